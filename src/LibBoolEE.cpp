@@ -16,6 +16,8 @@ this program.  If not, see <http://www.gnu.org/licenses/>.
 
 #include "LibBoolEE.h"
 
+#include <algorithm>
+
 std::vector<std::string> LibBoolEE::singleParse(const std::string & formula, const char op, ErrorReport* errorReport) {
     int start_pos = -1;
     int parity_count = 0;
@@ -145,6 +147,109 @@ bool LibBoolEE::resolveRec(const std::string &source, const Vals & valuation, Er
     }
 }
 
+bool LibBoolEE::compile(const std::string &source, const std::vector<std::string> &variables, Program &program) {
+    program = Program();
+    try {
+        size_t nStack = 0;
+        compileRec(removeWhitespaces(source), variables, program, nStack);
+    } catch (const std::runtime_error&) {
+        program = Program();
+        return false;
+    }
+    return true;
+}
+
+void LibBoolEE::compileRec(const std::string &source, const std::vector<std::string> &variables, Program &program, size_t &nStack) {
+    if (source.empty()) {
+        throw std::runtime_error("An empty subexpression was encountered");
+    }
+
+    char current_op = '|';
+    std::vector<std::string> subexpressions = singleParse(source, current_op);
+    if (subexpressions.size() == 1) {
+        current_op = '&';
+        subexpressions = singleParse(source, current_op);
+    }
+
+    if (subexpressions.size() == 0) {
+        throw std::runtime_error("The subexpression " + source + " is not a valid formula.");
+    }
+    else if (subexpressions.size() == 1) {
+        if (source[0] == '!') {
+            compileRec(source.substr(1), variables, program, nStack);
+            program.code.push_back(Program::NOT);
+            return;
+        }
+        else if (source[0] == '(') {
+            compileRec(source.substr(1, source.size() - 2), variables, program, nStack);
+            return;
+        }
+
+        if (++nStack > Program::MAX_STACK) {
+            throw std::runtime_error("The formula is too large to compile.");
+        }
+        if (source == "1") {
+            program.code.push_back(Program::PUSH_TRUE);
+        }
+        else if (source == "0") {
+            program.code.push_back(Program::PUSH_FALSE);
+        }
+        else {
+            std::vector<std::string>::const_iterator it = std::find(variables.begin(), variables.end(), source);
+            if (it == variables.end() || it - variables.begin() >= static_cast<int>(Program::MAX_VARIABLES)) {
+                throw std::runtime_error("Variable '" + source + "' not found in the interpretation.");
+            }
+            program.code.push_back(Program::PUSH_VAR);
+            program.code.push_back(static_cast<uint8_t>(it - variables.begin()));
+        }
+    }
+    else {
+        if (subexpressions.size() > 255) {
+            throw std::runtime_error("The formula is too large to compile.");
+        }
+        for (std::vector<std::string>::iterator it = subexpressions.begin(); it != subexpressions.end(); it++) {
+            compileRec(*it, variables, program, nStack);
+        }
+        program.code.push_back(current_op == '|' ? Program::OR : Program::AND);
+        program.code.push_back(static_cast<uint8_t>(subexpressions.size()));
+        nStack -= subexpressions.size() - 1;
+    }
+}
+
+bool LibBoolEE::evaluate(const Program &program, uint64_t valuation) {
+    bool stack[Program::MAX_STACK];
+    size_t n = 0;
+    const std::vector<uint8_t> &code = program.code;
+    for (size_t pc = 0; pc < code.size(); pc++) {
+        switch (code[pc]) {
+            case Program::PUSH_FALSE:
+                stack[n++] = false;
+                break;
+            case Program::PUSH_TRUE:
+                stack[n++] = true;
+                break;
+            case Program::PUSH_VAR:
+                stack[n++] = (valuation >> code[++pc]) & 1;
+                break;
+            case Program::NOT:
+                stack[n - 1] = !stack[n - 1];
+                break;
+            default: { // AND, OR
+                bool fAnd = code[pc] == Program::AND;
+                size_t count = code[++pc];
+                bool result = fAnd;
+                for (size_t i = n - count; i < n; i++) {
+                    result = fAnd ? (result && stack[i]) : (result || stack[i]);
+                }
+                n -= count;
+                stack[n++] = result;
+                break;
+            }
+        }
+    }
+    return n == 1 && stack[0];
+}
+
 std::string LibBoolEE::trim(const std::string &source) {
     static const std::string WHITESPACES = " \n\r\t\v\f";
     const size_t front = source.find_first_not_of(WHITESPACES);
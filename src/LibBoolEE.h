@@ -34,6 +34,7 @@ this program.  If not, see <http://www.gnu.org/licenses/>.
 #include "assets/assets.h"
 
 #include <map>
+#include <stdint.h>
 #include <string>
 #include <vector>
 #include <utility>
@@ -44,9 +45,24 @@ public:
     typedef std::map<std::string, bool> Vals; ///< Valuation of atomic propositions
     typedef std::pair<std::string, bool> Val; ///< A single proposition valuation
 
+    /// A formula compiled to postfix code, over variables numbered by their position in a list
+    struct Program {
+        enum Op : uint8_t { PUSH_FALSE, PUSH_TRUE, PUSH_VAR, NOT, AND, OR };
+        static const size_t MAX_VARIABLES = 64;
+        static const size_t MAX_STACK = 128;
+
+        std::vector<uint8_t> code; ///< PUSH_VAR is followed by the variable number, AND and OR by their operand count
+    };
+
     // @return	true iff the formula is true under the valuation (where the valuation are pairs (variable,value))
     static bool resolve(const std::string & source, const Vals & valuation,  ErrorReport* errorReport = nullptr);
 
+    // @return	true iff the formula was compiled; resolve() throws for exactly the formulas this rejects, unless there are too many variables
+    static bool compile(const std::string & source, const std::vector<std::string> & variables, Program & program);
+
+    // @return	the value of the compiled formula when variable i has the value of bit i of valuation
+    static bool evaluate(const Program & program, uint64_t valuation);
+
     // @return  new string made from the source by removing whitespaces
     static std::string removeWhitespaces(const std::string & source);
 
@@ -62,6 +78,9 @@ private:
     // @return	true iff the formula is true under the valuation (where the valuation are pairs (variable,value))---used internally
     static bool resolveRec(const std::string & source, const Vals & valuation, ErrorReport* errorReport = nullptr);
 
+    // Follows resolveRec step by step, emitting code instead of evaluating
+    static void compileRec(const std::string & source, const std::vector<std::string> & variables, Program & program, size_t & nStack);
+
 
     // @return	new string made from the source by removing the leading and trailing white spaces
     static std::string trim(const std::string & source);
@@ -7,6 +7,7 @@
 #include "addrdb.h"
 
 #include "addrman.h"
+#include "blockfilemap.h"
 #include "chainparams.h"
 #include "clientversion.h"
 #include "fs.h"
@@ -61,6 +62,67 @@ bool SerializeFileDB(const std::string& prefix, const fs::path& path, const Data
     return true;
 }
 
+bool WriteFileDB(const std::string& prefix, const fs::path& path, const std::vector<unsigned char>& vch)
+{
+    // Same temporary file and rename dance as SerializeFileDB
+    unsigned short randv = 0;
+    GetRandBytes((unsigned char*)&randv, sizeof(randv));
+    std::string tmpfn = strprintf("%s.%04x", prefix, randv);
+
+    fs::path pathTmp = GetDataDir() / tmpfn;
+    FILE *file = fsbridge::fopen(pathTmp, "wb");
+    if (!file)
+        return error("%s: Failed to open file %s", __func__, pathTmp.string());
+    if (fwrite(vch.data(), 1, vch.size(), file) != vch.size()) {
+        fclose(file);
+        return error("%s: Failed to write %s", __func__, pathTmp.string());
+    }
+    FileCommit(file);
+    fclose(file);
+
+    if (!RenameOver(pathTmp, path))
+        return error("%s: Rename-into-place failed", __func__);
+
+    return true;
+}
+
+/** Check the magic and checksum of a peers.dat in the fixed layout, then load it in place */
+bool ReadFixedAddrDB(FILE* file, CAddrMan& addr)
+{
+    const unsigned char* data = nullptr;
+    size_t size = 0;
+    std::vector<unsigned char> vch;
+    std::shared_ptr<const CMappedBlockFile> map = CMappedBlockFile::Map(file);
+    if (map) {
+        data = map->data();
+        size = map->size();
+    } else {
+        // No mmap on this platform, read it in one go instead
+        if (fseek(file, 0, SEEK_END) != 0)
+            return error("%s: Failed to seek peers.dat", __func__);
+        long nSize = ftell(file);
+        if (nSize < 0 || fseek(file, 0, SEEK_SET) != 0)
+            return error("%s: Failed to seek peers.dat", __func__);
+        vch.resize(nSize);
+        if (fread(vch.data(), 1, vch.size(), file) != vch.size())
+            return error("%s: Failed to read peers.dat", __func__);
+        data = vch.data();
+        size = vch.size();
+    }
+    fclose(file);
+
+    const size_t nMagicSize = sizeof(CMessageHeader::MessageStartChars);
+    if (size < nMagicSize + sizeof(uint256))
+        return error("%s: Truncated peers.dat", __func__);
+    if (memcmp(data, GetParams().MessageStart(), nMagicSize))
+        return error("%s: Invalid network magic number", __func__);
+    const unsigned char* pEnd = data + size - sizeof(uint256);
+    if (memcmp(Hash(data, pEnd).begin(), pEnd, sizeof(uint256)))
+        return error("%s: Checksum mismatch, data corrupted", __func__);
+
+    return addr.UnserializeFixed(data + nMagicSize, pEnd - data - nMagicSize);
+}
+
 template <typename Stream, typename Data>
 bool DeserializeDB(Stream& stream, Data& data, bool fCheckSum = true)
 {
@@ -126,14 +188,30 @@ CAddrDB::CAddrDB()
     pathAddr = GetDataDir() / "peers.dat";
 }
 
-bool CAddrDB::Write(const CAddrMan& addr)
+bool CAddrDB::Write(const CAddrManSnapshot& snapshot)
 {
-    return SerializeFileDB("peers", pathAddr, addr);
+    // Network magic, fixed layout tables, checksum of both
+    std::vector<unsigned char> vch(GetParams().MessageStart(), GetParams().MessageStart() + sizeof(CMessageHeader::MessageStartChars));
+    snapshot.SerializeFixed(vch);
+    uint256 hash = Hash(vch.begin(), vch.end());
+    vch.insert(vch.end(), hash.begin(), hash.end());
+    return WriteFileDB("peers", pathAddr, vch);
 }
 
 bool CAddrDB::Read(CAddrMan& addr)
 {
-    return DeserializeFileDB(pathAddr, addr);
+    FILE *file = fsbridge::fopen(pathAddr, "rb");
+    if (!file)
+        return error("%s: Failed to open file %s", __func__, pathAddr.string());
+
+    // Files written before the fixed layout are read through the stream format
+    unsigned char header[8];
+    bool fFixed = fread(header, 1, sizeof(header), file) == sizeof(header) && CAddrMan::IsFixedFormat(header + 4, 4);
+    if (!fFixed) {
+        fclose(file);
+        return DeserializeFileDB(pathAddr, addr);
+    }
+    return ReadFixedAddrDB(file, addr);
 }
 
 bool CAddrDB::Read(CAddrMan& addr, CDataStream& ssPeers)
@@ -15,6 +15,7 @@
 
 class CSubNet;
 class CAddrMan;
+class CAddrManSnapshot;
 class CDataStream;
 
 typedef enum BanReason
@@ -77,14 +78,19 @@ public:
 
 typedef std::map<CSubNet, CBanEntry> banmap_t;
 
-/** Access to the (IP) address database (peers.dat) */
+/**
+ * Access to the (IP) address database (peers.dat). It is written in the fixed
+ * layout of CAddrManSnapshot::SerializeFixed, from a snapshot so addrman isn't
+ * locked while the file is written, and mapped to be loaded in place. Files in
+ * the older stream format are still read.
+ */
 class CAddrDB
 {
 private:
     fs::path pathAddr;
 public:
     CAddrDB();
-    bool Write(const CAddrMan& addr);
+    bool Write(const CAddrManSnapshot& snapshot);
     bool Read(CAddrMan& addr);
     static bool Read(CAddrMan& addr, CDataStream& ssPeers);
 };
@@ -310,6 +310,82 @@ struct CAddressIndexIteratorHeightKey {
     }
 };
 
+/** Key of the balance rollup of one asset held by an address */
+struct CAddressBalanceKey {
+    unsigned int type;
+    uint160 hashBytes;
+    std::string asset;
+
+    size_t GetSerializeSize() const {
+        return 21 + asset.size();
+    }
+    template<typename Stream>
+    void Serialize(Stream& s) const {
+        ser_writedata8(s, type);
+        hashBytes.Serialize(s);
+        ::Serialize(s, asset);
+    }
+    template<typename Stream>
+    void Unserialize(Stream& s) {
+        type = ser_readdata8(s);
+        hashBytes.Unserialize(s);
+        ::Unserialize(s, asset);
+    }
+
+    CAddressBalanceKey(unsigned int addressType, uint160 addressHash, std::string assetName) {
+        type = addressType;
+        hashBytes = addressHash;
+        asset = assetName;
+    }
+
+    CAddressBalanceKey() {
+        SetNull();
+    }
+
+    void SetNull() {
+        type = 0;
+        hashBytes.SetNull();
+        asset.clear();
+    }
+
+    friend bool operator<(const CAddressBalanceKey& a, const CAddressBalanceKey& b) {
+        if (a.type != b.type)
+            return a.type < b.type;
+        if (a.hashBytes != b.hashBytes)
+            return a.hashBytes < b.hashBytes;
+        return a.asset < b.asset;
+    }
+};
+
+/** Sums of an address's index entries for one asset, kept up to date with the index */
+struct CAddressBalanceValue {
+    //! Sum of all entries
+    CAmount balance;
+    //! Sum of the entries that added to the balance
+    CAmount received;
+
+    ADD_SERIALIZE_METHODS;
+
+    template <typename Stream, typename Operation>
+    inline void SerializationOp(Stream& s, Operation ser_action) {
+        READWRITE(balance);
+        READWRITE(received);
+    }
+
+    CAddressBalanceValue() {
+        SetNull();
+    }
+
+    void SetNull() {
+        balance = 0;
+        received = 0;
+    }
+
+    bool IsNull() const {
+        return balance == 0 && received == 0;
+    }
+};
+
 struct CMempoolAddressDelta
 {
     int64_t time;
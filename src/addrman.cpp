@@ -6,10 +6,15 @@
 
 #include "addrman.h"
 
+#include "clientversion.h"
+#include "crypto/common.h"
 #include "hash.h"
 #include "serialize.h"
 #include "streams.h"
 
+#include <numeric>
+#include <unordered_map>
+
 int CAddrInfo::GetTriedBucket(const uint256& nKey) const
 {
     uint64_t hash1 = (CHashWriter(SER_GETHASH, 0) << nKey << GetKey()).GetHash().GetCheapHash();
@@ -389,6 +394,269 @@ CAddrInfo CAddrMan::Select_(bool newOnly)
     }
 }
 
+CAddrInfo CAddrManSnapshot::Select(bool newOnly, FastRandomContext& rng) const
+{
+    if (vAddrs.empty() || (newOnly && vNewSlots.empty()))
+        return CAddrInfo();
+
+    // Same 50% split and chance loop as CAddrMan::Select_, over the occupied slots only
+    bool fTried = !newOnly && !vTriedSlots.empty() && (vNewSlots.empty() || rng.randbool());
+    const std::vector<uint32_t>& vSlots = fTried ? vTriedSlots : vNewSlots;
+    double fChanceFactor = 1.0;
+    while (1) {
+        const CAddrInfo& info = vAddrs[vSlots[rng.randrange(vSlots.size())]];
+        if (rng.randbits(30) < fChanceFactor * info.GetChance() * (1 << 30))
+            return info;
+        fChanceFactor *= 1.2;
+    }
+}
+
+void CAddrManSnapshot::GetAddr(std::vector<CAddress>& vAddr, FastRandomContext& rng) const
+{
+    unsigned int nNodes = ADDRMAN_GETADDR_MAX_PCT * vAddrs.size() / 100;
+    if (nNodes > ADDRMAN_GETADDR_MAX)
+        nNodes = ADDRMAN_GETADDR_MAX;
+
+    // Partial shuffle of our own index list, the snapshot itself is shared
+    std::vector<uint32_t> vPos(vAddrs.size());
+    std::iota(vPos.begin(), vPos.end(), 0);
+    for (unsigned int n = 0; n < vPos.size(); n++) {
+        if (vAddr.size() >= nNodes)
+            break;
+
+        std::swap(vPos[n], vPos[n + rng.randrange(vPos.size() - n)]);
+        const CAddrInfo& ai = vAddrs[vPos[n]];
+        if (!ai.IsTerrible())
+            vAddr.push_back(ai);
+    }
+}
+
+std::shared_ptr<const CAddrManSnapshot> CAddrMan::MakeSnapshot_() const
+{
+    std::shared_ptr<CAddrManSnapshot> snap = std::make_shared<CAddrManSnapshot>();
+    snap->nVersion = nTablesVersion;
+    snap->nTime = GetTime();
+    snap->nKey = nKey;
+
+    std::unordered_map<int, uint32_t> mapPos;
+    mapPos.reserve(mapInfo.size());
+    snap->vAddrs.reserve(mapInfo.size());
+    for (const auto& item : mapInfo) {
+        mapPos.emplace(item.first, snap->vAddrs.size());
+        snap->vAddrs.push_back(item.second);
+    }
+
+    snap->vTriedSlots.reserve(nTried);
+    for (int bucket = 0; bucket < ADDRMAN_TRIED_BUCKET_COUNT; bucket++) {
+        for (int entry = 0; entry < ADDRMAN_BUCKET_SIZE; entry++) {
+            if (vvTried[bucket][entry] != -1)
+                snap->vTriedSlots.push_back(mapPos.at(vvTried[bucket][entry]));
+        }
+    }
+    snap->vNewSlots.reserve(nNew);
+    snap->vNewSlotBuckets.reserve(nNew);
+    for (int bucket = 0; bucket < ADDRMAN_NEW_BUCKET_COUNT; bucket++) {
+        for (int entry = 0; entry < ADDRMAN_BUCKET_SIZE; entry++) {
+            if (vvNew[bucket][entry] != -1) {
+                snap->vNewSlots.push_back(mapPos.at(vvNew[bucket][entry]));
+                snap->vNewSlotBuckets.push_back(bucket);
+            }
+        }
+    }
+    return snap;
+}
+
+std::shared_ptr<const CAddrManSnapshot> CAddrMan::GetCurrentSnapshot()
+{
+    LOCK(cs);
+    std::shared_ptr<const CAddrManSnapshot> snap = std::atomic_load(&snapshot);
+    if (!snap || snap->nVersion != nTablesVersion) {
+        snap = MakeSnapshot_();
+        std::atomic_store(&snapshot, snap);
+    }
+    return snap;
+}
+
+/**
+ * Fixed layout encoding, all integers little endian:
+ * * header (ADDRMAN_FIXED_HEADER_SIZE bytes): "ADRM", format version (1), number of
+ *   addresses, number of new table references, new bucket count, bucket size, nKey
+ * * one ADDRMAN_FIXED_RECORD_SIZE record per address: CService (18 bytes), 2 unused,
+ *   nTime (4), nServices (8), source CNetAddr (16), nLastSuccess (8), nAttempts (4),
+ *   flags (1, bit 0 = in tried), 3 unused
+ * * one ADDRMAN_FIXED_SLOT_SIZE record per new table reference: bucket (4), address index (4)
+ *
+ * Every record sits at an offset known from the header, so the whole file can be
+ * mapped and walked in place. Like the stream format, tried positions are recomputed
+ * from nKey, and new table references are only kept if the bucket geometry is unchanged.
+ */
+static const unsigned char ADDRMAN_FIXED_TAG[4] = {'A', 'D', 'R', 'M'};
+static const uint32_t ADDRMAN_FIXED_VERSION = 1;
+static const size_t ADDRMAN_FIXED_HEADER_SIZE = 56;
+static const size_t ADDRMAN_FIXED_RECORD_SIZE = 64;
+static const size_t ADDRMAN_FIXED_SLOT_SIZE = 8;
+
+void CAddrManSnapshot::SerializeFixed(std::vector<unsigned char>& vch) const
+{
+    size_t nStart = vch.size();
+    vch.resize(nStart + ADDRMAN_FIXED_HEADER_SIZE + vAddrs.size() * ADDRMAN_FIXED_RECORD_SIZE + vNewSlots.size() * ADDRMAN_FIXED_SLOT_SIZE);
+    size_t nPos = nStart;
+    unsigned char* p = vch.data() + nPos;
+
+    memcpy(p, ADDRMAN_FIXED_TAG, sizeof(ADDRMAN_FIXED_TAG));
+    WriteLE32(p + 4, ADDRMAN_FIXED_VERSION);
+    WriteLE32(p + 8, vAddrs.size());
+    WriteLE32(p + 12, vNewSlots.size());
+    WriteLE32(p + 16, ADDRMAN_NEW_BUCKET_COUNT);
+    WriteLE32(p + 20, ADDRMAN_BUCKET_SIZE);
+    memcpy(p + 24, nKey.begin(), 32);
+    nPos += ADDRMAN_FIXED_HEADER_SIZE;
+
+    for (const CAddrInfo& info : vAddrs) {
+        // The network address fields use their (fixed size) serialization
+        CVectorWriter(SER_DISK, CLIENT_VERSION, vch, nPos, static_cast<const CService&>(info));
+        CVectorWriter(SER_DISK, CLIENT_VERSION, vch, nPos + 32, info.source);
+        p = vch.data() + nPos;
+        WriteLE32(p + 20, info.nTime);
+        WriteLE64(p + 24, info.nServices);
+        WriteLE64(p + 48, info.nLastSuccess);
+        WriteLE32(p + 56, info.nAttempts);
+        p[60] = info.fInTried ? 1 : 0;
+        nPos += ADDRMAN_FIXED_RECORD_SIZE;
+    }
+
+    p = vch.data() + nPos;
+    for (size_t i = 0; i < vNewSlots.size(); i++) {
+        WriteLE32(p, vNewSlotBuckets[i]);
+        WriteLE32(p + 4, vNewSlots[i]);
+        p += ADDRMAN_FIXED_SLOT_SIZE;
+    }
+}
+
+bool CAddrMan::IsFixedFormat(const unsigned char* data, size_t size)
+{
+    return size >= sizeof(ADDRMAN_FIXED_TAG) && memcmp(data, ADDRMAN_FIXED_TAG, sizeof(ADDRMAN_FIXED_TAG)) == 0;
+}
+
+bool CAddrMan::UnserializeFixed(const unsigned char* data, size_t size)
+{
+    LOCK(cs);
+
+    Clear();
+
+    if (!IsFixedFormat(data, size) || size < ADDRMAN_FIXED_HEADER_SIZE || ReadLE32(data + 4) != ADDRMAN_FIXED_VERSION)
+        return false;
+    uint64_t nAddrs = ReadLE32(data + 8);
+    uint64_t nSlots = ReadLE32(data + 12);
+    bool fSameGeometry = ReadLE32(data + 16) == ADDRMAN_NEW_BUCKET_COUNT && ReadLE32(data + 20) == ADDRMAN_BUCKET_SIZE;
+    if (nAddrs > (ADDRMAN_NEW_BUCKET_COUNT + ADDRMAN_TRIED_BUCKET_COUNT) * ADDRMAN_BUCKET_SIZE ||
+        nSlots > nAddrs * ADDRMAN_NEW_BUCKETS_PER_ADDRESS ||
+        size != ADDRMAN_FIXED_HEADER_SIZE + nAddrs * ADDRMAN_FIXED_RECORD_SIZE + nSlots * ADDRMAN_FIXED_SLOT_SIZE) {
+        return error("%s: Corrupt CAddrMan fixed layout, bad sizes", __func__);
+    }
+    memcpy(nKey.begin(), data + 24, 32);
+
+    // Address index in the data -> nId, or -1 if the entry was dropped
+    std::vector<int> vIds(nAddrs, -1);
+    int nLost = 0;
+    const unsigned char* p = data + ADDRMAN_FIXED_HEADER_SIZE;
+    for (uint64_t i = 0; i < nAddrs; i++, p += ADDRMAN_FIXED_RECORD_SIZE) {
+        CService addr;
+        CNetAddr source;
+        CSpanReader(SER_DISK, CLIENT_VERSION, p, 18) >> addr;
+        CSpanReader(SER_DISK, CLIENT_VERSION, p + 32, 16) >> source;
+        CAddrInfo info(CAddress(addr, ServiceFlags(ReadLE64(p + 24))), source);
+        info.nTime = ReadLE32(p + 20);
+        info.nLastSuccess = ReadLE64(p + 48);
+        info.nAttempts = ReadLE32(p + 56);
+        if (mapAddr.count(info)) {
+            nLost++;
+            continue;
+        }
+
+        if (p[60] & 1) {
+            int nKBucket = info.GetTriedBucket(nKey);
+            int nKBucketPos = info.GetBucketPosition(nKey, false, nKBucket);
+            if (vvTried[nKBucket][nKBucketPos] != -1) {
+                nLost++;
+                continue;
+            }
+            info.fInTried = true;
+            vvTried[nKBucket][nKBucketPos] = nIdCount;
+            nTried++;
+        } else {
+            nNew++;
+        }
+        info.nRandomPos = vRandom.size();
+        vRandom.push_back(nIdCount);
+        mapAddr[info] = nIdCount;
+        mapInfo[nIdCount] = info;
+        vIds[i] = nIdCount++;
+    }
+
+    for (uint64_t i = 0; i < nSlots && fSameGeometry; i++, p += ADDRMAN_FIXED_SLOT_SIZE) {
+        uint32_t nUBucket = ReadLE32(p);
+        uint32_t nIndex = ReadLE32(p + 4);
+        if (nUBucket >= ADDRMAN_NEW_BUCKET_COUNT || nIndex >= nAddrs || vIds[nIndex] == -1)
+            continue;
+        CAddrInfo& info = mapInfo[vIds[nIndex]];
+        int nUBucketPos = info.GetBucketPosition(nKey, true, nUBucket);
+        if (!info.fInTried && vvNew[nUBucket][nUBucketPos] == -1 && info.nRefCount < ADDRMAN_NEW_BUCKETS_PER_ADDRESS) {
+            info.nRefCount++;
+            vvNew[nUBucket][nUBucketPos] = vIds[nIndex];
+        }
+    }
+    if (!fSameGeometry) {
+        // The stored references can't be used, give each entry one based on its primary source
+        for (auto& item : mapInfo) {
+            CAddrInfo& info = item.second;
+            if (info.fInTried)
+                continue;
+            int nUBucket = info.GetNewBucket(nKey);
+            int nUBucketPos = info.GetBucketPosition(nKey, true, nUBucket);
+            if (vvNew[nUBucket][nUBucketPos] == -1) {
+                vvNew[nUBucket][nUBucketPos] = item.first;
+                info.nRefCount++;
+            }
+        }
+    }
+
+    // Prune new entries left without a reference by collisions
+    for (std::map<int, CAddrInfo>::const_iterator it = mapInfo.begin(); it != mapInfo.end(); ) {
+        if (it->second.fInTried == false && it->second.nRefCount == 0) {
+            std::map<int, CAddrInfo>::const_iterator itCopy = it++;
+            Delete(itCopy->first);
+            nLost++;
+        } else {
+            it++;
+        }
+    }
+    if (nLost > 0) {
+        LogPrint(BCLog::ADDRMAN, "addrman lost %i addresses due to collisions\n", nLost);
+    }
+
+    nTablesVersion++;
+    Check();
+    return true;
+}
+
+std::shared_ptr<const CAddrManSnapshot> CAddrMan::GetSnapshot()
+{
+    std::shared_ptr<const CAddrManSnapshot> snap = std::atomic_load(&snapshot);
+    // An empty snapshot is never kept around, so the first addresses are usable right away
+    if (snap && (snap->nVersion == nTablesVersion || (!snap->vAddrs.empty() && GetTime() - snap->nTime < nSnapshotMaxAge)))
+        return snap;
+
+    LOCK(cs);
+    // Someone else may have just published one
+    snap = std::atomic_load(&snapshot);
+    if (!snap || snap->nVersion != nTablesVersion) {
+        snap = MakeSnapshot_();
+        std::atomic_store(&snapshot, snap);
+    }
+    return snap;
+}
+
 #ifdef DEBUG_ADDRMAN
 int CAddrMan::Check_()
 {
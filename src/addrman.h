@@ -14,7 +14,9 @@
 #include "timedata.h"
 #include "util.h"
 
+#include <atomic>
 #include <map>
+#include <memory>
 #include <set>
 #include <stdint.h>
 #include <vector>
@@ -53,6 +55,7 @@ private:
     int nRandomPos;
 
     friend class CAddrMan;
+    friend class CAddrManSnapshot;
 
 public:
 
@@ -172,11 +175,43 @@ public:
 //! the maximum number of nodes to return in a getaddr call
 #define ADDRMAN_GETADDR_MAX 2500
 
+//! how many seconds Select and GetAddr may keep answering from a snapshot after the tables changed
+#define ADDRMAN_SNAPSHOT_MAX_AGE 5
+
 //! Convenience
 #define ADDRMAN_TRIED_BUCKET_COUNT (1 << ADDRMAN_TRIED_BUCKET_COUNT_LOG2)
 #define ADDRMAN_NEW_BUCKET_COUNT (1 << ADDRMAN_NEW_BUCKET_COUNT_LOG2)
 #define ADDRMAN_BUCKET_SIZE (1 << ADDRMAN_BUCKET_SIZE_LOG2)
 
+/**
+ * Immutable copy of the address tables published for Select and GetAddr, so
+ * connection selection and GETADDR responses don't wait on cs while ADDR
+ * messages are being processed. Each occupied bucket slot refers to its entry
+ * in vAddrs, so addresses present in several new buckets keep their weight.
+ */
+class CAddrManSnapshot
+{
+public:
+    //! Table version the snapshot was taken at, and when (in seconds)
+    uint64_t nVersion{0};
+    int64_t nTime{0};
+
+    //! Key the bucket positions were computed with
+    uint256 nKey;
+
+    std::vector<CAddrInfo> vAddrs;
+    std::vector<uint32_t> vTriedSlots;
+    std::vector<uint32_t> vNewSlots;
+    //! New table bucket of each vNewSlots entry
+    std::vector<uint32_t> vNewSlotBuckets;
+
+    CAddrInfo Select(bool newOnly, FastRandomContext& rng) const;
+    void GetAddr(std::vector<CAddress>& vAddr, FastRandomContext& rng) const;
+
+    //! Append the fixed layout encoding read by CAddrMan::UnserializeFixed to vch
+    void SerializeFixed(std::vector<unsigned char>& vch) const;
+};
+
 /** 
  * Stochastical (IP) address manager 
  */
@@ -213,6 +248,12 @@ private:
     //! last time Good was called (memory only)
     int64_t nLastGood;
 
+    //! bumped on every change to the tables, compared against the published snapshot
+    std::atomic<uint64_t> nTablesVersion{0};
+
+    //! tables as of some recent version, read without cs (use std::atomic_load/atomic_store)
+    std::shared_ptr<const CAddrManSnapshot> snapshot;
+
 protected:
     //! secret key to randomize bucket select with
     uint256 nKey;
@@ -220,6 +261,12 @@ protected:
     //! Source of random numbers for randomization in inner loops
     FastRandomContext insecure_rand;
 
+    //! Seconds a snapshot may lag behind the tables, or negative to always read them under cs
+    int64_t nSnapshotMaxAge{ADDRMAN_SNAPSHOT_MAX_AGE};
+
+    //! Current snapshot, taken again under cs if it is older than nSnapshotMaxAge and out of date.
+    std::shared_ptr<const CAddrManSnapshot> GetSnapshot();
+
     //! Find an entry.
     CAddrInfo* Find(const CNetAddr& addr, int *pnId = nullptr);
 
@@ -268,7 +315,20 @@ protected:
     //! Update an entry's service bits.
     void SetServices_(const CService &addr, ServiceFlags nServices);
 
+    //! Copy the tables into a new snapshot.
+    std::shared_ptr<const CAddrManSnapshot> MakeSnapshot_() const;
+
 public:
+    //! Whether data starts like CAddrManSnapshot::SerializeFixed output
+    static bool IsFixedFormat(const unsigned char* data, size_t size);
+
+    //! Replace the tables with a CAddrManSnapshot::SerializeFixed encoding.
+    //! Returns false, leaving the tables empty, if it is malformed.
+    bool UnserializeFixed(const unsigned char* data, size_t size);
+
+    //! Snapshot of the tables as they are now (also published for Select and GetAddr)
+    std::shared_ptr<const CAddrManSnapshot> GetCurrentSnapshot();
+
     /**
      * serialized format:
      * * version byte (currently 1)
@@ -451,6 +511,7 @@ public:
             LogPrint(BCLog::ADDRMAN, "addrman lost %i new and %i tried addresses due to collisions\n", nLostUnk, nLost);
         }
 
+        nTablesVersion++;
         Check();
     }
 
@@ -475,6 +536,7 @@ public:
         nLastGood = 1; //Initially at 1 so that "never" is strictly worse.
         mapInfo.clear();
         mapAddr.clear();
+        nTablesVersion++;
     }
 
     CAddrMan()
@@ -514,6 +576,7 @@ public:
         bool fRet = false;
         Check();
         fRet |= Add_(addr, source, nTimePenalty);
+        nTablesVersion++;
         Check();
         if (fRet) {
             LogPrint(BCLog::ADDRMAN, "Added %s from %s: %i tried, %i new\n", addr.ToStringIPPort(), source.ToString(), nTried, nNew);
@@ -531,6 +594,7 @@ public:
         Check();
         for (std::vector<CAddress>::const_iterator it = vAddr.begin(); it != vAddr.end(); it++)
             nAdd += Add_(*it, source, nTimePenalty) ? 1 : 0;
+        nTablesVersion++;
         Check();
         if (nAdd) {
             LogPrint(BCLog::ADDRMAN, "Added %i addresses from %s: %i tried, %i new\n", nAdd, source.ToString(), nTried, nNew);
@@ -544,6 +608,7 @@ public:
         LOCK(cs);
         Check();
         Good_(addr, nTime);
+        nTablesVersion++;
         Check();
     }
 
@@ -553,6 +618,7 @@ public:
         LOCK(cs);
         Check();
         Attempt_(addr, fCountFailure, nTime);
+        nTablesVersion++;
         Check();
     }
 
@@ -561,6 +627,10 @@ public:
      */
     CAddrInfo Select(bool newOnly = false)
     {
+        if (nSnapshotMaxAge >= 0) {
+            FastRandomContext rng;
+            return GetSnapshot()->Select(newOnly, rng);
+        }
         CAddrInfo addrRet;
         {
             LOCK(cs);
@@ -574,8 +644,13 @@ public:
     //! Return a bunch of addresses, selected at random.
     std::vector<CAddress> GetAddr()
     {
-        Check();
         std::vector<CAddress> vAddr;
+        if (nSnapshotMaxAge >= 0) {
+            FastRandomContext rng;
+            GetSnapshot()->GetAddr(vAddr, rng);
+            return vAddr;
+        }
+        Check();
         {
             LOCK(cs);
             GetAddr_(vAddr);
@@ -590,6 +665,7 @@ public:
         LOCK(cs);
         Check();
         Connected_(addr, nTime);
+        nTablesVersion++;
         Check();
     }
 
@@ -598,6 +674,7 @@ public:
         LOCK(cs);
         Check();
         SetServices_(addr, nServices);
+        nTablesVersion++;
         Check();
     }
 
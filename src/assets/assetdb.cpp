@@ -8,16 +8,40 @@
 #include <tinyformat.h>
 #include "assetdb.h"
 #include "assets.h"
+#include "coins.h"
 #include "validation.h"
 
+#include <functional>
+
 #include <boost/thread.hpp>
 
 static const char ASSET_FLAG = 'A';
-static const char ASSET_ADDRESS_QUANTITY_FLAG = 'B';
-static const char ADDRESS_ASSET_QUANTITY_FLAG = 'C';
+static const char ASSET_ADDRESS_QUANTITY_FLAG = 'D';
+static const char ADDRESS_ASSET_QUANTITY_FLAG = 'E';
 static const char MY_ASSET_FLAG = 'M';
 static const char BLOCK_ASSET_UNDO_DATA = 'U';
 static const char MEMPOOL_REISSUED_TX = 'Z';
+static const char ASSET_HOLDER_COUNT_FLAG = 'H';
+static const char ADDRESS_ASSET_COUNT_FLAG = 'L';
+static const char DIR_COUNTS_INDEXED_FLAG = 'N';
+static const char HOT_ASSETS_FLAG = 'O';
+static const char UNIQUE_COLLECTION_FLAG = 'T';
+static const char UNIQUE_COLLECTION_COUNT_FLAG = 'S';
+static const char UNIQUE_COLLECTIONS_INDEXED_FLAG = 'I';
+static const char ASSET_CHILD_FLAG = 'P';
+static const char ASSET_CHILD_COUNT_FLAG = 'Q';
+static const char ASSET_DESCENDANT_COUNT_FLAG = 'R';
+static const char ASSET_TREE_INDEXED_FLAG = 'J';
+static const char ASSET_SUPPLY_FLAG = 'V';
+static const char ASSET_SUPPLY_INDEXED_FLAG = 'W';
+
+// The address entries before they were keyed by CAddressKey, see MigrateAddressKeys
+static const char LEGACY_ASSET_ADDRESS_QUANTITY_FLAG = 'B';
+static const char LEGACY_ADDRESS_ASSET_QUANTITY_FLAG = 'C';
+static const char LEGACY_ADDRESS_ASSET_COUNT_FLAG = 'K';
+
+//! Assets PrefetchHotAssets reads per hold of cs_main
+static const size_t HOT_ASSETS_BATCH_SIZE = 64;
 
 static size_t MAX_DATABASE_RESULTS = 50000;
 
@@ -27,16 +51,126 @@ CAssetsDB::CAssetsDB(size_t nCacheSize, bool fMemory, bool fWipe) : CDBWrapper(G
 bool CAssetsDB::WriteAssetData(const CNewAsset &asset, const int nHeight, const uint256& blockHash)
 {
     CDatabasedAssetData data(asset, nHeight, blockHash);
-    return Write(std::make_pair(ASSET_FLAG, asset.strName), data);
+    if (!Write(std::make_pair(ASSET_FLAG, asset.strName), data))
+        return false;
+
+    if (!WriteAssetTreeEntry(asset.strName))
+        return false;
+
+    // Unique assets are also listed under their collection, the root they were issued from
+    std::string root, tag;
+    if (SplitUniqueAssetName(asset.strName, root, tag))
+        return WriteDirEntry(UNIQUE_COLLECTION_FLAG, UNIQUE_COLLECTION_COUNT_FLAG, root, tag, asset.nAmount);
+    return true;
+}
+
+/** Add name under its parent in the asset tree, counting it for every node above it if it is new */
+bool CAssetsDB::WriteAssetTreeEntry(const std::string& name)
+{
+    std::string parent;
+    if (!GetAssetTreeParent(name, parent))
+        return true;
+
+    auto key = std::make_pair(ASSET_CHILD_FLAG, std::make_pair(parent, name));
+    if (Exists(key))
+        return true;
+
+    CDBBatch batch(*this);
+    AdjustDirCount(batch, ASSET_CHILD_COUNT_FLAG, parent, 1);
+    std::string ancestor = parent;
+    do {
+        AdjustDirCount(batch, ASSET_DESCENDANT_COUNT_FLAG, ancestor, 1);
+    } while (GetAssetTreeParent(ancestor, ancestor));
+    batch.Write(key, ASSET_TREE_ENTRY);
+    return WriteBatch(batch);
+}
+
+bool CAssetsDB::EraseAssetTreeEntry(const std::string& name)
+{
+    std::string parent;
+    if (!GetAssetTreeParent(name, parent))
+        return true;
+
+    auto key = std::make_pair(ASSET_CHILD_FLAG, std::make_pair(parent, name));
+    if (!Exists(key))
+        return true;
+
+    CDBBatch batch(*this);
+    AdjustDirCount(batch, ASSET_CHILD_COUNT_FLAG, parent, -1);
+    std::string ancestor = parent;
+    do {
+        AdjustDirCount(batch, ASSET_DESCENDANT_COUNT_FLAG, ancestor, -1);
+    } while (GetAssetTreeParent(ancestor, ancestor));
+    batch.Erase(key);
+    return WriteBatch(batch);
+}
+
+static std::string DirPrefixString(const std::string& prefix)
+{
+    return prefix;
 }
 
-bool CAssetsDB::WriteAssetAddressQuantity(const std::string &assetName, const std::string &address, const CAmount &quantity)
+static std::string DirPrefixString(const CAddressKey& prefix)
 {
-    return Write(std::make_pair(ASSET_ADDRESS_QUANTITY_FLAG, std::make_pair(assetName, address)), quantity);
+    return prefix.ToString();
 }
 
-bool CAssetsDB::WriteAddressAssetQuantity(const std::string &address, const std::string &assetName, const CAmount& quantity) {
-    return Write(std::make_pair(ADDRESS_ASSET_QUANTITY_FLAG, std::make_pair(address, assetName)), quantity);
+template <typename Prefix>
+uint32_t CAssetsDB::ReadDirCount(const char countFlag, const Prefix& prefix, const CDBSnapshot* snapshot) const
+{
+    uint32_t nCount = 0;
+    if (!Read(std::make_pair(countFlag, prefix), nCount, snapshot))
+        return 0;
+    return nCount;
+}
+
+template <typename Prefix>
+void CAssetsDB::AdjustDirCount(CDBBatch& batch, const char countFlag, const Prefix& prefix, const int nDelta) const
+{
+    uint32_t nCount = ReadDirCount(countFlag, prefix);
+    if (nDelta < 0 && nCount < (uint32_t)-nDelta) {
+        LogPrintf("%s: entry count of %s went negative, the asset index may need a -reindex\n", __func__, DirPrefixString(prefix));
+        nCount = 0;
+    } else {
+        nCount += nDelta;
+    }
+
+    if (nCount)
+        batch.Write(std::make_pair(countFlag, prefix), nCount);
+    else
+        batch.Erase(std::make_pair(countFlag, prefix));
+}
+
+template <typename Prefix, typename Name>
+bool CAssetsDB::WriteDirEntry(const char flag, const char countFlag, const Prefix& prefix, const Name& name, const CAmount& quantity)
+{
+    auto key = std::make_pair(flag, std::make_pair(prefix, name));
+    CDBBatch batch(*this);
+    if (!Exists(key))
+        AdjustDirCount(batch, countFlag, prefix, 1);
+    batch.Write(key, quantity);
+    return WriteBatch(batch);
+}
+
+template <typename Prefix, typename Name>
+bool CAssetsDB::EraseDirEntry(const char flag, const char countFlag, const Prefix& prefix, const Name& name)
+{
+    auto key = std::make_pair(flag, std::make_pair(prefix, name));
+    if (!Exists(key))
+        return true;
+    CDBBatch batch(*this);
+    AdjustDirCount(batch, countFlag, prefix, -1);
+    batch.Erase(key);
+    return WriteBatch(batch);
+}
+
+bool CAssetsDB::WriteAssetAddressQuantity(const std::string &assetName, const CAddressKey &address, const CAmount &quantity)
+{
+    return WriteDirEntry(ASSET_ADDRESS_QUANTITY_FLAG, ASSET_HOLDER_COUNT_FLAG, assetName, address, quantity);
+}
+
+bool CAssetsDB::WriteAddressAssetQuantity(const CAddressKey &address, const std::string &assetName, const CAmount& quantity) {
+    return WriteDirEntry(ADDRESS_ASSET_QUANTITY_FLAG, ADDRESS_ASSET_COUNT_FLAG, address, assetName, quantity);
 }
 
 bool CAssetsDB::ReadAssetData(const std::string& strName, CNewAsset& asset, int& nHeight, uint256& blockHash)
@@ -54,18 +188,24 @@ bool CAssetsDB::ReadAssetData(const std::string& strName, CNewAsset& asset, int&
     return ret;
 }
 
-bool CAssetsDB::ReadAssetAddressQuantity(const std::string& assetName, const std::string& address, CAmount& quantity)
+bool CAssetsDB::ReadAssetAddressQuantity(const std::string& assetName, const CAddressKey& address, CAmount& quantity)
 {
     return Read(std::make_pair(ASSET_ADDRESS_QUANTITY_FLAG, std::make_pair(assetName, address)), quantity);
 }
 
-bool CAssetsDB::ReadAddressAssetQuantity(const std::string &address, const std::string &assetName, CAmount& quantity) {
+bool CAssetsDB::ReadAddressAssetQuantity(const CAddressKey &address, const std::string &assetName, CAmount& quantity) {
     return Read(std::make_pair(ADDRESS_ASSET_QUANTITY_FLAG, std::make_pair(address, assetName)), quantity);
 }
 
 bool CAssetsDB::EraseAssetData(const std::string& assetName)
 {
-    return Erase(std::make_pair(ASSET_FLAG, assetName));
+    if (!Erase(std::make_pair(ASSET_FLAG, assetName)) || !EraseAssetTreeEntry(assetName))
+        return false;
+
+    std::string root, tag;
+    if (SplitUniqueAssetName(assetName, root, tag))
+        return EraseDirEntry(UNIQUE_COLLECTION_FLAG, UNIQUE_COLLECTION_COUNT_FLAG, root, tag);
+    return true;
 }
 
 bool CAssetsDB::EraseMyAssetData(const std::string& assetName)
@@ -73,16 +213,14 @@ bool CAssetsDB::EraseMyAssetData(const std::string& assetName)
     return Erase(std::make_pair(MY_ASSET_FLAG, assetName));
 }
 
-bool CAssetsDB::EraseAssetAddressQuantity(const std::string &assetName, const std::string &address) {
-    return Erase(std::make_pair(ASSET_ADDRESS_QUANTITY_FLAG, std::make_pair(assetName, address)));
+bool CAssetsDB::EraseAssetAddressQuantity(const std::string &assetName, const CAddressKey &address) {
+    return EraseDirEntry(ASSET_ADDRESS_QUANTITY_FLAG, ASSET_HOLDER_COUNT_FLAG, assetName, address);
 }
 
-bool CAssetsDB::EraseAddressAssetQuantity(const std::string &address, const std::string &assetName) {
-    return Erase(std::make_pair(ADDRESS_ASSET_QUANTITY_FLAG, std::make_pair(address, assetName)));
+bool CAssetsDB::EraseAddressAssetQuantity(const CAddressKey &address, const std::string &assetName) {
+    return EraseDirEntry(ADDRESS_ASSET_QUANTITY_FLAG, ADDRESS_ASSET_COUNT_FLAG, address, assetName);
 }
 
-bool EraseAddressAssetQuantity(const std::string &address, const std::string &assetName);
-
 bool CAssetsDB::WriteBlockUndoAssetData(const uint256& blockhash, const std::vector<std::pair<std::string, CBlockAssetUndo> >& assetUndoData)
 {
     return Write(std::make_pair(BLOCK_ASSET_UNDO_DATA, blockhash), assetUndoData);
@@ -98,11 +236,74 @@ bool CAssetsDB::ReadBlockUndoAssetData(const uint256 &blockhash, std::vector<std
     return true;
 }
 
+size_t CAssetsDB::EraseBlockUndoAssetData(const std::function<bool(const uint256&)>& fErase, size_t nMaxErase)
+{
+    std::unique_ptr<CDBIterator> pcursor(NewIterator());
+    pcursor->Seek(std::make_pair(BLOCK_ASSET_UNDO_DATA, uint256()));
+
+    CDBBatch batch(*this);
+    size_t nErased = 0;
+    while (pcursor->Valid() && nErased < nMaxErase) {
+        std::pair<char, uint256> key;
+        if (!pcursor->GetKey(key) || key.first != BLOCK_ASSET_UNDO_DATA)
+            break;
+        if (fErase(key.second)) {
+            batch.Erase(key);
+            nErased++;
+        }
+        pcursor->Next();
+    }
+    if (nErased && !WriteBatch(batch))
+        return 0;
+    return nErased;
+}
+
+void CAssetsDB::CompactBlockUndoAssetData()
+{
+    uint256 hashLast;
+    memset(hashLast.begin(), 0xff, hashLast.size());
+    CompactRange(std::make_pair(BLOCK_ASSET_UNDO_DATA, uint256()), std::make_pair(BLOCK_ASSET_UNDO_DATA, hashLast));
+}
+
 bool CAssetsDB::WriteReissuedMempoolState()
 {
     return Write(MEMPOOL_REISSUED_TX, mapReissuedAssets);
 }
 
+bool CAssetsDB::WriteHotAssets(const std::vector<std::string>& vNames)
+{
+    return Write(HOT_ASSETS_FLAG, vNames);
+}
+
+bool CAssetsDB::AddAssetSupply(const std::map<std::string, CAssetSupply>& mapDeltas)
+{
+    CDBBatch batch(*this);
+    for (const auto& item : mapDeltas) {
+        if (item.second.IsNull())
+            continue;
+
+        auto key = std::make_pair(ASSET_SUPPLY_FLAG, item.first);
+        CAssetSupply supply;
+        Read(key, supply);
+        supply += item.second;
+        if (supply.nOutputs < 0 || supply.nHeld < 0) {
+            LogPrintf("%s: supply of %s went negative, the asset index may need a -reindex\n", __func__, item.first);
+            supply = CAssetSupply(std::max<int64_t>(0, supply.nOutputs), std::max<CAmount>(0, supply.nHeld));
+        }
+
+        if (supply.IsNull())
+            batch.Erase(key);
+        else
+            batch.Write(key, supply);
+    }
+    return WriteBatch(batch);
+}
+
+bool CAssetsDB::ReadHotAssets(std::vector<std::string>& vNames)
+{
+    return Read(HOT_ASSETS_FLAG, vNames);
+}
+
 bool CAssetsDB::ReadReissuedMempoolState()
 {
     mapReissuedAssets.clear();
@@ -116,43 +317,282 @@ bool CAssetsDB::ReadReissuedMempoolState()
     return rv;
 }
 
-bool CAssetsDB::LoadAssets()
+template <typename Prefix, typename Name>
+bool CAssetsDB::IndexDirCounts(const char flag, const char countFlag)
 {
     std::unique_ptr<CDBIterator> pcursor(NewIterator());
+    pcursor->Seek(std::make_pair(flag, std::make_pair(Prefix(), Name())));
+
+    CDBBatch batch(*this);
+    Prefix prefix;
+    uint32_t nCount = 0;
+    while (pcursor->Valid()) {
+        boost::this_thread::interruption_point();
+        std::pair<char, std::pair<Prefix, Name> > key;
+        if (!pcursor->GetKey(key) || key.first != flag)
+            break;
+        if (key.second.first != prefix) {
+            if (nCount)
+                batch.Write(std::make_pair(countFlag, prefix), nCount);
+            prefix = key.second.first;
+            nCount = 0;
+        }
+        nCount++;
+        pcursor->Next();
+
+        if (batch.SizeEstimate() > (1 << 20)) {
+            if (!WriteBatch(batch))
+                return error("%s: failed to write entry counts", __func__);
+            batch.Clear();
+        }
+    }
+    if (nCount)
+        batch.Write(std::make_pair(countFlag, prefix), nCount);
+    if (!WriteBatch(batch))
+        return error("%s: failed to write entry counts", __func__);
 
+    return true;
+}
+
+// Databases written before the entry counts existed get them counted once here
+bool CAssetsDB::IndexDirCounts()
+{
+    if (Exists(DIR_COUNTS_INDEXED_FLAG))
+        return true;
+
+    LogPrintf("%s: counting asset holders and address assets, this is only done once\n", __func__);
+    if (!IndexDirCounts<std::string, CAddressKey>(ASSET_ADDRESS_QUANTITY_FLAG, ASSET_HOLDER_COUNT_FLAG))
+        return false;
+    if (!IndexDirCounts<CAddressKey, std::string>(ADDRESS_ASSET_QUANTITY_FLAG, ADDRESS_ASSET_COUNT_FLAG))
+        return false;
+
+    return Write(DIR_COUNTS_INDEXED_FLAG, true, true);
+}
+
+// Databases written before unique assets were indexed by collection get the index built once here
+bool CAssetsDB::IndexUniqueCollections()
+{
+    if (Exists(UNIQUE_COLLECTIONS_INDEXED_FLAG))
+        return true;
+
+    LogPrintf("%s: indexing unique assets by collection, this is only done once\n", __func__);
+    std::unique_ptr<CDBIterator> pcursor(NewIterator());
     pcursor->Seek(std::make_pair(ASSET_FLAG, std::string()));
 
-    // Load assets
+    // The asset entries are ordered by name length first, so a collection's tags are spread out
+    std::map<std::string, uint32_t> mapCounts;
+    CDBBatch batch(*this);
     while (pcursor->Valid()) {
         boost::this_thread::interruption_point();
         std::pair<char, std::string> key;
-        if (pcursor->GetKey(key) && key.first == ASSET_FLAG) {
+        if (!pcursor->GetKey(key) || key.first != ASSET_FLAG)
+            break;
+
+        std::string root, tag;
+        if (SplitUniqueAssetName(key.second, root, tag)) {
             CDatabasedAssetData data;
-            if (pcursor->GetValue(data)) {
-                passetsCache->Put(data.asset.strName, data);
-                pcursor->Next();
+            if (!pcursor->GetValue(data))
+                return error("%s: failed to read asset %s", __func__, key.second);
+            batch.Write(std::make_pair(UNIQUE_COLLECTION_FLAG, std::make_pair(root, tag)), data.asset.nAmount);
+            mapCounts[root]++;
+        }
+        pcursor->Next();
+
+        if (batch.SizeEstimate() > (1 << 20)) {
+            if (!WriteBatch(batch))
+                return error("%s: failed to write collection entries", __func__);
+            batch.Clear();
+        }
+    }
+    for (const auto& item : mapCounts)
+        batch.Write(std::make_pair(UNIQUE_COLLECTION_COUNT_FLAG, item.first), item.second);
+    batch.Write(UNIQUE_COLLECTIONS_INDEXED_FLAG, true);
+    if (!WriteBatch(batch, true))
+        return error("%s: failed to write collection entries", __func__);
+
+    LogPrintf("%s: indexed %u collections\n", __func__, mapCounts.size());
+    return true;
+}
+
+// Databases written before the asset tree existed get it built once here
+bool CAssetsDB::IndexAssetTree()
+{
+    if (Exists(ASSET_TREE_INDEXED_FLAG))
+        return true;
+
+    LogPrintf("%s: indexing the asset tree, this is only done once\n", __func__);
+    std::unique_ptr<CDBIterator> pcursor(NewIterator());
+    pcursor->Seek(std::make_pair(ASSET_FLAG, std::string()));
+
+    std::map<std::string, uint32_t> mapChildren, mapDescendants;
+    CDBBatch batch(*this);
+    while (pcursor->Valid()) {
+        boost::this_thread::interruption_point();
+        std::pair<char, std::string> key;
+        if (!pcursor->GetKey(key) || key.first != ASSET_FLAG)
+            break;
+
+        std::string parent;
+        if (GetAssetTreeParent(key.second, parent)) {
+            batch.Write(std::make_pair(ASSET_CHILD_FLAG, std::make_pair(parent, key.second)), ASSET_TREE_ENTRY);
+            mapChildren[parent]++;
+            do {
+                mapDescendants[parent]++;
+            } while (GetAssetTreeParent(parent, parent));
+        }
+        pcursor->Next();
+
+        if (batch.SizeEstimate() > (1 << 20)) {
+            if (!WriteBatch(batch))
+                return error("%s: failed to write asset tree entries", __func__);
+            batch.Clear();
+        }
+    }
+    for (const auto& item : mapChildren)
+        batch.Write(std::make_pair(ASSET_CHILD_COUNT_FLAG, item.first), item.second);
+    for (const auto& item : mapDescendants)
+        batch.Write(std::make_pair(ASSET_DESCENDANT_COUNT_FLAG, item.first), item.second);
+    batch.Write(ASSET_TREE_INDEXED_FLAG, true);
+    if (!WriteBatch(batch, true))
+        return error("%s: failed to write asset tree entries", __func__);
+
+    LogPrintf("%s: indexed the children of %u assets\n", __func__, mapChildren.size());
+    return true;
+}
 
-                // Loaded enough from database to have in memory.
-                // No need to load everything if it is just going to be removed from the cache
-                if (passetsCache->Size() == (passetsCache->MaxSize() / 2))
+// Databases written before the asset supply was kept get it counted from the coins once here
+bool CAssetsDB::IndexAssetSupply(CCoinsView* coins)
+{
+    // A wiped coins db is rebuilt from the genesis block, and the totals along with it
+    const bool fEmpty = coins->GetBestBlock().IsNull();
+    if (Exists(ASSET_SUPPLY_INDEXED_FLAG) && !fEmpty)
+        return true;
+
+    CDBBatch batch(*this);
+    std::unique_ptr<CDBIterator> pdbcursor(NewIterator());
+    pdbcursor->Seek(std::make_pair(ASSET_SUPPLY_FLAG, std::string()));
+    while (pdbcursor->Valid()) {
+        std::pair<char, std::string> key;
+        if (!pdbcursor->GetKey(key) || key.first != ASSET_SUPPLY_FLAG)
+            break;
+        batch.Erase(key);
+        pdbcursor->Next();
+    }
+    if (!WriteBatch(batch))
+        return error("%s: failed to clear the asset supply", __func__);
+    if (fEmpty)
+        return Write(ASSET_SUPPLY_INDEXED_FLAG, true, true);
+
+    LogPrintf("%s: counting the unspent outputs of each asset, this is only done once\n", __func__);
+    CAssetsCache counter;
+    std::unique_ptr<CCoinsViewCursor> pcursor(coins->Cursor());
+    for (; pcursor->Valid(); pcursor->Next()) {
+        boost::this_thread::interruption_point();
+        Coin coin;
+        if (!pcursor->GetValue(coin))
+            return error("%s: unable to read a coin", __func__);
+        if (coin.IsAsset())
+            counter.UpdateAssetSupply(coin.out, 1);
+    }
+    if (!AddAssetSupply(counter.mapAssetSupplyDelta) || !Write(ASSET_SUPPLY_INDEXED_FLAG, true, true))
+        return error("%s: failed to write the asset supply", __func__);
+
+    LogPrintf("%s: counted the outputs of %u assets\n", __func__, counter.mapAssetSupplyDelta.size());
+    return true;
+}
+
+/**
+ * Asset indexes written before the address entries were keyed by CAddressKey
+ * have them under base58 addresses. Move them to the binary keys once, a
+ * batch at a time so an interrupted run carries on where it stopped, and
+ * have IndexDirCounts count the per address entries again. Entries whose
+ * address doesn't decode can't be listed by address and are dropped.
+ */
+bool CAssetsDB::MigrateAddressKeys()
+{
+    auto fHasLegacy = [&](const char flag) {
+        std::unique_ptr<CDBIterator> pcursor(NewIterator());
+        pcursor->Seek(flag);
+        char key;
+        return pcursor->Valid() && pcursor->GetKey(key) && key == flag;
+    };
+    if (!fHasLegacy(LEGACY_ASSET_ADDRESS_QUANTITY_FLAG) && !fHasLegacy(LEGACY_ADDRESS_ASSET_QUANTITY_FLAG) && !fHasLegacy(LEGACY_ADDRESS_ASSET_COUNT_FLAG))
+        return true;
+
+    LogPrintf("%s: moving the asset index to binary address keys, this is only done once\n", __func__);
+    if (!Erase(DIR_COUNTS_INDEXED_FLAG, true))
+        return error("%s: failed to reset the entry counts", __func__);
+
+    size_t nMoved = 0;
+    size_t nDropped = 0;
+    for (const char flag : {LEGACY_ASSET_ADDRESS_QUANTITY_FLAG, LEGACY_ADDRESS_ASSET_QUANTITY_FLAG, LEGACY_ADDRESS_ASSET_COUNT_FLAG}) {
+        std::unique_ptr<CDBIterator> pcursor(NewIterator());
+        pcursor->Seek(flag);
+
+        CDBBatch batch(*this);
+        while (pcursor->Valid()) {
+            boost::this_thread::interruption_point();
+            if (flag == LEGACY_ADDRESS_ASSET_COUNT_FLAG) {
+                // Counted again from the moved entries
+                std::pair<char, std::string> key;
+                if (!pcursor->GetKey(key) || key.first != flag)
                     break;
+                batch.Erase(key);
             } else {
-                return error("%s: failed to read asset", __func__);
+                std::pair<char, std::pair<std::string, std::string> > key;
+                if (!pcursor->GetKey(key) || key.first != flag)
+                    break;
+                CAmount quantity;
+                if (!pcursor->GetValue(quantity))
+                    return error("%s: failed to read an address quantity", __func__);
+
+                const bool fAssetFirst = flag == LEGACY_ASSET_ADDRESS_QUANTITY_FLAG;
+                const std::string& assetName = fAssetFirst ? key.second.first : key.second.second;
+                const CAddressKey address = CAddressKey::FromString(fAssetFirst ? key.second.second : key.second.first);
+                if (address.IsNull()) {
+                    nDropped++;
+                } else if (fAssetFirst) {
+                    batch.Write(std::make_pair(ASSET_ADDRESS_QUANTITY_FLAG, std::make_pair(assetName, address)), quantity);
+                    nMoved++;
+                } else {
+                    batch.Write(std::make_pair(ADDRESS_ASSET_QUANTITY_FLAG, std::make_pair(address, assetName)), quantity);
+                }
+                batch.Erase(key);
+            }
+            pcursor->Next();
+
+            if (batch.SizeEstimate() > (1 << 20)) {
+                if (!WriteBatch(batch))
+                    return error("%s: failed to write the moved entries", __func__);
+                batch.Clear();
             }
-        } else {
-            break;
         }
+        if (!WriteBatch(batch, true))
+            return error("%s: failed to write the moved entries", __func__);
     }
 
+    LogPrintf("%s: moved %u balances, dropped %u entries without a valid address\n", __func__, nMoved, nDropped);
+    return true;
+}
+
+bool CAssetsDB::LoadAssets()
+{
+    // Asset metadata is no longer read here: lookups fill passetsCache as they
+    // miss, and StartHotAssetPrefetch refills it with the assets used before.
+    if (!IndexUniqueCollections() || !IndexAssetTree())
+        return false;
 
     if (fAssetIndex) {
+        if (!MigrateAddressKeys() || !IndexDirCounts())
+            return false;
+
         std::unique_ptr<CDBIterator> pcursor3(NewIterator());
-        pcursor3->Seek(std::make_pair(ASSET_ADDRESS_QUANTITY_FLAG, std::make_pair(std::string(), std::string())));
+        pcursor3->Seek(std::make_pair(ASSET_ADDRESS_QUANTITY_FLAG, std::make_pair(std::string(), CAddressKey())));
 
         // Load mapAssetAddressAmount
         while (pcursor3->Valid()) {
             boost::this_thread::interruption_point();
-            std::pair<char, std::pair<std::string, std::string> > key; // <Asset Name, Address> -> Quantity
+            std::pair<char, std::pair<std::string, CAddressKey> > key; // <Asset Name, Address> -> Quantity
             if (pcursor3->GetKey(key) && key.first == ASSET_ADDRESS_QUANTITY_FLAG) {
                 CAmount value;
                 if (pcursor3->GetValue(value)) {
@@ -173,18 +613,194 @@ bool CAssetsDB::LoadAssets()
     return true;
 }
 
+void CAssetsDB::PrefetchHotAssets()
+{
+    std::vector<std::string> vNames;
+    if (!ReadHotAssets(vNames))
+        return;
+
+    int64_t nStart = GetTimeMillis();
+    size_t nLoaded = 0;
+    for (size_t i = 0; i < vNames.size(); i += HOT_ASSETS_BATCH_SIZE) {
+        boost::this_thread::interruption_point();
+        // Under cs_main a block can't write newer data for these assets between
+        // reading them and putting them in the cache
+        LOCK(cs_main);
+        if (!passetsCache)
+            return;
+        for (size_t j = i; j < std::min(vNames.size(), i + HOT_ASSETS_BATCH_SIZE); j++) {
+            if (passetsCache->Exists(vNames[j]))
+                continue;
+            CNewAsset asset;
+            int nHeight;
+            uint256 blockHash;
+            if (ReadAssetData(vNames[j], asset, nHeight, blockHash)) {
+                passetsCache->Put(asset.strName, CDatabasedAssetData(asset, nHeight, blockHash));
+                nLoaded++;
+            }
+        }
+    }
+    LogPrintf("%s: loaded %u of %u assets in %dms\n", __func__, nLoaded, vNames.size(), GetTimeMillis() - nStart);
+}
+
+static void ThreadHotAssetPrefetch()
+{
+    RenameThread("mynta-assetload");
+    passetsdb->PrefetchHotAssets();
+}
+
+void StartHotAssetPrefetch(boost::thread_group& threadGroup)
+{
+    if (passetsdb && passetsCache)
+        threadGroup.create_thread(&ThreadHotAssetPrefetch);
+}
+
+namespace {
+/** Order of strings serialized into db keys: by length, then bytes (for lengths below 253) */
+struct CDBKeyStringLess
+{
+    bool operator()(const std::string& a, const std::string& b) const
+    {
+        return a.size() != b.size() ? a.size() < b.size() : a < b;
+    }
+};
+} // namespace
+
+std::shared_ptr<const CAssetsReadView> CAssetsDB::GetReadView()
+{
+    std::lock_guard<std::mutex> lock(csReadView);
+    if (!readView) {
+        std::shared_ptr<CAssetsReadView> view = std::make_shared<CAssetsReadView>();
+        view->snapshot = GetSnapshot();
+        readView = view;
+    }
+    return readView;
+}
+
+void CAssetsDB::PublishReadSnapshot()
+{
+    std::shared_ptr<CAssetsReadView> view = std::make_shared<CAssetsReadView>();
+    view->snapshot = GetSnapshot();
+
+    std::lock_guard<std::mutex> lock(csReadView);
+    readView = view;
+}
+
+void CAssetsDB::PublishReadDelta(std::shared_ptr<const CAssetsReadDelta> delta)
+{
+    if (delta->IsEmpty())
+        return;
+
+    std::lock_guard<std::mutex> lock(csReadView);
+    std::shared_ptr<CAssetsReadView> view = std::make_shared<CAssetsReadView>();
+    if (readView)
+        *view = *readView;
+    else
+        view->snapshot = GetSnapshot();
+    view->vDeltas.push_back(delta);
+    readView = view;
+}
+
+bool CAssetsDB::ReadAssetData(const CAssetsReadView& view, const std::string& strName, CDatabasedAssetData& data)
+{
+    for (auto it = view.vDeltas.rbegin(); it != view.vDeltas.rend(); ++it) {
+        auto itAsset = (*it)->mapAssets.find(strName);
+        if (itAsset != (*it)->mapAssets.end()) {
+            if (itAsset->second.first)
+                data = itAsset->second.second;
+            return itAsset->second.first;
+        }
+    }
+
+    return Read(std::make_pair(ASSET_FLAG, strName), data, view.snapshot.get());
+}
+
+bool CAssetsDB::ReadVerifier(const CAssetsReadView& view, const std::string& strName, std::string& verifier)
+{
+    for (auto it = view.vDeltas.rbegin(); it != view.vDeltas.rend(); ++it) {
+        auto itVerifier = (*it)->mapVerifiers.find(strName);
+        if (itVerifier != (*it)->mapVerifiers.end()) {
+            if (itVerifier->second.first)
+                verifier = itVerifier->second.second;
+            return itVerifier->second.first;
+        }
+    }
+
+    return prestricteddb && prestricteddb->ReadVerifier(strName, verifier);
+}
+
 bool CAssetsDB::AssetDir(std::vector<CDatabasedAssetData>& assets, const std::string filter, const size_t count, const long start)
 {
     FlushStateToDisk();
 
-    std::unique_ptr<CDBIterator> pcursor(NewIterator());
-    pcursor->Seek(std::make_pair(ASSET_FLAG, std::string()));
+    CAssetsReadView view;
+    view.snapshot = GetSnapshot();
+    return AssetDir(view, assets, filter, count, start);
+}
 
+bool CAssetsDB::AssetDir(const CAssetsReadView& view, std::vector<CDatabasedAssetData>& assets, const std::string filter, const size_t count, const long start)
+{
     auto prefix = filter;
     bool wildcard = prefix.back() == '*';
     if (wildcard)
         prefix.pop_back();
 
+    // The unique assets of one collection, ROOT#*, are paged from its index instead of filtering every asset
+    std::string root, tag;
+    if (wildcard && SplitUniqueAssetName(prefix + "A", root, tag) && tag == "A")
+        return CollectionAssets(view, assets, root, count, start);
+
+    auto matches = [&](const std::string& name) {
+        return prefix == "" || (wildcard && name.find(prefix) == 0) || (!wildcard && name == prefix);
+    };
+
+    // Matching assets the deltas changed, in db key order
+    std::map<std::string, std::pair<bool, CDatabasedAssetData>, CDBKeyStringLess> mapDelta;
+    for (const auto& delta : view.vDeltas) {
+        for (const auto& item : delta->mapAssets) {
+            if (matches(item.first))
+                mapDelta[item.first] = item.second;
+        }
+    }
+
+    // Walk the snapshot and the deltas together, calling fn on every matching asset until it returns false
+    auto walk = [&](const std::function<bool(const CDatabasedAssetData&)>& fn) {
+        std::unique_ptr<CDBIterator> pcursor(NewIterator(view.snapshot.get()));
+        pcursor->Seek(std::make_pair(ASSET_FLAG, std::string()));
+        auto itDelta = mapDelta.begin();
+
+        while (true) {
+            boost::this_thread::interruption_point();
+
+            std::pair<char, std::string> key;
+            bool fDb = pcursor->Valid() && pcursor->GetKey(key) && key.first == ASSET_FLAG;
+            if (fDb && !matches(key.second)) {
+                pcursor->Next();
+                continue;
+            }
+            if (!fDb && itDelta == mapDelta.end())
+                return true;
+
+            CDatabasedAssetData data;
+            if (itDelta != mapDelta.end() && (!fDb || !CDBKeyStringLess()(key.second, itDelta->first))) {
+                if (fDb && key.second == itDelta->first)
+                    pcursor->Next();
+                bool fExists = itDelta->second.first;
+                data = itDelta->second.second;
+                ++itDelta;
+                if (!fExists)
+                    continue;
+            } else {
+                if (!pcursor->GetValue(data))
+                    return error("%s: failed to read asset", __func__);
+                pcursor->Next();
+            }
+
+            if (!fn(data))
+                return true;
+        }
+    };
+
     size_t skip = 0;
     if (start >= 0) {
         skip = start;
@@ -192,199 +808,261 @@ bool CAssetsDB::AssetDir(std::vector<CDatabasedAssetData>& assets, const std::st
     else {
         // compute table size for backwards offset
         long table_size = 0;
-        while (pcursor->Valid()) {
-            boost::this_thread::interruption_point();
-
-            std::pair<char, std::string> key;
-            if (pcursor->GetKey(key) && key.first == ASSET_FLAG) {
-                if (prefix == "" ||
-                    (wildcard && key.second.find(prefix) == 0) ||
-                    (!wildcard && key.second == prefix)) {
-                    table_size += 1;
-                }
-            }
-            pcursor->Next();
-        }
-        skip = table_size + start;
-        pcursor->SeekToFirst();
+        if (!walk([&](const CDatabasedAssetData&) { table_size += 1; return true; }))
+            return false;
+        skip = std::max(0L, table_size + start);
     }
 
-
     size_t loaded = 0;
     size_t offset = 0;
 
     // Load assets
-    while (pcursor->Valid() && loaded < count) {
-        boost::this_thread::interruption_point();
-
-        std::pair<char, std::string> key;
-        if (pcursor->GetKey(key) && key.first == ASSET_FLAG) {
-            if (prefix == "" ||
-                    (wildcard && key.second.find(prefix) == 0) ||
-                    (!wildcard && key.second == prefix)) {
-                if (offset < skip) {
-                    offset += 1;
-                }
-                else {
-                    CDatabasedAssetData data;
-                    if (pcursor->GetValue(data)) {
-                        assets.push_back(data);
-                        loaded += 1;
-                    } else {
-                        return error("%s: failed to read asset", __func__);
-                    }
-                }
-            }
-            pcursor->Next();
+    return walk([&](const CDatabasedAssetData& data) {
+        if (loaded >= count)
+            return false;
+        if (offset < skip) {
+            offset += 1;
         } else {
-            break;
+            assets.push_back(data);
+            loaded += 1;
         }
-    }
-
-    return true;
+        return true;
+    });
 }
 
-bool CAssetsDB::AddressDir(std::vector<std::pair<std::string, CAmount> >& vecAssetAmount, int& totalEntries, const bool& fGetTotal, const std::string& address, const size_t count, const long start)
+/**
+ * List the entries under prefix in key order, or just count them, as of the
+ * view. Totals come from the entry counts, and a cursor seeks straight past
+ * the last name of the previous page, so neither walks the entries they don't
+ * return; only the deltas' entries under prefix are looked at one by one.
+ * NameLess is the order of the serialized names in the db.
+ */
+template <typename Prefix, typename Name, typename NameLess>
+bool CAssetsDB::DirEntries(const CAssetsReadView& view, const char flag, const char countFlag, std::map<std::pair<Prefix, Name>, CAmount> CAssetsReadDelta::*mapMember, std::vector<std::pair<Name, CAmount> >& vecNameAmount, int& totalEntries, const bool& fGetTotal, const Prefix& prefix, const size_t count, const long start, const Name* pStartAfter)
 {
-    FlushStateToDisk();
+    const CDBSnapshot* snapshot = view.snapshot.get();
+
+    // Entries under prefix the deltas changed, in db key order, 0 for erased
+    std::map<Name, CAmount, NameLess> mapDelta;
+    for (const auto& delta : view.vDeltas) {
+        const auto& mapAmounts = (*delta).*mapMember;
+        for (auto it = mapAmounts.lower_bound(std::make_pair(prefix, Name())); it != mapAmounts.end() && it->first.first == prefix; ++it)
+            mapDelta[it->first.second] = it->second;
+    }
 
-    std::unique_ptr<CDBIterator> pcursor(NewIterator());
-    pcursor->Seek(std::make_pair(ADDRESS_ASSET_QUANTITY_FLAG, std::make_pair(address, std::string())));
+    auto total = [&]() {
+        long nTotal = ReadDirCount(countFlag, prefix, snapshot);
+        for (const auto& item : mapDelta)
+            nTotal += (item.second != 0) - Exists(std::make_pair(flag, std::make_pair(prefix, item.first)), snapshot);
+        return std::max(0L, nTotal);
+    };
 
     if (fGetTotal) {
-        totalEntries = 0;
-        while (pcursor->Valid()) {
-            boost::this_thread::interruption_point();
-
-            std::pair<char, std::pair<std::string, std::string> > key;
-            if (pcursor->GetKey(key) && key.first == ADDRESS_ASSET_QUANTITY_FLAG && key.second.first == address) {
-                totalEntries++;
-            }
-            pcursor->Next();
-        }
+        totalEntries = total();
         return true;
     }
 
     size_t skip = 0;
     if (start >= 0) {
         skip = start;
-    }
-    else {
-        // compute table size for backwards offset
-        long table_size = 0;
-        while (pcursor->Valid()) {
-            boost::this_thread::interruption_point();
-
-            std::pair<char, std::pair<std::string, std::string> > key;
-            if (pcursor->GetKey(key) && key.first == ADDRESS_ASSET_QUANTITY_FLAG && key.second.first == address) {
-                table_size += 1;
-            }
-            pcursor->Next();
-        }
-        skip = table_size + start;
-        pcursor->SeekToFirst();
+    } else {
+        // Skip back from the end of the table
+        skip = std::max(0L, total() + start);
     }
 
+    std::unique_ptr<CDBIterator> pcursor(NewIterator(snapshot));
+    pcursor->Seek(std::make_pair(flag, std::make_pair(prefix, pStartAfter ? *pStartAfter : Name())));
+    auto itDelta = pStartAfter ? mapDelta.lower_bound(*pStartAfter) : mapDelta.begin();
 
     size_t loaded = 0;
     size_t offset = 0;
 
-    // Load assets
-    while (pcursor->Valid() && loaded < count && loaded < MAX_DATABASE_RESULTS) {
+    while (loaded < count && loaded < MAX_DATABASE_RESULTS) {
         boost::this_thread::interruption_point();
 
-        std::pair<char, std::pair<std::string, std::string> > key;
-        if (pcursor->GetKey(key) && key.first == ADDRESS_ASSET_QUANTITY_FLAG && key.second.first == address) {
-                if (offset < skip) {
-                    offset += 1;
-                }
-                else {
-                    CAmount amount;
-                    if (pcursor->GetValue(amount)) {
-                        vecAssetAmount.emplace_back(std::make_pair(key.second.second, amount));
-                        loaded += 1;
-                    } else {
-                        return error("%s: failed to Address Asset Quanity", __func__);
-                    }
-                }
+        std::pair<char, std::pair<Prefix, Name> > key;
+        bool fDb = pcursor->Valid() && pcursor->GetKey(key) && key.first == flag && key.second.first == prefix;
+        if (!fDb && itDelta == mapDelta.end())
+            break;
+
+        Name name;
+        CAmount amount;
+        if (itDelta != mapDelta.end() && (!fDb || !NameLess()(key.second.second, itDelta->first))) {
+            if (fDb && key.second.second == itDelta->first)
+                pcursor->Next();
+            name = itDelta->first;
+            amount = itDelta->second;
+            ++itDelta;
+            if (amount == 0)
+                continue;
+        } else {
+            name = key.second.second;
+            if (!pcursor->GetValue(amount))
+                return error("%s: failed to read quantity of %s in %s", __func__, DirPrefixString(name), DirPrefixString(prefix));
             pcursor->Next();
+        }
+
+        if (pStartAfter && name == *pStartAfter) {
+            // The cursor itself was returned with the previous page
+        } else if (offset < skip) {
+            offset += 1;
         } else {
-            break;
+            vecNameAmount.emplace_back(std::make_pair(name, amount));
+            loaded += 1;
         }
     }
 
     return true;
 }
 
-// Can get to total count of addresses that belong to a certain asset_name, or get you the list of all address that belong to a certain asset_name
-bool CAssetsDB::AssetAddressDir(std::vector<std::pair<std::string, CAmount> >& vecAddressAmount, int& totalEntries, const bool& fGetTotal, const std::string& assetName, const size_t count, const long start)
+bool CAssetsDB::AddressDir(std::vector<std::pair<std::string, CAmount> >& vecAssetAmount, int& totalEntries, const bool& fGetTotal, const std::string& address, const size_t count, const long start, const std::string& strStartAfter)
 {
     FlushStateToDisk();
 
-    std::unique_ptr<CDBIterator> pcursor(NewIterator());
-    pcursor->Seek(std::make_pair(ASSET_ADDRESS_QUANTITY_FLAG, std::make_pair(assetName, std::string())));
-
-    if (fGetTotal) {
-        totalEntries = 0;
-        while (pcursor->Valid()) {
-            boost::this_thread::interruption_point();
+    CAssetsReadView view;
+    view.snapshot = GetSnapshot();
+    return AddressDir(view, vecAssetAmount, totalEntries, fGetTotal, address, count, start, strStartAfter);
+}
 
-            std::pair<char, std::pair<std::string, std::string> > key;
-            if (pcursor->GetKey(key) && key.first == ASSET_ADDRESS_QUANTITY_FLAG && key.second.first == assetName) {
-                totalEntries += 1;
-            }
-            pcursor->Next();
-        }
+bool CAssetsDB::AddressDir(const CAssetsReadView& view, std::vector<std::pair<std::string, CAmount> >& vecAssetAmount, int& totalEntries, const bool& fGetTotal, const std::string& address, const size_t count, const long start, const std::string& strStartAfter)
+{
+    // An address that doesn't decode holds nothing
+    const CAddressKey addressKey = CAddressKey::FromString(address);
+    if (addressKey.IsNull()) {
+        if (fGetTotal)
+            totalEntries = 0;
         return true;
     }
 
-    size_t skip = 0;
-    if (start >= 0) {
-        skip = start;
+    return DirEntries<CAddressKey, std::string, CDBKeyStringLess>(view, ADDRESS_ASSET_QUANTITY_FLAG, ADDRESS_ASSET_COUNT_FLAG, &CAssetsReadDelta::mapAddressAssetAmount, vecAssetAmount, totalEntries, fGetTotal, addressKey, count, start, strStartAfter.empty() ? nullptr : &strStartAfter);
+}
+
+// Can get to total count of addresses that belong to a certain asset_name, or get you the list of all address that belong to a certain asset_name
+bool CAssetsDB::AssetAddressDir(std::vector<std::pair<std::string, CAmount> >& vecAddressAmount, int& totalEntries, const bool& fGetTotal, const std::string& assetName, const size_t count, const long start, const std::string& strStartAfter)
+{
+    FlushStateToDisk();
+
+    CAssetsReadView view;
+    view.snapshot = GetSnapshot();
+    return AssetAddressDir(view, vecAddressAmount, totalEntries, fGetTotal, assetName, count, start, strStartAfter);
+}
+
+bool CAssetsDB::AssetAddressDir(const CAssetsReadView& view, std::vector<std::pair<std::string, CAmount> >& vecAddressAmount, int& totalEntries, const bool& fGetTotal, const std::string& assetName, const size_t count, const long start, const std::string& strStartAfter)
+{
+    CAddressKey startAfter;
+    if (!strStartAfter.empty()) {
+        startAfter = CAddressKey::FromString(strStartAfter);
+        if (startAfter.IsNull())
+            return error("%s: can't continue after %s, it isn't a valid address", __func__, strStartAfter);
     }
-    else {
-        // compute table size for backwards offset
-        long table_size = 0;
-        while (pcursor->Valid()) {
-            boost::this_thread::interruption_point();
 
-            std::pair<char, std::pair<std::string, std::string> > key;
-            if (pcursor->GetKey(key) && key.first == ASSET_ADDRESS_QUANTITY_FLAG && key.second.first == assetName) {
-                table_size += 1;
-            }
-            pcursor->Next();
+    std::vector<std::pair<CAddressKey, CAmount> > vecKeyAmount;
+    if (!DirEntries<std::string, CAddressKey, std::less<CAddressKey> >(view, ASSET_ADDRESS_QUANTITY_FLAG, ASSET_HOLDER_COUNT_FLAG, &CAssetsReadDelta::mapAssetAddressAmount, vecKeyAmount, totalEntries, fGetTotal, assetName, count, start, strStartAfter.empty() ? nullptr : &startAfter))
+        return false;
+
+    for (const auto& item : vecKeyAmount)
+        vecAddressAmount.emplace_back(item.first.ToString(), item.second);
+    return true;
+}
+
+bool CAssetsDB::UniqueCollectionDir(std::vector<std::pair<std::string, CAmount> >& vecTagAmount, int& totalEntries, const bool& fGetTotal, const std::string& rootName, const size_t count, const long start, const std::string& strStartAfter)
+{
+    FlushStateToDisk();
+
+    CAssetsReadView view;
+    view.snapshot = GetSnapshot();
+    return UniqueCollectionDir(view, vecTagAmount, totalEntries, fGetTotal, rootName, count, start, strStartAfter);
+}
+
+bool CAssetsDB::UniqueCollectionDir(const CAssetsReadView& view, std::vector<std::pair<std::string, CAmount> >& vecTagAmount, int& totalEntries, const bool& fGetTotal, const std::string& rootName, const size_t count, const long start, const std::string& strStartAfter)
+{
+    return DirEntries<std::string, std::string, CDBKeyStringLess>(view, UNIQUE_COLLECTION_FLAG, UNIQUE_COLLECTION_COUNT_FLAG, &CAssetsReadDelta::mapUniqueCollection, vecTagAmount, totalEntries, fGetTotal, rootName, count, start, strStartAfter.empty() ? nullptr : &strStartAfter);
+}
+
+bool CAssetsDB::AssetChildrenDir(std::vector<std::pair<std::string, CAmount> >& vecChildren, int& totalEntries, const bool& fGetTotal, const std::string& parentName, const size_t count, const long start, const std::string& strStartAfter)
+{
+    FlushStateToDisk();
+
+    CAssetsReadView view;
+    view.snapshot = GetSnapshot();
+    return AssetChildrenDir(view, vecChildren, totalEntries, fGetTotal, parentName, count, start, strStartAfter);
+}
+
+bool CAssetsDB::AssetChildrenDir(const CAssetsReadView& view, std::vector<std::pair<std::string, CAmount> >& vecChildren, int& totalEntries, const bool& fGetTotal, const std::string& parentName, const size_t count, const long start, const std::string& strStartAfter)
+{
+    return DirEntries<std::string, std::string, CDBKeyStringLess>(view, ASSET_CHILD_FLAG, ASSET_CHILD_COUNT_FLAG, &CAssetsReadDelta::mapAssetTree, vecChildren, totalEntries, fGetTotal, parentName, count, start, strStartAfter.empty() ? nullptr : &strStartAfter);
+}
+
+uint32_t CAssetsDB::AssetDescendantCount(const CAssetsReadView& view, const std::string& name)
+{
+    const CDBSnapshot* snapshot = view.snapshot.get();
+    long nCount = ReadDirCount(ASSET_DESCENDANT_COUNT_FLAG, name, snapshot);
+
+    // Entries the deltas changed, latest first, that are somewhere below name
+    std::set<std::pair<std::string, std::string> > setSeen;
+    for (auto it = view.vDeltas.rbegin(); it != view.vDeltas.rend(); ++it) {
+        for (const auto& item : (*it)->mapAssetTree) {
+            if (!setSeen.insert(item.first).second)
+                continue;
+            std::string ancestor = item.first.first;
+            bool fBelow = false;
+            do {
+                fBelow = ancestor == name;
+            } while (!fBelow && GetAssetTreeParent(ancestor, ancestor));
+            if (fBelow)
+                nCount += (item.second != 0) - Exists(std::make_pair(ASSET_CHILD_FLAG, item.first), snapshot);
         }
-        skip = table_size + start;
-        pcursor->SeekToFirst();
     }
+    return std::max(0L, nCount);
+}
 
-    size_t loaded = 0;
-    size_t offset = 0;
+CAssetSupply CAssetsDB::ReadAssetSupply(const CAssetsReadView& view, const std::string& name)
+{
+    CAssetSupply supply;
+    Read(std::make_pair(ASSET_SUPPLY_FLAG, name), supply, view.snapshot.get());
+    for (const auto& delta : view.vDeltas) {
+        auto it = delta->mapAssetSupply.find(name);
+        if (it != delta->mapAssetSupply.end())
+            supply += it->second;
+    }
+    return supply;
+}
 
-    // Load assets
-    while (pcursor->Valid() && loaded < count && loaded < MAX_DATABASE_RESULTS) {
-        boost::this_thread::interruption_point();
+uint32_t CAssetsDB::AssetHolderCount(const CAssetsReadView& view, const std::string& name)
+{
+    std::vector<std::pair<std::string, CAmount> > vecAddressAmount;
+    int nTotal = 0;
+    if (!AssetAddressDir(view, vecAddressAmount, nTotal, true, name, 0, 0))
+        return 0;
+    return nTotal;
+}
 
-        std::pair<char, std::pair<std::string, std::string> > key;
-        if (pcursor->GetKey(key) && key.first == ASSET_ADDRESS_QUANTITY_FLAG && key.second.first == assetName) {
-            if (offset < skip) {
-                offset += 1;
-            }
-            else {
-                CAmount amount;
-                if (pcursor->GetValue(amount)) {
-                    vecAddressAmount.emplace_back(std::make_pair(key.second.second, amount));
-                    loaded += 1;
-                } else {
-                    return error("%s: failed to Asset Address Quanity", __func__);
-                }
-            }
-            pcursor->Next();
-        } else {
-            break;
+bool CAssetsDB::CollectionAssets(const CAssetsReadView& view, std::vector<CDatabasedAssetData>& assets, const std::string& rootName, const size_t count, const long start)
+{
+    // A page of DirEntries is at most MAX_DATABASE_RESULTS, so longer listings continue after the last tag
+    long nStart = start;
+    std::string strStartAfter;
+    size_t loaded = 0;
+    while (loaded < count) {
+        std::vector<std::pair<std::string, CAmount> > vecTagAmount;
+        int nTotal = 0;
+        const size_t nPage = std::min(count - loaded, MAX_DATABASE_RESULTS);
+        if (!UniqueCollectionDir(view, vecTagAmount, nTotal, false, rootName, nPage, nStart, strStartAfter))
+            return false;
+
+        for (const auto& item : vecTagAmount) {
+            CDatabasedAssetData data;
+            if (!ReadAssetData(view, rootName + "#" + item.first, data))
+                return error("%s: %s#%s is in the collection index but has no asset data", __func__, rootName, item.first);
+            assets.push_back(data);
         }
-    }
+        loaded += vecTagAmount.size();
 
+        if (vecTagAmount.size() < nPage)
+            break;
+        strStartAfter = vecTagAmount.back().first;
+        nStart = 0;
+    }
     return true;
 }
 
@@ -5,11 +5,15 @@
 #ifndef MYNTA_ASSETDB_H
 #define MYNTA_ASSETDB_H
 
+#include "assettypes.h"
 #include "fs.h"
 #include "serialize.h"
 
 #include <string>
+#include <functional>
 #include <map>
+#include <memory>
+#include <mutex>
 #include <dbwrapper.h>
 
 const int8_t ASSET_UNDO_INCLUDES_VERIFIER_STRING = -1;
@@ -18,6 +22,14 @@ class CNewAsset;
 class uint256;
 class COutPoint;
 class CDatabasedAssetData;
+class CCoinsView;
+
+namespace boost {
+class thread_group;
+} // namespace boost
+
+//! Most assets the hot asset list written at shutdown names
+static const size_t MAX_HOT_ASSETS = 25000;
 
 struct CBlockAssetUndo
 {
@@ -56,9 +68,68 @@ struct CBlockAssetUndo
     }
 };
 
+//! Value of the asset tree entries, which only mark that the child exists
+static const CAmount ASSET_TREE_ENTRY = 1;
+
+/**
+ * Asset state one connected or disconnected block changed on top of the
+ * assets db, in the form the db reads return it. Erased entries are kept with
+ * fExists false (metadata, verifiers) or a zero amount (balances).
+ */
+struct CAssetsReadDelta
+{
+    std::map<std::string, std::pair<bool, CDatabasedAssetData> > mapAssets;
+    std::map<std::string, std::pair<bool, std::string> > mapVerifiers;
+    std::map<std::pair<std::string, CAddressKey>, CAmount> mapAssetAddressAmount;
+    std::map<std::pair<CAddressKey, std::string>, CAmount> mapAddressAssetAmount;
+    //! <root, tag> of the unique assets issued or erased, with the amount or 0
+    std::map<std::pair<std::string, std::string>, CAmount> mapUniqueCollection;
+    //! <parent, name> of the assets issued or erased, ASSET_TREE_ENTRY or 0, see GetAssetTreeParent
+    std::map<std::pair<std::string, std::string>, CAmount> mapAssetTree;
+    //! Changes to the unspent outputs of each asset, added to the db totals rather than replacing them
+    std::map<std::string, CAssetSupply> mapAssetSupply;
+
+    bool IsEmpty() const { return mapAssets.empty() && mapVerifiers.empty() && mapAssetAddressAmount.empty() && mapAssetSupply.empty(); }
+};
+
+/**
+ * Immutable view of the asset state at the chain tip: a snapshot of the
+ * assets db pinned at the last flush plus the deltas of every block applied
+ * since, oldest first. RPCs read through it without cs_main.
+ */
+struct CAssetsReadView
+{
+    std::shared_ptr<const CDBSnapshot> snapshot;
+    std::vector<std::shared_ptr<const CAssetsReadDelta> > vDeltas;
+};
+
 /** Access to the block database (blocks/index/) */
 class CAssetsDB : public CDBWrapper
 {
+    // Address <-> asset quantity entries, with a count of entries kept per asset and per address
+    template <typename Prefix>
+    uint32_t ReadDirCount(const char countFlag, const Prefix& prefix, const CDBSnapshot* snapshot = nullptr) const;
+    template <typename Prefix>
+    void AdjustDirCount(CDBBatch& batch, const char countFlag, const Prefix& prefix, const int nDelta) const;
+    template <typename Prefix, typename Name>
+    bool WriteDirEntry(const char flag, const char countFlag, const Prefix& prefix, const Name& name, const CAmount& quantity);
+    template <typename Prefix, typename Name>
+    bool EraseDirEntry(const char flag, const char countFlag, const Prefix& prefix, const Name& name);
+    template <typename Prefix, typename Name, typename NameLess>
+    bool DirEntries(const CAssetsReadView& view, const char flag, const char countFlag, std::map<std::pair<Prefix, Name>, CAmount> CAssetsReadDelta::*mapMember, std::vector<std::pair<Name, CAmount> >& vecNameAmount, int& totalEntries, const bool& fGetTotal, const Prefix& prefix, const size_t count, const long start, const Name* pStartAfter);
+    template <typename Prefix, typename Name>
+    bool IndexDirCounts(const char flag, const char countFlag);
+    bool IndexDirCounts();
+    bool IndexUniqueCollections();
+    bool IndexAssetTree();
+    bool WriteAssetTreeEntry(const std::string& name);
+    bool EraseAssetTreeEntry(const std::string& name);
+    bool CollectionAssets(const CAssetsReadView& view, std::vector<CDatabasedAssetData>& assets, const std::string& rootName, const size_t count, const long start);
+    bool MigrateAddressKeys();
+
+    std::mutex csReadView;
+    std::shared_ptr<const CAssetsReadView> readView;
+
 public:
     explicit CAssetsDB(size_t nCacheSize, bool fMemory = false, bool fWipe = false);
 
@@ -67,32 +138,75 @@ public:
 
     // Write to database functions
     bool WriteAssetData(const CNewAsset& asset, const int nHeight, const uint256& blockHash);
-    bool WriteAssetAddressQuantity(const std::string& assetName, const std::string& address, const CAmount& quantity);
-    bool WriteAddressAssetQuantity( const std::string& address, const std::string& assetName, const CAmount& quantity);
+    bool WriteAssetAddressQuantity(const std::string& assetName, const CAddressKey& address, const CAmount& quantity);
+    bool WriteAddressAssetQuantity(const CAddressKey& address, const std::string& assetName, const CAmount& quantity);
     bool WriteBlockUndoAssetData(const uint256& blockhash, const std::vector<std::pair<std::string, CBlockAssetUndo> >& assetUndoData);
     bool WriteReissuedMempoolState();
+    bool WriteHotAssets(const std::vector<std::string>& vNames);
+    //! Add the changes to the unspent outputs of each asset to their totals
+    bool AddAssetSupply(const std::map<std::string, CAssetSupply>& mapDeltas);
 
     // Read from database functions
     bool ReadAssetData(const std::string& strName, CNewAsset& asset, int& nHeight, uint256& blockHash);
-    bool ReadAssetAddressQuantity(const std::string& assetName, const std::string& address, CAmount& quantity);
-    bool ReadAddressAssetQuantity(const std::string& address, const std::string& assetName, CAmount& quantity);
+    bool ReadAssetAddressQuantity(const std::string& assetName, const CAddressKey& address, CAmount& quantity);
+    bool ReadAddressAssetQuantity(const CAddressKey& address, const std::string& assetName, CAmount& quantity);
     bool ReadBlockUndoAssetData(const uint256& blockhash, std::vector<std::pair<std::string, CBlockAssetUndo> >& assetUndoData);
     bool ReadReissuedMempoolState();
+    //! Names of the assets that were in passetsCache at the last shutdown, most used first
+    bool ReadHotAssets(std::vector<std::string>& vNames);
 
     // Erase from database functions
     bool EraseAssetData(const std::string& assetName);
     bool EraseMyAssetData(const std::string& assetName);
-    bool EraseAssetAddressQuantity(const std::string &assetName, const std::string &address);
-    bool EraseAddressAssetQuantity(const std::string &address, const std::string &assetName);
+    bool EraseAssetAddressQuantity(const std::string &assetName, const CAddressKey &address);
+    bool EraseAddressAssetQuantity(const CAddressKey &address, const std::string &assetName);
+    //! Erase the undo data of up to nMaxErase blocks fErase picks, in one batch; returns how many
+    size_t EraseBlockUndoAssetData(const std::function<bool(const uint256&)>& fErase, size_t nMaxErase);
+    //! Compact the block undo data, after erasing some
+    void CompactBlockUndoAssetData();
 
     // Helper functions
     bool LoadAssets();
+    //! Count the asset outputs already in the coins db, once; coins must be at the same block as the assets db
+    bool IndexAssetSupply(CCoinsView* coins);
+    //! Put the assets of the hot asset list into passetsCache, a few at a time under cs_main
+    void PrefetchHotAssets();
     bool AssetDir(std::vector<CDatabasedAssetData>& assets, const std::string filter, const size_t count, const long start);
     bool AssetDir(std::vector<CDatabasedAssetData>& assets);
 
-    bool AddressDir(std::vector<std::pair<std::string, CAmount> >& vecAssetAmount, int& totalEntries, const bool& fGetTotal, const std::string& address, const size_t count, const long start);
-    bool AssetAddressDir(std::vector<std::pair<std::string, CAmount> >& vecAddressAmount, int& totalEntries, const bool& fGetTotal, const std::string& assetName, const size_t count, const long start);
+    // Addresses are base58 here, as the RPCs take and show them; the db keys them by CAddressKey.
+    // strStartAfter continues a listing from the last name of the previous page, start then counts from there
+    bool AddressDir(std::vector<std::pair<std::string, CAmount> >& vecAssetAmount, int& totalEntries, const bool& fGetTotal, const std::string& address, const size_t count, const long start, const std::string& strStartAfter = "");
+    bool AssetAddressDir(std::vector<std::pair<std::string, CAmount> >& vecAddressAmount, int& totalEntries, const bool& fGetTotal, const std::string& assetName, const size_t count, const long start, const std::string& strStartAfter = "");
+    //! The tags of the unique assets ROOT#TAG issued under rootName, in db key order, paged like AddressDir
+    bool UniqueCollectionDir(std::vector<std::pair<std::string, CAmount> >& vecTagAmount, int& totalEntries, const bool& fGetTotal, const std::string& rootName, const size_t count, const long start, const std::string& strStartAfter = "");
+    //! The assets hanging directly off parentName in the asset tree (see GetAssetTreeParent), paged like AddressDir
+    bool AssetChildrenDir(std::vector<std::pair<std::string, CAmount> >& vecChildren, int& totalEntries, const bool& fGetTotal, const std::string& parentName, const size_t count, const long start, const std::string& strStartAfter = "");
+
+    // Snapshot reads for RPCs, see CAssetsReadView; none of these need cs_main
+    std::shared_ptr<const CAssetsReadView> GetReadView();
+    //! Pin a new snapshot and drop the deltas; call after the asset cache was dumped to the db
+    void PublishReadSnapshot();
+    //! Append the changes of a block that were just flushed into passets
+    void PublishReadDelta(std::shared_ptr<const CAssetsReadDelta> delta);
+
+    bool ReadAssetData(const CAssetsReadView& view, const std::string& strName, CDatabasedAssetData& data);
+    //! Verifier string of a restricted asset; these live in the restricted db, which is read at its latest state
+    bool ReadVerifier(const CAssetsReadView& view, const std::string& strName, std::string& verifier);
+    bool AssetDir(const CAssetsReadView& view, std::vector<CDatabasedAssetData>& assets, const std::string filter, const size_t count, const long start);
+    bool AddressDir(const CAssetsReadView& view, std::vector<std::pair<std::string, CAmount> >& vecAssetAmount, int& totalEntries, const bool& fGetTotal, const std::string& address, const size_t count, const long start, const std::string& strStartAfter = "");
+    bool AssetAddressDir(const CAssetsReadView& view, std::vector<std::pair<std::string, CAmount> >& vecAddressAmount, int& totalEntries, const bool& fGetTotal, const std::string& assetName, const size_t count, const long start, const std::string& strStartAfter = "");
+    bool UniqueCollectionDir(const CAssetsReadView& view, std::vector<std::pair<std::string, CAmount> >& vecTagAmount, int& totalEntries, const bool& fGetTotal, const std::string& rootName, const size_t count, const long start, const std::string& strStartAfter = "");
+    bool AssetChildrenDir(const CAssetsReadView& view, std::vector<std::pair<std::string, CAmount> >& vecChildren, int& totalEntries, const bool& fGetTotal, const std::string& parentName, const size_t count, const long start, const std::string& strStartAfter = "");
+    //! Number of assets anywhere below name in the asset tree, kept up to date as they are issued
+    uint32_t AssetDescendantCount(const CAssetsReadView& view, const std::string& name);
+    //! Unspent outputs of an asset and what they hold, kept up to date as blocks connect and disconnect
+    CAssetSupply ReadAssetSupply(const CAssetsReadView& view, const std::string& name);
+    //! Addresses holding an asset; only kept with -assetindex
+    uint32_t AssetHolderCount(const CAssetsReadView& view, const std::string& name);
 };
 
+/** Start the thread that refills passetsCache from the hot asset list */
+void StartHotAssetPrefetch(boost::thread_group& threadGroup);
 
 #endif //MYNTA_ASSETDB_H
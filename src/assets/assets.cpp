@@ -2,7 +2,7 @@
 // Distributed under the MIT software license, see the accompanying
 // file COPYING or http://www.opensource.org/licenses/mit-license.php.
 
-#include <regex>
+#include <algorithm>
 #include <script/script.h>
 #include <version.h>
 #include <streams.h>
@@ -44,99 +44,177 @@ std::map<std::string, uint256> mapReissuedAssets;
 static const auto MAX_NAME_LENGTH = 31;
 static const auto MAX_CHANNEL_NAME_LENGTH = 12;
 
-// min lengths are expressed by quantifiers
-static const std::regex ROOT_NAME_CHARACTERS("^[A-Z0-9._]{3,}$");
-static const std::regex SUB_NAME_CHARACTERS("^[A-Z0-9._]+$");
-static const std::regex UNIQUE_TAG_CHARACTERS("^[-A-Za-z0-9@$%&*()[\\]{}_.?:]+$");
-static const std::regex MSG_CHANNEL_TAG_CHARACTERS("^[A-Za-z0-9_]+$");
-static const std::regex VOTE_TAG_CHARACTERS("^[A-Z0-9._]+$");
-
-// Restricted assets
-static const std::regex QUALIFIER_NAME_CHARACTERS("#[A-Z0-9._]{3,}$");
-static const std::regex SUB_QUALIFIER_NAME_CHARACTERS("#[A-Z0-9._]+$");
-static const std::regex RESTRICTED_NAME_CHARACTERS("\\$[A-Z0-9._]{3,}$");
-
-static const std::regex DOUBLE_PUNCTUATION("^.*[._]{2,}.*$");
-static const std::regex LEADING_PUNCTUATION("^[._].*$");
-static const std::regex TRAILING_PUNCTUATION("^.*[._]$");
-static const std::regex QUALIFIER_LEADING_PUNCTUATION("^[#\\$][._].*$"); // Used for qualifier assets, and restricted asset only
-
 static const std::string SUB_NAME_DELIMITER = "/";
 static const std::string UNIQUE_TAG_DELIMITER = "#";
 static const std::string MSG_CHANNEL_TAG_DELIMITER = "~";
 static const std::string VOTE_TAG_DELIMITER = "^";
 static const std::string RESTRICTED_TAG_DELIMITER = "$";
 
-static const std::regex UNIQUE_INDICATOR(R"(^[^^~#!]+#[^~#!\/]+$)");
-static const std::regex MSG_CHANNEL_INDICATOR(R"(^[^^~#!]+~[^~#!\/]+$)");
-static const std::regex OWNER_INDICATOR(R"(^[^^~#!]+!$)");
-static const std::regex VOTE_INDICATOR(R"(^[^^~#!]+\^[^~#!\/]+$)");
+static const char* const RAVEN_NAMES[] = {"RVN", "RAVEN", "RAVENCOIN", "#RVN", "#RAVEN", "#RAVENCOIN"};
+
+// Asset names are parsed for every asset output seen, so the formats below are
+// checked by hand in a single pass over the name.
+
+//! [A-Z0-9._]
+static inline bool IsNameChar(char c)
+{
+    return (c >= 'A' && c <= 'Z') || (c >= '0' && c <= '9') || c == '.' || c == '_';
+}
+
+static inline bool IsNamePunctuation(char c)
+{
+    return c == '.' || c == '_';
+}
 
-static const std::regex QUALIFIER_INDICATOR("^[#][A-Z0-9._]{3,}$"); // Starts with #
-static const std::regex SUB_QUALIFIER_INDICATOR("^#[A-Z0-9._]+\\/#[A-Z0-9._]+$"); // Starts with #
-static const std::regex RESTRICTED_INDICATOR("^[\\$][A-Z0-9._]{3,}$"); // Starts with $
+//! [A-Za-z0-9_]
+static inline bool IsMsgChannelTagChar(char c)
+{
+    return (c >= 'A' && c <= 'Z') || (c >= 'a' && c <= 'z') || (c >= '0' && c <= '9') || c == '_';
+}
+
+//! [-A-Za-z0-9@$%&*()[\]{}_.?:]
+static inline bool IsUniqueTagChar(char c)
+{
+    if ((c >= 'A' && c <= 'Z') || (c >= 'a' && c <= 'z') || (c >= '0' && c <= '9'))
+        return true;
+    switch (c) {
+        case '-': case '@': case '$': case '%': case '&': case '*': case '(': case ')':
+        case '[': case ']': case '{': case '}': case '_': case '.': case '?': case ':':
+            return true;
+        default:
+            return false;
+    }
+}
 
-static const std::regex RAVEN_NAMES("^RVN$|^RAVEN$|^RAVENCOIN$|^#RVN$|^#RAVEN$|^#RAVENCOIN$");
+/**
+ * Whether name[nBegin..] has at least nMinLength characters, all accepted by
+ * IsChar, and neither ends in punctuation nor has two punctuation characters in
+ * a row. With fLeading it may not start with punctuation either.
+ */
+template <typename CharCheck>
+static bool IsNameBodyValid(const std::string& name, size_t nBegin, size_t nMinLength, CharCheck IsChar, bool fLeading)
+{
+    if (name.size() < nBegin + nMinLength)
+        return false;
+
+    bool fPrevPunctuation = false;
+    for (size_t i = nBegin; i < name.size(); i++) {
+        const char c = name[i];
+        if (!IsChar(c))
+            return false;
+        const bool fPunctuation = IsNamePunctuation(c);
+        if (fPunctuation && (fPrevPunctuation || (fLeading && i == nBegin)))
+            return false;
+        fPrevPunctuation = fPunctuation;
+    }
+    return !fPrevPunctuation;
+}
+
+static bool IsRavenName(const std::string& name)
+{
+    for (const char* reserved : RAVEN_NAMES) {
+        if (name == reserved)
+            return true;
+    }
+    return false;
+}
 
 bool IsRootNameValid(const std::string& name)
 {
-    return std::regex_match(name, ROOT_NAME_CHARACTERS)
-        && !std::regex_match(name, DOUBLE_PUNCTUATION)
-        && !std::regex_match(name, LEADING_PUNCTUATION)
-        && !std::regex_match(name, TRAILING_PUNCTUATION)
-        && !std::regex_match(name, RAVEN_NAMES);
+    return IsNameBodyValid(name, 0, MIN_ASSET_LENGTH, IsNameChar, true)
+        && !IsRavenName(name);
 }
 
 bool IsQualifierNameValid(const std::string& name)
 {
-    return std::regex_match(name, QUALIFIER_NAME_CHARACTERS)
-           && !std::regex_match(name, DOUBLE_PUNCTUATION)
-           && !std::regex_match(name, QUALIFIER_LEADING_PUNCTUATION)
-           && !std::regex_match(name, TRAILING_PUNCTUATION)
-           && !std::regex_match(name, RAVEN_NAMES);
+    return !name.empty() && name[0] == '#'
+           && IsNameBodyValid(name, 1, MIN_ASSET_LENGTH, IsNameChar, true)
+           && !IsRavenName(name);
 }
 
 bool IsRestrictedNameValid(const std::string& name)
 {
-    return std::regex_match(name, RESTRICTED_NAME_CHARACTERS)
-           && !std::regex_match(name, DOUBLE_PUNCTUATION)
-           && !std::regex_match(name, LEADING_PUNCTUATION)
-           && !std::regex_match(name, TRAILING_PUNCTUATION)
-           && !std::regex_match(name, RAVEN_NAMES);
+    // The leading punctuation rule applies to the '$', so never fails
+    return !name.empty() && name[0] == '$'
+           && IsNameBodyValid(name, 1, MIN_ASSET_LENGTH, IsNameChar, false);
 }
 
 bool IsSubQualifierNameValid(const std::string& name)
 {
-    return std::regex_match(name, SUB_QUALIFIER_NAME_CHARACTERS)
-           && !std::regex_match(name, DOUBLE_PUNCTUATION)
-           && !std::regex_match(name, LEADING_PUNCTUATION)
-           && !std::regex_match(name, TRAILING_PUNCTUATION);
+    // As for restricted names, only the '#' is checked for leading punctuation
+    return !name.empty() && name[0] == '#'
+           && IsNameBodyValid(name, 1, 1, IsNameChar, false);
 }
 
 bool IsSubNameValid(const std::string& name)
 {
-    return std::regex_match(name, SUB_NAME_CHARACTERS)
-        && !std::regex_match(name, DOUBLE_PUNCTUATION)
-        && !std::regex_match(name, LEADING_PUNCTUATION)
-        && !std::regex_match(name, TRAILING_PUNCTUATION);
+    return IsNameBodyValid(name, 0, 1, IsNameChar, true);
 }
 
 bool IsUniqueTagValid(const std::string& tag)
 {
-    return std::regex_match(tag, UNIQUE_TAG_CHARACTERS);
+    return !tag.empty() && std::all_of(tag.begin(), tag.end(), IsUniqueTagChar);
 }
 
 bool IsVoteTagValid(const std::string& tag)
 {
-    return std::regex_match(tag, VOTE_TAG_CHARACTERS);
+    return !tag.empty() && std::all_of(tag.begin(), tag.end(), IsNameChar);
 }
 
 bool IsMsgChannelTagValid(const std::string &tag)
 {
-    return std::regex_match(tag, MSG_CHANNEL_TAG_CHARACTERS)
-        && !std::regex_match(tag, DOUBLE_PUNCTUATION)
-        && !std::regex_match(tag, LEADING_PUNCTUATION)
-        && !std::regex_match(tag, TRAILING_PUNCTUATION);
+    return IsNameBodyValid(tag, 0, 1, IsMsgChannelTagChar, true);
+}
+
+AssetType GetAssetNameIndicator(const std::string& name)
+{
+    const size_t npos = std::string::npos;
+    size_t nHash = 0, nTilde = 0, nBang = 0, nSlash = 0, nNameCharsAfterFirst = 0;
+    size_t nFirstHash = npos, nFirstTilde = npos, nFirstCaret = npos, nLastSlash = npos;
+    for (size_t i = 0; i < name.size(); i++) {
+        const char c = name[i];
+        if (IsNameChar(c)) {
+            if (i > 0)
+                nNameCharsAfterFirst++;
+            continue;
+        }
+        switch (c) {
+            case '#': if (nHash++ == 0) nFirstHash = i; break;
+            case '~': if (nTilde++ == 0) nFirstTilde = i; break;
+            case '^': if (nFirstCaret == npos) nFirstCaret = i; break;
+            case '!': nBang++; break;
+            case '/': nSlash++; nLastSlash = i; break;
+        }
+    }
+
+    const size_t nSize = name.size();
+    // ROOT#TAG, ROOT~CHANNEL and ROOT^TAG: a root part free of ^~#! and a tag free of ~#!/ around the one delimiter
+    auto fTagged = [&](size_t nDelimiter) {
+        return nDelimiter > 0 && nDelimiter + 1 < nSize
+            && (nFirstCaret == npos || nFirstCaret >= nDelimiter)
+            && (nLastSlash == npos || nLastSlash < nDelimiter);
+    };
+
+    if (nHash == 1 && nTilde == 0 && nBang == 0 && fTagged(nFirstHash))
+        return AssetType::UNIQUE;
+    if (nTilde == 1 && nHash == 0 && nBang == 0 && fTagged(nFirstTilde))
+        return AssetType::MSGCHANNEL;
+    if (nBang == 1 && nSize >= 2 && name[nSize - 1] == '!' && nHash == 0 && nTilde == 0 && nFirstCaret == npos)
+        return AssetType::OWNER;
+    if (nFirstCaret != npos && nHash == 0 && nTilde == 0 && nBang == 0 && fTagged(nFirstCaret))
+        return AssetType::VOTE;
+    if (nSize > 0 && name[0] == '#') {
+        // #NAME, or #NAME/#SUB
+        if (nSize >= 1 + MIN_ASSET_LENGTH && nNameCharsAfterFirst == nSize - 1)
+            return AssetType::QUALIFIER;
+        if (nHash == 2 && nSlash == 1 && nLastSlash >= 2 && nLastSlash + 2 < nSize && name[nLastSlash + 1] == '#'
+                && nNameCharsAfterFirst == nSize - 3)
+            return AssetType::SUB_QUALIFIER;
+    }
+    if (nSize >= 1 + MIN_ASSET_LENGTH && name[0] == '$' && nNameCharsAfterFirst == nSize - 1)
+        return AssetType::RESTRICTED;
+
+    return AssetType::INVALID;
 }
 
 bool IsNameValidBeforeTag(const std::string& name)
@@ -210,39 +288,17 @@ bool IsAssetNameValid(const std::string& name, AssetType& assetType, std::string
         return false;
 
     assetType = AssetType::INVALID;
-    if (std::regex_match(name, UNIQUE_INDICATOR))
-    {
-        bool ret = IsTypeCheckNameValid(AssetType::UNIQUE, name, error);
-        if (ret)
-            assetType = AssetType::UNIQUE;
-
-        return ret;
-    }
-    else if (std::regex_match(name, MSG_CHANNEL_INDICATOR))
-    {
-        bool ret = IsTypeCheckNameValid(AssetType::MSGCHANNEL, name, error);
-        if (ret)
-            assetType = AssetType::MSGCHANNEL;
-
-        return ret;
-    }
-    else if (std::regex_match(name, OWNER_INDICATOR))
+    const AssetType indicator = GetAssetNameIndicator(name);
+    if (indicator == AssetType::UNIQUE || indicator == AssetType::MSGCHANNEL || indicator == AssetType::OWNER
+            || indicator == AssetType::VOTE || indicator == AssetType::RESTRICTED)
     {
-        bool ret = IsTypeCheckNameValid(AssetType::OWNER, name, error);
+        bool ret = IsTypeCheckNameValid(indicator, name, error);
         if (ret)
-            assetType = AssetType::OWNER;
+            assetType = indicator;
 
         return ret;
     }
-    else if (std::regex_match(name, VOTE_INDICATOR))
-    {
-        bool ret = IsTypeCheckNameValid(AssetType::VOTE, name, error);
-        if (ret)
-            assetType = AssetType::VOTE;
-
-        return ret;
-    }
-    else if (std::regex_match(name, QUALIFIER_INDICATOR))
+    else if (indicator == AssetType::QUALIFIER)
     {
         bool ret = IsTypeCheckNameValid(AssetType::QUALIFIER, name, error);
         if (ret) {
@@ -254,7 +310,7 @@ bool IsAssetNameValid(const std::string& name, AssetType& assetType, std::string
 
         return ret;
     }
-    else if (std::regex_match(name, SUB_QUALIFIER_INDICATOR))
+    else if (indicator == AssetType::SUB_QUALIFIER)
     {
         bool ret = IsTypeCheckNameValid(AssetType::SUB_QUALIFIER, name, error);
         if (ret) {
@@ -264,14 +320,6 @@ bool IsAssetNameValid(const std::string& name, AssetType& assetType, std::string
 
         return ret;
     }
-    else if (std::regex_match(name, RESTRICTED_INDICATOR))
-    {
-        bool ret = IsTypeCheckNameValid(AssetType::RESTRICTED, name, error);
-        if (ret)
-            assetType = AssetType::RESTRICTED;
-
-        return ret;
-    }
     else
     {
         auto type = IsAssetNameASubasset(name) ? AssetType::SUB : AssetType::ROOT;
@@ -304,26 +352,27 @@ bool IsAssetNameARoot(const std::string& name)
 
 bool IsAssetNameAnOwner(const std::string& name)
 {
-    return IsAssetNameValid(name) && std::regex_match(name, OWNER_INDICATOR);
+    return IsAssetNameValid(name) && GetAssetNameIndicator(name) == AssetType::OWNER;
 }
 
 bool IsAssetNameAnRestricted(const std::string& name)
 {
-    return IsAssetNameValid(name) && std::regex_match(name, RESTRICTED_INDICATOR);
+    return IsAssetNameValid(name) && GetAssetNameIndicator(name) == AssetType::RESTRICTED;
 }
 
 bool IsAssetNameAQualifier(const std::string& name, bool fOnlyQualifiers)
 {
     if (fOnlyQualifiers) {
-        return IsAssetNameValid(name) && std::regex_match(name, QUALIFIER_INDICATOR);
+        return IsAssetNameValid(name) && GetAssetNameIndicator(name) == AssetType::QUALIFIER;
     }
 
-    return IsAssetNameValid(name) && (std::regex_match(name, QUALIFIER_INDICATOR) || std::regex_match(name, SUB_QUALIFIER_INDICATOR));
+    const AssetType indicator = GetAssetNameIndicator(name);
+    return IsAssetNameValid(name) && (indicator == AssetType::QUALIFIER || indicator == AssetType::SUB_QUALIFIER);
 }
 
 bool IsAssetNameAnMsgChannel(const std::string& name)
 {
-    return IsAssetNameValid(name) && std::regex_match(name, MSG_CHANNEL_INDICATOR);
+    return IsAssetNameValid(name) && GetAssetNameIndicator(name) == AssetType::MSGCHANNEL;
 }
 
 // TODO get the string translated below
@@ -421,6 +470,50 @@ std::string GetParentName(const std::string& name)
     return name;
 }
 
+bool GetAssetTreeParent(const std::string& name, std::string& parent)
+{
+    size_t nEnd = std::string::npos;
+    switch (GetAssetNameIndicator(name)) {
+        case AssetType::UNIQUE:
+            nEnd = name.find(UNIQUE_TAG_DELIMITER);
+            break;
+        case AssetType::MSGCHANNEL:
+            nEnd = name.find(MSG_CHANNEL_TAG_DELIMITER);
+            break;
+        case AssetType::VOTE:
+            nEnd = name.find(VOTE_TAG_DELIMITER);
+            break;
+        case AssetType::OWNER:
+            nEnd = name.size() - 1;
+            break;
+        case AssetType::QUALIFIER:
+        case AssetType::RESTRICTED:
+            // #NAME and $NAME hang off NAME
+            parent = name.substr(1);
+            return true;
+        case AssetType::SUB_QUALIFIER:
+        default:
+            nEnd = name.find_last_of(SUB_NAME_DELIMITER);
+            break;
+    }
+
+    if (nEnd == std::string::npos || nEnd == 0)
+        return false;
+    parent = name.substr(0, nEnd);
+    return true;
+}
+
+bool SplitUniqueAssetName(const std::string& name, std::string& root, std::string& tag)
+{
+    if (GetAssetNameIndicator(name) != AssetType::UNIQUE)
+        return false;
+
+    const size_t nDelimiter = name.find(UNIQUE_TAG_DELIMITER);
+    root = name.substr(0, nDelimiter);
+    tag = name.substr(nDelimiter + 1);
+    return true;
+}
+
 std::string GetUniqueAssetName(const std::string& parent, const std::string& tag)
 {
     std::string unique = parent + "#" + tag;
@@ -660,255 +753,250 @@ bool OwnerFromTransaction(const CTransaction& tx, std::string& ownerName, std::s
     return OwnerAssetFromScript(scriptPubKey, ownerName, strAddress);
 }
 
-bool TransferAssetFromScript(const CScript& scriptPubKey, CAssetTransfer& assetTransfer, std::string& strAddress)
+/** Deserialize an asset object in place from a payload inside a script */
+template <typename T>
+static bool UnserializeAssetPayload(const unsigned char* pData, size_t nSize, T& obj, const char* strWhat)
 {
-    int nStartingIndex = 0;
-    if (!IsScriptTransferAsset(scriptPubKey, nStartingIndex)) {
-        return false;
-    }
-
-    CTxDestination destination;
-    ExtractDestination(scriptPubKey, destination);
-
-    strAddress = EncodeDestination(destination);
-
-    std::vector<unsigned char> vchTransferAsset;
-
-    if (AreTransferScriptsSizeDeployed()) {
-        // Before kawpow activation we used the hardcoded 31 to find the data
-        // This created a bug where large transfers scripts would fail to serialize.
-        // This fixes that issue (https://github.com/RavenProject/Ravencoin/issues/752)
-        // TODO, after the kawpow fork goes active, we should be able to remove this if/else statement and just use this line.
-        vchTransferAsset.insert(vchTransferAsset.end(), scriptPubKey.begin() + nStartingIndex, scriptPubKey.end());
-    } else {
-        vchTransferAsset.insert(vchTransferAsset.end(), scriptPubKey.begin() + 31, scriptPubKey.end());
-    }
-
-    CDataStream ssAsset(vchTransferAsset, SER_NETWORK, PROTOCOL_VERSION);
+    CSpanReader ssAsset(SER_NETWORK, PROTOCOL_VERSION, pData, nSize);
 
     try {
-        ssAsset >> assetTransfer;
+        ssAsset >> obj;
     } catch(std::exception& e) {
-        error("Failed to get the transfer asset from the stream: %s", e.what());
+        error("Failed to get the %s from the stream: %s", strWhat, e.what());
         return false;
     }
 
     return true;
 }
 
-bool AssetFromScript(const CScript& scriptPubKey, CNewAsset& assetNew, std::string& strAddress)
+static std::string AddressFromAssetScript(const CScript& scriptPubKey)
 {
-    int nStartingIndex = 0;
-    if (!IsScriptNewAsset(scriptPubKey, nStartingIndex))
-        return false;
-
     CTxDestination destination;
     ExtractDestination(scriptPubKey, destination);
 
-    strAddress = EncodeDestination(destination);
+    return EncodeDestination(destination);
+}
 
-    std::vector<unsigned char> vchNewAsset;
-    vchNewAsset.insert(vchNewAsset.end(), scriptPubKey.begin() + nStartingIndex, scriptPubKey.end());
-    CDataStream ssAsset(vchNewAsset, SER_NETWORK, PROTOCOL_VERSION);
+bool DecodeAssetScript(const CScript& script, CAssetScriptView& view)
+{
+    view = CAssetScriptView();
 
-    try {
-        ssAsset >> assetNew;
-    } catch(std::exception& e) {
-        error("Failed to get the asset from the stream: %s", e.what());
-        return false;
+    int nType = 0;
+    bool fIsOwner = false;
+    int nStartingIndex = 0;
+    if (script.IsAssetScript(nType, fIsOwner, nStartingIndex)) {
+        if (nType == TX_TRANSFER_ASSET)
+            view.type = AssetScriptType::TRANSFER;
+        else if (nType == TX_REISSUE_ASSET)
+            view.type = AssetScriptType::REISSUE;
+        else
+            view.type = fIsOwner ? AssetScriptType::OWNER : AssetScriptType::NEW_ASSET;
+        view.nStartingIndex = nStartingIndex;
+        view.pPayload = script.data() + nStartingIndex;
+        view.nPayloadSize = script.size() - nStartingIndex;
     }
 
-    return true;
+    size_t nNullOffset = 0;
+    if (script.IsNullAssetTxDataScript()) {
+        view.nullType = NullAssetScriptType::TX_DATA;
+        nNullOffset = OFFSET_TWENTY_THREE;
+    } else if (script.IsNullGlobalRestrictionAssetTxDataScript()) {
+        view.nullType = NullAssetScriptType::GLOBAL_RESTRICTION;
+        nNullOffset = OFFSET_FOUR;
+    } else if (script.IsNullAssetVerifierTxDataScript()) {
+        view.nullType = NullAssetScriptType::VERIFIER;
+        nNullOffset = OFFSET_THREE;
+    }
+    if (view.nullType != NullAssetScriptType::NONE) {
+        view.pNullPayload = script.data() + nNullOffset;
+        view.nNullPayloadSize = script.size() - nNullOffset;
+    }
+
+    return view.type != AssetScriptType::NONE || view.nullType != NullAssetScriptType::NONE;
 }
 
-bool MsgChannelAssetFromScript(const CScript& scriptPubKey, CNewAsset& assetNew, std::string& strAddress)
+static bool TransferAssetFromView(const CScript& scriptPubKey, const CAssetScriptView& view, CAssetTransfer& assetTransfer, CAddressKey& address)
 {
-    int nStartingIndex = 0;
-    if (!IsScriptNewMsgChannelAsset(scriptPubKey, nStartingIndex))
+    if (view.type != AssetScriptType::TRANSFER)
         return false;
 
-    CTxDestination destination;
-    ExtractDestination(scriptPubKey, destination);
-
-    strAddress = EncodeDestination(destination);
-
-    std::vector<unsigned char> vchNewAsset;
-    vchNewAsset.insert(vchNewAsset.end(), scriptPubKey.begin() + nStartingIndex, scriptPubKey.end());
-    CDataStream ssAsset(vchNewAsset, SER_NETWORK, PROTOCOL_VERSION);
+    address = CAddressKey::FromScript(scriptPubKey);
 
-    try {
-        ssAsset >> assetNew;
-    } catch(std::exception& e) {
-        error("Failed to get the msg channel asset from the stream: %s", e.what());
-        return false;
+    if (AreTransferScriptsSizeDeployed()) {
+        // Before kawpow activation we used the hardcoded 31 to find the data
+        // This created a bug where large transfers scripts would fail to serialize.
+        // This fixes that issue (https://github.com/RavenProject/Ravencoin/issues/752)
+        // TODO, after the kawpow fork goes active, we should be able to remove this if/else statement and just use this line.
+        return UnserializeAssetPayload(view.pPayload, view.nPayloadSize, assetTransfer, "transfer asset");
     }
-
-    return true;
+    return UnserializeAssetPayload(scriptPubKey.data() + 31, scriptPubKey.size() - 31, assetTransfer, "transfer asset");
 }
 
-bool QualifierAssetFromScript(const CScript& scriptPubKey, CNewAsset& assetNew, std::string& strAddress)
+static bool AssetFromView(const CScript& scriptPubKey, const CAssetScriptView& view, CNewAsset& assetNew, CAddressKey& address)
 {
-    int nStartingIndex = 0;
-    if (!IsScriptNewQualifierAsset(scriptPubKey, nStartingIndex))
+    if (view.type != AssetScriptType::NEW_ASSET)
         return false;
 
-    CTxDestination destination;
-    ExtractDestination(scriptPubKey, destination);
+    address = CAddressKey::FromScript(scriptPubKey);
 
-    strAddress = EncodeDestination(destination);
-
-    std::vector<unsigned char> vchNewAsset;
-    vchNewAsset.insert(vchNewAsset.end(), scriptPubKey.begin() + nStartingIndex, scriptPubKey.end());
-    CDataStream ssAsset(vchNewAsset, SER_NETWORK, PROTOCOL_VERSION);
+    return UnserializeAssetPayload(view.pPayload, view.nPayloadSize, assetNew, "asset");
+}
 
-    try {
-        ssAsset >> assetNew;
-    } catch(std::exception& e) {
-        error("Failed to get the qualifier asset from the stream: %s", e.what());
+static bool ReissueAssetFromView(const CScript& scriptPubKey, const CAssetScriptView& view, CReissueAsset& reissue, CAddressKey& address)
+{
+    if (view.type != AssetScriptType::REISSUE)
         return false;
-    }
 
-    return true;
+    address = CAddressKey::FromScript(scriptPubKey);
+
+    return UnserializeAssetPayload(view.pPayload, view.nPayloadSize, reissue, "reissue asset");
 }
 
-bool RestrictedAssetFromScript(const CScript& scriptPubKey, CNewAsset& assetNew, std::string& strAddress)
+//! Deserialize a new asset and get the type of its name, which is what tells the issuance kinds apart
+static bool NewAssetNameTypeFromView(const CAssetScriptView& view, CNewAsset& assetNew, AssetType& assetType, const char* strWhat)
 {
-    int nStartingIndex = 0;
-    if (!IsScriptNewRestrictedAsset(scriptPubKey, nStartingIndex))
+    if (view.type != AssetScriptType::NEW_ASSET)
         return false;
 
-    CTxDestination destination;
-    ExtractDestination(scriptPubKey, destination);
+    if (!UnserializeAssetPayload(view.pPayload, view.nPayloadSize, assetNew, strWhat))
+        return false;
 
-    strAddress = EncodeDestination(destination);
+    return IsAssetNameValid(assetNew.strName, assetType);
+}
 
-    std::vector<unsigned char> vchNewAsset;
-    vchNewAsset.insert(vchNewAsset.end(), scriptPubKey.begin() + nStartingIndex, scriptPubKey.end());
-    CDataStream ssAsset(vchNewAsset, SER_NETWORK, PROTOCOL_VERSION);
+//! Shared by the issuance kinds that are only told apart by the asset name
+static bool NewAssetOfTypeFromScript(const CScript& scriptPubKey, CNewAsset& assetNew, std::string& strAddress, AssetType type, AssetType typeAlt, const char* strWhat)
+{
+    CAssetScriptView view;
+    DecodeAssetScript(scriptPubKey, view);
 
-    try {
-        ssAsset >> assetNew;
-    } catch(std::exception& e) {
-        error("Failed to get the restricted asset from the stream: %s", e.what());
+    CNewAsset asset;
+    AssetType assetType;
+    if (!NewAssetNameTypeFromView(view, asset, assetType, strWhat) || (assetType != type && assetType != typeAlt))
         return false;
-    }
+
+    assetNew = asset;
+    strAddress = AddressFromAssetScript(scriptPubKey);
 
     return true;
 }
 
-bool OwnerAssetFromScript(const CScript& scriptPubKey, std::string& assetName, std::string& strAddress)
+bool TransferAssetFromScript(const CScript& scriptPubKey, CAssetTransfer& assetTransfer, CAddressKey& address)
 {
-    int nStartingIndex = 0;
-    if (!IsScriptOwnerAsset(scriptPubKey, nStartingIndex))
-        return false;
-
-    CTxDestination destination;
-    ExtractDestination(scriptPubKey, destination);
+    CAssetScriptView view;
+    DecodeAssetScript(scriptPubKey, view);
 
-    strAddress = EncodeDestination(destination);
+    return TransferAssetFromView(scriptPubKey, view, assetTransfer, address);
+}
 
-    std::vector<unsigned char> vchOwnerAsset;
-    vchOwnerAsset.insert(vchOwnerAsset.end(), scriptPubKey.begin() + nStartingIndex, scriptPubKey.end());
-    CDataStream ssOwner(vchOwnerAsset, SER_NETWORK, PROTOCOL_VERSION);
+bool TransferAssetFromScript(const CScript& scriptPubKey, CAssetTransfer& assetTransfer, std::string& strAddress)
+{
+    CAddressKey address;
+    bool fResult = TransferAssetFromScript(scriptPubKey, assetTransfer, address);
+    strAddress = address.ToString();
+    return fResult;
+}
 
-    try {
-        ssOwner >> assetName;
-    } catch(std::exception& e) {
-        error("Failed to get the owner asset from the stream: %s", e.what());
-        return false;
-    }
+bool AssetFromScript(const CScript& scriptPubKey, CNewAsset& assetNew, CAddressKey& address)
+{
+    CAssetScriptView view;
+    DecodeAssetScript(scriptPubKey, view);
 
-    return true;
+    return AssetFromView(scriptPubKey, view, assetNew, address);
 }
 
-bool ReissueAssetFromScript(const CScript& scriptPubKey, CReissueAsset& reissue, std::string& strAddress)
+bool AssetFromScript(const CScript& scriptPubKey, CNewAsset& assetNew, std::string& strAddress)
 {
-    int nStartingIndex = 0;
-    if (!IsScriptReissueAsset(scriptPubKey, nStartingIndex))
-        return false;
+    CAddressKey address;
+    bool fResult = AssetFromScript(scriptPubKey, assetNew, address);
+    strAddress = address.ToString();
+    return fResult;
+}
 
-    CTxDestination destination;
-    ExtractDestination(scriptPubKey, destination);
+bool MsgChannelAssetFromScript(const CScript& scriptPubKey, CNewAsset& assetNew, std::string& strAddress)
+{
+    return NewAssetOfTypeFromScript(scriptPubKey, assetNew, strAddress, AssetType::MSGCHANNEL, AssetType::MSGCHANNEL, "msg channel asset");
+}
 
-    strAddress = EncodeDestination(destination);
+bool QualifierAssetFromScript(const CScript& scriptPubKey, CNewAsset& assetNew, std::string& strAddress)
+{
+    return NewAssetOfTypeFromScript(scriptPubKey, assetNew, strAddress, AssetType::QUALIFIER, AssetType::SUB_QUALIFIER, "qualifier asset");
+}
 
-    std::vector<unsigned char> vchReissueAsset;
-    vchReissueAsset.insert(vchReissueAsset.end(), scriptPubKey.begin() + nStartingIndex, scriptPubKey.end());
-    CDataStream ssReissue(vchReissueAsset, SER_NETWORK, PROTOCOL_VERSION);
+bool RestrictedAssetFromScript(const CScript& scriptPubKey, CNewAsset& assetNew, std::string& strAddress)
+{
+    return NewAssetOfTypeFromScript(scriptPubKey, assetNew, strAddress, AssetType::RESTRICTED, AssetType::RESTRICTED, "restricted asset");
+}
 
-    try {
-        ssReissue >> reissue;
-    } catch(std::exception& e) {
-        error("Failed to get the reissue asset from the stream: %s", e.what());
+bool OwnerAssetFromScript(const CScript& scriptPubKey, std::string& assetName, CAddressKey& address)
+{
+    CAssetScriptView view;
+    DecodeAssetScript(scriptPubKey, view);
+    if (view.type != AssetScriptType::OWNER)
         return false;
-    }
 
-    return true;
+    address = CAddressKey::FromScript(scriptPubKey);
+
+    return UnserializeAssetPayload(view.pPayload, view.nPayloadSize, assetName, "owner asset");
 }
 
-bool AssetNullDataFromScript(const CScript& scriptPubKey, CNullAssetTxData& assetData, std::string& strAddress)
+bool OwnerAssetFromScript(const CScript& scriptPubKey, std::string& assetName, std::string& strAddress)
 {
-    if (!scriptPubKey.IsNullAssetTxDataScript()) {
-        return false;
-    }
+    CAddressKey address;
+    bool fResult = OwnerAssetFromScript(scriptPubKey, assetName, address);
+    strAddress = address.ToString();
+    return fResult;
+}
 
-    CTxDestination destination;
-    ExtractDestination(scriptPubKey, destination);
+bool ReissueAssetFromScript(const CScript& scriptPubKey, CReissueAsset& reissue, CAddressKey& address)
+{
+    CAssetScriptView view;
+    DecodeAssetScript(scriptPubKey, view);
 
-    strAddress = EncodeDestination(destination);
+    return ReissueAssetFromView(scriptPubKey, view, reissue, address);
+}
 
-    std::vector<unsigned char> vchAssetData;
-    vchAssetData.insert(vchAssetData.end(), scriptPubKey.begin() + OFFSET_TWENTY_THREE, scriptPubKey.end());
-    CDataStream ssData(vchAssetData, SER_NETWORK, PROTOCOL_VERSION);
+bool ReissueAssetFromScript(const CScript& scriptPubKey, CReissueAsset& reissue, std::string& strAddress)
+{
+    CAddressKey address;
+    bool fResult = ReissueAssetFromScript(scriptPubKey, reissue, address);
+    strAddress = address.ToString();
+    return fResult;
+}
 
-    try {
-        ssData >> assetData;
-    } catch(std::exception& e) {
-        error("Failed to get the null asset tx data from the stream: %s", e.what());
+bool AssetNullDataFromScript(const CScript& scriptPubKey, CNullAssetTxData& assetData, std::string& strAddress)
+{
+    CAssetScriptView view;
+    DecodeAssetScript(scriptPubKey, view);
+    if (view.nullType != NullAssetScriptType::TX_DATA) {
         return false;
     }
 
-    return true;
+    strAddress = AddressFromAssetScript(scriptPubKey);
+
+    return UnserializeAssetPayload(view.pNullPayload, view.nNullPayloadSize, assetData, "null asset tx data");
 }
 
 bool GlobalAssetNullDataFromScript(const CScript& scriptPubKey, CNullAssetTxData& assetData)
 {
-    if (!scriptPubKey.IsNullGlobalRestrictionAssetTxDataScript()) {
-        return false;
-    }
-
-    std::vector<unsigned char> vchAssetData;
-    vchAssetData.insert(vchAssetData.end(), scriptPubKey.begin() + OFFSET_FOUR, scriptPubKey.end());
-    CDataStream ssData(vchAssetData, SER_NETWORK, PROTOCOL_VERSION);
-
-    try {
-        ssData >> assetData;
-    } catch(std::exception& e) {
-        error("Failed to get the global restriction asset tx data from the stream: %s", e.what());
+    CAssetScriptView view;
+    DecodeAssetScript(scriptPubKey, view);
+    if (view.nullType != NullAssetScriptType::GLOBAL_RESTRICTION) {
         return false;
     }
 
-    return true;
+    return UnserializeAssetPayload(view.pNullPayload, view.nNullPayloadSize, assetData, "global restriction asset tx data");
 }
 
 bool AssetNullVerifierDataFromScript(const CScript& scriptPubKey, CNullAssetTxVerifierString& verifierData)
 {
-    if (!scriptPubKey.IsNullAssetVerifierTxDataScript()) {
-        return false;
-    }
-
-    std::vector<unsigned char> vchAssetData;
-    vchAssetData.insert(vchAssetData.end(), scriptPubKey.begin() + OFFSET_THREE, scriptPubKey.end());
-    CDataStream ssData(vchAssetData, SER_NETWORK, PROTOCOL_VERSION);
-
-    try {
-        ssData >> verifierData;
-    } catch(std::exception& e) {
-        error("Failed to get the verifier string from the stream: %s", e.what());
+    CAssetScriptView view;
+    DecodeAssetScript(scriptPubKey, view);
+    if (view.nullType != NullAssetScriptType::VERIFIER) {
         return false;
     }
 
-    return true;
+    return UnserializeAssetPayload(view.pNullPayload, view.nNullPayloadSize, verifierData, "verifier string");
 }
 
 //! Call VerifyNewAsset if this function returns true
@@ -1608,7 +1696,7 @@ bool CAssetTransfer::ContextualCheckAgainstVerifyString(CAssetsCache *assetCache
         return false;
     }
 
-    if (!ContextualCheckVerifierString(assetCache, verifier.verifier_string, address, strError))
+    if (!ContextualCheckVerifierString(assetCache, verifier, address, strError))
         return false;
 
     return true;
@@ -1660,7 +1748,71 @@ bool CReissueAsset::IsNull() const
     return strName == "" || nAmount < 0;
 }
 
-bool CAssetsCache::AddTransferAsset(const CAssetTransfer& transferAsset, const std::string& address, const COutPoint& out, const CTxOut& txOut)
+CAssetsCache* CAssetsCache::GetBase() const
+{
+    if (pbase)
+        return pbase;
+    return this != passets ? passets : nullptr;
+}
+
+namespace {
+/**
+ * Look item up in the dirty sets of cache and of the overlays it sits on,
+ * nearest first, stopping short of passets, which the callers check on its
+ * own. fRemoved tells which of the two sets the closest entry was in.
+ */
+template <typename T>
+const T* FindInOverlays(const CAssetsCache* cache, CAssetCacheSet<T> CAssetsCache::*pSetToRemove, CAssetCacheSet<T> CAssetsCache::*pSetToAdd, const T& item, bool& fRemoved)
+{
+    for (const CAssetsCache* level = cache; level && level != passets; level = level->GetBase()) {
+        auto it = (level->*pSetToRemove).find(item);
+        if (it != (level->*pSetToRemove).end()) {
+            fRemoved = true;
+            return &*it;
+        }
+        it = (level->*pSetToAdd).find(item);
+        if (it != (level->*pSetToAdd).end()) {
+            fRemoved = false;
+            return &*it;
+        }
+    }
+    return nullptr;
+}
+
+//! Same for the dirty maps, where the closest entry is the current value
+template <typename Map>
+const typename Map::mapped_type* FindInOverlays(const CAssetsCache* cache, Map CAssets::*pMap, const typename Map::key_type& key)
+{
+    for (const CAssetsCache* level = cache; level && level != passets; level = level->GetBase()) {
+        auto it = (level->*pMap).find(key);
+        if (it != (level->*pMap).end())
+            return &it->second;
+    }
+    return nullptr;
+}
+
+//! Whether the closest overlay that mentions any sub qualifier of checker still has one added
+bool HasRootQualifierInOverlays(const CAssetsCache* cache, const CAssetCacheRootQualifierChecker& checker)
+{
+    std::set<std::string> setDecided;
+    for (const CAssetsCache* level = cache; level && level != passets; level = level->GetBase()) {
+        auto itAdd = level->mapRootQualifierAddressesAdd.find(checker);
+        if (itAdd != level->mapRootQualifierAddressesAdd.end()) {
+            for (const std::string& name : itAdd->second) {
+                if (!setDecided.count(name))
+                    return true;
+            }
+            setDecided.insert(itAdd->second.begin(), itAdd->second.end());
+        }
+        auto itRemove = level->mapRootQualifierAddressesRemove.find(checker);
+        if (itRemove != level->mapRootQualifierAddressesRemove.end())
+            setDecided.insert(itRemove->second.begin(), itRemove->second.end());
+    }
+    return false;
+}
+} // namespace
+
+bool CAssetsCache::AddTransferAsset(const CAssetTransfer& transferAsset, const CAddressKey& address, const COutPoint& out, const CTxOut& txOut)
 {
     AddToAssetBalance(transferAsset.strName, address, transferAsset.nAmount);
 
@@ -1675,7 +1827,7 @@ bool CAssetsCache::AddTransferAsset(const CAssetTransfer& transferAsset, const s
     return true;
 }
 
-void CAssetsCache::AddToAssetBalance(const std::string& strName, const std::string& address, const CAmount& nAmount)
+void CAssetsCache::AddToAssetBalance(const std::string& strName, const CAddressKey& address, const CAmount& nAmount)
 {
     if (fAssetIndex) {
         auto pair = std::make_pair(strName, address);
@@ -1695,48 +1847,25 @@ void CAssetsCache::AddToAssetBalance(const std::string& strName, const std::stri
 
 bool CAssetsCache::TrySpendCoin(const COutPoint& out, const CTxOut& txOut)
 {
-    // Placeholder strings that will get set if you successfully get the transfer or asset from the script
-    std::string address = "";
-    std::string assetName = "";
-    CAmount nAmount = -1;
+    // If it isn't an asset tx return true, we only fail if an error occurs
+    if (!txOut.scriptPubKey.IsAssetScript())
+        return true;
 
-    // Get the asset tx data
-    int nType = -1;
-    bool fIsOwner = false;
-    if (txOut.scriptPubKey.IsAssetScript(nType, fIsOwner)) {
+    CCoinAssetData data;
+    DecodeCoinAssetData(txOut.scriptPubKey, data);
+    return TrySpendCoin(out, data);
+}
 
-        // Get the New Asset or Transfer Asset from the scriptPubKey
-        if (nType == TX_NEW_ASSET && !fIsOwner) {
-            CNewAsset asset;
-            if (AssetFromScript(txOut.scriptPubKey, asset, address)) {
-                assetName = asset.strName;
-                nAmount = asset.nAmount;
-            }
-        } else if (nType == TX_TRANSFER_ASSET) {
-            CAssetTransfer transfer;
-            if (TransferAssetFromScript(txOut.scriptPubKey, transfer, address)) {
-                assetName = transfer.strName;
-                nAmount = transfer.nAmount;
-            }
-        } else if (nType == TX_NEW_ASSET && fIsOwner) {
-            if (!OwnerAssetFromScript(txOut.scriptPubKey, assetName, address))
-                return error("%s : ERROR Failed to get owner asset from the OutPoint: %s", __func__,
-                             out.ToString());
-            nAmount = OWNER_ASSET_AMOUNT;
-        } else if (nType == TX_REISSUE_ASSET) {
-            CReissueAsset reissue;
-            if (ReissueAssetFromScript(txOut.scriptPubKey, reissue, address)) {
-                assetName = reissue.strName;
-                nAmount = reissue.nAmount;
-            }
-        }
-    } else {
-        // If it isn't an asset tx return true, we only fail if an error occurs
-        return true;
-    }
+bool CAssetsCache::TrySpendCoin(const COutPoint& out, const CCoinAssetData& data)
+{
+    const std::string& assetName = data.strName;
+    const CAddressKey& address = data.address;
+    const CAmount nAmount = data.nAmount;
 
     // If we got the address and the assetName, proceed to remove it from the database, and in memory objects
-    if (address != "" && assetName != "") {
+    if (data.fDecoded && !address.IsNull() && assetName != "") {
+        UpdateAssetSupply(assetName, address, nAmount, -1);
+
         if (fAssetIndex && nAmount > 0) {
             CAssetCacheSpendAsset spend(assetName, address, nAmount);
             if (GetBestAssetAddressAmount(*this, assetName, address)) {
@@ -1758,6 +1887,22 @@ bool CAssetsCache::TrySpendCoin(const COutPoint& out, const CTxOut& txOut)
     return true;
 }
 
+void CAssetsCache::UpdateAssetSupply(const std::string& assetName, const CAddressKey& address, const CAmount& nAmount, const int nDirection)
+{
+    CAssetSupply& delta = mapAssetSupplyDelta[assetName];
+    delta.nOutputs += nDirection;
+    // Burned assets are still unspent outputs, but nobody can move them again
+    if (!GetParams().IsBurnAddress(address.ToString()))
+        delta.nHeld += nDirection * nAmount;
+}
+
+void CAssetsCache::UpdateAssetSupply(const CTxOut& txOut, const int nDirection)
+{
+    CAssetOutputEntry data;
+    if (GetAssetData(txOut.scriptPubKey, data))
+        UpdateAssetSupply(data.assetName, CAddressKey::FromDestination(data.destination), data.nAmount, nDirection);
+}
+
 bool CAssetsCache::ContainsAsset(const CNewAsset& asset)
 {
     return CheckIfAssetExists(asset.strName);
@@ -1770,7 +1915,7 @@ bool CAssetsCache::ContainsAsset(const std::string& assetName)
 
 bool CAssetsCache::UndoAssetCoin(const Coin& coin, const COutPoint& out)
 {
-    std::string strAddress = "";
+    CAddressKey address;
     std::string assetName = "";
     CAmount nAmount = 0;
 
@@ -1781,7 +1926,7 @@ bool CAssetsCache::UndoAssetCoin(const Coin& coin, const COutPoint& out)
 
         if (nType == TX_NEW_ASSET && !fIsOwner) {
             CNewAsset asset;
-            if (!AssetFromScript(coin.out.scriptPubKey, asset, strAddress)) {
+            if (!AssetFromScript(coin.out.scriptPubKey, asset, address)) {
                 return error("%s : Failed to get asset from script while trying to undo asset spend. OutPoint : %s",
                              __func__,
                              out.ToString());
@@ -1791,7 +1936,7 @@ bool CAssetsCache::UndoAssetCoin(const Coin& coin, const COutPoint& out)
             nAmount = asset.nAmount;
         } else if (nType == TX_TRANSFER_ASSET) {
             CAssetTransfer transfer;
-            if (!TransferAssetFromScript(coin.out.scriptPubKey, transfer, strAddress))
+            if (!TransferAssetFromScript(coin.out.scriptPubKey, transfer, address))
                 return error(
                         "%s : Failed to get transfer asset from script while trying to undo asset spend. OutPoint : %s",
                         __func__,
@@ -1801,7 +1946,7 @@ bool CAssetsCache::UndoAssetCoin(const Coin& coin, const COutPoint& out)
             nAmount = transfer.nAmount;
         } else if (nType == TX_NEW_ASSET && fIsOwner) {
             std::string ownerName;
-            if (!OwnerAssetFromScript(coin.out.scriptPubKey, ownerName, strAddress))
+            if (!OwnerAssetFromScript(coin.out.scriptPubKey, ownerName, address))
                 return error(
                         "%s : Failed to get owner asset from script while trying to undo asset spend. OutPoint : %s",
                         __func__, out.ToString());
@@ -1809,7 +1954,7 @@ bool CAssetsCache::UndoAssetCoin(const Coin& coin, const COutPoint& out)
             nAmount = OWNER_ASSET_AMOUNT;
         } else if (nType == TX_REISSUE_ASSET) {
             CReissueAsset reissue;
-            if (!ReissueAssetFromScript(coin.out.scriptPubKey, reissue, strAddress))
+            if (!ReissueAssetFromScript(coin.out.scriptPubKey, reissue, address))
                 return error(
                         "%s : Failed to get reissue asset from script while trying to undo asset spend. OutPoint : %s",
                         __func__, out.ToString());
@@ -1818,17 +1963,19 @@ bool CAssetsCache::UndoAssetCoin(const Coin& coin, const COutPoint& out)
         }
     }
 
-    if (assetName == "" || strAddress == "" || nAmount == 0)
-        return error("%s : AssetName, Address or nAmount is invalid., Asset Name: %s, Address: %s, Amount: %d", __func__, assetName, strAddress, nAmount);
+    if (assetName == "" || address.IsNull() || nAmount == 0)
+        return error("%s : AssetName, Address or nAmount is invalid., Asset Name: %s, Address: %s, Amount: %d", __func__, assetName, address.ToString(), nAmount);
 
-    if (!AddBackSpentAsset(coin, assetName, strAddress, nAmount, out))
+    if (!AddBackSpentAsset(coin, assetName, address, nAmount, out))
         return error("%s : Failed to add back the spent asset. OutPoint : %s", __func__, out.ToString());
 
+    UpdateAssetSupply(assetName, address, nAmount, 1);
+
     return true;
 }
 
 //! Changes Memory Only
-bool CAssetsCache::AddBackSpentAsset(const Coin& coin, const std::string& assetName, const std::string& address, const CAmount& nAmount, const COutPoint& out)
+bool CAssetsCache::AddBackSpentAsset(const Coin& coin, const std::string& assetName, const CAddressKey& address, const CAmount& nAmount, const COutPoint& out)
 {
     if (fAssetIndex) {
         // Update the assets address balance
@@ -1849,24 +1996,24 @@ bool CAssetsCache::AddBackSpentAsset(const Coin& coin, const std::string& assetN
 }
 
 //! Changes Memory Only
-bool CAssetsCache::UndoTransfer(const CAssetTransfer& transfer, const std::string& address, const COutPoint& outToRemove)
+bool CAssetsCache::UndoTransfer(const CAssetTransfer& transfer, const CAddressKey& address, const COutPoint& outToRemove)
 {
     if (fAssetIndex) {
         // Make sure we are in a valid state to undo the transfer of the asset
         if (!GetBestAssetAddressAmount(*this, transfer.strName, address))
             return error("%s : Failed to get the assets address balance from the database. Asset : %s Address : %s",
-                         __func__, transfer.strName, address);
+                         __func__, transfer.strName, address.ToString());
 
         auto pair = std::make_pair(transfer.strName, address);
         if (!mapAssetsAddressAmount.count(pair))
             return error(
                     "%s : Tried undoing a transfer and the map of address amount didn't have the asset address pair. Asset : %s Address : %s",
-                    __func__, transfer.strName, address);
+                    __func__, transfer.strName, address.ToString());
 
         if (mapAssetsAddressAmount.at(pair) < transfer.nAmount)
             return error(
                     "%s : Tried undoing a transfer and the map of address amount had less than the amount we are trying to undo. Asset : %s Address : %s",
-                    __func__, transfer.strName, address);
+                    __func__, transfer.strName, address.ToString());
 
         // Change the in memory balance of the asset at the address
         mapAssetsAddressAmount[pair] -= transfer.nAmount;
@@ -1876,7 +2023,7 @@ bool CAssetsCache::UndoTransfer(const CAssetTransfer& transfer, const std::strin
 }
 
 //! Changes Memory Only
-bool CAssetsCache::RemoveNewAsset(const CNewAsset& asset, const std::string address)
+bool CAssetsCache::RemoveNewAsset(const CNewAsset& asset, const CAddressKey& address)
 {
     if (!CheckIfAssetExists(asset.strName))
         return error("%s : Tried removing an asset that didn't exist. Asset Name : %s", __func__, asset.strName);
@@ -1895,7 +2042,7 @@ bool CAssetsCache::RemoveNewAsset(const CNewAsset& asset, const std::string addr
 }
 
 //! Changes Memory Only
-bool CAssetsCache::AddNewAsset(const CNewAsset& asset, const std::string address, const int& nHeight, const uint256& blockHash)
+bool CAssetsCache::AddNewAsset(const CNewAsset& asset, const CAddressKey& address, const int& nHeight, const uint256& blockHash)
 {
     if(CheckIfAssetExists(asset.strName))
         return error("%s: Tried adding new asset, but it already existed in the set of assets: %s", __func__, asset.strName);
@@ -1916,7 +2063,7 @@ bool CAssetsCache::AddNewAsset(const CNewAsset& asset, const std::string address
 }
 
 //! Changes Memory Only
-bool CAssetsCache::AddReissueAsset(const CReissueAsset& reissue, const std::string address, const COutPoint& out)
+bool CAssetsCache::AddReissueAsset(const CReissueAsset& reissue, const CAddressKey& address, const COutPoint& out)
 {
     auto pair = std::make_pair(reissue.strName, address);
 
@@ -1972,7 +2119,7 @@ bool CAssetsCache::AddReissueAsset(const CReissueAsset& reissue, const std::stri
 }
 
 //! Changes Memory Only
-bool CAssetsCache::RemoveReissueAsset(const CReissueAsset& reissue, const std::string address, const COutPoint& out, const std::vector<std::pair<std::string, CBlockAssetUndo> >& vUndoIPFS)
+bool CAssetsCache::RemoveReissueAsset(const CReissueAsset& reissue, const CAddressKey& address, const COutPoint& out, const std::vector<std::pair<std::string, CBlockAssetUndo> >& vUndoIPFS)
 {
     auto pair = std::make_pair(reissue.strName, address);
 
@@ -2038,7 +2185,7 @@ bool CAssetsCache::RemoveReissueAsset(const CReissueAsset& reissue, const std::s
 }
 
 //! Changes Memory Only
-bool CAssetsCache::AddOwnerAsset(const std::string& assetsName, const std::string address)
+bool CAssetsCache::AddOwnerAsset(const std::string& assetsName, const CAddressKey& address)
 {
     // Update the cache
     CAssetCacheNewOwner newOwner(assetsName, address);
@@ -2057,7 +2204,7 @@ bool CAssetsCache::AddOwnerAsset(const std::string& assetsName, const std::strin
 }
 
 //! Changes Memory Only
-bool CAssetsCache::RemoveOwnerAsset(const std::string& assetsName, const std::string address)
+bool CAssetsCache::RemoveOwnerAsset(const std::string& assetsName, const CAddressKey& address)
 {
     // Update the cache
     CAssetCacheNewOwner newOwner(assetsName, address);
@@ -2075,7 +2222,7 @@ bool CAssetsCache::RemoveOwnerAsset(const std::string& assetsName, const std::st
 }
 
 //! Changes Memory Only
-bool CAssetsCache::RemoveTransfer(const CAssetTransfer &transfer, const std::string &address, const COutPoint &out)
+bool CAssetsCache::RemoveTransfer(const CAssetTransfer &transfer, const CAddressKey &address, const COutPoint &out)
 {
     if (!UndoTransfer(transfer, address, out))
         return error("%s : Failed to undo the transfer", __func__);
@@ -2266,6 +2413,89 @@ bool CAssetsCache::RemoveRestrictedVerifier(const std::string& assetName, const
     return true;
 }
 
+void CAssetsCache::GetReadDelta(CAssetsReadDelta& delta) const
+{
+    // Same order as DumpCacheToDatabase, so later changes win
+    std::string root, tag, parent;
+    for (const auto& newAsset : setNewAssetsToRemove) {
+        delta.mapAssets[newAsset.asset.strName] = std::make_pair(false, CDatabasedAssetData());
+        if (SplitUniqueAssetName(newAsset.asset.strName, root, tag))
+            delta.mapUniqueCollection[std::make_pair(root, tag)] = 0;
+        if (GetAssetTreeParent(newAsset.asset.strName, parent))
+            delta.mapAssetTree[std::make_pair(parent, newAsset.asset.strName)] = 0;
+    }
+
+    for (const auto& newAsset : setNewAssetsToAdd) {
+        delta.mapAssets[newAsset.asset.strName] = std::make_pair(true, CDatabasedAssetData(newAsset.asset, newAsset.blockHeight, newAsset.blockHash));
+        if (SplitUniqueAssetName(newAsset.asset.strName, root, tag))
+            delta.mapUniqueCollection[std::make_pair(root, tag)] = newAsset.asset.nAmount;
+        if (GetAssetTreeParent(newAsset.asset.strName, parent))
+            delta.mapAssetTree[std::make_pair(parent, newAsset.asset.strName)] = ASSET_TREE_ENTRY;
+    }
+
+    for (const auto& newReissue : setNewReissueToAdd) {
+        auto it = mapReissuedAssetData.find(newReissue.reissue.strName);
+        if (it != mapReissuedAssetData.end())
+            delta.mapAssets[it->first] = std::make_pair(true, CDatabasedAssetData(it->second, newReissue.blockHeight, newReissue.blockHash));
+    }
+
+    for (const auto& undoReissue : setNewReissueToRemove) {
+        CAssetCacheNewAsset testNewAssetCache(CNewAsset(undoReissue.reissue.strName, 0), CAddressKey(), 0, uint256());
+        if (setNewAssetsToRemove.count(testNewAssetCache))
+            continue;
+        auto it = mapReissuedAssetData.find(undoReissue.reissue.strName);
+        if (it != mapReissuedAssetData.end())
+            delta.mapAssets[it->first] = std::make_pair(true, CDatabasedAssetData(it->second, undoReissue.blockHeight, undoReissue.blockHash));
+    }
+
+    for (const auto& newVerifier : setNewRestrictedVerifierToAdd)
+        delta.mapVerifiers[newVerifier.assetName] = std::make_pair(true, newVerifier.verifier);
+
+    for (const auto& undoVerifier : setNewRestrictedVerifierToRemove) {
+        if (undoVerifier.fUndoingRessiue)
+            delta.mapVerifiers[undoVerifier.assetName] = std::make_pair(true, undoVerifier.verifier);
+        else
+            delta.mapVerifiers[undoVerifier.assetName] = std::make_pair(false, std::string());
+    }
+
+    for (const auto& item : mapAssetSupplyDelta)
+        delta.mapAssetSupply[item.first] += item.second;
+
+    if (fAssetIndex) {
+        // Every balance this cache touched is in the map, with 0 for the removed ones
+        for (const auto& item : mapAssetsAddressAmount) {
+            delta.mapAssetAddressAmount[item.first] = item.second;
+            delta.mapAddressAssetAmount[std::make_pair(item.first.second, item.first.first)] = item.second;
+        }
+    }
+}
+
+void CAssetsCache::GetNotifications(int nHeight, bool fConnected, std::vector<CAssetNotification>& vNotifications) const
+{
+    const CAssetCacheSet<CAssetCacheNewAsset>& setNewAssets = fConnected ? setNewAssetsToAdd : setNewAssetsToRemove;
+    for (const auto& newAsset : SortedCacheEntries(setNewAssets))
+        vNotifications.emplace_back(CAssetNotification::ISSUE, fConnected, newAsset.asset.strName, newAsset.address.ToString(), newAsset.asset.nAmount, COutPoint(), nHeight);
+
+    const CAssetCacheSet<CAssetCacheNewOwner>& setNewOwners = fConnected ? setNewOwnerAssetsToAdd : setNewOwnerAssetsToRemove;
+    for (const auto& newOwner : SortedCacheEntries(setNewOwners))
+        vNotifications.emplace_back(CAssetNotification::ISSUE, fConnected, newOwner.assetName, newOwner.address.ToString(), OWNER_ASSET_AMOUNT, COutPoint(), nHeight);
+
+    const CAssetCacheSet<CAssetCacheReissueAsset>& setReissues = fConnected ? setNewReissueToAdd : setNewReissueToRemove;
+    for (const auto& reissue : SortedCacheEntries(setReissues))
+        vNotifications.emplace_back(CAssetNotification::REISSUE, fConnected, reissue.reissue.strName, reissue.address.ToString(), reissue.reissue.nAmount, reissue.out, nHeight);
+
+    const CAssetCacheSet<CAssetCacheNewTransfer>& setTransfers = fConnected ? setNewTransferAssetsToAdd : setNewTransferAssetsToRemove;
+    for (const auto& transfer : SortedCacheEntries(setTransfers))
+        vNotifications.emplace_back(CAssetNotification::TRANSFER, fConnected, transfer.transfer.strName, transfer.address.ToString(), transfer.transfer.nAmount, transfer.out, nHeight);
+
+    if (fAssetIndex) {
+        // Every balance this cache touched, with 0 for the emptied ones
+        std::map<std::pair<std::string, CAddressKey>, CAmount> mapBalances(mapAssetsAddressAmount.begin(), mapAssetsAddressAmount.end());
+        for (const auto& item : mapBalances)
+            vNotifications.emplace_back(CAssetNotification::BALANCE, fConnected, item.first.first, item.first.second.ToString(), item.second, COutPoint(), nHeight);
+    }
+}
+
 bool CAssetsCache::DumpCacheToDatabase()
 {
     try {
@@ -2273,7 +2503,7 @@ bool CAssetsCache::DumpCacheToDatabase()
         std::string message;
 
         // Remove new assets from the database
-        for (auto newAsset : setNewAssetsToRemove) {
+        for (auto newAsset : SortedCacheEntries(setNewAssetsToRemove)) {
             passetsCache->Erase(newAsset.asset.strName);
             if (!passetsdb->EraseAssetData(newAsset.asset.strName)) {
                 dirty = true;
@@ -2307,7 +2537,7 @@ bool CAssetsCache::DumpCacheToDatabase()
         }
 
         // Add the new assets to the database
-        for (auto newAsset : setNewAssetsToAdd) {
+        for (auto newAsset : SortedCacheEntries(setNewAssetsToAdd)) {
             passetsCache->Put(newAsset.asset.strName, CDatabasedAssetData(newAsset.asset, newAsset.blockHeight, newAsset.blockHash));
             if (!passetsdb->WriteAssetData(newAsset.asset, newAsset.blockHeight, newAsset.blockHash)) {
                 dirty = true;
@@ -2339,7 +2569,7 @@ bool CAssetsCache::DumpCacheToDatabase()
 
         if (fAssetIndex) {
             // Remove the new owners from database
-            for (auto ownerAsset : setNewOwnerAssetsToRemove) {
+            for (auto ownerAsset : SortedCacheEntries(setNewOwnerAssetsToRemove)) {
                 if (!passetsdb->EraseAssetAddressQuantity(ownerAsset.assetName, ownerAsset.address)) {
                     dirty = true;
                     message = "_Failed Erasing Owner Address Balance from database";
@@ -2356,7 +2586,7 @@ bool CAssetsCache::DumpCacheToDatabase()
             }
 
             // Add the new owners to database
-            for (auto ownerAsset : setNewOwnerAssetsToAdd) {
+            for (auto ownerAsset : SortedCacheEntries(setNewOwnerAssetsToAdd)) {
                 auto pair = std::make_pair(ownerAsset.assetName, ownerAsset.address);
                 if (mapAssetsAddressAmount.count(pair) && mapAssetsAddressAmount.at(pair) > 0) {
                     if (!passetsdb->WriteAssetAddressQuantity(ownerAsset.assetName, ownerAsset.address,
@@ -2379,7 +2609,7 @@ bool CAssetsCache::DumpCacheToDatabase()
 
             // Undo the transfering by updating the balances in the database
 
-            for (auto undoTransfer : setNewTransferAssetsToRemove) {
+            for (auto undoTransfer : SortedCacheEntries(setNewTransferAssetsToRemove)) {
                 auto pair = std::make_pair(undoTransfer.transfer.strName, undoTransfer.address);
                 if (mapAssetsAddressAmount.count(pair)) {
                     if (mapAssetsAddressAmount.at(pair) == 0) {
@@ -2422,7 +2652,7 @@ bool CAssetsCache::DumpCacheToDatabase()
 
 
             // Save the new transfers by updating the quantity in the database
-            for (auto newTransfer : setNewTransferAssetsToAdd) {
+            for (auto newTransfer : SortedCacheEntries(setNewTransferAssetsToAdd)) {
                 auto pair = std::make_pair(newTransfer.transfer.strName, newTransfer.address);
                 // During init and reindex it disconnects and verifies blocks, can create a state where vNewTransfer will contain transfers that have already been spent. So if they aren't in the map, we can skip them.
                 if (mapAssetsAddressAmount.count(pair)) {
@@ -2445,7 +2675,7 @@ bool CAssetsCache::DumpCacheToDatabase()
             }
         }
 
-        for (auto newReissue : setNewReissueToAdd) {
+        for (auto newReissue : SortedCacheEntries(setNewReissueToAdd)) {
             auto reissue_name = newReissue.reissue.strName;
             auto pair = make_pair(reissue_name, newReissue.address);
             if (mapReissuedAssetData.count(reissue_name)) {
@@ -2483,12 +2713,12 @@ bool CAssetsCache::DumpCacheToDatabase()
             }
         }
 
-        for (auto undoReissue : setNewReissueToRemove) {
+        for (auto undoReissue : SortedCacheEntries(setNewReissueToRemove)) {
             // In the case the the issue and reissue are both being removed
             // we can skip this call because the removal of the issue should remove all data pertaining the to asset
             // Fixes the issue where the reissue data will write over the removed asset meta data that was removed above
             CNewAsset asset(undoReissue.reissue.strName, 0);
-            CAssetCacheNewAsset testNewAssetCache(asset, "", 0 , uint256());
+            CAssetCacheNewAsset testNewAssetCache(asset, CAddressKey(), 0 , uint256());
             if (setNewAssetsToRemove.count(testNewAssetCache)) {
                 continue;
             }
@@ -2538,7 +2768,7 @@ bool CAssetsCache::DumpCacheToDatabase()
         }
 
         // Add new verifier strings for restricted assets
-        for (auto newVerifier : setNewRestrictedVerifierToAdd) {
+        for (auto newVerifier : SortedCacheEntries(setNewRestrictedVerifierToAdd)) {
             auto assetName = newVerifier.assetName;
             if (!prestricteddb->WriteVerifier(assetName, newVerifier.verifier)) {
                 dirty = true;
@@ -2553,7 +2783,7 @@ bool CAssetsCache::DumpCacheToDatabase()
         }
 
         // Undo verifier string for restricted assets
-        for (auto undoVerifiers : setNewRestrictedVerifierToRemove) {
+        for (auto undoVerifiers : SortedCacheEntries(setNewRestrictedVerifierToRemove)) {
             auto assetName = undoVerifiers.assetName;
 
             // If we are undoing a reissue, we need to save back the old verifier string to database
@@ -2577,9 +2807,9 @@ bool CAssetsCache::DumpCacheToDatabase()
         }
 
         // Add the new qualifier commands to the database
-        for (auto newQualifierAddress : setNewQualifierAddressToAdd) {
+        for (auto newQualifierAddress : SortedCacheEntries(setNewQualifierAddressToAdd)) {
             if (newQualifierAddress.type == QualifierType::REMOVE_QUALIFIER) {
-                passetsQualifierCache->Erase(newQualifierAddress.GetHash().GetHex());
+                passetsQualifierCache->Erase(newQualifierAddress.assetName, newQualifierAddress.address);
                 if (!prestricteddb->EraseAddressQualifier(newQualifierAddress.address, newQualifierAddress.assetName)) {
                     dirty = true;
                     message = "_Failed Erasing address qualifier from database";
@@ -2592,7 +2822,7 @@ bool CAssetsCache::DumpCacheToDatabase()
                     }
                 }
             } else if (newQualifierAddress.type == QualifierType::ADD_QUALIFIER) {
-                passetsQualifierCache->Put(newQualifierAddress.GetHash().GetHex(), 1);
+                passetsQualifierCache->Put(newQualifierAddress.assetName, newQualifierAddress.address, 1);
                 if (!prestricteddb->WriteAddressQualifier(newQualifierAddress.address, newQualifierAddress.assetName))
                 {
                     dirty = true;
@@ -2613,9 +2843,9 @@ bool CAssetsCache::DumpCacheToDatabase()
         }
 
         // Undo the qualifier commands
-        for (auto undoQualifierAddress : setNewQualifierAddressToRemove) {
+        for (auto undoQualifierAddress : SortedCacheEntries(setNewQualifierAddressToRemove)) {
             if (undoQualifierAddress.type == QualifierType::REMOVE_QUALIFIER) { // If we are undoing a removal, we write the data to database
-                passetsQualifierCache->Put(undoQualifierAddress.GetHash().GetHex(), 1);
+                passetsQualifierCache->Put(undoQualifierAddress.assetName, undoQualifierAddress.address, 1);
                 if (!prestricteddb->WriteAddressQualifier(undoQualifierAddress.address, undoQualifierAddress.assetName)) {
                     dirty = true;
                     message = "_Failed undoing a removal of a address qualifier  from database";
@@ -2628,7 +2858,7 @@ bool CAssetsCache::DumpCacheToDatabase()
                     }
                 }
             } else if (undoQualifierAddress.type == QualifierType::ADD_QUALIFIER) { // If we are undoing an addition, we remove the data from the database
-                passetsQualifierCache->Erase(undoQualifierAddress.GetHash().GetHex());
+                passetsQualifierCache->Erase(undoQualifierAddress.assetName, undoQualifierAddress.address);
                 if (!prestricteddb->EraseAddressQualifier(undoQualifierAddress.address, undoQualifierAddress.assetName))
                 {
                     dirty = true;
@@ -2649,15 +2879,15 @@ bool CAssetsCache::DumpCacheToDatabase()
         }
 
         // Add new restricted address commands
-        for (auto newRestrictedAddress : setNewRestrictedAddressToAdd) {
+        for (auto newRestrictedAddress : SortedCacheEntries(setNewRestrictedAddressToAdd)) {
             if (newRestrictedAddress.type == RestrictedType::UNFREEZE_ADDRESS) {
-                passetsRestrictionCache->Erase(newRestrictedAddress.GetHash().GetHex());
+                passetsRestrictionCache->Erase(newRestrictedAddress.assetName, newRestrictedAddress.address);
                 if (!prestricteddb->EraseRestrictedAddress(newRestrictedAddress.address, newRestrictedAddress.assetName)) {
                     dirty = true;
                     message = "_Failed Erasing restricted address from database";
                 }
             } else if (newRestrictedAddress.type == RestrictedType::FREEZE_ADDRESS) {
-                passetsRestrictionCache->Put(newRestrictedAddress.GetHash().GetHex(), 1);
+                passetsRestrictionCache->Put(newRestrictedAddress.assetName, newRestrictedAddress.address, 1);
                 if (!prestricteddb->WriteRestrictedAddress(newRestrictedAddress.address, newRestrictedAddress.assetName))
                 {
                     dirty = true;
@@ -2671,15 +2901,15 @@ bool CAssetsCache::DumpCacheToDatabase()
         }
 
         // Undo the qualifier addresses from database
-        for (auto undoRestrictedAddress : setNewRestrictedAddressToRemove) {
+        for (auto undoRestrictedAddress : SortedCacheEntries(setNewRestrictedAddressToRemove)) {
             if (undoRestrictedAddress.type == RestrictedType::UNFREEZE_ADDRESS) { // If we are undoing an unfreeze, we need to freeze the address
-                passetsRestrictionCache->Put(undoRestrictedAddress.GetHash().GetHex(), 1);
+                passetsRestrictionCache->Put(undoRestrictedAddress.assetName, undoRestrictedAddress.address, 1);
                 if (!prestricteddb->WriteRestrictedAddress(undoRestrictedAddress.address, undoRestrictedAddress.assetName)) {
                     dirty = true;
                     message = "_Failed undoing a removal of a restricted address from database";
                 }
             } else if (undoRestrictedAddress.type == RestrictedType::FREEZE_ADDRESS) { // If we are undoing a freeze, we need to unfreeze the address
-                passetsRestrictionCache->Erase(undoRestrictedAddress.GetHash().GetHex());
+                passetsRestrictionCache->Erase(undoRestrictedAddress.assetName, undoRestrictedAddress.address);
                 if (!prestricteddb->EraseRestrictedAddress(undoRestrictedAddress.address, undoRestrictedAddress.assetName))
                 {
                     dirty = true;
@@ -2693,7 +2923,7 @@ bool CAssetsCache::DumpCacheToDatabase()
         }
 
         // Add new global restriction commands
-        for (auto newGlobalRestriction : setNewRestrictedGlobalToAdd) {
+        for (auto newGlobalRestriction : SortedCacheEntries(setNewRestrictedGlobalToAdd)) {
             if (newGlobalRestriction.type == RestrictedType::GLOBAL_UNFREEZE) {
                 passetsGlobalRestrictionCache->Erase(newGlobalRestriction.assetName);
                 if (!prestricteddb->EraseGlobalRestriction(newGlobalRestriction.assetName)) {
@@ -2715,7 +2945,7 @@ bool CAssetsCache::DumpCacheToDatabase()
         }
 
         // Undo the global restriction commands
-        for (auto undoGlobalRestriction : setNewRestrictedGlobalToRemove) {
+        for (auto undoGlobalRestriction : SortedCacheEntries(setNewRestrictedGlobalToRemove)) {
             if (undoGlobalRestriction.type == RestrictedType::GLOBAL_UNFREEZE) { // If we are undoing an global unfreeze, we need to write a global freeze
                 passetsGlobalRestrictionCache->Put(undoGlobalRestriction.assetName, 1);
                 if (!prestricteddb->WriteGlobalRestriction(undoGlobalRestriction.assetName)) {
@@ -2799,6 +3029,9 @@ bool CAssetsCache::DumpCacheToDatabase()
             }
         }
 
+        if (!passetsdb->AddAssetSupply(mapAssetSupplyDelta))
+            return error("%s : %s", __func__, "_Failed Writing Asset Supply to database");
+
         ClearDirtyCache();
 
         return true;
@@ -2812,180 +3045,184 @@ bool CAssetsCache::DumpCacheToDatabase()
 bool CAssetsCache::Flush()
 {
 
-    if (!passets)
-        return error("%s: Couldn't find passets pointer while trying to flush assets cache", __func__);
+    CAssetsCache* pbaseCache = GetBase();
+    if (!pbaseCache)
+        return error("%s: Couldn't find the base cache while trying to flush assets cache", __func__);
 
     try {
         for (auto &item : setNewAssetsToAdd) {
-            if (passets->setNewAssetsToRemove.count(item))
-                passets->setNewAssetsToRemove.erase(item);
-            passets->setNewAssetsToAdd.insert(item);
+            if (pbaseCache->setNewAssetsToRemove.count(item))
+                pbaseCache->setNewAssetsToRemove.erase(item);
+            pbaseCache->setNewAssetsToAdd.insert(item);
         }
 
         for (auto &item : setNewAssetsToRemove) {
-            if (passets->setNewAssetsToAdd.count(item))
-                passets->setNewAssetsToAdd.erase(item);
-            passets->setNewAssetsToRemove.insert(item);
+            if (pbaseCache->setNewAssetsToAdd.count(item))
+                pbaseCache->setNewAssetsToAdd.erase(item);
+            pbaseCache->setNewAssetsToRemove.insert(item);
         }
 
         for (auto &item : mapAssetsAddressAmount)
-            passets->mapAssetsAddressAmount[item.first] = item.second;
+            pbaseCache->mapAssetsAddressAmount[item.first] = item.second;
 
         for (auto &item : mapReissuedAssetData)
-            passets->mapReissuedAssetData[item.first] = item.second;
+            pbaseCache->mapReissuedAssetData[item.first] = item.second;
 
         for (auto &item : setNewOwnerAssetsToAdd) {
-            if (passets->setNewOwnerAssetsToRemove.count(item))
-                passets->setNewOwnerAssetsToRemove.erase(item);
-            passets->setNewOwnerAssetsToAdd.insert(item);
+            if (pbaseCache->setNewOwnerAssetsToRemove.count(item))
+                pbaseCache->setNewOwnerAssetsToRemove.erase(item);
+            pbaseCache->setNewOwnerAssetsToAdd.insert(item);
         }
 
         for (auto &item : setNewOwnerAssetsToRemove) {
-            if (passets->setNewOwnerAssetsToAdd.count(item))
-                passets->setNewOwnerAssetsToAdd.erase(item);
-            passets->setNewOwnerAssetsToRemove.insert(item);
+            if (pbaseCache->setNewOwnerAssetsToAdd.count(item))
+                pbaseCache->setNewOwnerAssetsToAdd.erase(item);
+            pbaseCache->setNewOwnerAssetsToRemove.insert(item);
         }
 
         for (auto &item : setNewReissueToAdd) {
-            if (passets->setNewReissueToRemove.count(item))
-                passets->setNewReissueToRemove.erase(item);
-            passets->setNewReissueToAdd.insert(item);
+            if (pbaseCache->setNewReissueToRemove.count(item))
+                pbaseCache->setNewReissueToRemove.erase(item);
+            pbaseCache->setNewReissueToAdd.insert(item);
         }
 
         for (auto &item : setNewReissueToRemove) {
-            if (passets->setNewReissueToAdd.count(item))
-                passets->setNewReissueToAdd.erase(item);
-            passets->setNewReissueToRemove.insert(item);
+            if (pbaseCache->setNewReissueToAdd.count(item))
+                pbaseCache->setNewReissueToAdd.erase(item);
+            pbaseCache->setNewReissueToRemove.insert(item);
         }
 
         for (auto &item : setNewTransferAssetsToAdd) {
-            if (passets->setNewTransferAssetsToRemove.count(item))
-                passets->setNewTransferAssetsToRemove.erase(item);
-            passets->setNewTransferAssetsToAdd.insert(item);
+            if (pbaseCache->setNewTransferAssetsToRemove.count(item))
+                pbaseCache->setNewTransferAssetsToRemove.erase(item);
+            pbaseCache->setNewTransferAssetsToAdd.insert(item);
         }
 
         for (auto &item : setNewTransferAssetsToRemove) {
-            if (passets->setNewTransferAssetsToAdd.count(item))
-                passets->setNewTransferAssetsToAdd.erase(item);
-            passets->setNewTransferAssetsToRemove.insert(item);
+            if (pbaseCache->setNewTransferAssetsToAdd.count(item))
+                pbaseCache->setNewTransferAssetsToAdd.erase(item);
+            pbaseCache->setNewTransferAssetsToRemove.insert(item);
         }
 
         for (auto &item : vSpentAssets) {
-            passets->vSpentAssets.emplace_back(item);
+            pbaseCache->vSpentAssets.emplace_back(item);
         }
 
         for (auto &item : vUndoAssetAmount) {
-            passets->vUndoAssetAmount.emplace_back(item);
+            pbaseCache->vUndoAssetAmount.emplace_back(item);
         }
 
         for(auto &item : setNewQualifierAddressToAdd) {
-            if (passets->setNewQualifierAddressToRemove.count(item)) {
-                passets->setNewQualifierAddressToRemove.erase(item);
+            if (pbaseCache->setNewQualifierAddressToRemove.count(item)) {
+                pbaseCache->setNewQualifierAddressToRemove.erase(item);
             }
 
-            if (passets->setNewQualifierAddressToAdd.count(item)) {
-                passets->setNewQualifierAddressToAdd.erase(item);
+            if (pbaseCache->setNewQualifierAddressToAdd.count(item)) {
+                pbaseCache->setNewQualifierAddressToAdd.erase(item);
             }
 
-            passets->setNewQualifierAddressToAdd.insert(item);
+            pbaseCache->setNewQualifierAddressToAdd.insert(item);
         }
 
         for(auto &item : setNewQualifierAddressToRemove) {
-            if (passets->setNewQualifierAddressToAdd.count(item)) {
-                passets->setNewQualifierAddressToAdd.erase(item);
+            if (pbaseCache->setNewQualifierAddressToAdd.count(item)) {
+                pbaseCache->setNewQualifierAddressToAdd.erase(item);
             }
 
-            if (passets->setNewQualifierAddressToRemove.count(item)) {
-                passets->setNewQualifierAddressToRemove.erase(item);
+            if (pbaseCache->setNewQualifierAddressToRemove.count(item)) {
+                pbaseCache->setNewQualifierAddressToRemove.erase(item);
             }
 
-            passets->setNewQualifierAddressToRemove.insert(item);
+            pbaseCache->setNewQualifierAddressToRemove.insert(item);
         }
 
         for(auto &item : setNewRestrictedAddressToAdd) {
-            if (passets->setNewRestrictedAddressToRemove.count(item)) {
-                passets->setNewRestrictedAddressToRemove.erase(item);
+            if (pbaseCache->setNewRestrictedAddressToRemove.count(item)) {
+                pbaseCache->setNewRestrictedAddressToRemove.erase(item);
             }
 
-            if (passets->setNewRestrictedAddressToAdd.count(item)) {
-                passets->setNewRestrictedAddressToAdd.erase(item);
+            if (pbaseCache->setNewRestrictedAddressToAdd.count(item)) {
+                pbaseCache->setNewRestrictedAddressToAdd.erase(item);
             }
 
-            passets->setNewRestrictedAddressToAdd.insert(item);
+            pbaseCache->setNewRestrictedAddressToAdd.insert(item);
         }
 
         for(auto &item : setNewRestrictedAddressToRemove) {
-            if (passets->setNewRestrictedAddressToAdd.count(item)) {
-                passets->setNewRestrictedAddressToAdd.erase(item);
+            if (pbaseCache->setNewRestrictedAddressToAdd.count(item)) {
+                pbaseCache->setNewRestrictedAddressToAdd.erase(item);
             }
 
-            if (passets->setNewRestrictedAddressToRemove.count(item)) {
-                passets->setNewRestrictedAddressToRemove.erase(item);
+            if (pbaseCache->setNewRestrictedAddressToRemove.count(item)) {
+                pbaseCache->setNewRestrictedAddressToRemove.erase(item);
             }
 
-            passets->setNewRestrictedAddressToRemove.insert(item);
+            pbaseCache->setNewRestrictedAddressToRemove.insert(item);
         }
 
         for(auto &item : setNewRestrictedGlobalToAdd) {
-            if (passets->setNewRestrictedGlobalToRemove.count(item)) {
-                passets->setNewRestrictedGlobalToRemove.erase(item);
+            if (pbaseCache->setNewRestrictedGlobalToRemove.count(item)) {
+                pbaseCache->setNewRestrictedGlobalToRemove.erase(item);
             }
 
-            if (passets->setNewRestrictedGlobalToAdd.count(item)) {
-                passets->setNewRestrictedGlobalToAdd.erase(item);
+            if (pbaseCache->setNewRestrictedGlobalToAdd.count(item)) {
+                pbaseCache->setNewRestrictedGlobalToAdd.erase(item);
             }
 
-            passets->setNewRestrictedGlobalToAdd.insert(item);
+            pbaseCache->setNewRestrictedGlobalToAdd.insert(item);
         }
 
         for(auto &item : setNewRestrictedGlobalToRemove) {
-            if (passets->setNewRestrictedGlobalToAdd.count(item)) {
-                passets->setNewRestrictedGlobalToAdd.erase(item);
+            if (pbaseCache->setNewRestrictedGlobalToAdd.count(item)) {
+                pbaseCache->setNewRestrictedGlobalToAdd.erase(item);
             }
 
-            if (passets->setNewRestrictedGlobalToRemove.count(item)) {
-                passets->setNewRestrictedGlobalToRemove.erase(item);
+            if (pbaseCache->setNewRestrictedGlobalToRemove.count(item)) {
+                pbaseCache->setNewRestrictedGlobalToRemove.erase(item);
             }
 
-            passets->setNewRestrictedGlobalToRemove.insert(item);
+            pbaseCache->setNewRestrictedGlobalToRemove.insert(item);
         }
 
         for (auto &item : setNewRestrictedVerifierToAdd) {
-            if (passets->setNewRestrictedVerifierToRemove.count(item)) {
-                passets->setNewRestrictedVerifierToRemove.erase(item);
+            if (pbaseCache->setNewRestrictedVerifierToRemove.count(item)) {
+                pbaseCache->setNewRestrictedVerifierToRemove.erase(item);
             }
 
-            if (passets->setNewRestrictedVerifierToAdd.count(item)) {
-                passets->setNewRestrictedVerifierToAdd.erase(item);
+            if (pbaseCache->setNewRestrictedVerifierToAdd.count(item)) {
+                pbaseCache->setNewRestrictedVerifierToAdd.erase(item);
             }
 
-            passets->setNewRestrictedVerifierToAdd.insert(item);
+            pbaseCache->setNewRestrictedVerifierToAdd.insert(item);
         }
 
         for (auto &item : setNewRestrictedVerifierToRemove) {
-            if (passets->setNewRestrictedVerifierToAdd.count(item)) {
-                passets->setNewRestrictedVerifierToAdd.erase(item);
+            if (pbaseCache->setNewRestrictedVerifierToAdd.count(item)) {
+                pbaseCache->setNewRestrictedVerifierToAdd.erase(item);
             }
 
-            if (passets->setNewRestrictedVerifierToRemove.count(item)) {
-                passets->setNewRestrictedVerifierToRemove.erase(item);
+            if (pbaseCache->setNewRestrictedVerifierToRemove.count(item)) {
+                pbaseCache->setNewRestrictedVerifierToRemove.erase(item);
             }
 
-            passets->setNewRestrictedVerifierToRemove.insert(item);
+            pbaseCache->setNewRestrictedVerifierToRemove.insert(item);
         }
 
         for (auto &item : mapRootQualifierAddressesAdd) {
             for (auto asset : item.second) {
-                passets->mapRootQualifierAddressesAdd[item.first].insert(asset);
+                pbaseCache->mapRootQualifierAddressesAdd[item.first].insert(asset);
             }
         }
 
         for (auto &item : mapRootQualifierAddressesRemove) {
             for (auto asset : item.second) {
-                passets->mapRootQualifierAddressesAdd[item.first].insert(asset);
+                pbaseCache->mapRootQualifierAddressesAdd[item.first].insert(asset);
             }
         }
 
+        for (auto &item : mapAssetSupplyDelta)
+            pbaseCache->mapAssetSupplyDelta[item.first] += item.second;
+
         return true;
 
     } catch (const std::runtime_error& e) {
@@ -3184,18 +3421,14 @@ bool IsScriptNewUniqueAsset(const CScript& scriptPubKey)
 
 bool IsScriptNewUniqueAsset(const CScript &scriptPubKey, int &nStartingIndex)
 {
-    int nType = 0;
-    bool fIsOwner = false;
-    if (!scriptPubKey.IsAssetScript(nType, fIsOwner, nStartingIndex))
+    CAssetScriptView view;
+    if (!DecodeAssetScript(scriptPubKey, view) || view.type == AssetScriptType::NONE)
         return false;
+    nStartingIndex = view.nStartingIndex;
 
     CNewAsset asset;
-    std::string address;
-    if (!AssetFromScript(scriptPubKey, asset, address))
-        return false;
-
     AssetType assetType;
-    if (!IsAssetNameValid(asset.strName, assetType))
+    if (!NewAssetNameTypeFromView(view, asset, assetType, "asset"))
         return false;
 
     return AssetType::UNIQUE == assetType;
@@ -3209,18 +3442,14 @@ bool IsScriptNewMsgChannelAsset(const CScript& scriptPubKey)
 
 bool IsScriptNewMsgChannelAsset(const CScript &scriptPubKey, int &nStartingIndex)
 {
-    int nType = 0;
-    bool fIsOwner = false;
-    if (!scriptPubKey.IsAssetScript(nType, fIsOwner, nStartingIndex))
+    CAssetScriptView view;
+    if (!DecodeAssetScript(scriptPubKey, view) || view.type == AssetScriptType::NONE)
         return false;
+    nStartingIndex = view.nStartingIndex;
 
     CNewAsset asset;
-    std::string address;
-    if (!AssetFromScript(scriptPubKey, asset, address))
-        return false;
-
     AssetType assetType;
-    if (!IsAssetNameValid(asset.strName, assetType))
+    if (!NewAssetNameTypeFromView(view, asset, assetType, "asset"))
         return false;
 
     return AssetType::MSGCHANNEL == assetType;
@@ -3286,18 +3515,14 @@ bool IsScriptNewQualifierAsset(const CScript& scriptPubKey)
 
 bool IsScriptNewQualifierAsset(const CScript &scriptPubKey, int &nStartingIndex)
 {
-    int nType = 0;
-    bool fIsOwner = false;
-    if (!scriptPubKey.IsAssetScript(nType, fIsOwner, nStartingIndex))
+    CAssetScriptView view;
+    if (!DecodeAssetScript(scriptPubKey, view) || view.type == AssetScriptType::NONE)
         return false;
+    nStartingIndex = view.nStartingIndex;
 
     CNewAsset asset;
-    std::string address;
-    if (!AssetFromScript(scriptPubKey, asset, address))
-        return false;
-
     AssetType assetType;
-    if (!IsAssetNameValid(asset.strName, assetType))
+    if (!NewAssetNameTypeFromView(view, asset, assetType, "asset"))
         return false;
 
     return AssetType::QUALIFIER == assetType || AssetType::SUB_QUALIFIER == assetType;
@@ -3311,18 +3536,14 @@ bool IsScriptNewRestrictedAsset(const CScript& scriptPubKey)
 
 bool IsScriptNewRestrictedAsset(const CScript &scriptPubKey, int &nStartingIndex)
 {
-    int nType = 0;
-    bool fIsOwner = false;
-    if (!scriptPubKey.IsAssetScript(nType, fIsOwner, nStartingIndex))
+    CAssetScriptView view;
+    if (!DecodeAssetScript(scriptPubKey, view) || view.type == AssetScriptType::NONE)
         return false;
+    nStartingIndex = view.nStartingIndex;
 
     CNewAsset asset;
-    std::string address;
-    if (!AssetFromScript(scriptPubKey, asset, address))
-        return false;
-
     AssetType assetType;
-    if (!IsAssetNameValid(asset.strName, assetType))
+    if (!NewAssetNameTypeFromView(view, asset, assetType, "asset"))
         return false;
 
     return AssetType::RESTRICTED == assetType;
@@ -3340,10 +3561,12 @@ bool CAssetsCache::CheckIfAssetExists(const std::string& name, bool fForceDuplic
     // Create objects that will be used to check the dirty cache
     CNewAsset asset;
     asset.strName = name;
-    CAssetCacheNewAsset cachedAsset(asset, "", 0, uint256());
+    CAssetCacheNewAsset cachedAsset(asset, CAddressKey(), 0, uint256());
 
     // Check the dirty caches first and see if it was recently added or removed
-    if (setNewAssetsToRemove.count(cachedAsset)) {
+    bool fRemoved = false;
+    const CAssetCacheNewAsset* pDirty = FindInOverlays(this, &CAssetsCache::setNewAssetsToRemove, &CAssetsCache::setNewAssetsToAdd, cachedAsset, fRemoved);
+    if (pDirty && fRemoved) {
         return false;
     }
 
@@ -3352,7 +3575,7 @@ bool CAssetsCache::CheckIfAssetExists(const std::string& name, bool fForceDuplic
         return false;
     }
 
-    if (setNewAssetsToAdd.count(cachedAsset)) {
+    if (pDirty) {
         if (fForceDuplicateCheck) {
             return true;
         }
@@ -3409,8 +3632,9 @@ bool CAssetsCache::GetAssetMetaDataIfExists(const std::string &name, CNewAsset &
 bool CAssetsCache::GetAssetMetaDataIfExists(const std::string &name, CNewAsset &asset, int& nHeight, uint256& blockHash)
 {
     // Check the map that contains the reissued asset data. If it is in this map, it hasn't been saved to disk yet
-    if (mapReissuedAssetData.count(name)) {
-        asset = mapReissuedAssetData.at(name);
+    const CNewAsset* pReissued = FindInOverlays(this, &CAssets::mapReissuedAssetData, name);
+    if (pReissued) {
+        asset = *pReissued;
         return true;
     }
 
@@ -3423,10 +3647,12 @@ bool CAssetsCache::GetAssetMetaDataIfExists(const std::string &name, CNewAsset &
     // Create objects that will be used to check the dirty cache
     CNewAsset tempAsset;
     tempAsset.strName = name;
-    CAssetCacheNewAsset cachedAsset(tempAsset, "", 0, uint256());
+    CAssetCacheNewAsset cachedAsset(tempAsset, CAddressKey(), 0, uint256());
 
     // Check the dirty caches first and see if it was recently added or removed
-    if (setNewAssetsToRemove.count(cachedAsset)) {
+    bool fRemoved = false;
+    const CAssetCacheNewAsset* pDirty = FindInOverlays(this, &CAssetsCache::setNewAssetsToRemove, &CAssetsCache::setNewAssetsToAdd, cachedAsset, fRemoved);
+    if (pDirty && fRemoved) {
         LogPrintf("%s : Found in new assets to Remove - Returning False\n", __func__);
         return false;
     }
@@ -3437,15 +3663,14 @@ bool CAssetsCache::GetAssetMetaDataIfExists(const std::string &name, CNewAsset &
         return false;
     }
 
-    auto setIterator = setNewAssetsToAdd.find(cachedAsset);
-    if (setIterator != setNewAssetsToAdd.end()) {
-        asset = setIterator->asset;
-        nHeight = setIterator->blockHeight;
-        blockHash = setIterator->blockHash;
+    if (pDirty) {
+        asset = pDirty->asset;
+        nHeight = pDirty->blockHeight;
+        blockHash = pDirty->blockHash;
         return true;
     }
 
-    setIterator = passets->setNewAssetsToAdd.find(cachedAsset);
+    auto setIterator = passets->setNewAssetsToAdd.find(cachedAsset);
     if (setIterator != passets->setNewAssetsToAdd.end()) {
         asset = setIterator->asset;
         nHeight = setIterator->blockHeight;
@@ -3455,9 +3680,8 @@ bool CAssetsCache::GetAssetMetaDataIfExists(const std::string &name, CNewAsset &
 
     // Check the cache, if it doesn't exist in the cache. Try and read it from database
     if (passetsCache) {
-        if (passetsCache->Exists(name)) {
-            CDatabasedAssetData data;
-            data = passetsCache->Get(name);
+        CDatabasedAssetData data;
+        if (passetsCache->Get(name, data)) {
             asset = data.asset;
             nHeight = data.nHeight;
             blockHash = data.blockHash;
@@ -3499,10 +3723,73 @@ bool GetAssetInfoFromCoin(const Coin& coin, std::string& strName, CAmount& nAmou
     return GetAssetInfoFromScript(coin.out.scriptPubKey, strName, nAmount);
 }
 
+void DecodeAssetOutput(const CScript& script, CAssetOutputRecord& record)
+{
+    record = CAssetOutputRecord();
+    CAssetScriptView view;
+    DecodeAssetScript(script, view);
+    if (view.type == AssetScriptType::NONE)
+        return;
+    record.fIsAsset = true;
+    record.fIsOwner = view.type == AssetScriptType::OWNER;
+
+    if (view.type == AssetScriptType::TRANSFER) {
+        record.nType = TX_TRANSFER_ASSET;
+        record.fDecoded = TransferAssetFromView(script, view, record.transfer, record.address);
+    } else if (view.type == AssetScriptType::REISSUE) {
+        record.nType = TX_REISSUE_ASSET;
+        record.fDecoded = ReissueAssetFromView(script, view, record.reissue, record.address);
+    } else {
+        record.nType = TX_NEW_ASSET;
+        if (!record.fIsOwner)
+            record.fDecoded = AssetFromView(script, view, record.asset, record.address);
+    }
+}
+
+bool DecodeCoinAssetData(const CScript& script, CCoinAssetData& data)
+{
+    data = CCoinAssetData();
+    CAssetScriptView view;
+    DecodeAssetScript(script, view);
+
+    if (view.type == AssetScriptType::TRANSFER) {
+        CAssetTransfer transfer;
+        if (TransferAssetFromView(script, view, transfer, data.address)) {
+            data.strName = std::move(transfer.strName);
+            data.nAmount = transfer.nAmount;
+            data.fDecoded = true;
+        }
+    } else if (view.type == AssetScriptType::REISSUE) {
+        CReissueAsset reissue;
+        if (ReissueAssetFromView(script, view, reissue, data.address)) {
+            data.strName = std::move(reissue.strName);
+            data.nAmount = reissue.nAmount;
+            data.fDecoded = true;
+        }
+    } else if (view.type == AssetScriptType::OWNER) {
+        data.address = CAddressKey::FromScript(script);
+        if (UnserializeAssetPayload(view.pPayload, view.nPayloadSize, data.strName, "owner asset")) {
+            data.nAmount = OWNER_ASSET_AMOUNT;
+            data.fDecoded = true;
+        }
+    } else if (view.type == AssetScriptType::NEW_ASSET) {
+        CNewAsset asset;
+        if (AssetFromView(script, view, asset, data.address)) {
+            data.strName = std::move(asset.strName);
+            data.nAmount = asset.nAmount;
+            data.fDecoded = true;
+        }
+    }
+    if (!data.fDecoded)
+        data = CCoinAssetData();
+    return data.fDecoded;
+}
+
 bool GetAssetData(const CScript& script, CAssetOutputEntry& data)
 {
     // Placeholder strings that will get set if you successfully get the transfer or asset from the script
     std::string address = "";
+    CAddressKey addressKey;
     std::string assetName = "";
 
     int nType = 0;
@@ -3516,10 +3803,10 @@ bool GetAssetData(const CScript& script, CAssetOutputEntry& data)
     // Get the New Asset or Transfer Asset from the scriptPubKey
     if (type == TX_NEW_ASSET && !fIsOwner) {
         CNewAsset asset;
-        if (AssetFromScript(script, asset, address)) {
+        if (AssetFromScript(script, asset, addressKey)) {
             data.type = TX_NEW_ASSET;
             data.nAmount = asset.nAmount;
-            data.destination = DecodeDestination(address);
+            data.destination = addressKey.GetDestination();
             data.assetName = asset.strName;
             return true;
         } else if (MsgChannelAssetFromScript(script, asset, address)) {
@@ -3540,10 +3827,10 @@ bool GetAssetData(const CScript& script, CAssetOutputEntry& data)
         }
     } else if (type == TX_TRANSFER_ASSET) {
         CAssetTransfer transfer;
-        if (TransferAssetFromScript(script, transfer, address)) {
+        if (TransferAssetFromScript(script, transfer, addressKey)) {
             data.type = TX_TRANSFER_ASSET;
             data.nAmount = transfer.nAmount;
-            data.destination = DecodeDestination(address);
+            data.destination = addressKey.GetDestination();
             data.assetName = transfer.strName;
             data.message = transfer.message;
             data.expireTime = transfer.nExpireTime;
@@ -3552,19 +3839,19 @@ bool GetAssetData(const CScript& script, CAssetOutputEntry& data)
             LogPrintf("Failed to get transfer from script\n");
         }
     } else if (type == TX_NEW_ASSET && fIsOwner) {
-        if (OwnerAssetFromScript(script, assetName, address)) {
+        if (OwnerAssetFromScript(script, assetName, addressKey)) {
             data.type = TX_NEW_ASSET;
             data.nAmount = OWNER_ASSET_AMOUNT;
-            data.destination = DecodeDestination(address);
+            data.destination = addressKey.GetDestination();
             data.assetName = assetName;
             return true;
         }
     } else if (type == TX_REISSUE_ASSET) {
         CReissueAsset reissue;
-        if (ReissueAssetFromScript(script, reissue, address)) {
+        if (ReissueAssetFromScript(script, reissue, addressKey)) {
             data.type = TX_REISSUE_ASSET;
             data.nAmount = reissue.nAmount;
-            data.destination = DecodeDestination(address);
+            data.destination = addressKey.GetDestination();
             data.assetName = reissue.strName;
             return true;
         }
@@ -3721,7 +4008,7 @@ std::string GetBurnAddress(const AssetType type)
 }
 
 //! This will get the amount that an address for a certain asset contains from the database if they cache doesn't already have it
-bool GetBestAssetAddressAmount(CAssetsCache& cache, const std::string& assetName, const std::string& address)
+bool GetBestAssetAddressAmount(CAssetsCache& cache, const std::string& assetName, const CAddressKey& address)
 {
     if (fAssetIndex) {
         auto pair = make_pair(assetName, address);
@@ -3731,8 +4018,11 @@ bool GetBestAssetAddressAmount(CAssetsCache& cache, const std::string& assetName
             return true;
 
         // If the caches map has the pair, return true because the map already contains the best dirty amount
-        if (passets->mapAssetsAddressAmount.count(pair)) {
-            cache.mapAssetsAddressAmount[pair] = passets->mapAssetsAddressAmount.at(pair);
+        const CAmount* pAmount = FindInOverlays(cache.GetBase(), &CAssets::mapAssetsAddressAmount, pair);
+        if (!pAmount && passets->mapAssetsAddressAmount.count(pair))
+            pAmount = &passets->mapAssetsAddressAmount.at(pair);
+        if (pAmount) {
+            cache.mapAssetsAddressAmount[pair] = *pAmount;
             return true;
         }
 
@@ -4206,7 +4496,7 @@ bool CreateReissueAssetTransaction(CWallet* pwallet, CCoinControl& coinControl,
 
 // nullAssetTxData -> Use this for freeze/unfreeze an address or adding a qualifier to an address
 // nullGlobalRestrictionData -> Use this to globally freeze/unfreeze a restricted asset.
-bool CreateTransferAssetTransaction(CWallet* pwallet, const CCoinControl& coinControl, const std::vector< std::pair<CAssetTransfer, std::string> >vTransfers, const std::string& changeAddress, std::pair<int, std::string>& error, CWalletTx& wtxNew, CReserveKey& reservekey, CAmount& nFeeRequired, std::vector<std::pair<CNullAssetTxData, std::string> >* nullAssetTxData, std::vector<CNullAssetTxData>* nullGlobalRestrictionData)
+bool CreateTransferAssetTransaction(CWallet* pwallet, const CCoinControl& coinControl, const std::vector< std::pair<CAssetTransfer, std::string> >vTransfers, const std::string& changeAddress, std::pair<int, std::string>& error, CWalletTx& wtxNew, CReserveKey& reservekey, CAmount& nFeeRequired, std::vector<std::pair<CNullAssetTxData, std::string> >* nullAssetTxData, std::vector<CNullAssetTxData>* nullGlobalRestrictionData, bool sign)
 {
     // Initialize Values for transaction
     std::string strTxError;
@@ -4352,7 +4642,7 @@ bool CreateTransferAssetTransaction(CWallet* pwallet, const CCoinControl& coinCo
     }
 
     // Create and send the transaction
-    if (!pwallet->CreateTransactionWithTransferAsset(vecSend, wtxNew, reservekey, nFeeRequired, nChangePosRet, strTxError, coinControl)) {
+    if (!pwallet->CreateTransactionWithTransferAsset(vecSend, wtxNew, reservekey, nFeeRequired, nChangePosRet, strTxError, coinControl, sign)) {
         if (!fSubtractFeeFromAmount && nFeeRequired > curBalance) {
             error = std::make_pair(RPC_WALLET_ERROR, strprintf("Error: This transaction requires a transaction fee of at least %s", FormatMoney(nFeeRequired)));
             return false;
@@ -4583,17 +4873,18 @@ bool CAssetsCache::GetAssetVerifierStringIfExists(const std::string &name, CNull
     // Create objects that will be used to check the dirty cache
     CAssetCacheRestrictedVerifiers tempCacheVerifier {name, ""};
 
-    auto setIterator = setNewRestrictedVerifierToRemove.find(tempCacheVerifier);
+    bool fRemoved = false;
+    const CAssetCacheRestrictedVerifiers* pDirty = fSkipTempCache ? nullptr : FindInOverlays(this, &CAssetsCache::setNewRestrictedVerifierToRemove, &CAssetsCache::setNewRestrictedVerifierToAdd, tempCacheVerifier, fRemoved);
     // Check the dirty caches first and see if it was recently added or removed
-    if (!fSkipTempCache && setIterator != setNewRestrictedVerifierToRemove.end()) {
-        if (setIterator->fUndoingRessiue) {
-            verifierString.verifier_string = setIterator->verifier;
+    if (pDirty && fRemoved) {
+        if (pDirty->fUndoingRessiue) {
+            verifierString.verifier_string = pDirty->verifier;
             return true;
         }
         return false;
     }
 
-    setIterator = passets->setNewRestrictedVerifierToRemove.find(tempCacheVerifier);
+    auto setIterator = passets->setNewRestrictedVerifierToRemove.find(tempCacheVerifier);
     // Check the dirty caches first and see if it was recently added or removed
     if (setIterator != passets->setNewRestrictedVerifierToRemove.end()) {
         if (setIterator->fUndoingRessiue) {
@@ -4603,9 +4894,8 @@ bool CAssetsCache::GetAssetVerifierStringIfExists(const std::string &name, CNull
         return false;
     }
 
-    setIterator = setNewRestrictedVerifierToAdd.find(tempCacheVerifier);
-    if (!fSkipTempCache && setIterator != setNewRestrictedVerifierToAdd.end()) {
-        verifierString.verifier_string = setIterator->verifier;
+    if (pDirty) {
+        verifierString.verifier_string = pDirty->verifier;
         return true;
     }
 
@@ -4617,8 +4907,7 @@ bool CAssetsCache::GetAssetVerifierStringIfExists(const std::string &name, CNull
 
     // Check the cache, if it doesn't exist in the cache. Try and read it from database
     if (passetsVerifierCache) {
-        if (passetsVerifierCache->Exists(name)) {
-            verifierString = passetsVerifierCache->Get(name);
+        if (passetsVerifierCache->Get(name, verifierString)) {
             return true;
         }
     }
@@ -4627,6 +4916,7 @@ bool CAssetsCache::GetAssetVerifierStringIfExists(const std::string &name, CNull
         std::string verifier;
         if (prestricteddb->ReadVerifier(name, verifier)) {
             verifierString.verifier_string = verifier;
+            verifierString.compiled = CompileVerifierString(verifier);
             if (passetsVerifierCache)
                 passetsVerifierCache->Put(name, verifierString);
             return true;
@@ -4651,23 +4941,23 @@ bool CAssetsCache::CheckForAddressQualifier(const std::string &qualifier_name, c
     CAssetCacheQualifierAddress cachedQualifierAddress(qualifier_name, address, QualifierType::ADD_QUALIFIER);
 
     // Check the dirty caches first and see if it was recently added or removed
-    auto setIterator = setNewQualifierAddressToRemove.find(cachedQualifierAddress);
-    if (!fSkipTempCache &&setIterator != setNewQualifierAddressToRemove.end()) {
+    bool fRemoved = false;
+    const CAssetCacheQualifierAddress* pDirty = fSkipTempCache ? nullptr : FindInOverlays(this, &CAssetsCache::setNewQualifierAddressToRemove, &CAssetsCache::setNewQualifierAddressToAdd, cachedQualifierAddress, fRemoved);
+    if (pDirty && fRemoved) {
         // Undoing a remove qualifier command, means that we are adding the qualifier to the address
-        return setIterator->type == QualifierType::REMOVE_QUALIFIER;
+        return pDirty->type == QualifierType::REMOVE_QUALIFIER;
     }
 
 
-    setIterator = passets->setNewQualifierAddressToRemove.find(cachedQualifierAddress);
+    auto setIterator = passets->setNewQualifierAddressToRemove.find(cachedQualifierAddress);
     if (setIterator != passets->setNewQualifierAddressToRemove.end()) {
         // Undoing a remove qualifier command, means that we are adding the qualifier to the address
         return setIterator->type == QualifierType::REMOVE_QUALIFIER;
     }
 
-    setIterator = setNewQualifierAddressToAdd.find(cachedQualifierAddress);
-    if (!fSkipTempCache && setIterator != setNewQualifierAddressToAdd.end()) {
+    if (pDirty) {
         // Return true if we are adding the qualifier, and false if we are removing it
-        return setIterator->type == QualifierType::ADD_QUALIFIER;
+        return pDirty->type == QualifierType::ADD_QUALIFIER;
     }
 
 
@@ -4695,10 +4985,8 @@ bool CAssetsCache::CheckForAddressQualifier(const std::string &qualifier_name, c
     }
 
     auto tempChecker = CAssetCacheRootQualifierChecker(qualifier_name, address);
-    if (!fSkipTempCache && mapRootQualifierAddressesAdd.count(tempChecker)){
-        if (mapRootQualifierAddressesAdd.at(tempChecker).size()) {
-            return true;
-        }
+    if (!fSkipTempCache && HasRootQualifierInOverlays(this, tempChecker)) {
+        return true;
     }
 
     if (passets->mapRootQualifierAddressesAdd.count(tempChecker)) {
@@ -4709,7 +4997,7 @@ bool CAssetsCache::CheckForAddressQualifier(const std::string &qualifier_name, c
 
     // Check the cache, if it doesn't exist in the cache. Try and read it from database
     if (passetsQualifierCache) {
-        if (passetsQualifierCache->Exists(cachedQualifierAddress.GetHash().GetHex())) {
+        if (passetsQualifierCache->Exists(cachedQualifierAddress.assetName, cachedQualifierAddress.address)) {
             return true;
         }
     }
@@ -4717,7 +5005,7 @@ bool CAssetsCache::CheckForAddressQualifier(const std::string &qualifier_name, c
     if (prestricteddb) {
         // Check for exact qualifier, and add to cache if it exists
         if (prestricteddb->ReadAddressQualifier(address, qualifier_name)) {
-            passetsQualifierCache->Put(cachedQualifierAddress.GetHash().GetHex(), 1);
+            passetsQualifierCache->Put(cachedQualifierAddress.assetName, cachedQualifierAddress.address, 1);
             return true;
         }
 
@@ -4746,22 +5034,22 @@ bool CAssetsCache::CheckForAddressRestriction(const std::string &restricted_name
     CAssetCacheRestrictedAddress cachedRestrictedAddress(restricted_name, address, RestrictedType::FREEZE_ADDRESS);
 
     // Check the dirty caches first and see if it was recently added or removed
-    auto setIterator = setNewRestrictedAddressToRemove.find(cachedRestrictedAddress);
-    if (!fSkipTempCache && setIterator != setNewRestrictedAddressToRemove.end()) {
+    bool fRemoved = false;
+    const CAssetCacheRestrictedAddress* pDirty = fSkipTempCache ? nullptr : FindInOverlays(this, &CAssetsCache::setNewRestrictedAddressToRemove, &CAssetsCache::setNewRestrictedAddressToAdd, cachedRestrictedAddress, fRemoved);
+    if (pDirty && fRemoved) {
         // Undoing a unfreeze, means that we are adding back a freeze
-        return setIterator->type == RestrictedType::UNFREEZE_ADDRESS;
+        return pDirty->type == RestrictedType::UNFREEZE_ADDRESS;
     }
 
-    setIterator = passets->setNewRestrictedAddressToRemove.find(cachedRestrictedAddress);
+    auto setIterator = passets->setNewRestrictedAddressToRemove.find(cachedRestrictedAddress);
     if (setIterator != passets->setNewRestrictedAddressToRemove.end()) {
         // Undoing a unfreeze, means that we are adding back a freeze
         return setIterator->type == RestrictedType::UNFREEZE_ADDRESS;
     }
 
-    setIterator = setNewRestrictedAddressToAdd.find(cachedRestrictedAddress);
-    if (!fSkipTempCache && setIterator != setNewRestrictedAddressToAdd.end()) {
+    if (pDirty) {
         // Return true if we are freezing the address
-        return setIterator->type == RestrictedType::FREEZE_ADDRESS;
+        return pDirty->type == RestrictedType::FREEZE_ADDRESS;
     }
 
     setIterator = passets->setNewRestrictedAddressToAdd.find(cachedRestrictedAddress);
@@ -4772,7 +5060,7 @@ bool CAssetsCache::CheckForAddressRestriction(const std::string &restricted_name
 
     // Check the cache, if it doesn't exist in the cache. Try and read it from database
     if (passetsRestrictionCache) {
-        if (passetsRestrictionCache->Exists(cachedRestrictedAddress.GetHash().GetHex())) {
+        if (passetsRestrictionCache->Exists(cachedRestrictedAddress.assetName, cachedRestrictedAddress.address)) {
             return true;
         }
     }
@@ -4780,7 +5068,7 @@ bool CAssetsCache::CheckForAddressRestriction(const std::string &restricted_name
     if (prestricteddb) {
         if (prestricteddb->ReadRestrictedAddress(address, restricted_name)) {
             if (passetsRestrictionCache) {
-                passetsRestrictionCache->Put(cachedRestrictedAddress.GetHash().GetHex(), 1);
+                passetsRestrictionCache->Put(cachedRestrictedAddress.assetName, cachedRestrictedAddress.address, 1);
             }
             return true;
         }
@@ -4805,22 +5093,22 @@ bool CAssetsCache::CheckForGlobalRestriction(const std::string &restricted_name,
     CAssetCacheRestrictedGlobal cachedRestrictedGlobal(restricted_name, RestrictedType::GLOBAL_FREEZE);
 
     // Check the dirty caches first and see if it was recently added or removed
-    auto setIterator = setNewRestrictedGlobalToRemove.find(cachedRestrictedGlobal);
-    if (!fSkipTempCache && setIterator != setNewRestrictedGlobalToRemove.end()) {
+    bool fRemoved = false;
+    const CAssetCacheRestrictedGlobal* pDirty = fSkipTempCache ? nullptr : FindInOverlays(this, &CAssetsCache::setNewRestrictedGlobalToRemove, &CAssetsCache::setNewRestrictedGlobalToAdd, cachedRestrictedGlobal, fRemoved);
+    if (pDirty && fRemoved) {
         // Undoing a removal of a global unfreeze, means that is will become frozen
-        return setIterator->type == RestrictedType::GLOBAL_UNFREEZE;
+        return pDirty->type == RestrictedType::GLOBAL_UNFREEZE;
     }
 
-    setIterator = passets->setNewRestrictedGlobalToRemove.find(cachedRestrictedGlobal);
+    auto setIterator = passets->setNewRestrictedGlobalToRemove.find(cachedRestrictedGlobal);
     if (setIterator != passets->setNewRestrictedGlobalToRemove.end()) {
         // Undoing a removal of a global unfreeze, means that is will become frozen
         return setIterator->type == RestrictedType::GLOBAL_UNFREEZE;
     }
 
-    setIterator = setNewRestrictedGlobalToAdd.find(cachedRestrictedGlobal);
-    if (!fSkipTempCache && setIterator != setNewRestrictedGlobalToAdd.end()) {
+    if (pDirty) {
         // Return true if we are adding a freeze command
-        return setIterator->type == RestrictedType::GLOBAL_FREEZE;
+        return pDirty->type == RestrictedType::GLOBAL_FREEZE;
     }
 
     setIterator = passets->setNewRestrictedGlobalToAdd.find(cachedRestrictedGlobal);
@@ -4849,15 +5137,14 @@ bool CAssetsCache::CheckForGlobalRestriction(const std::string &restricted_name,
 
 void ExtractVerifierStringQualifiers(const std::string& verifier, std::set<std::string>& qualifiers)
 {
-    std::string s(verifier);
-
-    std::regex regexSearch = std::regex(R"([A-Z0-9_.]+)");
-    std::smatch match;
-
-    while (std::regex_search(s,match,regexSearch)) {
-        for (auto str : match)
-            qualifiers.insert(str);
-        s = match.suffix().str();
+    // Every run of name characters
+    auto it = verifier.begin();
+    while (true) {
+        auto begin = std::find_if(it, verifier.end(), IsNameChar);
+        if (begin == verifier.end())
+            break;
+        it = std::find_if_not(begin, verifier.end(), IsNameChar);
+        qualifiers.insert(std::string(begin, it));
     }
 }
 
@@ -5139,6 +5426,89 @@ bool ContextualCheckVerifierAssetTxOut(const CTxOut& txout, CAssetsCache* assetC
     return true;
 }
 
+struct CCompiledVerifier
+{
+    std::vector<std::string> vQualifiers;   // with the QUALIFIER_CHAR, bit i of the valuation is vQualifiers[i]
+    LibBoolEE::Program program;
+};
+
+std::shared_ptr<const CCompiledVerifier> CompileVerifierString(const std::string& verifier)
+{
+    if (verifier == "true")
+        return nullptr;
+
+    std::set<std::string> setFoundQualifiers;
+    std::string strError;
+    if (!CheckVerifierString(verifier, setFoundQualifiers, strError))
+        return nullptr;
+
+    // resolve() is given the qualifiers without the tag, in set order
+    std::vector<std::string> vVariables(setFoundQualifiers.begin(), setFoundQualifiers.end());
+    std::shared_ptr<CCompiledVerifier> compiled = std::make_shared<CCompiledVerifier>();
+    if (!LibBoolEE::compile(verifier, vVariables, compiled->program))
+        return nullptr;
+
+    for (const std::string& qualifier : vVariables)
+        compiled->vQualifiers.emplace_back(QUALIFIER_CHAR + qualifier);
+
+    return compiled;
+}
+
+static bool CheckVerifierQualifierIssued(CAssetsCache* cache, const std::string& search, std::string& strError, ErrorReport* errorReport)
+{
+    if (!cache->CheckIfAssetExists(search, true)) {
+        if (errorReport) {
+            errorReport->type = ErrorReport::ErrorType::AssetDoesntExist;
+            errorReport->vecUserData.emplace_back(search);
+            errorReport->strDevData = "bad-txns-null-verifier-contains-non-issued-qualifier";
+        }
+        strError = "bad-txns-null-verifier-contains-non-issued-qualifier";
+        return false;
+    }
+    return true;
+}
+
+static void ReportVerifierAddressFailure(const std::string& verifier, const std::string& check_address, std::string& strError, ErrorReport* errorReport)
+{
+    if (errorReport) {
+        if (errorReport->type == ErrorReport::ErrorType::NotSetError) {
+            errorReport->type = ErrorReport::ErrorType::FailedToVerifyAgainstAddress;
+            errorReport->vecUserData.emplace_back(check_address);
+            errorReport->strDevData = "bad-txns-null-verifier-address-failed-verification";
+        }
+    }
+
+    error("ContextualCheckVerifierString : The address %s failed to verify against: %s. Is null %d", check_address, verifier, errorReport ? 0 : 1);
+    strError = "bad-txns-null-verifier-address-failed-verification";
+}
+
+bool ContextualCheckVerifierString(CAssetsCache* cache, const CNullAssetTxVerifierString& verifier, const std::string& check_address, std::string& strError, ErrorReport* errorReport)
+{
+    if (!verifier.compiled)
+        return ContextualCheckVerifierString(cache, verifier.verifier_string, check_address, strError, errorReport);
+
+    // The string already passed CheckVerifierString when it was compiled
+    const CCompiledVerifier& compiled = *verifier.compiled;
+    for (const std::string& search : compiled.vQualifiers) {
+        if (!CheckVerifierQualifierIssued(cache, search, strError, errorReport))
+            return false;
+    }
+
+    if (check_address.empty())
+        return true;
+
+    uint64_t valuation = 0;
+    for (size_t i = 0; i < compiled.vQualifiers.size(); i++) {
+        if (cache->CheckForAddressQualifier(compiled.vQualifiers[i], check_address, true))
+            valuation |= (uint64_t)1 << i;
+    }
+
+    bool ret = LibBoolEE::evaluate(compiled.program, valuation);
+    if (!ret)
+        ReportVerifierAddressFailure(verifier.verifier_string, check_address, strError, errorReport);
+    return ret;
+}
+
 bool ContextualCheckVerifierString(CAssetsCache* cache, const std::string& verifier, const std::string& check_address, std::string& strError, ErrorReport* errorReport)
 {
     // If verifier is set to true, return true
@@ -5152,16 +5522,8 @@ bool ContextualCheckVerifierString(CAssetsCache* cache, const std::string& verif
 
     // Loop through each qualifier and make sure that the asset exists
     for(auto qualifier : setFoundQualifiers) {
-        std::string search = QUALIFIER_CHAR + qualifier;
-        if (!cache->CheckIfAssetExists(search, true)) {
-            if (errorReport) {
-                errorReport->type = ErrorReport::ErrorType::AssetDoesntExist;
-                errorReport->vecUserData.emplace_back(search);
-                errorReport->strDevData = "bad-txns-null-verifier-contains-non-issued-qualifier";
-            }
-            strError = "bad-txns-null-verifier-contains-non-issued-qualifier";
+        if (!CheckVerifierQualifierIssued(cache, QUALIFIER_CHAR + qualifier, strError, errorReport))
             return false;
-        }
     }
 
     // If we got this far, and the check_address is empty. The CheckVerifyString method already did the syntax checks
@@ -5185,18 +5547,8 @@ bool ContextualCheckVerifierString(CAssetsCache* cache, const std::string& verif
 
     try {
         bool ret = LibBoolEE::resolve(verifier, vals, errorReport);
-        if (!ret) {
-            if (errorReport) {
-                if (errorReport->type == ErrorReport::ErrorType::NotSetError) {
-                    errorReport->type = ErrorReport::ErrorType::FailedToVerifyAgainstAddress;
-                    errorReport->vecUserData.emplace_back(check_address);
-                    errorReport->strDevData = "bad-txns-null-verifier-address-failed-verification";
-                }
-            }
-
-            error("%s : The address %s failed to verify against: %s. Is null %d", __func__, check_address, verifier, errorReport ? 0 : 1);
-            strError = "bad-txns-null-verifier-address-failed-verification";
-        }
+        if (!ret)
+            ReportVerifierAddressFailure(verifier, check_address, strError, errorReport);
         return ret;
 
     } catch (const std::runtime_error& run_error) {
@@ -5215,7 +5567,7 @@ bool ContextualCheckVerifierString(CAssetsCache* cache, const std::string& verif
     }
 }
 
-bool ContextualCheckTransferAsset(CAssetsCache* assetCache, const CAssetTransfer& transfer, const std::string& address, std::string& strError)
+bool ContextualCheckTransferAsset(CAssetsCache* assetCache, const CAssetTransfer& transfer, const CAddressKey& address, std::string& strError)
 {
     strError = "";
     AssetType assetType;
@@ -5274,7 +5626,7 @@ bool ContextualCheckTransferAsset(CAssetsCache* assetCache, const CAssetTransfer
 
 
         std::string strError = "";
-        if (!transfer.ContextualCheckAgainstVerifyString(assetCache, address, strError)) {
+        if (!transfer.ContextualCheckAgainstVerifyString(assetCache, address.ToString(), strError)) {
             error("%s : %s", __func__, strError);
             return false;
         }
@@ -5386,7 +5738,7 @@ bool ContextualCheckNewAsset(CAssetsCache* assetCache, const CNewAsset& asset, s
 
     // Check the mempool
     if (fCheckMempool) {
-        if (mempool.mapAssetToHash.count(asset.strName)) {
+        if (mempool.HasAssetIssue(asset.strName)) {
             strError = _("Asset with this name is already in the mempool");
             return false;
         }
@@ -5525,7 +5877,7 @@ bool ContextualCheckReissueAsset(CAssetsCache* assetCache, const CReissueAsset&
             if (fNotFound) {
                 CNullAssetTxVerifierString current_verifier;
                 if (assetCache->GetAssetVerifierStringIfExists(reissue_asset.strName, current_verifier)) {
-                    if (!ContextualCheckVerifierString(assetCache, current_verifier.verifier_string, strAddress, strError))
+                    if (!ContextualCheckVerifierString(assetCache, current_verifier, strAddress, strError))
                         return false;
                 } else {
                     // This should happen, but if it does. The wallet needs to shutdown,
@@ -59,12 +59,16 @@ class CWallet;
 class CReserveKey;
 class CWalletTx;
 struct CAssetOutputEntry;
+struct CCoinAssetData;
 class CCoinControl;
 struct CBlockAssetUndo;
+struct CAssetsReadDelta;
 class COutput;
 
 // 2500 * 82 Bytes == 205 KB (kilobytes) of memory
 #define MAX_CACHE_ASSETS_SIZE 2500
+// Memory budget of each asset LRU cache, on top of the entry limit
+#define MAX_CACHE_ASSETS_USAGE (4 << 20)
 
 // Create map that store that state of current reissued transaction that the mempool as accepted.
 // If an asset name is in this map, any other reissue transactions wont be accepted into the mempool
@@ -73,7 +77,7 @@ extern std::map<std::string, uint256> mapReissuedAssets;
 
 class CAssets {
 public:
-    std::map<std::pair<std::string, std::string>, CAmount> mapAssetsAddressAmount; // pair < Asset Name , Address > -> Quantity of tokens in the address
+    std::unordered_map<std::pair<std::string, CAddressKey>, CAmount, CAssetCacheHasher> mapAssetsAddressAmount; // pair < Asset Name , Address > -> Quantity of tokens in the address
 
     // Dirty, Gets wiped once flushed to database
     std::map<std::string, CNewAsset> mapReissuedAssetData; // Asset Name -> New Asset Data
@@ -126,57 +130,74 @@ std::string GetUserErrorString(const ErrorReport& report);
 class CAssetsCache : public CAssets
 {
 private:
-    bool AddBackSpentAsset(const Coin& coin, const std::string& assetName, const std::string& address, const CAmount& nAmount, const COutPoint& out);
-    void AddToAssetBalance(const std::string& strName, const std::string& address, const CAmount& nAmount);
-    bool UndoTransfer(const CAssetTransfer& transfer, const std::string& address, const COutPoint& outToRemove);
+    bool AddBackSpentAsset(const Coin& coin, const std::string& assetName, const CAddressKey& address, const CAmount& nAmount, const COutPoint& out);
+    void AddToAssetBalance(const std::string& strName, const CAddressKey& address, const CAmount& nAmount);
+    bool UndoTransfer(const CAssetTransfer& transfer, const CAddressKey& address, const COutPoint& outToRemove);
+
+    //! Cache this one is layered on, nullptr to layer on passets (see GetBase)
+    CAssetsCache* pbase;
 public :
     //! These are memory only containers that show dirty entries that will be databased when flushed
     std::vector<CAssetCacheUndoAssetAmount> vUndoAssetAmount;
     std::vector<CAssetCacheSpendAsset> vSpentAssets;
 
     //! New Assets Caches
-    std::set<CAssetCacheNewAsset> setNewAssetsToRemove;
-    std::set<CAssetCacheNewAsset> setNewAssetsToAdd;
+    CAssetCacheSet<CAssetCacheNewAsset> setNewAssetsToRemove;
+    CAssetCacheSet<CAssetCacheNewAsset> setNewAssetsToAdd;
 
     //! New Reissue Caches
-    std::set<CAssetCacheReissueAsset> setNewReissueToRemove;
-    std::set<CAssetCacheReissueAsset> setNewReissueToAdd;
+    CAssetCacheSet<CAssetCacheReissueAsset> setNewReissueToRemove;
+    CAssetCacheSet<CAssetCacheReissueAsset> setNewReissueToAdd;
 
     //! Ownership Assets Caches
-    std::set<CAssetCacheNewOwner> setNewOwnerAssetsToAdd;
-    std::set<CAssetCacheNewOwner> setNewOwnerAssetsToRemove;
+    CAssetCacheSet<CAssetCacheNewOwner> setNewOwnerAssetsToAdd;
+    CAssetCacheSet<CAssetCacheNewOwner> setNewOwnerAssetsToRemove;
 
     //! Transfer Assets Caches
-    std::set<CAssetCacheNewTransfer> setNewTransferAssetsToAdd;
-    std::set<CAssetCacheNewTransfer> setNewTransferAssetsToRemove;
+    CAssetCacheSet<CAssetCacheNewTransfer> setNewTransferAssetsToAdd;
+    CAssetCacheSet<CAssetCacheNewTransfer> setNewTransferAssetsToRemove;
 
     //! Qualfier Address Asset Caches
-    std::set<CAssetCacheQualifierAddress> setNewQualifierAddressToAdd;
-    std::set<CAssetCacheQualifierAddress> setNewQualifierAddressToRemove;
+    CAssetCacheSet<CAssetCacheQualifierAddress> setNewQualifierAddressToAdd;
+    CAssetCacheSet<CAssetCacheQualifierAddress> setNewQualifierAddressToRemove;
 
     //! Restricted Address Asset Caches
-    std::set<CAssetCacheRestrictedAddress> setNewRestrictedAddressToAdd;
-    std::set<CAssetCacheRestrictedAddress> setNewRestrictedAddressToRemove;
+    CAssetCacheSet<CAssetCacheRestrictedAddress> setNewRestrictedAddressToAdd;
+    CAssetCacheSet<CAssetCacheRestrictedAddress> setNewRestrictedAddressToRemove;
 
     //! Restricted Global Asset Caches
-    std::set<CAssetCacheRestrictedGlobal> setNewRestrictedGlobalToAdd;
-    std::set<CAssetCacheRestrictedGlobal> setNewRestrictedGlobalToRemove;
+    CAssetCacheSet<CAssetCacheRestrictedGlobal> setNewRestrictedGlobalToAdd;
+    CAssetCacheSet<CAssetCacheRestrictedGlobal> setNewRestrictedGlobalToRemove;
 
     //! Restricted Assets Verifier Caches
-    std::set<CAssetCacheRestrictedVerifiers> setNewRestrictedVerifierToAdd;
-    std::set<CAssetCacheRestrictedVerifiers> setNewRestrictedVerifierToRemove;
+    CAssetCacheSet<CAssetCacheRestrictedVerifiers> setNewRestrictedVerifierToAdd;
+    CAssetCacheSet<CAssetCacheRestrictedVerifiers> setNewRestrictedVerifierToRemove;
 
     //! Root Qualifier Address Map
     std::map<CAssetCacheRootQualifierChecker, std::set<std::string> > mapRootQualifierAddressesAdd;
     std::map<CAssetCacheRootQualifierChecker, std::set<std::string> > mapRootQualifierAddressesRemove;
 
-    CAssetsCache() : CAssets()
+    //! Changes to the unspent outputs of each asset, see UpdateAssetSupply
+    std::map<std::string, CAssetSupply> mapAssetSupplyDelta;
+
+    CAssetsCache() : CAssets(), pbase(nullptr)
     {
         SetNull();
         ClearDirtyCache();
     }
 
-    CAssetsCache(const CAssetsCache& cache) : CAssets(cache)
+    /**
+     * Overlay on baseIn, in the style of CCoinsViewCache: it starts out empty,
+     * lookups fall through to baseIn (and from there to passets and the
+     * databases), and Flush() writes its own changes back into baseIn. Use
+     * this instead of copying a cache that is only needed temporarily.
+     */
+    explicit CAssetsCache(CAssetsCache* baseIn) : CAssets(), pbase(baseIn)
+    {
+        ClearDirtyCache();
+    }
+
+    CAssetsCache(const CAssetsCache& cache) : CAssets(cache), pbase(cache.pbase)
     {
         //! Copy dirty cache also
         this->vSpentAssets = cache.vSpentAssets;
@@ -217,10 +238,14 @@ public :
         //! Root Qualifier Address Map
         this->mapRootQualifierAddressesAdd = cache.mapRootQualifierAddressesAdd;
         this->mapRootQualifierAddressesRemove = cache.mapRootQualifierAddressesRemove;
+
+        //! Asset Supply Changes
+        this->mapAssetSupplyDelta = cache.mapAssetSupplyDelta;
     }
 
     CAssetsCache& operator=(const CAssetsCache& cache)
     {
+        this->pbase = cache.pbase;
         this->mapAssetsAddressAmount = cache.mapAssetsAddressAmount;
         this->mapReissuedAssetData = cache.mapReissuedAssetData;
 
@@ -264,14 +289,20 @@ public :
         this->mapRootQualifierAddressesAdd = cache.mapRootQualifierAddressesAdd;
         this->mapRootQualifierAddressesRemove = cache.mapRootQualifierAddressesRemove;
 
+        //! Asset Supply Changes
+        this->mapAssetSupplyDelta = cache.mapAssetSupplyDelta;
+
         return *this;
     }
 
+    //! The cache lookups fall through to next: the overlay base if there is one, otherwise passets (nullptr for passets itself)
+    CAssetsCache* GetBase() const;
+
     //! Cache only undo functions
-    bool RemoveNewAsset(const CNewAsset& asset, const std::string address);
-    bool RemoveTransfer(const CAssetTransfer& transfer, const std::string& address, const COutPoint& out);
-    bool RemoveOwnerAsset(const std::string& assetsName, const std::string address);
-    bool RemoveReissueAsset(const CReissueAsset& reissue, const std::string address, const COutPoint& out, const std::vector<std::pair<std::string, CBlockAssetUndo> >& vUndoIPFS);
+    bool RemoveNewAsset(const CNewAsset& asset, const CAddressKey& address);
+    bool RemoveTransfer(const CAssetTransfer& transfer, const CAddressKey& address, const COutPoint& out);
+    bool RemoveOwnerAsset(const std::string& assetsName, const CAddressKey& address);
+    bool RemoveReissueAsset(const CReissueAsset& reissue, const CAddressKey& address, const COutPoint& out, const std::vector<std::pair<std::string, CBlockAssetUndo> >& vUndoIPFS);
     bool UndoAssetCoin(const Coin& coin, const COutPoint& out);
     bool RemoveQualifierAddress(const std::string& assetName, const std::string& address, const QualifierType type);
     bool RemoveRestrictedAddress(const std::string& assetName, const std::string& address, const RestrictedType type);
@@ -279,10 +310,10 @@ public :
     bool RemoveRestrictedVerifier(const std::string& assetName, const std::string& verifier, const bool fUndoingReissue = false);
 
     //! Cache only add asset functions
-    bool AddNewAsset(const CNewAsset& asset, const std::string address, const int& nHeight, const uint256& blockHash);
-    bool AddTransferAsset(const CAssetTransfer& transferAsset, const std::string& address, const COutPoint& out, const CTxOut& txOut);
-    bool AddOwnerAsset(const std::string& assetsName, const std::string address);
-    bool AddReissueAsset(const CReissueAsset& reissue, const std::string address, const COutPoint& out);
+    bool AddNewAsset(const CNewAsset& asset, const CAddressKey& address, const int& nHeight, const uint256& blockHash);
+    bool AddTransferAsset(const CAssetTransfer& transferAsset, const CAddressKey& address, const COutPoint& out, const CTxOut& txOut);
+    bool AddOwnerAsset(const std::string& assetsName, const CAddressKey& address);
+    bool AddReissueAsset(const CReissueAsset& reissue, const CAddressKey& address, const COutPoint& out);
     bool AddQualifierAddress(const std::string& assetName, const std::string& address, const QualifierType type);
     bool AddRestrictedAddress(const std::string& assetName, const std::string& address, const RestrictedType type);
     bool AddGlobalRestricted(const std::string& assetName, const RestrictedType type);
@@ -290,6 +321,12 @@ public :
 
     //! Cache only validation functions
     bool TrySpendCoin(const COutPoint& out, const CTxOut& coin);
+    //! TrySpendCoin for an asset coin that was already decoded
+    bool TrySpendCoin(const COutPoint& out, const CCoinAssetData& data);
+
+    //! Count an asset output into (nDirection 1) or out of (-1) the unspent outputs of its asset
+    void UpdateAssetSupply(const std::string& assetName, const CAddressKey& address, const CAmount& nAmount, const int nDirection);
+    void UpdateAssetSupply(const CTxOut& txOut, const int nDirection);
 
     //! Help functions
     bool ContainsAsset(const CNewAsset& asset);
@@ -321,12 +358,18 @@ public :
     size_t GetCacheSize() const;
     size_t GetCacheSizeV2() const;
 
-    //! Flush all new cache entries into the passets global cache
+    //! Flush all new cache entries into the base cache (passets unless this is an overlay)
     bool Flush();
 
     //! Write asset cache data to database
     bool DumpCacheToDatabase();
 
+    //! The changes DumpCacheToDatabase would make to the assets db, as seen by its reads
+    void GetReadDelta(CAssetsReadDelta& delta) const;
+
+    //! Records of the transfers, issues and balances of the block this cache connected or disconnected
+    void GetNotifications(int nHeight, bool fConnected, std::vector<CAssetNotification>& vNotifications) const;
+
     //! Clear all dirty cache sets, vetors, and maps
     void ClearDirtyCache() {
 
@@ -362,6 +405,8 @@ public :
 
         mapRootQualifierAddressesAdd.clear();
         mapRootQualifierAddressesRemove.clear();
+
+        mapAssetSupplyDelta.clear();
     }
 
    std::string CacheToString() const {
@@ -403,6 +448,18 @@ bool IsAssetNameValid(const std::string& name, AssetType& assetType, std::string
 //! Check if an unique tagname is valid
 bool IsUniqueTagValid(const std::string& tag);
 
+//! Check the parts of an asset name against their allowed characters and punctuation rules
+bool IsRootNameValid(const std::string& name);
+bool IsSubNameValid(const std::string& name);
+bool IsQualifierNameValid(const std::string& name);
+bool IsSubQualifierNameValid(const std::string& name);
+bool IsRestrictedNameValid(const std::string& name);
+bool IsMsgChannelTagValid(const std::string& tag);
+bool IsVoteTagValid(const std::string& tag);
+
+//! The type an asset name's delimiters and prefix point to, INVALID for plain root and sub asset names
+AssetType GetAssetNameIndicator(const std::string& name);
+
 //! Check if an asset is an owner
 bool IsAssetNameAnOwner(const std::string& name);
 
@@ -429,6 +486,16 @@ std::string RestrictedNameToOwnerName(const std::string& name);
 //! Build a unique asset buy giving the root name, and the tag name (ROOT, TAG) => ROOT#TAG
 std::string GetUniqueAssetName(const std::string& parent, const std::string& tag);
 
+//! Split a unique asset name into its root and tag, ROOT#TAG => (ROOT, TAG); false for other names
+bool SplitUniqueAssetName(const std::string& name, std::string& root, std::string& tag);
+
+/**
+ * The node an asset hangs off in the asset namespace tree: ROOT/SUB, ROOT#TAG,
+ * ROOT~CHANNEL, ROOT^VOTE, ROOT! => ROOT; $ROOT and #ROOT => ROOT; #Q/#SUB => #Q.
+ * False for root names, which are the tops of the tree.
+ */
+bool GetAssetTreeParent(const std::string& name, std::string& parent);
+
 //! Given a type, and an asset name, return if that name is valid based on the type
 bool IsTypeCheckNameValid(const AssetType type, const std::string& name, std::string& error);
 
@@ -442,11 +509,55 @@ bool MsgChannelAssetFromTransaction(const CTransaction& tx, CNewAsset& asset, st
 bool QualifierAssetFromTransaction(const CTransaction& tx, CNewAsset& asset, std::string& strAddress);
 bool RestrictedAssetFromTransaction(const CTransaction& tx, CNewAsset& asset, std::string& strAddress);
 
+/** Kind of asset operation found at index 25 of a script by IsAssetScript */
+enum class AssetScriptType
+{
+    NONE,
+    NEW_ASSET,      // rvnq
+    OWNER,          // rvno
+    TRANSFER,       // rvnt
+    REISSUE         // rvnr
+};
+
+/** Kind of null asset data script, which starts with OP_RVN_ASSET */
+enum class NullAssetScriptType
+{
+    NONE,
+    TX_DATA,
+    GLOBAL_RESTRICTION,
+    VERIFIER
+};
+
+/**
+ * Result of scanning a script once for asset data. The payloads point into
+ * the script that was decoded and are only valid while it is unchanged. The
+ * two classifications are kept apart because they test different bytes and
+ * a crafted script can satisfy both.
+ */
+struct CAssetScriptView
+{
+    AssetScriptType type = AssetScriptType::NONE;
+    NullAssetScriptType nullType = NullAssetScriptType::NONE;
+    int nStartingIndex = 0;                         // first byte after the rvn? marker
+    const unsigned char* pPayload = nullptr;        // serialized asset object of type
+    size_t nPayloadSize = 0;
+    const unsigned char* pNullPayload = nullptr;    // serialized null asset object of nullType
+    size_t nNullPayloadSize = 0;
+};
+
+//! Classify script and locate its payloads; returns false if it holds no asset data of either kind
+bool DecodeAssetScript(const CScript& script, CAssetScriptView& view);
+
 //! Get specific asset type metadata from the given scripts
 bool TransferAssetFromScript(const CScript& scriptPubKey, CAssetTransfer& assetTransfer, std::string& strAddress);
 bool AssetFromScript(const CScript& scriptPubKey, CNewAsset& asset, std::string& strAddress);
 bool OwnerAssetFromScript(const CScript& scriptPubKey, std::string& assetName, std::string& strAddress);
 bool ReissueAssetFromScript(const CScript& scriptPubKey, CReissueAsset& reissue, std::string& strAddress);
+//! As above, with the address as the asset index keys it, which skips the base58 encoding
+bool TransferAssetFromScript(const CScript& scriptPubKey, CAssetTransfer& assetTransfer, CAddressKey& address);
+bool AssetFromScript(const CScript& scriptPubKey, CNewAsset& asset, CAddressKey& address);
+bool OwnerAssetFromScript(const CScript& scriptPubKey, std::string& assetName, CAddressKey& address);
+bool ReissueAssetFromScript(const CScript& scriptPubKey, CReissueAsset& reissue, CAddressKey& address);
 bool MsgChannelAssetFromScript(const CScript& scriptPubKey, CNewAsset& asset, std::string& strAddress);
 bool QualifierAssetFromScript(const CScript& scriptPubKey, CNewAsset& asset, std::string& strAddress);
 bool RestrictedAssetFromScript(const CScript& scriptPubKey, CNewAsset& asset, std::string& strAddress);
@@ -516,7 +627,44 @@ bool GetAssetInfoFromScript(const CScript& scriptPubKey, std::string& strName, C
 
 bool GetAssetData(const CScript& script, CAssetOutputEntry& data);
 
-bool GetBestAssetAddressAmount(CAssetsCache& cache, const std::string& assetName, const std::string& address);
+/**
+ * An output's asset script classified and its payload deserialized once, so
+ * CheckTxAssets and AddCoins don't each parse it again. Only the payload of
+ * nType is set, and only if fDecoded.
+ */
+struct CAssetOutputRecord
+{
+    bool fIsAsset = false;
+    int nType = 0;
+    bool fIsOwner = false;
+    bool fDecoded = false;
+    CAddressKey address;
+    CNewAsset asset;            // TX_NEW_ASSET issued through AssetFromScript
+    CAssetTransfer transfer;    // TX_TRANSFER_ASSET
+    CReissueAsset reissue;      // TX_REISSUE_ASSET
+};
+
+//! Fill record from the output's scriptPubKey
+void DecodeAssetOutput(const CScript& script, CAssetOutputRecord& record);
+
+/**
+ * The asset an unspent asset coin holds. The coins cache decodes it once per
+ * cache entry, so spending the coin doesn't parse its script again in each of
+ * CheckTxAssets and CAssetsCache::TrySpendCoin.
+ */
+struct CCoinAssetData
+{
+    //! False if the script didn't decode, the other fields are then unset
+    bool fDecoded = false;
+    std::string strName;
+    CAmount nAmount = 0;
+    CAddressKey address;
+};
+
+//! Fill data from an asset coin's scriptPubKey, returning data.fDecoded
+bool DecodeCoinAssetData(const CScript& script, CCoinAssetData& data);
+
+bool GetBestAssetAddressAmount(CAssetsCache& cache, const std::string& assetName, const CAddressKey& address);
 
 
 //! Decode and Encode IPFS hashes, or OIP hashes
@@ -539,7 +687,7 @@ bool CreateReissueAssetTransaction(CWallet* pwallet, CCoinControl& coinControl,
 
 
 //! Create a transfer asset transaction
-bool CreateTransferAssetTransaction(CWallet* pwallet, const CCoinControl& coinControl, const std::vector< std::pair<CAssetTransfer, std::string> >vTransfers, const std::string& changeAddress, std::pair<int, std::string>& error, CWalletTx& wtxNew, CReserveKey& reservekey, CAmount& nFeeRequired, std::vector<std::pair<CNullAssetTxData, std::string> >* nullAssetTxData = nullptr, std::vector<CNullAssetTxData>* nullGlobalRestrictionData = nullptr);
+bool CreateTransferAssetTransaction(CWallet* pwallet, const CCoinControl& coinControl, const std::vector< std::pair<CAssetTransfer, std::string> >vTransfers, const std::string& changeAddress, std::pair<int, std::string>& error, CWalletTx& wtxNew, CReserveKey& reservekey, CAmount& nFeeRequired, std::vector<std::pair<CNullAssetTxData, std::string> >* nullAssetTxData = nullptr, std::vector<CNullAssetTxData>* nullGlobalRestrictionData = nullptr, bool sign = true);
 
 //! Send any type of asset transaction to the network
 bool SendAssetTransaction(CWallet* pwallet, CWalletTx& transaction, CReserveKey& reserveKey, std::pair<int, std::string>& error, std::string& txid);
@@ -572,8 +720,12 @@ bool ContextualCheckNullAssetTxOut(const CTxOut& txout, CAssetsCache* assetCache
 bool ContextualCheckGlobalAssetTxOut(const CTxOut& txout, CAssetsCache* assetCache, std::string& strError);
 bool ContextualCheckVerifierAssetTxOut(const CTxOut& txout, CAssetsCache* assetCache, std::string& strError);
 bool ContextualCheckVerifierString(CAssetsCache* cache, const std::string& verifier, const std::string& check_address, std::string& strError, ErrorReport* errorReport = nullptr);
+//! Same check, using the compiled form of the verifier when it has one
+bool ContextualCheckVerifierString(CAssetsCache* cache, const CNullAssetTxVerifierString& verifier, const std::string& check_address, std::string& strError, ErrorReport* errorReport = nullptr);
+//! Compile a verifier string that passes CheckVerifierString; nullptr for "true" and for strings that don't pass
+std::shared_ptr<const CCompiledVerifier> CompileVerifierString(const std::string& verifier);
 bool ContextualCheckNewAsset(CAssetsCache* assetCache, const CNewAsset& asset, std::string& strError, bool fCheckMempool = false);
-bool ContextualCheckTransferAsset(CAssetsCache* assetCache, const CAssetTransfer& transfer, const std::string& address, std::string& strError);
+bool ContextualCheckTransferAsset(CAssetsCache* assetCache, const CAssetTransfer& transfer, const CAddressKey& address, std::string& strError);
 bool ContextualCheckReissueAsset(CAssetsCache* assetCache, const CReissueAsset& reissue_asset, std::string& strError, const CTransaction& tx);
 bool ContextualCheckReissueAsset(CAssetsCache* assetCache, const CReissueAsset& reissue_asset, std::string& strError);
 bool ContextualCheckUniqueAssetTx(CAssetsCache* assetCache, std::string& strError, const CTransaction& tx);
@@ -6,10 +6,110 @@
 #include "validation.h"
 #include "base58.h"
 
+#include <algorithm>
+
 #include <boost/algorithm/string.hpp>
 #include <boost/thread.hpp>
 
-static const char SNAPSHOTCHECK_FLAG = 'C'; // Snapshot Check
+static const char SNAPSHOTCHECK_FLAG = 'C'; // Snapshot Check (whole holder list, no longer written)
+static const char SNAPSHOT_HEADER_FLAG = 'H'; // Snapshot Header
+static const char SNAPSHOT_BASE_FLAG = 'B'; // Holders at a base height
+static const char SNAPSHOT_DELTA_FLAG = 'D'; // Holder balance changed by a block
+static const char SNAPSHOT_BLOCK_FLAG = 'K'; // Holder deltas written by a block
+static const char SNAPSHOT_TRACKED_FLAG = 'T'; // Asset whose holder deltas are kept
+
+//  Flush the base holder rows to disk every this many bytes
+static const size_t SNAPSHOT_BATCH_SIZE = 1 << 20;
+
+namespace {
+//  Heights are big endian in the row keys so that they sort numerically
+struct CSnapshotHeaderKey
+{
+    char flag;
+    std::string assetName;
+    uint32_t nHeight;
+
+    CSnapshotHeaderKey() : flag(0), nHeight(0) {}
+    CSnapshotHeaderKey(const std::string& p_assetName, int p_height)
+        : flag(SNAPSHOT_HEADER_FLAG), assetName(p_assetName), nHeight(p_height) {}
+
+    template<typename Stream>
+    void Serialize(Stream& s) const
+    {
+        s << flag << assetName;
+        ser_writedata32be(s, nHeight);
+    }
+
+    template<typename Stream>
+    void Unserialize(Stream& s)
+    {
+        s >> flag >> assetName;
+        nHeight = ser_readdata32be(s);
+    }
+};
+
+struct CSnapshotBaseKey
+{
+    char flag;
+    std::string assetName;
+    uint32_t nBaseHeight;
+    std::string address;
+
+    CSnapshotBaseKey() : flag(0), nBaseHeight(0) {}
+    CSnapshotBaseKey(const std::string& p_assetName, int p_baseHeight, const std::string& p_address)
+        : flag(SNAPSHOT_BASE_FLAG), assetName(p_assetName), nBaseHeight(p_baseHeight), address(p_address) {}
+
+    template<typename Stream>
+    void Serialize(Stream& s) const
+    {
+        s << flag << assetName;
+        ser_writedata32be(s, nBaseHeight);
+        s << address;
+    }
+
+    template<typename Stream>
+    void Unserialize(Stream& s)
+    {
+        s >> flag >> assetName;
+        nBaseHeight = ser_readdata32be(s);
+        s >> address;
+    }
+};
+
+struct CSnapshotDeltaKey
+{
+    char flag;
+    std::string assetName;
+    std::string address;
+    uint32_t nHeight;
+
+    CSnapshotDeltaKey() : flag(0), nHeight(0) {}
+    CSnapshotDeltaKey(const std::string& p_assetName, const std::string& p_address, int p_height)
+        : flag(SNAPSHOT_DELTA_FLAG), assetName(p_assetName), address(p_address), nHeight(p_height) {}
+
+    template<typename Stream>
+    void Serialize(Stream& s) const
+    {
+        s << flag << assetName << address;
+        ser_writedata32be(s, nHeight);
+    }
+
+    template<typename Stream>
+    void Unserialize(Stream& s)
+    {
+        s >> flag >> assetName >> address;
+        nHeight = ser_readdata32be(s);
+    }
+};
+
+//  The order serialized addresses are stored in: length first, then bytes
+bool AddressKeyLess(const std::string& a, const std::string& b)
+{
+    if (a.size() != b.size())
+        return a.size() < b.size();
+    return a < b;
+}
+} // namespace
 
 CAssetSnapshotDBEntry::CAssetSnapshotDBEntry()
 {
@@ -32,81 +132,354 @@ CAssetSnapshotDBEntry::CAssetSnapshotDBEntry(
     heightAndName = std::to_string(height) + assetName;
 }
 
-CAssetSnapshotDB::CAssetSnapshotDB(size_t nCacheSize, bool fMemory, bool fWipe) : CDBWrapper(GetDataDir() / "rewards" / "assetsnapshot", nCacheSize, fMemory, fWipe) {
+CAssetSnapshotReader::CAssetSnapshotReader(CAssetSnapshotDB& db, const std::string& p_assetName, int p_height)
+    : fFound(false), fLegacy(false), fHaveBase(false), fHaveDelta(false)
+{
+    dbSnapshot = db.GetSnapshot();
+
+    if (db.Read(CSnapshotHeaderKey(p_assetName, p_height), header, dbSnapshot.get())) {
+        fFound = true;
+        pBaseIter.reset(db.NewIterator(dbSnapshot.get()));
+        if (header.nBaseHeight < header.height)
+            pDeltaIter.reset(db.NewIterator(dbSnapshot.get()));
+        Rewind();
+        return;
+    }
+
+    if (db.Read(std::make_pair(SNAPSHOTCHECK_FLAG, std::to_string(p_height) + p_assetName), legacyEntry, dbSnapshot.get())) {
+        fFound = true;
+        fLegacy = true;
+        header = CAssetSnapshotHeader(legacyEntry.assetName, legacyEntry.height, legacyEntry.height);
+        Rewind();
+    }
 }
 
-bool CAssetSnapshotDB::AddAssetOwnershipSnapshot(
-    const std::string & p_assetName, int p_height)
+void CAssetSnapshotReader::Rewind()
 {
-    LogPrint(BCLog::REWARDS, "AddAssetOwnershipSnapshot: Adding snapshot for '%s' at height %d\n",
-        p_assetName.c_str(), p_height);
+    if (fLegacy) {
+        legacyIter = legacyEntry.ownersAndAmounts.begin();
+        return;
+    }
 
-    //  Retrieve ownership interest for the asset at this height
-    if (passetsdb == nullptr) {
-        LogPrint(BCLog::REWARDS, "AddAssetOwnershipSnapshot: Invalid assets DB!\n");
-        return false;
+    if (pBaseIter) {
+        pBaseIter->Seek(CSnapshotBaseKey(header.assetName, header.nBaseHeight, ""));
+        ReadNextBase();
+    }
+    if (pDeltaIter) {
+        pDeltaIter->Seek(CSnapshotDeltaKey(header.assetName, "", 0));
+        ReadNextDelta();
+    }
+}
+
+void CAssetSnapshotReader::ReadNextBase()
+{
+    fHaveBase = false;
+    if (!pBaseIter->Valid())
+        return;
+
+    CSnapshotBaseKey key;
+    if (!pBaseIter->GetKey(key) || key.flag != SNAPSHOT_BASE_FLAG || key.assetName != header.assetName
+            || key.nBaseHeight != (uint32_t)header.nBaseHeight)
+        return;
+
+    CAmount amount;
+    if (!pBaseIter->GetValue(amount))
+        return;
+
+    nextBase = std::make_pair(key.address, amount);
+    fHaveBase = true;
+    pBaseIter->Next();
+}
+
+void CAssetSnapshotReader::ReadNextDelta()
+{
+    fHaveDelta = false;
+
+    CSnapshotDeltaKey key;
+    bool fKey = pDeltaIter->Valid() && pDeltaIter->GetKey(key);
+    while (fKey && key.flag == SNAPSHOT_DELTA_FLAG && key.assetName == header.assetName) {
+        //  Rows are ordered by height within an address, so the last one in range wins
+        std::string address = key.address;
+        bool fInRange = false;
+        CAmount amount = 0;
+        while (fKey && key.flag == SNAPSHOT_DELTA_FLAG && key.assetName == header.assetName && key.address == address) {
+            if (key.nHeight > (uint32_t)header.nBaseHeight && key.nHeight <= (uint32_t)header.height) {
+                fInRange = pDeltaIter->GetValue(amount) || fInRange;
+            }
+            pDeltaIter->Next();
+            fKey = pDeltaIter->Valid() && pDeltaIter->GetKey(key);
+        }
+
+        if (fInRange) {
+            nextDelta = std::make_pair(address, amount);
+            fHaveDelta = true;
+            return;
+        }
+    }
+}
+
+bool CAssetSnapshotReader::Next(std::pair<std::string, CAmount>& p_ownerAndAmount)
+{
+    if (fLegacy) {
+        if (legacyIter == legacyEntry.ownersAndAmounts.end())
+            return false;
+        p_ownerAndAmount = *legacyIter++;
+        return true;
+    }
+
+    while (fHaveBase || fHaveDelta) {
+        if (fHaveDelta && (!fHaveBase || !AddressKeyLess(nextBase.first, nextDelta.first))) {
+            //  The delta replaces the base amount of the same address
+            bool fSameAddress = fHaveBase && nextBase.first == nextDelta.first;
+            p_ownerAndAmount = nextDelta;
+            ReadNextDelta();
+            if (fSameAddress)
+                ReadNextBase();
+        } else {
+            p_ownerAndAmount = nextBase;
+            ReadNextBase();
+        }
+
+        //  A zero delta means the address stopped holding the asset
+        if (p_ownerAndAmount.second > 0)
+            return true;
     }
+    return false;
+}
+
+CAssetSnapshotDB::CAssetSnapshotDB(size_t nCacheSize, bool fMemory, bool fWipe) : CDBWrapper(GetDataDir() / "rewards" / "assetsnapshot", nCacheSize, fMemory, fWipe) {
+    std::unique_ptr<CDBIterator> pcursor(NewIterator());
+    pcursor->Seek(std::make_pair(SNAPSHOT_TRACKED_FLAG, std::string()));
+
+    std::pair<char, std::string> key;
+    while (pcursor->Valid() && pcursor->GetKey(key) && key.first == SNAPSHOT_TRACKED_FLAG) {
+        int nBaseHeight;
+        if (pcursor->GetValue(nBaseHeight))
+            mapTrackedAssets[key.second] = nBaseHeight;
+        pcursor->Next();
+    }
+}
+
+bool CAssetSnapshotDB::WriteBaseSnapshot(CDBBatch& batch, const CAssetsReadView& p_view, const std::string& p_assetName, int p_height, size_t& p_ownerCount)
+{
+    p_ownerCount = 0;
 
-    std::set<std::pair<std::string, CAmount>> ownersAndAmounts;
     std::vector<std::pair<std::string, CAmount>> tempOwnersAndAmounts;
     int totalEntryCount;
 
-    if (!passetsdb->AssetAddressDir(tempOwnersAndAmounts, totalEntryCount, true, p_assetName, INT_MAX, 0)) {
+    if (!passetsdb->AssetAddressDir(p_view, tempOwnersAndAmounts, totalEntryCount, true, p_assetName, INT_MAX, 0)) {
         LogPrint(BCLog::REWARDS, "AddAssetOwnershipSnapshot: Failed to retrieve assets directory for '%s'\n", p_assetName.c_str());
         return false;
     }
 
+    //  A base left behind at this height by a reorg is rewritten from scratch
+    EraseBaseRows(batch, p_assetName, p_height);
+
     //  Retrieve all of the addresses/amounts in batches
     const int MAX_RETRIEVAL_COUNT = 100;
-    bool errorsOccurred = false;
 
+    std::string lastAddress;
     for (int retrievalOffset = 0; retrievalOffset < totalEntryCount; retrievalOffset += MAX_RETRIEVAL_COUNT) {
-        //  Retrieve the specified segment of addresses
-        if (!passetsdb->AssetAddressDir(tempOwnersAndAmounts, totalEntryCount, false, p_assetName, MAX_RETRIEVAL_COUNT, retrievalOffset)) {
+        //  Retrieve the next segment of addresses after the last one retrieved
+        if (!passetsdb->AssetAddressDir(p_view, tempOwnersAndAmounts, totalEntryCount, false, p_assetName, MAX_RETRIEVAL_COUNT, 0, lastAddress)) {
             LogPrint(BCLog::REWARDS, "AddAssetOwnershipSnapshot: Failed to retrieve assets directory for '%s'\n", p_assetName.c_str());
-            errorsOccurred = true;
-            break;
+            return false;
         }
 
         //  Verify that some addresses were returned
         if (tempOwnersAndAmounts.size() == 0) {
             LogPrint(BCLog::REWARDS, "AddAssetOwnershipSnapshot: No addresses were retrieved.\n");
-            continue;
+            break;
         }
+        lastAddress = tempOwnersAndAmounts.back().first;
 
-        //  Move these into the main set
         for (auto const & currPair : tempOwnersAndAmounts) {
             //  Verify that the address is valid
             CTxDestination dest = DecodeDestination(currPair.first);
             if (IsValidDestination(dest)) {
-                ownersAndAmounts.insert(currPair);
+                batch.Write(CSnapshotBaseKey(p_assetName, p_height, currPair.first), currPair.second);
+                p_ownerCount++;
             }
             else {
                 LogPrint(BCLog::REWARDS, "AddAssetOwnershipSnapshot: Address '%s' is invalid.\n", currPair.first.c_str());
             }
         }
-
         tempOwnersAndAmounts.clear();
+
+        if (batch.SizeEstimate() > SNAPSHOT_BATCH_SIZE) {
+            if (!WriteBatch(batch))
+                return false;
+            batch.Clear();
+        }
+    }
+
+    return true;
+}
+
+void CAssetSnapshotDB::EraseBaseRows(CDBBatch& batch, const std::string& p_assetName, int p_baseHeight)
+{
+    std::unique_ptr<CDBIterator> pcursor(NewIterator());
+    pcursor->Seek(CSnapshotBaseKey(p_assetName, p_baseHeight, ""));
+
+    CSnapshotBaseKey key;
+    while (pcursor->Valid() && pcursor->GetKey(key) && key.flag == SNAPSHOT_BASE_FLAG && key.assetName == p_assetName
+            && key.nBaseHeight == (uint32_t)p_baseHeight) {
+        batch.Erase(key);
+        if (batch.SizeEstimate() > SNAPSHOT_BATCH_SIZE) {
+            WriteBatch(batch);
+            batch.Clear();
+        }
+        pcursor->Next();
+    }
+}
+
+void CAssetSnapshotDB::EraseDeltaRows(const std::string& p_assetName)
+{
+    std::unique_ptr<CDBIterator> pcursor(NewIterator());
+    pcursor->Seek(CSnapshotDeltaKey(p_assetName, "", 0));
+
+    CDBBatch batch(*this);
+    CSnapshotDeltaKey key;
+    while (pcursor->Valid() && pcursor->GetKey(key) && key.flag == SNAPSHOT_DELTA_FLAG && key.assetName == p_assetName) {
+        batch.Erase(key);
+        if (batch.SizeEstimate() > SNAPSHOT_BATCH_SIZE) {
+            WriteBatch(batch);
+            batch.Clear();
+        }
+        pcursor->Next();
     }
+    WriteBatch(batch);
+}
 
-    if (errorsOccurred) {
+bool CAssetSnapshotDB::AddSnapshotToBatch(CDBBatch& batch, const CAssetsReadView& p_view, const std::string& p_assetName, int p_height, std::map<std::string, int>& p_newBases)
+{
+    LogPrint(BCLog::REWARDS, "AddAssetOwnershipSnapshot: Adding snapshot for '%s' at height %d\n",
+        p_assetName.c_str(), p_height);
+
+    //  Once an asset has a base, its holder deltas are recorded every block, so
+    //  a later snapshot is just a header. A base at or above this height is
+    //  from a chain that was disconnected and gets replaced.
+    auto it = mapTrackedAssets.find(p_assetName);
+    if (it != mapTrackedAssets.end() && it->second < p_height) {
+        batch.Write(CSnapshotHeaderKey(p_assetName, p_height), CAssetSnapshotHeader(p_assetName, p_height, it->second));
+        LogPrint(BCLog::REWARDS, "AddAssetOwnershipSnapshot: Adding snapshot for '%s' at height %d (base height = %d).\n",
+            p_assetName.c_str(), p_height, it->second);
+        return true;
+    }
+
+    size_t ownerCount;
+    if (!WriteBaseSnapshot(batch, p_view, p_assetName, p_height, ownerCount)) {
         LogPrint(BCLog::REWARDS, "AddAssetOwnershipSnapshot: Errors occurred while acquiring ownership info for asset '%s'.\n", p_assetName.c_str());
         return false;
     }
-    if (ownersAndAmounts.size() == 0) {
+    if (ownerCount == 0) {
         LogPrint(BCLog::REWARDS, "AddAssetOwnershipSnapshot: No owners exist for asset '%s'.\n", p_assetName.c_str());
         return false;
     }
 
-    //  Write the snapshot to the database. We don't care if we overwrite, because it should be identical.
-    CAssetSnapshotDBEntry snapshotEntry(p_assetName, p_height, ownersAndAmounts);
+    //  We don't care if we overwrite, because it should be identical.
+    batch.Write(std::make_pair(SNAPSHOT_TRACKED_FLAG, p_assetName), p_height);
+    batch.Write(CSnapshotHeaderKey(p_assetName, p_height), CAssetSnapshotHeader(p_assetName, p_height, p_height));
+    p_newBases[p_assetName] = p_height;
+    LogPrint(BCLog::REWARDS, "AddAssetOwnershipSnapshot: Adding snapshot for '%s' at height %d (ownerCount = %d).\n",
+        p_assetName.c_str(), p_height, ownerCount);
+    return true;
+}
 
-    if (Write(std::make_pair(SNAPSHOTCHECK_FLAG, snapshotEntry.heightAndName), snapshotEntry)) {
-        LogPrint(BCLog::REWARDS, "AddAssetOwnershipSnapshot: Successfully added snapshot for '%s' at height %d (ownerCount = %d).\n",
-            p_assetName.c_str(), p_height, ownersAndAmounts.size());
-        return true;
+bool CAssetSnapshotDB::AddAssetOwnershipSnapshot(
+    const std::string & p_assetName, int p_height)
+{
+    //  Retrieve ownership interest for the asset at this height
+    if (passetsdb == nullptr) {
+        LogPrint(BCLog::REWARDS, "AddAssetOwnershipSnapshot: Invalid assets DB!\n");
+        return false;
     }
-    return false;
+
+    //  Read the holders from the assets db as flushed now, as AssetAddressDir does
+    FlushStateToDisk();
+    CAssetsReadView view;
+    view.snapshot = passetsdb->GetSnapshot();
+
+    std::lock_guard<std::mutex> lock(cs);
+
+    CDBBatch batch(*this);
+    std::map<std::string, int> newBases;
+    if (!AddSnapshotToBatch(batch, view, p_assetName, p_height, newBases) || !WriteBatch(batch))
+        return false;
+    for (auto const & base : newBases)
+        mapTrackedAssets[base.first] = base.second;
+    return true;
+}
+
+void CAssetSnapshotDB::ConnectBlockHolderDeltas(int p_height, const std::map<std::pair<std::string, CAddressKey>, CAmount>& p_mapAssetAddressAmount)
+{
+    ConnectBlockSnapshots(p_height, p_mapAssetAddressAmount, std::vector<std::string>(), CAssetsReadView());
+}
+
+void CAssetSnapshotDB::ConnectBlockSnapshots(int p_height, const std::map<std::pair<std::string, CAddressKey>, CAmount>& p_mapAssetAddressAmount,
+                                             const std::vector<std::string>& p_snapshotAssets, const CAssetsReadView& p_view)
+{
+    std::lock_guard<std::mutex> lock(cs);
+    if ((mapTrackedAssets.empty() || p_mapAssetAddressAmount.empty()) && p_snapshotAssets.empty())
+        return;
+
+    CDBBatch batch(*this);
+    std::vector<std::pair<std::string, std::string>> vWritten;
+    for (auto const & tracked : mapTrackedAssets) {
+        if (tracked.second >= p_height)
+            continue;
+
+        //  The map is ordered by asset name first
+        for (auto it = p_mapAssetAddressAmount.lower_bound(std::make_pair(tracked.first, CAddressKey()));
+                it != p_mapAssetAddressAmount.end() && it->first.first == tracked.first; ++it) {
+            if (it->first.second.IsNull())
+                continue;
+            // The snapshots keep the base58 addresses the reward payments are made to
+            std::string address = it->first.second.ToString();
+            batch.Write(CSnapshotDeltaKey(tracked.first, address, p_height), it->second);
+            vWritten.emplace_back(tracked.first, address);
+        }
+    }
+
+    if (!vWritten.empty())
+        batch.Write(std::make_pair(SNAPSHOT_BLOCK_FLAG, p_height), vWritten);
+
+    //  The snapshots requested at this height go in the same write, their
+    //  holders read from the asset state the block left
+    std::map<std::string, int> newBases;
+    for (auto const & assetName : p_snapshotAssets) {
+        if (passetsdb == nullptr || !AddSnapshotToBatch(batch, p_view, assetName, p_height, newBases))
+            LogPrint(BCLog::REWARDS, "%s : Failed to snapshot owners for '%s' at height %d!\n", __func__, assetName.c_str(), p_height);
+    }
+
+    if (!WriteBatch(batch)) {
+        LogPrint(BCLog::REWARDS, "%s : Failed to write the holder deltas and snapshots of height %d\n", __func__, p_height);
+        return;
+    }
+    for (auto const & base : newBases)
+        mapTrackedAssets[base.first] = base.second;
+}
+
+void CAssetSnapshotDB::DisconnectBlockHolderDeltas(int p_height)
+{
+    std::lock_guard<std::mutex> lock(cs);
+
+    std::vector<std::pair<std::string, std::string>> vWritten;
+    if (!Read(std::make_pair(SNAPSHOT_BLOCK_FLAG, p_height), vWritten))
+        return;
+
+    CDBBatch batch(*this);
+    for (auto const & assetAndAddress : vWritten)
+        batch.Erase(CSnapshotDeltaKey(assetAndAddress.first, assetAndAddress.second, p_height));
+    batch.Erase(std::make_pair(SNAPSHOT_BLOCK_FLAG, p_height));
+    if (!WriteBatch(batch))
+        LogPrint(BCLog::REWARDS, "%s : Failed to erase the holder deltas of height %d\n", __func__, p_height);
+}
+
+bool CAssetSnapshotDB::HasOwnershipSnapshot(const std::string & p_assetName, int p_height)
+{
+    return Exists(CSnapshotHeaderKey(p_assetName, p_height))
+        || Exists(std::make_pair(SNAPSHOTCHECK_FLAG, std::to_string(p_height) + p_assetName));
 }
 
 bool CAssetSnapshotDB::RetrieveOwnershipSnapshot(
@@ -120,7 +493,18 @@ bool CAssetSnapshotDB::RetrieveOwnershipSnapshot(
         __func__,
         heightAndName.c_str());
 
-    bool succeeded = Read(std::make_pair(SNAPSHOTCHECK_FLAG, heightAndName), p_snapshotEntry);
+    CAssetSnapshotReader reader(*this, p_assetName, p_height);
+    bool succeeded = reader.Found();
+    if (succeeded) {
+        p_snapshotEntry.SetNull();
+        p_snapshotEntry.height = p_height;
+        p_snapshotEntry.assetName = p_assetName;
+        p_snapshotEntry.heightAndName = heightAndName;
+
+        std::pair<std::string, CAmount> ownerAndAmount;
+        while (reader.Next(ownerAndAmount))
+            p_snapshotEntry.ownersAndAmounts.insert(ownerAndAmount);
+    }
 
     LogPrint(BCLog::REWARDS, "%s : Retrieval of snapshot for '%s' %s!\n",
         __func__,
@@ -140,7 +524,50 @@ bool CAssetSnapshotDB::RemoveOwnershipSnapshot(
         __func__,
         heightAndName.c_str());
 
-    bool succeeded = Erase(std::make_pair(SNAPSHOTCHECK_FLAG, heightAndName), true);
+    std::lock_guard<std::mutex> lock(cs);
+
+    CAssetSnapshotHeader removed;
+    bool fHadHeader = Read(CSnapshotHeaderKey(p_assetName, p_height), removed);
+
+    bool succeeded = Erase(std::make_pair(SNAPSHOTCHECK_FLAG, heightAndName), true)
+        && Erase(CSnapshotHeaderKey(p_assetName, p_height), true);
+
+    if (succeeded && fHadHeader) {
+        //  Drop the rows no remaining snapshot of the asset needs
+        bool fBaseUsed = false;
+        bool fAnyLeft = false;
+        int nLatestBase = 0;
+        std::unique_ptr<CDBIterator> pcursor(NewIterator());
+        pcursor->Seek(CSnapshotHeaderKey(p_assetName, 0));
+        CSnapshotHeaderKey key;
+        while (pcursor->Valid() && pcursor->GetKey(key) && key.flag == SNAPSHOT_HEADER_FLAG && key.assetName == p_assetName) {
+            CAssetSnapshotHeader other;
+            if (pcursor->GetValue(other)) {
+                fAnyLeft = true;
+                fBaseUsed = fBaseUsed || other.nBaseHeight == removed.nBaseHeight;
+                nLatestBase = std::max(nLatestBase, other.nBaseHeight);
+            }
+            pcursor->Next();
+        }
+
+        if (!fBaseUsed) {
+            CDBBatch batch(*this);
+            EraseBaseRows(batch, p_assetName, removed.nBaseHeight);
+            WriteBatch(batch);
+
+            //  New snapshots build on the newest base still stored; the deltas after it are all kept
+            auto it = mapTrackedAssets.find(p_assetName);
+            if (fAnyLeft && it != mapTrackedAssets.end() && it->second == removed.nBaseHeight) {
+                it->second = nLatestBase;
+                Write(std::make_pair(SNAPSHOT_TRACKED_FLAG, p_assetName), nLatestBase);
+            }
+        }
+        if (!fAnyLeft) {
+            EraseDeltaRows(p_assetName);
+            Erase(std::make_pair(SNAPSHOT_TRACKED_FLAG, p_assetName));
+            mapTrackedAssets.erase(p_assetName);
+        }
+    }
 
     LogPrint(BCLog::REWARDS, "%s : Removal of snapshot for '%s' %s!\n",
         __func__,
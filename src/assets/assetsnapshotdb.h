@@ -5,10 +5,17 @@
 #ifndef ASSETSNAPSHOTDB_H
 #define ASSETSNAPSHOTDB_H
 
+#include <map>
+#include <memory>
+#include <mutex>
 #include <set>
+#include <vector>
 
 #include <dbwrapper.h>
 #include "amount.h"
+#include "assettypes.h"
+
+struct CAssetsReadView;
 
 class CAssetSnapshotDBEntry
 {
@@ -53,18 +60,132 @@ public:
     }
 };
 
+/**
+ * Where the holders of a snapshot are stored: the full holder list written at
+ * nBaseHeight, updated by the per-block holder deltas in (nBaseHeight, height].
+ * A snapshot taken at its own base has nBaseHeight == height.
+ */
+class CAssetSnapshotHeader
+{
+public:
+    int height;
+    std::string assetName;
+    int nBaseHeight;
+
+    CAssetSnapshotHeader()
+    {
+        SetNull();
+    }
+
+    CAssetSnapshotHeader(const std::string& p_assetName, int p_height, int p_baseHeight)
+        : height(p_height), assetName(p_assetName), nBaseHeight(p_baseHeight) {}
+
+    void SetNull()
+    {
+        height = 0;
+        assetName = "";
+        nBaseHeight = 0;
+    }
+
+    ADD_SERIALIZE_METHODS;
+
+    template<typename Stream, typename Operation>
+    inline void SerializationOp(Stream &s, Operation ser_action)
+    {
+        READWRITE(height);
+        READWRITE(assetName);
+        READWRITE(nBaseHeight);
+    }
+};
+
+class CAssetSnapshotDB;
+
+/**
+ * Streams the owners and amounts of one snapshot, merging its base rows with
+ * the latest holder delta of each address, without loading the whole list.
+ * Owners come out ordered by address length and then bytes, and the reader
+ * sees the database as it was when it was opened.
+ */
+class CAssetSnapshotReader
+{
+    std::shared_ptr<const CDBSnapshot> dbSnapshot;
+    std::unique_ptr<CDBIterator> pBaseIter;
+    std::unique_ptr<CDBIterator> pDeltaIter;
+    CAssetSnapshotHeader header;
+    bool fFound;
+
+    //  Snapshots written as a single CAssetSnapshotDBEntry before the header format
+    bool fLegacy;
+    CAssetSnapshotDBEntry legacyEntry;
+    std::set<std::pair<std::string, CAmount>>::const_iterator legacyIter;
+
+    bool fHaveBase;
+    std::pair<std::string, CAmount> nextBase;
+    bool fHaveDelta;
+    std::pair<std::string, CAmount> nextDelta;
+
+    void ReadNextBase();
+    void ReadNextDelta();
+
+public:
+    CAssetSnapshotReader(CAssetSnapshotDB& db, const std::string& p_assetName, int p_height);
+
+    CAssetSnapshotReader(const CAssetSnapshotReader&) = delete;
+    CAssetSnapshotReader& operator=(const CAssetSnapshotReader&) = delete;
+
+    //  Whether a snapshot exists for the asset at the height
+    bool Found() const { return fFound; }
+    const std::string& AssetName() const { return header.assetName; }
+    int Height() const { return header.height; }
+
+    //  Get the next owner with a non zero amount, false once all have been read
+    bool Next(std::pair<std::string, CAmount>& p_ownerAndAmount);
+
+    //  Start over from the first owner, reading the same database state
+    void Rewind();
+};
+
 class CAssetSnapshotDB  : public CDBWrapper {
+    friend class CAssetSnapshotReader;
+
+    std::mutex cs;
+    //  Assets with snapshots, and the base height their holder deltas are kept from
+    std::map<std::string, int> mapTrackedAssets;
+
+    //  Base rows and snapshot entries are added to the caller's batch, which
+    //  is written early when it grows past SNAPSHOT_BATCH_SIZE
+    bool WriteBaseSnapshot(CDBBatch& batch, const CAssetsReadView& p_view, const std::string& p_assetName, int p_height, size_t& p_ownerCount);
+    void EraseBaseRows(CDBBatch& batch, const std::string& p_assetName, int p_baseHeight);
+    //  Requires cs; the assets given a base are added to p_newBases once the batch is written
+    bool AddSnapshotToBatch(CDBBatch& batch, const CAssetsReadView& p_view, const std::string& p_assetName, int p_height, std::map<std::string, int>& p_newBases);
+    void EraseDeltaRows(const std::string& p_assetName);
+
 public:
     explicit CAssetSnapshotDB(size_t nCacheSize, bool fMemory = false, bool fWipe = false);
 
     CAssetSnapshotDB(const CAssetSnapshotDB&) = delete;
     CAssetSnapshotDB& operator=(const CAssetSnapshotDB&) = delete;
 
-    //  Add an entry to the snapshot at the specified height
+    //  Add an entry to the snapshot at the specified height. Only the first
+    //  snapshot of an asset walks its holders; later ones reuse the deltas.
     bool AddAssetOwnershipSnapshot(
         const std::string & p_assetName, int p_height);
 
-    //  Read all of the entries at a specified height
+    //  Record the holder balances a connected block changed, for the assets with snapshots
+    void ConnectBlockHolderDeltas(int p_height, const std::map<std::pair<std::string, CAddressKey>, CAmount>& p_mapAssetAddressAmount);
+
+    //  Record a connected block's holder deltas and take the snapshots requested
+    //  at its height in one write, reading holders from p_view, the asset state
+    //  the block left
+    void ConnectBlockSnapshots(int p_height, const std::map<std::pair<std::string, CAddressKey>, CAmount>& p_mapAssetAddressAmount,
+                               const std::vector<std::string>& p_snapshotAssets, const CAssetsReadView& p_view);
+
+    //  Drop the holder deltas recorded for a block that is being disconnected
+    void DisconnectBlockHolderDeltas(int p_height);
+
+    bool HasOwnershipSnapshot(const std::string & p_assetName, int p_height);
+
+    //  Read all of the entries at a specified height into memory; prefer CAssetSnapshotReader
     bool RetrieveOwnershipSnapshot(
         const std::string & p_assetName, int p_height,
         CAssetSnapshotDBEntry & p_snapshotEntry);
@@ -3,7 +3,12 @@
 // file COPYING or http://www.opensource.org/licenses/mit-license.php.
 
 #include "assettypes.h"
+#include "base58.h"
 #include "hash.h"
+#include "pubkey.h"
+#include "random.h"
+
+#include <limits>
 
 int IntFromAssetType(AssetType type) {
     return (int)type;
@@ -24,3 +29,148 @@ uint256 CAssetCacheRestrictedAddress::GetHash() {
 uint256 CAssetCacheRootQualifierChecker::GetHash() {
     return Hash(rootAssetName.begin(), rootAssetName.end(), address.begin(), address.end());
 }
+
+namespace {
+class CAddressKeyVisitor : public boost::static_visitor<void>
+{
+    CAddressKey& key;
+
+public:
+    explicit CAddressKeyVisitor(CAddressKey& keyIn) : key(keyIn) {}
+
+    void operator()(const CNoDestination&) const {}
+
+    void operator()(const CKeyID& id) const
+    {
+        key.nType = CAddressKey::KEY_ID;
+        key.hash = id;
+    }
+
+    void operator()(const CScriptID& id) const
+    {
+        key.nType = CAddressKey::SCRIPT_ID;
+        key.hash = id;
+    }
+};
+} // namespace
+
+CAddressKey CAddressKey::FromDestination(const CTxDestination& dest)
+{
+    CAddressKey key;
+    boost::apply_visitor(CAddressKeyVisitor(key), dest);
+    return key;
+}
+
+CAddressKey CAddressKey::FromScript(const CScript& script)
+{
+    CTxDestination dest;
+    if (!ExtractDestination(script, dest))
+        return CAddressKey();
+    return FromDestination(dest);
+}
+
+CAddressKey CAddressKey::FromString(const std::string& address)
+{
+    return FromDestination(DecodeDestination(address));
+}
+
+CTxDestination CAddressKey::GetDestination() const
+{
+    if (nType == KEY_ID)
+        return CKeyID(hash);
+    if (nType == SCRIPT_ID)
+        return CScriptID(hash);
+    return CNoDestination();
+}
+
+std::string CAddressKey::ToString() const
+{
+    return IsNull() ? std::string() : EncodeDestination(GetDestination());
+}
+
+CAssetNamePool assetNamePool;
+
+uint32_t CAssetNamePool::Intern(const std::string& name)
+{
+    std::lock_guard<std::mutex> lock(cs);
+    auto it = mapIds.find(name);
+    if (it != mapIds.end())
+        return it->second;
+    it = mapIds.emplace(name, (uint32_t)vNames.size()).first;
+    vNames.push_back(&it->first);
+    return it->second;
+}
+
+bool CAssetNamePool::Find(const std::string& name, uint32_t& nId) const
+{
+    std::lock_guard<std::mutex> lock(cs);
+    auto it = mapIds.find(name);
+    if (it == mapIds.end())
+        return false;
+    nId = it->second;
+    return true;
+}
+
+const std::string& CAssetNamePool::GetName(uint32_t nId) const
+{
+    std::lock_guard<std::mutex> lock(cs);
+    return *vNames.at(nId);
+}
+
+size_t CAssetNamePool::Size() const
+{
+    std::lock_guard<std::mutex> lock(cs);
+    return vNames.size();
+}
+
+namespace {
+struct CAssetCacheSalt
+{
+    uint64_t k0, k1;
+
+    CAssetCacheSalt() : k0(GetRand(std::numeric_limits<uint64_t>::max())), k1(GetRand(std::numeric_limits<uint64_t>::max())) {}
+};
+
+const CAssetCacheSalt& GetAssetCacheSalt()
+{
+    static const CAssetCacheSalt salt;
+    return salt;
+}
+} // namespace
+
+size_t CAssetCacheHasher::HashKey(const std::string& assetName, const std::string& address)
+{
+    const CAssetCacheSalt& salt = GetAssetCacheSalt();
+    // The name's length keeps ("AB", "C") and ("A", "BC") apart
+    return CSipHasher(salt.k0, salt.k1)
+        .Write(assetName.size())
+        .Write((const unsigned char*)assetName.data(), assetName.size())
+        .Write((const unsigned char*)address.data(), address.size())
+        .Finalize();
+}
+
+size_t CAssetCacheHasher::HashKey(const COutPoint& out)
+{
+    const CAssetCacheSalt& salt = GetAssetCacheSalt();
+    return SipHashUint256Extra(salt.k0, salt.k1, out.hash, out.n);
+}
+
+size_t CAssetCacheHasher::HashKey(uint32_t nAssetId, const std::string& address)
+{
+    const CAssetCacheSalt& salt = GetAssetCacheSalt();
+    return CSipHasher(salt.k0, salt.k1)
+        .Write(nAssetId)
+        .Write((const unsigned char*)address.data(), address.size())
+        .Finalize();
+}
+
+size_t CAssetCacheHasher::HashKey(const std::string& assetName, const CAddressKey& address)
+{
+    const CAssetCacheSalt& salt = GetAssetCacheSalt();
+    return CSipHasher(salt.k0, salt.k1)
+        .Write(assetName.size())
+        .Write((const unsigned char*)assetName.data(), assetName.size())
+        .Write(address.nType)
+        .Write(address.hash.begin(), address.hash.size())
+        .Finalize();
+}
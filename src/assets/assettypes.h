@@ -8,8 +8,16 @@
 #include <string>
 #include <sstream>
 #include <list>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <vector>
+#include <algorithm>
 #include <unordered_map>
+#include <unordered_set>
 #include "amount.h"
+#include "memusage.h"
 #include "script/standard.h"
 #include "primitives/transaction.h"
 
@@ -17,6 +25,7 @@
 #define MIN_UNIT 0
 
 class CAssetsCache;
+struct CCompiledVerifier;
 
 enum class AssetType
 {
@@ -184,6 +193,40 @@ public:
     }
 };
 
+/**
+ * The unspent outputs of an asset, counted as blocks connect and disconnect.
+ * The caches hold changes, which add up to the totals the assets db keeps.
+ */
+class CAssetSupply
+{
+public:
+    //! Unspent outputs holding the asset, burn addresses included
+    int64_t nOutputs;
+    //! What those outputs hold, less what was sent to a burn address
+    CAmount nHeld;
+
+    CAssetSupply() : nOutputs(0), nHeld(0) {}
+    CAssetSupply(const int64_t nOutputsIn, const CAmount nHeldIn) : nOutputs(nOutputsIn), nHeld(nHeldIn) {}
+
+    bool IsNull() const { return nOutputs == 0 && nHeld == 0; }
+
+    CAssetSupply& operator+=(const CAssetSupply& other)
+    {
+        nOutputs += other.nOutputs;
+        nHeld += other.nHeld;
+        return *this;
+    }
+
+    ADD_SERIALIZE_METHODS;
+
+    template <typename Stream, typename Operation>
+    inline void SerializationOp(Stream& s, Operation ser_action)
+    {
+        READWRITE(nOutputs);
+        READWRITE(nHeld);
+    }
+};
+
 class CAssetTransfer
 {
 public:
@@ -308,6 +351,8 @@ class CNullAssetTxVerifierString {
 
 public:
     std::string verifier_string;
+    //! Not serialized; set on the copies passetsVerifierCache holds (see CompileVerifierString)
+    std::shared_ptr<const CCompiledVerifier> compiled;
 
     CNullAssetTxVerifierString()
     {
@@ -317,6 +362,7 @@ public:
     void SetNull()
     {
         verifier_string ="";
+        compiled.reset();
     }
 
     ADD_SERIALIZE_METHODS;
@@ -331,15 +377,73 @@ public:
     void ConstructTransaction(CScript& script) const;
 };
 
+/**
+ * An address the way the asset index keeps it: the destination type and its
+ * hash160, 21 bytes instead of a base58 string. It is read straight from the
+ * script, so balance updates don't base58 encode, and is only turned into a
+ * string where an address is shown or parsed. A null key stands for scripts
+ * without a destination.
+ */
+class CAddressKey
+{
+public:
+    enum Type : uint8_t
+    {
+        NONE = 0,
+        KEY_ID = 1,
+        SCRIPT_ID = 2
+    };
+
+    uint8_t nType;
+    uint160 hash;
+
+    CAddressKey() : nType(NONE) {}
+
+    static CAddressKey FromDestination(const CTxDestination& dest);
+    //! The destination of an asset or standard script, null if it has none
+    static CAddressKey FromScript(const CScript& script);
+    //! Parse a base58 address, null if it isn't valid
+    static CAddressKey FromString(const std::string& address);
+
+    bool IsNull() const { return nType == NONE; }
+    CTxDestination GetDestination() const;
+    //! The base58 address, empty for a null key
+    std::string ToString() const;
+
+    ADD_SERIALIZE_METHODS;
+
+    template <typename Stream, typename Operation>
+    inline void SerializationOp(Stream& s, Operation ser_action) {
+        READWRITE(nType);
+        READWRITE(hash);
+    }
+
+    //! Same order as the serialized keys in the database
+    bool operator<(const CAddressKey& rhs) const
+    {
+        return nType < rhs.nType || (nType == rhs.nType && hash < rhs.hash);
+    }
+
+    bool operator==(const CAddressKey& rhs) const
+    {
+        return nType == rhs.nType && hash == rhs.hash;
+    }
+
+    bool operator!=(const CAddressKey& rhs) const
+    {
+        return !(*this == rhs);
+    }
+};
+
 /** THESE ARE ONLY TO BE USED WHEN ADDING THINGS TO THE CACHE DURING CONNECT AND DISCONNECT BLOCK */
 struct CAssetCacheNewAsset
 {
     CNewAsset asset;
-    std::string address;
+    CAddressKey address;
     uint256 blockHash;
     int blockHeight;
 
-    CAssetCacheNewAsset(const CNewAsset& asset, const std::string& address, const int& blockHeight, const uint256& blockHash)
+    CAssetCacheNewAsset(const CNewAsset& asset, const CAddressKey& address, const int& blockHeight, const uint256& blockHash)
     {
         this->asset = asset;
         this->address = address;
@@ -351,18 +455,23 @@ struct CAssetCacheNewAsset
     {
         return asset.strName < rhs.asset.strName;
     }
+
+    bool operator==(const CAssetCacheNewAsset& rhs) const
+    {
+        return asset.strName == rhs.asset.strName;
+    }
 };
 
 struct CAssetCacheReissueAsset
 {
     CReissueAsset reissue;
-    std::string address;
+    CAddressKey address;
     COutPoint out;
     uint256 blockHash;
     int blockHeight;
 
 
-    CAssetCacheReissueAsset(const CReissueAsset& reissue, const std::string& address, const COutPoint& out, const int& blockHeight, const uint256& blockHash)
+    CAssetCacheReissueAsset(const CReissueAsset& reissue, const CAddressKey& address, const COutPoint& out, const int& blockHeight, const uint256& blockHash)
     {
         this->reissue = reissue;
         this->address = address;
@@ -376,15 +485,20 @@ struct CAssetCacheReissueAsset
         return out < rhs.out;
     }
 
+    bool operator==(const CAssetCacheReissueAsset& rhs) const
+    {
+        return out == rhs.out;
+    }
+
 };
 
 struct CAssetCacheNewTransfer
 {
     CAssetTransfer transfer;
-    std::string address;
+    CAddressKey address;
     COutPoint out;
 
-    CAssetCacheNewTransfer(const CAssetTransfer& transfer, const std::string& address, const COutPoint& out)
+    CAssetCacheNewTransfer(const CAssetTransfer& transfer, const CAddressKey& address, const COutPoint& out)
     {
         this->transfer = transfer;
         this->address = address;
@@ -395,14 +509,19 @@ struct CAssetCacheNewTransfer
     {
         return out < rhs.out;
     }
+
+    bool operator==(const CAssetCacheNewTransfer& rhs) const
+    {
+        return out == rhs.out;
+    }
 };
 
 struct CAssetCacheNewOwner
 {
     std::string assetName;
-    std::string address;
+    CAddressKey address;
 
-    CAssetCacheNewOwner(const std::string& assetName, const std::string& address)
+    CAssetCacheNewOwner(const std::string& assetName, const CAddressKey& address)
     {
         this->assetName = assetName;
         this->address = address;
@@ -413,15 +532,20 @@ struct CAssetCacheNewOwner
 
         return assetName < rhs.assetName;
     }
+
+    bool operator==(const CAssetCacheNewOwner& rhs) const
+    {
+        return assetName == rhs.assetName;
+    }
 };
 
 struct CAssetCacheUndoAssetAmount
 {
     std::string assetName;
-    std::string address;
+    CAddressKey address;
     CAmount nAmount;
 
-    CAssetCacheUndoAssetAmount(const std::string& assetName, const std::string& address, const CAmount& nAmount)
+    CAssetCacheUndoAssetAmount(const std::string& assetName, const CAddressKey& address, const CAmount& nAmount)
     {
         this->assetName = assetName;
         this->address = address;
@@ -432,10 +556,10 @@ struct CAssetCacheUndoAssetAmount
 struct CAssetCacheSpendAsset
 {
     std::string assetName;
-    std::string address;
+    CAddressKey address;
     CAmount nAmount;
 
-    CAssetCacheSpendAsset(const std::string& assetName, const std::string& address, const CAmount& nAmount)
+    CAssetCacheSpendAsset(const std::string& assetName, const CAddressKey& address, const CAmount& nAmount)
     {
         this->assetName = assetName;
         this->address = address;
@@ -458,6 +582,10 @@ struct CAssetCacheQualifierAddress {
         return assetName < rhs.assetName || (assetName == rhs.assetName && address < rhs.address);
     }
 
+    bool operator==(const CAssetCacheQualifierAddress &rhs) const {
+        return assetName == rhs.assetName && address == rhs.address;
+    }
+
     uint256 GetHash();
 };
 
@@ -495,6 +623,11 @@ struct CAssetCacheRestrictedAddress
         return assetName < rhs.assetName || (assetName == rhs.assetName && address < rhs.address);
     }
 
+    bool operator==(const CAssetCacheRestrictedAddress& rhs) const
+    {
+        return assetName == rhs.assetName && address == rhs.address;
+    }
+
     uint256 GetHash();
 };
 
@@ -513,6 +646,11 @@ struct CAssetCacheRestrictedGlobal
     {
         return assetName < rhs.assetName;
     }
+
+    bool operator==(const CAssetCacheRestrictedGlobal& rhs) const
+    {
+        return assetName == rhs.assetName;
+    }
 };
 
 struct CAssetCacheRestrictedVerifiers
@@ -532,10 +670,97 @@ struct CAssetCacheRestrictedVerifiers
     {
         return assetName < rhs.assetName;
     }
+
+    bool operator==(const CAssetCacheRestrictedVerifiers& rhs) const
+    {
+        return assetName == rhs.assetName;
+    }
+};
+
+/**
+ * Process-wide interning pool for asset names. Each distinct name is stored
+ * once and given a compact id that never changes, so the asset LRU caches can
+ * be keyed by a 32-bit integer. Only the caches' Put() interns, and they are
+ * only filled with assets that exist, which keeps the pool bounded by the
+ * number of assets; lookups go through Find(), which never adds a name.
+ */
+class CAssetNamePool
+{
+    mutable std::mutex cs;
+    std::unordered_map<std::string, uint32_t> mapIds;
+    //! Names by id, pointing at the keys of mapIds
+    std::vector<const std::string*> vNames;
+
+public:
+    //! The id of name, adding it to the pool if needed
+    uint32_t Intern(const std::string& name);
+    //! The id of name if it was interned before
+    bool Find(const std::string& name, uint32_t& nId) const;
+    const std::string& GetName(uint32_t nId) const;
+    size_t Size() const;
+};
+
+extern CAssetNamePool assetNamePool;
+
+/** Key of the qualifier and restriction caches: an interned asset name and an address */
+struct CAssetAddressKey
+{
+    uint32_t nAssetId;
+    std::string address;
+
+    CAssetAddressKey(uint32_t nAssetIdIn, const std::string& addressIn) : nAssetId(nAssetIdIn), address(addressIn) {}
+
+    bool operator==(const CAssetAddressKey& rhs) const
+    {
+        return nAssetId == rhs.nAssetId && address == rhs.address;
+    }
 };
 
+/**
+ * Salted SipHash over the fields that identify an entry of the CAssetsCache
+ * dirty containers, which are the same fields their operator< compares. The
+ * (asset name, address) pair is hashed in one pass, so a lookup costs one
+ * hash and usually one string compare instead of a compare per tree level.
+ * The salt is picked once per process, so crafted asset names can't be used
+ * to flood a bucket.
+ */
+class CAssetCacheHasher
+{
+public:
+    static size_t HashKey(const std::string& assetName, const std::string& address);
+    static size_t HashKey(const COutPoint& out);
+    static size_t HashKey(uint32_t nAssetId, const std::string& address);
+    static size_t HashKey(const std::string& assetName, const CAddressKey& address);
+
+    size_t operator()(const CAssetCacheNewAsset& item) const { return HashKey(item.asset.strName, ""); }
+    size_t operator()(const CAssetCacheReissueAsset& item) const { return HashKey(item.out); }
+    size_t operator()(const CAssetCacheNewTransfer& item) const { return HashKey(item.out); }
+    size_t operator()(const CAssetCacheNewOwner& item) const { return HashKey(item.assetName, ""); }
+    size_t operator()(const CAssetCacheQualifierAddress& item) const { return HashKey(item.assetName, item.address); }
+    size_t operator()(const CAssetCacheRestrictedAddress& item) const { return HashKey(item.assetName, item.address); }
+    size_t operator()(const CAssetCacheRestrictedGlobal& item) const { return HashKey(item.assetName, ""); }
+    size_t operator()(const CAssetCacheRestrictedVerifiers& item) const { return HashKey(item.assetName, ""); }
+    size_t operator()(const std::string& key) const { return HashKey(key, ""); }
+    size_t operator()(const std::pair<std::string, std::string>& key) const { return HashKey(key.first, key.second); }
+    size_t operator()(const std::pair<std::string, CAddressKey>& key) const { return HashKey(key.first, key.second); }
+    size_t operator()(const CAssetAddressKey& key) const { return HashKey(key.nAssetId, key.address); }
+};
+
+/** Unordered set of CAssetsCache dirty entries; sort with SortedCacheEntries() where order matters */
+template <typename T>
+using CAssetCacheSet = std::unordered_set<T, CAssetCacheHasher>;
+
+//! The entries of set in operator< order, e.g. for writing them to the database
+template <typename T>
+std::vector<T> SortedCacheEntries(const CAssetCacheSet<T>& set)
+{
+    std::vector<T> vEntries(set.begin(), set.end());
+    std::sort(vEntries.begin(), vEntries.end());
+    return vEntries;
+}
+
 // Least Recently Used Cache
-template<typename cache_key_t, typename cache_value_t>
+template<typename cache_key_t, typename cache_value_t, typename cache_hash_t = std::hash<cache_key_t> >
 class CLRUCache
 {
 public:
@@ -628,7 +853,7 @@ public:
         maxSize = size;
     }
 
-   const std::unordered_map<cache_key_t, list_iterator_t>& GetItemsMap()
+   const std::unordered_map<cache_key_t, list_iterator_t, cache_hash_t>& GetItemsMap()
     {
         return cacheItemsMap;
     };
@@ -648,8 +873,415 @@ public:
 
 private:
     std::list<key_value_pair_t> cacheItemsList;
-    std::unordered_map<cache_key_t, list_iterator_t> cacheItemsMap;
+    std::unordered_map<cache_key_t, list_iterator_t, cache_hash_t> cacheItemsMap;
     size_t maxSize;
 };
 
+/**
+ * Heap bytes owned by the keys and values of the asset LRU caches, beyond
+ * their sizeof, for the caches' memory budget.
+ */
+struct CAssetCacheUsage
+{
+    static size_t StringUsage(const std::string& str)
+    {
+        // Short strings are stored inline
+        return str.capacity() > 15 ? memusage::MallocUsage(str.capacity() + 1) : 0;
+    }
+
+    size_t operator()(uint32_t) const { return 0; }
+    size_t operator()(int8_t) const { return 0; }
+    size_t operator()(const std::string& str) const { return StringUsage(str); }
+    size_t operator()(const CAssetAddressKey& key) const { return StringUsage(key.address); }
+    size_t operator()(const CDatabasedAssetData& data) const { return StringUsage(data.asset.strName) + StringUsage(data.asset.strIPFSHash); }
+    size_t operator()(const CNullAssetTxVerifierString& verifier) const { return StringUsage(verifier.verifier_string); }
+};
+
+/** Snapshot of the size and counters of a CShardedLRUCache */
+struct CLRUCacheStats
+{
+    size_t nEntries{0};
+    size_t nMaxEntries{0};
+    size_t nUsage{0};
+    size_t nMaxUsage{0};
+    uint64_t nHits{0};
+    uint64_t nMisses{0};
+    uint64_t nEvictions{0};
+};
+
+/**
+ * Thread-safe LRU cache, split by key hash into shards that each have their
+ * own lock, their share of the entry limit and memory budget, and their own
+ * recency list. Readers of different shards never contend, and none of them
+ * need cs_main. Eviction is least recently used within a shard, which only
+ * approximates a global LRU, so small caches use a single shard.
+ */
+template<typename cache_key_t, typename cache_value_t, typename cache_hash_t = std::hash<cache_key_t>, typename cache_usage_t = CAssetCacheUsage>
+class CShardedLRUCache
+{
+    typedef std::pair<cache_key_t, cache_value_t> key_value_pair_t;
+    typedef typename std::list<key_value_pair_t>::iterator list_iterator_t;
+
+    //! Entries per shard below which an extra shard isn't worth losing LRU precision over
+    static const size_t MIN_SHARD_ENTRIES = 256;
+    static const size_t MAX_SHARDS = 16;
+
+    struct CShard
+    {
+        std::mutex cs;
+        std::list<key_value_pair_t> cacheItemsList;
+        std::unordered_map<cache_key_t, list_iterator_t, cache_hash_t> cacheItemsMap;
+        size_t nUsage{0};
+        uint64_t nHits{0};
+        uint64_t nMisses{0};
+        uint64_t nEvictions{0};
+    };
+
+    std::vector<std::unique_ptr<CShard> > vShards;
+    size_t nMaxEntries;
+    size_t nMaxUsage;
+    cache_hash_t hasher;
+    cache_usage_t usage;
+
+    CShard& GetShard(const cache_key_t& key) const
+    {
+        return *vShards[hasher(key) % vShards.size()];
+    }
+
+    size_t EntryUsage(const key_value_pair_t& item) const
+    {
+        return memusage::MallocUsage(sizeof(key_value_pair_t) + 2 * sizeof(void*)) +
+               memusage::MallocUsage(sizeof(std::pair<const cache_key_t, list_iterator_t>) + 2 * sizeof(void*)) +
+               usage(item.first) + usage(item.second);
+    }
+
+    //! Drop the shard's least recently used entry, returning its usage; shard.cs must be held
+    size_t EvictLast(CShard& shard)
+    {
+        const key_value_pair_t& last = shard.cacheItemsList.back();
+        const size_t nEntryUsage = EntryUsage(last);
+        shard.nUsage -= nEntryUsage;
+        shard.cacheItemsMap.erase(last.first);
+        shard.cacheItemsList.pop_back();
+        shard.nEvictions++;
+        return nEntryUsage;
+    }
+
+    //! Drop the shard's least recently used entries until it is back within its limits; shard.cs must be held
+    void Trim(CShard& shard)
+    {
+        const size_t nShardEntries = std::max<size_t>(1, nMaxEntries / vShards.size());
+        const size_t nShardUsage = nMaxUsage / vShards.size();
+        while (!shard.cacheItemsList.empty() && (shard.cacheItemsMap.size() > nShardEntries || (nShardUsage && shard.nUsage > nShardUsage))) {
+            EvictLast(shard);
+        }
+    }
+
+public:
+    //! Keep at most nMaxEntriesIn entries using about nMaxUsageIn bytes (0 for no byte limit)
+    explicit CShardedLRUCache(size_t nMaxEntriesIn, size_t nMaxUsageIn = 0) : nMaxEntries(nMaxEntriesIn), nMaxUsage(nMaxUsageIn)
+    {
+        size_t nShards = std::min((size_t)MAX_SHARDS, std::max<size_t>(1, nMaxEntries / MIN_SHARD_ENTRIES));
+        for (size_t i = 0; i < nShards; i++) {
+            vShards.emplace_back(new CShard());
+        }
+    }
+
+    CShardedLRUCache(const CShardedLRUCache&) = delete;
+    CShardedLRUCache& operator=(const CShardedLRUCache&) = delete;
+
+    void Put(const cache_key_t& key, const cache_value_t& value)
+    {
+        CShard& shard = GetShard(key);
+        std::lock_guard<std::mutex> lock(shard.cs);
+        auto it = shard.cacheItemsMap.find(key);
+        if (it != shard.cacheItemsMap.end()) {
+            shard.nUsage -= EntryUsage(*it->second);
+            shard.cacheItemsList.erase(it->second);
+            shard.cacheItemsMap.erase(it);
+        }
+        shard.cacheItemsList.push_front(key_value_pair_t(key, value));
+        shard.cacheItemsMap[key] = shard.cacheItemsList.begin();
+        shard.nUsage += EntryUsage(shard.cacheItemsList.front());
+        Trim(shard);
+    }
+
+    void Erase(const cache_key_t& key)
+    {
+        CShard& shard = GetShard(key);
+        std::lock_guard<std::mutex> lock(shard.cs);
+        auto it = shard.cacheItemsMap.find(key);
+        if (it != shard.cacheItemsMap.end()) {
+            shard.nUsage -= EntryUsage(*it->second);
+            shard.cacheItemsList.erase(it->second);
+            shard.cacheItemsMap.erase(it);
+        }
+    }
+
+    //! Copy the value of key into value and mark it recently used; returns false on a miss
+    bool Get(const cache_key_t& key, cache_value_t& value)
+    {
+        CShard& shard = GetShard(key);
+        std::lock_guard<std::mutex> lock(shard.cs);
+        auto it = shard.cacheItemsMap.find(key);
+        if (it == shard.cacheItemsMap.end()) {
+            shard.nMisses++;
+            return false;
+        }
+        shard.nHits++;
+        shard.cacheItemsList.splice(shard.cacheItemsList.begin(), shard.cacheItemsList, it->second);
+        value = it->second->second;
+        return true;
+    }
+
+    //! The value of key, which must be in the cache; prefer Get(key, value) where another thread may evict it
+    cache_value_t Get(const cache_key_t& key)
+    {
+        CShard& shard = GetShard(key);
+        std::lock_guard<std::mutex> lock(shard.cs);
+        auto it = shard.cacheItemsMap.find(key);
+        if (it == shard.cacheItemsMap.end())
+            throw std::range_error("There is no such key in cache");
+        shard.cacheItemsList.splice(shard.cacheItemsList.begin(), shard.cacheItemsList, it->second);
+        return it->second->second;
+    }
+
+    bool Exists(const cache_key_t& key) const
+    {
+        CShard& shard = GetShard(key);
+        std::lock_guard<std::mutex> lock(shard.cs);
+        bool fFound = shard.cacheItemsMap.count(key);
+        if (fFound)
+            shard.nHits++;
+        else
+            shard.nMisses++;
+        return fFound;
+    }
+
+    size_t Size() const
+    {
+        size_t nSize = 0;
+        for (const auto& shard : vShards) {
+            std::lock_guard<std::mutex> lock(shard->cs);
+            nSize += shard->cacheItemsMap.size();
+        }
+        return nSize;
+    }
+
+    size_t MaxSize() const
+    {
+        return nMaxEntries;
+    }
+
+    //! Up to nMax keys, taking the most recently used of each shard in turn
+    std::vector<cache_key_t> GetRecentKeys(size_t nMax) const
+    {
+        std::vector<std::vector<cache_key_t> > vShardKeys;
+        for (const auto& shard : vShards) {
+            std::lock_guard<std::mutex> lock(shard->cs);
+            vShardKeys.emplace_back();
+            for (const key_value_pair_t& item : shard->cacheItemsList) {
+                if (vShardKeys.back().size() >= nMax)
+                    break;
+                vShardKeys.back().push_back(item.first);
+            }
+        }
+        std::vector<cache_key_t> vKeys;
+        for (size_t i = 0; vKeys.size() < nMax; i++) {
+            bool fMore = false;
+            for (const auto& vShard : vShardKeys) {
+                if (i < vShard.size() && vKeys.size() < nMax) {
+                    vKeys.push_back(vShard[i]);
+                    fMore = true;
+                }
+            }
+            if (!fMore)
+                break;
+        }
+        return vKeys;
+    }
+
+    void Clear()
+    {
+        for (const auto& shard : vShards) {
+            std::lock_guard<std::mutex> lock(shard->cs);
+            shard->cacheItemsMap.clear();
+            shard->cacheItemsList.clear();
+            shard->nUsage = 0;
+        }
+    }
+
+    //! Drop least recently used entries, spread over the shards, until about nBytes are freed; returns the bytes freed
+    size_t Shrink(size_t nBytes)
+    {
+        size_t nFreed = 0;
+        bool fMore = true;
+        while (nFreed < nBytes && fMore) {
+            fMore = false;
+            const size_t nShardTarget = (nBytes - nFreed + vShards.size() - 1) / vShards.size();
+            for (const auto& shard : vShards) {
+                std::lock_guard<std::mutex> lock(shard->cs);
+                size_t nShardFreed = 0;
+                while (nShardFreed < nShardTarget && !shard->cacheItemsList.empty())
+                    nShardFreed += EvictLast(*shard);
+                nFreed += nShardFreed;
+                fMore |= !shard->cacheItemsList.empty();
+            }
+        }
+        return nFreed;
+    }
+
+    //! Estimated bytes used by the entries, including the index
+    size_t DynamicMemoryUsage() const
+    {
+        size_t nTotal = 0;
+        for (const auto& shard : vShards) {
+            std::lock_guard<std::mutex> lock(shard->cs);
+            nTotal += shard->nUsage + memusage::MallocUsage(sizeof(void*) * shard->cacheItemsMap.bucket_count());
+        }
+        return nTotal;
+    }
+
+    CLRUCacheStats GetStats() const
+    {
+        CLRUCacheStats stats;
+        stats.nMaxEntries = nMaxEntries;
+        stats.nMaxUsage = nMaxUsage;
+        for (const auto& shard : vShards) {
+            std::lock_guard<std::mutex> lock(shard->cs);
+            stats.nEntries += shard->cacheItemsMap.size();
+            stats.nUsage += shard->nUsage;
+            stats.nHits += shard->nHits;
+            stats.nMisses += shard->nMisses;
+            stats.nEvictions += shard->nEvictions;
+        }
+        return stats;
+    }
+};
+
+/**
+ * Sharded LRU cache keyed by assetNamePool ids but used with asset names.
+ * Looking up a name that was never put misses without interning it.
+ */
+template<typename cache_value_t>
+class CAssetNameLRUCache : public CShardedLRUCache<uint32_t, cache_value_t>
+{
+    typedef CShardedLRUCache<uint32_t, cache_value_t> Base;
+
+public:
+    explicit CAssetNameLRUCache(size_t nMaxEntries, size_t nMaxUsage = 0) : Base(nMaxEntries, nMaxUsage) {}
+
+    void Put(const std::string& name, const cache_value_t& value)
+    {
+        Base::Put(assetNamePool.Intern(name), value);
+    }
+
+    void Erase(const std::string& name)
+    {
+        uint32_t nId;
+        if (assetNamePool.Find(name, nId))
+            Base::Erase(nId);
+    }
+
+    bool Get(const std::string& name, cache_value_t& value)
+    {
+        uint32_t nId;
+        return assetNamePool.Find(name, nId) && Base::Get(nId, value);
+    }
+
+    cache_value_t Get(const std::string& name)
+    {
+        uint32_t nId;
+        if (!assetNamePool.Find(name, nId))
+            throw std::range_error("There is no such key in cache");
+        return Base::Get(nId);
+    }
+
+    bool Exists(const std::string& name) const
+    {
+        uint32_t nId;
+        return assetNamePool.Find(name, nId) && Base::Exists(nId);
+    }
+
+    std::vector<std::string> GetRecentNames(size_t nMax) const
+    {
+        std::vector<std::string> vNames;
+        for (uint32_t nId : Base::GetRecentKeys(nMax))
+            vNames.push_back(assetNamePool.GetName(nId));
+        return vNames;
+    }
+};
+
+/** Same for caches keyed by an asset name and an address */
+template<typename cache_value_t>
+class CAssetAddressLRUCache : public CShardedLRUCache<CAssetAddressKey, cache_value_t, CAssetCacheHasher>
+{
+    typedef CShardedLRUCache<CAssetAddressKey, cache_value_t, CAssetCacheHasher> Base;
+
+public:
+    explicit CAssetAddressLRUCache(size_t nMaxEntries, size_t nMaxUsage = 0) : Base(nMaxEntries, nMaxUsage) {}
+
+    void Put(const std::string& assetName, const std::string& address, const cache_value_t& value)
+    {
+        Base::Put(CAssetAddressKey(assetNamePool.Intern(assetName), address), value);
+    }
+
+    void Erase(const std::string& assetName, const std::string& address)
+    {
+        uint32_t nId;
+        if (assetNamePool.Find(assetName, nId))
+            Base::Erase(CAssetAddressKey(nId, address));
+    }
+
+    bool Exists(const std::string& assetName, const std::string& address) const
+    {
+        uint32_t nId;
+        return assetNamePool.Find(assetName, nId) && Base::Exists(CAssetAddressKey(nId, address));
+    }
+};
+
+/**
+ * One change a connected or disconnected block made to assets, published over
+ * ZMQ (-zmqpubassettransfer, -zmqpubassetissue, -zmqpubassetbalance) so that
+ * indexers don't have to decode asset scripts themselves. Disconnected blocks
+ * give the same records with fConnected false.
+ */
+class CAssetNotification
+{
+public:
+    enum Type : uint8_t {
+        TRANSFER = 0,   //! Asset output paying nAmount to address
+        ISSUE = 1,      //! New asset (or owner token) of nAmount sent to address
+        REISSUE = 2,    //! nAmount more of an asset sent to address
+        BALANCE = 3,    //! nAmount is the address's new balance (needs -assetindex)
+    };
+
+    uint8_t nType{TRANSFER};
+    bool fConnected{true};
+    std::string assetName;
+    std::string address;
+    CAmount nAmount{0};
+    //! Null for ISSUE and BALANCE
+    COutPoint out;
+    int32_t nHeight{0};
+
+    CAssetNotification() = default;
+    CAssetNotification(Type type, bool connected, const std::string& name, const std::string& addr, CAmount amount, const COutPoint& outIn, int height)
+        : nType(type), fConnected(connected), assetName(name), address(addr), nAmount(amount), out(outIn), nHeight(height) {}
+
+    ADD_SERIALIZE_METHODS;
+
+    template <typename Stream, typename Operation>
+    inline void SerializationOp(Stream& s, Operation ser_action)
+    {
+        READWRITE(nType);
+        READWRITE(fConnected);
+        READWRITE(assetName);
+        READWRITE(address);
+        READWRITE(nAmount);
+        READWRITE(out);
+        READWRITE(nHeight);
+    }
+};
+
 #endif //RAVENCOIN_NEWASSET_H
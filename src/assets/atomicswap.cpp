@@ -10,11 +10,17 @@
 #include "script/script.h"
 #include "script/standard.h"
 #include "util.h"
+#include "validationinterface.h"
 
 #include <algorithm>
+#include <atomic>
 #include <sstream>
 
 std::unique_ptr<CAtomicSwapOrderBook> atomicSwapOrderBook;
+CHTLCIndex htlcIndex;
+
+//! Sequence number of the last COrderBookUpdate published by either book
+static std::atomic<uint64_t> nOrderBookSequence{0};
 
 // ============================================================================
 // CAtomicSwapOffer Implementation
@@ -235,8 +241,373 @@ bool ExtractPreimage(
     return false;
 }
 
+bool ParseHTLCRedeemScript(const CScript& redeemScript, CHTLC& htlc)
+{
+    txnouttype type;
+    std::vector<std::vector<unsigned char>> solutions;
+    if (!Solver(redeemScript, type, solutions) || type != TX_HTLC) {
+        return false;
+    }
+    
+    // Little endian CScriptNum; a lock height is never negative
+    const std::vector<unsigned char>& vchTimeLock = solutions[2];
+    if (!vchTimeLock.empty() && (vchTimeLock.back() & 0x80)) {
+        return false;
+    }
+    int64_t nTimeLock = 0;
+    for (size_t i = 0; i < vchTimeLock.size(); i++) {
+        nTimeLock |= (int64_t)vchTimeLock[i] << (8 * i);
+    }
+    if (nTimeLock > std::numeric_limits<uint32_t>::max()) {
+        return false;
+    }
+    
+    htlc.hashLock = uint256(solutions[0]);
+    htlc.receiverAddress = GetScriptForDestination(CKeyID(uint160(solutions[1])));
+    htlc.timeLock = nTimeLock;
+    htlc.senderAddress = GetScriptForDestination(CKeyID(uint160(solutions[3])));
+    return true;
+}
+
+bool MatchHTLCSpend(const CScript& scriptSig, HTLCSpend& spend)
+{
+    // Cheapest checks first: almost no scriptSig ends in an HTLC redeem script
+    static const size_t MIN_REDEEM_SCRIPT_SIZE = 91;
+    if (scriptSig.size() < MIN_REDEEM_SCRIPT_SIZE + 3) {
+        return false;
+    }
+    
+    // Remember the last three items; the redeem script is the final push
+    opcodetype ops[3] = {OP_INVALIDOPCODE, OP_INVALIDOPCODE, OP_INVALIDOPCODE};
+    std::vector<unsigned char> data[3];
+    size_t nPushes = 0;
+    CScript::const_iterator pc = scriptSig.begin();
+    while (pc < scriptSig.end()) {
+        ops[0] = ops[1];
+        ops[1] = ops[2];
+        data[0].swap(data[1]);
+        data[1].swap(data[2]);
+        if (!scriptSig.GetOp(pc, ops[2], data[2]) || ops[2] > OP_16) {
+            return false;
+        }
+        nPushes++;
+    }
+    
+    const std::vector<unsigned char>& redeem = data[2];
+    if (ops[2] > OP_PUSHDATA4 || redeem.size() < MIN_REDEEM_SCRIPT_SIZE || redeem[0] != OP_IF) {
+        return false;
+    }
+    if (ops[1] == OP_TRUE && nPushes >= 5) {
+        spend.fClaim = true;
+        spend.preimage = data[0];
+    } else if (ops[1] == OP_FALSE && nPushes >= 4) {
+        spend.fClaim = false;
+        spend.preimage.clear();
+    } else {
+        return false;
+    }
+    
+    return ParseHTLCRedeemScript(CScript(redeem.begin(), redeem.end()), spend.htlc);
+}
+
 } // namespace HTLCScript
 
+// ============================================================================
+// CHTLCIndex Implementation
+// ============================================================================
+
+void CHTLCIndex::AddHTLC(const uint256& hashLock, const COutPoint& outpoint)
+{
+    LOCK(cs);
+    outpoints[hashLock] = outpoint;
+}
+
+bool CHTLCIndex::GetHTLC(const uint256& hashLock, COutPoint& outpoint) const
+{
+    LOCK(cs);
+    auto it = outpoints.find(hashLock);
+    if (it == outpoints.end()) {
+        return false;
+    }
+    outpoint = it->second;
+    return true;
+}
+
+bool CHTLCIndex::GetPreimage(const uint256& hashLock, std::vector<unsigned char>& preimage) const
+{
+    LOCK(cs);
+    auto it = preimages.find(hashLock);
+    if (it == preimages.end()) {
+        return false;
+    }
+    preimage = it->second;
+    return true;
+}
+
+int CHTLCIndex::ConnectTransaction(const CTransaction& tx)
+{
+    int nClaims = 0;
+    HTLCScript::HTLCSpend spend;
+    for (const CTxIn& txin : tx.vin) {
+        if (!HTLCScript::MatchHTLCSpend(txin.scriptSig, spend)) {
+            continue;
+        }
+        
+        LOCK(cs);
+        outpoints[spend.htlc.hashLock] = txin.prevout;
+        if (spend.fClaim && HashSecret(spend.preimage) == spend.htlc.hashLock) {
+            preimages[spend.htlc.hashLock] = spend.preimage;
+            nClaims++;
+        }
+    }
+    return nClaims;
+}
+
+// ============================================================================
+// COrderBookIndex Implementation
+// ============================================================================
+
+namespace {
+//! Full 128 bit product of a and b as (hi, lo)
+std::pair<uint64_t, uint64_t> Mul64(uint64_t a, uint64_t b)
+{
+    uint64_t aLo = a & 0xffffffff, aHi = a >> 32;
+    uint64_t bLo = b & 0xffffffff, bHi = b >> 32;
+    uint64_t p0 = aLo * bLo, p1 = aLo * bHi, p2 = aHi * bLo, p3 = aHi * bHi;
+    uint64_t mid = (p0 >> 32) + (p1 & 0xffffffff) + (p2 & 0xffffffff);
+    return std::make_pair(p3 + (p1 >> 32) + (p2 >> 32) + (mid >> 32), (p0 & 0xffffffff) | (mid << 32));
+}
+
+std::string NormalizeAssetName(const std::string& assetName)
+{
+    return assetName.empty() ? "MYNTA" : assetName;
+}
+
+UniValue OfferToJson(const CAtomicSwapOffer& offer)
+{
+    UniValue offerJson(UniValue::VOBJ);
+    offerJson.pushKV("hash", offer.offerHash.ToString());
+    offerJson.pushKV("makerAsset", NormalizeAssetName(offer.makerAssetName));
+    offerJson.pushKV("makerAmount", offer.makerAmount);
+    offerJson.pushKV("takerAsset", NormalizeAssetName(offer.takerAssetName));
+    offerJson.pushKV("takerAmount", offer.takerAmount);
+    offerJson.pushKV("rate", offer.GetRate());
+    offerJson.pushKV("createdHeight", offer.createdHeight);
+    offerJson.pushKV("expiresHeight", static_cast<int64_t>(offer.createdHeight) + offer.timeoutBlocks);
+    return offerJson;
+}
+
+/**
+ * Append up to nMaxLevels price levels of side, best (lowest rate) first, to
+ * levels and their offers to offerList
+ */
+void SideToJson(const COrderBookIndex::Side* side, const std::map<uint256, CAtomicSwapOffer>& offers,
+                size_t nMaxLevels, UniValue& offerList, UniValue& levels)
+{
+    if (!side) {
+        return;
+    }
+    for (const auto& level : *side) {
+        if (nMaxLevels && levels.size() >= nMaxLevels) {
+            break;
+        }
+        UniValue levelJson(UniValue::VOBJ);
+        levelJson.pushKV("rate", level.first.ToDouble());
+        levelJson.pushKV("makerAmount", level.second.nMakerTotal);
+        levelJson.pushKV("takerAmount", level.second.nTakerTotal);
+        levelJson.pushKV("offers", (uint64_t)level.second.offers.size());
+        levels.push_back(levelJson);
+
+        for (const auto& entry : level.second.offers) {
+            auto it = offers.find(entry.second);
+            if (it != offers.end() && it->second.isActive) {
+                offerList.push_back(OfferToJson(it->second));
+            }
+        }
+    }
+}
+
+UniValue OrderBookToJson(const COrderBookIndex& book, const std::map<uint256, CAtomicSwapOffer>& offers,
+                         const std::string& assetA, const std::string& assetB, size_t nMaxLevels)
+{
+    UniValue result(UniValue::VOBJ);
+    UniValue bids(UniValue::VARR);  // Buy orders for assetA
+    UniValue asks(UniValue::VARR);  // Sell orders for assetA
+    UniValue bidLevels(UniValue::VARR);
+    UniValue askLevels(UniValue::VARR);
+
+    SideToJson(book.GetSide(assetB, assetA), offers, nMaxLevels, bids, bidLevels);
+    SideToJson(book.GetSide(assetA, assetB), offers, nMaxLevels, asks, askLevels);
+
+    result.pushKV("pair", NormalizeAssetName(assetA) + "/" + NormalizeAssetName(assetB));
+    result.pushKV("bids", bids);
+    result.pushKV("asks", asks);
+    result.pushKV("bidLevels", bidLevels);
+    result.pushKV("askLevels", askLevels);
+    return result;
+}
+
+/** Walk the levels of side from [first, last) and return the earliest active offer of the first level that has one */
+template <typename Iterator>
+CAtomicSwapOffer* FirstActiveOffer(Iterator first, Iterator last, std::map<uint256, CAtomicSwapOffer>& offers)
+{
+    for (; first != last; ++first) {
+        for (const auto& entry : first->second.offers) {
+            auto it = offers.find(entry.second);
+            if (it != offers.end() && it->second.isActive) {
+                return &it->second;
+            }
+        }
+    }
+    return nullptr;
+}
+
+//! Active offers of both sides of a pair, in book order
+std::vector<CAtomicSwapOffer> OffersInBookOrder(const COrderBookIndex& book, const std::map<uint256, CAtomicSwapOffer>& offers,
+                                                const std::string& assetA, const std::string& assetB)
+{
+    std::vector<CAtomicSwapOffer> result;
+    for (const COrderBookIndex::Side* side : {book.GetSide(assetA, assetB), book.GetSide(assetB, assetA)}) {
+        if (!side) {
+            continue;
+        }
+        for (const auto& level : *side) {
+            for (const auto& entry : level.second.offers) {
+                auto it = offers.find(entry.second);
+                if (it != offers.end() && it->second.isActive) {
+                    result.push_back(it->second);
+                }
+            }
+        }
+    }
+    return result;
+}
+} // namespace
+
+COrderBookUpdate::COrderBookUpdate(Type type, const CAtomicSwapOffer& offer)
+    : nType(type), offerHash(offer.offerHash), makerAssetName(offer.makerAssetName), makerAmount(offer.makerAmount),
+      takerAssetName(offer.takerAssetName), takerAmount(offer.takerAmount), createdHeight(offer.createdHeight),
+      timeoutBlocks(offer.timeoutBlocks), fillTxHash(offer.fillTxHash)
+{
+}
+
+/** Number the update and hand it to the listeners; called with the book's lock held so updates leave in book order */
+static void PublishOrderBookUpdate(COrderBookUpdate update)
+{
+    update.nSequence = ++nOrderBookSequence;
+    GetMainSignals().OrderBookUpdated(update);
+}
+
+COrderBookPrice::COrderBookPrice(const CAtomicSwapOffer& offer)
+{
+    // Same as GetRate(), which treats an offer giving nothing as rate 0
+    if (offer.makerAmount > 0) {
+        nTaker = std::max<CAmount>(offer.takerAmount, 0);
+        nMaker = offer.makerAmount;
+    }
+}
+
+bool COrderBookPrice::operator<(const COrderBookPrice& other) const
+{
+    // nTaker / nMaker < other.nTaker / other.nMaker, cross multiplied so it is exact
+    return Mul64(nTaker, other.nMaker) < Mul64(other.nTaker, nMaker);
+}
+
+void COrderBookIndex::Add(const CAtomicSwapOffer& offer)
+{
+    if (!offer.isActive || positions.count(offer.offerHash)) {
+        return;
+    }
+
+    CPosition pos;
+    pos.pairKey = GetTradingPairKey(offer.makerAssetName, offer.takerAssetName);
+    pos.nSide = NormalizeAssetName(offer.makerAssetName) <= NormalizeAssetName(offer.takerAssetName) ? 0 : 1;
+    pos.price = COrderBookPrice(offer);
+    pos.makerAmount = offer.makerAmount;
+    pos.takerAmount = offer.takerAmount;
+
+    CPriceLevel& level = pairs[pos.pairKey][pos.nSide][pos.price];
+    level.nMakerTotal += offer.makerAmount;
+    level.nTakerTotal += offer.takerAmount;
+
+    // Offers mostly arrive in height order, so search for the slot from the back
+    auto it = level.offers.end();
+    while (it != level.offers.begin() && std::prev(it)->first > offer.createdHeight) {
+        --it;
+    }
+    pos.it = level.offers.emplace(it, offer.createdHeight, offer.offerHash);
+
+    positions.emplace(offer.offerHash, pos);
+}
+
+bool COrderBookIndex::Remove(const uint256& offerHash)
+{
+    auto posIt = positions.find(offerHash);
+    if (posIt == positions.end()) {
+        return false;
+    }
+    const CPosition& pos = posIt->second;
+
+    auto pairIt = pairs.find(pos.pairKey);
+    Side& side = pairIt->second[pos.nSide];
+    auto levelIt = side.find(pos.price);
+    levelIt->second.nMakerTotal -= pos.makerAmount;
+    levelIt->second.nTakerTotal -= pos.takerAmount;
+    levelIt->second.offers.erase(pos.it);
+    if (levelIt->second.offers.empty()) {
+        side.erase(levelIt);
+        if (pairIt->second[0].empty() && pairIt->second[1].empty()) {
+            pairs.erase(pairIt);
+        }
+    }
+
+    positions.erase(posIt);
+    return true;
+}
+
+void COrderBookIndex::Clear()
+{
+    pairs.clear();
+    positions.clear();
+}
+
+const COrderBookIndex::Side* COrderBookIndex::GetSide(const std::string& makerAsset, const std::string& takerAsset) const
+{
+    auto it = pairs.find(GetTradingPairKey(makerAsset, takerAsset));
+    if (it == pairs.end()) {
+        return nullptr;
+    }
+    int nSide = NormalizeAssetName(makerAsset) <= NormalizeAssetName(takerAsset) ? 0 : 1;
+    const Side& side = it->second[nSide];
+    return side.empty() ? nullptr : &side;
+}
+
+void COfferExpiryIndex::Add(const CAtomicSwapOffer& offer)
+{
+    buckets[offer.createdHeight + static_cast<int>(offer.timeoutBlocks)].insert(offer.offerHash);
+}
+
+void COfferExpiryIndex::Remove(const CAtomicSwapOffer& offer)
+{
+    auto it = buckets.find(offer.createdHeight + static_cast<int>(offer.timeoutBlocks));
+    if (it == buckets.end()) {
+        return;
+    }
+    it->second.erase(offer.offerHash);
+    if (it->second.empty()) {
+        buckets.erase(it);
+    }
+}
+
+std::vector<uint256> COfferExpiryIndex::GetExpired(int currentHeight) const
+{
+    std::vector<uint256> result;
+    for (auto it = buckets.begin(); it != buckets.end() && it->first <= currentHeight; ++it) {
+        result.insert(result.end(), it->second.begin(), it->second.end());
+    }
+    return result;
+}
+
 // ============================================================================
 // CAtomicSwapOrderBook Implementation
 // ============================================================================
@@ -251,9 +622,10 @@ bool CAtomicSwapOrderBook::AddOffer(const CAtomicSwapOffer& offer)
     
     offers[offer.offerHash] = offer;
     
-    // Index by trading pair
-    std::string pairKey = GetTradingPairKey(offer.makerAssetName, offer.takerAssetName);
-    offersByPair[pairKey].insert(offer.offerHash);
+    // Index by trading pair, side and price
+    book.Add(offer);
+    expiry.Add(offer);
+    PublishOrderBookUpdate(COrderBookUpdate(COrderBookUpdate::OFFER_ADDED, offer));
     
     LogPrintf("CAtomicSwapOrderBook::%s -- Added offer: %s\n", __func__, offer.ToString());
     return true;
@@ -268,10 +640,9 @@ bool CAtomicSwapOrderBook::RemoveOffer(const uint256& offerHash)
         return false;
     }
     
-    const CAtomicSwapOffer& offer = it->second;
-    std::string pairKey = GetTradingPairKey(offer.makerAssetName, offer.takerAssetName);
-    offersByPair[pairKey].erase(offerHash);
-    
+    book.Remove(offerHash);
+    expiry.Remove(it->second);
+    PublishOrderBookUpdate(COrderBookUpdate(COrderBookUpdate::OFFER_REMOVED, it->second));
     offers.erase(it);
     
     LogPrintf("CAtomicSwapOrderBook::%s -- Removed offer: %s\n", __func__, offerHash.ToString());
@@ -294,23 +665,7 @@ std::vector<CAtomicSwapOffer> CAtomicSwapOrderBook::GetOffersForPair(
     const std::string& assetB) const
 {
     LOCK(cs);
-    
-    std::vector<CAtomicSwapOffer> result;
-    std::string pairKey = GetTradingPairKey(assetA, assetB);
-    
-    auto it = offersByPair.find(pairKey);
-    if (it == offersByPair.end()) {
-        return result;
-    }
-    
-    for (const uint256& hash : it->second) {
-        auto offerIt = offers.find(hash);
-        if (offerIt != offers.end() && offerIt->second.isActive) {
-            result.push_back(offerIt->second);
-        }
-    }
-    
-    return result;
+    return OffersInBookOrder(book, offers, assetA, assetB);
 }
 
 CAtomicSwapOffer* CAtomicSwapOrderBook::GetBestOffer(
@@ -320,63 +675,21 @@ CAtomicSwapOffer* CAtomicSwapOrderBook::GetBestOffer(
 {
     LOCK(cs);
     
-    std::string pairKey = GetTradingPairKey(wantAsset, haveAsset);
-    
-    auto it = offersByPair.find(pairKey);
-    if (it == offersByPair.end()) {
-        return nullptr;
+    if (buyOrder) {
+        // Buying: offers giving wantAsset, lowest rate first
+        const COrderBookIndex::Side* side = book.GetSide(wantAsset, haveAsset);
+        return side ? FirstActiveOffer(side->begin(), side->end(), offers) : nullptr;
     }
-    
-    CAtomicSwapOffer* bestOffer = nullptr;
-    double bestRate = buyOrder ? std::numeric_limits<double>::max() : 0;
-    
-    for (const uint256& hash : it->second) {
-        auto offerIt = offers.find(hash);
-        if (offerIt == offers.end() || !offerIt->second.isActive) {
-            continue;
-        }
-        
-        CAtomicSwapOffer& offer = offerIt->second;
-        
-        // Check if offer matches our direction
-        bool offerMatchesDirection = 
-            (buyOrder && offer.makerAssetName == wantAsset) ||
-            (!buyOrder && offer.takerAssetName == wantAsset);
-        
-        if (!offerMatchesDirection) {
-            continue;
-        }
-        
-        double rate = offer.GetRate();
-        if (buyOrder) {
-            // Buying: want lowest rate
-            if (rate < bestRate) {
-                bestRate = rate;
-                bestOffer = &offer;
-            }
-        } else {
-            // Selling: want highest rate
-            if (rate > bestRate) {
-                bestRate = rate;
-                bestOffer = &offer;
-            }
-        }
-    }
-    
-    return bestOffer;
+    // Selling: offers taking wantAsset, highest rate first
+    const COrderBookIndex::Side* side = book.GetSide(haveAsset, wantAsset);
+    return side ? FirstActiveOffer(side->rbegin(), side->rend(), offers) : nullptr;
 }
 
 void CAtomicSwapOrderBook::CleanupExpired(int currentHeight)
 {
     LOCK(cs);
     
-    std::vector<uint256> toRemove;
-    
-    for (const auto& pair : offers) {
-        if (pair.second.IsExpired(currentHeight)) {
-            toRemove.push_back(pair.first);
-        }
-    }
+    std::vector<uint256> toRemove = expiry.GetExpired(currentHeight);
     
     for (const uint256& hash : toRemove) {
         RemoveOffer(hash);
@@ -390,40 +703,13 @@ void CAtomicSwapOrderBook::CleanupExpired(int currentHeight)
 
 UniValue CAtomicSwapOrderBook::GetOrderBookJson(
     const std::string& assetA,
-    const std::string& assetB) const
+    const std::string& assetB,
+    size_t nMaxLevels) const
 {
     LOCK(cs);
     
-    UniValue result(UniValue::VOBJ);
-    UniValue bids(UniValue::VARR);  // Buy orders for assetA
-    UniValue asks(UniValue::VARR);  // Sell orders for assetA
-    
-    auto allOffers = GetOffersForPair(assetA, assetB);
-    
-    for (const auto& offer : allOffers) {
-        UniValue offerJson(UniValue::VOBJ);
-        offerJson.pushKV("hash", offer.offerHash.ToString());
-        offerJson.pushKV("makerAsset", offer.makerAssetName.empty() ? "MYNTA" : offer.makerAssetName);
-        offerJson.pushKV("makerAmount", offer.makerAmount);
-        offerJson.pushKV("takerAsset", offer.takerAssetName.empty() ? "MYNTA" : offer.takerAssetName);
-        offerJson.pushKV("takerAmount", offer.takerAmount);
-        offerJson.pushKV("rate", offer.GetRate());
-        offerJson.pushKV("createdHeight", offer.createdHeight);
-        offerJson.pushKV("expiresHeight", static_cast<int64_t>(offer.createdHeight) + offer.timeoutBlocks);
-        
-        // Determine if this is a bid or ask relative to assetA
-        if (offer.makerAssetName == assetA || 
-            (offer.makerAssetName.empty() && assetA.empty())) {
-            asks.push_back(offerJson);  // Selling assetA
-        } else {
-            bids.push_back(offerJson);  // Buying assetA
-        }
-    }
-    
-    result.pushKV("pair", assetA + "/" + (assetB.empty() ? "MYNTA" : assetB));
-    result.pushKV("bids", bids);
-    result.pushKV("asks", asks);
-    
+    UniValue result = OrderBookToJson(book, offers, assetA, assetB, nMaxLevels);
+    result.pushKV("sequence", (uint64_t)nOrderBookSequence);
     return result;
 }
 
@@ -627,6 +913,16 @@ HTLCResult CreateHTLC(
         return HTLCResult("Failed to commit transaction: " + state.GetRejectReason());
     }
     
+    // Index the HTLC output so its claim can be found by hash lock
+    for (size_t i = 0; i < wtx.tx->vout.size(); i++) {
+        if (wtx.tx->vout[i].scriptPubKey == p2shScript) {
+            htlcIndex.AddHTLC(finalHashLock, COutPoint(wtx.GetHash(), i));
+            // So the wallet can tell when the refund path opens
+            wallet->WatchHTLC(COutPoint(wtx.GetHash(), i), htlcScript);
+            break;
+        }
+    }
+    
     // Build result
     HTLCResult result = HTLCResult::Success(wtx.GetHash());
     result.preimage = preimage;
@@ -885,6 +1181,11 @@ bool ParseHTLCScript(const CScript& script, CHTLC& htlc)
         return false;
     }
     
+    if (type == TX_HTLC) {
+        // Given the redeem script itself
+        return HTLCScript::ParseHTLCRedeemScript(script, htlc);
+    }
+    
     if (type != TX_SCRIPTHASH) {
         return false;
     }
@@ -1008,6 +1309,7 @@ CPersistentOrderBook::CPersistentOrderBook(const std::string& dbPath)
 {
     fs::path path = fs::path(dbPath) / "orderbook";
     db = std::make_unique<CDBWrapper>(path, 1 << 20, false, false);
+    batch = std::make_unique<CDBBatch>(*db);
 }
 
 CPersistentOrderBook::~CPersistentOrderBook()
@@ -1022,8 +1324,10 @@ bool CPersistentOrderBook::Initialize()
     // Load height
     db->Read(DB_HEIGHT, currentHeight);
     
-    // Load all offers
+    // Load all offers. The iterator yields them in key order, so each goes in
+    // at the end of the map without a search.
     std::unique_ptr<CDBIterator> iter(db->NewIterator());
+    std::vector<uint256> vInvalid;
     
     for (iter->Seek(DB_OFFER); iter->Valid(); iter->Next()) {
         std::pair<char, uint256> key;
@@ -1032,28 +1336,40 @@ bool CPersistentOrderBook::Initialize()
         if (key.first != DB_OFFER) break;
         
         CAtomicSwapOffer offer;
-        if (iter->GetValue(offer)) {
-            offers[key.second] = offer;
-            
-            std::string pairKey = GetTradingPairKey(offer.makerAssetName, offer.takerAssetName);
-            offersByPair[pairKey].insert(key.second);
+        std::string strError;
+        if (!iter->GetValue(offer) || offer.offerHash != key.second || !CheckAtomicSwapOffer(offer, strError)) {
+            vInvalid.push_back(key.second);
+            continue;
         }
+        offers.emplace_hint(offers.end(), key.second, offer);
+        // Filled offers stay on disk but are no longer in the book
+        book.Add(offer);
+        expiry.Add(offer);
     }
     
     // Load UTXO mappings
+    offersByUTXO.reserve(offers.size());
     for (iter->Seek(DB_UTXO); iter->Valid(); iter->Next()) {
         std::pair<char, uint256> key;
         if (!iter->GetKey(key)) break;
         
         if (key.first != DB_UTXO) break;
+        if (!offers.count(key.second)) continue;
         
         COutPoint utxo;
         if (iter->GetValue(utxo)) {
-            offerUTXOs[key.second] = utxo;
+            offerUTXOs.emplace_hint(offerUTXOs.end(), key.second, utxo);
+            offersByUTXO.emplace(utxo, key.second);
         }
     }
     
-    LogPrintf("CPersistentOrderBook::%s -- Loaded %d offers\n", __func__, offers.size());
+    // Offers that can't be read back or don't pass the checks go at the next flush
+    for (const uint256& offerHash : vInvalid) {
+        batch->Erase(std::make_pair(DB_OFFER, offerHash));
+        batch->Erase(std::make_pair(DB_UTXO, offerHash));
+    }
+    
+    LogPrintf("CPersistentOrderBook::%s -- Loaded %d offers, dropped %d invalid ones\n", __func__, offers.size(), vInvalid.size());
     return true;
 }
 
@@ -1065,27 +1381,17 @@ bool CPersistentOrderBook::AddOffer(const CAtomicSwapOffer& offer, const COutPoi
         return false;
     }
     
-    // Write to database
-    CDataStream keyStream(SER_DISK, CLIENT_VERSION);
-    keyStream << DB_OFFER << offer.offerHash;
-    
-    if (!db->Write(keyStream, offer)) {
-        return false;
-    }
-    
-    // Write UTXO mapping
-    CDataStream utxoKeyStream(SER_DISK, CLIENT_VERSION);
-    utxoKeyStream << DB_UTXO << offer.offerHash;
-    
-    if (!db->Write(utxoKeyStream, fundingUTXO)) {
-        return false;
-    }
+    // Queue the offer and its UTXO mapping for the next flush
+    batch->Write(std::make_pair(DB_OFFER, offer.offerHash), offer);
+    batch->Write(std::make_pair(DB_UTXO, offer.offerHash), fundingUTXO);
     
     // Update memory
     offers[offer.offerHash] = offer;
-    std::string pairKey = GetTradingPairKey(offer.makerAssetName, offer.takerAssetName);
-    offersByPair[pairKey].insert(offer.offerHash);
+    book.Add(offer);
+    expiry.Add(offer);
+    PublishOrderBookUpdate(COrderBookUpdate(COrderBookUpdate::OFFER_ADDED, offer));
     offerUTXOs[offer.offerHash] = fundingUTXO;
+    offersByUTXO.emplace(fundingUTXO, offer.offerHash);
     
     LogPrintf("CPersistentOrderBook::%s -- Added offer: %s\n", __func__, offer.ToString());
     return true;
@@ -1100,20 +1406,25 @@ bool CPersistentOrderBook::RemoveOffer(const uint256& offerHash)
         return false;
     }
     
-    // Remove from database
-    CDataStream keyStream(SER_DISK, CLIENT_VERSION);
-    keyStream << DB_OFFER << offerHash;
-    db->Erase(keyStream);
-    
-    CDataStream utxoKeyStream(SER_DISK, CLIENT_VERSION);
-    utxoKeyStream << DB_UTXO << offerHash;
-    db->Erase(utxoKeyStream);
+    // Queue the removal for the next flush
+    batch->Erase(std::make_pair(DB_OFFER, offerHash));
+    batch->Erase(std::make_pair(DB_UTXO, offerHash));
     
     // Update memory
-    const CAtomicSwapOffer& offer = it->second;
-    std::string pairKey = GetTradingPairKey(offer.makerAssetName, offer.takerAssetName);
-    offersByPair[pairKey].erase(offerHash);
-    offerUTXOs.erase(offerHash);
+    book.Remove(offerHash);
+    expiry.Remove(it->second);
+    PublishOrderBookUpdate(COrderBookUpdate(COrderBookUpdate::OFFER_REMOVED, it->second));
+    auto utxoIt = offerUTXOs.find(offerHash);
+    if (utxoIt != offerUTXOs.end()) {
+        auto range = offersByUTXO.equal_range(utxoIt->second);
+        for (auto rangeIt = range.first; rangeIt != range.second; ++rangeIt) {
+            if (rangeIt->second == offerHash) {
+                offersByUTXO.erase(rangeIt);
+                break;
+            }
+        }
+        offerUTXOs.erase(utxoIt);
+    }
     offers.erase(it);
     
     return true;
@@ -1131,11 +1442,11 @@ bool CPersistentOrderBook::MarkOfferFilled(const uint256& offerHash, const uint2
     it->second.isActive = false;
     it->second.isFilled = true;
     it->second.fillTxHash = fillTxHash;
+    if (book.Remove(offerHash)) {
+        PublishOrderBookUpdate(COrderBookUpdate(COrderBookUpdate::OFFER_FILLED, it->second));
+    }
     
-    // Update database
-    CDataStream keyStream(SER_DISK, CLIENT_VERSION);
-    keyStream << DB_OFFER << offerHash;
-    db->Write(keyStream, it->second);
+    batch->Write(std::make_pair(DB_OFFER, offerHash), it->second);
     
     return true;
 }
@@ -1163,23 +1474,7 @@ std::vector<CAtomicSwapOffer> CPersistentOrderBook::GetOffersForPair(
     const std::string& assetB) const
 {
     LOCK(cs);
-    
-    std::vector<CAtomicSwapOffer> result;
-    std::string pairKey = GetTradingPairKey(assetA, assetB);
-    
-    auto it = offersByPair.find(pairKey);
-    if (it == offersByPair.end()) {
-        return result;
-    }
-    
-    for (const uint256& hash : it->second) {
-        auto offerIt = offers.find(hash);
-        if (offerIt != offers.end() && offerIt->second.isActive) {
-            result.push_back(offerIt->second);
-        }
-    }
-    
-    return result;
+    return OffersInBookOrder(book, offers, assetA, assetB);
 }
 
 std::vector<CAtomicSwapOffer> CPersistentOrderBook::GetActiveOffers() const
@@ -1202,18 +1497,20 @@ void CPersistentOrderBook::ConnectBlock(const CBlock& block, int height)
     
     // Check for filled or cancelled offers in this block
     for (const auto& tx : block.vtx) {
+        // Revealed swap secrets
+        htlcIndex.ConnectTransaction(*tx);
+        
         // Check if any inputs spend offer UTXOs
         for (const auto& vin : tx->vin) {
-            for (auto& pair : offerUTXOs) {
-                if (pair.second == vin.prevout) {
-                    MarkOfferFilled(pair.first, tx->GetHash());
-                }
+            auto range = offersByUTXO.equal_range(vin.prevout);
+            for (auto it = range.first; it != range.second; ++it) {
+                MarkOfferFilled(it->second, tx->GetHash());
             }
         }
     }
     
-    // Update height in database
-    db->Write(DB_HEIGHT, currentHeight);
+    // The height goes out with the block's offer updates at the next flush
+    batch->Write(DB_HEIGHT, currentHeight);
 }
 
 void CPersistentOrderBook::DisconnectBlock(const CBlock& block, int height)
@@ -1225,7 +1522,7 @@ void CPersistentOrderBook::DisconnectBlock(const CBlock& block, int height)
     // This requires tracking which offers were filled in which block
     // For now, simple implementation just updates height
     
-    db->Write(DB_HEIGHT, currentHeight);
+    batch->Write(DB_HEIGHT, currentHeight);
     
     LogPrintf("CPersistentOrderBook::%s -- Disconnected block at height %d\n", __func__, height);
 }
@@ -1234,39 +1531,36 @@ void CPersistentOrderBook::UTXOSpent(const COutPoint& utxo)
 {
     LOCK(cs);
     
-    for (auto& pair : offerUTXOs) {
-        if (pair.second == utxo) {
-            RemoveOffer(pair.first);
-            break;
-        }
+    auto it = offersByUTXO.find(utxo);
+    if (it != offersByUTXO.end()) {
+        uint256 offerHash = it->second;
+        RemoveOffer(offerHash);
     }
 }
 
 bool CPersistentOrderBook::IsOfferUTXOSpent(const uint256& offerHash) const
 {
-    LOCK(cs);
-    
-    auto it = offerUTXOs.find(offerHash);
-    if (it == offerUTXOs.end()) {
-        return true; // No UTXO means it's spent or doesn't exist
+    COutPoint utxo;
+    {
+        LOCK(cs);
+        auto it = offerUTXOs.find(offerHash);
+        if (it == offerUTXOs.end()) {
+            return true; // No UTXO means it's spent or doesn't exist
+        }
+        utxo = it->second;
     }
     
+    // cs is released first: Flush() is called from FlushStateToDisk with cs_main held
     LOCK(cs_main);
     CCoinsViewCache& view = *pcoinsTip;
-    return view.AccessCoin(it->second).IsSpent();
+    return view.AccessCoin(utxo).IsSpent();
 }
 
 void CPersistentOrderBook::CleanupExpired(int currentHeight)
 {
     LOCK(cs);
     
-    std::vector<uint256> toRemove;
-    
-    for (const auto& pair : offers) {
-        if (pair.second.IsExpired(currentHeight)) {
-            toRemove.push_back(pair.first);
-        }
-    }
+    std::vector<uint256> toRemove = expiry.GetExpired(currentHeight);
     
     for (const uint256& hash : toRemove) {
         RemoveOffer(hash);
@@ -1278,50 +1572,34 @@ void CPersistentOrderBook::CleanupExpired(int currentHeight)
     }
 }
 
-void CPersistentOrderBook::Flush()
+bool CPersistentOrderBook::Flush()
 {
     LOCK(cs);
-    if (db) {
-        db->Write(DB_HEIGHT, currentHeight);
+    if (!db) {
+        return true;
+    }
+    
+    // LevelDB logs the batch before applying it, so after a crash the book
+    // on disk is the one as of the end of some flushed block, never a mix
+    batch->Write(DB_HEIGHT, currentHeight);
+    if (!db->WriteBatch(*batch, true)) {
+        LogPrintf("CPersistentOrderBook::%s -- Failed to write order book at height %d\n", __func__, currentHeight);
+        return false;
     }
+    batch->Clear();
+    return true;
 }
 
 UniValue CPersistentOrderBook::GetOrderBookJson(
     const std::string& assetA,
-    const std::string& assetB) const
+    const std::string& assetB,
+    size_t nMaxLevels) const
 {
     LOCK(cs);
     
-    UniValue result(UniValue::VOBJ);
-    UniValue bids(UniValue::VARR);
-    UniValue asks(UniValue::VARR);
-    
-    auto allOffers = GetOffersForPair(assetA, assetB);
-    
-    for (const auto& offer : allOffers) {
-        UniValue offerJson(UniValue::VOBJ);
-        offerJson.pushKV("hash", offer.offerHash.ToString());
-        offerJson.pushKV("makerAsset", offer.makerAssetName.empty() ? "MYNTA" : offer.makerAssetName);
-        offerJson.pushKV("makerAmount", offer.makerAmount);
-        offerJson.pushKV("takerAsset", offer.takerAssetName.empty() ? "MYNTA" : offer.takerAssetName);
-        offerJson.pushKV("takerAmount", offer.takerAmount);
-        offerJson.pushKV("rate", offer.GetRate());
-        offerJson.pushKV("createdHeight", offer.createdHeight);
-        offerJson.pushKV("expiresHeight", static_cast<int64_t>(offer.createdHeight) + offer.timeoutBlocks);
-        
-        if (offer.makerAssetName == assetA ||
-            (offer.makerAssetName.empty() && assetA.empty())) {
-            asks.push_back(offerJson);
-        } else {
-            bids.push_back(offerJson);
-        }
-    }
-    
-    result.pushKV("pair", (assetA.empty() ? "MYNTA" : assetA) + "/" + (assetB.empty() ? "MYNTA" : assetB));
-    result.pushKV("bids", bids);
-    result.pushKV("asks", asks);
+    UniValue result = OrderBookToJson(book, offers, assetA, assetB, nMaxLevels);
+    result.pushKV("sequence", (uint64_t)nOrderBookSequence);
     result.pushKV("height", currentHeight);
-    
     return result;
 }
 
@@ -6,6 +6,7 @@
 #define MYNTA_ASSETS_ATOMICSWAP_H
 
 #include "amount.h"
+#include "coins.h"
 #include "primitives/transaction.h"
 #include "script/script.h"
 #include "script/standard.h"
@@ -15,10 +16,13 @@
 
 #include <univalue.h>
 
+#include <array>
+#include <list>
 #include <map>
 #include <memory>
 #include <set>
 #include <string>
+#include <unordered_map>
 #include <vector>
 
 /**
@@ -258,8 +262,183 @@ namespace HTLCScript {
         const CScript& scriptSig,
         std::vector<unsigned char>& preimage
     );
+    
+    /**
+     * Decode a redeem script made by CreateHTLCScript with P2PKH parties
+     * (the TX_HTLC solver template) into htlc's addresses and locks
+     */
+    bool ParseHTLCRedeemScript(const CScript& redeemScript, CHTLC& htlc);
+    
+    /**
+     * An input spending a P2SH HTLC output
+     */
+    struct HTLCSpend {
+        bool fClaim{false};
+        CHTLC htlc;                         // Decoded from the redeem script
+        std::vector<unsigned char> preimage;  // Claims only
+    };
+    
+    /**
+     * Match a scriptSig of the form <sig> <pubkey> <preimage> OP_TRUE <redeemScript>
+     * (claim) or <sig> <pubkey> OP_FALSE <redeemScript> (refund)
+     */
+    bool MatchHTLCSpend(const CScript& scriptSig, HTLCSpend& spend);
 }
 
+/**
+ * HTLC outpoints by hash lock, and the preimages revealed by claims seen in
+ * blocks, so the secret of a counterparty's claim is one lookup away.
+ */
+class CHTLCIndex
+{
+private:
+    mutable CCriticalSection cs;
+    std::map<uint256, COutPoint> outpoints;
+    std::map<uint256, std::vector<unsigned char>> preimages;
+
+public:
+    void AddHTLC(const uint256& hashLock, const COutPoint& outpoint);
+    bool GetHTLC(const uint256& hashLock, COutPoint& outpoint) const;
+    bool GetPreimage(const uint256& hashLock, std::vector<unsigned char>& preimage) const;
+    
+    // Record the HTLC claims and refunds among tx's inputs; returns the number of claims
+    int ConnectTransaction(const CTransaction& tx);
+};
+
+extern CHTLCIndex htlcIndex;
+
+/**
+ * One change to the in-memory or persistent order book, published over ZMQ
+ * (-zmqpubdexoffer, -zmqpubdexfill). nSequence increases by one per update
+ * across both books and "sequence" in dex orderbook is the last one applied,
+ * so clients can keep a book from one RPC snapshot plus the later updates.
+ */
+class COrderBookUpdate
+{
+public:
+    enum Type : uint8_t {
+        OFFER_ADDED = 0,
+        OFFER_REMOVED = 1,
+        OFFER_FILLED = 2,
+    };
+
+    uint64_t nSequence{0};
+    uint8_t nType{OFFER_ADDED};
+    uint256 offerHash;
+
+    // Only serialized for OFFER_ADDED
+    std::string makerAssetName;     // Empty string = MYNTA
+    CAmount makerAmount{0};
+    std::string takerAssetName;     // Empty string = MYNTA
+    CAmount takerAmount{0};
+    int createdHeight{0};
+    uint32_t timeoutBlocks{0};
+
+    // Only serialized for OFFER_FILLED
+    uint256 fillTxHash;
+
+    COrderBookUpdate() = default;
+    COrderBookUpdate(Type type, const CAtomicSwapOffer& offer);
+
+    ADD_SERIALIZE_METHODS;
+
+    template <typename Stream, typename Operation>
+    inline void SerializationOp(Stream& s, Operation ser_action)
+    {
+        READWRITE(nSequence);
+        READWRITE(nType);
+        READWRITE(offerHash);
+        if (nType == OFFER_ADDED) {
+            READWRITE(makerAssetName);
+            READWRITE(makerAmount);
+            READWRITE(takerAssetName);
+            READWRITE(takerAmount);
+            READWRITE(createdHeight);
+            READWRITE(timeoutBlocks);
+        } else if (nType == OFFER_FILLED) {
+            READWRITE(fillTxHash);
+        }
+    }
+};
+
+/**
+ * Exact price of an offer, takerAmount / makerAmount, compared without
+ * rounding so that offers at the same price share a level.
+ */
+struct COrderBookPrice
+{
+    CAmount nTaker{0};
+    CAmount nMaker{1};
+
+    COrderBookPrice() = default;
+    explicit COrderBookPrice(const CAtomicSwapOffer& offer);
+
+    bool operator<(const COrderBookPrice& other) const;
+    double ToDouble() const { return static_cast<double>(nTaker) / static_cast<double>(nMaker); }
+};
+
+/**
+ * Active offers of every trading pair, split into two sides by the asset the
+ * maker gives and grouped into price levels. Levels are ordered by rising
+ * price and the offers of a level by creation height, then arrival, so the
+ * best offer of a side is the front of its first or last level.
+ */
+class COrderBookIndex
+{
+public:
+    // Created height and hash of each offer resting at a price
+    typedef std::list<std::pair<int, uint256>> OfferQueue;
+
+    struct CPriceLevel
+    {
+        CAmount nMakerTotal{0};
+        CAmount nTakerTotal{0};
+        OfferQueue offers;
+    };
+    typedef std::map<COrderBookPrice, CPriceLevel> Side;
+
+private:
+    struct CPosition
+    {
+        std::string pairKey;
+        int nSide;
+        COrderBookPrice price;
+        OfferQueue::iterator it;
+        CAmount makerAmount;
+        CAmount takerAmount;
+    };
+
+    // Key: "ASSET_A:ASSET_B" (sorted alphabetically); side 0 holds the offers giving ASSET_A
+    std::map<std::string, std::array<Side, 2>> pairs;
+    std::map<uint256, CPosition> positions;
+
+public:
+    // Inactive offers and offers already indexed are ignored
+    void Add(const CAtomicSwapOffer& offer);
+    bool Remove(const uint256& offerHash);
+    void Clear();
+
+    // The side holding the offers that give makerAsset for takerAsset, or nullptr if there are none
+    const Side* GetSide(const std::string& makerAsset, const std::string& takerAsset) const;
+};
+
+/**
+ * Offers bucketed by the height at which they expire, so that cleanup only
+ * visits the offers that actually expired instead of the whole book.
+ */
+class COfferExpiryIndex
+{
+    std::map<int, std::set<uint256>> buckets;
+
+public:
+    void Add(const CAtomicSwapOffer& offer);
+    void Remove(const CAtomicSwapOffer& offer);
+    void Clear() { buckets.clear(); }
+
+    // Offers for which IsExpired(currentHeight) holds, earliest expiry first
+    std::vector<uint256> GetExpired(int currentHeight) const;
+};
+
 // Order Book Management
 class CAtomicSwapOrderBook
 {
@@ -269,9 +448,9 @@ private:
     // Active offers indexed by hash
     std::map<uint256, CAtomicSwapOffer> offers;
     
-    // Offers indexed by asset pair for quick lookup
-    // Key: "ASSET_A:ASSET_B" (sorted alphabetically)
-    std::map<std::string, std::set<uint256>> offersByPair;
+    // Offers by trading pair, side and price
+    COrderBookIndex book;
+    COfferExpiryIndex expiry;
 
 public:
     // Add a new offer
@@ -299,10 +478,11 @@ public:
     // Clean up expired offers
     void CleanupExpired(int currentHeight);
     
-    // Get order book summary
+    // Get order book summary, best first and limited to nMaxLevels price levels per side (0 = all)
     UniValue GetOrderBookJson(
         const std::string& assetA,
-        const std::string& assetB
+        const std::string& assetB,
+        size_t nMaxLevels = 0
     ) const;
 };
 
@@ -404,7 +584,7 @@ HTLCResult RefundHTLC(
 /**
  * Parse an HTLC from a transaction output
  * 
- * @param script The scriptPubKey of the output
+ * @param script The scriptPubKey of the output, or the HTLC redeem script
  * @param htlc Output HTLC structure
  * @return true if successfully parsed as HTLC
  */
@@ -452,6 +632,7 @@ bool GetHTLCStatus(
 // Persistent Order Book with Reorg Safety
 // ============================================================================
 
+class CDBBatch;
 class CDBWrapper;
 
 /**
@@ -463,13 +644,20 @@ private:
     mutable CCriticalSection cs;
     std::unique_ptr<CDBWrapper> db;
     
+    // Mutations not yet on disk. The in-memory maps are authoritative, so
+    // nothing reads through the batch; Flush() commits it in one write.
+    std::unique_ptr<CDBBatch> batch;
+    
     // In-memory cache synchronized with disk
     std::map<uint256, CAtomicSwapOffer> offers;
-    std::map<std::string, std::set<uint256>> offersByPair;
+    COrderBookIndex book;
+    COfferExpiryIndex expiry;
     
     // UTXO tracking for reorg safety
     // Maps offer hash to the UTXO that locks it
     std::map<uint256, COutPoint> offerUTXOs;
+    // Reverse of offerUTXOs, so spent inputs are matched with one lookup each
+    std::unordered_multimap<COutPoint, uint256, SaltedOutpointHasher> offersByUTXO;
     
     // Height tracking for deterministic pruning
     int currentHeight{0};
@@ -502,10 +690,11 @@ public:
     
     // Maintenance
     void CleanupExpired(int currentHeight);
-    void Flush();
+    // Atomically write every mutation since the last flush, together with the current height
+    bool Flush();
     
     // Queries
-    UniValue GetOrderBookJson(const std::string& assetA, const std::string& assetB) const;
+    UniValue GetOrderBookJson(const std::string& assetA, const std::string& assetB, size_t nMaxLevels = 0) const;
     int GetOfferCount() const;
     int GetCurrentHeight() const { return currentHeight; }
 };
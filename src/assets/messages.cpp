@@ -113,10 +113,8 @@ bool GetMessage(const COutPoint& out, CMessage& message)
         return false;
 
     // Check database cache
-    if (pMessagesCache->Exists(out.ToSerializedString())) {
-        message = pMessagesCache->Get(out.ToSerializedString());
+    if (pMessagesCache->Get(out.ToSerializedString(), message))
         return true;
-    }
 
     // Check the database
     if (pmessagedb->ReadMessage(out, message)) {
@@ -300,33 +298,25 @@ void AddAddressSeen(const std::string &address)
 
 size_t GetMessageDirtyCacheSize()
 {
-    // COutPoint: 32 bytes
-    // CNewAsset: Max 80 bytes
-    // CAssetTransfer: Asset Name, CAmount ( 40 bytes)
-    // CReissueAsset: Max 80 bytes
-    // CAmount: 8 bytes
-    // Asset Name: Max 32 bytes
-    // Address: 40 bytes
-    // Block hash: 32 bytes
-    // CTxOut: CAmount + CScript (105 + 8 = 113 bytes)
-    // CMessage: Max 123 Bytes
-
+    // Each dirty message also owns its asset name and IPFS hash on the heap
+    static const size_t MESSAGE_STRINGS_USAGE = 2 * memusage::MallocUsage(48);
+    // A channel name or address that doesn't fit in std::string's inline buffer
+    static const size_t NAME_USAGE = memusage::MallocUsage(48);
 
     size_t size = 0;
     // Messages Caches
-    size += 32 * setDirtyMessagesRemove.size(); // COutPoint;
-    size += (32 + 123) * mapDirtyMessagesAdd.size(); // COutPoint -> CMessage
-    size += (32 + 123) * mapDirtyMessagesOrphaned.size(); // COutPoint -> CMessage
-
+    size += memusage::DynamicUsage(setDirtyMessagesRemove);
+    size += memusage::DynamicUsage(mapDirtyMessagesAdd) + MESSAGE_STRINGS_USAGE * mapDirtyMessagesAdd.size();
+    size += memusage::DynamicUsage(mapDirtyMessagesOrphaned) + MESSAGE_STRINGS_USAGE * mapDirtyMessagesOrphaned.size();
 
     // Message Channel Caches
-    size += 32 * setDirtyChannelsAdd.size();
-    size += 32 * setDirtyChannelsRemove.size();
-    size += 32 * setSubscribedChannelsAskedForFalse.size();
+    size += memusage::DynamicUsage(setDirtyChannelsAdd) + NAME_USAGE * setDirtyChannelsAdd.size();
+    size += memusage::DynamicUsage(setDirtyChannelsRemove) + NAME_USAGE * setDirtyChannelsRemove.size();
+    size += memusage::DynamicUsage(setSubscribedChannelsAskedForFalse) + NAME_USAGE * setSubscribedChannelsAskedForFalse.size();
 
     // Address Seen Caches
-    size += 32 * setDirtySeenAddressAdd.size();
-    size += 32 * setAddressAskedForFalse.size();
+    size += memusage::DynamicUsage(setDirtySeenAddressAdd) + NAME_USAGE * setDirtySeenAddressAdd.size();
+    size += memusage::DynamicUsage(setAddressAskedForFalse) + NAME_USAGE * setAddressAskedForFalse.size();
 
     return size;
 }
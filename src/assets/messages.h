@@ -9,9 +9,17 @@
 #include <uint256.h>
 #include <serialize.h>
 
+#include "assettypes.h"
+
 class CMessage;
 class COutPoint;
 
+/** Share of -dbcache given to the message and seen address read caches, and its cap */
+static const int64_t MESSAGE_DBCACHE_FRACTION = 32;
+static const int64_t MAX_MESSAGE_CACHE_USAGE = 16 << 20;
+/** Entry limit of the message read caches, far above what their byte budget holds */
+static const size_t MAX_MESSAGE_CACHE_ENTRIES = 1 << 20;
+
 // Message Database caches
 extern std::set<COutPoint> setDirtyMessagesRemove;
 extern std::map<COutPoint, CMessage> mapDirtyMessagesAdd;
@@ -123,6 +131,16 @@ public:
     }
 };
 
+/** CAssetCacheUsage extended to the heap owned by a cached CMessage */
+struct CMessageCacheUsage : public CAssetCacheUsage
+{
+    using CAssetCacheUsage::operator();
+    size_t operator()(const CMessage& message) const { return StringUsage(message.strName) + StringUsage(message.ipfsHash); }
+};
+
+typedef CShardedLRUCache<std::string, CMessage, std::hash<std::string>, CMessageCacheUsage> CMessageLRUCache;
+typedef CShardedLRUCache<std::string, int8_t> CSeenAddressLRUCache;
+
 class CZMQMessage {
 public:
     int blockHeight;
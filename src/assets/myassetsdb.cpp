@@ -9,6 +9,7 @@
 #include <boost/thread.hpp>
 
 static const char MESSAGE_FLAG = 'Z'; // Message
+static const char MESSAGE_CHANNEL_FLAG = 'H'; // Message by channel, block height and outpoint
 static const char MY_MESSAGE_CHANNEL = 'C'; // My followed Channels
 static const char MY_SEEN_ADDRESSES = 'S'; // Addresses that have been seen on the chain
 static const char DB_FLAG = 'D'; // Database Flags
@@ -16,12 +17,55 @@ static const char DB_FLAG = 'D'; // Database Flags
 static const char MY_TAGGED_ADDRESSES = 'T'; // Addresses that have been tagged
 static const char MY_RESTRICTED_ADDRESSES = 'R'; // Addresses that have been restricted
 
+static const std::string CHANNEL_INDEX_FLAG = "channelindex";
+
+namespace {
+/**
+ * Key of the per channel index. The height is stored big endian so that
+ * LevelDB orders a channel's messages by block height, then by outpoint.
+ */
+struct CMessageChannelKey
+{
+    std::string strName;
+    uint32_t nHeight;
+    COutPoint out;
+
+    CMessageChannelKey() : nHeight(0) {}
+    CMessageChannelKey(const std::string& strName, int nHeight, const COutPoint& out) : strName(strName), nHeight(nHeight < 0 ? 0 : nHeight), out(out) {}
+    explicit CMessageChannelKey(const CMessage& message) : CMessageChannelKey(message.strName, message.nBlockHeight, message.out) {}
+
+    template<typename Stream>
+    void Serialize(Stream& s) const
+    {
+        s << strName;
+        ser_writedata32be(s, nHeight);
+        s << out;
+    }
+
+    template<typename Stream>
+    void Unserialize(Stream& s)
+    {
+        s >> strName;
+        nHeight = ser_readdata32be(s);
+        s >> out;
+    }
+};
+
+void WriteMessageToBatch(CDBBatch& batch, const CMessage& message)
+{
+    batch.Write(std::make_pair(MESSAGE_FLAG, message.out), message);
+    batch.Write(std::make_pair(MESSAGE_CHANNEL_FLAG, CMessageChannelKey(message)), message);
+}
+} // namespace
+
 CMessageDB::CMessageDB(size_t nCacheSize, bool fMemory, bool fWipe) : CDBWrapper(GetDataDir() / "messages" / "messages", nCacheSize, fMemory, fWipe) {
 }
 
 bool CMessageDB::WriteMessage(const CMessage &message)
 {
-    return Write(std::make_pair(MESSAGE_FLAG, message.out), message);
+    CDBBatch batch(*this);
+    WriteMessageToBatch(batch, message);
+    return WriteBatch(batch);
 }
 
 bool CMessageDB::ReadMessage(const COutPoint &out, CMessage &message)
@@ -31,7 +75,12 @@ bool CMessageDB::ReadMessage(const COutPoint &out, CMessage &message)
 
 bool CMessageDB::EraseMessage(const COutPoint &out)
 {
-    return Erase(std::make_pair(MESSAGE_FLAG, out));
+    CDBBatch batch(*this);
+    CMessage message;
+    if (ReadMessage(out, message))
+        batch.Erase(std::make_pair(MESSAGE_CHANNEL_FLAG, CMessageChannelKey(message)));
+    batch.Erase(std::make_pair(MESSAGE_FLAG, out));
+    return WriteBatch(batch);
 }
 
 bool CMessageDB::LoadMessages(std::set<CMessage>& setMessages)
@@ -60,6 +109,73 @@ bool CMessageDB::LoadMessages(std::set<CMessage>& setMessages)
     return true;
 }
 
+bool CMessageDB::LoadChannelMessages(const std::string& channel, std::vector<CMessage>& vMessages, int nStartHeight, size_t nMaxCount)
+{
+    std::unique_ptr<CDBIterator> pcursor(NewIterator());
+
+    pcursor->Seek(std::make_pair(MESSAGE_CHANNEL_FLAG, CMessageChannelKey(channel, nStartHeight, COutPoint())));
+
+    // Only this channel's keys are visited, in block height order
+    while (pcursor->Valid() && (nMaxCount == 0 || vMessages.size() < nMaxCount)) {
+        boost::this_thread::interruption_point();
+        std::pair<char, CMessageChannelKey> key;
+        if (pcursor->GetKey(key) && key.first == MESSAGE_CHANNEL_FLAG && key.second.strName == channel) {
+            CMessage message;
+            if (pcursor->GetValue(message)) {
+                vMessages.push_back(message);
+            } else {
+                LogPrintf("%s: failed to read message\n", __func__);
+            }
+            pcursor->Next();
+        } else {
+            break;
+        }
+    }
+    return true;
+}
+
+bool CMessageDB::EraseChannelMessages(const std::string& channel, int nBeforeHeight, int& count)
+{
+    CDBBatch batch(*this);
+    std::unique_ptr<CDBIterator> pcursor(NewIterator());
+
+    pcursor->Seek(std::make_pair(MESSAGE_CHANNEL_FLAG, CMessageChannelKey(channel, 0, COutPoint())));
+
+    while (pcursor->Valid()) {
+        boost::this_thread::interruption_point();
+        std::pair<char, CMessageChannelKey> key;
+        if (pcursor->GetKey(key) && key.first == MESSAGE_CHANNEL_FLAG && key.second.strName == channel && (int)key.second.nHeight < nBeforeHeight) {
+            batch.Erase(key);
+            batch.Erase(std::make_pair(MESSAGE_FLAG, key.second.out));
+            count++;
+            pcursor->Next();
+        } else {
+            break;
+        }
+    }
+    return WriteBatch(batch);
+}
+
+bool CMessageDB::BuildChannelIndex()
+{
+    bool fIndexed = false;
+    if (ReadFlag(CHANNEL_INDEX_FLAG, fIndexed) && fIndexed)
+        return true;
+
+    // Databases written before the channel index existed only have the outpoint keys
+    std::set<CMessage> setMessages;
+    if (!LoadMessages(setMessages))
+        return false;
+
+    LogPrintf("%s: indexing %u messages by channel\n", __func__, setMessages.size());
+
+    CDBBatch batch(*this);
+    for (const auto& message : setMessages)
+        batch.Write(std::make_pair(MESSAGE_CHANNEL_FLAG, CMessageChannelKey(message)), message);
+    batch.Write(std::make_pair(DB_FLAG, CHANNEL_INDEX_FLAG), '1');
+    return WriteBatch(batch, true);
+}
+
 bool CMessageDB::EraseAllMessages(int& count)
 {
     std::set<CMessage> setMessages;
@@ -94,24 +210,39 @@ bool CMessageDB::EraseAllMessages(int& count)
 
 bool CMessageDB::Flush() {
     try {
+        // Every dirty change goes to disk in a single write
+        CDBBatch batch(*this);
 
         for (auto messageRemove : setDirtyMessagesRemove) {
-            if (!EraseMessage(messageRemove))
-                return error("%s: failed to erase message %s", __func__, messageRemove.ToString());
+            CMessage message;
+            if (ReadMessage(messageRemove, message))
+                batch.Erase(std::make_pair(MESSAGE_CHANNEL_FLAG, CMessageChannelKey(message)));
+            batch.Erase(std::make_pair(MESSAGE_FLAG, messageRemove));
         }
 
         for (auto messageAdd : mapDirtyMessagesAdd) {
-            if (!WriteMessage(messageAdd.second))
-                return error("%s: failed to write message %s", __func__, messageAdd.second.ToString());
-
+            WriteMessageToBatch(batch, messageAdd.second);
             mapDirtyMessagesOrphaned.erase(messageAdd.first);
         }
 
-        for (auto orphans : mapDirtyMessagesOrphaned) {
-            CMessage msg = orphans.second;
-            msg.status = MessageStatus::ORPHAN;
-            if (!WriteMessage(msg))
-                return error("%s: failed to write message orphan %s", __func__, msg.ToString());
+        for (auto& orphans : mapDirtyMessagesOrphaned) {
+            orphans.second.status = MessageStatus::ORPHAN;
+            WriteMessageToBatch(batch, orphans.second);
+        }
+
+        LogPrintf("%s: Flushing messagesdb removeSize:%u, addSize:%u, orphanSize:%u (%u bytes)\n", __func__, setDirtyMessagesRemove.size(), mapDirtyMessagesAdd.size(), mapDirtyMessagesOrphaned.size(), batch.SizeEstimate());
+
+        if (!WriteBatch(batch))
+            return error("%s: failed to write the message batch", __func__);
+
+        // The flushed messages stay readable from memory as clean entries
+        if (pMessagesCache) {
+            for (auto messageRemove : setDirtyMessagesRemove)
+                pMessagesCache->Erase(messageRemove.ToSerializedString());
+            for (auto messageAdd : mapDirtyMessagesAdd)
+                pMessagesCache->Put(messageAdd.first.ToSerializedString(), messageAdd.second);
+            for (auto orphans : mapDirtyMessagesOrphaned)
+                pMessagesCache->Put(orphans.first.ToSerializedString(), orphans.second);
         }
 
         setDirtyMessagesRemove.clear();
@@ -212,19 +343,29 @@ bool CMessageChannelDB::Flush() {
     try {
         LogPrintf("%s: Flushing messagechannelsdb addSize:%u, removeSize:%u, seenAddressSize:%u\n", __func__, setDirtyChannelsAdd.size(), setDirtyChannelsRemove.size(), setDirtySeenAddressAdd.size());
 
-        for (auto channelRemove : setDirtyChannelsRemove) {
-            if (!EraseMyMessageChannel(channelRemove))
-                return error("%s: failed to erase messagechannel %s", __func__, channelRemove);
-        }
+        CDBBatch batch(*this);
 
-        for (auto channelAdd : setDirtyChannelsAdd) {
-            if (!WriteMyMessageChannel(channelAdd))
-                return error("%s: failed to write messagechannel %s", __func__, channelAdd);
-        }
+        for (auto channelRemove : setDirtyChannelsRemove)
+            batch.Erase(std::make_pair(MY_MESSAGE_CHANNEL, channelRemove));
+
+        for (auto channelAdd : setDirtyChannelsAdd)
+            batch.Write(std::make_pair(MY_MESSAGE_CHANNEL, channelAdd), 1);
 
-        for (auto seenAddress : setDirtySeenAddressAdd) {
-            if (!WriteUsedAddress(seenAddress))
-                return error("%s: failed to write seenaddress %s", __func__, seenAddress);
+        for (auto seenAddress : setDirtySeenAddressAdd)
+            batch.Write(std::make_pair(MY_SEEN_ADDRESSES, seenAddress), 1);
+
+        if (!WriteBatch(batch))
+            return error("%s: failed to write the message channel batch", __func__);
+
+        if (pMessageSubscribedChannelsCache) {
+            for (auto channelRemove : setDirtyChannelsRemove)
+                pMessageSubscribedChannelsCache->Erase(channelRemove);
+            for (auto channelAdd : setDirtyChannelsAdd)
+                pMessageSubscribedChannelsCache->Put(channelAdd, 1);
+        }
+        if (pMessagesSeenAddressCache) {
+            for (auto seenAddress : setDirtySeenAddressAdd)
+                pMessagesSeenAddressCache->Put(seenAddress, 1);
         }
 
         setDirtyChannelsRemove.clear();
@@ -7,6 +7,8 @@
 
 #include <dbwrapper.h>
 
+#include <vector>
+
 class CMessage;
 class COutPoint;
 
@@ -25,6 +27,11 @@ public:
     bool LoadMessages(std::set<CMessage>& setMessages);
     bool EraseAllMessages(int& count);
 
+    // Per channel index of messages ordered by block height
+    bool LoadChannelMessages(const std::string& channel, std::vector<CMessage>& vMessages, int nStartHeight = 0, size_t nMaxCount = 0);
+    bool EraseChannelMessages(const std::string& channel, int nBeforeHeight, int& count);
+    bool BuildChannelIndex();
+
     // Write / Read Database flags
     bool WriteFlag(const std::string &name, bool fValue);
     bool ReadFlag(const std::string &name, bool &fValue);
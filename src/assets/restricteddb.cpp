@@ -3,10 +3,14 @@
 // file COPYING or http://www.opensource.org/licenses/mit-license.php.
 
 #include "restricteddb.h"
+#include "hash.h"
+#include "random.h"
 #include "validation.h"
 
 #include <boost/thread.hpp>
 
+#include <limits>
+
 static const char DB_FLAG = 'D';
 static const char VERIFIER_FLAG = 'V';
 static const char ADDRESS_QULAIFIER_FLAG = 'T';
@@ -16,9 +20,149 @@ static const char GLOBAL_RESTRICTION_FLAG = 'G';
 
 
 
+CRestrictedPrefilter::CRestrictedPrefilter() : k0(GetRand(std::numeric_limits<uint64_t>::max())), k1(GetRand(std::numeric_limits<uint64_t>::max()))
+{
+}
+
+uint64_t CRestrictedPrefilter::Hash(const std::string& a, const std::string& b) const
+{
+    return CSipHasher(k0, k1).Write(a.size()).Write((const unsigned char*)a.data(), a.size()).Write((const unsigned char*)b.data(), b.size()).Finalize();
+}
+
+void CRestrictedPrefilter::Reset(size_t nKeys)
+{
+    std::lock_guard<std::mutex> lock(cs);
+    nCapacity = std::max(nKeys, (size_t)MIN_CAPACITY);
+    nInserted = 0;
+    fEnabled = false;
+    vBits.assign((nCapacity * BITS_PER_KEY + 63) / 64, 0);
+}
+
+void CRestrictedPrefilter::Enable()
+{
+    std::lock_guard<std::mutex> lock(cs);
+    fEnabled = true;
+}
+
+bool CRestrictedPrefilter::Insert(const std::string& a, const std::string& b)
+{
+    uint64_t nHash = Hash(a, b);
+    std::lock_guard<std::mutex> lock(cs);
+    if (vBits.empty())
+        return true;
+
+    // Double hashing over the two halves of one SipHash
+    uint64_t nBits = vBits.size() * 64;
+    uint32_t h1 = nHash, h2 = nHash >> 32;
+    for (int i = 0; i < NUM_HASHES; i++) {
+        uint64_t nBit = (h1 + (uint64_t)i * h2) % nBits;
+        vBits[nBit >> 6] |= (uint64_t)1 << (nBit & 63);
+    }
+    return ++nInserted <= nCapacity;
+}
+
+bool CRestrictedPrefilter::MayContain(const std::string& a, const std::string& b) const
+{
+    uint64_t nHash = Hash(a, b);
+    std::lock_guard<std::mutex> lock(cs);
+    if (!fEnabled)
+        return true;
+
+    uint64_t nBits = vBits.size() * 64;
+    uint32_t h1 = nHash, h2 = nHash >> 32;
+    for (int i = 0; i < NUM_HASHES; i++) {
+        uint64_t nBit = (h1 + (uint64_t)i * h2) % nBits;
+        if (!(vBits[nBit >> 6] & ((uint64_t)1 << (nBit & 63))))
+            return false;
+    }
+    return true;
+}
+
+size_t CRestrictedPrefilter::Inserted() const
+{
+    std::lock_guard<std::mutex> lock(cs);
+    return nInserted;
+}
+
 CRestrictedDB::CRestrictedDB(size_t nCacheSize, bool fMemory, bool fWipe) : CDBWrapper(GetDataDir() / "assets" / "restricted", nCacheSize, fMemory, fWipe) {
 }
 
+void CRestrictedDB::InsertAddressQualifierKeys(const std::string& address, const std::string& tag)
+{
+    // CheckForAddressRootQualifier matches #ROOT against #ROOT/#SUB, so every root is a key too
+    bool fFull = false;
+    for (size_t pos = tag.find('/'); pos != std::string::npos; pos = tag.find('/', pos + 1)) {
+        fFull |= !qualifierFilter.Insert(address, tag.substr(0, pos));
+    }
+    fFull |= !qualifierFilter.Insert(address, tag);
+    if (fFull) {
+        // The rebuild only sees what is already written
+        RebuildQualifierFilter();
+        InsertAddressQualifierKeys(address, tag);
+    }
+}
+
+void CRestrictedDB::RebuildQualifierFilter()
+{
+    // Size for twice what is there now, so growth doesn't rebuild every few writes
+    qualifierFilter.Reset(2 * qualifierFilter.Inserted());
+
+    std::unique_ptr<CDBIterator> pcursor(NewIterator());
+    pcursor->Seek(std::make_pair(ADDRESS_QULAIFIER_FLAG, std::make_pair(std::string(), std::string())));
+    while (pcursor->Valid()) {
+        std::pair<char, std::pair<std::string, std::string> > key;
+        if (!pcursor->GetKey(key) || key.first != ADDRESS_QULAIFIER_FLAG)
+            break;
+        const std::string& tag = key.second.second;
+        for (size_t pos = tag.find('/'); pos != std::string::npos; pos = tag.find('/', pos + 1))
+            qualifierFilter.Insert(key.second.first, tag.substr(0, pos));
+        qualifierFilter.Insert(key.second.first, tag);
+        pcursor->Next();
+    }
+    qualifierFilter.Enable();
+}
+
+void CRestrictedDB::RebuildRestrictionFilter()
+{
+    restrictionFilter.Reset(2 * restrictionFilter.Inserted());
+
+    std::unique_ptr<CDBIterator> pcursor(NewIterator());
+    pcursor->Seek(std::make_pair(RESTRICTED_ADDRESS_FLAG, std::make_pair(std::string(), std::string())));
+    while (pcursor->Valid()) {
+        std::pair<char, std::pair<std::string, std::string> > key;
+        if (!pcursor->GetKey(key) || key.first != RESTRICTED_ADDRESS_FLAG)
+            break;
+        restrictionFilter.Insert(key.second.first, key.second.second);
+        pcursor->Next();
+    }
+    restrictionFilter.Enable();
+}
+
+void CRestrictedDB::RebuildGlobalFilter()
+{
+    globalFilter.Reset(2 * globalFilter.Inserted());
+
+    std::unique_ptr<CDBIterator> pcursor(NewIterator());
+    pcursor->Seek(std::make_pair(GLOBAL_RESTRICTION_FLAG, std::string()));
+    while (pcursor->Valid()) {
+        std::pair<char, std::string> key;
+        if (!pcursor->GetKey(key) || key.first != GLOBAL_RESTRICTION_FLAG)
+            break;
+        globalFilter.Insert(key.second);
+        pcursor->Next();
+    }
+    globalFilter.Enable();
+}
+
+void CRestrictedDB::LoadPrefilters()
+{
+    RebuildQualifierFilter();
+    RebuildRestrictionFilter();
+    RebuildGlobalFilter();
+    LogPrintf("%s: %u qualifier, %u restriction and %u global restriction keys\n", __func__,
+              qualifierFilter.Inserted(), restrictionFilter.Inserted(), globalFilter.Inserted());
+}
+
 // Restricted Verifier Strings
 bool CRestrictedDB::WriteVerifier(const std::string& assetName, const std::string& verifier)
 {
@@ -38,12 +182,15 @@ bool CRestrictedDB::EraseVerifier(const std::string& assetName)
 // Address Tags
 bool CRestrictedDB::WriteAddressQualifier(const std::string &address, const std::string &tag)
 {
+    InsertAddressQualifierKeys(address, tag);
     int8_t i = 1;
     return Write(std::make_pair(ADDRESS_QULAIFIER_FLAG, std::make_pair(address, tag)), i);
 }
 
 bool CRestrictedDB::ReadAddressQualifier(const std::string &address, const std::string &tag)
 {
+    if (!qualifierFilter.MayContain(address, tag))
+        return false;
     int8_t i;
     return Read(std::make_pair(ADDRESS_QULAIFIER_FLAG, std::make_pair(address, tag)), i);
 }
@@ -75,12 +222,18 @@ bool CRestrictedDB::EraseQualifierAddress(const std::string &address, const std:
 // Address Restriction
 bool CRestrictedDB::WriteRestrictedAddress(const std::string& address, const std::string& assetName)
 {
+    if (!restrictionFilter.Insert(address, assetName)) {
+        RebuildRestrictionFilter();
+        restrictionFilter.Insert(address, assetName);
+    }
     int8_t i = 1;
     return Write(std::make_pair(RESTRICTED_ADDRESS_FLAG, std::make_pair(address, assetName)), i);
 }
 
 bool CRestrictedDB::ReadRestrictedAddress(const std::string& address, const std::string& assetName)
 {
+    if (!restrictionFilter.MayContain(address, assetName))
+        return false;
     int8_t i;
     return Read(std::make_pair(RESTRICTED_ADDRESS_FLAG, std::make_pair(address, assetName)), i);
 }
@@ -93,12 +246,18 @@ bool CRestrictedDB::EraseRestrictedAddress(const std::string& address, const std
 // Global Restriction
 bool CRestrictedDB::WriteGlobalRestriction(const std::string& assetName)
 {
+    if (!globalFilter.Insert(assetName)) {
+        RebuildGlobalFilter();
+        globalFilter.Insert(assetName);
+    }
     int8_t i = 1;
     return Write(std::make_pair(GLOBAL_RESTRICTION_FLAG, assetName), i);
 }
 
 bool CRestrictedDB::ReadGlobalRestriction(const std::string& assetName)
 {
+    if (!globalFilter.MayContain(assetName))
+        return false;
     int8_t i;
     return Read(std::make_pair(GLOBAL_RESTRICTION_FLAG, assetName), i);
 }
@@ -147,6 +306,9 @@ bool CRestrictedDB::GetQualifierAddresses(std::string& qualifier, std::vector<st
 
 bool CRestrictedDB::CheckForAddressRootQualifier(const std::string& address, const std::string& qualifier)
 {
+    if (!qualifierFilter.MayContain(address, qualifier))
+        return false;
+
     std::unique_ptr<CDBIterator> pcursor(NewIterator());
 
     pcursor->Seek(std::make_pair(ADDRESS_QULAIFIER_FLAG, std::make_pair(address, qualifier)));
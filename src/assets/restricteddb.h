@@ -8,8 +8,59 @@
 
 #include <dbwrapper.h>
 
+#include <mutex>
+#include <string>
+#include <vector>
+
+/**
+ * Bloom filter over the keys of one kind of restricted database entry.
+ *
+ * Keys are inserted before they are written and are never taken out, so a
+ * negative answer means the key is not in the database. Erased keys only cost
+ * a wasted read until the next rebuild. Until Enable() is called every lookup
+ * answers maybe.
+ */
+class CRestrictedPrefilter
+{
+    static const size_t MIN_CAPACITY = 1 << 16;
+    static const int NUM_HASHES = 7;
+    static const int BITS_PER_KEY = 10;
+
+    mutable std::mutex cs;
+    std::vector<uint64_t> vBits;
+    size_t nCapacity{0};
+    size_t nInserted{0};
+    bool fEnabled{false};
+    uint64_t k0, k1;
+
+    uint64_t Hash(const std::string& a, const std::string& b) const;
+
+public:
+    CRestrictedPrefilter();
+
+    //! Empty the filter and size it for nKeys, passing lookups through until Enable()
+    void Reset(size_t nKeys);
+    void Enable();
+
+    //! Returns false once the filter holds more keys than it was sized for and should be rebuilt
+    bool Insert(const std::string& a, const std::string& b = std::string());
+    bool MayContain(const std::string& a, const std::string& b = std::string()) const;
+
+    size_t Inserted() const;
+};
+
 class CRestrictedDB  : public CDBWrapper {
 
+    // Address qualifiers, also keyed by every root of a sub qualifier; address restrictions; global restrictions
+    CRestrictedPrefilter qualifierFilter;
+    CRestrictedPrefilter restrictionFilter;
+    CRestrictedPrefilter globalFilter;
+
+    void InsertAddressQualifierKeys(const std::string& address, const std::string& tag);
+    void RebuildQualifierFilter();
+    void RebuildRestrictionFilter();
+    void RebuildGlobalFilter();
+
 public:
     explicit CRestrictedDB(size_t nCacheSize, bool fMemory = false, bool fWipe = false);
 
@@ -52,6 +103,9 @@ public:
 
     bool CheckForAddressRootQualifier(const std::string& address, const std::string& qualifier);
 
+    //! Build the lookup prefilters from the database; lookups go to the database until this has run
+    void LoadPrefilters();
+
     bool Flush();
 };
 
@@ -15,10 +15,14 @@
 #include <consensus/validation.h>
 #include <wallet/coincontrol.h>
 #include <utilmoneystr.h>
+#include <script/sign.h>
 #include "assets/rewards.h"
 #include "assetsnapshotdb.h"
 #include "wallet/wallet.h"
 
+#include <mutex>
+#include <thread>
+
 std::map<uint256, CRewardSnapshot> mapRewardSnapshots;
 
 uint256 CRewardSnapshot::GetHash() const
@@ -41,10 +45,25 @@ bool AddDistributeRewardSnapshot(CRewardSnapshot& p_rewardSnapshot)
     return true;
 }
 
-bool GenerateDistributionList(const CRewardSnapshot& p_rewardSnapshot, std::vector<OwnerAndAmount>& vecDistributionList)
+CDistributionStream::CDistributionStream(const CRewardSnapshot& p_rewardSnapshot, size_t p_nChunkSize)
+    : rewardSnapshot(p_rewardSnapshot), nChunkSize(p_nChunkSize), modifiedPaymentInAssetUnits(0),
+      distributionUnitDivisor(1), totalAmtOwned(0), totalSentAsRewards(0), nOwners(0), nOwnersProcessed(0), fDone(false)
 {
-    vecDistributionList.clear();
+}
 
+CDistributionStream::~CDistributionStream()
+{
+}
+
+bool CDistributionStream::IsPayable(const std::string& p_address) const
+{
+    //  Ignore exception and burn addresses
+    return exceptionAddressSet.find(p_address) == exceptionAddressSet.end()
+        && !GetParams().IsBurnAddress(p_address);
+}
+
+bool CDistributionStream::Init()
+{
     if (passets == nullptr) {
         LogPrint(BCLog::REWARDS, "%s: Invalid assets cache!\n", __func__);
         return false;
@@ -60,82 +79,70 @@ bool GenerateDistributionList(const CRewardSnapshot& p_rewardSnapshot, std::vect
 
     //  Get details on the specified source asset
     CNewAsset distributionAsset;
-    UNUSED_VAR bool srcIsIndivisible = false;
     CAmount srcUnitDivisor = COIN;  //  Default to divisor for RVN
     const int8_t COIN_DIGITS_PAST_DECIMAL = 8;
 
     //  This value is in indivisible units of the source asset
-    CAmount modifiedPaymentInAssetUnits = p_rewardSnapshot.nDistributionAmount;
+    modifiedPaymentInAssetUnits = rewardSnapshot.nDistributionAmount;
 
-    if (p_rewardSnapshot.strDistributionAsset != "RVN") {
-        if (!passets->GetAssetMetaDataIfExists(p_rewardSnapshot.strDistributionAsset, distributionAsset)) {
-            LogPrint(BCLog::REWARDS, "%s: Failed to retrieve asset details for '%s'\n", __func__, p_rewardSnapshot.strDistributionAsset.c_str());
+    if (rewardSnapshot.strDistributionAsset != "RVN") {
+        if (!passets->GetAssetMetaDataIfExists(rewardSnapshot.strDistributionAsset, distributionAsset)) {
+            LogPrint(BCLog::REWARDS, "%s: Failed to retrieve asset details for '%s'\n", __func__, rewardSnapshot.strDistributionAsset.c_str());
             return false;
         }
 
-        //  If the token is indivisible, signal this to later code with a zero divisor
-        if (distributionAsset.units == 0) {
-            srcIsIndivisible = true;
-        }
-
         srcUnitDivisor = static_cast<CAmount>(pow(10, distributionAsset.units));
 
         CAmount srcDivisor = pow(10, COIN_DIGITS_PAST_DECIMAL - distributionAsset.units);
         modifiedPaymentInAssetUnits /= srcDivisor;
 
         LogPrint(BCLog::REWARDS, "%s: Distribution asset '%s' has units %d and divisor %d\n", __func__,
-                 p_rewardSnapshot.strDistributionAsset.c_str(), distributionAsset.units, srcUnitDivisor);
+                 rewardSnapshot.strDistributionAsset.c_str(), distributionAsset.units, srcUnitDivisor);
     }
     else {
         LogPrint(BCLog::REWARDS, "%s: Distribution is RVN with divisor %d\n", __func__, srcUnitDivisor);
     }
 
+    //  Rewards are rounded down to the precision of the distribution asset
+    distributionUnitDivisor = static_cast<CAmount>(pow(10, COIN_DIGITS_PAST_DECIMAL - distributionAsset.units));
+
     LogPrint(BCLog::REWARDS, "%s: Scaled payment amount in %s is %d\n", __func__,
-             p_rewardSnapshot.strDistributionAsset.c_str(), modifiedPaymentInAssetUnits);
+             rewardSnapshot.strDistributionAsset.c_str(), modifiedPaymentInAssetUnits);
 
     //  Get details on the ownership asset
     CNewAsset ownershipAsset;
-    CAmount tgtUnitDivisor = 0;
-    if (!passets->GetAssetMetaDataIfExists(p_rewardSnapshot.strOwnershipAsset, ownershipAsset)) {
-        LogPrint(BCLog::REWARDS, "%s: Failed to retrieve asset details for '%s'\n", __func__, p_rewardSnapshot.strOwnershipAsset.c_str());
+    if (!passets->GetAssetMetaDataIfExists(rewardSnapshot.strOwnershipAsset, ownershipAsset)) {
+        LogPrint(BCLog::REWARDS, "%s: Failed to retrieve asset details for '%s'\n", __func__, rewardSnapshot.strOwnershipAsset.c_str());
         return false;
     }
 
-    //  Save the ownership asset's divisor
-    tgtUnitDivisor = static_cast<CAmount>(pow(10, COIN_DIGITS_PAST_DECIMAL - ownershipAsset.units));
-
     LogPrint(BCLog::REWARDS, "%s: Ownership asset '%s' has units %d and divisor %d\n", __func__,
-             p_rewardSnapshot.strOwnershipAsset.c_str(), ownershipAsset.units, tgtUnitDivisor);
+             rewardSnapshot.strOwnershipAsset.c_str(), ownershipAsset.units,
+             static_cast<CAmount>(pow(10, COIN_DIGITS_PAST_DECIMAL - ownershipAsset.units)));
 
     //  Remove exception addresses & amounts from the list
-    std::set<std::string> exceptionAddressSet;
-    boost::split(exceptionAddressSet, p_rewardSnapshot.strExceptionAddresses, boost::is_any_of(ADDRESS_COMMA_DELIMITER));
+    boost::split(exceptionAddressSet, rewardSnapshot.strExceptionAddresses, boost::is_any_of(ADDRESS_COMMA_DELIMITER));
 
-    std::set<OwnerAndAmount> nonExceptionOwnerships;
-    CAmount totalAmtOwned = 0;
-
-    CAssetSnapshotDBEntry snapshotEntry;
-    if (!pAssetSnapshotDb->RetrieveOwnershipSnapshot(p_rewardSnapshot.strOwnershipAsset, p_rewardSnapshot.nHeight, snapshotEntry)) {
+    pReader.reset(new CAssetSnapshotReader(*pAssetSnapshotDb, rewardSnapshot.strOwnershipAsset, rewardSnapshot.nHeight));
+    if (!pReader->Found()) {
         LogPrint(BCLog::REWARDS, "%s: Failed to retrieve ownership snapshot list!\n", __func__);
         return false;
     }
 
-    for (auto const & currPair : snapshotEntry.ownersAndAmounts) {
-        //  Ignore exception and burn addresses
-        if (
-                exceptionAddressSet.find(currPair.first) == exceptionAddressSet.end()
-                && !GetParams().IsBurnAddress(currPair.first)
-                ) {
-            //  Address is valid so add it to the payment list
-            nonExceptionOwnerships.insert(OwnerAndAmount(currPair.first, currPair.second));
+    //  First pass: the shares are relative to everything the payable owners hold
+    std::pair<std::string, CAmount> currPair;
+    while (pReader->Next(currPair)) {
+        if (IsPayable(currPair.first)) {
             totalAmtOwned += currPair.second;
+            nOwners++;
         }
     }
+    pReader->Rewind();
 
     //  Make sure we have some addresses to pay to
-    if (nonExceptionOwnerships.size() == 0) {
+    if (nOwners == 0) {
         LogPrint(BCLog::REWARDS, "%s: Ownership of '%s' includes only exception/burn addresses.\n", __func__,
-                 p_rewardSnapshot.strOwnershipAsset.c_str());
+                 rewardSnapshot.strOwnershipAsset.c_str());
         return false;
     }
 
@@ -145,39 +152,202 @@ bool GenerateDistributionList(const CRewardSnapshot& p_rewardSnapshot, std::vect
     LogPrint(BCLog::REWARDS, "%s: Total payout amount %d\n", __func__,
              modifiedPaymentInAssetUnits);
 
-    CAmount totalSentAsRewards = 0;
-    //  Loop through asset owners
-    for (auto & ownership : nonExceptionOwnerships) {
+    return true;
+}
+
+bool CDistributionStream::NextChunk(std::vector<OwnerAndAmount>& p_vecChunk)
+{
+    p_vecChunk.clear();
+    if (!pReader || fDone)
+        return false;
+
+    std::pair<std::string, CAmount> ownership;
+    while (p_vecChunk.size() < nChunkSize) {
+        if (!pReader->Next(ownership)) {
+            fDone = true;
+            CAmount change = totalAmtOwned - totalSentAsRewards;
+            if (change > 0) {
+                LogPrint(BCLog::REWARDS, "%s: Found change amount of %u\n", __func__, change);
+            }
+            break;
+        }
+        if (!IsPayable(ownership.first))
+            continue;
+        nOwnersProcessed++;
+
         // Get percentage of total ownership
-        long double percent = (long double)ownership.amount / (long double)totalAmtOwned;
+        long double percent = (long double)ownership.second / (long double)totalAmtOwned;
         // Caculate the reward with potentional unit inaccurancies e.g with units 4, 90054100 satoshis = 0.90054100
-        CAmount rewardAmt = percent * modifiedPaymentInAssetUnits * static_cast<CAmount>(pow(10, COIN_DIGITS_PAST_DECIMAL - distributionAsset.units));
+        CAmount rewardAmt = percent * modifiedPaymentInAssetUnits * distributionUnitDivisor;
         // Remove all none accurate units e.g with units 4 90054100 => 9005
-        rewardAmt /= static_cast<CAmount>(pow(10, COIN_DIGITS_PAST_DECIMAL - distributionAsset.units));
+        rewardAmt /= distributionUnitDivisor;
         // Replace all none accurate units back with zeros e.g with units 4 9005 => 90050000 satoshis = 0.90050000
-        rewardAmt *= static_cast<CAmount>(pow(10, COIN_DIGITS_PAST_DECIMAL - distributionAsset.units));
+        rewardAmt *= distributionUnitDivisor;
 
         totalSentAsRewards += rewardAmt;
 
         LogPrint(BCLog::REWARDS, "%s: Found ownership address for '%s': '%s' owns %d => reward %d\n", __func__,
-                 p_rewardSnapshot.strOwnershipAsset.c_str(), ownership.address.c_str(),
-                 ownership.amount, rewardAmt);
+                 rewardSnapshot.strOwnershipAsset.c_str(), ownership.first.c_str(),
+                 ownership.second, rewardAmt);
 
         //  Save it into our list if the reward payment is above zero
         if (rewardAmt > 0)
-            vecDistributionList.push_back(OwnerAndAmount(ownership.address, rewardAmt));
+            p_vecChunk.push_back(OwnerAndAmount(ownership.first, rewardAmt));
     }
 
-    CAmount change = totalAmtOwned - totalSentAsRewards;
-    if (change > 0) {
-        LogPrint(BCLog::REWARDS, "%s: Found change amount of %u\n", __func__, change);
-    }
+    return !p_vecChunk.empty();
+}
+
+static std::mutex csDistributionProgress;
+static std::map<uint256, CDistributionProgress> mapDistributionProgress;
+
+#ifdef ENABLE_WALLET
+static void SetDistributionProgress(const uint256& p_hash, const CDistributionProgress& p_progress)
+{
+    std::lock_guard<std::mutex> lock(csDistributionProgress);
+    mapDistributionProgress[p_hash] = p_progress;
+}
+#endif //ENABLE_WALLET
+
+bool GetDistributionProgress(const uint256& p_hash, CDistributionProgress& p_progress)
+{
+    std::lock_guard<std::mutex> lock(csDistributionProgress);
+    auto it = mapDistributionProgress.find(p_hash);
+    if (it == mapDistributionProgress.end())
+        return false;
+    p_progress = it->second;
+    return true;
+}
+
+bool GenerateDistributionList(const CRewardSnapshot& p_rewardSnapshot, std::vector<OwnerAndAmount>& vecDistributionList)
+{
+    vecDistributionList.clear();
+
+    CDistributionStream stream(p_rewardSnapshot);
+    if (!stream.Init())
+        return false;
+
+    std::vector<OwnerAndAmount> vecChunk;
+    while (stream.NextChunk(vecChunk))
+        vecDistributionList.insert(vecDistributionList.end(), vecChunk.begin(), vecChunk.end());
 
     return true;
 }
 
 #ifdef ENABLE_WALLET
 
+namespace {
+//  A reward transaction built without signatures, with its inputs locked until it is committed
+struct CPendingRewardTx
+{
+    int nBatch;
+    std::shared_ptr<CWalletTx> txnPtr;
+    std::shared_ptr<CReserveKey> reserveKeyPtr;
+    CMutableTransaction mtx;
+    //  Script and amount of the coin spent by each input
+    std::vector<std::pair<CScript, CAmount>> vSpent;
+    bool fSigned = false;
+};
+
+bool LockRewardTransactionInputs(CWallet * p_wallet, CPendingRewardTx& p_pending, CAmount& p_lockedAmount)
+{
+    LOCK(p_wallet->cs_wallet);
+    p_pending.mtx = CMutableTransaction(*p_pending.txnPtr->tx);
+    for (const auto& input : p_pending.mtx.vin) {
+        const CWalletTx* prev = p_wallet->GetWalletTx(input.prevout.hash);
+        if (!prev || input.prevout.n >= prev->tx->vout.size())
+            return false;
+        const CTxOut& spent = prev->tx->vout[input.prevout.n];
+        p_pending.vSpent.emplace_back(spent.scriptPubKey, spent.nValue);
+    }
+    for (const auto& input : p_pending.mtx.vin) {
+        p_wallet->LockCoin(input.prevout);
+    }
+    for (const auto& spent : p_pending.vSpent) {
+        p_lockedAmount += spent.second;
+    }
+    return true;
+}
+
+//  The key store locks itself, so the transactions are signed without cs_wallet
+void SignRewardTransaction(CWallet * p_wallet, CPendingRewardTx& p_pending)
+{
+    CTransaction txConst(p_pending.mtx);
+    for (unsigned int nIn = 0; nIn < p_pending.vSpent.size(); nIn++) {
+        SignatureData sigdata;
+        if (!ProduceSignature(TransactionSignatureCreator(p_wallet, &txConst, nIn, p_pending.vSpent[nIn].second, SIGHASH_ALL), p_pending.vSpent[nIn].first, sigdata))
+            return;
+        UpdateTransaction(p_pending.mtx, nIn, sigdata);
+    }
+    p_pending.fSigned = true;
+}
+
+void SignRewardTransactions(CWallet * p_wallet, std::vector<CPendingRewardTx>& p_vecPending)
+{
+    size_t nThreads = std::min<size_t>(std::max(1, GetNumCores()), p_vecPending.size());
+    if (nThreads <= 1) {
+        for (auto& pending : p_vecPending)
+            SignRewardTransaction(p_wallet, pending);
+        return;
+    }
+
+    auto signRange = [p_wallet, &p_vecPending, nThreads](size_t nThread) {
+        for (size_t i = nThread; i < p_vecPending.size(); i += nThreads)
+            SignRewardTransaction(p_wallet, p_vecPending[i]);
+    };
+    std::vector<std::thread> threads;
+    threads.reserve(nThreads - 1);
+    for (size_t t = 1; t < nThreads; t++) {
+        threads.emplace_back(signRange, t);
+    }
+    signRange(0);
+    for (auto& thread : threads) {
+        thread.join();
+    }
+}
+
+//  Commit the signed transactions in batch order, stopping at the first failure
+bool CommitRewardTransactions(CWallet * p_wallet, const CRewardSnapshot& p_rewardSnapshot,
+        std::vector<CPendingRewardTx>& p_vecPending, CDistributionProgress& p_progress)
+{
+    auto rewardSnapshotHash = p_rewardSnapshot.GetHash();
+
+    SignRewardTransactions(p_wallet, p_vecPending);
+
+    {
+        LOCK(p_wallet->cs_wallet);
+        for (const auto& pending : p_vecPending) {
+            for (const auto& input : pending.mtx.vin)
+                p_wallet->UnlockCoin(input.prevout);
+        }
+    }
+
+    bool fSucceeded = true;
+    for (auto& pending : p_vecPending) {
+        if (!pending.fSigned) {
+            mapRewardSnapshots[rewardSnapshotHash].nStatus = CRewardSnapshot::FAILED_CREATE_TRANSACTION;
+            pDistributeSnapshotDb->OverrideDistributeSnapshot(rewardSnapshotHash, mapRewardSnapshots.at(rewardSnapshotHash));
+            LogPrint(BCLog::REWARDS, "Failed to sign Tx: distribute: %s, batch: %d\n", p_rewardSnapshot.strDistributionAsset, pending.nBatch);
+            fSucceeded = false;
+            break;
+        }
+
+        pending.txnPtr->SetTx(MakeTransactionRef(std::move(pending.mtx)));
+        uint256 retTxid;
+        if (!CommitRewardTransaction(p_wallet, p_rewardSnapshot, *pending.txnPtr, *pending.reserveKeyPtr, retTxid)) {
+            fSucceeded = false;
+            break;
+        }
+        pDistributeSnapshotDb->AddDistributeTransaction(rewardSnapshotHash, pending.nBatch, retTxid);
+        p_progress.nBatchesSent++;
+    }
+
+    p_progress.nBatchesPending = 0;
+    p_vecPending.clear();
+    return fSucceeded;
+}
+} // namespace
+
 void DistributeRewardSnapshot(CWallet * p_wallet, const CRewardSnapshot& p_rewardSnapshot)
 {
     if (p_wallet->IsLocked()) {
@@ -190,40 +360,50 @@ void DistributeRewardSnapshot(CWallet * p_wallet, const CRewardSnapshot& p_rewar
         return;
     }
 
-    //  Retrieve the asset snapshot entry for the target asset at the specified height
-    CAssetSnapshotDBEntry snapshotEntry;
-
-    if (!pAssetSnapshotDb->RetrieveOwnershipSnapshot(p_rewardSnapshot.strOwnershipAsset, p_rewardSnapshot.nHeight, snapshotEntry)) {
+    //  Make sure the asset snapshot exists for the target asset at the specified height
+    if (!pAssetSnapshotDb->HasOwnershipSnapshot(p_rewardSnapshot.strOwnershipAsset, p_rewardSnapshot.nHeight)) {
         LogPrint(BCLog::REWARDS, "Failed to retrieve ownership snapshot!\n");
         return;
     }
 
     //  Generate payment transactions and store in the payments DB
-    std::vector<OwnerAndAmount> paymentDetails;
-    if (!GenerateDistributionList(p_rewardSnapshot, paymentDetails)) {
+    CDistributionStream stream(p_rewardSnapshot);
+    if (!stream.Init()) {
         LogPrint(BCLog::REWARDS, "Failed to generate payment details!\n");
         return;
     }
 
-    int nNumberOfTransactions = ((int)paymentDetails.size() / MAX_PAYMENTS_PER_TRANSACTION) + 1;
-    CRewardSnapshot copyRewardSnapshot = p_rewardSnapshot;
-    for (int i = 0; i < nNumberOfTransactions; i++) {
+    auto rewardSnapshotHash = p_rewardSnapshot.GetHash();
+    CDistributionProgress progress;
+    progress.fRunning = true;
+    progress.nOwners = stream.GetOwnerCount();
+    SetDistributionProgress(rewardSnapshotHash, progress);
+
+    //  Batches are built one after another, since each one selects coins, and
+    //  signed together once there is one for every core
+    const size_t nMaxPending = std::max(1, std::min(GetNumCores(), MAX_REWARD_SIGNING_THREADS));
+    std::vector<CPendingRewardTx> vecPending;
+    CAmount nLockedAmount = 0;
+    bool fContinue = true;
+
+    std::vector<OwnerAndAmount> paymentDetails;
+    for (int i = 0; fContinue && stream.NextChunk(paymentDetails); i++) {
+        progress.nOwnersProcessed = stream.GetOwnersProcessed();
+
         uint256 txid;
-        if (pDistributeSnapshotDb->GetDistributeTransaction(p_rewardSnapshot.GetHash(), i, txid)) {
-            CTransactionRef txRef;
-            uint256 hashBlock;
+        if (pDistributeSnapshotDb->GetDistributeTransaction(rewardSnapshotHash, i, txid)) {
             auto walletTx = p_wallet->GetWalletTx(txid);
             if (walletTx) {
                 int depth = walletTx->GetDepthInMainChain();
                 if (depth < 0) {
                     LogPrint(BCLog::REWARDS, "Failed distribution: Tx conflict with another tx: %s: number of block back %d!\n", txid.GetHex(), depth);
-                    return;
+                    fContinue = false;
                 } else if (depth == 0) {
                     LogPrint(BCLog::REWARDS, "Tx is in the mempool! %s\n", txid.GetHex());
-                    return;
+                    fContinue = false;
                 } else if (depth > 0) {
                     LogPrint(BCLog::REWARDS, "Tx is in a block %s!\n", txid.GetHex());
-                    continue;
+                    progress.nBatchesConfirmed++;
                 }
             } else {
                 LogPrint(BCLog::REWARDS, "Failed to get wallet Tx: %s\n", txid.GetHex());
@@ -231,29 +411,39 @@ void DistributeRewardSnapshot(CWallet * p_wallet, const CRewardSnapshot& p_rewar
         } else {
             LogPrint(BCLog::REWARDS, "Didn't find transaction in database creating new transaction: %s %s %d %d\n", p_rewardSnapshot.strOwnershipAsset, p_rewardSnapshot.strDistributionAsset, p_rewardSnapshot.nDistributionAmount, i);
             // Create a new transaction and database it
-            int start = i * MAX_PAYMENTS_PER_TRANSACTION;
-            uint256 retTxid;
+            CPendingRewardTx pending;
+            pending.nBatch = i;
+            pending.txnPtr = std::make_shared<CWalletTx>();
+            pending.reserveKeyPtr = std::make_shared<CReserveKey>(p_wallet);
             std::string change = "";
-            if (!BuildTransaction(p_wallet, p_rewardSnapshot, paymentDetails, start, change, retTxid)) {
+            if (!BuildTransaction(p_wallet, p_rewardSnapshot, paymentDetails, nLockedAmount, change, *pending.txnPtr, *pending.reserveKeyPtr, false)
+                    || !LockRewardTransactionInputs(p_wallet, pending, nLockedAmount)) {
                 LogPrint(BCLog::REWARDS, "Failed to build Tx: distribute: %s, amount: %d\n", p_rewardSnapshot.strDistributionAsset, p_rewardSnapshot.nDistributionAmount);
-                return;
+                fContinue = false;
+            } else {
+                vecPending.push_back(std::move(pending));
+                progress.nBatchesPending = vecPending.size();
+                if (vecPending.size() >= nMaxPending) {
+                    fContinue = CommitRewardTransactions(p_wallet, p_rewardSnapshot, vecPending, progress);
+                    nLockedAmount = 0;
+                }
             }
-            pDistributeSnapshotDb->AddDistributeTransaction(p_rewardSnapshot.GetHash(), i, retTxid);
         }
+        SetDistributionProgress(rewardSnapshotHash, progress);
     }
+
+    if (!vecPending.empty()) {
+        CommitRewardTransactions(p_wallet, p_rewardSnapshot, vecPending, progress);
+    }
+    progress.fRunning = false;
+    SetDistributionProgress(rewardSnapshotHash, progress);
 }
 
 bool BuildTransaction(
         CWallet * const p_walletPtr, const CRewardSnapshot& p_rewardSnapshot,
-        const std::vector<OwnerAndAmount> & p_pendingPayments,const int& start,
-        std::string& change_address, uint256& retTxid)
+        const std::vector<OwnerAndAmount> & p_pendingPayments, const CAmount& nLockedAmount,
+        std::string& change_address, CWalletTx& wtxNew, CReserveKey& reserveKey, bool sign)
 {
-    int expectedCount = 0;
-    int actualCount = 0;
-    CValidationState state;
-
-    int stop = start + MAX_PAYMENTS_PER_TRANSACTION;
-    CRewardSnapshot copyRewardSnapshot = p_rewardSnapshot;
     auto rewardSnapshotHash = p_rewardSnapshot.GetHash();
 
     LogPrint(BCLog::REWARDS, "Generating transactions for payments...\n");
@@ -262,17 +452,14 @@ bool BuildTransaction(
     CCoinControl ctrl;
     ctrl.destChange = DecodeDestination(change_address);
     ctrl.assetDestChange = DecodeDestination(change_address);
-    std::shared_ptr<CWalletTx> txnPtr = std::make_shared<CWalletTx>();
-    std::shared_ptr<CReserveKey> reserveKeyPtr = std::make_shared<CReserveKey>(p_walletPtr);
-    std::shared_ptr<UniValue> batchResult = std::make_shared<UniValue>(UniValue::VOBJ);
     CAmount nFeeRequired = 0;
     CAmount totalPaymentAmt = 0;
 
 
     //  Handle payouts using RVN differently from those using an asset
     if (p_rewardSnapshot.strDistributionAsset == "RVN") {
-        // Check amount
-        CAmount curBalance = p_walletPtr->GetBalance();
+        // Check amount, leaving out the coins other unsigned reward transactions spend
+        CAmount curBalance = p_walletPtr->GetBalance() - nLockedAmount;
 
         if (p_walletPtr->GetBroadcastTransactions() && !g_connman) {
             mapRewardSnapshots[rewardSnapshotHash].nStatus = CRewardSnapshot::NETWORK_ERROR;
@@ -284,17 +471,14 @@ bool BuildTransaction(
         std::vector<CRecipient> vDestinations;
 
         //  This should (due to external logic) only include pending payments
-        for (int i = start; i < (int)p_pendingPayments.size() && i < stop; i++) {
-            expectedCount++;
-
+        for (const auto& payment : p_pendingPayments) {
             // Parse Raven address (already validated during ownership snapshot creation)
-            CTxDestination dest = DecodeDestination(p_pendingPayments[i].address);
+            CTxDestination dest = DecodeDestination(payment.address);
             CScript scriptPubKey = GetScriptForDestination(dest);
-            CRecipient recipient = {scriptPubKey, p_pendingPayments[i].amount, false};
+            CRecipient recipient = {scriptPubKey, payment.amount, false};
             vDestinations.emplace_back(recipient);
 
-            totalPaymentAmt += p_pendingPayments[i].amount;
-            actualCount++;
+            totalPaymentAmt += payment.amount;
         }
 
         //  Verify funds
@@ -310,7 +494,7 @@ bool BuildTransaction(
         std::string strError;
         int nChangePosRet = -1;
 
-        if (!p_walletPtr->CreateTransaction(vDestinations, *txnPtr.get(), *reserveKeyPtr.get(), nFeeRequired, nChangePosRet, strError, ctrl)) {
+        if (!p_walletPtr->CreateTransaction(vDestinations, wtxNew, reserveKey, nFeeRequired, nChangePosRet, strError, ctrl, sign)) {
             if (totalPaymentAmt + nFeeRequired > curBalance) {
                 mapRewardSnapshots[rewardSnapshotHash].nStatus = CRewardSnapshot::NOT_ENOUGH_FEE;
                 pDistributeSnapshotDb->OverrideDistributeSnapshot(rewardSnapshotHash, mapRewardSnapshots.at(rewardSnapshotHash));
@@ -325,31 +509,22 @@ bool BuildTransaction(
             return false;
         }
 
-        if (!p_walletPtr->CommitTransaction(*txnPtr.get(), *reserveKeyPtr.get(), g_connman.get(), state)) {
-            mapRewardSnapshots[rewardSnapshotHash].nStatus = CRewardSnapshot::FAILED_COMMIT_TRANSACTION;
-            pDistributeSnapshotDb->OverrideDistributeSnapshot(rewardSnapshotHash, mapRewardSnapshots.at(rewardSnapshotHash));
-            LogPrint(BCLog::REWARDS, "%s\n", state.GetRejectReason());
-            return false;
-        }
     }
     else {
         std::pair<int, std::string> error;
         std::vector< std::pair<CAssetTransfer, std::string> > vDestinations;
         CAmount nTotalAssetAmount = 0;
 
-        // Get the total amount of distribution assets this wallet has
+        // Get the total amount of distribution assets this wallet has; locked coins are not counted
         CAmount totalAssetBalance = 0;
         GetMyAssetBalance(p_rewardSnapshot.strDistributionAsset, totalAssetBalance, 0);
 
         //  This should (due to external logic) only include pending payments
-        for (int i = start; i < (int)p_pendingPayments.size() && i < stop; i++) {
-            expectedCount++;
-
+        for (const auto& payment : p_pendingPayments) {
             vDestinations.emplace_back(std::make_pair(
-                    CAssetTransfer(p_rewardSnapshot.strDistributionAsset, p_pendingPayments[i].amount, DecodeAssetData(""), 0), p_pendingPayments[i].address));
+                    CAssetTransfer(p_rewardSnapshot.strDistributionAsset, payment.amount, DecodeAssetData(""), 0), payment.address));
 
-            nTotalAssetAmount += p_pendingPayments[i].amount;
-            actualCount++;
+            nTotalAssetAmount += payment.amount;
         }
 
         if (nTotalAssetAmount > totalAssetBalance) {
@@ -361,27 +536,41 @@ bool BuildTransaction(
         }
 
         // Create the Transaction (this also verifies dest address)
-        if (!CreateTransferAssetTransaction(p_walletPtr, ctrl, vDestinations, "", error, *txnPtr.get(), *reserveKeyPtr.get(), nFeeRequired)) {
+        if (!CreateTransferAssetTransaction(p_walletPtr, ctrl, vDestinations, "", error, wtxNew, reserveKey, nFeeRequired, nullptr, nullptr, sign)) {
             mapRewardSnapshots[rewardSnapshotHash].nStatus = CRewardSnapshot::FAILED_CREATE_TRANSACTION;
             pDistributeSnapshotDb->OverrideDistributeSnapshot(rewardSnapshotHash, mapRewardSnapshots.at(rewardSnapshotHash));
             LogPrint(BCLog::REWARDS, "Failed to create transfer asset transaction: %s\n", error.second.c_str());
             return false;
         }
 
-        if (!p_walletPtr->CommitTransaction(*txnPtr.get(), *reserveKeyPtr.get(), g_connman.get(), state)) {
-            mapRewardSnapshots[rewardSnapshotHash].nStatus = CRewardSnapshot::FAILED_COMMIT_TRANSACTION;
-            pDistributeSnapshotDb->OverrideDistributeSnapshot(rewardSnapshotHash, mapRewardSnapshots.at(rewardSnapshotHash));
-            LogPrint(BCLog::REWARDS, "%s\n", state.GetRejectReason());
-            return false;
-        }
     }
 
-    retTxid = txnPtr->GetHash();
-    LogPrint(BCLog::REWARDS, "Transaction generation succeeded : %s\n", retTxid.GetHex());
+    LogPrint(BCLog::REWARDS, "Transaction generation succeeded : %s\n", wtxNew.GetHash().GetHex());
+
+    return true;
+}
+
+bool CommitRewardTransaction(
+        CWallet * const p_walletPtr, const CRewardSnapshot& p_rewardSnapshot,
+        CWalletTx& wtxNew, CReserveKey& reserveKey, uint256& retTxid)
+{
+    CValidationState state;
+    auto rewardSnapshotHash = p_rewardSnapshot.GetHash();
+
+    if (!p_walletPtr->CommitTransaction(wtxNew, reserveKey, g_connman.get(), state)) {
+        mapRewardSnapshots[rewardSnapshotHash].nStatus = CRewardSnapshot::FAILED_COMMIT_TRANSACTION;
+        pDistributeSnapshotDb->OverrideDistributeSnapshot(rewardSnapshotHash, mapRewardSnapshots.at(rewardSnapshotHash));
+        LogPrint(BCLog::REWARDS, "%s\n", state.GetRejectReason());
+        return false;
+    }
+
+    retTxid = wtxNew.GetHash();
+    LogPrint(BCLog::REWARDS, "Transaction commit succeeded : %s\n", retTxid.GetHex());
 
     return true;
 }
 
+
 void CheckRewardDistributions(CWallet * p_wallet)
 {
     for (auto item : mapRewardSnapshots) {
@@ -14,17 +14,24 @@
 #include <map>
 #include <unordered_map>
 #include <list>
+#include <memory>
+#include <vector>
 
 
 class CRewardSnapshot;
 class CWallet;
+class CWalletTx;
+class CReserveKey;
 class CRewardSnapshot;
+class CAssetSnapshotReader;
 
 extern std::map<uint256, CRewardSnapshot> mapRewardSnapshots;
 
 //  Addresses are delimited by commas
 static const std::string ADDRESS_COMMA_DELIMITER = ",";
 const int MAX_PAYMENTS_PER_TRANSACTION = 1000;
+//  Upper bound on the reward transactions signed at the same time
+const int MAX_REWARD_SIGNING_THREADS = 8;
 
 //  Individual payment record
 struct OwnerAndAmount
@@ -146,16 +153,76 @@ enum {
     FAILED_
 };
 
+/**
+ * Computes the payments of a reward distribution straight from the ownership
+ * snapshot, one chunk of at most nChunkSize payments at a time. Init() sums
+ * the payable holdings in a first pass over the snapshot; each NextChunk()
+ * then continues a second pass, so only one chunk is ever in memory.
+ * Chunk i always holds the same payments, which is what the distribute
+ * transaction of batch i in pDistributeSnapshotDb is keyed on.
+ */
+class CDistributionStream
+{
+    const CRewardSnapshot& rewardSnapshot;
+    const size_t nChunkSize;
+    std::unique_ptr<CAssetSnapshotReader> pReader;
+    std::set<std::string> exceptionAddressSet;
+
+    CAmount modifiedPaymentInAssetUnits;
+    CAmount distributionUnitDivisor;
+    CAmount totalAmtOwned;
+    CAmount totalSentAsRewards;
+    int nOwners;
+    int nOwnersProcessed;
+    bool fDone;
+
+    bool IsPayable(const std::string& p_address) const;
+
+public:
+    explicit CDistributionStream(const CRewardSnapshot& p_rewardSnapshot, size_t p_nChunkSize = MAX_PAYMENTS_PER_TRANSACTION);
+    ~CDistributionStream();
+
+    //  Look up the assets and total the payable holdings; false if nothing can be distributed
+    bool Init();
+
+    //  Fill the next chunk of payments, false once every owner has been processed
+    bool NextChunk(std::vector<OwnerAndAmount>& p_vecChunk);
+
+    int GetOwnerCount() const { return nOwners; }
+    int GetOwnersProcessed() const { return nOwnersProcessed; }
+};
+
+//  How far the distribution of a reward snapshot got, for getdistributestatus
+struct CDistributionProgress
+{
+    bool fRunning = false;
+    int nOwners = 0;
+    int nOwnersProcessed = 0;
+    //  Batches whose transaction is confirmed, sent this run, or waiting to be signed
+    int nBatchesConfirmed = 0;
+    int nBatchesSent = 0;
+    int nBatchesPending = 0;
+};
+
+bool GetDistributionProgress(const uint256& p_hash, CDistributionProgress& p_progress);
+
 bool GenerateDistributionList(const CRewardSnapshot& p_rewardSnapshot, std::vector<OwnerAndAmount>& vecDistributionList);
 bool AddDistributeRewardSnapshot(CRewardSnapshot& p_rewardSnapshot);
 
 #ifdef ENABLE_WALLET
 void DistributeRewardSnapshot(CWallet * p_wallet, const CRewardSnapshot& p_rewardSnapshot);
 
+//  Create the transaction paying one chunk of a distribution. With sign set to
+//  false it is left unsigned; nLockedAmount is the RVN already committed to
+//  other unsigned reward transactions.
 bool BuildTransaction(
         CWallet * const p_walletPtr, const CRewardSnapshot& p_rewardSnapshot,
-        const std::vector<OwnerAndAmount> & p_pendingPayments, const int& start,
-        std::string& change_address, uint256& retTxid);
+        const std::vector<OwnerAndAmount> & p_pendingPayments, const CAmount& nLockedAmount,
+        std::string& change_address, CWalletTx& wtxNew, CReserveKey& reserveKey, bool sign = true);
+
+bool CommitRewardTransaction(
+        CWallet * const p_walletPtr, const CRewardSnapshot& p_rewardSnapshot,
+        CWalletTx& wtxNew, CReserveKey& reserveKey, uint256& retTxid);
 
 void CheckRewardDistributions(CWallet * p_wallet);
 #endif //ENABLE_WALLET
@@ -7,11 +7,42 @@
 
 #include "snapshotrequestdb.h"
 
-static const char SNAPSHOTREQUEST_FLAG = 'S';
+static const char SNAPSHOTREQUEST_FLAG = 'S'; // Snapshot Request keyed by heightAndName (no longer written)
+static const char SNAPSHOTREQUEST_HEIGHT_FLAG = 'R'; // Snapshot Request keyed by height, then asset name
 
 static const char DISTRIBUTEREQUEST_FLAG = 'D';
 static const char DISTRIBUTETRANSACTION_FLAG = 'T';
 
+namespace {
+//  Big endian height first, so the requests due at a block are one prefix seek
+struct CSnapshotRequestKey
+{
+    char flag;
+    uint32_t nHeight;
+    std::string assetName;
+
+    CSnapshotRequestKey() : flag(0), nHeight(0) {}
+    CSnapshotRequestKey(int p_height, const std::string& p_assetName)
+        : flag(SNAPSHOTREQUEST_HEIGHT_FLAG), nHeight(p_height), assetName(p_assetName) {}
+
+    template<typename Stream>
+    void Serialize(Stream& s) const
+    {
+        s << flag;
+        ser_writedata32be(s, nHeight);
+        s << assetName;
+    }
+
+    template<typename Stream>
+    void Unserialize(Stream& s)
+    {
+        s >> flag;
+        nHeight = ser_readdata32be(s);
+        s >> assetName;
+    }
+};
+} // namespace
+
 CSnapshotRequestDBEntry::CSnapshotRequestDBEntry()
 {
     SetNull();
@@ -32,6 +63,32 @@ CSnapshotRequestDBEntry::CSnapshotRequestDBEntry(
 CSnapshotRequestDB::CSnapshotRequestDB(
     size_t nCacheSize, bool fMemory, bool fWipe)
     : CDBWrapper(GetDataDir() / "rewards" / "snapshotrequest", nCacheSize, fMemory, fWipe) {
+    //  Move the requests written under their heightAndName string to the height keys
+    std::unique_ptr<CDBIterator> pcursor(NewIterator());
+    pcursor->Seek(std::make_pair(SNAPSHOTREQUEST_FLAG, std::string()));
+
+    CDBBatch batch(*this);
+    std::pair<char, std::string> key;
+    size_t nMoved = 0;
+    bool fLegacy = false;
+    while (pcursor->Valid() && pcursor->GetKey(key) && key.first == SNAPSHOTREQUEST_FLAG) {
+        CSnapshotRequestDBEntry reqDbEntry;
+        if (pcursor->GetValue(reqDbEntry)) {
+            batch.Write(CSnapshotRequestKey(reqDbEntry.heightForSnapshot, reqDbEntry.assetName), reqDbEntry);
+            nMoved++;
+        } else {
+            LogPrint(BCLog::REWARDS, "%s: Failed to read snapshot request '%s'\n", __func__, key.second.c_str());
+        }
+        batch.Erase(key);
+        fLegacy = true;
+        pcursor->Next();
+    }
+    if (fLegacy) {
+        if (WriteBatch(batch, true))
+            LogPrint(BCLog::REWARDS, "%s: Rekeyed %u snapshot requests by height\n", __func__, nMoved);
+        else
+            LogPrintf("%s: Failed to rekey the snapshot requests\n", __func__);
+    }
 }
 
 bool CSnapshotRequestDB::ScheduleSnapshot(
@@ -45,7 +102,7 @@ bool CSnapshotRequestDB::ScheduleSnapshot(
     CSnapshotRequestDBEntry snapshotRequest(p_assetName, p_heightForSnapshot);
 
     //  Add the entry to the database
-    bool succeeded = Write(std::make_pair(SNAPSHOTREQUEST_FLAG, snapshotRequest.heightAndName), snapshotRequest);
+    bool succeeded = Write(CSnapshotRequestKey(p_heightForSnapshot, p_assetName), snapshotRequest);
 
     LogPrint(BCLog::REWARDS, "%s : Snapshot request for '%s' at height %d %s!\n",
         __func__,
@@ -66,7 +123,7 @@ bool CSnapshotRequestDB::RetrieveSnapshotRequest(
     LogPrint(BCLog::REWARDS, "%s : Looking for snapshot request '%s'\n",
         __func__, heightAndName.c_str());
 
-    bool succeeded = Read(std::make_pair(SNAPSHOTREQUEST_FLAG, heightAndName), p_snapshotRequest);
+    bool succeeded = Read(CSnapshotRequestKey(p_heightForSnapshot, p_assetName), p_snapshotRequest);
 
     LogPrint(BCLog::REWARDS, "%s : Retrieval of snapshot request for '%s' %s!\n",
         __func__,
@@ -78,10 +135,7 @@ bool CSnapshotRequestDB::RetrieveSnapshotRequest(
 
 bool CSnapshotRequestDB::ContainsSnapshotRequest(const std::string & p_assetName, int p_heightForSnapshot)
 {
-    std::string heightAndName = std::to_string(p_heightForSnapshot) + p_assetName;
-
-    CSnapshotRequestDBEntry snapshotRequest;
-    return Read(std::make_pair(SNAPSHOTREQUEST_FLAG, heightAndName), snapshotRequest);
+    return Exists(CSnapshotRequestKey(p_heightForSnapshot, p_assetName));
 }
 
 bool CSnapshotRequestDB::RemoveSnapshotRequest(
@@ -96,7 +150,7 @@ bool CSnapshotRequestDB::RemoveSnapshotRequest(
         heightAndName.c_str());
 
     //  Otherwise, erase the entire entry since none are left.
-    bool succeeded = Erase(std::make_pair(SNAPSHOTREQUEST_FLAG, heightAndName), true);
+    bool succeeded = Erase(CSnapshotRequestKey(p_heightForSnapshot, p_assetName), true);
 
     LogPrint(BCLog::REWARDS, "%s : Removal of snapshot request for '%s' %s!\n",
         __func__,
@@ -124,27 +178,29 @@ bool CSnapshotRequestDB::RetrieveSnapshotRequestsForHeight(
 
     p_assetsToSnapshot.clear();
 
-    std::unique_ptr<CDBIterator> pcursor(NewIterator());
+    //  A single request is a point lookup
+    if (assetNameProvided && p_blockHeight != 0) {
+        CSnapshotRequestDBEntry reqDbEntry;
+        if (Read(CSnapshotRequestKey(p_blockHeight, p_assetName), reqDbEntry))
+            p_assetsToSnapshot.insert(reqDbEntry);
+        return true;
+    }
 
-    pcursor->SeekToFirst();
+    //  The requests of a height are contiguous, and those of all heights follow each other
+    std::unique_ptr<CDBIterator> pcursor(NewIterator());
+    pcursor->Seek(CSnapshotRequestKey(p_blockHeight, ""));
 
-    // Load all pending rewards
-    while (pcursor->Valid()) {
+    CSnapshotRequestKey key;
+    while (pcursor->Valid() && pcursor->GetKey(key) && key.flag == SNAPSHOTREQUEST_HEIGHT_FLAG
+            && (p_blockHeight == 0 || key.nHeight == (uint32_t)p_blockHeight)) {
         boost::this_thread::interruption_point();
-        std::pair<char, int> key;
 
-        //  Only retrieve entries at the provided block height
-        if (pcursor->GetKey(key) && key.first == SNAPSHOTREQUEST_FLAG) {
+        //  If an asset was specified, only add entries for it.
+        //  Otherwise, retrieve all entries.
+        if (!assetNameProvided || p_assetName == key.assetName) {
             CSnapshotRequestDBEntry reqDbEntry;
-
             if (pcursor->GetValue(reqDbEntry)) {
-                if (p_blockHeight == 0 || reqDbEntry.heightForSnapshot == p_blockHeight) {
-                    //  If an asset was specified, only add entries for it.
-                    //  Otherwise, retrieve all entries.
-                    if (!assetNameProvided || p_assetName == reqDbEntry.assetName) {
-                        p_assetsToSnapshot.insert(reqDbEntry);
-                    }
-                }
+                p_assetsToSnapshot.insert(reqDbEntry);
             } else {
                 LogPrint(BCLog::REWARDS, "%s: Failed to read snapshot request\n", __func__);
             }
@@ -20,7 +20,7 @@ public:
     std::string assetName;
     int heightForSnapshot;
 
-    //  Used as the DB key for the snapshot request
+    //  Orders the requests; the DB key is the big endian height then the asset name
     std::string heightAndName;
 
     CSnapshotRequestDBEntry();
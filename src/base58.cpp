@@ -18,6 +18,135 @@
 
 /** All alphanumeric characters except for "0", "I", "O", and "l" */
 static const char* pszBase58 = "123456789ABCDEFGHJKLMNPQRSTUVWXYZabcdefghijkmnopqrstuvwxyz";
+static const int8_t mapBase58[256] = {
+    -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+    -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+    -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+    -1, 0, 1, 2, 3, 4, 5, 6, 7, 8, -1, -1, -1, -1, -1, -1,
+    -1, 9, 10, 11, 12, 13, 14, 15, 16, -1, 17, 18, 19, 20, 21, -1,
+    22, 23, 24, 25, 26, 27, 28, 29, 30, 31, 32, -1, -1, -1, -1, -1,
+    -1, 33, 34, 35, 36, 37, 38, 39, 40, 41, 42, 43, -1, 44, 45, 46,
+    47, 48, 49, 50, 51, 52, 53, 54, 55, 56, 57, -1, -1, -1, -1, -1,
+    -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+    -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+    -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+    -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+    -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+    -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+    -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+    -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+};
+
+/**
+ * The conversions work on limbs rather than single digits: base58 is built
+ * from limbs of 58^5, five digits each, and bytes from limbs of 2^32, four
+ * bytes each. A limb times the other base's limb fits in 64 bits, so each
+ * step of the schoolbook conversion handles 4 bytes or 5 digits at once.
+ */
+static const uint32_t BASE58_LIMB = 656356768; // 58^5
+static const int BASE58_LIMB_DIGITS = 5;
+static const uint32_t BASE58_POWERS[BASE58_LIMB_DIGITS + 1] = {1, 58, 3364, 195112, 11316496, 656356768};
+
+//! A version byte, a 160-bit hash and a checksum: the payload of an address
+static const size_t ADDRESS_PAYLOAD_SIZE = 25;
+//! Limbs for the payload of an address, so encoding and decoding them never allocates
+static const size_t ADDRESS_LIMBS = 8;
+
+/** Limbs of 58^5 holding any value of nBytes bytes */
+static size_t Base58LimbsFor(size_t nBytes) { return nBytes * 8 / 29 + 1; }
+
+/** Limbs of 2^32 holding any value of nDigits base58 digits */
+static size_t ByteLimbsFor(size_t nDigits) { return (nDigits + BASE58_LIMB_DIGITS - 1) / BASE58_LIMB_DIGITS; }
+
+static std::string EncodeBase58Limbs(const unsigned char* pbegin, const unsigned char* pend, int zeroes, uint32_t* limbs)
+{
+    // Apply "b58 = b58 * 2^32 + next four bytes", the first step taking what is left over
+    size_t length = 0;
+    size_t nChunk = (pend - pbegin) % 4;
+    if (nChunk == 0)
+        nChunk = 4;
+    while (pbegin != pend) {
+        const uint64_t mul = uint64_t(1) << (8 * nChunk);
+        uint64_t carry = 0;
+        for (size_t i = 0; i < nChunk; i++)
+            carry = (carry << 8) | *pbegin++;
+        size_t i = 0;
+        for (; i < length; i++) {
+            carry += mul * limbs[i];
+            limbs[i] = carry % BASE58_LIMB;
+            carry /= BASE58_LIMB;
+        }
+        for (; carry != 0; i++) {
+            limbs[i] = carry % BASE58_LIMB;
+            carry /= BASE58_LIMB;
+        }
+        length = i;
+        nChunk = 4;
+    }
+    // Translate the limbs, most significant first, dropping the leading zero digits of the top one
+    std::string str;
+    str.reserve(zeroes + length * BASE58_LIMB_DIGITS);
+    str.assign(zeroes, '1');
+    char digits[BASE58_LIMB_DIGITS];
+    for (size_t i = length; i-- > 0;) {
+        uint32_t limb = limbs[i];
+        for (int j = BASE58_LIMB_DIGITS - 1; j >= 0; j--) {
+            digits[j] = pszBase58[limb % 58];
+            limb /= 58;
+        }
+        int nSkip = 0;
+        if (i == length - 1) {
+            while (digits[nSkip] == '1')
+                nSkip++;
+        }
+        str.append(digits + nSkip, BASE58_LIMB_DIGITS - nSkip);
+    }
+    return str;
+}
+
+static bool DecodeBase58Limbs(const char* psz, const char* pend, int zeroes, std::vector<unsigned char>& vch, uint32_t* limbs)
+{
+    // Apply "b256 = b256 * 58^5 + next five digits", the first step taking what is left over
+    size_t length = 0;
+    size_t nChunk = (pend - psz) % BASE58_LIMB_DIGITS;
+    if (nChunk == 0)
+        nChunk = BASE58_LIMB_DIGITS;
+    while (psz != pend) {
+        const uint64_t mul = BASE58_POWERS[nChunk];
+        uint64_t carry = 0;
+        for (size_t i = 0; i < nChunk; i++) {
+            int digit = mapBase58[(uint8_t)*psz++];
+            if (digit == -1)
+                return false;
+            carry = carry * 58 + digit;
+        }
+        size_t i = 0;
+        for (; i < length; i++) {
+            carry += mul * limbs[i];
+            limbs[i] = (uint32_t)carry;
+            carry >>= 32;
+        }
+        for (; carry != 0; i++) {
+            limbs[i] = (uint32_t)carry;
+            carry >>= 32;
+        }
+        length = i;
+        nChunk = BASE58_LIMB_DIGITS;
+    }
+    // Copy the limbs out big-endian, dropping the leading zero bytes of the top one
+    vch.reserve(zeroes + length * 4);
+    vch.assign(zeroes, 0x00);
+    for (size_t i = length; i-- > 0;) {
+        int nShift = 24;
+        if (i == length - 1) {
+            while ((limbs[i] >> nShift) == 0)
+                nShift -= 8;
+        }
+        for (; nShift >= 0; nShift -= 8)
+            vch.push_back((unsigned char)(limbs[i] >> nShift));
+    }
+    return true;
+}
 
 bool DecodeBase58(const char* psz, std::vector<unsigned char>& vch)
 {
@@ -26,87 +155,44 @@ bool DecodeBase58(const char* psz, std::vector<unsigned char>& vch)
         psz++;
     // Skip and count leading '1's.
     int zeroes = 0;
-    int length = 0;
     while (*psz == '1') {
         zeroes++;
         psz++;
     }
-    // Allocate enough space in big-endian base256 representation.
-    int size = strlen(psz) * 733 /1000 + 1; // log(58) / log(256), rounded up.
-    std::vector<unsigned char> b256(size);
-    // Process the characters.
-    while (*psz && !isspace(*psz)) {
-        // Decode base58 character
-        const char* ch = strchr(pszBase58, *psz);
-        if (ch == nullptr)
-            return false;
-        // Apply "b256 = b256 * 58 + ch".
-        int carry = ch - pszBase58;
-        int i = 0;
-        for (std::vector<unsigned char>::reverse_iterator it = b256.rbegin(); (carry != 0 || i < length) && (it != b256.rend()); ++it, ++i) {
-            carry += 58 * (*it);
-            *it = carry % 256;
-            carry /= 256;
-        }
-        assert(carry == 0);
-        length = i;
-        psz++;
-    }
-    // Skip trailing spaces.
-    while (isspace(*psz))
-        psz++;
-    if (*psz != 0)
+    // The digits run up to the first space, which may only be followed by more.
+    const char* pend = psz;
+    while (*pend && !isspace(*pend))
+        pend++;
+    const char* ptail = pend;
+    while (isspace(*ptail))
+        ptail++;
+    if (*ptail != 0)
         return false;
-    // Skip leading zeroes in b256.
-    std::vector<unsigned char>::iterator it = b256.begin() + (size - length);
-    while (it != b256.end() && *it == 0)
-        it++;
-    // Copy result into output vector.
-    vch.reserve(zeroes + (b256.end() - it));
-    vch.assign(zeroes, 0x00);
-    while (it != b256.end())
-        vch.push_back(*(it++));
-    return true;
+
+    const size_t nLimbs = ByteLimbsFor(pend - psz);
+    if (nLimbs <= ADDRESS_LIMBS) {
+        uint32_t limbs[ADDRESS_LIMBS];
+        return DecodeBase58Limbs(psz, pend, zeroes, vch, limbs);
+    }
+    std::vector<uint32_t> limbs(nLimbs);
+    return DecodeBase58Limbs(psz, pend, zeroes, vch, limbs.data());
 }
 
 std::string EncodeBase58(const unsigned char* pbegin, const unsigned char* pend)
 {
     // Skip & count leading zeroes.
     int zeroes = 0;
-    int length = 0;
     while (pbegin != pend && *pbegin == 0) {
         pbegin++;
         zeroes++;
     }
-    // Allocate enough space in big-endian base58 representation.
-    int size = (pend - pbegin) * 138 / 100 + 1; // log(256) / log(58), rounded up.
-    std::vector<unsigned char> b58(size);
-    // Process the bytes.
-    while (pbegin != pend) {
-        int carry = *pbegin;
-        int i = 0;
-        // Apply "b58 = b58 * 256 + ch".
-        for (std::vector<unsigned char>::reverse_iterator it = b58.rbegin(); (carry != 0 || i < length) && (it != b58.rend()); it++, i++) {
-            carry += 256 * (*it);
-            *it = carry % 58;
-            carry /= 58;
-        }
-
-        assert(carry == 0);
-        length = i;
-        pbegin++;
+    const size_t nLimbs = Base58LimbsFor(pend - pbegin);
+    if (nLimbs <= ADDRESS_LIMBS) {
+        uint32_t limbs[ADDRESS_LIMBS];
+        return EncodeBase58Limbs(pbegin, pend, zeroes, limbs);
     }
-    // Skip leading zeroes in base58 result.
-    std::vector<unsigned char>::iterator it = b58.begin() + (size - length);
-    while (it != b58.end() && *it == 0)
-        it++;
-    // Translate the result into a string.
-    std::string str;
-    str.reserve(zeroes + (b58.end() - it));
-    str.assign(zeroes, '1');
-    while (it != b58.end())
-        str += pszBase58[*(it++)];
-    return str;
+    std::vector<uint32_t> limbs(nLimbs);
+    return EncodeBase58Limbs(pbegin, pend, zeroes, limbs.data());
 }
 
 std::string EncodeBase58(const std::vector<unsigned char>& vch)
@@ -193,9 +279,21 @@ bool CBase58Data::SetString(const std::string& str)
 
 std::string CBase58Data::ToString() const
 {
-    std::vector<unsigned char> vch = vchVersion;
-    vch.insert(vch.end(), vchData.begin(), vchData.end());
-    return EncodeBase58Check(vch);
+    const size_t nSize = vchVersion.size() + vchData.size() + 4;
+    if (nSize > ADDRESS_PAYLOAD_SIZE) {
+        std::vector<unsigned char> vch = vchVersion;
+        vch.insert(vch.end(), vchData.begin(), vchData.end());
+        return EncodeBase58Check(vch);
+    }
+    // Addresses are put together on the stack
+    unsigned char payload[ADDRESS_PAYLOAD_SIZE];
+    if (!vchVersion.empty())
+        memcpy(payload, vchVersion.data(), vchVersion.size());
+    if (!vchData.empty())
+        memcpy(payload + vchVersion.size(), vchData.data(), vchData.size());
+    uint256 hash = Hash(payload, payload + nSize - 4);
+    memcpy(payload + nSize - 4, &hash, 4);
+    return EncodeBase58(payload, payload + nSize);
 }
 
 int CBase58Data::CompareTo(const CBase58Data& b58) const
@@ -0,0 +1,149 @@
+// Copyright (c) 2026 The Mynta Core Developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include "baseindex.h"
+
+#include "chain.h"
+#include "chainparams.h"
+#include "coins.h"
+#include "primitives/block.h"
+#include "undo.h"
+#include "util.h"
+#include "validation.h"
+
+#include <algorithm>
+
+#include <boost/thread.hpp>
+
+/** Blocks the sync thread indexes between checks for shutdown and new tips */
+static const int INDEX_SYNC_STEP = 1000;
+
+/** Where a block to index is stored, copied out of mapBlockIndex under cs_main */
+struct CIndexBlock
+{
+    const CBlockIndex* pindex;
+    uint256 hashPrev;
+    CDiskBlockPos pos;
+    CDiskBlockPos posUndo;
+};
+
+CBaseIndex::CBaseIndex(const fs::path& path, size_t nCacheSize, bool fMemory, bool fWipe)
+    : db(path, nCacheSize, fMemory, fWipe)
+{
+}
+
+void CBaseIndex::SetBest(const CBlockIndex* pindex)
+{
+    pindexBest = pindex;
+    nBestHeight = pindex ? pindex->nHeight : -1;
+}
+
+int CBaseIndex::GetBestHeight() const
+{
+    return nBestHeight;
+}
+
+bool CBaseIndex::AdvanceTo(const CBlockIndex* pindexTarget, const CBlock* pblock)
+{
+    if (pindexBest && pindexTarget->GetAncestor(pindexBest->nHeight) != pindexBest) {
+        if (!RewindTo(LastCommonAncestor(pindexBest, pindexTarget)))
+            return false;
+    }
+    if (pindexBest == pindexTarget)
+        return true;
+
+    std::vector<CIndexBlock> vBlocks;
+    {
+        LOCK(cs_main);
+        for (const CBlockIndex* pindex = pindexTarget; pindex != pindexBest; pindex = pindex->pprev) {
+            CIndexBlock entry;
+            entry.pindex = pindex;
+            entry.hashPrev = pindex->pprev ? pindex->pprev->GetBlockHash() : uint256();
+            entry.pos = pindex->GetBlockPos();
+            entry.posUndo = pindex->GetUndoPos();
+            vBlocks.push_back(entry);
+        }
+    }
+    std::reverse(vBlocks.begin(), vBlocks.end());
+
+    const Consensus::Params& consensusParams = GetParams().GetConsensus();
+    for (const CIndexBlock& entry : vBlocks) {
+        CBlock blockRead;
+        const CBlock* pblockEntry = &blockRead;
+        if (pblock && entry.pindex == pindexTarget) {
+            pblockEntry = pblock;
+        } else if (!ReadBlockFromDisk(blockRead, entry.pos, consensusParams)) {
+            return error("%s: failed to read block %s", __func__, entry.pindex->GetBlockHash().ToString());
+        }
+        // The genesis block has no undo data, nor does a block spending nothing
+        CBlockUndo blockundo;
+        if (entry.pindex->pprev && pblockEntry->vtx.size() > 1 && !UndoReadFromDisk(blockundo, entry.posUndo, entry.hashPrev))
+            return error("%s: failed to read undo data of block %s", __func__, entry.pindex->GetBlockHash().ToString());
+        if (!WriteBlock(*pblockEntry, blockundo, entry.pindex))
+            return false;
+    }
+    return true;
+}
+
+void CBaseIndex::BlockConnected(const std::shared_ptr<const CBlock>& block, const CBlockIndex* pindex, const std::vector<CTransactionRef>& txnConflicted)
+{
+    // Until the sync thread catches up, these are blocks it will index itself
+    if (!fSynced)
+        return;
+    // Queued before the sync thread caught up, and indexed by it
+    if (pindexBest && pindex->nHeight <= pindexBest->nHeight && pindexBest->GetAncestor(pindex->nHeight) == pindex)
+        return;
+    if (!AdvanceTo(pindex, block.get()))
+        LogPrintf("%s: failed to index block %s in the %s\n", __func__, pindex->GetBlockHash().ToString(), GetName());
+}
+
+void CBaseIndex::ThreadSync()
+{
+    while (true) {
+        boost::this_thread::interruption_point();
+        if (fImporting || fReindex) {
+            MilliSleep(1000);
+            continue;
+        }
+
+        const CBlockIndex* pindexTarget;
+        {
+            LOCK(cs_main);
+            const CBlockIndex* pindexTip = chainActive.Tip();
+            if (!pindexTip) {
+                pindexTarget = nullptr;
+            } else if (nBestHeight >= pindexTip->nHeight - INDEX_SYNC_STEP) {
+                // Index the last blocks while holding cs_main, so that no block is
+                // connected between them and BlockConnected taking over
+                if (!AdvanceTo(pindexTip, nullptr)) {
+                    LogPrintf("%s: stopped building the %s\n", __func__, GetName());
+                    return;
+                }
+                fSynced = true;
+                LogPrintf("The %s is synced at height %d\n", GetName(), pindexTip->nHeight);
+                return;
+            } else {
+                pindexTarget = pindexTip->GetAncestor(std::max(nBestHeight.load(), 0) + INDEX_SYNC_STEP);
+            }
+        }
+
+        if (!pindexTarget) {
+            MilliSleep(1000);
+            continue;
+        }
+        if (!AdvanceTo(pindexTarget, nullptr)) {
+            LogPrintf("%s: stopped building the %s\n", __func__, GetName());
+            return;
+        }
+        LogPrintf("Built the %s up to height %d\n", GetName(), pindexTarget->nHeight);
+    }
+}
+
+void CBaseIndex::StartSync(boost::thread_group& threadGroup, const char* pszThreadName)
+{
+    threadGroup.create_thread([this, pszThreadName] {
+        RenameThread(pszThreadName);
+        ThreadSync();
+    });
+}
@@ -0,0 +1,78 @@
+// Copyright (c) 2026 The Mynta Core Developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#ifndef MYNTA_BASEINDEX_H
+#define MYNTA_BASEINDEX_H
+
+#include "dbwrapper.h"
+#include "fs.h"
+#include "validationinterface.h"
+
+#include <atomic>
+#include <string>
+
+class CBlockIndex;
+class CBlockUndo;
+
+namespace boost {
+class thread_group;
+} // namespace boost
+
+/**
+ * An optional index of the active chain, kept in its own database.
+ *
+ * A background thread builds it from the blocks already on disk, after which
+ * BlockConnected keeps it up to date. The index says what it writes for a
+ * block and how it steps back from one; finding the blocks to write, reading
+ * them and their undo data, and handing over from the sync thread happen here.
+ */
+class CBaseIndex : public CValidationInterface
+{
+private:
+    /**
+     * Make pindexTarget the best block: step back to where its chain forks from
+     * the indexed one, then write the blocks after that, reading them from disk
+     * unless pblock is the block at pindexTarget.
+     */
+    bool AdvanceTo(const CBlockIndex* pindexTarget, const CBlock* pblock);
+
+    /** Index the blocks connected before the index caught up. Returns once it has. */
+    void ThreadSync();
+
+protected:
+    CDBWrapper db;
+
+    // Only one thread writes at a time: the sync thread until it has caught up,
+    // then the thread of the index's validation queue, which fSynced lets in.
+
+    //! last block written, on a chain that was active when it was written
+    const CBlockIndex* pindexBest{nullptr};
+    std::atomic<int> nBestHeight{-1};
+    std::atomic<bool> fSynced{false};
+
+    void SetBest(const CBlockIndex* pindex);
+
+    //! Write what pindex, whose parent is pindexBest, adds to the index, and make it the best block
+    virtual bool WriteBlock(const CBlock& block, const CBlockUndo& blockundo, const CBlockIndex* pindex) = 0;
+
+    //! Step back to pindexFork, an ancestor of pindexBest, and make it the best block
+    virtual bool RewindTo(const CBlockIndex* pindexFork) = 0;
+
+    //! What the index is called in the log
+    virtual std::string GetName() const = 0;
+
+    void BlockConnected(const std::shared_ptr<const CBlock>& block, const CBlockIndex* pindex, const std::vector<CTransactionRef>& txnConflicted) override;
+
+public:
+    CBaseIndex(const fs::path& path, size_t nCacheSize, bool fMemory, bool fWipe);
+    virtual ~CBaseIndex() {}
+
+    /** Height of the best indexed block, -1 if there is none yet */
+    int GetBestHeight() const;
+
+    /** Start the thread that catches the index up with the chain */
+    void StartSync(boost::thread_group& threadGroup, const char* pszThreadName);
+};
+
+#endif // MYNTA_BASEINDEX_H
@@ -0,0 +1,108 @@
+// Copyright (c) 2026 The Mynta Core Developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include "bench.h"
+
+#include "addrman.h"
+#include "random.h"
+#include "timedata.h"
+
+#include <atomic>
+#include <thread>
+#include <vector>
+
+/* About twice as many addresses as a long running node keeps, from many source groups */
+static const size_t NUM_SOURCES = 64;
+static const size_t NUM_ADDRESSES_PER_SOURCE = 256;
+
+static CAddress RandomAddress(FastRandomContext& rng)
+{
+    struct in_addr addr;
+    addr.s_addr = rng.rand32();
+    CAddress ret(CService(CNetAddr(addr), 8767), NODE_NETWORK);
+    ret.nTime = GetAdjustedTime();
+    return ret;
+}
+
+static void FillAddrMan(CAddrMan& addrman, FastRandomContext& rng)
+{
+    for (size_t source = 0; source < NUM_SOURCES; source++) {
+        std::vector<CAddress> vAddr;
+        for (size_t i = 0; i < NUM_ADDRESSES_PER_SOURCE; i++) {
+            vAddr.push_back(RandomAddress(rng));
+        }
+        addrman.Add(vAddr, RandomAddress(rng));
+        // Some of them have been connected to
+        for (size_t i = 0; i < vAddr.size(); i += 8) {
+            addrman.Good(vAddr[i]);
+        }
+    }
+}
+
+static void AddrManAdd(benchmark::State& state)
+{
+    FastRandomContext rng(true);
+    std::vector<CAddress> vAddr;
+    for (size_t i = 0; i < NUM_ADDRESSES_PER_SOURCE; i++) {
+        vAddr.push_back(RandomAddress(rng));
+    }
+    CNetAddr source = RandomAddress(rng);
+    while (state.KeepRunning()) {
+        CAddrMan addrman;
+        addrman.Add(vAddr, source);
+    }
+}
+
+static void AddrManSelect(benchmark::State& state)
+{
+    FastRandomContext rng(true);
+    CAddrMan addrman;
+    FillAddrMan(addrman, rng);
+    while (state.KeepRunning()) {
+        CAddrInfo addr = addrman.Select();
+        assert(addr.GetPort() == 8767);
+    }
+}
+
+/* Select while another thread keeps processing ADDR messages, as on a seed node */
+static void AddrManSelectContended(benchmark::State& state)
+{
+    FastRandomContext rng(true);
+    CAddrMan addrman;
+    FillAddrMan(addrman, rng);
+
+    std::atomic<bool> fStop(false);
+    std::thread writer([&addrman, &fStop] {
+        FastRandomContext writerRng(true);
+        while (!fStop) {
+            std::vector<CAddress> vAddr;
+            for (size_t i = 0; i < 10; i++) {
+                vAddr.push_back(RandomAddress(writerRng));
+            }
+            addrman.Add(vAddr, RandomAddress(writerRng));
+        }
+    });
+    while (state.KeepRunning()) {
+        CAddrInfo addr = addrman.Select();
+        assert(addr.GetPort() == 8767);
+    }
+    fStop = true;
+    writer.join();
+}
+
+static void AddrManGetAddr(benchmark::State& state)
+{
+    FastRandomContext rng(true);
+    CAddrMan addrman;
+    FillAddrMan(addrman, rng);
+    while (state.KeepRunning()) {
+        std::vector<CAddress> vAddr = addrman.GetAddr();
+        assert(!vAddr.empty());
+    }
+}
+
+BENCHMARK(AddrManAdd);
+BENCHMARK(AddrManSelect);
+BENCHMARK(AddrManSelectContended);
+BENCHMARK(AddrManGetAddr);
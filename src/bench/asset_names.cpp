@@ -0,0 +1,39 @@
+// Copyright (c) 2026 The Mynta Core Developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include "bench.h"
+
+#include "assets/assets.h"
+
+#include <string>
+#include <vector>
+
+// One name of each kind, as they appear in transfer outputs
+static const std::vector<std::string> BENCH_ASSET_NAMES = {
+    "BENCHASSET", "BENCHASSET/SUB.ASSET", "BENCHASSET#Tag_01", "BENCHASSET~Channel_1",
+    "BENCHASSET!", "BENCHASSET^VOTE", "#KYC_QUALIFIER", "#KYC/#SUB", "$RESTRICTED",
+    "NOT VALID", "_LEADING", "DOUBLE..PUNCT",
+};
+
+static void AssetNameValidate(benchmark::State& state)
+{
+    while (state.KeepRunning()) {
+        for (const std::string& name : BENCH_ASSET_NAMES) {
+            AssetType type;
+            IsAssetNameValid(name, type);
+        }
+    }
+}
+
+static void AssetNameIsOwner(benchmark::State& state)
+{
+    while (state.KeepRunning()) {
+        for (const std::string& name : BENCH_ASSET_NAMES) {
+            IsAssetNameAnOwner(name);
+        }
+    }
+}
+
+BENCHMARK(AssetNameValidate);
+BENCHMARK(AssetNameIsOwner);
@@ -0,0 +1,56 @@
+// Copyright (c) 2026 The Mynta Core Developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include "bench.h"
+
+#include "assets/assets.h"
+#include "base58.h"
+#include "chainparams.h"
+#include "script/standard.h"
+
+#include <vector>
+
+// Roughly the outputs of a block full of asset transfers
+static std::vector<CScript> BuildTransferScripts(size_t nCount)
+{
+    CScript scriptDest = GetScriptForDestination(DecodeDestination(GetParams().GlobalBurnAddress()));
+    std::vector<CScript> vScripts;
+    vScripts.reserve(nCount);
+    for (size_t i = 0; i < nCount; i++) {
+        CAssetTransfer transfer("BENCHASSET" + std::to_string(i % 50), COIN * (i + 1));
+        CScript script = scriptDest;
+        transfer.ConstructTransaction(script);
+        vScripts.push_back(script);
+    }
+    return vScripts;
+}
+
+// The classify-then-deserialize pattern used by callers
+static void AssetTransferFromScript(benchmark::State& state)
+{
+    const std::vector<CScript> vScripts = BuildTransferScripts(2000);
+    while (state.KeepRunning()) {
+        for (const CScript& script : vScripts) {
+            CAssetTransfer transfer;
+            std::string address;
+            assert(IsScriptTransferAsset(script));
+            assert(TransferAssetFromScript(script, transfer, address));
+        }
+    }
+}
+
+static void AssetOutputDecode(benchmark::State& state)
+{
+    const std::vector<CScript> vScripts = BuildTransferScripts(2000);
+    while (state.KeepRunning()) {
+        for (const CScript& script : vScripts) {
+            CAssetOutputRecord record;
+            DecodeAssetOutput(script, record);
+            assert(record.fDecoded);
+        }
+    }
+}
+
+BENCHMARK(AssetTransferFromScript);
+BENCHMARK(AssetOutputDecode);
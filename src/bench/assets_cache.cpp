@@ -0,0 +1,91 @@
+// Copyright (c) 2026 The Mynta Core Developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include "bench.h"
+#include "synthchain.h"
+
+#include "assets/assets.h"
+#include "pubkey.h"
+#include "validation.h"
+
+#include <string>
+#include <vector>
+
+// Changes per iteration, about what a busy block carries
+static const size_t ASSET_CHANGES = 1000;
+static const size_t ASSETS = 50;
+static const CAddressKey BENCH_ADDRESS = CAddressKey::FromDestination(CKeyID(uint160(std::vector<unsigned char>(20, 0x42))));
+
+/**
+ * The block caches look assets up in passets, the cache of the chain tip,
+ * which is not set up without a node. This gives them an empty one, holding
+ * the first nIssued synthetic assets, for as long as it exists.
+ */
+class BenchAssetsTip
+{
+private:
+    CAssetsCache* pprevAssets;
+
+public:
+    explicit BenchAssetsTip(size_t nIssued) : pprevAssets(passets)
+    {
+        passets = new CAssetsCache();
+        for (size_t i = 0; i < nIssued; i++) {
+            bool fAdded = passets->AddNewAsset(CNewAsset(CSyntheticChain::AssetName(i), 1000 * COIN), BENCH_ADDRESS, 1, uint256());
+            assert(fAdded);
+        }
+    }
+
+    ~BenchAssetsTip()
+    {
+        delete passets;
+        passets = pprevAssets;
+    }
+};
+
+static void AssetsCacheIssue(benchmark::State& state)
+{
+    BenchAssetsTip tip(0);
+    std::vector<CNewAsset> vAssets;
+    for (size_t i = 0; i < ASSET_CHANGES; i++)
+        vAssets.emplace_back(CSyntheticChain::AssetName(i), 1000 * COIN);
+    while (state.KeepRunning()) {
+        CAssetsCache cache;
+        for (const CNewAsset& asset : vAssets)
+            cache.AddNewAsset(asset, BENCH_ADDRESS, 2, uint256());
+    }
+}
+
+static void AssetsCacheTransfer(benchmark::State& state)
+{
+    BenchAssetsTip tip(ASSETS);
+    CSyntheticChain chain;
+    std::vector<std::pair<CAssetTransfer, COutPoint>> vTransfers;
+    for (size_t i = 0; i < ASSET_CHANGES; i++)
+        vTransfers.emplace_back(CAssetTransfer(CSyntheticChain::AssetName(i % ASSETS), COIN), COutPoint(chain.RandHash(), i % 4));
+    const CTxOut txout;
+    while (state.KeepRunning()) {
+        CAssetsCache cache;
+        for (const auto& transfer : vTransfers)
+            cache.AddTransferAsset(transfer.first, BENCH_ADDRESS, transfer.second, txout);
+    }
+}
+
+static void AssetsCacheReissue(benchmark::State& state)
+{
+    BenchAssetsTip tip(ASSETS);
+    CSyntheticChain chain;
+    std::vector<std::pair<CReissueAsset, COutPoint>> vReissues;
+    for (size_t i = 0; i < ASSET_CHANGES; i++)
+        vReissues.emplace_back(CReissueAsset(CSyntheticChain::AssetName(i % ASSETS), COIN, -1, 1, ""), COutPoint(chain.RandHash(), 0));
+    while (state.KeepRunning()) {
+        CAssetsCache cache;
+        for (const auto& reissue : vReissues)
+            cache.AddReissueAsset(reissue.first, BENCH_ADDRESS, reissue.second);
+    }
+}
+
+BENCHMARK(AssetsCacheIssue);
+BENCHMARK(AssetsCacheTransfer);
+BENCHMARK(AssetsCacheReissue);
@@ -55,6 +55,30 @@ static void Base58Decode(benchmark::State& state)
 }
 
 
+// The 25 bytes of an address: version, hash and checksum
+static void Base58AddressEncode(benchmark::State& state)
+{
+    std::array<unsigned char, 25> buff;
+    for (size_t i = 0; i < buff.size(); i++)
+        buff[i] = 50 + i * 7;
+    while (state.KeepRunning()) {
+        EncodeBase58(buff.begin(), buff.end());
+    }
+}
+
+
+static void Base58AddressCheckDecode(benchmark::State& state)
+{
+    const char* addr = "17VZNX1SN5NtKa8UQFxwQbFeFc3iqRYhem";
+    std::vector<unsigned char> vch;
+    while (state.KeepRunning()) {
+        DecodeBase58Check(addr, vch);
+    }
+}
+
+
 BENCHMARK(Base58Encode);
 BENCHMARK(Base58CheckEncode);
 BENCHMARK(Base58Decode);
+BENCHMARK(Base58AddressEncode);
+BENCHMARK(Base58AddressCheckDecode);
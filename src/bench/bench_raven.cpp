@@ -6,21 +6,52 @@
 #include <chainparamsbase.h>
 #include <chainparams.h>
 #include "bench.h"
+#include "bench/replay.h"
+#include "blockprefetch.h"
 #include "crypto/sha256.h"
+#include "hash.h"
 #include "key.h"
+#include "txdb.h"
 #include "validation.h"
 #include "util.h"
 #include "random.h"
 
+#include <iostream>
+
 int
 main(int argc, char **argv)
 {
     SHA256AutoDetect();
+    X16RAutoDetect();
     RandomInit();
     ECC_Start();
     SetupEnvironment();
     fPrintToDebugLog = false; // don't want to write to debug.log file
 
+    gArgs.ParseParameters(argc, argv);
+    if (gArgs.IsArgSet("-replay")) {
+        // bench_raven -replay=<blk file or blocks dir> [-replayoutput=<json file>] [-dbcache=<MiB>]
+        //             [-par=<threads>] [-prefetchthreads=<n>] [-keepdatadir] [-testnet|-regtest]
+        SelectParams(ChainNameFromCommandLine());
+        CReplayOptions options;
+        options.pathBlocks = fs::path(gArgs.GetArg("-replay", ""));
+        options.pathOutput = fs::path(gArgs.GetArg("-replayoutput", ""));
+        options.nDbCacheMiB = gArgs.GetArg("-dbcache", nDefaultDbCache);
+        int nScriptThreads = gArgs.GetArg("-par", 0);
+        if (nScriptThreads <= 0)
+            nScriptThreads += GetNumCores();
+        options.nScriptThreads = std::max(1, std::min(nScriptThreads, MAX_SCRIPTCHECK_THREADS));
+        options.nPrefetchThreads = std::max(0, std::min<int>(gArgs.GetArg("-prefetchthreads", 0), MAX_PREFETCH_THREADS));
+        options.fKeepDatadir = gArgs.GetBoolArg("-keepdatadir", false);
+
+        std::string strError;
+        const bool fOk = RunChainReplay(options, strError);
+        if (!fOk)
+            std::cerr << "Replay failed: " << strError << std::endl;
+        ECC_Stop();
+        return fOk ? 0 : 1;
+    }
+
     SelectParams(CBaseChainParams::MAIN);
     benchmark::BenchRunner::RunAll();
 
@@ -0,0 +1,123 @@
+// Copyright (c) 2026 The Mynta Core Developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include "bench.h"
+#include "synthchain.h"
+
+#include "bls/bls.h"
+#include "hash.h"
+
+#include <vector>
+
+// Members of the largest quorums and the shares needed to sign for them (LLMQ_400_60)
+static const size_t QUORUM_SIZE = 400;
+static const size_t QUORUM_THRESHOLD = 240;
+// Signatures checked together, about a block of InstantSend locks
+static const size_t BATCH_SIZE = 100;
+
+struct BLSBenchKeys
+{
+    std::vector<CBLSPublicKey> vPubKeys;
+    std::vector<CBLSSignature> vSigs;
+    std::vector<uint256> vHashes;
+};
+
+// Keys of the first nCount synthetic masternodes, each signing its own message
+static BLSBenchKeys MakeBLSBenchKeys(size_t nCount)
+{
+    BLSBenchKeys keys;
+    CSyntheticChain chain;
+    for (size_t i = 0; i < nCount; i++) {
+        CBLSSecretKey sk;
+        CSyntheticChain::GetOperatorKey(i, sk);
+        keys.vHashes.push_back(chain.RandHash());
+        keys.vPubKeys.push_back(sk.GetPublicKey());
+        keys.vSigs.push_back(sk.Sign(keys.vHashes.back()));
+    }
+    return keys;
+}
+
+static void BLSVerify(benchmark::State& state)
+{
+    const BLSBenchKeys keys = MakeBLSBenchKeys(1);
+    while (state.KeepRunning()) {
+        assert(keys.vSigs[0].VerifyInsecure(keys.vPubKeys[0], keys.vHashes[0]));
+    }
+}
+
+static void BLSBatchVerify(benchmark::State& state)
+{
+    const BLSBenchKeys keys = MakeBLSBenchKeys(BATCH_SIZE);
+    while (state.KeepRunning()) {
+        assert(CBLSSignature::BatchVerify(keys.vSigs, keys.vPubKeys, keys.vHashes));
+    }
+}
+
+static void BLSAggregatePublicKeys(benchmark::State& state)
+{
+    const BLSBenchKeys keys = MakeBLSBenchKeys(QUORUM_SIZE);
+    while (state.KeepRunning()) {
+        assert(CBLSPublicKey::AggregatePublicKeys(keys.vPubKeys).IsValid());
+    }
+}
+
+static void BLSAggregateSignatures(benchmark::State& state)
+{
+    const BLSBenchKeys keys = MakeBLSBenchKeys(QUORUM_SIZE);
+    while (state.KeepRunning()) {
+        assert(CBLSSignature::AggregateSignatures(keys.vSigs).IsValid());
+    }
+}
+
+// A quorum's threshold of shares signing the same message
+struct BLSBenchShares
+{
+    std::vector<CBLSSignature> vShares;
+    std::vector<CBLSId> vIds;
+    uint256 quorumHash;
+};
+
+static BLSBenchShares MakeBLSBenchShares()
+{
+    CSyntheticChain chain;
+    std::vector<CBLSSecretKey> msk(QUORUM_THRESHOLD);
+    for (size_t i = 0; i < msk.size(); i++)
+        CSyntheticChain::GetOperatorKey(QUORUM_SIZE + i, msk[i]);
+
+    BLSBenchShares shares;
+    shares.quorumHash = chain.RandHash();
+    const uint256 hash = chain.RandHash();
+    for (size_t i = 0; i < QUORUM_THRESHOLD; i++) {
+        CBLSId id(chain.RandHash());
+        CBLSSecretKey skShare;
+        assert(skShare.SecretKeyShare(msk, id));
+        shares.vIds.push_back(id);
+        shares.vShares.push_back(skShare.Sign(hash));
+    }
+    return shares;
+}
+
+static void BLSRecoverThresholdSignature(benchmark::State& state)
+{
+    const BLSBenchShares shares = MakeBLSBenchShares();
+    while (state.KeepRunning()) {
+        assert(CBLSSignature::RecoverThresholdSignature(shares.vShares, shares.vIds, QUORUM_THRESHOLD).IsValid());
+    }
+}
+
+// The same signer set again, as for the sessions of one quorum, with the Lagrange coefficients cached
+static void BLSRecoverThresholdSignature_Cached(benchmark::State& state)
+{
+    const BLSBenchShares shares = MakeBLSBenchShares();
+    while (state.KeepRunning()) {
+        assert(CBLSSignature::RecoverThresholdSignature(shares.vShares, shares.vIds, QUORUM_THRESHOLD, shares.quorumHash).IsValid());
+    }
+}
+
+BENCHMARK(BLSVerify);
+BENCHMARK(BLSBatchVerify);
+BENCHMARK(BLSAggregatePublicKeys);
+BENCHMARK(BLSAggregateSignatures);
+BENCHMARK(BLSRecoverThresholdSignature);
+BENCHMARK(BLSRecoverThresholdSignature_Cached);
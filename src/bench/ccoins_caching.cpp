@@ -6,6 +6,7 @@
 #include "bench.h"
 #include "coins.h"
 #include "policy/policy.h"
+#include "random.h"
 #include "wallet/crypter.h"
 
 #include <vector>
@@ -85,4 +86,34 @@ static void CCoinsCaching(benchmark::State& state)
     }
 }
 
+// Add, look up and spend a few thousand coins whose scripts are too big to be
+// stored inline, like asset transfers, then flush them into a parent cache.
+static void CCoinsCachingManyCoins(benchmark::State& state)
+{
+    FastRandomContext ctx(true);
+    std::vector<COutPoint> vOutpoints;
+    for (int i = 0; i < 10000; i++) {
+        vOutpoints.emplace_back(ctx.rand256(), ctx.randrange(4));
+    }
+    CTxOut txout(1 * CENT, CScript() << OP_DUP << OP_HASH160 << std::vector<unsigned char>(20, 1) << OP_EQUALVERIFY << OP_CHECKSIG << OP_RVN_ASSET << std::vector<unsigned char>(40, 2) << OP_DROP);
+
+    while (state.KeepRunning()) {
+        CCoinsView coinsDummy;
+        CCoinsViewCache base(&coinsDummy);
+        CCoinsViewCache coins(&base);
+        for (const COutPoint& outpoint : vOutpoints) {
+            coins.AddCoin(outpoint, Coin(txout, 1, false), false);
+        }
+        for (size_t i = 0; i < vOutpoints.size(); i++) {
+            assert(coins.HaveCoin(vOutpoints[i]));
+            if (i % 2) {
+                coins.SpendCoin(vOutpoints[i]);
+            }
+        }
+        assert(coins.DynamicMemoryUsage() > 0);
+        coins.Flush();
+    }
+}
+
 BENCHMARK(CCoinsCaching);
+BENCHMARK(CCoinsCachingManyCoins);
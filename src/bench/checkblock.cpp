@@ -5,9 +5,11 @@
 
 #include "bench.h"
 
+#include "arith_uint256.h"
 #include "chainparams.h"
 #include "validation.h"
 #include "streams.h"
+#include "consensus/tx_verify.h"
 #include "consensus/validation.h"
 
 namespace block_bench {
@@ -54,5 +56,22 @@ static void DeserializeAndCheckBlockTest(benchmark::State& state)
     }
 }
 
+// A 5000-input consolidation, where most of CheckTransaction is the duplicate input check
+static void CheckTransactionManyInputs(benchmark::State& state)
+{
+    CMutableTransaction mtx;
+    for (uint32_t i = 0; i < 5000; i++) {
+        mtx.vin.push_back(CTxIn(COutPoint(ArithToUint256(arith_uint256(i / 4 + 1) * 2654435761U), i % 4)));
+    }
+    mtx.vout.push_back(CTxOut(COIN, CScript() << OP_TRUE));
+    const CTransaction tx(mtx);
+
+    while (state.KeepRunning()) {
+        CValidationState validationState;
+        assert(CheckTransaction(tx, validationState));
+    }
+}
+
 BENCHMARK(DeserializeBlockTest);
 BENCHMARK(DeserializeAndCheckBlockTest);
+BENCHMARK(CheckTransactionManyInputs);
@@ -21,7 +21,7 @@ static const size_t BATCHES = 101;
 static const size_t BATCH_SIZE = 30;
 static const int PREVECTOR_SIZE = 28;
 static const int QUEUE_BATCH_SIZE = 128;
-static void CCheckQueueSpeed(benchmark::State& state)
+static void CCheckQueueSpeedThreads(benchmark::State& state, int nThreads)
 {
     struct FakeJobNoWork {
         bool operator()()
@@ -32,7 +32,7 @@ static void CCheckQueueSpeed(benchmark::State& state)
     };
     CCheckQueue<FakeJobNoWork> queue {QUEUE_BATCH_SIZE};
     boost::thread_group tg;
-    for (auto x = 0; x < std::max(MIN_CORES, GetNumCores()); ++x) {
+    for (auto x = 0; x < nThreads; ++x) {
        tg.create_thread([&]{queue.Thread();});
     }
     while (state.KeepRunning()) {
@@ -59,6 +59,19 @@ static void CCheckQueueSpeed(benchmark::State& state)
     tg.join_all();
 }
 
+static void CCheckQueueSpeed(benchmark::State& state)
+{
+    CCheckQueueSpeedThreads(state, std::max(MIN_CORES, GetNumCores()));
+}
+
+// Scaling of the same workload with a fixed number of worker threads
+static void CCheckQueueSpeed1Thread(benchmark::State& state) { CCheckQueueSpeedThreads(state, 1); }
+static void CCheckQueueSpeed2Threads(benchmark::State& state) { CCheckQueueSpeedThreads(state, 2); }
+static void CCheckQueueSpeed4Threads(benchmark::State& state) { CCheckQueueSpeedThreads(state, 4); }
+static void CCheckQueueSpeed8Threads(benchmark::State& state) { CCheckQueueSpeedThreads(state, 8); }
+static void CCheckQueueSpeed16Threads(benchmark::State& state) { CCheckQueueSpeedThreads(state, 16); }
+static void CCheckQueueSpeed32Threads(benchmark::State& state) { CCheckQueueSpeedThreads(state, 32); }
+
 // This Benchmark tests the CheckQueue with a slightly realistic workload,
 // where checks all contain a prevector that is indirect 50% of the time
 // and there is a little bit of work done between calls to Add.
@@ -101,4 +114,10 @@ static void CCheckQueueSpeedPrevectorJob(benchmark::State& state)
     tg.join_all();
 }
 BENCHMARK(CCheckQueueSpeed);
+BENCHMARK(CCheckQueueSpeed1Thread);
+BENCHMARK(CCheckQueueSpeed2Threads);
+BENCHMARK(CCheckQueueSpeed4Threads);
+BENCHMARK(CCheckQueueSpeed8Threads);
+BENCHMARK(CCheckQueueSpeed16Threads);
+BENCHMARK(CCheckQueueSpeed32Threads);
 BENCHMARK(CCheckQueueSpeedPrevectorJob);
@@ -4,6 +4,7 @@
 // file COPYING or http://www.opensource.org/licenses/mit-license.php.
 
 #include "bench.h"
+#include "assets/assets.h"
 #include "wallet/wallet.h"
 
 #include <set>
@@ -57,4 +58,45 @@ static void CoinSelection(benchmark::State& state)
     }
 }
 
+static void addAssetCoin(const CAmount& nAmount, const CWallet& wallet, std::vector<COutput>& vCoins)
+{
+    static int nextLockTime = 0;
+    CMutableTransaction tx;
+    tx.nLockTime = nextLockTime++; // so all transactions get different hashes
+    tx.vout.resize(1);
+    tx.vout[0].scriptPubKey = GetScriptForDestination(CKeyID());
+    CAssetTransfer("BENCHASSET", nAmount).ConstructTransaction(tx.vout[0].scriptPubKey);
+    CWalletTx* wtx = new CWalletTx(&wallet, MakeTransactionRef(std::move(tx)));
+
+    int nAge = 6 * 24;
+    COutput output(wtx, 0, nAge, true /* spendable */, true /* solvable */, true /* safe */);
+    vCoins.push_back(output);
+}
+
+// The same scenario for an asset, as transfer on a wallet holding many
+// outputs of one asset runs it
+static void AssetCoinSelection(benchmark::State& state)
+{
+    const CWallet wallet;
+    std::vector<COutput> vCoins;
+    LOCK(wallet.cs_wallet);
+
+    for (int i = 0; i < 1000; i++)
+        addAssetCoin(1000 * COIN, wallet, vCoins);
+    addAssetCoin(3 * COIN, wallet, vCoins);
+
+    while (state.KeepRunning()) {
+        std::set<CInputCoin> setCoinsRet;
+        CAmount nValueRet;
+        bool success = wallet.SelectAssetsMinConf(1003 * COIN, 1, 6, 0, "BENCHASSET", vCoins, setCoinsRet, nValueRet);
+        assert(success);
+        assert(nValueRet == 1003 * COIN);
+        assert(setCoinsRet.size() == 2);
+    }
+
+    for (COutput output : vCoins)
+        delete output.tx;
+}
+
 BENCHMARK(CoinSelection);
+BENCHMARK(AssetCoinSelection);
@@ -4,6 +4,7 @@
 // file COPYING or http://www.opensource.org/licenses/mit-license.php.
 
 #include <iostream>
+#include <string.h>
 
 #include "bench.h"
 #include "bloom.h"
@@ -53,6 +54,14 @@ static void SHA256_32b(benchmark::State& state)
     }
 }
 
+static void SHA256D64_1024(benchmark::State& state)
+{
+    std::vector<uint8_t> in(64 * 1024, 0);
+    while (state.KeepRunning()) {
+        SHA256D64(in.data(), in.data(), 1024);
+    }
+}
+
 static void SHA512(benchmark::State& state)
 {
     uint8_t hash[CSHA512::OUTPUT_SIZE];
@@ -93,12 +102,67 @@ static void FastRandom_1bit(benchmark::State& state)
     }
 }
 
+/* X16R stages chain 64-byte digests, so time them on 64-byte inputs */
+static void X16RStage(benchmark::State& state, X16RStageFunc func)
+{
+    unsigned char buf[64] = {0};
+    while (state.KeepRunning()) {
+        for (int i = 0; i < 10000; i++) {
+            func(buf, sizeof(buf), buf);
+        }
+    }
+}
+
+static void X16R_Groestl512_64b(benchmark::State& state)
+{
+    X16RStage(state, x16rStages.groestl512);
+}
+
+static void X16R_Shavite512_64b(benchmark::State& state)
+{
+    X16RStage(state, x16rStages.shavite512);
+}
+
+static void X16R_Echo512_64b(benchmark::State& state)
+{
+    X16RStage(state, x16rStages.echo512);
+}
+
+static void X16R_Simd512_64b(benchmark::State& state)
+{
+    X16RStage(state, [](const void* data, size_t len, void* out) {
+        sph_simd512_context ctx;
+        sph_simd512_init(&ctx);
+        sph_simd512(&ctx, data, len);
+        sph_simd512_close(&ctx, out);
+    });
+}
+
+static void X16R_80b(benchmark::State& state)
+{
+    std::vector<uint8_t> in(80, 0);
+    uint256 hashPrev = uint256S("0x0123456789abcdef0123456789abcdef0123456789abcdef0123456789abcdef");
+    while (state.KeepRunning()) {
+        for (int i = 0; i < 1000; i++) {
+            uint256 hash = HashX16R(in.begin(), in.end(), hashPrev);
+            memcpy(in.data(), hash.begin(), hash.size());
+        }
+    }
+}
+
 BENCHMARK(RIPEMD160);
 BENCHMARK(SHA1);
 BENCHMARK(SHA256);
 BENCHMARK(SHA512);
 
 BENCHMARK(SHA256_32b);
+BENCHMARK(SHA256D64_1024);
 BENCHMARK(SipHash_32b);
 BENCHMARK(FastRandom_32bit);
 BENCHMARK(FastRandom_1bit);
+
+BENCHMARK(X16R_Groestl512_64b);
+BENCHMARK(X16R_Shavite512_64b);
+BENCHMARK(X16R_Echo512_64b);
+BENCHMARK(X16R_Simd512_64b);
+BENCHMARK(X16R_80b);
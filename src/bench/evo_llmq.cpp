@@ -0,0 +1,88 @@
+// Copyright (c) 2026 The Mynta Core Developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include "bench.h"
+#include "synthchain.h"
+
+#include "consensus/validation.h"
+#include "evo/deterministicmns.h"
+#include "evo/evodb.h"
+#include "llmq/quorums.h"
+
+#include <vector>
+
+// Enough masternodes for a full quorum of every type
+static const size_t MASTERNODES = 500;
+static const size_t REGISTRATIONS_PER_BLOCK = 50;
+
+/**
+ * A synthetic chain whose first blocks register MASTERNODES masternodes,
+ * processed by a fresh deterministicMNManager over an in-memory evo db.
+ */
+struct EvoBenchSetup
+{
+    CSyntheticChain chain;
+
+    EvoBenchSetup()
+    {
+        evoDb.reset(new CEvoDB(1 << 20, true, true));
+        deterministicMNManager.reset(new CDeterministicMNManager(*evoDb));
+        deterministicMNManager->Init();
+        for (size_t nRegistered = 0; nRegistered < MASTERNODES; nRegistered += REGISTRATIONS_PER_BLOCK) {
+            std::vector<CTransactionRef> vtx;
+            for (size_t i = 0; i < REGISTRATIONS_PER_BLOCK; i++)
+                vtx.push_back(chain.MakeProRegTx());
+            ConnectBlock(chain.MakeBlock(vtx));
+        }
+    }
+
+    ~EvoBenchSetup()
+    {
+        deterministicMNManager.reset();
+        evoDb.reset();
+    }
+
+    void ConnectBlock(const CBlock& block)
+    {
+        CValidationState state;
+        const CBlockIndex* pindex = chain.Extend();
+        bool fProcessed = deterministicMNManager->ProcessBlock(block, pindex, state, false);
+        assert(fProcessed);
+    }
+};
+
+// A block that only pays the next masternode, as most blocks are
+static void DeterministicMNManagerProcessBlock(benchmark::State& state)
+{
+    EvoBenchSetup setup;
+    assert(deterministicMNManager->GetListAtChainTip()->GetValidMNsCount() == MASTERNODES);
+    while (state.KeepRunning()) {
+        setup.ConnectBlock(setup.chain.MakeBlock({}));
+    }
+}
+
+// Selecting the members and aggregating their operator keys, for a manager that has not built the quorum yet
+static void QuorumManagerBuildQuorum(benchmark::State& state, llmq::LLMQType type)
+{
+    EvoBenchSetup setup;
+    while (state.KeepRunning()) {
+        llmq::CQuorumManager manager;
+        llmq::CQuorumCPtr quorum = manager.BuildQuorum(type, setup.chain.Tip());
+        assert(quorum && quorum->fValid);
+    }
+}
+
+static void QuorumManagerBuildQuorum_50_60(benchmark::State& state)
+{
+    QuorumManagerBuildQuorum(state, llmq::LLMQType::LLMQ_50_60);
+}
+
+static void QuorumManagerBuildQuorum_400_60(benchmark::State& state)
+{
+    QuorumManagerBuildQuorum(state, llmq::LLMQType::LLMQ_400_60);
+}
+
+BENCHMARK(DeterministicMNManagerProcessBlock);
+BENCHMARK(QuorumManagerBuildQuorum_50_60);
+BENCHMARK(QuorumManagerBuildQuorum_400_60);
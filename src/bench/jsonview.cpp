@@ -0,0 +1,82 @@
+// Copyright (c) 2026 The Mynta Core Developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include "bench.h"
+
+#include "core_io.h"
+#include "primitives/block.h"
+#include "rpc/jsonview.h"
+#include "streams.h"
+#include "version.h"
+
+#include <univalue.h>
+
+namespace block_bench {
+#include "bench/data/block566553.raw.h"
+} // namespace block_bench
+
+/* The block's transactions as getblock verbosity 2 reports them */
+static std::string BlockJSON()
+{
+    CDataStream stream((const char*)block_bench::block566553,
+            (const char*)&block_bench::block566553[sizeof(block_bench::block566553)],
+            SER_NETWORK, PROTOCOL_VERSION);
+    CBlock block;
+    stream >> block;
+
+    UniValue txs(UniValue::VARR);
+    for (const auto& tx : block.vtx) {
+        UniValue objTx(UniValue::VOBJ);
+        TxToUniv(*tx, uint256(), objTx, true);
+        txs.push_back(objTx);
+    }
+    UniValue result(UniValue::VOBJ);
+    result.push_back(Pair("hash", block.GetHash().GetHex()));
+    result.push_back(Pair("tx", txs));
+    return result.write();
+}
+
+static void UniValueParseBlockJSON(benchmark::State& state)
+{
+    const std::string strJSON = BlockJSON();
+    while (state.KeepRunning()) {
+        UniValue val;
+        assert(val.read(strJSON));
+    }
+}
+
+static void UniValueViewParseBlockJSON(benchmark::State& state)
+{
+    const std::string strJSON = BlockJSON();
+    CJSONDocument doc;
+    while (state.KeepRunning()) {
+        assert(doc.read(strJSON));
+    }
+}
+
+static void UniValueWriteBlockJSON(benchmark::State& state)
+{
+    UniValue val;
+    assert(val.read(BlockJSON()));
+    while (state.KeepRunning()) {
+        std::string str = val.write();
+        assert(!str.empty());
+    }
+}
+
+static void UniValueViewWriteBlockJSON(benchmark::State& state)
+{
+    CJSONDocument doc;
+    assert(doc.read(BlockJSON()));
+    while (state.KeepRunning()) {
+        std::string str;
+        doc.Root().write(str);
+        assert(!str.empty());
+    }
+}
+
+BENCHMARK(UniValueParseBlockJSON);
+BENCHMARK(UniValueViewParseBlockJSON);
+BENCHMARK(UniValueWriteBlockJSON);
+BENCHMARK(UniValueViewWriteBlockJSON);
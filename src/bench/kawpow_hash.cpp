@@ -0,0 +1,73 @@
+// Copyright (c) 2026 The Mynta Core Developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include "bench.h"
+#include "hash.h"
+#include "primitives/block.h"
+#include "uint256.h"
+
+#include <crypto/ethash/include/ethash/progpow.hpp>
+
+/* Number of headers hashed per iteration */
+static const int HEADERS_PER_ITERATION = 1000;
+
+static CBlockHeader KAWPOWTestHeader()
+{
+    CBlockHeader header;
+    header.nVersion = 0x30000000;
+    header.hashPrevBlock = uint256S("0000000000000000000000000000000000000000000000000000000000000001");
+    header.hashMerkleRoot = uint256S("00000000000000000000000000000000000000000000000000000000000000aa");
+    header.nTime = 1700000000;
+    header.nBits = 0x1e00ffff;
+    header.nHeight = 100;
+    header.nNonce64 = 0;
+    header.mix_hash = uint256S("0123456789abcdef0123456789abcdef0123456789abcdef0123456789abcdef");
+    return header;
+}
+
+// Header-sync path (hash_no_verify), as used for every header received during IBD
+static void KAWPOWHash_OnlyMix_Headers(benchmark::State& state)
+{
+    CBlockHeader header = KAWPOWTestHeader();
+    while (state.KeepRunning()) {
+        for (int i = 0; i < HEADERS_PER_ITERATION; i++) {
+            header.nNonce64++;
+            KAWPOWHash_OnlyMix(header);
+        }
+    }
+}
+
+// The hex round trip KAWPOWHash_OnlyMix used to do around hash_no_verify
+static void KAWPOWHashConversion_Hex(benchmark::State& state)
+{
+    CBlockHeader header = KAWPOWTestHeader();
+    uint256 hashHeader = header.GetKAWPOWHeaderHash();
+    while (state.KeepRunning()) {
+        for (int i = 0; i < HEADERS_PER_ITERATION; i++) {
+            const auto header_hash = to_hash256(hashHeader.GetHex());
+            const auto mix_hash = to_hash256(header.mix_hash.GetHex());
+            hashHeader = uint256S(to_hex(header_hash));
+            header.mix_hash = uint256S(to_hex(mix_hash));
+        }
+    }
+}
+
+// The same conversions done in binary
+static void KAWPOWHashConversion_Binary(benchmark::State& state)
+{
+    CBlockHeader header = KAWPOWTestHeader();
+    uint256 hashHeader = header.GetKAWPOWHeaderHash();
+    while (state.KeepRunning()) {
+        for (int i = 0; i < HEADERS_PER_ITERATION; i++) {
+            const auto header_hash = ToEthashHash256(hashHeader);
+            const auto mix_hash = ToEthashHash256(header.mix_hash);
+            hashHeader = FromEthashHash256(header_hash);
+            header.mix_hash = FromEthashHash256(mix_hash);
+        }
+    }
+}
+
+BENCHMARK(KAWPOWHash_OnlyMix_Headers);
+BENCHMARK(KAWPOWHashConversion_Hex);
+BENCHMARK(KAWPOWHashConversion_Binary);
@@ -0,0 +1,58 @@
+// Copyright (c) 2026 The Mynta Core Developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include "bench.h"
+
+#include "LibBoolEE.h"
+#include "assets/assets.h"
+
+#include <string>
+#include <vector>
+
+// A restricted asset's verifier as ContextualCheckVerifierString sees it, qualifier tags removed
+static const std::string VERIFIER_FORMULA = "KYC & RESIDENT & (ACCREDITED | ISSUER) & !BANNED & (ISSUER | !LOCKUP)";
+static const std::string VERIFIER_STRING = "#KYC & #RESIDENT & (#ACCREDITED | #ISSUER) & !#BANNED & (#ISSUER | !#LOCKUP)";
+static const std::vector<std::string> VERIFIER_VARIABLES = {"ACCREDITED", "BANNED", "ISSUER", "KYC", "LOCKUP", "RESIDENT"};
+
+// Number of address checks per iteration, one per valuation of the variables
+static const uint64_t VALUATIONS = 1 << 6;
+
+// Parsing the formula again for every address
+static void LibBoolEEResolve(benchmark::State& state)
+{
+    std::vector<LibBoolEE::Vals> vValuations;
+    for (uint64_t valuation = 0; valuation < VALUATIONS; valuation++) {
+        LibBoolEE::Vals vals;
+        for (size_t i = 0; i < VERIFIER_VARIABLES.size(); i++)
+            vals.insert(LibBoolEE::Val(VERIFIER_VARIABLES[i], (valuation >> i) & 1));
+        vValuations.push_back(vals);
+    }
+    while (state.KeepRunning()) {
+        for (const LibBoolEE::Vals& vals : vValuations)
+            LibBoolEE::resolve(VERIFIER_FORMULA, vals);
+    }
+}
+
+// Running the program the formula was compiled to once
+static void LibBoolEEEvaluate(benchmark::State& state)
+{
+    LibBoolEE::Program program;
+    assert(LibBoolEE::compile(VERIFIER_FORMULA, VERIFIER_VARIABLES, program));
+    while (state.KeepRunning()) {
+        for (uint64_t valuation = 0; valuation < VALUATIONS; valuation++)
+            LibBoolEE::evaluate(program, valuation);
+    }
+}
+
+// What a verifier string costs once per script it is deserialized from
+static void VerifierStringCompile(benchmark::State& state)
+{
+    while (state.KeepRunning()) {
+        assert(CompileVerifierString(VERIFIER_STRING));
+    }
+}
+
+BENCHMARK(LibBoolEEResolve);
+BENCHMARK(LibBoolEEEvaluate);
+BENCHMARK(VerifierStringCompile);
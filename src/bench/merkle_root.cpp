@@ -0,0 +1,43 @@
+// Copyright (c) 2026 The Mynta Core Developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include "bench.h"
+
+#include "consensus/merkle.h"
+#include "random.h"
+#include "uint256.h"
+
+static const size_t MERKLE_LEAVES = 9001;
+
+static std::vector<uint256> RandomLeaves()
+{
+    FastRandomContext rng(true);
+    std::vector<uint256> leaves(MERKLE_LEAVES);
+    for (uint256& leaf : leaves)
+        leaf = rng.rand256();
+    return leaves;
+}
+
+static void MerkleRoot(benchmark::State& state)
+{
+    const std::vector<uint256> leaves = RandomLeaves();
+    while (state.KeepRunning()) {
+        bool mutated = false;
+        ComputeMerkleRoot(leaves, &mutated);
+    }
+}
+
+//! The branch of every hundredth leaf, as a proof for many transactions needs
+static void MerkleBranches(benchmark::State& state)
+{
+    const std::vector<uint256> leaves = RandomLeaves();
+    while (state.KeepRunning()) {
+        const CMerkleTree tree(leaves);
+        for (uint32_t pos = 0; pos < leaves.size(); pos += 100)
+            tree.Branch(pos);
+    }
+}
+
+BENCHMARK(MerkleRoot);
+BENCHMARK(MerkleBranches);
@@ -0,0 +1,79 @@
+// Copyright (c) 2026 The Mynta Core Developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include "bench.h"
+#include "synthchain.h"
+
+#include "assets/atomicswap.h"
+
+#include <string>
+#include <vector>
+
+// Offers resting on the book, spread over a few pairs
+static const size_t BOOK_OFFERS = 5000;
+static const size_t BOOK_PAIRS = 10;
+
+static std::vector<CAtomicSwapOffer> MakeBookOffers(CSyntheticChain& chain, size_t nCount, int nHeight)
+{
+    std::vector<CAtomicSwapOffer> vOffers;
+    vOffers.reserve(nCount);
+    for (size_t i = 0; i < nCount; i++) {
+        // Both sides of each pair, against MYNTA
+        const std::string strAsset = CSyntheticChain::AssetName(i % BOOK_PAIRS);
+        if ((i / BOOK_PAIRS) % 2)
+            vOffers.push_back(chain.MakeOffer(strAsset, "", nHeight));
+        else
+            vOffers.push_back(chain.MakeOffer("", strAsset, nHeight));
+    }
+    return vOffers;
+}
+
+// Filling a book and taking every offer off it again
+static void OrderBookAddRemove(benchmark::State& state)
+{
+    CSyntheticChain chain;
+    const std::vector<CAtomicSwapOffer> vOffers = MakeBookOffers(chain, BOOK_OFFERS, 100);
+    CAtomicSwapOrderBook book;
+    while (state.KeepRunning()) {
+        for (const CAtomicSwapOffer& offer : vOffers)
+            book.AddOffer(offer);
+        for (const CAtomicSwapOffer& offer : vOffers)
+            book.RemoveOffer(offer.offerHash);
+    }
+}
+
+static void OrderBookBestOffer(benchmark::State& state)
+{
+    CSyntheticChain chain;
+    CAtomicSwapOrderBook book;
+    for (const CAtomicSwapOffer& offer : MakeBookOffers(chain, BOOK_OFFERS, 100))
+        book.AddOffer(offer);
+    while (state.KeepRunning()) {
+        for (size_t i = 0; i < BOOK_PAIRS; i++) {
+            const std::string strAsset = CSyntheticChain::AssetName(i);
+            assert(book.GetBestOffer(strAsset, "", true));
+            assert(book.GetBestOffer(strAsset, "", false));
+        }
+    }
+}
+
+// The book as a block comes in: a block's worth of new offers and the expired ones dropped
+static void OrderBookBlockCleanup(benchmark::State& state)
+{
+    CSyntheticChain chain;
+    CAtomicSwapOrderBook book;
+    int nHeight = 100;
+    for (const CAtomicSwapOffer& offer : MakeBookOffers(chain, BOOK_OFFERS, nHeight))
+        book.AddOffer(offer);
+    while (state.KeepRunning()) {
+        nHeight++;
+        for (const CAtomicSwapOffer& offer : MakeBookOffers(chain, BOOK_OFFERS / 100, nHeight))
+            book.AddOffer(offer);
+        book.CleanupExpired(nHeight);
+    }
+}
+
+BENCHMARK(OrderBookAddRemove);
+BENCHMARK(OrderBookBestOffer);
+BENCHMARK(OrderBookBlockCleanup);
@@ -0,0 +1,344 @@
+// Copyright (c) 2026 The Mynta Core Developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include "bench/replay.h"
+
+#include "blockprefetch.h"
+#include "chainparams.h"
+#include "consensus/validation.h"
+#include "evo/providertx.h"
+#include "random.h"
+#include "scheduler.h"
+#include "script/sigcache.h"
+#include "txdb.h"
+#include "util.h"
+#include "utiltime.h"
+#include "validation.h"
+#include "validationinterface.h"
+#include "validationstats.h"
+#include "assets/assets.h"
+#include "assets/assetdb.h"
+#include "assets/assetsnapshotdb.h"
+#include "assets/restricteddb.h"
+#include "assets/snapshotrequestdb.h"
+
+#include <univalue.h>
+
+#include <algorithm>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <vector>
+
+#include <boost/bind/bind.hpp>
+#include <boost/thread.hpp>
+
+#ifndef WIN32
+#include <sys/resource.h>
+#endif
+
+namespace {
+
+struct CIOCounters {
+    int64_t nReadBytes{-1};
+    int64_t nWriteBytes{-1};
+};
+
+/** Bytes this process made the storage layer read and write, -1 where the platform doesn't say */
+CIOCounters GetIOCounters()
+{
+    CIOCounters counters;
+    std::ifstream file("/proc/self/io");
+    std::string strKey;
+    int64_t nValue;
+    while (file >> strKey >> nValue) {
+        if (strKey == "read_bytes:")
+            counters.nReadBytes = nValue;
+        else if (strKey == "write_bytes:")
+            counters.nWriteBytes = nValue;
+    }
+    return counters;
+}
+
+/** Peak resident set size in bytes, -1 if unknown */
+int64_t GetPeakRSS()
+{
+#ifndef WIN32
+    struct rusage usage;
+    if (getrusage(RUSAGE_SELF, &usage) != 0)
+        return -1;
+#ifdef __APPLE__
+    return usage.ru_maxrss;
+#else
+    return (int64_t)usage.ru_maxrss * 1024;
+#endif
+#else
+    return -1;
+#endif
+}
+
+int64_t GetDirectorySize(const fs::path& path)
+{
+    int64_t nSize = 0;
+    boost::system::error_code ec;
+    for (fs::recursive_directory_iterator it(path, ec), end; !ec && it != end; it.increment(ec)) {
+        if (fs::is_regular_file(it->status()))
+            nSize += fs::file_size(it->path(), ec);
+    }
+    return nSize;
+}
+
+/** The file itself, or the blk?????.dat files of a directory in the order they were written */
+std::vector<fs::path> ListBlockFiles(const fs::path& path)
+{
+    std::vector<fs::path> vFiles;
+    if (!fs::is_directory(path)) {
+        vFiles.push_back(path);
+        return vFiles;
+    }
+    for (fs::directory_iterator it(path), end; it != end; ++it) {
+        const std::string strName = it->path().filename().string();
+        if (strName.size() == 12 && strName.compare(0, 3, "blk") == 0 && strName.compare(8, 4, ".dat") == 0)
+            vFiles.push_back(it->path());
+    }
+    std::sort(vFiles.begin(), vFiles.end());
+    return vFiles;
+}
+
+/**
+ * A fresh datadir set up as AppInitMain sets one up: the block tree,
+ * chainstate and asset databases, the script, header and transaction
+ * workers and a scheduler thread for the validation callbacks.
+ */
+class CReplayNode
+{
+private:
+    fs::path pathDatadir;
+    bool fKeepDatadir;
+    CScheduler scheduler;
+    boost::thread_group threadGroup;
+
+public:
+    CReplayNode(const CReplayOptions& options) : fKeepDatadir(options.fKeepDatadir)
+    {
+        pathDatadir = fs::temp_directory_path() / strprintf("replay_mynta_%lu_%i", (unsigned long)GetTime(), (int)GetRand(100000));
+        fs::create_directories(pathDatadir);
+        gArgs.ForceSetArg("-datadir", pathDatadir.string());
+        ClearDatadirCache();
+
+        InitSignatureCache();
+        InitScriptExecutionCache();
+        // Nothing subscribes to messages or reads them back here
+        fMessaging = false;
+
+        // Split the cache the way AppInitMain splits -dbcache
+        int64_t nTotalCache = std::max(std::min(options.nDbCacheMiB, nMaxDbCache), nMinDbCache) << 20;
+        const int64_t nBlockTreeDBCache = std::min(nTotalCache / 8, nMaxBlockDBCache << 20);
+        nTotalCache -= nBlockTreeDBCache;
+        const int64_t nCoinDBCache = std::min(std::min(nTotalCache / 2, (nTotalCache / 4) + (1 << 23)), nMaxCoinsDBCache << 20);
+        nTotalCache -= nCoinDBCache;
+        nCoinCacheUsage = nTotalCache;
+
+        threadGroup.create_thread(boost::bind(&TraceThread<CScheduler::Function>, "scheduler", CScheduler::Function(boost::bind(&CScheduler::serviceQueue, &scheduler))));
+        GetMainSignals().RegisterBackgroundSignalScheduler(scheduler);
+
+        pblocktree = new CBlockTreeDB(nBlockTreeDBCache, false, true);
+        passetsdb = new CAssetsDB(nBlockTreeDBCache, false, true);
+        passets = new CAssetsCache();
+        passetsCache = new CAssetNameLRUCache<CDatabasedAssetData>(MAX_CACHE_ASSETS_SIZE, MAX_CACHE_ASSETS_USAGE);
+        prestricteddb = new CRestrictedDB(nBlockTreeDBCache, false, true);
+        passetsVerifierCache = new CAssetNameLRUCache<CNullAssetTxVerifierString>(MAX_CACHE_ASSETS_SIZE, MAX_CACHE_ASSETS_USAGE);
+        passetsQualifierCache = new CAssetAddressLRUCache<int8_t>(MAX_CACHE_ASSETS_SIZE, MAX_CACHE_ASSETS_USAGE);
+        passetsRestrictionCache = new CAssetAddressLRUCache<int8_t>(MAX_CACHE_ASSETS_SIZE, MAX_CACHE_ASSETS_USAGE);
+        passetsGlobalRestrictionCache = new CAssetNameLRUCache<int8_t>(MAX_CACHE_ASSETS_SIZE, MAX_CACHE_ASSETS_USAGE);
+        pSnapshotRequestDb = new CSnapshotRequestDB(nBlockTreeDBCache, false, true);
+        pAssetSnapshotDb = new CAssetSnapshotDB(nBlockTreeDBCache, false, true);
+        pDistributeSnapshotDb = new CDistributeSnapshotRequestDB(nBlockTreeDBCache, false, true);
+
+        pcoinsdbview = new CCoinsViewDB(nCoinDBCache, false, true);
+        pcoinsbuffer = new CCoinsViewFlushBuffer(pcoinsdbview, pcoinsdbview);
+        pcoinsTip = new CCoinsViewCache(pcoinsbuffer);
+
+        nScriptCheckThreads = options.nScriptThreads;
+        for (int i = 0; i < nScriptCheckThreads - 1; i++)
+            threadGroup.create_thread(boost::bind(&ThreadScriptCheck, i));
+        for (int i = 0; i < nScriptCheckThreads - 1; i++)
+            threadGroup.create_thread(&ThreadHeaderCheck);
+        for (int i = 0; i < nScriptCheckThreads - 1; i++)
+            threadGroup.create_thread(&ThreadBlockLoadCheck);
+        for (int i = 0; i < nScriptCheckThreads - 1; i++)
+            threadGroup.create_thread(&ThreadTxPrepare);
+        for (int i = 0; i < nScriptCheckThreads - 1; i++)
+            threadGroup.create_thread(&ThreadProviderSigCheck);
+        if (options.nPrefetchThreads > 0)
+            g_blockPrefetcher.Start(pcoinsTip, options.nPrefetchThreads);
+    }
+
+    ~CReplayNode()
+    {
+        g_blockPrefetcher.Stop();
+        threadGroup.interrupt_all();
+        threadGroup.join_all();
+        GetMainSignals().FlushBackgroundCallbacks();
+        GetMainSignals().UnregisterBackgroundSignalScheduler();
+        UnloadBlockIndex();
+        delete pcoinsTip;
+        pcoinsTip = nullptr;
+        delete pcoinsbuffer;
+        pcoinsbuffer = nullptr;
+        delete pcoinsdbview;
+        pcoinsdbview = nullptr;
+        delete pDistributeSnapshotDb;
+        pDistributeSnapshotDb = nullptr;
+        delete pAssetSnapshotDb;
+        pAssetSnapshotDb = nullptr;
+        delete pSnapshotRequestDb;
+        pSnapshotRequestDb = nullptr;
+        delete passetsGlobalRestrictionCache;
+        passetsGlobalRestrictionCache = nullptr;
+        delete passetsRestrictionCache;
+        passetsRestrictionCache = nullptr;
+        delete passetsQualifierCache;
+        passetsQualifierCache = nullptr;
+        delete passetsVerifierCache;
+        passetsVerifierCache = nullptr;
+        delete prestricteddb;
+        prestricteddb = nullptr;
+        delete passetsCache;
+        passetsCache = nullptr;
+        delete passets;
+        passets = nullptr;
+        delete passetsdb;
+        passetsdb = nullptr;
+        delete pblocktree;
+        pblocktree = nullptr;
+        if (!fKeepDatadir)
+            fs::remove_all(pathDatadir);
+    }
+
+    const fs::path& Datadir() const { return pathDatadir; }
+};
+
+UniValue PhaseStatsToJSON()
+{
+    UniValue phases(UniValue::VOBJ);
+    for (size_t i = 0; i < VALIDATION_PHASE_COUNT; i++) {
+        const ValidationPhase phase = static_cast<ValidationPhase>(i);
+        const CValidationPhaseStats stats = GetValidationPhaseStats(phase);
+        UniValue obj(UniValue::VOBJ);
+        obj.push_back(Pair("count", stats.nCount));
+        obj.push_back(Pair("total_ms", stats.nTotalMicros * 0.001));
+        obj.push_back(Pair("mean_ms", stats.nCount ? stats.nTotalMicros * 0.001 / stats.nCount : 0.0));
+        obj.push_back(Pair("p50_ms", stats.nP50Micros * 0.001));
+        obj.push_back(Pair("p90_ms", stats.nP90Micros * 0.001));
+        obj.push_back(Pair("p99_ms", stats.nP99Micros * 0.001));
+        obj.push_back(Pair("max_ms", stats.nMaxMicros * 0.001));
+        phases.push_back(Pair(ValidationPhaseName(phase), obj));
+    }
+    return phases;
+}
+
+} // namespace
+
+bool RunChainReplay(const CReplayOptions& options, std::string& strError)
+{
+    const std::vector<fs::path> vFiles = ListBlockFiles(options.pathBlocks);
+    if (vFiles.empty() || !fs::exists(vFiles.front())) {
+        strError = strprintf("No block files found at %s", options.pathBlocks.string());
+        return false;
+    }
+
+    const CChainParams& chainparams = GetParams();
+    CReplayNode node(options);
+    if (!LoadGenesisBlock(chainparams)) {
+        strError = "LoadGenesisBlock failed";
+        return false;
+    }
+    {
+        CValidationState state;
+        if (!ActivateBestChain(state, chainparams)) {
+            strError = "Connecting the genesis block failed: " + FormatStateMessage(state);
+            return false;
+        }
+    }
+
+    ResetValidationStats();
+    const CIOCounters ioStart = GetIOCounters();
+    const int nStartHeight = chainActive.Height();
+    const int64_t nStart = GetTimeMicros();
+
+    for (const fs::path& path : vFiles) {
+        FILE* file = fsbridge::fopen(path, "rb");
+        if (!file) {
+            strError = strprintf("Can't open %s", path.string());
+            return false;
+        }
+        std::cout << "Replaying " << path.string() << std::endl;
+        // Closes the file
+        LoadExternalBlockFile(chainparams, file);
+        // Connect what the file made the best chain before reading the next one,
+        // as ThreadImport does after each -loadblock file
+        CValidationState state;
+        if (!ActivateBestChain(state, chainparams)) {
+            strError = "ActivateBestChain failed: " + FormatStateMessage(state);
+            return false;
+        }
+    }
+    FlushStateToDisk();
+    GetMainSignals().FlushBackgroundCallbacks();
+
+    const int64_t nMicros = GetTimeMicros() - nStart;
+    const CIOCounters ioEnd = GetIOCounters();
+    const int nBlocks = chainActive.Height() - nStartHeight;
+    if (nBlocks <= 0) {
+        strError = "No block connected; are the block files of this network and do they start at genesis?";
+        return false;
+    }
+
+    const double dSeconds = nMicros * 0.000001;
+    UniValue result(UniValue::VOBJ);
+    result.push_back(Pair("chain", ChainNameFromCommandLine()));
+    result.push_back(Pair("blocks", nBlocks));
+    result.push_back(Pair("height", chainActive.Height()));
+    result.push_back(Pair("seconds", dSeconds));
+    result.push_back(Pair("blocks_per_sec", nBlocks / dSeconds));
+    result.push_back(Pair("dbcache_mib", options.nDbCacheMiB));
+    result.push_back(Pair("script_threads", options.nScriptThreads));
+    result.push_back(Pair("prefetch_threads", options.nPrefetchThreads));
+    result.push_back(Pair("peak_rss_bytes", GetPeakRSS()));
+    UniValue io(UniValue::VOBJ);
+    io.push_back(Pair("read_bytes", ioStart.nReadBytes < 0 || ioEnd.nReadBytes < 0 ? -1 : ioEnd.nReadBytes - ioStart.nReadBytes));
+    io.push_back(Pair("write_bytes", ioStart.nWriteBytes < 0 || ioEnd.nWriteBytes < 0 ? -1 : ioEnd.nWriteBytes - ioStart.nWriteBytes));
+    io.push_back(Pair("blocks_dir_bytes", GetDirectorySize(node.Datadir() / "blocks")));
+    io.push_back(Pair("chainstate_bytes", GetDirectorySize(node.Datadir() / "chainstate")));
+    io.push_back(Pair("assets_bytes", GetDirectorySize(node.Datadir() / "assets")));
+    result.push_back(Pair("io", io));
+    result.push_back(Pair("phases", PhaseStatsToJSON()));
+
+    std::cout << std::fixed << std::setprecision(3)
+              << "Connected " << nBlocks << " blocks in " << dSeconds << "s, "
+              << nBlocks / dSeconds << " blocks/s" << std::endl;
+    std::cout << "#Phase,count,total_ms,mean_ms,p50_ms,p90_ms,p99_ms,max_ms" << std::endl;
+    for (size_t i = 0; i < VALIDATION_PHASE_COUNT; i++) {
+        const ValidationPhase phase = static_cast<ValidationPhase>(i);
+        const CValidationPhaseStats stats = GetValidationPhaseStats(phase);
+        std::cout << ValidationPhaseName(phase) << "," << stats.nCount << "," << stats.nTotalMicros * 0.001 << ","
+                  << (stats.nCount ? stats.nTotalMicros * 0.001 / stats.nCount : 0.0) << ","
+                  << stats.nP50Micros * 0.001 << "," << stats.nP90Micros * 0.001 << ","
+                  << stats.nP99Micros * 0.001 << "," << stats.nMaxMicros * 0.001 << std::endl;
+    }
+    std::cout << "Peak RSS: " << GetPeakRSS() << " bytes, read " << io["read_bytes"].get_int64()
+              << " bytes, wrote " << io["write_bytes"].get_int64() << " bytes" << std::endl;
+    std::cout.copyfmt(std::ios(nullptr));
+
+    if (!options.pathOutput.empty()) {
+        std::ofstream file(options.pathOutput.string());
+        if (!file) {
+            strError = strprintf("Can't write %s", options.pathOutput.string());
+            return false;
+        }
+        file << result.write(2) << std::endl;
+    }
+    return true;
+}
@@ -0,0 +1,37 @@
+// Copyright (c) 2026 The Mynta Core Developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#ifndef MYNTA_BENCH_REPLAY_H
+#define MYNTA_BENCH_REPLAY_H
+
+#include "fs.h"
+
+#include <stdint.h>
+#include <string>
+
+struct CReplayOptions {
+    //! A block file, or a directory whose blk?????.dat files are replayed in order
+    fs::path pathBlocks;
+    //! Where the results are written as JSON, if set
+    fs::path pathOutput;
+    //! Split between the databases and the coins cache the way -dbcache is
+    int64_t nDbCacheMiB{0};
+    //! Script check threads, counting the validating thread
+    int nScriptThreads{1};
+    //! Threads reading the inputs of blocks ahead of connecting them, 0 for none
+    int nPrefetchThreads{0};
+    //! Keep the temporary datadir instead of removing it
+    bool fKeepDatadir{false};
+};
+
+/**
+ * Connect the blocks of stored block files, starting from genesis, in a
+ * fresh temporary datadir with the databases and worker threads a node
+ * runs, then report blocks per second, the validation profiler's phases,
+ * the peak resident memory and the bytes read and written. Returns false
+ * with strError set if the replay could not be set up or ran no block.
+ */
+bool RunChainReplay(const CReplayOptions& options, std::string& strError);
+
+#endif // MYNTA_BENCH_REPLAY_H
@@ -0,0 +1,59 @@
+// Copyright (c) 2026 The Mynta Core Developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include "bench.h"
+
+#include "utilstrencodings.h"
+
+#include <string>
+#include <vector>
+
+// About the size of a large block as returned by getblock with verbosity 0
+static const size_t HEX_BENCH_BYTES = 1000000;
+
+static std::vector<unsigned char> HexBenchData()
+{
+    std::vector<unsigned char> data(HEX_BENCH_BYTES);
+    for (size_t i = 0; i < data.size(); i++)
+        data[i] = i * 131 + (i >> 8);
+    return data;
+}
+
+static void HexStrLarge(benchmark::State& state)
+{
+    const std::vector<unsigned char> data = HexBenchData();
+    while (state.KeepRunning()) {
+        HexStr(data);
+    }
+}
+
+static void ParseHexLarge(benchmark::State& state)
+{
+    const std::string str = HexStr(HexBenchData());
+    while (state.KeepRunning()) {
+        ParseHex(str);
+    }
+}
+
+static void IsHexLarge(benchmark::State& state)
+{
+    const std::string str = HexStr(HexBenchData());
+    while (state.KeepRunning()) {
+        IsHex(str);
+    }
+}
+
+// A transaction id, the common case in RPC replies
+static void HexStrHash(benchmark::State& state)
+{
+    const std::vector<unsigned char> data(32, 0xa5);
+    while (state.KeepRunning()) {
+        HexStr(data);
+    }
+}
+
+BENCHMARK(HexStrLarge);
+BENCHMARK(ParseHexLarge);
+BENCHMARK(IsHexLarge);
+BENCHMARK(HexStrHash);
@@ -0,0 +1,101 @@
+// Copyright (c) 2026 The Mynta Core Developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include "synthchain.h"
+
+#include "amount.h"
+#include "arith_uint256.h"
+#include "assets/atomicswap.h"
+#include "bls/bls.h"
+#include "evo/providertx.h"
+#include "evo/specialtx.h"
+#include "hash.h"
+#include "netaddress.h"
+#include "script/standard.h"
+
+#include <arpa/inet.h>
+
+CSyntheticChain::CSyntheticChain(uint64_t nSeed) : rng(ArithToUint256(arith_uint256(nSeed)))
+{
+}
+
+const CBlockIndex* CSyntheticChain::Extend()
+{
+    CBlockIndex* pprev = vIndexes.empty() ? nullptr : &vIndexes.back();
+    vBlockHashes.push_back(rng.rand256());
+    vIndexes.emplace_back();
+    CBlockIndex& index = vIndexes.back();
+    index.phashBlock = &vBlockHashes.back();
+    index.pprev = pprev;
+    index.nHeight = pprev ? pprev->nHeight + 1 : 0;
+    index.nTime = 1700000000 + index.nHeight * 60;
+    index.BuildSkip();
+    return &index;
+}
+
+CBlock CSyntheticChain::MakeBlock(const std::vector<CTransactionRef>& vtx) const
+{
+    CMutableTransaction coinbase;
+    coinbase.vin.resize(1);
+    coinbase.vin[0].prevout.SetNull();
+    coinbase.vin[0].scriptSig = CScript() << (Height() + 1) << OP_0;
+    coinbase.vout.emplace_back(50 * COIN, CScript() << OP_TRUE);
+
+    CBlock block;
+    block.hashPrevBlock = Tip() ? Tip()->GetBlockHash() : uint256();
+    block.vtx.push_back(MakeTransactionRef(std::move(coinbase)));
+    block.vtx.insert(block.vtx.end(), vtx.begin(), vtx.end());
+    return block;
+}
+
+CTransactionRef CSyntheticChain::MakeProRegTx()
+{
+    const uint32_t nRegistration = nRegistrations++;
+
+    CProRegTx proTx;
+    proTx.collateralOutpoint = COutPoint(rng.rand256(), 0);
+    struct in_addr ipv4;
+    ipv4.s_addr = htonl(0x0a000000 | nRegistration);
+    proTx.addr = CService(ipv4, 8770);
+    const uint256 hashOwner = rng.rand256();
+    proTx.keyIDOwner = CKeyID(Hash160(hashOwner.begin(), hashOwner.end()));
+    proTx.keyIDVoting = proTx.keyIDOwner;
+    CBLSSecretKey skOperator;
+    GetOperatorKey(nRegistration, skOperator);
+    proTx.vchOperatorPubKey = skOperator.GetPublicKey().ToBytes();
+    proTx.scriptPayout = GetScriptForDestination(proTx.keyIDOwner);
+
+    CMutableTransaction tx;
+    tx.nVersion = 3;
+    tx.nType = static_cast<uint16_t>(TxType::TRANSACTION_PROVIDER_REGISTER);
+    tx.vin.emplace_back(COutPoint(rng.rand256(), 0));
+    SetTxPayload(tx, proTx);
+    return MakeTransactionRef(std::move(tx));
+}
+
+void CSyntheticChain::GetOperatorKey(uint32_t nRegistration, CBLSSecretKey& skOperator)
+{
+    skOperator.SetSecretKeyFromSeed(ArithToUint256(arith_uint256(nRegistration + 1)));
+}
+
+std::string CSyntheticChain::AssetName(size_t n)
+{
+    return "SYNTH" + std::to_string(n);
+}
+
+CAtomicSwapOffer CSyntheticChain::MakeOffer(const std::string& makerAsset, const std::string& takerAsset, int nHeight)
+{
+    CAtomicSwapOffer offer;
+    offer.offerHash = rng.rand256();
+    offer.makerAssetName = makerAsset;
+    offer.makerAmount = 100 * COIN;
+    offer.makerAddress = CScript() << OP_TRUE;
+    offer.takerAssetName = takerAsset;
+    // Prices in steps of a tenth of a percent around one
+    offer.takerAmount = offer.makerAmount + ((CAmount)rng.randrange(61) - 30) * COIN / 10;
+    offer.hashLock = rng.rand256();
+    offer.timeoutBlocks = 10 + rng.randrange(200);
+    offer.createdHeight = nHeight;
+    return offer;
+}
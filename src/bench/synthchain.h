@@ -0,0 +1,73 @@
+// Copyright (c) 2026 The Mynta Core Developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#ifndef MYNTA_BENCH_SYNTHCHAIN_H
+#define MYNTA_BENCH_SYNTHCHAIN_H
+
+#include "chain.h"
+#include "primitives/block.h"
+#include "primitives/transaction.h"
+#include "random.h"
+#include "uint256.h"
+
+#include <deque>
+#include <string>
+#include <vector>
+
+class CAtomicSwapOffer;
+class CBLSSecretKey;
+
+/**
+ * Made up chain data for the benchmarks of the code particular to Mynta:
+ * block indexes linked by random hashes, blocks registering masternodes,
+ * asset names and DEX offers. It is all drawn from a seeded generator, so
+ * every run measures the same chain, and nothing needs a datadir.
+ */
+class CSyntheticChain
+{
+private:
+    FastRandomContext rng;
+    // Deques, so that neither the indexes nor the hashes they point at move
+    std::deque<uint256> vBlockHashes;
+    std::deque<CBlockIndex> vIndexes;
+    uint32_t nRegistrations{0};
+
+public:
+    explicit CSyntheticChain(uint64_t nSeed = 1);
+
+    uint256 RandHash() { return rng.rand256(); }
+    uint64_t RandRange(uint64_t nRange) { return rng.randrange(nRange); }
+
+    //! -1 while the chain is empty
+    int Height() const { return (int)vIndexes.size() - 1; }
+    const CBlockIndex* Tip() const { return vIndexes.empty() ? nullptr : &vIndexes.back(); }
+    const CBlockIndex* operator[](int nHeight) const { return &vIndexes.at(nHeight); }
+
+    /** Add a block index with a random hash on top of the tip */
+    const CBlockIndex* Extend();
+
+    /** A block of a coinbase followed by vtx, for the height after the tip */
+    CBlock MakeBlock(const std::vector<CTransactionRef>& vtx) const;
+
+    /**
+     * A provider registration holding what CDeterministicMNManager reads
+     * from one, with a unique service and an operator key from
+     * GetOperatorKey. It is not signed and spends nothing.
+     */
+    CTransactionRef MakeProRegTx();
+
+    /** Operator key of the registration made nRegistration-th */
+    static void GetOperatorKey(uint32_t nRegistration, CBLSSecretKey& skOperator);
+
+    /** A valid root asset name, different for each n */
+    static std::string AssetName(size_t n);
+
+    /**
+     * An active offer giving some makerAsset for takerAsset at a price within
+     * a few percent of one, so offers of a pair share price levels.
+     */
+    CAtomicSwapOffer MakeOffer(const std::string& makerAsset, const std::string& takerAsset, int nHeight);
+};
+
+#endif // MYNTA_BENCH_SYNTHCHAIN_H
@@ -0,0 +1,57 @@
+// Copyright (c) 2026 The Mynta Core Developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#if defined(HAVE_CONFIG_H)
+#include "config/mynta-config.h"
+#endif
+
+#include "blockcompression.h"
+
+#include <ios>
+
+#ifdef HAVE_SNAPPY
+#include <snappy.h>
+#endif
+
+bool CanCompressDiskRecords()
+{
+#ifdef HAVE_SNAPPY
+    return true;
+#else
+    return false;
+#endif
+}
+
+bool CompressDiskRecord(const std::vector<unsigned char>& vData, std::vector<unsigned char>& vStored)
+{
+#ifdef HAVE_SNAPPY
+    vStored.resize(snappy::MaxCompressedLength(vData.size()));
+    size_t nStored;
+    snappy::RawCompress((const char*)vData.data(), vData.size(), (char*)vStored.data(), &nStored);
+    if (nStored >= vData.size()) {
+        vStored.clear();
+        return false;
+    }
+    vStored.resize(nStored);
+    return true;
+#else
+    return false;
+#endif
+}
+
+void DecompressDiskRecord(const unsigned char* pStored, size_t nStored, size_t nMaxSize, std::vector<unsigned char>& vData)
+{
+#ifdef HAVE_SNAPPY
+    size_t nSize;
+    if (!snappy::GetUncompressedLength((const char*)pStored, nStored, &nSize))
+        throw std::ios_base::failure("DecompressDiskRecord(): corrupt compressed record");
+    if (nSize > nMaxSize)
+        throw std::ios_base::failure("DecompressDiskRecord(): compressed record too large");
+    vData.resize(nSize);
+    if (!snappy::RawUncompress((const char*)pStored, nStored, (char*)vData.data()))
+        throw std::ios_base::failure("DecompressDiskRecord(): corrupt compressed record");
+#else
+    throw std::ios_base::failure("DecompressDiskRecord(): compressed record, but built without Snappy");
+#endif
+}
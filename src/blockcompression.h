@@ -0,0 +1,32 @@
+// Copyright (c) 2026 The Mynta Core Developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#ifndef MYNTA_BLOCKCOMPRESSION_H
+#define MYNTA_BLOCKCOMPRESSION_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <vector>
+
+/** Default for -blockcompression */
+static const bool DEFAULT_BLOCK_COMPRESSION = false;
+
+/**
+ * Set in the size field written in front of a block or undo record whose data
+ * is compressed. No record comes near 2 GiB, so versions that don't know the
+ * flag reject the size rather than misread the data.
+ */
+static const uint32_t DISK_RECORD_COMPRESSED = 0x80000000;
+
+//! Whether this build can write compressed records (it was built with Snappy)
+bool CanCompressDiskRecords();
+
+//! Compress a serialized block or undo record into vStored; false if that wouldn't make it smaller
+bool CompressDiskRecord(const std::vector<unsigned char>& vData, std::vector<unsigned char>& vStored);
+
+//! Decompress the nStored bytes of a compressed record into vData; throws
+//! std::ios_base::failure if they are corrupt or would decompress to more than nMaxSize
+void DecompressDiskRecord(const unsigned char* pStored, size_t nStored, size_t nMaxSize, std::vector<unsigned char>& vData);
+
+#endif // MYNTA_BLOCKCOMPRESSION_H
@@ -46,6 +46,26 @@ uint64_t CBlockHeaderAndShortTxIDs::GetShortID(const uint256& txhash) const {
 
 
 
+void PartiallyDownloadedBlock::MatchMempoolTx(const CBlockHeaderAndShortTxIDs& cmpctblock, const std::unordered_map<uint64_t, uint16_t>& shorttxids, std::vector<bool>& have_txn, const uint256& wtxid, const CTransactionRef& tx) {
+    uint64_t shortid = cmpctblock.GetShortID(wtxid);
+    std::unordered_map<uint64_t, uint16_t>::const_iterator idit = shorttxids.find(shortid);
+    if (idit == shorttxids.end())
+        return;
+    if (!have_txn[idit->second]) {
+        txn_available[idit->second] = tx;
+        have_txn[idit->second]  = true;
+        mempool_count++;
+    } else if (txn_available[idit->second] && txn_available[idit->second] != tx) {
+        // If we find two mempool txn that match the short id, just request it.
+        // This should be rare enough that the extra bandwidth doesn't matter,
+        // but eating a round-trip due to FillBlock failure would be annoying.
+        // The same entry is seen twice when the ancestor score pass didn't
+        // finish the block, which is not a collision.
+        txn_available[idit->second].reset();
+        mempool_count--;
+    }
+}
+
 ReadStatus PartiallyDownloadedBlock::InitData(const CBlockHeaderAndShortTxIDs& cmpctblock, const std::vector<std::pair<uint256, CTransactionRef>>& extra_txn) {
     if (cmpctblock.header.IsNull() || (cmpctblock.shorttxids.empty() && cmpctblock.prefilledtxn.empty()))
         return READ_STATUS_INVALID;
@@ -105,30 +125,27 @@ ReadStatus PartiallyDownloadedBlock::InitData(const CBlockHeaderAndShortTxIDs& c
     std::vector<bool> have_txn(txn_available.size());
     {
     LOCK(pool->cs);
+    // Short IDs are salted per block, so every candidate has to be hashed again for each
+    // compact block. Try what a miner would have picked first: when the mempool is much
+    // bigger than a block, the early exit usually triggers after about a block's worth of
+    // transactions instead of after a large share of the mempool.
+    size_t nScannedWeight = 0;
+    const size_t nMaxScanWeight = 2 * GetMaxBlockWeight();
+    for (const CTxMemPoolEntry& entry : pool->mapTx.get<ancestor_score>()) {
+        if (mempool_count == shorttxids.size() || nScannedWeight > nMaxScanWeight)
+            break;
+        nScannedWeight += entry.GetTxWeight();
+        MatchMempoolTx(cmpctblock, shorttxids, have_txn, entry.GetTx().GetWitnessHash(), entry.GetSharedTx());
+    }
+    // Anything still missing may be anywhere in the mempool
     const std::vector<std::pair<uint256, CTxMemPool::txiter> >& vTxHashes = pool->vTxHashes;
     for (size_t i = 0; i < vTxHashes.size(); i++) {
-        uint64_t shortid = cmpctblock.GetShortID(vTxHashes[i].first);
-        std::unordered_map<uint64_t, uint16_t>::iterator idit = shorttxids.find(shortid);
-        if (idit != shorttxids.end()) {
-            if (!have_txn[idit->second]) {
-                txn_available[idit->second] = vTxHashes[i].second->GetSharedTx();
-                have_txn[idit->second]  = true;
-                mempool_count++;
-            } else {
-                // If we find two mempool txn that match the short id, just request it.
-                // This should be rare enough that the extra bandwidth doesn't matter,
-                // but eating a round-trip due to FillBlock failure would be annoying
-                if (txn_available[idit->second]) {
-                    txn_available[idit->second].reset();
-                    mempool_count--;
-                }
-            }
-        }
         // Though ideally we'd continue scanning for the two-txn-match-shortid case,
         // the performance win of an early exit here is too good to pass up and worth
         // the extra risk.
         if (mempool_count == shorttxids.size())
             break;
+        MatchMempoolTx(cmpctblock, shorttxids, have_txn, vTxHashes[i].first, vTxHashes[i].second->GetSharedTx());
     }
     }
 
@@ -9,6 +9,7 @@
 #include "primitives/block.h"
 
 #include <memory>
+#include <unordered_map>
 
 class CTxMemPool;
 class CDatabasedAssetData;
@@ -198,6 +199,9 @@ protected:
     std::vector<CTransactionRef> txn_available;
     size_t prefilled_count = 0, mempool_count = 0, extra_count = 0;
     CTxMemPool* pool;
+
+    // Fill the slot whose short ID matches wtxid with tx, unless another transaction already matched it
+    void MatchMempoolTx(const CBlockHeaderAndShortTxIDs& cmpctblock, const std::unordered_map<uint64_t, uint16_t>& shorttxids, std::vector<bool>& have_txn, const uint256& wtxid, const CTransactionRef& tx);
 public:
     CBlockHeader header;
     explicit PartiallyDownloadedBlock(CTxMemPool* poolIn) : pool(poolIn) {}
@@ -0,0 +1,130 @@
+// Copyright (c) 2026 The Mynta Core Developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include "blockfilemap.h"
+
+#include "compat.h"
+#include "util.h"
+
+#include <algorithm>
+
+#ifndef WIN32
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+CBlockFileMapCache blockFileMaps;
+
+CMappedBlockFile::~CMappedBlockFile()
+{
+#ifndef WIN32
+    if (pData) {
+        munmap(const_cast<unsigned char*>(pData), nSize);
+    }
+#endif
+}
+
+std::shared_ptr<const CMappedBlockFile> CMappedBlockFile::Map(int fd)
+{
+#ifndef WIN32
+    struct stat st;
+    if (fd < 0 || fstat(fd, &st) != 0 || st.st_size <= 0) {
+        return nullptr;
+    }
+    void* p = mmap(nullptr, st.st_size, PROT_READ, MAP_SHARED, fd, 0);
+    if (p == MAP_FAILED) {
+        LogPrintf("CMappedBlockFile::%s -- mmap of %u bytes failed: %s\n", __func__, (uint64_t)st.st_size, strerror(errno));
+        return nullptr;
+    }
+    std::shared_ptr<CMappedBlockFile> map(new CMappedBlockFile());
+    map->pData = static_cast<const unsigned char*>(p);
+    map->nSize = st.st_size;
+    return map;
+#else
+    return nullptr;
+#endif
+}
+
+std::shared_ptr<const CMappedBlockFile> CMappedBlockFile::Map(FILE* file)
+{
+#ifndef WIN32
+    return file ? Map(fileno(file)) : nullptr;
+#else
+    return nullptr;
+#endif
+}
+
+void CMappedBlockFile::AdviseSequential() const
+{
+#ifndef WIN32
+    posix_madvise(const_cast<unsigned char*>(pData), nSize, POSIX_MADV_SEQUENTIAL);
+#endif
+}
+
+void CMappedBlockFile::WillNeed(size_t nPos, size_t nLength) const
+{
+#ifndef WIN32
+    if (nPos >= nSize) {
+        return;
+    }
+    // madvise wants a page aligned start
+    static const size_t nPageSize = sysconf(_SC_PAGESIZE);
+    size_t nStart = nPos - nPos % nPageSize;
+    size_t nEnd = std::min(nSize, nPos + nLength);
+    posix_madvise(const_cast<unsigned char*>(pData) + nStart, nEnd - nStart, POSIX_MADV_WILLNEED);
+#endif
+}
+
+CBlockFileMapCache::MapPtr CBlockFileMapCache::Get(const fs::path& path, size_t nMinSize)
+{
+    std::lock_guard<std::mutex> lock(cs);
+
+    auto it = maps.find(path);
+    if (it != maps.end() && it->second.map->size() >= nMinSize) {
+        it->second.nLastUsed = ++nUseCounter;
+        return it->second.map;
+    }
+
+    // Not mapped yet, or the file has grown past the old mapping
+    MapPtr map;
+#ifndef WIN32
+    int fd = open(path.string().c_str(), O_RDONLY);
+    if (fd >= 0) {
+        map = CMappedBlockFile::Map(fd);
+        close(fd);
+    }
+#endif
+    if (!map || map->size() < nMinSize) {
+        return nullptr;
+    }
+
+    if (it != maps.end()) {
+        it->second.map = map;
+        it->second.nLastUsed = ++nUseCounter;
+        return map;
+    }
+
+    if (maps.size() >= MAX_MAPPED_BLOCK_FILES) {
+        auto oldest = std::min_element(maps.begin(), maps.end(), [](const std::pair<const fs::path, CEntry>& a, const std::pair<const fs::path, CEntry>& b) {
+            return a.second.nLastUsed < b.second.nLastUsed;
+        });
+        // Readers still holding the mapping keep it alive until they finish
+        maps.erase(oldest);
+    }
+    maps.emplace(path, CEntry{map, ++nUseCounter});
+    return map;
+}
+
+void CBlockFileMapCache::Invalidate(const fs::path& path)
+{
+    std::lock_guard<std::mutex> lock(cs);
+    maps.erase(path);
+}
+
+void CBlockFileMapCache::Clear()
+{
+    std::lock_guard<std::mutex> lock(cs);
+    maps.clear();
+}
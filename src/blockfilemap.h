@@ -0,0 +1,91 @@
+// Copyright (c) 2026 The Mynta Core Developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#ifndef MYNTA_BLOCKFILEMAP_H
+#define MYNTA_BLOCKFILEMAP_H
+
+#include "fs.h"
+
+#include <map>
+#include <memory>
+#include <mutex>
+#include <stdint.h>
+#include <stdio.h>
+
+/** Default for -blockfilemmap; memory mapping is not implemented on Windows */
+#ifdef WIN32
+static const bool DEFAULT_BLOCKFILE_MMAP = false;
+#else
+static const bool DEFAULT_BLOCKFILE_MMAP = true;
+#endif
+/** Number of blk/rev files kept mapped at once */
+static const size_t MAX_MAPPED_BLOCK_FILES = 16;
+/** Bytes past the end of each read requested from the kernel ahead of time */
+static const size_t BLOCKFILE_READAHEAD_SIZE = 4 << 20;
+
+/**
+ * Read-only memory mapping of a whole blk?????.dat or rev?????.dat file.
+ *
+ * The mapping covers the file as it was when mapped; appends made later are
+ * only visible through a new mapping (see CBlockFileMapCache::Get).
+ */
+class CMappedBlockFile
+{
+    const unsigned char* pData{nullptr};
+    size_t nSize{0};
+
+    CMappedBlockFile() = default;
+
+public:
+    ~CMappedBlockFile();
+
+    CMappedBlockFile(const CMappedBlockFile&) = delete;
+    CMappedBlockFile& operator=(const CMappedBlockFile&) = delete;
+
+    //! Map the file open as fd; returns nullptr if it is empty or can't be mapped
+    static std::shared_ptr<const CMappedBlockFile> Map(int fd);
+    static std::shared_ptr<const CMappedBlockFile> Map(FILE* file);
+
+    const unsigned char* data() const { return pData; }
+    size_t size() const { return nSize; }
+
+    //! Tell the kernel the file will be read front to back (reindex, -loadblock)
+    void AdviseSequential() const;
+    //! Start reading [nPos, nPos + nLength) in now, clamped to the mapping
+    void WillNeed(size_t nPos, size_t nLength) const;
+};
+
+/**
+ * Small LRU cache of mapped block and undo files shared by ReadBlockFromDisk,
+ * UndoReadFromDisk and LoadExternalBlockFile. A mapping that is too short
+ * for a request (because the file has grown since) is replaced, and any file
+ * that gets truncated or deleted must be dropped with Invalidate() first.
+ */
+class CBlockFileMapCache
+{
+public:
+    typedef std::shared_ptr<const CMappedBlockFile> MapPtr;
+
+private:
+    struct CEntry {
+        MapPtr map;
+        uint64_t nLastUsed;
+    };
+
+    std::mutex cs;
+    std::map<fs::path, CEntry> maps;
+    uint64_t nUseCounter{0};
+
+public:
+    //! Mapping of path covering at least nMinSize bytes, or nullptr if the file is shorter or can't be mapped
+    MapPtr Get(const fs::path& path, size_t nMinSize);
+
+    //! Drop the mapping of path, if any
+    void Invalidate(const fs::path& path);
+    void Clear();
+};
+
+extern CBlockFileMapCache blockFileMaps;
+
+#endif // MYNTA_BLOCKFILEMAP_H
@@ -0,0 +1,320 @@
+// Copyright (c) 2026 The Mynta Core Developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include "blockfilter.h"
+
+#include "coins.h"
+#include "hash.h"
+#include "primitives/block.h"
+#include "script/script.h"
+#include "streams.h"
+#include "undo.h"
+
+#include <algorithm>
+#include <map>
+#include <set>
+
+/** Writes values of up to 64 bits, most significant bit first */
+class BitWriter
+{
+private:
+    std::vector<unsigned char>& vData;
+    uint8_t nBuffer{0};
+    //! Bits of nBuffer in use
+    int nOffset{0};
+
+public:
+    explicit BitWriter(std::vector<unsigned char>& vDataIn) : vData(vDataIn) {}
+
+    /** Write the low nBits bits of data, 1 <= nBits <= 64 */
+    void Write(uint64_t data, int nBits)
+    {
+        while (nBits > 0) {
+            int nTake = std::min(8 - nOffset, nBits);
+            nBuffer |= (data << (64 - nBits)) >> (64 - 8 + nOffset);
+            nOffset += nTake;
+            nBits -= nTake;
+            if (nOffset == 8)
+                Flush();
+        }
+    }
+
+    /** Write out a partly filled byte, padded with zero bits */
+    void Flush()
+    {
+        if (nOffset == 0)
+            return;
+        vData.push_back(nBuffer);
+        nBuffer = 0;
+        nOffset = 0;
+    }
+};
+
+/** Reads what BitWriter wrote, throwing std::ios_base::failure at the end of the data */
+class BitReader
+{
+private:
+    const std::vector<unsigned char>& vData;
+    size_t nPos;
+    uint8_t nBuffer{0};
+    //! Bits of nBuffer already read
+    int nOffset{8};
+
+public:
+    BitReader(const std::vector<unsigned char>& vDataIn, size_t nPosIn) : vData(vDataIn), nPos(nPosIn) {}
+
+    uint64_t Read(int nBits)
+    {
+        uint64_t data = 0;
+        while (nBits > 0) {
+            if (nOffset == 8) {
+                if (nPos >= vData.size())
+                    throw std::ios_base::failure("GCS filter ended early");
+                nBuffer = vData[nPos++];
+                nOffset = 0;
+            }
+            int nTake = std::min(8 - nOffset, nBits);
+            data <<= nTake;
+            data |= static_cast<uint8_t>(nBuffer << nOffset) >> (8 - nTake);
+            nOffset += nTake;
+            nBits -= nTake;
+        }
+        return data;
+    }
+
+    /** Bytes not read yet, not counting a partly read one */
+    size_t Remaining() const { return vData.size() - nPos; }
+};
+
+static void GolombRiceEncode(BitWriter& writer, uint8_t nP, uint64_t x)
+{
+    // The quotient in unary, then the remainder in nP bits
+    uint64_t q = x >> nP;
+    while (q > 0) {
+        int nBits = q <= 64 ? static_cast<int>(q) : 64;
+        writer.Write(~0ULL, nBits);
+        q -= nBits;
+    }
+    writer.Write(0, 1);
+    writer.Write(x, nP);
+}
+
+static uint64_t GolombRiceDecode(BitReader& reader, uint8_t nP)
+{
+    uint64_t q = 0;
+    while (reader.Read(1) == 1)
+        q++;
+    uint64_t r = reader.Read(nP);
+    return (q << nP) + r;
+}
+
+/** floor(x * n / 2^64), mapping a uniform 64 bit hash onto [0, n) without a division */
+static uint64_t MapIntoRange(uint64_t x, uint64_t n)
+{
+    const uint64_t x_hi = x >> 32;
+    const uint64_t x_lo = x & 0xFFFFFFFF;
+    const uint64_t n_hi = n >> 32;
+    const uint64_t n_lo = n & 0xFFFFFFFF;
+
+    const uint64_t ac = x_hi * n_hi;
+    const uint64_t ad = x_hi * n_lo;
+    const uint64_t bc = x_lo * n_hi;
+    const uint64_t bd = x_lo * n_lo;
+
+    const uint64_t mid34 = (bd >> 32) + (bc & 0xFFFFFFFF) + (ad & 0xFFFFFFFF);
+    return ac + (bc >> 32) + (ad >> 32) + (mid34 >> 32);
+}
+
+uint64_t GCSFilter::HashToRange(const Element& element) const
+{
+    uint64_t hash = CSipHasher(params.nSipHashK0, params.nSipHashK1).Write(element.data(), element.size()).Finalize();
+    return MapIntoRange(hash, nF);
+}
+
+std::vector<uint64_t> GCSFilter::BuildHashedSet(const ElementSet& elements) const
+{
+    std::vector<uint64_t> vHashed;
+    vHashed.reserve(elements.size());
+    for (const Element& element : elements)
+        vHashed.push_back(HashToRange(element));
+    std::sort(vHashed.begin(), vHashed.end());
+    return vHashed;
+}
+
+GCSFilter::GCSFilter(const Params& paramsIn) : params(paramsIn), nN(0), nF(0)
+{
+    CVectorWriter(SER_NETWORK, 0, vEncoded, 0) << COMPACTSIZE(uint64_t(0));
+}
+
+GCSFilter::GCSFilter(const Params& paramsIn, std::vector<unsigned char> vEncodedIn)
+    : params(paramsIn), vEncoded(std::move(vEncodedIn))
+{
+    CDataStream stream(vEncoded, SER_NETWORK, 0);
+    uint64_t nCount = ReadCompactSize(stream);
+    if (nCount > std::numeric_limits<uint32_t>::max())
+        throw std::ios_base::failure("GCS filter has too many elements");
+    nN = static_cast<uint32_t>(nCount);
+    nF = static_cast<uint64_t>(nN) * params.nM;
+
+    // Decode every element so that a malformed filter is refused here
+    BitReader reader(vEncoded, vEncoded.size() - stream.size());
+    for (uint32_t i = 0; i < nN; i++)
+        GolombRiceDecode(reader, params.nP);
+    if (reader.Remaining() != 0)
+        throw std::ios_base::failure("GCS filter has trailing data");
+}
+
+GCSFilter::GCSFilter(const Params& paramsIn, const ElementSet& elements) : params(paramsIn)
+{
+    std::set<Element> setUnique(elements.begin(), elements.end());
+    if (setUnique.size() > std::numeric_limits<uint32_t>::max())
+        throw std::invalid_argument("GCS filter can hold at most 2^32 - 1 elements");
+    nN = static_cast<uint32_t>(setUnique.size());
+    nF = static_cast<uint64_t>(nN) * params.nM;
+
+    CVectorWriter(SER_NETWORK, 0, vEncoded, 0) << COMPACTSIZE(static_cast<uint64_t>(nN));
+    if (nN == 0)
+        return;
+
+    BitWriter writer(vEncoded);
+    uint64_t nLast = 0;
+    for (uint64_t value : BuildHashedSet(ElementSet(setUnique.begin(), setUnique.end()))) {
+        GolombRiceEncode(writer, params.nP, value - nLast);
+        nLast = value;
+    }
+    writer.Flush();
+}
+
+bool GCSFilter::MatchInternal(const std::vector<uint64_t>& vQuery) const
+{
+    if (nN == 0 || vQuery.empty())
+        return false;
+
+    CDataStream stream(vEncoded, SER_NETWORK, 0);
+    ReadCompactSize(stream);
+    BitReader reader(vEncoded, vEncoded.size() - stream.size());
+
+    // Walk the filter and the sorted query together
+    uint64_t value = 0;
+    auto itQuery = vQuery.begin();
+    for (uint32_t i = 0; i < nN; i++) {
+        value += GolombRiceDecode(reader, params.nP);
+        while (itQuery != vQuery.end() && *itQuery < value)
+            ++itQuery;
+        if (itQuery == vQuery.end())
+            return false;
+        if (*itQuery == value)
+            return true;
+    }
+    return false;
+}
+
+bool GCSFilter::Match(const Element& element) const
+{
+    if (nN == 0)
+        return false;
+    return MatchInternal(std::vector<uint64_t>{HashToRange(element)});
+}
+
+bool GCSFilter::MatchAny(const ElementSet& elements) const
+{
+    if (nN == 0)
+        return false;
+    return MatchInternal(BuildHashedSet(elements));
+}
+
+static const std::map<BlockFilterType, std::string> mapFilterTypeNames = {
+    {BlockFilterType::BASIC, "basic"},
+};
+
+const std::string& BlockFilterTypeName(BlockFilterType filterType)
+{
+    static const std::string strUnknown;
+    auto it = mapFilterTypeNames.find(filterType);
+    return it != mapFilterTypeNames.end() ? it->second : strUnknown;
+}
+
+bool BlockFilterTypeByName(const std::string& strName, BlockFilterType& filterType)
+{
+    for (const auto& entry : mapFilterTypeNames) {
+        if (entry.second == strName) {
+            filterType = entry.first;
+            return true;
+        }
+    }
+    return false;
+}
+
+static void AddFilterScript(const CScript& script, std::set<GCSFilter::Element>& setElements)
+{
+    if (script.empty() || script[0] == OP_RETURN)
+        return;
+    setElements.emplace(script.begin(), script.end());
+
+    // Asset scripts start with the pay to key hash script of their address
+    if (script.IsAssetScript() && script.size() > 25) {
+        CScript scriptAddress(script.begin(), script.begin() + 25);
+        if (scriptAddress.IsPayToPublicKeyHash())
+            setElements.emplace(scriptAddress.begin(), scriptAddress.end());
+    }
+}
+
+GCSFilter::ElementSet BasicFilterElements(const CBlock& block, const CBlockUndo& blockundo)
+{
+    std::set<GCSFilter::Element> setElements;
+    for (const CTransactionRef& tx : block.vtx) {
+        for (const CTxOut& txout : tx->vout)
+            AddFilterScript(txout.scriptPubKey, setElements);
+    }
+    for (const CTxUndo& txundo : blockundo.vtxundo) {
+        for (const Coin& coin : txundo.vprevout)
+            AddFilterScript(coin.out.scriptPubKey, setElements);
+    }
+    return GCSFilter::ElementSet(setElements.begin(), setElements.end());
+}
+
+bool BlockFilter::BuildParams(GCSFilter::Params& params) const
+{
+    switch (filterType) {
+    case BlockFilterType::BASIC:
+        params.nSipHashK0 = hashBlock.GetUint64(0);
+        params.nSipHashK1 = hashBlock.GetUint64(1);
+        params.nP = BASIC_FILTER_P;
+        params.nM = BASIC_FILTER_M;
+        return true;
+    case BlockFilterType::INVALID:
+        return false;
+    }
+    return false;
+}
+
+BlockFilter::BlockFilter(BlockFilterType filterTypeIn, const uint256& hashBlockIn, std::vector<unsigned char> vFilter)
+    : filterType(filterTypeIn), hashBlock(hashBlockIn)
+{
+    GCSFilter::Params params;
+    if (!BuildParams(params))
+        throw std::invalid_argument("unknown filter type");
+    filter = GCSFilter(params, std::move(vFilter));
+}
+
+BlockFilter::BlockFilter(BlockFilterType filterTypeIn, const CBlock& block, const CBlockUndo& blockundo)
+    : filterType(filterTypeIn), hashBlock(block.GetHash())
+{
+    GCSFilter::Params params;
+    if (!BuildParams(params))
+        throw std::invalid_argument("unknown filter type");
+    filter = GCSFilter(params, BasicFilterElements(block, blockundo));
+}
+
+uint256 BlockFilter::GetHash() const
+{
+    const std::vector<unsigned char>& vEncoded = GetEncodedFilter();
+    return Hash(vEncoded.begin(), vEncoded.end());
+}
+
+uint256 BlockFilter::ComputeHeader(const uint256& hashPrevHeader) const
+{
+    const uint256 hashFilter = GetHash();
+    return Hash(hashFilter.begin(), hashFilter.end(), hashPrevHeader.begin(), hashPrevHeader.end());
+}
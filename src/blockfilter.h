@@ -0,0 +1,148 @@
+// Copyright (c) 2026 The Mynta Core Developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#ifndef MYNTA_BLOCKFILTER_H
+#define MYNTA_BLOCKFILTER_H
+
+#include "serialize.h"
+#include "uint256.h"
+
+#include <stdint.h>
+#include <string>
+#include <vector>
+
+class CBlock;
+class CBlockUndo;
+
+/**
+ * Golomb-coded set as BIP158 defines it: a compact, probabilistic set of byte
+ * strings. Each element is hashed with SipHash into [0, N * M), and the sorted
+ * hashes are stored as Golomb-Rice coded differences with parameter P.
+ * Membership tests have a false positive rate of about 1 / M.
+ */
+class GCSFilter
+{
+public:
+    typedef std::vector<unsigned char> Element;
+    typedef std::vector<Element> ElementSet;
+
+    struct Params
+    {
+        uint64_t nSipHashK0;
+        uint64_t nSipHashK1;
+        uint8_t nP; //!< Golomb-Rice coding parameter
+        uint32_t nM; //!< Inverse false positive rate
+
+        Params(uint64_t nSipHashK0In = 0, uint64_t nSipHashK1In = 0, uint8_t nPIn = 0, uint32_t nMIn = 1)
+            : nSipHashK0(nSipHashK0In), nSipHashK1(nSipHashK1In), nP(nPIn), nM(nMIn) {}
+    };
+
+private:
+    Params params;
+    uint32_t nN; //!< Number of elements in the filter
+    uint64_t nF; //!< Range of element hashes, N * M
+    std::vector<unsigned char> vEncoded;
+
+    uint64_t HashToRange(const Element& element) const;
+    std::vector<uint64_t> BuildHashedSet(const ElementSet& elements) const;
+    //! Whether any of the sorted hashes in vQuery is in the filter
+    bool MatchInternal(const std::vector<uint64_t>& vQuery) const;
+
+public:
+    /** An empty filter */
+    explicit GCSFilter(const Params& paramsIn = Params());
+
+    /** Decode a filter, throwing std::ios_base::failure if it is malformed */
+    GCSFilter(const Params& paramsIn, std::vector<unsigned char> vEncodedIn);
+
+    /** Build a filter holding elements; duplicates and empty elements count once or not at all */
+    GCSFilter(const Params& paramsIn, const ElementSet& elements);
+
+    uint32_t GetN() const { return nN; }
+    const Params& GetParams() const { return params; }
+    const std::vector<unsigned char>& GetEncoded() const { return vEncoded; }
+
+    /** Whether element is in the filter, or a false positive */
+    bool Match(const Element& element) const;
+
+    /** Whether any of elements is in the filter, decoding it only once */
+    bool MatchAny(const ElementSet& elements) const;
+};
+
+static const uint8_t BASIC_FILTER_P = 19;
+static const uint32_t BASIC_FILTER_M = 784931;
+
+enum class BlockFilterType : uint8_t
+{
+    BASIC = 0,
+    INVALID = 255,
+};
+
+/** Name of a filter type, as the -blockfilterindex option and REST interface use it */
+const std::string& BlockFilterTypeName(BlockFilterType filterType);
+
+/** Filter type for a name, false if there is none */
+bool BlockFilterTypeByName(const std::string& strName, BlockFilterType& filterType);
+
+/**
+ * The output scripts a basic filter holds for a block: those it creates and
+ * those its inputs spend, as blockundo holds them, leaving out empty and
+ * OP_RETURN scripts. For an asset script the plain script paying its address
+ * is added as well, so that light clients watching an address see the asset
+ * transfers to and from it.
+ */
+GCSFilter::ElementSet BasicFilterElements(const CBlock& block, const CBlockUndo& blockundo);
+
+/** A compact filter for one block, as BIP157 serves it */
+class BlockFilter
+{
+private:
+    BlockFilterType filterType{BlockFilterType::INVALID};
+    uint256 hashBlock;
+    GCSFilter filter;
+
+    bool BuildParams(GCSFilter::Params& params) const;
+
+public:
+    BlockFilter() = default;
+
+    /** Reconstruct a filter from its encoding, throwing std::ios_base::failure if it is malformed */
+    BlockFilter(BlockFilterType filterTypeIn, const uint256& hashBlockIn, std::vector<unsigned char> vFilter);
+
+    /** Compute the filter of a block */
+    BlockFilter(BlockFilterType filterTypeIn, const CBlock& block, const CBlockUndo& blockundo);
+
+    BlockFilterType GetFilterType() const { return filterType; }
+    const uint256& GetBlockHash() const { return hashBlock; }
+    const GCSFilter& GetFilter() const { return filter; }
+    const std::vector<unsigned char>& GetEncodedFilter() const { return filter.GetEncoded(); }
+
+    /** Double SHA256 of the encoded filter */
+    uint256 GetHash() const;
+
+    /** Header of this filter, committing to hashPrevHeader, the previous block's */
+    uint256 ComputeHeader(const uint256& hashPrevHeader) const;
+
+    template <typename Stream>
+    void Serialize(Stream& s) const
+    {
+        s << static_cast<uint8_t>(filterType) << hashBlock << filter.GetEncoded();
+    }
+
+    template <typename Stream>
+    void Unserialize(Stream& s)
+    {
+        uint8_t nType;
+        std::vector<unsigned char> vEncoded;
+        s >> nType >> hashBlock >> vEncoded;
+        filterType = static_cast<BlockFilterType>(nType);
+
+        GCSFilter::Params params;
+        if (!BuildParams(params))
+            throw std::ios_base::failure("unknown filter type");
+        filter = GCSFilter(params, std::move(vEncoded));
+    }
+};
+
+#endif // MYNTA_BLOCKFILTER_H
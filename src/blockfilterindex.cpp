@@ -0,0 +1,127 @@
+// Copyright (c) 2026 The Mynta Core Developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include "blockfilterindex.h"
+
+#include "chain.h"
+#include "coins.h"
+#include "primitives/block.h"
+#include "undo.h"
+#include "util.h"
+#include "validation.h"
+
+static const char DB_FILTER = 'f';
+static const char DB_FILTER_HEADER = 'h';
+static const char DB_BEST_BLOCK = 'B';
+
+CBlockFilterIndex* pblockfilterindex = nullptr;
+
+CBlockFilterIndex::CBlockFilterIndex(BlockFilterType filterTypeIn, size_t nCacheSize, bool fMemory, bool fWipe)
+    : CBaseIndex(GetDataDir() / "indexes" / "blockfilter" / BlockFilterTypeName(filterTypeIn), nCacheSize, fMemory, fWipe),
+      filterType(filterTypeIn)
+{
+}
+
+void CBlockFilterIndex::Init()
+{
+    AssertLockHeld(cs_main);
+    SetBest(nullptr);
+    hashBestHeader.SetNull();
+
+    uint256 hashBest;
+    if (!db.Read(DB_BEST_BLOCK, hashBest))
+        return;
+    BlockMap::const_iterator it = mapBlockIndex.find(hashBest);
+    if (it == mapBlockIndex.end()) {
+        LogPrintf("%s: best block %s of the %s block filter index is unknown, building it again\n",
+                  __func__, hashBest.ToString(), BlockFilterTypeName(filterType));
+        return;
+    }
+    std::pair<uint256, uint256> value;
+    if (!db.Read(std::make_pair(DB_FILTER_HEADER, hashBest), value))
+        return;
+    SetBest(it->second);
+    hashBestHeader = value.second;
+}
+
+std::string CBlockFilterIndex::GetName() const
+{
+    return BlockFilterTypeName(filterType) + " block filter index";
+}
+
+bool CBlockFilterIndex::WriteBlock(const CBlock& block, const CBlockUndo& blockundo, const CBlockIndex* pindex)
+{
+    const BlockFilter filter(filterType, block, blockundo);
+    const uint256 hashHeader = filter.ComputeHeader(hashBestHeader);
+
+    CDBBatch batch(db);
+    batch.Write(std::make_pair(DB_FILTER, pindex->GetBlockHash()), filter.GetEncodedFilter());
+    batch.Write(std::make_pair(DB_FILTER_HEADER, pindex->GetBlockHash()), std::make_pair(filter.GetHash(), hashHeader));
+    batch.Write(DB_BEST_BLOCK, pindex->GetBlockHash());
+    if (!db.WriteBatch(batch))
+        return error("%s: failed to write the filter of block %s", __func__, pindex->GetBlockHash().ToString());
+
+    SetBest(pindex);
+    hashBestHeader = hashHeader;
+    return true;
+}
+
+bool CBlockFilterIndex::RewindTo(const CBlockIndex* pindexFork)
+{
+    // Filters are stored by block hash, so stepping back needs no erasing
+    std::pair<uint256, uint256> value;
+    if (!db.Read(std::make_pair(DB_FILTER_HEADER, pindexFork->GetBlockHash()), value))
+        return error("%s: missing the filter header of block %s", __func__, pindexFork->GetBlockHash().ToString());
+    SetBest(pindexFork);
+    hashBestHeader = value.second;
+    return true;
+}
+
+bool CBlockFilterIndex::LookupFilter(const uint256& hashBlock, BlockFilter& filter) const
+{
+    std::vector<unsigned char> vEncoded;
+    if (!db.Read(std::make_pair(DB_FILTER, hashBlock), vEncoded))
+        return false;
+    try {
+        filter = BlockFilter(filterType, hashBlock, std::move(vEncoded));
+    } catch (const std::exception& e) {
+        return error("%s: filter of block %s is corrupt: %s", __func__, hashBlock.ToString(), e.what());
+    }
+    return true;
+}
+
+bool CBlockFilterIndex::LookupFilterHeader(const uint256& hashBlock, uint256& hashHeader) const
+{
+    std::pair<uint256, uint256> value;
+    if (!db.Read(std::make_pair(DB_FILTER_HEADER, hashBlock), value))
+        return false;
+    hashHeader = value.second;
+    return true;
+}
+
+bool CBlockFilterIndex::LookupFilterRange(int nStartHeight, const CBlockIndex* pindexStop, std::vector<BlockFilter>& vFilters) const
+{
+    if (nStartHeight < 0 || nStartHeight > pindexStop->nHeight)
+        return false;
+    vFilters.resize(pindexStop->nHeight - nStartHeight + 1);
+    for (const CBlockIndex* pindex = pindexStop; pindex && pindex->nHeight >= nStartHeight; pindex = pindex->pprev) {
+        if (!LookupFilter(pindex->GetBlockHash(), vFilters[pindex->nHeight - nStartHeight]))
+            return false;
+    }
+    return true;
+}
+
+bool CBlockFilterIndex::LookupFilterHashRange(int nStartHeight, const CBlockIndex* pindexStop, std::vector<uint256>& vHashes) const
+{
+    if (nStartHeight < 0 || nStartHeight > pindexStop->nHeight)
+        return false;
+    vHashes.resize(pindexStop->nHeight - nStartHeight + 1);
+    for (const CBlockIndex* pindex = pindexStop; pindex && pindex->nHeight >= nStartHeight; pindex = pindex->pprev) {
+        std::pair<uint256, uint256> value;
+        if (!db.Read(std::make_pair(DB_FILTER_HEADER, pindex->GetBlockHash()), value))
+            return false;
+        vHashes[pindex->nHeight - nStartHeight] = value.first;
+    }
+    return true;
+}
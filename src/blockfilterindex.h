@@ -0,0 +1,59 @@
+// Copyright (c) 2026 The Mynta Core Developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#ifndef MYNTA_BLOCKFILTERINDEX_H
+#define MYNTA_BLOCKFILTERINDEX_H
+
+#include "baseindex.h"
+#include "blockfilter.h"
+#include "uint256.h"
+
+#include <vector>
+
+static const char* const DEFAULT_BLOCKFILTERINDEX = "0";
+static const bool DEFAULT_PEERBLOCKFILTERS = false;
+static const size_t BLOCKFILTERINDEX_DB_CACHE_SIZE = 16 << 20;
+//! Events the index's validation queue holds; it sees every mempool transaction too
+static const size_t BLOCKFILTERINDEX_QUEUE_DEPTH = 10000;
+
+/**
+ * Compact block filters of the active chain, kept in their own database.
+ *
+ * Filters and filter headers are stored by block hash, so a reorg leaves the
+ * entries of the blocks it disconnects in place and only moves the best block
+ * back; they are found again if those blocks become active once more.
+ */
+class CBlockFilterIndex : public CBaseIndex
+{
+private:
+    const BlockFilterType filterType;
+    uint256 hashBestHeader;
+
+protected:
+    bool WriteBlock(const CBlock& block, const CBlockUndo& blockundo, const CBlockIndex* pindex) override;
+    bool RewindTo(const CBlockIndex* pindexFork) override;
+    std::string GetName() const override;
+
+public:
+    explicit CBlockFilterIndex(BlockFilterType filterTypeIn, size_t nCacheSize, bool fMemory = false, bool fWipe = false);
+
+    BlockFilterType GetFilterType() const { return filterType; }
+
+    /** Load the best block written so far. Requires cs_main. */
+    void Init();
+
+    bool LookupFilter(const uint256& hashBlock, BlockFilter& filter) const;
+    bool LookupFilterHeader(const uint256& hashBlock, uint256& hashHeader) const;
+
+    /** Filters of the blocks from nStartHeight up to pindexStop, lowest first */
+    bool LookupFilterRange(int nStartHeight, const CBlockIndex* pindexStop, std::vector<BlockFilter>& vFilters) const;
+
+    /** Filter hashes of the blocks from nStartHeight up to pindexStop, lowest first */
+    bool LookupFilterHashRange(int nStartHeight, const CBlockIndex* pindexStop, std::vector<uint256>& vHashes) const;
+};
+
+/** The index, if -blockfilterindex turned it on */
+extern CBlockFilterIndex* pblockfilterindex;
+
+#endif // MYNTA_BLOCKFILTERINDEX_H
@@ -0,0 +1,144 @@
+// Copyright (c) 2026 The Mynta Core Developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include "blockindexcold.h"
+
+#include "compat.h"
+#include "crypto/common.h"
+#include "util.h"
+
+#include <assert.h>
+#include <string.h>
+
+#ifndef WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
+CBlockIndexColdStore blockIndexColdStore;
+
+static void WriteRecord(unsigned char* p, const CBlockIndexColdData& data)
+{
+    memcpy(p, data.hashMerkleRoot.begin(), 32);
+    WriteLE32(p + 32, data.nNonce);
+    WriteLE64(p + 36, data.nNonce64);
+    memcpy(p + 44, data.mix_hash.begin(), 32);
+}
+
+static CBlockIndexColdData ReadRecord(const unsigned char* p)
+{
+    CBlockIndexColdData data;
+    memcpy(data.hashMerkleRoot.begin(), p, 32);
+    data.nNonce = ReadLE32(p + 32);
+    data.nNonce64 = ReadLE64(p + 36);
+    memcpy(data.mix_hash.begin(), p + 44, 32);
+    return data;
+}
+
+CBlockIndexColdStore::~CBlockIndexColdStore()
+{
+    FreeChunks();
+#ifndef WIN32
+    if (fd >= 0)
+        close(fd);
+#endif
+}
+
+void CBlockIndexColdStore::FreeChunks()
+{
+    for (const CChunk& chunk : vChunks) {
+#ifndef WIN32
+        if (chunk.fMapped) {
+            munmap(chunk.pData, CHUNK_SIZE);
+            continue;
+        }
+#endif
+        delete[] chunk.pData;
+    }
+    vChunks.clear();
+    nRecords = 0;
+}
+
+bool CBlockIndexColdStore::Open(const fs::path& path)
+{
+#ifndef WIN32
+    std::lock_guard<std::mutex> lock(cs);
+    if (fd >= 0)
+        return true;
+    fd = open(path.string().c_str(), O_RDWR | O_CREAT | O_TRUNC, 0600);
+    if (fd < 0) {
+        LogPrintf("CBlockIndexColdStore::%s -- can't create %s: %s\n", __func__, path.string(), strerror(errno));
+        return false;
+    }
+    // Nothing reads the file but this process, which keeps it open
+    unlink(path.string().c_str());
+    return true;
+#else
+    return false;
+#endif
+}
+
+uint32_t CBlockIndexColdStore::Add(const CBlockIndexColdData& data)
+{
+    std::lock_guard<std::mutex> lock(cs);
+    if (nRecords == vChunks.size() * CHUNK_RECORDS) {
+        CChunk chunk{nullptr, false};
+#ifndef WIN32
+        if (fd >= 0) {
+            const off_t nOffset = (off_t)vChunks.size() * CHUNK_SIZE;
+            void* p = MAP_FAILED;
+            if (ftruncate(fd, nOffset + CHUNK_SIZE) == 0)
+                p = mmap(nullptr, CHUNK_SIZE, PROT_READ | PROT_WRITE, MAP_SHARED, fd, nOffset);
+            if (p != MAP_FAILED) {
+                chunk.pData = static_cast<unsigned char*>(p);
+                chunk.fMapped = true;
+            } else {
+                LogPrintf("CBlockIndexColdStore::%s -- mapping %u bytes failed, keeping headers in memory: %s\n", __func__, (uint64_t)CHUNK_SIZE, strerror(errno));
+            }
+        }
+#endif
+        if (!chunk.pData)
+            chunk.pData = new unsigned char[CHUNK_SIZE];
+        vChunks.push_back(chunk);
+    }
+    WriteRecord(Record(nRecords), data);
+    return nRecords++;
+}
+
+void CBlockIndexColdStore::Set(uint32_t nPos, const CBlockIndexColdData& data)
+{
+    std::lock_guard<std::mutex> lock(cs);
+    assert(nPos < nRecords);
+    WriteRecord(Record(nPos), data);
+}
+
+CBlockIndexColdData CBlockIndexColdStore::Get(uint32_t nPos) const
+{
+    std::lock_guard<std::mutex> lock(cs);
+    assert(nPos < nRecords);
+    return ReadRecord(Record(nPos));
+}
+
+size_t CBlockIndexColdStore::Size() const
+{
+    std::lock_guard<std::mutex> lock(cs);
+    return nRecords;
+}
+
+bool CBlockIndexColdStore::IsMapped() const
+{
+    std::lock_guard<std::mutex> lock(cs);
+    return fd >= 0;
+}
+
+void CBlockIndexColdStore::Clear()
+{
+    std::lock_guard<std::mutex> lock(cs);
+    FreeChunks();
+#ifndef WIN32
+    if (fd >= 0 && ftruncate(fd, 0) != 0)
+        LogPrintf("CBlockIndexColdStore::%s -- truncating failed: %s\n", __func__, strerror(errno));
+#endif
+}
@@ -0,0 +1,94 @@
+// Copyright (c) 2026 The Mynta Core Developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#ifndef MYNTA_BLOCKINDEXCOLD_H
+#define MYNTA_BLOCKINDEXCOLD_H
+
+#include "fs.h"
+#include "primitives/block.h"
+#include "uint256.h"
+
+#include <mutex>
+#include <stdint.h>
+#include <vector>
+
+/**
+ * Header fields of a block index entry that nothing walking the chain reads:
+ * they are only needed to rebuild the header, to send it to a peer, write it
+ * to the block index database or show it over RPC.
+ */
+struct CBlockIndexColdData
+{
+    uint256 hashMerkleRoot;
+    uint32_t nNonce{0};
+    // KAWPOW
+    uint64_t nNonce64{0};
+    uint256 mix_hash;
+
+    CBlockIndexColdData() {}
+    explicit CBlockIndexColdData(const CBlockHeader& block)
+        : hashMerkleRoot(block.hashMerkleRoot), nNonce(block.nNonce), nNonce64(block.nNonce64), mix_hash(block.mix_hash) {}
+};
+
+/**
+ * The cold header fields of every block index entry, as fixed size records
+ * in chunks that never move, so an entry only keeps the position of its
+ * record. Once Open has been called the chunks are shared mappings of a
+ * scratch file, so the kernel can write the records out and drop them from
+ * memory until a header is asked for again; without it, or where mapping
+ * fails, chunks are allocated on the heap.
+ *
+ * The file is rebuilt from the block index database on every start and
+ * unlinked as soon as it is open, so it never outlives the process.
+ */
+class CBlockIndexColdStore
+{
+public:
+    static const size_t RECORD_SIZE = 32 + 4 + 8 + 32;
+    //! Records per chunk; a chunk is a whole number of pages
+    static const uint32_t CHUNK_RECORDS = 1 << 16;
+    static const size_t CHUNK_SIZE = RECORD_SIZE * CHUNK_RECORDS;
+
+private:
+    struct CChunk {
+        unsigned char* pData;
+        bool fMapped;
+    };
+
+    mutable std::mutex cs;
+    std::vector<CChunk> vChunks;
+    uint32_t nRecords{0};
+    //! The scratch file the chunks are mapped from, -1 if they are on the heap
+    int fd{-1};
+
+    unsigned char* Record(uint32_t nPos) const { return vChunks[nPos / CHUNK_RECORDS].pData + (nPos % CHUNK_RECORDS) * RECORD_SIZE; }
+    void FreeChunks();
+
+public:
+    CBlockIndexColdStore() {}
+    ~CBlockIndexColdStore();
+
+    CBlockIndexColdStore(const CBlockIndexColdStore&) = delete;
+    CBlockIndexColdStore& operator=(const CBlockIndexColdStore&) = delete;
+
+    /** Map the chunks added from now on from a scratch file at path; false if it can't be created */
+    bool Open(const fs::path& path);
+
+    /** Store a record and return its position */
+    uint32_t Add(const CBlockIndexColdData& data);
+    /** Overwrite the record at nPos */
+    void Set(uint32_t nPos, const CBlockIndexColdData& data);
+    CBlockIndexColdData Get(uint32_t nPos) const;
+
+    size_t Size() const;
+    bool IsMapped() const;
+
+    /** Drop every record, keeping the scratch file open for the next ones */
+    void Clear();
+};
+
+/** The cold fields of the entries of mapBlockIndex */
+extern CBlockIndexColdStore blockIndexColdStore;
+
+#endif // MYNTA_BLOCKINDEXCOLD_H
@@ -0,0 +1,222 @@
+// Copyright (c) 2026 The Mynta Core Developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include "blockprefetch.h"
+
+#include "assets/assets.h"
+#include "util.h"
+#include "validation.h"
+
+#include <functional>
+#include <unordered_set>
+
+CBlockInputPrefetcher g_blockPrefetcher;
+
+std::vector<COutPoint> GetBlockPrefetchOutpoints(const CBlock& block)
+{
+    std::vector<COutPoint> vOutpoints;
+    if (block.vtx.size() <= 1)
+        return vOutpoints;
+    std::unordered_set<uint256, BlockHasher> setBlockTxids;
+    for (const CTransactionRef& ptx : block.vtx)
+        setBlockTxids.insert(ptx->GetHash());
+    for (const CTransactionRef& ptx : block.vtx) {
+        if (ptx->IsCoinBase())
+            continue;
+        for (const CTxIn& txin : ptx->vin) {
+            if (!setBlockTxids.count(txin.prevout.hash))
+                vOutpoints.push_back(txin.prevout);
+        }
+    }
+    return vOutpoints;
+}
+
+CBlockInputPrefetcher::~CBlockInputPrefetcher()
+{
+    Stop();
+}
+
+void CBlockInputPrefetcher::Start(CCoinsViewCache* view, int nThreads)
+{
+    Stop();
+    if (!view || nThreads <= 0)
+        return;
+    {
+        std::lock_guard<std::mutex> lock(cs);
+        pview = view;
+        fStop = false;
+    }
+    for (int i = 0; i < nThreads; i++) {
+        vThreads.emplace_back(&TraceThread<std::function<void()> >, "blkprefetch",
+                              std::function<void()>(std::bind(&CBlockInputPrefetcher::ThreadPrefetch, this)));
+    }
+}
+
+void CBlockInputPrefetcher::Stop()
+{
+    {
+        std::lock_guard<std::mutex> lock(cs);
+        fStop = true;
+    }
+    condQueued.notify_all();
+    for (std::thread& thread : vThreads)
+        thread.join();
+    vThreads.clear();
+
+    std::lock_guard<std::mutex> lock(cs);
+    mapJobs.clear();
+    queue.clear();
+    nUsage = 0;
+    pview = nullptr;
+}
+
+bool CBlockInputPrefetcher::IsRunning() const
+{
+    std::lock_guard<std::mutex> lock(cs);
+    return pview != nullptr && !fStop;
+}
+
+void CBlockInputPrefetcher::ThreadPrefetch()
+{
+    while (true) {
+        std::shared_ptr<CJob> job;
+        {
+            std::unique_lock<std::mutex> lock(cs);
+            condQueued.wait(lock, [this] { return fStop || !queue.empty(); });
+            if (fStop)
+                return;
+            job = std::move(queue.front());
+            queue.pop_front();
+            if (job->state != CJob::QUEUED)
+                continue;
+            job->state = CJob::RUNNING;
+        }
+
+        // An odd sequence means the view is writing to its base right now,
+        // so whatever is read can't be trusted and Apply will drop it
+        const uint64_t nSequence = pview->GetFlushSequence();
+        std::vector<std::pair<COutPoint, CCoinsCacheEntry>> vEntries;
+        size_t nJobUsage = 0;
+        if (!(nSequence & 1)) {
+            std::vector<std::pair<COutPoint, Coin>> vCoins;
+            pview->GetBaseCoins(job->vOutpoints, vCoins);
+            vEntries.reserve(vCoins.size());
+            for (std::pair<COutPoint, Coin>& fetched : vCoins) {
+                vEntries.emplace_back(fetched.first, CCoinsCacheEntry(std::move(fetched.second)));
+                CCoinsCacheEntry& entry = vEntries.back().second;
+                if (entry.coin.IsAsset()) {
+                    auto data = std::make_shared<CCoinAssetData>();
+                    DecodeCoinAssetData(entry.coin.out.scriptPubKey, *data);
+                    entry.assetData = std::move(data);
+                }
+                nJobUsage += entry.DynamicMemoryUsage();
+            }
+            nJobUsage += memusage::DynamicUsage(vEntries);
+        }
+
+        {
+            std::lock_guard<std::mutex> lock(cs);
+            job->nSequence = nSequence;
+            job->vEntries = std::move(vEntries);
+            if (job->state == CJob::RUNNING) {
+                job->state = CJob::DONE;
+                job->nUsage = nJobUsage;
+                nUsage += nJobUsage;
+            } else {
+                job->vEntries.clear();
+            }
+        }
+        condDone.notify_all();
+    }
+}
+
+void CBlockInputPrefetcher::EraseLocked(std::map<uint256, std::shared_ptr<CJob>>::iterator it)
+{
+    CJob& job = *it->second;
+    nUsage -= job.nUsage;
+    job.nUsage = 0;
+    // A worker reading the job drops its result when it finds it discarded
+    job.state = CJob::DISCARDED;
+    mapJobs.erase(it);
+}
+
+void CBlockInputPrefetcher::EvictLocked()
+{
+    while (mapJobs.size() > MAX_PREFETCH_BLOCKS) {
+        auto itOldest = mapJobs.end();
+        for (auto it = mapJobs.begin(); it != mapJobs.end(); ++it) {
+            if (it->second->state != CJob::RUNNING && (itOldest == mapJobs.end() || it->second->nOrder < itOldest->second->nOrder))
+                itOldest = it;
+        }
+        if (itOldest == mapJobs.end())
+            return;
+        EraseLocked(itOldest);
+    }
+}
+
+void CBlockInputPrefetcher::Prefetch(const CBlock& block)
+{
+    std::vector<COutPoint> vOutpoints = GetBlockPrefetchOutpoints(block);
+    if (vOutpoints.empty())
+        return;
+    const uint256 hash = block.GetHash();
+    {
+        std::lock_guard<std::mutex> lock(cs);
+        if (!pview || fStop || mapJobs.count(hash))
+            return;
+        auto job = std::make_shared<CJob>();
+        job->hash = hash;
+        job->vOutpoints = std::move(vOutpoints);
+        job->nOrder = nNextOrder++;
+        mapJobs.emplace(hash, job);
+        queue.push_back(std::move(job));
+        EvictLocked();
+    }
+    condQueued.notify_one();
+}
+
+void CBlockInputPrefetcher::Discard(const uint256& hash)
+{
+    std::lock_guard<std::mutex> lock(cs);
+    auto it = mapJobs.find(hash);
+    if (it != mapJobs.end())
+        EraseLocked(it);
+}
+
+size_t CBlockInputPrefetcher::Apply(const uint256& hash)
+{
+    std::shared_ptr<CJob> job;
+    CCoinsViewCache* view;
+    {
+        std::unique_lock<std::mutex> lock(cs);
+        auto it = mapJobs.find(hash);
+        if (it == mapJobs.end())
+            return 0;
+        job = it->second;
+        // Once the read started, waiting for it beats reading the coins again
+        condDone.wait(lock, [&job] { return job->state != CJob::RUNNING; });
+        view = pview;
+        const bool fDone = job->state == CJob::DONE;
+        it = mapJobs.find(hash);
+        if (it != mapJobs.end())
+            EraseLocked(it);
+        if (!fDone || !view)
+            return 0;
+    }
+
+    if (job->nSequence & 1 || job->nSequence != view->GetFlushSequence()) {
+        LogPrint(BCLog::BENCH, "  - Prefetched inputs of %s are stale, dropped %u coins\n", hash.ToString(), job->vEntries.size());
+        return 0;
+    }
+    const size_t nCoins = job->vEntries.size();
+    view->AddFetchedCoins(job->vEntries);
+    LogPrint(BCLog::BENCH, "  - Prefetched inputs: %u of %u coins read ahead\n", nCoins, job->vOutpoints.size());
+    return nCoins;
+}
+
+size_t CBlockInputPrefetcher::DynamicMemoryUsage() const
+{
+    std::lock_guard<std::mutex> lock(cs);
+    return nUsage;
+}
@@ -0,0 +1,103 @@
+// Copyright (c) 2026 The Mynta Core Developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#ifndef MYNTA_BLOCKPREFETCH_H
+#define MYNTA_BLOCKPREFETCH_H
+
+#include "coins.h"
+#include "primitives/block.h"
+#include "uint256.h"
+
+#include <condition_variable>
+#include <deque>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/** Default for -prefetchthreads, threads reading the inputs of incoming blocks */
+static const int DEFAULT_PREFETCH_THREADS = 2;
+static const int MAX_PREFETCH_THREADS = 8;
+/** Most blocks whose inputs are held waiting to be connected */
+static const size_t MAX_PREFETCH_BLOCKS = 32;
+
+/** The prevouts of a block's transactions that aren't created by the block itself */
+std::vector<COutPoint> GetBlockPrefetchOutpoints(const CBlock& block);
+
+/**
+ * Reads the inputs of blocks that passed CheckBlock on a few worker threads,
+ * while the block still waits for cs_main, to be stored and for its parent
+ * to be connected. The coins are read from the backing view of the coins
+ * tip, asset coins decoded, and kept aside until ConnectTip hands them to
+ * the tip with Apply, so ConnectBlock finds them in memory.
+ *
+ * The tip is only written to its backing view by Flush, which moves its
+ * flush sequence before and after. Coins read while the sequence was odd or
+ * that it has moved past since are dropped, and the tip keeps its own entry
+ * for any outpoint it already has one for, so nothing stale gets in.
+ */
+class CBlockInputPrefetcher
+{
+private:
+    struct CJob {
+        enum State { QUEUED, RUNNING, DONE, DISCARDED };
+
+        uint256 hash;
+        std::vector<COutPoint> vOutpoints;
+        State state{QUEUED};
+        uint64_t nOrder{0};
+        //! Flush sequence of the view taken before the read
+        uint64_t nSequence{0};
+        std::vector<std::pair<COutPoint, CCoinsCacheEntry>> vEntries;
+        size_t nUsage{0};
+    };
+
+    mutable std::mutex cs;
+    std::condition_variable condQueued;
+    std::condition_variable condDone;
+    std::map<uint256, std::shared_ptr<CJob>> mapJobs;
+    std::deque<std::shared_ptr<CJob>> queue;
+    uint64_t nNextOrder{0};
+    size_t nUsage{0};
+    bool fStop{false};
+
+    CCoinsViewCache* pview{nullptr};
+    std::vector<std::thread> vThreads;
+
+    void ThreadPrefetch();
+    //! Drop a job that isn't being read, so the map stays within MAX_PREFETCH_BLOCKS
+    void EvictLocked();
+    void EraseLocked(std::map<uint256, std::shared_ptr<CJob>>::iterator it);
+
+public:
+    CBlockInputPrefetcher() {}
+    ~CBlockInputPrefetcher();
+
+    CBlockInputPrefetcher(const CBlockInputPrefetcher&) = delete;
+    CBlockInputPrefetcher& operator=(const CBlockInputPrefetcher&) = delete;
+
+    /** Start nThreads workers reading through view's backing view; Apply adds to view */
+    void Start(CCoinsViewCache* view, int nThreads);
+    /** Stop the workers and drop everything read so far */
+    void Stop();
+    bool IsRunning() const;
+
+    /** Queue the inputs of a block that passed CheckBlock */
+    void Prefetch(const CBlock& block);
+    /** Forget the block, for one that turned out to be known or invalid */
+    void Discard(const uint256& hash);
+    /**
+     * Add the coins read for the block to the view given to Start, waiting
+     * for a read in progress, and forget the block. Returns the number of
+     * coins handed over. Must be called under the lock guarding the view.
+     */
+    size_t Apply(const uint256& hash);
+
+    size_t DynamicMemoryUsage() const;
+};
+
+extern CBlockInputPrefetcher g_blockPrefetcher;
+
+#endif // MYNTA_BLOCKPREFETCH_H
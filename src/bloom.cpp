@@ -12,6 +12,8 @@
 #include "random.h"
 #include "streams.h"
 
+#include <algorithm>
+#include <assert.h>
 #include <math.h>
 #include <stdlib.h>
 
@@ -50,67 +52,133 @@ CBloomFilter::CBloomFilter(const unsigned int nElements, const double nFPRate, c
 {
 }
 
-inline unsigned int CBloomFilter::Hash(unsigned int nHashNum, const std::vector<unsigned char>& vDataToHash) const
+CBloomFilterElements::CBloomFilterElements(const CTransaction& tx)
+{
+    std::vector<unsigned char> data;
+
+    vOutputBegin.reserve(tx.vout.size() + 1);
+    for (const CTxOut& txout : tx.vout) {
+        vOutputBegin.push_back(vElements.size());
+        CScript::const_iterator pc = txout.scriptPubKey.begin();
+        while (pc < txout.scriptPubKey.end())
+        {
+            opcodetype opcode;
+            if (!txout.scriptPubKey.GetOp(pc, opcode, data))
+                break;
+            if (data.size() != 0)
+                AddElement(data.data(), data.size());
+        }
+    }
+    vOutputBegin.push_back(vElements.size());
+
+    vInputBegin.reserve(tx.vin.size() + 1);
+    for (const CTxIn& txin : tx.vin) {
+        vInputBegin.push_back(vElements.size());
+        CDataStream stream(SER_NETWORK, PROTOCOL_VERSION);
+        stream << txin.prevout;
+        AddElement((const unsigned char*)stream.data(), stream.size());
+
+        CScript::const_iterator pc = txin.scriptSig.begin();
+        while (pc < txin.scriptSig.end())
+        {
+            opcodetype opcode;
+            if (!txin.scriptSig.GetOp(pc, opcode, data))
+                break;
+            if (data.size() != 0)
+                AddElement(data.data(), data.size());
+        }
+    }
+    vInputBegin.push_back(vElements.size());
+}
+
+void CBloomFilterElements::AddElement(const unsigned char* pData, size_t nSize)
+{
+    vElements.push_back(Element{(uint32_t)vBytes.size(), (uint32_t)nSize});
+    vBytes.insert(vBytes.end(), pData, pData + nSize);
+}
+
+void CBloomFilter::Hash(unsigned int nFirst, unsigned int nHashes, const unsigned char* pKey, size_t nLen, unsigned int* pIndexes) const
 {
     // 0xFBA4C795 chosen as it guarantees a reasonable bit difference between nHashNum values.
-    return MurmurHash3(nHashNum * 0xFBA4C795 + nTweak, vDataToHash) % (vData.size() * 8);
+    MurmurHash3Multi(nFirst * 0xFBA4C795 + nTweak, 0xFBA4C795, nHashes, pKey, nLen, pIndexes);
+    for (unsigned int i = 0; i < nHashes; i++)
+        pIndexes[i] %= vData.size() * 8;
 }
 
-void CBloomFilter::insert(const std::vector<unsigned char>& vKey)
+void CBloomFilter::insert(const unsigned char* pKey, size_t nLen)
 {
     if (isFull)
         return;
-    for (unsigned int i = 0; i < nHashFuncs; i++)
+    unsigned int vIndexes[MURMUR_HASH_LANES];
+    for (unsigned int nFirst = 0; nFirst < nHashFuncs; nFirst += MURMUR_HASH_LANES)
     {
-        unsigned int nIndex = Hash(i, vKey);
-        // Sets bit nIndex of vData
-        vData[nIndex >> 3] |= (1 << (7 & nIndex));
+        unsigned int nHashes = std::min(MURMUR_HASH_LANES, nHashFuncs - nFirst);
+        Hash(nFirst, nHashes, pKey, nLen, vIndexes);
+        for (unsigned int i = 0; i < nHashes; i++)
+        {
+            // Sets bit nIndex of vData
+            unsigned int nIndex = vIndexes[i];
+            vData[nIndex >> 3] |= (1 << (7 & nIndex));
+        }
     }
     isEmpty = false;
 }
 
+void CBloomFilter::insert(const std::vector<unsigned char>& vKey)
+{
+    insert(vKey.data(), vKey.size());
+}
+
 void CBloomFilter::insert(const COutPoint& outpoint)
 {
     CDataStream stream(SER_NETWORK, PROTOCOL_VERSION);
     stream << outpoint;
-    std::vector<unsigned char> data(stream.begin(), stream.end());
-    insert(data);
+    insert((const unsigned char*)stream.data(), stream.size());
 }
 
 void CBloomFilter::insert(const uint256& hash)
 {
-    std::vector<unsigned char> data(hash.begin(), hash.end());
-    insert(data);
+    insert(hash.begin(), hash.size());
 }
 
-bool CBloomFilter::contains(const std::vector<unsigned char>& vKey) const
+bool CBloomFilter::contains(const unsigned char* pKey, size_t nLen) const
 {
     if (isFull)
         return true;
     if (isEmpty)
         return false;
-    for (unsigned int i = 0; i < nHashFuncs; i++)
+    // A batch of hash functions at a time, so a key the filter lacks is usually rejected by the first
+    unsigned int vIndexes[MURMUR_HASH_LANES];
+    for (unsigned int nFirst = 0; nFirst < nHashFuncs; nFirst += MURMUR_HASH_LANES)
     {
-        unsigned int nIndex = Hash(i, vKey);
-        // Checks bit nIndex of vData
-        if (!(vData[nIndex >> 3] & (1 << (7 & nIndex))))
-            return false;
+        unsigned int nHashes = std::min(MURMUR_HASH_LANES, nHashFuncs - nFirst);
+        Hash(nFirst, nHashes, pKey, nLen, vIndexes);
+        for (unsigned int i = 0; i < nHashes; i++)
+        {
+            // Checks bit nIndex of vData
+            unsigned int nIndex = vIndexes[i];
+            if (!(vData[nIndex >> 3] & (1 << (7 & nIndex))))
+                return false;
+        }
     }
     return true;
 }
 
+bool CBloomFilter::contains(const std::vector<unsigned char>& vKey) const
+{
+    return contains(vKey.data(), vKey.size());
+}
+
 bool CBloomFilter::contains(const COutPoint& outpoint) const
 {
     CDataStream stream(SER_NETWORK, PROTOCOL_VERSION);
     stream << outpoint;
-    std::vector<unsigned char> data(stream.begin(), stream.end());
-    return contains(data);
+    return contains((const unsigned char*)stream.data(), stream.size());
 }
 
 bool CBloomFilter::contains(const uint256& hash) const
 {
-    std::vector<unsigned char> data(hash.begin(), hash.end());
-    return contains(data);
+    return contains(hash.begin(), hash.size());
 }
 
 void CBloomFilter::clear()
@@ -133,6 +201,17 @@ bool CBloomFilter::IsWithinSizeConstraints() const
 
 bool CBloomFilter::IsRelevantAndUpdate(const CTransaction& tx)
 {
+    if (isFull)
+        return true;
+    if (isEmpty)
+        return false;
+    return IsRelevantAndUpdate(tx, CBloomFilterElements(tx));
+}
+
+bool CBloomFilter::IsRelevantAndUpdate(const CTransaction& tx, const CBloomFilterElements& elements)
+{
+    assert(elements.vOutputBegin.size() == tx.vout.size() + 1 && elements.vInputBegin.size() == tx.vin.size() + 1);
+
     bool fFound = false;
     // Match if the filter contains the hash of tx
     //  for finding tx when they appear in a block
@@ -151,14 +230,10 @@ bool CBloomFilter::IsRelevantAndUpdate(const CTransaction& tx)
         // If this matches, also add the specific output that was matched.
         // This means clients don't have to update the filter themselves when a new relevant tx 
         // is discovered in order to find spending transactions, which avoids round-tripping and race conditions.
-        CScript::const_iterator pc = txout.scriptPubKey.begin();
-        std::vector<unsigned char> data;
-        while (pc < txout.scriptPubKey.end())
+        for (uint32_t n = elements.vOutputBegin[i]; n < elements.vOutputBegin[i + 1]; n++)
         {
-            opcodetype opcode;
-            if (!txout.scriptPubKey.GetOp(pc, opcode, data))
-                break;
-            if (data.size() != 0 && contains(data))
+            const CBloomFilterElements::Element& element = elements.vElements[n];
+            if (contains(elements.Data(element), element.nSize))
             {
                 fFound = true;
                 if ((nFlags & BLOOM_UPDATE_MASK) == BLOOM_UPDATE_ALL)
@@ -179,23 +254,13 @@ bool CBloomFilter::IsRelevantAndUpdate(const CTransaction& tx)
     if (fFound)
         return true;
 
-    for (const CTxIn& txin : tx.vin)
+    // Match if the filter contains an outpoint tx spends, the first element of each input,
+    // or any arbitrary script data element in any scriptSig in tx
+    for (uint32_t n = elements.vInputBegin.front(); n < elements.vInputBegin.back(); n++)
     {
-        // Match if the filter contains an outpoint tx spends
-        if (contains(txin.prevout))
+        const CBloomFilterElements::Element& element = elements.vElements[n];
+        if (contains(elements.Data(element), element.nSize))
             return true;
-
-        // Match if the filter contains any arbitrary script data element in any scriptSig in tx
-        CScript::const_iterator pc = txin.scriptSig.begin();
-        std::vector<unsigned char> data;
-        while (pc < txin.scriptSig.end())
-        {
-            opcodetype opcode;
-            if (!txin.scriptSig.GetOp(pc, opcode, data))
-                break;
-            if (data.size() != 0 && contains(data))
-                return true;
-        }
     }
 
     return false;
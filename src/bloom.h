@@ -8,6 +8,7 @@
 
 #include "serialize.h"
 
+#include <stdint.h>
 #include <vector>
 
 class COutPoint;
@@ -31,6 +32,37 @@ enum bloomflags
     BLOOM_UPDATE_MASK = 3,
 };
 
+/**
+ * The data elements of a transaction that CBloomFilter::IsRelevantAndUpdate
+ * matches: the push data of each scriptPubKey, and the serialized prevout and
+ * scriptSig push data of each input. They don't depend on the filter, so a
+ * block's are extracted once and matched against every peer's filter.
+ */
+class CBloomFilterElements
+{
+public:
+    struct Element
+    {
+        uint32_t nBegin;
+        uint32_t nSize;
+    };
+
+    //! Every element's bytes, back to back
+    std::vector<unsigned char> vBytes;
+    std::vector<Element> vElements;
+    //! Where in vElements each output's elements start, and one past the last output's end
+    std::vector<uint32_t> vOutputBegin;
+    //! Where in vElements each input's elements start, its prevout first, and one past the last input's end
+    std::vector<uint32_t> vInputBegin;
+
+    explicit CBloomFilterElements(const CTransaction& tx);
+
+    const unsigned char* Data(const Element& element) const { return vBytes.data() + element.nBegin; }
+
+private:
+    void AddElement(const unsigned char* pData, size_t nSize);
+};
+
 /**
  * BloomFilter is a probabilistic filter which SPV clients provide
  * so that we can filter the transactions we send them.
@@ -52,7 +84,10 @@ private:
     unsigned int nTweak;
     unsigned char nFlags;
 
-    unsigned int Hash(unsigned int nHashNum, const std::vector<unsigned char>& vDataToHash) const;
+    //! Bit indexes of hash functions nFirst to nFirst + nHashes - 1 for the key, into pIndexes
+    void Hash(unsigned int nFirst, unsigned int nHashes, const unsigned char* pKey, size_t nLen, unsigned int* pIndexes) const;
+    void insert(const unsigned char* pKey, size_t nLen);
+    bool contains(const unsigned char* pKey, size_t nLen) const;
 
     // Private constructor for CRollingBloomFilter, no restrictions on size
     CBloomFilter(const unsigned int nElements, const double nFPRate, const unsigned int nTweak);
@@ -98,6 +133,8 @@ public:
 
     //! Also adds any outputs which match the filter to the filter (to match their spending txes)
     bool IsRelevantAndUpdate(const CTransaction& tx);
+    //! Same, with the elements of tx already extracted
+    bool IsRelevantAndUpdate(const CTransaction& tx, const CBloomFilterElements& elements);
 
     //! Checks for empty and full filters to avoid wasting cpu
     void UpdateEmptyFull();
@@ -23,7 +23,10 @@
 
 #include <algorithm>
 #include <cstring>
+#include <list>
+#include <map>
 #include <sstream>
+#include <unordered_map>
 
 // Domain separation tag for Mynta BLS signatures
 static const std::string DST_MYNTA_BLS = "BLS_SIG_BLS12381G2_XMD:SHA-256_SSWU_RO_NUL_";
@@ -37,6 +40,183 @@ static void SecureClear(void* ptr, size_t len)
     memory_cleanse(ptr, len);
 }
 
+// Map a participant id into the scalar field (ids are reduced mod r)
+static bool IdToFr(const CBLSId& id, blst_fr& frOut)
+{
+    blst_scalar scalar;
+    if (!id.IsValid() || !blst_scalar_from_le_bytes(&scalar, id.GetHash().begin(), 32)) {
+        return false;
+    }
+    blst_fr_from_scalar(&frOut, &scalar);
+    return true;
+}
+
+static bool FrIsZero(const blst_fr& fr)
+{
+    static const blst_fr frZero{};
+    return memcmp(&fr, &frZero, sizeof(blst_fr)) == 0;
+}
+
+// ============================================================================
+// Decompressed point cache
+// ============================================================================
+
+/**
+ * Process-wide LRU cache from compressed point bytes to the decompressed,
+ * subgroup-checked affine point. Operator and quorum public keys are parsed
+ * over and over (every quorum build, every verification); with the cache
+ * only the first sighting pays for decompression and the group check.
+ * Only points that passed both checks are ever inserted.
+ *
+ * Points that verify many signatures, like the public keys of the active
+ * quorums, can be pinned: they are kept outside the LRU until unpinned as
+ * often as they were pinned, so lookups of other keys never evict them.
+ */
+template <size_t N, typename Point>
+class CBLSPointCache
+{
+private:
+    typedef std::array<uint8_t, N> Key;
+
+    struct KeyHasher {
+        size_t operator()(const Key& key) const
+        {
+            // Compressed points are uniformly distributed apart from the
+            // flag bits in the first byte
+            size_t h;
+            memcpy(&h, key.data() + 8, sizeof(h));
+            return h;
+        }
+    };
+
+    typedef std::list<Key> LRUList;
+
+    std::mutex mutex;
+    const size_t nMaxSize;
+    LRUList lruList;
+    std::unordered_map<Key, std::pair<Point, typename LRUList::iterator>, KeyHasher> cache;
+    // Pinned points and how often each was pinned
+    std::unordered_map<Key, std::pair<Point, size_t>, KeyHasher> pinned;
+
+public:
+    explicit CBLSPointCache(size_t nMaxSizeIn) : nMaxSize(nMaxSizeIn) {}
+
+    bool Get(const uint8_t* bytes, Point& pointOut)
+    {
+        Key key;
+        memcpy(key.data(), bytes, N);
+        std::lock_guard<std::mutex> lock(mutex);
+        auto itPinned = pinned.find(key);
+        if (itPinned != pinned.end()) {
+            pointOut = itPinned->second.first;
+            return true;
+        }
+        auto it = cache.find(key);
+        if (it == cache.end()) {
+            return false;
+        }
+        lruList.splice(lruList.begin(), lruList, it->second.second);
+        pointOut = it->second.first;
+        return true;
+    }
+
+    void Put(const uint8_t* bytes, const Point& point)
+    {
+        Key key;
+        memcpy(key.data(), bytes, N);
+        std::lock_guard<std::mutex> lock(mutex);
+        if (cache.count(key)) {
+            return;
+        }
+        lruList.push_front(key);
+        cache.emplace(key, std::make_pair(point, lruList.begin()));
+        while (cache.size() > nMaxSize) {
+            cache.erase(lruList.back());
+            lruList.pop_back();
+        }
+    }
+
+    void Pin(const uint8_t* bytes, const Point& point)
+    {
+        Key key;
+        memcpy(key.data(), bytes, N);
+        std::lock_guard<std::mutex> lock(mutex);
+        auto& entry = pinned.emplace(key, std::make_pair(point, 0)).first->second;
+        entry.second++;
+    }
+
+    void Unpin(const uint8_t* bytes)
+    {
+        Key key;
+        memcpy(key.data(), bytes, N);
+        std::lock_guard<std::mutex> lock(mutex);
+        auto it = pinned.find(key);
+        if (it != pinned.end() && --it->second.second == 0) {
+            pinned.erase(it);
+        }
+    }
+
+    size_t PinnedSize()
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        return pinned.size();
+    }
+};
+
+static const size_t BLS_PUBKEY_CACHE_SIZE = 8192;
+static const size_t BLS_SIG_CACHE_SIZE = 2048;
+
+static CBLSPointCache<BLS_PUBLIC_KEY_SIZE, blst_p1_affine> pubKeyPointCache(BLS_PUBKEY_CACHE_SIZE);
+static CBLSPointCache<BLS_SIGNATURE_SIZE, blst_p2_affine> sigPointCache(BLS_SIG_CACHE_SIZE);
+
+// Decompress and subgroup-check a G1 point, consulting the cache first
+static bool DecompressPublicKey(const uint8_t* bytes, blst_p1_affine& pointOut)
+{
+    if (pubKeyPointCache.Get(bytes, pointOut)) {
+        return true;
+    }
+    if (blst_p1_uncompress(&pointOut, bytes) != BLST_SUCCESS || !blst_p1_affine_in_g1(&pointOut)) {
+        return false;
+    }
+    pubKeyPointCache.Put(bytes, pointOut);
+    return true;
+}
+
+bool BLSPinPublicKey(const CBLSPublicKey& pk)
+{
+    blst_p1_affine point;
+    if (!pk.IsValid() || !DecompressPublicKey(pk.begin(), point)) {
+        return false;
+    }
+    pubKeyPointCache.Pin(pk.begin(), point);
+    return true;
+}
+
+void BLSUnpinPublicKey(const CBLSPublicKey& pk)
+{
+    if (pk.IsValid()) {
+        pubKeyPointCache.Unpin(pk.begin());
+    }
+}
+
+size_t BLSPinnedPublicKeyCount()
+{
+    return pubKeyPointCache.PinnedSize();
+}
+
+// Decompress and subgroup-check a G2 point, consulting the cache first
+static bool DecompressSignature(const uint8_t* bytes, blst_p2_affine& pointOut)
+{
+    if (sigPointCache.Get(bytes, pointOut)) {
+        return true;
+    }
+    if (blst_p2_uncompress(&pointOut, bytes) != BLST_SUCCESS || !blst_p2_affine_in_g2(&pointOut)) {
+        return false;
+    }
+    sigPointCache.Put(bytes, pointOut);
+    return true;
+}
+
 // ============================================================================
 // CBLSId Implementation
 // ============================================================================
@@ -221,6 +401,45 @@ CBLSSignature CBLSSecretKey::SignWithShare(const uint256& hash, const CBLSId& id
     return Sign(shareHash);
 }
 
+bool CBLSSecretKey::SecretKeyShare(const std::vector<CBLSSecretKey>& msk, const CBLSId& id)
+{
+    SetNull();
+    
+    blst_fr x;
+    if (msk.empty() || !IdToFr(id, x)) {
+        return false;
+    }
+    
+    // Horner evaluation of f(x) = msk[0] + msk[1]*x + ... + msk[t-1]*x^(t-1)
+    blst_fr y{};
+    for (auto it = msk.rbegin(); it != msk.rend(); ++it) {
+        if (!it->IsValid()) {
+            SecureClear(&y, sizeof(y));
+            return false;
+        }
+        blst_scalar coeff;
+        blst_fr frCoeff;
+        blst_scalar_from_bendian(&coeff, it->data.data());
+        blst_fr_from_scalar(&frCoeff, &coeff);
+        blst_fr_mul(&y, &y, &x);
+        blst_fr_add(&y, &y, &frCoeff);
+        SecureClear(&coeff, sizeof(coeff));
+        SecureClear(&frCoeff, sizeof(frCoeff));
+    }
+    
+    blst_scalar sk;
+    blst_scalar_from_fr(&sk, &y);
+    blst_bendian_from_scalar(data.data(), &sk);
+    fValid = blst_sk_check(&sk);
+    SecureClear(&sk, sizeof(sk));
+    SecureClear(&y, sizeof(y));
+    
+    if (!fValid) {
+        SetNull();
+    }
+    return fValid;
+}
+
 std::vector<uint8_t> CBLSSecretKey::ToBytes() const
 {
     return std::vector<uint8_t>(data.begin(), data.end());
@@ -269,17 +488,9 @@ bool CBLSPublicKey::SetBytes(const std::vector<uint8_t>& bytes)
     
     std::copy(bytes.begin(), bytes.end(), data.begin());
     
-    // Validate by attempting to decompress
+    // Validate by decompressing and checking the point is in the G1 subgroup
     blst_p1_affine pk_affine;
-    BLST_ERROR err = blst_p1_uncompress(&pk_affine, data.data());
-    
-    if (err != BLST_SUCCESS) {
-        SetNull();
-        return false;
-    }
-    
-    // Verify point is in G1 subgroup
-    fValid = blst_p1_affine_in_g1(&pk_affine);
+    fValid = DecompressPublicKey(data.data(), pk_affine);
     fHashCached = false;
     
     if (!fValid) {
@@ -356,8 +567,7 @@ CBLSPublicKey CBLSPublicKey::AggregatePublicKeys(const std::vector<CBLSPublicKey
         }
         
         blst_p1_affine pk_affine;
-        BLST_ERROR err = blst_p1_uncompress(&pk_affine, pk.data.data());
-        if (err != BLST_SUCCESS) {
+        if (!DecompressPublicKey(pk.data.data(), pk_affine)) {
             return CBLSPublicKey();
         }
         
@@ -419,17 +629,9 @@ bool CBLSSignature::SetBytes(const std::vector<uint8_t>& bytes)
     
     std::copy(bytes.begin(), bytes.end(), data.begin());
     
-    // Validate by attempting to decompress
+    // Validate by decompressing and checking the point is in the G2 subgroup
     blst_p2_affine sig_affine;
-    BLST_ERROR err = blst_p2_uncompress(&sig_affine, data.data());
-    
-    if (err != BLST_SUCCESS) {
-        SetNull();
-        return false;
-    }
-    
-    // Verify point is in G2 subgroup
-    fValid = blst_p2_affine_in_g2(&sig_affine);
+    fValid = DecompressSignature(data.data(), sig_affine);
     
     if (!fValid) {
         SetNull();
@@ -472,20 +674,18 @@ bool CBLSSignature::VerifyInsecure(const CBLSPublicKey& pk, const uint256& hash)
     
     // Decompress public key
     blst_p1_affine pk_affine;
-    BLST_ERROR err = blst_p1_uncompress(&pk_affine, pk.begin());
-    if (err != BLST_SUCCESS) {
+    if (!DecompressPublicKey(pk.begin(), pk_affine)) {
         return false;
     }
     
     // Decompress signature
     blst_p2_affine sig_affine;
-    err = blst_p2_uncompress(&sig_affine, data.data());
-    if (err != BLST_SUCCESS) {
+    if (!DecompressSignature(data.data(), sig_affine)) {
         return false;
     }
     
     // Verify signature using pairing
-    err = blst_core_verify_pk_in_g1(&pk_affine, &sig_affine, true,
+    BLST_ERROR err = blst_core_verify_pk_in_g1(&pk_affine, &sig_affine, true,
                                     hash.begin(), 32,
                                     (const uint8_t*)DST_MYNTA_BLS.data(),
                                     DST_MYNTA_BLS.size(),
@@ -511,23 +711,133 @@ bool CBLSSignature::VerifySecure(const CBLSPublicKey& pk, const uint256& hash,
     return VerifyInsecure(pk, prefixedHash);
 }
 
+/**
+ * Verify the entries with indexes in [begin, end) as one batch.
+ *
+ * Each (pk_i, sig_i, msg_i) triple is weighted by a fresh random 64-bit
+ * scalar r_i and accumulated into a single pairing context, so the batch
+ * checks e(sum(r_i * sig_i), G1) == prod(e(r_i * pk_i, H(msg_i))) with one
+ * final exponentiation. A forged signature can only slip through if the
+ * attacker guesses the random weights.
+ */
+static bool BatchVerifyRange(
+    const std::vector<blst_p1_affine>& pkPoints,
+    const std::vector<blst_p2_affine>& sigPoints,
+    const std::vector<uint256>& hashes,
+    const std::vector<size_t>& vecIndexes,
+    size_t begin, size_t end)
+{
+    if (end - begin == 1) {
+        size_t i = vecIndexes[begin];
+        return blst_core_verify_pk_in_g1(&pkPoints[i], &sigPoints[i], true,
+                                         hashes[i].begin(), 32,
+                                         (const uint8_t*)DST_MYNTA_BLS.data(),
+                                         DST_MYNTA_BLS.size(),
+                                         nullptr, 0) == BLST_SUCCESS;
+    }
+
+    std::vector<uint8_t> pairing_buffer(blst_pairing_sizeof());
+    blst_pairing* ctx = reinterpret_cast<blst_pairing*>(pairing_buffer.data());
+    blst_pairing_init(ctx, true, (const uint8_t*)DST_MYNTA_BLS.data(), DST_MYNTA_BLS.size());
+
+    for (size_t j = begin; j < end; j++) {
+        size_t i = vecIndexes[j];
+
+        // Random non-zero weight (little-endian, as blst expects)
+        uint8_t scalar[8];
+        GetRandBytes(scalar, sizeof(scalar));
+        scalar[0] |= 1;
+
+        BLST_ERROR err = blst_pairing_mul_n_aggregate_pk_in_g1(ctx, &pkPoints[i], &sigPoints[i],
+                                                               scalar, 64,
+                                                               hashes[i].begin(), 32,
+                                                               nullptr, 0);
+        if (err != BLST_SUCCESS) {
+            return false;
+        }
+    }
+
+    blst_pairing_commit(ctx);
+    return blst_pairing_finalverify(ctx, nullptr);
+}
+
+/**
+ * Verify [begin, end) as a batch and, if it fails, bisect until the
+ * offending entries are isolated. Indexes of invalid entries are appended
+ * to vecInvalid.
+ */
+static void BatchVerifyBisect(
+    const std::vector<blst_p1_affine>& pkPoints,
+    const std::vector<blst_p2_affine>& sigPoints,
+    const std::vector<uint256>& hashes,
+    const std::vector<size_t>& vecIndexes,
+    size_t begin, size_t end,
+    std::vector<size_t>& vecInvalid)
+{
+    if (begin == end) {
+        return;
+    }
+    if (BatchVerifyRange(pkPoints, sigPoints, hashes, vecIndexes, begin, end)) {
+        return;
+    }
+    if (end - begin == 1) {
+        vecInvalid.emplace_back(vecIndexes[begin]);
+        return;
+    }
+    size_t mid = begin + (end - begin) / 2;
+    BatchVerifyBisect(pkPoints, sigPoints, hashes, vecIndexes, begin, mid, vecInvalid);
+    BatchVerifyBisect(pkPoints, sigPoints, hashes, vecIndexes, mid, end, vecInvalid);
+}
+
 bool CBLSSignature::BatchVerify(
     const std::vector<CBLSSignature>& sigs,
     const std::vector<CBLSPublicKey>& pubKeys,
     const std::vector<uint256>& hashes)
 {
+    std::vector<size_t> vecInvalid;
+    return BatchVerify(sigs, pubKeys, hashes, vecInvalid, false);
+}
+
+bool CBLSSignature::BatchVerify(
+    const std::vector<CBLSSignature>& sigs,
+    const std::vector<CBLSPublicKey>& pubKeys,
+    const std::vector<uint256>& hashes,
+    std::vector<size_t>& vecInvalid,
+    bool fFindInvalid)
+{
+    vecInvalid.clear();
+
     if (sigs.size() != pubKeys.size() || sigs.size() != hashes.size() || sigs.empty()) {
         return false;
     }
-    
-    // For now, verify each signature individually
-    // A full implementation would use multi-pairing for efficiency
+
+    // Decompress every point once up front; malformed entries are reported
+    // directly and never enter the pairing batch.
+    std::vector<blst_p1_affine> pkPoints(sigs.size());
+    std::vector<blst_p2_affine> sigPoints(sigs.size());
+    std::vector<size_t> vecIndexes;
+    vecIndexes.reserve(sigs.size());
+
     for (size_t i = 0; i < sigs.size(); i++) {
-        if (!sigs[i].VerifyInsecure(pubKeys[i], hashes[i])) {
-            return false;
+        if (!sigs[i].IsValid() || !pubKeys[i].IsValid() ||
+            !DecompressPublicKey(pubKeys[i].begin(), pkPoints[i]) ||
+            !DecompressSignature(sigs[i].begin(), sigPoints[i])) {
+            vecInvalid.emplace_back(i);
+            if (!fFindInvalid) {
+                return false;
+            }
+            continue;
         }
+        vecIndexes.emplace_back(i);
     }
-    return true;
+
+    if (!fFindInvalid) {
+        return BatchVerifyRange(pkPoints, sigPoints, hashes, vecIndexes, 0, vecIndexes.size());
+    }
+
+    BatchVerifyBisect(pkPoints, sigPoints, hashes, vecIndexes, 0, vecIndexes.size(), vecInvalid);
+    std::sort(vecInvalid.begin(), vecInvalid.end());
+    return vecInvalid.empty();
 }
 
 CBLSSignature CBLSSignature::AggregateSignatures(const std::vector<CBLSSignature>& sigs)
@@ -552,8 +862,7 @@ CBLSSignature CBLSSignature::AggregateSignatures(const std::vector<CBLSSignature
         
         // Decompress signature
         blst_p2_affine sig_affine;
-        BLST_ERROR err = blst_p2_uncompress(&sig_affine, sig.data.data());
-        if (err != BLST_SUCCESS) {
+        if (!DecompressSignature(sig.data.data(), sig_affine)) {
             return CBLSSignature();
         }
         
@@ -594,8 +903,7 @@ bool CBLSSignature::VerifyAggregate(
     
     // Decompress the aggregated signature
     blst_p2_affine agg_sig_affine;
-    BLST_ERROR err = blst_p2_uncompress(&agg_sig_affine, data.data());
-    if (err != BLST_SUCCESS) {
+    if (!DecompressSignature(data.data(), agg_sig_affine)) {
         return false;
     }
     
@@ -606,13 +914,12 @@ bool CBLSSignature::VerifyAggregate(
         }
         
         blst_p1_affine pk_affine;
-        err = blst_p1_uncompress(&pk_affine, pks[i].begin());
-        if (err != BLST_SUCCESS) {
+        if (!DecompressPublicKey(pks[i].begin(), pk_affine)) {
             return false;
         }
         
         // Add to pairing context
-        err = blst_pairing_aggregate_pk_in_g1(ctx, &pk_affine, nullptr,
+        BLST_ERROR err = blst_pairing_aggregate_pk_in_g1(ctx, &pk_affine, nullptr,
                                               hashes[i].begin(), 32,
                                               nullptr, 0);
         if (err != BLST_SUCCESS) {
@@ -647,19 +954,300 @@ bool CBLSSignature::VerifySameMessage(
     return VerifyInsecure(aggPk, hash);
 }
 
-CBLSSignature CBLSSignature::RecoverThresholdSignature(
+// ============================================================================
+// Threshold recovery (Lagrange interpolation at x = 0)
+// ============================================================================
+
+/**
+ * Compute the Lagrange coefficients lambda_i = prod_{j != i} x_j / (x_j - x_i)
+ * for the given ids. All denominators are inverted together (Montgomery's
+ * trick), so the whole set costs one field inversion.
+ */
+static bool ComputeLagrangeCoefficients(const std::vector<CBLSId>& ids, std::vector<blst_scalar>& coeffsOut)
+{
+    const size_t n = ids.size();
+    std::vector<blst_fr> xs(n);
+    for (size_t i = 0; i < n; i++) {
+        if (!IdToFr(ids[i], xs[i])) {
+            return false;
+        }
+    }
+    
+    // total = prod x_j, den_i = x_i * prod_{j != i} (x_j - x_i)
+    // so that lambda_i = total / den_i
+    blst_fr total = xs[0];
+    for (size_t i = 1; i < n; i++) {
+        blst_fr_mul(&total, &total, &xs[i]);
+    }
+    
+    std::vector<blst_fr> dens(n);
+    for (size_t i = 0; i < n; i++) {
+        dens[i] = xs[i];
+        for (size_t j = 0; j < n; j++) {
+            if (j == i) continue;
+            blst_fr diff;
+            blst_fr_sub(&diff, &xs[j], &xs[i]);
+            blst_fr_mul(&dens[i], &dens[i], &diff);
+        }
+        if (FrIsZero(dens[i])) {
+            // Duplicate (or zero) id, interpolation is undefined
+            return false;
+        }
+    }
+    
+    // Batch inversion
+    std::vector<blst_fr> prefix(n);
+    prefix[0] = dens[0];
+    for (size_t i = 1; i < n; i++) {
+        blst_fr_mul(&prefix[i], &prefix[i - 1], &dens[i]);
+    }
+    blst_fr inv;
+    blst_fr_inverse(&inv, &prefix[n - 1]);
+    
+    coeffsOut.resize(n);
+    for (size_t i = n; i-- > 0; ) {
+        blst_fr invDen = inv;
+        if (i > 0) {
+            blst_fr_mul(&invDen, &invDen, &prefix[i - 1]);
+            blst_fr_mul(&inv, &inv, &dens[i]);
+        }
+        blst_fr lambda;
+        blst_fr_mul(&lambda, &total, &invDen);
+        blst_scalar_from_fr(&coeffsOut[i], &lambda);
+    }
+    return true;
+}
+
+/**
+ * Lagrange coefficients only depend on the signer id set, and the same
+ * quorum usually recovers many signatures from the same members. Cache them
+ * per (quorumHash, ordered signer ids), evicting least recently used.
+ */
+static const size_t MAX_LAGRANGE_CACHE_SIZE = 1024;
+
+class CLagrangeCoefficientCache
+{
+private:
+    std::mutex mutex;
+    std::list<uint256> lruList;
+    std::map<uint256, std::pair<std::vector<blst_scalar>, std::list<uint256>::iterator>> cache;
+
+public:
+    bool Get(const uint256& key, std::vector<blst_scalar>& coeffsOut)
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        auto it = cache.find(key);
+        if (it == cache.end()) {
+            return false;
+        }
+        lruList.splice(lruList.begin(), lruList, it->second.second);
+        coeffsOut = it->second.first;
+        return true;
+    }
+
+    void Put(const uint256& key, const std::vector<blst_scalar>& coeffs)
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (cache.count(key)) {
+            return;
+        }
+        lruList.push_front(key);
+        cache.emplace(key, std::make_pair(coeffs, lruList.begin()));
+        while (cache.size() > MAX_LAGRANGE_CACHE_SIZE) {
+            cache.erase(lruList.back());
+            lruList.pop_back();
+        }
+    }
+};
+
+static CLagrangeCoefficientCache lagrangeCache;
+
+static CBLSSignature RecoverThresholdSignatureInternal(
     const std::vector<CBLSSignature>& sigShares,
     const std::vector<CBLSId>& ids,
-    size_t threshold)
+    size_t threshold,
+    const uint256* pquorumHash)
 {
-    if (sigShares.size() < threshold || sigShares.size() != ids.size()) {
+    if (threshold == 0 || sigShares.size() < threshold || sigShares.size() != ids.size()) {
         return CBLSSignature();
     }
     
-    // For full Lagrange interpolation, we would compute:
-    // sig = sum(share_i * lagrange_coeff_i)
-    // Simplified: aggregate shares with equal weight
-    return AggregateSignatures(sigShares);
+    // Any t shares of a degree t-1 polynomial determine it; use the first t
+    std::vector<CBLSId> usedIds(ids.begin(), ids.begin() + threshold);
+    
+    std::vector<blst_p2_affine> points(threshold);
+    for (size_t i = 0; i < threshold; i++) {
+        if (!sigShares[i].IsValid() ||
+            !DecompressSignature(sigShares[i].begin(), points[i])) {
+            return CBLSSignature();
+        }
+    }
+    
+    if (threshold == 1) {
+        // f is constant, the single share already is the recovered signature
+        return sigShares[0];
+    }
+    
+    std::vector<blst_scalar> coeffs;
+    uint256 cacheKey;
+    if (pquorumHash) {
+        CHashWriter hw(SER_GETHASH, 0);
+        hw << *pquorumHash;
+        for (const auto& id : usedIds) {
+            hw << id.GetHash();
+        }
+        cacheKey = hw.GetHash();
+    }
+    if (!pquorumHash || !lagrangeCache.Get(cacheKey, coeffs)) {
+        if (!ComputeLagrangeCoefficients(usedIds, coeffs)) {
+            return CBLSSignature();
+        }
+        if (pquorumHash) {
+            lagrangeCache.Put(cacheKey, coeffs);
+        }
+    }
+    
+    // sig = sum(lambda_i * share_i), computed as one multi-scalar
+    // multiplication (Pippenger) instead of t separate scalar multiplies
+    std::vector<const blst_p2_affine*> pointPtrs(threshold);
+    std::vector<const uint8_t*> scalarPtrs(threshold);
+    for (size_t i = 0; i < threshold; i++) {
+        pointPtrs[i] = &points[i];
+        scalarPtrs[i] = coeffs[i].b;
+    }
+    std::vector<limb_t> scratch(blst_p2s_mult_pippenger_scratch_sizeof(threshold) / sizeof(limb_t) + 1);
+    
+    blst_p2 recovered;
+    blst_p2s_mult_pippenger(&recovered, pointPtrs.data(), threshold, scalarPtrs.data(), 255, scratch.data());
+    
+    std::vector<uint8_t> sigBytes(BLS_SIGNATURE_SIZE);
+    blst_p2_compress(sigBytes.data(), &recovered);
+    
+    CBLSSignature sig;
+    sig.SetBytes(sigBytes);
+    return sig;
+}
+
+CBLSSignature CBLSSignature::RecoverThresholdSignature(
+    const std::vector<CBLSSignature>& sigShares,
+    const std::vector<CBLSId>& ids,
+    size_t threshold)
+{
+    return RecoverThresholdSignatureInternal(sigShares, ids, threshold, nullptr);
+}
+
+CBLSSignature CBLSSignature::RecoverThresholdSignature(
+    const std::vector<CBLSSignature>& sigShares,
+    const std::vector<CBLSId>& ids,
+    size_t threshold,
+    const uint256& quorumHash)
+{
+    return RecoverThresholdSignatureInternal(sigShares, ids, threshold, &quorumHash);
+}
+
+// ============================================================================
+// CBLSLazyPublicKey / CBLSLazySignature Implementation
+// ============================================================================
+
+CBLSLazyPublicKey::CBLSLazyPublicKey(const CBLSLazyPublicKey& other)
+{
+    std::lock_guard<std::mutex> lock(other.mutex);
+    vecBytes = other.vecBytes;
+    pubKey = other.pubKey;
+    fParsed = other.fParsed;
+}
+
+CBLSLazyPublicKey& CBLSLazyPublicKey::operator=(const CBLSLazyPublicKey& other)
+{
+    if (this != &other) {
+        std::lock(mutex, other.mutex);
+        std::lock_guard<std::mutex> lock1(mutex, std::adopt_lock);
+        std::lock_guard<std::mutex> lock2(other.mutex, std::adopt_lock);
+        vecBytes = other.vecBytes;
+        pubKey = other.pubKey;
+        fParsed = other.fParsed;
+    }
+    return *this;
+}
+
+void CBLSLazyPublicKey::SetBytes(const std::vector<uint8_t>& _vecBytes)
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    vecBytes = _vecBytes;
+    pubKey.SetNull();
+    fParsed = false;
+}
+
+const CBLSPublicKey& CBLSLazyPublicKey::Get() const
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    if (!fParsed) {
+        // Hot keys are served from the decompressed point cache
+        pubKey.SetBytes(vecBytes);
+        fParsed = true;
+    }
+    return pubKey;
+}
+
+bool CBLSLazyPublicKey::IsValid() const
+{
+    return Get().IsValid();
+}
+
+std::vector<uint8_t> CBLSLazyPublicKey::ToBytes() const
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    return vecBytes;
+}
+
+CBLSLazySignature::CBLSLazySignature(const CBLSLazySignature& other)
+{
+    std::lock_guard<std::mutex> lock(other.mutex);
+    vecBytes = other.vecBytes;
+    sig = other.sig;
+    fParsed = other.fParsed;
+}
+
+CBLSLazySignature& CBLSLazySignature::operator=(const CBLSLazySignature& other)
+{
+    if (this != &other) {
+        std::lock(mutex, other.mutex);
+        std::lock_guard<std::mutex> lock1(mutex, std::adopt_lock);
+        std::lock_guard<std::mutex> lock2(other.mutex, std::adopt_lock);
+        vecBytes = other.vecBytes;
+        sig = other.sig;
+        fParsed = other.fParsed;
+    }
+    return *this;
+}
+
+void CBLSLazySignature::SetBytes(const std::vector<uint8_t>& _vecBytes)
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    vecBytes = _vecBytes;
+    sig.SetNull();
+    fParsed = false;
+}
+
+const CBLSSignature& CBLSLazySignature::Get() const
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    if (!fParsed) {
+        sig.SetBytes(vecBytes);
+        fParsed = true;
+    }
+    return sig;
+}
+
+bool CBLSLazySignature::IsValid() const
+{
+    return Get().IsValid();
+}
+
+std::vector<uint8_t> CBLSLazySignature::ToBytes() const
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    return vecBytes;
 }
 
 // ============================================================================
@@ -669,7 +1257,7 @@ CBLSSignature CBLSSignature::RecoverThresholdSignature(
 static std::mutex g_bls_mutex;
 static bool g_bls_initialized = false;
 
-void InitBLSSystem()
+void BLSInit()
 {
     std::lock_guard<std::mutex> lock(g_bls_mutex);
     if (!g_bls_initialized) {
@@ -678,13 +1266,13 @@ void InitBLSSystem()
     }
 }
 
-bool IsBLSInitialized()
+bool BLSIsInitialized()
 {
     std::lock_guard<std::mutex> lock(g_bls_mutex);
     return g_bls_initialized;
 }
 
-void ShutdownBLSSystem()
+void BLSCleanup()
 {
     std::lock_guard<std::mutex> lock(g_bls_mutex);
     g_bls_initialized = false;
@@ -120,6 +120,10 @@ public:
     // Sign a message
     CBLSSignature Sign(const uint256& hash) const;
     
+    // Derive the share for `id` from the master secret key polynomial
+    // msk (msk[0] is the group secret, t = msk.size() is the threshold)
+    bool SecretKeyShare(const std::vector<CBLSSecretKey>& msk, const CBLSId& id);
+    
     // Threshold signature contribution
     // In a t-of-n scheme, each participant signs with their share
     CBLSSignature SignWithShare(const uint256& hash, const CBLSId& id) const;
@@ -229,10 +233,22 @@ public:
                       const std::string& strMessagePrefix = "") const;
     
     // Batch verification (more efficient for multiple signatures)
+    // Uses a random linear combination of all entries and a single final
+    // exponentiation, so it costs roughly one pairing per entry plus one.
     static bool BatchVerify(
         const std::vector<CBLSSignature>& sigs,
         const std::vector<CBLSPublicKey>& pubKeys,
         const std::vector<uint256>& hashes);
+
+    // Same as above, but reports the indexes of failing entries in vecInvalid.
+    // With fFindInvalid set, a failing batch is bisected so that every invalid
+    // entry is found; otherwise only malformed entries are reported.
+    static bool BatchVerify(
+        const std::vector<CBLSSignature>& sigs,
+        const std::vector<CBLSPublicKey>& pubKeys,
+        const std::vector<uint256>& hashes,
+        std::vector<size_t>& vecInvalid,
+        bool fFindInvalid = true);
     
     // Aggregation
     static CBLSSignature AggregateSignatures(const std::vector<CBLSSignature>& sigs);
@@ -247,12 +263,21 @@ public:
         const std::vector<CBLSPublicKey>& pubKeys,
         const uint256& hash) const;
     
-    // Recover threshold signature from shares
+    // Recover threshold signature from shares by Lagrange interpolation.
+    // The first `threshold` shares are used; ids must be distinct.
     static CBLSSignature RecoverThresholdSignature(
         const std::vector<CBLSSignature>& sigShares,
         const std::vector<CBLSId>& ids,
         size_t threshold);
     
+    // Same as above, caching the Lagrange coefficients per (quorumHash, ids)
+    // so repeated recoveries from the same signer set skip the field math.
+    static CBLSSignature RecoverThresholdSignature(
+        const std::vector<CBLSSignature>& sigShares,
+        const std::vector<CBLSId>& ids,
+        size_t threshold,
+        const uint256& quorumHash);
+    
     // Comparison
     bool operator==(const CBLSSignature& other) const;
     bool operator!=(const CBLSSignature& other) const { return !(*this == other); }
@@ -280,6 +305,9 @@ public:
  * CBLSLazyPublicKey - Lazily parsed public key for performance
  * 
  * Useful when receiving many public keys but only verifying a few.
+ * Parsing goes through a process-wide cache of decompressed, subgroup
+ * checked points keyed by the compressed bytes, so keys seen before (e.g.
+ * operator keys of registered masternodes) skip decompression entirely.
  */
 class CBLSLazyPublicKey
 {
@@ -291,12 +319,29 @@ private:
 
 public:
     CBLSLazyPublicKey() = default;
+    CBLSLazyPublicKey(const CBLSLazyPublicKey& other);
+    CBLSLazyPublicKey& operator=(const CBLSLazyPublicKey& other);
     
     void SetBytes(const std::vector<uint8_t>& _vecBytes);
     const CBLSPublicKey& Get() const;
     bool IsValid() const;
     
     std::vector<uint8_t> ToBytes() const;
+    
+    ADD_SERIALIZE_METHODS;
+    
+    template <typename Stream, typename Operation>
+    inline void SerializationOp(Stream& s, Operation ser_action)
+    {
+        if (ser_action.ForRead()) {
+            std::vector<uint8_t> vecBytesIn;
+            READWRITE(vecBytesIn);
+            SetBytes(vecBytesIn);
+        } else {
+            std::vector<uint8_t> vecBytesOut = ToBytes();
+            READWRITE(vecBytesOut);
+        }
+    }
 };
 
 /**
@@ -312,14 +357,40 @@ private:
 
 public:
     CBLSLazySignature() = default;
+    CBLSLazySignature(const CBLSLazySignature& other);
+    CBLSLazySignature& operator=(const CBLSLazySignature& other);
     
     void SetBytes(const std::vector<uint8_t>& _vecBytes);
     const CBLSSignature& Get() const;
     bool IsValid() const;
     
     std::vector<uint8_t> ToBytes() const;
+    
+    ADD_SERIALIZE_METHODS;
+    
+    template <typename Stream, typename Operation>
+    inline void SerializationOp(Stream& s, Operation ser_action)
+    {
+        if (ser_action.ForRead()) {
+            std::vector<uint8_t> vecBytesIn;
+            READWRITE(vecBytesIn);
+            SetBytes(vecBytesIn);
+        } else {
+            std::vector<uint8_t> vecBytesOut = ToBytes();
+            READWRITE(vecBytesOut);
+        }
+    }
 };
 
+/**
+ * Keep the decompressed, subgroup-checked point of pk resident until it is
+ * unpinned as often as it was pinned, for keys that verify many signatures
+ * such as the public keys of active quorums. Returns false if pk is invalid.
+ */
+bool BLSPinPublicKey(const CBLSPublicKey& pk);
+void BLSUnpinPublicKey(const CBLSPublicKey& pk);
+size_t BLSPinnedPublicKeyCount();
+
 // Global initialization/cleanup
 void BLSInit();
 void BLSCleanup();
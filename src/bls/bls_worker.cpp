@@ -0,0 +1,148 @@
+// Copyright (c) 2026 The Mynta Core Developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include "bls/bls_worker.h"
+#include "util.h"
+
+#include <algorithm>
+#include <iterator>
+
+CBLSWorker blsWorker;
+
+CBLSWorker::~CBLSWorker()
+{
+    Stop();
+}
+
+void CBLSWorker::Start(int nThreads, unsigned int nBatchSizeIn)
+{
+    Stop();
+
+    std::lock_guard<std::mutex> lock(mutex);
+    fQuit = false;
+    nBatchSize = std::max(1U, nBatchSizeIn);
+    nThreads = std::max(0, std::min(nThreads, MAX_BLS_VERIFY_THREADS));
+    for (int i = 0; i < nThreads; i++) {
+        workers.emplace_back(&TraceThread<std::function<void()> >, "blsverify",
+                             std::function<void()>(std::bind(&CBLSWorker::ThreadWorker, this)));
+    }
+    if (nThreads > 0) {
+        LogPrintf("CBLSWorker::%s -- Started %d BLS verification threads (batch size %u)\n",
+                  __func__, nThreads, nBatchSize);
+    }
+}
+
+void CBLSWorker::Stop()
+{
+    std::vector<std::thread> vStopping;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        fQuit = true;
+        vStopping.swap(workers);
+    }
+    condWorker.notify_all();
+    for (auto& thread : vStopping) {
+        if (thread.joinable()) {
+            thread.join();
+        }
+    }
+
+    std::lock_guard<std::mutex> lock(mutex);
+    queue.clear();
+}
+
+bool CBLSWorker::IsRunning()
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    return !workers.empty() && !fQuit;
+}
+
+size_t CBLSWorker::GetQueueSize()
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    return queue.size();
+}
+
+void CBLSWorker::AsyncVerifySig(const CBLSSignature& sig, const CBLSPublicKey& pubKey,
+                                const uint256& hash, SigVerifyDoneCallback doneCallback)
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (!workers.empty() && !fQuit) {
+            queue.push_back(SigVerifyJob{sig, pubKey, hash, std::move(doneCallback)});
+            condWorker.notify_one();
+            return;
+        }
+    }
+
+    // No worker threads: verify on the caller's thread
+    doneCallback(sig.VerifyInsecure(pubKey, hash));
+}
+
+void CBLSWorker::ThreadWorker()
+{
+    std::vector<SigVerifyJob> vJobs;
+    while (true) {
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            condWorker.wait(lock, [this] { return fQuit || !queue.empty(); });
+            if (fQuit) {
+                return;
+            }
+            // Take everything up to the batch size; whatever arrived while the
+            // previous batch was being verified is grouped into this one.
+            size_t nNow = std::min(queue.size(), (size_t)nBatchSize);
+            vJobs.assign(std::make_move_iterator(queue.begin()),
+                         std::make_move_iterator(queue.begin() + nNow));
+            queue.erase(queue.begin(), queue.begin() + nNow);
+            if (!queue.empty()) {
+                condWorker.notify_one();
+            }
+        }
+
+        ProcessBatch(vJobs);
+        vJobs.clear();
+    }
+}
+
+void CBLSWorker::ProcessBatch(std::vector<SigVerifyJob>& vJobs)
+{
+    if (vJobs.empty()) {
+        return;
+    }
+
+    if (vJobs.size() == 1) {
+        auto& job = vJobs.front();
+        job.doneCallback(job.sig.VerifyInsecure(job.pubKey, job.hash));
+        return;
+    }
+
+    std::vector<CBLSSignature> sigs;
+    std::vector<CBLSPublicKey> pubKeys;
+    std::vector<uint256> hashes;
+    sigs.reserve(vJobs.size());
+    pubKeys.reserve(vJobs.size());
+    hashes.reserve(vJobs.size());
+    for (const auto& job : vJobs) {
+        sigs.push_back(job.sig);
+        pubKeys.push_back(job.pubKey);
+        hashes.push_back(job.hash);
+    }
+
+    std::vector<size_t> vecInvalid;
+    CBLSSignature::BatchVerify(sigs, pubKeys, hashes, vecInvalid, true);
+
+    std::vector<bool> vResults(vJobs.size(), true);
+    for (size_t i : vecInvalid) {
+        vResults[i] = false;
+    }
+    if (!vecInvalid.empty()) {
+        LogPrint(BCLog::LLMQ, "CBLSWorker::%s -- %u of %u signatures in batch failed verification\n",
+                 __func__, vecInvalid.size(), vJobs.size());
+    }
+
+    for (size_t i = 0; i < vJobs.size(); i++) {
+        vJobs[i].doneCallback(vResults[i]);
+    }
+}
@@ -0,0 +1,96 @@
+// Copyright (c) 2026 The Mynta Core Developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#ifndef MYNTA_BLS_BLS_WORKER_H
+#define MYNTA_BLS_BLS_WORKER_H
+
+#include "bls/bls.h"
+#include "uint256.h"
+
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/** Default number of BLS verification threads (0 = verify on the caller's thread) */
+static const int DEFAULT_BLS_VERIFY_THREADS = 1;
+/** Maximum number of BLS verification threads */
+static const int MAX_BLS_VERIFY_THREADS = 16;
+/** Maximum number of signatures verified in one multi-pairing batch */
+static const unsigned int DEFAULT_BLS_VERIFY_BATCH_SIZE = 64;
+
+/**
+ * CBLSWorker - Shared pool for asynchronous BLS signature verification
+ *
+ * Modeled on CCheckQueue: callers push verification jobs and return
+ * immediately, worker threads pop up to nBatchSize jobs at a time and check
+ * them with a single CBLSSignature::BatchVerify call. A failing batch is
+ * bisected so every job still gets an individual result, which is handed
+ * back through the job's callback on the worker thread.
+ *
+ * Callbacks run without any worker lock held and may take the caller's own
+ * critical sections. When the pool has no threads (not started, or started
+ * with 0 threads) jobs are verified synchronously on the calling thread.
+ */
+class CBLSWorker
+{
+public:
+    typedef std::function<void(bool)> SigVerifyDoneCallback;
+
+private:
+    struct SigVerifyJob {
+        CBLSSignature sig;
+        CBLSPublicKey pubKey;
+        uint256 hash;
+        SigVerifyDoneCallback doneCallback;
+    };
+
+    //! Mutex to protect the inner state
+    std::mutex mutex;
+
+    //! Worker threads block on this when out of work
+    std::condition_variable condWorker;
+
+    //! Pending verification jobs (FIFO, so callbacks complete in arrival order per batch)
+    std::deque<SigVerifyJob> queue;
+
+    std::vector<std::thread> workers;
+
+    //! Whether we're shutting down
+    bool fQuit{false};
+
+    //! The maximum number of jobs verified in one batch
+    unsigned int nBatchSize{DEFAULT_BLS_VERIFY_BATCH_SIZE};
+
+    void ThreadWorker();
+    static void ProcessBatch(std::vector<SigVerifyJob>& vJobs);
+
+public:
+    CBLSWorker() = default;
+    ~CBLSWorker();
+
+    CBLSWorker(const CBLSWorker&) = delete;
+    CBLSWorker& operator=(const CBLSWorker&) = delete;
+
+    //! Start nThreads worker threads; 0 keeps verification synchronous
+    void Start(int nThreads, unsigned int nBatchSizeIn = DEFAULT_BLS_VERIFY_BATCH_SIZE);
+
+    //! Stop all worker threads. Jobs still queued are dropped without calling back.
+    void Stop();
+
+    bool IsRunning();
+
+    //! Number of jobs waiting to be picked up by a worker
+    size_t GetQueueSize();
+
+    //! Verify sig against pubKey/hash and report the result through doneCallback
+    void AsyncVerifySig(const CBLSSignature& sig, const CBLSPublicKey& pubKey,
+                        const uint256& hash, SigVerifyDoneCallback doneCallback);
+};
+
+extern CBLSWorker blsWorker;
+
+#endif // MYNTA_BLS_BLS_WORKER_H
@@ -6,6 +6,21 @@
 
 #include "chain.h"
 
+CBlockIndexColdData CBlockIndex::GetColdData() const
+{
+    if (nColdPos == NO_COLD_DATA)
+        return CBlockIndexColdData();
+    return blockIndexColdStore.Get(nColdPos);
+}
+
+void CBlockIndex::SetColdData(const CBlockIndexColdData& data)
+{
+    if (nColdPos == NO_COLD_DATA)
+        nColdPos = blockIndexColdStore.Add(data);
+    else
+        blockIndexColdStore.Set(nColdPos, data);
+}
+
 /**
  * CChain implementation
  */
@@ -8,6 +8,7 @@
 #define MYNTA_CHAIN_H
 
 #include "arith_uint256.h"
+#include "blockindexcold.h"
 #include "primitives/block.h"
 #include "pow.h"
 #include "tinyformat.h"
@@ -208,16 +209,10 @@ public:
     //! Verification status of this block. See enum BlockStatus
     uint32_t nStatus;
 
-    //! block header
+    //! block header; the rest of it is in blockIndexColdStore, see GetColdData
     int32_t nVersion;
-    uint256 hashMerkleRoot;
     uint32_t nTime;
     uint32_t nBits;
-    uint32_t nNonce;
-
-    // KAWPOW
-    uint64_t nNonce64;
-    uint256 mix_hash;
 
     //! (memory only) Sequential id assigned to distinguish order in which blocks are received.
     int32_t nSequenceId;
@@ -225,6 +220,11 @@ public:
     //! (memory only) Maximum nTime in the chain up to and including this block.
     unsigned int nTimeMax;
 
+    //! (memory only) Position of the cold header fields in blockIndexColdStore, NO_COLD_DATA if they were never set
+    uint32_t nColdPos;
+
+    static const uint32_t NO_COLD_DATA = 0xffffffff;
+
     void SetNull()
     {
         phashBlock = nullptr;
@@ -241,15 +241,11 @@ public:
         nSequenceId = 0;
         nTimeMax = 0;
 
+        nColdPos = NO_COLD_DATA;
+
         nVersion       = 0;
-        hashMerkleRoot = uint256();
         nTime          = 0;
         nBits          = 0;
-        nNonce         = 0;
-
-        //KAWPOW
-        nNonce64       = 0;
-        mix_hash       = uint256();
     }
 
     CBlockIndex()
@@ -257,21 +253,17 @@ public:
         SetNull();
     }
 
+    //! The cold fields of block are left out; SetColdData stores them for an entry of mapBlockIndex
     explicit CBlockIndex(const CBlockHeader& block)
     {
         SetNull();
 
         nVersion       = block.nVersion;
-        hashMerkleRoot = block.hashMerkleRoot;
         nTime          = block.nTime;
         nBits          = block.nBits;
-        nNonce         = block.nNonce;
 
         //KAWPOW
         nHeight        = block.nHeight;
-        nNonce64       = block.nNonce64;
-        mix_hash       = block.mix_hash;
-
     }
 
     CDiskBlockPos GetBlockPos() const {
@@ -292,19 +284,26 @@ public:
         return ret;
     }
 
+    //! Header fields kept out of the entry, read back from blockIndexColdStore
+    CBlockIndexColdData GetColdData() const;
+    void SetColdData(const CBlockIndexColdData& data);
+
     CBlockHeader GetBlockHeader() const
     {
+        const CBlockIndexColdData cold = GetColdData();
         CBlockHeader block;
         block.nVersion       = nVersion;
         if (pprev)
             block.hashPrevBlock = pprev->GetBlockHash();
-        block.hashMerkleRoot = hashMerkleRoot;
+        block.hashMerkleRoot = cold.hashMerkleRoot;
         block.nTime          = nTime;
         block.nBits          = nBits;
-        block.nNonce         = nNonce;
+        block.nNonce         = cold.nNonce;
         block.nHeight        = nHeight;
-        block.nNonce64       = nNonce64;
-        block.mix_hash       = mix_hash;
+        block.nNonce64       = cold.nNonce64;
+        block.mix_hash       = cold.mix_hash;
+        if (phashBlock)
+            block.SetCachedHash(*phashBlock);
         return block;
     }
 
@@ -343,7 +342,7 @@ public:
     {
         return strprintf("CBlockIndex(pprev=%p, nHeight=%d, merkle=%s, hashBlock=%s)",
             pprev, nHeight,
-            hashMerkleRoot.ToString(),
+            GetColdData().hashMerkleRoot.ToString(),
             GetBlockHash().ToString());
     }
 
@@ -390,12 +389,13 @@ class CDiskBlockIndex : public CBlockIndex
 {
 public:
     uint256 hashPrev;
+    CBlockIndexColdData cold;
 
     CDiskBlockIndex() {
         hashPrev = uint256();
     }
 
-    explicit CDiskBlockIndex(const CBlockIndex* pindex) : CBlockIndex(*pindex) {
+    explicit CDiskBlockIndex(const CBlockIndex* pindex) : CBlockIndex(*pindex), cold(pindex->GetColdData()) {
         hashPrev = (pprev ? pprev->GetBlockHash() : uint256());
     }
 
@@ -420,15 +420,15 @@ public:
         // block header
         READWRITE(this->nVersion);
         READWRITE(hashPrev);
-        READWRITE(hashMerkleRoot);
+        READWRITE(cold.hashMerkleRoot);
         READWRITE(nTime);
         READWRITE(nBits);
         if (nTime < nKAWPOWActivationTime) {
-            READWRITE(nNonce);
+            READWRITE(cold.nNonce);
         } else {
             //KAWPOW
-            READWRITE(nNonce64);
-            READWRITE(mix_hash);
+            READWRITE(cold.nNonce64);
+            READWRITE(cold.mix_hash);
         }
 
     }
@@ -438,14 +438,14 @@ public:
         CBlockHeader block;
         block.nVersion        = nVersion;
         block.hashPrevBlock   = hashPrev;
-        block.hashMerkleRoot  = hashMerkleRoot;
+        block.hashMerkleRoot  = cold.hashMerkleRoot;
         block.nTime           = nTime;
         block.nBits           = nBits;
-        block.nNonce          = nNonce;
+        block.nNonce          = cold.nNonce;
 
         block.nHeight         = nHeight;
-        block.nNonce64        = nNonce64;
-        block.mix_hash        = mix_hash;
+        block.nNonce64        = cold.nNonce64;
+        block.mix_hash        = cold.mix_hash;
         return block.GetHash();
     }
 
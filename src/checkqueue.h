@@ -9,14 +9,35 @@
 #include "sync.h"
 
 #include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <functional>
+#include <memory>
 #include <vector>
+#include <stdint.h>
 
 #include <boost/thread/condition_variable.hpp>
 #include <boost/thread/mutex.hpp>
+#include <boost/thread/thread.hpp>
+
+/** Maximum number of per-worker deques in a CCheckQueue (the master's included) */
+static const unsigned int MAX_CHECKQUEUE_DEQUES = 64;
 
 template <typename T>
 class CCheckQueueControl;
 
+/** Work done by the threads using one deque of a CCheckQueue, since it was created */
+struct CCheckQueueWorkerStats {
+    //! Checks executed
+    uint64_t nChecks;
+    //! Batches taken, including the stolen ones
+    uint64_t nBatches;
+    //! Batches stolen from another deque
+    uint64_t nSteals;
+    //! Time spent executing checks
+    uint64_t nBusyMicros;
+};
+
 /** 
  * Queue for verifications that have to be performed.
   * The verifications are represented by a type T, which must provide an
@@ -26,12 +47,44 @@ class CCheckQueueControl;
   * onto the queue, where they are processed by N-1 worker threads. When
   * the master is done adding work, it temporarily joins the worker pool
   * as an N'th worker, until all jobs are done.
+  *
+  * Every worker owns a deque, and Add spreads each batch over them round
+  * robin. A worker takes work from the back of its own deque and, when that
+  * is empty, steals half of another worker's deque from the front, so the
+  * only locks taken while checking are the small per-deque ones. The shared
+  * mutex is only used to put idle threads to sleep and wake them up again.
   */
 template <typename T>
 class CCheckQueue
 {
 private:
-    //! Mutex to protect the inner state
+    //! Checks of one worker: the owner pops from the back, thieves take from nFront
+    struct WorkerDeque {
+        boost::mutex mutex;
+        std::vector<T> vChecks;
+        size_t nFront{0};
+        //! Number of checks queued, readable without the lock
+        std::atomic<unsigned int> nSize{0};
+
+        std::atomic<uint64_t> nChecks{0};
+        std::atomic<uint64_t> nBatches{0};
+        std::atomic<uint64_t> nSteals{0};
+        std::atomic<uint64_t> nBusyMicros{0};
+    };
+
+    //! One deque per worker; the master uses the first
+    std::vector<std::unique_ptr<WorkerDeque>> vDeques;
+
+    //! Number of deques in use (the master's plus one per registered worker, up to MAX_CHECKQUEUE_DEQUES)
+    std::atomic<unsigned int> nDeques;
+
+    //! Number of worker threads that ever registered, used to assign them a deque
+    std::atomic<unsigned int> nWorkers;
+
+    //! Deque the next Add starts at
+    std::atomic<unsigned int> nNextDeque;
+
+    //! Mutex that idle threads sleep on
     boost::mutex mutex;
 
     //! Worker threads block on this when out of work
@@ -40,90 +93,149 @@ private:
     //! Master thread blocks on this when out of work
     boost::condition_variable condMaster;
 
-    //! The queue of elements to be processed.
-    //! As the order of booleans doesn't matter, it is used as a LIFO (stack)
-    std::vector<T> queue;
-
     //! The number of workers (including the master) that are idle.
-    int nIdle;
-
-    //! The total number of workers (including the master).
-    int nTotal;
+    std::atomic<int> nIdle;
 
     //! The temporary evaluation result.
-    bool fAllOk;
+    std::atomic<bool> fAllOk;
 
     /**
      * Number of verifications that haven't completed yet.
      * This includes elements that are no longer queued, but still in the
      * worker's own batches.
      */
-    unsigned int nTodo;
+    std::atomic<unsigned int> nTodo;
 
-    //! Whether we're shutting down.
-    bool fQuit;
+    //! Number of verifications still sitting in one of the deques
+    std::atomic<unsigned int> nQueued;
 
     //! The maximum number of elements to be processed in one batch
     unsigned int nBatchSize;
 
+    /**
+     * Move up to nMax checks from deque nIndex into vChecks, from the back
+     * of the worker's own deque or the front of someone else's.
+     */
+    unsigned int Take(unsigned int nIndex, bool fSteal, unsigned int nMax, std::vector<T>& vChecks)
+    {
+        WorkerDeque& wd = *vDeques[nIndex];
+        // Don't lock deques that have nothing to take
+        if (wd.nSize.load(std::memory_order_relaxed) == 0)
+            return 0;
+        boost::unique_lock<boost::mutex> lock(wd.mutex);
+        unsigned int nSize = wd.vChecks.size() - wd.nFront;
+        if (nSize == 0)
+            return 0;
+        // A thief takes half of what is there, so the owner keeps the rest
+        unsigned int nNow = std::min(nMax, fSteal ? (nSize + 1) / 2 : nSize);
+        vChecks.resize(nNow);
+        for (unsigned int i = 0; i < nNow; i++) {
+            if (fSteal) {
+                vChecks[i].swap(wd.vChecks[wd.nFront]);
+                // Destroy what was swapped in right away, like popping would
+                T().swap(wd.vChecks[wd.nFront++]);
+            } else {
+                vChecks[i].swap(wd.vChecks.back());
+                wd.vChecks.pop_back();
+            }
+        }
+        if (wd.nFront == wd.vChecks.size()) {
+            wd.vChecks.clear();
+            wd.nFront = 0;
+        }
+        wd.nSize.store(nSize - nNow, std::memory_order_relaxed);
+        nQueued -= nNow;
+        return nNow;
+    }
+
+    /** Fill vChecks from the own deque, or steal from the others. Returns the number of checks taken. */
+    unsigned int Grab(unsigned int nSelf, std::vector<T>& vChecks)
+    {
+        unsigned int nCount = nDeques.load();
+        // Decide how many work units to process now.
+        // * Do not try to do everything at once, but aim for increasingly smaller batches so
+        //   all workers finish approximately simultaneously.
+        // * Try to account for idle jobs which will instantly start helping.
+        // * Don't do batches smaller than 1 (duh), or larger than nBatchSize.
+        unsigned int nMax = std::max(1U, std::min(nBatchSize, nQueued.load() / (nCount + nIdle.load() + 1)));
+        unsigned int nNow = Take(nSelf, false, nMax, vChecks);
+        for (unsigned int i = 1; nNow == 0 && i < nCount; i++) {
+            nNow = Take((nSelf + i) % nCount, true, nMax, vChecks);
+            if (nNow)
+                vDeques[nSelf]->nSteals.fetch_add(1, std::memory_order_relaxed);
+        }
+        return nNow;
+    }
+
+    /** Wake up sleeping threads after new work was queued */
+    void WakeUp(size_t nAdded)
+    {
+        if (nIdle.load() == 0)
+            return;
+        {
+            // A thread that saw no work is waiting by the time we have the lock
+            boost::unique_lock<boost::mutex> lock(mutex);
+        }
+        if (nAdded == 1)
+            condWorker.notify_one();
+        else
+            condWorker.notify_all();
+    }
+
     /** Internal function that does bulk of the verification work. */
     bool Loop(bool fMaster = false)
     {
         boost::condition_variable& cond = fMaster ? condMaster : condWorker;
+        unsigned int nSelf = 0;
+        if (!fMaster) {
+            nSelf = 1 + nWorkers++ % (MAX_CHECKQUEUE_DEQUES - 1);
+            unsigned int nCount = nDeques.load();
+            while (nCount < nSelf + 1 && !nDeques.compare_exchange_weak(nCount, nSelf + 1)) {}
+        }
         std::vector<T> vChecks;
         vChecks.reserve(nBatchSize);
-        unsigned int nNow = 0;
-        bool fOk = true;
         do {
-            {
+            unsigned int nNow = Grab(nSelf, vChecks);
+            if (nNow == 0 && nTodo.load() != 0) {
+                // Work is still being added or finished; give it a moment before sleeping
+                boost::this_thread::yield();
+                nNow = Grab(nSelf, vChecks);
+            }
+            if (nNow == 0) {
                 boost::unique_lock<boost::mutex> lock(mutex);
-                // first do the clean-up of the previous loop run (allowing us to do it in the same critsect)
-                if (nNow) {
-                    fAllOk &= fOk;
-                    nTodo -= nNow;
-                    if (nTodo == 0 && !fMaster)
-                        // We processed the last element; inform the master it can exit and return the result
-                        condMaster.notify_one();
-                } else {
-                    // first iteration
-                    nTotal++;
-                }
-                // logically, the do loop starts here
-                while (queue.empty()) {
-                    if ((fMaster || fQuit) && nTodo == 0) {
-                        nTotal--;
-                        bool fRet = fAllOk;
-                        // reset the status for new work later
-                        if (fMaster)
-                            fAllOk = true;
-                        // return the current status
-                        return fRet;
-                    }
-                    nIdle++;
-                    cond.wait(lock); // wait
-                    nIdle--;
+                if (fMaster && nTodo.load() == 0) {
+                    // reset the status for new work later
+                    return fAllOk.exchange(true);
                 }
-                // Decide how many work units to process now.
-                // * Do not try to do everything at once, but aim for increasingly smaller batches so
-                //   all workers finish approximately simultaneously.
-                // * Try to account for idle jobs which will instantly start helping.
-                // * Don't do batches smaller than 1 (duh), or larger than nBatchSize.
-                nNow = std::max(1U, std::min(nBatchSize, (unsigned int)queue.size() / (nTotal + nIdle + 1)));
-                vChecks.resize(nNow);
-                for (unsigned int i = 0; i < nNow; i++) {
-                    // We want the lock on the mutex to be as short as possible, so swap jobs from the global
-                    // queue to the local batch vector instead of copying.
-                    vChecks[i].swap(queue.back());
-                    queue.pop_back();
-                }
-                // Check whether we need to do work at all
-                fOk = fAllOk;
+                // Adders only wake sleepers they can see, so register as idle
+                // before the last look for work.
+                nIdle++;
+                while (nQueued.load() == 0 && !(fMaster && nTodo.load() == 0))
+                    cond.wait(lock);
+                nIdle--;
+                continue;
             }
+            // Check whether we need to do work at all
+            bool fOk = fAllOk.load();
             // execute work
+            auto start = std::chrono::steady_clock::now();
             for (T& check : vChecks)
                 if (fOk)
                     fOk = check();
+            WorkerDeque& wd = *vDeques[nSelf];
+            wd.nChecks.fetch_add(nNow, std::memory_order_relaxed);
+            wd.nBatches.fetch_add(1, std::memory_order_relaxed);
+            wd.nBusyMicros.fetch_add(std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start).count(), std::memory_order_relaxed);
+            // Clean up before the work is counted as done, so the master
+            // never returns while checks are still being destroyed.
             vChecks.clear();
+            if (!fOk)
+                fAllOk = false;
+            if (nTodo.fetch_sub(nNow) == nNow && !fMaster) {
+                // We processed the last element; inform the master it can exit and return the result
+                boost::unique_lock<boost::mutex> lock(mutex);
+                condMaster.notify_one();
+            }
         } while (true);
     }
 
@@ -132,7 +244,13 @@ public:
     boost::mutex ControlMutex;
 
     //! Create a new check queue
-    explicit CCheckQueue(unsigned int nBatchSizeIn) : nIdle(0), nTotal(0), fAllOk(true), nTodo(0), fQuit(false), nBatchSize(nBatchSizeIn) {}
+    explicit CCheckQueue(unsigned int nBatchSizeIn) :
+        nDeques(1), nWorkers(0), nNextDeque(0), nIdle(0), fAllOk(true), nTodo(0), nQueued(0), nBatchSize(nBatchSizeIn)
+    {
+        vDeques.reserve(MAX_CHECKQUEUE_DEQUES);
+        for (unsigned int i = 0; i < MAX_CHECKQUEUE_DEQUES; i++)
+            vDeques.emplace_back(new WorkerDeque());
+    }
 
     //! Worker thread
     void Thread()
@@ -146,19 +264,43 @@ public:
         return Loop(true);
     }
 
+    /**
+     * Counters for each deque in use. The first belongs to the master, and
+     * workers past MAX_CHECKQUEUE_DEQUES share theirs with another worker.
+     */
+    std::vector<CCheckQueueWorkerStats> GetWorkerStats() const
+    {
+        std::vector<CCheckQueueWorkerStats> vStats;
+        unsigned int nCount = nDeques.load();
+        for (unsigned int i = 0; i < nCount; i++) {
+            const WorkerDeque& wd = *vDeques[i];
+            vStats.push_back({wd.nChecks.load(std::memory_order_relaxed), wd.nBatches.load(std::memory_order_relaxed),
+                              wd.nSteals.load(std::memory_order_relaxed), wd.nBusyMicros.load(std::memory_order_relaxed)});
+        }
+        return vStats;
+    }
+
     //! Add a batch of checks to the queue
     void Add(std::vector<T>& vChecks)
     {
-        boost::unique_lock<boost::mutex> lock(mutex);
-        for (T& check : vChecks) {
-            queue.push_back(T());
-            check.swap(queue.back());
-        }
+        if (vChecks.empty())
+            return;
+        // Count the work before it becomes visible, so nTodo can't reach zero early
         nTodo += vChecks.size();
-        if (vChecks.size() == 1)
-            condWorker.notify_one();
-        else if (vChecks.size() > 1)
-            condWorker.notify_all();
+        unsigned int nCount = nDeques.load();
+        size_t nChunk = (vChecks.size() + nCount - 1) / nCount;
+        for (size_t nPos = 0; nPos < vChecks.size(); nPos += nChunk) {
+            size_t nEnd = std::min(vChecks.size(), nPos + nChunk);
+            WorkerDeque& wd = *vDeques[nNextDeque++ % nCount];
+            boost::unique_lock<boost::mutex> lock(wd.mutex);
+            for (size_t i = nPos; i < nEnd; i++) {
+                wd.vChecks.emplace_back();
+                vChecks[i].swap(wd.vChecks.back());
+            }
+            wd.nSize.store(wd.vChecks.size() - wd.nFront, std::memory_order_relaxed);
+            nQueued += nEnd - nPos;
+        }
+        WakeUp(vChecks.size());
     }
 
     ~CCheckQueue()
@@ -215,4 +357,30 @@ public:
     }
 };
 
+/**
+ * A check that runs any callable, for work that has no check type of its
+ * own. Subsystems that verify in bulk (BLS batches, the asset pre-pass) can
+ * queue these on a CCheckQueue<CFunctionCheck> and get the same work
+ * stealing and batching as script checks.
+ */
+class CFunctionCheck
+{
+private:
+    std::function<bool()> func;
+
+public:
+    CFunctionCheck() {}
+    explicit CFunctionCheck(std::function<bool()> funcIn) : func(std::move(funcIn)) {}
+
+    bool operator()()
+    {
+        return func ? func() : true;
+    }
+
+    void swap(CFunctionCheck& check)
+    {
+        func.swap(check.func);
+    }
+};
+
 #endif // MYNTA_CHECKQUEUE_H
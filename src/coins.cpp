@@ -29,6 +29,15 @@ bool CCoinsView::HaveCoin(const COutPoint &outpoint) const
     return GetCoin(outpoint, coin);
 }
 
+void CCoinsView::GetCoins(const std::vector<COutPoint> &vOutpoints, std::vector<std::pair<COutPoint, Coin>> &vCoins) const
+{
+    Coin coin;
+    for (const COutPoint& outpoint : vOutpoints) {
+        if (GetCoin(outpoint, coin))
+            vCoins.emplace_back(outpoint, std::move(coin));
+    }
+}
+
 CCoinsViewBacked::CCoinsViewBacked(CCoinsView *viewIn) : base(viewIn) { }
 bool CCoinsViewBacked::GetCoin(const COutPoint &outpoint, Coin &coin) const { return base->GetCoin(outpoint, coin); }
 bool CCoinsViewBacked::HaveCoin(const COutPoint &outpoint) const { return base->HaveCoin(outpoint); }
@@ -60,10 +69,55 @@ CCoinsMap::iterator CCoinsViewCache::FetchCoin(const COutPoint &outpoint) const
         // version as fresh.
         ret->second.flags = CCoinsCacheEntry::FRESH;
     }
-    cachedCoinsUsage += ret->second.coin.DynamicMemoryUsage();
+    cachedCoinsUsage += ret->second.DynamicMemoryUsage();
     return ret;
 }
 
+void CCoinsViewCache::FetchCoins(const std::vector<COutPoint> &vOutpoints, std::vector<std::pair<COutPoint, Coin>> *pCoins) const {
+    std::vector<COutPoint> vMissing;
+    for (const COutPoint& outpoint : vOutpoints) {
+        CCoinsMap::const_iterator it = cacheCoins.find(outpoint);
+        if (it == cacheCoins.end())
+            vMissing.push_back(outpoint);
+        else if (pCoins && !it->second.coin.IsSpent())
+            pCoins->emplace_back(outpoint, it->second.coin);
+    }
+    if (vMissing.empty())
+        return;
+    std::vector<std::pair<COutPoint, Coin>> vFetched;
+    base->GetCoins(vMissing, vFetched);
+    for (std::pair<COutPoint, Coin>& fetched : vFetched) {
+        auto ret = cacheCoins.emplace(std::piecewise_construct, std::forward_as_tuple(fetched.first), std::forward_as_tuple());
+        if (!ret.second)
+            continue;
+        ret.first->second.coin = pCoins ? fetched.second : std::move(fetched.second);
+        cachedCoinsUsage += ret.first->second.DynamicMemoryUsage();
+        if (pCoins)
+            pCoins->push_back(std::move(fetched));
+    }
+}
+
+void CCoinsViewCache::GetCoins(const std::vector<COutPoint> &vOutpoints, std::vector<std::pair<COutPoint, Coin>> &vCoins) const {
+    FetchCoins(vOutpoints, &vCoins);
+}
+
+void CCoinsViewCache::PrefetchCoins(const std::vector<COutPoint> &vOutpoints) const {
+    FetchCoins(vOutpoints, nullptr);
+}
+
+void CCoinsViewCache::AddFetchedCoins(std::vector<std::pair<COutPoint, CCoinsCacheEntry>> &vEntries) {
+    for (std::pair<COutPoint, CCoinsCacheEntry>& fetched : vEntries) {
+        if (fetched.second.coin.IsSpent())
+            continue;
+        auto ret = cacheCoins.emplace(std::piecewise_construct, std::forward_as_tuple(fetched.first), std::forward_as_tuple());
+        if (!ret.second)
+            continue;
+        ret.first->second.coin = std::move(fetched.second.coin);
+        ret.first->second.assetData = std::move(fetched.second.assetData);
+        cachedCoinsUsage += ret.first->second.DynamicMemoryUsage();
+    }
+}
+
 bool CCoinsViewCache::GetCoin(const COutPoint &outpoint, Coin &coin) const {
     CCoinsMap::const_iterator it = FetchCoin(outpoint);
     if (it != cacheCoins.end()) {
@@ -81,7 +135,7 @@ void CCoinsViewCache::AddCoin(const COutPoint &outpoint, Coin&& coin, bool possi
     std::tie(it, inserted) = cacheCoins.emplace(std::piecewise_construct, std::forward_as_tuple(outpoint), std::tuple<>());
     bool fresh = false;
     if (!inserted) {
-        cachedCoinsUsage -= it->second.coin.DynamicMemoryUsage();
+        cachedCoinsUsage -= it->second.DynamicMemoryUsage();
     }
     if (!possible_overwrite) {
         if (!it->second.coin.IsSpent()) {
@@ -90,11 +144,12 @@ void CCoinsViewCache::AddCoin(const COutPoint &outpoint, Coin&& coin, bool possi
         fresh = !(it->second.flags & CCoinsCacheEntry::DIRTY);
     }
     it->second.coin = std::move(coin);
+    it->second.assetData.reset();
     it->second.flags |= CCoinsCacheEntry::DIRTY | (fresh ? CCoinsCacheEntry::FRESH : 0);
-    cachedCoinsUsage += it->second.coin.DynamicMemoryUsage();
+    cachedCoinsUsage += it->second.DynamicMemoryUsage();
 }
 
-void AddCoins(CCoinsViewCache& cache, const CTransaction &tx, int nHeight, uint256 blockHash, bool check, CAssetsCache* assetsCache, std::pair<std::string, CBlockAssetUndo>* undoAssetData) {
+void AddCoins(CCoinsViewCache& cache, const CTransaction &tx, int nHeight, uint256 blockHash, bool check, CAssetsCache* assetsCache, std::pair<std::string, CBlockAssetUndo>* undoAssetData, const std::vector<CAssetOutputRecord>* pAssetOutputs) {
     bool fCoinbase = tx.IsCoinBase();
     const uint256& txid = tx.GetHash();
 
@@ -111,12 +166,12 @@ void AddCoins(CCoinsViewCache& cache, const CTransaction &tx, int nHeight, uint2
                 OwnerFromTransaction(tx, ownerName, ownerAddress);
 
                 // Add the new asset to cache
-                if (!assetsCache->AddNewAsset(asset, strAddress, nHeight, blockHash))
+                if (!assetsCache->AddNewAsset(asset, CAddressKey::FromString(strAddress), nHeight, blockHash))
                     error("%s : Failed at adding a new asset to our cache. asset: %s", __func__,
                           asset.strName);
 
                 // Add the owner asset to cache
-                if (!assetsCache->AddOwnerAsset(ownerName, ownerAddress))
+                if (!assetsCache->AddOwnerAsset(ownerName, CAddressKey::FromString(ownerAddress)))
                     error("%s : Failed at adding a new asset to our cache. asset: %s", __func__,
                           asset.strName);
 
@@ -133,7 +188,7 @@ void AddCoins(CCoinsViewCache& cache, const CTransaction &tx, int nHeight, uint2
                     error("%s: Failed to get the original asset that is getting reissued. Asset Name : %s",
                           __func__, reissue.strName);
 
-                if (!assetsCache->AddReissueAsset(reissue, strAddress, COutPoint(txid, reissueIndex)))
+                if (!assetsCache->AddReissueAsset(reissue, CAddressKey::FromString(strAddress), COutPoint(txid, reissueIndex)))
                     error("%s: Failed to reissue an asset. Asset Name : %s", __func__, reissue.strName);
 
                 // Check to see if we are reissuing a restricted asset
@@ -191,13 +246,13 @@ void AddCoins(CCoinsViewCache& cache, const CTransaction &tx, int nHeight, uint2
                     auto out = tx.vout[n];
 
                     CNewAsset asset;
-                    std::string strAddress;
+                    CAddressKey address;
 
                     if (IsScriptNewUniqueAsset(out.scriptPubKey)) {
-                        AssetFromScript(out.scriptPubKey, asset, strAddress);
+                        AssetFromScript(out.scriptPubKey, asset, address);
 
                         // Add the new asset to cache
-                        if (!assetsCache->AddNewAsset(asset, strAddress, nHeight, blockHash))
+                        if (!assetsCache->AddNewAsset(asset, address, nHeight, blockHash))
                             error("%s : Failed at adding a new asset to our cache. asset: %s", __func__,
                                   asset.strName);
                     }
@@ -208,7 +263,7 @@ void AddCoins(CCoinsViewCache& cache, const CTransaction &tx, int nHeight, uint2
                 MsgChannelAssetFromTransaction(tx, asset, strAddress);
 
                 // Add the new asset to cache
-                if (!assetsCache->AddNewAsset(asset, strAddress, nHeight, blockHash))
+                if (!assetsCache->AddNewAsset(asset, CAddressKey::FromString(strAddress), nHeight, blockHash))
                     error("%s : Failed at adding a new asset to our cache. asset: %s", __func__,
                           asset.strName);
             } else if (tx.IsNewQualifierAsset()) {
@@ -217,7 +272,7 @@ void AddCoins(CCoinsViewCache& cache, const CTransaction &tx, int nHeight, uint2
                 QualifierAssetFromTransaction(tx, asset, strAddress);
 
                 // Add the new asset to cache
-                if (!assetsCache->AddNewAsset(asset, strAddress, nHeight, blockHash))
+                if (!assetsCache->AddNewAsset(asset, CAddressKey::FromString(strAddress), nHeight, blockHash))
                     error("%s : Failed at adding a new qualifier asset to our cache. asset: %s", __func__,
                           asset.strName);
             }  else if (tx.IsNewRestrictedAsset()) {
@@ -226,7 +281,7 @@ void AddCoins(CCoinsViewCache& cache, const CTransaction &tx, int nHeight, uint2
                 RestrictedAssetFromTransaction(tx, asset, strAddress);
 
                 // Add the new asset to cache
-                if (!assetsCache->AddNewAsset(asset, strAddress, nHeight, blockHash))
+                if (!assetsCache->AddNewAsset(asset, CAddressKey::FromString(strAddress), nHeight, blockHash))
                     error("%s : Failed at adding a new restricted asset to our cache. asset: %s", __func__,
                           asset.strName);
 
@@ -263,17 +318,39 @@ void AddCoins(CCoinsViewCache& cache, const CTransaction &tx, int nHeight, uint2
         if (AreAssetsDeployed()) {
             if (assetsCache) {
                 CAssetOutputEntry assetData;
-                if (GetAssetData(tx.vout[i].scriptPubKey, assetData)) {
+                bool fHaveAssetData;
+                const CAssetOutputRecord* pRecord = pAssetOutputs ? &(*pAssetOutputs)[i] : nullptr;
+                if (!pRecord) {
+                    fHaveAssetData = GetAssetData(tx.vout[i].scriptPubKey, assetData);
+                } else if (!pRecord->fIsAsset) {
+                    fHaveAssetData = false;
+                } else if (pRecord->nType == TX_TRANSFER_ASSET) {
+                    // Reuse the transfer ConnectBlock already deserialized
+                    fHaveAssetData = pRecord->fDecoded;
+                    if (fHaveAssetData) {
+                        assetData.type = TX_TRANSFER_ASSET;
+                        assetData.nAmount = pRecord->transfer.nAmount;
+                        assetData.destination = pRecord->address.GetDestination();
+                        assetData.assetName = pRecord->transfer.strName;
+                        assetData.message = pRecord->transfer.message;
+                        assetData.expireTime = pRecord->transfer.nExpireTime;
+                    } else {
+                        LogPrintf("Failed to get transfer from script\n");
+                    }
+                } else {
+                    fHaveAssetData = GetAssetData(tx.vout[i].scriptPubKey, assetData);
+                }
+                if (fHaveAssetData) {
+                    assetsCache->UpdateAssetSupply(assetData.assetName, CAddressKey::FromDestination(assetData.destination), assetData.nAmount, 1);
 
                     // If this is a transfer asset, and the amount is greater than zero
                     // We want to make sure it is added to the asset addresses database if (fAssetIndex == true)
                     if (assetData.type == TX_TRANSFER_ASSET && assetData.nAmount > 0) {
                         // Create the objects needed from the assetData
                         CAssetTransfer assetTransfer(assetData.assetName, assetData.nAmount, assetData.message, assetData.expireTime);
-                        std::string address = EncodeDestination(assetData.destination);
 
                         // Add the transfer asset data to the asset cache
-                        if (!assetsCache->AddTransferAsset(assetTransfer, address, COutPoint(txid, i), tx.vout[i]))
+                        if (!assetsCache->AddTransferAsset(assetTransfer, CAddressKey::FromDestination(assetData.destination), COutPoint(txid, i), tx.vout[i]))
                             LogPrintf("%s : ERROR - Failed to add transfer asset CTxOut: %s\n", __func__,
                                       tx.vout[i].ToString());
 
@@ -282,6 +359,7 @@ void AddCoins(CCoinsViewCache& cache, const CTransaction &tx, int nHeight, uint2
                         if (fMessaging && pMessageSubscribedChannelsCache) {
                             LOCK(cs_messaging);
                             if (vpwallets.size() && vpwallets[0]->IsMine(tx.vout[i]) == ISMINE_SPENDABLE) {
+                                std::string address = EncodeDestination(assetData.destination);
                                 AssetType aType;
                                 IsAssetNameValid(assetTransfer.strName, aType);
 
@@ -361,12 +439,15 @@ bool CCoinsViewCache::SpendCoin(const COutPoint &outpoint, Coin* moveout, CAsset
     CCoinsMap::iterator it = FetchCoin(outpoint);
     if (it == cacheCoins.end())
         return false;
-    cachedCoinsUsage -= it->second.coin.DynamicMemoryUsage();
 
     /** RVN START */
-    Coin tempCoin = it->second.coin;
+    // Taken before the entry goes, decoding the script only if no earlier check did
+    std::shared_ptr<const CCoinAssetData> assetData;
+    if (AreAssetsDeployed() && assetsCache)
+        assetData = DecodeCoinAsset(it->second);
     /** RVN END */
 
+    cachedCoinsUsage -= it->second.DynamicMemoryUsage();
     if (moveout) {
         *moveout = std::move(it->second.coin);
     }
@@ -375,14 +456,13 @@ bool CCoinsViewCache::SpendCoin(const COutPoint &outpoint, Coin* moveout, CAsset
     } else {
         it->second.flags |= CCoinsCacheEntry::DIRTY;
         it->second.coin.Clear();
+        it->second.assetData.reset();
     }
 
     /** RVN START */
-    if (AreAssetsDeployed()) {
-        if (assetsCache) {
-            if (!assetsCache->TrySpendCoin(outpoint, tempCoin.out)) {
-                return error("%s : Failed to try and spend the asset. COutPoint : %s", __func__, outpoint.ToString());
-            }
+    if (assetData) {
+        if (!assetsCache->TrySpendCoin(outpoint, *assetData)) {
+            return error("%s : Failed to try and spend the asset. COutPoint : %s", __func__, outpoint.ToString());
         }
     }
     /** RVN END */
@@ -401,6 +481,25 @@ const Coin& CCoinsViewCache::AccessCoin(const COutPoint &outpoint) const {
     }
 }
 
+const std::shared_ptr<const CCoinAssetData>& CCoinsViewCache::DecodeCoinAsset(CCoinsCacheEntry& entry) const {
+    if (!entry.assetData && !entry.coin.IsSpent() && entry.coin.IsAsset()) {
+        auto data = std::make_shared<CCoinAssetData>();
+        DecodeCoinAssetData(entry.coin.out.scriptPubKey, *data);
+        const size_t nUsageBefore = entry.DynamicMemoryUsage();
+        entry.assetData = std::move(data);
+        cachedCoinsUsage += entry.DynamicMemoryUsage() - nUsageBefore;
+    }
+    return entry.assetData;
+}
+
+std::shared_ptr<const CCoinAssetData> CCoinsViewCache::AccessCoinAssetData(const COutPoint &outpoint) const {
+    CCoinsMap::iterator it = FetchCoin(outpoint);
+    if (it == cacheCoins.end()) {
+        return nullptr;
+    }
+    return DecodeCoinAsset(it->second);
+}
+
 bool CCoinsViewCache::HaveCoin(const COutPoint &outpoint) const {
     CCoinsMap::const_iterator it = FetchCoin(outpoint);
     return (it != cacheCoins.end() && !it->second.coin.IsSpent());
@@ -433,7 +532,8 @@ bool CCoinsViewCache::BatchWrite(CCoinsMap &mapCoins, const uint256 &hashBlockIn
                     // and move the data up and mark it as dirty
                     CCoinsCacheEntry& entry = cacheCoins[it->first];
                     entry.coin = std::move(it->second.coin);
-                    cachedCoinsUsage += entry.coin.DynamicMemoryUsage();
+                    entry.assetData = std::move(it->second.assetData);
+                    cachedCoinsUsage += entry.DynamicMemoryUsage();
                     entry.flags = CCoinsCacheEntry::DIRTY;
                     // We can mark it FRESH in the parent if it was FRESH in the child
                     // Otherwise it might have just been flushed from the parent's cache
@@ -454,13 +554,14 @@ bool CCoinsViewCache::BatchWrite(CCoinsMap &mapCoins, const uint256 &hashBlockIn
                     // The grandparent does not have an entry, and the child is
                     // modified and being pruned. This means we can just delete
                     // it from the parent.
-                    cachedCoinsUsage -= itUs->second.coin.DynamicMemoryUsage();
+                    cachedCoinsUsage -= itUs->second.DynamicMemoryUsage();
                     cacheCoins.erase(itUs);
                 } else {
                     // A normal modification.
-                    cachedCoinsUsage -= itUs->second.coin.DynamicMemoryUsage();
+                    cachedCoinsUsage -= itUs->second.DynamicMemoryUsage();
                     itUs->second.coin = std::move(it->second.coin);
-                    cachedCoinsUsage += itUs->second.coin.DynamicMemoryUsage();
+                    itUs->second.assetData = std::move(it->second.assetData);
+                    cachedCoinsUsage += itUs->second.DynamicMemoryUsage();
                     itUs->second.flags |= CCoinsCacheEntry::DIRTY;
                     // NOTE: It is possible the child has a FRESH flag here in
                     // the event the entry we found in the parent is pruned. But
@@ -478,9 +579,11 @@ bool CCoinsViewCache::BatchWrite(CCoinsMap &mapCoins, const uint256 &hashBlockIn
 }
 
 bool CCoinsViewCache::Flush() {
+    nFlushSequence.fetch_add(1, std::memory_order_acq_rel);
     bool fOk = base->BatchWrite(cacheCoins, hashBlock);
     cacheCoins.clear();
     cachedCoinsUsage = 0;
+    nFlushSequence.fetch_add(1, std::memory_order_release);
     return fOk;
 }
 
@@ -488,7 +591,7 @@ void CCoinsViewCache::Uncache(const COutPoint& hash)
 {
     CCoinsMap::iterator it = cacheCoins.find(hash);
     if (it != cacheCoins.end() && it->second.flags == 0) {
-        cachedCoinsUsage -= it->second.coin.DynamicMemoryUsage();
+        cachedCoinsUsage -= it->second.DynamicMemoryUsage();
         cacheCoins.erase(it);
     }
 }
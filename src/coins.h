@@ -10,6 +10,7 @@
 #include "primitives/transaction.h"
 #include "compressor.h"
 #include "core_memusage.h"
+#include "flatmap.h"
 #include "hash.h"
 #include "memusage.h"
 #include "serialize.h"
@@ -122,11 +123,21 @@ struct CCoinsCacheEntry
          */
     };
 
+    //! The coin's decoded asset, set on first use for an asset coin and dropped with the coin
+    std::shared_ptr<const CCoinAssetData> assetData;
+
     CCoinsCacheEntry() : flags(0) {}
     explicit CCoinsCacheEntry(Coin&& coin_) : coin(std::move(coin_)), flags(0) {}
+
+    size_t DynamicMemoryUsage() const {
+        size_t nUsage = coin.DynamicMemoryUsage();
+        if (assetData)
+            nUsage += memusage::DynamicUsage(assetData) + memusage::MallocUsage(assetData->strName.capacity());
+        return nUsage;
+    }
 };
 
-typedef std::unordered_map<COutPoint, CCoinsCacheEntry, SaltedOutpointHasher> CCoinsMap;
+typedef flatmap<COutPoint, CCoinsCacheEntry, SaltedOutpointHasher> CCoinsMap;
 
 /** Cursor for iterating over CoinsView state */
 class CCoinsViewCursor
@@ -161,6 +172,10 @@ public:
     //! Just check whether a given outpoint is unspent.
     virtual bool HaveCoin(const COutPoint &outpoint) const;
 
+    //! Look up many outpoints at once, appending the unspent coins found to vCoins in no
+    //! particular order. Views reading from disk do this faster than a GetCoin each.
+    virtual void GetCoins(const std::vector<COutPoint> &vOutpoints, std::vector<std::pair<COutPoint, Coin>> &vCoins) const;
+
     //! Retrieve the block hash whose state this CCoinsView currently represents
     virtual uint256 GetBestBlock() const;
 
@@ -218,6 +233,9 @@ protected:
     /* Cached dynamic memory usage for the inner Coin objects. */
     mutable size_t cachedCoinsUsage;
 
+    /* Bumped before and after every Flush, so it is odd while base is being written. */
+    std::atomic<uint64_t> nFlushSequence{0};
+
 public:
     CCoinsViewCache(CCoinsView *baseIn);
 
@@ -229,6 +247,7 @@ public:
     // Standard CCoinsView methods
     bool GetCoin(const COutPoint &outpoint, Coin &coin) const override;
     bool HaveCoin(const COutPoint &outpoint) const override;
+    void GetCoins(const std::vector<COutPoint> &vOutpoints, std::vector<std::pair<COutPoint, Coin>> &vCoins) const override;
     uint256 GetBestBlock() const override;
     void SetBestBlock(const uint256 &hashBlock);
     bool BatchWrite(CCoinsMap &mapCoins, const uint256 &hashBlock) override;
@@ -243,6 +262,28 @@ public:
      */
     bool HaveCoinInCache(const COutPoint &outpoint) const;
 
+    /**
+     * Bring the coins of the outpoints that aren't in the cache in from the
+     * backing view with one GetCoins, so that the lookups that follow hit.
+     */
+    void PrefetchCoins(const std::vector<COutPoint> &vOutpoints) const;
+
+    /**
+     * Read coins from the backing view without touching this cache. Unlike
+     * every other method this may be called without the lock guarding the
+     * cache, as long as the backing view allows concurrent reads; take
+     * GetFlushSequence before the read to tell whether it went stale.
+     */
+    void GetBaseCoins(const std::vector<COutPoint> &vOutpoints, std::vector<std::pair<COutPoint, Coin>> &vCoins) const { base->GetCoins(vOutpoints, vCoins); }
+    uint64_t GetFlushSequence() const { return nFlushSequence.load(std::memory_order_acquire); }
+
+    /**
+     * Add entries read with GetBaseCoins for the outpoints this cache has no
+     * entry for. The caller must have checked that no Flush started since
+     * they were read, otherwise the base may have changed under them.
+     */
+    void AddFetchedCoins(std::vector<std::pair<COutPoint, CCoinsCacheEntry>> &vEntries);
+
     /**
      * Return a reference to Coin in the cache, or a pruned one if not found. This is
      * more efficient than GetCoin.
@@ -255,6 +296,14 @@ public:
      */
     const Coin& AccessCoin(const COutPoint &output) const;
 
+    /**
+     * The decoded asset of the unspent asset coin at outpoint, or nullptr if
+     * it isn't one. The script is decoded on the first call and the result
+     * kept with the cache entry, the same object is handed to every caller
+     * until the coin is spent.
+     */
+    std::shared_ptr<const CCoinAssetData> AccessCoinAssetData(const COutPoint &outpoint) const;
+
     /**
      * Add a coin. Set potential_overwrite to true if a non-pruned version may
      * already exist.
@@ -302,6 +351,9 @@ public:
 
 private:
     CCoinsMap::iterator FetchCoin(const COutPoint &outpoint) const;
+    //! Cache the coins of the outpoints missing from cacheCoins with one call to base, also appending every coin found to pCoins if given
+    void FetchCoins(const std::vector<COutPoint> &vOutpoints, std::vector<std::pair<COutPoint, Coin>> *pCoins) const;
+    const std::shared_ptr<const CCoinAssetData>& DecodeCoinAsset(CCoinsCacheEntry& entry) const;
 };
 
 //! Utility function to add all of a transaction's outputs to a cache.
@@ -310,7 +362,7 @@ private:
 // an overwrite.
 // TODO: pass in a boolean to limit these possible overwrites to known
 // (pre-BIP34) cases.
-void AddCoins(CCoinsViewCache& cache, const CTransaction& tx, int nHeight, uint256 blockHash, bool check = false, CAssetsCache* assetsCache = nullptr, std::pair<std::string, CBlockAssetUndo>* undoAssetData = nullptr);
+void AddCoins(CCoinsViewCache& cache, const CTransaction& tx, int nHeight, uint256 blockHash, bool check = false, CAssetsCache* assetsCache = nullptr, std::pair<std::string, CBlockAssetUndo>* undoAssetData = nullptr, const std::vector<CAssetOutputRecord>* pAssetOutputs = nullptr);
 
 //! Utility function to find any unspent output with a given txid.
 // This function can be quite expensive because in the event of a transaction
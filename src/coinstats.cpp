@@ -0,0 +1,211 @@
+// Copyright (c) 2026 The Mynta Core Developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include "coinstats.h"
+
+#include "assets/assets.h"
+#include "coins.h"
+#include "crypto/muhash.h"
+#include "hash.h"
+#include "init.h"
+#include "pubkey.h"
+#include "script/standard.h"
+#include "serialize.h"
+#include "streams.h"
+#include "txdb.h"
+#include "util.h"
+
+#include <algorithm>
+#include <set>
+#include <thread>
+#include <vector>
+
+namespace {
+
+/** Coins between shutdown checks */
+const uint64_t COINSTATS_SHUTDOWN_CHECK = 4096;
+
+const std::string HASH_TYPE_NAMES[] = {"hash_serialized_2", "muhash", "none"};
+
+/** What one thread found in its range of txids */
+struct CCoinsRangeStats
+{
+    uint256 hashBlock;
+    uint64_t nTransactions{0};
+    uint64_t nTransactionOutputs{0};
+    uint64_t nBogoSize{0};
+    CAmount nTotalAmount{0};
+    MuHash3072 muhash;
+    std::map<std::string, CCoinsAssetStats> mapAssets;
+    std::map<std::string, std::set<CTxDestination>> mapHolders;
+    bool fOk{false};
+};
+
+void ApplyHashSerialized(CHashWriter& ss, const uint256& hash, const std::map<uint32_t, Coin>& outputs)
+{
+    assert(!outputs.empty());
+    ss << hash;
+    ss << VARINT(outputs.begin()->second.nHeight * 2 + outputs.begin()->second.fCoinBase);
+    for (const auto& output : outputs) {
+        ss << VARINT(output.first + 1);
+        ss << output.second.out.scriptPubKey;
+        ss << VARINT(output.second.out.nValue);
+    }
+    ss << VARINT(0);
+}
+
+void ApplyCoin(CCoinsRangeStats& range, CDataStream& ssCoin, const COutPoint& outpoint, const Coin& coin, CoinStatsHashType hashType, bool fAssets)
+{
+    range.nTransactionOutputs++;
+    range.nTotalAmount += coin.out.nValue;
+    range.nBogoSize += 32 /* txid */ + 4 /* vout index */ + 4 /* height + coinbase */ + 8 /* amount */ +
+                       2 /* scriptPubKey len */ + coin.out.scriptPubKey.size() /* scriptPubKey */;
+
+    if (hashType == CoinStatsHashType::MUHASH) {
+        ssCoin.clear();
+        ssCoin << outpoint;
+        ssCoin << (uint32_t)(coin.nHeight * 2 + coin.fCoinBase);
+        ssCoin << coin.out;
+        range.muhash.Insert((const unsigned char*)ssCoin.data(), ssCoin.size());
+    }
+
+    if (fAssets) {
+        std::string strName;
+        CAmount nAmount;
+        if (GetAssetInfoFromScript(coin.out.scriptPubKey, strName, nAmount)) {
+            CCoinsAssetStats& asset = range.mapAssets[strName];
+            asset.nAmount += nAmount;
+            asset.nOutputs++;
+            CTxDestination dest;
+            if (ExtractDestination(coin.out.scriptPubKey, dest))
+                range.mapHolders[strName].insert(dest);
+        }
+    }
+}
+
+/** Read the coins whose txid starts with a byte in [nBegin, nEnd) into range */
+void ScanRange(const CCoinsViewDB* view, const std::shared_ptr<const CDBSnapshot>& snapshot, int nBegin, int nEnd,
+               CoinStatsHashType hashType, bool fAssets, CHashWriter* pss, CCoinsRangeStats& range)
+{
+    try {
+        uint256 hashFrom;
+        *hashFrom.begin() = (unsigned char)nBegin;
+        std::unique_ptr<CCoinsViewCursor> pcursor(view->Cursor(snapshot, hashFrom));
+        range.hashBlock = pcursor->GetBestBlock();
+        if (pss)
+            *pss << range.hashBlock;
+
+        CDataStream ssCoin(SER_DISK, PROTOCOL_VERSION);
+        uint256 prevkey;
+        std::map<uint32_t, Coin> outputs;
+        uint64_t nRead = 0;
+        for (; pcursor->Valid(); pcursor->Next()) {
+            COutPoint key;
+            Coin coin;
+            if (!pcursor->GetKey(key) || !pcursor->GetValue(coin)) {
+                error("%s: unable to read value", __func__);
+                return;
+            }
+            if (*key.hash.begin() >= nEnd)
+                break;
+            if (++nRead % COINSTATS_SHUTDOWN_CHECK == 0 && ShutdownRequested())
+                return;
+            if (nRead == 1 || key.hash != prevkey) {
+                range.nTransactions++;
+                if (pss && !outputs.empty()) {
+                    ApplyHashSerialized(*pss, prevkey, outputs);
+                    outputs.clear();
+                }
+                prevkey = key.hash;
+            }
+            ApplyCoin(range, ssCoin, key, coin, hashType, fAssets);
+            if (pss)
+                outputs[key.n] = std::move(coin);
+        }
+        if (pss && !outputs.empty())
+            ApplyHashSerialized(*pss, prevkey, outputs);
+        range.fOk = true;
+    } catch (const std::exception& e) {
+        error("%s: %s", __func__, e.what());
+    }
+}
+
+} // namespace
+
+const std::string& CoinStatsHashTypeName(CoinStatsHashType hashType)
+{
+    return HASH_TYPE_NAMES[(int)hashType];
+}
+
+bool CoinStatsHashTypeByName(const std::string& strName, CoinStatsHashType& hashType)
+{
+    for (int i = 0; i <= (int)CoinStatsHashType::NONE; i++) {
+        if (HASH_TYPE_NAMES[i] == strName) {
+            hashType = (CoinStatsHashType)i;
+            return true;
+        }
+    }
+    return false;
+}
+
+bool GetUTXOStats(const CCoinsViewDB* view, const std::shared_ptr<const CDBSnapshot>& snapshot, CCoinsStats& stats,
+                  CoinStatsHashType hashType, bool fAssets, int nThreads)
+{
+    // The serialized hash covers the coins in database order, so it takes one pass
+    if (hashType == CoinStatsHashType::HASH_SERIALIZED)
+        nThreads = 1;
+    nThreads = std::max(1, std::min(nThreads, MAX_COINSTATS_THREADS));
+
+    std::vector<CCoinsRangeStats> vRanges(nThreads);
+    CHashWriter ss(SER_GETHASH, PROTOCOL_VERSION);
+    CHashWriter* pss = hashType == CoinStatsHashType::HASH_SERIALIZED ? &ss : nullptr;
+    std::vector<std::thread> vThreads;
+    for (int i = 1; i < nThreads; i++) {
+        vThreads.emplace_back([&, i] {
+            RenameThread("mynta-coinstats");
+            ScanRange(view, snapshot, i * 256 / nThreads, (i + 1) * 256 / nThreads, hashType, fAssets, nullptr, vRanges[i]);
+        });
+    }
+    ScanRange(view, snapshot, 0, 256 / nThreads, hashType, fAssets, pss, vRanges[0]);
+    for (std::thread& thread : vThreads)
+        thread.join();
+
+    MuHash3072 muhash;
+    std::map<std::string, std::set<CTxDestination>> mapHolders;
+    for (CCoinsRangeStats& range : vRanges) {
+        if (!range.fOk)
+            return false;
+        stats.nTransactions += range.nTransactions;
+        stats.nTransactionOutputs += range.nTransactionOutputs;
+        stats.nBogoSize += range.nBogoSize;
+        stats.nTotalAmount += range.nTotalAmount;
+        if (hashType == CoinStatsHashType::MUHASH)
+            muhash *= range.muhash;
+        for (const auto& asset : range.mapAssets) {
+            CCoinsAssetStats& total = stats.mapAssets[asset.first];
+            total.nAmount += asset.second.nAmount;
+            total.nOutputs += asset.second.nOutputs;
+        }
+        for (auto& holders : range.mapHolders) {
+            std::set<CTxDestination>& all = mapHolders[holders.first];
+            if (all.empty())
+                all.swap(holders.second);
+            else
+                all.insert(holders.second.begin(), holders.second.end());
+        }
+    }
+    for (const auto& holders : mapHolders)
+        stats.mapAssets[holders.first].nHolders = holders.second.size();
+
+    stats.hashBlock = vRanges[0].hashBlock;
+    if (hashType == CoinStatsHashType::HASH_SERIALIZED) {
+        stats.hashSerialized = ss.GetHash();
+    } else if (hashType == CoinStatsHashType::MUHASH) {
+        std::vector<unsigned char> vchHash(MuHash3072::OUTPUT_SIZE);
+        muhash.Finalize(vchHash.data());
+        stats.hashSerialized = uint256(vchHash);
+    }
+    stats.nDiskSize = view->EstimateSize();
+    return true;
+}
@@ -0,0 +1,70 @@
+// Copyright (c) 2026 The Mynta Core Developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#ifndef MYNTA_COINSTATS_H
+#define MYNTA_COINSTATS_H
+
+#include "amount.h"
+#include "uint256.h"
+
+#include <map>
+#include <memory>
+#include <string>
+
+class CCoinsViewDB;
+class CDBSnapshot;
+
+//! Threads gettxoutsetinfo reads the coins database with, at most
+static const int MAX_COINSTATS_THREADS = 16;
+
+/** The hash of the UTXO set GetUTXOStats computes */
+enum class CoinStatsHashType {
+    //! SHA256 of the coins in database order; needs a single, serial pass
+    HASH_SERIALIZED,
+    //! MuHash3072 of the coins, which doesn't depend on their order
+    MUHASH,
+    NONE,
+};
+
+const std::string& CoinStatsHashTypeName(CoinStatsHashType hashType);
+bool CoinStatsHashTypeByName(const std::string& strName, CoinStatsHashType& hashType);
+
+/** Unspent outputs of one asset */
+struct CCoinsAssetStats
+{
+    CAmount nAmount{0};
+    uint64_t nOutputs{0};
+    //! Distinct destinations holding the asset
+    uint64_t nHolders{0};
+};
+
+struct CCoinsStats
+{
+    int nHeight;
+    uint256 hashBlock;
+    uint64_t nTransactions;
+    uint64_t nTransactionOutputs;
+    uint64_t nBogoSize;
+    uint256 hashSerialized;
+    uint64_t nDiskSize;
+    CAmount nTotalAmount;
+    //! Per asset, if asked for
+    std::map<std::string, CCoinsAssetStats> mapAssets;
+
+    CCoinsStats() : nHeight(0), nTransactions(0), nTransactionOutputs(0), nBogoSize(0), nDiskSize(0), nTotalAmount(0) {}
+};
+
+/**
+ * Calculate statistics about the unspent transaction output set in snapshot
+ * of the coins database, optionally broken down by asset. Leaves nHeight to
+ * the caller, which knows the block index.
+ *
+ * Unless the hash is HASH_SERIALIZED, the coins are split into nThreads
+ * ranges of txids, each read by its own thread, and the per-range results
+ * are added up.
+ */
+bool GetUTXOStats(const CCoinsViewDB* view, const std::shared_ptr<const CDBSnapshot>& snapshot, CCoinsStats& stats,
+                  CoinStatsHashType hashType, bool fAssets, int nThreads);
+
+#endif // MYNTA_COINSTATS_H
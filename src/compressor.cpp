@@ -6,9 +6,11 @@
 
 #include "compressor.h"
 
+#include "crypto/common.h"
 #include "hash.h"
 #include "pubkey.h"
 #include "script/standard.h"
+#include "streams.h"
 
 bool CScriptCompressor::IsToKeyID(CKeyID &hash) const
 {
@@ -74,9 +76,119 @@ bool CScriptCompressor::Compress(std::vector<unsigned char> &out) const
             return true;
         }
     }
+    if (fAssetScripts && CompressAsset(out))
+        return true;
     return false;
 }
 
+//! Marker at the start of asset data, before its type
+static const unsigned char ASSET_DATA_MARKER[] = {'r', 'v', 'n'};
+
+bool CScriptCompressor::CompressAsset(std::vector<unsigned char> &out) const
+{
+    // The destination: OP_DUP OP_HASH160 <20> OP_EQUALVERIFY OP_CHECKSIG, or OP_HASH160 <20> OP_EQUAL
+    unsigned int nSize;
+    size_t nPos;
+    if (script.size() > 25 && script[0] == OP_DUP && script[1] == OP_HASH160 && script[2] == 20
+                           && script[23] == OP_EQUALVERIFY && script[24] == OP_CHECKSIG) {
+        nSize = 0x06;
+        nPos = 25;
+    } else if (script.size() > 23 && script[0] == OP_HASH160 && script[1] == 20 && script[22] == OP_EQUAL) {
+        nSize = 0x07;
+        nPos = 23;
+    } else {
+        return false;
+    }
+    uint160 hash;
+    memcpy(hash.begin(), &script[nSize == 0x06 ? 3 : 2], 20);
+
+    // Then OP_RVN_ASSET <asset data> OP_DROP
+    if (script.size() < nPos + 3 || script[nPos] != OP_RVN_ASSET || script.back() != OP_DROP)
+        return false;
+    nPos++;
+    size_t nData = script[nPos++];
+    if (nData == OP_PUSHDATA1 && nPos < script.size())
+        nData = script[nPos++];
+    else if (nData >= OP_PUSHDATA1)
+        return false;
+    if (nPos + nData + 1 != script.size())
+        return false;
+
+    // The asset data: marker, type, name, amount (not for owners), anything else
+    const unsigned char* pdata = &script[nPos];
+    const unsigned char* pend = pdata + nData;
+    if (nData < sizeof(ASSET_DATA_MARKER) + 2 || memcmp(pdata, ASSET_DATA_MARKER, sizeof(ASSET_DATA_MARKER)) != 0)
+        return false;
+    pdata += sizeof(ASSET_DATA_MARKER);
+    const unsigned char nType = *pdata++;
+    if (nType != ASSET_SCRIPT_NEW && nType != ASSET_SCRIPT_TRANSFER && nType != ASSET_SCRIPT_OWNER)
+        return false;
+    const size_t nName = *pdata++;
+    if (nName >= 253 || (size_t)(pend - pdata) < nName)
+        return false;
+    const std::string strName(pdata, pdata + nName);
+    pdata += nName;
+    uint64_t nAmount = 0;
+    if (nType != ASSET_SCRIPT_OWNER) {
+        if (pend - pdata < 8)
+            return false;
+        const int64_t nValue = (int64_t)ReadLE64(pdata);
+        if (nValue < 0)
+            return false;
+        nAmount = CTxOutCompressor::CompressAmount(nValue);
+        pdata += 8;
+    }
+    const std::vector<unsigned char> vchTail(pdata, pend);
+
+    // Only take the short form if it gives back exactly this script
+    CScript check;
+    if (!CScriptCompressor(check, true).DecompressAsset(nSize, hash, nType, strName, nAmount, vchTail) || check != script)
+        return false;
+
+    CDataStream ss(SER_DISK, 0);
+    ss << VARINT(nSize) << hash << nType << strName;
+    if (nType != ASSET_SCRIPT_OWNER)
+        ss << VARINT(nAmount);
+    ss << vchTail;
+    // Amounts that don't end in zeros can take more than the 8 bytes they had
+    if (ss.size() > script.size())
+        return false;
+    out.assign(ss.begin(), ss.end());
+    return true;
+}
+
+bool CScriptCompressor::DecompressAsset(unsigned int nSize, const uint160 &hash, unsigned char nType, const std::string &strName,
+                                        uint64_t nAmount, const std::vector<unsigned char> &vchTail)
+{
+    if (strName.size() >= 253 || vchTail.size() > MAX_SCRIPT_SIZE)
+        return false;
+
+    std::vector<unsigned char> vchData(ASSET_DATA_MARKER, ASSET_DATA_MARKER + sizeof(ASSET_DATA_MARKER));
+    vchData.push_back(nType);
+    vchData.push_back(strName.size());
+    vchData.insert(vchData.end(), strName.begin(), strName.end());
+    if (nType != ASSET_SCRIPT_OWNER) {
+        unsigned char vchAmount[8];
+        WriteLE64(vchAmount, CTxOutCompressor::DecompressAmount(nAmount));
+        vchData.insert(vchData.end(), vchAmount, vchAmount + 8);
+    }
+    vchData.insert(vchData.end(), vchTail.begin(), vchTail.end());
+
+    script.clear();
+    switch (nSize) {
+    case 0x06:
+        script << OP_DUP << OP_HASH160 << ToByteVector(hash) << OP_EQUALVERIFY << OP_CHECKSIG;
+        break;
+    case 0x07:
+        script << OP_HASH160 << ToByteVector(hash) << OP_EQUAL;
+        break;
+    default:
+        return false;
+    }
+    script << OP_RVN_ASSET << vchData << OP_DROP;
+    return script.size() <= MAX_SCRIPT_SIZE;
+}
+
 unsigned int CScriptCompressor::GetSpecialSize(unsigned int nSize) const
 {
     if (nSize == 0 || nSize == 1)
@@ -25,7 +25,20 @@ class CScriptID;
  *
  *  Other scripts up to 121 bytes require 1 byte + script length. Above
  *  that, scripts up to 16505 bytes require 2 bytes + script length.
+ *
+ *  With fAssetScripts (the chainstate format, see CCoinsViewDB) 2 more
+ *  special cases are defined, for asset new, transfer and owner outputs to
+ *  a pubkey hash or a script hash: the hash, the asset type, the name and a
+ *  compressed amount, followed by whatever else the asset data holds. Raw
+ *  scripts are then offset by 8 instead of 6.
  */
+//! Longest asset name a compressed asset script can hold
+static const unsigned int MAX_ASSET_SCRIPT_NAME = 255;
+//! Asset data types with a compressed form: new asset, transfer, owner
+static const unsigned char ASSET_SCRIPT_NEW = 'q';
+static const unsigned char ASSET_SCRIPT_TRANSFER = 't';
+static const unsigned char ASSET_SCRIPT_OWNER = 'o';
+
 class CScriptCompressor
 {
 private:
@@ -36,8 +49,13 @@ private:
      * and nHeight of the enclosing transaction.
      */
     static const unsigned int nSpecialScripts = 6;
+    //! nSpecialScripts plus the asset script cases
+    static const unsigned int nAssetSpecialScripts = 8;
 
     CScript &script;
+    const bool fAssetScripts;
+
+    unsigned int SpecialScripts() const { return fAssetScripts ? nAssetSpecialScripts : nSpecialScripts; }
 protected:
     /**
      * These check for scripts for which a special case with a shorter encoding is defined.
@@ -53,8 +71,13 @@ protected:
     bool Compress(std::vector<unsigned char> &out) const;
     unsigned int GetSpecialSize(unsigned int nSize) const;
     bool Decompress(unsigned int nSize, const std::vector<unsigned char> &out);
+
+    /** The asset script cases, appended to out after the case number */
+    bool CompressAsset(std::vector<unsigned char> &out) const;
+    bool DecompressAsset(unsigned int nSize, const uint160 &hash, unsigned char nType, const std::string &strName,
+                         uint64_t nAmount, const std::vector<unsigned char> &vchTail);
 public:
-    explicit CScriptCompressor(CScript &scriptIn) : script(scriptIn) { }
+    explicit CScriptCompressor(CScript &scriptIn, bool fAssetScriptsIn = false) : script(scriptIn), fAssetScripts(fAssetScriptsIn) { }
 
     template<typename Stream>
     void Serialize(Stream &s) const {
@@ -63,7 +86,7 @@ public:
             s << CFlatData(compr);
             return;
         }
-        unsigned int nSize = script.size() + nSpecialScripts;
+        unsigned int nSize = script.size() + SpecialScripts();
         s << VARINT(nSize);
         s << CFlatData(script);
     }
@@ -78,7 +101,23 @@ public:
             Decompress(nSize, vch);
             return;
         }
-        nSize -= nSpecialScripts;
+        if (nSize < SpecialScripts()) {
+            uint160 hash;
+            unsigned char nType;
+            std::string strName;
+            uint64_t nAmount = 0;
+            std::vector<unsigned char> vchTail;
+            s >> hash >> nType >> LIMITED_STRING(strName, MAX_ASSET_SCRIPT_NAME);
+            if (nType != ASSET_SCRIPT_OWNER)
+                s >> VARINT(nAmount);
+            s >> vchTail;
+            if (!DecompressAsset(nSize, hash, nType, strName, nAmount, vchTail)) {
+                script.clear();
+                script << OP_RETURN;
+            }
+            return;
+        }
+        nSize -= SpecialScripts();
         if (nSize > MAX_SCRIPT_SIZE) {
             // Overly long script, replace with a short invalid one
             script << OP_RETURN;
@@ -95,12 +134,13 @@ class CTxOutCompressor
 {
 private:
     CTxOut &txout;
+    const bool fAssetScripts;
 
 public:
     static uint64_t CompressAmount(uint64_t nAmount);
     static uint64_t DecompressAmount(uint64_t nAmount);
 
-    explicit CTxOutCompressor(CTxOut &txoutIn) : txout(txoutIn) { }
+    explicit CTxOutCompressor(CTxOut &txoutIn, bool fAssetScriptsIn = false) : txout(txoutIn), fAssetScripts(fAssetScriptsIn) { }
 
     ADD_SERIALIZE_METHODS;
 
@@ -114,7 +154,7 @@ public:
             READWRITE(VARINT(nVal));
             txout.nValue = DecompressAmount(nVal);
         }
-        CScriptCompressor cscript(REF(txout.scriptPubKey));
+        CScriptCompressor cscript(REF(txout.scriptPubKey), fAssetScripts);
         READWRITE(cscript);
     }
 };
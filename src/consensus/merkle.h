@@ -13,6 +13,31 @@
 #include "primitives/block.h"
 #include "uint256.h"
 
+/**
+ * Every level of a merkle tree, from the leaves up to the root, hashed one
+ * level at a time with SHA256D64. Keeping it lets the branches of many leaves
+ * or the hash of any inner node be read without hashing the tree again.
+ */
+class CMerkleTree
+{
+private:
+    //! vLevels[0] are the leaves; a level of odd size pairs its last node with itself
+    std::vector<std::vector<uint256>> vLevels;
+    bool fMutated{false};
+
+public:
+    explicit CMerkleTree(std::vector<uint256> leaves);
+
+    /** Null when there are no leaves */
+    uint256 Root() const;
+    /** Whether two equal nodes were paired anywhere, see ComputeMerkleRoot */
+    bool Mutated() const { return fMutated; }
+    size_t Height() const { return vLevels.size(); }
+    size_t Width(size_t height) const { return vLevels[height].size(); }
+    const uint256& Node(size_t height, size_t pos) const { return vLevels[height][pos]; }
+    std::vector<uint256> Branch(uint32_t position) const;
+};
+
 uint256 ComputeMerkleRoot(const std::vector<uint256>& leaves, bool* mutated = nullptr);
 std::vector<uint256> ComputeMerkleBranch(const std::vector<uint256>& leaves, uint32_t position);
 uint256 ComputeMerkleRootFromBranch(const uint256& leaf, const std::vector<uint256>& branch, uint32_t position);
@@ -36,4 +61,10 @@ uint256 BlockWitnessMerkleRoot(const CBlock& block, bool* mutated = nullptr);
  */
 std::vector<uint256> BlockMerkleBranch(const CBlock& block, uint32_t position);
 
+/*
+ * Compute the whole merkle tree of the transactions in a block, for getting
+ * the branches of several transactions.
+ */
+CMerkleTree BlockMerkleTree(const CBlock& block);
+
 #endif
@@ -14,7 +14,9 @@
 #include "primitives/transaction.h"
 #include "script/interpreter.h"
 #include "validation.h"
+#include <algorithm>
 #include <cmath>
+#include <unordered_map>
 #include <wallet/wallet.h>
 #include <base58.h>
 #include <tinyformat.h>
@@ -116,16 +118,7 @@ bool SequenceLocks(const CTransaction &tx, int flags, std::vector<int>* prevHeig
 
 unsigned int GetLegacySigOpCount(const CTransaction& tx)
 {
-    unsigned int nSigOps = 0;
-    for (const auto& txin : tx.vin)
-    {
-        nSigOps += txin.scriptSig.GetSigOpCount(false);
-    }
-    for (const auto& txout : tx.vout)
-    {
-        nSigOps += txout.scriptPubKey.GetSigOpCount(false);
-    }
-    return nSigOps;
+    return tx.GetLegacySigOpCount();
 }
 
 unsigned int GetP2SHSigOpCount(const CTransaction& tx, const CCoinsViewCache& inputs)
@@ -166,6 +159,9 @@ int64_t GetTransactionSigOpCost(const CTransaction& tx, const CCoinsViewCache& i
     return nSigOps;
 }
 
+/** Up to this many inputs, CheckTransaction compares every pair to find duplicates */
+static const size_t MAX_PAIRWISE_DUPLICATE_INPUTS = 16;
+
 bool CheckTransaction(const CTransaction& tx, CValidationState &state, bool fCheckDuplicateInputs, bool fMempoolCheck, bool fBlockCheck)
 {
     // Basic checks that don't depend on any context
@@ -174,7 +170,7 @@ bool CheckTransaction(const CTransaction& tx, CValidationState &state, bool fChe
     if (tx.vout.empty())
         return state.DoS(10, false, REJECT_INVALID, "bad-txns-vout-empty");
     // Size limits (this doesn't take the witness into account, as that hasn't been checked for malleability)
-    if (::GetSerializeSize(tx, SER_NETWORK, PROTOCOL_VERSION | SERIALIZE_TRANSACTION_NO_WITNESS) * WITNESS_SCALE_FACTOR > GetMaxBlockWeight())
+    if (tx.GetBaseSize() * WITNESS_SCALE_FACTOR > GetMaxBlockWeight())
         return state.DoS(100, false, REJECT_INVALID, "bad-txns-oversize");
 
     // Check for negative or overflow output values
@@ -366,10 +362,23 @@ bool CheckTransaction(const CTransaction& tx, CValidationState &state, bool fChe
     /** RVN END */
 
     if (fCheckDuplicateInputs) {
-        std::set<COutPoint> vInOutPoints;
-        for (const auto& txin : tx.vin)
-        {
-            if (!vInOutPoints.insert(txin.prevout).second)
+        // Comparing pairs is cheapest for a few inputs, beyond that the
+        // prevouts are copied to one flat vector and sorted, instead of
+        // allocating a set node per input
+        if (tx.vin.size() <= MAX_PAIRWISE_DUPLICATE_INPUTS) {
+            for (size_t i = 1; i < tx.vin.size(); i++) {
+                for (size_t j = 0; j < i; j++) {
+                    if (tx.vin[i].prevout == tx.vin[j].prevout)
+                        return state.DoS(100, false, REJECT_INVALID, "bad-txns-inputs-duplicate");
+                }
+            }
+        } else {
+            std::vector<COutPoint> vInOutPoints;
+            vInOutPoints.reserve(tx.vin.size());
+            for (const auto& txin : tx.vin)
+                vInOutPoints.push_back(txin.prevout);
+            std::sort(vInOutPoints.begin(), vInOutPoints.end());
+            if (std::adjacent_find(vInOutPoints.begin(), vInOutPoints.end()) != vInOutPoints.end())
                 return state.DoS(100, false, REJECT_INVALID, "bad-txns-inputs-duplicate");
         }
     }
@@ -379,13 +388,9 @@ bool CheckTransaction(const CTransaction& tx, CValidationState &state, bool fChe
         if (tx.vin[0].scriptSig.size() < 2 || tx.vin[0].scriptSig.size() > 100)
             return state.DoS(100, false, REJECT_INVALID, "bad-cb-length");
 
-        if (AreCoinbaseCheckAssetsDeployed()) {
-            for (auto vout : tx.vout) {
-                if (vout.scriptPubKey.IsAssetScript() || vout.scriptPubKey.IsNullAsset()) {
-                    return state.DoS(0, error("%s: coinbase contains asset transaction", __func__),
-                                     REJECT_INVALID, "bad-txns-coinbase-contains-asset-txes");
-                }
-            }
+        if (AreCoinbaseCheckAssetsDeployed() && (tx.HasAssetOutputs() || tx.HasNullAssetOutputs())) {
+            return state.DoS(0, error("%s: coinbase contains asset transaction", __func__),
+                             REJECT_INVALID, "bad-txns-coinbase-contains-asset-txes");
         }
     }
     else
@@ -603,8 +608,109 @@ bool Consensus::CheckTxInputs(const CTransaction& tx, CValidationState& state, c
     return true;
 }
 
+namespace {
+/**
+ * Per-asset running totals of one transaction's inputs or outputs. Asset
+ * transactions carry one or two assets, so a linear scan of a flat vector
+ * beats a tree. Past MAX_LINEAR_ENTRIES assets the tally also keeps a hash
+ * index from name to entry, so a transaction with many assets stays linear
+ * in its size. Clear() keeps the entries and their name buffers, so a
+ * reused tally stops allocating once it has seen a few transactions, and
+ * drops them once a large transaction left more than MAX_KEPT_ENTRIES.
+ */
+class CAssetTally
+{
+public:
+    struct Entry {
+        std::string strName;
+        CAmount nAmount;
+        //! Where the first input holding the asset came from, for messages
+        CTxDestination destination;
+    };
+
+    static const size_t MAX_LINEAR_ENTRIES = 16;
+    static const size_t MAX_KEPT_ENTRIES = 64;
+
+private:
+    std::vector<Entry> vEntries;
+    size_t nUsed{0};
+    //! Entry position by name, only filled once nUsed passes MAX_LINEAR_ENTRIES
+    std::unordered_map<std::string, size_t> mapIndex;
+
+public:
+    void Clear()
+    {
+        nUsed = 0;
+        if (vEntries.size() > MAX_KEPT_ENTRIES) {
+            std::vector<Entry>().swap(vEntries);
+            std::unordered_map<std::string, size_t>().swap(mapIndex);
+        } else {
+            mapIndex.clear();
+        }
+    }
+    size_t Size() const { return nUsed; }
+    std::vector<Entry>::iterator begin() { return vEntries.begin(); }
+    std::vector<Entry>::iterator end() { return vEntries.begin() + nUsed; }
+
+    Entry* Find(const std::string& strName)
+    {
+        if (nUsed > MAX_LINEAR_ENTRIES) {
+            auto it = mapIndex.find(strName);
+            return it == mapIndex.end() ? nullptr : &vEntries[it->second];
+        }
+        for (size_t i = 0; i < nUsed; i++) {
+            if (vEntries[i].strName == strName)
+                return &vEntries[i];
+        }
+        return nullptr;
+    }
+
+    //! Add nAmount to the asset's total, setting fNew if this is its first entry
+    Entry& Add(const std::string& strName, CAmount nAmount, bool& fNew)
+    {
+        Entry* pEntry = Find(strName);
+        fNew = !pEntry;
+        if (pEntry) {
+            pEntry->nAmount += nAmount;
+            return *pEntry;
+        }
+        if (nUsed == vEntries.size())
+            vEntries.emplace_back();
+        Entry& entry = vEntries[nUsed++];
+        entry.strName.assign(strName);
+        entry.nAmount = nAmount;
+        entry.destination = CNoDestination();
+        if (nUsed == MAX_LINEAR_ENTRIES + 1) {
+            for (size_t i = 0; i < nUsed; i++)
+                mapIndex.emplace(vEntries[i].strName, i);
+        } else if (nUsed > MAX_LINEAR_ENTRIES) {
+            mapIndex.emplace(entry.strName, nUsed - 1);
+        }
+        return entry;
+    }
+
+    //! Order the entries by name, moving them in the index too
+    void SortByName()
+    {
+        std::sort(begin(), end(), [](const Entry& a, const Entry& b) {
+            return a.strName < b.strName;
+        });
+        if (nUsed > MAX_LINEAR_ENTRIES) {
+            for (size_t i = 0; i < nUsed; i++)
+                mapIndex[vEntries[i].strName] = i;
+        }
+    }
+};
+
+/** Tallies reused by every CheckTxAssets call on a thread */
+struct CAssetTallyScratch {
+    CAssetTally inputs;
+    CAssetTally outputs;
+};
+} // namespace
+
 //! Check to make sure that the inputs and outputs CAmount match exactly.
-bool Consensus::CheckTxAssets(const CTransaction& tx, CValidationState& state, const CCoinsViewCache& inputs, CAssetsCache* assetCache, bool fCheckMempool, std::vector<std::pair<std::string, uint256> >& vPairReissueAssets, const bool fRunningUnitTests, std::set<CMessage>* setMessages, int64_t nBlocktime,   std::vector<std::pair<std::string, CNullAssetTxData>>* myNullAssetData)
+bool Consensus::CheckTxAssets(const CTransaction& tx, CValidationState& state, const CCoinsViewCache& inputs, CAssetsCache* assetCache, bool fCheckMempool, std::vector<std::pair<std::string, uint256> >& vPairReissueAssets, const bool fRunningUnitTests, std::set<CMessage>* setMessages, int64_t nBlocktime,   std::vector<std::pair<std::string, CNullAssetTxData>>* myNullAssetData, const std::vector<CAssetOutputRecord>* pAssetOutputs)
 {
     // are the actual inputs available?
     if (!inputs.HaveInputs(tx)) {
@@ -612,10 +718,12 @@ bool Consensus::CheckTxAssets(const CTransaction& tx, CValidationState& state, c
                          strprintf("%s: inputs missing/spent", __func__), tx.GetHash());
     }
 
-    // Create map that stores the amount of an asset transaction input. Used to verify no assets are burned
-    std::map<std::string, CAmount> totalInputs;
-
-    std::map<std::string, std::string> mapAddresses;
+    // Totals of each asset in the inputs and outputs. Used to verify no assets are burned
+    static thread_local CAssetTallyScratch scratch;
+    CAssetTally& totalInputs = scratch.inputs;
+    CAssetTally& totalOutputs = scratch.outputs;
+    totalInputs.Clear();
+    totalOutputs.Clear();
 
     for (unsigned int i = 0; i < tx.vin.size(); ++i) {
         const COutPoint &prevout = tx.vin[i].prevout;
@@ -623,40 +731,43 @@ bool Consensus::CheckTxAssets(const CTransaction& tx, CValidationState& state, c
         assert(!coin.IsSpent());
 
         if (coin.IsAsset()) {
-            CAssetOutputEntry data;
-            if (!GetAssetData(coin.out.scriptPubKey, data))
+            // Decoded once per coins cache entry, spending the coin reuses it
+            auto pData = inputs.AccessCoinAssetData(prevout);
+            if (!pData || !pData->fDecoded)
                 return state.DoS(100, false, REJECT_INVALID, "bad-txns-failed-to-get-asset-from-script", false, "", tx.GetHash());
+            const CCoinAssetData& data = *pData;
 
-            // Add to the total value of assets in the inputs
-            if (totalInputs.count(data.assetName))
-                totalInputs.at(data.assetName) += data.nAmount;
-            else
-                totalInputs.insert(make_pair(data.assetName, data.nAmount));
+            // Add to the total value of assets in the inputs. The first input's
+            // destination is kept undecoded, only a message compares against it.
+            bool fNew;
+            CAssetTally::Entry& entry = totalInputs.Add(data.strName, data.nAmount, fNew);
+            if (fNew)
+                entry.destination = data.address.GetDestination();
 
-            if (AreMessagesDeployed()) {
-                mapAddresses.insert(make_pair(data.assetName,EncodeDestination(data.destination)));
-            }
-
-            if (IsAssetNameAnRestricted(data.assetName)) {
-                if (assetCache->CheckForAddressRestriction(data.assetName, EncodeDestination(data.destination), true)) {
+            if (IsAssetNameAnRestricted(data.strName)) {
+                if (assetCache->CheckForAddressRestriction(data.strName, data.address.ToString(), true)) {
                     return state.DoS(100, false, REJECT_INVALID, "bad-txns-restricted-asset-transfer-from-frozen-address", false, "", tx.GetHash());
                 }
             }
         }
     }
 
-    // Create map that stores the amount of an asset transaction output. Used to verify no assets are burned
-    std::map<std::string, CAmount> totalOutputs;
     int index = 0;
     int64_t currentTime = GetTime();
     std::string strError = "";
     int i = 0;
     for (const auto& txout : tx.vout) {
         i++;
+        // Outputs decoded ahead of time by ConnectBlock carry their classification and payload
+        const CAssetOutputRecord* pRecord = pAssetOutputs ? &(*pAssetOutputs)[index] : nullptr;
         bool fIsAsset = false;
         int nType = 0;
         bool fIsOwner = false;
-        if (txout.scriptPubKey.IsAssetScript(nType, fIsOwner))
+        if (pRecord) {
+            fIsAsset = pRecord->fIsAsset;
+            nType = pRecord->nType;
+            fIsOwner = pRecord->fIsOwner;
+        } else if (txout.scriptPubKey.IsAssetScript(nType, fIsOwner))
             fIsAsset = true;
 
         if (assetCache) {
@@ -684,19 +795,19 @@ bool Consensus::CheckTxAssets(const CTransaction& tx, CValidationState& state, c
         }
 
         if (nType == TX_TRANSFER_ASSET) {
-            CAssetTransfer transfer;
-            std::string address = "";
-            if (!TransferAssetFromScript(txout.scriptPubKey, transfer, address))
+            CAssetTransfer decodedTransfer;
+            CAddressKey decodedAddress;
+            if (pRecord ? !pRecord->fDecoded : !TransferAssetFromScript(txout.scriptPubKey, decodedTransfer, decodedAddress))
                 return state.DoS(100, false, REJECT_INVALID, "bad-tx-asset-transfer-bad-deserialize", false, "", tx.GetHash());
+            const CAssetTransfer& transfer = pRecord ? pRecord->transfer : decodedTransfer;
+            const CAddressKey& address = pRecord ? pRecord->address : decodedAddress;
 
             if (!ContextualCheckTransferAsset(assetCache, transfer, address, strError))
                 return state.DoS(100, false, REJECT_INVALID, strError, false, "", tx.GetHash());
 
             // Add to the total value of assets in the outputs
-            if (totalOutputs.count(transfer.strName))
-                totalOutputs.at(transfer.strName) += transfer.nAmount;
-            else
-                totalOutputs.insert(make_pair(transfer.strName, transfer.nAmount));
+            bool fNew;
+            totalOutputs.Add(transfer.strName, transfer.nAmount, fNew);
 
             if (!fRunningUnitTests) {
                 if (IsAssetNameAnOwner(transfer.strName)) {
@@ -722,8 +833,9 @@ bool Consensus::CheckTxAssets(const CTransaction& tx, CValidationState& state, c
                 if (IsAssetNameAnOwner(transfer.strName) || IsAssetNameAnMsgChannel(transfer.strName)) {
                     if (!transfer.message.empty()) {
                         if (transfer.nExpireTime == 0 || transfer.nExpireTime > currentTime) {
-                            if (mapAddresses.count(transfer.strName)) {
-                                if (mapAddresses.at(transfer.strName) == address) {
+                            const CAssetTally::Entry* pInput = totalInputs.Find(transfer.strName);
+                            if (pInput) {
+                                if (EncodeDestination(pInput->destination) == address.ToString()) {
                                     COutPoint out(tx.GetHash(), index);
                                     CMessage message(out, transfer.strName, transfer.message,
                                                      transfer.nExpireTime, nBlocktime);
@@ -736,10 +848,11 @@ bool Consensus::CheckTxAssets(const CTransaction& tx, CValidationState& state, c
                 }
             }
         } else if (nType == TX_REISSUE_ASSET) {
-            CReissueAsset reissue;
+            CReissueAsset decodedReissue;
             std::string address;
-            if (!ReissueAssetFromScript(txout.scriptPubKey, reissue, address))
+            if (pRecord ? !pRecord->fDecoded : !ReissueAssetFromScript(txout.scriptPubKey, decodedReissue, address))
                 return state.DoS(100, false, REJECT_INVALID, "bad-tx-asset-reissue-bad-deserialize", false, "", tx.GetHash());
+            const CReissueAsset& reissue = pRecord ? pRecord->reissue : decodedReissue;
 
             if (mapReissuedAssets.count(reissue.strName)) {
                 if (mapReissuedAssets.at(reissue.strName) != tx.GetHash())
@@ -752,11 +865,14 @@ bool Consensus::CheckTxAssets(const CTransaction& tx, CValidationState& state, c
     }
 
     if (assetCache) {
+        const CAssetOutputRecord* pLast = pAssetOutputs && !pAssetOutputs->empty() ? &pAssetOutputs->back() : nullptr;
         if (tx.IsNewAsset()) {
             // Get the asset type
             CNewAsset asset;
             std::string address;
-            if (!AssetFromScript(tx.vout[tx.vout.size() - 1].scriptPubKey, asset, address)) {
+            if (pLast && pLast->fDecoded && pLast->nType == TX_NEW_ASSET && !pLast->fIsOwner) {
+                asset = pLast->asset;
+            } else if (!AssetFromScript(tx.vout[tx.vout.size() - 1].scriptPubKey, asset, address)) {
                 error("%s : Failed to get new asset from transaction: %s", __func__, tx.GetHash().GetHex());
                 return state.DoS(100, false, REJECT_INVALID, "bad-txns-issue-serialzation-failed", false, "", tx.GetHash());
             }
@@ -770,7 +886,9 @@ bool Consensus::CheckTxAssets(const CTransaction& tx, CValidationState& state, c
         } else if (tx.IsReissueAsset()) {
             CReissueAsset reissue_asset;
             std::string address;
-            if (!ReissueAssetFromScript(tx.vout[tx.vout.size() - 1].scriptPubKey, reissue_asset, address)) {
+            if (pLast && pLast->fDecoded && pLast->nType == TX_REISSUE_ASSET) {
+                reissue_asset = pLast->reissue;
+            } else if (!ReissueAssetFromScript(tx.vout[tx.vout.size() - 1].scriptPubKey, reissue_asset, address)) {
                 error("%s : Failed to get new asset from transaction: %s", __func__, tx.GetHash().GetHex());
                 return state.DoS(100, false, REJECT_INVALID, "bad-txns-reissue-serialzation-failed", false, "", tx.GetHash());
             }
@@ -849,22 +967,26 @@ bool Consensus::CheckTxAssets(const CTransaction& tx, CValidationState& state, c
         }
     }
 
+    // In name order, so the asset a mismatch is reported for doesn't depend on output order
+    if (totalOutputs.Size() > 1)
+        totalOutputs.SortByName();
     for (const auto& outValue : totalOutputs) {
-        if (!totalInputs.count(outValue.first)) {
+        const CAssetTally::Entry* pInput = totalInputs.Find(outValue.strName);
+        if (!pInput) {
             std::string errorMsg;
-            errorMsg = strprintf("Bad Transaction - Trying to create outpoint for asset that you don't have: %s", outValue.first);
+            errorMsg = strprintf("Bad Transaction - Trying to create outpoint for asset that you don't have: %s", outValue.strName);
             return state.DoS(100, false, REJECT_INVALID, "bad-tx-inputs-outputs-mismatch " + errorMsg, false, "", tx.GetHash());
         }
 
-        if (totalInputs.at(outValue.first) != outValue.second) {
+        if (pInput->nAmount != outValue.nAmount) {
             std::string errorMsg;
-            errorMsg = strprintf("Bad Transaction - Assets would be burnt %s", outValue.first);
+            errorMsg = strprintf("Bad Transaction - Assets would be burnt %s", outValue.strName);
             return state.DoS(100, false, REJECT_INVALID, "bad-tx-inputs-outputs-mismatch " + errorMsg, false, "", tx.GetHash());
         }
     }
 
     // Check the input size and the output size
-    if (totalOutputs.size() != totalInputs.size()) {
+    if (totalOutputs.Size() != totalInputs.Size()) {
         return state.DoS(100, false, REJECT_INVALID, "bad-tx-asset-inputs-size-does-not-match-outputs-size", false, "", tx.GetHash());
     }
     return true;
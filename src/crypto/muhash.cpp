@@ -0,0 +1,182 @@
+// Copyright (c) 2026 The Mynta Core Developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include "crypto/muhash.h"
+
+#include "crypto/chacha20.h"
+#include "crypto/common.h"
+#include "crypto/sha256.h"
+
+#include <string.h>
+
+namespace
+{
+
+//! 2^3072 - MAX_PRIME_DIFF is the prime, so 2^3072 is congruent to MAX_PRIME_DIFF
+const uint32_t MAX_PRIME_DIFF = 1103717;
+
+//! Limbs of the exponent of GetInverse, the prime minus two
+inline uint32_t InverseExponentLimb(int i)
+{
+    return i == 0 ? (uint32_t)(0 - MAX_PRIME_DIFF - 2) : 0xFFFFFFFFu;
+}
+
+} // namespace
+
+Num3072::Num3072()
+{
+    SetToOne();
+}
+
+Num3072::Num3072(const unsigned char (&data)[BYTE_SIZE])
+{
+    for (int i = 0; i < LIMBS; i++)
+        limbs[i] = ReadLE32(data + 4 * i);
+}
+
+void Num3072::SetToOne()
+{
+    limbs[0] = 1;
+    memset(limbs + 1, 0, (LIMBS - 1) * sizeof(limbs[0]));
+}
+
+bool Num3072::IsOverflow() const
+{
+    if (limbs[0] < (uint32_t)(0 - MAX_PRIME_DIFF))
+        return false;
+    for (int i = 1; i < LIMBS; i++) {
+        if (limbs[i] != 0xFFFFFFFFu)
+            return false;
+    }
+    return true;
+}
+
+void Num3072::FullReduce()
+{
+    // Subtracting the prime is adding MAX_PRIME_DIFF and dropping 2^3072
+    uint64_t carry = MAX_PRIME_DIFF;
+    for (int i = 0; i < LIMBS && carry; i++) {
+        carry += limbs[i];
+        limbs[i] = (uint32_t)carry;
+        carry >>= 32;
+    }
+}
+
+void Num3072::Multiply(const Num3072& a)
+{
+    uint32_t t[2 * LIMBS] = {0};
+    for (int i = 0; i < LIMBS; i++) {
+        uint64_t carry = 0;
+        for (int j = 0; j < LIMBS; j++) {
+            carry += (uint64_t)limbs[i] * a.limbs[j] + t[i + j];
+            t[i + j] = (uint32_t)carry;
+            carry >>= 32;
+        }
+        t[i + LIMBS] = (uint32_t)carry;
+    }
+
+    // Fold the high half in as multiples of MAX_PRIME_DIFF, then whatever
+    // spills past 2^3072 again until nothing does
+    uint64_t carry = 0;
+    for (int i = 0; i < LIMBS; i++) {
+        carry += (uint64_t)t[i + LIMBS] * MAX_PRIME_DIFF + t[i];
+        limbs[i] = (uint32_t)carry;
+        carry >>= 32;
+    }
+    while (carry) {
+        uint64_t acc = carry * MAX_PRIME_DIFF;
+        for (int i = 0; i < LIMBS && acc; i++) {
+            acc += limbs[i];
+            limbs[i] = (uint32_t)acc;
+            acc >>= 32;
+        }
+        carry = acc;
+    }
+    if (IsOverflow())
+        FullReduce();
+}
+
+Num3072 Num3072::GetInverse() const
+{
+    // Fermat: the inverse is this to the power of the prime minus two,
+    // taken four bits of the exponent at a time
+    Num3072 table[16];
+    table[1] = *this;
+    for (int k = 2; k < 16; k++) {
+        table[k] = table[k - 1];
+        table[k].Multiply(*this);
+    }
+    Num3072 out;
+    for (int i = LIMBS * 8 - 1; i >= 0; i--) {
+        for (int k = 0; k < 4; k++)
+            out.Multiply(out);
+        const uint32_t nibble = (InverseExponentLimb(i / 8) >> (4 * (i % 8))) & 15;
+        if (nibble)
+            out.Multiply(table[nibble]);
+    }
+    return out;
+}
+
+void Num3072::Divide(const Num3072& a)
+{
+    Multiply(a.GetInverse());
+}
+
+void Num3072::ToBytes(unsigned char (&out)[BYTE_SIZE])
+{
+    // Anything below 2^3072 is at most one prime too large
+    if (IsOverflow())
+        FullReduce();
+    for (int i = 0; i < LIMBS; i++)
+        WriteLE32(out + 4 * i, limbs[i]);
+}
+
+Num3072 MuHash3072::ToNum3072(const unsigned char* data, size_t len)
+{
+    unsigned char key[CSHA256::OUTPUT_SIZE];
+    CSHA256().Write(data, len).Finalize(key);
+    unsigned char stream[Num3072::BYTE_SIZE];
+    ChaCha20(key, sizeof(key)).Output(stream, sizeof(stream));
+    return Num3072(stream);
+}
+
+MuHash3072::MuHash3072(const unsigned char* data, size_t len) : numerator(ToNum3072(data, len))
+{
+}
+
+MuHash3072& MuHash3072::Insert(const unsigned char* data, size_t len)
+{
+    numerator.Multiply(ToNum3072(data, len));
+    return *this;
+}
+
+MuHash3072& MuHash3072::Remove(const unsigned char* data, size_t len)
+{
+    denominator.Multiply(ToNum3072(data, len));
+    return *this;
+}
+
+MuHash3072& MuHash3072::operator*=(const MuHash3072& mul)
+{
+    numerator.Multiply(mul.numerator);
+    denominator.Multiply(mul.denominator);
+    return *this;
+}
+
+MuHash3072& MuHash3072::operator/=(const MuHash3072& div)
+{
+    numerator.Multiply(div.denominator);
+    denominator.Multiply(div.numerator);
+    return *this;
+}
+
+void MuHash3072::Finalize(unsigned char hash[OUTPUT_SIZE])
+{
+    numerator.Divide(denominator);
+    denominator.SetToOne();
+
+    unsigned char data[Num3072::BYTE_SIZE];
+    numerator.ToBytes(data);
+    CSHA256().Write(data, sizeof(data)).Finalize(hash);
+}
@@ -0,0 +1,76 @@
+// Copyright (c) 2026 The Mynta Core Developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#ifndef MYNTA_CRYPTO_MUHASH_H
+#define MYNTA_CRYPTO_MUHASH_H
+
+#include <stdint.h>
+#include <stdlib.h>
+
+/** A number modulo 2^3072 - 1103717, a prime. */
+class Num3072
+{
+public:
+    static const size_t BYTE_SIZE = 384;
+    static const int LIMBS = 96;
+
+    //! Little endian 32-bit limbs, so products fit a uint64_t on any platform
+    uint32_t limbs[LIMBS];
+
+    //! The number one
+    Num3072();
+    //! The little endian number in data, which may be as large as 2^3072 - 1
+    explicit Num3072(const unsigned char (&data)[BYTE_SIZE]);
+
+    void SetToOne();
+    void Multiply(const Num3072& a);
+    //! Multiply by the inverse of a, which is zero when a is
+    void Divide(const Num3072& a);
+    //! Little endian bytes of the number reduced modulo the prime
+    void ToBytes(unsigned char (&out)[BYTE_SIZE]);
+
+private:
+    bool IsOverflow() const;
+    void FullReduce();
+    Num3072 GetInverse() const;
+};
+
+/**
+ * A hash of a set that does not depend on the order of its elements, and
+ * that an element can be added to or removed from without the others.
+ *
+ * Each element is hashed to a number modulo a 3072-bit prime (SHA256 of the
+ * element keys ChaCha20, whose first 384 bytes are the number), and the set
+ * hashes to the product of its elements. Removals are kept in a separate
+ * product so only Finalize needs a modular inverse. Two hashes of disjoint
+ * sets combine into the hash of their union with *=, so parts of a set can
+ * be hashed on different threads.
+ */
+class MuHash3072
+{
+private:
+    Num3072 numerator;
+    Num3072 denominator;
+
+    static Num3072 ToNum3072(const unsigned char* data, size_t len);
+
+public:
+    static const size_t OUTPUT_SIZE = 32;
+
+    //! The hash of the empty set
+    MuHash3072() {}
+    //! The hash of the set with one element
+    MuHash3072(const unsigned char* data, size_t len);
+
+    MuHash3072& Insert(const unsigned char* data, size_t len);
+    MuHash3072& Remove(const unsigned char* data, size_t len);
+
+    MuHash3072& operator*=(const MuHash3072& mul);
+    MuHash3072& operator/=(const MuHash3072& div);
+
+    //! SHA256 of the set's number. Leaves the hash as it was, divided out.
+    void Finalize(unsigned char hash[OUTPUT_SIZE]);
+};
+
+#endif // MYNTA_CRYPTO_MUHASH_H
@@ -0,0 +1,166 @@
+// Copyright (c) 2026 The Mynta Core Developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+//
+// Double SHA-256 of four 64-byte inputs at once, one input in each 32-bit
+// lane of an SSE register. SHA256D64() in sha256.cpp uses it for runs of
+// four or more inputs, such as the levels of a merkle tree.
+
+#include <stdint.h>
+#include <stddef.h>
+
+#if defined(__x86_64__) || defined(__amd64__)
+
+#include <immintrin.h>
+
+#include "crypto/common.h"
+
+#define SHA256_SSE41_TARGET __attribute__((target("sse4.1")))
+
+namespace sha256d64_sse41
+{
+namespace
+{
+
+const uint32_t K[64] = {
+    0x428a2f98, 0x71374491, 0xb5c0fbcf, 0xe9b5dba5, 0x3956c25b, 0x59f111f1, 0x923f82a4, 0xab1c5ed5,
+    0xd807aa98, 0x12835b01, 0x243185be, 0x550c7dc3, 0x72be5d74, 0x80deb1fe, 0x9bdc06a7, 0xc19bf174,
+    0xe49b69c1, 0xefbe4786, 0x0fc19dc6, 0x240ca1cc, 0x2de92c6f, 0x4a7484aa, 0x5cb0a9dc, 0x76f988da,
+    0x983e5152, 0xa831c66d, 0xb00327c8, 0xbf597fc7, 0xc6e00bf3, 0xd5a79147, 0x06ca6351, 0x14292967,
+    0x27b70a85, 0x2e1b2138, 0x4d2c6dfc, 0x53380d13, 0x650a7354, 0x766a0abb, 0x81c2c92e, 0x92722c85,
+    0xa2bfe8a1, 0xa81a664b, 0xc24b8b70, 0xc76c51a3, 0xd192e819, 0xd6990624, 0xf40e3585, 0x106aa070,
+    0x19a4c116, 0x1e376c08, 0x2748774c, 0x34b0bcb5, 0x391c0cb3, 0x4ed8aa4a, 0x5b9cca4f, 0x682e6ff3,
+    0x748f82ee, 0x78a5636f, 0x84c87814, 0x8cc70208, 0x90befffa, 0xa4506ceb, 0xbef9a3f7, 0xc67178f2,
+};
+
+//! K plus the message schedule of the padding block of a 64-byte message
+const uint32_t KW_PADDING[64] = {
+    0xc28a2f98, 0x71374491, 0xb5c0fbcf, 0xe9b5dba5, 0x3956c25b, 0x59f111f1, 0x923f82a4, 0xab1c5ed5,
+    0xd807aa98, 0x12835b01, 0x243185be, 0x550c7dc3, 0x72be5d74, 0x80deb1fe, 0x9bdc06a7, 0xc19bf374,
+    0x649b69c1, 0xf0fe4786, 0x0fe1edc6, 0x240cf254, 0x4fe9346f, 0x6cc984be, 0x61b9411e, 0x16f988fa,
+    0xf2c65152, 0xa88e5a6d, 0xb019fc65, 0xb9d99ec7, 0x9a1231c3, 0xe70eeaa0, 0xfdb1232b, 0xc7353eb0,
+    0x3069bad5, 0xcb976d5f, 0x5a0f118f, 0xdc1eeefd, 0x0a35b689, 0xde0b7a04, 0x58f4ca9d, 0xe15d5b16,
+    0x007f3e86, 0x37088980, 0xa507ea32, 0x6fab9537, 0x17406110, 0x0d8cd6f1, 0xcdaa3b6d, 0xc0bbbe37,
+    0x83613bda, 0xdb48a363, 0x0b02e931, 0x6fd15ca7, 0x521afaca, 0x31338431, 0x6ed41a95, 0x6d437890,
+    0xc39c91f2, 0x9eccabbd, 0xb5c9a0e6, 0x532fb63c, 0xd2c741c6, 0x07237ea3, 0xa4954b68, 0x4c191d76,
+};
+
+const uint32_t INIT[8] = {0x6a09e667ul, 0xbb67ae85ul, 0x3c6ef372ul, 0xa54ff53aul, 0x510e527ful, 0x9b05688cul, 0x1f83d9abul, 0x5be0cd19ul};
+
+SHA256_SSE41_TARGET inline __m128i K4(uint32_t x) { return _mm_set1_epi32(x); }
+SHA256_SSE41_TARGET inline __m128i Add(__m128i x, __m128i y) { return _mm_add_epi32(x, y); }
+SHA256_SSE41_TARGET inline __m128i Add(__m128i x, __m128i y, __m128i z) { return Add(Add(x, y), z); }
+SHA256_SSE41_TARGET inline __m128i Add(__m128i x, __m128i y, __m128i z, __m128i w) { return Add(Add(x, y), Add(z, w)); }
+SHA256_SSE41_TARGET inline __m128i Xor(__m128i x, __m128i y) { return _mm_xor_si128(x, y); }
+SHA256_SSE41_TARGET inline __m128i Xor(__m128i x, __m128i y, __m128i z) { return Xor(Xor(x, y), z); }
+SHA256_SSE41_TARGET inline __m128i Or(__m128i x, __m128i y) { return _mm_or_si128(x, y); }
+SHA256_SSE41_TARGET inline __m128i And(__m128i x, __m128i y) { return _mm_and_si128(x, y); }
+SHA256_SSE41_TARGET inline __m128i ShR(__m128i x, int n) { return _mm_srli_epi32(x, n); }
+SHA256_SSE41_TARGET inline __m128i ShL(__m128i x, int n) { return _mm_slli_epi32(x, n); }
+SHA256_SSE41_TARGET inline __m128i RotR(__m128i x, int n) { return Or(ShR(x, n), ShL(x, 32 - n)); }
+
+SHA256_SSE41_TARGET inline __m128i Ch(__m128i x, __m128i y, __m128i z) { return Xor(z, And(x, Xor(y, z))); }
+SHA256_SSE41_TARGET inline __m128i Maj(__m128i x, __m128i y, __m128i z) { return Or(And(x, y), And(z, Or(x, y))); }
+SHA256_SSE41_TARGET inline __m128i Sigma0(__m128i x) { return Xor(RotR(x, 2), RotR(x, 13), RotR(x, 22)); }
+SHA256_SSE41_TARGET inline __m128i Sigma1(__m128i x) { return Xor(RotR(x, 6), RotR(x, 11), RotR(x, 25)); }
+SHA256_SSE41_TARGET inline __m128i sigma0(__m128i x) { return Xor(RotR(x, 7), RotR(x, 18), ShR(x, 3)); }
+SHA256_SSE41_TARGET inline __m128i sigma1(__m128i x) { return Xor(RotR(x, 17), RotR(x, 19), ShR(x, 10)); }
+
+/** One round of SHA-256; kw is the round constant plus the message word */
+SHA256_SSE41_TARGET inline void Round(__m128i a, __m128i b, __m128i c, __m128i& d, __m128i e, __m128i f, __m128i g, __m128i& h, __m128i kw)
+{
+    const __m128i t1 = Add(h, Sigma1(e), Ch(e, f, g), kw);
+    const __m128i t2 = Add(Sigma0(a), Maj(a, b, c));
+    d = Add(d, t1);
+    h = Add(t1, t2);
+}
+
+/** Message word i, expanding the schedule in place once past the first sixteen */
+SHA256_SSE41_TARGET inline __m128i Word(__m128i* w, int i)
+{
+    if (i >= 16)
+        w[i & 15] = Add(w[i & 15], sigma1(w[(i - 2) & 15]), w[(i - 7) & 15], sigma0(w[(i - 15) & 15]));
+    return w[i & 15];
+}
+
+/** 64 rounds over s, with the message words in w or, when w is null, the padding block */
+SHA256_SSE41_TARGET void Rounds(__m128i* s, __m128i* w)
+{
+    __m128i a = s[0], b = s[1], c = s[2], d = s[3], e = s[4], f = s[5], g = s[6], h = s[7];
+    for (int i = 0; i < 64; i += 8) {
+        if (w) {
+            Round(a, b, c, d, e, f, g, h, Add(K4(K[i + 0]), Word(w, i + 0)));
+            Round(h, a, b, c, d, e, f, g, Add(K4(K[i + 1]), Word(w, i + 1)));
+            Round(g, h, a, b, c, d, e, f, Add(K4(K[i + 2]), Word(w, i + 2)));
+            Round(f, g, h, a, b, c, d, e, Add(K4(K[i + 3]), Word(w, i + 3)));
+            Round(e, f, g, h, a, b, c, d, Add(K4(K[i + 4]), Word(w, i + 4)));
+            Round(d, e, f, g, h, a, b, c, Add(K4(K[i + 5]), Word(w, i + 5)));
+            Round(c, d, e, f, g, h, a, b, Add(K4(K[i + 6]), Word(w, i + 6)));
+            Round(b, c, d, e, f, g, h, a, Add(K4(K[i + 7]), Word(w, i + 7)));
+        } else {
+            Round(a, b, c, d, e, f, g, h, K4(KW_PADDING[i + 0]));
+            Round(h, a, b, c, d, e, f, g, K4(KW_PADDING[i + 1]));
+            Round(g, h, a, b, c, d, e, f, K4(KW_PADDING[i + 2]));
+            Round(f, g, h, a, b, c, d, e, K4(KW_PADDING[i + 3]));
+            Round(e, f, g, h, a, b, c, d, K4(KW_PADDING[i + 4]));
+            Round(d, e, f, g, h, a, b, c, K4(KW_PADDING[i + 5]));
+            Round(c, d, e, f, g, h, a, b, K4(KW_PADDING[i + 6]));
+            Round(b, c, d, e, f, g, h, a, K4(KW_PADDING[i + 7]));
+        }
+    }
+    s[0] = Add(s[0], a);
+    s[1] = Add(s[1], b);
+    s[2] = Add(s[2], c);
+    s[3] = Add(s[3], d);
+    s[4] = Add(s[4], e);
+    s[5] = Add(s[5], f);
+    s[6] = Add(s[6], g);
+    s[7] = Add(s[7], h);
+}
+
+/** Big endian word at offset of each of the four inputs */
+SHA256_SSE41_TARGET inline __m128i Read4(const unsigned char* in, int offset)
+{
+    return _mm_set_epi32(ReadBE32(in + 192 + offset), ReadBE32(in + 128 + offset), ReadBE32(in + 64 + offset), ReadBE32(in + offset));
+}
+
+SHA256_SSE41_TARGET inline void Write4(unsigned char* out, int offset, __m128i v)
+{
+    WriteBE32(out + offset, _mm_extract_epi32(v, 0));
+    WriteBE32(out + 32 + offset, _mm_extract_epi32(v, 1));
+    WriteBE32(out + 64 + offset, _mm_extract_epi32(v, 2));
+    WriteBE32(out + 96 + offset, _mm_extract_epi32(v, 3));
+}
+
+} // namespace
+
+SHA256_SSE41_TARGET void Transform_4way(unsigned char* out, const unsigned char* in)
+{
+    __m128i s[8], w[16];
+
+    // The input block, then the padding of a 64-byte message
+    for (int i = 0; i < 8; i++)
+        s[i] = K4(INIT[i]);
+    for (int i = 0; i < 16; i++)
+        w[i] = Read4(in, 4 * i);
+    Rounds(s, w);
+    Rounds(s, nullptr);
+
+    // The 32-byte first hash, padded, hashed again
+    for (int i = 0; i < 8; i++) {
+        w[i] = s[i];
+        s[i] = K4(INIT[i]);
+    }
+    w[8] = K4(0x80000000ul);
+    for (int i = 9; i < 15; i++)
+        w[i] = K4(0);
+    w[15] = K4(0x100);
+    Rounds(s, w);
+
+    for (int i = 0; i < 8; i++)
+        Write4(out, 4 * i, s[i]);
+}
+
+} // namespace sha256d64_sse41
+
+#endif
@@ -0,0 +1,499 @@
+// Copyright (c) 2026 The Mynta Core Developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+//
+// AES-NI implementations of the Groestl-512, SHAvite-512 and ECHO-512 stages
+// of X16R/X16RV2. Each function hashes a whole message in one call and gives
+// exactly the same output as the sph_* code in src/algo; X16RAutoDetect() in
+// hash.cpp checks that before switching to them.
+
+#include <stdint.h>
+#include <stddef.h>
+#include <string.h>
+
+#if defined(__x86_64__) || defined(__amd64__)
+
+#include <immintrin.h>
+
+#define X16R_AESNI_TARGET __attribute__((target("aes,ssse3")))
+
+namespace x16r_aesni
+{
+namespace
+{
+
+/** Multiply every byte by 2 in GF(2^8) modulo the AES polynomial */
+X16R_AESNI_TARGET inline __m128i XTime(__m128i x)
+{
+    __m128i carry = _mm_cmpgt_epi8(_mm_setzero_si128(), x);
+    return _mm_xor_si128(_mm_add_epi8(x, x), _mm_and_si128(carry, _mm_set1_epi8(0x1b)));
+}
+
+// ============================================================================
+// Groestl-512
+//
+// The 8x16 byte state is kept as one __m128i per row, so every step works on
+// all 16 columns at once. SubBytes comes from AESENCLAST with a zero key after
+// a shuffle that undoes its ShiftRows; ShiftBytes is folded into the same
+// shuffle.
+// ============================================================================
+
+static const int GROESTL_ROUNDS = 14;
+static const int GROESTL_SHIFT_P[8] = {0, 1, 2, 3, 4, 5, 6, 11};
+static const int GROESTL_SHIFT_Q[8] = {1, 3, 5, 11, 0, 2, 4, 6};
+
+/** Inverse of AES ShiftRows on a 16-byte block */
+static const int AES_INV_SHIFT_ROWS[16] = {0, 13, 10, 7, 4, 1, 14, 11, 8, 5, 2, 15, 12, 9, 6, 3};
+
+struct GroestlShuffles {
+    __m128i p[8];
+    __m128i q[8];
+};
+
+X16R_AESNI_TARGET __m128i MakeGroestlShuffle(int shift)
+{
+    alignas(16) unsigned char mask[16];
+    for (int d = 0; d < 16; d++) {
+        mask[d] = (AES_INV_SHIFT_ROWS[d] + shift) & 15;
+    }
+    return _mm_load_si128((const __m128i*)mask);
+}
+
+X16R_AESNI_TARGET const GroestlShuffles& GetGroestlShuffles()
+{
+    static const GroestlShuffles shuffles = [] {
+        GroestlShuffles s;
+        for (int i = 0; i < 8; i++) {
+            s.p[i] = MakeGroestlShuffle(GROESTL_SHIFT_P[i]);
+            s.q[i] = MakeGroestlShuffle(GROESTL_SHIFT_Q[i]);
+        }
+        return s;
+    }();
+    return shuffles;
+}
+
+/** Load a 128-byte column-major block into row vectors */
+X16R_AESNI_TARGET inline void GroestlLoadRows(__m128i rows[8], const unsigned char* block)
+{
+    alignas(16) unsigned char t[8][16];
+    for (int j = 0; j < 16; j++) {
+        for (int i = 0; i < 8; i++) {
+            t[i][j] = block[8 * j + i];
+        }
+    }
+    for (int i = 0; i < 8; i++) {
+        rows[i] = _mm_load_si128((const __m128i*)t[i]);
+    }
+}
+
+X16R_AESNI_TARGET inline void GroestlStoreRows(unsigned char* block, const __m128i rows[8])
+{
+    alignas(16) unsigned char t[8][16];
+    for (int i = 0; i < 8; i++) {
+        _mm_store_si128((__m128i*)t[i], rows[i]);
+    }
+    for (int j = 0; j < 16; j++) {
+        for (int i = 0; i < 8; i++) {
+            block[8 * j + i] = t[i][j];
+        }
+    }
+}
+
+/**
+ * MixBytes with the circulant matrix (02 02 03 04 05 03 05 07). With
+ * s_i = a_i ^ a_{i+1} the output row is
+ *   b_i = (a_{i+2} ^ s_{i+4} ^ s_{i+6})
+ *       ^ 2 * (s_i ^ a_{i+2} ^ a_{i+5} ^ a_{i+7} ^ 2 * (s_{i+3} ^ s_{i+6}))
+ */
+template <int i>
+X16R_AESNI_TARGET inline __m128i GroestlMixRow(const __m128i a[8], const __m128i s[8])
+{
+    __m128i x1 = _mm_xor_si128(a[(i + 2) & 7], _mm_xor_si128(s[(i + 4) & 7], s[(i + 6) & 7]));
+    __m128i x2 = _mm_xor_si128(_mm_xor_si128(s[i], a[(i + 2) & 7]), _mm_xor_si128(a[(i + 5) & 7], a[(i + 7) & 7]));
+    __m128i x4 = _mm_xor_si128(s[(i + 3) & 7], s[(i + 6) & 7]);
+    return _mm_xor_si128(x1, XTime(_mm_xor_si128(x2, XTime(x4))));
+}
+
+X16R_AESNI_TARGET inline void GroestlMixBytes(__m128i a[8])
+{
+    // Written out per row so that every index is a constant and the whole
+    // state stays in registers
+    __m128i s[8];
+    s[0] = _mm_xor_si128(a[0], a[1]);
+    s[1] = _mm_xor_si128(a[1], a[2]);
+    s[2] = _mm_xor_si128(a[2], a[3]);
+    s[3] = _mm_xor_si128(a[3], a[4]);
+    s[4] = _mm_xor_si128(a[4], a[5]);
+    s[5] = _mm_xor_si128(a[5], a[6]);
+    s[6] = _mm_xor_si128(a[6], a[7]);
+    s[7] = _mm_xor_si128(a[7], a[0]);
+    __m128i b0 = GroestlMixRow<0>(a, s);
+    __m128i b1 = GroestlMixRow<1>(a, s);
+    __m128i b2 = GroestlMixRow<2>(a, s);
+    __m128i b3 = GroestlMixRow<3>(a, s);
+    __m128i b4 = GroestlMixRow<4>(a, s);
+    __m128i b5 = GroestlMixRow<5>(a, s);
+    __m128i b6 = GroestlMixRow<6>(a, s);
+    __m128i b7 = GroestlMixRow<7>(a, s);
+    a[0] = b0;
+    a[1] = b1;
+    a[2] = b2;
+    a[3] = b3;
+    a[4] = b4;
+    a[5] = b5;
+    a[6] = b6;
+    a[7] = b7;
+}
+
+/** One round of P (fQ = false) or Q (fQ = true) */
+X16R_AESNI_TARGET inline void GroestlRound(__m128i a[8], const __m128i shuffle[8], bool fQ, int r)
+{
+    const __m128i zero = _mm_setzero_si128();
+    if (fQ) {
+        const __m128i ones = _mm_set1_epi8((char)0xff);
+        const __m128i columns = _mm_set_epi8(0x0f, 0x1f, 0x2f, 0x3f, 0x4f, 0x5f, 0x6f, 0x7f,
+                                             (char)0x8f, (char)0x9f, (char)0xaf, (char)0xbf, (char)0xcf, (char)0xdf, (char)0xef, (char)0xff);
+        for (int i = 0; i < 7; i++) {
+            a[i] = _mm_xor_si128(a[i], ones);
+        }
+        a[7] = _mm_xor_si128(a[7], _mm_xor_si128(columns, _mm_set1_epi8((char)r)));
+    } else {
+        const __m128i columns = _mm_set_epi8((char)0xf0, (char)0xe0, (char)0xd0, (char)0xc0, (char)0xb0, (char)0xa0, (char)0x90, (char)0x80,
+                                             0x70, 0x60, 0x50, 0x40, 0x30, 0x20, 0x10, 0x00);
+        a[0] = _mm_xor_si128(a[0], _mm_xor_si128(columns, _mm_set1_epi8((char)r)));
+    }
+    a[0] = _mm_aesenclast_si128(_mm_shuffle_epi8(a[0], shuffle[0]), zero);
+    a[1] = _mm_aesenclast_si128(_mm_shuffle_epi8(a[1], shuffle[1]), zero);
+    a[2] = _mm_aesenclast_si128(_mm_shuffle_epi8(a[2], shuffle[2]), zero);
+    a[3] = _mm_aesenclast_si128(_mm_shuffle_epi8(a[3], shuffle[3]), zero);
+    a[4] = _mm_aesenclast_si128(_mm_shuffle_epi8(a[4], shuffle[4]), zero);
+    a[5] = _mm_aesenclast_si128(_mm_shuffle_epi8(a[5], shuffle[5]), zero);
+    a[6] = _mm_aesenclast_si128(_mm_shuffle_epi8(a[6], shuffle[6]), zero);
+    a[7] = _mm_aesenclast_si128(_mm_shuffle_epi8(a[7], shuffle[7]), zero);
+    GroestlMixBytes(a);
+}
+
+X16R_AESNI_TARGET void GroestlP(__m128i a[8])
+{
+    const GroestlShuffles& shuffles = GetGroestlShuffles();
+    for (int r = 0; r < GROESTL_ROUNDS; r++) {
+        GroestlRound(a, shuffles.p, false, r);
+    }
+}
+
+/** h = P(h ^ m) ^ Q(m) ^ h */
+X16R_AESNI_TARGET void GroestlCompress(__m128i h[8], const unsigned char* block)
+{
+    __m128i m[8], p[8];
+    GroestlLoadRows(m, block);
+    for (int i = 0; i < 8; i++) {
+        p[i] = _mm_xor_si128(h[i], m[i]);
+    }
+    // P and Q are independent, so run their rounds interleaved
+    const GroestlShuffles& shuffles = GetGroestlShuffles();
+    for (int r = 0; r < GROESTL_ROUNDS; r++) {
+        GroestlRound(p, shuffles.p, false, r);
+        GroestlRound(m, shuffles.q, true, r);
+    }
+    for (int i = 0; i < 8; i++) {
+        h[i] = _mm_xor_si128(h[i], _mm_xor_si128(p[i], m[i]));
+    }
+}
+
+// ============================================================================
+// SHAvite-512
+// ============================================================================
+
+static const uint32_t SHAVITE_IV512[16] = {
+    0x72FCCDD8, 0x79CA4727, 0x128A077B, 0x40D55AEC,
+    0xD1901A06, 0x430AE307, 0xB29F5CD1, 0xDF07FBFC,
+    0x8E45D73D, 0x681AB538, 0xBDE86578, 0xDD577E47,
+    0xE275EADE, 0x502D9FCD, 0xB9357178, 0x022A4B9A
+};
+
+X16R_AESNI_TARGET void ShaviteCompress(__m128i h[4], const unsigned char* block, const uint32_t count[4])
+{
+    const __m128i zero = _mm_setzero_si128();
+    __m128i rk[112];
+    for (int j = 0; j < 8; j++) {
+        rk[j] = _mm_loadu_si128((const __m128i*)(block + 16 * j));
+    }
+
+    // Message expansion; j indexes 128-bit words (sph's u / 4)
+    int j = 8;
+    for (;;) {
+        for (int s = 0; s < 4; s++) {
+            for (int half = 0; half < 2; half++) {
+                __m128i x = _mm_shuffle_epi32(rk[j - 8], _MM_SHUFFLE(0, 3, 2, 1));
+                x = _mm_aesenc_si128(x, zero);
+                rk[j] = _mm_xor_si128(x, rk[j - 1]);
+                if (j == 8) {
+                    rk[j] = _mm_xor_si128(rk[j], _mm_set_epi32(~count[3], count[2], count[1], count[0]));
+                } else if (j == 41) {
+                    rk[j] = _mm_xor_si128(rk[j], _mm_set_epi32(~count[0], count[1], count[2], count[3]));
+                } else if (j == 79) {
+                    rk[j] = _mm_xor_si128(rk[j], _mm_set_epi32(~count[1], count[0], count[3], count[2]));
+                } else if (j == 110) {
+                    rk[j] = _mm_xor_si128(rk[j], _mm_set_epi32(~count[2], count[3], count[0], count[1]));
+                }
+                j++;
+            }
+        }
+        if (j == 112) {
+            break;
+        }
+        for (int s = 0; s < 8; s++) {
+            rk[j] = _mm_xor_si128(rk[j - 8], _mm_alignr_epi8(rk[j - 1], rk[j - 2], 4));
+            j++;
+        }
+    }
+
+    __m128i p0 = h[0], p1 = h[1], p2 = h[2], p3 = h[3];
+    j = 0;
+    for (int r = 0; r < 14; r++) {
+        __m128i x = _mm_xor_si128(p1, rk[j++]);
+        x = _mm_aesenc_si128(x, zero);
+        x = _mm_aesenc_si128(_mm_xor_si128(x, rk[j++]), zero);
+        x = _mm_aesenc_si128(_mm_xor_si128(x, rk[j++]), zero);
+        x = _mm_aesenc_si128(_mm_xor_si128(x, rk[j++]), zero);
+        p0 = _mm_xor_si128(p0, x);
+
+        x = _mm_xor_si128(p3, rk[j++]);
+        x = _mm_aesenc_si128(x, zero);
+        x = _mm_aesenc_si128(_mm_xor_si128(x, rk[j++]), zero);
+        x = _mm_aesenc_si128(_mm_xor_si128(x, rk[j++]), zero);
+        x = _mm_aesenc_si128(_mm_xor_si128(x, rk[j++]), zero);
+        p2 = _mm_xor_si128(p2, x);
+
+        __m128i t = p3;
+        p3 = p2;
+        p2 = p1;
+        p1 = p0;
+        p0 = t;
+    }
+    h[0] = _mm_xor_si128(h[0], p0);
+    h[1] = _mm_xor_si128(h[1], p1);
+    h[2] = _mm_xor_si128(h[2], p2);
+    h[3] = _mm_xor_si128(h[3], p3);
+}
+
+// ============================================================================
+// ECHO-512
+// ============================================================================
+
+X16R_AESNI_TARGET inline void EchoMixColumn(__m128i& a, __m128i& b, __m128i& c, __m128i& d)
+{
+    __m128i ab = _mm_xor_si128(a, b);
+    __m128i bc = _mm_xor_si128(b, c);
+    __m128i cd = _mm_xor_si128(c, d);
+    __m128i abx = XTime(ab);
+    __m128i bcx = XTime(bc);
+    __m128i cdx = XTime(cd);
+    __m128i na = _mm_xor_si128(_mm_xor_si128(abx, bc), d);
+    __m128i nb = _mm_xor_si128(_mm_xor_si128(bcx, a), cd);
+    __m128i nc = _mm_xor_si128(_mm_xor_si128(cdx, ab), d);
+    __m128i nd = _mm_xor_si128(_mm_xor_si128(_mm_xor_si128(abx, bcx), _mm_xor_si128(cdx, ab)), c);
+    a = na;
+    b = nb;
+    c = nc;
+    d = nd;
+}
+
+/** One ECHO-512 compression; (k0, k1) is the 128-bit salt counter for this block */
+X16R_AESNI_TARGET void EchoCompress(__m128i v[8], const unsigned char* block, uint64_t k0, uint64_t k1)
+{
+    const __m128i zero = _mm_setzero_si128();
+    __m128i w[16];
+    for (int i = 0; i < 8; i++) {
+        w[i] = v[i];
+        w[i + 8] = _mm_loadu_si128((const __m128i*)(block + 16 * i));
+    }
+
+    for (int r = 0; r < 10; r++) {
+        // BIG.SubWords
+        for (int i = 0; i < 16; i++) {
+            __m128i k = _mm_set_epi64x((int64_t)k1, (int64_t)k0);
+            w[i] = _mm_aesenc_si128(_mm_aesenc_si128(w[i], k), zero);
+            if (++k0 == 0) {
+                ++k1;
+            }
+        }
+
+        // BIG.ShiftRows
+        __m128i t = w[1];
+        w[1] = w[5];
+        w[5] = w[9];
+        w[9] = w[13];
+        w[13] = t;
+        t = w[2];
+        w[2] = w[10];
+        w[10] = t;
+        t = w[6];
+        w[6] = w[14];
+        w[14] = t;
+        t = w[15];
+        w[15] = w[11];
+        w[11] = w[7];
+        w[7] = w[3];
+        w[3] = t;
+
+        // BIG.MixColumns
+        for (int c = 0; c < 16; c += 4) {
+            EchoMixColumn(w[c], w[c + 1], w[c + 2], w[c + 3]);
+        }
+    }
+
+    for (int i = 0; i < 8; i++) {
+        __m128i m = _mm_loadu_si128((const __m128i*)(block + 16 * i));
+        v[i] = _mm_xor_si128(v[i], _mm_xor_si128(m, _mm_xor_si128(w[i], w[i + 8])));
+    }
+}
+
+} // namespace
+
+X16R_AESNI_TARGET void Groestl512(const void* data, size_t len, void* out)
+{
+    const unsigned char* p = (const unsigned char*)data;
+    __m128i h[8];
+    for (int i = 0; i < 8; i++) {
+        h[i] = _mm_setzero_si128();
+    }
+    // IV: the output size (512) in the last bytes of the state, i.e. row 6, column 15
+    h[6] = _mm_insert_epi16(h[6], 0x0200, 7);
+
+    uint64_t count = 0;
+    while (len >= 128) {
+        GroestlCompress(h, p);
+        p += 128;
+        len -= 128;
+        count++;
+    }
+
+    unsigned char buf[256];
+    memset(buf, 0, sizeof(buf));
+    memcpy(buf, p, len);
+    buf[len] = 0x80;
+    size_t padLen = len < 120 ? 128 : 256;
+    count += padLen / 128;
+    for (int i = 0; i < 8; i++) {
+        buf[padLen - 1 - i] = (unsigned char)(count >> (8 * i));
+    }
+    for (size_t off = 0; off < padLen; off += 128) {
+        GroestlCompress(h, buf + off);
+    }
+
+    // Output transformation: trunc512(P(h) ^ h)
+    __m128i x[8];
+    for (int i = 0; i < 8; i++) {
+        x[i] = h[i];
+    }
+    GroestlP(x);
+    for (int i = 0; i < 8; i++) {
+        x[i] = _mm_xor_si128(x[i], h[i]);
+    }
+    GroestlStoreRows(buf, x);
+    memcpy(out, buf + 64, 64);
+}
+
+X16R_AESNI_TARGET void Shavite512(const void* data, size_t len, void* out)
+{
+    const unsigned char* p = (const unsigned char*)data;
+    __m128i h[4];
+    for (int i = 0; i < 4; i++) {
+        h[i] = _mm_loadu_si128((const __m128i*)(SHAVITE_IV512 + 4 * i));
+    }
+
+    uint32_t count[4] = {0, 0, 0, 0};
+    while (len >= 128) {
+        if ((count[0] += 1024) == 0 && ++count[1] == 0 && ++count[2] == 0) {
+            ++count[3];
+        }
+        ShaviteCompress(h, p, count);
+        p += 128;
+        len -= 128;
+    }
+
+    // Like sph, the final bit count only carries within its low word
+    count[0] += (uint32_t)(len << 3);
+    const uint32_t encoded[4] = {count[0], count[1], count[2], count[3]};
+    unsigned char buf[128];
+    memset(buf, 0, sizeof(buf));
+    memcpy(buf, p, len);
+    buf[len] = 0x80;
+    if (len == 0) {
+        memset(count, 0, sizeof(count));
+    } else if (len >= 110) {
+        ShaviteCompress(h, buf, count);
+        memset(buf, 0, 110);
+        memset(count, 0, sizeof(count));
+    }
+    for (int i = 0; i < 4; i++) {
+        buf[110 + 4 * i + 0] = (unsigned char)(encoded[i]);
+        buf[110 + 4 * i + 1] = (unsigned char)(encoded[i] >> 8);
+        buf[110 + 4 * i + 2] = (unsigned char)(encoded[i] >> 16);
+        buf[110 + 4 * i + 3] = (unsigned char)(encoded[i] >> 24);
+    }
+    // Output size in bits (512), 16-bit little-endian
+    buf[126] = 0x00;
+    buf[127] = 0x02;
+    ShaviteCompress(h, buf, count);
+
+    for (int i = 0; i < 4; i++) {
+        _mm_storeu_si128((__m128i*)((unsigned char*)out + 16 * i), h[i]);
+    }
+}
+
+X16R_AESNI_TARGET void Echo512(const void* data, size_t len, void* out)
+{
+    const unsigned char* p = (const unsigned char*)data;
+    __m128i v[8];
+    for (int i = 0; i < 8; i++) {
+        v[i] = _mm_set_epi64x(0, 512);
+    }
+
+    uint64_t c0 = 0, c1 = 0;
+    while (len >= 128) {
+        c0 += 1024;
+        if (c0 < 1024) {
+            c1++;
+        }
+        EchoCompress(v, p, c0, c1);
+        p += 128;
+        len -= 128;
+    }
+
+    uint64_t elen = (uint64_t)len << 3;
+    c0 += elen;
+    if (c0 < elen) {
+        c1++;
+    }
+    // A final block holding only padding is compressed with a zero counter,
+    // but the total bit count is still appended
+    uint64_t k0 = elen ? c0 : 0;
+    uint64_t k1 = elen ? c1 : 0;
+
+    unsigned char buf[128];
+    memset(buf, 0, sizeof(buf));
+    memcpy(buf, p, len);
+    buf[len] = 0x80;
+    if (len + 1 > 110) {
+        EchoCompress(v, buf, k0, k1);
+        k0 = k1 = 0;
+        memset(buf, 0, sizeof(buf));
+    }
+    buf[110] = 0x00;
+    buf[111] = 0x02;
+    for (int i = 0; i < 8; i++) {
+        buf[112 + i] = (unsigned char)(c0 >> (8 * i));
+        buf[120 + i] = (unsigned char)(c1 >> (8 * i));
+    }
+    EchoCompress(v, buf, k0, k1);
+
+    for (int i = 0; i < 4; i++) {
+        _mm_storeu_si128((__m128i*)((unsigned char*)out + 16 * i), v[i]);
+    }
+}
+
+} // namespace x16r_aesni
+
+#endif
@@ -15,6 +15,7 @@
 #include <memenv.h>
 #include <stdint.h>
 #include <algorithm>
+#include <sstream>
 
 class CMyntaLevelDBLogger : public leveldb::Logger {
 public:
@@ -99,13 +100,77 @@ static void SetMaxOpenFiles(leveldb::Options *options) {
              options->max_open_files, default_open_files);
 }
 
-static leveldb::Options GetOptions(size_t nCacheSize, size_t maxFileSize)
+bool GetDBProfile(const std::string& strName, CDBProfile& profile, std::string& strError)
+{
+    profile = CDBProfile();
+    if (strName == "index") {
+        // The block index holds the address, timestamp and spent indexes, which
+        // grow to hundreds of gigabytes and are read in key ranges
+        profile.fCompress = true;
+        profile.nBlockSize = 16 << 10;
+    } else if (strName == "assetsnapshot") {
+        // Snapshots are written once and walked from start to end
+        profile.nBlockSize = 64 << 10;
+    }
+
+    for (const std::string& strArg : gArgs.GetArgs("-dbprofile")) {
+        const size_t nColon = strArg.find(':');
+        if (nColon == 0 || nColon == std::string::npos) {
+            strError = strprintf(_("Invalid -dbprofile '%s': expected <database>:<setting>=<value>,..."), strArg);
+            return false;
+        }
+        CDBProfile changed = profile;
+        std::stringstream ssSettings(strArg.substr(nColon + 1));
+        std::string strSetting;
+        while (std::getline(ssSettings, strSetting, ',')) {
+            const size_t nEquals = strSetting.find('=');
+            const std::string strKey = strSetting.substr(0, nEquals);
+            int64_t nValue;
+            if (nEquals == std::string::npos || !ParseInt64(strSetting.substr(nEquals + 1), &nValue)) {
+                strError = strprintf(_("Invalid -dbprofile setting '%s'"), strSetting);
+                return false;
+            }
+            if (strKey == "compress" && (nValue == 0 || nValue == 1)) {
+                changed.fCompress = nValue;
+            } else if (strKey == "blocksize" && nValue >= 1024 && nValue <= (4 << 20)) {
+                changed.nBlockSize = nValue;
+            } else if (strKey == "bloombits" && nValue >= 0 && nValue <= 32) {
+                changed.nBloomBits = nValue;
+            } else {
+                strError = strprintf(_("Invalid -dbprofile setting '%s'"), strSetting);
+                return false;
+            }
+        }
+        if (strArg.compare(0, nColon, strName) == 0)
+            profile = changed;
+    }
+    return true;
+}
+
+static std::mutex csSharedBlockCache;
+static std::shared_ptr<leveldb::Cache> sharedBlockCacheNext;
+
+void SetSharedDBBlockCache(size_t nSize)
+{
+    std::lock_guard<std::mutex> lock(csSharedBlockCache);
+    // Databases already open keep the old cache alive until they close
+    sharedBlockCacheNext.reset(nSize ? leveldb::NewLRUCache(nSize) : nullptr);
+}
+
+size_t GetSharedDBBlockCacheUsage()
+{
+    std::lock_guard<std::mutex> lock(csSharedBlockCache);
+    return sharedBlockCacheNext ? sharedBlockCacheNext->TotalCharge() : 0;
+}
+
+static leveldb::Options GetOptions(size_t nCacheSize, size_t maxFileSize, const CDBProfile& profile, leveldb::Cache* pSharedBlockCache)
 {
     leveldb::Options options;
-    options.block_cache = leveldb::NewLRUCache(nCacheSize / 2);
+    options.block_cache = pSharedBlockCache ? pSharedBlockCache : leveldb::NewLRUCache(nCacheSize / 2);
     options.write_buffer_size = nCacheSize / 4; // up to two write buffers may be held in memory simultaneously
-    options.filter_policy = leveldb::NewBloomFilterPolicy(10);
-    options.compression = leveldb::kNoCompression;
+    options.filter_policy = profile.nBloomBits ? leveldb::NewBloomFilterPolicy(profile.nBloomBits) : nullptr;
+    options.compression = profile.fCompress ? leveldb::kSnappyCompression : leveldb::kNoCompression;
+    options.block_size = profile.nBlockSize;
     options.info_log = new CMyntaLevelDBLogger();
     options.max_file_size = maxFileSize;
     if (leveldb::kMajorVersion > 1 || (leveldb::kMajorVersion == 1 && leveldb::kMinorVersion >= 16)) {
@@ -124,7 +189,17 @@ CDBWrapper::CDBWrapper(const fs::path& path, size_t nCacheSize, bool fMemory, bo
     iteroptions.verify_checksums = true;
     iteroptions.fill_cache = false;
     syncoptions.sync = true;
-    options = GetOptions(nCacheSize, maxFileSize);
+    CDBProfile profile;
+    std::string strError;
+    if (!GetDBProfile(path.filename().string(), profile, strError))
+        throw dbwrapper_error(strError);
+    LogPrint(BCLog::LEVELDB, "LevelDB tables for %s: compress=%d blocksize=%u bloombits=%d\n",
+             path.string(), profile.fCompress, profile.nBlockSize, profile.nBloomBits);
+    {
+        std::lock_guard<std::mutex> lock(csSharedBlockCache);
+        sharedBlockCache = sharedBlockCacheNext;
+    }
+    options = GetOptions(nCacheSize, maxFileSize, profile, sharedBlockCache.get());
     options.create_if_missing = true;
     if (fMemory) {
         penv = leveldb::NewMemEnv(leveldb::Env::Default());
@@ -165,6 +240,7 @@ CDBWrapper::CDBWrapper(const fs::path& path, size_t nCacheSize, bool fMemory, bo
         LogPrintf("Wrote new obfuscate key for %s: %s\n", path.string(), HexStr(obfuscate_key));
     }
 
+    fObfuscated = std::any_of(obfuscate_key.begin(), obfuscate_key.end(), [](unsigned char c) { return c != 0; });
     LogPrintf("Using obfuscation key for %s: %s\n", path.string(), HexStr(obfuscate_key));
 }
 
@@ -176,19 +252,94 @@ CDBWrapper::~CDBWrapper()
     options.filter_policy = nullptr;
     delete options.info_log;
     options.info_log = nullptr;
-    delete options.block_cache;
+    if (!sharedBlockCache)
+        delete options.block_cache;
     options.block_cache = nullptr;
     delete penv;
     options.env = nullptr;
 }
 
+namespace {
+/** Replays the operations of one leveldb batch into another, recording the value each key ends up with */
+class CBatchAppender : public leveldb::WriteBatch::Handler
+{
+    leveldb::WriteBatch& dest;
+    std::map<std::string, std::pair<bool, std::string> >& mapValues;
+
+public:
+    CBatchAppender(leveldb::WriteBatch& destIn, std::map<std::string, std::pair<bool, std::string> >& mapValuesIn) : dest(destIn), mapValues(mapValuesIn) {}
+
+    void Put(const leveldb::Slice& key, const leveldb::Slice& value) override
+    {
+        dest.Put(key, value);
+        mapValues[key.ToString()] = std::make_pair(true, value.ToString());
+    }
+
+    void Delete(const leveldb::Slice& key) override
+    {
+        dest.Delete(key);
+        mapValues[key.ToString()] = std::make_pair(false, std::string());
+    }
+};
+} // namespace
+
 bool CDBWrapper::WriteBatch(CDBBatch& batch, bool fSync)
 {
+    {
+        std::lock_guard<std::mutex> lock(cs_deferred);
+        if (pdeferred) {
+            CBatchAppender appender(pdeferred->batch, mapDeferred);
+            dbwrapper_private::HandleError(batch.batch.Iterate(&appender));
+            pdeferred->size_estimate += batch.size_estimate;
+            return true;
+        }
+    }
     leveldb::Status status = pdb->Write(fSync ? syncoptions : writeoptions, &batch.batch);
     dbwrapper_private::HandleError(status);
     return true;
 }
 
+void CDBWrapper::BeginDeferred()
+{
+    std::lock_guard<std::mutex> lock(cs_deferred);
+    assert(!pdeferred);
+    pdeferred.reset(new CDBBatch(*this));
+    fDeferring = true;
+}
+
+bool CDBWrapper::CommitDeferred(bool fSync)
+{
+    // Keep answering reads from the queue until the database has the changes
+    std::lock_guard<std::mutex> lock(cs_deferred);
+    if (!pdeferred)
+        return true;
+    leveldb::Status status = pdb->Write(fSync ? syncoptions : writeoptions, &pdeferred->batch);
+    pdeferred.reset();
+    mapDeferred.clear();
+    fDeferring = false;
+    dbwrapper_private::HandleError(status);
+    return true;
+}
+
+void CDBWrapper::DiscardDeferred()
+{
+    std::lock_guard<std::mutex> lock(cs_deferred);
+    pdeferred.reset();
+    mapDeferred.clear();
+    fDeferring = false;
+}
+
+bool CDBWrapper::ReadDeferred(const leveldb::Slice& key, bool& fExists, std::string& strValue) const
+{
+    std::lock_guard<std::mutex> lock(cs_deferred);
+    auto it = mapDeferred.find(key.ToString());
+    if (it == mapDeferred.end())
+        return false;
+    fExists = it->second.first;
+    strValue = it->second.second;
+    return true;
+}
+
 // Prefixed with null character to avoid collisions with other keys
 //
 // We must use a string constructor which specifies length so that we copy
@@ -197,6 +348,8 @@ const std::string CDBWrapper::OBFUSCATE_KEY_KEY("\000obfuscate_key", 14);
 
 const unsigned int CDBWrapper::OBFUSCATE_KEY_NUM_BYTES = 8;
 
+const std::string CDBWrapper::FLUSH_MARKER_KEY("\000flush_marker", 13);
+
 /**
  * Returns a string (consisting of 8 random bytes) suitable for use as an
  * obfuscating XOR key.
@@ -221,6 +374,24 @@ bool CDBIterator::Valid() const { return piter->Valid(); }
 void CDBIterator::SeekToFirst() { piter->SeekToFirst(); }
 void CDBIterator::Next() { piter->Next(); }
 
+std::vector<unsigned char> CDBIterator::GetKeyBytes() const
+{
+    leveldb::Slice slKey = piter->key();
+    return std::vector<unsigned char>(slKey.data(), slKey.data() + slKey.size());
+}
+
+std::vector<unsigned char> CDBIterator::GetValueBytes() const
+{
+    leveldb::Slice slValue = piter->value();
+    std::vector<unsigned char> vValue(slValue.data(), slValue.data() + slValue.size());
+    const std::vector<unsigned char>& vKey = dbwrapper_private::GetObfuscateKey(parent);
+    if (!vKey.empty()) {
+        for (size_t i = 0; i < vValue.size(); i++)
+            vValue[i] ^= vKey[i % vKey.size()];
+    }
+    return vValue;
+}
+
 namespace dbwrapper_private {
 
 void HandleError(const leveldb::Status& status)
@@ -242,4 +413,9 @@ const std::vector<unsigned char>& GetObfuscateKey(const CDBWrapper &w)
     return w.obfuscate_key;
 }
 
+bool IsObfuscated(const CDBWrapper &w)
+{
+    return w.fObfuscated;
+}
+
 } // namespace dbwrapper_private
@@ -10,6 +10,7 @@
 #include "fs.h"
 #include "serialize.h"
 #include "streams.h"
+#include "uint256.h"
 #include "util.h"
 #include "utilstrencodings.h"
 #include "version.h"
@@ -17,6 +18,11 @@
 #include <leveldb/db.h>
 #include <leveldb/write_batch.h>
 
+#include <atomic>
+#include <map>
+#include <memory>
+#include <mutex>
+
 static const size_t DBWRAPPER_PREALLOC_KEY_SIZE = 64;
 static const size_t DBWRAPPER_PREALLOC_VALUE_SIZE = 1024;
 
@@ -28,6 +34,24 @@ public:
 
 class CDBWrapper;
 
+/** LevelDB table settings for one database, to suit how it is read */
+struct CDBProfile
+{
+    //! compress tables with Snappy (only takes effect when LevelDB is built with Snappy)
+    bool fCompress = false;
+    //! approximate amount of data per table block; scans favour larger blocks, point reads smaller ones
+    size_t nBlockSize = 4096;
+    //! bloom filter bits per key, 0 for no filter
+    int nBloomBits = 10;
+};
+
+/**
+ * Settings for the database in the directory called strName: its built in
+ * profile with any -dbprofile=<name>:<setting>=<value>,... for it applied.
+ * Fails if any -dbprofile argument, for whichever database, is invalid.
+ */
+bool GetDBProfile(const std::string& strName, CDBProfile& profile, std::string& strError);
+
 /** These should be considered an implementation detail of the specific database.
  */
 namespace dbwrapper_private {
@@ -42,6 +66,28 @@ void HandleError(const leveldb::Status& status);
  */
 const std::vector<unsigned char>& GetObfuscateKey(const CDBWrapper &w);
 
+/** Whether the values of w are stored XORed with a key that isn't all zeros */
+bool IsObfuscated(const CDBWrapper &w);
+
+/** Unserialize a value of w from the bytes leveldb returned, without copying them */
+template <typename V>
+bool UnserializeValue(const CDBWrapper &w, const char* pData, size_t nSize, V& value)
+{
+    const unsigned char* p = reinterpret_cast<const unsigned char*>(pData);
+    try {
+        if (IsObfuscated(w)) {
+            CXorSpanReader ssValue(SER_DISK, CLIENT_VERSION, p, nSize, GetObfuscateKey(w));
+            ssValue >> value;
+        } else {
+            CSpanReader ssValue(SER_DISK, CLIENT_VERSION, p, nSize);
+            ssValue >> value;
+        }
+    } catch (const std::exception&) {
+        return false;
+    }
+    return true;
+}
+
 };
 
 /** Batch of changes queued to be written to a CDBWrapper */
@@ -148,7 +194,7 @@ public:
     template<typename K> bool GetKey(K& key) {
         leveldb::Slice slKey = piter->key();
         try {
-            CDataStream ssKey(slKey.data(), slKey.data() + slKey.size(), SER_DISK, CLIENT_VERSION);
+            CSpanReader ssKey(SER_DISK, CLIENT_VERSION, reinterpret_cast<const unsigned char*>(slKey.data()), slKey.size());
             ssKey >> key;
         } catch (const std::exception&) {
             return false;
@@ -158,25 +204,57 @@ public:
 
     template<typename V> bool GetValue(V& value) {
         leveldb::Slice slValue = piter->value();
-        try {
-            CDataStream ssValue(slValue.data(), slValue.data() + slValue.size(), SER_DISK, CLIENT_VERSION);
-            ssValue.Xor(dbwrapper_private::GetObfuscateKey(parent));
-            ssValue >> value;
-        } catch (const std::exception&) {
-            return false;
-        }
-        return true;
+        return dbwrapper_private::UnserializeValue(parent, slValue.data(), slValue.size(), value);
     }
 
     unsigned int GetValueSize() {
         return piter->value().size();
     }
 
+    //! The key as stored
+    std::vector<unsigned char> GetKeyBytes() const;
+    //! The value as stored, without the obfuscation
+    std::vector<unsigned char> GetValueBytes() const;
+
+};
+
+/**
+ * Consistent read-only view of a CDBWrapper as of when it was taken, for
+ * Read, Exists and NewIterator. Must not outlive the database.
+ */
+class CDBSnapshot
+{
+    friend class CDBWrapper;
+
+private:
+    leveldb::DB* pdb;
+    const leveldb::Snapshot* psnapshot;
+
+    explicit CDBSnapshot(leveldb::DB* _pdb) : pdb(_pdb), psnapshot(_pdb->GetSnapshot()) { };
+
+public:
+    ~CDBSnapshot() { pdb->ReleaseSnapshot(psnapshot); }
+
+    CDBSnapshot(const CDBSnapshot&) = delete;
+    CDBSnapshot& operator=(const CDBSnapshot&) = delete;
+
+    const leveldb::Snapshot* get() const { return psnapshot; }
 };
 
+/**
+ * Have the databases opened from now on keep the table blocks they read in one
+ * cache of nSize bytes, instead of each in its own of half its nCacheSize, so
+ * the memory goes to whichever database is busy. 0 goes back to a cache each.
+ */
+void SetSharedDBBlockCache(size_t nSize);
+
+/** Bytes held by the shared block cache, 0 if there is none */
+size_t GetSharedDBBlockCacheUsage();
+
 class CDBWrapper
 {
     friend const std::vector<unsigned char>& dbwrapper_private::GetObfuscateKey(const CDBWrapper &w);
+    friend bool dbwrapper_private::IsObfuscated(const CDBWrapper &w);
 private:
     //! custom environment this database is using (may be nullptr in case of default environment)
     leveldb::Env* penv;
@@ -184,6 +262,9 @@ private:
     //! database options used
     leveldb::Options options;
 
+    //! the block cache shared with other databases, if options.block_cache is it
+    std::shared_ptr<leveldb::Cache> sharedBlockCache;
+
     //! options used when reading from the database
     leveldb::ReadOptions readoptions;
 
@@ -202,6 +283,9 @@ private:
     //! a key used for optional XOR-obfuscation of the database
     std::vector<unsigned char> obfuscate_key;
 
+    //! whether obfuscate_key has a non-zero byte, so values have to be XORed as they are read
+    bool fObfuscated{false};
+
     //! the key under which the obfuscation key is stored
     static const std::string OBFUSCATE_KEY_KEY;
 
@@ -210,6 +294,19 @@ private:
 
     std::vector<unsigned char> CreateObfuscateKey() const;
 
+    //! the key under which the block of the last flush is stored
+    static const std::string FLUSH_MARKER_KEY;
+
+    //! while deferring, writes are queued in pdeferred instead of reaching the database,
+    //! and mapDeferred holds the value each queued key will have (not present: erased)
+    mutable std::mutex cs_deferred;
+    std::atomic<bool> fDeferring{false};
+    std::unique_ptr<CDBBatch> pdeferred;
+    std::map<std::string, std::pair<bool, std::string> > mapDeferred;
+
+    /** Whether key has been queued since BeginDeferred; if so, set fExists and its value */
+    bool ReadDeferred(const leveldb::Slice& key, bool& fExists, std::string& strValue) const;
+
 public:
     /**
      * @param[in] path        Location in the filesystem where leveldb data will be stored.
@@ -218,34 +315,38 @@ public:
      * @param[in] fWipe       If true, remove all existing data.
      * @param[in] obfuscate   If true, store data obfuscated via simple XOR. If false, XOR
      *                        with a zero'd byte array.
+     *
+     * Table settings come from GetDBProfile for the name of the directory at path.
      */
     CDBWrapper(const fs::path& path, size_t nCacheSize, bool fMemory = false, bool fWipe = false, bool obfuscate = false, size_t maxFileSize = 2 << 20);
     ~CDBWrapper();
 
     template <typename K, typename V>
-    bool Read(const K& key, V& value) const
+    bool Read(const K& key, V& value, const CDBSnapshot* snapshot = nullptr) const
     {
         CDataStream ssKey(SER_DISK, CLIENT_VERSION);
         ssKey.reserve(DBWRAPPER_PREALLOC_KEY_SIZE);
         ssKey << key;
         leveldb::Slice slKey(ssKey.data(), ssKey.size());
 
+        leveldb::ReadOptions options = readoptions;
+        if (snapshot)
+            options.snapshot = snapshot->get();
         std::string strValue;
-        leveldb::Status status = pdb->Get(readoptions, slKey, &strValue);
-        if (!status.ok()) {
-            if (status.IsNotFound())
+        bool fExists;
+        if (!snapshot && fDeferring && ReadDeferred(slKey, fExists, strValue)) {
+            if (!fExists)
                 return false;
-            LogPrintf("LevelDB read failure: %s\n", status.ToString());
-            dbwrapper_private::HandleError(status);
+        } else {
+            leveldb::Status status = pdb->Get(options, slKey, &strValue);
+            if (!status.ok()) {
+                if (status.IsNotFound())
+                    return false;
+                LogPrintf("LevelDB read failure: %s\n", status.ToString());
+                dbwrapper_private::HandleError(status);
+            }
         }
-        try {
-            CDataStream ssValue(strValue.data(), strValue.data() + strValue.size(), SER_DISK, CLIENT_VERSION);
-            ssValue.Xor(obfuscate_key);
-            ssValue >> value;
-        } catch (const std::exception&) {
-            return false;
-        }
-        return true;
+        return dbwrapper_private::UnserializeValue(*this, strValue.data(), strValue.size(), value);
     }
 
     template <typename K, typename V>
@@ -257,15 +358,21 @@ public:
     }
 
     template <typename K>
-    bool Exists(const K& key) const
+    bool Exists(const K& key, const CDBSnapshot* snapshot = nullptr) const
     {
         CDataStream ssKey(SER_DISK, CLIENT_VERSION);
         ssKey.reserve(DBWRAPPER_PREALLOC_KEY_SIZE);
         ssKey << key;
         leveldb::Slice slKey(ssKey.data(), ssKey.size());
 
+        leveldb::ReadOptions options = readoptions;
+        if (snapshot)
+            options.snapshot = snapshot->get();
         std::string strValue;
-        leveldb::Status status = pdb->Get(readoptions, slKey, &strValue);
+        bool fExists;
+        if (!snapshot && fDeferring && ReadDeferred(slKey, fExists, strValue))
+            return fExists;
+        leveldb::Status status = pdb->Get(options, slKey, &strValue);
         if (!status.ok()) {
             if (status.IsNotFound())
                 return false;
@@ -285,6 +392,19 @@ public:
 
     bool WriteBatch(CDBBatch& batch, bool fSync = false);
 
+    /**
+     * Queue every write and erase from now on, until CommitDeferred writes
+     * them all in one atomic write or DiscardDeferred drops them. Read and
+     * Exists see the queued changes; snapshots and iterators do not.
+     */
+    void BeginDeferred();
+    bool CommitDeferred(bool fSync = false);
+    void DiscardDeferred();
+
+    //! Record which block the database was last flushed at, or read it back
+    bool WriteFlushMarker(const uint256& hashBlock) { return Write(FLUSH_MARKER_KEY, hashBlock); }
+    bool ReadFlushMarker(uint256& hashBlock) const { return Read(FLUSH_MARKER_KEY, hashBlock); }
+
     // not available for LevelDB; provide for compatibility with BDB
     bool Flush()
     {
@@ -297,9 +417,18 @@ public:
         return WriteBatch(batch, true);
     }
 
-    CDBIterator *NewIterator()
+    CDBIterator *NewIterator(const CDBSnapshot* snapshot = nullptr)
+    {
+        leveldb::ReadOptions options = iteroptions;
+        if (snapshot)
+            options.snapshot = snapshot->get();
+        return new CDBIterator(*this, pdb->NewIterator(options));
+    }
+
+    //! Pin the current state of the database for later reads
+    std::shared_ptr<const CDBSnapshot> GetSnapshot() const
     {
-        return new CDBIterator(*this, pdb->NewIterator(iteroptions));
+        return std::shared_ptr<const CDBSnapshot>(new CDBSnapshot(pdb));
     }
 
     /**
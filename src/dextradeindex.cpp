@@ -0,0 +1,456 @@
+// Copyright (c) 2026 The Mynta Core Developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include "dextradeindex.h"
+
+#include "arith_uint256.h"
+#include "assets/assets.h"
+#include "assets/atomicswap.h"
+#include "chain.h"
+#include "coins.h"
+#include "primitives/block.h"
+#include "undo.h"
+#include "util.h"
+#include "validation.h"
+
+#include <algorithm>
+#include <limits>
+#include <map>
+#include <set>
+#include <tuple>
+
+static const char DB_LEG = 'l';
+static const char DB_FILL = 'f';
+static const char DB_CANDLE = 'c';
+static const char DB_BLOCK = 'b';
+static const char DB_BEST_BLOCK = 'B';
+
+CDexTradeIndex* pdextradeindex = nullptr;
+
+namespace {
+/** Key of a fill. Time, height and order are stored inverted and big endian, so a pair's newest fills come first. */
+struct CDexFillKey
+{
+    std::string strBase;
+    std::string strQuote;
+    uint32_t nTime;
+    uint32_t nHeight;
+    uint32_t nOrder;
+
+    CDexFillKey() : nTime(0), nHeight(0), nOrder(0) {}
+    CDexFillKey(const std::string& strBaseIn, const std::string& strQuoteIn, uint32_t nTimeIn, uint32_t nHeightIn, uint32_t nOrderIn)
+        : strBase(strBaseIn), strQuote(strQuoteIn), nTime(nTimeIn), nHeight(nHeightIn), nOrder(nOrderIn) {}
+    explicit CDexFillKey(const CDexTrade& trade)
+        : CDexFillKey(trade.strBase, trade.strQuote, trade.nTime, trade.nHeight, trade.nOrder) {}
+
+    template <typename Stream>
+    void Serialize(Stream& s) const
+    {
+        ::Serialize(s, strBase);
+        ::Serialize(s, strQuote);
+        ser_writedata32be(s, ~nTime);
+        ser_writedata32be(s, ~nHeight);
+        ser_writedata32be(s, ~nOrder);
+    }
+
+    template <typename Stream>
+    void Unserialize(Stream& s)
+    {
+        ::Unserialize(s, strBase);
+        ::Unserialize(s, strQuote);
+        nTime = ~ser_readdata32be(s);
+        nHeight = ~ser_readdata32be(s);
+        nOrder = ~ser_readdata32be(s);
+    }
+};
+
+/** Key of a candle, a pair's buckets of one interval in time order */
+struct CDexCandleKey
+{
+    std::string strBase;
+    std::string strQuote;
+    uint32_t nInterval;
+    uint32_t nStart;
+
+    CDexCandleKey() : nInterval(0), nStart(0) {}
+    CDexCandleKey(const std::string& strBaseIn, const std::string& strQuoteIn, uint32_t nIntervalIn, uint32_t nStartIn)
+        : strBase(strBaseIn), strQuote(strQuoteIn), nInterval(nIntervalIn), nStart(nStartIn) {}
+
+    bool operator<(const CDexCandleKey& other) const
+    {
+        return std::tie(strBase, strQuote, nInterval, nStart) < std::tie(other.strBase, other.strQuote, other.nInterval, other.nStart);
+    }
+
+    template <typename Stream>
+    void Serialize(Stream& s) const
+    {
+        ::Serialize(s, strBase);
+        ::Serialize(s, strQuote);
+        ser_writedata32be(s, nInterval);
+        ser_writedata32be(s, nStart);
+    }
+
+    template <typename Stream>
+    void Unserialize(Stream& s)
+    {
+        ::Unserialize(s, strBase);
+        ::Unserialize(s, strQuote);
+        nInterval = ser_readdata32be(s);
+        nStart = ser_readdata32be(s);
+    }
+};
+
+/** Key of a block's record, inverted so the newest block comes first */
+struct CDexHeightKey
+{
+    uint32_t nHeight;
+
+    explicit CDexHeightKey(uint32_t nHeightIn = 0) : nHeight(nHeightIn) {}
+
+    template <typename Stream>
+    void Serialize(Stream& s) const { ser_writedata32be(s, ~nHeight); }
+
+    template <typename Stream>
+    void Unserialize(Stream& s) { nHeight = ~ser_readdata32be(s); }
+};
+
+/** What a block changed in the index, to undo it in a reorg */
+struct CDexBlockRecord
+{
+    uint256 hashBlock;
+    std::vector<uint256> vLegsAdded;
+    std::vector<std::pair<uint256, CDexSwapLeg>> vLegsUsed;
+    std::vector<CDexTrade> vTrades;
+
+    bool IsEmpty() const { return vLegsAdded.empty() && vLegsUsed.empty() && vTrades.empty(); }
+
+    ADD_SERIALIZE_METHODS;
+
+    template <typename Stream, typename Operation>
+    inline void SerializationOp(Stream& s, Operation ser_action)
+    {
+        READWRITE(hashBlock);
+        READWRITE(vLegsAdded);
+        READWRITE(vLegsUsed);
+        READWRITE(vTrades);
+    }
+};
+
+/** The asset and amount of a claimed HTLC output */
+bool GetClaimedLeg(const Coin& coin, CDexSwapLeg& leg)
+{
+    if (coin.IsAsset()) {
+        CCoinAssetData data;
+        if (!DecodeCoinAssetData(coin.out.scriptPubKey, data))
+            return false;
+        leg.strAsset = data.strName;
+        leg.nAmount = data.nAmount;
+    } else {
+        leg.strAsset = "MYNTA";
+        leg.nAmount = coin.out.nValue;
+    }
+    return leg.nAmount > 0;
+}
+} // namespace
+
+bool CDexTrade::FromLegs(const CDexSwapLeg& legA, const CDexSwapLeg& legB, CDexTrade& trade)
+{
+    if (legA.strAsset == legB.strAsset)
+        return false;
+    const CDexSwapLeg& legBase = legA.strAsset < legB.strAsset ? legA : legB;
+    const CDexSwapLeg& legQuote = legA.strAsset < legB.strAsset ? legB : legA;
+    trade.strBase = legBase.strAsset;
+    trade.strQuote = legQuote.strAsset;
+    trade.nBaseAmount = legBase.nAmount;
+    trade.nQuoteAmount = legQuote.nAmount;
+    return true;
+}
+
+CAmount CDexTrade::GetPrice() const
+{
+    if (nBaseAmount <= 0 || nQuoteAmount <= 0)
+        return 0;
+    const arith_uint256 nPrice = arith_uint256((uint64_t)nQuoteAmount) * (uint64_t)COIN / (uint64_t)nBaseAmount;
+    if (nPrice > arith_uint256((uint64_t)std::numeric_limits<CAmount>::max()))
+        return std::numeric_limits<CAmount>::max();
+    return (CAmount)nPrice.GetLow64();
+}
+
+bool CDexTrade::Before(uint32_t nTimeIn, int nHeightIn, uint32_t nOrderIn) const
+{
+    return std::tie(nTime, nHeight, nOrder) < std::tie(nTimeIn, nHeightIn, nOrderIn);
+}
+
+void CDexCandle::Add(const CDexTrade& trade)
+{
+    const CAmount nPrice = trade.GetPrice();
+    if (nTrades == 0 || trade.Before(nOpenTime, nOpenHeight, nOpenOrder)) {
+        nOpen = nPrice;
+        nOpenTime = trade.nTime;
+        nOpenHeight = trade.nHeight;
+        nOpenOrder = trade.nOrder;
+    }
+    if (nTrades == 0 || !trade.Before(nCloseTime, nCloseHeight, nCloseOrder)) {
+        nClose = nPrice;
+        nCloseTime = trade.nTime;
+        nCloseHeight = trade.nHeight;
+        nCloseOrder = trade.nOrder;
+    }
+    if (nTrades == 0 || nPrice > nHigh)
+        nHigh = nPrice;
+    if (nTrades == 0 || nPrice < nLow)
+        nLow = nPrice;
+    nBaseVolume += trade.nBaseAmount;
+    nQuoteVolume += trade.nQuoteAmount;
+    nTrades++;
+}
+
+CDexTradeIndex::CDexTradeIndex(size_t nCacheSize, bool fMemory, bool fWipe)
+    : CBaseIndex(GetDataDir() / "indexes" / "dex", nCacheSize, fMemory, fWipe)
+{
+}
+
+bool CDexTradeIndex::Init()
+{
+    AssertLockHeld(cs_main);
+    SetBest(nullptr);
+
+    uint256 hashBest;
+    if (!db.Read(DB_BEST_BLOCK, hashBest))
+        return true;
+    // Unlike filters, trades and candles of blocks off the chain can't be told apart, so don't build on them
+    BlockMap::const_iterator it = mapBlockIndex.find(hashBest);
+    if (it == mapBlockIndex.end())
+        return error("%s: best block %s of the DEX trade index is unknown", __func__, hashBest.ToString());
+    SetBest(it->second);
+    return true;
+}
+
+std::string CDexTradeIndex::GetName() const
+{
+    return "DEX trade index";
+}
+
+bool CDexTradeIndex::WriteBlock(const CBlock& block, const CBlockUndo& blockundo, const CBlockIndex* pindex)
+{
+    CDexBlockRecord record;
+    record.hashBlock = pindex->GetBlockHash();
+    // Legs first claimed in this block and not matched yet
+    std::map<uint256, CDexSwapLeg> mapLegs;
+
+    HTLCScript::HTLCSpend spend;
+    for (size_t i = 1; i < block.vtx.size() && i - 1 < blockundo.vtxundo.size(); i++) {
+        const CTransaction& tx = *block.vtx[i];
+        const CTxUndo& txundo = blockundo.vtxundo[i - 1];
+        for (size_t j = 0; j < tx.vin.size() && j < txundo.vprevout.size(); j++) {
+            if (!HTLCScript::MatchHTLCSpend(tx.vin[j].scriptSig, spend) || !spend.fClaim)
+                continue;
+            const uint256& hashLock = spend.htlc.hashLock;
+            if (HashSecret(spend.preimage) != hashLock)
+                continue;
+            CDexSwapLeg leg;
+            if (!GetClaimedLeg(txundo.vprevout[j], leg))
+                continue;
+            leg.nHeight = pindex->nHeight;
+
+            CDexSwapLeg legOther;
+            std::map<uint256, CDexSwapLeg>::iterator it = mapLegs.find(hashLock);
+            if (it != mapLegs.end()) {
+                legOther = it->second;
+                mapLegs.erase(it);
+            } else if (db.Read(std::make_pair(DB_LEG, hashLock), legOther)) {
+                record.vLegsUsed.emplace_back(hashLock, legOther);
+            } else {
+                mapLegs.emplace(hashLock, leg);
+                continue;
+            }
+
+            CDexTrade trade;
+            if (!CDexTrade::FromLegs(legOther, leg, trade)) {
+                // Not a swap; the later claim may still be matched
+                mapLegs.emplace(hashLock, leg);
+                continue;
+            }
+            trade.hashLock = hashLock;
+            trade.txid = tx.GetHash();
+            trade.nHeight = pindex->nHeight;
+            trade.nTime = pindex->GetBlockTime();
+            trade.nOrder = record.vTrades.size();
+            record.vTrades.push_back(trade);
+        }
+    }
+
+    CDBBatch batch(db);
+    for (const auto& entry : record.vLegsUsed)
+        batch.Erase(std::make_pair(DB_LEG, entry.first));
+    for (const auto& entry : mapLegs) {
+        batch.Write(std::make_pair(DB_LEG, entry.first), entry.second);
+        record.vLegsAdded.push_back(entry.first);
+    }
+
+    std::map<CDexCandleKey, CDexCandle> mapCandles;
+    for (const CDexTrade& trade : record.vTrades) {
+        batch.Write(std::make_pair(DB_FILL, CDexFillKey(trade)), trade);
+        for (uint32_t nInterval : DEX_CANDLE_INTERVALS) {
+            const CDexCandleKey key(trade.strBase, trade.strQuote, nInterval, CDexCandle::BucketStart(trade.nTime, nInterval));
+            std::map<CDexCandleKey, CDexCandle>::iterator it = mapCandles.find(key);
+            if (it == mapCandles.end()) {
+                CDexCandle candle;
+                if (!db.Read(std::make_pair(DB_CANDLE, key), candle)) {
+                    candle.nStart = key.nStart;
+                    candle.nInterval = nInterval;
+                }
+                it = mapCandles.emplace(key, candle).first;
+            }
+            it->second.Add(trade);
+        }
+    }
+    for (const auto& entry : mapCandles)
+        batch.Write(std::make_pair(DB_CANDLE, entry.first), entry.second);
+
+    if (!record.IsEmpty())
+        batch.Write(std::make_pair(DB_BLOCK, CDexHeightKey(pindex->nHeight)), record);
+    batch.Write(DB_BEST_BLOCK, pindex->GetBlockHash());
+    if (!db.WriteBatch(batch))
+        return error("%s: failed to write the trades of block %s", __func__, pindex->GetBlockHash().ToString());
+
+    SetBest(pindex);
+    return true;
+}
+
+bool CDexTradeIndex::ComputeCandle(const std::string& strBase, const std::string& strQuote, uint32_t nInterval, uint32_t nStart,
+                                   const std::vector<CDexTrade>& vErased, CDexCandle& candle) const
+{
+    candle = CDexCandle();
+    candle.nStart = nStart;
+    candle.nInterval = nInterval;
+
+    const uint32_t nEnd = nStart + std::min(nInterval - 1, std::numeric_limits<uint32_t>::max() - nStart);
+    std::unique_ptr<CDBIterator> pcursor(const_cast<CDBWrapper&>(db).NewIterator());
+    pcursor->Seek(std::make_pair(DB_FILL, CDexFillKey(strBase, strQuote, nEnd, std::numeric_limits<uint32_t>::max(), std::numeric_limits<uint32_t>::max())));
+    for (; pcursor->Valid(); pcursor->Next()) {
+        std::pair<char, CDexFillKey> key;
+        if (!pcursor->GetKey(key) || key.first != DB_FILL || key.second.strBase != strBase || key.second.strQuote != strQuote || key.second.nTime < nStart)
+            break;
+        CDexTrade trade;
+        if (!pcursor->GetValue(trade))
+            return error("%s: failed to read a fill of %s/%s", __func__, strBase, strQuote);
+        const bool fErased = std::any_of(vErased.begin(), vErased.end(), [&trade](const CDexTrade& erased) {
+            return erased.nHeight == trade.nHeight && erased.nOrder == trade.nOrder;
+        });
+        if (!fErased)
+            candle.Add(trade);
+    }
+    return true;
+}
+
+bool CDexTradeIndex::RewindBlock()
+{
+    const CBlockIndex* pindex = pindexBest;
+    CDBBatch batch(db);
+
+    CDexBlockRecord record;
+    if (db.Read(std::make_pair(DB_BLOCK, CDexHeightKey(pindex->nHeight)), record)) {
+        if (record.hashBlock != pindex->GetBlockHash())
+            return error("%s: record at height %d is of block %s, not %s", __func__, pindex->nHeight, record.hashBlock.ToString(), pindex->GetBlockHash().ToString());
+
+        // Legs are erased before the used ones are restored, a claim can have replaced the leg it used
+        for (const uint256& hashLock : record.vLegsAdded)
+            batch.Erase(std::make_pair(DB_LEG, hashLock));
+        for (const auto& entry : record.vLegsUsed)
+            batch.Write(std::make_pair(DB_LEG, entry.first), entry.second);
+
+        std::set<CDexCandleKey> setCandles;
+        for (const CDexTrade& trade : record.vTrades) {
+            batch.Erase(std::make_pair(DB_FILL, CDexFillKey(trade)));
+            for (uint32_t nInterval : DEX_CANDLE_INTERVALS)
+                setCandles.emplace(trade.strBase, trade.strQuote, nInterval, CDexCandle::BucketStart(trade.nTime, nInterval));
+        }
+        for (const CDexCandleKey& key : setCandles) {
+            CDexCandle candle;
+            if (!ComputeCandle(key.strBase, key.strQuote, key.nInterval, key.nStart, record.vTrades, candle))
+                return false;
+            if (candle.nTrades == 0)
+                batch.Erase(std::make_pair(DB_CANDLE, key));
+            else
+                batch.Write(std::make_pair(DB_CANDLE, key), candle);
+        }
+        batch.Erase(std::make_pair(DB_BLOCK, CDexHeightKey(pindex->nHeight)));
+    }
+
+    const CBlockIndex* pindexPrev = pindex->pprev;
+    if (pindexPrev)
+        batch.Write(DB_BEST_BLOCK, pindexPrev->GetBlockHash());
+    else
+        batch.Erase(DB_BEST_BLOCK);
+    if (!db.WriteBatch(batch))
+        return error("%s: failed to undo the trades of block %s", __func__, pindex->GetBlockHash().ToString());
+
+    SetBest(pindexPrev);
+    return true;
+}
+
+bool CDexTradeIndex::RewindTo(const CBlockIndex* pindexFork)
+{
+    while (pindexBest != pindexFork) {
+        if (!RewindBlock())
+            return false;
+    }
+    return true;
+}
+
+bool CDexTradeIndex::GetTrades(const std::string& strBase, const std::string& strQuote, uint32_t nStartTime, uint32_t nEndTime,
+                               size_t nCount, std::vector<CDexTrade>& vTrades) const
+{
+    vTrades.clear();
+    std::unique_ptr<CDBIterator> pcursor(const_cast<CDBWrapper&>(db).NewIterator());
+    pcursor->Seek(std::make_pair(DB_FILL, CDexFillKey(strBase, strQuote, nEndTime, std::numeric_limits<uint32_t>::max(), std::numeric_limits<uint32_t>::max())));
+    for (; pcursor->Valid() && vTrades.size() < nCount; pcursor->Next()) {
+        std::pair<char, CDexFillKey> key;
+        if (!pcursor->GetKey(key) || key.first != DB_FILL || key.second.strBase != strBase || key.second.strQuote != strQuote || key.second.nTime < nStartTime)
+            break;
+        CDexTrade trade;
+        if (!pcursor->GetValue(trade))
+            return error("%s: failed to read a fill of %s/%s", __func__, strBase, strQuote);
+        vTrades.push_back(trade);
+    }
+    return true;
+}
+
+bool CDexTradeIndex::GetRecentTrades(size_t nCount, std::vector<CDexTrade>& vTrades) const
+{
+    vTrades.clear();
+    std::unique_ptr<CDBIterator> pcursor(const_cast<CDBWrapper&>(db).NewIterator());
+    pcursor->Seek(std::make_pair(DB_BLOCK, CDexHeightKey(std::numeric_limits<uint32_t>::max())));
+    for (; pcursor->Valid() && vTrades.size() < nCount; pcursor->Next()) {
+        std::pair<char, CDexHeightKey> key;
+        if (!pcursor->GetKey(key) || key.first != DB_BLOCK)
+            break;
+        CDexBlockRecord record;
+        if (!pcursor->GetValue(record))
+            return error("%s: failed to read the record of height %u", __func__, key.second.nHeight);
+        for (auto it = record.vTrades.rbegin(); it != record.vTrades.rend() && vTrades.size() < nCount; ++it)
+            vTrades.push_back(*it);
+    }
+    return true;
+}
+
+bool CDexTradeIndex::GetCandles(const std::string& strBase, const std::string& strQuote, uint32_t nInterval,
+                                uint32_t nStartTime, uint32_t nEndTime, size_t nCount, std::vector<CDexCandle>& vCandles) const
+{
+    vCandles.clear();
+    std::unique_ptr<CDBIterator> pcursor(const_cast<CDBWrapper&>(db).NewIterator());
+    pcursor->Seek(std::make_pair(DB_CANDLE, CDexCandleKey(strBase, strQuote, nInterval, CDexCandle::BucketStart(nStartTime, nInterval))));
+    for (; pcursor->Valid() && vCandles.size() < nCount; pcursor->Next()) {
+        std::pair<char, CDexCandleKey> key;
+        if (!pcursor->GetKey(key) || key.first != DB_CANDLE || key.second.strBase != strBase || key.second.strQuote != strQuote ||
+            key.second.nInterval != nInterval || key.second.nStart > nEndTime)
+            break;
+        CDexCandle candle;
+        if (!pcursor->GetValue(candle))
+            return error("%s: failed to read a candle of %s/%s", __func__, strBase, strQuote);
+        vCandles.push_back(candle);
+    }
+    return true;
+}
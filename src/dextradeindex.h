@@ -0,0 +1,186 @@
+// Copyright (c) 2026 The Mynta Core Developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#ifndef MYNTA_DEXTRADEINDEX_H
+#define MYNTA_DEXTRADEINDEX_H
+
+#include "amount.h"
+#include "baseindex.h"
+#include "serialize.h"
+#include "uint256.h"
+
+#include <string>
+#include <vector>
+
+static const bool DEFAULT_DEXINDEX = false;
+static const size_t DEXINDEX_DB_CACHE_SIZE = 8 << 20;
+//! Events the index's validation queue holds; it sees every mempool transaction too
+static const size_t DEXINDEX_QUEUE_DEPTH = 10000;
+
+/** Candle lengths the index keeps, in seconds */
+static const uint32_t DEX_CANDLE_INTERVALS[] = {60, 60 * 60, 24 * 60 * 60};
+
+/** One side of a swap: an HTLC output claimed by revealing the preimage of its hash lock */
+class CDexSwapLeg
+{
+public:
+    //! Normalized asset name, "MYNTA" for the native coin
+    std::string strAsset;
+    CAmount nAmount{0};
+    int nHeight{0};
+
+    ADD_SERIALIZE_METHODS;
+
+    template <typename Stream, typename Operation>
+    inline void SerializationOp(Stream& s, Operation ser_action)
+    {
+        READWRITE(strAsset);
+        READWRITE(nAmount);
+        READWRITE(nHeight);
+    }
+};
+
+/**
+ * A filled swap: two HTLCs sharing a hash lock, for different assets, both
+ * claimed. The pair is ordered like the order book's pair keys, the base asset
+ * being the one whose normalized name sorts first.
+ */
+class CDexTrade
+{
+public:
+    std::string strBase;
+    std::string strQuote;
+    CAmount nBaseAmount{0};
+    CAmount nQuoteAmount{0};
+    uint256 hashLock;
+    //! The claim that completed the swap
+    uint256 txid;
+    int nHeight{0};
+    uint32_t nTime{0};
+    //! Position among the trades of its block
+    uint32_t nOrder{0};
+
+    /** The trade of two claimed legs, false if they are for the same asset */
+    static bool FromLegs(const CDexSwapLeg& legA, const CDexSwapLeg& legB, CDexTrade& trade);
+
+    //! Quote amount per whole unit (COIN) of base, rounded down
+    CAmount GetPrice() const;
+
+    //! Orders trades by time, then by when they were connected
+    bool Before(uint32_t nTimeIn, int nHeightIn, uint32_t nOrderIn) const;
+
+    ADD_SERIALIZE_METHODS;
+
+    template <typename Stream, typename Operation>
+    inline void SerializationOp(Stream& s, Operation ser_action)
+    {
+        READWRITE(strBase);
+        READWRITE(strQuote);
+        READWRITE(nBaseAmount);
+        READWRITE(nQuoteAmount);
+        READWRITE(hashLock);
+        READWRITE(txid);
+        READWRITE(nHeight);
+        READWRITE(nTime);
+        READWRITE(nOrder);
+    }
+};
+
+/** Open, high, low, close and volume of the trades of a pair in one time bucket */
+class CDexCandle
+{
+public:
+    uint32_t nStart{0};
+    uint32_t nInterval{0};
+    CAmount nOpen{0};
+    CAmount nHigh{0};
+    CAmount nLow{0};
+    CAmount nClose{0};
+    CAmount nBaseVolume{0};
+    CAmount nQuoteVolume{0};
+    uint32_t nTrades{0};
+
+    // Which trades opened and closed the bucket, so trades can be added in any order
+    uint32_t nOpenTime{0};
+    int nOpenHeight{0};
+    uint32_t nOpenOrder{0};
+    uint32_t nCloseTime{0};
+    int nCloseHeight{0};
+    uint32_t nCloseOrder{0};
+
+    static uint32_t BucketStart(uint32_t nTime, uint32_t nInterval) { return nTime - nTime % nInterval; }
+
+    void Add(const CDexTrade& trade);
+
+    ADD_SERIALIZE_METHODS;
+
+    template <typename Stream, typename Operation>
+    inline void SerializationOp(Stream& s, Operation ser_action)
+    {
+        READWRITE(nStart);
+        READWRITE(nInterval);
+        READWRITE(nOpen);
+        READWRITE(nHigh);
+        READWRITE(nLow);
+        READWRITE(nClose);
+        READWRITE(nBaseVolume);
+        READWRITE(nQuoteVolume);
+        READWRITE(nTrades);
+        READWRITE(nOpenTime);
+        READWRITE(nOpenHeight);
+        READWRITE(nOpenOrder);
+        READWRITE(nCloseTime);
+        READWRITE(nCloseHeight);
+        READWRITE(nCloseOrder);
+    }
+};
+
+/**
+ * Trade history of the on-chain side of the DEX, kept in its own database.
+ *
+ * Offers are matched off-chain, so a fill is seen when its two HTLCs are
+ * claimed: the first claim of a hash lock is kept as a pending leg, the
+ * second one, for another asset, completes a trade. Trades are appended under
+ * their pair and time, newest first, and folded into 1m/1h/1d candles as
+ * blocks connect. What each block changed is recorded under its height, so a
+ * reorg erases its trades, restores the legs they used and recomputes the
+ * candles they touched from the trades left.
+ */
+class CDexTradeIndex : public CBaseIndex
+{
+private:
+    //! Undo what pindexBest wrote and make its parent the best block
+    bool RewindBlock();
+
+    /** Candle of the trades in a bucket, ignoring the fills about to be erased */
+    bool ComputeCandle(const std::string& strBase, const std::string& strQuote, uint32_t nInterval, uint32_t nStart,
+                       const std::vector<CDexTrade>& vErased, CDexCandle& candle) const;
+
+protected:
+    bool WriteBlock(const CBlock& block, const CBlockUndo& blockundo, const CBlockIndex* pindex) override;
+    bool RewindTo(const CBlockIndex* pindexFork) override;
+    std::string GetName() const override;
+
+public:
+    explicit CDexTradeIndex(size_t nCacheSize, bool fMemory = false, bool fWipe = false);
+
+    /** Load the best block written so far, false if it isn't on any known chain. Requires cs_main. */
+    bool Init();
+
+    /** Up to nCount trades of a pair from nStartTime to nEndTime, newest first */
+    bool GetTrades(const std::string& strBase, const std::string& strQuote, uint32_t nStartTime, uint32_t nEndTime,
+                   size_t nCount, std::vector<CDexTrade>& vTrades) const;
+
+    /** Up to nCount trades of every pair, newest first */
+    bool GetRecentTrades(size_t nCount, std::vector<CDexTrade>& vTrades) const;
+
+    /** Up to nCount candles of a pair, from the bucket holding nStartTime to the one holding nEndTime, oldest first */
+    bool GetCandles(const std::string& strBase, const std::string& strQuote, uint32_t nInterval,
+                    uint32_t nStartTime, uint32_t nEndTime, size_t nCount, std::vector<CDexCandle>& vCandles) const;
+};
+
+/** The index, if -dexindex turned it on */
+extern CDexTradeIndex* pdextradeindex;
+
+#endif // MYNTA_DEXTRADEINDEX_H
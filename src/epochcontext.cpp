@@ -0,0 +1,107 @@
+// Copyright (c) 2026 The Mynta Core Developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include "epochcontext.h"
+#include "util.h"
+
+#include <crypto/ethash/include/ethash/ethash.hpp>
+
+#include <algorithm>
+
+CEpochContextCache epochContextCache;
+
+CEpochContextCache::~CEpochContextCache()
+{
+    if (prebuildThread.joinable()) {
+        prebuildThread.join();
+    }
+}
+
+CEpochContextCache::ContextPtr CEpochContextCache::Build(int nEpoch)
+{
+    int64_t nStart = GetTimeMillis();
+    ContextPtr context(ethash_create_epoch_context(nEpoch), [](const ethash_epoch_context* p) {
+        ethash_destroy_epoch_context(const_cast<ethash_epoch_context*>(p));
+    });
+    LogPrint(BCLog::BENCH, "CEpochContextCache::%s -- Built context for epoch %d in %dms\n",
+             __func__, nEpoch, GetTimeMillis() - nStart);
+
+    {
+        std::lock_guard<std::mutex> lock(cs);
+        setBuilding.erase(nEpoch);
+        if (context) {
+            contexts[nEpoch] = CEntry{context, ++nUseCounter};
+            EvictLocked();
+        }
+    }
+    condBuilt.notify_all();
+    return context;
+}
+
+void CEpochContextCache::EvictLocked()
+{
+    while (contexts.size() > MAX_RESIDENT_EPOCH_CONTEXTS) {
+        auto itOldest = std::min_element(contexts.begin(), contexts.end(), [](const auto& a, const auto& b) {
+            return a.second.nLastUsed < b.second.nLastUsed;
+        });
+        // Callers still hashing with an evicted context keep it alive through their ContextPtr
+        contexts.erase(itOldest);
+    }
+}
+
+CEpochContextCache::ContextPtr CEpochContextCache::Get(int nEpoch)
+{
+    {
+        std::unique_lock<std::mutex> lock(cs);
+        while (true) {
+            auto it = contexts.find(nEpoch);
+            if (it != contexts.end()) {
+                it->second.nLastUsed = ++nUseCounter;
+                return it->second.context;
+            }
+            if (!setBuilding.count(nEpoch)) {
+                break;
+            }
+            // Another thread is building it, wait for that instead of building twice
+            condBuilt.wait(lock);
+        }
+        setBuilding.insert(nEpoch);
+    }
+
+    return Build(nEpoch);
+}
+
+void CEpochContextCache::Prebuild(int nEpoch)
+{
+    std::lock_guard<std::mutex> lock(cs);
+    if (fPrebuildRunning || contexts.count(nEpoch) || setBuilding.count(nEpoch)) {
+        return;
+    }
+    setBuilding.insert(nEpoch);
+
+    // The previous prebuild cleared fPrebuildRunning as its last step, so
+    // joining it here does not block
+    if (prebuildThread.joinable()) {
+        prebuildThread.join();
+    }
+    fPrebuildRunning = true;
+    prebuildThread = std::thread([this, nEpoch] {
+        RenameThread("mynta-epochctx");
+        Build(nEpoch);
+        std::lock_guard<std::mutex> threadLock(cs);
+        fPrebuildRunning = false;
+    });
+}
+
+CEpochContextCache::ContextPtr CEpochContextCache::GetForHeight(int nHeight)
+{
+    const int nEpoch = ethash::get_epoch_number(nHeight);
+    ContextPtr context = Get(nEpoch);
+
+    if (nHeight % ethash::epoch_length >= ethash::epoch_length - EPOCH_CONTEXT_PREBUILD_BLOCKS) {
+        Prebuild(nEpoch + 1);
+    }
+
+    return context;
+}
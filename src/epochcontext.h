@@ -0,0 +1,79 @@
+// Copyright (c) 2026 The Mynta Core Developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#ifndef MYNTA_EPOCHCONTEXT_H
+#define MYNTA_EPOCHCONTEXT_H
+
+#include <condition_variable>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <set>
+#include <thread>
+
+struct ethash_epoch_context;
+
+/** Number of KAWPOW epoch contexts kept resident (current, next and one spare for RPC lookups) */
+static const size_t MAX_RESIDENT_EPOCH_CONTEXTS = 3;
+/** Start building the next epoch's context this many blocks before the epoch boundary */
+static const int EPOCH_CONTEXT_PREBUILD_BLOCKS = 100;
+
+/**
+ * Shared, thread-safe cache of KAWPOW (ethash light) epoch contexts.
+ *
+ * Building a context for a new epoch takes seconds. Every KAWPOW hash goes
+ * through this cache (header/block validation and the mining RPCs), so
+ * contexts are built once and a caller never rebuilds an epoch another
+ * thread is already building: it waits for that build instead. Once a
+ * height gets within EPOCH_CONTEXT_PREBUILD_BLOCKS of the end of its epoch,
+ * the next epoch's context is built on a background thread so nothing
+ * stalls at the boundary.
+ */
+class CEpochContextCache
+{
+public:
+    typedef std::shared_ptr<const ethash_epoch_context> ContextPtr;
+
+private:
+    struct CEntry {
+        ContextPtr context;
+        uint64_t nLastUsed;
+    };
+
+    std::mutex cs;
+    std::condition_variable condBuilt;
+
+    std::map<int, CEntry> contexts;
+    std::set<int> setBuilding;
+    uint64_t nUseCounter{0};
+
+    //! Background builder for the next epoch, at most one at a time
+    std::thread prebuildThread;
+    bool fPrebuildRunning{false};
+
+    //! Build the context for nEpoch (unlocked) and insert it; nEpoch must be in setBuilding
+    ContextPtr Build(int nEpoch);
+    void EvictLocked();
+
+public:
+    CEpochContextCache() = default;
+    ~CEpochContextCache();
+
+    CEpochContextCache(const CEpochContextCache&) = delete;
+    CEpochContextCache& operator=(const CEpochContextCache&) = delete;
+
+    //! Context for the epoch containing nHeight, built on demand; prebuilds the next epoch near the boundary
+    ContextPtr GetForHeight(int nHeight);
+
+    //! Context for nEpoch, built synchronously unless resident or already being built
+    ContextPtr Get(int nEpoch);
+
+    //! Start building nEpoch's context in the background unless resident or already being built
+    void Prebuild(int nEpoch);
+};
+
+extern CEpochContextCache epochContextCache;
+
+#endif // MYNTA_EPOCHCONTEXT_H
@@ -12,6 +12,7 @@
 #include "chainparams.h"
 #include "consensus/validation.h"
 #include "hash.h"
+#include "memusage.h"
 #include "script/standard.h"
 #include "util.h"
 #include "validation.h"
@@ -98,24 +99,10 @@ std::string CDeterministicMN::ToString() const
 // CDeterministicMNList Implementation
 // ============================================================================
 
-size_t CDeterministicMNList::GetValidMNsCount() const
-{
-    size_t count = 0;
-    for (const auto& pair : mnMap) {
-        if (pair.second->IsValid()) {
-            count++;
-        }
-    }
-    return count;
-}
-
 CDeterministicMNCPtr CDeterministicMNList::GetMN(const uint256& proTxHash) const
 {
-    auto it = mnMap.find(proTxHash);
-    if (it == mnMap.end()) {
-        return nullptr;
-    }
-    return it->second;
+    const CDeterministicMNCPtr* p = mnMap.find_value(proTxHash);
+    return p ? *p : nullptr;
 }
 
 CDeterministicMNCPtr CDeterministicMNList::GetMNByOperatorKey(const std::vector<unsigned char>& vchPubKey) const
@@ -130,22 +117,36 @@ CDeterministicMNCPtr CDeterministicMNList::GetMNByOperatorKey(const std::vector<
 
 CDeterministicMNCPtr CDeterministicMNList::GetMNByCollateral(const COutPoint& collateralOutpoint) const
 {
-    for (const auto& pair : mnMap) {
-        if (pair.second->collateralOutpoint == collateralOutpoint) {
-            return pair.second;
-        }
+    if (!MayBeCollateral(collateralOutpoint)) {
+        return nullptr;
     }
-    return nullptr;
+    const CDeterministicMNCPtr* p = mnCollateralMap.find_value(collateralOutpoint);
+    return p ? *p : nullptr;
 }
 
 CDeterministicMNCPtr CDeterministicMNList::GetMNByService(const CService& addr) const
 {
-    for (const auto& pair : mnMap) {
-        if (pair.second->state.addr == addr) {
-            return pair.second;
-        }
+    const uint256* proTxHash = mnUniquePropertyMap.find_value(GetUniquePropertyHash(addr));
+    if (!proTxHash) {
+        return nullptr;
     }
-    return nullptr;
+    auto mn = GetMN(*proTxHash);
+    return mn && mn->state.addr == addr ? mn : nullptr;
+}
+
+size_t CDeterministicMNList::CollateralFilterBit(const COutPoint& outpoint)
+{
+    // Collateral txids are random, their first bytes do as a hash
+    return (outpoint.hash.GetCheapHash() + outpoint.n) % COLLATERAL_FILTER_BITS;
+}
+
+bool CDeterministicMNList::MayBeCollateral(const COutPoint& outpoint) const
+{
+    if (!collateralFilter) {
+        return false;
+    }
+    const size_t nBit = CollateralFilterBit(outpoint);
+    return ((*collateralFilter)[nBit / 64] >> (nBit % 64)) & 1;
 }
 
 bool CDeterministicMNList::HasUniqueProperty(const uint256& propertyHash) const
@@ -180,50 +181,140 @@ uint256 CDeterministicMNList::GetUniquePropertyHash(const CKeyID& keyId) const
 std::vector<CDeterministicMNCPtr> CDeterministicMNList::GetValidMNsForPayment() const
 {
     std::vector<CDeterministicMNCPtr> result;
-    for (const auto& pair : mnMap) {
-        if (pair.second->IsValid()) {
-            result.push_back(pair.second);
-        }
+    result.reserve(mnPaymentQueue.size());
+    for (const auto& pair : mnPaymentQueue) {
+        result.push_back(pair.second);
     }
     return result;
 }
 
-CDeterministicMNCPtr CDeterministicMNList::GetMNPayee(const uint256& blockHashForPayment) const
+CDeterministicMNCPtr CDeterministicMNList::GetMNPayee() const
 {
-    // Get all valid masternodes
-    std::vector<CDeterministicMNCPtr> validMNs = GetValidMNsForPayment();
-    if (validMNs.empty()) {
+    if (mnPaymentQueue.empty()) {
         return nullptr;
     }
+    return mnPaymentQueue.begin()->second;
+}
 
-    // Calculate scores and find the one with lowest score (highest priority)
-    CDeterministicMNCPtr winner = nullptr;
-    arith_uint256 lowestScore = arith_uint256();
-    bool first = true;
+std::vector<CDeterministicMNCPtr> CDeterministicMNList::GetProjectedMNPayees(int nCount) const
+{
+    std::vector<CDeterministicMNCPtr> result;
+    if (nCount <= 0 || mnPaymentQueue.empty()) {
+        return result;
+    }
+    result.reserve(nCount);
 
-    for (const auto& mn : validMNs) {
-        arith_uint256 score = mn->CalcScore(blockHashForPayment);
-        
-        if (first || score < lowestScore) {
-            winner = mn;
-            lowestScore = score;
-            first = false;
+    // Every payee moves to the back of the queue, so the order simply repeats
+    auto it = mnPaymentQueue.begin();
+    while ((int)result.size() < nCount) {
+        if (it == mnPaymentQueue.end()) {
+            it = mnPaymentQueue.begin();
         }
+        result.push_back(it->second);
+        ++it;
     }
-
-    return winner;
+    return result;
 }
 
-CDeterministicMNList CDeterministicMNList::AddMN(const CDeterministicMNCPtr& mn) const
+void CDeterministicMNList::AddMNInternal(const CDeterministicMNCPtr& mn)
 {
-    CDeterministicMNList result(*this);
-    result.mnMap[mn->proTxHash] = mn;
+    mnMap.set(mn->proTxHash, mn);
     
     // Add unique property entries
-    result.mnUniquePropertyMap[GetUniquePropertyHash(mn->collateralOutpoint)] = mn->proTxHash;
-    result.mnUniquePropertyMap[GetUniquePropertyHash(mn->state.addr)] = mn->proTxHash;
-    result.mnUniquePropertyMap[GetUniquePropertyHash(mn->state.keyIDOwner)] = mn->proTxHash;
+    mnUniquePropertyMap.set(GetUniquePropertyHash(mn->collateralOutpoint), mn->proTxHash);
+    mnUniquePropertyMap.set(GetUniquePropertyHash(mn->state.addr), mn->proTxHash);
+    mnUniquePropertyMap.set(GetUniquePropertyHash(mn->state.keyIDOwner), mn->proTxHash);
+
+    mnCollateralMap.set(mn->collateralOutpoint, mn);
+    const size_t nBit = CollateralFilterBit(mn->collateralOutpoint);
+    if (!MayBeCollateral(mn->collateralOutpoint)) {
+        auto filter = collateralFilter ? std::make_shared<CollateralFilter>(*collateralFilter) : std::make_shared<CollateralFilter>();
+        if (!collateralFilter) {
+            filter->fill(0);
+        }
+        (*filter)[nBit / 64] |= uint64_t(1) << (nBit % 64);
+        collateralFilter = std::move(filter);
+    }
+
+    if (mn->IsValid()) {
+        mnPaymentQueue.set(std::make_pair(mn->GetPaymentQueueHeight(), mn->proTxHash), mn);
+    }
+}
+
+void CDeterministicMNList::UpdateMNInternal(const CDeterministicMNCPtr& oldMN, const CDeterministicMNState& newState)
+{
+    // Remove old address from unique map if changed
+    if (oldMN->state.addr != newState.addr) {
+        mnUniquePropertyMap.erase(GetUniquePropertyHash(oldMN->state.addr));
+        mnUniquePropertyMap.set(GetUniquePropertyHash(newState.addr), oldMN->proTxHash);
+    }
+    
+    // Create updated MN entry
+    auto newMN = std::make_shared<CDeterministicMN>(*oldMN);
+    newMN->state = newState;
+    mnMap.set(oldMN->proTxHash, newMN);
+    mnCollateralMap.set(newMN->collateralOutpoint, newMN);
+
+    // The queue holds the MN pointer, so re-insert even if the position is unchanged
+    if (oldMN->IsValid()) {
+        mnPaymentQueue.erase(std::make_pair(oldMN->GetPaymentQueueHeight(), oldMN->proTxHash));
+    }
+    if (newMN->IsValid()) {
+        mnPaymentQueue.set(std::make_pair(newMN->GetPaymentQueueHeight(), newMN->proTxHash), newMN);
+    }
+}
+
+void CDeterministicMNList::RemoveMNInternal(const CDeterministicMNCPtr& mn)
+{
+    mnMap.erase(mn->proTxHash);
     
+    // Remove from unique property map
+    mnUniquePropertyMap.erase(GetUniquePropertyHash(mn->collateralOutpoint));
+    mnUniquePropertyMap.erase(GetUniquePropertyHash(mn->state.addr));
+    mnUniquePropertyMap.erase(GetUniquePropertyHash(mn->state.keyIDOwner));
+
+    if (mn->IsValid()) {
+        mnPaymentQueue.erase(std::make_pair(mn->GetPaymentQueueHeight(), mn->proTxHash));
+    }
+
+    // Another collateral may share the bit, so the filter is rebuilt (removals are rare)
+    mnCollateralMap.erase(mn->collateralOutpoint);
+    auto filter = std::make_shared<CollateralFilter>();
+    filter->fill(0);
+    for (const auto& pair : mnCollateralMap) {
+        const size_t nBit = CollateralFilterBit(pair.first);
+        (*filter)[nBit / 64] |= uint64_t(1) << (nBit % 64);
+    }
+    collateralFilter = std::move(filter);
+}
+
+void CDeterministicMNList::RebuildPaymentQueue()
+{
+    mnPaymentQueue.clear();
+    for (const auto& pair : mnMap) {
+        if (pair.second->IsValid()) {
+            mnPaymentQueue.set(std::make_pair(pair.second->GetPaymentQueueHeight(), pair.first), pair.second);
+        }
+    }
+}
+
+void CDeterministicMNList::RebuildCollateralIndex()
+{
+    mnCollateralMap.clear();
+    auto filter = std::make_shared<CollateralFilter>();
+    filter->fill(0);
+    for (const auto& pair : mnMap) {
+        mnCollateralMap.set(pair.second->collateralOutpoint, pair.second);
+        const size_t nBit = CollateralFilterBit(pair.second->collateralOutpoint);
+        (*filter)[nBit / 64] |= uint64_t(1) << (nBit % 64);
+    }
+    collateralFilter = std::move(filter);
+}
+
+CDeterministicMNList CDeterministicMNList::AddMN(const CDeterministicMNCPtr& mn) const
+{
+    CDeterministicMNList result(*this);
+    result.AddMNInternal(mn);
     result.nTotalRegisteredCount++;
     return result;
 }
@@ -236,18 +327,7 @@ CDeterministicMNList CDeterministicMNList::UpdateMN(const uint256& proTxHash, co
     }
 
     CDeterministicMNList result(*this);
-    
-    // Remove old address from unique map if changed
-    if (mn->state.addr != newState.addr) {
-        result.mnUniquePropertyMap.erase(GetUniquePropertyHash(mn->state.addr));
-        result.mnUniquePropertyMap[GetUniquePropertyHash(newState.addr)] = proTxHash;
-    }
-    
-    // Create updated MN entry
-    auto newMN = std::make_shared<CDeterministicMN>(*mn);
-    newMN->state = newState;
-    result.mnMap[proTxHash] = newMN;
-    
+    result.UpdateMNInternal(mn, newState);
     return result;
 }
 
@@ -259,16 +339,95 @@ CDeterministicMNList CDeterministicMNList::RemoveMN(const uint256& proTxHash) co
     }
 
     CDeterministicMNList result(*this);
-    result.mnMap.erase(proTxHash);
-    
-    // Remove from unique property map
-    result.mnUniquePropertyMap.erase(GetUniquePropertyHash(mn->collateralOutpoint));
-    result.mnUniquePropertyMap.erase(GetUniquePropertyHash(mn->state.addr));
-    result.mnUniquePropertyMap.erase(GetUniquePropertyHash(mn->state.keyIDOwner));
-    
+    result.RemoveMNInternal(mn);
     return result;
 }
 
+CDeterministicMNListDiff CDeterministicMNList::BuildDiff(const CDeterministicMNList& to) const
+{
+    CDeterministicMNListDiff diff;
+    diff.blockHash = to.blockHash;
+    diff.nHeight = to.nHeight;
+    diff.nTotalRegisteredCount = to.nTotalRegisteredCount;
+
+    if (mnMap.shares_root_with(to.mnMap)) {
+        return diff;
+    }
+
+    // Both maps are ordered by proTxHash, so walk them side by side
+    auto itFrom = mnMap.begin();
+    auto itTo = to.mnMap.begin();
+    while (itFrom != mnMap.end() || itTo != to.mnMap.end()) {
+        if (itTo == to.mnMap.end() || (itFrom != mnMap.end() && itFrom->first < itTo->first)) {
+            diff.removedMns.emplace(itFrom->first);
+            ++itFrom;
+        } else if (itFrom == mnMap.end() || itTo->first < itFrom->first) {
+            diff.addedMNs.emplace_back(itTo->second);
+            ++itTo;
+        } else {
+            if (itFrom->second != itTo->second && itFrom->second->state != itTo->second->state) {
+                diff.updatedMNs.emplace(itTo->first, itTo->second->state);
+            }
+            ++itFrom;
+            ++itTo;
+        }
+    }
+
+    return diff;
+}
+
+CDeterministicMNList CDeterministicMNList::ApplyDiff(const CDeterministicMNListDiff& diff) const
+{
+    CDeterministicMNList result(*this);
+    result.blockHash = diff.blockHash;
+    result.nHeight = diff.nHeight;
+    result.nTotalRegisteredCount = diff.nTotalRegisteredCount;
+
+    for (const auto& proTxHash : diff.removedMns) {
+        auto mn = result.GetMN(proTxHash);
+        if (mn) {
+            result.RemoveMNInternal(mn);
+        }
+    }
+    for (const auto& mn : diff.addedMNs) {
+        result.AddMNInternal(mn);
+    }
+    for (const auto& [proTxHash, newState] : diff.updatedMNs) {
+        auto mn = result.GetMN(proTxHash);
+        if (mn) {
+            result.UpdateMNInternal(mn, newState);
+        }
+    }
+
+    return result;
+}
+
+size_t CDeterministicMNList::GetMemoryUsage() const
+{
+    return sizeof(CDeterministicMNList)
+        + memusage::DynamicUsage(mnMap)
+        + memusage::DynamicUsage(mnUniquePropertyMap)
+        + memusage::DynamicUsage(mnPaymentQueue)
+        + memusage::DynamicUsage(mnCollateralMap)
+        + (collateralFilter ? memusage::MallocUsage(sizeof(CollateralFilter)) : 0)
+        + mnMap.size() * memusage::MallocUsage(sizeof(CDeterministicMN));
+}
+
+size_t CDeterministicMNList::GetIncrementalMemoryUsage(size_t nChanges) const
+{
+    // Each change copies one path in mnMap, up to three paths in the unique
+    // property index, two in the payment queue and one in the collateral
+    // index, plus (for adds and updates) one CDeterministicMN. A list that
+    // adds or removes MNs also gets its own collateral filter.
+    size_t nPerChange = memusage::IncrementalDynamicUsage(mnMap)
+        + 3 * memusage::IncrementalDynamicUsage(mnUniquePropertyMap)
+        + 2 * memusage::IncrementalDynamicUsage(mnPaymentQueue)
+        + memusage::IncrementalDynamicUsage(mnCollateralMap)
+        + memusage::MallocUsage(sizeof(CDeterministicMN));
+    size_t nFilter = nChanges ? memusage::MallocUsage(sizeof(CollateralFilter)) : 0;
+    return sizeof(CDeterministicMNList) + nFilter + nChanges * nPerChange;
+}
+
 std::string CDeterministicMNList::ToString() const
 {
     std::ostringstream ss;
@@ -288,6 +447,8 @@ std::string CDeterministicMNList::ToString() const
 CDeterministicMNManager::CDeterministicMNManager(CEvoDB& _evoDb)
     : evoDb(_evoDb)
 {
+    int64_t nCacheMB = std::max<int64_t>(1, gArgs.GetArg("-mnlistcachemb", DEFAULT_MNLIST_CACHE_MB));
+    nMaxCacheUsage = (size_t)nCacheMB << 20;
 }
 
 bool CDeterministicMNManager::Init()
@@ -312,19 +473,32 @@ bool CDeterministicMNManager::ProcessBlock(const CBlock& block, const CBlockInde
         prevList = std::make_shared<CDeterministicMNList>();
     }
 
-    // Build the new list by processing transactions
+    // Build the new list by processing transactions, starting from the
+    // previous list (the entries themselves are shared, not copied)
     CDeterministicMNList newList = *prevList;
-    newList = CDeterministicMNList(pindex->GetBlockHash(), pindex->nHeight);
-    
-    // Copy existing masternodes
-    for (const auto& pair : prevList->GetMnMap()) {
-        newList = newList.AddMN(pair.second);
-    }
+    newList.SetBlockHash(pindex->GetBlockHash());
+    newList.SetHeight(pindex->nHeight);
+    size_t nChanges = 0;
 
     // Process each transaction in the block
     for (size_t i = 0; i < block.vtx.size(); i++) {
         const CTransaction& tx = *block.vtx[i];
-        
+
+        // A spent collateral drops its MN from the list. The prefilter
+        // turns this into a bit test for almost every input.
+        if (!tx.IsCoinBase()) {
+            for (const CTxIn& txin : tx.vin) {
+                auto mn = newList.GetMNByCollateral(txin.prevout);
+                if (mn) {
+                    newList = newList.RemoveMN(mn->proTxHash);
+                    nChanges++;
+
+                    LogPrintf("CDeterministicMNManager::%s -- MN collateral spent: %s, tx=%s\n",
+                             __func__, mn->proTxHash.ToString(), tx.GetHash().ToString());
+                }
+            }
+        }
+
         if (!IsTxTypeSpecial(tx)) {
             continue;
         }
@@ -350,9 +524,10 @@ bool CDeterministicMNManager::ProcessBlock(const CBlock& block, const CBlockInde
                 newMN->state.addr = proTx.addr;
                 newMN->state.scriptPayout = proTx.scriptPayout;
                 newMN->internalId = newList.GetTotalRegisteredCount();
-                newList.IncrementTotalRegisteredCount();
 
+                // AddMN bumps the total registered count
                 newList = newList.AddMN(newMN);
+                nChanges++;
                 
                 LogPrintf("CDeterministicMNManager::%s -- New MN registered: %s\n", 
                          __func__, newMN->ToString());
@@ -377,6 +552,7 @@ bool CDeterministicMNManager::ProcessBlock(const CBlock& block, const CBlockInde
                 }
 
                 newList = newList.UpdateMN(proTx.proTxHash, newState);
+                nChanges++;
                 
                 LogPrintf("CDeterministicMNManager::%s -- MN service updated: %s\n", 
                          __func__, proTx.proTxHash.ToString());
@@ -413,6 +589,7 @@ bool CDeterministicMNManager::ProcessBlock(const CBlock& block, const CBlockInde
                 }
 
                 newList = newList.UpdateMN(proTx.proTxHash, newState);
+                nChanges++;
                 
                 LogPrintf("CDeterministicMNManager::%s -- MN registrar updated: %s\n", 
                          __func__, proTx.proTxHash.ToString());
@@ -435,6 +612,7 @@ bool CDeterministicMNManager::ProcessBlock(const CBlock& block, const CBlockInde
                 newState.nPoSeBanHeight = pindex->nHeight;
 
                 newList = newList.UpdateMN(proTx.proTxHash, newState);
+                nChanges++;
                 
                 LogPrintf("CDeterministicMNManager::%s -- MN revoked: %s, reason=%d\n", 
                          __func__, proTx.proTxHash.ToString(), proTx.nReason);
@@ -446,17 +624,28 @@ bool CDeterministicMNManager::ProcessBlock(const CBlock& block, const CBlockInde
         }
     }
 
+    // The MN at the front of the previous list's payment queue is paid in
+    // this block and moves to the back of the queue
+    auto payee = prevList->GetMNPayee();
+    if (payee) {
+        auto mn = newList.GetMN(payee->proTxHash);
+        if (mn && mn->IsValid()) {
+            CDeterministicMNState newState = mn->state;
+            newState.nLastPaidHeight = pindex->nHeight;
+            newList = newList.UpdateMN(mn->proTxHash, newState);
+            nChanges++;
+        }
+    }
+
     if (!fJustCheck) {
         // Store the new list
         auto newListPtr = std::make_shared<CDeterministicMNList>(newList);
-        mnListsCache[pindex->GetBlockHash()] = newListPtr;
+        AddListToCache(newListPtr, newListPtr->GetIncrementalMemoryUsage(nChanges));
+        IndexList(newListPtr);
         tipList = newListPtr;
         
         // Persist to database
-        SaveListToDb(newListPtr);
-        
-        // Cleanup old cache entries
-        CleanupCache();
+        SaveListToDb(newListPtr, prevList);
     }
 
     return true;
@@ -467,7 +656,8 @@ bool CDeterministicMNManager::UndoBlock(const CBlock& block, const CBlockIndex*
     LOCK(cs);
 
     // Remove the list for this block from cache
-    mnListsCache.erase(pindex->GetBlockHash());
+    RemoveListFromCache(pindex->GetBlockHash());
+    UnindexList(pindex);
 
     // Set tip to previous block's list
     if (pindex->pprev) {
@@ -481,27 +671,69 @@ bool CDeterministicMNManager::UndoBlock(const CBlock& block, const CBlockIndex*
 
 CDeterministicMNListCPtr CDeterministicMNManager::GetListForBlock(const CBlockIndex* pindex)
 {
-    LOCK(cs);
-
     if (!pindex) {
         return std::make_shared<CDeterministicMNList>();
     }
+    if (auto indexed = GetIndexedList(pindex)) {
+        return indexed;
+    }
+
+    LOCK(cs);
 
     // Check cache first
-    auto it = mnListsCache.find(pindex->GetBlockHash());
-    if (it != mnListsCache.end()) {
-        return it->second;
+    if (auto cached = GetCachedList(pindex->GetBlockHash())) {
+        nCacheHits++;
+        return cached;
     }
+    nCacheMisses++;
+
+    // Walk back to the nearest cached list or stored snapshot, collecting
+    // the per-block diffs on the way
+    std::vector<std::shared_ptr<const CDeterministicMNListDiff>> vecDiffs;
+    CDeterministicMNListCPtr baseList;
+    bool fBaseCached = false;
+    for (const CBlockIndex* pcur = pindex; pcur; pcur = pcur->pprev) {
+        if (pcur != pindex && (baseList = GetCachedList(pcur->GetBlockHash()))) {
+            fBaseCached = true;
+            break;
+        }
 
-    // Try to load from database
-    auto list = LoadListFromDb(pindex->GetBlockHash());
-    if (list) {
-        mnListsCache[pindex->GetBlockHash()] = list;
-        return list;
+        baseList = LoadListFromDb(pcur->GetBlockHash());
+        if (baseList) {
+            break;
+        }
+
+        auto diff = evoDb.ReadShared<CDeterministicMNListDiff>(std::make_pair(DB_LIST_DIFF, pcur->GetBlockHash()));
+        if (!diff) {
+            // Nothing stored below this block, start from an empty list
+            break;
+        }
+        vecDiffs.emplace_back(std::move(diff));
     }
 
-    // Build from scratch if not found (shouldn't happen in normal operation)
-    return std::make_shared<CDeterministicMNList>(pindex->GetBlockHash(), pindex->nHeight);
+    if (!baseList && vecDiffs.empty()) {
+        // Build from scratch if not found (shouldn't happen in normal operation)
+        return std::make_shared<CDeterministicMNList>(pindex->GetBlockHash(), pindex->nHeight);
+    }
+
+    CDeterministicMNList list = baseList ? *baseList : CDeterministicMNList();
+    for (auto itDiff = vecDiffs.rbegin(); itDiff != vecDiffs.rend(); ++itDiff) {
+        list = list.ApplyDiff(**itDiff);
+    }
+
+    auto listPtr = std::make_shared<CDeterministicMNList>(std::move(list));
+    size_t nUsage;
+    if (fBaseCached) {
+        size_t nChanges = 0;
+        for (const auto& diff : vecDiffs) {
+            nChanges += diff->GetChangeCount();
+        }
+        nUsage = listPtr->GetIncrementalMemoryUsage(nChanges);
+    } else {
+        nUsage = listPtr->GetMemoryUsage();
+    }
+    AddListToCache(listPtr, nUsage);
+    return listPtr;
 }
 
 CDeterministicMNListCPtr CDeterministicMNManager::GetListAtChainTip()
@@ -536,41 +768,182 @@ bool CDeterministicMNManager::IsProTxWithCollateral(const COutPoint& outpoint) c
 
 CDeterministicMNCPtr CDeterministicMNManager::GetMNPayee(const CBlockIndex* pindex) const
 {
-    LOCK(cs);
-    
     if (!pindex) return nullptr;
     
-    auto list = const_cast<CDeterministicMNManager*>(this)->GetListForBlock(pindex);
+    // Usually the tip or just below it, served from the height index without cs
+    auto list = GetIndexedList(pindex);
+    if (!list) {
+        list = const_cast<CDeterministicMNManager*>(this)->GetListForBlock(pindex);
+    }
     if (!list) return nullptr;
     
-    return list->GetMNPayee(pindex->GetBlockHash());
+    return list->GetMNPayee();
 }
 
 void CDeterministicMNManager::UpdatedBlockTip(const CBlockIndex* pindex)
 {
     LOCK(cs);
     tipList = GetListForBlock(pindex);
+    if (pindex) {
+        IndexList(tipList);
+    }
 }
 
-void CDeterministicMNManager::SaveListToDb(const CDeterministicMNListCPtr& list)
+void CDeterministicMNManager::SaveListToDb(const CDeterministicMNListCPtr& list, const CDeterministicMNListCPtr& prevList)
 {
-    evoDb.Write(std::make_pair(DB_LIST_SNAPSHOT, list->GetBlockHash()), *list);
+    // Genesis of the list (or a gap) needs a snapshot to rebuild from later
+    if (!prevList || prevList->GetHeight() < 0 || list->GetHeight() % DMN_SNAPSHOT_INTERVAL == 0) {
+        evoDb.Write(std::make_pair(DB_LIST_SNAPSHOT, list->GetBlockHash()), *list);
+        return;
+    }
+
+    evoDb.Write(std::make_pair(DB_LIST_DIFF, list->GetBlockHash()), prevList->BuildDiff(*list));
 }
 
 CDeterministicMNListCPtr CDeterministicMNManager::LoadListFromDb(const uint256& blockHash)
 {
-    CDeterministicMNList list;
-    if (evoDb.Read(std::make_pair(DB_LIST_SNAPSHOT, blockHash), list)) {
-        return std::make_shared<CDeterministicMNList>(list);
+    return evoDb.ReadShared<CDeterministicMNList>(std::make_pair(DB_LIST_SNAPSHOT, blockHash));
+}
+
+size_t CDeterministicMNManager::EraseListsBelow(int nKeepHeight, size_t nMaxErase)
+{
+    AssertLockHeld(cs_main);
+    LOCK(cs);
+
+    // Lists from the last snapshot at or below nKeepHeight on are rebuilt
+    // from that snapshot and the diffs after it, so it has to be there
+    const int nSnapshotHeight = nKeepHeight - nKeepHeight % DMN_SNAPSHOT_INTERVAL;
+    const CBlockIndex* pindexSnapshot = chainActive[nSnapshotHeight];
+    if (nSnapshotHeight <= 0 || !pindexSnapshot || evoDb.HasTransaction() ||
+        !evoDb.Exists(std::make_pair(DB_LIST_SNAPSHOT, pindexSnapshot->GetBlockHash()))) {
+        return 0;
     }
-    return nullptr;
+
+    std::vector<std::pair<std::string, uint256>> vErase;
+    for (const std::string& strPrefix : {DB_LIST_DIFF, DB_LIST_SNAPSHOT}) {
+        std::unique_ptr<CDBIterator> pcursor(evoDb.GetRawDB().NewIterator());
+        pcursor->Seek(std::make_pair(strPrefix, uint256()));
+        while (pcursor->Valid() && vErase.size() < nMaxErase) {
+            std::pair<std::string, uint256> key;
+            if (!pcursor->GetKey(key) || key.first != strPrefix) {
+                break;
+            }
+            // Blocks that aren't in the index any more are dropped as well
+            BlockMap::const_iterator mi = mapBlockIndex.find(key.second);
+            if (mi == mapBlockIndex.end() || mi->second->nHeight < nSnapshotHeight) {
+                vErase.push_back(key);
+            }
+            pcursor->Next();
+        }
+    }
+    if (!vErase.empty()) {
+        evoDb.EraseMany(vErase);
+    }
+    return vErase.size();
+}
+
+void CDeterministicMNManager::CompactLists()
+{
+    uint256 hashLast;
+    memset(hashLast.begin(), 0xff, hashLast.size());
+    evoDb.GetRawDB().CompactRange(std::make_pair(DB_LIST_DIFF, uint256()), std::make_pair(DB_LIST_DIFF, hashLast));
+    evoDb.GetRawDB().CompactRange(std::make_pair(DB_LIST_SNAPSHOT, uint256()), std::make_pair(DB_LIST_SNAPSHOT, hashLast));
+}
+
+CDeterministicMNListCPtr CDeterministicMNManager::GetCachedList(const uint256& blockHash)
+{
+    AssertLockHeld(cs);
+
+    auto it = mnListsCache.find(blockHash);
+    if (it == mnListsCache.end()) {
+        return nullptr;
+    }
+    mnListsLru.splice(mnListsLru.begin(), mnListsLru, it->second.itLru);
+    return it->second.list;
+}
+
+void CDeterministicMNManager::AddListToCache(const CDeterministicMNListCPtr& list, size_t nUsage)
+{
+    AssertLockHeld(cs);
+
+    RemoveListFromCache(list->GetBlockHash());
+    mnListsLru.push_front(list->GetBlockHash());
+    mnListsCache.emplace(list->GetBlockHash(), CListCacheEntry{list, nUsage, mnListsLru.begin()});
+    nCacheUsage += nUsage;
+    CleanupCache();
+}
+
+void CDeterministicMNManager::RemoveListFromCache(const uint256& blockHash)
+{
+    AssertLockHeld(cs);
+
+    auto it = mnListsCache.find(blockHash);
+    if (it == mnListsCache.end()) {
+        return;
+    }
+    nCacheUsage -= it->second.nUsage;
+    mnListsLru.erase(it->second.itLru);
+    mnListsCache.erase(it);
 }
 
 void CDeterministicMNManager::CleanupCache()
 {
-    while (mnListsCache.size() > MAX_CACHE_SIZE) {
-        // Remove oldest entry (simple approach - could be improved with LRU)
-        mnListsCache.erase(mnListsCache.begin());
+    AssertLockHeld(cs);
+
+    // Usage is an estimate: an evicted list may still share nodes with lists
+    // that stay cached. The most recently used list is always kept.
+    while (nCacheUsage > nMaxCacheUsage && mnListsCache.size() > 1) {
+        RemoveListFromCache(mnListsLru.back());
+    }
+}
+
+size_t CDeterministicMNManager::EvictCache(size_t nBytes)
+{
+    LOCK(cs);
+
+    const size_t nUsageBefore = nCacheUsage;
+    while (nUsageBefore - nCacheUsage < nBytes && mnListsCache.size() > 1) {
+        RemoveListFromCache(mnListsLru.back());
+    }
+    return nUsageBefore - nCacheUsage;
+}
+
+CDeterministicMNManager::CacheStats CDeterministicMNManager::GetCacheStats() const
+{
+    LOCK(cs);
+    return CacheStats{mnListsCache.size(), nCacheUsage, nMaxCacheUsage, nCacheHits, nCacheMisses, nIndexHits.load()};
+}
+
+CDeterministicMNListCPtr CDeterministicMNManager::GetIndexedList(const CBlockIndex* pindex) const
+{
+    if (pindex->nHeight < 0) {
+        return nullptr;
+    }
+    auto list = std::atomic_load(&heightIndex[pindex->nHeight % MNLIST_HEIGHT_INDEX_SIZE]);
+    if (!list || list->GetHeight() != pindex->nHeight || list->GetBlockHash() != pindex->GetBlockHash()) {
+        return nullptr;
+    }
+    nIndexHits++;
+    return list;
+}
+
+void CDeterministicMNManager::IndexList(const CDeterministicMNListCPtr& list)
+{
+    if (!list || list->GetHeight() < 0) {
+        return;
+    }
+    std::atomic_store(&heightIndex[list->GetHeight() % MNLIST_HEIGHT_INDEX_SIZE], list);
+}
+
+void CDeterministicMNManager::UnindexList(const CBlockIndex* pindex)
+{
+    if (pindex->nHeight < 0) {
+        return;
+    }
+    auto& slot = heightIndex[pindex->nHeight % MNLIST_HEIGHT_INDEX_SIZE];
+    auto list = std::atomic_load(&slot);
+    if (list && list->GetBlockHash() == pindex->GetBlockHash()) {
+        std::atomic_store(&slot, CDeterministicMNListCPtr());
     }
 }
 
@@ -8,6 +8,7 @@
 #include "arith_uint256.h"
 #include "evo/evodb.h"
 #include "netaddress.h"
+#include "persistentmap.h"
 #include "primitives/transaction.h"
 #include "pubkey.h"
 #include "script/script.h"
@@ -15,6 +16,10 @@
 #include "sync.h"
 #include "uint256.h"
 
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <list>
 #include <map>
 #include <memory>
 #include <set>
@@ -127,6 +132,12 @@ public:
 
     // Status checks
     bool IsValid() const { return !state.IsBanned() && state.nRevocationReason == 0; }
+
+    // Position in the payment queue: the height this MN was last paid, registered or revived
+    int GetPaymentQueueHeight() const
+    {
+        return std::max(state.nLastPaidHeight, std::max(state.nRegisteredHeight, state.nPoSeRevivedHeight));
+    }
     
     // Calculate score for payment ordering
     arith_uint256 CalcScore(const uint256& blockHash) const;
@@ -134,18 +145,62 @@ public:
     std::string ToString() const;
 };
 
+/**
+ * CDeterministicMNListDiff - Changes between two consecutive masternode lists
+ * 
+ * One diff is stored per block, so the evo database only grows with the
+ * number of changes instead of with the size of the list. Full snapshots
+ * are written every DMN_SNAPSHOT_INTERVAL blocks to bound the number of
+ * diffs that have to be applied to rebuild a list.
+ */
+class CDeterministicMNListDiff
+{
+public:
+    uint256 blockHash;
+    int nHeight{-1};
+    uint64_t nTotalRegisteredCount{0};
+    
+    std::vector<CDeterministicMNCPtr> addedMNs;
+    std::map<uint256, CDeterministicMNState> updatedMNs; // proTxHash -> new state
+    std::set<uint256> removedMns;
+
+    ADD_SERIALIZE_METHODS;
+
+    template <typename Stream, typename Operation>
+    inline void SerializationOp(Stream& s, Operation ser_action)
+    {
+        READWRITE(blockHash);
+        READWRITE(nHeight);
+        READWRITE(nTotalRegisteredCount);
+        READWRITE(addedMNs);
+        READWRITE(updatedMNs);
+        READWRITE(removedMns);
+    }
+
+    bool HasChanges() const { return !addedMNs.empty() || !updatedMNs.empty() || !removedMns.empty(); }
+    size_t GetChangeCount() const { return addedMNs.size() + updatedMNs.size() + removedMns.size(); }
+};
+
 /**
  * CDeterministicMNList - The deterministic masternode list
  * 
  * This is the complete state of all registered masternodes at a given block.
  * It is computed deterministically from the blockchain and can be efficiently
- * diffed between blocks.
+ * diffed between blocks. Consecutive lists share almost all of their storage.
  */
 class CDeterministicMNList
 {
 public:
-    using MnMap = std::map<uint256, CDeterministicMNCPtr>;
-    using MnUniquePropertyMap = std::map<uint256, uint256>; // property hash -> proTxHash
+    // Persistent maps: copying a list is O(1) and each AddMN/UpdateMN/RemoveMN
+    // only allocates O(log n) nodes, the rest is shared with the parent list
+    using MnMap = persistentmap<uint256, CDeterministicMNCPtr>;
+    using MnUniquePropertyMap = persistentmap<uint256, uint256>; // property hash -> proTxHash
+    using MnPaymentQueue = persistentmap<std::pair<int, uint256>, CDeterministicMNCPtr>; // (queue height, proTxHash) -> MN
+    using MnCollateralMap = persistentmap<COutPoint, CDeterministicMNCPtr>; // collateral -> MN
+
+    // Bits of the collateral prefilter, see MayBeCollateral
+    static const size_t COLLATERAL_FILTER_BITS = 1 << 16;
+    using CollateralFilter = std::array<uint64_t, COLLATERAL_FILTER_BITS / 64>;
 
 private:
     uint256 blockHash;
@@ -157,6 +212,17 @@ private:
     // Unique property indexes for fast lookups
     MnUniquePropertyMap mnUniquePropertyMap;
 
+    // Valid MNs in payment order, the front entry is paid next. Not
+    // serialized, it is rebuilt from mnMap when a list is loaded.
+    MnPaymentQueue mnPaymentQueue;
+
+    // Collateral outpoint index and a bit per collateral txid in front of it,
+    // so checking an input that spends no collateral costs one bit test.
+    // Neither is serialized, both are rebuilt from mnMap when a list is
+    // loaded. The filter is copied on write and otherwise shared.
+    MnCollateralMap mnCollateralMap;
+    std::shared_ptr<const CollateralFilter> collateralFilter;
+
 public:
     CDeterministicMNList() = default;
     explicit CDeterministicMNList(const uint256& _blockHash, int _nHeight)
@@ -172,13 +238,17 @@ public:
         READWRITE(nTotalRegisteredCount);
         READWRITE(mnMap);
         READWRITE(mnUniquePropertyMap);
+        if (ser_action.ForRead()) {
+            RebuildPaymentQueue();
+            RebuildCollateralIndex();
+        }
     }
 
     // Getters
     const uint256& GetBlockHash() const { return blockHash; }
     int GetHeight() const { return nHeight; }
     size_t GetAllMNsCount() const { return mnMap.size(); }
-    size_t GetValidMNsCount() const;
+    size_t GetValidMNsCount() const { return mnPaymentQueue.size(); }
     uint64_t GetTotalRegisteredCount() const { return nTotalRegisteredCount; }
     void IncrementTotalRegisteredCount() { nTotalRegisteredCount++; }
     const MnMap& GetMnMap() const { return mnMap; }
@@ -189,25 +259,38 @@ public:
     CDeterministicMNCPtr GetMNByCollateral(const COutPoint& collateralOutpoint) const;
     CDeterministicMNCPtr GetMNByService(const CService& addr) const;
 
+    // False if no MN in this list uses outpoint as collateral, true if one may
+    bool MayBeCollateral(const COutPoint& outpoint) const;
+
     // Check for unique property conflicts
     bool HasUniqueProperty(const uint256& propertyHash) const;
     uint256 GetUniquePropertyHash(const COutPoint& outpoint) const;
     uint256 GetUniquePropertyHash(const CService& addr) const;
     uint256 GetUniquePropertyHash(const CKeyID& keyId) const;
 
-    // Get valid masternodes for payment
+    // Get valid masternodes in payment order
     std::vector<CDeterministicMNCPtr> GetValidMNsForPayment() const;
 
-    // Calculate which masternode should be paid
-    CDeterministicMNCPtr GetMNPayee(const uint256& blockHash) const;
+    // The masternode to be paid in the block following this list (O(log n))
+    CDeterministicMNCPtr GetMNPayee() const;
+
+    // The payees of the next nCount blocks, assuming the list does not change otherwise
+    std::vector<CDeterministicMNCPtr> GetProjectedMNPayees(int nCount) const;
 
     // Modification (returns new list, original is immutable)
     CDeterministicMNList AddMN(const CDeterministicMNCPtr& mn) const;
     CDeterministicMNList UpdateMN(const uint256& proTxHash, const CDeterministicMNState& newState) const;
     CDeterministicMNList RemoveMN(const uint256& proTxHash) const;
 
-    // Apply block updates
-    CDeterministicMNList ApplyDiff(const CBlock& block, const CBlockIndex* pindex) const;
+    // Set the block this list belongs to
+    void SetBlockHash(const uint256& _blockHash) { blockHash = _blockHash; }
+    void SetHeight(int _nHeight) { nHeight = _nHeight; }
+
+    // Compute the changes needed to turn this list into `to`
+    CDeterministicMNListDiff BuildDiff(const CDeterministicMNList& to) const;
+
+    // Apply a diff built on top of this list
+    CDeterministicMNList ApplyDiff(const CDeterministicMNListDiff& diff) const;
 
     // Iterate over all masternodes
     template <typename Func>
@@ -221,14 +304,35 @@ public:
         }
     }
 
+    // Approximate heap usage of this list if it shared nothing with other lists
+    size_t GetMemoryUsage() const;
+
+    // Approximate heap usage added by deriving this list from its parent with nChanges modifications
+    size_t GetIncrementalMemoryUsage(size_t nChanges) const;
+
     std::string ToString() const;
+
+private:
+    // In-place modification helpers (maintain the unique property index)
+    void AddMNInternal(const CDeterministicMNCPtr& mn);
+    void UpdateMNInternal(const CDeterministicMNCPtr& oldMN, const CDeterministicMNState& newState);
+    void RemoveMNInternal(const CDeterministicMNCPtr& mn);
+    void RebuildPaymentQueue();
+    void RebuildCollateralIndex();
+    static size_t CollateralFilterBit(const COutPoint& outpoint);
 };
 
+/** Default memory budget for the masternode list cache, in megabytes */
+static const int64_t DEFAULT_MNLIST_CACHE_MB = 64;
+/** Lists of this many of the most recent active chain blocks are indexed by height */
+static const int MNLIST_HEIGHT_INDEX_SIZE = 128;
+
 /**
  * CDeterministicMNManager - Manages the deterministic masternode list
  * 
  * This is the main interface for accessing and updating the masternode list.
- * It maintains a cache of recent lists and handles persistence to the database.
+ * It maintains an LRU cache of recent lists, bounded by an (approximate)
+ * memory budget, and handles persistence to the database.
  */
 class CDeterministicMNManager
 {
@@ -236,14 +340,50 @@ private:
     mutable CCriticalSection cs;
     CEvoDB& evoDb;
 
+    struct CListCacheEntry {
+        CDeterministicMNListCPtr list;
+        size_t nUsage;
+        std::list<uint256>::iterator itLru;
+    };
+
     // Cache of recent masternode lists (block hash -> list)
-    std::map<uint256, CDeterministicMNListCPtr> mnListsCache;
+    std::map<uint256, CListCacheEntry> mnListsCache;
+
+    // Cached block hashes, most recently used first
+    std::list<uint256> mnListsLru;
+
+    // Sum of the cached lists' estimated memory usage and the budget for it
+    size_t nCacheUsage{0};
+    size_t nMaxCacheUsage;
+
+    uint64_t nCacheHits{0};
+    uint64_t nCacheMisses{0};
     
     // The current tip's masternode list
     CDeterministicMNListCPtr tipList;
 
-    // Maximum cache size
-    static const size_t MAX_CACHE_SIZE = 100;
+    // Lists of the latest active chain blocks, in a ring by height, read and
+    // written with atomic shared_ptr operations instead of under cs. Most
+    // lookups (payee, quorum members) are at or just below the tip. A slot
+    // is only used when its list is for the very block asked about, so one
+    // left behind by a reorg is never returned for the new block.
+    std::array<CDeterministicMNListCPtr, MNLIST_HEIGHT_INDEX_SIZE> heightIndex;
+    mutable std::atomic<uint64_t> nIndexHits{0};
+
+public:
+    // A full list snapshot is stored every DMN_SNAPSHOT_INTERVAL blocks,
+    // in between only per-block diffs are written
+    static const int DMN_SNAPSHOT_INTERVAL = 576;
+
+public:
+    struct CacheStats {
+        size_t nEntries;
+        size_t nUsage;
+        size_t nMaxUsage;
+        uint64_t nHits;
+        uint64_t nMisses;
+        uint64_t nIndexHits;
+    };
 
 public:
     explicit CDeterministicMNManager(CEvoDB& _evoDb);
@@ -276,12 +416,24 @@ public:
     // Check if an output is a masternode collateral
     bool IsProTxWithCollateral(const COutPoint& outpoint) const;
 
-    // Get the masternode that should be paid in a block
+    // Get the masternode that should be paid in the block after pindex
     CDeterministicMNCPtr GetMNPayee(const CBlockIndex* pindex) const;
 
     // Update chain tip
     void UpdatedBlockTip(const CBlockIndex* pindex);
 
+    // List cache statistics (for RPC)
+    CacheStats GetCacheStats() const;
+    // Evict least recently used lists until about nBytes are freed, always
+    // keeping the most recently used one; returns the bytes freed
+    size_t EvictCache(size_t nBytes);
+
+    // Erase up to nMaxErase stored snapshots and diffs that no list at or
+    // above nKeepHeight is built from; returns how many. Requires cs_main
+    size_t EraseListsBelow(int nKeepHeight, size_t nMaxErase);
+    // Compact the stored snapshots and diffs, after erasing some
+    void CompactLists();
+
 private:
     // Build the initial list at genesis
     CDeterministicMNListCPtr BuildInitialList(const CBlockIndex* pindex);
@@ -290,14 +442,24 @@ private:
     CDeterministicMNListCPtr ApplyBlockToList(const CBlock& block, const CBlockIndex* pindex, 
                                                const CDeterministicMNListCPtr& prevList);
 
-    // Persist list to database
-    void SaveListToDb(const CDeterministicMNListCPtr& list);
+    // Persist list to database (diff against prevList, plus periodic snapshots)
+    void SaveListToDb(const CDeterministicMNListCPtr& list, const CDeterministicMNListCPtr& prevList);
     
-    // Load list from database
+    // Load a list snapshot from database
     CDeterministicMNListCPtr LoadListFromDb(const uint256& blockHash);
 
-    // Clean old entries from cache
+    // List cache access, all require cs
+    CDeterministicMNListCPtr GetCachedList(const uint256& blockHash);
+    void AddListToCache(const CDeterministicMNListCPtr& list, size_t nUsage);
+    void RemoveListFromCache(const uint256& blockHash);
+
+    // Evict least recently used lists until the cache fits its memory budget
     void CleanupCache();
+
+    // Height index access, none of which needs cs
+    CDeterministicMNListCPtr GetIndexedList(const CBlockIndex* pindex) const;
+    void IndexList(const CDeterministicMNListCPtr& list);
+    void UnindexList(const CBlockIndex* pindex);
 };
 
 // Global manager instance
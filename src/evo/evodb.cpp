@@ -7,9 +7,61 @@
 
 std::unique_ptr<CEvoDB> evoDb;
 
-CEvoDB::CEvoDB(size_t nCacheSize, bool fMemory, bool fWipe)
-    : db(GetDataDir() / "evodb", nCacheSize, fMemory, fWipe)
+//! Bytes a cache entry takes besides its key and object
+static const size_t EVODB_CACHE_ENTRY_OVERHEAD = 128;
+
+CEvoDB::CEvoDB(size_t nCacheSize, bool fMemory, bool fWipe, size_t nObjectCacheSize)
+    : db(GetDataDir() / "evodb", nCacheSize, fMemory, fWipe), nMaxCacheSize(nObjectCacheSize)
+{
+}
+
+bool CEvoDB::LookupObject(const std::string& strKey, CachedObjectPtr& obj) const
+{
+    AssertLockHeld(cs);
+    auto itPending = mapPending.find(strKey);
+    if (itPending != mapPending.end()) {
+        obj = itPending->second;
+        return true;
+    }
+
+    auto it = mapCache.find(strKey);
+    if (it == mapCache.end()) {
+        return false;
+    }
+    listCache.splice(listCache.begin(), listCache, it->second);
+    obj = it->second->second;
+    return true;
+}
+
+void CEvoDB::CacheObject(const std::string& strKey, CachedObjectPtr obj) const
+{
+    AssertLockHeld(cs);
+    UncacheObject(strKey);
+    const size_t nUsage = strKey.size() + (obj ? obj->nSize : 0) + EVODB_CACHE_ENTRY_OVERHEAD;
+    if (nUsage > nMaxCacheSize) {
+        return;
+    }
+
+    listCache.emplace_front(strKey, std::move(obj));
+    mapCache.emplace(strKey, listCache.begin());
+    nCacheSize += nUsage;
+    while (nCacheSize > nMaxCacheSize) {
+        const std::string strOldest = listCache.back().first;
+        UncacheObject(strOldest);
+    }
+}
+
+void CEvoDB::UncacheObject(const std::string& strKey) const
 {
+    AssertLockHeld(cs);
+    auto it = mapCache.find(strKey);
+    if (it == mapCache.end()) {
+        return;
+    }
+    const CachedObjectPtr& obj = it->second->second;
+    nCacheSize -= strKey.size() + (obj ? obj->nSize : 0) + EVODB_CACHE_ENTRY_OVERHEAD;
+    listCache.erase(it->second);
+    mapCache.erase(it);
 }
 
 void CEvoDB::BeginTransaction()
@@ -27,6 +79,12 @@ void CEvoDB::CommitTransaction()
     db.WriteBatch(*curDBTransaction);
     curDBTransaction.reset();
     hasTransaction = false;
+
+    // What was written is what the database holds now
+    for (auto& item : mapPending) {
+        CacheObject(item.first, std::move(item.second));
+    }
+    mapPending.clear();
 }
 
 void CEvoDB::RollbackTransaction()
@@ -35,6 +93,7 @@ void CEvoDB::RollbackTransaction()
     assert(hasTransaction);
     curDBTransaction.reset();
     hasTransaction = false;
+    mapPending.clear();
 }
 
 bool CEvoDB::Sync()
@@ -43,3 +102,14 @@ bool CEvoDB::Sync()
     return db.Sync();
 }
 
+size_t CEvoDB::GetCacheCount() const
+{
+    LOCK(cs);
+    return listCache.size();
+}
+
+size_t CEvoDB::GetCacheSize() const
+{
+    LOCK(cs);
+    return nCacheSize;
+}
@@ -5,21 +5,62 @@
 #ifndef MYNTA_EVO_EVODB_H
 #define MYNTA_EVO_EVODB_H
 
+#include "clientversion.h"
 #include "dbwrapper.h"
+#include "serialize.h"
+#include "streams.h"
 #include "sync.h"
 #include "uint256.h"
 
+#include <list>
+#include <map>
 #include <memory>
+#include <string>
+#include <unordered_map>
+
+//! Bytes of deserialized objects CEvoDB keeps in memory by default
+static const size_t DEFAULT_EVODB_OBJECT_CACHE_SIZE = 32 << 20;
 
 /**
  * CEvoDB - Evolution database for deterministic masternode state
  * 
  * This database stores the state of the deterministic masternode list
  * in a way that allows for efficient queries and rollbacks during reorgs.
+ *
+ * Objects are kept deserialized in a least recently used cache, bounded by
+ * their serialized size, in front of LevelDB; keys found missing are cached
+ * too. The writes and erases of an open transaction are kept the same way
+ * and looked at first, so reads see them before they are committed. Reads
+ * through GetRawDB() see neither.
  */
 class CEvoDB
 {
 private:
+    /** An object read from or written to the database, kept deserialized */
+    struct CachedObject
+    {
+        size_t nSize{0};
+
+        virtual ~CachedObject() {}
+        virtual void Serialize(CDataStream& ss) const = 0;
+    };
+
+    template <typename V>
+    struct TypedObject : public CachedObject
+    {
+        const V value;
+
+        explicit TypedObject(const V& valueIn) : value(valueIn)
+        {
+            nSize = ::GetSerializeSize(value, SER_DISK, CLIENT_VERSION);
+        }
+
+        void Serialize(CDataStream& ss) const override { ss << value; }
+    };
+
+    //! nullptr stands for a key that isn't in the database, or is erased
+    typedef std::shared_ptr<const CachedObject> CachedObjectPtr;
+
     mutable CCriticalSection cs;
     CDBWrapper db;
 
@@ -29,8 +70,51 @@ private:
     // Track if we're in the middle of a transaction
     bool hasTransaction{false};
 
+    //! Writes and erases of the open transaction, by serialized key
+    std::map<std::string, CachedObjectPtr> mapPending;
+
+    //! What is in the database, by serialized key, most recently used first
+    size_t nMaxCacheSize;
+    mutable size_t nCacheSize{0};
+    mutable std::list<std::pair<std::string, CachedObjectPtr>> listCache;
+    mutable std::unordered_map<std::string, std::list<std::pair<std::string, CachedObjectPtr>>::iterator> mapCache;
+
+    template <typename K>
+    static std::string SerializeKey(const K& key)
+    {
+        CDataStream ssKey(SER_DISK, CLIENT_VERSION);
+        ssKey << key;
+        return std::string(ssKey.begin(), ssKey.end());
+    }
+
+    //! Whether strKey is pending or cached, and if so its object
+    bool LookupObject(const std::string& strKey, CachedObjectPtr& obj) const;
+    void CacheObject(const std::string& strKey, CachedObjectPtr obj) const;
+    void UncacheObject(const std::string& strKey) const;
+
+    //! The value of a looked up object, converted through its serialization if it is another type
+    template <typename V>
+    static std::shared_ptr<const V> GetValue(const CachedObjectPtr& obj)
+    {
+        if (!obj) {
+            return nullptr;
+        }
+        if (auto typed = std::dynamic_pointer_cast<const TypedObject<V>>(obj)) {
+            return std::shared_ptr<const V>(typed, &typed->value);
+        }
+        try {
+            CDataStream ss(SER_DISK, CLIENT_VERSION);
+            obj->Serialize(ss);
+            auto value = std::make_shared<V>();
+            ss >> *value;
+            return value;
+        } catch (const std::exception&) {
+            return nullptr;
+        }
+    }
+
 public:
-    explicit CEvoDB(size_t nCacheSize, bool fMemory = false, bool fWipe = false);
+    explicit CEvoDB(size_t nCacheSize, bool fMemory = false, bool fWipe = false, size_t nObjectCacheSize = DEFAULT_EVODB_OBJECT_CACHE_SIZE);
     ~CEvoDB() = default;
 
     // Prevent copying
@@ -43,41 +127,92 @@ public:
     void RollbackTransaction();
     bool HasTransaction() const { return hasTransaction; }
 
+    //! The object at key, shared with the cache, or nullptr if there is none
+    template <typename V, typename K>
+    std::shared_ptr<const V> ReadShared(const K& key) const
+    {
+        const std::string strKey = SerializeKey(key);
+        LOCK(cs);
+        CachedObjectPtr obj;
+        if (LookupObject(strKey, obj)) {
+            return GetValue<V>(obj);
+        }
+
+        V value;
+        if (!db.Read(key, value)) {
+            CacheObject(strKey, nullptr);
+            return nullptr;
+        }
+        auto typed = std::make_shared<const TypedObject<V>>(value);
+        CacheObject(strKey, typed);
+        return std::shared_ptr<const V>(typed, &typed->value);
+    }
+
     // Template methods for reading/writing
     template <typename K, typename V>
     bool Read(const K& key, V& value) const
     {
-        LOCK(cs);
-        return db.Read(key, value);
+        auto pvalue = ReadShared<V>(key);
+        if (!pvalue) {
+            return false;
+        }
+        value = *pvalue;
+        return true;
     }
 
     template <typename K, typename V>
     void Write(const K& key, const V& value)
     {
+        const std::string strKey = SerializeKey(key);
+        auto obj = std::make_shared<const TypedObject<V>>(value);
         LOCK(cs);
         if (curDBTransaction) {
             curDBTransaction->Write(key, value);
+            mapPending[strKey] = obj;
         } else {
             db.Write(key, value);
+            CacheObject(strKey, obj);
         }
     }
 
     template <typename K>
     bool Exists(const K& key) const
     {
+        const std::string strKey = SerializeKey(key);
         LOCK(cs);
+        CachedObjectPtr obj;
+        if (LookupObject(strKey, obj)) {
+            return obj != nullptr;
+        }
         return db.Exists(key);
     }
 
     template <typename K>
     void Erase(const K& key)
     {
+        const std::string strKey = SerializeKey(key);
         LOCK(cs);
         if (curDBTransaction) {
             curDBTransaction->Erase(key);
+            mapPending[strKey] = nullptr;
         } else {
             db.Erase(key);
+            CacheObject(strKey, nullptr);
+        }
+    }
+
+    //! Erase many keys in one write; there must be no open transaction
+    template <typename K>
+    void EraseMany(const std::vector<K>& vKeys)
+    {
+        LOCK(cs);
+        assert(!curDBTransaction);
+        CDBBatch batch(db);
+        for (const K& key : vKeys) {
+            batch.Erase(key);
+            UncacheObject(SerializeKey(key));
         }
+        db.WriteBatch(batch);
     }
 
     // Direct wrapper access for iteration
@@ -86,6 +221,10 @@ public:
 
     // Sync to disk
     bool Sync();
+
+    //! Objects and bytes the cache holds
+    size_t GetCacheCount() const;
+    size_t GetCacheSize() const;
 };
 
 // Global evolution database instance
@@ -10,6 +10,7 @@
 #include "base58.h"
 #include "chain.h"
 #include "chainparams.h"
+#include "checkqueue.h"
 #include "consensus/validation.h"
 #include "core_io.h"
 #include "hash.h"
@@ -60,16 +61,7 @@ uint256 CProRegTx::GetSignatureHash() const
 bool CProRegTx::CheckSignature(const CKeyID& keyID) const
 {
     // Verify the signature using the owner key
-    uint256 hash = GetSignatureHash();
-    
-    // Recover the public key from the signature
-    CPubKey pubkey;
-    if (!pubkey.RecoverCompact(hash, vchSig)) {
-        return false;
-    }
-    
-    // Check if the recovered key matches the expected keyID
-    return pubkey.GetID() == keyID;
+    return CProviderSigCheck(GetSignatureHash(), vchSig, keyID)();
 }
 
 std::string CProRegTx::ToString() const
@@ -123,12 +115,7 @@ uint256 CProUpRegTx::GetSignatureHash() const
 
 bool CProUpRegTx::CheckSignature(const CKeyID& keyID) const
 {
-    uint256 hash = GetSignatureHash();
-    CPubKey pubkey;
-    if (!pubkey.RecoverCompact(hash, vchSig)) {
-        return false;
-    }
-    return pubkey.GetID() == keyID;
+    return CProviderSigCheck(GetSignatureHash(), vchSig, keyID)();
 }
 
 std::string CProUpRegTx::ToString() const
@@ -165,6 +152,45 @@ std::string CProUpRevTx::ToString() const
     return ss.str();
 }
 
+// ============================================================================
+// CProviderSigCheck Implementation
+// ============================================================================
+
+bool CProviderSigCheck::operator()() const
+{
+    // Recover the public key from the signature
+    CPubKey pubkey;
+    if (!pubkey.RecoverCompact(hash, vchSig)) {
+        return false;
+    }
+
+    // Check if the recovered key matches the expected keyID
+    return pubkey.GetID() == keyID;
+}
+
+static CCheckQueue<CProviderSigCheck> providersigcheckqueue(16);
+
+void ThreadProviderSigCheck()
+{
+    RenameThread("mynta-protxsig");
+    providersigcheckqueue.Thread();
+}
+
+static bool RunProviderSigChecks(std::vector<CProviderSigCheck>& vChecks)
+{
+    if (nScriptCheckThreads && vChecks.size() > 1) {
+        CCheckQueueControl<CProviderSigCheck> control(&providersigcheckqueue);
+        control.Add(vChecks);
+        return control.Wait();
+    }
+    for (const CProviderSigCheck& check : vChecks) {
+        if (!check()) {
+            return false;
+        }
+    }
+    return true;
+}
+
 // ============================================================================
 // Validation Functions
 // ============================================================================
@@ -184,7 +210,7 @@ static bool CheckInputsHash(const CTransaction& tx, const uint256& expectedInput
     return true;
 }
 
-bool CheckProRegTx(const CTransaction& tx, const CBlockIndex* pindexPrev, CValidationState& state)
+bool CheckProRegTx(const CTransaction& tx, const CBlockIndex* pindexPrev, CValidationState& state, std::vector<CProviderSigCheck>* pvChecks)
 {
     if (tx.nType != static_cast<uint16_t>(TxType::TRANSACTION_PROVIDER_REGISTER)) {
         return state.DoS(100, false, REJECT_INVALID, "bad-protx-type");
@@ -239,7 +265,9 @@ bool CheckProRegTx(const CTransaction& tx, const CBlockIndex* pindexPrev, CValid
     // This is verified during contextual validation with access to UTXO set
     
     // Check signature by owner key
-    if (!proTx.CheckSignature(proTx.keyIDOwner)) {
+    if (pvChecks) {
+        pvChecks->emplace_back(proTx.GetSignatureHash(), proTx.vchSig, proTx.keyIDOwner);
+    } else if (!proTx.CheckSignature(proTx.keyIDOwner)) {
         return state.DoS(100, false, REJECT_INVALID, "bad-protx-sig");
     }
 
@@ -321,7 +349,7 @@ bool CheckProUpServTx(const CTransaction& tx, const CBlockIndex* pindexPrev, CVa
     return true;
 }
 
-bool CheckProUpRegTx(const CTransaction& tx, const CBlockIndex* pindexPrev, CValidationState& state)
+bool CheckProUpRegTx(const CTransaction& tx, const CBlockIndex* pindexPrev, CValidationState& state, std::vector<CProviderSigCheck>* pvChecks)
 {
     if (tx.nType != static_cast<uint16_t>(TxType::TRANSACTION_PROVIDER_UPDATE_REGISTRAR)) {
         return state.DoS(100, false, REJECT_INVALID, "bad-protx-type");
@@ -362,7 +390,9 @@ bool CheckProUpRegTx(const CTransaction& tx, const CBlockIndex* pindexPrev, CVal
         }
 
         // Check signature by owner key
-        if (!proTx.CheckSignature(mn->state.keyIDOwner)) {
+        if (pvChecks) {
+            pvChecks->emplace_back(proTx.GetSignatureHash(), proTx.vchSig, mn->state.keyIDOwner);
+        } else if (!proTx.CheckSignature(mn->state.keyIDOwner)) {
             return state.DoS(100, false, REJECT_INVALID, "bad-protx-sig");
         }
     }
@@ -411,7 +441,7 @@ bool CheckProUpRevTx(const CTransaction& tx, const CBlockIndex* pindexPrev, CVal
     return true;
 }
 
-bool CheckSpecialTx(const CTransaction& tx, const CBlockIndex* pindexPrev, CValidationState& state)
+bool CheckSpecialTx(const CTransaction& tx, const CBlockIndex* pindexPrev, CValidationState& state, std::vector<CProviderSigCheck>* pvChecks)
 {
     if (!IsTxTypeSpecial(tx)) {
         return true; // Normal transaction, nothing to check
@@ -419,11 +449,11 @@ bool CheckSpecialTx(const CTransaction& tx, const CBlockIndex* pindexPrev, CVali
 
     switch (GetTxType(tx)) {
         case TxType::TRANSACTION_PROVIDER_REGISTER:
-            return CheckProRegTx(tx, pindexPrev, state);
+            return CheckProRegTx(tx, pindexPrev, state, pvChecks);
         case TxType::TRANSACTION_PROVIDER_UPDATE_SERVICE:
             return CheckProUpServTx(tx, pindexPrev, state);
         case TxType::TRANSACTION_PROVIDER_UPDATE_REGISTRAR:
-            return CheckProUpRegTx(tx, pindexPrev, state);
+            return CheckProUpRegTx(tx, pindexPrev, state, pvChecks);
         case TxType::TRANSACTION_PROVIDER_UPDATE_REVOKE:
             return CheckProUpRevTx(tx, pindexPrev, state);
         default:
@@ -433,13 +463,18 @@ bool CheckSpecialTx(const CTransaction& tx, const CBlockIndex* pindexPrev, CVali
 
 bool ProcessSpecialTxsInBlock(const CBlock& block, const CBlockIndex* pindex, CValidationState& state, bool fJustCheck)
 {
-    // Validate all special transactions in the block
+    // Validate all special transactions in the block, leaving the owner
+    // key signatures to be verified together on the check queue
+    std::vector<CProviderSigCheck> vChecks;
     for (size_t i = 0; i < block.vtx.size(); i++) {
         const CTransaction& tx = *block.vtx[i];
-        if (!CheckSpecialTx(tx, pindex->pprev, state)) {
+        if (!CheckSpecialTx(tx, pindex->pprev, state, &vChecks)) {
             return false;
         }
     }
+    if (!RunProviderSigChecks(vChecks)) {
+        return state.DoS(100, false, REJECT_INVALID, "bad-protx-sig");
+    }
 
     // If not just checking, apply the transactions to the masternode list
     if (!fJustCheck && deterministicMNManager) {
@@ -217,14 +217,46 @@ public:
     uint256 GetSignatureHash() const;
 };
 
+/**
+ * CProviderSigCheck - An owner key signature of a provider transaction
+ *
+ * Split from the rest of the checks so the signatures of a block can be
+ * verified on a check queue while its state transitions stay sequential.
+ */
+class CProviderSigCheck
+{
+private:
+    uint256 hash;
+    std::vector<unsigned char> vchSig;
+    CKeyID keyID;
+
+public:
+    CProviderSigCheck() {}
+    CProviderSigCheck(const uint256& hashIn, const std::vector<unsigned char>& vchSigIn, const CKeyID& keyIDIn) :
+        hash(hashIn), vchSig(vchSigIn), keyID(keyIDIn) {}
+
+    bool operator()() const;
+
+    void swap(CProviderSigCheck& check)
+    {
+        std::swap(hash, check.hash);
+        vchSig.swap(check.vchSig);
+        std::swap(keyID, check.keyID);
+    }
+};
+
 // Validation functions
-bool CheckProRegTx(const CTransaction& tx, const CBlockIndex* pindexPrev, CValidationState& state);
+// If pvChecks is not nullptr, owner key signatures are pushed onto it instead of being verified inline
+bool CheckProRegTx(const CTransaction& tx, const CBlockIndex* pindexPrev, CValidationState& state, std::vector<CProviderSigCheck>* pvChecks = nullptr);
 bool CheckProUpServTx(const CTransaction& tx, const CBlockIndex* pindexPrev, CValidationState& state);
-bool CheckProUpRegTx(const CTransaction& tx, const CBlockIndex* pindexPrev, CValidationState& state);
+bool CheckProUpRegTx(const CTransaction& tx, const CBlockIndex* pindexPrev, CValidationState& state, std::vector<CProviderSigCheck>* pvChecks = nullptr);
 bool CheckProUpRevTx(const CTransaction& tx, const CBlockIndex* pindexPrev, CValidationState& state);
 
 // Master validation dispatcher
-bool CheckSpecialTx(const CTransaction& tx, const CBlockIndex* pindexPrev, CValidationState& state);
+bool CheckSpecialTx(const CTransaction& tx, const CBlockIndex* pindexPrev, CValidationState& state, std::vector<CProviderSigCheck>* pvChecks = nullptr);
+
+// Run a worker verifying the provider signatures of blocks being connected
+void ThreadProviderSigCheck();
 
 // Process special transactions during block connection
 bool ProcessSpecialTxsInBlock(const CBlock& block, const CBlockIndex* pindex, CValidationState& state, bool fJustCheck);
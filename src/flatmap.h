@@ -0,0 +1,328 @@
+// Copyright (c) 2026 The Mynta Core Developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#ifndef MYNTA_FLATMAP_H
+#define MYNTA_FLATMAP_H
+
+#include <assert.h>
+#include <stdint.h>
+
+#include <functional>
+#include <iterator>
+#include <memory>
+#include <new>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+/**
+ * STL-like hash map with open addressing.
+ *
+ * Lookups probe one flat array of buckets, each holding a pointer to its
+ * entry and 32 bits of the entry's hash, so most misses are answered without
+ * touching an entry. The entries themselves are carved out of a few large
+ * chunks and recycled through a free list instead of being allocated one node
+ * at a time, which keeps a big map from fragmenting the heap.
+ *
+ * Entries never move: references to them stay valid until they are erased,
+ * also when the bucket array grows. As with std::unordered_map, iterators are
+ * invalidated by any insertion that grows the bucket array. Erasing leaves a
+ * tombstone, so erasing one element does not invalidate iterators to others.
+ */
+template <typename K, typename V, typename Hash = std::hash<K>, typename KeyEqual = std::equal_to<K> >
+class flatmap
+{
+public:
+    typedef K key_type;
+    typedef V mapped_type;
+    typedef std::pair<const key_type, mapped_type> value_type;
+    typedef size_t size_type;
+
+private:
+    enum : uint32_t {
+        EMPTY = 0,
+        FULL = 1,
+        DELETED = 2,
+    };
+
+    struct Bucket {
+        value_type* p;
+        uint32_t nHash;
+        uint32_t nState;
+    };
+
+    typedef typename std::aligned_storage<sizeof(value_type), alignof(value_type)>::type Slot;
+
+    //! Entries in the first chunk; each further chunk doubles up to MAX_CHUNK_SLOTS
+    static const size_t MIN_CHUNK_SLOTS = 16;
+    static const size_t MAX_CHUNK_SLOTS = 4096;
+
+    //! Held by pointer so that swap() can exchange hashers that cannot be assigned, like salted ones
+    std::unique_ptr<Hash> hasher;
+    KeyEqual equal;
+    std::vector<Bucket> vBuckets;
+    size_type nSize{0};
+    size_type nDeleted{0};
+    std::vector<std::unique_ptr<Slot[]> > vChunks;
+    //! Slots of the last chunk that have been handed out
+    size_t nChunkUsed{0};
+    std::vector<value_type*> vFree;
+
+    value_type* Allocate()
+    {
+        if (!vFree.empty()) {
+            value_type* p = vFree.back();
+            vFree.pop_back();
+            return p;
+        }
+        if (vChunks.empty() || nChunkUsed == chunk_capacity(vChunks.size() - 1)) {
+            vChunks.emplace_back(new Slot[chunk_capacity(vChunks.size())]);
+            nChunkUsed = 0;
+        }
+        return reinterpret_cast<value_type*>(&vChunks.back()[nChunkUsed++]);
+    }
+
+    void Deallocate(value_type* p)
+    {
+        p->~value_type();
+        vFree.push_back(p);
+    }
+
+    //! Bucket holding k, or nullptr
+    Bucket* FindBucket(const key_type& k, size_t h) const
+    {
+        if (vBuckets.empty())
+            return nullptr;
+        const size_t mask = vBuckets.size() - 1;
+        const uint32_t nHash = (uint32_t)h;
+        for (size_t i = h & mask;; i = (i + 1) & mask) {
+            const Bucket& b = vBuckets[i];
+            if (b.nState == EMPTY)
+                return nullptr;
+            if (b.nState == FULL && b.nHash == nHash && equal(b.p->first, k))
+                return const_cast<Bucket*>(&b);
+        }
+    }
+
+    //! Resize the bucket array, dropping tombstones. Entries stay where they are.
+    void Rehash(size_t nBuckets)
+    {
+        assert(nBuckets - 1 <= UINT32_MAX);
+        std::vector<Bucket> vOld;
+        vOld.swap(vBuckets);
+        vBuckets.assign(nBuckets, Bucket{nullptr, 0, EMPTY});
+        nDeleted = 0;
+        const size_t mask = nBuckets - 1;
+        for (const Bucket& b : vOld) {
+            if (b.nState != FULL)
+                continue;
+            // The stored low 32 bits of the hash are all the index uses
+            size_t i = b.nHash & mask;
+            while (vBuckets[i].nState != EMPTY)
+                i = (i + 1) & mask;
+            vBuckets[i] = b;
+        }
+    }
+
+    //! Make room for one more entry, keeping the table at most 7/8 full counting tombstones
+    void Reserve()
+    {
+        if ((nSize + nDeleted + 1) * 8 <= vBuckets.size() * 7)
+            return;
+        size_t nBuckets = 16;
+        while (nBuckets < (nSize + 1) * 2)
+            nBuckets *= 2;
+        Rehash(nBuckets);
+    }
+
+    template <bool Const>
+    class Iter
+    {
+        friend class flatmap;
+        template <bool> friend class Iter;
+        const Bucket* pos;
+        const Bucket* end;
+
+        Iter(const Bucket* posIn, const Bucket* endIn) : pos(posIn), end(endIn)
+        {
+            while (pos != end && pos->nState != FULL)
+                ++pos;
+        }
+
+    public:
+        typedef std::forward_iterator_tag iterator_category;
+        typedef typename flatmap::value_type value_type;
+        typedef std::ptrdiff_t difference_type;
+        typedef typename std::conditional<Const, const value_type*, value_type*>::type pointer;
+        typedef typename std::conditional<Const, const value_type&, value_type&>::type reference;
+
+        Iter() : pos(nullptr), end(nullptr) {}
+        //! iterator converts to const_iterator
+        template <bool C = Const, typename = typename std::enable_if<C>::type>
+        Iter(const Iter<false>& other) : pos(other.pos), end(other.end) {}
+
+        reference operator*() const { return *pos->p; }
+        pointer operator->() const { return pos->p; }
+        Iter& operator++()
+        {
+            do {
+                ++pos;
+            } while (pos != end && pos->nState != FULL);
+            return *this;
+        }
+        Iter operator++(int)
+        {
+            Iter copy(*this);
+            ++(*this);
+            return copy;
+        }
+        bool operator==(const Iter& other) const { return pos == other.pos; }
+        bool operator!=(const Iter& other) const { return pos != other.pos; }
+    };
+
+public:
+    typedef Iter<false> iterator;
+    typedef Iter<true> const_iterator;
+
+    flatmap() : hasher(new Hash()) {}
+    flatmap(const flatmap&) = delete;
+    flatmap& operator=(const flatmap&) = delete;
+    ~flatmap() { clear(); }
+
+    iterator begin() { return iterator(vBuckets.data(), vBuckets.data() + vBuckets.size()); }
+    iterator end() { return iterator(vBuckets.data() + vBuckets.size(), vBuckets.data() + vBuckets.size()); }
+    const_iterator begin() const { return const_iterator(vBuckets.data(), vBuckets.data() + vBuckets.size()); }
+    const_iterator end() const { return const_iterator(vBuckets.data() + vBuckets.size(), vBuckets.data() + vBuckets.size()); }
+
+    size_type size() const { return nSize; }
+    bool empty() const { return nSize == 0; }
+
+    iterator find(const key_type& k)
+    {
+        Bucket* b = FindBucket(k, (*hasher)(k));
+        return b ? iterator(b, vBuckets.data() + vBuckets.size()) : end();
+    }
+    const_iterator find(const key_type& k) const
+    {
+        Bucket* b = FindBucket(k, (*hasher)(k));
+        return b ? const_iterator(b, vBuckets.data() + vBuckets.size()) : end();
+    }
+    size_type count(const key_type& k) const { return FindBucket(k, (*hasher)(k)) ? 1 : 0; }
+
+    /** Construct the entry from args, and keep it unless its key is already present */
+    template <typename... Args>
+    std::pair<iterator, bool> emplace(Args&&... args)
+    {
+        Reserve();
+        value_type* p = Allocate();
+        try {
+            new (p) value_type(std::forward<Args>(args)...);
+        } catch (...) {
+            vFree.push_back(p);
+            throw;
+        }
+        const size_t h = (*hasher)(p->first);
+        const uint32_t nHash = (uint32_t)h;
+        const size_t mask = vBuckets.size() - 1;
+        Bucket* pTombstone = nullptr;
+        for (size_t i = h & mask;; i = (i + 1) & mask) {
+            Bucket& b = vBuckets[i];
+            if (b.nState == FULL) {
+                if (b.nHash == nHash && equal(b.p->first, p->first)) {
+                    Deallocate(p);
+                    return std::make_pair(iterator(&b, vBuckets.data() + vBuckets.size()), false);
+                }
+                continue;
+            }
+            if (b.nState == DELETED) {
+                if (!pTombstone)
+                    pTombstone = &b;
+                continue;
+            }
+            if (pTombstone) {
+                nDeleted--;
+            } else {
+                pTombstone = &b;
+            }
+            *pTombstone = Bucket{p, nHash, FULL};
+            nSize++;
+            return std::make_pair(iterator(pTombstone, vBuckets.data() + vBuckets.size()), true);
+        }
+    }
+
+    std::pair<iterator, bool> insert(const value_type& v) { return emplace(v); }
+
+    mapped_type& operator[](const key_type& k)
+    {
+        Bucket* b = FindBucket(k, (*hasher)(k));
+        if (b)
+            return b->p->second;
+        return emplace(std::piecewise_construct, std::forward_as_tuple(k), std::tuple<>()).first->second;
+    }
+
+    /** Erase the entry at it, returning an iterator to the one after it */
+    iterator erase(const_iterator it)
+    {
+        Bucket* b = const_cast<Bucket*>(it.pos);
+        assert(b->nState == FULL);
+        Deallocate(b->p);
+        b->p = nullptr;
+        b->nState = DELETED;
+        nSize--;
+        nDeleted++;
+        return iterator(b, vBuckets.data() + vBuckets.size());
+    }
+
+    size_type erase(const key_type& k)
+    {
+        Bucket* b = FindBucket(k, (*hasher)(k));
+        if (!b)
+            return 0;
+        erase(const_iterator(b, vBuckets.data() + vBuckets.size()));
+        return 1;
+    }
+
+    /** Remove every entry and give back all memory */
+    void clear()
+    {
+        for (Bucket& b : vBuckets) {
+            if (b.nState == FULL)
+                b.p->~value_type();
+        }
+        std::vector<Bucket>().swap(vBuckets);
+        std::vector<std::unique_ptr<Slot[]> >().swap(vChunks);
+        std::vector<value_type*>().swap(vFree);
+        nChunkUsed = 0;
+        nSize = 0;
+        nDeleted = 0;
+    }
+
+    /** Exchange contents with other. Entries stay where they are, so references to them stay valid. */
+    void swap(flatmap& other)
+    {
+        std::swap(hasher, other.hasher);
+        std::swap(equal, other.equal);
+        vBuckets.swap(other.vBuckets);
+        std::swap(nSize, other.nSize);
+        std::swap(nDeleted, other.nDeleted);
+        vChunks.swap(other.vChunks);
+        std::swap(nChunkUsed, other.nChunkUsed);
+        vFree.swap(other.vFree);
+    }
+
+    size_t bucket_count() const { return vBuckets.size(); }
+    size_t chunk_count() const { return vChunks.size(); }
+    size_t free_list_capacity() const { return vFree.capacity(); }
+    static size_t bucket_alloc_size() { return sizeof(Bucket); }
+    static size_t slot_alloc_size() { return sizeof(Slot); }
+    //! Entries that the n'th chunk holds
+    static size_t chunk_capacity(size_t n)
+    {
+        const size_t nSlots = n < 8 ? MIN_CHUNK_SLOTS << n : MAX_CHUNK_SLOTS;
+        return nSlots < MAX_CHUNK_SLOTS ? nSlots : MAX_CHUNK_SLOTS;
+    }
+};
+
+#endif // MYNTA_FLATMAP_H
@@ -7,11 +7,26 @@
 #include "hash.h"
 #include "crypto/common.h"
 #include "crypto/hmac_sha512.h"
+#include "epochcontext.h"
 #include "pubkey.h"
 #include "util.h"
 
 #include <crypto/ethash/include/ethash/progpow.hpp>
 
+#include <string.h>
+
+#if defined(__x86_64__) || defined(__amd64__)
+#if defined(USE_ASM)
+#include <cpuid.h>
+namespace x16r_aesni
+{
+void Groestl512(const void* data, size_t len, void* out);
+void Shavite512(const void* data, size_t len, void* out);
+void Echo512(const void* data, size_t len, void* out);
+}
+#endif
+#endif
+
 //TODO remove these
 double algoHashTotal[16];
 int algoHashHits[16];
@@ -77,6 +92,61 @@ unsigned int MurmurHash3(unsigned int nHashSeed, const std::vector<unsigned char
     return h1;
 }
 
+void MurmurHash3Multi(unsigned int nSeedBase, unsigned int nSeedStep, unsigned int nHashes, const unsigned char* pData, size_t nLen, unsigned int* pHashes)
+{
+    const uint32_t c1 = 0xcc9e2d51;
+    const uint32_t c2 = 0x1b873593;
+    const size_t nblocks = nLen / 4;
+
+    for (unsigned int nFirst = 0; nFirst < nHashes; nFirst += MURMUR_HASH_LANES) {
+        // Lanes past nHashes are hashed too and dropped, so every loop below has a fixed width
+        uint32_t h[MURMUR_HASH_LANES];
+        for (unsigned int j = 0; j < MURMUR_HASH_LANES; j++)
+            h[j] = nSeedBase + (nFirst + j) * nSeedStep;
+
+        for (size_t i = 0; i < nblocks; ++i) {
+            uint32_t k1 = ReadLE32(pData + i*4);
+
+            k1 *= c1;
+            k1 = ROTL32(k1, 15);
+            k1 *= c2;
+
+            for (unsigned int j = 0; j < MURMUR_HASH_LANES; j++) {
+                h[j] ^= k1;
+                h[j] = ROTL32(h[j], 13);
+                h[j] = h[j] * 5 + 0xe6546b64;
+            }
+        }
+
+        const uint8_t* tail = pData + nblocks * 4;
+        uint32_t k1 = 0;
+        switch (nLen & 3) {
+            case 3:
+                k1 ^= tail[2] << 16;
+            case 2:
+                k1 ^= tail[1] << 8;
+            case 1:
+                k1 ^= tail[0];
+                k1 *= c1;
+                k1 = ROTL32(k1, 15);
+                k1 *= c2;
+        }
+
+        for (unsigned int j = 0; j < MURMUR_HASH_LANES; j++) {
+            h[j] ^= k1;
+            h[j] ^= (uint32_t)nLen;
+            h[j] ^= h[j] >> 16;
+            h[j] *= 0x85ebca6b;
+            h[j] ^= h[j] >> 13;
+            h[j] *= 0xc2b2ae35;
+            h[j] ^= h[j] >> 16;
+        }
+
+        for (unsigned int j = 0; j < MURMUR_HASH_LANES && nFirst + j < nHashes; j++)
+            pHashes[nFirst + j] = h[j];
+    }
+}
+
 void BIP32Hash(const ChainCode &chainCode, unsigned int nChild, unsigned char header, const unsigned char data[32], unsigned char output[64])
 {
     unsigned char num[4];
@@ -257,38 +327,96 @@ uint64_t SipHashUint256Extra(uint64_t k0, uint64_t k1, const uint256& val, uint3
 
 uint256 KAWPOWHash(const CBlockHeader& blockHeader, uint256& mix_hash)
 {
-    static ethash::epoch_context_ptr context{nullptr, nullptr};
-
     // Get the context from the block height
-    const auto epoch_number = ethash::get_epoch_number(blockHeader.nHeight);
-
-    if (!context || context->epoch_number != epoch_number)
-        context = ethash::create_epoch_context(epoch_number);
+    const auto context = epochContextCache.GetForHeight(blockHeader.nHeight);
 
     // Build the header_hash
-    uint256 nHeaderHash = blockHeader.GetKAWPOWHeaderHash();
-    const auto header_hash = to_hash256(nHeaderHash.GetHex());
+    const auto header_hash = ToEthashHash256(blockHeader.GetKAWPOWHeaderHash());
 
     // ProgPow hash
     const auto result = progpow::hash(*context, blockHeader.nHeight, header_hash, blockHeader.nNonce64);
 
-    mix_hash = uint256S(to_hex(result.mix_hash));
-    return uint256S(to_hex(result.final_hash));
+    mix_hash = FromEthashHash256(result.mix_hash);
+    return FromEthashHash256(result.final_hash);
 }
 
 
 uint256 KAWPOWHash_OnlyMix(const CBlockHeader& blockHeader)
 {
     // Build the header_hash
-    uint256 nHeaderHash = blockHeader.GetKAWPOWHeaderHash();
-    const auto header_hash = to_hash256(nHeaderHash.GetHex());
+    const auto header_hash = ToEthashHash256(blockHeader.GetKAWPOWHeaderHash());
 
     // ProgPow hash
-    const auto result = progpow::hash_no_verify(blockHeader.nHeight, header_hash, to_hash256(blockHeader.mix_hash.GetHex()), blockHeader.nNonce64);
+    const auto result = progpow::hash_no_verify(blockHeader.nHeight, header_hash, ToEthashHash256(blockHeader.mix_hash), blockHeader.nNonce64);
 
-    return uint256S(to_hex(result));
+    return FromEthashHash256(result);
 }
 
 
 
 
+
+namespace
+{
+void Groestl512Generic(const void* data, size_t len, void* out)
+{
+    sph_groestl512_context ctx;
+    sph_groestl512_init(&ctx);
+    sph_groestl512(&ctx, data, len);
+    sph_groestl512_close(&ctx, out);
+}
+
+void Shavite512Generic(const void* data, size_t len, void* out)
+{
+    sph_shavite512_context ctx;
+    sph_shavite512_init(&ctx);
+    sph_shavite512(&ctx, data, len);
+    sph_shavite512_close(&ctx, out);
+}
+
+void Echo512Generic(const void* data, size_t len, void* out)
+{
+    sph_echo512_context ctx;
+    sph_echo512_init(&ctx);
+    sph_echo512(&ctx, data, len);
+    sph_echo512_close(&ctx, out);
+}
+
+/** Check an implementation against the generic one around every padding boundary */
+bool SelfTest(X16RStageFunc func, X16RStageFunc generic)
+{
+    unsigned char in[300];
+    for (size_t i = 0; i < sizeof(in); i++) {
+        in[i] = (unsigned char)(i * 131 + 7);
+    }
+    for (size_t len = 0; len <= sizeof(in); len++) {
+        unsigned char out1[64], out2[64];
+        func(in, len, out1);
+        generic(in, len, out2);
+        if (memcmp(out1, out2, sizeof(out1))) return false;
+    }
+    return true;
+}
+} // namespace
+
+X16RStageFuncs x16rStages = {Groestl512Generic, Shavite512Generic, Echo512Generic};
+
+std::string X16RAutoDetect()
+{
+#if defined(USE_ASM) && (defined(__x86_64__) || defined(__amd64__))
+    uint32_t eax, ebx, ecx, edx;
+    // AES-NI is CPUID.1:ECX bit 25, SSSE3 bit 9
+    if (__get_cpuid(1, &eax, &ebx, &ecx, &edx) && (ecx >> 25) & 1 && (ecx >> 9) & 1) {
+        X16RStageFuncs aesni = {x16r_aesni::Groestl512, x16r_aesni::Shavite512, x16r_aesni::Echo512};
+        if (SelfTest(aesni.groestl512, Groestl512Generic) &&
+            SelfTest(aesni.shavite512, Shavite512Generic) &&
+            SelfTest(aesni.echo512, Echo512Generic)) {
+            x16rStages = aesni;
+            return "aesni";
+        }
+    }
+#endif
+
+    x16rStages = {Groestl512Generic, Shavite512Generic, Echo512Generic};
+    return "standard";
+}
@@ -39,6 +39,9 @@
 
 #include <crypto/ethash/helpers.hpp>
 
+#include <algorithm>
+#include <iterator>
+#include <string>
 #include <vector>
 
 class CBlockHeader;
@@ -280,6 +283,17 @@ uint256 SerializeHash(const T& obj, int nType=SER_GETHASH, int nVersion=PROTOCOL
 
 unsigned int MurmurHash3(unsigned int nHashSeed, const std::vector<unsigned char>& vDataToHash);
 
+//! Seeds MurmurHash3Multi hashes with at once
+static const unsigned int MURMUR_HASH_LANES = 8;
+
+/**
+ * MurmurHash3 of the same data under nHashes seeds, nSeedBase + i * nSeedStep,
+ * into pHashes. Mixing a block of the data doesn't depend on the seed, so it is
+ * done once for MURMUR_HASH_LANES seeds, whose steps run side by side in lanes
+ * the compiler vectorizes.
+ */
+void MurmurHash3Multi(unsigned int nSeedBase, unsigned int nSeedStep, unsigned int nHashes, const unsigned char* pData, size_t nLen, unsigned int* pHashes);
+
 void BIP32Hash(const ChainCode &chainCode, unsigned int nChild, unsigned char header, const unsigned char data[32], unsigned char output[64]);
 
 /** SipHash-2-4 */
@@ -326,6 +340,24 @@ inline int GetHashSelection(const uint256 PrevBlockHash, int index) {
     return(hashSelection);
 }
 
+/** One-shot 512-bit hash of len bytes at data into 64 bytes at out */
+typedef void (*X16RStageFunc)(const void* data, size_t len, void* out);
+
+/**
+ * Implementations of the X16R/X16RV2 stages that have accelerated versions.
+ * They default to the generic sph_* code until X16RAutoDetect() is called.
+ */
+struct X16RStageFuncs
+{
+    X16RStageFunc groestl512;
+    X16RStageFunc shavite512;
+    X16RStageFunc echo512;
+};
+extern X16RStageFuncs x16rStages;
+
+/** Autodetect the X16R stage implementations to use; returns a description */
+std::string X16RAutoDetect();
+
 extern double algoHashTotal[16];
 extern int algoHashHits[16];
 
@@ -339,15 +371,12 @@ inline uint256 HashX16R(const T1 pbegin, const T1 pend, const uint256 PrevBlockH
 
     sph_blake512_context     ctx_blake;      //0
     sph_bmw512_context       ctx_bmw;        //1
-    sph_groestl512_context   ctx_groestl;    //2
     sph_jh512_context        ctx_jh;         //3
     sph_keccak512_context    ctx_keccak;     //4
     sph_skein512_context     ctx_skein;      //5
     sph_luffa512_context     ctx_luffa;      //6
     sph_cubehash512_context  ctx_cubehash;   //7
-    sph_shavite512_context   ctx_shavite;    //8
     sph_simd512_context      ctx_simd;       //9
-    sph_echo512_context      ctx_echo;       //A
     sph_hamsi512_context     ctx_hamsi;      //B
     sph_fugue512_context     ctx_fugue;      //C
     sph_shabal512_context    ctx_shabal;     //D
@@ -386,9 +415,7 @@ inline uint256 HashX16R(const T1 pbegin, const T1 pend, const uint256 PrevBlockH
                 sph_bmw512_close(&ctx_bmw, static_cast<void*>(&hash[i]));
                 break;
             case 2:
-                sph_groestl512_init(&ctx_groestl);
-                sph_groestl512 (&ctx_groestl, toHash, lenToHash);
-                sph_groestl512_close(&ctx_groestl, static_cast<void*>(&hash[i]));
+                x16rStages.groestl512(toHash, lenToHash, static_cast<void*>(&hash[i]));
                 break;
             case 3:
                 sph_jh512_init(&ctx_jh);
@@ -416,9 +443,7 @@ inline uint256 HashX16R(const T1 pbegin, const T1 pend, const uint256 PrevBlockH
                 sph_cubehash512_close(&ctx_cubehash, static_cast<void*>(&hash[i]));
                 break;
             case 8:
-                sph_shavite512_init(&ctx_shavite);
-                sph_shavite512(&ctx_shavite, toHash, lenToHash);
-                sph_shavite512_close(&ctx_shavite, static_cast<void*>(&hash[i]));
+                x16rStages.shavite512(toHash, lenToHash, static_cast<void*>(&hash[i]));
                 break;
             case 9:
                 sph_simd512_init(&ctx_simd);
@@ -426,9 +451,7 @@ inline uint256 HashX16R(const T1 pbegin, const T1 pend, const uint256 PrevBlockH
                 sph_simd512_close(&ctx_simd, static_cast<void*>(&hash[i]));
                 break;
             case 10:
-                sph_echo512_init(&ctx_echo);
-                sph_echo512 (&ctx_echo, toHash, lenToHash);
-                sph_echo512_close(&ctx_echo, static_cast<void*>(&hash[i]));
+                x16rStages.echo512(toHash, lenToHash, static_cast<void*>(&hash[i]));
                 break;
             case 11:
                 sph_hamsi512_init(&ctx_hamsi);
@@ -469,15 +492,12 @@ inline uint256 HashX16RV2(const T1 pbegin, const T1 pend, const uint256 PrevBloc
 
     sph_blake512_context     ctx_blake;      //0
     sph_bmw512_context       ctx_bmw;        //1
-    sph_groestl512_context   ctx_groestl;    //2
     sph_jh512_context        ctx_jh;         //3
     sph_keccak512_context    ctx_keccak;     //4
     sph_skein512_context     ctx_skein;      //5
     sph_luffa512_context     ctx_luffa;      //6
     sph_cubehash512_context  ctx_cubehash;   //7
-    sph_shavite512_context   ctx_shavite;    //8
     sph_simd512_context      ctx_simd;       //9
-    sph_echo512_context      ctx_echo;       //A
     sph_hamsi512_context     ctx_hamsi;      //B
     sph_fugue512_context     ctx_fugue;      //C
     sph_shabal512_context    ctx_shabal;     //D
@@ -518,9 +538,7 @@ inline uint256 HashX16RV2(const T1 pbegin, const T1 pend, const uint256 PrevBloc
                 sph_bmw512_close(&ctx_bmw, static_cast<void*>(&hash[i]));
                 break;
             case 2:
-                sph_groestl512_init(&ctx_groestl);
-                sph_groestl512 (&ctx_groestl, toHash, lenToHash);
-                sph_groestl512_close(&ctx_groestl, static_cast<void*>(&hash[i]));
+                x16rStages.groestl512(toHash, lenToHash, static_cast<void*>(&hash[i]));
                 break;
             case 3:
                 sph_jh512_init(&ctx_jh);
@@ -556,9 +574,7 @@ inline uint256 HashX16RV2(const T1 pbegin, const T1 pend, const uint256 PrevBloc
                 sph_cubehash512_close(&ctx_cubehash, static_cast<void*>(&hash[i]));
                 break;
             case 8:
-                sph_shavite512_init(&ctx_shavite);
-                sph_shavite512(&ctx_shavite, toHash, lenToHash);
-                sph_shavite512_close(&ctx_shavite, static_cast<void*>(&hash[i]));
+                x16rStages.shavite512(toHash, lenToHash, static_cast<void*>(&hash[i]));
                 break;
             case 9:
                 sph_simd512_init(&ctx_simd);
@@ -566,9 +582,7 @@ inline uint256 HashX16RV2(const T1 pbegin, const T1 pend, const uint256 PrevBloc
                 sph_simd512_close(&ctx_simd, static_cast<void*>(&hash[i]));
                 break;
             case 10:
-                sph_echo512_init(&ctx_echo);
-                sph_echo512 (&ctx_echo, toHash, lenToHash);
-                sph_echo512_close(&ctx_echo, static_cast<void*>(&hash[i]));
+                x16rStages.echo512(toHash, lenToHash, static_cast<void*>(&hash[i]));
                 break;
             case 11:
                 sph_hamsi512_init(&ctx_hamsi);
@@ -605,6 +619,25 @@ inline uint256 HashX16RV2(const T1 pbegin, const T1 pend, const uint256 PrevBloc
     return hash[15].trim256();
 }
 
+/**
+ * Convert between uint256 and ethash::hash256 without going through hex.
+ * ethash stores hashes in the reverse byte order of uint256, so these are
+ * byte-for-byte equivalent to to_hash256(h.GetHex()) and uint256S(to_hex(h)).
+ */
+inline ethash::hash256 ToEthashHash256(const uint256& hash)
+{
+    ethash::hash256 result;
+    std::reverse_copy(hash.begin(), hash.end(), result.bytes);
+    return result;
+}
+
+inline uint256 FromEthashHash256(const ethash::hash256& hash)
+{
+    uint256 result;
+    std::reverse_copy(std::begin(hash.bytes), std::end(hash.bytes), result.begin());
+    return result;
+}
+
 uint256 KAWPOWHash(const CBlockHeader& blockHeader, uint256& mix_hash);
 uint256 KAWPOWHash_OnlyMix(const CBlockHeader& blockHeader);
 
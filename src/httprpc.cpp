@@ -8,6 +8,9 @@
 #include "base58.h"
 #include "chainparams.h"
 #include "httpserver.h"
+#include "rpc/binary.h"
+#include "rpc/jsonstream.h"
+#include "rpc/jsonview.h"
 #include "rpc/protocol.h"
 #include "rpc/server.h"
 #include "random.h"
@@ -16,8 +19,11 @@
 #include "utilstrencodings.h"
 #include "ui_interface.h"
 #include "crypto/hmac_sha256.h"
+#include "crypto/sha256.h"
 #include <stdio.h>
 
+#include <algorithm>
+
 #include <boost/algorithm/string.hpp> // boost::trim
 
 /** WWW-Authenticate to present with 401 Unauthorized response */
@@ -61,6 +67,8 @@ private:
 
 
 /* Pre-base64-encoded authentication token */
+/** Largest batch request body accepted (-rpcbatchmaxbytes) */
+static size_t nMaxBatchBytes = DEFAULT_RPC_BATCH_MAX_BYTES;
 static std::string strRPCUserColonPass;
 /* Stored RPC timer interface (for unregistration) */
 static HTTPRPCTimerInterface* httpRPCTimerInterface = nullptr;
@@ -82,6 +90,66 @@ static void JSONErrorReply(HTTPRequest* req, const UniValue& objError, const Uni
     req->WriteReply(nStatus, strReply);
 }
 
+/** One -rpcauth entry, parsed once at startup */
+struct RPCAuthEntry
+{
+    std::string strUser;
+    std::string strSalt;
+    std::string strHash;
+};
+static std::vector<RPCAuthEntry> vRPCAuth;
+
+/** A recently verified -rpcauth credential. Only a salted digest of the
+ * user:password pair is kept, never the password itself. */
+struct RPCAuthCacheEntry
+{
+    std::vector<unsigned char> vDigest;
+    int64_t nExpire;
+};
+
+static CCriticalSection cs_rpcAuthCache;
+static std::vector<RPCAuthCacheEntry> vRPCAuthCache;
+/** Random per-process salt for the cache digests */
+static unsigned char rpcAuthCacheSalt[32];
+static int64_t nRPCAuthCacheTTL = DEFAULT_RPC_AUTH_CACHE_TTL;
+
+static std::vector<unsigned char> RPCAuthCacheDigest(const std::string& strUserPass)
+{
+    std::vector<unsigned char> vDigest(CSHA256::OUTPUT_SIZE);
+    CSHA256().Write(rpcAuthCacheSalt, sizeof(rpcAuthCacheSalt)).Write(reinterpret_cast<const unsigned char*>(strUserPass.data()), strUserPass.size()).Finalize(vDigest.data());
+    return vDigest;
+}
+
+/** Whether the credential was verified less than -rpcauthcachettl seconds
+ * ago. Every live entry is compared, in constant time, so the lookup does not
+ * leak which entry matched or how much of it did. */
+static bool RPCAuthCacheLookup(const std::vector<unsigned char>& vDigest, int64_t nNow)
+{
+    LOCK(cs_rpcAuthCache);
+    bool fFound = false;
+    for (auto it = vRPCAuthCache.begin(); it != vRPCAuthCache.end();) {
+        if (it->nExpire <= nNow) {
+            it = vRPCAuthCache.erase(it);
+            continue;
+        }
+        fFound |= TimingResistantEqual(it->vDigest, vDigest);
+        ++it;
+    }
+    return fFound;
+}
+
+static void RPCAuthCacheInsert(const std::vector<unsigned char>& vDigest, int64_t nNow)
+{
+    LOCK(cs_rpcAuthCache);
+    if (vRPCAuthCache.size() >= RPC_AUTH_CACHE_SIZE) {
+        // Make room by dropping the entry closest to expiry
+        auto itOldest = std::min_element(vRPCAuthCache.begin(), vRPCAuthCache.end(),
+            [](const RPCAuthCacheEntry& a, const RPCAuthCacheEntry& b) { return a.nExpire < b.nExpire; });
+        vRPCAuthCache.erase(itOldest);
+    }
+    vRPCAuthCache.push_back(RPCAuthCacheEntry{vDigest, nNow + nRPCAuthCacheTTL});
+}
+
 //This function checks username and password against -rpcauth
 //entries from config file.
 static bool multiUserAuthorized(std::string strUserPass)
@@ -92,31 +160,34 @@ static bool multiUserAuthorized(std::string strUserPass)
     std::string strUser = strUserPass.substr(0, strUserPass.find(":"));
     std::string strPass = strUserPass.substr(strUserPass.find(":") + 1);
 
-    for (const std::string& strRPCAuth : gArgs.GetArgs("-rpcauth")) {
-        //Search for multi-user login/pass "rpcauth" from config
-        std::vector<std::string> vFields;
-        boost::split(vFields, strRPCAuth, boost::is_any_of(":$"));
-        if (vFields.size() != 3) {
-            //Incorrect formatting in config file
-            continue;
+    // Keep-alive and high rate clients send the same credential over and
+    // over; skip the HMAC for one that was checked recently
+    const int64_t nNow = GetTime();
+    std::vector<unsigned char> vDigest;
+    if (nRPCAuthCacheTTL > 0) {
+        vDigest = RPCAuthCacheDigest(strUserPass);
+        if (RPCAuthCacheLookup(vDigest, nNow)) {
+            return true;
         }
+    }
 
-        std::string strName = vFields[0];
-        if (!TimingResistantEqual(strName, strUser)) {
+    for (const RPCAuthEntry& entry : vRPCAuth) {
+        //Search for multi-user login/pass "rpcauth" from config
+        if (!TimingResistantEqual(entry.strUser, strUser)) {
             continue;
         }
 
-        std::string strSalt = vFields[1];
-        std::string strHash = vFields[2];
-
         static const unsigned int KEY_SIZE = 32;
         unsigned char out[KEY_SIZE];
 
-        CHMAC_SHA256(reinterpret_cast<const unsigned char*>(strSalt.c_str()), strSalt.size()).Write(reinterpret_cast<const unsigned char*>(strPass.c_str()), strPass.size()).Finalize(out);
+        CHMAC_SHA256(reinterpret_cast<const unsigned char*>(entry.strSalt.c_str()), entry.strSalt.size()).Write(reinterpret_cast<const unsigned char*>(strPass.c_str()), strPass.size()).Finalize(out);
         std::vector<unsigned char> hexvec(out, out+KEY_SIZE);
         std::string strHashFromPass = HexStr(hexvec);
 
-        if (TimingResistantEqual(strHashFromPass, strHash)) {
+        if (TimingResistantEqual(strHashFromPass, entry.strHash)) {
+            if (nRPCAuthCacheTTL > 0) {
+                RPCAuthCacheInsert(vDigest, nNow);
+            }
             return true;
         }
     }
@@ -143,6 +214,99 @@ static bool RPCAuthorized(const std::string& strAuth, std::string& strAuthUserna
     return multiUserAuthorized(strUserPass);
 }
 
+/** Requests and latency per authenticated user, for getrpcinfo */
+struct RPCUserCounters
+{
+    uint64_t nRequests = 0;
+    uint64_t nAuthFailures = 0;
+    int64_t nTotalMicros = 0;
+    int64_t nMaxMicros = 0;
+    //! Requests in the current and the previous whole minute
+    int64_t nMinute = 0;
+    uint64_t nThisMinute = 0;
+    uint64_t nLastMinute = 0;
+};
+
+static CCriticalSection cs_rpcUserStats;
+static std::map<std::string, RPCUserCounters> mapRPCUserStats;
+
+/** Most distinct user names tracked; failed logins can carry any name */
+static const size_t RPC_USER_STATS_MAX = 256;
+
+static RPCUserCounters* GetRPCUserCounters(const std::string& strUser)
+{
+    AssertLockHeld(cs_rpcUserStats);
+    auto it = mapRPCUserStats.find(strUser);
+    if (it == mapRPCUserStats.end()) {
+        if (mapRPCUserStats.size() >= RPC_USER_STATS_MAX)
+            return nullptr;
+        it = mapRPCUserStats.emplace(strUser, RPCUserCounters()).first;
+    }
+    return &it->second;
+}
+
+static void RecordRPCUserRequest(const std::string& strUser, int64_t nMicros)
+{
+    const int64_t nMinute = GetTime() / 60;
+    LOCK(cs_rpcUserStats);
+    RPCUserCounters* counters = GetRPCUserCounters(strUser);
+    if (!counters)
+        return;
+    counters->nRequests++;
+    counters->nTotalMicros += nMicros;
+    counters->nMaxMicros = std::max(counters->nMaxMicros, nMicros);
+    if (counters->nMinute != nMinute) {
+        counters->nLastMinute = counters->nMinute + 1 == nMinute ? counters->nThisMinute : 0;
+        counters->nThisMinute = 0;
+        counters->nMinute = nMinute;
+    }
+    counters->nThisMinute++;
+}
+
+static void RecordRPCUserAuthFailure(const std::string& strUser)
+{
+    LOCK(cs_rpcUserStats);
+    RPCUserCounters* counters = GetRPCUserCounters(strUser);
+    if (counters)
+        counters->nAuthFailures++;
+}
+
+/** Records a request against its user when it goes out of scope, whichever
+ * way the reply was sent */
+class RPCUserRequestTimer
+{
+public:
+    explicit RPCUserRequestTimer(const std::string& strUserIn) : strUser(strUserIn), nStart(GetTimeMicros()) {}
+    ~RPCUserRequestTimer() { RecordRPCUserRequest(strUser, GetTimeMicros() - nStart); }
+private:
+    const std::string& strUser;
+    const int64_t nStart;
+};
+
+std::vector<HTTPRPCUserStats> GetHTTPRPCUserStats()
+{
+    const int64_t nMinute = GetTime() / 60;
+    std::vector<HTTPRPCUserStats> vStats;
+    LOCK(cs_rpcUserStats);
+    for (const auto& item : mapRPCUserStats) {
+        const RPCUserCounters& counters = item.second;
+        HTTPRPCUserStats stats;
+        stats.name = item.first;
+        stats.nRequests = counters.nRequests;
+        stats.nAuthFailures = counters.nAuthFailures;
+        stats.nTotalMicros = counters.nTotalMicros;
+        stats.nMaxMicros = counters.nMaxMicros;
+        if (counters.nMinute == nMinute)
+            stats.nLastMinute = counters.nLastMinute;
+        else if (counters.nMinute + 1 == nMinute)
+            stats.nLastMinute = counters.nThisMinute;
+        else
+            stats.nLastMinute = 0;
+        vStats.push_back(stats);
+    }
+    return vStats;
+}
+
 static bool HTTPReq_JSONRPC(HTTPRequest* req, const std::string &)
 {
     // JSONRPC handles only POST
@@ -167,16 +331,21 @@ static bool HTTPReq_JSONRPC(HTTPRequest* req, const std::string &)
            shouldn't have their RPC port exposed. */
         MilliSleep(250);
 
+        RecordRPCUserAuthFailure(jreq.authUser);
         req->WriteHeader("WWW-Authenticate", WWW_AUTH_HEADER_DATA);
         req->WriteReply(HTTP_UNAUTHORIZED);
         return false;
     }
 
+    RPCUserRequestTimer timer(jreq.authUser);
+
     try {
-        // Parse request
-        UniValue valRequest;
-        if (!valRequest.read(req->ReadBody()))
+        // Parse request; only the params end up as UniValues
+        CJSONDocument docRequest;
+        const std::string strBody = req->ReadBody();
+        if (!docRequest.read(strBody))
             throw JSONRPCError(RPC_PARSE_ERROR, "Parse error");
+        UniValueView valRequest = docRequest.Root();
 
         // Set the URI
         jreq.URI = req->GetURI();
@@ -186,15 +355,52 @@ static bool HTTPReq_JSONRPC(HTTPRequest* req, const std::string &)
         if (valRequest.isObject()) {
             jreq.parse(valRequest);
 
-            UniValue result = tableRPC.execute(jreq);
+            // Methods that can stream their result write it straight into a
+            // chunked reply, started once the first piece is ready
+            bool fReplyStarted = false;
+            CJSONStreamWriter stream([req, &fReplyStarted](const std::string& strChunk) {
+                if (!fReplyStarted) {
+                    req->WriteHeader("Content-Type", "application/json");
+                    req->StartChunkedReply(HTTP_OK);
+                    req->WriteChunk("{\"result\":");
+                    fReplyStarted = true;
+                }
+                req->WriteChunk(strChunk);
+            });
+            jreq.stream = &stream;
+
+            UniValue result;
+            try {
+                result = tableRPC.execute(jreq);
+            } catch (...) {
+                // Too late for an error reply once part of the result is out;
+                // cut the reply short, which the client sees as a parse error
+                if (fReplyStarted) {
+                    LogPrintf("%s: %s failed while streaming its result\n", __func__, jreq.strMethod);
+                    req->EndChunkedReply();
+                    return false;
+                }
+                throw;
+            }
+
+            if (stream.IsStarted()) {
+                assert(stream.IsComplete());
+                stream.Flush();
+                req->WriteChunk(",\"error\":null,\"id\":" + jreq.id.write() + "}\n");
+                req->EndChunkedReply();
+                return true;
+            }
 
             // Send reply
             strReply = JSONRPCReply(result, NullUniValue, jreq.id);
 
         // array of requests
-        } else if (valRequest.isArray())
-            strReply = JSONRPCExecBatch(jreq, valRequest.get_array());
-        else
+        } else if (valRequest.isArray()) {
+            if (strBody.size() > nMaxBatchBytes)
+                throw JSONRPCError(RPC_INVALID_REQUEST, strprintf("Batch of %u bytes exceeds the -rpcbatchmaxbytes limit of %u", strBody.size(), nMaxBatchBytes));
+            // Spread runs of read-only calls over the other worker threads of this queue
+            strReply = JSONRPCExecBatch(jreq, valRequest, EnqueueHTTPTask, GetHTTPWorkerThreads() - 1);
+        } else
             throw JSONRPCError(RPC_PARSE_ERROR, "Top-level object parse error");
 
         req->WriteHeader("Content-Type", "application/json");
@@ -209,6 +415,91 @@ static bool HTTPReq_JSONRPC(HTTPRequest* req, const std::string &)
     return true;
 }
 
+/** /binary: the binary RPC transport, see rpc/binary.h. Authenticated like
+ * JSON-RPC; the body is a serialized vector of calls and the reply a
+ * serialized vector of their answers. */
+static bool HTTPReq_BinaryRPC(HTTPRequest* req, const std::string &)
+{
+    if (req->GetRequestMethod() != HTTPRequest::POST) {
+        req->WriteReply(HTTP_BAD_METHOD, "Binary RPC handles only POST requests");
+        return false;
+    }
+    std::pair<bool, std::string> authHeader = req->GetHeader("authorization");
+    std::string strAuthUser;
+    if (!authHeader.first || !RPCAuthorized(authHeader.second, strAuthUser)) {
+        if (authHeader.first) {
+            LogPrintf("ThreadRPCServer incorrect password attempt from %s\n", req->GetPeer().ToString());
+            RecordRPCUserAuthFailure(strAuthUser);
+            MilliSleep(250);
+        }
+        req->WriteHeader("WWW-Authenticate", WWW_AUTH_HEADER_DATA);
+        req->WriteReply(HTTP_UNAUTHORIZED);
+        return false;
+    }
+
+    RPCUserRequestTimer timer(strAuthUser);
+    std::string strReply;
+    try {
+        strReply = ExecuteBinaryRPC(req->ReadBody());
+    } catch (const std::exception& e) {
+        req->WriteHeader("Content-Type", "text/plain");
+        req->WriteReply(HTTP_BAD_REQUEST, std::string("Malformed request: ") + e.what() + "\r\n");
+        return false;
+    }
+    req->WriteHeader("Content-Type", "application/octet-stream");
+    req->WriteReply(HTTP_OK, strReply);
+    return true;
+}
+
+/** Bytes of a request body looked at to find the method it calls */
+static const size_t RPC_ROUTE_PEEK_SIZE = 1024;
+
+/** Method of a single JSON-RPC request, for -rpcroute. Only the top level of
+ * the start of the body is tokenized; batches and anything the method can't be
+ * found in go to the default queue. */
+static std::string HTTPRPCRouteKey(HTTPRequest* req)
+{
+    const std::string strBody = req->PeekBody(RPC_ROUTE_PEEK_SIZE);
+    const char* pos = strBody.data();
+    const char* end = pos + strBody.size();
+    std::string tokenVal;
+    unsigned int consumed;
+    int nDepth = 0;
+    bool fExpectKey = true, fMethod = false;
+    while (true) {
+        enum jtokentype tok = getJsonToken(tokenVal, consumed, pos, end);
+        pos += consumed;
+        if (tok == JTOK_ERR || tok == JTOK_NONE)
+            return "";
+        if (nDepth == 0) {
+            // Only a single request object
+            if (tok != JTOK_OBJ_OPEN)
+                return "";
+            nDepth = 1;
+            continue;
+        }
+        if (tok == JTOK_OBJ_OPEN || tok == JTOK_ARR_OPEN) {
+            nDepth++;
+        } else if (tok == JTOK_OBJ_CLOSE || tok == JTOK_ARR_CLOSE) {
+            if (--nDepth == 1)
+                fMethod = false;
+            else if (nDepth == 0)
+                return "";
+        } else if (nDepth == 1) {
+            if (tok == JTOK_COMMA) {
+                fExpectKey = true;
+            } else if (tok == JTOK_STRING && fExpectKey) {
+                fMethod = tokenVal == "method";
+                fExpectKey = false;
+            } else if (tok == JTOK_STRING && fMethod) {
+                return tokenVal;
+            } else if (tok != JTOK_COLON) {
+                fMethod = false;
+            }
+        }
+    }
+}
+
 static bool InitRPCAuthentication()
 {
     if (gArgs.GetArg("-rpcpassword", "") == "")
@@ -224,6 +515,25 @@ static bool InitRPCAuthentication()
         LogPrintf("Config options rpcuser and rpcpassword will soon be deprecated. Locally-run instances may remove rpcuser to use cookie-based auth, or may be replaced with rpcauth. Please see share/rpcuser for rpcauth auth generation.\n");
         strRPCUserColonPass = gArgs.GetArg("-rpcuser", "") + ":" + gArgs.GetArg("-rpcpassword", "");
     }
+
+    vRPCAuth.clear();
+    for (const std::string& strRPCAuth : gArgs.GetArgs("-rpcauth")) {
+        std::vector<std::string> vFields;
+        boost::split(vFields, strRPCAuth, boost::is_any_of(":$"));
+        if (vFields.size() != 3) {
+            //Incorrect formatting in config file
+            LogPrintf("Ignoring malformed -rpcauth entry\n");
+            continue;
+        }
+        vRPCAuth.push_back(RPCAuthEntry{vFields[0], vFields[1], vFields[2]});
+    }
+
+    nRPCAuthCacheTTL = std::max<int64_t>(gArgs.GetArg("-rpcauthcachettl", DEFAULT_RPC_AUTH_CACHE_TTL), 0);
+    GetRandBytes(rpcAuthCacheSalt, sizeof(rpcAuthCacheSalt));
+    {
+        LOCK(cs_rpcAuthCache);
+        vRPCAuthCache.clear();
+    }
     return true;
 }
 
@@ -233,10 +543,13 @@ bool StartHTTPRPC()
     if (!InitRPCAuthentication())
         return false;
 
-    RegisterHTTPHandler("/", true, HTTPReq_JSONRPC);
+    nMaxBatchBytes = std::max<int64_t>(gArgs.GetArg("-rpcbatchmaxbytes", DEFAULT_RPC_BATCH_MAX_BYTES), 0);
+
+    RegisterHTTPHandler("/", true, HTTPReq_JSONRPC, HTTPRPCRouteKey);
+    RegisterHTTPHandler("/binary", true, HTTPReq_BinaryRPC);
 #ifdef ENABLE_WALLET
     // ifdef can be removed once we switch to better endpoint support and API versioning
-    RegisterHTTPHandler("/wallet/", false, HTTPReq_JSONRPC);
+    RegisterHTTPHandler("/wallet/", false, HTTPReq_JSONRPC, HTTPRPCRouteKey);
 #endif
     assert(EventBase());
     httpRPCTimerInterface = new HTTPRPCTimerInterface(EventBase());
@@ -253,6 +566,7 @@ void StopHTTPRPC()
 {
     LogPrint(BCLog::RPC, "Stopping HTTP RPC server\n");
     UnregisterHTTPHandler("/", true);
+    UnregisterHTTPHandler("/binary", true);
     if (httpRPCTimerInterface) {
         RPCUnsetTimerInterface(httpRPCTimerInterface);
         delete httpRPCTimerInterface;
@@ -6,8 +6,34 @@
 #ifndef MYNTA_HTTPRPC_H
 #define MYNTA_HTTPRPC_H
 
+#include <stdint.h>
 #include <string>
 #include <map>
+#include <vector>
+
+/** Largest JSON-RPC batch request body accepted, in bytes */
+static const int64_t DEFAULT_RPC_BATCH_MAX_BYTES = 4 * 1024 * 1024;
+
+/** Seconds a verified -rpcauth credential is trusted without hashing it again */
+static const int64_t DEFAULT_RPC_AUTH_CACHE_TTL = 60;
+/** Most -rpcauth credentials remembered at once */
+static const size_t RPC_AUTH_CACHE_SIZE = 64;
+
+/** Requests and latency of one RPC user */
+struct HTTPRPCUserStats
+{
+    std::string name;
+    uint64_t nRequests;
+    //! Requests rejected for a wrong password
+    uint64_t nAuthFailures;
+    //! Time spent handling the user's requests
+    int64_t nTotalMicros;
+    int64_t nMaxMicros;
+    //! Requests in the last whole minute
+    uint64_t nLastMinute;
+};
+/** Stats for every user that sent a request, by name */
+std::vector<HTTPRPCUserStats> GetHTTPRPCUserStats();
 
 /** Start HTTP RPC subsystem.
  * Precondition; HTTP and RPC has been started.
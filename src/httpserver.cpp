@@ -17,7 +17,10 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <algorithm>
 #include <deque>
+#include <map>
+#include <memory>
 
 #include <sys/types.h>
 #include <sys/stat.h>
@@ -61,6 +64,22 @@ private:
     HTTPRequestHandler func;
 };
 
+/** Task queued with EnqueueHTTPTask */
+class HTTPTaskItem final : public HTTPClosure
+{
+public:
+    explicit HTTPTaskItem(const std::function<void()>& _task): task(_task)
+    {
+    }
+    void operator()() override
+    {
+        task();
+    }
+
+private:
+    std::function<void()> task;
+};
+
 /** Simple work queue for distributing work over multiple threads.
  * Work items are simply callable objects.
  */
@@ -71,11 +90,20 @@ private:
     /** Mutex protects entire object */
     std::mutex cs;
     std::condition_variable cond;
-    std::deque<std::unique_ptr<WorkItem>> queue;
+    /** Items with the time they were queued at */
+    std::deque<std::pair<int64_t, std::unique_ptr<WorkItem>>> queue;
     bool running;
     size_t maxDepth;
     int numThreads;
 
+    /** Latency counters, see HTTPWorkQueueStats */
+    uint64_t nProcessed;
+    uint64_t nRejected;
+    int64_t nTotalWaitMicros;
+    int64_t nMaxWaitMicros;
+    int64_t nTotalRunMicros;
+    int64_t nMaxRunMicros;
+
     /** RAII object to keep track of number of running worker threads */
     class ThreadCounter
     {
@@ -95,9 +123,21 @@ private:
     };
 
 public:
-    explicit WorkQueue(size_t _maxDepth) : running(true),
+    /** Name for -rpcroute and getrpcinfo, and number of threads to start for it */
+    const std::string name;
+    const int threads;
+
+    WorkQueue(const std::string& _name, int _threads, size_t _maxDepth) : running(true),
                                  maxDepth(_maxDepth),
-                                 numThreads(0)
+                                 numThreads(0),
+                                 nProcessed(0),
+                                 nRejected(0),
+                                 nTotalWaitMicros(0),
+                                 nMaxWaitMicros(0),
+                                 nTotalRunMicros(0),
+                                 nMaxRunMicros(0),
+                                 name(_name),
+                                 threads(_threads)
     {
     }
     /** Precondition: worker threads have all stopped
@@ -111,9 +151,10 @@ public:
     {
         std::unique_lock<std::mutex> lock(cs);
         if (!running || queue.size() >= maxDepth) {
+            nRejected++;
             return false;
         }
-        queue.emplace_back(std::unique_ptr<WorkItem>(item));
+        queue.emplace_back(GetTimeMicros(), std::unique_ptr<WorkItem>(item));
         cond.notify_one();
         return true;
     }
@@ -123,16 +164,28 @@ public:
         ThreadCounter count(*this);
         while (true) {
             std::unique_ptr<WorkItem> i;
+            int64_t nWait;
             {
                 std::unique_lock<std::mutex> lock(cs);
                 while (running && queue.empty())
                     cond.wait(lock);
                 if (!running && queue.empty())
                     break;
-                i = std::move(queue.front());
+                nWait = GetTimeMicros() - queue.front().first;
+                i = std::move(queue.front().second);
                 queue.pop_front();
             }
+            int64_t nStart = GetTimeMicros();
             (*i)();
+            int64_t nRun = GetTimeMicros() - nStart;
+            {
+                std::unique_lock<std::mutex> lock(cs);
+                nProcessed++;
+                nTotalWaitMicros += nWait;
+                nMaxWaitMicros = std::max(nMaxWaitMicros, nWait);
+                nTotalRunMicros += nRun;
+                nMaxRunMicros = std::max(nMaxRunMicros, nRun);
+            }
         }
     }
     /** Interrupt and exit loops */
@@ -149,18 +202,35 @@ public:
         while (numThreads > 0)
             cond.wait(lock);
     }
+    HTTPWorkQueueStats GetStats()
+    {
+        std::unique_lock<std::mutex> lock(cs);
+        HTTPWorkQueueStats stats;
+        stats.name = name;
+        stats.nThreads = threads;
+        stats.nMaxDepth = maxDepth;
+        stats.nDepth = queue.size();
+        stats.nProcessed = nProcessed;
+        stats.nRejected = nRejected;
+        stats.nTotalWaitMicros = nTotalWaitMicros;
+        stats.nMaxWaitMicros = nMaxWaitMicros;
+        stats.nTotalRunMicros = nTotalRunMicros;
+        stats.nMaxRunMicros = nMaxRunMicros;
+        return stats;
+    }
 };
 
 struct HTTPPathHandler
 {
     HTTPPathHandler() {}
-    HTTPPathHandler(std::string _prefix, bool _exactMatch, HTTPRequestHandler _handler):
-        prefix(_prefix), exactMatch(_exactMatch), handler(_handler)
+    HTTPPathHandler(std::string _prefix, bool _exactMatch, HTTPRequestHandler _handler, HTTPRouteKeyFunc _routeKey):
+        prefix(_prefix), exactMatch(_exactMatch), handler(_handler), routeKey(_routeKey)
     {
     }
     std::string prefix;
     bool exactMatch;
     HTTPRequestHandler handler;
+    HTTPRouteKeyFunc routeKey;
 };
 
 /** HTTP module state */
@@ -171,8 +241,11 @@ static struct event_base* eventBase = nullptr;
 struct evhttp* eventHTTP = nullptr;
 //! List of subnets to allow RPC connections from
 static std::vector<CSubNet> rpc_allow_subnets;
-//! Work queue for handling longer requests off the event loop thread
-static WorkQueue<HTTPClosure>* workQueue = nullptr;
+//! Work queues for handling longer requests off the event loop thread, the default one first
+static std::vector<std::unique_ptr<WorkQueue<HTTPClosure>>> workQueues;
+//! -rpcroute entries: request names (e.g. JSON-RPC methods) and URI prefixes to the queue serving them
+static std::map<std::string, WorkQueue<HTTPClosure>*> mapNameRoutes;
+static std::vector<std::pair<std::string, WorkQueue<HTTPClosure>*>> vPrefixRoutes;
 //! Handlers for (sub)paths
 std::vector<HTTPPathHandler> pathHandlers;
 //! Bound listening sockets
@@ -238,6 +311,23 @@ static std::string RequestMethodString(HTTPRequest::RequestMethod m)
     }
 }
 
+/** Pick the work queue for a request: by the handler's route key (e.g. the
+ * JSON-RPC method) first, then by the longest matching URI prefix */
+static WorkQueue<HTTPClosure>* SelectWorkQueue(HTTPRequest* req, const std::string& strURI, const HTTPPathHandler& handler)
+{
+    assert(!workQueues.empty());
+    if (!mapNameRoutes.empty() && handler.routeKey) {
+        auto it = mapNameRoutes.find(handler.routeKey(req));
+        if (it != mapNameRoutes.end())
+            return it->second;
+    }
+    for (const auto& route : vPrefixRoutes) {
+        if (strURI.compare(0, route.first.size(), route.first) == 0)
+            return route.second;
+    }
+    return workQueues[0].get();
+}
+
 /** HTTP request callback */
 static void http_request_cb(struct evhttp_request* req, void* arg)
 {
@@ -277,13 +367,16 @@ static void http_request_cb(struct evhttp_request* req, void* arg)
 
     // Dispatch to worker thread
     if (i != iend) {
+        WorkQueue<HTTPClosure>* queue = SelectWorkQueue(hreq.get(), strURI, *i);
         std::unique_ptr<HTTPWorkItem> item(new HTTPWorkItem(std::move(hreq), path, i->handler));
-        assert(workQueue);
-        if (workQueue->Enqueue(item.get()))
+        if (queue->Enqueue(item.get()))
             item.release(); /* if true, queue took ownership */
-        else {
+        else if (queue == workQueues[0].get()) {
             LogPrintf("WARNING: request rejected because http work queue depth exceeded, it can be increased with the -rpcworkqueue= setting\n");
             item->req->WriteReply(HTTP_INTERNAL, "Work queue depth exceeded");
+        } else {
+            LogPrintf("WARNING: request rejected because http work queue %s depth exceeded, it can be increased with the -rpcqueue= setting\n", queue->name);
+            item->req->WriteReply(HTTP_INTERNAL, "Work queue depth exceeded");
         }
     } else {
         hreq->WriteReply(HTTP_NOTFOUND);
@@ -346,10 +439,69 @@ static bool HTTPBindAddresses(struct evhttp* http)
     return !boundSockets.empty();
 }
 
+/** Create the default work queue, the ones given with -rpcqueue and the -rpcroute table */
+static bool InitHTTPWorkQueues()
+{
+    int rpcThreads = std::max((long)gArgs.GetArg("-rpcthreads", DEFAULT_HTTP_THREADS), 1L);
+    int workQueueDepth = std::max((long)gArgs.GetArg("-rpcworkqueue", DEFAULT_HTTP_WORKQUEUE), 1L);
+    LogPrintf("HTTP: creating work queue of depth %d\n", workQueueDepth);
+    workQueues.emplace_back(new WorkQueue<HTTPClosure>(DEFAULT_HTTP_WORKQUEUE_NAME, rpcThreads, workQueueDepth));
+
+    std::map<std::string, WorkQueue<HTTPClosure>*> mapQueues;
+    mapQueues[DEFAULT_HTTP_WORKQUEUE_NAME] = workQueues[0].get();
+    for (const std::string& strQueue : gArgs.GetArgs("-rpcqueue")) {
+        std::vector<std::string> vFields;
+        size_t nStart = 0, nEnd;
+        while ((nEnd = strQueue.find(':', nStart)) != std::string::npos) {
+            vFields.push_back(strQueue.substr(nStart, nEnd - nStart));
+            nStart = nEnd + 1;
+        }
+        vFields.push_back(strQueue.substr(nStart));
+        int nThreads = 0;
+        int nDepth = DEFAULT_HTTP_WORKQUEUE;
+        if (vFields.size() < 2 || vFields.size() > 3 || vFields[0].empty() || mapQueues.count(vFields[0]) ||
+            !ParseInt32(vFields[1], &nThreads) || nThreads < 1 ||
+            (vFields.size() == 3 && (!ParseInt32(vFields[2], &nDepth) || nDepth < 1))) {
+            uiInterface.ThreadSafeMessageBox(
+                strprintf("Invalid -rpcqueue specification: %s. Expected a new queue name, a number of threads and optionally a depth, e.g. mining:2:16.", strQueue),
+                "", CClientUIInterface::MSG_ERROR);
+            return false;
+        }
+        LogPrintf("HTTP: creating work queue %s of depth %d with %d threads\n", vFields[0], nDepth, nThreads);
+        workQueues.emplace_back(new WorkQueue<HTTPClosure>(vFields[0], nThreads, nDepth));
+        mapQueues[vFields[0]] = workQueues.back().get();
+    }
+
+    for (const std::string& strRoute : gArgs.GetArgs("-rpcroute")) {
+        size_t nPos = strRoute.rfind(':');
+        auto itQueue = nPos == std::string::npos ? mapQueues.end() : mapQueues.find(strRoute.substr(nPos + 1));
+        if (nPos == 0 || itQueue == mapQueues.end()) {
+            uiInterface.ThreadSafeMessageBox(
+                strprintf("Invalid -rpcroute specification: %s. Expected a method name or URI prefix starting with /, and a queue name, e.g. getblocktemplate:mining.", strRoute),
+                "", CClientUIInterface::MSG_ERROR);
+            return false;
+        }
+        std::string strKey = strRoute.substr(0, nPos);
+        if (strKey[0] == '/')
+            vPrefixRoutes.emplace_back(strKey, itQueue->second);
+        else
+            mapNameRoutes[strKey] = itQueue->second;
+    }
+    // Longest prefix first
+    std::stable_sort(vPrefixRoutes.begin(), vPrefixRoutes.end(), [](const std::pair<std::string, WorkQueue<HTTPClosure>*>& a, const std::pair<std::string, WorkQueue<HTTPClosure>*>& b) {
+        return a.first.size() > b.first.size();
+    });
+    return true;
+}
+
 /** Simple wrapper to set thread name and run work queue */
+//! Work queue served by the current thread, if it is an HTTP worker
+static thread_local WorkQueue<HTTPClosure>* currentWorkQueue = nullptr;
+
 static void HTTPWorkQueueRun(WorkQueue<HTTPClosure>* queue)
 {
     RenameThread("raven-httpworker");
+    currentWorkQueue = queue;
     queue->Run();
 }
 
@@ -414,10 +566,9 @@ bool InitHTTPServer()
     }
 
     LogPrint(BCLog::HTTP, "Initialized HTTP server\n");
-    int workQueueDepth = std::max((long)gArgs.GetArg("-rpcworkqueue", DEFAULT_HTTP_WORKQUEUE), 1L);
-    LogPrintf("HTTP: creating work queue of depth %d\n", workQueueDepth);
+    if (!InitHTTPWorkQueues())
+        return false;
 
-    workQueue = new WorkQueue<HTTPClosure>(workQueueDepth);
     // transfer ownership to eventBase/HTTP via .release()
     eventBase = base_ctr.release();
     eventHTTP = http_ctr.release();
@@ -444,15 +595,16 @@ std::future<bool> threadResult;
 bool StartHTTPServer()
 {
     LogPrint(BCLog::HTTP, "Starting HTTP server\n");
-    int rpcThreads = std::max((long)gArgs.GetArg("-rpcthreads", DEFAULT_HTTP_THREADS), 1L);
-    LogPrintf("HTTP: starting %d worker threads\n", rpcThreads);
     std::packaged_task<bool(event_base*, evhttp*)> task(ThreadHTTP);
     threadResult = task.get_future();
     threadHTTP = std::thread(std::move(task), eventBase, eventHTTP);
 
-    for (int i = 0; i < rpcThreads; i++) {
-        std::thread rpc_worker(HTTPWorkQueueRun, workQueue);
-        rpc_worker.detach();
+    for (const auto& queue : workQueues) {
+        LogPrintf("HTTP: starting %d worker threads for work queue %s\n", queue->threads, queue->name);
+        for (int i = 0; i < queue->threads; i++) {
+            std::thread rpc_worker(HTTPWorkQueueRun, queue.get());
+            rpc_worker.detach();
+        }
     }
     return true;
 }
@@ -468,16 +620,17 @@ void InterruptHTTPServer()
         // Reject requests on current connections
         evhttp_set_gencb(eventHTTP, http_reject_request_cb, nullptr);
     }
-    if (workQueue)
-        workQueue->Interrupt();
+    for (const auto& queue : workQueues)
+        queue->Interrupt();
 }
 
 void StopHTTPServer()
 {
     LogPrint(BCLog::HTTP, "Stopping HTTP server\n");
-    if (workQueue) {
+    if (!workQueues.empty()) {
         LogPrint(BCLog::HTTP, "Waiting for HTTP worker threads to exit\n");
-        workQueue->WaitExit();
+        for (const auto& queue : workQueues)
+            queue->WaitExit();
     }
     if (eventBase) {
         LogPrint(BCLog::HTTP, "Waiting for HTTP event thread to exit\n");
@@ -503,13 +656,45 @@ void StopHTTPServer()
         event_base_free(eventBase);
         eventBase = nullptr;
     }
-    if (workQueue) {
-        delete workQueue;
-        workQueue = nullptr;
-    }
+    mapNameRoutes.clear();
+    vPrefixRoutes.clear();
+    workQueues.clear();
     LogPrint(BCLog::HTTP, "Stopped HTTP server\n");
 }
 
+static WorkQueue<HTTPClosure>* CurrentWorkQueue()
+{
+    if (currentWorkQueue)
+        return currentWorkQueue;
+    return workQueues.empty() ? nullptr : workQueues[0].get();
+}
+
+bool EnqueueHTTPTask(const std::function<void()>& task)
+{
+    WorkQueue<HTTPClosure>* queue = CurrentWorkQueue();
+    if (!queue)
+        return false;
+    std::unique_ptr<HTTPTaskItem> item(new HTTPTaskItem(task));
+    if (!queue->Enqueue(item.get()))
+        return false;
+    item.release(); /* queue took ownership */
+    return true;
+}
+
+int GetHTTPWorkerThreads()
+{
+    WorkQueue<HTTPClosure>* queue = CurrentWorkQueue();
+    return queue ? queue->threads : 0;
+}
+
+std::vector<HTTPWorkQueueStats> GetHTTPWorkQueueStats()
+{
+    std::vector<HTTPWorkQueueStats> vStats;
+    for (const auto& queue : workQueues)
+        vStats.push_back(queue->GetStats());
+    return vStats;
+}
+
 struct event_base* EventBase()
 {
     return eventBase;
@@ -542,7 +727,8 @@ void HTTPEvent::trigger(struct timeval* tv)
         evtimer_add(ev, tv); // trigger after timeval passed
 }
 HTTPRequest::HTTPRequest(struct evhttp_request* _req) : req(_req),
-                                                       replySent(false)
+                                                       replySent(false),
+                                                       replyStarted(false)
 {
 }
 HTTPRequest::~HTTPRequest()
@@ -550,7 +736,10 @@ HTTPRequest::~HTTPRequest()
     if (!replySent) {
         // Keep track of whether reply was sent to avoid request leaks
         LogPrintf("%s: Unhandled request\n", __func__);
-        WriteReply(HTTP_INTERNAL, "Unhandled request");
+        if (replyStarted)
+            EndChunkedReply();
+        else
+            WriteReply(HTTP_INTERNAL, "Unhandled request");
     }
     // evhttpd cleans up the request, as long as a reply was sent.
 }
@@ -586,6 +775,17 @@ std::string HTTPRequest::ReadBody()
     return rv;
 }
 
+std::string HTTPRequest::PeekBody(size_t nMaxSize)
+{
+    struct evbuffer* buf = evhttp_request_get_input_buffer(req);
+    if (!buf)
+        return "";
+    std::string rv(std::min(nMaxSize, evbuffer_get_length(buf)), '\0');
+    ev_ssize_t nCopied = evbuffer_copyout(buf, &rv[0], rv.size());
+    rv.resize(std::max(nCopied, (ev_ssize_t)0));
+    return rv;
+}
+
 void HTTPRequest::WriteHeader(const std::string& hdr, const std::string& value)
 {
     struct evkeyvalq* headers = evhttp_request_get_output_headers(req);
@@ -600,7 +800,7 @@ void HTTPRequest::WriteHeader(const std::string& hdr, const std::string& value)
  */
 void HTTPRequest::WriteReply(int nStatus, const std::string& strReply)
 {
-    assert(!replySent && req);
+    assert(!replySent && !replyStarted && req);
     // Send event to main http thread to send reply message
     struct evbuffer* evb = evhttp_request_get_output_buffer(req);
     assert(evb);
@@ -612,6 +812,45 @@ void HTTPRequest::WriteReply(int nStatus, const std::string& strReply)
     req = nullptr; // transferred back to main thread
 }
 
+/** Chunked replies are sent from the main http thread the same way. Events
+ * triggered from one thread run in the order they were triggered, so the
+ * chunks go out in order.
+ */
+void HTTPRequest::StartChunkedReply(int nStatus)
+{
+    assert(!replySent && !replyStarted && req);
+    HTTPEvent* ev = new HTTPEvent(eventBase, true,
+        std::bind(evhttp_send_reply_start, req, nStatus, (const char*)nullptr));
+    ev->trigger(nullptr);
+    replyStarted = true;
+}
+
+void HTTPRequest::WriteChunk(const std::string& strChunk)
+{
+    assert(!replySent && replyStarted && req);
+    // An empty chunk would end the reply
+    if (strChunk.empty())
+        return;
+    struct evbuffer* evb = evbuffer_new();
+    assert(evb);
+    evbuffer_add(evb, strChunk.data(), strChunk.size());
+    struct evhttp_request* reqChunk = req;
+    HTTPEvent* ev = new HTTPEvent(eventBase, true, [reqChunk, evb]() {
+        evhttp_send_reply_chunk(reqChunk, evb);
+        evbuffer_free(evb);
+    });
+    ev->trigger(nullptr);
+}
+
+void HTTPRequest::EndChunkedReply()
+{
+    assert(!replySent && replyStarted && req);
+    HTTPEvent* ev = new HTTPEvent(eventBase, true, std::bind(evhttp_send_reply_end, req));
+    ev->trigger(nullptr);
+    replySent = true;
+    req = nullptr; // transferred back to main thread
+}
+
 CService HTTPRequest::GetPeer()
 {
     evhttp_connection* con = evhttp_request_get_connection(req);
@@ -652,10 +891,10 @@ HTTPRequest::RequestMethod HTTPRequest::GetRequestMethod()
     }
 }
 
-void RegisterHTTPHandler(const std::string &prefix, bool exactMatch, const HTTPRequestHandler &handler)
+void RegisterHTTPHandler(const std::string &prefix, bool exactMatch, const HTTPRequestHandler &handler, const HTTPRouteKeyFunc &routeKey)
 {
     LogPrint(BCLog::HTTP, "Registering HTTP handler for %s (exactmatch %d)\n", prefix, exactMatch);
-    pathHandlers.push_back(HTTPPathHandler(prefix, exactMatch, handler));
+    pathHandlers.push_back(HTTPPathHandler(prefix, exactMatch, handler, routeKey));
 }
 
 void UnregisterHTTPHandler(const std::string &prefix, bool exactMatch)
@@ -9,10 +9,13 @@
 #include <string>
 #include <stdint.h>
 #include <functional>
+#include <vector>
 
 static const int DEFAULT_HTTP_THREADS=4;
 static const int DEFAULT_HTTP_WORKQUEUE=16;
 static const int DEFAULT_HTTP_SERVER_TIMEOUT=30;
+/** Name of the work queue configured by -rpcthreads and -rpcworkqueue */
+static const char* const DEFAULT_HTTP_WORKQUEUE_NAME = "default";
 
 struct evhttp_request;
 struct event_base;
@@ -39,14 +42,45 @@ bool UpdateHTTPServerLogging(bool enable);
 
 /** Handler for requests to a certain HTTP path */
 typedef std::function<bool(HTTPRequest* req, const std::string &)> HTTPRequestHandler;
+/** Name a request is routed by with -rpcroute (e.g. its JSON-RPC method), or empty.
+ * Called on the event loop thread, so it must be cheap and leave the body unread.
+ */
+typedef std::function<std::string(HTTPRequest* req)> HTTPRouteKeyFunc;
 /** Register handler for prefix.
  * If multiple handlers match a prefix, the first-registered one will
  * be invoked.
  */
-void RegisterHTTPHandler(const std::string &prefix, bool exactMatch, const HTTPRequestHandler &handler);
+void RegisterHTTPHandler(const std::string &prefix, bool exactMatch, const HTTPRequestHandler &handler, const HTTPRouteKeyFunc &routeKey = nullptr);
 /** Unregister handler for prefix */
 void UnregisterHTTPHandler(const std::string &prefix, bool exactMatch);
 
+/** Depth and latency of one HTTP work queue */
+struct HTTPWorkQueueStats
+{
+    std::string name;
+    int nThreads;
+    size_t nDepth;
+    size_t nMaxDepth;
+    uint64_t nProcessed;
+    //! Requests turned away because the queue was full
+    uint64_t nRejected;
+    //! Time spent waiting for a worker, and handling the request
+    int64_t nTotalWaitMicros;
+    int64_t nMaxWaitMicros;
+    int64_t nTotalRunMicros;
+    int64_t nMaxRunMicros;
+};
+/** Stats for every work queue, the default one first */
+std::vector<HTTPWorkQueueStats> GetHTTPWorkQueueStats();
+
+/** Queue a task behind the requests waiting on the calling worker thread's
+ * work queue (the default queue if not called from a worker). Returns false
+ * if the queue is full or stopped, in which case the task will not run.
+ */
+bool EnqueueHTTPTask(const std::function<void()>& task);
+/** Number of threads serving the calling worker thread's work queue */
+int GetHTTPWorkerThreads();
+
 /** Return evhttp event base. This can be used by submodules to
  * queue timers or custom events.
  */
@@ -60,6 +94,7 @@ class HTTPRequest
 private:
     struct evhttp_request* req;
     bool replySent;
+    bool replyStarted;
 
 public:
     explicit HTTPRequest(struct evhttp_request* req);
@@ -99,6 +134,11 @@ public:
      */
     std::string ReadBody();
 
+    /**
+     * Copy up to nMaxSize bytes of the request body, leaving it to be read.
+     */
+    std::string PeekBody(size_t nMaxSize);
+
     /**
      * Write output header.
      *
@@ -115,6 +155,21 @@ public:
      * main thread, do not call any other HTTPRequest methods after calling this.
      */
     void WriteReply(int nStatus, const std::string& strReply = "");
+
+    /**
+     * Start a chunked HTTP reply, for bodies produced a piece at a time.
+     * Follow with any number of WriteChunk calls and finish with EndChunkedReply,
+     * instead of WriteReply. HTTP/1.0 clients get the body unchunked and the
+     * connection closed at the end.
+     */
+    void StartChunkedReply(int nStatus);
+    void WriteChunk(const std::string& strChunk);
+    /**
+     * Finish a chunked HTTP reply.
+     *
+     * @note Like WriteReply, this gives the request back to the main thread.
+     */
+    void EndChunkedReply();
 };
 
 /** Event handler closure.
@@ -0,0 +1,324 @@
+// Copyright (c) 2026 The Mynta Core Developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include "indexbuilder.h"
+
+#include "assets/assets.h"
+#include "chain.h"
+#include "chainparams.h"
+#include "hash.h"
+#include "primitives/block.h"
+#include "txdb.h"
+#include "undo.h"
+#include "util.h"
+#include "validation.h"
+#include "versionbits.h"
+
+#include <boost/thread.hpp>
+
+void CIndexBuildBatch::Clear()
+{
+    vAddressIndex.clear();
+    vAddressUnspent.clear();
+    vSpentIndex.clear();
+    vTimestamps.clear();
+}
+
+int GetIndexedAddress(const CScript& script, bool fAssets, uint160& hashBytes, std::string& strAsset, CAmount& nAssetAmount)
+{
+    strAsset.clear();
+    if (script.IsPayToScriptHash()) {
+        hashBytes = uint160(std::vector<unsigned char>(script.begin() + 2, script.begin() + 22));
+        return 2;
+    }
+    if (script.IsPayToPublicKeyHash()) {
+        hashBytes = uint160(std::vector<unsigned char>(script.begin() + 3, script.begin() + 23));
+        return 1;
+    }
+    if (script.IsPayToPublicKey()) {
+        hashBytes = Hash160(script.begin() + 1, script.end() - 1);
+        return 1;
+    }
+    hashBytes.SetNull();
+    if (fAssets && ParseAssetScript(script, hashBytes, strAsset, nAssetAmount))
+        return 1;
+    strAsset.clear();
+    hashBytes.SetNull();
+    return 0;
+}
+
+void AppendBlockIndexEntries(const CBlock& block, const CBlockUndo& blockundo, int nHeight, bool fAssets,
+                             bool fAddressIndex, bool fSpentIndex, CIndexBuildBatch& batch)
+{
+    uint160 hashBytes;
+    std::string strAsset;
+    CAmount nAssetAmount;
+    for (unsigned int i = 0; i < block.vtx.size(); i++) {
+        const CTransaction& tx = *block.vtx[i];
+        const uint256 txhash = tx.GetHash();
+
+        if (!tx.IsCoinBase() && (fAddressIndex || fSpentIndex)) {
+            const CTxUndo& txundo = blockundo.vtxundo[i - 1];
+            for (size_t j = 0; j < tx.vin.size(); j++) {
+                const CTxIn& input = tx.vin[j];
+                const CTxOut& prevout = txundo.vprevout[j].out;
+                const int addressType = GetIndexedAddress(prevout.scriptPubKey, fAssets, hashBytes, strAsset, nAssetAmount);
+
+                if (fAddressIndex && addressType > 0) {
+                    if (!strAsset.empty()) {
+                        // record spending activity
+                        batch.vAddressIndex.emplace_back(CAddressIndexKey(addressType, hashBytes, strAsset, nHeight, i, txhash, j, true), nAssetAmount * -1);
+
+                        // remove address from unspent index
+                        batch.vAddressUnspent.emplace_back(CAddressUnspentKey(addressType, hashBytes, strAsset, input.prevout.hash, input.prevout.n), CAddressUnspentValue());
+                    } else {
+                        batch.vAddressIndex.emplace_back(CAddressIndexKey(addressType, hashBytes, nHeight, i, txhash, j, true), prevout.nValue * -1);
+                        batch.vAddressUnspent.emplace_back(CAddressUnspentKey(addressType, hashBytes, input.prevout.hash, input.prevout.n), CAddressUnspentValue());
+                    }
+                }
+
+                if (fSpentIndex) {
+                    // the txid and input that spent an output, and the amount and address an input spends
+                    batch.vSpentIndex.emplace_back(CSpentIndexKey(input.prevout.hash, input.prevout.n), CSpentIndexValue(txhash, j, nHeight, prevout.nValue, addressType, hashBytes));
+                }
+            }
+        }
+
+        if (!fAddressIndex)
+            continue;
+        for (unsigned int k = 0; k < tx.vout.size(); k++) {
+            const CTxOut& out = tx.vout[k];
+            const int addressType = GetIndexedAddress(out.scriptPubKey, fAssets, hashBytes, strAsset, nAssetAmount);
+            if (addressType == 0)
+                continue;
+
+            if (!strAsset.empty()) {
+                // record receiving activity
+                batch.vAddressIndex.emplace_back(CAddressIndexKey(addressType, hashBytes, strAsset, nHeight, i, txhash, k, false), nAssetAmount);
+
+                // record unspent output
+                batch.vAddressUnspent.emplace_back(CAddressUnspentKey(addressType, hashBytes, strAsset, txhash, k), CAddressUnspentValue(nAssetAmount, out.scriptPubKey, nHeight));
+            } else {
+                batch.vAddressIndex.emplace_back(CAddressIndexKey(addressType, hashBytes, nHeight, i, txhash, k, false), out.nValue);
+                batch.vAddressUnspent.emplace_back(CAddressUnspentKey(addressType, hashBytes, txhash, k), CAddressUnspentValue(out.nValue, out.scriptPubKey, nHeight));
+            }
+        }
+    }
+}
+
+static std::string IndexBuildNames(uint32_t nIndexes)
+{
+    std::vector<std::string> vNames;
+    if (nIndexes & INDEX_BUILD_ADDRESS)
+        vNames.push_back("address");
+    if (nIndexes & INDEX_BUILD_SPENT)
+        vNames.push_back("spent");
+    if (nIndexes & INDEX_BUILD_TIMESTAMP)
+        vNames.push_back("timestamp");
+    std::string strNames;
+    for (size_t i = 0; i < vNames.size(); i++)
+        strNames += (i == 0 ? "" : i + 1 == vNames.size() ? " and " : ", ") + vNames[i];
+    return strNames + (vNames.size() > 1 ? " indexes" : " index");
+}
+
+bool InitIndexBuild(std::string& strError)
+{
+    const bool fWantAddressIndex = gArgs.GetBoolArg("-addressindex", DEFAULT_ADDRESSINDEX);
+    const bool fWantSpentIndex = gArgs.GetBoolArg("-spentindex", DEFAULT_SPENTINDEX);
+    const bool fWantTimestampIndex = gArgs.GetBoolArg("-timestampindex", DEFAULT_TIMESTAMPINDEX);
+    if (fAddressIndex && !fWantAddressIndex) {
+        strError = _("You need to rebuild the database using -reindex-chainstate to change -addressindex");
+        return false;
+    }
+    if (fSpentIndex && !fWantSpentIndex) {
+        strError = _("You need to rebuild the database using -reindex-chainstate to change -spentindex");
+        return false;
+    }
+    if (fTimestampIndex && !fWantTimestampIndex) {
+        strError = _("You need to rebuild the database using -reindex-chainstate to change -timestampindex");
+        return false;
+    }
+
+    uint32_t nMissing = 0;
+    if (fWantAddressIndex && !fAddressIndex)
+        nMissing |= INDEX_BUILD_ADDRESS;
+    if (fWantSpentIndex && !fSpentIndex)
+        nMissing |= INDEX_BUILD_SPENT;
+    if (fWantTimestampIndex && !fTimestampIndex)
+        nMissing |= INDEX_BUILD_TIMESTAMP;
+
+    CIndexBuildState state;
+    if (pblocktree->ReadIndexBuild(state)) {
+        if (state.nIndexes != nMissing) {
+            strError = strprintf(_("The background build of the %s has not finished. Restart with the same index options, or rebuild the database using -reindex."), IndexBuildNames(state.nIndexes));
+            return false;
+        }
+        return true;
+    }
+    if (!nMissing)
+        return true;
+    if (fPruneMode) {
+        strError = _("Adding an index to a pruned node needs the blocks it pruned. You need to rebuild the database using -reindex.");
+        return false;
+    }
+    state.nIndexes = nMissing;
+    if (!pblocktree->WriteIndexBuild(state)) {
+        strError = _("Error writing to block database");
+        return false;
+    }
+    LogPrintf("%s: the %s will be built in the background\n", __func__, IndexBuildNames(nMissing));
+    return true;
+}
+
+/** A block to index, copied out of mapBlockIndex under cs_main */
+struct CIndexBuildBlock
+{
+    uint256 hash;
+    uint256 hashPrev;
+    int nHeight;
+    unsigned int nTime;
+    CDiskBlockPos pos;
+    CDiskBlockPos posUndo;
+    bool fAssets;
+};
+
+/** Read a block and its undo data, and add the entries of the indexes being built */
+static bool IndexBlock(const CIndexBuildBlock& entry, CIndexBuildState& state, CIndexBuildBatch& batch, const Consensus::Params& consensusParams)
+{
+    CBlock block;
+    if (!ReadBlockFromDisk(block, entry.pos, consensusParams))
+        return error("%s: failed to read block %s", __func__, entry.hash.ToString());
+    CBlockUndo blockundo;
+    if (block.vtx.size() > 1 && !UndoReadFromDisk(blockundo, entry.posUndo, entry.hashPrev))
+        return error("%s: failed to read undo data of block %s", __func__, entry.hash.ToString());
+
+    AppendBlockIndexEntries(block, blockundo, entry.nHeight, entry.fAssets,
+                            state.nIndexes & INDEX_BUILD_ADDRESS, state.nIndexes & INDEX_BUILD_SPENT, batch);
+    if (state.nIndexes & INDEX_BUILD_TIMESTAMP) {
+        // the same logical timestamps ConnectBlock gives: strictly increasing along the chain
+        state.nLogicalTS = entry.nTime > state.nLogicalTS ? entry.nTime : state.nLogicalTS + 1;
+        batch.vTimestamps.emplace_back(entry.hash, state.nLogicalTS);
+    }
+    state.hashBlock = entry.hash;
+    return true;
+}
+
+/**
+ * Height of the last block the build has indexed, 0 before the first, or -1
+ * if that block is not in the active chain.
+ */
+static int GetIndexBuildHeight(const CIndexBuildState& state)
+{
+    AssertLockHeld(cs_main);
+    if (state.hashBlock.IsNull())
+        return 0;
+    BlockMap::const_iterator it = mapBlockIndex.find(state.hashBlock);
+    if (it == mapBlockIndex.end() || !chainActive.Contains(it->second))
+        return -1;
+    return it->second->nHeight;
+}
+
+/** Copy out the active chain's blocks from nFromHeight to nToHeight */
+static void GetBlocksToIndex(int nFromHeight, int nToHeight, std::vector<CIndexBuildBlock>& vBlocks)
+{
+    AssertLockHeld(cs_main);
+    const Consensus::Params& consensusParams = GetParams().GetConsensus();
+    vBlocks.clear();
+    for (int nHeight = nFromHeight; nHeight <= nToHeight; nHeight++) {
+        const CBlockIndex* pindex = chainActive[nHeight];
+        CIndexBuildBlock entry;
+        entry.hash = pindex->GetBlockHash();
+        entry.hashPrev = pindex->pprev->GetBlockHash();
+        entry.nHeight = nHeight;
+        entry.nTime = pindex->nTime;
+        entry.pos = pindex->GetBlockPos();
+        entry.posUndo = pindex->GetUndoPos();
+        entry.fAssets = VersionBitsState(pindex->pprev, consensusParams, Consensus::DEPLOYMENT_ASSETS, versionbitscache) == THRESHOLD_ACTIVE;
+        vBlocks.push_back(entry);
+    }
+}
+
+static void ThreadIndexBuild()
+{
+    RenameThread("mynta-idxbuild");
+    const Consensus::Params& consensusParams = GetParams().GetConsensus();
+
+    CIndexBuildState state;
+    if (!pblocktree->ReadIndexBuild(state))
+        return;
+    LogPrintf("Building the %s in the background\n", IndexBuildNames(state.nIndexes));
+
+    CIndexBuildBatch batch;
+    std::vector<CIndexBuildBlock> vBlocks;
+    while (true) {
+        boost::this_thread::interruption_point();
+        if (fImporting || fReindex) {
+            MilliSleep(1000);
+            continue;
+        }
+
+        {
+            LOCK(cs_main);
+            const int nTipHeight = chainActive.Height();
+            const int nHeight = GetIndexBuildHeight(state);
+            if (nHeight < 0) {
+                BlockMap::const_iterator it = mapBlockIndex.find(state.hashBlock);
+                if (it != mapBlockIndex.end() && it->second->GetAncestor(nTipHeight) == chainActive.Tip()) {
+                    // Indexed before a restart, and not connected again yet
+                    vBlocks.clear();
+                } else {
+                    LogPrintf("%s: block %s, which the index build had reached, is no longer in the active chain. Rebuild the database using -reindex to add the %s.\n",
+                              __func__, state.hashBlock.ToString(), IndexBuildNames(state.nIndexes));
+                    return;
+                }
+            } else if (nHeight >= nTipHeight - INDEX_BUILD_TIP_DISTANCE) {
+                // Close to the tip, index the last blocks while holding cs_main so
+                // that ConnectBlock takes over from exactly where the build ends
+                GetBlocksToIndex(nHeight + 1, nTipHeight, vBlocks);
+                for (const CIndexBuildBlock& entry : vBlocks) {
+                    if (!IndexBlock(entry, state, batch, consensusParams))
+                        return;
+                }
+                if (!pblocktree->WriteIndexBuildBatch(batch, state, true)) {
+                    LogPrintf("%s: failed to write the %s\n", __func__, IndexBuildNames(state.nIndexes));
+                    return;
+                }
+                fAddressIndex |= (state.nIndexes & INDEX_BUILD_ADDRESS) != 0;
+                fSpentIndex |= (state.nIndexes & INDEX_BUILD_SPENT) != 0;
+                fTimestampIndex |= (state.nIndexes & INDEX_BUILD_TIMESTAMP) != 0;
+                LogPrintf("Finished building the %s at height %d\n", IndexBuildNames(state.nIndexes), nTipHeight);
+                return;
+            } else {
+                // The genesis block is never connected, so it has no entries
+                GetBlocksToIndex(std::max(nHeight + 1, 1), std::min(nHeight + 1000, nTipHeight - INDEX_BUILD_TIP_DISTANCE), vBlocks);
+            }
+        }
+
+        if (vBlocks.empty()) {
+            MilliSleep(1000);
+            continue;
+        }
+        for (const CIndexBuildBlock& entry : vBlocks) {
+            boost::this_thread::interruption_point();
+            if (!IndexBlock(entry, state, batch, consensusParams))
+                return;
+        }
+        // Entries average well under 128 bytes once written
+        if (batch.Count() * 128 >= INDEX_BUILD_BATCH_SIZE) {
+            if (!pblocktree->WriteIndexBuildBatch(batch, state, false)) {
+                LogPrintf("%s: failed to write the %s\n", __func__, IndexBuildNames(state.nIndexes));
+                return;
+            }
+            batch.Clear();
+            LogPrintf("Built the %s up to height %d\n", IndexBuildNames(state.nIndexes), vBlocks.back().nHeight);
+        }
+    }
+}
+
+void StartIndexBuild(boost::thread_group& threadGroup)
+{
+    CIndexBuildState state;
+    if (pblocktree->ReadIndexBuild(state))
+        threadGroup.create_thread(&ThreadIndexBuild);
+}
@@ -0,0 +1,101 @@
+// Copyright (c) 2026 The Mynta Core Developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#ifndef MYNTA_INDEXBUILDER_H
+#define MYNTA_INDEXBUILDER_H
+
+#include "addressindex.h"
+#include "amount.h"
+#include "serialize.h"
+#include "spentindex.h"
+#include "uint256.h"
+
+#include <stdint.h>
+#include <string>
+#include <utility>
+#include <vector>
+
+class CBlock;
+class CBlockUndo;
+class CScript;
+
+namespace boost {
+class thread_group;
+} // namespace boost
+
+/** Indexes that a background build can add to an existing block tree */
+enum IndexBuildFlags : uint32_t {
+    INDEX_BUILD_ADDRESS = (1U << 0),
+    INDEX_BUILD_SPENT = (1U << 1),
+    INDEX_BUILD_TIMESTAMP = (1U << 2),
+};
+
+/** Blocks the background build stays below the tip, so that reorgs never undo what it wrote */
+static const int INDEX_BUILD_TIP_DISTANCE = 100;
+/** Bytes of index entries collected before they are written */
+static const size_t INDEX_BUILD_BATCH_SIZE = 32 << 20;
+
+/** How far a background index build has got, kept in the block tree database */
+struct CIndexBuildState
+{
+    //! IndexBuildFlags being built
+    uint32_t nIndexes{0};
+    //! last block indexed, null before the first
+    uint256 hashBlock;
+    //! logical timestamp given to hashBlock by the timestamp index
+    unsigned int nLogicalTS{0};
+
+    ADD_SERIALIZE_METHODS;
+
+    template <typename Stream, typename Operation>
+    inline void SerializationOp(Stream& s, Operation ser_action) {
+        READWRITE(nIndexes);
+        READWRITE(hashBlock);
+        READWRITE(nLogicalTS);
+    }
+};
+
+/** Index entries of one or more connected blocks */
+struct CIndexBuildBatch
+{
+    std::vector<std::pair<CAddressIndexKey, CAmount> > vAddressIndex;
+    //! in block order: an output created and spent within the batch is written, then erased
+    std::vector<std::pair<CAddressUnspentKey, CAddressUnspentValue> > vAddressUnspent;
+    std::vector<std::pair<CSpentIndexKey, CSpentIndexValue> > vSpentIndex;
+    //! hash and logical timestamp of each block, for the timestamp index
+    std::vector<std::pair<uint256, unsigned int> > vTimestamps;
+
+    size_t Count() const { return vAddressIndex.size() + vAddressUnspent.size() + vSpentIndex.size() + vTimestamps.size(); }
+    void Clear();
+};
+
+/**
+ * The address an output script pays, as the address and spent indexes record
+ * it: type 1 for public keys and key hashes, 2 for script hashes and 0 for
+ * anything else. Once assets are active (fAssets), asset transfers count for
+ * their key hash and set strAsset and nAssetAmount.
+ */
+int GetIndexedAddress(const CScript& script, bool fAssets, uint160& hashBytes, std::string& strAsset, CAmount& nAssetAmount);
+
+/**
+ * Add the address and spent index entries of a connected block, in the order
+ * ConnectBlock writes them. blockundo holds the outputs its inputs spent.
+ */
+void AppendBlockIndexEntries(const CBlock& block, const CBlockUndo& blockundo, int nHeight, bool fAssets,
+                             bool fAddressIndex, bool fSpentIndex, CIndexBuildBatch& batch);
+
+/**
+ * Compare the index options with the indexes the block tree has. An index
+ * that is asked for but missing is built in the background from the blocks
+ * connected so far, instead of needing a reindex; turning one off still does.
+ */
+bool InitIndexBuild(std::string& strError);
+
+/**
+ * Build the missing indexes on their own thread, a batch of blocks at a time,
+ * until they catch up with the tip. ConnectBlock maintains them from then on.
+ */
+void StartIndexBuild(boost::thread_group& threadGroup);
+
+#endif // MYNTA_INDEXBUILDER_H
@@ -12,15 +12,24 @@
 
 #include "addrman.h"
 #include "amount.h"
+#include "blockcompression.h"
+#include "blockfilemap.h"
+#include "blockindexcold.h"
+#include "blockprefetch.h"
+#include "blockfilterindex.h"
+#include "dextradeindex.h"
 #include "chain.h"
 #include "chainparams.h"
 #include "checkpoints.h"
 #include "compat/sanity.h"
 #include "consensus/validation.h"
 #include "fs.h"
+#include "hash.h"
 #include "httpserver.h"
 #include "httprpc.h"
+#include "indexbuilder.h"
 #include "key.h"
+#include "memorybudget.h"
 #include "validation.h"
 #include "miner.h"
 #include "netbase.h"
@@ -37,6 +46,7 @@
 #include "script/standard.h"
 #include "script/sigcache.h"
 #include "scheduler.h"
+#include "stratum.h"
 #include "timedata.h"
 #include "txdb.h"
 #include "txmempool.h"
@@ -48,6 +58,10 @@
 #include "assets/assets.h"
 #include "assets/assetdb.h"
 #include "assets/snapshotrequestdb.h"
+#include "bls/bls_worker.h"
+#include "evo/deterministicmns.h"
+#include "evo/providertx.h"
+#include "llmq/quorums.h"
 #ifdef ENABLE_WALLET
 #include "wallet/init.h"
 #include <wallet/wallet.h>
@@ -74,6 +88,8 @@ using namespace boost::placeholders;
 
 #if ENABLE_ZMQ
 #include "zmq/zmqnotificationinterface.h"
+#include "zmq/zmqpublishnotifier.h"
+#include "zmq/zmqrpc.h"
 #endif
 
 bool fFeeEstimatesInitialized = false;
@@ -81,13 +97,12 @@ static const bool DEFAULT_PROXYRANDOMIZE = true;
 static const bool DEFAULT_REST_ENABLE = false;
 static const bool DEFAULT_STOPAFTERBLOCKIMPORT = false;
 
+//! Filters -blockfilterindex asks for, INVALID when the index is off
+static BlockFilterType blockFilterIndexType = BlockFilterType::INVALID;
+
 std::unique_ptr<CConnman> g_connman;
 std::unique_ptr<PeerLogicValidation> peerLogic;
 
-#if ENABLE_ZMQ
-static CZMQNotificationInterface* pzmqNotificationInterface = nullptr;
-#endif
-
 #ifdef WIN32
 // Win32 LevelDB doesn't use filedescriptors, and the ones used for
 // accessing block files don't count towards the fd_set size limit
@@ -98,6 +113,86 @@ static CZMQNotificationInterface* pzmqNotificationInterface = nullptr;
 #endif
 
 static const char* FEE_ESTIMATES_FILENAME="fee_estimates.dat";
+/** Blocks processed by the fee estimator between saves of its file */
+static const unsigned int FEE_ESTIMATES_WRITE_BLOCKS = 6;
+
+/** Save the fee estimates through a temporary file, so the old file stays whole until the new one is */
+static void WriteFeeEstimates()
+{
+    fs::path est_path = GetDataDir() / FEE_ESTIMATES_FILENAME;
+    fs::path est_path_tmp = GetDataDir() / (std::string(FEE_ESTIMATES_FILENAME) + ".new");
+    CAutoFile est_fileout(fsbridge::fopen(est_path_tmp, "wb"), SER_DISK, CLIENT_VERSION);
+    if (est_fileout.IsNull()) {
+        LogPrintf("%s: Failed to write fee estimates to %s\n", __func__, est_path_tmp.string());
+        return;
+    }
+    if (!::feeEstimator.Write(est_fileout))
+        return;
+    FileCommit(est_fileout.Get());
+    est_fileout.fclose();
+    if (!RenameOver(est_path_tmp, est_path))
+        LogPrintf("%s: Failed to rename %s to %s\n", __func__, est_path_tmp.string(), est_path.string());
+}
+
+/** Scheduler task keeping the fee estimates file close to the estimator, so an unclean exit loses little */
+static void PeriodicWriteFeeEstimates()
+{
+    static unsigned int nLastWriteHeight = 0;
+    unsigned int nHeight = ::feeEstimator.GetBestSeenHeight();
+    if (nLastWriteHeight == 0) {
+        nLastWriteHeight = nHeight;
+        return;
+    }
+    if (nHeight < nLastWriteHeight + FEE_ESTIMATES_WRITE_BLOCKS)
+        return;
+    WriteFeeEstimates();
+    nLastWriteHeight = nHeight;
+}
+
+/** Scheduler task working out the fee estimates estimatesmartfee serves, once the stats move */
+static void RefreshFeeEstimates()
+{
+    if (!IsInitialBlockDownload())
+        ::feeEstimator.RefreshEstimates();
+}
+
+/** Count a sharded LRU cache against the memory budget, whichever cache the pointer holds at the time */
+template <typename Cache>
+static void RegisterLRUCache(const std::string& strName, Cache* const& pcache)
+{
+    g_memoryBudget.Register(strName,
+        [&pcache]() { return pcache ? pcache->DynamicMemoryUsage() : 0; },
+        [&pcache](size_t nBytes) { return pcache ? pcache->Shrink(nBytes) : 0; });
+}
+
+/** Register the node's caches with the memory budget; the ones with their own flushing only count against it */
+static void RegisterMemoryConsumers()
+{
+    g_memoryBudget.Register("coins_tip", []() {
+        LOCK(cs_main);
+        return pcoinsTip ? pcoinsTip->DynamicMemoryUsage() : 0;
+    });
+    g_memoryBudget.Register("mempool", []() { return mempool.DynamicMemoryUsage(); });
+    g_memoryBudget.Register("db_block_cache", []() { return GetSharedDBBlockCacheUsage(); });
+    g_memoryBudget.Register("block_prefetch", []() { return g_blockPrefetcher.DynamicMemoryUsage(); });
+    g_memoryBudget.Register("assets_tip", []() {
+        LOCK(cs_main);
+        return passets ? passets->DynamicMemoryUsage() : 0;
+    });
+    RegisterLRUCache("asset_metadata", passetsCache);
+    RegisterLRUCache("asset_verifiers", passetsVerifierCache);
+    RegisterLRUCache("asset_qualifiers", passetsQualifierCache);
+    RegisterLRUCache("asset_restrictions", passetsRestrictionCache);
+    RegisterLRUCache("asset_global_restrictions", passetsGlobalRestrictionCache);
+    RegisterLRUCache("messages", pMessagesCache);
+    RegisterLRUCache("messages_seen_addresses", pMessagesSeenAddressCache);
+    g_memoryBudget.Register("mnlists",
+        []() { return deterministicMNManager ? deterministicMNManager->GetCacheStats().nUsage : 0; },
+        [](size_t nBytes) { return deterministicMNManager ? deterministicMNManager->EvictCache(nBytes) : 0; });
+    g_memoryBudget.Register("quorums",
+        []() { return llmq::quorumManager ? llmq::quorumManager->GetCacheUsage() : 0; },
+        [](size_t nBytes) { return llmq::quorumManager ? llmq::quorumManager->EvictCache(nBytes) : 0; });
+}
 
 //////////////////////////////////////////////////////////////////////////////
 //
@@ -148,19 +243,31 @@ bool ShutdownRequested()
 */
 class CCoinsViewErrorCatcher final : public CCoinsViewBacked
 {
+private:
+    [[noreturn]] static void ReadFailed(const std::runtime_error& e) {
+        uiInterface.ThreadSafeMessageBox(_("Error reading from database, shutting down."), "", CClientUIInterface::MSG_ERROR);
+        LogPrintf("Error reading from database: %s\n", e.what());
+        // Starting the shutdown sequence and returning false to the caller would be
+        // interpreted as 'entry not found' (as opposed to unable to read data), and
+        // could lead to invalid interpretation. Just exit immediately, as we can't
+        // continue anyway, and all writes should be atomic.
+        abort();
+    }
+
 public:
     explicit CCoinsViewErrorCatcher(CCoinsView* view) : CCoinsViewBacked(view) {}
     bool GetCoin(const COutPoint &outpoint, Coin &coin) const override {
         try {
             return CCoinsViewBacked::GetCoin(outpoint, coin);
         } catch(const std::runtime_error& e) {
-            uiInterface.ThreadSafeMessageBox(_("Error reading from database, shutting down."), "", CClientUIInterface::MSG_ERROR);
-            LogPrintf("Error reading from database: %s\n", e.what());
-            // Starting the shutdown sequence and returning false to the caller would be
-            // interpreted as 'entry not found' (as opposed to unable to read data), and
-            // could lead to invalid interpretation. Just exit immediately, as we can't
-            // continue anyway, and all writes should be atomic.
-            abort();
+            ReadFailed(e);
+        }
+    }
+    void GetCoins(const std::vector<COutPoint> &vOutpoints, std::vector<std::pair<COutPoint, Coin>> &vCoins) const override {
+        try {
+            base->GetCoins(vOutpoints, vCoins);
+        } catch(const std::runtime_error& e) {
+            ReadFailed(e);
         }
     }
     // Writes do not need similar protection, as failure to write is handled by the caller.
@@ -176,6 +283,7 @@ void Interrupt(boost::thread_group& threadGroup)
     InterruptRPC();
     InterruptREST();
     InterruptTorControl();
+    InterruptStratumServer();
     if (g_connman)
         g_connman->Interrupt();
     threadGroup.interrupt_all();
@@ -201,6 +309,7 @@ void PrepareShutdown()
     StopREST();
     StopRPC();
     StopHTTPServer();
+    StopStratumServer();
 #ifdef ENABLE_WALLET
     FlushWallets();
 #endif
@@ -222,12 +331,7 @@ void PrepareShutdown()
     if (fFeeEstimatesInitialized)
     {
         ::feeEstimator.FlushUnconfirmed(::mempool);
-        fs::path est_path = GetDataDir() / FEE_ESTIMATES_FILENAME;
-        CAutoFile est_fileout(fsbridge::fopen(est_path, "wb"), SER_DISK, CLIENT_VERSION);
-        if (!est_fileout.IsNull())
-            ::feeEstimator.Write(est_fileout);
-        else
-            LogPrintf("%s: Failed to write fee estimates to %s\n", __func__, est_path.string());
+        WriteFeeEstimates();
         fFeeEstimatesInitialized = false;
     }
 
@@ -240,20 +344,36 @@ void PrepareShutdown()
     // CValidationInterface callbacks, flush them...
     GetMainSignals().FlushBackgroundCallbacks();
 
+    if (pblockfilterindex) {
+        UnregisterValidationInterface(pblockfilterindex);
+        delete pblockfilterindex;
+        pblockfilterindex = nullptr;
+    }
+    if (pdextradeindex) {
+        UnregisterValidationInterface(pdextradeindex);
+        delete pdextradeindex;
+        pdextradeindex = nullptr;
+    }
+
     // Any future callbacks will be dropped. This should absolutely be safe - if
     // missing a callback results in an unrecoverable situation, unclean shutdown
     // would too. The only reason to do the above flushes is to let the wallet catch
     // up with our current chain to avoid any strange pruning edge cases and make
     // next startup faster by avoiding rescan.
 
+    g_memoryBudget.UnregisterAll();
     {
         LOCK(cs_main);
+        g_blockPrefetcher.Stop();
         if (pcoinsTip != nullptr) {
             FlushStateToDisk();
         }
         delete pcoinsTip;
         pcoinsTip = nullptr;
 
+        delete pcoinsbuffer;
+        pcoinsbuffer = nullptr;
+
         delete pcoinscatcher;
         pcoinscatcher = nullptr;
 
@@ -264,6 +384,10 @@ void PrepareShutdown()
         pblocktree = nullptr;
 
         /** MYNTA START */
+        // Remember which assets were in use, to read them back in at the next start
+        if (passetsdb && passetsCache)
+            passetsdb->WriteHotAssets(passetsCache->GetRecentNames(MAX_HOT_ASSETS));
+
         delete passets;
         passets = nullptr;
 
@@ -341,6 +465,7 @@ void PrepareShutdown()
 #endif
     UnregisterAllValidationInterfaces();
     GetMainSignals().UnregisterBackgroundSignalScheduler();
+    g_scheduler = nullptr;
 }
 
 /**
@@ -446,7 +571,14 @@ std::string HelpMessage(HelpMessageMode mode)
     if (showDebug) {
         strUsage += HelpMessageOpt("-dbbatchsize", strprintf("Maximum database write batch size in bytes (default: %u)", nDefaultDbBatchSize));
     }
+    strUsage += HelpMessageOpt("-blockcompression", strprintf(_("Compress the blocks and undo data written to block and undo files from then on, each record on its own (needs a build with Snappy; files written this way can't be read by older versions) (default: %u)"), DEFAULT_BLOCK_COMPRESSION));
+    strUsage += HelpMessageOpt("-blockfilemmap", strprintf(_("Read block and undo files through memory mappings with readahead (default: %u)"), DEFAULT_BLOCKFILE_MMAP));
+    strUsage += HelpMessageOpt("-backgroundflush", strprintf(_("Write the coins database on a background thread while validation continues (default: %u)"), DEFAULT_BACKGROUND_FLUSH));
     strUsage += HelpMessageOpt("-dbcache=<n>", strprintf(_("Set database cache size in megabytes (%d to %d, default: %d)"), nMinDbCache, nMaxDbCache, nDefaultDbCache));
+    if (showDebug) {
+        strUsage += HelpMessageOpt("-dbsharedcache", strprintf("Have the databases share one cache of the table blocks they read instead of keeping one each (default: %u)", DEFAULT_DB_SHARED_CACHE));
+    }
+    strUsage += HelpMessageOpt("-dbprofile=<db>:<setting>=<n>,...", _("Change the table settings of the database in directory <db> (chainstate, index, assets, ...): compress (0 or 1, needs LevelDB built with Snappy), blocksize (bytes) or bloombits (0 for no bloom filter). Settings apply to tables written from then on. Can be specified multiple times"));
     strUsage += HelpMessageOpt("-disablemessaging", strprintf(_("Turn off the databasing the messages sent with assets (default: %u)"), false));
     if (showDebug)
         strUsage += HelpMessageOpt("-feefilter", strprintf("Tell other nodes to filter invs to us by our mempool min fee (default: %u)", DEFAULT_FEEFILTER));
@@ -455,7 +587,10 @@ std::string HelpMessage(HelpMessageMode mode)
     strUsage += HelpMessageOpt("-minreorgpeers=<n>", strprintf(_("Set the Minimum amount of peers required to disallow reorg of chains of depth >= maxreorg. Peers must be greater than. (default: %u)"), defaultChainParams->MinReorganizationPeers()));
     strUsage += HelpMessageOpt("-minreorgage=<n>", strprintf(_("Set the Minimum tip age (in seconds) required to allow reorg of a chain of depth >= maxreorg on a node with more than minreorgpeers peers. (default: %u)"), defaultChainParams->MinReorganizationAge()));
     strUsage += HelpMessageOpt("-maxorphantx=<n>", strprintf(_("Keep at most <n> unconnectable transactions in memory (default: %u)"), DEFAULT_MAX_ORPHAN_TRANSACTIONS));
+    strUsage += HelpMessageOpt("-maxorphanmemory=<n>", strprintf(_("Keep the unconnectable transactions in memory below <n> megabytes, evicting from the peer that sent the most first (default: %u)"), DEFAULT_MAX_ORPHAN_MEMORY));
+    strUsage += HelpMessageOpt("-maxrelaymemory=<n>", strprintf(_("Keep the transactions announced to peers in the last 15 minutes in memory below <n> megabytes, dropping the oldest first (default: %u)"), DEFAULT_MAX_RELAY_MEMORY));
     strUsage += HelpMessageOpt("-maxmempool=<n>", strprintf(_("Keep the transaction memory pool below <n> megabytes (default: %u)"), DEFAULT_MAX_MEMPOOL_SIZE));
+    strUsage += HelpMessageOpt("-memorybudget=<n>", strprintf(_("Keep the node's caches below <n> megabytes together, evicting from the largest that can drop entries first; the UTXO set and mempool only count against it (0 = no limit, default: %d)"), DEFAULT_MEMORY_BUDGET));
     strUsage += HelpMessageOpt("-mempoolexpiry=<n>", strprintf(_("Do not keep transactions in the mempool longer than <n> hours (default: %u)"), DEFAULT_MEMPOOL_EXPIRY));
     if (showDebug) {
         strUsage += HelpMessageOpt("-minimumchainwork=<hex>", strprintf("Minimum work assumed to exist on a valid chain in hex (default: %s, testnet: %s)", defaultChainParams->GetConsensus().nMinimumChainWork.GetHex(), testnetChainParams->GetConsensus().nMinimumChainWork.GetHex()));
@@ -464,6 +599,13 @@ std::string HelpMessage(HelpMessageMode mode)
     strUsage += HelpMessageOpt("-blockreconstructionextratxn=<n>", strprintf(_("Extra transactions to keep in memory for compact block reconstructions (default: %u)"), DEFAULT_BLOCK_RECONSTRUCTION_EXTRA_TXN));
     strUsage += HelpMessageOpt("-par=<n>", strprintf(_("Set the number of script verification threads (%u to %d, 0 = auto, <0 = leave that many cores free, default: %d)"),
         -GetNumCores(), MAX_SCRIPTCHECK_THREADS, DEFAULT_SCRIPTCHECK_THREADS));
+    strUsage += HelpMessageOpt("-parpin", strprintf(_("Pin script verification threads to CPUs, filling one shared cache domain before the next (Linux only, default: %u)"), DEFAULT_SCRIPTCHECK_PIN));
+    strUsage += HelpMessageOpt("-prefetchthreads=<n>", strprintf(_("Set the number of threads reading the inputs of incoming blocks before they are connected (0 to %d, 0 = off, default: %d)"), MAX_PREFETCH_THREADS, DEFAULT_PREFETCH_THREADS));
+    if (showDebug)
+        strUsage += HelpMessageOpt("-schedulerthreads=<n>", strprintf("Set the number of threads running scheduled background tasks (1 to %d, default: %d)", MAX_SCHEDULER_THREADS, DEFAULT_SCHEDULER_THREADS));
+    if (showDebug)
+        strUsage += HelpMessageOpt("-blsverifythreads=<n>", strprintf("Set the number of BLS signature verification threads used by LLMQ, InstantSend and ChainLocks (0 to %d, 0 = verify on the calling thread, default: %d)", MAX_BLS_VERIFY_THREADS, DEFAULT_BLS_VERIFY_THREADS));
+    strUsage += HelpMessageOpt("-mnlistcachemb=<n>", strprintf(_("Memory budget for cached deterministic masternode lists in megabytes (default: %u)"), DEFAULT_MNLIST_CACHE_MB));
     strUsage += HelpMessageOpt("-autofixmempool", strprintf(_("When set, if the CreateNewBlock fails because of a transaction. The mempool will be cleared. (default: %d)"), false));
     strUsage += HelpMessageOpt("-bypassdownload", strprintf(_("When set, if the chain is in initialblockdownload the getblocktemplate rpc call will still return block data (default: %d)"), false));
 #ifndef WIN32
@@ -478,11 +620,14 @@ std::string HelpMessage(HelpMessageMode mode)
     strUsage += HelpMessageOpt("-sysperms", _("Create new files with system default permissions, instead of umask 077 (only effective with disabled wallet functionality)"));
 #endif
     strUsage += HelpMessageOpt("-txindex", strprintf(_("Maintain a full transaction index, used by the getrawtransaction rpc call (default: %u)"), DEFAULT_TXINDEX));
+    strUsage += HelpMessageOpt("-blockfilterindex=<type>", strprintf(_("Maintain an index of compact filters by block (default: %s, values: %s). "
+            "If <type> is not supplied or if <type> = 1, basic filters are indexed."), DEFAULT_BLOCKFILTERINDEX, BlockFilterTypeName(BlockFilterType::BASIC)));
+    strUsage += HelpMessageOpt("-dexindex", strprintf(_("Maintain an index of DEX trades and their OHLCV candles, used by the dex listtrades and dex ohlcv rpc calls (default: %u)"), DEFAULT_DEXINDEX));
     strUsage += HelpMessageOpt("-assetindex", _("Keep an index of assets, used by the requestsnapshot rpc call. Requires a -reindex."));
 
-    strUsage += HelpMessageOpt("-addressindex", strprintf(_("Maintain a full address index, used to query for the balance, txids and unspent outputs for addresses (default: %u)"), DEFAULT_ADDRESSINDEX));
-    strUsage += HelpMessageOpt("-timestampindex", strprintf(_("Maintain a timestamp index for block hashes, used to query blocks hashes by a range of timestamps (default: %u)"), DEFAULT_TIMESTAMPINDEX));
-    strUsage += HelpMessageOpt("-spentindex", strprintf(_("Maintain a full spent index, used to query the spending txid and input index for an outpoint (default: %u)"), DEFAULT_SPENTINDEX));
+    strUsage += HelpMessageOpt("-addressindex", strprintf(_("Maintain a full address index, used to query for the balance, txids and unspent outputs for addresses (built in the background if turned on later; default: %u)"), DEFAULT_ADDRESSINDEX));
+    strUsage += HelpMessageOpt("-timestampindex", strprintf(_("Maintain a timestamp index for block hashes, used to query blocks hashes by a range of timestamps (built in the background if turned on later; default: %u)"), DEFAULT_TIMESTAMPINDEX));
+    strUsage += HelpMessageOpt("-spentindex", strprintf(_("Maintain a full spent index, used to query the spending txid and input index for an outpoint (built in the background if turned on later; default: %u)"), DEFAULT_SPENTINDEX));
 
     strUsage += HelpMessageGroup(_("Connection options:"));
     strUsage += HelpMessageOpt("-addnode=<ip>", _("Add a node to connect to and attempt to keep the connection open (see the `addnode` RPC command help for more info)"));
@@ -501,14 +646,17 @@ std::string HelpMessage(HelpMessageMode mode)
     strUsage += HelpMessageOpt("-maxreceivebuffer=<n>", strprintf(_("Maximum per-connection receive buffer, <n>*1000 bytes (default: %u)"), DEFAULT_MAXRECEIVEBUFFER));
     strUsage += HelpMessageOpt("-maxsendbuffer=<n>", strprintf(_("Maximum per-connection send buffer, <n>*1000 bytes (default: %u)"), DEFAULT_MAXSENDBUFFER));
     strUsage += HelpMessageOpt("-maxtimeadjustment", strprintf(_("Maximum allowed median peer time offset adjustment. Local perspective of time may be influenced by peers forward or backward by this amount. (default: %u seconds)"), DEFAULT_MAX_TIME_ADJUSTMENT));
+    strUsage += HelpMessageOpt("-msghandlerthreads=<n>", strprintf(_("Number of threads processing peer messages, each peer's in order (1 to %d, default: %d)"), MAX_MESSAGE_HANDLER_THREADS, DEFAULT_MESSAGE_HANDLER_THREADS));
     strUsage += HelpMessageOpt("-onion=<ip:port>", strprintf(_("Use separate SOCKS5 proxy to reach peers via Tor hidden services (default: %s)"), "-proxy"));
     strUsage += HelpMessageOpt("-onlynet=<net>", _("Only connect to nodes in network <net> (ipv4, ipv6 or onion)"));
     strUsage += HelpMessageOpt("-permitbaremultisig", strprintf(_("Relay non-P2SH multisig (default: %u)"), DEFAULT_PERMIT_BAREMULTISIG));
+    strUsage += HelpMessageOpt("-peerblockfilters", strprintf(_("Serve compact block filters to peers per BIP 157 (default: %u)"), DEFAULT_PEERBLOCKFILTERS));
     strUsage += HelpMessageOpt("-peerbloomfilters", strprintf(_("Support filtering of blocks and transaction with bloom filters (default: %u)"), DEFAULT_PEERBLOOMFILTERS));
     strUsage += HelpMessageOpt("-port=<port>", strprintf(_("Listen for connections on <port> (default: %u or testnet: %u)"), defaultChainParams->GetDefaultPort(), testnetChainParams->GetDefaultPort()));
     strUsage += HelpMessageOpt("-proxy=<ip:port>", _("Connect through SOCKS5 proxy"));
     strUsage += HelpMessageOpt("-proxyrandomize", strprintf(_("Randomize credentials for every proxy connection. This enables Tor stream isolation (default: %u)"), DEFAULT_PROXYRANDOMIZE));
     strUsage += HelpMessageOpt("-seednode=<ip>", _("Connect to a node to retrieve peer addresses, and disconnect"));
+    strUsage += HelpMessageOpt("-socketevents=<mode>", strprintf(_("How the network thread waits for socket readiness: %s (default: %s)"), GetSocketEventsBackends(), DEFAULT_SOCKETEVENTS));
     strUsage += HelpMessageOpt("-timeout=<n>", strprintf(_("Specify connection timeout in milliseconds (minimum: 1, default: %d)"), DEFAULT_CONNECT_TIMEOUT));
     strUsage += HelpMessageOpt("-torcontrol=<ip>:<port>", strprintf(_("Tor control port to use if onion listening enabled (default: %s)"), DEFAULT_TOR_CONTROL));
     strUsage += HelpMessageOpt("-torpassword=<pass>", _("Tor control port password (default: empty)"));
@@ -535,6 +683,13 @@ std::string HelpMessage(HelpMessageMode mode)
     strUsage += HelpMessageOpt("-zmqpubrawblock=<address>", _("Enable publish raw block in <address>"));
     strUsage += HelpMessageOpt("-zmqpubrawtx=<address>", _("Enable publish raw transaction in <address>"));
     strUsage += HelpMessageOpt("-zmqpubrawmessage=<address>", _("Enable publish raw asset messages in <address>"));
+    strUsage += HelpMessageOpt("-zmqpubdexoffer=<address>", _("Enable publish order book offer updates in <address>"));
+    strUsage += HelpMessageOpt("-zmqpubdexfill=<address>", _("Enable publish order book fills in <address>"));
+    strUsage += HelpMessageOpt("-zmqpubassettransfer=<address>", _("Enable publish asset transfers in <address>"));
+    strUsage += HelpMessageOpt("-zmqpubassetissue=<address>", _("Enable publish asset issues and reissues in <address>"));
+    strUsage += HelpMessageOpt("-zmqpubassetbalance=<address>", _("Enable publish changed asset balances in <address> (requires -assetindex)"));
+    strUsage += HelpMessageOpt("-zmqpubmempoolevent=<address>", _("Enable publish sequenced mempool additions and removals in <address>"));
+    strUsage += HelpMessageOpt("-zmqpubqueue=<n>", strprintf(_("Number of messages waiting to be published before new ones are dropped (default: %u)"), DEFAULT_ZMQ_PUB_QUEUE));
 #endif
 
     strUsage += HelpMessageGroup(_("Debugging/Testing options:"));
@@ -546,6 +701,7 @@ std::string HelpMessage(HelpMessageMode mode)
         strUsage += HelpMessageOpt("-checkblockindex", strprintf("Do a full consistency check for mapBlockIndex, setBlockIndexCandidates, chainActive and mapBlocksUnlinked occasionally. Also sets -checkmempool (default: %u)", defaultChainParams->DefaultConsistencyChecks()));
         strUsage += HelpMessageOpt("-checkmempool=<n>", strprintf("Run checks every <n> transactions (default: %u)", defaultChainParams->DefaultConsistencyChecks()));
         strUsage += HelpMessageOpt("-checkpoints", strprintf("Disable expensive verification for known chain history (default: %u)", DEFAULT_CHECKPOINTS_ENABLED));
+        strUsage += HelpMessageOpt("-verifyblockindex", strprintf("Hash every block header in the block index in the background and check it against the stored hash and its proof of work (default: %u)", DEFAULT_VERIFYBLOCKINDEX));
         strUsage += HelpMessageOpt("-disablesafemode", strprintf("Disable safemode, override a real safe mode event (default: %u)", DEFAULT_DISABLE_SAFEMODE));
         strUsage += HelpMessageOpt("-deprecatedrpc=<method>", "Allows deprecated RPC method(s) to be used");
         strUsage += HelpMessageOpt("-testsafemode", strprintf("Force safe mode (default: %u)", DEFAULT_TESTSAFEMODE));
@@ -603,8 +759,18 @@ std::string HelpMessage(HelpMessageMode mode)
     strUsage += HelpMessageOpt("-blockmaxweight=<n>", strprintf(_("Set maximum BIP141 block weight (default: %d)"), MAX_BLOCK_WEIGHT - 4000));
     strUsage += HelpMessageOpt("-blockmaxsize=<n>", _("Set maximum BIP141 block weight to this * 4. Deprecated, use blockmaxweight"));
     strUsage += HelpMessageOpt("-blockmintxfee=<amt>", strprintf(_("Set lowest fee rate (in %s/kB) for transactions to be included in block creation. (default: %s)"), CURRENCY_UNIT, FormatMoney(DEFAULT_BLOCK_MIN_TX_FEE)));
-    if (showDebug)
+    if (showDebug) {
         strUsage += HelpMessageOpt("-blockversion=<n>", "Override block version to test forking scenarios");
+        strUsage += HelpMessageOpt("-testblocktemplate", strprintf("Fully validate every new block template, asset checks included (default: %u)", defaultChainParams->DefaultConsistencyChecks()));
+    }
+    strUsage += HelpMessageOpt("-minerfulldataset", strprintf(_("Let the built-in miner search KAWPOW against the full epoch dataset instead of the light cache; uses several GB of memory (default: %u)"), DEFAULT_MINER_FULL_DATASET));
+
+    strUsage += HelpMessageGroup(_("Stratum server options:"));
+    strUsage += HelpMessageOpt("-stratum", strprintf(_("Serve KAWPOW jobs from the block template to stratum miners and pools, submitting the blocks they find directly (default: %u)"), DEFAULT_STRATUM));
+    strUsage += HelpMessageOpt("-stratumbind=<addr>", _("Bind to given address to listen for stratum connections (default: 127.0.0.1)"));
+    strUsage += HelpMessageOpt("-stratumport=<port>", strprintf(_("Listen for stratum connections on <port> (default: %u)"), DEFAULT_STRATUM_PORT));
+    strUsage += HelpMessageOpt("-stratumallowip=<ip>", _("Allow stratum connections from specified source. Valid for <ip> are a single IP (e.g. 1.2.3.4), a network/netmask (e.g. 1.2.3.4/255.255.255.0) or a network/CIDR (e.g. 1.2.3.4/24). This option can be specified multiple times"));
+    strUsage += HelpMessageOpt("-stratumdifficulty=<n>", strprintf(_("Accept shares meeting the KAWPOW proof of work limit divided by <n> (default: %u)"), DEFAULT_STRATUM_DIFFICULTY));
 
     strUsage += HelpMessageGroup(_("RPC server options:"));
     strUsage += HelpMessageOpt("-server", _("Accept command line and JSON-RPC commands"));
@@ -614,12 +780,16 @@ std::string HelpMessage(HelpMessageMode mode)
     strUsage += HelpMessageOpt("-rpcuser=<user>", _("Username for JSON-RPC connections"));
     strUsage += HelpMessageOpt("-rpcpassword=<pw>", _("Password for JSON-RPC connections"));
     strUsage += HelpMessageOpt("-rpcauth=<userpw>", _("Username and hashed password for JSON-RPC connections. The field <userpw> comes in the format: <USERNAME>:<SALT>$<HASH>. A canonical python script is included in share/rpcuser. The client then connects normally using the rpcuser=<USERNAME>/rpcpassword=<PASSWORD> pair of arguments. This option can be specified multiple times"));
+    strUsage += HelpMessageOpt("-rpcauthcachettl=<n>", strprintf(_("Seconds a verified -rpcauth password is trusted before it is hashed again, 0 to hash it on every request (default: %d)"), DEFAULT_RPC_AUTH_CACHE_TTL));
     strUsage += HelpMessageOpt("-rpcport=<port>", strprintf(_("Listen for JSON-RPC connections on <port> (default: %u or testnet: %u)"), defaultBaseParams->RPCPort(), testnetBaseParams->RPCPort()));
     strUsage += HelpMessageOpt("-rpcallowip=<ip>", _("Allow JSON-RPC connections from specified source. Valid for <ip> are a single IP (e.g. 1.2.3.4), a network/netmask (e.g. 1.2.3.4/255.255.255.0) or a network/CIDR (e.g. 1.2.3.4/24). This option can be specified multiple times"));
     strUsage += HelpMessageOpt("-rpcserialversion", strprintf(_("Sets the serialization of raw transaction or block hex returned in non-verbose mode, non-segwit(0) or segwit(1) (default: %d)"), DEFAULT_RPC_SERIALIZE_VERSION));
     strUsage += HelpMessageOpt("-rpcthreads=<n>", strprintf(_("Set the number of threads to service RPC calls (default: %d)"), DEFAULT_HTTP_THREADS));
+    strUsage += HelpMessageOpt("-rpcqueue=<name>:<n>[:<depth>]", strprintf(_("Add a work queue served by <n> threads of its own, for requests routed to it with -rpcroute (default depth: %d). This option can be specified multiple times"), DEFAULT_HTTP_WORKQUEUE));
+    strUsage += HelpMessageOpt("-rpcroute=<method>:<name>", _("Handle calls to an RPC method, or requests for a URI prefix starting with /, on the named work queue instead of the default one. This option can be specified multiple times"));
     if (showDebug) {
         strUsage += HelpMessageOpt("-rpcworkqueue=<n>", strprintf("Set the depth of the work queue to service RPC calls (default: %d)", DEFAULT_HTTP_WORKQUEUE));
+        strUsage += HelpMessageOpt("-rpcbatchmaxbytes=<n>", strprintf("Reject JSON-RPC batch requests larger than <n> bytes (default: %d)", DEFAULT_RPC_BATCH_MAX_BYTES));
         strUsage += HelpMessageOpt("-rpcservertimeout=<n>", strprintf("Timeout during HTTP requests (default: %d)", DEFAULT_HTTP_SERVER_TIMEOUT));
     }
 
@@ -802,6 +972,26 @@ void ThreadImport(std::vector<fs::path> vImportFiles)
     }
 }
 
+/** Check the block hashes the block index was loaded with, see -verifyblockindex */
+static void ThreadVerifyBlockIndex()
+{
+    RenameThread("mynta-verifyidx");
+    while (fImporting || fReindex) {
+        boost::this_thread::interruption_point();
+        MilliSleep(1000);
+    }
+
+    int64_t nStart = GetTimeMillis();
+    if (!pblocktree->VerifyBlockIndexHashes(GetParams().GetConsensus())) {
+        const std::string strWarning = _("Warning: The block index database is corrupted, restart with -reindex to rebuild it");
+        LogPrintf("%s\n", strWarning);
+        SetMiscWarning(strWarning);
+        uiInterface.ThreadSafeMessageBox(strWarning, "", CClientUIInterface::MSG_WARNING);
+        return;
+    }
+    LogPrintf("Verified the block index hashes in %dms\n", GetTimeMillis() - nStart);
+}
+
 /** Sanity checks
  *  Ensure that Mynta is running in a usable environment with all
  *  necessary library support.
@@ -1007,10 +1197,22 @@ bool AppInitParameterInteraction()
 
     // also see: InitParameterInteraction()
 
+    // -blockfilterindex with no value or 1 means basic filters, 0 turns the index off
+    const std::string strFilterIndex = gArgs.GetArg("-blockfilterindex", DEFAULT_BLOCKFILTERINDEX);
+    if (strFilterIndex == "1" || strFilterIndex.empty()) {
+        blockFilterIndexType = BlockFilterType::BASIC;
+    } else if (strFilterIndex != "0" && !BlockFilterTypeByName(strFilterIndex, blockFilterIndexType)) {
+        return InitError(strprintf(_("Unknown -blockfilterindex value %s."), strFilterIndex));
+    }
+
     // if using block pruning, then disallow txindex
     if (gArgs.GetArg("-prune", 0)) {
         if (gArgs.GetBoolArg("-txindex", DEFAULT_TXINDEX))
             return InitError(_("Prune mode is incompatible with -txindex."));
+        if (blockFilterIndexType != BlockFilterType::INVALID)
+            return InitError(_("Prune mode is incompatible with -blockfilterindex."));
+        if (gArgs.GetBoolArg("-dexindex", DEFAULT_DEXINDEX))
+            return InitError(_("Prune mode is incompatible with -dexindex."));
     }
 
     // -bind and -whitebind can't be set when not listening
@@ -1024,8 +1226,14 @@ bool AppInitParameterInteraction()
     nUserMaxConnections = gArgs.GetArg("-maxconnections", DEFAULT_MAX_PEER_CONNECTIONS);
     nMaxConnections = std::max(nUserMaxConnections, 0);
 
+    // Only select() is limited to descriptors below FD_SETSIZE
+    std::unique_ptr<CSocketEvents> socketEvents = CreateSocketEvents(gArgs.GetArg("-socketevents", DEFAULT_SOCKETEVENTS));
+    if (!socketEvents)
+        return InitError(strprintf(_("Unsupported -socketevents value '%s' (supported: %s)"), gArgs.GetArg("-socketevents", DEFAULT_SOCKETEVENTS), GetSocketEventsBackends()));
+
     // Trim requested connection counts, to fit into system limitations
-    nMaxConnections = std::max(std::min(nMaxConnections, (int)(FD_SETSIZE - nBind - MIN_CORE_FILEDESCRIPTORS - MAX_ADDNODE_CONNECTIONS)), 0);
+    if (socketEvents->IsFdSetLimited())
+        nMaxConnections = std::max(std::min(nMaxConnections, (int)(FD_SETSIZE - nBind - MIN_CORE_FILEDESCRIPTORS - MAX_ADDNODE_CONNECTIONS)), 0);
     nFD = RaiseFileDescriptorLimit(nMaxConnections + MIN_CORE_FILEDESCRIPTORS + MAX_ADDNODE_CONNECTIONS);
     if (nFD < MIN_CORE_FILEDESCRIPTORS)
         return InitError(_("Not enough file descriptors available."));
@@ -1087,6 +1295,19 @@ bool AppInitParameterInteraction()
     }
     fCheckBlockIndex = gArgs.GetBoolArg("-checkblockindex", chainparams.DefaultConsistencyChecks());
     fCheckpointsEnabled = gArgs.GetBoolArg("-checkpoints", DEFAULT_CHECKPOINTS_ENABLED);
+    fBlockFileMmap = gArgs.GetBoolArg("-blockfilemmap", DEFAULT_BLOCKFILE_MMAP);
+    fBlockCompression = gArgs.GetBoolArg("-blockcompression", DEFAULT_BLOCK_COMPRESSION);
+    if (fBlockCompression && !CanCompressDiskRecords()) {
+        InitWarning(_("-blockcompression needs a build with Snappy; block files will not be compressed."));
+        fBlockCompression = false;
+    }
+
+    {
+        CDBProfile profile;
+        std::string strError;
+        if (!GetDBProfile("", profile, strError))
+            return InitError(strError);
+    }
 
     hashAssumeValid = uint256S(gArgs.GetArg("-assumevalid", chainparams.GetConsensus().defaultAssumeValid.GetHex()));
     if (!hashAssumeValid.IsNull())
@@ -1151,6 +1372,9 @@ bool AppInitParameterInteraction()
     }
 
     RegisterAllCoreRPCCommands(tableRPC);
+#if ENABLE_ZMQ
+    RegisterZMQRPCCommands(tableRPC);
+#endif
 #ifdef ENABLE_WALLET
     RegisterWalletRPC(tableRPC);
 #endif
@@ -1213,6 +1437,12 @@ bool AppInitParameterInteraction()
     if (gArgs.GetBoolArg("-peerbloomfilters", DEFAULT_PEERBLOOMFILTERS))
         nLocalServices = ServiceFlags(nLocalServices | NODE_BLOOM);
 
+    if (gArgs.GetBoolArg("-peerblockfilters", DEFAULT_PEERBLOCKFILTERS)) {
+        if (blockFilterIndexType != BlockFilterType::BASIC)
+            return InitError(_("Cannot set -peerblockfilters without -blockfilterindex."));
+        nLocalServices = ServiceFlags(nLocalServices | NODE_COMPACT_FILTERS);
+    }
+
     if (gArgs.GetArg("-rpcserialversion", DEFAULT_RPC_SERIALIZE_VERSION) < 0)
         return InitError("rpcserialversion must be non-negative.");
 
@@ -1296,6 +1526,8 @@ bool AppInitSanityChecks()
     // Initialize elliptic curve code
     std::string sha256_algo = SHA256AutoDetect();
     LogPrintf("Using the '%s' SHA256 implementation\n", sha256_algo);
+    std::string x16r_algo = X16RAutoDetect();
+    LogPrintf("Using the '%s' X16R stage implementations\n", x16r_algo);
     RandomInit();
     ECC_Start();
     globalVerifyHandle.reset(new ECCVerifyHandle());
@@ -1348,17 +1580,29 @@ bool AppInitMain(boost::thread_group& threadGroup, CScheduler& scheduler)
     InitSignatureCache();
     InitScriptExecutionCache();
 
-    LogPrintf("Using %u threads for script verification\n", nScriptCheckThreads);
+    LogPrintf("Using %u threads for script and header verification\n", nScriptCheckThreads);
     if (nScriptCheckThreads) {
         for (int i=0; i<nScriptCheckThreads-1; i++)
-            threadGroup.create_thread(&ThreadScriptCheck);
+            threadGroup.create_thread(boost::bind(&ThreadScriptCheck, i));
+        for (int i=0; i<nScriptCheckThreads-1; i++)
+            threadGroup.create_thread(&ThreadHeaderCheck);
+        for (int i=0; i<nScriptCheckThreads-1; i++)
+            threadGroup.create_thread(&ThreadBlockLoadCheck);
+        for (int i=0; i<nScriptCheckThreads-1; i++)
+            threadGroup.create_thread(&ThreadTxPrepare);
+        for (int i=0; i<nScriptCheckThreads-1; i++)
+            threadGroup.create_thread(&ThreadProviderSigCheck);
     }
 
-    // Start the lightweight task scheduler thread
+    // Start the lightweight task scheduler threads
+    const int nSchedulerThreads = std::max(1, std::min<int>(gArgs.GetArg("-schedulerthreads", DEFAULT_SCHEDULER_THREADS), MAX_SCHEDULER_THREADS));
     CScheduler::Function serviceLoop = boost::bind(&CScheduler::serviceQueue, &scheduler);
-    threadGroup.create_thread(boost::bind(&TraceThread<CScheduler::Function>, "scheduler", serviceLoop));
+    for (int i = 0; i < nSchedulerThreads; i++)
+        threadGroup.create_thread(boost::bind(&TraceThread<CScheduler::Function>, "scheduler", serviceLoop));
+    g_scheduler = &scheduler;
 
     GetMainSignals().RegisterBackgroundSignalScheduler(scheduler);
+    StartBlockTemplateRefresh(scheduler);
 
     /* Start the RPC server already.  It will be started in "warmup" mode
      * and not really process calls already (but it will signify connections
@@ -1487,7 +1731,9 @@ bool AppInitMain(boost::thread_group& threadGroup, CScheduler& scheduler)
     pzmqNotificationInterface = CZMQNotificationInterface::Create();
 
     if (pzmqNotificationInterface) {
-        RegisterValidationInterface(pzmqNotificationInterface);
+        ValidationQueueOptions options;
+        options.strName = "zmq";
+        RegisterValidationInterface(pzmqNotificationInterface, options);
     }
 #endif
     uint64_t nMaxOutboundLimit = 0; //unlimited unless -maxuploadtarget is set
@@ -1518,12 +1764,37 @@ bool AppInitMain(boost::thread_group& threadGroup, CScheduler& scheduler)
     int64_t nCoinDBCache = std::min(nTotalCache / 2, (nTotalCache / 4) + (1 << 23)); // use 25%-50% of the remainder for disk cache
     nCoinDBCache = std::min(nCoinDBCache, nMaxCoinsDBCache << 20); // cap total coins db cache
     nTotalCache -= nCoinDBCache;
+    int64_t nMessageCache = 0;
+    if (!gArgs.GetBoolArg("-disablemessaging", false)) {
+        nMessageCache = std::min(nTotalCache / MESSAGE_DBCACHE_FRACTION, MAX_MESSAGE_CACHE_USAGE); // message read caches
+        nTotalCache -= nMessageCache;
+    }
     nCoinCacheUsage = nTotalCache; // the rest goes to in-memory cache
     int64_t nMempoolSizeMax = gArgs.GetArg("-maxmempool", DEFAULT_MAX_MEMPOOL_SIZE) * 1000000;
     LogPrintf("Cache configuration:\n");
     LogPrintf("* Using %.1fMiB for block index database\n", nBlockTreeDBCache * (1.0 / 1024 / 1024));
     LogPrintf("* Using %.1fMiB for chain state database\n", nCoinDBCache * (1.0 / 1024 / 1024));
     LogPrintf("* Using %.1fMiB for in-memory UTXO set (plus up to %.1fMiB of unused mempool space)\n", nCoinCacheUsage * (1.0 / 1024 / 1024), nMempoolSizeMax * (1.0 / 1024 / 1024));
+    if (nMessageCache)
+        LogPrintf("* Using %.1fMiB for message caches\n", nMessageCache * (1.0 / 1024 / 1024));
+    if (gArgs.GetBoolArg("-dbsharedcache", DEFAULT_DB_SHARED_CACHE)) {
+        // What the chainstate and block index caches would have had, and as much as
+        // three more block index caches for the asset, message and other databases
+        int64_t nSharedBlockCache = (nCoinDBCache + 4 * nBlockTreeDBCache) / 2;
+        SetSharedDBBlockCache(nSharedBlockCache);
+        LogPrintf("* Using %.1fMiB for the table block cache shared by the databases\n", nSharedBlockCache * (1.0 / 1024 / 1024));
+    }
+    int64_t nMemoryBudget = gArgs.GetArg("-memorybudget", DEFAULT_MEMORY_BUDGET);
+    if (nMemoryBudget < 0)
+        return InitError(strprintf(_("Invalid -memorybudget: %d"), nMemoryBudget));
+    g_memoryBudget.SetBudget(nMemoryBudget << 20);
+    if (nMemoryBudget)
+        LogPrintf("* Keeping the caches below %dMiB together\n", nMemoryBudget);
+    RegisterMemoryConsumers();
+
+    // Keep the cold header fields of the block index in a mapped scratch file
+    TryCreateDirectories(GetDataDir() / "blocks");
+    blockIndexColdStore.Open(GetDataDir() / "blocks" / "indexcold.tmp");
 
     bool fLoaded = false;
     while (!fLoaded && !fRequestShutdown) {
@@ -1537,6 +1808,7 @@ bool AppInitMain(boost::thread_group& threadGroup, CScheduler& scheduler)
             try {
                 UnloadBlockIndex();
                 delete pcoinsTip;
+                delete pcoinsbuffer;
                 delete pcoinsdbview;
                 delete pcoinscatcher;
                 delete pblocktree;
@@ -1574,12 +1846,14 @@ bool AppInitMain(boost::thread_group& threadGroup, CScheduler& scheduler)
                     // Basic assets
                     passetsdb = new CAssetsDB(nBlockTreeDBCache, false, fReset);
                     passets = new CAssetsCache();
-                    passetsCache = new CLRUCache<std::string, CDatabasedAssetData>(MAX_CACHE_ASSETS_SIZE);
+                    passetsCache = new CAssetNameLRUCache<CDatabasedAssetData>(MAX_CACHE_ASSETS_SIZE, MAX_CACHE_ASSETS_USAGE);
 
                     // Messaging assets
-                    pMessagesCache = new CLRUCache<std::string, CMessage>(1000);
+                    // With messaging disabled there is no byte budget, so keep the caches small
+                    size_t nMessageCacheEntries = nMessageCache ? MAX_MESSAGE_CACHE_ENTRIES : 1000;
+                    pMessagesCache = new CMessageLRUCache(nMessageCacheEntries, nMessageCache * 3 / 4);
                     pMessageSubscribedChannelsCache = new CLRUCache<std::string, int>(1000);
-                    pMessagesSeenAddressCache = new CLRUCache<std::string, int>(1000);
+                    pMessagesSeenAddressCache = new CSeenAddressLRUCache(nMessageCacheEntries, nMessageCache / 4);
                     pmessagedb = new CMessageDB(nBlockTreeDBCache, false, false);
                     pmessagechanneldb = new CMessageChannelDB(nBlockTreeDBCache, false, false);
 
@@ -1588,11 +1862,11 @@ bool AppInitMain(boost::thread_group& threadGroup, CScheduler& scheduler)
 
                     // Restricted assets
                     prestricteddb = new CRestrictedDB(nBlockTreeDBCache, false, fReset);
-                    passetsVerifierCache = new CLRUCache<std::string, CNullAssetTxVerifierString>(
-                            MAX_CACHE_ASSETS_SIZE);
-                    passetsQualifierCache = new CLRUCache<std::string, int8_t>(MAX_CACHE_ASSETS_SIZE);
-                    passetsRestrictionCache = new CLRUCache<std::string, int8_t>(MAX_CACHE_ASSETS_SIZE);
-                    passetsGlobalRestrictionCache = new CLRUCache<std::string, int8_t>(MAX_CACHE_ASSETS_SIZE);
+                    passetsVerifierCache = new CAssetNameLRUCache<CNullAssetTxVerifierString>(
+                            MAX_CACHE_ASSETS_SIZE, MAX_CACHE_ASSETS_USAGE);
+                    passetsQualifierCache = new CAssetAddressLRUCache<int8_t>(MAX_CACHE_ASSETS_SIZE, MAX_CACHE_ASSETS_USAGE);
+                    passetsRestrictionCache = new CAssetAddressLRUCache<int8_t>(MAX_CACHE_ASSETS_SIZE, MAX_CACHE_ASSETS_USAGE);
+                    passetsGlobalRestrictionCache = new CAssetNameLRUCache<int8_t>(MAX_CACHE_ASSETS_SIZE, MAX_CACHE_ASSETS_USAGE);
 
                     // Rewards
                     pSnapshotRequestDb = new CSnapshotRequestDB(nBlockTreeDBCache, false, false);
@@ -1607,6 +1881,8 @@ bool AppInitMain(boost::thread_group& threadGroup, CScheduler& scheduler)
                         break;
                     }
 
+                    prestricteddb->LoadPrefilters();
+
                     if (!passetsdb->ReadReissuedMempoolState())
                         LogPrintf(
                                 "Database failed to load last Reissued Mempool State. Will have to start from empty state");
@@ -1621,6 +1897,12 @@ bool AppInitMain(boost::thread_group& threadGroup, CScheduler& scheduler)
                     } else {
                         LogPrintf("Messaging is enabled\n");
                     }
+
+                    // Message databases from before the per channel index get it built once
+                    if (fMessaging && !pmessagedb->BuildChannelIndex()) {
+                        strLoadError = _("Failed to build the message channel index");
+                        break;
+                    }
                 }
                 /** MYNTA END */
 
@@ -1654,21 +1936,9 @@ bool AppInitMain(boost::thread_group& threadGroup, CScheduler& scheduler)
                     break;
                 }
 
-                // Check for changed -addressindex state
-                if (fAddressIndex != gArgs.GetBoolArg("-addressindex", DEFAULT_ADDRESSINDEX)) {
-                    strLoadError = _("You need to rebuild the database using -reindex-chainstate to change -addressindex");
-                    break;
-                }
-
-                // Check for changed -spentindex state
-                if (fSpentIndex != gArgs.GetBoolArg("-spentindex", DEFAULT_SPENTINDEX)) {
-                    strLoadError = _("You need to rebuild the database using -reindex-chainstate to change -spentindex");
-                    break;
-                }
-
-                // Check for changed -timestampindex state
-                if (fTimestampIndex != gArgs.GetBoolArg("-timestampindex", DEFAULT_TIMESTAMPINDEX)) {
-                    strLoadError = _("You need to rebuild the database using -reindex-chainstate to change -timestampindex");
+                // Check for changed -addressindex, -spentindex and -timestampindex state.
+                // Indexes turned on since the last start are built in the background.
+                if (!InitIndexBuild(strLoadError)) {
                     break;
                 }
 
@@ -1708,7 +1978,8 @@ bool AppInitMain(boost::thread_group& threadGroup, CScheduler& scheduler)
                 }
 
                 // The on-disk coinsdb is now in a good state, create the cache
-                pcoinsTip = new CCoinsViewCache(pcoinscatcher);
+                pcoinsbuffer = new CCoinsViewFlushBuffer(pcoinscatcher, pcoinsdbview);
+                pcoinsTip = new CCoinsViewCache(pcoinsbuffer);
 
                 bool is_coinsview_empty = fReset || fReindexChainState || pcoinsTip->GetBestBlock().IsNull();
                 if (!is_coinsview_empty) {
@@ -1718,6 +1989,17 @@ bool AppInitMain(boost::thread_group& threadGroup, CScheduler& scheduler)
                         break;
                     }
                     assert(chainActive.Tip() != nullptr);
+
+                    if (!CheckChainstateSideDatabases()) {
+                        strLoadError = _("The asset databases do not match the chainstate. You will need to rebuild the database using -reindex.");
+                        break;
+                    }
+                }
+
+                // Needs the coins and the assets db at the same block, so before anything is connected or rewound
+                if (passetsdb && !passetsdb->IndexAssetSupply(pcoinsdbview)) {
+                    strLoadError = _("Error counting the supply of the assets");
+                    break;
                 }
 
                 if (!fReset) {
@@ -1797,12 +2079,42 @@ bool AppInitMain(boost::thread_group& threadGroup, CScheduler& scheduler)
         LogPrintf(" block index %15dms\n", GetTimeMillis() - nStart);
     }
 
+    if (blockFilterIndexType != BlockFilterType::INVALID) {
+        pblockfilterindex = new CBlockFilterIndex(blockFilterIndexType, BLOCKFILTERINDEX_DB_CACHE_SIZE);
+        {
+            LOCK(cs_main);
+            pblockfilterindex->Init();
+        }
+        // Every block it misses would have to be found again by the sync thread, so it is never dropped
+        ValidationQueueOptions options;
+        options.strName = "blockfilterindex";
+        options.nMaxDepth = BLOCKFILTERINDEX_QUEUE_DEPTH;
+        RegisterValidationInterface(pblockfilterindex, options);
+    }
+
+    if (gArgs.GetBoolArg("-dexindex", DEFAULT_DEXINDEX)) {
+        pdextradeindex = new CDexTradeIndex(DEXINDEX_DB_CACHE_SIZE, false, fReindex);
+        {
+            LOCK(cs_main);
+            if (!pdextradeindex->Init())
+                return InitError(_("The DEX trade index is of a chain that isn't known. Restart with -reindex to rebuild it."));
+        }
+        ValidationQueueOptions options;
+        options.strName = "dexindex";
+        options.nMaxDepth = DEXINDEX_QUEUE_DEPTH;
+        RegisterValidationInterface(pdextradeindex, options);
+    }
+
     fs::path est_path = GetDataDir() / FEE_ESTIMATES_FILENAME;
     CAutoFile est_filein(fsbridge::fopen(est_path, "rb"), SER_DISK, CLIENT_VERSION);
     // Allowed to fail as this file IS missing on first startup.
     if (!est_filein.IsNull())
         ::feeEstimator.Read(est_filein);
     fFeeEstimatesInitialized = true;
+    scheduler.scheduleEvery(RefreshFeeEstimates, 1000, "fee_estimates_refresh");
+    scheduler.scheduleEvery(PeriodicWriteFeeEstimates, 60 * 1000, "fee_estimates_write");
+    if (g_memoryBudget.GetBudget())
+        scheduler.scheduleEvery([] { g_memoryBudget.Enforce(); }, MEMORY_BUDGET_INTERVAL, "memory_budget");
 
     // ********************************************************* Step 8: load wallet
 #ifdef ENABLE_WALLET
@@ -1823,6 +2135,8 @@ bool AppInitMain(boost::thread_group& threadGroup, CScheduler& scheduler)
             uiInterface.InitMessage(_("Pruning blockstore..."));
             PruneAndFlush();
         }
+        // The asset db and evo db keep per-block data of their own
+        scheduler.scheduleEvery(PruneBlockStateData, BLOCK_STATE_PRUNE_INTERVAL * 1000, "block_state_prune");
     }
 
     if(chainparams.GetConsensus().nSegwitEnabled) {
@@ -1844,12 +2158,26 @@ bool AppInitMain(boost::thread_group& threadGroup, CScheduler& scheduler)
     if (gArgs.IsArgSet("-blocknotify"))
         uiInterface.NotifyBlockTip.connect(BlockNotifyCallback);
 
+    const int nPrefetchThreads = std::max(0, std::min<int>(gArgs.GetArg("-prefetchthreads", DEFAULT_PREFETCH_THREADS), MAX_PREFETCH_THREADS));
+    if (nPrefetchThreads) {
+        LogPrintf("Using %d threads to read the inputs of incoming blocks\n", nPrefetchThreads);
+        g_blockPrefetcher.Start(pcoinsTip, nPrefetchThreads);
+    }
+
     std::vector<fs::path> vImportFiles;
     for (const std::string& strFile : gArgs.GetArgs("-loadblock")) {
         vImportFiles.push_back(strFile);
     }
 
     threadGroup.create_thread(boost::bind(&ThreadImport, vImportFiles));
+    StartIndexBuild(threadGroup);
+    if (pblockfilterindex)
+        pblockfilterindex->StartSync(threadGroup, "mynta-filteridx");
+    if (pdextradeindex)
+        pdextradeindex->StartSync(threadGroup, "mynta-dexidx");
+    StartHotAssetPrefetch(threadGroup);
+    if (gArgs.GetBoolArg("-verifyblockindex", DEFAULT_VERIFYBLOCKINDEX))
+        threadGroup.create_thread(&ThreadVerifyBlockIndex);
 
     // Wait for genesis block to be processed
     {
@@ -1872,6 +2200,9 @@ bool AppInitMain(boost::thread_group& threadGroup, CScheduler& scheduler)
     }
     LogPrintf("nBestHeight = %d\n", chain_active_height);
 
+    if (!StartStratumServer())
+        return InitError(_("Unable to start the stratum server. See debug log for details."));
+
     if (gArgs.GetBoolArg("-listenonion", DEFAULT_LISTEN_ONION))
         StartTorControl(threadGroup, scheduler);
 
@@ -1923,6 +2254,8 @@ bool AppInitMain(boost::thread_group& threadGroup, CScheduler& scheduler)
     }
 
     connOptions.vSeedNodes = gArgs.GetArgs("-seednode");
+    connOptions.strSocketEvents = gArgs.GetArg("-socketevents", DEFAULT_SOCKETEVENTS);
+    connOptions.nMessageHandlerThreads = gArgs.GetArg("-msghandlerthreads", DEFAULT_MESSAGE_HANDLER_THREADS);
 
     // Initiate outbound connections unless connect=0
     connOptions.m_use_addrman_outgoing = !gArgs.IsArgSet("-connect");
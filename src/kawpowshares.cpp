@@ -0,0 +1,60 @@
+// Copyright (c) 2026 The Mynta Core Developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include "kawpowshares.h"
+
+#include "arith_uint256.h"
+#include "epochcontext.h"
+#include "hash.h"
+
+#include <crypto/ethash/include/ethash/ethash.hpp>
+#include <crypto/ethash/include/ethash/progpow.hpp>
+
+#include <algorithm>
+#include <atomic>
+#include <thread>
+
+static void VerifyKawpowSharesWorker(const std::vector<CKawpowShare>& vShares, std::vector<CKawpowShareResult>& vResults, std::atomic<size_t>& nNext)
+{
+    // Batches mostly share one epoch, so hold on to the last context used
+    // instead of taking the cache's lock for every share
+    int nEpoch = -1;
+    CEpochContextCache::ContextPtr context;
+
+    for (size_t i = nNext++; i < vShares.size(); i = nNext++) {
+        const CKawpowShare& share = vShares[i];
+        CKawpowShareResult& result = vResults[i];
+        const ethash::hash256 header_hash = ToEthashHash256(share.hashHeader);
+        const ethash::hash256 mix_hash = ToEthashHash256(share.hashMix);
+
+        result.hashFinal = FromEthashHash256(progpow::hash_no_verify(share.nHeight, header_hash, mix_hash, share.nNonce));
+        if (UintToArith256(result.hashFinal) > UintToArith256(share.target))
+            continue;
+
+        const int nShareEpoch = ethash::get_epoch_number(share.nHeight);
+        if (nShareEpoch != nEpoch) {
+            context = epochContextCache.Get(nShareEpoch);
+            nEpoch = nShareEpoch;
+        }
+        if (!context)
+            continue;
+        result.fValid = progpow::verify(*context, share.nHeight, header_hash, mix_hash, share.nNonce, ToEthashHash256(share.target));
+    }
+}
+
+std::vector<CKawpowShareResult> VerifyKawpowShares(const std::vector<CKawpowShare>& vShares, int nThreads)
+{
+    std::vector<CKawpowShareResult> vResults(vShares.size());
+    const size_t nMaxThreads = (vShares.size() + MIN_KAWPOW_SHARES_PER_THREAD - 1) / MIN_KAWPOW_SHARES_PER_THREAD;
+    const int nWorkers = std::max(1, (int)std::min<size_t>(std::min(nThreads, MAX_KAWPOW_VERIFY_THREADS), nMaxThreads));
+
+    std::atomic<size_t> nNext{0};
+    std::vector<std::thread> vThreads;
+    for (int i = 1; i < nWorkers; i++)
+        vThreads.emplace_back(VerifyKawpowSharesWorker, std::cref(vShares), std::ref(vResults), std::ref(nNext));
+    VerifyKawpowSharesWorker(vShares, vResults, nNext);
+    for (std::thread& thread : vThreads)
+        thread.join();
+    return vResults;
+}
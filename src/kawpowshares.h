@@ -0,0 +1,67 @@
+// Copyright (c) 2026 The Mynta Core Developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#ifndef MYNTA_KAWPOWSHARES_H
+#define MYNTA_KAWPOWSHARES_H
+
+#include "serialize.h"
+#include "uint256.h"
+
+#include <stdint.h>
+#include <vector>
+
+/** Most shares verifykawpowshares takes in one call */
+static const size_t MAX_KAWPOW_SHARES_PER_CALL = 4096;
+/** Most threads a batch of shares is verified on */
+static const int MAX_KAWPOW_VERIFY_THREADS = 8;
+/** Fewest shares worth starting another thread for */
+static const size_t MIN_KAWPOW_SHARES_PER_THREAD = 16;
+
+/** A share as a miner submits it: the KAWPOW header hash, mix hash and nonce it found */
+struct CKawpowShare {
+    uint256 hashHeader;
+    uint256 hashMix;
+    uint64_t nNonce{0};
+    uint32_t nHeight{0};
+    //! Target the final hash has to meet
+    uint256 target;
+
+    ADD_SERIALIZE_METHODS;
+
+    template <typename Stream, typename Operation>
+    inline void SerializationOp(Stream& s, Operation ser_action)
+    {
+        READWRITE(hashHeader);
+        READWRITE(hashMix);
+        READWRITE(nNonce);
+        READWRITE(nHeight);
+        READWRITE(target);
+    }
+};
+
+struct CKawpowShareResult {
+    //! The mix hash is right and the final hash meets the target
+    bool fValid{false};
+    //! Final hash of the claimed mix hash, valid or not
+    uint256 hashFinal;
+
+    ADD_SERIALIZE_METHODS;
+
+    template <typename Stream, typename Operation>
+    inline void SerializationOp(Stream& s, Operation ser_action)
+    {
+        READWRITE(fValid);
+        READWRITE(hashFinal);
+    }
+};
+
+/**
+ * Verify shares with progpow::verify on up to nThreads threads, using the
+ * epoch contexts of the shared epochContextCache. A share whose final hash
+ * misses its target fails without touching an epoch context. The results
+ * are in the order of the shares.
+ */
+std::vector<CKawpowShareResult> VerifyKawpowShares(const std::vector<CKawpowShare>& vShares, int nThreads);
+
+#endif // MYNTA_KAWPOWSHARES_H
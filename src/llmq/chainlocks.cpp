@@ -3,10 +3,15 @@
 // file COPYING or http://www.opensource.org/licenses/mit-license.php.
 
 #include "llmq/chainlocks.h"
+#include "llmq/instantsend.h"
+#include "bls/bls_worker.h"
 #include "chain.h"
 #include "chainparams.h"
 #include "consensus/validation.h"
+#include "crypto/common.h"
+#include "evo/evodb.h"
 #include "hash.h"
+#include "net.h"
 #include "util.h"
 #include "validation.h"
 
@@ -63,28 +68,116 @@ std::string CChainLockSig::ToString() const
 // CChainLocksDb Implementation
 // ============================================================================
 
+static const std::string DB_CHAINLOCK = "clsig_H";
+static const std::string DB_BEST_CHAINLOCK = "clsig_B";
+
+CChainLocksDb::CChainLocksDb(CEvoDB* pevodbIn)
+    : pevodb(pevodbIn)
+{
+    for (auto& slot : window) {
+        for (auto& word : slot.blockHash) {
+            word.store(0, std::memory_order_relaxed);
+        }
+    }
+    
+    int nBestHeight;
+    if (!pevodb || !pevodb->Read(DB_BEST_CHAINLOCK, nBestHeight)) {
+        return;
+    }
+    
+    LOCK(cs);
+    for (int nHeight = std::max(0, nBestHeight - CHAINLOCK_WINDOW_SIZE + 1); nHeight <= nBestHeight; nHeight++) {
+        CChainLockSig clsig;
+        if (pevodb->Read(std::make_pair(DB_CHAINLOCK, nHeight), clsig) && clsig.nHeight == nHeight) {
+            locksByHeight[nHeight] = clsig;
+            SetSlot(nHeight, clsig.blockHash);
+        }
+    }
+    auto it = locksByHeight.find(nBestHeight);
+    if (it != locksByHeight.end()) {
+        bestChainLockHash = it->second.blockHash;
+        bestChainLockHeight.store(nBestHeight, std::memory_order_release);
+    }
+    LogPrint(BCLog::LLMQ, "CChainLocksDb::%s -- Loaded %u ChainLocks, best at height %d\n",
+             __func__, locksByHeight.size(), GetBestChainLockHeight());
+}
+
+void CChainLocksDb::SetSlot(int nHeight, const uint256& blockHash)
+{
+    AssertLockHeld(cs);
+    
+    CWindowSlot& slot = window[nHeight % CHAINLOCK_WINDOW_SIZE];
+    const uint32_t nSequence = slot.nSequence.load(std::memory_order_relaxed);
+    slot.nSequence.store(nSequence + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    slot.nHeight.store(nHeight, std::memory_order_relaxed);
+    for (size_t i = 0; i < slot.blockHash.size(); i++) {
+        slot.blockHash[i].store(ReadLE64(blockHash.begin() + 8 * i), std::memory_order_relaxed);
+    }
+    slot.nSequence.store(nSequence + 2, std::memory_order_release);
+}
+
+void CChainLocksDb::ClearSlot(int nHeight)
+{
+    AssertLockHeld(cs);
+    
+    CWindowSlot& slot = window[nHeight % CHAINLOCK_WINDOW_SIZE];
+    if (slot.nHeight.load(std::memory_order_relaxed) != nHeight) {
+        return;
+    }
+    const uint32_t nSequence = slot.nSequence.load(std::memory_order_relaxed);
+    slot.nSequence.store(nSequence + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    slot.nHeight.store(-1, std::memory_order_relaxed);
+    slot.nSequence.store(nSequence + 2, std::memory_order_release);
+}
+
+void CChainLocksDb::PruneWindow()
+{
+    AssertLockHeld(cs);
+    
+    const int nKeepFrom = GetBestChainLockHeight() - CHAINLOCK_WINDOW_SIZE + 1;
+    for (auto it = locksByHeight.begin(); it != locksByHeight.end() && it->first < nKeepFrom; ) {
+        ClearSlot(it->first);
+        if (pevodb) {
+            pevodb->Erase(std::make_pair(DB_CHAINLOCK, it->first));
+        }
+        it = locksByHeight.erase(it);
+    }
+}
+
 bool CChainLocksDb::WriteChainLock(const CChainLockSig& clsig)
 {
     LOCK(cs);
     
+    const int nBestHeight = GetBestChainLockHeight();
+    
     // Don't allow going backwards
-    if (clsig.nHeight <= bestChainLockHeight && bestChainLockHeight > 0) {
+    if (clsig.nHeight <= nBestHeight && nBestHeight > 0) {
         // Allow updating same height (shouldn't happen, but be safe)
-        if (clsig.nHeight < bestChainLockHeight) {
+        if (clsig.nHeight < nBestHeight) {
             LogPrintf("CChainLocksDb::%s -- Rejecting ChainLock at height %d (current best: %d)\n",
-                      __func__, clsig.nHeight, bestChainLockHeight);
+                      __func__, clsig.nHeight, nBestHeight);
             return false;
         }
     }
     
-    // Store by height and hash
+    // Store by height
     locksByHeight[clsig.nHeight] = clsig;
-    locksByHash[clsig.blockHash] = clsig;
+    SetSlot(clsig.nHeight, clsig.blockHash);
+    if (pevodb) {
+        pevodb->Write(std::make_pair(DB_CHAINLOCK, clsig.nHeight), clsig);
+    }
     
-    // Update best
-    if (clsig.nHeight > bestChainLockHeight) {
-        bestChainLockHeight = clsig.nHeight;
+    // Update best. Its ancestors are final with it, so the locks further
+    // below than the window are implied by it and not kept.
+    if (clsig.nHeight > nBestHeight) {
         bestChainLockHash = clsig.blockHash;
+        bestChainLockHeight.store(clsig.nHeight, std::memory_order_release);
+        if (pevodb) {
+            pevodb->Write(DB_BEST_CHAINLOCK, clsig.nHeight);
+        }
+        PruneWindow();
     }
     
     LogPrintf("CChainLocksDb::%s -- Wrote ChainLock: %s\n", __func__, clsig.ToString());
@@ -108,13 +201,14 @@ bool CChainLocksDb::GetChainLockByHash(const uint256& blockHash, CChainLockSig&
 {
     LOCK(cs);
     
-    auto it = locksByHash.find(blockHash);
-    if (it == locksByHash.end()) {
-        return false;
+    // The window is small, a scan beats keeping a second index
+    for (const auto& entry : locksByHeight) {
+        if (entry.second.blockHash == blockHash) {
+            clsigOut = entry.second;
+            return true;
+        }
     }
-    
-    clsigOut = it->second;
-    return true;
+    return false;
 }
 
 bool CChainLocksDb::IsChainLocked(int nHeight) const
@@ -125,14 +219,32 @@ bool CChainLocksDb::IsChainLocked(int nHeight) const
 
 bool CChainLocksDb::HasChainLock(const uint256& blockHash) const
 {
-    LOCK(cs);
-    return locksByHash.count(blockHash) > 0;
+    CChainLockSig clsig;
+    return GetChainLockByHash(blockHash, clsig);
 }
 
-int CChainLocksDb::GetBestChainLockHeight() const
+bool CChainLocksDb::HasChainLock(int nHeight, const uint256& blockHash) const
 {
-    LOCK(cs);
-    return bestChainLockHeight;
+    if (nHeight < 0) {
+        return false;
+    }
+    
+    const CWindowSlot& slot = window[nHeight % CHAINLOCK_WINDOW_SIZE];
+    while (true) {
+        const uint32_t nSequence = slot.nSequence.load(std::memory_order_acquire);
+        if (nSequence & 1) {
+            continue;
+        }
+        const int nSlotHeight = slot.nHeight.load(std::memory_order_relaxed);
+        bool fMatch = nSlotHeight == nHeight;
+        for (size_t i = 0; i < slot.blockHash.size(); i++) {
+            fMatch &= slot.blockHash[i].load(std::memory_order_relaxed) == ReadLE64(blockHash.begin() + 8 * i);
+        }
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if (slot.nSequence.load(std::memory_order_relaxed) == nSequence) {
+            return fMatch;
+        }
+    }
 }
 
 uint256 CChainLocksDb::GetBestChainLockHash() const
@@ -145,23 +257,25 @@ void CChainLocksDb::RemoveAboveHeight(int nHeight)
 {
     LOCK(cs);
     
-    for (auto it = locksByHeight.begin(); it != locksByHeight.end(); ) {
-        if (it->first > nHeight) {
-            locksByHash.erase(it->second.blockHash);
-            it = locksByHeight.erase(it);
-        } else {
-            ++it;
+    for (auto it = locksByHeight.upper_bound(nHeight); it != locksByHeight.end(); ) {
+        ClearSlot(it->first);
+        if (pevodb) {
+            pevodb->Erase(std::make_pair(DB_CHAINLOCK, it->first));
         }
+        it = locksByHeight.erase(it);
     }
     
-    // Update best
-    if (bestChainLockHeight > nHeight) {
-        bestChainLockHeight = nHeight;
-        auto it = locksByHeight.find(nHeight);
-        if (it != locksByHeight.end()) {
-            bestChainLockHash = it->second.blockHash;
-        } else {
+    // The best is now the highest lock left
+    if (GetBestChainLockHeight() > nHeight) {
+        const int nBestHeight = locksByHeight.empty() ? 0 : locksByHeight.rbegin()->first;
+        if (locksByHeight.empty()) {
             bestChainLockHash.SetNull();
+        } else {
+            bestChainLockHash = locksByHeight.rbegin()->second.blockHash;
+        }
+        bestChainLockHeight.store(nBestHeight, std::memory_order_release);
+        if (pevodb) {
+            pevodb->Write(DB_BEST_CHAINLOCK, nBestHeight);
         }
     }
 }
@@ -173,9 +287,31 @@ void CChainLocksDb::RemoveAboveHeight(int nHeight)
 CChainLocksManager::CChainLocksManager(
     CSigningManager& _signingManager,
     CQuorumManager& _quorumManager)
-    : signingManager(_signingManager)
+    : db(evoDb.get())
+    , signingManager(_signingManager)
     , quorumManager(_quorumManager)
 {
+    // Pick up where the last run left off, locks at or below the best one
+    // are then not verified again
+    LOCK(cs);
+    if (db.GetBestChainLockHeight() > 0) {
+        db.GetChainLock(db.GetBestChainLockHeight(), bestChainLock);
+        ResolveBestChainLockBlock();
+    }
+}
+
+void CChainLocksManager::ResolveBestChainLockBlock()
+{
+    AssertLockHeld(cs);
+    
+    if (bestChainLock.IsNull() || bestChainLockBlockIndex.load()) {
+        return;
+    }
+    LOCK(cs_main);
+    BlockMap::iterator it = mapBlockIndex.find(bestChainLock.blockHash);
+    if (it != mapBlockIndex.end() && it->second->nHeight == bestChainLock.nHeight) {
+        bestChainLockBlockIndex.store(it->second);
+    }
 }
 
 void CChainLocksManager::ProcessNewBlock(const CBlock& block, const CBlockIndex* pindex)
@@ -206,8 +342,8 @@ bool CChainLocksManager::TrySignChainLock(const CBlockIndex* pindex)
         return false;
     }
     
-    // Already have a lock at this height?
-    if (db.IsChainLocked(pindex->nHeight)) {
+    // Already final at this height?
+    if (pindex->nHeight <= db.GetBestChainLockHeight()) {
         return true;
     }
     
@@ -248,36 +384,94 @@ bool CChainLocksManager::TrySignChainLock(const CBlockIndex* pindex)
     return true;
 }
 
-bool CChainLocksManager::ProcessChainLock(const CChainLockSig& clsig, CValidationState& state)
+bool CChainLocksManager::PreVerifyChainLock(const CChainLockSig& clsig, CValidationState& state) const
 {
     LOCK(cs);
     
     // Already have it?
-    if (db.HasChainLock(clsig.blockHash)) {
-        return true;
+    if (db.HasChainLock(clsig.nHeight, clsig.blockHash)) {
+        return false;
     }
     
-    // Validate height is increasing
+    // Validate height is increasing. A lock at or below the best one is
+    // implied by it and not verified again; it only has to agree with it.
     int currentBest = db.GetBestChainLockHeight();
     if (clsig.nHeight <= currentBest) {
-        // Allow same height only if same hash
-        CChainLockSig existing;
-        if (db.GetChainLock(clsig.nHeight, existing)) {
-            if (existing.blockHash != clsig.blockHash) {
-                // Conflict! This should not happen with honest quorum
-                LogPrintf("CChainLocksManager::%s -- CONFLICT at height %d!\n",
-                          __func__, clsig.nHeight);
-                return state.DoS(100, false, REJECT_DUPLICATE, "chainlock-conflict");
-            }
+        const CBlockIndex* pindexBest = bestChainLockBlockIndex.load();
+        const CBlockIndex* pindexLocked = pindexBest ? pindexBest->GetAncestor(clsig.nHeight) : nullptr;
+        if (pindexLocked && pindexLocked->GetBlockHash() != clsig.blockHash) {
+            // Conflict! This should not happen with honest quorum
+            LogPrintf("CChainLocksManager::%s -- CONFLICT at height %d!\n",
+                      __func__, clsig.nHeight);
+            return state.DoS(100, false, REJECT_DUPLICATE, "chainlock-conflict");
         }
-        return true; // Already have it
+        return false; // Already final
+    }
+    
+    return true;
+}
+
+bool CChainLocksManager::ProcessChainLock(const CChainLockSig& clsig, CValidationState& state)
+{
+    if (!PreVerifyChainLock(clsig, state)) {
+        return state.IsValid();
     }
     
-    // Verify signature
+    // Verify signature (no cs held, the pairing can be slow)
     if (!VerifyChainLock(clsig)) {
         return state.DoS(100, false, REJECT_INVALID, "bad-chainlock-sig");
     }
     
+    return ProcessVerifiedChainLock(clsig, state);
+}
+
+void CChainLocksManager::AsyncProcessChainLock(const CChainLockSig& clsig)
+{
+    CValidationState state;
+    if (!PreVerifyChainLock(clsig, state)) {
+        return;
+    }
+    
+    CQuorumCPtr quorum = SelectQuorumForChainLock(clsig);
+    if (!quorum || !quorum->IsValid() || !clsig.sig.IsValid()) {
+        LogPrint(BCLog::LLMQ, "CChainLocksManager::%s -- No valid quorum or signature for %s\n",
+                 __func__, clsig.ToString());
+        return;
+    }
+    
+    // Every peer announces the new ChainLock; verify it once
+    {
+        LOCK(cs);
+        if (!seenChainLocks.insert(clsig.GetHash()).second) {
+            return;
+        }
+    }
+    
+    blsWorker.AsyncVerifySig(clsig.sig, quorum->quorumPublicKey, clsig.GetSignHash(),
+        [this, clsig](bool fValid) {
+            if (!fValid) {
+                LogPrintf("CChainLocksManager::%s -- Signature verification failed for %s\n",
+                          __func__, clsig.ToString());
+                return;
+            }
+            CValidationState state;
+            if (!ProcessVerifiedChainLock(clsig, state)) {
+                LogPrint(BCLog::LLMQ, "CChainLocksManager::%s -- Rejected %s: %s\n",
+                         __func__, clsig.ToString(), FormatStateMessage(state));
+            }
+        });
+}
+
+bool CChainLocksManager::ProcessVerifiedChainLock(const CChainLockSig& clsig, CValidationState& state)
+{
+    LOCK(cs);
+    
+    // Re-check under cs: another lock may have been accepted while this
+    // one was being verified
+    if (!PreVerifyChainLock(clsig, state)) {
+        return state.IsValid();
+    }
+    
     // Verify block exists in our chain
     LOCK(cs_main);
     BlockMap::iterator it = mapBlockIndex.find(clsig.blockHash);
@@ -302,14 +496,26 @@ bool CChainLocksManager::ProcessChainLock(const CChainLockSig& clsig, CValidatio
     
     // Update best
     bestChainLock = clsig;
-    bestChainLockBlockIndex = pindex;
+    bestChainLockBlockIndex.store(pindex);
     
-    // Remove from pending
-    pendingChainLocks.erase(clsig.nHeight);
-    signingHeights.erase(clsig.nHeight);
+    // Everything pending or being signed at or below the lock is final now
+    pendingChainLocks.erase(pendingChainLocks.begin(), pendingChainLocks.upper_bound(clsig.nHeight));
+    signingHeights.erase(signingHeights.begin(), signingHeights.upper_bound(clsig.nHeight));
     
     LogPrintf("CChainLocksManager::%s -- Processed ChainLock: %s\n", __func__, clsig.ToString());
     
+    // InstantSend locks of transactions in the locked chain are not needed anymore
+    if (instantSendManager && chainActive.Contains(pindex)) {
+        instantSendManager->NotifyChainLock(pindex);
+    }
+    
+    if (g_connman) {
+        CInv inv(MSG_CLSIG, clsig.GetHash());
+        g_connman->ForEachNode([&inv](CNode* pnode) {
+            pnode->PushInventory(inv);
+        });
+    }
+    
     return true;
 }
 
@@ -319,22 +525,29 @@ bool CChainLocksManager::IsChainLockActive() const
     return chainActive.Height() >= CHAINLOCK_ACTIVATION_HEIGHT;
 }
 
+// These are on the validation path and take no lock: the best locked block
+// is read once, and the window is read through its sequence counters
+
 bool CChainLocksManager::IsChainLocked(int nHeight) const
 {
-    LOCK(cs);
-    return db.IsChainLocked(nHeight);
+    const CBlockIndex* pindexBest = bestChainLockBlockIndex.load();
+    return pindexBest && nHeight <= pindexBest->nHeight;
 }
 
 bool CChainLocksManager::HasChainLock(const uint256& blockHash) const
 {
-    LOCK(cs);
     return db.HasChainLock(blockHash);
 }
 
 bool CChainLocksManager::HasChainLock(const CBlockIndex* pindex) const
 {
     if (!pindex) return false;
-    return HasChainLock(pindex->GetBlockHash());
+    if (db.HasChainLock(pindex->nHeight, pindex->GetBlockHash())) {
+        return true;
+    }
+    // The locked block and all its ancestors are final
+    const CBlockIndex* pindexBest = bestChainLockBlockIndex.load();
+    return pindexBest && pindexBest->GetAncestor(pindex->nHeight) == pindex;
 }
 
 CChainLockSig CChainLocksManager::GetBestChainLock() const
@@ -343,9 +556,24 @@ CChainLockSig CChainLocksManager::GetBestChainLock() const
     return bestChainLock;
 }
 
-int CChainLocksManager::GetBestChainLockHeight() const
+bool CChainLocksManager::GetChainLockByHash(const uint256& hash, CChainLockSig& clsigOut) const
 {
     LOCK(cs);
+    if (bestChainLock.IsNull() || bestChainLock.GetHash() != hash) {
+        return false;
+    }
+    clsigOut = bestChainLock;
+    return true;
+}
+
+bool CChainLocksManager::AlreadyHave(const uint256& hash) const
+{
+    LOCK(cs);
+    return seenChainLocks.count(hash) || (!bestChainLock.IsNull() && bestChainLock.GetHash() == hash);
+}
+
+int CChainLocksManager::GetBestChainLockHeight() const
+{
     return db.GetBestChainLockHeight();
 }
 
@@ -375,12 +603,8 @@ bool CChainLocksManager::CanReorg(const CBlockIndex* pindexNew, const CBlockInde
     return true;
 }
 
-bool CChainLocksManager::VerifyChainLock(const CChainLockSig& clsig) const
+CQuorumCPtr CChainLocksManager::SelectQuorumForChainLock(const CChainLockSig& clsig) const
 {
-    if (!clsig.sig.IsValid()) {
-        return false;
-    }
-    
     // Get the quorum for this height
     LOCK(cs_main);
     const CBlockIndex* pindex = chainActive[clsig.nHeight - 1];
@@ -389,8 +613,17 @@ bool CChainLocksManager::VerifyChainLock(const CChainLockSig& clsig) const
         pindex = chainActive.Tip();
     }
     
-    auto quorum = quorumManager.SelectQuorumForSigning(
+    return quorumManager.SelectQuorumForSigning(
         CHAINLOCK_QUORUM_TYPE, pindex, clsig.GetRequestId());
+}
+
+bool CChainLocksManager::VerifyChainLock(const CChainLockSig& clsig) const
+{
+    if (!clsig.sig.IsValid()) {
+        return false;
+    }
+    
+    auto quorum = SelectQuorumForChainLock(clsig);
     
     if (!quorum || !quorum->IsValid()) {
         LogPrintf("CChainLocksManager::%s -- No valid quorum for ChainLock\n", __func__);
@@ -430,19 +663,26 @@ void CChainLocksManager::UpdatedBlockTip(const CBlockIndex* pindex)
 {
     LOCK(cs);
     
-    // Process any pending ChainLocks for blocks we now have
-    for (auto it = pendingChainLocks.begin(); it != pendingChainLocks.end(); ) {
+    ResolveBestChainLockBlock();
+    
+    // Process any pending ChainLocks for blocks we now have. Their signatures
+    // were verified before they were queued, and processing one prunes the
+    // queue, so work on a copy.
+    std::vector<CChainLockSig> vReady;
+    {
         LOCK(cs_main);
-        BlockMap::iterator blockIt = mapBlockIndex.find(it->second.blockHash);
-        const CBlockIndex* blockIndex = (blockIt != mapBlockIndex.end()) ? blockIt->second : nullptr;
-        if (blockIndex && blockIndex->nHeight == it->second.nHeight) {
-            CValidationState state;
-            ProcessChainLock(it->second, state);
-            it = pendingChainLocks.erase(it);
-        } else {
-            ++it;
+        for (const auto& entry : pendingChainLocks) {
+            BlockMap::iterator blockIt = mapBlockIndex.find(entry.second.blockHash);
+            if (blockIt != mapBlockIndex.end() && blockIt->second->nHeight == entry.first) {
+                vReady.push_back(entry.second);
+            }
         }
     }
+    for (const auto& clsig : vReady) {
+        pendingChainLocks.erase(clsig.nHeight);
+        CValidationState state;
+        ProcessVerifiedChainLock(clsig, state);
+    }
     
     // Try to sign new tip
     if (pindex && pindex->nHeight >= CHAINLOCK_ACTIVATION_HEIGHT) {
@@ -467,6 +707,9 @@ void CChainLocksManager::Cleanup()
     
     lastCleanupHeight = currentHeight;
     
+    // Anything seen this long ago is below the best ChainLock by now
+    seenChainLocks.clear();
+    
     // Remove old signing heights
     for (auto it = signingHeights.begin(); it != signingHeights.end(); ) {
         if (*it < currentHeight - 100) {
@@ -542,18 +785,13 @@ bool CheckAgainstChainLocks(const CBlockIndex* pindex, CValidationState& state)
         return true;
     }
     
-    // Check if this block conflicts with a ChainLock
-    CChainLockSig clsig;
-    if (chainLocksManager->IsChainLocked(pindex->nHeight)) {
-        // Get the ChainLock for this height
-        // If the block hash doesn't match, reject
-        // (This would require getting the lock and comparing)
-        
-        // For now, if we have a ChainLock at this height, the block
-        // must match - otherwise it would have been rejected earlier
+    // Above the best ChainLock nothing is final yet, and at or below it
+    // only the locked block's ancestors are; anything else conflicts
+    if (!chainLocksManager->IsChainLocked(pindex->nHeight) || chainLocksManager->HasChainLock(pindex)) {
+        return true;
     }
-    
-    return true;
+    return state.DoS(10, error("%s: block %s conflicts with a ChainLock", __func__, pindex->GetBlockHash().ToString()),
+                     REJECT_INVALID, "bad-chainlock");
 }
 
 } // namespace llmq
@@ -10,12 +10,15 @@
 #include "sync.h"
 #include "uint256.h"
 
+#include <array>
+#include <atomic>
 #include <map>
 #include <memory>
 #include <set>
 
 class CBlock;
 class CBlockIndex;
+class CEvoDB;
 class CValidationState;
 
 namespace llmq {
@@ -46,6 +49,9 @@ static const LLMQType CHAINLOCK_QUORUM_TYPE = LLMQType::LLMQ_400_60;
 // Minimum height before ChainLocks activate
 static const int CHAINLOCK_ACTIVATION_HEIGHT = 1000;
 
+// Heights below the best ChainLock whose locks are kept, in memory and on disk
+static const int CHAINLOCK_WINDOW_SIZE = 64;
+
 /**
  * CChainLockSig - A ChainLock signature
  */
@@ -94,24 +100,47 @@ public:
 
 /**
  * CChainLocksDb - Persistent storage for ChainLocks
+ *
+ * A ChainLock makes its block and all the block's ancestors final, so only
+ * the best lock and the ones within CHAINLOCK_WINDOW_SIZE heights below it
+ * are kept. They are written to the evo database, if given one, and loaded
+ * from it on start, so a restarted node doesn't verify them again.
+ *
+ * The window is mirrored in a ring of slots indexed by height, each slot
+ * guarded by a sequence counter, so HasChainLock(height, hash) and the best
+ * height are read without taking cs. Writers are serialized by cs.
  */
 class CChainLocksDb
 {
 private:
     mutable CCriticalSection cs;
     
-    // ChainLocks by height
-    std::map<int, CChainLockSig> locksByHeight;
+    CEvoDB* pevodb;
     
-    // ChainLocks by block hash
-    std::map<uint256, CChainLockSig> locksByHash;
+    // ChainLocks in the window, by height
+    std::map<int, CChainLockSig> locksByHeight;
     
     // Best ChainLock height
-    int bestChainLockHeight{0};
+    std::atomic<int> bestChainLockHeight{0};
     uint256 bestChainLockHash;
+    
+    struct CWindowSlot {
+        // Odd while the slot is being written
+        std::atomic<uint32_t> nSequence{0};
+        std::atomic<int> nHeight{-1};
+        std::array<std::atomic<uint64_t>, 4> blockHash;
+    };
+    
+    std::array<CWindowSlot, CHAINLOCK_WINDOW_SIZE> window;
+    
+    void SetSlot(int nHeight, const uint256& blockHash);
+    void ClearSlot(int nHeight);
+    
+    // Drop the locks that fell out of the window below the best one
+    void PruneWindow();
 
 public:
-    CChainLocksDb() = default;
+    explicit CChainLocksDb(CEvoDB* pevodbIn = nullptr);
     
     // Write a ChainLock
     bool WriteChainLock(const CChainLockSig& clsig);
@@ -125,9 +154,11 @@ public:
     // Check if a block is ChainLocked
     bool IsChainLocked(int nHeight) const;
     bool HasChainLock(const uint256& blockHash) const;
+    // Whether the window holds a lock of blockHash at nHeight, without locking
+    bool HasChainLock(int nHeight, const uint256& blockHash) const;
     
     // Get best ChainLock
-    int GetBestChainLockHeight() const;
+    int GetBestChainLockHeight() const { return bestChainLockHeight.load(std::memory_order_acquire); }
     uint256 GetBestChainLockHash() const;
     
     // Remove ChainLocks above a certain height (for cleanup)
@@ -151,9 +182,10 @@ private:
     // Our node's proTxHash
     uint256 myProTxHash;
     
-    // Best known ChainLock
+    // Best known ChainLock. Its block index is read without cs: block
+    // indexes are never freed, and it and its ancestors never change.
     CChainLockSig bestChainLock;
-    const CBlockIndex* bestChainLockBlockIndex{nullptr};
+    std::atomic<const CBlockIndex*> bestChainLockBlockIndex{nullptr};
     
     // Pending ChainLock signatures being collected
     std::map<int, CChainLockSig> pendingChainLocks;
@@ -161,6 +193,9 @@ private:
     // Block heights we're trying to sign
     std::set<int> signingHeights;
     
+    // Hashes of ChainLocks received from peers since the last cleanup
+    std::set<uint256> seenChainLocks;
+    
     // Last cleanup height
     int lastCleanupHeight{0};
 
@@ -179,16 +214,25 @@ public:
     // Process a received ChainLock
     bool ProcessChainLock(const CChainLockSig& clsig, CValidationState& state);
     
+    // Process a received ChainLock, verifying its signature on the BLS worker
+    void AsyncProcessChainLock(const CChainLockSig& clsig);
+    
     // Check if ChainLocks are enabled at this height
     bool IsChainLockActive() const;
     
-    // Check if a block is ChainLocked
+    // Check if the chain is final up to nHeight, or pindex is the ChainLocked
+    // block or one of its ancestors
     bool IsChainLocked(int nHeight) const;
     bool HasChainLock(const uint256& blockHash) const;
     bool HasChainLock(const CBlockIndex* pindex) const;
     
     // Get the best ChainLock
     CChainLockSig GetBestChainLock() const;
+    // Only the best ChainLock is served to peers, older ones are outdated
+    bool GetChainLockByHash(const uint256& hash, CChainLockSig& clsigOut) const;
+    
+    // Whether the ChainLock announced as hash was already received
+    bool AlreadyHave(const uint256& hash) const;
     int GetBestChainLockHeight() const;
     
     // Check if a block can be reorganized away
@@ -219,6 +263,19 @@ private:
     
     // Select quorum for ChainLock at given height
     CQuorumCPtr SelectQuorum(const CBlockIndex* pindex) const;
+    
+    // Select the quorum a received ChainLock must be signed by
+    CQuorumCPtr SelectQuorumForChainLock(const CChainLockSig& clsig) const;
+    
+    // Cheap checks before signature verification; returns false if the
+    // ChainLock needs no further processing (state is invalid on conflict)
+    bool PreVerifyChainLock(const CChainLockSig& clsig, CValidationState& state) const;
+    
+    // Store a ChainLock whose signature has already been verified
+    bool ProcessVerifiedChainLock(const CChainLockSig& clsig, CValidationState& state);
+    
+    // Find the block of a best ChainLock loaded from disk once it is known
+    void ResolveBestChainLockBlock();
 };
 
 // Global instance
@@ -3,6 +3,7 @@
 // file COPYING or http://www.opensource.org/licenses/mit-license.php.
 
 #include "llmq/instantsend.h"
+#include "bls/bls_worker.h"
 #include "chain.h"
 #include "chainparams.h"
 #include "consensus/validation.h"
@@ -69,95 +70,197 @@ std::string CInstantSendLock::ToString() const
 // CInstantSendDb Implementation
 // ============================================================================
 
+static const char DB_ISLOCK = 'l';
+static const char DB_ISLOCK_MINED = 'm';
+
+/** Key of a mined lock, ordered by height so that pruning walks them oldest first */
+struct CMinedLockKey
+{
+    uint32_t nHeight;
+    uint256 hash;
+
+    CMinedLockKey() : nHeight(0) {}
+    CMinedLockKey(int nHeightIn, const uint256& hashIn) : nHeight(nHeightIn), hash(hashIn) {}
+
+    template <typename Stream>
+    void Serialize(Stream& s) const
+    {
+        ser_writedata32be(s, nHeight);
+        hash.Serialize(s);
+    }
+
+    template <typename Stream>
+    void Unserialize(Stream& s)
+    {
+        nHeight = ser_readdata32be(s);
+        hash.Unserialize(s);
+    }
+};
+
+CInstantSendDb::CInstantSendDb(size_t nCacheSize, bool fMemory, bool fWipe)
+    : db(GetDataDir() / "islocks", nCacheSize, fMemory, fWipe)
+{
+    std::unique_ptr<CDBIterator> pcursor(db.NewIterator());
+    pcursor->Seek(std::make_pair(DB_ISLOCK, uint256()));
+    size_t nLoaded = 0;
+    while (pcursor->Valid()) {
+        std::pair<char, uint256> key;
+        auto islock = std::make_shared<CInstantSendLock>();
+        if (!pcursor->GetKey(key) || key.first != DB_ISLOCK || !pcursor->GetValue(*islock)) {
+            break;
+        }
+        AddToIndexes(islock);
+        nLoaded++;
+        pcursor->Next();
+    }
+    LogPrint(BCLog::LLMQ, "CInstantSendDb::%s -- Loaded %u locks\n", __func__, nLoaded);
+}
+
+void CInstantSendDb::AddToIndexes(const CInstantSendLockPtr& islock)
+{
+    const uint256 hash = islock->GetHash();
+    {
+        auto& shard = GetShard(hash);
+        boost::unique_lock<boost::shared_mutex> lock(shard.cs);
+        shard.locksByHash[hash] = islock;
+    }
+    {
+        auto& shard = GetShard(islock->txid);
+        boost::unique_lock<boost::shared_mutex> lock(shard.cs);
+        shard.locksByTxid[islock->txid] = islock;
+    }
+    for (const auto& input : islock->inputs) {
+        auto& shard = GetShard(input.hash);
+        boost::unique_lock<boost::shared_mutex> lock(shard.cs);
+        shard.locksByInput[input] = islock;
+    }
+}
+
+void CInstantSendDb::RemoveFromIndexes(const CInstantSendLockPtr& islock)
+{
+    // Inputs first, a lock found by hash or txid is never missing its inputs
+    for (const auto& input : islock->inputs) {
+        auto& shard = GetShard(input.hash);
+        boost::unique_lock<boost::shared_mutex> lock(shard.cs);
+        auto it = shard.locksByInput.find(input);
+        if (it != shard.locksByInput.end() && it->second == islock) {
+            shard.locksByInput.erase(it);
+        }
+    }
+    {
+        auto& shard = GetShard(islock->txid);
+        boost::unique_lock<boost::shared_mutex> lock(shard.cs);
+        auto it = shard.locksByTxid.find(islock->txid);
+        if (it != shard.locksByTxid.end() && it->second == islock) {
+            shard.locksByTxid.erase(it);
+        }
+    }
+    const uint256 hash = islock->GetHash();
+    auto& shard = GetShard(hash);
+    boost::unique_lock<boost::shared_mutex> lock(shard.cs);
+    shard.locksByHash.erase(hash);
+}
+
 bool CInstantSendDb::WriteLock(const CInstantSendLock& islock)
 {
     LOCK(cs);
     
-    uint256 hash = islock.GetHash();
-    
-    // Store lock
-    locksById[hash] = islock;
-    txidToLockHash[islock.txid] = hash;
-    
-    // Index inputs
-    for (const auto& input : islock.inputs) {
-        inputLocks[input] = hash;
+    auto islockPtr = std::make_shared<const CInstantSendLock>(islock);
+    if (!db.Write(std::make_pair(DB_ISLOCK, islockPtr->GetHash()), *islockPtr)) {
+        return false;
     }
+    AddToIndexes(islockPtr);
     
     LogPrintf("CInstantSendDb::%s -- Wrote lock: %s\n", __func__, islock.ToString());
     return true;
 }
 
+CInstantSendLockPtr CInstantSendDb::GetLock(const uint256& hash) const
+{
+    const auto& shard = GetShard(hash);
+    boost::shared_lock<boost::shared_mutex> lock(shard.cs);
+    auto it = shard.locksByHash.find(hash);
+    return it == shard.locksByHash.end() ? nullptr : it->second;
+}
+
 bool CInstantSendDb::GetLock(const uint256& hash, CInstantSendLock& islockOut) const
 {
-    LOCK(cs);
-    
-    auto it = locksById.find(hash);
-    if (it == locksById.end()) {
+    auto islock = GetLock(hash);
+    if (!islock) {
         return false;
     }
-    
-    islockOut = it->second;
+    islockOut = *islock;
     return true;
 }
 
+CInstantSendLockPtr CInstantSendDb::GetLockByTxid(const uint256& txid) const
+{
+    const auto& shard = GetShard(txid);
+    boost::shared_lock<boost::shared_mutex> lock(shard.cs);
+    auto it = shard.locksByTxid.find(txid);
+    return it == shard.locksByTxid.end() ? nullptr : it->second;
+}
+
 bool CInstantSendDb::GetLockByTxid(const uint256& txid, CInstantSendLock& islockOut) const
 {
-    LOCK(cs);
-    
-    auto it = txidToLockHash.find(txid);
-    if (it == txidToLockHash.end()) {
+    auto islock = GetLockByTxid(txid);
+    if (!islock) {
         return false;
     }
-    
-    return GetLock(it->second, islockOut);
+    islockOut = *islock;
+    return true;
 }
 
 bool CInstantSendDb::IsInputLocked(const COutPoint& outpoint) const
 {
-    LOCK(cs);
-    return inputLocks.count(outpoint) > 0;
+    return GetLockForInput(outpoint) != nullptr;
 }
 
 bool CInstantSendDb::IsTxLocked(const uint256& txid) const
 {
-    LOCK(cs);
-    return txidToLockHash.count(txid) > 0;
+    return GetLockByTxid(txid) != nullptr;
+}
+
+CInstantSendLockPtr CInstantSendDb::GetLockForInput(const COutPoint& outpoint) const
+{
+    const auto& shard = GetShard(outpoint.hash);
+    boost::shared_lock<boost::shared_mutex> lock(shard.cs);
+    auto it = shard.locksByInput.find(outpoint);
+    return it == shard.locksByInput.end() ? nullptr : it->second;
 }
 
 bool CInstantSendDb::GetLockForInput(const COutPoint& outpoint, CInstantSendLock& islockOut) const
 {
-    LOCK(cs);
-    
-    auto it = inputLocks.find(outpoint);
-    if (it == inputLocks.end()) {
+    auto islock = GetLockForInput(outpoint);
+    if (!islock) {
         return false;
     }
+    islockOut = *islock;
+    return true;
+}
+
+CInstantSendLockPtr CInstantSendDb::RemoveLock(const uint256& hash, CDBBatch& batch)
+{
+    AssertLockHeld(cs);
     
-    return GetLock(it->second, islockOut);
+    auto islock = GetLock(hash);
+    if (!islock) {
+        return nullptr;
+    }
+    RemoveFromIndexes(islock);
+    batch.Erase(std::make_pair(DB_ISLOCK, hash));
+    return islock;
 }
 
 void CInstantSendDb::RemoveLock(const uint256& hash)
 {
     LOCK(cs);
     
-    auto it = locksById.find(hash);
-    if (it == locksById.end()) {
+    CDBBatch batch(db);
+    if (!RemoveLock(hash, batch)) {
         return;
     }
-    
-    const CInstantSendLock& islock = it->second;
-    
-    // Remove input index
-    for (const auto& input : islock.inputs) {
-        inputLocks.erase(input);
-    }
-    
-    // Remove txid mapping
-    txidToLockHash.erase(islock.txid);
-    
-    // Remove lock
-    locksById.erase(it);
+    db.WriteBatch(batch);
     
     LogPrintf("CInstantSendDb::%s -- Removed lock: %s\n", __func__, hash.ToString().substr(0, 16));
 }
@@ -166,21 +269,75 @@ void CInstantSendDb::RemoveLocksForTxids(const std::set<uint256>& txids)
 {
     LOCK(cs);
     
+    CDBBatch batch(db);
     for (const auto& txid : txids) {
-        auto it = txidToLockHash.find(txid);
-        if (it != txidToLockHash.end()) {
-            RemoveLock(it->second);
+        auto islock = GetLockByTxid(txid);
+        if (islock) {
+            RemoveLock(islock->GetHash(), batch);
         }
     }
+    db.WriteBatch(batch);
 }
 
-std::set<COutPoint> CInstantSendDb::GetAllLockedOutpoints() const
+void CInstantSendDb::WriteLocksMined(const std::vector<uint256>& hashes, int nHeight)
 {
     LOCK(cs);
+    CDBBatch batch(db);
+    for (const auto& hash : hashes) {
+        batch.Write(std::make_pair(DB_ISLOCK_MINED, CMinedLockKey(nHeight, hash)), '\0');
+    }
+    db.WriteBatch(batch);
+}
+
+void CInstantSendDb::RemoveLocksMined(const std::vector<uint256>& hashes, int nHeight)
+{
+    LOCK(cs);
+    CDBBatch batch(db);
+    for (const auto& hash : hashes) {
+        batch.Erase(std::make_pair(DB_ISLOCK_MINED, CMinedLockKey(nHeight, hash)));
+    }
+    db.WriteBatch(batch);
+}
+
+size_t CInstantSendDb::RemoveConfirmedLocks(int nUntilHeight)
+{
+    LOCK(cs);
+    
+    if (nUntilHeight < 0) {
+        return 0;
+    }
     
+    CDBBatch batch(db);
+    size_t nRemoved = 0;
+    std::unique_ptr<CDBIterator> pcursor(db.NewIterator());
+    pcursor->Seek(std::make_pair(DB_ISLOCK_MINED, CMinedLockKey()));
+    while (pcursor->Valid()) {
+        std::pair<char, CMinedLockKey> key;
+        if (!pcursor->GetKey(key) || key.first != DB_ISLOCK_MINED || key.second.nHeight > (uint32_t)nUntilHeight) {
+            break;
+        }
+        batch.Erase(key);
+        if (RemoveLock(key.second.hash, batch)) {
+            nRemoved++;
+        }
+        if (batch.SizeEstimate() > INSTANTSEND_PRUNE_BATCH_SIZE) {
+            db.WriteBatch(batch);
+            batch.Clear();
+        }
+        pcursor->Next();
+    }
+    db.WriteBatch(batch);
+    return nRemoved;
+}
+
+std::set<COutPoint> CInstantSendDb::GetAllLockedOutpoints() const
+{
     std::set<COutPoint> result;
-    for (const auto& [outpoint, hash] : inputLocks) {
-        result.insert(outpoint);
+    for (const auto& shard : shards) {
+        boost::shared_lock<boost::shared_mutex> lock(shard.cs);
+        for (const auto& entry : shard.locksByInput) {
+            result.insert(entry.first);
+        }
     }
     return result;
 }
@@ -191,8 +348,10 @@ std::set<COutPoint> CInstantSendDb::GetAllLockedOutpoints() const
 
 CInstantSendManager::CInstantSendManager(
     CSigningManager& _signingManager,
-    CQuorumManager& _quorumManager)
-    : signingManager(_signingManager)
+    CQuorumManager& _quorumManager,
+    bool fMemoryDb)
+    : db(INSTANTSEND_DB_CACHE_SIZE, fMemoryDb)
+    , signingManager(_signingManager)
     , quorumManager(_quorumManager)
 {
 }
@@ -271,42 +430,97 @@ bool CInstantSendManager::TrySignInstantSendLock(const CTransactionRef& tx)
 
 bool CInstantSendManager::ProcessInstantSendLock(const CInstantSendLock& islock, CValidationState& state)
 {
-    LOCK(cs);
-    
     // Already have it?
-    if (db.IsTxLocked(islock.txid)) {
+    if (IsLocked(islock.txid)) {
         return true;
     }
     
-    // Verify signature
+    // Verify signature (no cs held, the pairing can be slow)
     if (!VerifyInstantSendLock(islock)) {
         return state.DoS(100, false, REJECT_INVALID, "bad-islock-sig");
     }
     
-    // Check for conflicts
-    for (const auto& input : islock.inputs) {
-        if (db.IsInputLocked(input)) {
-            CInstantSendLock existingLock;
-            if (db.GetLockForInput(input, existingLock)) {
-                if (existingLock.txid != islock.txid) {
-                    // Conflict! This should not happen with honest quorum
-                    LogPrintf("CInstantSendManager::%s -- CONFLICT! Input already locked by different TX\n", __func__);
-                    return state.DoS(100, false, REJECT_DUPLICATE, "islock-conflict");
-                }
-            }
-        }
+    return ProcessVerifiedInstantSendLock(islock, state);
+}
+
+void CInstantSendManager::AsyncProcessInstantSendLock(const CInstantSendLock& islock)
+{
+    if (IsLocked(islock.txid) || !islock.sig.IsValid()) {
+        return;
     }
     
-    // Store the lock
-    if (!db.WriteLock(islock)) {
-        return false;
+    auto quorum = GetLockQuorum(islock);
+    if (!quorum) {
+        return;
     }
     
-    // Remove from pending
-    pendingTxs.erase(islock.txid);
-    pendingRequests.erase(islock.txid);
+    // Several peers announce the same lock; verify it once
+    const uint256 hash = islock.GetHash();
+    {
+        LOCK(cs);
+        if (!verifyingLocks.insert(hash).second) {
+            return;
+        }
+    }
     
-    LogPrintf("CInstantSendManager::%s -- Processed lock: %s\n", __func__, islock.ToString());
+    blsWorker.AsyncVerifySig(islock.sig, quorum->quorumPublicKey, islock.GetSignHash(),
+        [this, islock, hash](bool fValid) {
+            {
+                LOCK(cs);
+                verifyingLocks.erase(hash);
+            }
+            if (!fValid) {
+                LogPrintf("CInstantSendManager::%s -- Signature verification failed for %s\n",
+                          __func__, islock.ToString());
+                return;
+            }
+            CValidationState state;
+            if (!ProcessVerifiedInstantSendLock(islock, state)) {
+                LogPrint(BCLog::LLMQ, "CInstantSendManager::%s -- Rejected %s: %s\n",
+                         __func__, islock.ToString(), FormatStateMessage(state));
+            }
+        });
+}
+
+bool CInstantSendManager::ProcessVerifiedInstantSendLock(const CInstantSendLock& islock, CValidationState& state)
+{
+    {
+        LOCK(cs);
+    
+        // Another copy may have been accepted while this one was being verified
+        if (db.IsTxLocked(islock.txid)) {
+            return true;
+        }
+    
+        // Check for conflicts
+        for (const auto& input : islock.inputs) {
+            auto existingLock = db.GetLockForInput(input);
+            if (existingLock && existingLock->txid != islock.txid) {
+                // Conflict! This should not happen with honest quorum
+                LogPrintf("CInstantSendManager::%s -- CONFLICT! Input already locked by different TX\n", __func__);
+                return state.DoS(100, false, REJECT_DUPLICATE, "islock-conflict");
+            }
+        }
+    
+        // Store the lock
+        if (!db.WriteLock(islock)) {
+            return false;
+        }
+    
+        // Remove from pending
+        pendingTxs.erase(islock.txid);
+        pendingRequests.erase(islock.txid);
+    
+        LogPrintf("CInstantSendManager::%s -- Processed lock: %s\n", __func__, islock.ToString());
+    }
+    
+    // Announce outside cs, peers fetch the lock with getdata
+    if (g_connman) {
+        CInv inv(MSG_ISLOCK, islock.GetHash());
+        g_connman->ForEachNode([&inv](CNode* pnode) {
+            pnode->PushInventory(inv);
+        });
+    }
     
     return true;
 }
@@ -343,16 +557,12 @@ bool CInstantSendManager::CanTxBeLocked(const CTransactionRef& tx) const
 
 bool CInstantSendManager::HasConflictingLock(const CTransaction& tx) const
 {
-    LOCK(cs);
-    
+    // One probe per input on the db's sharded index, without cs
+    const uint256& txid = tx.GetHash();
     for (const auto& txin : tx.vin) {
-        if (db.IsInputLocked(txin.prevout)) {
-            CInstantSendLock existingLock;
-            if (db.GetLockForInput(txin.prevout, existingLock)) {
-                if (existingLock.txid != tx.GetHash()) {
-                    return true;
-                }
-            }
+        auto existingLock = db.GetLockForInput(txin.prevout);
+        if (existingLock && existingLock->txid != txid) {
+            return true;
         }
     }
     
@@ -361,16 +571,28 @@ bool CInstantSendManager::HasConflictingLock(const CTransaction& tx) const
 
 bool CInstantSendManager::IsLocked(const uint256& txid) const
 {
-    LOCK(cs);
     return db.IsTxLocked(txid);
 }
 
 bool CInstantSendManager::GetInstantSendLock(const uint256& txid, CInstantSendLock& islockOut) const
 {
-    LOCK(cs);
     return db.GetLockByTxid(txid, islockOut);
 }
 
+bool CInstantSendManager::GetInstantSendLockByHash(const uint256& hash, CInstantSendLock& islockOut) const
+{
+    return db.GetLock(hash, islockOut);
+}
+
+bool CInstantSendManager::AlreadyHave(const uint256& hash) const
+{
+    if (db.GetLock(hash)) {
+        return true;
+    }
+    LOCK(cs);
+    return verifyingLocks.count(hash) > 0;
+}
+
 bool CInstantSendManager::CheckCanLock(const CTransaction& tx, bool printDebug) const
 {
     if (!IsInstantSendEnabled()) {
@@ -404,12 +626,21 @@ bool CInstantSendManager::CheckCanLock(const CTransaction& tx, bool printDebug)
 
 bool CInstantSendManager::ProcessBlock(const CBlock& block, const CBlockIndex* pindex)
 {
-    LOCK(cs);
+    // Note the height the locked transactions were mined at, so their locks
+    // can be pruned, in one write. The lock index is read without cs.
+    std::vector<uint256> vLockHashes;
+    GetBlockLockHashes(block, vLockHashes);
+    if (!vLockHashes.empty()) {
+        db.WriteLocksMined(vLockHashes, pindex->nHeight);
+    }
     
     // Remove pending requests for included transactions
-    for (const auto& tx : block.vtx) {
-        pendingTxs.erase(tx->GetHash());
-        pendingRequests.erase(tx->GetHash());
+    LOCK(cs);
+    if (!pendingTxs.empty() || !pendingRequests.empty()) {
+        for (const auto& tx : block.vtx) {
+            pendingTxs.erase(tx->GetHash());
+            pendingRequests.erase(tx->GetHash());
+        }
     }
     
     return true;
@@ -417,18 +648,35 @@ bool CInstantSendManager::ProcessBlock(const CBlock& block, const CBlockIndex* p
 
 bool CInstantSendManager::UndoBlock(const CBlock& block, const CBlockIndex* pindex)
 {
-    LOCK(cs);
-    
     // On reorg, we need to be careful
     // Transactions that were confirmed but are now unconfirmed
     // may still have valid InstantSend locks
     
     // The locks remain valid - they protect against double-spends
-    // even during reorgs
+    // even during reorgs. Only forget that they were mined here.
+    std::vector<uint256> vLockHashes;
+    GetBlockLockHashes(block, vLockHashes);
+    if (!vLockHashes.empty()) {
+        db.RemoveLocksMined(vLockHashes, pindex->nHeight);
+    }
     
     return true;
 }
 
+void CInstantSendManager::GetBlockLockHashes(const CBlock& block, std::vector<uint256>& vLockHashesOut) const
+{
+    vLockHashesOut.clear();
+    for (const auto& tx : block.vtx) {
+        if (tx->IsCoinBase()) {
+            continue;
+        }
+        auto islock = db.GetLockByTxid(tx->GetHash());
+        if (islock) {
+            vLockHashesOut.push_back(islock->GetHash());
+        }
+    }
+}
+
 bool CInstantSendManager::VerifyInstantSendLock(const CInstantSendLock& islock) const
 {
     if (!islock.sig.IsValid()) {
@@ -436,9 +684,8 @@ bool CInstantSendManager::VerifyInstantSendLock(const CInstantSendLock& islock)
     }
     
     // Get the quorum
-    auto quorum = quorumManager.GetQuorum(INSTANTSEND_QUORUM_TYPE, islock.quorumHash);
-    if (!quorum || !quorum->IsValid()) {
-        LogPrintf("CInstantSendManager::%s -- Quorum not found or invalid\n", __func__);
+    auto quorum = GetLockQuorum(islock);
+    if (!quorum) {
         return false;
     }
     
@@ -452,10 +699,18 @@ bool CInstantSendManager::VerifyInstantSendLock(const CInstantSendLock& islock)
     return true;
 }
 
+CQuorumCPtr CInstantSendManager::GetLockQuorum(const CInstantSendLock& islock) const
+{
+    auto quorum = quorumManager.GetQuorum(INSTANTSEND_QUORUM_TYPE, islock.quorumHash);
+    if (!quorum || !quorum->IsValid()) {
+        LogPrintf("CInstantSendManager::%s -- Quorum not found or invalid\n", __func__);
+        return nullptr;
+    }
+    return quorum;
+}
+
 std::vector<CInstantSendLock> CInstantSendManager::GetLocksForTxids(const std::vector<uint256>& txids) const
 {
-    LOCK(cs);
-    
     std::vector<CInstantSendLock> result;
     result.reserve(txids.size());
     
@@ -471,6 +726,12 @@ std::vector<CInstantSendLock> CInstantSendManager::GetLocksForTxids(const std::v
 
 void CInstantSendManager::UpdatedBlockTip(const CBlockIndex* pindex)
 {
+    // Locks of transactions buried deep enough are not needed anymore
+    size_t nPruned = db.RemoveConfirmedLocks(pindex->nHeight - INSTANTSEND_KEEP_CONFIRMED_BLOCKS);
+    if (nPruned > 0) {
+        LogPrint(BCLog::LLMQ, "CInstantSendManager::%s -- Pruned %u confirmed locks\n", __func__, nPruned);
+    }
+    
     LOCK(cs);
     
     // Retry pending transactions
@@ -489,6 +750,16 @@ void CInstantSendManager::UpdatedBlockTip(const CBlockIndex* pindex)
     }
 }
 
+void CInstantSendManager::NotifyChainLock(const CBlockIndex* pindexChainLock)
+{
+    // A ChainLocked block can't be reorged away, so there is no need to wait
+    // INSTANTSEND_KEEP_CONFIRMED_BLOCKS for the locks of what it confirmed
+    size_t nPruned = db.RemoveConfirmedLocks(pindexChainLock->nHeight);
+    if (nPruned > 0) {
+        LogPrint(BCLog::LLMQ, "CInstantSendManager::%s -- Pruned %u ChainLocked locks\n", __func__, nPruned);
+    }
+}
+
 void CInstantSendManager::Cleanup()
 {
     LOCK(cs);
@@ -5,17 +5,23 @@
 #ifndef MYNTA_LLMQ_INSTANTSEND_H
 #define MYNTA_LLMQ_INSTANTSEND_H
 
+#include "coins.h"
+#include "dbwrapper.h"
 #include "llmq/quorums.h"
 #include "primitives/transaction.h"
 #include "serialize.h"
 #include "sync.h"
 #include "uint256.h"
 
+#include <array>
 #include <map>
 #include <memory>
 #include <set>
+#include <unordered_map>
 #include <vector>
 
+#include <boost/thread/shared_mutex.hpp>
+
 class CBlockIndex;
 class CTxMemPool;
 class CValidationState;
@@ -119,33 +125,72 @@ public:
     std::string ToString() const;
 };
 
+typedef std::shared_ptr<const CInstantSendLock> CInstantSendLockPtr;
+
+/** Number of independently locked shards of the InstantSend lock indexes */
+static const size_t INSTANTSEND_DB_SHARD_COUNT = 16;
+/** Blocks a lock is kept after its transaction was mined, in case of a reorg */
+static const int INSTANTSEND_KEEP_CONFIRMED_BLOCKS = 100;
+/** LevelDB cache of the InstantSend lock database */
+static const size_t INSTANTSEND_DB_CACHE_SIZE = 4 << 20;
+/** Pruning writes its erasures once a batch grows past this many bytes */
+static const size_t INSTANTSEND_PRUNE_BATCH_SIZE = 1 << 20;
+
 /**
  * CInstantSendDb - Persistent storage for InstantSend locks
+ *
+ * Locks are kept in LevelDB and indexed in memory by hash, txid and input.
+ * The indexes are hash maps sharded by key, each shard behind its own
+ * shared mutex, so lookups like the conflict checks on mempool acceptance
+ * only take a read lock on the shards of the keys they probe. Writers are
+ * serialized by cs. Once the transaction of a lock is mined and buried
+ * INSTANTSEND_KEEP_CONFIRMED_BLOCKS deep, the lock is pruned.
  */
 class CInstantSendDb
 {
 private:
+    // Serializes writers, readers only take shard locks
     mutable CCriticalSection cs;
     
-    // Locks by input (for conflict detection)
-    std::map<COutPoint, uint256> inputLocks; // outpoint -> islock hash
+    CDBWrapper db;
+    
+    struct LockHashHasher {
+        size_t operator()(const uint256& hash) const { return hash.GetCheapHash(); }
+    };
     
-    // Locks by txid
-    std::map<uint256, CInstantSendLock> locksById;
+    struct CLockShard {
+        mutable boost::shared_mutex cs;
+        // Each map holds the entries whose key falls in this shard
+        std::unordered_map<uint256, CInstantSendLockPtr, LockHashHasher> locksByHash;
+        std::unordered_map<uint256, CInstantSendLockPtr, LockHashHasher> locksByTxid;
+        std::unordered_map<COutPoint, CInstantSendLockPtr, SaltedOutpointHasher> locksByInput;
+    };
     
-    // Lock hashes by txid
-    std::map<uint256, uint256> txidToLockHash;
+    std::array<CLockShard, INSTANTSEND_DB_SHARD_COUNT> shards;
+    
+    // GetCheapHash() uses the first bytes for the hash maps, shard on the last
+    CLockShard& GetShard(const uint256& hash) { return shards[*(hash.end() - 1) % INSTANTSEND_DB_SHARD_COUNT]; }
+    const CLockShard& GetShard(const uint256& hash) const { return shards[*(hash.end() - 1) % INSTANTSEND_DB_SHARD_COUNT]; }
+    
+    // Add a lock to, or remove it from, the in-memory indexes
+    void AddToIndexes(const CInstantSendLockPtr& islock);
+    void RemoveFromIndexes(const CInstantSendLockPtr& islock);
+    
+    // Remove a lock from the indexes and add its erasure to batch
+    CInstantSendLockPtr RemoveLock(const uint256& hash, CDBBatch& batch);
 
 public:
-    CInstantSendDb() = default;
+    CInstantSendDb(size_t nCacheSize, bool fMemory = false, bool fWipe = false);
     
     // Write a lock
     bool WriteLock(const CInstantSendLock& islock);
     
     // Get lock by hash
+    CInstantSendLockPtr GetLock(const uint256& hash) const;
     bool GetLock(const uint256& hash, CInstantSendLock& islockOut) const;
     
     // Get lock by txid
+    CInstantSendLockPtr GetLockByTxid(const uint256& txid) const;
     bool GetLockByTxid(const uint256& txid, CInstantSendLock& islockOut) const;
     
     // Check if an input is locked
@@ -155,6 +200,7 @@ public:
     bool IsTxLocked(const uint256& txid) const;
     
     // Get the lock for an input
+    CInstantSendLockPtr GetLockForInput(const COutPoint& outpoint) const;
     bool GetLockForInput(const COutPoint& outpoint, CInstantSendLock& islockOut) const;
     
     // Remove a lock (for reorg)
@@ -163,6 +209,15 @@ public:
     // Remove locks for a set of txids
     void RemoveLocksForTxids(const std::set<uint256>& txids);
     
+    // Record that the transactions of the locks hashes were mined at nHeight, or undo that, in one write
+    void WriteLocksMined(const std::vector<uint256>& hashes, int nHeight);
+    void RemoveLocksMined(const std::vector<uint256>& hashes, int nHeight);
+    
+    // Prune the locks of transactions mined at or below nUntilHeight, returns
+    // how many. Written in batches of INSTANTSEND_PRUNE_BATCH_SIZE, so catching
+    // up on a ChainLock far ahead of the last prune doesn't build one huge batch.
+    size_t RemoveConfirmedLocks(int nUntilHeight);
+    
     // Get all locked outpoints
     std::set<COutPoint> GetAllLockedOutpoints() const;
 };
@@ -173,6 +228,8 @@ public:
 class CInstantSendManager
 {
 private:
+    // Guards the pending state and serializes storing locks; lookups of
+    // stored locks go straight to db without it
     mutable CCriticalSection cs;
     
     CInstantSendDb db;
@@ -183,6 +240,9 @@ private:
     // Transactions waiting for quorum (txid -> tx)
     std::map<uint256, CTransactionRef> pendingTxs;
     
+    // Hashes of received locks queued on the BLS worker
+    std::set<uint256> verifyingLocks;
+    
     // Reference to signing manager
     CSigningManager& signingManager;
     CQuorumManager& quorumManager;
@@ -191,7 +251,7 @@ private:
     uint256 myProTxHash;
     
 public:
-    CInstantSendManager(CSigningManager& _signingManager, CQuorumManager& _quorumManager);
+    CInstantSendManager(CSigningManager& _signingManager, CQuorumManager& _quorumManager, bool fMemoryDb = false);
     
     // Set our identity
     void SetMyProTxHash(const uint256& _proTxHash) { myProTxHash = _proTxHash; }
@@ -205,6 +265,9 @@ public:
     // Process a received lock message
     bool ProcessInstantSendLock(const CInstantSendLock& islock, CValidationState& state);
     
+    // Process a received lock message, verifying its signature on the BLS worker
+    void AsyncProcessInstantSendLock(const CInstantSendLock& islock);
+    
     // Check if a transaction is eligible for InstantSend
     bool IsInstantSendEnabled() const;
     bool CanTxBeLocked(const CTransactionRef& tx) const;
@@ -215,6 +278,10 @@ public:
     // Get lock status for a transaction
     bool IsLocked(const uint256& txid) const;
     bool GetInstantSendLock(const uint256& txid, CInstantSendLock& islockOut) const;
+    bool GetInstantSendLockByHash(const uint256& hash, CInstantSendLock& islockOut) const;
+    
+    // Whether the lock announced as hash is stored or being verified
+    bool AlreadyHave(const uint256& hash) const;
     
     // Mempool integration
     bool CheckCanLock(const CTransaction& tx, bool printDebug = false) const;
@@ -232,13 +299,25 @@ public:
     // Update on new chain tip
     void UpdatedBlockTip(const CBlockIndex* pindex);
     
+    // Prune the locks of transactions mined at or below a ChainLocked block
+    void NotifyChainLock(const CBlockIndex* pindexChainLock);
+    
     // Cleanup expired requests
     void Cleanup();
 
 private:
+    // Hashes of the locks of the transactions in block
+    void GetBlockLockHashes(const CBlock& block, std::vector<uint256>& vLockHashesOut) const;
+    
     // Create the request ID for a transaction
     uint256 CreateRequestId(const std::vector<COutPoint>& inputs) const;
     
+    // Get the (valid) quorum that signed a lock
+    CQuorumCPtr GetLockQuorum(const CInstantSendLock& islock) const;
+    
+    // Store a lock whose signature has already been verified
+    bool ProcessVerifiedInstantSendLock(const CInstantSendLock& islock, CValidationState& state);
+    
     // Sign a lock request
     bool SignLockRequest(const CTransactionRef& tx);
     
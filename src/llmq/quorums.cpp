@@ -3,15 +3,19 @@
 // file COPYING or http://www.opensource.org/licenses/mit-license.php.
 
 #include "llmq/quorums.h"
+#include "bls/bls_worker.h"
 #include "chain.h"
 #include "chainparams.h"
 #include "evo/deterministicmns.h"
+#include "evo/evodb.h"
 #include "hash.h"
+#include "memusage.h"
 #include "util.h"
 #include "validation.h"
 
 #include <algorithm>
 #include <sstream>
+#include <thread>
 
 namespace llmq {
 
@@ -134,6 +138,66 @@ std::string CQuorum::ToString() const
     return ss.str();
 }
 
+// ============================================================================
+// CQuorumSnapshot
+// ============================================================================
+
+static const std::string DB_QUORUM_SNAPSHOT = "llmq_Q";
+
+CQuorumSnapshot MakeQuorumSnapshot(const CQuorum& quorum)
+{
+    CQuorumSnapshot snapshot;
+    snapshot.llmqType = quorum.llmqType;
+    snapshot.quorumHash = quorum.quorumHash;
+    snapshot.quorumHeight = quorum.quorumHeight;
+    snapshot.activeMembers.reserve(quorum.members.size());
+    snapshot.members.reserve(quorum.members.size());
+    snapshot.memberPubKeys.reserve(quorum.members.size());
+    for (const auto& member : quorum.members) {
+        snapshot.activeMembers.push_back(member.valid);
+        snapshot.members.push_back(member.proTxHash);
+        snapshot.memberPubKeys.push_back(member.pubKeyOperator);
+    }
+    snapshot.quorumPublicKey = quorum.quorumPublicKey;
+    return snapshot;
+}
+
+CQuorumPtr QuorumFromSnapshot(const CQuorumSnapshot& snapshot)
+{
+    if (snapshot.members.size() != snapshot.activeMembers.size() ||
+        snapshot.members.size() != snapshot.memberPubKeys.size()) {
+        return nullptr;
+    }
+    
+    auto quorum = std::make_shared<CQuorum>();
+    quorum->llmqType = snapshot.llmqType;
+    quorum->quorumHash = snapshot.quorumHash;
+    quorum->quorumHeight = snapshot.quorumHeight;
+    quorum->members.resize(snapshot.members.size());
+    for (size_t i = 0; i < snapshot.members.size(); i++) {
+        CQuorumMember& member = quorum->members[i];
+        member.proTxHash = snapshot.members[i];
+        member.pubKeyOperator = snapshot.memberPubKeys[i];
+        member.valid = snapshot.activeMembers[i];
+        if (member.valid) {
+            quorum->validMemberCount++;
+        }
+    }
+    quorum->quorumPublicKey = snapshot.quorumPublicKey;
+    quorum->fValid = quorum->validMemberCount >= quorum->GetMinSize();
+    return quorum;
+}
+
+bool ReadQuorumSnapshot(const CEvoDB& db, const uint256& quorumHash, CQuorumSnapshot& snapshotOut)
+{
+    return db.Read(std::make_pair(DB_QUORUM_SNAPSHOT, quorumHash), snapshotOut);
+}
+
+void WriteQuorumSnapshot(CEvoDB& db, const CQuorumSnapshot& snapshot)
+{
+    db.Write(std::make_pair(DB_QUORUM_SNAPSHOT, snapshot.quorumHash), snapshot);
+}
+
 // ============================================================================
 // CRecoveredSig Implementation
 // ============================================================================
@@ -178,6 +242,15 @@ CQuorumManager::CQuorumManager()
 {
 }
 
+CQuorumManager::~CQuorumManager()
+{
+    for (const auto& entry : activeQuorums) {
+        for (const auto& quorum : entry.second) {
+            BLSUnpinPublicKey(quorum->quorumPublicKey);
+        }
+    }
+}
+
 void CQuorumManager::SetMyProTxHash(const uint256& _proTxHash)
 {
     LOCK(cs);
@@ -204,15 +277,14 @@ CQuorumCPtr CQuorumManager::BuildQuorum(LLMQType type, const CBlockIndex* pindex
     hw << pindex->GetBlockHash();
     uint256 quorumHash = hw.GetHash();
     
-    // Check cache
+    // Check cache, then the snapshot of an earlier build
     auto key = std::make_pair(type, quorumHash);
-    auto it = quorumCache.find(key);
-    if (it != quorumCache.end()) {
-        return it->second;
+    if (auto quorum = GetQuorum(type, quorumHash)) {
+        return quorum;
     }
     
     // Select members
-    auto selectedMembers = SelectQuorumMembers(type, pindex);
+    const auto& selectedMembers = GetQuorumMembers(type, quorumHash, pindex);
     if (selectedMembers.size() < static_cast<size_t>(params.minSize)) {
         LogPrintf("CQuorumManager::%s -- Not enough MNs for quorum type %d at height %d\n",
                   __func__, static_cast<int>(type), pindex->nHeight);
@@ -249,15 +321,18 @@ CQuorumCPtr CQuorumManager::BuildQuorum(LLMQType type, const CBlockIndex* pindex
         quorum->members.push_back(member);
     }
     
-    // Aggregate public key
+    // Aggregate public key, once per quorum; verifications only use the result
     if (!memberPubKeys.empty()) {
         quorum->quorumPublicKey = CBLSPublicKey::AggregatePublicKeys(memberPubKeys);
     }
     
     quorum->fValid = (quorum->validMemberCount >= params.minSize);
     
-    // Cache
+    // Cache, and persist so the quorum never has to be built again
     quorumCache[key] = quorum;
+    if (evoDb) {
+        WriteQuorumSnapshot(*evoDb, MakeQuorumSnapshot(*quorum));
+    }
     
     LogPrintf("CQuorumManager::%s -- Built quorum: %s\n", __func__, quorum->ToString());
     
@@ -267,11 +342,75 @@ CQuorumCPtr CQuorumManager::BuildQuorum(LLMQType type, const CBlockIndex* pindex
 CQuorumCPtr CQuorumManager::GetQuorum(LLMQType type, const uint256& quorumHash) const
 {
     LOCK(cs);
-    auto it = quorumCache.find(std::make_pair(type, quorumHash));
+    auto key = std::make_pair(type, quorumHash);
+    auto it = quorumCache.find(key);
     if (it != quorumCache.end()) {
         return it->second;
     }
-    return nullptr;
+    
+    // A quorum built in an earlier run, or evicted, e.g. when verifying an
+    // old lock during reindex: one read instead of a rebuild
+    CQuorumSnapshot snapshot;
+    if (!evoDb || !ReadQuorumSnapshot(*evoDb, quorumHash, snapshot) || snapshot.llmqType != type) {
+        return nullptr;
+    }
+    CQuorumCPtr quorum = QuorumFromSnapshot(snapshot);
+    if (quorum) {
+        quorumCache.emplace(key, quorum);
+    }
+    return quorum;
+}
+
+size_t CQuorumManager::QuorumUsage(const CQuorum& quorum)
+{
+    // The member set is filled lazily, so count it as if it were
+    return memusage::MallocUsage(sizeof(CQuorum)) +
+           memusage::MallocUsage(sizeof(memusage::stl_tree_node<std::pair<const std::pair<LLMQType, uint256>, CQuorumCPtr>>)) +
+           memusage::DynamicUsage(quorum.members) +
+           memusage::MallocUsage(sizeof(memusage::stl_tree_node<uint256>)) * quorum.members.size();
+}
+
+size_t CQuorumManager::GetCacheUsage() const
+{
+    LOCK(cs);
+    size_t nUsage = 0;
+    for (const auto& entry : quorumCache) {
+        nUsage += QuorumUsage(*entry.second);
+    }
+    return nUsage;
+}
+
+size_t CQuorumManager::EvictCache(size_t nBytes)
+{
+    LOCK(cs);
+    if (!evoDb) {
+        return 0;
+    }
+    
+    std::set<const CQuorum*> setKeep;
+    for (const auto& entry : activeQuorums) {
+        for (const auto& quorum : entry.second) {
+            setKeep.insert(quorum.get());
+        }
+    }
+    std::vector<std::pair<int, std::pair<LLMQType, uint256>>> vCandidates;
+    for (const auto& entry : quorumCache) {
+        if (!setKeep.count(entry.second.get()) && !entry.second->skShare) {
+            vCandidates.emplace_back(entry.second->quorumHeight, entry.first);
+        }
+    }
+    std::sort(vCandidates.begin(), vCandidates.end());
+    
+    size_t nFreed = 0;
+    for (const auto& candidate : vCandidates) {
+        if (nFreed >= nBytes) {
+            break;
+        }
+        auto it = quorumCache.find(candidate.second);
+        nFreed += QuorumUsage(*it->second);
+        quorumCache.erase(it);
+    }
+    return nFreed;
 }
 
 std::vector<CQuorumCPtr> CQuorumManager::GetActiveQuorums(LLMQType type) const
@@ -345,7 +484,21 @@ void CQuorumManager::UpdatedBlockTip(const CBlockIndex* pindex)
             quorumHeight -= params.dkgInterval;
         }
         
-        activeQuorums[type] = newActive;
+        // Keep the decompressed public keys of the active quorums resident,
+        // every recovered sig, ChainLock and InstantSend lock is verified
+        // against one of them
+        auto& oldActive = activeQuorums[type];
+        for (const auto& quorum : newActive) {
+            if (std::find(oldActive.begin(), oldActive.end(), quorum) == oldActive.end()) {
+                BLSPinPublicKey(quorum->quorumPublicKey);
+            }
+        }
+        for (const auto& quorum : oldActive) {
+            if (std::find(newActive.begin(), newActive.end(), quorum) == newActive.end()) {
+                BLSUnpinPublicKey(quorum->quorumPublicKey);
+            }
+        }
+        oldActive = std::move(newActive);
     }
 }
 
@@ -379,6 +532,66 @@ bool CQuorumManager::GetSecretKeyShare(
     return true;
 }
 
+const std::vector<CDeterministicMNCPtr>& CQuorumManager::GetQuorumMembers(
+    LLMQType type,
+    const uint256& quorumHash,
+    const CBlockIndex* pindex)
+{
+    AssertLockHeld(cs);
+    
+    auto key = std::make_pair(type, quorumHash);
+    auto it = quorumMembersCache.find(key);
+    if (it != quorumMembersCache.end()) {
+        return it->second.members;
+    }
+    
+    // Quorums are built for recent heights only, so drop the oldest selection
+    if (quorumMembersCache.size() >= MAX_QUORUM_MEMBERS_CACHE) {
+        auto itOldest = std::min_element(quorumMembersCache.begin(), quorumMembersCache.end(),
+            [](const auto& a, const auto& b) { return a.second.nHeight < b.second.nHeight; });
+        quorumMembersCache.erase(itOldest);
+    }
+    
+    auto& entry = quorumMembersCache[key];
+    entry.nHeight = pindex->nHeight;
+    entry.members = SelectQuorumMembers(type, pindex);
+    return entry.members;
+}
+
+// Below this many candidates per thread, scoring is not worth spawning threads for
+static const size_t MIN_SCORES_PER_THREAD = 512;
+
+// Fill in the score of every candidate. hwPrefix already holds the part of
+// the preimage common to all candidates, only the proTxHash is appended.
+static void CalcMemberScores(const CHashWriter& hwPrefix,
+                             std::vector<std::pair<uint256, CDeterministicMNCPtr>>& scored)
+{
+    auto scoreRange = [&hwPrefix, &scored](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; i++) {
+            CHashWriter hw(hwPrefix);
+            hw << scored[i].second->proTxHash;
+            scored[i].first = hw.GetHash();
+        }
+    };
+    
+    size_t nThreads = std::min<size_t>(std::max(1, GetNumCores()), scored.size() / MIN_SCORES_PER_THREAD);
+    if (nThreads <= 1) {
+        scoreRange(0, scored.size());
+        return;
+    }
+    
+    size_t nChunk = (scored.size() + nThreads - 1) / nThreads;
+    std::vector<std::thread> threads;
+    threads.reserve(nThreads - 1);
+    for (size_t t = 1; t < nThreads; t++) {
+        threads.emplace_back(scoreRange, t * nChunk, std::min(scored.size(), (t + 1) * nChunk));
+    }
+    scoreRange(0, nChunk);
+    for (auto& thread : threads) {
+        thread.join();
+    }
+}
+
 std::vector<CDeterministicMNCPtr> CQuorumManager::SelectQuorumMembers(
     LLMQType type,
     const CBlockIndex* pindex) const
@@ -398,43 +611,37 @@ std::vector<CDeterministicMNCPtr> CQuorumManager::SelectQuorumMembers(
     hw << pindex->GetBlockHash();
     uint256 quorumModifier = hw.GetHash();
     
-    // Score all valid masternodes
+    // Collect candidates, then score them all
     std::vector<std::pair<uint256, CDeterministicMNCPtr>> scored;
+    scored.reserve(mnList->GetValidMNsCount());
     
     mnList->ForEachMN(true, [&](const CDeterministicMNCPtr& mn) {
         if (mn->state.vchOperatorPubKey.empty()) return;
-        
-        uint256 score = CalcMemberScore(mn, quorumModifier);
-        scored.emplace_back(score, mn);
+        scored.emplace_back(uint256(), mn);
     });
     
-    // Sort by score
-    std::sort(scored.begin(), scored.end(), [](const auto& a, const auto& b) {
-        return a.first < b.first;
+    // score = H("LLMQ_SCORE" || quorumModifier || proTxHash)
+    CHashWriter hwScore(SER_GETHASH, PROTOCOL_VERSION);
+    hwScore << std::string("LLMQ_SCORE");
+    hwScore << quorumModifier;
+    CalcMemberScores(hwScore, scored);
+    
+    // Only the top N need to be ordered
+    size_t nSelect = std::min(scored.size(), static_cast<size_t>(params.size));
+    std::partial_sort(scored.begin(), scored.begin() + nSelect, scored.end(), [](const auto& a, const auto& b) {
+        if (a.first != b.first) return a.first < b.first;
+        return a.second->proTxHash < b.second->proTxHash;
     });
     
-    // Take top N
     std::vector<CDeterministicMNCPtr> result;
-    result.reserve(std::min(scored.size(), static_cast<size_t>(params.size)));
-    
-    for (size_t i = 0; i < scored.size() && result.size() < static_cast<size_t>(params.size); i++) {
+    result.reserve(nSelect);
+    for (size_t i = 0; i < nSelect; i++) {
         result.push_back(scored[i].second);
     }
     
     return result;
 }
 
-uint256 CQuorumManager::CalcMemberScore(
-    const CDeterministicMNCPtr& mn,
-    const uint256& quorumModifier) const
-{
-    CHashWriter hw(SER_GETHASH, PROTOCOL_VERSION);
-    hw << std::string("LLMQ_SCORE");
-    hw << quorumModifier;
-    hw << mn->proTxHash;
-    return hw.GetHash();
-}
-
 // ============================================================================
 // CSigningManager Implementation
 // ============================================================================
@@ -444,10 +651,13 @@ CSigningManager::CSigningManager(CQuorumManager& _quorumManager)
 {
 }
 
+CSigningManager::~CSigningManager()
+{
+    StopIngressWorker();
+}
+
 bool CSigningManager::AsyncSign(LLMQType type, const uint256& id, const uint256& msgHash)
 {
-    LOCK(cs);
-    
     LOCK(cs_main);
     auto quorum = quorumManager.SelectQuorumForSigning(type, chainActive.Tip(), id);
     if (!quorum) {
@@ -462,12 +672,7 @@ bool CSigningManager::AsyncSign(LLMQType type, const uint256& id, const uint256&
     }
     
     // Build sign hash
-    CHashWriter hw(SER_GETHASH, PROTOCOL_VERSION);
-    hw << static_cast<uint8_t>(type);
-    hw << quorum->quorumHash;
-    hw << id;
-    hw << msgHash;
-    uint256 signHash = hw.GetHash();
+    uint256 signHash = BuildSignHash(type, quorum->quorumHash, id, msgHash);
     
     // Sign
     CBLSSignature sigShare = skShare.Sign(signHash);
@@ -476,110 +681,380 @@ bool CSigningManager::AsyncSign(LLMQType type, const uint256& id, const uint256&
         return false;
     }
     
-    // Store our share
-    sigShares[id][quorumManager.GetMyProTxHash()] = sigShare;
-    
     LogPrintf("CSigningManager::%s -- Created sig share for %s\n", 
               __func__, id.ToString().substr(0, 16));
     
-    // Try to recover
-    CRecoveredSig recSig;
-    if (TryRecoverSignature(type, id, msgHash, recSig)) {
-        recoveredSigs[id] = recSig;
-        LogPrintf("CSigningManager::%s -- Recovered signature for %s\n",
-                  __func__, id.ToString().substr(0, 16));
+    // Store our share, this recovers the signature if it completes the threshold
+    const uint256& myProTxHash = quorumManager.GetMyProTxHash();
+    if (ProcessSigShare(type, quorum->quorumHash, id, msgHash, myProTxHash, sigShare)) {
+        QueueSigShareForRelay(type, quorum->quorumHash, id, msgHash, quorum->GetMemberIndex(myProTxHash), sigShare);
     }
     
     return true;
 }
 
 bool CSigningManager::ProcessSigShare(
+    LLMQType type,
     const uint256& quorumHash,
     const uint256& id,
+    const uint256& msgHash,
     const uint256& proTxHash,
     const CBLSSignature& sigShare)
 {
-    LOCK(cs);
-    
     if (!sigShare.IsValid()) {
         return false;
     }
     
-    // Store the share
-    sigShares[id][proTxHash] = sigShare;
+    auto quorum = quorumManager.GetQuorum(type, quorumHash);
+    if (!quorum || !quorum->IsMember(proTxHash)) {
+        return false;
+    }
+    
+    CSigSharesSession sessionInfo;
+    std::vector<std::pair<uint256, CBLSSignature>> shares;
+    {
+        auto& shard = GetShard(id);
+        std::lock_guard<std::mutex> lock(shard.cs);
+        
+        auto [it, fInserted] = shard.sessions.try_emplace(id);
+        auto& session = it->second;
+        if (fInserted) {
+            session.llmqType = type;
+            session.quorumHash = quorumHash;
+            session.msgHash = msgHash;
+            session.nThreshold = quorum->GetThreshold();
+            session.nTimeCreated = GetTime();
+        } else if (session.llmqType != type || session.quorumHash != quorumHash || session.msgHash != msgHash) {
+            LogPrint(BCLog::LLMQ, "CSigningManager::%s -- Conflicting sig share from %s for %s\n",
+                     __func__, proTxHash.ToString().substr(0, 16), id.ToString().substr(0, 16));
+            return false;
+        }
+        
+        if (session.fRecovered) {
+            return true;
+        }
+        for (const auto& share : session.shares) {
+            if (share.first == proTxHash) {
+                return true;
+            }
+        }
+        session.shares.emplace_back(proTxHash, sigShare);
+        if (static_cast<int>(session.shares.size()) < session.nThreshold) {
+            return true;
+        }
+        
+        // Threshold reached: take the shares out and recover without the shard lock
+        session.fRecovered = true;
+        shares.swap(session.shares);
+        sessionInfo = session;
+    }
+    
+    if (!RecoverSession(id, sessionInfo, shares)) {
+        // Put the shares back so a later share can retry
+        auto& shard = GetShard(id);
+        std::lock_guard<std::mutex> lock(shard.cs);
+        auto it = shard.sessions.find(id);
+        if (it != shard.sessions.end()) {
+            it->second.fRecovered = false;
+            it->second.shares.insert(it->second.shares.end(), shares.begin(), shares.end());
+        }
+    }
     
     return true;
 }
 
-bool CSigningManager::TryRecoverSignature(
+void CSigningManager::AsyncProcessSigShare(
     LLMQType type,
+    const uint256& quorumHash,
     const uint256& id,
     const uint256& msgHash,
-    CRecoveredSig& recSigOut)
+    const uint256& proTxHash,
+    const CBLSSignature& sigShare)
 {
-    LOCK(cs);
+    if (!sigShare.IsValid()) {
+        return;
+    }
     
-    // Already recovered?
-    auto it = recoveredSigs.find(id);
-    if (it != recoveredSigs.end()) {
-        recSigOut = it->second;
-        return true;
+    auto quorum = quorumManager.GetQuorum(type, quorumHash);
+    if (!quorum || !quorum->IsValid()) {
+        LogPrint(BCLog::LLMQ, "CSigningManager::%s -- Unknown quorum %s\n",
+                 __func__, quorumHash.ToString().substr(0, 16));
+        return;
     }
     
-    // Get shares for this id
-    auto sharesIt = sigShares.find(id);
-    if (sharesIt == sigShares.end()) {
+    int memberIndex = quorum->GetMemberIndex(proTxHash);
+    if (memberIndex < 0 || !quorum->members[memberIndex].valid) {
+        LogPrint(BCLog::LLMQ, "CSigningManager::%s -- %s is not a valid member of quorum %s\n",
+                 __func__, proTxHash.ToString().substr(0, 16), quorumHash.ToString().substr(0, 16));
+        return;
+    }
+    
+    AsyncVerifySigShare(quorum, id, msgHash, memberIndex, sigShare);
+}
+
+bool CSigningManager::AsyncProcessSigShares(CBatchedSigShares&& batch)
+{
+    if (batch.shares.empty() || batch.shares.size() > MAX_SIG_SHARES_PER_BATCH) {
         return false;
     }
+    for (const auto& [nMember, sigShare] : batch.shares) {
+        if (!sigShare.IsValid()) {
+            return false;
+        }
+    }
     
-    const auto& shares = sharesIt->second;
+    if (!fIngressRunning) {
+        std::map<std::pair<LLMQType, uint256>, CQuorumCPtr> quorums;
+        std::set<std::pair<uint256, uint256>> seen;
+        return ProcessIngressBatch(batch, quorums, seen);
+    }
     
-    LOCK(cs_main);
-    auto quorum = quorumManager.SelectQuorumForSigning(type, chainActive.Tip(), id);
-    if (!quorum) {
-        return false;
+    if (!sigSharesIngress.TryPush(std::move(batch))) {
+        // The worker is behind; shares are relayed by every quorum member,
+        // so a dropped batch will most likely arrive again from another peer
+        if (nIngressDropped++ % 100 == 0) {
+            LogPrint(BCLog::LLMQ, "CSigningManager::%s -- Ingress queue full, %u batches dropped so far\n",
+                     __func__, nIngressDropped.load());
+        }
+        return true;
+    }
+    if (fIngressSleeping) {
+        std::lock_guard<std::mutex> lock(csIngressWake);
+        condIngress.notify_one();
+    }
+    return true;
+}
+
+bool CSigningManager::ProcessIngressBatch(
+    const CBatchedSigShares& batch,
+    std::map<std::pair<LLMQType, uint256>, CQuorumCPtr>& quorums,
+    std::set<std::pair<uint256, uint256>>& seen)
+{
+    auto itQuorum = quorums.find(std::make_pair(batch.llmqType, batch.quorumHash));
+    if (itQuorum == quorums.end()) {
+        itQuorum = quorums.emplace(std::make_pair(batch.llmqType, batch.quorumHash),
+                                   quorumManager.GetQuorum(batch.llmqType, batch.quorumHash)).first;
+    }
+    const CQuorumCPtr& quorum = itQuorum->second;
+    if (!quorum || !quorum->IsValid()) {
+        // Possibly a quorum we don't know about yet, not the peer's fault
+        LogPrint(BCLog::LLMQ, "CSigningManager::%s -- Unknown quorum %s\n",
+                 __func__, batch.quorumHash.ToString().substr(0, 16));
+        return true;
     }
     
-    // Check if we have enough shares
-    int threshold = quorum->GetThreshold();
-    if (static_cast<int>(shares.size()) < threshold) {
-        return false;
+    for (const auto& [nMember, sigShare] : batch.shares) {
+        if (nMember >= quorum->members.size()) {
+            return false;
+        }
     }
     
-    // Collect shares from members
-    std::vector<CBLSSignature> memberSigs;
-    std::vector<CBLSId> memberIds;
+    for (const auto& [nMember, sigShare] : batch.shares) {
+        const CQuorumMember& member = quorum->members[nMember];
+        if (!member.valid || !seen.emplace(batch.id, member.proTxHash).second) {
+            continue;
+        }
+        AsyncVerifySigShare(quorum, batch.id, batch.msgHash, nMember, sigShare);
+    }
+    return true;
+}
+
+void CSigningManager::StartIngressWorker()
+{
+    StopIngressWorker();
+    fIngressRunning = true;
+    ingressThread = std::thread(&TraceThread<std::function<void()> >, "llmqsigs",
+                                std::function<void()>(std::bind(&CSigningManager::ThreadIngress, this)));
+}
+
+void CSigningManager::StopIngressWorker()
+{
+    if (!ingressThread.joinable()) {
+        return;
+    }
+    {
+        std::lock_guard<std::mutex> lock(csIngressWake);
+        fIngressRunning = false;
+    }
+    condIngress.notify_all();
+    ingressThread.join();
     
-    for (const auto& [proTxHash, sig] : shares) {
-        if (quorum->IsMember(proTxHash)) {
-            memberSigs.push_back(sig);
-            memberIds.emplace_back(proTxHash);
-            
-            if (static_cast<int>(memberSigs.size()) >= threshold) {
-                break;
+    // Nothing pops any more; drop what is left
+    CBatchedSigShares batch;
+    while (sigSharesIngress.TryPop(batch)) {
+    }
+}
+
+void CSigningManager::ThreadIngress()
+{
+    std::map<std::pair<LLMQType, uint256>, CQuorumCPtr> quorums;
+    std::set<std::pair<uint256, uint256>> seen;
+    CBatchedSigShares batch;
+    while (fIngressRunning) {
+        // Take everything queued; copies of a share that came from several
+        // peers in the meantime are only looked at once
+        bool fAny = false;
+        while (sigSharesIngress.TryPop(batch)) {
+            fAny = true;
+            if (!ProcessIngressBatch(batch, quorums, seen)) {
+                LogPrint(BCLog::LLMQ, "CSigningManager::%s -- Malformed sig share batch for %s\n",
+                         __func__, batch.id.ToString().substr(0, 16));
             }
         }
+        quorums.clear();
+        seen.clear();
+        if (fAny) {
+            continue;
+        }
+        
+        std::unique_lock<std::mutex> lock(csIngressWake);
+        fIngressSleeping = true;
+        // The timeout covers a push that raced with going to sleep
+        condIngress.wait_for(lock, std::chrono::milliseconds(100), [this] {
+            return !fIngressRunning || !sigSharesIngress.Empty();
+        });
+        fIngressSleeping = false;
+    }
+}
+
+void CSigningManager::AsyncVerifySigShare(
+    const CQuorumCPtr& quorum,
+    const uint256& id,
+    const uint256& msgHash,
+    int memberIndex,
+    const CBLSSignature& sigShare)
+{
+    const CQuorumMember& member = quorum->members[memberIndex];
+    const uint256 proTxHash = member.proTxHash;
+    {
+        auto& shard = GetShard(id);
+        std::lock_guard<std::mutex> lock(shard.cs);
+        auto it = shard.sessions.find(id);
+        if (it != shard.sessions.end()) {
+            if (it->second.fRecovered) {
+                return;
+            }
+            for (const auto& share : it->second.shares) {
+                if (share.first == proTxHash) {
+                    return;
+                }
+            }
+        }
+        if (!shard.verifying.emplace(id, proTxHash).second) {
+            return;
+        }
     }
     
-    if (static_cast<int>(memberSigs.size()) < threshold) {
-        return false;
+    // The pairing runs on the BLS worker; only the session's shard is locked to store the share
+    LLMQType type = quorum->llmqType;
+    uint256 quorumHash = quorum->quorumHash;
+    uint256 signHash = BuildSignHash(type, quorumHash, id, msgHash);
+    blsWorker.AsyncVerifySig(sigShare, member.pubKeyOperator, signHash,
+        [this, type, quorumHash, id, msgHash, proTxHash, memberIndex, sigShare](bool fValid) {
+            {
+                auto& shard = GetShard(id);
+                std::lock_guard<std::mutex> lock(shard.cs);
+                shard.verifying.erase(std::make_pair(id, proTxHash));
+            }
+            if (!fValid) {
+                LogPrint(BCLog::LLMQ, "CSigningManager::%s -- Invalid sig share from %s for %s\n",
+                         __func__, proTxHash.ToString().substr(0, 16), id.ToString().substr(0, 16));
+                return;
+            }
+            if (ProcessSigShare(type, quorumHash, id, msgHash, proTxHash, sigShare)) {
+                QueueSigShareForRelay(type, quorumHash, id, msgHash, memberIndex, sigShare);
+            }
+        });
+}
+
+void CSigningManager::QueueSigShareForRelay(
+    LLMQType type,
+    const uint256& quorumHash,
+    const uint256& id,
+    const uint256& msgHash,
+    int memberIndex,
+    const CBLSSignature& sigShare)
+{
+    std::lock_guard<std::mutex> lock(csRelay);
+    auto [it, fInserted] = sigSharesToRelay.try_emplace(id);
+    CBatchedSigShares& batch = it->second;
+    if (fInserted) {
+        batch.llmqType = type;
+        batch.quorumHash = quorumHash;
+        batch.id = id;
+        batch.msgHash = msgHash;
+    } else if (batch.quorumHash != quorumHash || batch.msgHash != msgHash ||
+               batch.shares.size() >= MAX_SIG_SHARES_PER_BATCH) {
+        return;
+    }
+    batch.shares.emplace_back(static_cast<uint16_t>(memberIndex), sigShare);
+}
+
+void CSigningManager::GetSigSharesToRelay(std::vector<CBatchedSigShares>& vBatchesOut)
+{
+    std::lock_guard<std::mutex> lock(csRelay);
+    vBatchesOut.reserve(vBatchesOut.size() + sigSharesToRelay.size());
+    for (auto& item : sigSharesToRelay) {
+        vBatchesOut.push_back(std::move(item.second));
+    }
+    sigSharesToRelay.clear();
+}
+
+bool CSigningManager::RecoverSession(
+    const uint256& id,
+    const CSigSharesSession& session,
+    const std::vector<std::pair<uint256, CBLSSignature>>& shares)
+{
+    std::vector<CBLSSignature> memberSigs;
+    std::vector<CBLSId> memberIds;
+    memberSigs.reserve(shares.size());
+    memberIds.reserve(shares.size());
+    for (const auto& [proTxHash, sig] : shares) {
+        memberSigs.push_back(sig);
+        memberIds.emplace_back(proTxHash);
     }
     
-    // Recover threshold signature
     CBLSSignature recoveredSig = CBLSSignature::RecoverThresholdSignature(
-        memberSigs, memberIds, threshold);
-    
+        memberSigs, memberIds, session.nThreshold, session.quorumHash);
     if (!recoveredSig.IsValid()) {
+        LogPrint(BCLog::LLMQ, "CSigningManager::%s -- Failed to recover signature for %s\n",
+                 __func__, id.ToString().substr(0, 16));
         return false;
     }
     
-    // Build result
-    recSigOut.llmqType = type;
-    recSigOut.quorumHash = quorum->quorumHash;
-    recSigOut.id = id;
-    recSigOut.msgHash = msgHash;
-    recSigOut.sig = recoveredSig;
+    CRecoveredSig recSig;
+    recSig.llmqType = session.llmqType;
+    recSig.quorumHash = session.quorumHash;
+    recSig.id = id;
+    recSig.msgHash = session.msgHash;
+    recSig.sig = recoveredSig;
+    
+    {
+        LOCK(cs);
+        recoveredSigs[id] = recSig;
+    }
     
+    LogPrintf("CSigningManager::%s -- Recovered signature for %s\n",
+              __func__, id.ToString().substr(0, 16));
+    return true;
+}
+
+bool CSigningManager::TryRecoverSignature(
+    LLMQType type,
+    const uint256& id,
+    const uint256& msgHash,
+    CRecoveredSig& recSigOut)
+{
+    // Recovery runs as soon as a session reaches its threshold (see
+    // ProcessSigShare), so there is nothing to rescan here
+    LOCK(cs);
+    
+    auto it = recoveredSigs.find(id);
+    if (it == recoveredSigs.end() || it->second.llmqType != type || it->second.msgHash != msgHash) {
+        return false;
+    }
+    
+    recSigOut = it->second;
     return true;
 }
 
@@ -612,17 +1087,52 @@ bool CSigningManager::VerifyRecoveredSig(const CRecoveredSig& recSig) const
     return recSig.sig.VerifyInsecure(quorum->quorumPublicKey, signHash);
 }
 
-void CSigningManager::Cleanup(int currentHeight)
+void CSigningManager::AsyncVerifyRecoveredSig(
+    const CRecoveredSig& recSig,
+    CBLSWorker::SigVerifyDoneCallback doneCallback) const
 {
-    LOCK(cs);
+    auto quorum = quorumManager.GetQuorum(recSig.llmqType, recSig.quorumHash);
+    if (!recSig.sig.IsValid() || !quorum || !quorum->IsValid()) {
+        doneCallback(false);
+        return;
+    }
     
-    // Remove old signature sessions
-    // In production, use proper expiry logic
-    if (sigShares.size() > 10000) {
-        sigShares.clear();
-        LogPrintf("CSigningManager::%s -- Cleared signature shares cache\n", __func__);
+    blsWorker.AsyncVerifySig(recSig.sig, quorum->quorumPublicKey, recSig.BuildSignHash(),
+                             std::move(doneCallback));
+}
+
+uint256 CSigningManager::BuildSignHash(LLMQType type, const uint256& quorumHash,
+                                       const uint256& id, const uint256& msgHash)
+{
+    CHashWriter hw(SER_GETHASH, PROTOCOL_VERSION);
+    hw << static_cast<uint8_t>(type);
+    hw << quorumHash;
+    hw << id;
+    hw << msgHash;
+    return hw.GetHash();
+}
+
+void CSigningManager::Cleanup(int currentHeight)
+{
+    // Remove expired signature sessions, one shard at a time
+    int64_t nExpireTime = GetTime() - SIG_SHARES_SESSION_TIMEOUT;
+    size_t nRemoved = 0;
+    for (auto& shard : sigSharesShards) {
+        std::lock_guard<std::mutex> lock(shard.cs);
+        for (auto it = shard.sessions.begin(); it != shard.sessions.end(); ) {
+            if (it->second.nTimeCreated < nExpireTime) {
+                it = shard.sessions.erase(it);
+                nRemoved++;
+            } else {
+                ++it;
+            }
+        }
+    }
+    if (nRemoved > 0) {
+        LogPrint(BCLog::LLMQ, "CSigningManager::%s -- Removed %u expired signing sessions\n", __func__, nRemoved);
     }
     
+    LOCK(cs);
     if (recoveredSigs.size() > 10000) {
         recoveredSigs.clear();
         LogPrintf("CSigningManager::%s -- Cleared recovered sigs cache\n", __func__);
@@ -640,11 +1150,21 @@ void InitLLMQ()
     quorumManager = std::make_unique<CQuorumManager>();
     signingManager = std::make_unique<CSigningManager>(*quorumManager);
     
+    blsWorker.Start(gArgs.GetArg("-blsverifythreads", DEFAULT_BLS_VERIFY_THREADS));
+    signingManager->StartIngressWorker();
+    
     LogPrintf("LLMQ subsystem initialized\n");
 }
 
 void StopLLMQ()
 {
+    // Stop the share ingress and then the verification pool first, pending
+    // batches and callbacks reference the managers
+    if (signingManager) {
+        signingManager->StopIngressWorker();
+    }
+    blsWorker.Stop();
+    
     signingManager.reset();
     quorumManager.reset();
     
@@ -6,17 +6,26 @@
 #define MYNTA_LLMQ_QUORUMS_H
 
 #include "bls/bls.h"
+#include "bls/bls_worker.h"
 #include "evo/deterministicmns.h"
+#include "mpscqueue.h"
 #include "serialize.h"
 #include "sync.h"
 #include "uint256.h"
 
+#include <array>
+#include <atomic>
+#include <condition_variable>
 #include <map>
 #include <memory>
+#include <mutex>
 #include <set>
+#include <thread>
+#include <unordered_map>
 #include <vector>
 
 class CBlockIndex;
+class CEvoDB;
 class CValidationState;
 
 namespace llmq {
@@ -68,26 +77,64 @@ struct CQuorumMember {
 
 /**
  * CQuorumSnapshot - State of a quorum at a specific height
+ *
+ * Written to the evo database when a quorum is first built, so verifying a
+ * lock or recovered sig of an old quorum, as during reindex or catch-up,
+ * reads it back instead of rebuilding the masternode list at that height and
+ * selecting the members again.
  */
 class CQuorumSnapshot
 {
 public:
     LLMQType llmqType{LLMQType::LLMQ_NONE};
     uint256 quorumHash;              // Hash identifying this quorum
-    int quorumHeight;                // Height when quorum was formed
+    int quorumHeight{-1};            // Height when quorum was formed
     std::vector<bool> activeMembers; // Bitmask of active members
     std::vector<bool> skipList;      // Members to skip (PoSe banned etc)
+    std::vector<uint256> members;    // proTxHash of every member
+    std::vector<CBLSPublicKey> memberPubKeys; // Operator key of every member
+    CBLSPublicKey quorumPublicKey;   // Aggregate of the active members' keys
     
     ADD_SERIALIZE_METHODS;
     
     template <typename Stream, typename Operation>
     inline void SerializationOp(Stream& s, Operation ser_action)
     {
-        READWRITE(llmqType);
+        uint8_t typeVal = static_cast<uint8_t>(llmqType);
+        READWRITE(typeVal);
+        if (ser_action.ForRead()) {
+            llmqType = static_cast<LLMQType>(typeVal);
+        }
         READWRITE(quorumHash);
         READWRITE(quorumHeight);
-        READWRITE(activeMembers);
-        READWRITE(skipList);
+        SerializeBits(s, ser_action, activeMembers);
+        SerializeBits(s, ser_action, skipList);
+        READWRITE(members);
+        READWRITE(memberPubKeys);
+        READWRITE(quorumPublicKey);
+    }
+
+private:
+    // A bit vector as its size and the bits packed eight to a byte
+    template <typename Stream, typename Operation>
+    static void SerializeBits(Stream& s, Operation ser_action, std::vector<bool>& vBits)
+    {
+        uint32_t nBits = vBits.size();
+        std::vector<uint8_t> vBytes((vBits.size() + 7) / 8);
+        for (size_t i = 0; i < vBits.size(); i++) {
+            vBytes[i / 8] |= vBits[i] << (i % 8);
+        }
+        READWRITE(nBits);
+        READWRITE(vBytes);
+        if (ser_action.ForRead()) {
+            if (vBytes.size() != (nBits + 7) / 8) {
+                throw std::ios_base::failure("quorum snapshot bit vector size mismatch");
+            }
+            vBits.resize(nBits);
+            for (size_t i = 0; i < nBits; i++) {
+                vBits[i] = (vBytes[i / 8] >> (i % 8)) & 1;
+            }
+        }
     }
 };
 
@@ -155,6 +202,14 @@ public:
 using CQuorumPtr = std::shared_ptr<CQuorum>;
 using CQuorumCPtr = std::shared_ptr<const CQuorum>;
 
+// The snapshot persisted for a quorum, and the quorum restored from one
+CQuorumSnapshot MakeQuorumSnapshot(const CQuorum& quorum);
+CQuorumPtr QuorumFromSnapshot(const CQuorumSnapshot& snapshot);
+
+// Quorum snapshots in the evo database, by quorum hash
+bool ReadQuorumSnapshot(const CEvoDB& db, const uint256& quorumHash, CQuorumSnapshot& snapshotOut);
+void WriteQuorumSnapshot(CEvoDB& db, const CQuorumSnapshot& snapshot);
+
 /**
  * CRecoveredSig - A threshold-recovered signature from a quorum
  */
@@ -198,6 +253,44 @@ public:
     std::string ToString() const;
 };
 
+/** Most shares one CBatchedSigShares may carry; no quorum is bigger */
+static const size_t MAX_SIG_SHARES_PER_BATCH = 400;
+/** Most batches in a single qsigshares message */
+static const size_t MAX_SIG_SHARE_BATCHES_PER_MESSAGE = 64;
+
+/**
+ * CBatchedSigShares - Signature shares of one signing session, as relayed in
+ * qsigshares messages
+ *
+ * Members are referred to by their index in the quorum instead of their
+ * proTxHash, which keeps a full quorum's worth of shares compact.
+ */
+class CBatchedSigShares
+{
+public:
+    LLMQType llmqType{LLMQType::LLMQ_NONE};
+    uint256 quorumHash;
+    uint256 id;
+    uint256 msgHash;
+    std::vector<std::pair<uint16_t, CBLSSignature>> shares;
+    
+    ADD_SERIALIZE_METHODS;
+    
+    template <typename Stream, typename Operation>
+    inline void SerializationOp(Stream& s, Operation ser_action)
+    {
+        uint8_t typeVal = static_cast<uint8_t>(llmqType);
+        READWRITE(typeVal);
+        if (ser_action.ForRead()) {
+            llmqType = static_cast<LLMQType>(typeVal);
+        }
+        READWRITE(quorumHash);
+        READWRITE(id);
+        READWRITE(msgHash);
+        READWRITE(shares);
+    }
+};
+
 /**
  * CQuorumManager - Manages quorum lifecycle and selection
  */
@@ -206,17 +299,27 @@ class CQuorumManager
 private:
     mutable CCriticalSection cs;
     
-    // Cached quorums by type and hash
-    std::map<std::pair<LLMQType, uint256>, CQuorumCPtr> quorumCache;
+    // Cached quorums by type and hash, built here or loaded from their snapshot
+    mutable std::map<std::pair<LLMQType, uint256>, CQuorumCPtr> quorumCache;
     
     // Active quorums per type (most recent first)
     std::map<LLMQType, std::vector<CQuorumCPtr>> activeQuorums;
     
+    // Memoized member selections by type and quorum hash, so a quorum's
+    // members are computed once even when the quorum itself is not valid
+    struct CQuorumMembersEntry {
+        int nHeight;
+        std::vector<CDeterministicMNCPtr> members;
+    };
+    std::map<std::pair<LLMQType, uint256>, CQuorumMembersEntry> quorumMembersCache;
+    static const size_t MAX_QUORUM_MEMBERS_CACHE = 256;
+    
     // Our node's proTxHash (if we're a masternode)
     uint256 myProTxHash;
     
 public:
     CQuorumManager();
+    ~CQuorumManager();
     
     // Set our identity
     void SetMyProTxHash(const uint256& _proTxHash);
@@ -227,7 +330,8 @@ public:
     // Build quorum for a given height
     CQuorumCPtr BuildQuorum(LLMQType type, const CBlockIndex* pindex);
     
-    // Get quorum by hash
+    // Get quorum by hash, from its snapshot in the evo database if it was
+    // built before and isn't cached
     CQuorumCPtr GetQuorum(LLMQType type, const uint256& quorumHash) const;
     
     // Get active signing quorums
@@ -246,46 +350,139 @@ public:
     // Get our secret key share for a quorum (if we're a member)
     bool GetSecretKeyShare(LLMQType type, const uint256& quorumHash,
                            CBLSSecretKey& skShareOut) const;
+    
+    // Estimated bytes held by the quorum cache
+    size_t GetCacheUsage() const;
+    
+    // Drop cached quorums, oldest first, until about nBytes are freed; returns
+    // the bytes freed. Only quorums that can be reloaded from their snapshot
+    // and aren't active or holding our key share are dropped
+    size_t EvictCache(size_t nBytes);
 
 private:
+    // Estimated bytes a cached quorum holds, with its cache entry
+    static size_t QuorumUsage(const CQuorum& quorum);
+    
+    // Members of the quorum of this type at pindex, memoized per (type, quorumHash)
+    const std::vector<CDeterministicMNCPtr>& GetQuorumMembers(
+        LLMQType type,
+        const uint256& quorumHash,
+        const CBlockIndex* pindex);
+    
     // Deterministically select members for a quorum
     std::vector<CDeterministicMNCPtr> SelectQuorumMembers(
         LLMQType type, 
         const CBlockIndex* pindex) const;
-    
-    // Score a masternode for quorum selection
-    uint256 CalcMemberScore(const CDeterministicMNCPtr& mn, 
-                            const uint256& quorumModifier) const;
 };
 
+/** Number of independently locked shards of the sig share store */
+static const size_t SIG_SHARES_SHARD_COUNT = 16;
+/** Seconds a signing session is kept before Cleanup drops it */
+static const int64_t SIG_SHARES_SESSION_TIMEOUT = 10 * 60;
+/** Received share batches waiting for the ingress worker; more are dropped */
+static const size_t SIG_SHARES_INGRESS_SIZE = 256;
+
 /**
  * CSigningManager - Manages signature sessions
+ * 
+ * Sig shares are collected per signing session (request id) in a store that
+ * is sharded by id, each shard with its own lock, so shares for different
+ * sessions don't contend with each other or with recovery. As soon as a
+ * session holds threshold shares the signature is recovered (outside of the
+ * shard lock) and stored in recoveredSigs.
+ *
+ * Batches received from peers are pushed onto a lock-free ingress queue and
+ * return to the message handler straight away. A dedicated worker drains the
+ * queue, looks up each quorum once per drain and drops (id, proTxHash) pairs
+ * it has already seen before handing the rest to the BLS worker, so a flood
+ * of shares neither blocks the message handler nor gets verified twice.
  */
 class CSigningManager
 {
 private:
     mutable CCriticalSection cs;
     
-    // Pending signature shares we've received
-    std::map<uint256, std::map<uint256, CBLSSignature>> sigShares; // id -> (proTxHash -> sig)
-    
-    // Recovered signatures
+    struct CSigSharesSession {
+        LLMQType llmqType{LLMQType::LLMQ_NONE};
+        uint256 quorumHash;
+        uint256 msgHash;
+        int nThreshold{0};
+        int64_t nTimeCreated{0};
+        bool fRecovered{false};
+        
+        // (proTxHash, share) in arrival order; a session never holds more
+        // than one quorum's worth of shares, so a flat vector is enough
+        std::vector<std::pair<uint256, CBLSSignature>> shares;
+    };
+    
+    struct SessionIdHasher {
+        size_t operator()(const uint256& id) const { return id.GetCheapHash(); }
+    };
+    
+    struct CSigSharesShard {
+        std::mutex cs;
+        std::unordered_map<uint256, CSigSharesSession, SessionIdHasher> sessions;
+        // (id, proTxHash) of shares queued on the BLS worker, so copies of a
+        // share arriving from several peers are only verified once
+        std::set<std::pair<uint256, uint256>> verifying;
+    };
+    
+    // Pending signature shares by session id, guarded per shard (not by cs)
+    std::array<CSigSharesShard, SIG_SHARES_SHARD_COUNT> sigSharesShards;
+    
+    // Recovered signatures, guarded by cs
     std::map<uint256, CRecoveredSig> recoveredSigs;
     
+    // Verified or own shares not relayed yet, by session id
+    std::mutex csRelay;
+    std::map<uint256, CBatchedSigShares> sigSharesToRelay;
+    
     // Reference to quorum manager
     CQuorumManager& quorumManager;
     
+    // Peer batches waiting for the ingress worker
+    CMPSCQueue<CBatchedSigShares> sigSharesIngress{SIG_SHARES_INGRESS_SIZE};
+    std::thread ingressThread;
+    std::atomic<bool> fIngressRunning{false};
+    // Only used to sleep and wake the ingress worker, never to access the queue
+    std::mutex csIngressWake;
+    std::condition_variable condIngress;
+    std::atomic<bool> fIngressSleeping{false};
+    std::atomic<uint64_t> nIngressDropped{0};
+    
 public:
     explicit CSigningManager(CQuorumManager& _quorumManager);
+    ~CSigningManager();
+    
+    // Start and stop the worker draining the ingress queue. Without it
+    // received batches are processed on the caller's thread.
+    void StartIngressWorker();
+    void StopIngressWorker();
     
     // Sign a message (if we're a quorum member)
     bool AsyncSign(LLMQType type, const uint256& id, const uint256& msgHash);
     
-    // Process a signature share from another member
-    bool ProcessSigShare(const uint256& quorumHash, const uint256& id,
-                         const uint256& proTxHash, const CBLSSignature& sigShare);
+    // Store an already verified signature share, recovering the threshold
+    // signature once the session has enough shares
+    bool ProcessSigShare(LLMQType type, const uint256& quorumHash, const uint256& id,
+                         const uint256& msgHash, const uint256& proTxHash,
+                         const CBLSSignature& sigShare);
+    
+    // Verify a signature share against the member's operator key on the
+    // BLS worker and store it once it checks out
+    void AsyncProcessSigShare(LLMQType type, const uint256& quorumHash, const uint256& id,
+                              const uint256& msgHash, const uint256& proTxHash,
+                              const CBLSSignature& sigShare);
+    
+    // Queue a batch of shares received from a peer for the ingress worker,
+    // which has them verified on the BLS worker and stores the valid ones.
+    // Returns false, leaving batch untouched, if it is malformed.
+    bool AsyncProcessSigShares(CBatchedSigShares&& batch);
     
-    // Try to recover a signature
+    // Take the shares verified or made since the last call, for relay to peers
+    void GetSigSharesToRelay(std::vector<CBatchedSigShares>& vBatchesOut);
+    
+    // Get the signature recovered for id/msgHash, if its session reached the threshold
     bool TryRecoverSignature(LLMQType type, const uint256& id, const uint256& msgHash,
                              CRecoveredSig& recSigOut);
     
@@ -295,8 +492,44 @@ public:
     // Verify a recovered signature
     bool VerifyRecoveredSig(const CRecoveredSig& recSig) const;
     
+    // Verify a recovered signature on the BLS worker
+    void AsyncVerifyRecoveredSig(const CRecoveredSig& recSig,
+                                 CBLSWorker::SigVerifyDoneCallback doneCallback) const;
+    
+    // Message hash signed by quorum members
+    static uint256 BuildSignHash(LLMQType type, const uint256& quorumHash,
+                                 const uint256& id, const uint256& msgHash);
+    
     // Cleanup old sessions
     void Cleanup(int currentHeight);
+
+private:
+    CSigSharesShard& GetShard(const uint256& id)
+    {
+        // GetCheapHash() uses the first bytes for the hash map, shard on the last
+        return sigSharesShards[*(id.end() - 1) % SIG_SHARES_SHARD_COUNT];
+    }
+    
+    void ThreadIngress();
+    
+    // Check a batch against its quorum and queue its shares for
+    // verification, skipping pairs already in seen. Returns false if a
+    // member index is out of range.
+    bool ProcessIngressBatch(const CBatchedSigShares& batch,
+                             std::map<std::pair<LLMQType, uint256>, CQuorumCPtr>& quorums,
+                             std::set<std::pair<uint256, uint256>>& seen);
+    
+    // Queue the share of the quorum member at memberIndex for verification,
+    // unless that share is already stored or being verified
+    void AsyncVerifySigShare(const CQuorumCPtr& quorum, const uint256& id, const uint256& msgHash,
+                             int memberIndex, const CBLSSignature& sigShare);
+    
+    void QueueSigShareForRelay(LLMQType type, const uint256& quorumHash, const uint256& id,
+                               const uint256& msgHash, int memberIndex, const CBLSSignature& sigShare);
+    
+    // Recover and store the signature of a session that reached its threshold
+    bool RecoverSession(const uint256& id, const CSigSharesSession& session,
+                        const std::vector<std::pair<uint256, CBLSSignature>>& shares);
 };
 
 // Global instances
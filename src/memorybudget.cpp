@@ -0,0 +1,125 @@
+// Copyright (c) 2026 The Mynta Core Developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include "memorybudget.h"
+
+#include "util.h"
+
+#include <algorithm>
+
+CMemoryBudget g_memoryBudget;
+
+void CMemoryBudget::Register(const std::string& strName, UsageFunction usage, EvictFunction evict)
+{
+    std::lock_guard<std::mutex> lock(cs);
+    CConsumer& consumer = mapConsumers[strName];
+    consumer.usage = std::move(usage);
+    consumer.evict = std::move(evict);
+}
+
+void CMemoryBudget::Unregister(const std::string& strName)
+{
+    std::lock_guard<std::mutex> lock(cs);
+    mapConsumers.erase(strName);
+}
+
+void CMemoryBudget::UnregisterAll()
+{
+    std::lock_guard<std::mutex> lock(cs);
+    mapConsumers.clear();
+}
+
+void CMemoryBudget::SetBudget(size_t nBytes)
+{
+    std::lock_guard<std::mutex> lock(cs);
+    nBudget = nBytes;
+}
+
+size_t CMemoryBudget::GetBudget() const
+{
+    std::lock_guard<std::mutex> lock(cs);
+    return nBudget;
+}
+
+uint64_t CMemoryBudget::GetPressureEvents() const
+{
+    std::lock_guard<std::mutex> lock(cs);
+    return nPressureEvents;
+}
+
+std::vector<CMemoryConsumerStats> CMemoryBudget::GetStats() const
+{
+    std::vector<CMemoryConsumerStats> vStats;
+    std::vector<UsageFunction> vUsage;
+    {
+        std::lock_guard<std::mutex> lock(cs);
+        for (const auto& entry : mapConsumers) {
+            CMemoryConsumerStats stats;
+            stats.strName = entry.first;
+            stats.fEvictable = bool(entry.second.evict);
+            stats.nEvictions = entry.second.nEvictions;
+            stats.nEvictedBytes = entry.second.nEvictedBytes;
+            vStats.push_back(stats);
+            vUsage.push_back(entry.second.usage);
+        }
+    }
+    // Measure outside the lock, the callbacks take the caches' own locks
+    for (size_t i = 0; i < vStats.size(); i++)
+        vStats[i].nUsage = vUsage[i]();
+    return vStats;
+}
+
+size_t CMemoryBudget::Enforce()
+{
+    struct CMeasured {
+        std::string strName;
+        UsageFunction usage;
+        EvictFunction evict;
+        size_t nUsage;
+    };
+    std::vector<CMeasured> vMeasured;
+    size_t nLimit;
+    {
+        std::lock_guard<std::mutex> lock(cs);
+        nLimit = nBudget;
+        if (nLimit == 0)
+            return 0;
+        for (const auto& entry : mapConsumers)
+            vMeasured.push_back(CMeasured{entry.first, entry.second.usage, entry.second.evict, 0});
+    }
+
+    size_t nTotal = 0;
+    for (size_t i = 0; i < vMeasured.size(); i++) {
+        vMeasured[i].nUsage = vMeasured[i].usage();
+        nTotal += vMeasured[i].nUsage;
+    }
+    if (nTotal <= nLimit)
+        return 0;
+
+    size_t nExcess = nTotal - nLimit;
+    std::sort(vMeasured.begin(), vMeasured.end(), [](const CMeasured& a, const CMeasured& b) {
+        return a.nUsage > b.nUsage;
+    });
+    size_t nFreedTotal = 0;
+    for (const CMeasured& measured : vMeasured) {
+        if (nFreedTotal >= nExcess)
+            break;
+        if (!measured.evict || measured.nUsage == 0)
+            continue;
+        const size_t nFreed = measured.evict(std::min(nExcess - nFreedTotal, measured.nUsage));
+        nFreedTotal += nFreed;
+        std::lock_guard<std::mutex> lock(cs);
+        auto it = mapConsumers.find(measured.strName);
+        if (it != mapConsumers.end()) {
+            it->second.nEvictions++;
+            it->second.nEvictedBytes += nFreed;
+        }
+    }
+    {
+        std::lock_guard<std::mutex> lock(cs);
+        nPressureEvents++;
+    }
+    LogPrint(BCLog::BENCH, "CMemoryBudget::%s -- caches used %u bytes of %u, freed %u\n", __func__, nTotal, nLimit, nFreedTotal);
+    return nFreedTotal;
+}
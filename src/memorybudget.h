@@ -0,0 +1,86 @@
+// Copyright (c) 2026 The Mynta Core Developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#ifndef MYNTA_MEMORYBUDGET_H
+#define MYNTA_MEMORYBUDGET_H
+
+#include <functional>
+#include <map>
+#include <mutex>
+#include <stddef.h>
+#include <stdint.h>
+#include <string>
+#include <vector>
+
+/** Default for -memorybudget in MiB, 0 for no limit */
+static const int64_t DEFAULT_MEMORY_BUDGET = 0;
+/** Milliseconds between checks of the caches against the budget */
+static const int64_t MEMORY_BUDGET_INTERVAL = 1000;
+
+/** A cache's use of the node's memory budget, as getmemoryinfo and getcacheinfo report it */
+struct CMemoryConsumerStats
+{
+    std::string strName;
+    size_t nUsage{0};
+    //! whether the budget can make it free memory
+    bool fEvictable{false};
+    //! times it was asked to free memory, and how much it freed
+    uint64_t nEvictions{0};
+    uint64_t nEvictedBytes{0};
+};
+
+/**
+ * One memory budget for the caches of the node. Every cache registers how
+ * to measure its DynamicMemoryUsage and, if it can drop entries, how to
+ * free some bytes. Enforce, run from the scheduler, adds up the caches and
+ * while they exceed the budget asks the evictable ones, largest first, to
+ * free the difference. Caches that can't evict, such as the coins tip with
+ * its own flushing, still count, so their growth squeezes the others.
+ *
+ * Callbacks run without the budget's lock held and may take their cache's
+ * own locks, so a cache must not call into the budget while holding them.
+ */
+class CMemoryBudget
+{
+public:
+    typedef std::function<size_t()> UsageFunction;
+    //! Free about the given number of bytes, returning how many were freed
+    typedef std::function<size_t(size_t)> EvictFunction;
+
+private:
+    struct CConsumer {
+        UsageFunction usage;
+        EvictFunction evict;
+        uint64_t nEvictions{0};
+        uint64_t nEvictedBytes{0};
+    };
+
+    mutable std::mutex cs;
+    std::map<std::string, CConsumer> mapConsumers;
+    size_t nBudget{0};
+    uint64_t nPressureEvents{0};
+
+public:
+    /** Add a cache, or replace the callbacks of the cache of that name */
+    void Register(const std::string& strName, UsageFunction usage, EvictFunction evict = nullptr);
+    void Unregister(const std::string& strName);
+    void UnregisterAll();
+
+    /** Bytes all registered caches may use together, 0 for no limit */
+    void SetBudget(size_t nBytes);
+    size_t GetBudget() const;
+
+    /** Times Enforce found the caches over the budget */
+    uint64_t GetPressureEvents() const;
+
+    /** The current usage of every cache, by name */
+    std::vector<CMemoryConsumerStats> GetStats() const;
+
+    /** Bring the caches back within the budget as far as they can evict; returns the bytes freed */
+    size_t Enforce();
+};
+
+extern CMemoryBudget g_memoryBudget;
+
+#endif // MYNTA_MEMORYBUDGET_H
@@ -6,7 +6,9 @@
 #ifndef MYNTA_MEMUSAGE_H
 #define MYNTA_MEMUSAGE_H
 
+#include "flatmap.h"
 #include "indirectmap.h"
+#include "persistentmap.h"
 
 #include <stdlib.h>
 
@@ -131,6 +133,22 @@ static inline size_t IncrementalDynamicUsage(const indirectmap<X, Y>& m)
     return MallocUsage(sizeof(stl_tree_node<std::pair<const X*, Y> >));
 }
 
+// persistentmap nodes may be shared with other copies of the map; DynamicUsage
+// counts them as if this map owned all of them
+
+template<typename X, typename Y>
+static inline size_t DynamicUsage(const persistentmap<X, Y>& m)
+{
+    return MallocUsage(persistentmap<X, Y>::node_alloc_size()) * m.size();
+}
+
+template<typename X, typename Y>
+static inline size_t IncrementalDynamicUsage(const persistentmap<X, Y>& m)
+{
+    // Modifying a copy allocates a new node for every level on the path
+    return MallocUsage(persistentmap<X, Y>::node_alloc_size()) * (m.height() + 1);
+}
+
 template<typename X>
 static inline size_t DynamicUsage(const std::unique_ptr<X>& p)
 {
@@ -165,6 +183,17 @@ static inline size_t DynamicUsage(const std::unordered_map<X, Y, Z>& m)
     return MallocUsage(sizeof(unordered_node<std::pair<const X, Y> >)) * m.size() + MallocUsage(sizeof(void*) * m.bucket_count());
 }
 
+template<typename X, typename Y, typename Z, typename W>
+static inline size_t DynamicUsage(const flatmap<X, Y, Z, W>& m)
+{
+    size_t usage = MallocUsage(flatmap<X, Y, Z, W>::bucket_alloc_size() * m.bucket_count()) +
+                   MallocUsage(sizeof(void*) * m.free_list_capacity()) +
+                   MallocUsage(sizeof(void*) * m.chunk_count());
+    for (size_t i = 0; i < m.chunk_count(); i++)
+        usage += MallocUsage(flatmap<X, Y, Z, W>::slot_alloc_size() * flatmap<X, Y, Z, W>::chunk_capacity(i));
+    return usage;
+}
+
 }
 
 #endif // MYNTA_MEMUSAGE_H
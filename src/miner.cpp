@@ -14,6 +14,7 @@
 #include "consensus/tx_verify.h"
 #include "consensus/merkle.h"
 #include "consensus/validation.h"
+#include "epochcontext.h"
 #include "hash.h"
 #include "validation.h"
 #include "net.h"
@@ -32,8 +33,13 @@
 //#include "wallet/rpcwallet.h"
 
 
+#include <crypto/ethash/include/ethash/progpow.hpp>
+
 #include <boost/thread.hpp>
 #include <algorithm>
+#include <atomic>
+#include <limits>
+#include <mutex>
 #include <queue>
 #include <utility>
 
@@ -52,9 +58,10 @@ extern std::vector<CWalletRef> vpwallets;
 
 uint64_t nLastBlockTx = 0;
 uint64_t nLastBlockWeight = 0;
-uint64_t nMiningTimeStart = 0;
-uint64_t nHashesPerSec = 0;
-uint64_t nHashesDone = 0;
+std::atomic<int64_t> nMiningTimeStart{0};
+std::atomic<uint64_t> nHashesDone{0};
+std::atomic<int> nMinerThreads{0};
+std::atomic<bool> fMinerFullDataset{false};
 
 
 int64_t UpdateTime(CBlockHeader* pblock, const Consensus::Params& consensusParams, const CBlockIndex* pindexPrev)
@@ -72,14 +79,106 @@ int64_t UpdateTime(CBlockHeader* pblock, const Consensus::Params& consensusParam
     return nNewTime - nOldTime;
 }
 
+void CBlockAssetClaims::GetKeys(const CMempoolAssetRecord& record, std::vector<std::string>& vChanged, std::vector<std::string>& vDepended)
+{
+    // A letter for each kind of state keeps the keys of different kinds apart
+    if (!record.strNewAsset.empty())
+        vChanged.push_back("n" + record.strNewAsset);
+    for (const std::string& strAsset : record.vGlobalFreezes)
+        vChanged.push_back("g" + strAsset);
+    for (const std::string& strAsset : record.vGlobalUnfreezes)
+        vChanged.push_back("g" + strAsset);
+    for (const auto& tag : record.vAddedTags)
+        vChanged.push_back("q" + tag.first);
+    for (const auto& tag : record.vRemovedTags)
+        vChanged.push_back("q" + tag.first);
+    for (const std::string& strAsset : record.vVerifierChanges)
+        vChanged.push_back("v" + strAsset);
+    for (const auto& freeze : record.vAddressFreezes)
+        vChanged.push_back("f" + freeze.first + "/" + freeze.second);
+
+    for (const std::string& strAddress : record.vQualifierAddresses)
+        vDepended.push_back("q" + strAddress);
+    for (const std::string& strAsset : record.vVerifierAssets)
+        vDepended.push_back("v" + strAsset);
+    for (const std::string& strAsset : record.vGlobalFrozenAssets)
+        vDepended.push_back("g" + strAsset);
+    for (const auto& spend : record.vFrozenAddresses)
+        vDepended.push_back("f" + spend.first + "/" + spend.second);
+}
+
+bool CBlockAssetClaims::Conflicts(const CTxMemPool::setEntries& package) const
+{
+    std::set<std::string> setChanged;
+    std::set<std::string> setDepended;
+    for (const CTxMemPool::txiter& it : package) {
+        const CMempoolAssetRecord* record = it->GetAssetRecord();
+        if (!record)
+            continue;
+        std::vector<std::string> vChanged, vDepended;
+        GetKeys(*record, vChanged, vDepended);
+        for (const std::string& key : vChanged) {
+            if (mapChanged.count(key) || mapDepended.count(key) || setChanged.count(key) || setDepended.count(key))
+                return true;
+        }
+        for (const std::string& key : vDepended) {
+            if (mapChanged.count(key) || setChanged.count(key))
+                return true;
+        }
+        // Only checked against the other transactions, as a transaction may depend on state it changes itself
+        setChanged.insert(vChanged.begin(), vChanged.end());
+        setDepended.insert(vDepended.begin(), vDepended.end());
+    }
+    return false;
+}
+
+void CBlockAssetClaims::Add(const CTxMemPool::txiter& it)
+{
+    const CMempoolAssetRecord* record = it->GetAssetRecord();
+    if (!record)
+        return;
+    std::vector<std::string> vChanged, vDepended;
+    GetKeys(*record, vChanged, vDepended);
+    for (const std::string& key : vChanged)
+        mapChanged[key]++;
+    for (const std::string& key : vDepended)
+        mapDepended[key]++;
+}
+
+void CBlockAssetClaims::Remove(const CTxMemPool::txiter& it)
+{
+    const CMempoolAssetRecord* record = it->GetAssetRecord();
+    if (!record)
+        return;
+    std::vector<std::string> vChanged, vDepended;
+    GetKeys(*record, vChanged, vDepended);
+    auto fnRelease = [](std::map<std::string, int>& mapCount, const std::string& key) {
+        auto itCount = mapCount.find(key);
+        if (itCount != mapCount.end() && --itCount->second == 0)
+            mapCount.erase(itCount);
+    };
+    for (const std::string& key : vChanged)
+        fnRelease(mapChanged, key);
+    for (const std::string& key : vDepended)
+        fnRelease(mapDepended, key);
+}
+
+void CBlockAssetClaims::Clear()
+{
+    mapChanged.clear();
+    mapDepended.clear();
+}
+
 BlockAssembler::Options::Options() {
     blockMinFeeRate = CFeeRate(DEFAULT_BLOCK_MIN_TX_FEE);
     nBlockMaxWeight = GetMaxBlockWeight() - 4000;
+    fTestBlockValidity = true;
 }
 
 BlockAssembler::BlockAssembler(const CChainParams& params, const Options& options) : chainparams(params)
 {
     blockMinFeeRate = options.blockMinFeeRate;
+    fTestBlockValidity = options.fTestBlockValidity;
     // Limit weight to between 4K and MAX_BLOCK_WEIGHT-4K for sanity:
     nBlockMaxWeight = std::max<size_t>(4000, std::min<size_t>(GetMaxBlockWeight() - 4000, options.nBlockMaxWeight));
 }
@@ -99,6 +198,7 @@ static BlockAssembler::Options DefaultOptions(const CChainParams& params)
     } else {
         options.blockMinFeeRate = CFeeRate(DEFAULT_BLOCK_MIN_TX_FEE);
     }
+    options.fTestBlockValidity = gArgs.GetBoolArg("-testblocktemplate", params.DefaultConsistencyChecks());
     return options;
 }
 
@@ -107,6 +207,9 @@ BlockAssembler::BlockAssembler(const CChainParams& params) : BlockAssembler(para
 void BlockAssembler::resetBlock()
 {
     inBlock.clear();
+    vPackages.clear();
+    assetClaims.Clear();
+    pindexPrevBuilt = nullptr;
 
     // Reserve space for coinbase tx
     nBlockWeight = 4000;
@@ -128,7 +231,8 @@ std::unique_ptr<CBlockTemplate> BlockAssembler::CreateNewBlock(const CScript& sc
 
     if(!pblocktemplate.get())
         return nullptr;
-    pblock = &pblocktemplate->block; // pointer for convenience
+    ptemplate = pblocktemplate.get();
+    pblock = &ptemplate->block; // pointer for convenience
 
     // Add dummy coinbase tx as first transaction
     pblock->vtx.emplace_back();
@@ -167,6 +271,56 @@ std::unique_ptr<CBlockTemplate> BlockAssembler::CreateNewBlock(const CScript& sc
 
     int64_t nTime1 = GetTimeMicros();
 
+    FinishBlock(scriptPubKeyIn, pindexPrev);
+
+    LogPrintf("CreateNewBlock(): block weight: %u txs: %u fees: %ld sigops %d\n", GetBlockWeight(*pblock), nBlockTx, nFees, nBlockSigOpsCost);
+
+    // Package selection keeps clashing asset changes apart and every transaction
+    // passed the asset checks against this tip, so the full check of the block
+    // with a copy of the asset cache is a debugging aid
+    if (fTestBlockValidity) {
+        CValidationState state;
+        if (!TestBlockValidity(state, chainparams, *pblock, pindexPrev, false, false)) {
+            if (state.IsTransactionError()) {
+                if (gArgs.GetBoolArg("-autofixmempool", false)) {
+                    {
+                        TRY_LOCK(mempool.cs, fLockMempool);
+                        if (fLockMempool) {
+                            LogPrintf("%s failed because of a transaction %s. -autofixmempool is set to true. Clearing the mempool\n", __func__,
+                                      state.GetFailedTransaction().GetHex());
+                            mempool.clear();
+                        }
+                    }
+                } else {
+                    {
+                        TRY_LOCK(mempool.cs, fLockMempool);
+                        if (fLockMempool) {
+                            auto mempoolTx = mempool.get(state.GetFailedTransaction());
+                            if (mempoolTx) {
+                                LogPrintf("%s : Failed because of a transaction %s. Trying to remove the transaction from the mempool\n", __func__, state.GetFailedTransaction().GetHex());
+                                mempool.removeRecursive(*mempoolTx, MemPoolRemovalReason::CONFLICT);
+                            }
+                        }
+                    }
+                }
+            }
+            throw std::runtime_error(strprintf("%s: TestBlockValidity failed: %s", __func__, FormatStateMessage(state)));
+        }
+    }
+    int64_t nTime2 = GetTimeMicros();
+
+    LogPrint(BCLog::BENCH, "CreateNewBlock() packages: %.2fms (%d packages, %d updated descendants), validity: %.2fms (total %.2fms)\n", 0.001 * (nTime1 - nTimeStart), nPackagesSelected, nDescendantsUpdated, 0.001 * (nTime2 - nTime1), 0.001 * (nTime2 - nTimeStart));
+
+    pindexPrevBuilt = pindexPrev;
+    nPackagesChangedBuilt = mempool.GetPackagesChanged();
+    nMempoolSizeBuilt = mempool.mapTx.size();
+    nTimeBuilt = GetTime();
+
+    return std::move(pblocktemplate);
+}
+
+void BlockAssembler::FinishBlock(const CScript& scriptPubKeyIn, const CBlockIndex* pindexPrev)
+{
     nLastBlockTx = nBlockTx;
     nLastBlockWeight = nBlockWeight;
 
@@ -179,10 +333,8 @@ std::unique_ptr<CBlockTemplate> BlockAssembler::CreateNewBlock(const CScript& sc
     coinbaseTx.vout[0].nValue = nFees + GetBlockSubsidy(nHeight, chainparams.GetConsensus());
     coinbaseTx.vin[0].scriptSig = CScript() << nHeight << OP_0;
     pblock->vtx[0] = MakeTransactionRef(std::move(coinbaseTx));
-    pblocktemplate->vchCoinbaseCommitment = GenerateCoinbaseCommitment(*pblock, pindexPrev, chainparams.GetConsensus());
-    pblocktemplate->vTxFees[0] = -nFees;
-
-    LogPrintf("CreateNewBlock(): block weight: %u txs: %u fees: %ld sigops %d\n", GetBlockWeight(*pblock), nBlockTx, nFees, nBlockSigOpsCost);
+    ptemplate->vchCoinbaseCommitment = GenerateCoinbaseCommitment(*pblock, pindexPrev, chainparams.GetConsensus());
+    ptemplate->vTxFees[0] = -nFees;
 
     // Fill in header
     pblock->hashPrevBlock  = pindexPrev->GetBlockHash();
@@ -191,40 +343,107 @@ std::unique_ptr<CBlockTemplate> BlockAssembler::CreateNewBlock(const CScript& sc
     pblock->nNonce         = 0;
     pblock->nNonce64         = 0;
     pblock->nHeight          = nHeight;
-    pblocktemplate->vTxSigOpsCost[0] = WITNESS_SCALE_FACTOR * GetLegacySigOpCount(*pblock->vtx[0]);
+    ptemplate->vTxSigOpsCost[0] = WITNESS_SCALE_FACTOR * GetLegacySigOpCount(*pblock->vtx[0]);
+}
 
-    CValidationState state;
-    if (!TestBlockValidity(state, chainparams, *pblock, pindexPrev, false, false)) {
-        if (state.IsTransactionError()) {
-            if (gArgs.GetBoolArg("-autofixmempool", false)) {
-                {
-                    TRY_LOCK(mempool.cs, fLockMempool);
-                    if (fLockMempool) {
-                        LogPrintf("%s failed because of a transaction %s. -autofixmempool is set to true. Clearing the mempool\n", __func__,
-                                  state.GetFailedTransaction().GetHex());
-                        mempool.clear();
-                    }
-                }
-            } else {
-                {
-                    TRY_LOCK(mempool.cs, fLockMempool);
-                    if (fLockMempool) {
-                        auto mempoolTx = mempool.get(state.GetFailedTransaction());
-                        if (mempoolTx) {
-                            LogPrintf("%s : Failed because of a transaction %s. Trying to remove the transaction from the mempool\n", __func__, state.GetFailedTransaction().GetHex());
-                            mempool.removeRecursive(*mempoolTx, MemPoolRemovalReason::CONFLICT);
-                        }
-                    }
-                }
-            }
+bool BlockAssembler::UpdateBlock(CBlockTemplate& blocktemplate, const CScript& scriptPubKeyIn)
+{
+    int64_t nTimeStart = GetTimeMicros();
+
+    LOCK2(cs_main, mempool.cs);
+    CBlockIndex* pindexPrev = chainActive.Tip();
+    if (!pindexPrevBuilt || pindexPrev != pindexPrevBuilt || mempool.GetPackagesChanged() != nPackagesChangedBuilt)
+        return false;
+    ptemplate = &blocktemplate;
+    pblock = &ptemplate->block;
+
+    // Nothing left the mempool, so the transactions added since the template
+    // was built are its newest entries. They were accepted under cs_main after
+    // the build, so their entry time is no earlier than nTimeBuilt; if some
+    // were added with an older time (a loaded mempool), build anew instead.
+    const size_t nAdded = mempool.mapTx.size() - nMempoolSizeBuilt;
+    std::vector<CTxMemPool::txiter> vCandidates;
+    const auto& timeIndex = mempool.mapTx.get<entry_time>();
+    for (auto mi = timeIndex.end(); mi != timeIndex.begin(); ) {
+        --mi;
+        if (mi->GetTime() < nTimeBuilt)
+            break;
+        vCandidates.push_back(mempool.mapTx.project<0>(mi));
+    }
+    if (vCandidates.size() < nAdded)
+        return false;
+    std::sort(vCandidates.begin(), vCandidates.end(), [](CTxMemPool::txiter a, CTxMemPool::txiter b) {
+        return CompareTxMemPoolEntryByAncestorFee()(*a, *b);
+    });
+
+    int nPackagesSelected = 0;
+    int nPackagesRemoved = 0;
+    for (CTxMemPool::txiter iter : vCandidates) {
+        if (inBlock.count(iter))
+            continue;
+
+        CTxMemPool::setEntries ancestors;
+        uint64_t nNoLimit = std::numeric_limits<uint64_t>::max();
+        std::string dummy;
+        mempool.CalculateMemPoolAncestors(*iter, ancestors, nNoLimit, nNoLimit, nNoLimit, nNoLimit, dummy, false);
+        // Packages holding one of these can't be taken out to make room
+        const CTxMemPool::setEntries allAncestors = ancestors;
+        onlyUnconfirmed(ancestors);
+        ancestors.insert(iter);
+
+        uint64_t packageSize = 0;
+        CAmount packageFees = 0;
+        int64_t packageSigOpsCost = 0;
+        for (CTxMemPool::txiter it : ancestors) {
+            packageSize += it->GetTxSize();
+            packageFees += it->GetModifiedFee();
+            packageSigOpsCost += it->GetSigOpCost();
+        }
+        if (packageFees < blockMinFeeRate.GetFee(packageSize))
+            continue;
+        if (!TestPackageTransactions(ancestors) || assetClaims.Conflicts(ancestors))
+            continue;
+        const CFeeRate feeRate(packageFees, packageSize);
+
+        // Make room by taking out the last added packages, as long as they pay
+        // less than this one; they are never ancestors of an earlier package
+        uint64_t nWeightFreed = 0;
+        int64_t nSigOpsFreed = 0;
+        size_t nRemove = 0;
+        while (!TestPackage(packageSize, packageSigOpsCost, nWeightFreed, nSigOpsFreed) && nRemove < vPackages.size()) {
+            const CBlockTemplatePackage& package = vPackages[vPackages.size() - 1 - nRemove];
+            if (!(package.feeRate < feeRate))
+                break;
+            if (std::any_of(package.vTx.begin(), package.vTx.end(), [&allAncestors](CTxMemPool::txiter it) { return allAncestors.count(it) > 0; }))
+                break;
+            nWeightFreed += package.nWeight;
+            nSigOpsFreed += package.nSigOpsCost;
+            ++nRemove;
         }
-        throw std::runtime_error(strprintf("%s: TestBlockValidity failed: %s", __func__, FormatStateMessage(state)));
+        if (!TestPackage(packageSize, packageSigOpsCost, nWeightFreed, nSigOpsFreed))
+            continue;
+
+        for (size_t i = 0; i < nRemove; i++)
+            RemoveLastPackage();
+        nPackagesRemoved += nRemove;
+
+        std::vector<CTxMemPool::txiter> sortedEntries;
+        SortForBlock(ancestors, iter, sortedEntries);
+        AddPackageToBlock(sortedEntries, feeRate);
+        ++nPackagesSelected;
     }
-    int64_t nTime2 = GetTimeMicros();
 
-    LogPrint(BCLog::BENCH, "CreateNewBlock() packages: %.2fms (%d packages, %d updated descendants), validity: %.2fms (total %.2fms)\n", 0.001 * (nTime1 - nTimeStart), nPackagesSelected, nDescendantsUpdated, 0.001 * (nTime2 - nTime1), 0.001 * (nTime2 - nTimeStart));
+    // Every transaction in the template was accepted to the mempool on top of
+    // this tip with its ancestors before it, which is what TestBlockValidity
+    // checks the full build for; running it again would cost more than the update.
+    FinishBlock(scriptPubKeyIn, pindexPrev);
 
-    return std::move(pblocktemplate);
+    nMempoolSizeBuilt = mempool.mapTx.size();
+    nTimeBuilt = GetTime();
+
+    LogPrint(BCLog::BENCH, "UpdateBlock(): %u new transactions, %d packages added, %d taken out: %.2fms\n",
+             vCandidates.size(), nPackagesSelected, nPackagesRemoved, 0.001 * (GetTimeMicros() - nTimeStart));
+    return true;
 }
 
 void BlockAssembler::onlyUnconfirmed(CTxMemPool::setEntries& testSet)
@@ -240,12 +459,12 @@ void BlockAssembler::onlyUnconfirmed(CTxMemPool::setEntries& testSet)
     }
 }
 
-bool BlockAssembler::TestPackage(uint64_t packageSize, int64_t packageSigOpsCost) const
+bool BlockAssembler::TestPackage(uint64_t packageSize, int64_t packageSigOpsCost, uint64_t nWeightFreed, int64_t nSigOpsFreed) const
 {
     // TODO: switch to weight-based accounting for packages instead of vsize-based accounting.
-    if (nBlockWeight + WITNESS_SCALE_FACTOR * packageSize >= nBlockMaxWeight)
+    if (nBlockWeight - nWeightFreed + WITNESS_SCALE_FACTOR * packageSize >= nBlockMaxWeight)
         return false;
-    if (nBlockSigOpsCost + packageSigOpsCost >= MAX_BLOCK_SIGOPS_COST)
+    if (nBlockSigOpsCost - nSigOpsFreed + packageSigOpsCost >= MAX_BLOCK_SIGOPS_COST)
         return false;
     return true;
 }
@@ -268,8 +487,8 @@ bool BlockAssembler::TestPackageTransactions(const CTxMemPool::setEntries& packa
 void BlockAssembler::AddToBlock(CTxMemPool::txiter iter)
 {
     pblock->vtx.emplace_back(iter->GetSharedTx());
-    pblocktemplate->vTxFees.push_back(iter->GetFee());
-    pblocktemplate->vTxSigOpsCost.push_back(iter->GetSigOpCost());
+    ptemplate->vTxFees.push_back(iter->GetFee());
+    ptemplate->vTxSigOpsCost.push_back(iter->GetSigOpCost());
     nBlockWeight += iter->GetTxWeight();
     ++nBlockTx;
     nBlockSigOpsCost += iter->GetSigOpCost();
@@ -284,6 +503,39 @@ void BlockAssembler::AddToBlock(CTxMemPool::txiter iter)
     }
 }
 
+void BlockAssembler::AddPackageToBlock(const std::vector<CTxMemPool::txiter>& sortedEntries, const CFeeRate& feeRate)
+{
+    CBlockTemplatePackage package;
+    package.vTx = sortedEntries;
+    package.feeRate = feeRate;
+    for (CTxMemPool::txiter it : sortedEntries) {
+        AddToBlock(it);
+        assetClaims.Add(it);
+        package.nFees += it->GetFee();
+        package.nWeight += it->GetTxWeight();
+        package.nSigOpsCost += it->GetSigOpCost();
+    }
+    vPackages.push_back(std::move(package));
+}
+
+void BlockAssembler::RemoveLastPackage()
+{
+    const CBlockTemplatePackage& package = vPackages.back();
+    const size_t nTx = package.vTx.size();
+    pblock->vtx.resize(pblock->vtx.size() - nTx);
+    ptemplate->vTxFees.resize(ptemplate->vTxFees.size() - nTx);
+    ptemplate->vTxSigOpsCost.resize(ptemplate->vTxSigOpsCost.size() - nTx);
+    nBlockWeight -= package.nWeight;
+    nBlockTx -= nTx;
+    nBlockSigOpsCost -= package.nSigOpsCost;
+    nFees -= package.nFees;
+    for (CTxMemPool::txiter it : package.vTx) {
+        inBlock.erase(it);
+        assetClaims.Remove(it);
+    }
+    vPackages.pop_back();
+}
+
 int BlockAssembler::UpdatePackagesForAdded(const CTxMemPool::setEntries& alreadyAdded,
         indexed_modified_transaction_set &mapModifiedTx)
 {
@@ -448,8 +700,8 @@ void BlockAssembler::addPackageTxs(int &nPackagesSelected, int &nDescendantsUpda
         onlyUnconfirmed(ancestors);
         ancestors.insert(iter);
 
-        // Test if all tx's are Final
-        if (!TestPackageTransactions(ancestors)) {
+        // Test if all tx's are Final, and that their asset changes don't clash with the block's
+        if (!TestPackageTransactions(ancestors) || assetClaims.Conflicts(ancestors)) {
             if (fUsingModified) {
                 mapModifiedTx.get<ancestor_score>().erase(modit);
                 failedTx.insert(iter);
@@ -464,8 +716,8 @@ void BlockAssembler::addPackageTxs(int &nPackagesSelected, int &nDescendantsUpda
         std::vector<CTxMemPool::txiter> sortedEntries;
         SortForBlock(ancestors, iter, sortedEntries);
 
+        AddPackageToBlock(sortedEntries, CFeeRate(packageFees, packageSize));
         for (size_t i=0; i<sortedEntries.size(); ++i) {
-            AddToBlock(sortedEntries[i]);
             // Erase from the modified set, if present
             mapModifiedTx.erase(sortedEntries[i]);
         }
@@ -535,7 +787,92 @@ CWallet *GetFirstWallet() {
     return(NULL);
 }
 
-void static MyntaMiner(const CChainParams& chainparams)
+namespace {
+/**
+ * Full KAWPOW dataset shared by all miner threads. It is allocated once per
+ * epoch and filled in lazily by the ethash library as the search touches its
+ * items, so hashing starts close to light-cache speed and speeds up as the
+ * dataset fills. If the allocation fails the epoch stays on the light cache.
+ */
+class CMinerDataset
+{
+public:
+    typedef std::shared_ptr<const ethash_epoch_context_full> ContextPtr;
+
+private:
+    std::mutex cs;
+    int nEpoch{-1};
+    ContextPtr context;
+
+public:
+    ContextPtr Get(int nEpochIn)
+    {
+        std::lock_guard<std::mutex> lock(cs);
+        if (nEpoch != nEpochIn) {
+            // Drop our reference first so two datasets are never held here at once
+            context.reset();
+            context = ContextPtr(ethash_create_epoch_context_full(nEpochIn), ethash_destroy_epoch_context_full);
+            nEpoch = nEpochIn;
+            if (!context) {
+                LogPrintf("MyntaMiner -- could not allocate the full dataset for epoch %d, using the light cache\n", nEpochIn);
+            }
+        }
+        return context;
+    }
+
+    void Clear()
+    {
+        std::lock_guard<std::mutex> lock(cs);
+        context.reset();
+        nEpoch = -1;
+    }
+};
+
+CMinerDataset minerDataset;
+} // namespace
+
+/**
+ * Try the next KAWPOW_SEARCH_BATCH nonces of pblock with the ethash batched
+ * search and store the solution in pblock if one meets hashTarget.
+ */
+static bool SearchKAWPOW(CBlock* pblock, const arith_uint256& hashTarget, bool fFullDataset)
+{
+    const auto header_hash = ToEthashHash256(pblock->GetKAWPOWHeaderHash());
+    const auto boundary = ToEthashHash256(ArithToUint256(hashTarget));
+    const int nEpoch = ethash::get_epoch_number(pblock->nHeight);
+
+    ethash::search_result result;
+    CMinerDataset::ContextPtr full = fFullDataset ? minerDataset.Get(nEpoch) : nullptr;
+    if (full) {
+        result = progpow::search(*full, pblock->nHeight, header_hash, boundary, pblock->nNonce64, KAWPOW_SEARCH_BATCH);
+    } else {
+        const auto light = epochContextCache.GetForHeight(pblock->nHeight);
+        result = progpow::search_light(*light, pblock->nHeight, header_hash, boundary, pblock->nNonce64, KAWPOW_SEARCH_BATCH);
+    }
+
+    if (!result.solution_found) {
+        pblock->nNonce64 += KAWPOW_SEARCH_BATCH;
+        nHashesDone += KAWPOW_SEARCH_BATCH;
+        return false;
+    }
+    nHashesDone += result.nonce - pblock->nNonce64 + 1;
+    pblock->nNonce64 = result.nonce;
+    pblock->mix_hash = FromEthashHash256(result.mix_hash);
+
+    // The library fills the shared dataset without synchronisation, so
+    // recheck a solution found with it against the light cache
+    if (full) {
+        uint256 mix_hash;
+        if (UintToArith256(KAWPOWHash(*pblock, mix_hash)) > hashTarget || mix_hash != pblock->mix_hash) {
+            LogPrintf("MyntaMiner -- discarding KAWPOW solution at nonce %u that failed the light check\n", result.nonce);
+            pblock->nNonce64++;
+            return false;
+        }
+    }
+    return true;
+}
+
+void static MyntaMiner(const CChainParams& chainparams, int nThreadIndex, int nThreadCount, bool fFullDataset)
 {
     LogPrintf("MyntaMiner -- started\n");
     SetThreadPriority(THREAD_PRIORITY_LOWEST);
@@ -627,38 +964,47 @@ void static MyntaMiner(const CChainParams& chainparams)
             //
             int64_t nStart = GetTime();
             arith_uint256 hashTarget = arith_uint256().SetCompact(pblock->nBits);
+            // Every thread mines the same template, so split the nonce space between them
+            const uint32_t nNonceSpan = (0xffff0000 / nThreadCount) & ~0xFFu;
+            const uint32_t nNonceEnd = nNonceSpan * (nThreadIndex + 1);
+            pblock->nNonce = nNonceSpan * nThreadIndex;
+            pblock->nNonce64 = (std::numeric_limits<uint64_t>::max() / nThreadCount) * nThreadIndex;
             while (true)
             {
+                bool fFound = false;
+                if (pblock->nTime >= nKAWPOWActivationTime) {
+                    fFound = SearchKAWPOW(pblock, hashTarget, fFullDataset);
+                } else {
+                    uint256 mix_hash;
+                    while (true)
+                    {
+                        uint256 hash = pblock->GetHashFull(mix_hash);
+                        nHashesDone++;
+                        if (UintToArith256(hash) <= hashTarget) {
+                            fFound = true;
+                            break;
+                        }
+                        pblock->nNonce += 1;
+                        if ((pblock->nNonce & 0xFF) == 0)
+                            break;
+                    }
+                }
 
-                uint256 hash;
-                uint256 mix_hash;
-                while (true)
+                if (fFound)
                 {
-                    hash = pblock->GetHashFull(mix_hash);
-                    if (UintToArith256(hash) <= hashTarget)
-                    {
-                        pblock->mix_hash = mix_hash;
-                        // Found a solution
-                        SetThreadPriority(THREAD_PRIORITY_NORMAL);
-                        LogPrintf("MyntaMiner:\n  proof-of-work found\n  hash: %s\n  target: %s\n", hash.GetHex(), hashTarget.GetHex());
-                        ProcessBlockFound(pblock, chainparams);
-                        SetThreadPriority(THREAD_PRIORITY_LOWEST);
-                        coinbaseScript->KeepScript();
-
-                        // In regression test mode, stop mining after a block is found. This
-                        // allows developers to controllably generate a block on demand.
-                        if (chainparams.MineBlocksOnDemand())
-                            throw boost::thread_interrupted();
+                    // Found a solution
+                    SetThreadPriority(THREAD_PRIORITY_NORMAL);
+                    LogPrintf("MyntaMiner:\n  proof-of-work found\n  hash: %s\n  target: %s\n", pblock->GetHash().GetHex(), hashTarget.GetHex());
+                    ProcessBlockFound(pblock, chainparams);
+                    SetThreadPriority(THREAD_PRIORITY_LOWEST);
+                    coinbaseScript->KeepScript();
+
+                    // In regression test mode, stop mining after a block is found. This
+                    // allows developers to controllably generate a block on demand.
+                    if (chainparams.MineBlocksOnDemand())
+                        throw boost::thread_interrupted();
 
-                        break;
-                    }
-                    pblock->nNonce += 1;
-                    nHashesDone += 1;
-                    if (nHashesDone % 500000 == 0) {   //Calculate hashing speed
-                        nHashesPerSec = nHashesDone / (((GetTimeMicros() - nMiningTimeStart) / 1000000) + 1);
-                    } 
-                    if ((pblock->nNonce & 0xFF) == 0)
-                        break;
+                    break;
                 }
 
                 // Check for stop or if block needs to be rebuilt
@@ -666,7 +1012,7 @@ void static MyntaMiner(const CChainParams& chainparams)
                 // Regtest mode doesn't require peers
                 //if (vNodes.empty() && chainparams.MiningRequiresPeers())
                 //    break;
-                if (pblock->nNonce >= 0xffff0000)
+                if (pblock->nNonce >= nNonceEnd)
                     break;
                 if (mempool.GetTransactionsUpdated() != nTransactionsUpdatedLast && GetTime() - nStart > 60)
                     break;
@@ -697,6 +1043,21 @@ void static MyntaMiner(const CChainParams& chainparams)
     }
 }
 
+CMinerHashRate GetMinerHashRate()
+{
+    CMinerHashRate stats;
+    stats.nThreads = nMinerThreads;
+    stats.fFullDataset = fMinerFullDataset;
+    stats.nHashesDone = nHashesDone;
+    if (stats.nThreads > 0) {
+        stats.nElapsedMicros = GetTimeMicros() - nMiningTimeStart;
+        if (stats.nElapsedMicros > 0) {
+            stats.nHashesPerSec = (uint64_t)(stats.nHashesDone * 1000000.0 / stats.nElapsedMicros);
+        }
+    }
+    return stats;
+}
+
 int GenerateMyntas(bool fGenerate, int nThreads, const CChainParams& chainparams)
 {
 
@@ -713,18 +1074,26 @@ int GenerateMyntas(bool fGenerate, int nThreads, const CChainParams& chainparams
         minerThreads = NULL;
     }
 
-    if (nThreads == 0 || !fGenerate)
+    nMinerThreads = 0;
+    if (nThreads == 0 || !fGenerate) {
+        minerDataset.Clear();
         return numCores;
+    }
 
     minerThreads = new boost::thread_group();
     
     //Reset metrics
     nMiningTimeStart = GetTimeMicros();
     nHashesDone = 0;
-    nHashesPerSec = 0;
+    nMinerThreads = nThreads;
 
+    const bool fFullDataset = gArgs.GetBoolArg("-minerfulldataset", DEFAULT_MINER_FULL_DATASET);
+    fMinerFullDataset = fFullDataset;
+    if (!fFullDataset) {
+        minerDataset.Clear();
+    }
     for (int i = 0; i < nThreads; i++){
-        minerThreads->create_thread(boost::bind(&MyntaMiner, boost::cref(chainparams)));
+        minerThreads->create_thread(boost::bind(&MyntaMiner, boost::cref(chainparams), i, nThreads, fFullDataset));
     }
 
     return(numCores);
@@ -11,7 +11,10 @@
 #include "txmempool.h"
 
 #include <stdint.h>
+#include <map>
 #include <memory>
+#include <string>
+#include <vector>
 #include <boost/multi_index_container.hpp>
 #include <boost/multi_index/ordered_index.hpp>
 
@@ -22,6 +25,10 @@ class CScript;
 namespace Consensus { struct Params; };
 
 static const bool DEFAULT_PRINTPRIORITY = false;
+/** Default for -minerfulldataset: search KAWPOW with the light cache only */
+static const bool DEFAULT_MINER_FULL_DATASET = false;
+/** Nonces each miner thread tries per progpow search call between checks for a new tip */
+static const size_t KAWPOW_SEARCH_BATCH = 64;
 
 struct CBlockTemplate
 {
@@ -129,19 +136,58 @@ struct update_for_parent_inclusion
     CTxMemPool::txiter iter;
 };
 
+/**
+ * The asset state the transactions of a block template change and depend on,
+ * taken from their mempool asset records. Each mempool transaction passed the
+ * asset checks against the tip alone, so two that change the same state, or
+ * one that depends on state another changes (the qualifiers of an address it
+ * sends a restricted asset to, the verifier or freezes of a restricted asset
+ * it sends or spends), may not be valid in the same block. Packages clashing
+ * with the template this way are left out of it.
+ */
+class CBlockAssetClaims
+{
+private:
+    //! number of template transactions changing, and depending on, each piece of state
+    std::map<std::string, int> mapChanged;
+    std::map<std::string, int> mapDepended;
+
+    static void GetKeys(const CMempoolAssetRecord& record, std::vector<std::string>& vChanged, std::vector<std::string>& vDepended);
+
+public:
+    /** Whether the asset records of a package clash with the template or with each other */
+    bool Conflicts(const CTxMemPool::setEntries& package) const;
+    void Add(const CTxMemPool::txiter& it);
+    void Remove(const CTxMemPool::txiter& it);
+    void Clear();
+};
+
+/** A package of transactions added to a block template in one step */
+struct CBlockTemplatePackage
+{
+    std::vector<CTxMemPool::txiter> vTx;
+    CFeeRate feeRate; //!< modified fees of the package over its size
+    CAmount nFees{0};
+    uint64_t nWeight{0};
+    int64_t nSigOpsCost{0};
+};
+
 /** Generate a new block, without valid proof-of-work */
 class BlockAssembler
 {
 private:
     // The constructed block template
     std::unique_ptr<CBlockTemplate> pblocktemplate;
-    // A convenience pointer that always refers to the CBlock in pblocktemplate
+    // A convenience pointer that always refers to the template being built or updated
+    CBlockTemplate* ptemplate;
+    // A convenience pointer that always refers to the CBlock in ptemplate
     CBlock* pblock;
 
     // Configuration parameters for the block size
     bool fIncludeWitness;
     unsigned int nBlockMaxWeight;
     CFeeRate blockMinFeeRate;
+    bool fTestBlockValidity;
 
     // Information on the current status of the block
     uint64_t nBlockWeight;
@@ -150,16 +196,28 @@ private:
     CAmount nFees;
     CTxMemPool::setEntries inBlock;
 
+    // Packages in the order they were added, so UpdateBlock can take the last ones out again
+    std::vector<CBlockTemplatePackage> vPackages;
+    CBlockAssetClaims assetClaims;
+
     // Chain context for the block
     int nHeight;
     int64_t nLockTimeCutoff;
     const CChainParams& chainparams;
 
+    // What the last template was built from, for UpdateBlock
+    const CBlockIndex* pindexPrevBuilt{nullptr};
+    unsigned int nPackagesChangedBuilt{0};
+    size_t nMempoolSizeBuilt{0};
+    int64_t nTimeBuilt{0};
+
 public:
     struct Options {
         Options();
         size_t nBlockMaxWeight;
         CFeeRate blockMinFeeRate;
+        //! Run TestBlockValidity on every new template; -testblocktemplate
+        bool fTestBlockValidity;
     };
 
     explicit BlockAssembler(const CChainParams& params);
@@ -168,12 +226,28 @@ public:
     /** Construct a new block template with coinbase to scriptPubKeyIn */
     std::unique_ptr<CBlockTemplate> CreateNewBlock(const CScript& scriptPubKeyIn, bool fMineWitnessTx=true);
 
+    /**
+     * Patch blocktemplate, the last template CreateNewBlock returned, with the
+     * packages of the transactions that entered the mempool since it was
+     * built, taking the last added packages out again when a better paying one
+     * needs their room. Returns false without touching the template when it
+     * must be built anew instead: the tip moved, or transactions left the
+     * mempool or had their fee or ancestors change.
+     */
+    bool UpdateBlock(CBlockTemplate& blocktemplate, const CScript& scriptPubKeyIn);
+
 private:
     // utility functions
     /** Clear the block's state and prepare for assembling a new block */
     void resetBlock();
     /** Add a tx to the block */
     void AddToBlock(CTxMemPool::txiter iter);
+    /** Add a package, sorted in a valid order, to the block */
+    void AddPackageToBlock(const std::vector<CTxMemPool::txiter>& sortedEntries, const CFeeRate& feeRate);
+    /** Take the last added package out of the block */
+    void RemoveLastPackage();
+    /** Create the coinbase paying scriptPubKeyIn and fill in the header */
+    void FinishBlock(const CScript& scriptPubKeyIn, const CBlockIndex* pindexPrev);
 
     // Methods for how to add transactions to a block.
     /** Add transactions based on feerate including unconfirmed ancestors
@@ -184,8 +258,8 @@ private:
     // helper functions for addPackageTxs()
     /** Remove confirmed (inBlock) entries from given set */
     void onlyUnconfirmed(CTxMemPool::setEntries& testSet);
-    /** Test if a new package would "fit" in the block */
-    bool TestPackage(uint64_t packageSize, int64_t packageSigOpsCost) const;
+    /** Test if a new package would "fit" in the block, after freeing the given weight and sigops */
+    bool TestPackage(uint64_t packageSize, int64_t packageSigOpsCost, uint64_t nWeightFreed = 0, int64_t nSigOpsFreed = 0) const;
     /** Perform checks on each transaction in a package:
       * locktime, premature-witness, serialized size (if necessary)
       * These checks should always succeed, and they're here
@@ -206,5 +280,23 @@ private:
 void IncrementExtraNonce(CBlock* pblock, const CBlockIndex* pindexPrev, unsigned int& nExtraNonce);
 int64_t UpdateTime(CBlockHeader* pblock, const Consensus::Params& consensusParams, const CBlockIndex* pindexPrev);
 
+/** Built-in miner throughput since the miner threads were last (re)started */
+struct CMinerHashRate
+{
+    int nThreads{0};
+    bool fFullDataset{false};
+    uint64_t nHashesDone{0};
+    int64_t nElapsedMicros{0};
+    uint64_t nHashesPerSec{0};
+};
+
+CMinerHashRate GetMinerHashRate();
+
+/**
+ * Start nThreads miner threads (-1 for one per core) or stop mining. Every
+ * thread works on its own slice of the nonce space; KAWPOW blocks are
+ * searched in KAWPOW_SEARCH_BATCH nonce batches, against the full dataset
+ * when -minerfulldataset is set.
+ */
 int GenerateMyntas(bool fGenerate, int nThreads, const CChainParams& chainparams);
 #endif // MYNTA_MINER_H
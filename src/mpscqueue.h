@@ -0,0 +1,107 @@
+// Copyright (c) 2026 The Mynta Core Developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#ifndef MYNTA_MPSCQUEUE_H
+#define MYNTA_MPSCQUEUE_H
+
+#include <atomic>
+#include <memory>
+#include <stddef.h>
+#include <stdint.h>
+
+/**
+ * Bounded lock-free queue for any number of producers and a single consumer.
+ *
+ * A ring of cells, each with a sequence number telling whose turn it is: a
+ * producer claims the cell at the enqueue position with one compare-and-swap
+ * and publishes its value by bumping the sequence, the consumer takes values
+ * in order and hands the cell back for the next lap. Neither side ever waits
+ * for the other, so a producer on a network thread is never held up by the
+ * consumer, and a full queue is reported instead of growing.
+ *
+ * Only one thread at a time may call TryPop.
+ */
+template <typename T>
+class CMPSCQueue
+{
+private:
+    struct Cell {
+        std::atomic<size_t> nSequence;
+        T value;
+    };
+
+    const size_t nMask;
+    std::unique_ptr<Cell[]> cells;
+    // Producers and the consumer each keep their position on their own cache line
+    alignas(64) std::atomic<size_t> nEnqueuePos{0};
+    alignas(64) size_t nDequeuePos{0};
+
+    static size_t RoundUpPow2(size_t n)
+    {
+        size_t nPow2 = 2;
+        while (nPow2 < n)
+            nPow2 <<= 1;
+        return nPow2;
+    }
+
+public:
+    //! Holds at least nCapacity values, rounded up to a power of two
+    explicit CMPSCQueue(size_t nCapacity) : nMask(RoundUpPow2(nCapacity) - 1), cells(new Cell[nMask + 1])
+    {
+        for (size_t i = 0; i <= nMask; i++)
+            cells[i].nSequence.store(i, std::memory_order_relaxed);
+    }
+
+    CMPSCQueue(const CMPSCQueue&) = delete;
+    CMPSCQueue& operator=(const CMPSCQueue&) = delete;
+
+    size_t Capacity() const { return nMask + 1; }
+
+    //! Append value, or return false and leave it untouched if the queue is full
+    bool TryPush(T&& value)
+    {
+        size_t nPos = nEnqueuePos.load(std::memory_order_relaxed);
+        Cell* cell;
+        while (true) {
+            cell = &cells[nPos & nMask];
+            const size_t nSeq = cell->nSequence.load(std::memory_order_acquire);
+            const intptr_t nDiff = (intptr_t)nSeq - (intptr_t)nPos;
+            if (nDiff == 0) {
+                if (nEnqueuePos.compare_exchange_weak(nPos, nPos + 1, std::memory_order_relaxed))
+                    break;
+            } else if (nDiff < 0) {
+                // The consumer hasn't taken this cell's value from the last lap
+                return false;
+            } else {
+                nPos = nEnqueuePos.load(std::memory_order_relaxed);
+            }
+        }
+        cell->value = std::move(value);
+        cell->nSequence.store(nPos + 1, std::memory_order_release);
+        return true;
+    }
+
+    //! Take the oldest value, or return false if none is published yet
+    bool TryPop(T& valueOut)
+    {
+        Cell& cell = cells[nDequeuePos & nMask];
+        const size_t nSeq = cell.nSequence.load(std::memory_order_acquire);
+        if ((intptr_t)nSeq - (intptr_t)(nDequeuePos + 1) < 0)
+            return false;
+        valueOut = std::move(cell.value);
+        // Don't keep what the value owns alive until the cell is reused
+        cell.value = T();
+        cell.nSequence.store(nDequeuePos + nMask + 1, std::memory_order_release);
+        nDequeuePos++;
+        return true;
+    }
+
+    //! Whether every value pushed so far was popped; only for the consumer thread
+    bool Empty() const
+    {
+        return nEnqueuePos.load(std::memory_order_acquire) == nDequeuePos;
+    }
+};
+
+#endif // MYNTA_MPSCQUEUE_H
@@ -18,16 +18,23 @@
 
 #include <stdio.h>
 
+#include <map>
+#include <memory>
+
 #include <event2/buffer.h>
 #include <event2/keyvalq_struct.h>
 #include "support/events.h"
 
 #include <univalue.h>
 
+#include <boost/algorithm/string.hpp>
+
 static const char DEFAULT_RPCCONNECT[] = "127.0.0.1";
 static const int DEFAULT_HTTP_CLIENT_TIMEOUT=900;
 static const bool DEFAULT_NAMED=false;
 static const int CONTINUE_EXECUTION=-1;
+static const int DEFAULT_RPC_BATCH_SIZE=100;
+static const int DEFAULT_RPC_CONCURRENCY=4;
 
 std::string HelpMessageCli()
 {
@@ -49,6 +56,10 @@ std::string HelpMessageCli()
     strUsage += HelpMessageOpt("-rpcclienttimeout=<n>", strprintf(_("Timeout in seconds during HTTP requests, or 0 for no timeout. (default: %d)"), DEFAULT_HTTP_CLIENT_TIMEOUT));
     strUsage += HelpMessageOpt("-stdinrpcpass", strprintf(_("Read RPC password from standard input as a single line.  When combined with -stdin, the first line from standard input is used for the RPC password.")));
     strUsage += HelpMessageOpt("-stdin", _("Read extra arguments from standard input, one per line until EOF/Ctrl-D (recommended for sensitive information such as passphrases).  When combined with -stdinrpcpass, the first line from standard input is used for the RPC password."));
+    strUsage += HelpMessageOpt("-stdinbatch", _("Read one command per line from standard input, as the method and its arguments separated by spaces or as a JSON array of strings, and print each result on its own line in the same order. "
+        "Commands are sent as JSON-RPC batches over kept alive connections; a command that fails prints an empty line and its error goes to standard error"));
+    strUsage += HelpMessageOpt("-rpcbatchsize=<n>", strprintf(_("Commands sent in each JSON-RPC batch with -stdinbatch (default: %d)"), DEFAULT_RPC_BATCH_SIZE));
+    strUsage += HelpMessageOpt("-rpcconcurrency=<n>", strprintf(_("Batches in flight at once with -stdinbatch, each on its own connection (default: %d)"), DEFAULT_RPC_CONCURRENCY));
     strUsage += HelpMessageOpt("-rpcwallet=<walletname>", _("Send RPC for non-default wallet on RPC server (argument is wallet filename in myntad directory, required if myntad/-Qt runs with multiple wallets)"));
 
     return strUsage;
@@ -283,16 +294,70 @@ public:
     }
 };
 
-static UniValue CallRPC(BaseRequestHandler *rh, const std::string& strMethod, const std::vector<std::string>& args)
+static void GetRPCHostPort(std::string& host, int& port)
 {
-    std::string host;
     // In preference order, we choose the following for the port:
     //     1. -rpcport
     //     2. port in -rpcconnect (ie following : in ipv4 or ]: in ipv6)
     //     3. default port for chain
-    int port = BaseParams().RPCPort();
+    port = BaseParams().RPCPort();
     SplitHostPort(gArgs.GetArg("-rpcconnect", DEFAULT_RPCCONNECT), port, host);
     port = gArgs.GetArg("-rpcport", port);
+}
+
+static std::string GetRPCCredentials()
+{
+    std::string strRPCUserColonPass;
+    if (gArgs.GetArg("-rpcpassword", "") == "") {
+        // Try fall back to cookie-based authentication if no password is provided
+        if (!GetAuthCookie(&strRPCUserColonPass)) {
+            throw std::runtime_error(strprintf(
+                _("Could not locate RPC credentials. No authentication cookie could be found, and RPC password is not set.  See -rpcpassword and -stdinrpcpass.  Configuration file: (%s)"),
+                    GetConfigFile(gArgs.GetArg("-conf", MYNTA_CONF_FILENAME)).string().c_str()));
+
+        }
+    } else {
+        strRPCUserColonPass = gArgs.GetArg("-rpcuser", "") + ":" + gArgs.GetArg("-rpcpassword", "");
+    }
+    return strRPCUserColonPass;
+}
+
+static std::string GetRPCEndpoint()
+{
+    // check if we should use a special wallet endpoint
+    std::string endpoint = "/";
+    std::string walletName = gArgs.GetArg("-rpcwallet", "");
+    if (!walletName.empty()) {
+        char *encodedURI = evhttp_uriencode(walletName.c_str(), walletName.size(), false);
+        if (encodedURI) {
+            endpoint = "/wallet/"+ std::string(encodedURI);
+            free(encodedURI);
+        }
+        else {
+            throw CConnectionFailed("uri-encode failed");
+        }
+    }
+    return endpoint;
+}
+
+//  Throw if the reply to a request isn't a JSON-RPC reply
+static void CheckHTTPReply(const HTTPReply& response)
+{
+    if (response.status == 0)
+        throw CConnectionFailed(strprintf("couldn't connect to server: %s (code %d)\n(make sure server is running and you are connecting to the correct RPC port)", http_errorstring(response.error), response.error));
+    else if (response.status == HTTP_UNAUTHORIZED)
+        throw std::runtime_error("incorrect rpcuser or rpcpassword (authorization failed)");
+    else if (response.status >= 400 && response.status != HTTP_BAD_REQUEST && response.status != HTTP_NOT_FOUND && response.status != HTTP_INTERNAL_SERVER_ERROR)
+        throw std::runtime_error(strprintf("server returned HTTP error %d", response.status));
+    else if (response.body.empty())
+        throw std::runtime_error("no response from server");
+}
+
+static UniValue CallRPC(BaseRequestHandler *rh, const std::string& strMethod, const std::vector<std::string>& args)
+{
+    std::string host;
+    int port;
+    GetRPCHostPort(host, port);
 
     // Obtain event base
     raii_event_base base = obtain_event_base();
@@ -310,18 +375,7 @@ static UniValue CallRPC(BaseRequestHandler *rh, const std::string& strMethod, co
 #endif
 
     // Get credentials
-    std::string strRPCUserColonPass;
-    if (gArgs.GetArg("-rpcpassword", "") == "") {
-        // Try fall back to cookie-based authentication if no password is provided
-        if (!GetAuthCookie(&strRPCUserColonPass)) {
-            throw std::runtime_error(strprintf(
-                _("Could not locate RPC credentials. No authentication cookie could be found, and RPC password is not set.  See -rpcpassword and -stdinrpcpass.  Configuration file: (%s)"),
-                    GetConfigFile(gArgs.GetArg("-conf", MYNTA_CONF_FILENAME)).string().c_str()));
-
-        }
-    } else {
-        strRPCUserColonPass = gArgs.GetArg("-rpcuser", "") + ":" + gArgs.GetArg("-rpcpassword", "");
-    }
+    std::string strRPCUserColonPass = GetRPCCredentials();
 
     struct evkeyvalq* output_headers = evhttp_request_get_output_headers(req.get());
     assert(output_headers);
@@ -335,19 +389,7 @@ static UniValue CallRPC(BaseRequestHandler *rh, const std::string& strMethod, co
     assert(output_buffer);
     evbuffer_add(output_buffer, strRequest.data(), strRequest.size());
 
-    // check if we should use a special wallet endpoint
-    std::string endpoint = "/";
-    std::string walletName = gArgs.GetArg("-rpcwallet", "");
-    if (!walletName.empty()) {
-        char *encodedURI = evhttp_uriencode(walletName.c_str(), walletName.size(), false);
-        if (encodedURI) {
-            endpoint = "/wallet/"+ std::string(encodedURI);
-            free(encodedURI);
-        }
-        else {
-            throw CConnectionFailed("uri-encode failed");
-        }
-    }
+    std::string endpoint = GetRPCEndpoint();
     int r = evhttp_make_request(evcon.get(), req.get(), EVHTTP_REQ_POST, endpoint.c_str());
     req.release(); // ownership moved to evcon in above call
     if (r != 0) {
@@ -356,14 +398,7 @@ static UniValue CallRPC(BaseRequestHandler *rh, const std::string& strMethod, co
 
     event_base_dispatch(base.get());
 
-    if (response.status == 0)
-        throw CConnectionFailed(strprintf("couldn't connect to server: %s (code %d)\n(make sure server is running and you are connecting to the correct RPC port)", http_errorstring(response.error), response.error));
-    else if (response.status == HTTP_UNAUTHORIZED)
-        throw std::runtime_error("incorrect rpcuser or rpcpassword (authorization failed)");
-    else if (response.status >= 400 && response.status != HTTP_BAD_REQUEST && response.status != HTTP_NOT_FOUND && response.status != HTTP_INTERNAL_SERVER_ERROR)
-        throw std::runtime_error(strprintf("server returned HTTP error %d", response.status));
-    else if (response.body.empty())
-        throw std::runtime_error("no response from server");
+    CheckHTTPReply(response);
 
     // Parse reply
     UniValue valReply(UniValue::VSTR);
@@ -376,6 +411,267 @@ static UniValue CallRPC(BaseRequestHandler *rh, const std::string& strMethod, co
     return reply;
 }
 
+/**
+ * Runs the commands read from standard input for -stdinbatch. They are sent
+ * -rpcbatchsize at a time as JSON-RPC batches, with up to -rpcconcurrency
+ * batches in flight, each connection kept alive and given the next batch as
+ * soon as it has a reply. Results are printed as the batches before them
+ * complete, so they come out in input order while the rest is still read.
+ */
+class CStdinBatchClient
+{
+private:
+    struct Chunk {
+        //! Number of the first line in the chunk, from 1
+        size_t nFirstLine{0};
+        //! Request sent for each line, null where the line had no command or couldn't be converted
+        std::vector<UniValue> vRequests;
+        std::vector<std::string> vOutput;
+        std::vector<std::string> vErrors;
+        bool fDone{false};
+    };
+
+    struct InFlight {
+        CStdinBatchClient* client;
+        size_t nConn;
+        size_t nChunk;
+        HTTPReply reply;
+    };
+
+    struct event_base* base;
+    std::string host;
+    std::string strAuth;
+    std::string endpoint;
+    size_t nBatchSize;
+    std::vector<raii_evhttp_connection> vConns;
+    std::map<size_t, Chunk> mapChunks;
+    std::vector<std::unique_ptr<InFlight>> vInFlight;
+    size_t nChunksRead{0};
+    size_t nChunksPrinted{0};
+    size_t nLinesRead{0};
+    size_t nRunning{0};
+    bool fEOF{false};
+    bool fFailed{false};
+    int nRet{0};
+
+    bool ReadChunk(Chunk& chunk)
+    {
+        chunk.nFirstLine = nLinesRead + 1;
+        std::string line;
+        while (chunk.vRequests.size() < nBatchSize && !fEOF) {
+            if (!std::getline(std::cin, line)) {
+                fEOF = true;
+                break;
+            }
+            nLinesRead++;
+            chunk.vRequests.emplace_back();
+            chunk.vErrors.emplace_back();
+            chunk.vOutput.emplace_back();
+            boost::algorithm::trim(line);
+            if (line.empty())
+                continue;
+            try {
+                chunk.vRequests.back() = PrepareLine(line, chunk.vRequests.size() - 1);
+            } catch (const std::exception& e) {
+                chunk.vErrors.back() = e.what();
+            }
+        }
+        return !chunk.vRequests.empty();
+    }
+
+    static UniValue PrepareLine(const std::string& line, size_t id)
+    {
+        std::vector<std::string> args;
+        if (line[0] == '[') {
+            UniValue array;
+            if (!array.read(line) || !array.isArray())
+                throw std::runtime_error("couldn't parse JSON array of the command and its arguments");
+            for (size_t i = 0; i < array.size(); i++) {
+                if (!array[i].isStr())
+                    throw std::runtime_error("command and arguments must be strings");
+                args.push_back(array[i].get_str());
+            }
+        } else {
+            boost::split(args, line, boost::is_any_of(" \t"), boost::token_compress_on);
+        }
+        if (args.empty() || args[0].empty())
+            throw std::runtime_error("too few parameters (need at least command)");
+
+        std::string method = args[0];
+        args.erase(args.begin());
+        UniValue params;
+        if (gArgs.GetBoolArg("-named", DEFAULT_NAMED)) {
+            params = RPCConvertNamedValues(method, args);
+        } else {
+            params = RPCConvertValues(method, args);
+        }
+        return JSONRPCRequestObj(method, params, id);
+    }
+
+    //! Send the next chunk on connection nConn, false if there is none
+    bool SendNext(size_t nConn)
+    {
+        while (!fFailed) {
+            Chunk chunk;
+            if (!ReadChunk(chunk))
+                return false;
+            const size_t nChunk = nChunksRead++;
+            UniValue batch(UniValue::VARR);
+            for (const UniValue& request : chunk.vRequests) {
+                if (!request.isNull())
+                    batch.push_back(request);
+            }
+            Chunk& stored = mapChunks.emplace(nChunk, std::move(chunk)).first->second;
+            if (batch.empty()) {
+                // Nothing to ask the server, the lines are printed as they are
+                stored.fDone = true;
+                Print();
+                continue;
+            }
+
+            vInFlight[nConn].reset(new InFlight{this, nConn, nChunk, HTTPReply()});
+            raii_evhttp_request req = obtain_evhttp_request(RequestDone, vInFlight[nConn].get());
+            if (req == nullptr)
+                throw std::runtime_error("create http request failed");
+#if LIBEVENT_VERSION_NUMBER >= 0x02010300
+            evhttp_request_set_error_cb(req.get(), RequestError);
+#endif
+            struct evkeyvalq* output_headers = evhttp_request_get_output_headers(req.get());
+            assert(output_headers);
+            evhttp_add_header(output_headers, "Host", host.c_str());
+            evhttp_add_header(output_headers, "Connection", "keep-alive");
+            evhttp_add_header(output_headers, "Authorization", strAuth.c_str());
+
+            std::string strRequest = batch.write() + "\n";
+            struct evbuffer* output_buffer = evhttp_request_get_output_buffer(req.get());
+            assert(output_buffer);
+            evbuffer_add(output_buffer, strRequest.data(), strRequest.size());
+
+            int r = evhttp_make_request(vConns[nConn].get(), req.get(), EVHTTP_REQ_POST, endpoint.c_str());
+            req.release(); // ownership moved to evcon in above call
+            if (r != 0)
+                throw CConnectionFailed("send http request failed");
+            nRunning++;
+            return true;
+        }
+        return false;
+    }
+
+#if LIBEVENT_VERSION_NUMBER >= 0x02010300
+    static void RequestError(enum evhttp_request_error err, void *ctx)
+    {
+        static_cast<InFlight*>(ctx)->reply.error = err;
+    }
+#endif
+
+    static void RequestDone(struct evhttp_request *req, void *ctx)
+    {
+        InFlight* inflight = static_cast<InFlight*>(ctx);
+        http_request_done(req, &inflight->reply);
+        inflight->client->Complete(*inflight);
+    }
+
+    void Complete(const InFlight& inflight)
+    {
+        nRunning--;
+        Chunk& chunk = mapChunks[inflight.nChunk];
+        try {
+            CheckHTTPReply(inflight.reply);
+            UniValue valReply(UniValue::VSTR);
+            if (!valReply.read(inflight.reply.body))
+                throw std::runtime_error("couldn't parse reply from server");
+            std::vector<UniValue> vReplies = JSONRPCProcessBatchReply(valReply, chunk.vRequests.size());
+            for (size_t i = 0; i < chunk.vRequests.size(); i++) {
+                if (chunk.vRequests[i].isNull())
+                    continue;
+                const UniValue& result = find_value(vReplies[i], "result");
+                const UniValue& error = find_value(vReplies[i], "error");
+                if (vReplies[i].isNull()) {
+                    chunk.vErrors[i] = "no reply from server";
+                } else if (!error.isNull()) {
+                    const UniValue& errMsg = find_value(error, "message");
+                    chunk.vErrors[i] = errMsg.isStr() ? strprintf("%s (code %s)", errMsg.get_str(), find_value(error, "code").getValStr()) : error.write();
+                } else if (result.isStr()) {
+                    chunk.vOutput[i] = result.get_str();
+                } else if (!result.isNull()) {
+                    chunk.vOutput[i] = result.write();
+                }
+            }
+        } catch (const std::exception& e) {
+            // The connection is unusable, or the server refused us: stop here
+            fprintf(stderr, "error: %s\n", e.what());
+            fFailed = true;
+            nRet = EXIT_FAILURE;
+        }
+        chunk.fDone = !fFailed;
+        Print();
+
+        // Nothing may be thrown back into libevent
+        bool fSent = false;
+        try {
+            fSent = !fFailed && SendNext(inflight.nConn);
+        } catch (const std::exception& e) {
+            fprintf(stderr, "error: %s\n", e.what());
+            fFailed = true;
+            nRet = EXIT_FAILURE;
+        }
+        if (!fSent && nRunning == 0)
+            event_base_loopbreak(base);
+    }
+
+    //! Print the chunks whose predecessors are all printed
+    void Print()
+    {
+        for (auto it = mapChunks.find(nChunksPrinted); it != mapChunks.end() && it->second.fDone; it = mapChunks.find(nChunksPrinted)) {
+            const Chunk& chunk = it->second;
+            for (size_t i = 0; i < chunk.vRequests.size(); i++) {
+                if (!chunk.vErrors[i].empty()) {
+                    fprintf(stderr, "error: line %u: %s\n", (unsigned int)(chunk.nFirstLine + i), chunk.vErrors[i].c_str());
+                    nRet = EXIT_FAILURE;
+                }
+                fprintf(stdout, "%s\n", chunk.vOutput[i].c_str());
+            }
+            fflush(stdout);
+            mapChunks.erase(it);
+            nChunksPrinted++;
+        }
+    }
+
+public:
+    explicit CStdinBatchClient(struct event_base* baseIn) : base(baseIn)
+    {
+        int port;
+        GetRPCHostPort(host, port);
+        strAuth = std::string("Basic ") + EncodeBase64(GetRPCCredentials());
+        endpoint = GetRPCEndpoint();
+        nBatchSize = std::max(1, (int)gArgs.GetArg("-rpcbatchsize", DEFAULT_RPC_BATCH_SIZE));
+        const int nConcurrency = std::max(1, (int)gArgs.GetArg("-rpcconcurrency", DEFAULT_RPC_CONCURRENCY));
+        for (int i = 0; i < nConcurrency; i++) {
+            vConns.push_back(obtain_evhttp_connection_base(base, host, port));
+            evhttp_connection_set_timeout(vConns.back().get(), gArgs.GetArg("-rpcclienttimeout", DEFAULT_HTTP_CLIENT_TIMEOUT));
+        }
+        vInFlight.resize(nConcurrency);
+    }
+
+    int Run()
+    {
+        for (size_t nConn = 0; nConn < vConns.size(); nConn++) {
+            if (!SendNext(nConn))
+                break;
+        }
+        if (nRunning > 0)
+            event_base_dispatch(base);
+        return nRet;
+    }
+};
+
+static int StdinBatchRPC()
+{
+    raii_event_base base = obtain_event_base();
+    CStdinBatchClient client(base.get());
+    return client.Run();
+}
+
 int CommandLineRPC(int argc, char *argv[])
 {
     std::string strPrint;
@@ -393,6 +689,8 @@ int CommandLineRPC(int argc, char *argv[])
             }
             gArgs.ForceSetArg("-rpcpassword", rpcPass);
         }
+        if (gArgs.GetBoolArg("-stdinbatch", false))
+            return StdinBatchRPC();
         std::vector<std::string> args = std::vector<std::string>(&argv[1], &argv[argc]);
         if (gArgs.GetBoolArg("-stdin", false)) {
             // Read one arg per line from stdin and append
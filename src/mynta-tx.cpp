@@ -7,6 +7,7 @@
 #include "config/mynta-config.h"
 #endif
 
+#include "assets/assets.h"
 #include "base58.h"
 #include "clientversion.h"
 #include "coins.h"
@@ -25,11 +26,20 @@
 
 #include <stdio.h>
 
+#include <atomic>
+#include <iostream>
+#include <thread>
+
 #include <boost/algorithm/string.hpp>
 
 static bool fCreateBlank;
 static std::map<std::string,UniValue> registers;
 static const int CONTINUE_EXECUTION=-1;
+//! Whether secp256k1 was started for the whole run, as -batch does
+static bool fECCStarted = false;
+
+//! Transactions each -batch worker is handed per chunk of input
+static const size_t BATCH_SPECS_PER_THREAD = 256;
 
 //
 // This function returns either one of EXIT_ codes when it's expected to stop the process or
@@ -68,6 +78,10 @@ static int AppInitRawTx(int argc, char* argv[])
         strUsage += HelpMessageOpt("-create", _("Create new, empty TX."));
         strUsage += HelpMessageOpt("-json", _("Select JSON output"));
         strUsage += HelpMessageOpt("-txid", _("Output only the hex-encoded transaction id of the resultant transaction."));
+        strUsage += HelpMessageOpt("-batch", _("Read one transaction per line from standard input and output each result on its own line, in the same order. "
+            "A line is a JSON array of commands or comma separated commands, optionally preceded by the hex-encoded transaction to update. "
+            "Commands given on the command line may only set registers, which every line shares"));
+        strUsage += HelpMessageOpt("-batchthreads=<n>", _("Number of threads building -batch transactions (default: number of cores)"));
         AppendParamsHelpMessages(strUsage);
 
         fprintf(stdout, "%s", strUsage.c_str());
@@ -83,6 +97,7 @@ static int AppInitRawTx(int argc, char* argv[])
         strUsage += HelpMessageOpt("outpubkey=VALUE:PUBKEY[:FLAGS]", _("Add pay-to-pubkey output to TX") + ". " +
             _("Optionally add the \"W\" flag to produce a pay-to-witness-pubkey-hash output") + ". " +
             _("Optionally add the \"S\" flag to wrap the output in a pay-to-script-hash."));
+        strUsage += HelpMessageOpt("outasset=ASSET:QUANTITY:ADDRESS", _("Add asset transfer output to TX"));
         strUsage += HelpMessageOpt("outdata=[VALUE:]DATA", _("Add data-based output to TX"));
         strUsage += HelpMessageOpt("outscript=VALUE:SCRIPT[:FLAGS]", _("Add raw script output to TX") + ". " +
             _("Optionally add the \"W\" flag to produce a pay-to-witness-script-hash output") + ". " +
@@ -111,7 +126,7 @@ static int AppInitRawTx(int argc, char* argv[])
     return CONTINUE_EXECUTION;
 }
 
-static void RegisterSetJson(const std::string& key, const std::string& rawJson)
+static void RegisterSetJson(std::map<std::string,UniValue>& regs, const std::string& key, const std::string& rawJson)
 {
     UniValue val;
     if (!val.read(rawJson)) {
@@ -119,10 +134,10 @@ static void RegisterSetJson(const std::string& key, const std::string& rawJson)
         throw std::runtime_error(strErr);
     }
 
-    registers[key] = val;
+    regs[key] = val;
 }
 
-static void RegisterSet(const std::string& strInput)
+static void RegisterSet(std::map<std::string,UniValue>& regs, const std::string& strInput)
 {
     // separate NAME:VALUE in string
     size_t pos = strInput.find(':');
@@ -134,10 +149,10 @@ static void RegisterSet(const std::string& strInput)
     std::string key = strInput.substr(0, pos);
     std::string valStr = strInput.substr(pos + 1, std::string::npos);
 
-    RegisterSetJson(key, valStr);
+    RegisterSetJson(regs, key, valStr);
 }
 
-static void RegisterLoad(const std::string& strInput)
+static void RegisterLoad(std::map<std::string,UniValue>& regs, const std::string& strInput)
 {
     // separate NAME:FILENAME in string
     size_t pos = strInput.find(':');
@@ -175,7 +190,17 @@ static void RegisterLoad(const std::string& strInput)
     }
 
     // evaluate as JSON buffer register
-    RegisterSetJson(key, valStr);
+    RegisterSetJson(regs, key, valStr);
+}
+
+//  A register of the transaction being built, else one every -batch line shares
+static const UniValue* FindRegister(const std::map<std::string,UniValue>& regs, const std::string& key)
+{
+    auto it = regs.find(key);
+    if (it != regs.end())
+        return &it->second;
+    it = registers.find(key);
+    return it != registers.end() ? &it->second : nullptr;
 }
 
 static CAmount ExtractAndValidateValue(const std::string& strValue)
@@ -291,6 +316,43 @@ static void MutateTxAddOutAddr(CMutableTransaction& tx, const std::string& strIn
     tx.vout.push_back(txout);
 }
 
+static void MutateTxAddOutAsset(CMutableTransaction& tx, const std::string& strInput)
+{
+    // Separate into ASSET:QUANTITY:ADDRESS
+    std::vector<std::string> vStrInputParts;
+    boost::split(vStrInputParts, strInput, boost::is_any_of(":"));
+
+    if (vStrInputParts.size() != 3)
+        throw std::runtime_error("TX asset output missing or too many separators");
+
+    // Extract the asset name; the node checks it is a valid, existing asset
+    CAssetTransfer transfer;
+    transfer.strName = vStrInputParts[0];
+    if (transfer.strName.size() < MIN_ASSET_LENGTH || transfer.strName.size() > MAX_ASSET_LENGTH + OWNER_LENGTH)
+        throw std::runtime_error("invalid TX output asset name");
+
+    // Extract and validate QUANTITY
+    if (!ParseFixedPoint(vStrInputParts[1], 8, &transfer.nAmount) || transfer.nAmount <= 0 || !MoneyRange(transfer.nAmount))
+        throw std::runtime_error("invalid TX output asset quantity");
+
+    // extract and validate ADDRESS
+    CTxDestination destination = DecodeDestination(vStrInputParts[2]);
+    if (!IsValidDestination(destination))
+        throw std::runtime_error("invalid TX output address");
+    CScript scriptPubKey = GetScriptForDestination(destination);
+
+    // Append the transfer as CAssetTransfer::ConstructTransaction does
+    CDataStream ssTransfer(SER_NETWORK, PROTOCOL_VERSION);
+    ssTransfer << transfer;
+    std::vector<unsigned char> vchMessage = {RVN_R, RVN_V, RVN_N, RVN_T};
+    vchMessage.insert(vchMessage.end(), ssTransfer.begin(), ssTransfer.end());
+    scriptPubKey << OP_RVN_ASSET << ToByteVector(vchMessage) << OP_DROP;
+
+    // construct TxOut, append to transaction output list
+    CTxOut txout(0, scriptPubKey);
+    tx.vout.push_back(txout);
+}
+
 static void MutateTxAddOutPubKey(CMutableTransaction& tx, const std::string& strInput)
 {
     // Separate into VALUE:PUBKEY[:FLAGS]
@@ -533,7 +595,24 @@ static CAmount AmountFromValue(const UniValue& value)
     return amount;
 }
 
-static void MutateTxSign(CMutableTransaction& tx, const std::string& flagStr)
+static void AddPrivateKeys(CBasicKeyStore& keystore, const UniValue& keysObj)
+{
+    for (unsigned int kidx = 0; kidx < keysObj.size(); kidx++) {
+        if (!keysObj[kidx].isStr())
+            throw std::runtime_error("privatekey not a std::string");
+        CMyntaSecret vchSecret;
+        bool fGood = vchSecret.SetString(keysObj[kidx].getValStr());
+        if (!fGood)
+            throw std::runtime_error("privatekey not valid");
+
+        CKey key = vchSecret.GetKey();
+        keystore.AddKey(key);
+    }
+}
+
+//  pBatchKeystore holds the keys every -batch line signs with, unless the line sets its own
+static void MutateTxSign(CMutableTransaction& tx, const std::string& flagStr,
+                         const std::map<std::string,UniValue>& regs, CBasicKeyStore* pBatchKeystore)
 {
     int nHashType = SIGHASH_ALL;
 
@@ -551,27 +630,21 @@ static void MutateTxSign(CMutableTransaction& tx, const std::string& flagStr)
     CCoinsView viewDummy;
     CCoinsViewCache view(&viewDummy);
 
-    if (!registers.count("privatekeys"))
-        throw std::runtime_error("privatekeys register variable must be set.");
     CBasicKeyStore tempKeystore;
-    UniValue keysObj = registers["privatekeys"];
-
-    for (unsigned int kidx = 0; kidx < keysObj.size(); kidx++) {
-        if (!keysObj[kidx].isStr())
-            throw std::runtime_error("privatekey not a std::string");
-        CMyntaSecret vchSecret;
-        bool fGood = vchSecret.SetString(keysObj[kidx].getValStr());
-        if (!fGood)
-            throw std::runtime_error("privatekey not valid");
-
-        CKey key = vchSecret.GetKey();
-        tempKeystore.AddKey(key);
-    }
+    CBasicKeyStore* pKeystore = &tempKeystore;
+    const UniValue* pKeysObj = FindRegister(regs, "privatekeys");
+    if (pKeysObj)
+        AddPrivateKeys(tempKeystore, *pKeysObj);
+    else if (pBatchKeystore)
+        pKeystore = pBatchKeystore;
+    else
+        throw std::runtime_error("privatekeys register variable must be set.");
 
     // Add previous txouts given in the RPC call:
-    if (!registers.count("prevtxs"))
+    const UniValue* pPrevtxsObj = FindRegister(regs, "prevtxs");
+    if (!pPrevtxsObj)
         throw std::runtime_error("prevtxs register variable must be set.");
-    UniValue prevtxsObj = registers["prevtxs"];
+    const UniValue& prevtxsObj = *pPrevtxsObj;
     {
         for (unsigned int previdx = 0; previdx < prevtxsObj.size(); previdx++) {
             UniValue prevOut = prevtxsObj[previdx];
@@ -621,12 +694,12 @@ static void MutateTxSign(CMutableTransaction& tx, const std::string& flagStr)
                 UniValue v = prevOut["redeemScript"];
                 std::vector<unsigned char> rsData(ParseHexUV(v, "redeemScript"));
                 CScript redeemScript(rsData.begin(), rsData.end());
-                tempKeystore.AddCScript(redeemScript);
+                pKeystore->AddCScript(redeemScript);
             }
         }
     }
 
-    const CKeyStore& keystore = tempKeystore;
+    const CKeyStore& keystore = *pKeystore;
 
     bool fHashSingle = ((nHashType & ~SIGHASH_ANYONECANPAY) == SIGHASH_SINGLE);
 
@@ -677,7 +750,8 @@ public:
 };
 
 static void MutateTx(CMutableTransaction& tx, const std::string& command,
-                     const std::string& commandVal)
+                     const std::string& commandVal,
+                     std::map<std::string,UniValue>& regs = registers, CBasicKeyStore* pBatchKeystore = nullptr)
 {
     std::unique_ptr<Secp256k1Init> ecc;
 
@@ -698,11 +772,15 @@ static void MutateTx(CMutableTransaction& tx, const std::string& command,
         MutateTxDelOutput(tx, commandVal);
     else if (command == "outaddr")
         MutateTxAddOutAddr(tx, commandVal);
+    else if (command == "outasset")
+        MutateTxAddOutAsset(tx, commandVal);
     else if (command == "outpubkey") {
-        ecc.reset(new Secp256k1Init());
+        if (!fECCStarted)
+            ecc.reset(new Secp256k1Init());
         MutateTxAddOutPubKey(tx, commandVal);
     } else if (command == "outmultisig") {
-        ecc.reset(new Secp256k1Init());
+        if (!fECCStarted)
+            ecc.reset(new Secp256k1Init());
         MutateTxAddOutMultiSig(tx, commandVal);
     } else if (command == "outscript")
         MutateTxAddOutScript(tx, commandVal);
@@ -710,15 +788,16 @@ static void MutateTx(CMutableTransaction& tx, const std::string& command,
         MutateTxAddOutData(tx, commandVal);
 
     else if (command == "sign") {
-        ecc.reset(new Secp256k1Init());
-        MutateTxSign(tx, commandVal);
+        if (!fECCStarted)
+            ecc.reset(new Secp256k1Init());
+        MutateTxSign(tx, commandVal, regs, pBatchKeystore);
     }
 
     else if (command == "load")
-        RegisterLoad(commandVal);
+        RegisterLoad(regs, commandVal);
 
     else if (command == "set")
-        RegisterSet(commandVal);
+        RegisterSet(regs, commandVal);
 
     else
         throw std::runtime_error("unknown command");
@@ -733,6 +812,19 @@ static void OutputTxJSON(const CTransaction& tx)
     fprintf(stdout, "%s\n", jsonOutput.c_str());
 }
 
+//  The -batch output of a transaction, on a single line
+static std::string FormatTxLine(const CTransaction& tx)
+{
+    if (gArgs.GetBoolArg("-json", false)) {
+        UniValue entry(UniValue::VOBJ);
+        TxToUniv(tx, uint256(), entry);
+        return entry.write();
+    }
+    if (gArgs.GetBoolArg("-txid", false))
+        return tx.GetHash().GetHex();
+    return EncodeHexTx(tx);
+}
+
 static void OutputTxHash(const CTransaction& tx)
 {
     std::string strHexHash = tx.GetHash().GetHex(); // the hex-encoded transaction hash (aka the transaction id)
@@ -777,6 +869,165 @@ static std::string readStdin()
     return ret;
 }
 
+static void SplitCommand(const std::string& arg, std::string& key, std::string& value)
+{
+    size_t eqpos = arg.find('=');
+    if (eqpos == std::string::npos) {
+        key = arg;
+        value.clear();
+    } else {
+        key = arg.substr(0, eqpos);
+        value = arg.substr(eqpos + 1);
+    }
+}
+
+//  Build the transaction one -batch line describes
+static std::string BatchLineTx(const std::string& strLine, CBasicKeyStore& keystore)
+{
+    std::vector<std::string> vArgs;
+    if (strLine[0] == '[') {
+        UniValue commands;
+        if (!commands.read(strLine) || !commands.isArray())
+            throw std::runtime_error("cannot parse JSON command array");
+        for (size_t i = 0; i < commands.size(); i++) {
+            if (!commands[i].isStr())
+                throw std::runtime_error("command not a string");
+            vArgs.push_back(commands[i].get_str());
+        }
+    } else {
+        boost::split(vArgs, strLine, boost::is_any_of(","));
+        for (std::string& arg : vArgs)
+            boost::algorithm::trim(arg);
+    }
+
+    CMutableTransaction tx;
+    size_t startArg = 0;
+    if (!vArgs.empty() && vArgs[0].find('=') == std::string::npos && IsHex(vArgs[0])) {
+        if (!DecodeHexTx(tx, vArgs[0], true))
+            throw std::runtime_error("invalid transaction encoding");
+        startArg = 1;
+    }
+
+    std::map<std::string,UniValue> lineRegisters;
+    for (size_t i = startArg; i < vArgs.size(); i++) {
+        std::string key, value;
+        SplitCommand(vArgs[i], key, value);
+        MutateTx(tx, key, value, lineRegisters, &keystore);
+    }
+
+    return FormatTxLine(tx);
+}
+
+/**
+ * Build a transaction for every line of standard input, on all cores, and
+ * print each result on its own line in input order; a line that fails prints
+ * an empty line and its error goes to stderr. The input is read a chunk at a
+ * time, so output streams while the rest is read. secp256k1 is started once,
+ * and the private keys are parsed once into a key store per thread.
+ */
+static int BatchRawTx(int argc, char* argv[])
+{
+    // Register commands on the command line are shared by every line
+    for (int i = 1; i < argc; i++) {
+        std::string key, value;
+        SplitCommand(argv[i], key, value);
+        if (key == "set")
+            RegisterSet(registers, value);
+        else if (key == "load")
+            RegisterLoad(registers, value);
+        else
+            throw std::runtime_error("only register commands can be given on the command line with -batch");
+    }
+
+    Secp256k1Init ecc;
+    fECCStarted = true;
+
+    std::vector<CKey> vKeys;
+    auto itKeys = registers.find("privatekeys");
+    if (itKeys != registers.end()) {
+        CBasicKeyStore parsed;
+        AddPrivateKeys(parsed, itKeys->second);
+        std::set<CKeyID> setKeyIDs = parsed.GetKeys();
+        for (const CKeyID& keyID : setKeyIDs) {
+            CKey key;
+            if (parsed.GetKey(keyID, key))
+                vKeys.push_back(key);
+        }
+        registers.erase(itKeys);
+    }
+
+    int nThreads = gArgs.GetArg("-batchthreads", GetNumCores());
+    if (nThreads < 1)
+        nThreads = 1;
+
+    // Each thread signs with its own key store, redeem scripts from prevtxs
+    // being added to it as they are met
+    std::vector<std::unique_ptr<CBasicKeyStore>> vKeystores;
+    for (int t = 0; t < nThreads; t++) {
+        vKeystores.emplace_back(new CBasicKeyStore());
+        for (const CKey& key : vKeys)
+            vKeystores.back()->AddKey(key);
+    }
+
+    int nRet = EXIT_SUCCESS;
+    size_t nLinesRead = 0;
+    std::vector<std::string> vLines;
+    std::vector<std::string> vResults;
+    std::vector<std::string> vErrors;
+    std::string strLine;
+    bool fEnd = false;
+    while (!fEnd) {
+        vLines.clear();
+        while (vLines.size() < BATCH_SPECS_PER_THREAD * (size_t)nThreads) {
+            if (!std::getline(std::cin, strLine)) {
+                fEnd = true;
+                break;
+            }
+            vLines.push_back(strLine);
+        }
+        if (vLines.empty())
+            break;
+
+        vResults.assign(vLines.size(), std::string());
+        vErrors.assign(vLines.size(), std::string());
+        std::atomic<size_t> nNext{0};
+        auto worker = [&](CBasicKeyStore& keystore) {
+            for (size_t i = nNext++; i < vLines.size(); i = nNext++) {
+                std::string strSpec = boost::algorithm::trim_copy(vLines[i]);
+                if (strSpec.empty() || strSpec[0] == '#')
+                    continue;
+                try {
+                    vResults[i] = BatchLineTx(strSpec, keystore);
+                } catch (const std::exception& e) {
+                    vErrors[i] = e.what();
+                }
+            }
+        };
+
+        std::vector<std::thread> vWorkers;
+        for (int t = 1; t < nThreads; t++)
+            vWorkers.emplace_back(worker, std::ref(*vKeystores[t]));
+        worker(*vKeystores[0]);
+        for (std::thread& thread : vWorkers)
+            thread.join();
+
+        for (size_t i = 0; i < vLines.size(); i++) {
+            if (!vErrors[i].empty()) {
+                fprintf(stderr, "error: line %u: %s\n", (unsigned int)(nLinesRead + i + 1), vErrors[i].c_str());
+                nRet = EXIT_FAILURE;
+            }
+            fprintf(stdout, "%s\n", vResults[i].c_str());
+        }
+        fflush(stdout);
+        nLinesRead += vLines.size();
+    }
+
+    if (std::cin.bad())
+        throw std::runtime_error("error reading stdin");
+
+    return nRet;
+}
+
 static int CommandLineRawTx(int argc, char* argv[])
 {
     std::string strPrint;
@@ -789,6 +1040,9 @@ static int CommandLineRawTx(int argc, char* argv[])
             argv++;
         }
 
+        if (gArgs.GetBoolArg("-batch", false))
+            return BatchRawTx(argc, argv);
+
         CMutableTransaction tx;
         int startArg;
 
@@ -810,15 +1064,8 @@ static int CommandLineRawTx(int argc, char* argv[])
             startArg = 1;
 
         for (int i = startArg; i < argc; i++) {
-            std::string arg = argv[i];
             std::string key, value;
-            size_t eqpos = arg.find('=');
-            if (eqpos == std::string::npos)
-                key = arg;
-            else {
-                key = arg.substr(0, eqpos);
-                value = arg.substr(eqpos + 1);
-            }
+            SplitCommand(argv[i], key, value);
 
             MutateTx(tx, key, value);
         }
@@ -29,6 +29,10 @@
 #include <fcntl.h>
 #endif
 
+#ifndef WIN32
+#include <sys/uio.h>
+#endif
+
 #ifdef USE_UPNP
 #include <miniupnpc/miniupnpc.h>
 #include <miniupnpc/miniwget.h>
@@ -42,6 +46,7 @@
 #include <string>       // std::string
 #include <iostream>     // std::cout
 #include <sstream>
+#include <unordered_map>
 
 // Dump addresses to peers.dat and banlist.dat every 15 minutes (900s)
 #define DUMP_ADDRESSES_INTERVAL 900
@@ -805,6 +810,40 @@ int CNode::GetSendVersion() const
 }
 
 
+CNetMessageBufferPool netMessageBufferPool;
+
+void CNetMessageBufferPool::Take(CDataStream& s)
+{
+    std::lock_guard<std::mutex> lock(cs);
+    if (!vFree.empty()) {
+        s.SwapBuffer(vFree.back());
+        vFree.pop_back();
+    }
+}
+
+void CNetMessageBufferPool::Give(CDataStream& s)
+{
+    CSerializeData buffer;
+    s.SwapBuffer(buffer);
+    if (buffer.capacity() == 0 || buffer.capacity() > MAX_POOLED_RECV_BUFFER_SIZE)
+        return;
+    buffer.clear();
+    std::lock_guard<std::mutex> lock(cs);
+    if (vFree.size() < MAX_POOLED_RECV_BUFFERS)
+        vFree.push_back(std::move(buffer));
+}
+
+size_t CNetMessageBufferPool::size()
+{
+    std::lock_guard<std::mutex> lock(cs);
+    return vFree.size();
+}
+
+CNetMessage::~CNetMessage()
+{
+    netMessageBufferPool.Give(vRecv);
+}
+
 int CNetMessage::readHeader(const char *pch, unsigned int nBytes)
 {
     // copy data to temporary parsing buffer
@@ -832,6 +871,8 @@ int CNetMessage::readHeader(const char *pch, unsigned int nBytes)
 
     // switch state to reading message data
     in_data = true;
+    if (hdr.nMessageSize > 0)
+        netMessageBufferPool.Take(vRecv);
 
     return nCopy;
 }
@@ -876,27 +917,53 @@ size_t CConnman::SocketSendData(CNode *pnode) const
     size_t nSentSize = 0;
 
     while (it != pnode->vSendMsg.end()) {
-        const auto &data = *it;
-        assert(data.size() > pnode->nSendOffset);
+        assert((*it)->size() > pnode->nSendOffset);
+        size_t nOffered = 0;
         int nBytes = 0;
         {
             LOCK(pnode->cs_hSocket);
             if (pnode->hSocket == INVALID_SOCKET)
                 break;
-            nBytes = send(pnode->hSocket, reinterpret_cast<const char*>(data.data()) + pnode->nSendOffset, data.size() - pnode->nSendOffset, MSG_NOSIGNAL | MSG_DONTWAIT);
+#ifndef WIN32
+            // Hand the kernel as much of the queue as fits in one call
+            struct iovec iov[MAX_SEND_IOVECS];
+            int nIov = 0;
+            size_t nOffset = pnode->nSendOffset;
+            for (auto itIov = it; itIov != pnode->vSendMsg.end() && nIov < MAX_SEND_IOVECS; ++itIov, ++nIov) {
+                iov[nIov].iov_base = const_cast<unsigned char*>((*itIov)->data()) + nOffset;
+                iov[nIov].iov_len = (*itIov)->size() - nOffset;
+                nOffered += iov[nIov].iov_len;
+                nOffset = 0;
+            }
+            struct msghdr msg = {};
+            msg.msg_iov = iov;
+            msg.msg_iovlen = nIov;
+            nBytes = sendmsg(pnode->hSocket, &msg, MSG_NOSIGNAL | MSG_DONTWAIT);
+#else
+            const auto &data = **it;
+            nOffered = data.size() - pnode->nSendOffset;
+            nBytes = send(pnode->hSocket, reinterpret_cast<const char*>(data.data()) + pnode->nSendOffset, nOffered, MSG_NOSIGNAL | MSG_DONTWAIT);
+#endif
         }
         if (nBytes > 0) {
             pnode->nLastSend = GetSystemTimeInSeconds();
             pnode->nSendBytes += nBytes;
-            pnode->nSendOffset += nBytes;
             nSentSize += nBytes;
-            if (pnode->nSendOffset == data.size()) {
+            size_t nLeft = nBytes;
+            while (nLeft > 0) {
+                size_t nRemaining = (*it)->size() - pnode->nSendOffset;
+                if (nLeft < nRemaining) {
+                    pnode->nSendOffset += nLeft;
+                    break;
+                }
+                nLeft -= nRemaining;
                 pnode->nSendOffset = 0;
-                pnode->nSendSize -= data.size();
-                pnode->fPauseSend = pnode->nSendSize > nSendBufferMaxSize;
+                pnode->nSendSize -= (*it)->size();
                 it++;
-            } else {
-                // could not send full message; stop sending more
+            }
+            pnode->fPauseSend = pnode->nSendSize > nSendBufferMaxSize;
+            if ((size_t)nBytes < nOffered) {
+                // could not send everything; stop sending more
                 break;
             }
         } else {
@@ -1104,7 +1171,7 @@ void CConnman::AcceptConnection(const ListenSocket& hListenSocket) {
         return;
     }
 
-    if (!IsSelectableSocket(hSocket))
+    if (socketEvents->IsFdSetLimited() && !IsSelectableSocket(hSocket))
     {
         LogPrintf("connection from %s dropped: non-selectable socket\n", addr.ToString());
         CloseSocket(hSocket);
@@ -1149,8 +1216,17 @@ void CConnman::AcceptConnection(const ListenSocket& hListenSocket) {
     }
 }
 
+/** Tags of listening sockets in socketEvents, above any NodeId the peers are registered with */
+static const uint64_t SOCKET_TAG_LISTEN = uint64_t{1} << 30;
+
 void CConnman::ThreadSocketHandler()
 {
+    // Listening sockets stay level triggered so that every pending connection gets accepted
+    for (size_t i = 0; i < vhListenSocket.size(); i++) {
+        if (!socketEvents->Add(vhListenSocket[i].socket, SOCKET_TAG_LISTEN + i, SOCKET_EVENT_RECV, false))
+            LogPrintf("Failed to watch listening socket %u with %s\n", i, socketEvents->GetName());
+    }
+
     unsigned int nPrevNodeCount = 0;
     while (!interruptNet)
     {
@@ -1171,6 +1247,12 @@ void CConnman::ThreadSocketHandler()
                     // release outbound grant (if any)
                     pnode->grantOutbound.Release();
 
+                    // stop watching the socket before it's closed and its descriptor reused
+                    if (pnode->fSocketRegistered) {
+                        socketEvents->Remove(pnode->GetId());
+                        pnode->fSocketRegistered = false;
+                    }
+
                     // close socket and cleanup
                     pnode->CloseSocketDisconnect();
 
@@ -1216,95 +1298,83 @@ void CConnman::ThreadSocketHandler()
         }
 
         //
-        // Find which sockets have data to receive
+        // Register new sockets and find which ones have work left over
         //
-        struct timeval timeout;
-        timeout.tv_sec  = 0;
-        timeout.tv_usec = 50000; // frequency to poll pnode->vSend
-
-        fd_set fdsetRecv;
-        fd_set fdsetSend;
-        fd_set fdsetError;
-        FD_ZERO(&fdsetRecv);
-        FD_ZERO(&fdsetSend);
-        FD_ZERO(&fdsetError);
-        SOCKET hSocketMax = 0;
-        bool have_fds = false;
-
-        for (const ListenSocket& hListenSocket : vhListenSocket) {
-            FD_SET(hListenSocket.socket, &fdsetRecv);
-            hSocketMax = std::max(hSocketMax, hListenSocket.socket);
-            have_fds = true;
-        }
-
+        bool fPendingWork = false;
         {
             LOCK(cs_vNodes);
             for (CNode* pnode : vNodes)
             {
                 // Implement the following logic:
-                // * If there is data to send, select() for sending data. As this only
+                // * If there is data to send, wait for sending data. As this only
                 //   happens when optimistic write failed, we choose to first drain the
                 //   write buffer in this case before receiving more. This avoids
                 //   needlessly queueing received data, if the remote peer is not themselves
                 //   receiving data. This means properly utilizing TCP flow control signalling.
-                // * Otherwise, if there is space left in the receive buffer, select() for
+                // * Otherwise, if there is space left in the receive buffer, wait for
                 //   receiving data.
                 // * Hand off all complete messages to the processor, to be handled without
                 //   blocking here.
 
-                bool select_recv = !pnode->fPauseRecv;
                 bool select_send;
                 {
                     LOCK(pnode->cs_vSend);
                     select_send = !pnode->vSendMsg.empty();
                 }
+                bool select_recv = !pnode->fPauseRecv && !select_send;
 
                 LOCK(pnode->cs_hSocket);
-                if (pnode->hSocket == INVALID_SOCKET)
-                    continue;
-
-                FD_SET(pnode->hSocket, &fdsetError);
-                hSocketMax = std::max(hSocketMax, pnode->hSocket);
-                have_fds = true;
-
-                if (select_send) {
-                    FD_SET(pnode->hSocket, &fdsetSend);
+                if (pnode->hSocket == INVALID_SOCKET) {
+                    if (pnode->fSocketRegistered) {
+                        socketEvents->Remove(pnode->GetId());
+                        pnode->fSocketRegistered = false;
+                    }
                     continue;
                 }
-                if (select_recv) {
-                    FD_SET(pnode->hSocket, &fdsetRecv);
+
+                if (!pnode->fSocketRegistered) {
+                    if (!socketEvents->Add(pnode->hSocket, pnode->GetId(), SOCKET_EVENT_RECV | SOCKET_EVENT_SEND, true)) {
+                        LogPrintf("socket registration with %s failed, disconnecting peer=%d\n", socketEvents->GetName(), pnode->GetId());
+                        pnode->fDisconnect = true;
+                        continue;
+                    }
+                    pnode->fSocketRegistered = true;
+                    // Data that arrived before the registration produced no edge
+                    pnode->fSocketReadable = true;
                 }
+                socketEvents->SetInterest(pnode->GetId(), (select_send ? SOCKET_EVENT_SEND : 0) | (select_recv ? SOCKET_EVENT_RECV : 0));
+
+                if ((select_send && pnode->fSocketWritable) || (select_recv && pnode->fSocketReadable))
+                    fPendingWork = true;
             }
         }
 
-        int nSelect = select(have_fds ? hSocketMax + 1 : 0,
-                             &fdsetRecv, &fdsetSend, &fdsetError, &timeout);
+        // frequency to poll pnode->vSend, unless a socket is already known to be ready
+        std::vector<CSocketEvents::Event> vEvents;
+        bool fWaitFailed = !socketEvents->Wait(fPendingWork ? 0 : 50, vEvents);
         if (interruptNet)
             return;
 
-        if (nSelect == SOCKET_ERROR)
+        if (fWaitFailed)
         {
-            if (have_fds)
-            {
-                int nErr = WSAGetLastError();
-                LogPrintf("socket select error %s\n", NetworkErrorString(nErr));
-                for (unsigned int i = 0; i <= hSocketMax; i++)
-                    FD_SET(i, &fdsetRecv);
-            }
-            FD_ZERO(&fdsetSend);
-            FD_ZERO(&fdsetError);
-            if (!interruptNet.sleep_for(std::chrono::milliseconds(timeout.tv_usec/1000)))
+            int nErr = WSAGetLastError();
+            LogPrintf("socket %s error %s\n", socketEvents->GetName(), NetworkErrorString(nErr));
+            if (!interruptNet.sleep_for(std::chrono::milliseconds(50)))
                 return;
         }
 
         //
         // Accept new connections
         //
-        for (const ListenSocket& hListenSocket : vhListenSocket)
+        std::unordered_map<uint64_t, int> mapSocketEvents;
+        for (const CSocketEvents::Event& event : vEvents)
         {
-            if (hListenSocket.socket != INVALID_SOCKET && FD_ISSET(hListenSocket.socket, &fdsetRecv))
-            {
-                AcceptConnection(hListenSocket);
+            if (event.nTag >= SOCKET_TAG_LISTEN) {
+                size_t nListen = event.nTag - SOCKET_TAG_LISTEN;
+                if (nListen < vhListenSocket.size() && vhListenSocket[nListen].socket != INVALID_SOCKET)
+                    AcceptConnection(vhListenSocket[nListen]);
+            } else {
+                mapSocketEvents[event.nTag] |= event.nFlags;
             }
         }
 
@@ -1323,20 +1393,28 @@ void CConnman::ThreadSocketHandler()
             if (interruptNet)
                 return;
 
+            bool errorSet = fWaitFailed;
+            auto itEvents = mapSocketEvents.find(pnode->GetId());
+            if (itEvents != mapSocketEvents.end()) {
+                if (itEvents->second & SOCKET_EVENT_RECV)
+                    pnode->fSocketReadable = true;
+                if (itEvents->second & SOCKET_EVENT_SEND)
+                    pnode->fSocketWritable = true;
+                if (itEvents->second & SOCKET_EVENT_ERROR)
+                    errorSet = true;
+            }
+
+            bool select_send;
+            {
+                LOCK(pnode->cs_vSend);
+                select_send = !pnode->vSendMsg.empty();
+            }
+            bool recvSet = pnode->fSocketReadable && !pnode->fPauseRecv && !select_send;
+            bool sendSet = pnode->fSocketWritable && select_send;
+
             //
             // Receive
             //
-            bool recvSet = false;
-            bool sendSet = false;
-            bool errorSet = false;
-            {
-                LOCK(pnode->cs_hSocket);
-                if (pnode->hSocket == INVALID_SOCKET)
-                    continue;
-                recvSet = FD_ISSET(pnode->hSocket, &fdsetRecv);
-                sendSet = FD_ISSET(pnode->hSocket, &fdsetSend);
-                errorSet = FD_ISSET(pnode->hSocket, &fdsetError);
-            }
             if (recvSet || errorSet)
             {
                 // typical socket buffer is 8K-64K
@@ -1350,6 +1428,9 @@ void CConnman::ThreadSocketHandler()
                 }
                 if (nBytes > 0)
                 {
+                    // A short read drained the socket, so more data raises a new edge
+                    if (nBytes < (int)sizeof(pchBuf))
+                        pnode->fSocketReadable = false;
                     bool notify = false;
                     if (!pnode->ReceiveMsgBytes(pchBuf, nBytes, notify))
                         pnode->CloseSocketDisconnect();
@@ -1383,7 +1464,11 @@ void CConnman::ThreadSocketHandler()
                 {
                     // error
                     int nErr = WSAGetLastError();
-                    if (nErr != WSAEWOULDBLOCK && nErr != WSAEMSGSIZE && nErr != WSAEINTR && nErr != WSAEINPROGRESS)
+                    if (nErr == WSAEWOULDBLOCK)
+                    {
+                        pnode->fSocketReadable = false;
+                    }
+                    else if (nErr != WSAEMSGSIZE && nErr != WSAEINTR && nErr != WSAEINPROGRESS)
                     {
                         if (!pnode->fDisconnect)
                             LogPrintf("socket recv error %s\n", NetworkErrorString(nErr));
@@ -1402,6 +1487,9 @@ void CConnman::ThreadSocketHandler()
                 if (nBytes) {
                     RecordBytesSent(nBytes);
                 }
+                // Whatever is left didn't fit in the socket buffer; wait for it to drain
+                if (!pnode->vSendMsg.empty())
+                    pnode->fSocketWritable = false;
             }
 
             //
@@ -1449,9 +1537,9 @@ void CConnman::WakeMessageHandler()
 {
     {
         std::lock_guard<std::mutex> lock(mutexMsgProc);
-        fMsgProcWake = true;
+        nMsgProcWake++;
     }
-    condMsgProc.notify_one();
+    condMsgProc.notify_all();
 }
 
 
@@ -1683,7 +1771,7 @@ void CConnman::DumpAddresses()
     int64_t nStart = GetTimeMillis();
 
     CAddrDB adb;
-    adb.Write(addrman);
+    adb.Write(*addrman.GetCurrentSnapshot());
 
     LogPrint(BCLog::NET, "Flushed %d addresses to peers.dat  %dms\n",
            addrman.size(), GetTimeMillis() - nStart);
@@ -2027,8 +2115,14 @@ bool CConnman::OpenNetworkConnection(const CAddress& addrConnect, bool fCountFai
     return true;
 }
 
-void CConnman::ThreadMessageHandler()
+void CConnman::ThreadMessageHandler(int nWorker, int nWorkers)
 {
+    uint64_t nLastWake;
+    {
+        std::unique_lock<std::mutex> lock(mutexMsgProc);
+        nLastWake = nMsgProcWake;
+    }
+
     while (!flagInterruptMsgProc)
     {
         std::vector<CNode*> vNodesCopy;
@@ -2042,24 +2136,30 @@ void CConnman::ThreadMessageHandler()
 
         bool fMoreWork = false;
 
-        for (CNode* pnode : vNodesCopy)
+        // Each worker starts at a different node so they don't all contend for the same ones
+        size_t nStart = vNodesCopy.size() * nWorker / nWorkers;
+        for (size_t i = 0; i < vNodesCopy.size(); i++)
         {
+            CNode* pnode = vNodesCopy[(nStart + i) % vNodesCopy.size()];
             if (pnode->fDisconnect)
                 continue;
 
+            // Another worker has this node; it'll pick up anything queued meanwhile
+            if (pnode->fMessageProcessing.exchange(true))
+                continue;
+
             // Receive messages
             bool fMoreNodeWork = m_msgproc->ProcessMessages(pnode, flagInterruptMsgProc);
             fMoreWork |= (fMoreNodeWork && !pnode->fPauseSend);
-            if (flagInterruptMsgProc)
-                return;
             // Send messages
-            {
+            if (!flagInterruptMsgProc) {
                 LOCK(pnode->cs_sendProcessing);
                 m_msgproc->SendMessages(pnode, flagInterruptMsgProc);
             }
+            pnode->fMessageProcessing = false;
 
             if (flagInterruptMsgProc)
-                return;
+                break;
         }
 
         {
@@ -2068,11 +2168,14 @@ void CConnman::ThreadMessageHandler()
                 pnode->Release();
         }
 
+        if (flagInterruptMsgProc)
+            return;
+
         std::unique_lock<std::mutex> lock(mutexMsgProc);
         if (!fMoreWork) {
-            condMsgProc.wait_until(lock, std::chrono::steady_clock::now() + std::chrono::milliseconds(100), [this] { return fMsgProcWake; });
+            condMsgProc.wait_until(lock, std::chrono::steady_clock::now() + std::chrono::milliseconds(100), [this, nLastWake] { return nMsgProcWake != nLastWake; });
         }
-        fMsgProcWake = false;
+        nLastWake = nMsgProcWake;
     }
 }
 
@@ -2322,6 +2425,17 @@ bool CConnman::Start(CScheduler& scheduler, const Options& connOptions)
 
     LogPrintf("Connection Manager: Start");
 
+    socketEvents = CreateSocketEvents(connOptions.strSocketEvents);
+    if (!socketEvents) {
+        if (clientInterface) {
+            clientInterface->ThreadSafeMessageBox(
+                strprintf(_("Failed to set up -socketevents=%s."), connOptions.strSocketEvents),
+                "", CClientUIInterface::MSG_ERROR);
+        }
+        return false;
+    }
+    LogPrintf("Connection Manager: Using %s for socket events\n", socketEvents->GetName());
+
     if (fListen && !InitBinds(connOptions.vBinds, connOptions.vWhiteBinds)) {
         if (clientInterface) {
             clientInterface->ThreadSafeMessageBox(
@@ -2396,7 +2510,7 @@ bool CConnman::Start(CScheduler& scheduler, const Options& connOptions)
 
     {
         std::unique_lock<std::mutex> lock(mutexMsgProc);
-        fMsgProcWake = false;
+        nMsgProcWake = 0;
     }
 
     // Send and receive from sockets, accept connections
@@ -2422,10 +2536,17 @@ bool CConnman::Start(CScheduler& scheduler, const Options& connOptions)
         threadOpenConnections = std::thread(&TraceThread<std::function<void()> >, "opencon", std::function<void()>(std::bind(&CConnman::ThreadOpenConnections, this)));
 
     // Process messages
-    threadMessageHandler = std::thread(&TraceThread<std::function<void()> >, "msghand", std::function<void()>(std::bind(&CConnman::ThreadMessageHandler, this)));
+    int nWorkers = std::max(1, std::min(connOptions.nMessageHandlerThreads, MAX_MESSAGE_HANDLER_THREADS));
+    LogPrintf("Using %d message handler threads\n", nWorkers);
+    for (int i = 0; i < nWorkers; i++) {
+        std::string strName = i == 0 ? "msghand" : strprintf("msghand.%d", i);
+        threadMessageHandlers.emplace_back([this, strName, i, nWorkers] {
+            TraceThread(strName.c_str(), std::function<void()>(std::bind(&CConnman::ThreadMessageHandler, this, i, nWorkers)));
+        });
+    }
 
     // Dump network addresses
-    scheduler.scheduleEvery(std::bind(&CConnman::DumpData, this), DUMP_ADDRESSES_INTERVAL * 1000);
+    scheduler.scheduleEvery(std::bind(&CConnman::DumpData, this), DUMP_ADDRESSES_INTERVAL * 1000, "addresses_dump");
 
     return true;
 }
@@ -2479,8 +2600,11 @@ void CConnman::Interrupt()
 
 void CConnman::Stop()
 {
-    if (threadMessageHandler.joinable())
-        threadMessageHandler.join();
+    for (std::thread& thread : threadMessageHandlers) {
+        if (thread.joinable())
+            thread.join();
+    }
+    threadMessageHandlers.clear();
     if (threadOpenConnections.joinable())
         threadOpenConnections.join();
     if (threadOpenAddedConnections.joinable())
@@ -2504,6 +2628,8 @@ void CConnman::Stop()
             if (!CloseSocket(hListenSocket.socket))
                 LogPrintf("CloseSocket(hListenSocket) failed with error %s\n", NetworkErrorString(WSAGetLastError()));
 
+    socketEvents.reset();
+
     // clean up some globals (to help leak detection)
     for (CNode *pnode : vNodes) {
         DeleteNode(pnode);
@@ -2880,12 +3006,9 @@ bool CConnman::NodeFullyConnected(const CNode* pnode)
     return pnode && pnode->fSuccessfullyConnected && !pnode->fDisconnect;
 }
 
-void CConnman::PushMessage(CNode* pnode, CSerializedNetMsg&& msg)
+CSharedNetMsg CConnman::MakeSharedMessage(CSerializedNetMsg&& msg) const
 {
     size_t nMessageSize = msg.data.size();
-    size_t nTotalSize = nMessageSize + CMessageHeader::HEADER_SIZE;
-    LogPrint(BCLog::NET, "sending %s (%d bytes) peer=%d\n",  SanitizeString(msg.command.c_str()), nMessageSize, pnode->GetId());
-
     std::vector<unsigned char> serializedHeader;
     serializedHeader.reserve(CMessageHeader::HEADER_SIZE);
     uint256 hash = Hash(msg.data.data(), msg.data.data() + nMessageSize);
@@ -2894,6 +3017,25 @@ void CConnman::PushMessage(CNode* pnode, CSerializedNetMsg&& msg)
 
     CVectorWriter{SER_NETWORK, INIT_PROTO_VERSION, serializedHeader, 0, hdr};
 
+    CSharedNetMsg shared;
+    shared.header = std::make_shared<const std::vector<unsigned char>>(std::move(serializedHeader));
+    if (nMessageSize)
+        shared.data = std::make_shared<const std::vector<unsigned char>>(std::move(msg.data));
+    shared.command = std::move(msg.command);
+    return shared;
+}
+
+void CConnman::PushMessage(CNode* pnode, CSerializedNetMsg&& msg)
+{
+    PushMessage(pnode, MakeSharedMessage(std::move(msg)));
+}
+
+void CConnman::PushMessage(CNode* pnode, const CSharedNetMsg& msg)
+{
+    size_t nMessageSize = msg.data ? msg.data->size() : 0;
+    size_t nTotalSize = nMessageSize + CMessageHeader::HEADER_SIZE;
+    LogPrint(BCLog::NET, "sending %s (%d bytes) peer=%d\n",  SanitizeString(msg.command.c_str()), nMessageSize, pnode->GetId());
+
     size_t nBytesSent = 0;
     {
         LOCK(pnode->cs_vSend);
@@ -2905,11 +3047,9 @@ void CConnman::PushMessage(CNode* pnode, CSerializedNetMsg&& msg)
 
         if (pnode->nSendSize > nSendBufferMaxSize)
             pnode->fPauseSend = true;
-//         LogPrintf("Header: %s\n", HexStr(serializedHeader));
-        pnode->vSendMsg.push_back(std::move(serializedHeader));
+        pnode->vSendMsg.push_back(msg.header);
         if (nMessageSize) {
-//             LogPrintf("Data: %s\n", HexStr(msg.data));
-            pnode->vSendMsg.push_back(std::move(msg.data));
+            pnode->vSendMsg.push_back(msg.data);
         }
 
         // If write queue empty, attempt "optimistic write"
@@ -18,6 +18,7 @@
 #include "policy/feerate.h"
 #include "protocol.h"
 #include "random.h"
+#include "sockevents.h"
 #include "streams.h"
 #include "sync.h"
 #include "uint256.h"
@@ -28,6 +29,7 @@
 #include <stdint.h>
 #include <thread>
 #include <memory>
+#include <mutex>
 #include <condition_variable>
 
 #ifndef WIN32
@@ -88,6 +90,16 @@ static const bool DEFAULT_BLOCKSONLY = false;
 static const bool DEFAULT_FORCEDNSSEED = false;
 static const size_t DEFAULT_MAXRECEIVEBUFFER = 5 * 1000;
 static const size_t DEFAULT_MAXSENDBUFFER    = 1 * 1000;
+/** Most idle receive buffers CNetMessageBufferPool keeps */
+static const size_t MAX_POOLED_RECV_BUFFERS = 128;
+/** Receive buffers that grew past this (blocks, mostly) are freed instead of pooled */
+static const size_t MAX_POOLED_RECV_BUFFER_SIZE = 64 * 1024;
+/** Most send buffer entries handed to a single sendmsg call */
+static const int MAX_SEND_IOVECS = 64;
+/** Default for -msghandlerthreads */
+static const int DEFAULT_MESSAGE_HANDLER_THREADS = 2;
+/** Most message handler threads -msghandlerthreads will start */
+static const int MAX_MESSAGE_HANDLER_THREADS = 16;
 
 // NOTE: When adjusting this, update rpcnet:setban's help ("24h")
 static const unsigned int DEFAULT_MISBEHAVING_BANTIME = 60 * 60 * 24;  // Default 24-hour ban
@@ -118,6 +130,18 @@ struct CSerializedNetMsg
     std::string command;
 };
 
+/**
+ * A message whose header and payload were serialized once, so that it can be
+ * queued on the send buffer of any number of peers without copying. Made by
+ * CConnman::MakeSharedMessage; the buffers must not change afterwards.
+ */
+struct CSharedNetMsg
+{
+    std::shared_ptr<const std::vector<unsigned char>> header;
+    std::shared_ptr<const std::vector<unsigned char>> data;
+    std::string command;
+};
+
 class NetEventsInterface;
 class CConnman
 {
@@ -150,6 +174,8 @@ public:
         bool m_use_addrman_outgoing = true;
         std::vector<std::string> m_specified_outgoing;
         std::vector<std::string> m_added_nodes;
+        std::string strSocketEvents = DEFAULT_SOCKETEVENTS;
+        int nMessageHandlerThreads = DEFAULT_MESSAGE_HANDLER_THREADS;
     };
 
     void Init(const Options& connOptions) {
@@ -188,6 +214,9 @@ public:
     bool ForNode(NodeId id, std::function<bool(CNode* pnode)> func);
 
     void PushMessage(CNode* pnode, CSerializedNetMsg&& msg);
+    void PushMessage(CNode* pnode, const CSharedNetMsg& msg);
+    //! Serialize msg's header once, for relaying the same bytes to many peers
+    CSharedNetMsg MakeSharedMessage(CSerializedNetMsg&& msg) const;
 
     template<typename Callable>
     void ForEachNode(Callable&& func)
@@ -334,7 +363,7 @@ private:
     void AddOneShot(const std::string& strDest);
     void ProcessOneShot();
     void ThreadOpenConnections();
-    void ThreadMessageHandler();
+    void ThreadMessageHandler(int nWorker, int nWorkers);
     void AcceptConnection(const ListenSocket& hListenSocket);
     void ThreadSocketHandler();
     void ThreadDNSAddressSeed();
@@ -423,8 +452,8 @@ private:
     /** SipHasher seeds for deterministic randomness */
     const uint64_t nSeed0, nSeed1;
 
-    /** flag for waking the message processor. */
-    bool fMsgProcWake;
+    /** bumped to wake all message handler threads */
+    uint64_t nMsgProcWake;
 
     std::condition_variable condMsgProc;
     std::mutex mutexMsgProc;
@@ -434,9 +463,11 @@ private:
 
     std::thread threadDNSAddressSeed;
     std::thread threadSocketHandler;
+    //! Readiness backend of ThreadSocketHandler, picked with -socketevents
+    std::unique_ptr<CSocketEvents> socketEvents;
     std::thread threadOpenAddedConnections;
     std::thread threadOpenConnections;
-    std::thread threadMessageHandler;
+    std::vector<std::thread> threadMessageHandlers;
 
     /** flag for deciding to connect to an extra outbound peer,
      *  in excess of nMaxOutbound
@@ -564,6 +595,27 @@ public:
 
 
 
+/**
+ * Idle CNetMessage receive buffers. The socket thread takes one for every
+ * message whose header it has read and the message handler gives it back when
+ * it is done with the message, so a steady stream of small messages doesn't
+ * allocate (and zero on free) a new buffer for each one.
+ */
+class CNetMessageBufferPool
+{
+    std::mutex cs;
+    std::vector<CSerializeData> vFree;
+
+public:
+    //! Swap an idle buffer, if there is one, into the empty stream s
+    void Take(CDataStream& s);
+    //! Clear s and keep its buffer for a later Take, unless it is too big or the pool is full
+    void Give(CDataStream& s);
+    size_t size();
+};
+
+extern CNetMessageBufferPool netMessageBufferPool;
+
 class CNetMessage {
 private:
     mutable CHash256 hasher;
@@ -587,6 +639,10 @@ public:
         nDataPos = 0;
         nTime = 0;
     }
+    CNetMessage(CNetMessage&&) = default;
+    CNetMessage& operator=(CNetMessage&&) = default;
+    //! Gives vRecv's buffer back to netMessageBufferPool
+    ~CNetMessage();
 
     bool complete() const
     {
@@ -619,7 +675,8 @@ public:
     size_t nSendSize; // total size of all vSendMsg entries
     size_t nSendOffset; // offset inside the first vSendMsg already sent
     uint64_t nSendBytes;
-    std::deque<std::vector<unsigned char>> vSendMsg;
+    // Headers and payloads, possibly shared with other peers' queues (see CSharedNetMsg)
+    std::deque<std::shared_ptr<const std::vector<unsigned char>>> vSendMsg;
     CCriticalSection cs_vSend;
     CCriticalSection cs_hSocket;
     CCriticalSection cs_vRecv;
@@ -632,6 +689,9 @@ public:
 
     std::deque<CInv> vRecvGetData;
     std::deque<CInvAsset> vRecvAssetGetData;
+    // Token bucket pacing how fast vRecvAssetGetData is answered; used by the message handler only
+    double dAssetDataTokens{MAX_ASSET_INV_SZ};
+    int64_t nAssetDataTokensTime{0};
     uint64_t nRecvBytes;
     std::atomic<int> nRecvVersion;
 
@@ -672,6 +732,13 @@ public:
     const uint64_t nKeyedNetGroup;
     std::atomic_bool fPauseRecv;
     std::atomic_bool fPauseSend;
+    // Socket readiness, only used by the socket handler thread. Edge triggered
+    // events set these and a short recv or send clears them again.
+    bool fSocketRegistered{false};
+    // Set while a message handler thread is processing this node, so that a peer's messages stay in order
+    std::atomic_bool fMessageProcessing{false};
+    bool fSocketReadable{false};
+    bool fSocketWritable{true};
 protected:
 
     mapMsgCmdSize mapSendBytesPerMsgCmd;
@@ -701,6 +768,8 @@ public:
     // There is no final sorting before sending, as they are always sent immediately
     // and in the order requested.
     std::vector<uint256> vInventoryBlockToSend;
+    // ISLOCK and CLSIG announcements, sent immediately like blocks
+    std::vector<CInv> vInventoryOtherToSend;
     CCriticalSection cs_inventory;
     std::set<uint256> setAskFor;
     std::multimap<int64_t, CInv> mapAskFor;
@@ -842,6 +911,8 @@ public:
             }
         } else if (inv.type == MSG_BLOCK) {
             vInventoryBlockToSend.push_back(inv.hash);
+        } else if (!filterInventoryKnown.contains(inv.hash)) {
+            vInventoryOtherToSend.push_back(inv);
         }
     }
 
@@ -7,12 +7,18 @@
 #include "net_processing.h"
 
 #include "addrman.h"
+#include "assets/assetdb.h"
 #include "arith_uint256.h"
 #include "blockencodings.h"
+#include "blockfilterindex.h"
 #include "chainparams.h"
 #include "consensus/validation.h"
+#include "core_memusage.h"
 #include "hash.h"
 #include "init.h"
+#include "llmq/chainlocks.h"
+#include "llmq/instantsend.h"
+#include "llmq/quorums.h"
 #include "validation.h"
 #include "merkleblock.h"
 #include "net.h"
@@ -23,6 +29,7 @@
 #include "primitives/block.h"
 #include "primitives/transaction.h"
 #include "random.h"
+#include "relaycache.h"
 #include "reverse_iterator.h"
 #include "scheduler.h"
 #include "tinyformat.h"
@@ -53,9 +60,17 @@ struct COrphanTx {
     CTransactionRef tx;
     NodeId fromPeer;
     int64_t nTimeExpire;
+    size_t nUsage;
 };
 std::map<uint256, COrphanTx> mapOrphanTransactions GUARDED_BY(cs_main);
 std::map<COutPoint, std::set<std::map<uint256, COrphanTx>::iterator, IteratorComparator>> mapOrphanTransactionsByPrev GUARDED_BY(cs_main);
+/** The orphans a peer sent, and the memory they take */
+struct COrphanPeer {
+    size_t nUsage;
+    std::set<uint256> setOrphans;
+};
+std::map<NodeId, COrphanPeer> mapOrphansByPeer GUARDED_BY(cs_main);
+size_t nOrphanUsage GUARDED_BY(cs_main) = 0;
 void EraseOrphansFor(NodeId peer) EXCLUSIVE_LOCKS_REQUIRED(cs_main);
 
 static size_t vExtraTxnForCompactIt = 0;
@@ -114,6 +129,7 @@ namespace {
         const CBlockIndex* pindex;                               //!< Optional.
         bool fValidatedHeaders;                                  //!< Whether this block has validated headers at the time of request.
         std::unique_ptr<PartiallyDownloadedBlock> partialBlock;  //!< Optional, used for CMPCTBLOCK downloads
+        int64_t nTimeRequested;                                  //!< When the block was requested (in microseconds).
     };
     std::map<uint256, std::pair<NodeId, std::list<QueuedBlock>::iterator> > mapBlocksInFlight;
 
@@ -137,8 +153,24 @@ namespace {
     MapRelay mapRelay;
     /** Expiration-time ordered list of (expire time, relay map entry) pairs, protected by cs_main). */
     std::deque<std::pair<int64_t, MapRelay::iterator>> vRelayExpiration;
+    /** Memory mapRelay and vRelayExpiration take, counting each transaction in full as it may have left the mempool, protected by cs_main. */
+    size_t nMapRelayUsage = 0;
 } // namespace
 
+static size_t RelayEntryUsage(const CTransactionRef& tx)
+{
+    return RecursiveDynamicUsage(tx) + memusage::MallocUsage(sizeof(memusage::stl_tree_node<MapRelay::value_type>)) +
+           sizeof(decltype(vRelayExpiration)::value_type);
+}
+
+static void EraseOldestRelayEntry()
+{
+    MapRelay::iterator it = vRelayExpiration.front().second;
+    nMapRelayUsage -= RelayEntryUsage(it->second);
+    mapRelay.erase(it);
+    vRelayExpiration.pop_front();
+}
+
 namespace {
 
 struct CBlockReject {
@@ -187,6 +219,12 @@ struct CNodeState {
     int64_t nDownloadingSince{0};
     int nBlocksInFlight{0};
     int nBlocksInFlightValidHeaders{0};
+    //! Smoothed time from requesting a block from an idle queue to receiving it (in microseconds), or 0.
+    int64_t nBlockRtt{0};
+    //! Smoothed time between back to back block deliveries (in microseconds), or 0.
+    int64_t nBlockServiceTime{0};
+    //! When the last requested block from this peer arrived (in microseconds).
+    int64_t nLastBlockReceived{0};
     //! Whether we consider this a preferred download peer.
     bool fPreferredDownload{false};
     //! Whether this peer wants invs or headers (when possible) for block announcements.
@@ -313,6 +351,39 @@ bool MarkBlockAsReceived(const uint256& hash) {
     return false;
 }
 
+// Requires cs_main.
+// Update nodeid's latency and delivery rate estimates for the arrival of hash, if it was requested from nodeid.
+void RecordBlockDelivery(NodeId nodeid, const uint256& hash) {
+    std::map<uint256, std::pair<NodeId, std::list<QueuedBlock>::iterator> >::iterator itInFlight = mapBlocksInFlight.find(hash);
+    if (itInFlight == mapBlocksInFlight.end() || itInFlight->second.first != nodeid)
+        return;
+    CNodeState *state = State(nodeid);
+    assert(state != nullptr);
+
+    int64_t nNow = GetTimeMicros();
+    int64_t nRequested = itInFlight->second.second->nTimeRequested;
+    if (itInFlight->second.second == state->vBlocksInFlight.begin() && nRequested >= state->nLastBlockReceived) {
+        // Nothing was queued ahead of this block, so it took a round trip plus its own transfer
+        int64_t nRtt = nNow - nRequested;
+        state->nBlockRtt = state->nBlockRtt ? (7 * state->nBlockRtt + nRtt) / 8 : nRtt;
+    } else {
+        // Queued behind the previous delivery: the gap is what the peer needs per block
+        int64_t nService = std::max<int64_t>(1, nNow - std::max(nRequested, state->nLastBlockReceived));
+        state->nBlockServiceTime = state->nBlockServiceTime ? (7 * state->nBlockServiceTime + nService) / 8 : nService;
+    }
+    state->nLastBlockReceived = nNow;
+}
+
+// Requires cs_main.
+// How many blocks to keep in flight from a peer: enough to cover a round trip at its delivery rate, with
+// headroom, so fast peers stay busy while slow ones don't hold on to a large part of the download window.
+int GetBlockDownloadWindow(const CNodeState& state) {
+    if (state.nBlockRtt == 0 || state.nBlockServiceTime == 0)
+        return MAX_BLOCKS_IN_TRANSIT_PER_PEER;
+    int64_t nWindow = 2 * (state.nBlockRtt / state.nBlockServiceTime + 1);
+    return std::max<int64_t>(MIN_ADAPTIVE_BLOCKS_IN_TRANSIT_PER_PEER, std::min<int64_t>(MAX_ADAPTIVE_BLOCKS_IN_TRANSIT_PER_PEER, nWindow));
+}
+
 // Requires cs_main.
 // returns false, still setting pit, if the block was already in flight from the same peer
 // pit will only be valid as long as the same cs_main lock is being held
@@ -333,7 +404,7 @@ bool MarkBlockAsInFlight(NodeId nodeid, const uint256& hash, const CBlockIndex*
     MarkBlockAsReceived(hash);
 
     std::list<QueuedBlock>::iterator it = state->vBlocksInFlight.insert(state->vBlocksInFlight.end(),
-            {hash, pindex, pindex != nullptr, std::unique_ptr<PartiallyDownloadedBlock>(pit ? new PartiallyDownloadedBlock(&mempool) : nullptr)});
+            {hash, pindex, pindex != nullptr, std::unique_ptr<PartiallyDownloadedBlock>(pit ? new PartiallyDownloadedBlock(&mempool) : nullptr), GetTimeMicros()});
     state->nBlocksInFlight++;
     state->nBlocksInFlightValidHeaders += it->fValidatedHeaders;
     if (state->nBlocksInFlight == 1) {
@@ -441,8 +512,9 @@ bool PeerHasHeader(CNodeState *state, const CBlockIndex *pindex)
 }
 
 /** Update pindexLastCommonBlock and add not-in-flight missing successors to vBlocks, until it has
- *  at most count entries. */
-void FindNextBlocksToDownload(NodeId nodeid, unsigned int count, std::vector<const CBlockIndex*>& vBlocks, NodeId& nodeStaller, const Consensus::Params& consensusParams) {
+ *  at most count entries. If the download window keeps anything from being added, nodeStaller and
+ *  pindexStalling are set to the peer and block it is waiting for. */
+void FindNextBlocksToDownload(NodeId nodeid, unsigned int count, std::vector<const CBlockIndex*>& vBlocks, NodeId& nodeStaller, const CBlockIndex*& pindexStalling, const Consensus::Params& consensusParams) {
     if (count == 0)
         return;
 
@@ -478,6 +550,7 @@ void FindNextBlocksToDownload(NodeId nodeid, unsigned int count, std::vector<con
     int nWindowEnd = state->pindexLastCommonBlock->nHeight + BLOCK_DOWNLOAD_WINDOW;
     int nMaxHeight = std::min<int>(state->pindexBestKnownBlock->nHeight, nWindowEnd + 1);
     NodeId waitingfor = -1;
+    const CBlockIndex* pindexWaitingFor = nullptr;
     while (pindexWalk->nHeight < nMaxHeight) {
         // Read up to 128 (or more, if more blocks than that are needed) successors of pindexWalk (towards
         // pindexBestKnownBlock) into vToFetch. We fetch 128, because CBlockIndex::GetAncestor may be as expensive
@@ -513,6 +586,7 @@ void FindNextBlocksToDownload(NodeId nodeid, unsigned int count, std::vector<con
                     if (vBlocks.size() == 0 && waitingfor != nodeid) {
                         // We aren't able to fetch anything, but we would be if the download window was one larger.
                         nodeStaller = waitingfor;
+                        pindexStalling = pindexWaitingFor;
                     }
                     return;
                 }
@@ -523,6 +597,7 @@ void FindNextBlocksToDownload(NodeId nodeid, unsigned int count, std::vector<con
             } else if (waitingfor == -1) {
                 // This is the first already-in-flight block.
                 waitingfor = mapBlocksInFlight[pindex->GetBlockHash()].first;
+                pindexWaitingFor = pindex;
             }
         }
     }
@@ -635,17 +710,22 @@ bool AddOrphanTx(const CTransactionRef& tx, NodeId peer) EXCLUSIVE_LOCKS_REQUIRE
         return false;
     }
 
-    auto ret = mapOrphanTransactions.emplace(hash, COrphanTx{tx, peer, GetTime() + ORPHAN_TX_EXPIRE_TIME});
+    size_t nUsage = RecursiveDynamicUsage(tx);
+    auto ret = mapOrphanTransactions.emplace(hash, COrphanTx{tx, peer, GetTime() + ORPHAN_TX_EXPIRE_TIME, nUsage});
     assert(ret.second);
     for (const CTxIn& txin : tx->vin)
     {
         mapOrphanTransactionsByPrev[txin.prevout].insert(ret.first);
     }
+    COrphanPeer& orphanPeer = mapOrphansByPeer[peer];
+    orphanPeer.nUsage += nUsage;
+    orphanPeer.setOrphans.insert(hash);
+    nOrphanUsage += nUsage;
 
     AddToCompactExtraTransactions(tx);
 
-    LogPrint(BCLog::MEMPOOL, "stored orphan tx %s (mapsz %u outsz %u)\n", hash.ToString(),
-             mapOrphanTransactions.size(), mapOrphanTransactionsByPrev.size());
+    LogPrint(BCLog::MEMPOOL, "stored orphan tx %s (mapsz %u outsz %u usage %u)\n", hash.ToString(),
+             mapOrphanTransactions.size(), mapOrphanTransactionsByPrev.size(), nOrphanUsage);
     return true;
 }
 
@@ -663,6 +743,13 @@ int static EraseOrphanTx(uint256 hash) EXCLUSIVE_LOCKS_REQUIRED(cs_main)
         if (itPrev->second.empty())
             mapOrphanTransactionsByPrev.erase(itPrev);
     }
+    auto itPeer = mapOrphansByPeer.find(it->second.fromPeer);
+    assert(itPeer != mapOrphansByPeer.end());
+    itPeer->second.nUsage -= it->second.nUsage;
+    itPeer->second.setOrphans.erase(hash);
+    if (itPeer->second.setOrphans.empty())
+        mapOrphansByPeer.erase(itPeer);
+    nOrphanUsage -= it->second.nUsage;
     mapOrphanTransactions.erase(it);
     return 1;
 }
@@ -670,20 +757,21 @@ int static EraseOrphanTx(uint256 hash) EXCLUSIVE_LOCKS_REQUIRED(cs_main)
 void EraseOrphansFor(NodeId peer)
 {
     int nErased = 0;
-    std::map<uint256, COrphanTx>::iterator iter = mapOrphanTransactions.begin();
-    while (iter != mapOrphanTransactions.end())
+    auto itPeer = mapOrphansByPeer.find(peer);
+    if (itPeer != mapOrphansByPeer.end())
     {
-        std::map<uint256, COrphanTx>::iterator maybeErase = iter++; // increment to avoid iterator becoming invalid
-        if (maybeErase->second.fromPeer == peer)
+        // Copied, as erasing the last one erases the set
+        std::set<uint256> setOrphans = itPeer->second.setOrphans;
+        for (const uint256& hash : setOrphans)
         {
-            nErased += EraseOrphanTx(maybeErase->second.tx->GetHash());
+            nErased += EraseOrphanTx(hash);
         }
     }
     if (nErased > 0) LogPrint(BCLog::MEMPOOL, "Erased %d orphan tx from peer=%d\n", nErased, peer);
 }
 
 
-unsigned int LimitOrphanTxSize(unsigned int nMaxOrphans) EXCLUSIVE_LOCKS_REQUIRED(cs_main)
+unsigned int LimitOrphanTxSize(unsigned int nMaxOrphans, size_t nMaxUsage) EXCLUSIVE_LOCKS_REQUIRED(cs_main)
 {
     unsigned int nEvicted = 0;
     static int64_t nNextSweep;
@@ -706,14 +794,20 @@ unsigned int LimitOrphanTxSize(unsigned int nMaxOrphans) EXCLUSIVE_LOCKS_REQUIRE
         nNextSweep = nMinExpTime + ORPHAN_TX_EXPIRE_INTERVAL;
         if (nErased > 0) LogPrint(BCLog::MEMPOOL, "Erased %d orphan tx due to expiration\n", nErased);
     }
-    while (mapOrphanTransactions.size() > nMaxOrphans)
+    while (mapOrphanTransactions.size() > nMaxOrphans || nOrphanUsage > nMaxUsage)
     {
-        // Evict a random orphan:
-        uint256 randomhash = GetRandHash();
-        std::map<uint256, COrphanTx>::iterator it = mapOrphanTransactions.lower_bound(randomhash);
-        if (it == mapOrphanTransactions.end())
-            it = mapOrphanTransactions.begin();
-        EraseOrphanTx(it->first);
+        // Evict a random orphan of the peer whose orphans take the most memory,
+        // so that a peer flooding the pool pushes out its own orphans first:
+        auto itPeer = std::max_element(mapOrphansByPeer.begin(), mapOrphansByPeer.end(),
+            [](const std::pair<const NodeId, COrphanPeer>& a, const std::pair<const NodeId, COrphanPeer>& b) {
+                return a.second.nUsage < b.second.nUsage;
+            });
+        const std::set<uint256>& setOrphans = itPeer->second.setOrphans;
+        std::set<uint256>::const_iterator it = setOrphans.lower_bound(GetRandHash());
+        if (it == setOrphans.end())
+            it = setOrphans.begin();
+        uint256 hash = *it;
+        EraseOrphanTx(hash);
         ++nEvicted;
     }
     return nEvicted;
@@ -772,7 +866,28 @@ PeerLogicValidation::PeerLogicValidation(CConnman* connmanIn, CScheduler &schedu
     // combine them in one function and schedule at the quicker (peer-eviction)
     // timer.
     static_assert(EXTRA_PEER_CHECK_INTERVAL < STALE_CHECK_INTERVAL, "peer eviction timer should be less than stale tip check timer");
-    scheduler.scheduleEvery(std::bind(&PeerLogicValidation::CheckForStaleTipAndEvictPeers, this, consensusParams), EXTRA_PEER_CHECK_INTERVAL * 1000);
+    scheduler.scheduleEvery(std::bind(&PeerLogicValidation::CheckForStaleTipAndEvictPeers, this, consensusParams), EXTRA_PEER_CHECK_INTERVAL * 1000, "stale_tip_check");
+    scheduler.scheduleEvery(std::bind(&PeerLogicValidation::RelaySigShares, this), SIG_SHARES_RELAY_INTERVAL, "sigshares_relay");
+}
+
+void PeerLogicValidation::RelaySigShares()
+{
+    if (!llmq::signingManager)
+        return;
+
+    std::vector<llmq::CBatchedSigShares> vBatches;
+    llmq::signingManager->GetSigSharesToRelay(vBatches);
+
+    for (size_t i = 0; i < vBatches.size(); i += llmq::MAX_SIG_SHARE_BATCHES_PER_MESSAGE) {
+        size_t nEnd = std::min(vBatches.size(), i + llmq::MAX_SIG_SHARE_BATCHES_PER_MESSAGE);
+        std::vector<llmq::CBatchedSigShares> vChunk(std::make_move_iterator(vBatches.begin() + i), std::make_move_iterator(vBatches.begin() + nEnd));
+        // Serialized once for all peers; receivers drop the shares they already have before verifying
+        CSharedNetMsg msg = connman->MakeSharedMessage(CNetMsgMaker(PROTOCOL_VERSION).Make(NetMsgType::QSIGSHARES, vChunk));
+        connman->ForEachNode([this, &msg](CNode* pnode) {
+            if (pnode->fSuccessfullyConnected && !pnode->fDisconnect)
+                connman->PushMessage(pnode, msg);
+        });
+    }
 }
 
 void PeerLogicValidation::BlockConnected(const std::shared_ptr<const CBlock>& pblock, const CBlockIndex* pindex, const std::vector<CTransactionRef>& vtxConflicted) {
@@ -813,6 +928,12 @@ static std::shared_ptr<const CBlock> most_recent_block;
 static std::shared_ptr<const CBlockHeaderAndShortTxIDs> most_recent_compact_block;
 static uint256 most_recent_block_hash;
 static bool fWitnessesPresentInMostRecentCompactBlock;
+// most_recent_compact_block serialized once, for every peer it goes to
+static CSharedNetMsg most_recent_compact_block_msg;
+
+// Serialized BLOCK and TX messages shared by the peers asking for them
+static CRelayMessageCache blockRelayCache(DEFAULT_BLOCK_RELAY_CACHE_SIZE);
+static CRelayMessageCache txRelayCache(DEFAULT_TX_RELAY_CACHE_SIZE);
 
 void PeerLogicValidation::NewPoWValidBlock(const CBlockIndex *pindex, const std::shared_ptr<const CBlock>& pblock) {
     std::shared_ptr<const CBlockHeaderAndShortTxIDs> pcmpctblock = std::make_shared<const CBlockHeaderAndShortTxIDs> (*pblock, true);
@@ -828,16 +949,17 @@ void PeerLogicValidation::NewPoWValidBlock(const CBlockIndex *pindex, const std:
     bool fWitnessEnabled = IsWitnessEnabled(pindex->pprev, GetParams().GetConsensus());
     uint256 hashBlock(pblock->GetHash());
 
+    const CSharedNetMsg cmpctblockmsg = connman->MakeSharedMessage(msgMaker.Make(NetMsgType::CMPCTBLOCK, *pcmpctblock));
     {
         LOCK(cs_most_recent_block);
         most_recent_block_hash = hashBlock;
         most_recent_block = pblock;
         most_recent_compact_block = pcmpctblock;
         fWitnessesPresentInMostRecentCompactBlock = fWitnessEnabled;
+        most_recent_compact_block_msg = cmpctblockmsg;
     }
 
-    connman->ForEachNode([this, &pcmpctblock, pindex, &msgMaker, fWitnessEnabled, &hashBlock](CNode* pnode) {
-        // TODO: Avoid the repeated-serialization here
+    connman->ForEachNode([this, &cmpctblockmsg, pindex, fWitnessEnabled, &hashBlock](CNode* pnode) {
         if (pnode->nVersion < INVALID_CB_NO_BAN_VERSION || pnode->fDisconnect)
             return;
         ProcessBlockAvailability(pnode->GetId());
@@ -849,7 +971,7 @@ void PeerLogicValidation::NewPoWValidBlock(const CBlockIndex *pindex, const std:
 
             LogPrint(BCLog::NET, "%s sending header-and-ids %s to peer=%d\n", "PeerLogicValidation::NewPoWValidBlock",
                     hashBlock.ToString(), pnode->GetId());
-            connman->PushMessage(pnode, msgMaker.Make(NetMsgType::CMPCTBLOCK, *pcmpctblock));
+            connman->PushMessage(pnode, cmpctblockmsg);
             state.pindexBestHeaderSent = pindex;
         }
     });
@@ -952,6 +1074,12 @@ bool static AlreadyHave(const CInv& inv) EXCLUSIVE_LOCKS_REQUIRED(cs_main)
     case MSG_BLOCK:
     case MSG_WITNESS_BLOCK:
         return mapBlockIndex.count(inv.hash);
+
+    case MSG_ISLOCK:
+        return !llmq::instantSendManager || llmq::instantSendManager->AlreadyHave(inv.hash);
+
+    case MSG_CLSIG:
+        return !llmq::chainLocksManager || llmq::chainLocksManager->AlreadyHave(inv.hash);
     }
     // Don't know what it is, just say we already got one
     return true;
@@ -1002,12 +1130,49 @@ static void RelayAddress(const CAddress& addr, bool fReachable, CConnman* connma
     connman->ForEachNodeThen(std::move(sortfunc), std::move(pushfunc));
 }
 
-void static ProcessGetData(CNode* pfrom, const Consensus::Params& consensusParams, CConnman* connman, const std::atomic<bool>& interruptMsgProc)
+// Data elements of the blocks last served filtered, extracted once for every peer filtering them
+static const size_t MAX_FILTER_ELEMENTS_CACHE_BLOCKS = 8;
+static std::mutex cs_filterElementsCache;
+static std::list<std::pair<uint256, std::shared_ptr<const std::vector<CBloomFilterElements>>>> filterElementsCache; // most recently used first
+
+static std::shared_ptr<const std::vector<CBloomFilterElements>> GetBlockFilterElements(const uint256& hash, const CBlock& block)
 {
+    {
+        std::lock_guard<std::mutex> lock(cs_filterElementsCache);
+        for (auto it = filterElementsCache.begin(); it != filterElementsCache.end(); ++it) {
+            if (it->first == hash) {
+                filterElementsCache.splice(filterElementsCache.begin(), filterElementsCache, it);
+                return it->second;
+            }
+        }
+    }
+
+    // Extracted outside the lock; peers asking for the same new block at once may each extract it
+    std::shared_ptr<std::vector<CBloomFilterElements>> pvElements = std::make_shared<std::vector<CBloomFilterElements>>();
+    pvElements->reserve(block.vtx.size());
+    for (const CTransactionRef& ptx : block.vtx)
+        pvElements->emplace_back(*ptx);
+
+    std::lock_guard<std::mutex> lock(cs_filterElementsCache);
+    filterElementsCache.emplace_front(hash, pvElements);
+    if (filterElementsCache.size() > MAX_FILTER_ELEMENTS_CACHE_BLOCKS)
+        filterElementsCache.pop_back();
+    return pvElements;
+}
+
+/**
+ * Answer the getdata requests of pfrom with cs_main held, except a filtered
+ * block: that is returned in pblockFiltered with its hash in hashFiltered, to be matched against the peer's
+ * filter once cs_main is released, with the tip to announce after it in
+ * hashContinueTip if it ends a getblocks batch.
+ */
+static void ProcessGetDataLocked(CNode* pfrom, const Consensus::Params& consensusParams, CConnman* connman, const std::atomic<bool>& interruptMsgProc,
+                                 std::shared_ptr<const CBlock>& pblockFiltered, uint256& hashFiltered, uint256& hashContinueTip)
+{
+    AssertLockHeld(cs_main);
     std::deque<CInv>::iterator it = pfrom->vRecvGetData.begin();
     std::vector<CInv> vNotFound;
     const CNetMsgMaker msgMaker(pfrom->GetSendVersion());
-    LOCK(cs_main);
 
     while (it != pfrom->vRecvGetData.end()) {
         // Don't bother if send buffer is too full to respond anyway
@@ -1075,7 +1240,12 @@ void static ProcessGetData(CNode* pfrom, const Consensus::Params& consensusParam
                 if (send && (mi->second->nStatus & BLOCK_HAVE_DATA))
                 {
                     std::shared_ptr<const CBlock> pblock;
-                    if (a_recent_block && a_recent_block->GetHash() == (*mi).second->GetBlockHash()) {
+                    bool fWitness = inv.type == MSG_WITNESS_BLOCK;
+                    CSharedNetMsg blockmsg;
+                    bool fCachedMsg = (inv.type == MSG_BLOCK || fWitness) && blockRelayCache.Get(inv.hash, fWitness, blockmsg);
+                    if (fCachedMsg) {
+                        // Already serialized for another peer, so there's nothing to read
+                    } else if (a_recent_block && a_recent_block->GetHash() == (*mi).second->GetBlockHash()) {
                         pblock = a_recent_block;
                     } else {
                         // Send block from disk
@@ -1084,35 +1254,20 @@ void static ProcessGetData(CNode* pfrom, const Consensus::Params& consensusParam
                             assert(!"cannot load block from disk");
                         pblock = pblockRead;
                     }
-                    if (inv.type == MSG_BLOCK)
-                        connman->PushMessage(pfrom, msgMaker.Make(SERIALIZE_TRANSACTION_NO_WITNESS, NetMsgType::BLOCK, *pblock));
-                    else if (inv.type == MSG_WITNESS_BLOCK)
-                        connman->PushMessage(pfrom, msgMaker.Make(NetMsgType::BLOCK, *pblock));
+                    if (inv.type == MSG_BLOCK || inv.type == MSG_WITNESS_BLOCK) {
+                        if (!fCachedMsg) {
+                            blockmsg = connman->MakeSharedMessage(msgMaker.Make(fWitness ? 0 : SERIALIZE_TRANSACTION_NO_WITNESS, NetMsgType::BLOCK, *pblock));
+                            // Recent blocks get asked for by many peers at once
+                            if (mi->second->nHeight > chainActive.Height() - RELAY_CACHE_BLOCK_DEPTH)
+                                blockRelayCache.Put(inv.hash, fWitness, blockmsg);
+                        }
+                        connman->PushMessage(pfrom, blockmsg);
+                    }
                     else if (inv.type == MSG_FILTERED_BLOCK)
                     {
-                        bool sendMerkleBlock = false;
-                        CMerkleBlock merkleBlock;
-                        {
-                            LOCK(pfrom->cs_filter);
-                            if (pfrom->pfilter) {
-                                sendMerkleBlock = true;
-                                merkleBlock = CMerkleBlock(*pblock, *pfrom->pfilter);
-                            }
-                        }
-                        if (sendMerkleBlock) {
-                            connman->PushMessage(pfrom, msgMaker.Make(NetMsgType::MERKLEBLOCK, merkleBlock));
-                            // CMerkleBlock just contains hashes, so also push any transactions in the block the client did not see
-                            // This avoids hurting performance by pointlessly requiring a round-trip
-                            // Note that there is currently no way for a node to request any single transactions we didn't send here -
-                            // they must either disconnect and retry or request the full block.
-                            // Thus, the protocol spec specified allows for us to provide duplicate txn here,
-                            // however we MUST always provide at least what the remote peer needs
-                            typedef std::pair<unsigned int, uint256> PairType;
-                            for (PairType& pair : merkleBlock.vMatchedTxn)
-                                connman->PushMessage(pfrom, msgMaker.Make(SERIALIZE_TRANSACTION_NO_WITNESS, NetMsgType::TX, *pblock->vtx[pair.first]));
-                        }
-                        // else
-                            // no response
+                        // Matched by ProcessGetData, without cs_main
+                        pblockFiltered = pblock;
+                        hashFiltered = inv.hash;
                     }
                     else if (inv.type == MSG_CMPCT_BLOCK)
                     {
@@ -1141,9 +1296,13 @@ void static ProcessGetData(CNode* pfrom, const Consensus::Params& consensusParam
                         // Bypass PushInventory, this must send even if redundant,
                         // and we want it right after the last block so they don't
                         // wait for other stuff first.
-                        std::vector<CInv> vInv;
-                        vInv.push_back(CInv(MSG_BLOCK, chainActive.Tip()->GetBlockHash()));
-                        connman->PushMessage(pfrom, msgMaker.Make(NetMsgType::INV, vInv));
+                        if (pblockFiltered) {
+                            hashContinueTip = chainActive.Tip()->GetBlockHash();
+                        } else {
+                            std::vector<CInv> vInv;
+                            vInv.push_back(CInv(MSG_BLOCK, chainActive.Tip()->GetBlockHash()));
+                            connman->PushMessage(pfrom, msgMaker.Make(NetMsgType::INV, vInv));
+                        }
                         pfrom->hashContinue.SetNull();
                     }
                 }
@@ -1151,22 +1310,46 @@ void static ProcessGetData(CNode* pfrom, const Consensus::Params& consensusParam
             else if (inv.type == MSG_TX || inv.type == MSG_WITNESS_TX)
             {
                 // Send stream from relay memory
-                bool push = false;
+                CTransactionRef tx;
                 auto mi = mapRelay.find(inv.hash);
-                int nSendFlags = (inv.type == MSG_TX ? SERIALIZE_TRANSACTION_NO_WITNESS : 0);
                 if (mi != mapRelay.end()) {
-                    connman->PushMessage(pfrom, msgMaker.Make(nSendFlags, NetMsgType::TX, *mi->second));
-                    push = true;
+                    tx = mi->second;
                 } else if (pfrom->timeLastMempoolReq) {
                     auto txinfo = mempool.info(inv.hash);
                     // To protect privacy, do not answer getdata using the mempool when
                     // that TX couldn't have been INVed in reply to a MEMPOOL request.
                     if (txinfo.tx && txinfo.nTime <= pfrom->timeLastMempoolReq) {
-                        connman->PushMessage(pfrom, msgMaker.Make(nSendFlags, NetMsgType::TX, *txinfo.tx));
-                        push = true;
+                        tx = txinfo.tx;
+                    }
+                }
+                if (tx) {
+                    // Keyed by wtxid, so a cached message always has this transaction's witness
+                    bool fWitness = inv.type == MSG_WITNESS_TX;
+                    CSharedNetMsg txmsg;
+                    if (!txRelayCache.Get(tx->GetWitnessHash(), fWitness, txmsg)) {
+                        txmsg = connman->MakeSharedMessage(msgMaker.Make(fWitness ? 0 : SERIALIZE_TRANSACTION_NO_WITNESS, NetMsgType::TX, *tx));
+                        txRelayCache.Put(tx->GetWitnessHash(), fWitness, txmsg);
                     }
+                    connman->PushMessage(pfrom, txmsg);
+                } else {
+                    vNotFound.push_back(inv);
+                }
+            }
+            else if (inv.type == MSG_ISLOCK)
+            {
+                llmq::CInstantSendLock islock;
+                if (llmq::instantSendManager && llmq::instantSendManager->GetInstantSendLockByHash(inv.hash, islock)) {
+                    connman->PushMessage(pfrom, msgMaker.Make(NetMsgType::ISLOCK, islock));
+                } else {
+                    vNotFound.push_back(inv);
                 }
-                if (!push) {
+            }
+            else if (inv.type == MSG_CLSIG)
+            {
+                llmq::CChainLockSig clsig;
+                if (llmq::chainLocksManager && llmq::chainLocksManager->GetChainLockByHash(inv.hash, clsig)) {
+                    connman->PushMessage(pfrom, msgMaker.Make(NetMsgType::CLSIG, clsig));
+                } else {
                     vNotFound.push_back(inv);
                 }
             }
@@ -1190,70 +1373,121 @@ void static ProcessGetData(CNode* pfrom, const Consensus::Params& consensusParam
     }
 }
 
+void static ProcessGetData(CNode* pfrom, const Consensus::Params& consensusParams, CConnman* connman, const std::atomic<bool>& interruptMsgProc)
+{
+    std::shared_ptr<const CBlock> pblockFiltered;
+    uint256 hashFiltered;
+    uint256 hashContinueTip;
+    {
+        LOCK(cs_main);
+        ProcessGetDataLocked(pfrom, consensusParams, connman, interruptMsgProc, pblockFiltered, hashFiltered, hashContinueTip);
+    }
+    if (!pblockFiltered)
+        return;
+
+    // Every transaction of the block is matched against the filter, which
+    // needs nothing from the chain state, so it doesn't hold up other peers
+    const CNetMsgMaker msgMaker(pfrom->GetSendVersion());
+    bool sendMerkleBlock = false;
+    CMerkleBlock merkleBlock;
+    {
+        LOCK(pfrom->cs_filter);
+        if (pfrom->pfilter) {
+            sendMerkleBlock = true;
+            merkleBlock = CMerkleBlock(*pblockFiltered, *pfrom->pfilter, *GetBlockFilterElements(hashFiltered, *pblockFiltered));
+        }
+    }
+    if (sendMerkleBlock) {
+        connman->PushMessage(pfrom, msgMaker.Make(NetMsgType::MERKLEBLOCK, merkleBlock));
+        // CMerkleBlock just contains hashes, so also push any transactions in the block the client did not see
+        // This avoids hurting performance by pointlessly requiring a round-trip
+        // Note that there is currently no way for a node to request any single transactions we didn't send here -
+        // they must either disconnect and retry or request the full block.
+        // Thus, the protocol spec specified allows for us to provide duplicate txn here,
+        // however we MUST always provide at least what the remote peer needs
+        typedef std::pair<unsigned int, uint256> PairType;
+        for (PairType& pair : merkleBlock.vMatchedTxn)
+            connman->PushMessage(pfrom, msgMaker.Make(SERIALIZE_TRANSACTION_NO_WITNESS, NetMsgType::TX, *pblockFiltered->vtx[pair.first]));
+    }
+    // else
+        // no response
+
+    if (!hashContinueTip.IsNull()) {
+        std::vector<CInv> vInv;
+        vInv.push_back(CInv(MSG_BLOCK, hashContinueTip));
+        connman->PushMessage(pfrom, msgMaker.Make(NetMsgType::INV, vInv));
+    }
+}
+
+// ASSETDATA responses made from assetDataCacheView, shared by every peer asking
+static std::mutex cs_assetDataCache;
+static std::shared_ptr<const CAssetsReadView> assetDataCacheView;
+static CRelayMessageCache assetDataCache(DEFAULT_ASSET_DATA_CACHE_SIZE);
+
+/** Answer as much of pfrom->vRecvAssetGetData as its rate allows, from one asset read view and without cs_main */
 void static ProcessAssetGetData(CNode* pfrom, const Consensus::Params& consensusParams, CConnman* connman, const std::atomic<bool>& interruptMsgProc)
 {
-    std::deque<CInvAsset>::iterator it = pfrom->vRecvAssetGetData.begin();
-    std::vector<CInvAsset> vNotFound;
+    if (!passetsdb)
+        return;
+
     const CNetMsgMaker msgMaker(pfrom->GetSendVersion());
-    LOCK(cs_main);
 
+    int64_t nNow = GetTimeMicros();
+    if (pfrom->nAssetDataTokensTime)
+        pfrom->dAssetDataTokens = std::min<double>(MAX_ASSET_INV_SZ, pfrom->dAssetDataTokens + (nNow - pfrom->nAssetDataTokensTime) * ASSET_DATA_SERVE_RATE / 1000000);
+    pfrom->nAssetDataTokensTime = nNow;
+
+    // Views are taken under the cache lock so the cache only ever moves forward to newer ones
+    std::shared_ptr<const CAssetsReadView> view;
+    {
+        std::lock_guard<std::mutex> lock(cs_assetDataCache);
+        view = passetsdb->GetReadView();
+        if (view != assetDataCacheView) {
+            assetDataCache.Clear();
+            assetDataCacheView = view;
+        }
+    }
+
+    std::deque<CInvAsset>::iterator it = pfrom->vRecvAssetGetData.begin();
     while (it != pfrom->vRecvAssetGetData.end()) {
         // Don't bother if send buffer is too full to respond anyway
         if (pfrom->fPauseSend)
             break;
 
-        const CInvAsset &inv = *it;
-        {
-            if (interruptMsgProc)
-                return;
+        if (!pfrom->fWhitelisted && pfrom->dAssetDataTokens < 1)
+            break;
 
-            it++;
+        if (interruptMsgProc)
+            return;
 
-            if (!IsAssetNameValid(inv.name)) {
-                vNotFound.push_back(inv);
-                continue;
-            }
+        const CInvAsset &inv = *it++;
+        if (!IsAssetNameValid(inv.name))
+            continue;
+        pfrom->dAssetDataTokens -= 1;
 
-            UNUSED_VAR bool push = false;
-            auto currentActiveAssetCache = GetCurrentAssetCache();
-            if (currentActiveAssetCache) {
-                CNewAsset asset;
-                int height;
-                uint256 hash;
-                if (currentActiveAssetCache->GetAssetMetaDataIfExists(inv.name, asset, height, hash)) {
-                    auto data = CDatabasedAssetData(asset, height, hash);
-                    passetsCache->Put(inv.name, data);
-                    connman->PushMessage(pfrom, msgMaker.Make(NetMsgType::ASSETDATA, SerializedAssetData(data)));
-                    push = true;
-                } else {
-                    CDatabasedAssetData data;
-                    data.asset.strName = "_NF"; // Return _NF for NOT Found
-                    connman->PushMessage(pfrom, msgMaker.Make(NetMsgType::ASSETDATA, SerializedAssetData(data)));
-                }
+        uint256 hashName = Hash(inv.name.begin(), inv.name.end());
+        CSharedNetMsg msg;
+        bool fCached;
+        {
+            std::lock_guard<std::mutex> lock(cs_assetDataCache);
+            fCached = assetDataCacheView == view && assetDataCache.Get(hashName, false, msg);
+        }
+        if (!fCached) {
+            CDatabasedAssetData data;
+            if (!passetsdb->ReadAssetData(*view, inv.name, data)) {
+                data = CDatabasedAssetData();
+                data.asset.strName = "_NF"; // Return _NF for NOT Found
             }
+            msg = connman->MakeSharedMessage(msgMaker.Make(NetMsgType::ASSETDATA, SerializedAssetData(data)));
 
-//            if (!push) {
-//                vNotFound.push_back(inv);
-//            }
+            std::lock_guard<std::mutex> lock(cs_assetDataCache);
+            if (assetDataCacheView == view)
+                assetDataCache.Put(hashName, false, msg);
         }
+        connman->PushMessage(pfrom, msg);
     }
 
     pfrom->vRecvAssetGetData.erase(pfrom->vRecvAssetGetData.begin(), it);
-
-//    if (!vNotFound.empty()) {
-//        // Let the peer know that we didn't find what it asked for, so it doesn't
-//        // have to wait around forever. Currently only SPV clients actually care
-//        // about this message: it's needed when they are recursively walking the
-//        // dependencies of relevant unconfirmed transactions. SPV clients want to
-//        // do that because they want to know about (and store and rebroadcast and
-//        // risk analyze) the dependencies of transactions relevant to them, without
-//        // having to download the entire memory pool.
-//        for (auto assetinv : vNotFound) {
-//            CDatabasedAssetData data;
-//            data.asset.strName = "_NF"; // Return _NF for NOT Found
-//            connman->PushMessage(pfrom, msgMaker.Make(NetMsgType::ASSETDATA, SerializedAssetData(data)));
-//        }
-//    }
 }
 
 uint32_t GetFetchFlags(CNode* pfrom) {
@@ -1291,6 +1525,10 @@ bool static ProcessHeadersMessage(CNode *pfrom, CConnman *connman, const std::ve
         return true;
     }
 
+    // Hash the batch on the header check threads before taking cs_main; the
+    // checks below reuse the hashes instead of hashing every header again.
+    std::vector<CHeaderPreCheck> vPreChecks = HashBlockHeaders(headers);
+
     bool received_new_header = false;
     const CBlockIndex *pindexLast = nullptr;
     {
@@ -1309,14 +1547,14 @@ bool static ProcessHeadersMessage(CNode *pfrom, CConnman *connman, const std::ve
             nodestate->nUnconnectingHeaders++;
             connman->PushMessage(pfrom, msgMaker.Make(NetMsgType::GETHEADERS, chainActive.GetLocator(pindexBestHeader), uint256()));
             LogPrint(BCLog::NET, "received header %s: missing prev block %s, sending getheaders (%d) to end (peer=%d, nUnconnectingHeaders=%d)\n",
-                     headers[0].GetHash().ToString(),
+                     vPreChecks[0].hash.ToString(),
                     headers[0].hashPrevBlock.ToString(),
                     pindexBestHeader->nHeight,
                     pfrom->GetId(), nodestate->nUnconnectingHeaders);
             // Set hashLastUnknownBlock for this peer, so that if we
             // eventually get the headers - even from a different peer -
             // we can use this peer to download.
-            UpdateBlockAvailability(pfrom->GetId(), headers.back().GetHash());
+            UpdateBlockAvailability(pfrom->GetId(), vPreChecks.back().hash);
 
             if (nodestate->nUnconnectingHeaders % MAX_UNCONNECTING_HEADERS == 0) {
                 Misbehaving(pfrom->GetId(), 20);
@@ -1325,12 +1563,12 @@ bool static ProcessHeadersMessage(CNode *pfrom, CConnman *connman, const std::ve
         }
 
         uint256 hashLastBlock;
-        for (const CBlockHeader& header : headers) {
-            if (!hashLastBlock.IsNull() && header.hashPrevBlock != hashLastBlock) {
+        for (size_t i = 0; i < nCount; i++) {
+            if (!hashLastBlock.IsNull() && headers[i].hashPrevBlock != hashLastBlock) {
                 Misbehaving(pfrom->GetId(), 20);
                 return error("non-continuous headers sequence");
             }
-            hashLastBlock = header.GetHash();
+            hashLastBlock = vPreChecks[i].hash;
         }
 
         // If we don't have the last header, then they'll have given us
@@ -1340,9 +1578,13 @@ bool static ProcessHeadersMessage(CNode *pfrom, CConnman *connman, const std::ve
         }
     }
 
+    // Only now that the batch connects and is continuous, check the proof of
+    // work of its new headers in parallel
+    PreCheckBlockHeaders(headers, vPreChecks, chainparams.GetConsensus());
+
     CValidationState state;
     CBlockHeader first_invalid_header;
-    if (!ProcessNewBlockHeaders(headers, state, chainparams, &pindexLast, &first_invalid_header)) {
+    if (!ProcessNewBlockHeaders(headers, state, chainparams, &pindexLast, &first_invalid_header, &vPreChecks)) {
         int nDoS;
         if (state.IsInvalid(nDoS)) {
             LOCK(cs_main);
@@ -1500,6 +1742,152 @@ bool static ProcessHeadersMessage(CNode *pfrom, CConnman *connman, const std::ve
     return true;
 }
 
+/** Most blocks one getcfilters may ask for */
+static const uint32_t MAX_GETCFILTERS_SIZE = 1000;
+/** Most blocks one getcfheaders may ask for */
+static const uint32_t MAX_GETCFHEADERS_SIZE = 2000;
+/** Blocks between the filter headers getcfcheckpt returns */
+static const int CFCHECKPT_INTERVAL = 1000;
+
+/**
+ * Check a compact filter request and find its stop block. A peer asking for a
+ * filter type we do not serve, for a stop block outside the active chain or
+ * for too many blocks is disconnected, as BIP157 says.
+ */
+static bool PrepareBlockFilterRequest(CNode* pfrom, uint8_t nFilterType, uint32_t nStartHeight, const uint256& hashStop,
+                                      uint32_t nMaxBlocks, const CBlockIndex*& pindexStop)
+{
+    const bool fSupported = (pfrom->GetLocalServices() & NODE_COMPACT_FILTERS) && pblockfilterindex &&
+                            static_cast<uint8_t>(pblockfilterindex->GetFilterType()) == nFilterType;
+    if (!fSupported) {
+        LogPrint(BCLog::NET, "peer %d requested unsupported block filter type: %d\n", pfrom->GetId(), nFilterType);
+        pfrom->fDisconnect = true;
+        return false;
+    }
+
+    {
+        LOCK(cs_main);
+        BlockMap::const_iterator it = mapBlockIndex.find(hashStop);
+        if (it == mapBlockIndex.end() || !chainActive.Contains(it->second)) {
+            LogPrint(BCLog::NET, "peer %d requested filters of unknown block %s\n", pfrom->GetId(), hashStop.ToString());
+            pfrom->fDisconnect = true;
+            return false;
+        }
+        pindexStop = it->second;
+    }
+
+    const uint32_t nStopHeight = pindexStop->nHeight;
+    if (nStartHeight > nStopHeight) {
+        LogPrint(BCLog::NET, "peer %d sent invalid getcfilters/getcfheaders with start height %d and stop height %d\n",
+                 pfrom->GetId(), nStartHeight, nStopHeight);
+        pfrom->fDisconnect = true;
+        return false;
+    }
+    if (nStopHeight - nStartHeight >= nMaxBlocks) {
+        LogPrint(BCLog::NET, "peer %d requested too many filters/filter headers: %d / %d\n",
+                 pfrom->GetId(), nStopHeight - nStartHeight + 1, nMaxBlocks);
+        pfrom->fDisconnect = true;
+        return false;
+    }
+    return true;
+}
+
+static void ProcessGetCFilters(CNode* pfrom, CDataStream& vRecv, CConnman* connman)
+{
+    uint8_t nFilterType;
+    uint32_t nStartHeight;
+    uint256 hashStop;
+    vRecv >> nFilterType >> nStartHeight >> hashStop;
+
+    const CBlockIndex* pindexStop;
+    if (!PrepareBlockFilterRequest(pfrom, nFilterType, nStartHeight, hashStop, MAX_GETCFILTERS_SIZE, pindexStop))
+        return;
+
+    std::vector<BlockFilter> vFilters;
+    if (!pblockfilterindex->LookupFilterRange(nStartHeight, pindexStop, vFilters)) {
+        LogPrint(BCLog::NET, "Failed to find block filters of blocks %d-%s for peer=%d\n", nStartHeight, hashStop.ToString(), pfrom->GetId());
+        return;
+    }
+
+    const CNetMsgMaker msgMaker(pfrom->GetSendVersion());
+    for (const BlockFilter& filter : vFilters)
+        connman->PushMessage(pfrom, msgMaker.Make(NetMsgType::CFILTER, filter));
+}
+
+static void ProcessGetCFHeaders(CNode* pfrom, CDataStream& vRecv, CConnman* connman)
+{
+    uint8_t nFilterType;
+    uint32_t nStartHeight;
+    uint256 hashStop;
+    vRecv >> nFilterType >> nStartHeight >> hashStop;
+
+    const CBlockIndex* pindexStop;
+    if (!PrepareBlockFilterRequest(pfrom, nFilterType, nStartHeight, hashStop, MAX_GETCFHEADERS_SIZE, pindexStop))
+        return;
+
+    uint256 hashPrevHeader;
+    if (nStartHeight > 0) {
+        const CBlockIndex* pindexPrev = pindexStop->GetAncestor(nStartHeight - 1);
+        if (!pblockfilterindex->LookupFilterHeader(pindexPrev->GetBlockHash(), hashPrevHeader)) {
+            LogPrint(BCLog::NET, "Failed to find block filter header of block %s for peer=%d\n", pindexPrev->GetBlockHash().ToString(), pfrom->GetId());
+            return;
+        }
+    }
+
+    std::vector<uint256> vFilterHashes;
+    if (!pblockfilterindex->LookupFilterHashRange(nStartHeight, pindexStop, vFilterHashes)) {
+        LogPrint(BCLog::NET, "Failed to find block filter hashes of blocks %d-%s for peer=%d\n", nStartHeight, hashStop.ToString(), pfrom->GetId());
+        return;
+    }
+
+    const CNetMsgMaker msgMaker(pfrom->GetSendVersion());
+    connman->PushMessage(pfrom, msgMaker.Make(NetMsgType::CFHEADERS, nFilterType, pindexStop->GetBlockHash(), hashPrevHeader, vFilterHashes));
+}
+
+static void ProcessGetCFCheckPt(CNode* pfrom, CDataStream& vRecv, CConnman* connman)
+{
+    uint8_t nFilterType;
+    uint256 hashStop;
+    vRecv >> nFilterType >> hashStop;
+
+    const CBlockIndex* pindexStop;
+    if (!PrepareBlockFilterRequest(pfrom, nFilterType, 0, hashStop, std::numeric_limits<uint32_t>::max(), pindexStop))
+        return;
+
+    std::vector<uint256> vHeaders(pindexStop->nHeight / CFCHECKPT_INTERVAL);
+    for (int i = static_cast<int>(vHeaders.size()) - 1; i >= 0; i--) {
+        const CBlockIndex* pindex = pindexStop->GetAncestor((i + 1) * CFCHECKPT_INTERVAL);
+        if (!pblockfilterindex->LookupFilterHeader(pindex->GetBlockHash(), vHeaders[i])) {
+            LogPrint(BCLog::NET, "Failed to find block filter header of block %s for peer=%d\n", pindex->GetBlockHash().ToString(), pfrom->GetId());
+            return;
+        }
+    }
+
+    const CNetMsgMaker msgMaker(pfrom->GetSendVersion());
+    connman->PushMessage(pfrom, msgMaker.Make(NetMsgType::CFCHECKPT, nFilterType, pindexStop->GetBlockHash(), vHeaders));
+}
+
+/** Held by message handler threads while they run anything that isn't IsPeerLocalMessage */
+static CCriticalSection cs_msgProcSerial;
+
+bool IsPeerLocalMessage(const std::string& strCommand)
+{
+    static const std::set<std::string> setPeerLocal = {
+        NetMsgType::PING,
+        NetMsgType::PONG,
+        NetMsgType::FEEFILTER,
+        NetMsgType::SENDHEADERS,
+        NetMsgType::SENDCMPCT,
+        NetMsgType::FILTERLOAD,
+        NetMsgType::FILTERADD,
+        NetMsgType::FILTERCLEAR,
+        NetMsgType::GETASSETDATA,
+        NetMsgType::NOTFOUND,
+        NetMsgType::ASSETNOTFOUND,
+    };
+    return setPeerLocal.count(strCommand);
+}
+
 bool static ProcessMessage(CNode* pfrom, const std::string& strCommand, CDataStream& vRecv, int64_t nTimeReceived, const CChainParams& chainparams, CConnman* connman, const std::atomic<bool>& interruptMsgProc)
 {
     LogPrint(BCLog::NET, "received: %s (%u bytes) peer=%d\n", SanitizeString(strCommand), vRecv.size(), pfrom->GetId());
@@ -1922,7 +2310,8 @@ bool static ProcessMessage(CNode* pfrom, const std::string& strCommand, CDataStr
             else
             {
                 pfrom->AddInventoryKnown(inv);
-                if (fBlocksOnly) {
+                // ChainLocks concern blocks, so even blocks only peers take them
+                if (fBlocksOnly && inv.type != MSG_CLSIG) {
                     LogPrint(BCLog::NET, "transaction (%s) inv sent in violation of protocol peer=%d\n", inv.hash.ToString(), pfrom->GetId());
                 } else if (!fAlreadyHave && !fImporting && !fReindex && !IsInitialBlockDownload()) {
                     pfrom->AskFor(inv);
@@ -1952,6 +2341,18 @@ bool static ProcessMessage(CNode* pfrom, const std::string& strCommand, CDataStr
         ProcessGetData(pfrom, chainparams.GetConsensus(), connman, interruptMsgProc);
     }
 
+    else if (strCommand == NetMsgType::GETCFILTERS) {
+        ProcessGetCFilters(pfrom, vRecv, connman);
+    }
+
+    else if (strCommand == NetMsgType::GETCFHEADERS) {
+        ProcessGetCFHeaders(pfrom, vRecv, connman);
+    }
+
+    else if (strCommand == NetMsgType::GETCFCHECKPT) {
+        ProcessGetCFCheckPt(pfrom, vRecv, connman);
+    }
+
     else if (strCommand == NetMsgType::GETASSETDATA)
     {
         if (IsInitialBlockDownload()) {
@@ -1983,6 +2384,11 @@ bool static ProcessMessage(CNode* pfrom, const std::string& strCommand, CDataStr
             LogPrint(BCLog::NET, "received getassetdata for: %s peer=%d\n", vInvAsset[0].ToString(), pfrom->GetId());
         }
 
+        if (pfrom->vRecvAssetGetData.size() + vInvAsset.size() > MAX_ASSET_GETDATA_QUEUE) {
+            LogPrint(BCLog::NET, "Ignoring getassetdata from peer=%d, %u requests still queued\n", pfrom->GetId(), pfrom->vRecvAssetGetData.size());
+            return true;
+        }
+
         pfrom->vRecvAssetGetData.insert(pfrom->vRecvAssetGetData.end(), vInvAsset.begin(), vInvAsset.end());
         ProcessAssetGetData(pfrom, chainparams.GetConsensus(), connman, interruptMsgProc);
     }
@@ -2217,8 +2623,12 @@ bool static ProcessMessage(CNode* pfrom, const std::string& strCommand, CDataStr
                 tx.GetHash().ToString(),
                 mempool.size(), mempool.DynamicMemoryUsage() / 1000);
 
-            // Recursively process any orphan transactions that depended on this one
-            std::set<NodeId> setMisbehaving;
+            // Gather the orphan transactions that depended on this one, directly or
+            // through each other, and process them as one batch
+            std::vector<CTxMemPoolBatchEntry> vOrphans;
+            std::vector<NodeId> vOrphanPeers;
+            std::set<uint256> setOrphansQueued;
+            int64_t nNow = GetTime();
             while (!vWorkQueue.empty()) {
                 auto itByPrev = mapOrphanTransactionsByPrev.find(vWorkQueue.front());
                 vWorkQueue.pop_front();
@@ -2229,51 +2639,60 @@ bool static ProcessMessage(CNode* pfrom, const std::string& strCommand, CDataStr
                      ++mi)
                 {
                     const CTransactionRef& porphanTx = (*mi)->second.tx;
-                    const CTransaction& orphanTx = *porphanTx;
-                    const uint256& orphanHash = orphanTx.GetHash();
-                    NodeId fromPeer = (*mi)->second.fromPeer;
-                    bool fMissingInputs2 = false;
-                    // Use a dummy CValidationState so someone can't setup nodes to counter-DoS based on orphan
-                    // resolution (that is, feeding people an invalid transaction based on LegitTxX in order to get
-                    // anyone relaying LegitTxX banned)
-                    CValidationState stateDummy;
-
-
-                    if (setMisbehaving.count(fromPeer))
+                    const uint256& orphanHash = porphanTx->GetHash();
+                    if (!setOrphansQueued.insert(orphanHash).second)
                         continue;
-                    if (AcceptToMemoryPool(mempool, stateDummy, porphanTx, &fMissingInputs2, &lRemovedTxn, false /* bypass_limits */, 0 /* nAbsurdFee */)) {
-                        LogPrint(BCLog::MEMPOOL, "   accepted orphan tx %s\n", orphanHash.ToString());
-                        RelayTransaction(orphanTx, connman);
-                        for (unsigned int i = 0; i < orphanTx.vout.size(); i++) {
-                            vWorkQueue.emplace_back(orphanHash, i);
-                        }
-                        vEraseQueue.push_back(orphanHash);
+                    vOrphans.emplace_back(porphanTx, nNow);
+                    vOrphanPeers.push_back((*mi)->second.fromPeer);
+                    for (unsigned int i = 0; i < porphanTx->vout.size(); i++) {
+                        vWorkQueue.emplace_back(orphanHash, i);
                     }
-                    else if (!fMissingInputs2)
+                }
+            }
+            AcceptToMemoryPoolBatch(mempool, vOrphans, &lRemovedTxn, false /* bypass_limits */, 0 /* nAbsurdFee */);
+
+            std::set<NodeId> setMisbehaving;
+            for (size_t i = 0; i < vOrphans.size(); i++)
+            {
+                const CTxMemPoolBatchEntry& entry = vOrphans[i];
+                const CTransaction& orphanTx = *entry.tx;
+                const uint256& orphanHash = orphanTx.GetHash();
+                NodeId fromPeer = vOrphanPeers[i];
+                // The entry's state is only used to punish the peer that sent
+                // the orphan, never this one, so someone can't setup nodes to
+                // counter-DoS based on orphan resolution (that is, feeding people
+                // an invalid transaction based on LegitTxX in order to get anyone
+                // relaying LegitTxX banned)
+                if (entry.fAccepted) {
+                    LogPrint(BCLog::MEMPOOL, "   accepted orphan tx %s\n", orphanHash.ToString());
+                    RelayTransaction(orphanTx, connman);
+                    vEraseQueue.push_back(orphanHash);
+                }
+                else if (!entry.fMissingInputs)
+                {
+                    int nDos = 0;
+                    if (entry.state.IsInvalid(nDos) && nDos > 0 && !setMisbehaving.count(fromPeer))
                     {
-                        int nDos = 0;
-                        if (stateDummy.IsInvalid(nDos) && nDos > 0)
-                        {
-                            // Punish peer that gave us an invalid orphan tx
-                            Misbehaving(fromPeer, nDos);
-                            setMisbehaving.insert(fromPeer);
-                            LogPrint(BCLog::MEMPOOL, "   invalid orphan tx %s\n", orphanHash.ToString());
-                        }
-                        // Has inputs but not accepted to mempool
-                        // Probably non-standard or insufficient fee
-                        LogPrint(BCLog::MEMPOOL, "   removed orphan tx %s\n", orphanHash.ToString());
-                        vEraseQueue.push_back(orphanHash);
-                        if (!orphanTx.HasWitness() && !stateDummy.CorruptionPossible()) {
-                            // Do not use rejection cache for witness transactions or
-                            // witness-stripped transactions, as they can have been malleated.
-                            // See https://github.com/bitcoin/bitcoin/issues/8279 for details.
-                            assert(recentRejects);
-                            recentRejects->insert(orphanHash);
-                        }
+                        // Punish peer that gave us an invalid orphan tx
+                        Misbehaving(fromPeer, nDos);
+                        setMisbehaving.insert(fromPeer);
+                        LogPrint(BCLog::MEMPOOL, "   invalid orphan tx %s\n", orphanHash.ToString());
+                    }
+                    // Has inputs but not accepted to mempool
+                    // Probably non-standard or insufficient fee
+                    LogPrint(BCLog::MEMPOOL, "   removed orphan tx %s\n", orphanHash.ToString());
+                    vEraseQueue.push_back(orphanHash);
+                    if (!orphanTx.HasWitness() && !entry.state.CorruptionPossible()) {
+                        // Do not use rejection cache for witness transactions or
+                        // witness-stripped transactions, as they can have been malleated.
+                        // See https://github.com/bitcoin/bitcoin/issues/8279 for details.
+                        assert(recentRejects);
+                        recentRejects->insert(orphanHash);
                     }
-                    mempool.check(pcoinsTip);
                 }
             }
+            if (!vOrphans.empty())
+                mempool.check(pcoinsTip);
 
             for (uint256 hash : vEraseQueue)
                 EraseOrphanTx(hash);
@@ -2298,7 +2717,8 @@ bool static ProcessMessage(CNode* pfrom, const std::string& strCommand, CDataStr
 
                 // DoS prevention: do not allow mapOrphanTransactions to grow unbounded
                 unsigned int nMaxOrphanTx = (unsigned int)std::max((int64_t)0, gArgs.GetArg("-maxorphantx", DEFAULT_MAX_ORPHAN_TRANSACTIONS));
-                unsigned int nEvicted = LimitOrphanTxSize(nMaxOrphanTx);
+                size_t nMaxOrphanUsage = (size_t)std::max((int64_t)0, gArgs.GetArg("-maxorphanmemory", DEFAULT_MAX_ORPHAN_MEMORY)) * 1000000;
+                unsigned int nEvicted = LimitOrphanTxSize(nMaxOrphanTx, nMaxOrphanUsage);
                 if (nEvicted > 0) {
                     LogPrint(BCLog::MEMPOOL, "mapOrphan overflow, removed %u tx\n", nEvicted);
                 }
@@ -2705,6 +3125,7 @@ bool static ProcessMessage(CNode* pfrom, const std::string& strCommand, CDataStr
             LOCK(cs_main);
             // Also always process if we requested the block explicitly, as we may
             // need it even though it is not a candidate for a new best tip.
+            RecordBlockDelivery(pfrom->GetId(), hash);
             forceProcessing |= MarkBlockAsReceived(hash);
             // mapBlockSource is only used for sending reject messages and DoS scores,
             // so the race between here and cs_main in ProcessNewBlock is fine.
@@ -2918,6 +3339,65 @@ bool static ProcessMessage(CNode* pfrom, const std::string& strCommand, CDataStr
         }
     }
 
+    else if (strCommand == NetMsgType::ISLOCK) {
+        llmq::CInstantSendLock islock;
+        vRecv >> islock;
+
+        CInv inv(MSG_ISLOCK, islock.GetHash());
+        pfrom->AddInventoryKnown(inv);
+        {
+            LOCK(cs_main);
+            pfrom->setAskFor.erase(inv.hash);
+            mapAlreadyAskedFor.erase(inv.hash);
+            if (islock.inputs.empty() || islock.inputs.size() > (size_t)llmq::INSTANTSEND_MAX_INPUTS) {
+                Misbehaving(pfrom->GetId(), 100);
+                return error("islock with %u inputs", islock.inputs.size());
+            }
+        }
+
+        // Verified on the BLS worker, and announced to our peers once stored
+        if (llmq::instantSendManager) {
+            llmq::instantSendManager->AsyncProcessInstantSendLock(islock);
+        }
+    }
+
+    else if (strCommand == NetMsgType::CLSIG) {
+        llmq::CChainLockSig clsig;
+        vRecv >> clsig;
+
+        CInv inv(MSG_CLSIG, clsig.GetHash());
+        pfrom->AddInventoryKnown(inv);
+        {
+            LOCK(cs_main);
+            pfrom->setAskFor.erase(inv.hash);
+            mapAlreadyAskedFor.erase(inv.hash);
+        }
+
+        if (llmq::chainLocksManager) {
+            llmq::chainLocksManager->AsyncProcessChainLock(clsig);
+        }
+    }
+
+    else if (strCommand == NetMsgType::QSIGSHARES) {
+        std::vector<llmq::CBatchedSigShares> vBatches;
+        vRecv >> vBatches;
+        if (vBatches.size() > llmq::MAX_SIG_SHARE_BATCHES_PER_MESSAGE) {
+            LOCK(cs_main);
+            Misbehaving(pfrom->GetId(), 20);
+            return error("message qsigshares size() = %u", vBatches.size());
+        }
+
+        if (llmq::signingManager) {
+            for (llmq::CBatchedSigShares& batch : vBatches) {
+                if (!llmq::signingManager->AsyncProcessSigShares(std::move(batch))) {
+                    LOCK(cs_main);
+                    Misbehaving(pfrom->GetId(), 10);
+                    return error("malformed qsigshares batch for %s", batch.id.ToString());
+                }
+            }
+        }
+    }
+
     else if (strCommand == NetMsgType::NOTFOUND) {
         // We do not care about the NOTFOUND message, but logging an Unknown Command
         // message would be undesirable as we transmit it ourselves.
@@ -2981,8 +3461,14 @@ bool PeerLogicValidation::ProcessMessages(CNode* pfrom, std::atomic<bool>& inter
     //
     bool fMoreWork = false;
 
-    if (!pfrom->vRecvGetData.empty())
+    if (!pfrom->vRecvGetData.empty()) {
+        LOCK(cs_msgProcSerial);
         ProcessGetData(pfrom, chainparams.GetConsensus(), connman, interruptMsgProc);
+    }
+
+    // Asset requests held back by the send buffer or the peer's rate
+    if (!pfrom->vRecvAssetGetData.empty())
+        ProcessAssetGetData(pfrom, chainparams.GetConsensus(), connman, interruptMsgProc);
 
     if (pfrom->fDisconnect)
         return false;
@@ -3043,7 +3529,13 @@ bool PeerLogicValidation::ProcessMessages(CNode* pfrom, std::atomic<bool>& inter
     bool fRet = false;
     try
     {
-        fRet = ProcessMessage(pfrom, strCommand, vRecv, msg.nTime, chainparams, connman, interruptMsgProc);
+        // Handlers that may reach into other peers' state run one at a time
+        if (pfrom->fSuccessfullyConnected && IsPeerLocalMessage(strCommand)) {
+            fRet = ProcessMessage(pfrom, strCommand, vRecv, msg.nTime, chainparams, connman, interruptMsgProc);
+        } else {
+            LOCK(cs_msgProcSerial);
+            fRet = ProcessMessage(pfrom, strCommand, vRecv, msg.nTime, chainparams, connman, interruptMsgProc);
+        }
         if (interruptMsgProc)
             return false;
         if (!pfrom->vRecvGetData.empty())
@@ -3217,23 +3709,6 @@ void PeerLogicValidation::CheckForStaleTipAndEvictPeers(const Consensus::Params
     }
 }
 
-class CompareInvMempoolOrder
-{
-    CTxMemPool *mp;
-public:
-    explicit CompareInvMempoolOrder(CTxMemPool *_mempool)
-    {
-        mp = _mempool;
-    }
-
-    bool operator()(std::set<uint256>::iterator a, std::set<uint256>::iterator b)
-    {
-        /* As std::make_heap produces a max-heap, we want the entries with the
-         * fewest ancestors/highest fee to sort later. */
-        return mp->CompareDepthAndScore(*b, *a);
-    }
-};
-
 bool PeerLogicValidation::SendMessages(CNode* pto, std::atomic<bool>& interruptMsgProc)
 {
     const Consensus::Params& consensusParams = GetParams().GetConsensus();
@@ -3242,6 +3717,8 @@ bool PeerLogicValidation::SendMessages(CNode* pto, std::atomic<bool>& interruptM
         if (!pto->fSuccessfullyConnected || pto->fDisconnect)
             return true;
 
+        LOCK(cs_msgProcSerial);
+
         // If we get here, the outgoing message serialization version is set and can't change.
         const CNetMsgMaker msgMaker(pto->GetSendVersion());
 
@@ -3457,7 +3934,9 @@ bool PeerLogicValidation::SendMessages(CNode* pto, std::atomic<bool>& interruptM
                     {
                         LOCK(cs_most_recent_block);
                         if (most_recent_block_hash == pBestIndex->GetBlockHash()) {
-                            if (state.fWantsCmpctWitness || !fWitnessesPresentInMostRecentCompactBlock)
+                            if (state.fWantsCmpctWitness && most_recent_compact_block_msg.header)
+                                connman->PushMessage(pto, most_recent_compact_block_msg);
+                            else if (state.fWantsCmpctWitness || !fWitnessesPresentInMostRecentCompactBlock)
                                 connman->PushMessage(pto, msgMaker.Make(nSendFlags, NetMsgType::CMPCTBLOCK, *most_recent_compact_block));
                             else {
                                 CBlockHeaderAndShortTxIDs cmpctblock(*most_recent_block, state.fWantsCmpctWitness);
@@ -3536,6 +4015,20 @@ bool PeerLogicValidation::SendMessages(CNode* pto, std::atomic<bool>& interruptM
             }
             pto->vInventoryBlockToSend.clear();
 
+            // Add ISLOCKs and CLSIGs
+            for (const CInv& inv : pto->vInventoryOtherToSend) {
+                if (pto->filterInventoryKnown.contains(inv.hash)) {
+                    continue;
+                }
+                pto->filterInventoryKnown.insert(inv.hash);
+                vInv.push_back(inv);
+                if (vInv.size() == MAX_INV_SZ) {
+                    connman->PushMessage(pto, msgMaker.Make(NetMsgType::INV, vInv));
+                    vInv.clear();
+                }
+            }
+            pto->vInventoryOtherToSend.clear();
+
             // Check whether periodic sends should happen
             bool fSendTrickle = pto->fWhitelisted;
             if (pto->nNextInvSend < nNow) {
@@ -3585,42 +4078,30 @@ bool PeerLogicValidation::SendMessages(CNode* pto, std::atomic<bool>& interruptM
 
             // Determine transactions to relay
             if (fSendTrickle) {
-                // Produce a vector with all candidates for sending
-                std::vector<std::set<uint256>::iterator> vInvTx;
-                vInvTx.reserve(pto->setInventoryTxToSend.size());
-                for (std::set<uint256>::iterator it = pto->setInventoryTxToSend.begin(); it != pto->setInventoryTxToSend.end(); it++) {
-                    vInvTx.push_back(it);
-                }
                 CAmount filterrate = 0;
                 {
                     LOCK(pto->cs_feeFilter);
                     filterrate = pto->minFeeFilter;
                 }
-                // Topologically and fee-rate sort the inventory we send for privacy and priority reasons.
-                // A heap is used so that not all items need sorting if only a few are being sent.
-                CompareInvMempoolOrder compareInvMempoolOrder(&mempool);
-                std::make_heap(vInvTx.begin(), vInvTx.end(), compareInvMempoolOrder);
+                const size_t nMaxRelayUsage = (size_t)std::max((int64_t)0, gArgs.GetArg("-maxrelaymemory", DEFAULT_MAX_RELAY_MEMORY)) * 1000000;
+                LOCK(pto->cs_filter);
+                // Topologically and fee-rate sort the inventory we send for privacy and priority reasons,
+                // all at once under a single mempool lock, then take it from the front. What the peer
+                // already knows of or what left the mempool is dropped here, as it would never be sent.
+                std::vector<uint256> vInvTx;
+                vInvTx.reserve(pto->setInventoryTxToSend.size());
+                for (const uint256& hash : pto->setInventoryTxToSend) {
+                    if (!pto->filterInventoryKnown.contains(hash))
+                        vInvTx.push_back(hash);
+                }
+                std::vector<TxMempoolInfo> vInvTxInfo = mempool.infoByDepthAndScore(vInvTx);
                 // No reason to drain out at many times the network's capacity,
                 // especially since we have many peers and some will draw much shorter delays.
                 unsigned int nRelayedTransactions = 0;
-                LOCK(pto->cs_filter);
-                while (!vInvTx.empty() && nRelayedTransactions < INVENTORY_BROADCAST_MAX) {
-                    // Fetch the top element from the heap
-                    std::pop_heap(vInvTx.begin(), vInvTx.end(), compareInvMempoolOrder);
-                    std::set<uint256>::iterator it = vInvTx.back();
-                    vInvTx.pop_back();
-                    uint256 hash = *it;
-                    // Remove it from the to-be-sent set
-                    pto->setInventoryTxToSend.erase(it);
-                    // Check if not in the filter already
-                    if (pto->filterInventoryKnown.contains(hash)) {
-                        continue;
-                    }
-                    // Not in the mempool anymore? don't bother sending it.
-                    auto txinfo = mempool.info(hash);
-                    if (!txinfo.tx) {
-                        continue;
-                    }
+                size_t nPos = 0;
+                for (; nPos < vInvTxInfo.size() && nRelayedTransactions < INVENTORY_BROADCAST_MAX; nPos++) {
+                    TxMempoolInfo& txinfo = vInvTxInfo[nPos];
+                    const uint256 hash = txinfo.tx->GetHash();
                     if (filterrate && txinfo.feeRate.GetFeePerK() < filterrate) {
                         continue;
                     }
@@ -3631,15 +4112,17 @@ bool PeerLogicValidation::SendMessages(CNode* pto, std::atomic<bool>& interruptM
                     {
                         // Expire old relay messages
                         while (!vRelayExpiration.empty() && vRelayExpiration.front().first < nNow)
-                        {
-                            mapRelay.erase(vRelayExpiration.front().second);
-                            vRelayExpiration.pop_front();
-                        }
+                            EraseOldestRelayEntry();
 
                         auto ret = mapRelay.insert(std::make_pair(hash, std::move(txinfo.tx)));
                         if (ret.second) {
                             vRelayExpiration.push_back(std::make_pair(nNow + 15 * 60 * 1000000, ret.first));
+                            nMapRelayUsage += RelayEntryUsage(ret.first->second);
                         }
+
+                        // Then the oldest ones, for as many as are over the memory limit
+                        while (nMapRelayUsage > nMaxRelayUsage && !vRelayExpiration.empty())
+                            EraseOldestRelayEntry();
                     }
                     if (vInv.size() == MAX_INV_SZ) {
                         connman->PushMessage(pto, msgMaker.Make(NetMsgType::INV, vInv));
@@ -3647,6 +4130,10 @@ bool PeerLogicValidation::SendMessages(CNode* pto, std::atomic<bool>& interruptM
                     }
                     pto->filterInventoryKnown.insert(hash);
                 }
+                // Keep what is left over for the next trickle
+                pto->setInventoryTxToSend.clear();
+                for (; nPos < vInvTxInfo.size(); nPos++)
+                    pto->setInventoryTxToSend.insert(vInvTxInfo[nPos].tx->GetHash());
             }
         }
         if (!vInv.empty())
@@ -3717,10 +4204,12 @@ bool PeerLogicValidation::SendMessages(CNode* pto, std::atomic<bool>& interruptM
         // Message: getdata (blocks)
         //
         std::vector<CInv> vGetData;
-        if (!pto->fClient && (fFetch || !IsInitialBlockDownload()) && state.nBlocksInFlight < MAX_BLOCKS_IN_TRANSIT_PER_PEER) {
+        int nDownloadWindow = GetBlockDownloadWindow(state);
+        if (!pto->fClient && (fFetch || !IsInitialBlockDownload()) && state.nBlocksInFlight < nDownloadWindow) {
             std::vector<const CBlockIndex*> vToDownload;
             NodeId staller = -1;
-            FindNextBlocksToDownload(pto->GetId(), MAX_BLOCKS_IN_TRANSIT_PER_PEER - state.nBlocksInFlight, vToDownload, staller, consensusParams);
+            const CBlockIndex* pindexStalling = nullptr;
+            FindNextBlocksToDownload(pto->GetId(), nDownloadWindow - state.nBlocksInFlight, vToDownload, staller, pindexStalling, consensusParams);
             for (const CBlockIndex *pindex : vToDownload) {
                 uint32_t nFetchFlags = GetFetchFlags(pto);
                 vGetData.push_back(CInv(MSG_BLOCK | nFetchFlags, pindex->GetBlockHash()));
@@ -3734,6 +4223,24 @@ bool PeerLogicValidation::SendMessages(CNode* pto, std::atomic<bool>& interruptM
                     LogPrint(BCLog::NET, "Stall started peer=%d\n", staller);
                 }
             }
+            // Rather than wait for the staller to be disconnected, take over the block holding the window
+            // back once it is well past when the staller should have delivered it, if we expect to be quicker.
+            if (vToDownload.empty() && pindexStalling) {
+                const CNodeState* stallerState = State(staller);
+                std::map<uint256, std::pair<NodeId, std::list<QueuedBlock>::iterator> >::iterator itInFlight = mapBlocksInFlight.find(pindexStalling->GetBlockHash());
+                if (stallerState != nullptr && itInFlight != mapBlocksInFlight.end() && itInFlight->second.first == staller) {
+                    int64_t nExpected = stallerState->nBlockRtt + stallerState->nBlockServiceTime * stallerState->nBlocksInFlight;
+                    int64_t nOurs = state.nBlockRtt + state.nBlockServiceTime * (state.nBlocksInFlight + 1);
+                    bool fFaster = state.nBlockServiceTime != 0 && (stallerState->nBlockServiceTime == 0 || state.nBlockServiceTime < stallerState->nBlockServiceTime);
+                    if (fFaster && nNow - itInFlight->second.second->nTimeRequested > std::max(BLOCK_REASSIGN_MIN_DELAY, 2 * std::max(nExpected, nOurs))) {
+                        uint32_t nFetchFlags = GetFetchFlags(pto);
+                        vGetData.push_back(CInv(MSG_BLOCK | nFetchFlags, pindexStalling->GetBlockHash()));
+                        MarkBlockAsInFlight(pto->GetId(), pindexStalling->GetBlockHash(), pindexStalling);
+                        LogPrint(BCLog::NET, "Reassigning stalled block %s (%d) from peer=%d to peer=%d\n", pindexStalling->GetBlockHash().ToString(),
+                            pindexStalling->nHeight, staller, pto->GetId());
+                    }
+                }
+            }
         }
 
         //
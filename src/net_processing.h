@@ -12,7 +12,11 @@
 #include "consensus/params.h"
 
 /** Default for -maxorphantx, maximum number of orphan transactions kept in memory */
-static const unsigned int DEFAULT_MAX_ORPHAN_TRANSACTIONS = 100;
+static const unsigned int DEFAULT_MAX_ORPHAN_TRANSACTIONS = 1000;
+/** Default for -maxorphanmemory, maximum megabytes of memory the orphan transactions take */
+static const unsigned int DEFAULT_MAX_ORPHAN_MEMORY = 10;
+/** Default for -maxrelaymemory, maximum megabytes of memory the transactions kept for announced invs take */
+static const unsigned int DEFAULT_MAX_RELAY_MEMORY = 50;
 /** Expiration time for orphan transactions in seconds */
 static const int64_t ORPHAN_TX_EXPIRE_TIME = 20 * 60;
 /** Minimum time between orphan transactions expire time checks in seconds */
@@ -35,6 +39,14 @@ static constexpr int64_t STALE_CHECK_INTERVAL = 10 * 60; // 10 minutes
 static constexpr int64_t EXTRA_PEER_CHECK_INTERVAL = 45;
 /** Minimum time an outbound-peer-eviction candidate must be connected for, in order to evict, in seconds */
 static constexpr int64_t MINIMUM_CONNECT_TIME = 30;
+/** Assets per second answered for a (non-whitelisted) peer, after a burst of MAX_ASSET_INV_SZ */
+static constexpr double ASSET_DATA_SERVE_RATE = 200;
+/** Most getassetdata entries queued for a peer; requests past this are ignored */
+static constexpr size_t MAX_ASSET_GETDATA_QUEUE = 4 * MAX_ASSET_INV_SZ;
+/** Bytes of serialized ASSETDATA responses kept for the current asset read view */
+static constexpr size_t DEFAULT_ASSET_DATA_CACHE_SIZE = 4 << 20;
+/** How often verified LLMQ signature shares are batched up and relayed, in milliseconds */
+static constexpr int64_t SIG_SHARES_RELAY_INTERVAL = 100;
 
 class PeerLogicValidation final: public CValidationInterface, public NetEventsInterface {
 private:
@@ -65,6 +77,8 @@ public:
     void ConsiderEviction(CNode *pto, int64_t time_in_seconds);
     void CheckForStaleTipAndEvictPeers(const Consensus::Params &consensusParams);
     void EvictExtraOutboundPeers(int64_t time_in_seconds);
+    /** Send the signature shares collected since the last call to every peer, in qsigshares messages */
+    void RelaySigShares();
 
 private:
     int64_t m_stale_tip_check_time; //!< Next time to check for stale tip
@@ -81,5 +95,13 @@ struct CNodeStateStats {
 bool GetNodeStateStats(NodeId nodeid, CNodeStateStats &stats);
 /** Increase a node's misbehavior score. */
 void Misbehaving(NodeId nodeid, int howmuch);
+/**
+ * Whether a message from a peer past the version handshake may be handled
+ * concurrently with other peers' messages. Its handler only touches the
+ * sending peer's own state, or state guarded by its own lock such as cs_main;
+ * every other message, and all of SendMessages, runs under a single lock
+ * because it may change other peers' unguarded fields (vAddrToSend, mapAskFor).
+ */
+bool IsPeerLocalMessage(const std::string& strCommand);
 
 #endif // MYNTA_NET_PROCESSING_H
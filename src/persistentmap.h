@@ -0,0 +1,321 @@
+// Copyright (c) 2026 The Mynta Core Developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#ifndef MYNTA_PERSISTENTMAP_H
+#define MYNTA_PERSISTENTMAP_H
+
+#include "serialize.h"
+
+#include <algorithm>
+#include <functional>
+#include <memory>
+#include <utility>
+#include <vector>
+
+/**
+ * STL-like ordered map with persistent (structurally shared) storage.
+ *
+ * The map is an AVL tree of immutable nodes held by shared_ptr. Copying a
+ * persistentmap only copies the root pointer; set() and erase() copy the
+ * O(log n) nodes on the path to the modified key and share everything else
+ * with the original. A chain of maps that each differ by a few entries
+ * therefore costs roughly O(changes * log n) memory instead of O(n) per map.
+ *
+ * Nodes are never modified after construction, so different copies can be
+ * read and modified from different threads without extra locking. There is
+ * no mutable access to values; use set() to replace one.
+ */
+template <typename K, typename V, typename Compare = std::less<K> >
+class persistentmap
+{
+public:
+    typedef K key_type;
+    typedef V mapped_type;
+    typedef std::pair<const key_type, mapped_type> value_type;
+    typedef size_t size_type;
+
+private:
+    struct Node;
+    typedef std::shared_ptr<const Node> NodePtr;
+
+    struct Node {
+        value_type kv;
+        NodePtr left;
+        NodePtr right;
+        int height;
+
+        Node(const value_type& _kv, NodePtr _left, NodePtr _right)
+            : kv(_kv), left(std::move(_left)), right(std::move(_right)),
+              height(1 + std::max(Height(left), Height(right))) {}
+    };
+
+    NodePtr root;
+    size_type nSize{0};
+
+    static int Height(const NodePtr& n) { return n ? n->height : 0; }
+
+    static NodePtr Make(const value_type& kv, NodePtr left, NodePtr right)
+    {
+        return std::make_shared<const Node>(kv, std::move(left), std::move(right));
+    }
+
+    /** Build a node from kv/left/right, rotating if the subtree heights differ by 2 */
+    static NodePtr Balance(const value_type& kv, NodePtr left, NodePtr right)
+    {
+        int hl = Height(left);
+        int hr = Height(right);
+        if (hl > hr + 1) {
+            if (Height(left->left) >= Height(left->right)) {
+                return Make(left->kv, left->left, Make(kv, left->right, std::move(right)));
+            }
+            const NodePtr& lr = left->right;
+            return Make(lr->kv, Make(left->kv, left->left, lr->left), Make(kv, lr->right, std::move(right)));
+        }
+        if (hr > hl + 1) {
+            if (Height(right->right) >= Height(right->left)) {
+                return Make(right->kv, Make(kv, std::move(left), right->left), right->right);
+            }
+            const NodePtr& rl = right->left;
+            return Make(rl->kv, Make(kv, std::move(left), rl->left), Make(right->kv, rl->right, right->right));
+        }
+        return Make(kv, std::move(left), std::move(right));
+    }
+
+    static NodePtr Insert(const NodePtr& n, const key_type& k, const mapped_type& v, bool& fAdded)
+    {
+        if (!n) {
+            fAdded = true;
+            return Make(value_type(k, v), nullptr, nullptr);
+        }
+        if (Compare()(k, n->kv.first)) {
+            return Balance(n->kv, Insert(n->left, k, v, fAdded), n->right);
+        }
+        if (Compare()(n->kv.first, k)) {
+            return Balance(n->kv, n->left, Insert(n->right, k, v, fAdded));
+        }
+        return Make(value_type(k, v), n->left, n->right);
+    }
+
+    static NodePtr RemoveMin(const NodePtr& n)
+    {
+        if (!n->left) {
+            return n->right;
+        }
+        return Balance(n->kv, RemoveMin(n->left), n->right);
+    }
+
+    /** Remove k from the subtree; the key must be present */
+    static NodePtr Remove(const NodePtr& n, const key_type& k)
+    {
+        if (Compare()(k, n->kv.first)) {
+            return Balance(n->kv, Remove(n->left, k), n->right);
+        }
+        if (Compare()(n->kv.first, k)) {
+            return Balance(n->kv, n->left, Remove(n->right, k));
+        }
+        if (!n->left) {
+            return n->right;
+        }
+        if (!n->right) {
+            return n->left;
+        }
+        const Node* minNode = n->right.get();
+        while (minNode->left) {
+            minNode = minNode->left.get();
+        }
+        return Balance(minNode->kv, n->left, RemoveMin(n->right));
+    }
+
+    /** Build a perfectly balanced tree from sorted, unique entries */
+    static NodePtr BuildSorted(const std::vector<value_type>& v, size_t begin, size_t end)
+    {
+        if (begin == end) {
+            return nullptr;
+        }
+        size_t mid = begin + (end - begin) / 2;
+        return Make(v[mid], BuildSorted(v, begin, mid), BuildSorted(v, mid + 1, end));
+    }
+
+    const Node* FindNode(const key_type& k) const
+    {
+        const Node* n = root.get();
+        while (n) {
+            if (Compare()(k, n->kv.first)) {
+                n = n->left.get();
+            } else if (Compare()(n->kv.first, k)) {
+                n = n->right.get();
+            } else {
+                return n;
+            }
+        }
+        return nullptr;
+    }
+
+public:
+    /** In-order iterator. Holds raw pointers, so it is invalidated when the map it came from is destroyed. */
+    class const_iterator
+    {
+        friend class persistentmap;
+        std::vector<const Node*> stack;
+
+        void PushLeft(const Node* n)
+        {
+            while (n) {
+                stack.push_back(n);
+                n = n->left.get();
+            }
+        }
+
+    public:
+        typedef std::forward_iterator_tag iterator_category;
+        typedef typename persistentmap::value_type value_type;
+        typedef std::ptrdiff_t difference_type;
+        typedef const value_type* pointer;
+        typedef const value_type& reference;
+
+        reference operator*() const { return stack.back()->kv; }
+        pointer operator->() const { return &stack.back()->kv; }
+
+        const_iterator& operator++()
+        {
+            const Node* n = stack.back();
+            stack.pop_back();
+            PushLeft(n->right.get());
+            return *this;
+        }
+        const_iterator operator++(int)
+        {
+            const_iterator copy(*this);
+            ++*this;
+            return copy;
+        }
+
+        bool operator==(const const_iterator& other) const
+        {
+            if (stack.empty() || other.stack.empty()) {
+                return stack.empty() == other.stack.empty();
+            }
+            return stack.back() == other.stack.back();
+        }
+        bool operator!=(const const_iterator& other) const { return !(*this == other); }
+    };
+    typedef const_iterator iterator;
+
+    persistentmap() = default;
+
+    const_iterator begin() const
+    {
+        const_iterator it;
+        it.PushLeft(root.get());
+        return it;
+    }
+    const_iterator end() const { return const_iterator(); }
+
+    size_type size() const { return nSize; }
+    bool empty() const { return nSize == 0; }
+
+    const_iterator find(const key_type& k) const
+    {
+        // The iterator stack holds every ancestor whose left subtree we descended into
+        const_iterator it;
+        const Node* n = root.get();
+        while (n) {
+            if (Compare()(k, n->kv.first)) {
+                it.stack.push_back(n);
+                n = n->left.get();
+            } else if (Compare()(n->kv.first, k)) {
+                n = n->right.get();
+            } else {
+                it.stack.push_back(n);
+                return it;
+            }
+        }
+        return end();
+    }
+    size_type count(const key_type& k) const { return FindNode(k) ? 1 : 0; }
+
+    /** Lookup without building an iterator; returns nullptr when k is absent */
+    const mapped_type* find_value(const key_type& k) const
+    {
+        const Node* n = FindNode(k);
+        return n ? &n->kv.second : nullptr;
+    }
+
+    /** Insert or replace the value for k */
+    void set(const key_type& k, const mapped_type& v)
+    {
+        bool fAdded = false;
+        root = Insert(root, k, v, fAdded);
+        if (fAdded) {
+            nSize++;
+        }
+    }
+
+    /** Remove k; returns the number of entries removed (0 or 1) */
+    size_type erase(const key_type& k)
+    {
+        if (!FindNode(k)) {
+            return 0;
+        }
+        root = Remove(root, k);
+        nSize--;
+        return 1;
+    }
+
+    void clear()
+    {
+        root.reset();
+        nSize = 0;
+    }
+
+    /** Height of the tree; a modification copies at most this many nodes */
+    int height() const { return Height(root); }
+
+    /** Size of one node allocation (make_shared places the reference counts next to the node) */
+    static constexpr size_t node_alloc_size() { return sizeof(Node) + 2 * sizeof(void*); }
+
+    /** True if both maps share the same root, i.e. are trivially identical */
+    bool shares_root_with(const persistentmap& other) const { return root == other.root; }
+
+    /** Serialized exactly like std::map, so on-disk formats are unchanged */
+    template <typename Stream>
+    void Serialize(Stream& os) const
+    {
+        WriteCompactSize(os, nSize);
+        for (const auto& kv : *this) {
+            ::Serialize(os, kv.first);
+            ::Serialize(os, kv.second);
+        }
+    }
+
+    template <typename Stream>
+    void Unserialize(Stream& is)
+    {
+        clear();
+        unsigned int nSizeIn = ReadCompactSize(is);
+        std::vector<value_type> entries;
+        entries.reserve(nSizeIn);
+        bool fSorted = true;
+        for (unsigned int i = 0; i < nSizeIn; i++) {
+            key_type k;
+            mapped_type v;
+            ::Unserialize(is, k);
+            ::Unserialize(is, v);
+            if (!entries.empty() && !Compare()(entries.back().first, k)) {
+                fSorted = false;
+            }
+            entries.emplace_back(k, v);
+        }
+        if (fSorted) {
+            root = BuildSorted(entries, 0, entries.size());
+            nSize = entries.size();
+        } else {
+            for (const auto& kv : entries) {
+                set(kv.first, kv.second);
+            }
+        }
+    }
+};
+
+#endif // MYNTA_PERSISTENTMAP_H
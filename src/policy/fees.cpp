@@ -291,8 +291,9 @@ double TxConfirmStats::EstimateMedianVal(int confTarget, double sufficientTxVal,
         nConf += confAvg[periodTarget - 1][bucket];
         totalNum += txCtAvg[bucket];
         failNum += failAvg[periodTarget - 1][bucket];
+        // Adding bins first keeps heights below it from wrapping to another slot
         for (unsigned int confct = confTarget; confct < GetMaxConfirms(); confct++)
-            extraNum += unconfTxs[(nBlockHeight - confct)%bins][bucket];
+            extraNum += unconfTxs[(nBlockHeight + bins - confct)%bins][bucket];
         extraNum += oldUnconfTxs[bucket];
         // If we have enough transaction data points in this range of buckets,
         // we can test for success
@@ -526,6 +527,10 @@ bool CBlockPolicyEstimator::removeTx(uint256 hash, bool inBlock)
     LOCK(cs_feeEstimator);
     std::map<uint256, TxStatsInfo>::iterator pos = mapMemPoolTxs.find(hash);
     if (pos != mapMemPoolTxs.end()) {
+        // Estimates only count unconfirmed txs from before the last block, so
+        // one that came and went since does not move them
+        if (pos->second.blockHeight != nBestSeenHeight)
+            nStatsVersion++;
         feeStats->removeTx(pos->second.blockHeight, nBestSeenHeight, pos->second.bucketIndex, inBlock);
         shortStats->removeTx(pos->second.blockHeight, nBestSeenHeight, pos->second.bucketIndex, inBlock);
         longStats->removeTx(pos->second.blockHeight, nBestSeenHeight, pos->second.bucketIndex, inBlock);
@@ -644,6 +649,7 @@ void CBlockPolicyEstimator::processBlock(unsigned int nBlockHeight,
     // calls to removeTx (via processBlockTx) correctly calculate age
     // of unconfirmed txs to remove from tracking.
     nBestSeenHeight = nBlockHeight;
+    nStatsVersion++;
 
     // Update unconfirmed circular buffer
     feeStats->ClearCurrent(nBlockHeight);
@@ -741,6 +747,12 @@ unsigned int CBlockPolicyEstimator::HighestTargetTracked(FeeEstimateHorizon hori
     }
 }
 
+unsigned int CBlockPolicyEstimator::GetBestSeenHeight() const
+{
+    LOCK(cs_feeEstimator);
+    return nBestSeenHeight;
+}
+
 unsigned int CBlockPolicyEstimator::BlockSpan() const
 {
     if (firstRecordedHeight == 0) return 0;
@@ -834,7 +846,24 @@ double CBlockPolicyEstimator::estimateConservativeFee(unsigned int doubleTarget,
  */
 CFeeRate CBlockPolicyEstimator::estimateSmartFee(int confTarget, FeeCalculation *feeCalc, bool conservative) const
 {
+    std::shared_ptr<const EstimateTable> table = std::atomic_load(&estimateTable);
+    if (table && table->nStatsVersion == nStatsVersion) {
+        auto it = table->mapEstimates.find(std::make_pair(confTarget, conservative));
+        if (it != table->mapEstimates.end()) {
+            if (feeCalc) *feeCalc = it->second.second;
+            return it->second.first;
+        }
+    }
+
     LOCK(cs_feeEstimator);
+    if (confTarget > 0 && (unsigned int)confTarget <= longStats->GetMaxConfirms())
+        setRequestedTargets.emplace(confTarget, conservative);
+    return estimateSmartFeeLocked(confTarget, feeCalc, conservative);
+}
+
+CFeeRate CBlockPolicyEstimator::estimateSmartFeeLocked(int confTarget, FeeCalculation *feeCalc, bool conservative) const
+{
+    AssertLockHeld(cs_feeEstimator);
 
     if (feeCalc) {
         feeCalc->desiredTarget = confTarget;
@@ -910,6 +939,31 @@ CFeeRate CBlockPolicyEstimator::estimateSmartFee(int confTarget, FeeCalculation
     return CFeeRate(llround(median));
 }
 
+void CBlockPolicyEstimator::RefreshEstimates()
+{
+    std::shared_ptr<const EstimateTable> table = std::atomic_load(&estimateTable);
+    if (table && table->nStatsVersion == nStatsVersion)
+        return;
+
+    int64_t nTimeStart = GetTimeMicros();
+    std::shared_ptr<EstimateTable> tableNew = std::make_shared<EstimateTable>();
+    LOCK(cs_feeEstimator);
+    tableNew->nStatsVersion = nStatsVersion;
+    std::set<std::pair<int, bool>> setTargets = setRequestedTargets;
+    for (int target : confTargets) {
+        setTargets.emplace(target, false);
+        setTargets.emplace(target, true);
+    }
+    for (const auto& target : setTargets) {
+        FeeCalculation feeCalc;
+        CFeeRate feeRate = estimateSmartFeeLocked(target.first, &feeCalc, target.second);
+        tableNew->mapEstimates.emplace(target, std::make_pair(feeRate, feeCalc));
+    }
+    std::atomic_store(&estimateTable, std::shared_ptr<const EstimateTable>(std::move(tableNew)));
+    LogPrint(BCLog::ESTIMATEFEE, "Blockpolicy refreshed %u estimates at height %u in %.2fms\n",
+             setTargets.size(), nBestSeenHeight, (GetTimeMicros() - nTimeStart) * 0.001);
+}
+
 
 bool CBlockPolicyEstimator::Write(CAutoFile& fileout) const
 {
@@ -1013,6 +1067,7 @@ bool CBlockPolicyEstimator::Read(CAutoFile& filein)
             nBestSeenHeight = nFileBestSeenHeight;
             historicalFirst = nFileHistoricalFirst;
             historicalBest = nFileHistoricalBest;
+            nStatsVersion++;
         }
     }
     catch (const std::exception& e) {
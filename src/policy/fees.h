@@ -12,7 +12,10 @@
 #include "random.h"
 #include "sync.h"
 
+#include <atomic>
 #include <map>
+#include <memory>
+#include <set>
 #include <string>
 #include <vector>
 #include <array>
@@ -209,9 +212,17 @@ public:
      *  blocks. If no answer can be given at confTarget, return an estimate at
      *  the closest target where one can be given.  'conservative' estimates are
      *  valid over longer time horizons also.
+     *  Answered without locking from the table RefreshEstimates builds, as long
+     *  as the stats have not moved since and the table has the target.
      */
     CFeeRate estimateSmartFee(int confTarget, FeeCalculation *feeCalc, bool conservative) const;
 
+    /** Work out the estimates of the usual targets, and of any other target
+     *  asked for since, if the stats have moved since the last time. Meant to
+     *  be run in the background after blocks come in.
+     */
+    void RefreshEstimates();
+
     /** Return a specific fee estimate calculation with a given success
      * threshold and time horizon, and optionally return detailed data about
      * calculation
@@ -230,6 +241,9 @@ public:
     /** Calculation of highest target that estimates are tracked for */
     unsigned int HighestTargetTracked(FeeEstimateHorizon horizon) const;
 
+    /** Height of the last block processed */
+    unsigned int GetBestSeenHeight() const;
+
 private:
     unsigned int nBestSeenHeight;
     unsigned int firstRecordedHeight;
@@ -259,9 +273,25 @@ private:
 
     mutable CCriticalSection cs_feeEstimator;
 
+    /** estimateSmartFee answers keyed by target and whether they are conservative */
+    struct EstimateTable
+    {
+        uint64_t nStatsVersion;
+        std::map<std::pair<int, bool>, std::pair<CFeeRate, FeeCalculation>> mapEstimates;
+    };
+
+    //! bumped under cs_feeEstimator by every change to the stats that can move an estimate
+    std::atomic<uint64_t> nStatsVersion{0};
+    //! only ever replaced whole, with std::atomic_store
+    std::shared_ptr<const EstimateTable> estimateTable;
+    //! targets estimateSmartFee was asked for that the table lacked
+    mutable std::set<std::pair<int, bool>> setRequestedTargets;
+
     /** Process a transaction confirmed in a block*/
     bool processBlockTx(unsigned int nBlockHeight, const CTxMemPoolEntry* entry);
 
+    /** estimateSmartFee, with cs_feeEstimator held */
+    CFeeRate estimateSmartFeeLocked(int confTarget, FeeCalculation *feeCalc, bool conservative) const;
     /** Helper for estimateSmartFee */
     double estimateCombinedFee(unsigned int confTarget, double successThreshold, bool checkShorterHorizon, EstimationResult *result) const;
     /** Helper for estimateSmartFee */
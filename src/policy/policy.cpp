@@ -78,6 +78,9 @@ bool IsStandard(const CScript& scriptPubKey, txnouttype& whichType, const bool w
         return false;
     else if (whichType == TX_RESTRICTED_ASSET_DATA && scriptPubKey.size() > MAX_OP_RETURN_RELAY)
         return false;
+    else if (whichType == TX_HTLC)
+        return false; // HTLCs are paid to through P2SH
+
     else if (!witnessEnabled && (whichType == TX_WITNESS_V0_KEYHASH || whichType == TX_WITNESS_V0_SCRIPTHASH))
         return false;
 
@@ -35,39 +35,115 @@ void BlockNetwork::SetNetwork(const std::string& net)
     }
 }
 
+static uint32_t GetX16RV2ActivationTime()
+{
+    if (bNetwork.fOnTestnet) {
+        return TESTNET_X16RV2ACTIVATIONTIME;
+    } else if (bNetwork.fOnRegtest) {
+        return REGTEST_X16RV2ACTIVATIONTIME;
+    }
+    return MAINNET_X16RV2ACTIVATIONTIME;
+}
+
+CBlockHashCache& CBlockHashCache::operator=(const CBlockHashCache& other)
+{
+    if (this == &other) {
+        return *this;
+    }
+    fValid.store(false, std::memory_order_relaxed);
+    if (!other.fValid.load(std::memory_order_acquire)) {
+        return *this;
+    }
+    hash = other.hash;
+    nVersion = other.nVersion;
+    hashPrevBlock = other.hashPrevBlock;
+    hashMerkleRoot = other.hashMerkleRoot;
+    nTime = other.nTime;
+    nBits = other.nBits;
+    nNonce = other.nNonce;
+    nHeight = other.nHeight;
+    nNonce64 = other.nNonce64;
+    mix_hash = other.mix_hash;
+    nKAWPOWActivationTime = other.nKAWPOWActivationTime;
+    nX16RV2ActivationTime = other.nX16RV2ActivationTime;
+    fValid.store(true, std::memory_order_release);
+    return *this;
+}
+
+bool CBlockHashCache::Matches(const CBlockHeader& header, uint32_t nX16RV2ActivationTimeIn) const
+{
+    return nVersion == header.nVersion &&
+           nTime == header.nTime &&
+           nBits == header.nBits &&
+           nNonce == header.nNonce &&
+           nHeight == header.nHeight &&
+           nNonce64 == header.nNonce64 &&
+           nKAWPOWActivationTime == ::nKAWPOWActivationTime &&
+           nX16RV2ActivationTime == nX16RV2ActivationTimeIn &&
+           hashPrevBlock == header.hashPrevBlock &&
+           hashMerkleRoot == header.hashMerkleRoot &&
+           mix_hash == header.mix_hash;
+}
+
+bool CBlockHashCache::Get(const CBlockHeader& header, uint32_t nX16RV2ActivationTimeIn, uint256& hashOut) const
+{
+    if (!fValid.load(std::memory_order_acquire) || !Matches(header, nX16RV2ActivationTimeIn)) {
+        return false;
+    }
+    hashOut = hash;
+    return true;
+}
+
+void CBlockHashCache::Set(const CBlockHeader& header, uint32_t nX16RV2ActivationTimeIn, const uint256& hashIn)
+{
+    fValid.store(false, std::memory_order_relaxed);
+    hash = hashIn;
+    nVersion = header.nVersion;
+    hashPrevBlock = header.hashPrevBlock;
+    hashMerkleRoot = header.hashMerkleRoot;
+    nTime = header.nTime;
+    nBits = header.nBits;
+    nNonce = header.nNonce;
+    nHeight = header.nHeight;
+    nNonce64 = header.nNonce64;
+    mix_hash = header.mix_hash;
+    nKAWPOWActivationTime = ::nKAWPOWActivationTime;
+    nX16RV2ActivationTime = nX16RV2ActivationTimeIn;
+    fValid.store(true, std::memory_order_release);
+}
+
 uint256 CBlockHeader::GetHash() const
 {
+    const uint32_t nX16RV2ActivationTime = GetX16RV2ActivationTime();
+    uint256 hash;
+    if (hashCache.Get(*this, nX16RV2ActivationTime, hash)) {
+        return hash;
+    }
+
     if (nTime < nKAWPOWActivationTime) {
-        uint32_t nTimeToUse = MAINNET_X16RV2ACTIVATIONTIME;
-        if (bNetwork.fOnTestnet) {
-            nTimeToUse = TESTNET_X16RV2ACTIVATIONTIME;
-        } else if (bNetwork.fOnRegtest) {
-            nTimeToUse = REGTEST_X16RV2ACTIVATIONTIME;
+        if (nTime >= nX16RV2ActivationTime) {
+            hash = HashX16RV2(BEGIN(nVersion), END(nNonce), hashPrevBlock);
+        } else {
+            hash = HashX16R(BEGIN(nVersion), END(nNonce), hashPrevBlock);
         }
-        if (nTime >= nTimeToUse) {
-            return HashX16RV2(BEGIN(nVersion), END(nNonce), hashPrevBlock);
-        }
-
-        return HashX16R(BEGIN(nVersion), END(nNonce), hashPrevBlock);
     } else {
-        return KAWPOWHash_OnlyMix(*this);
+        hash = KAWPOWHash_OnlyMix(*this);
     }
+
+    hashCache.Set(*this, nX16RV2ActivationTime, hash);
+    return hash;
+}
+
+void CBlockHeader::SetCachedHash(const uint256& hash) const
+{
+    hashCache.Set(*this, GetX16RV2ActivationTime(), hash);
 }
 
 uint256 CBlockHeader::GetHashFull(uint256& mix_hash) const
 {
     if (nTime < nKAWPOWActivationTime) {
-        uint32_t nTimeToUse = MAINNET_X16RV2ACTIVATIONTIME;
-        if (bNetwork.fOnTestnet) {
-            nTimeToUse = TESTNET_X16RV2ACTIVATIONTIME;
-        } else if (bNetwork.fOnRegtest) {
-            nTimeToUse = REGTEST_X16RV2ACTIVATIONTIME;
-        }
-        if (nTime >= nTimeToUse) {
-            return HashX16RV2(BEGIN(nVersion), END(nNonce), hashPrevBlock);
-        }
-
-        return HashX16R(BEGIN(nVersion), END(nNonce), hashPrevBlock);
+        // X16R(V2) has no separate full hash, so share the memoized one
+        return GetHash();
     } else {
         return KAWPOWHash(*this, mix_hash);
     }
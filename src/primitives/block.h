@@ -11,6 +11,8 @@
 #include "serialize.h"
 #include "uint256.h"
 
+#include <atomic>
+
 /** Nodes collect new transactions into a block, hash them into a hash tree,
  * and scan through nonce values to make the block's hash satisfy proof-of-work
  * requirements.  When they solve the proof-of-work, they broadcast the block
@@ -32,6 +34,47 @@ public:
 
 extern BlockNetwork bNetwork;
 
+class CBlockHeader;
+
+/**
+ * Memoized CBlockHeader::GetHash() result (memory only).
+ *
+ * The header fields are public and modified in place (e.g. by the miner), so
+ * the cache keeps a copy of every input to the hash and is only used while
+ * those still match. The result is published through an atomic flag so that
+ * shared, const blocks can be hashed from several threads.
+ */
+class CBlockHashCache
+{
+private:
+    std::atomic<bool> fValid{false};
+    uint256 hash;
+
+    // Inputs of the cached hash
+    int32_t nVersion{0};
+    uint256 hashPrevBlock;
+    uint256 hashMerkleRoot;
+    uint32_t nTime{0};
+    uint32_t nBits{0};
+    uint32_t nNonce{0};
+    uint32_t nHeight{0};
+    uint64_t nNonce64{0};
+    uint256 mix_hash;
+    uint32_t nKAWPOWActivationTime{0};
+    uint32_t nX16RV2ActivationTime{0};
+
+    bool Matches(const CBlockHeader& header, uint32_t nX16RV2ActivationTimeIn) const;
+
+public:
+    CBlockHashCache() = default;
+    CBlockHashCache(const CBlockHashCache& other) { *this = other; }
+    CBlockHashCache& operator=(const CBlockHashCache& other);
+
+    bool Get(const CBlockHeader& header, uint32_t nX16RV2ActivationTimeIn, uint256& hashOut) const;
+    void Set(const CBlockHeader& header, uint32_t nX16RV2ActivationTimeIn, const uint256& hashIn);
+    void Clear() { fValid.store(false, std::memory_order_release); }
+};
+
 
 class CBlockHeader
 {
@@ -50,6 +93,9 @@ public:
     uint64_t nNonce64;
     uint256 mix_hash;
 
+    // memory only
+    mutable CBlockHashCache hashCache;
+
     CBlockHeader()
     {
         SetNull();
@@ -85,6 +131,7 @@ public:
         nNonce64 = 0;
         nHeight = 0;
         mix_hash.SetNull();
+        hashCache.Clear();
     }
 
     bool IsNull() const
@@ -92,7 +139,10 @@ public:
         return (nBits == 0);
     }
 
+    /** Block hash; memoized in hashCache until one of the header fields changes */
     uint256 GetHash() const;
+    /** Seed hashCache with a hash known to belong to this header, e.g. its CBlockIndex's */
+    void SetCachedHash(const uint256& hash) const;
     uint256 GetX16RHash() const;
     uint256 GetX16RV2Hash() const;
 
@@ -138,7 +188,7 @@ public:
     template <typename Stream, typename Operation>
     inline void SerializationOp(Stream& s, Operation ser_action) {
         READWRITE(*(CBlockHeader*)this);
-        READWRITE(vtx);
+        SerializeBlockTransactions(s, vtx, ser_action);
     }
 
     void SetNull()
@@ -162,6 +212,7 @@ public:
         block.nHeight        = nHeight;
         block.nNonce64       = nNonce64;
         block.mix_hash       = mix_hash;
+        block.hashCache      = hashCache;
         return block;
     }
 
@@ -0,0 +1,148 @@
+// Copyright (c) 2026 The Mynta Core Developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include "primitives/blockview.h"
+
+#include "consensus/consensus.h"
+#include "hash.h"
+#include "serialize.h"
+#include "streams.h"
+#include "version.h"
+
+#include <algorithm>
+#include <ios>
+#include <string.h>
+
+namespace {
+void SkipScript(CSpanReader& r)
+{
+    r.ignore(ReadCompactSize(r));
+}
+} // namespace
+
+/** Walks a transaction the same way UnserializeTransaction does, recording offsets instead of copying */
+void CBlockView::ParseTransaction(CSpanReader& r, CTransactionView& tx)
+{
+    const unsigned char* pBegin = r.data();
+    r.ignore(4); // nVersion
+
+    unsigned char flags = 0;
+    uint64_t nInputs = ReadCompactSize(r);
+    uint64_t nOutputs = 0;
+    uint32_t nVinOffset = 4;
+    uint32_t nVoutOffset;
+    if (nInputs == 0) {
+        // Either an empty vin or the extended format's dummy
+        r >> flags;
+        if (flags != 0) {
+            nVinOffset = r.data() - pBegin;
+            nInputs = ReadCompactSize(r);
+        }
+    }
+    for (uint64_t i = 0; i < nInputs; i++) {
+        r.ignore(36); // prevout
+        SkipScript(r);
+        r.ignore(4); // nSequence
+    }
+    if (nInputs == 0 && flags == 0) {
+        // No vout was serialized; the zero flags byte doubles as an empty output count
+        nVoutOffset = 5;
+    } else {
+        nVoutOffset = r.data() - pBegin;
+        nOutputs = ReadCompactSize(r);
+        for (uint64_t i = 0; i < nOutputs; i++) {
+            r.ignore(8); // nValue
+            SkipScript(r);
+        }
+    }
+
+    uint32_t nWitnessOffset = r.data() - pBegin;
+    if (flags & 1) {
+        flags ^= 1;
+        for (uint64_t i = 0; i < nInputs; i++) {
+            uint64_t nItems = ReadCompactSize(r);
+            for (uint64_t j = 0; j < nItems; j++) {
+                SkipScript(r);
+            }
+        }
+        tx.fWitness = true;
+    }
+    if (flags) {
+        throw std::ios_base::failure("Unknown transaction optional data");
+    }
+    r.ignore(4); // nLockTime
+
+    tx.pBegin = pBegin;
+    tx.nSize = r.data() - pBegin;
+    tx.nVinOffset = nVinOffset;
+    tx.nVoutOffset = nVoutOffset;
+    tx.nWitnessOffset = nWitnessOffset;
+    tx.nInputs = nInputs;
+    tx.nOutputs = nOutputs;
+
+    // The txid covers the serialization without the marker, flag and witnesses
+    CHash256 hasher;
+    if (tx.fWitness) {
+        hasher.Write(pBegin, 4);
+        hasher.Write(pBegin + nVinOffset, nWitnessOffset - nVinOffset);
+        hasher.Write(pBegin + tx.nSize - 4, 4);
+    } else {
+        hasher.Write(pBegin, tx.nSize);
+    }
+    hasher.Finalize(tx.hash.begin());
+}
+
+uint64_t blockview_detail::ReadCompactSize(const unsigned char*& pos)
+{
+    unsigned char chSize = *pos++;
+    uint64_t nSize = chSize;
+    if (chSize == 253) {
+        nSize = ReadLE16(pos);
+        pos += 2;
+    } else if (chSize == 254) {
+        nSize = ReadLE32(pos);
+        pos += 4;
+    } else if (chSize == 255) {
+        nSize = ReadLE64(pos);
+        pos += 8;
+    }
+    return nSize;
+}
+
+bool CBlockView::Parse(const unsigned char* data, size_t size)
+{
+    header = CBlockHeader();
+    vtx.clear();
+    nSize = 0;
+    nStrippedSize = 0;
+
+    try {
+        CSpanReader r(SER_NETWORK, PROTOCOL_VERSION, data, size);
+        r >> header;
+        uint64_t nTx = ReadCompactSize(r);
+        // A transaction takes at least 10 bytes, so a bogus count can't force a huge reservation
+        vtx.reserve(std::min<uint64_t>(nTx, r.size() / 10));
+        size_t nStripped = r.data() - data;
+        for (uint64_t i = 0; i < nTx; i++) {
+            vtx.emplace_back();
+            ParseTransaction(r, vtx.back());
+            nStripped += vtx.back().GetStrippedSize();
+        }
+        if (r.size() != 0) {
+            vtx.clear();
+            return false;
+        }
+        nSize = size;
+        nStrippedSize = nStripped;
+    } catch (const std::ios_base::failure&) {
+        vtx.clear();
+        return false;
+    }
+    return true;
+}
+
+int64_t CBlockView::GetWeight() const
+{
+    return (int64_t)nStrippedSize * (WITNESS_SCALE_FACTOR - 1) + (int64_t)nSize;
+}
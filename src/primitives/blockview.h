@@ -0,0 +1,123 @@
+// Copyright (c) 2026 The Mynta Core Developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#ifndef MYNTA_PRIMITIVES_BLOCKVIEW_H
+#define MYNTA_PRIMITIVES_BLOCKVIEW_H
+
+#include "amount.h"
+#include "crypto/common.h"
+#include "primitives/block.h"
+#include "script/script.h"
+#include "uint256.h"
+
+#include <stddef.h>
+#include <stdint.h>
+#include <vector>
+
+class CSpanReader;
+
+/** One output of a CTransactionView; the script points into the view's buffer */
+struct CTxOutView
+{
+    CAmount nValue;
+    const unsigned char* pScript;
+    size_t nScriptSize;
+
+    CScript GetScript() const { return CScript(pScript, pScript + nScriptSize); }
+};
+
+/**
+ * Read-only transaction parsed in place from a serialized block.
+ *
+ * Only offsets into the block buffer are stored. The txid is computed while
+ * parsing by hashing the non-witness parts of the buffer directly, so looking
+ * at a transaction never copies its inputs, scripts or witnesses.
+ */
+class CTransactionView
+{
+    friend class CBlockView;
+
+    const unsigned char* pBegin{nullptr};
+    uint32_t nSize{0};
+    //! Offsets from pBegin of the first input count, the first output count and the witness data
+    uint32_t nVinOffset{0};
+    uint32_t nVoutOffset{0};
+    uint32_t nWitnessOffset{0};
+    uint32_t nInputs{0};
+    uint32_t nOutputs{0};
+    bool fWitness{false};
+    uint256 hash;
+
+public:
+    const uint256& GetHash() const { return hash; }
+    bool HasWitness() const { return fWitness; }
+    size_t GetInputCount() const { return nInputs; }
+    size_t GetOutputCount() const { return nOutputs; }
+
+    //! Serialized size with witness data
+    size_t GetTotalSize() const { return nSize; }
+    //! Serialized size without witness data
+    size_t GetStrippedSize() const { return fWitness ? 4 + (nWitnessOffset - nVinOffset) + 4 : nSize; }
+
+    //! The raw serialization of the whole transaction, witness included
+    const unsigned char* begin() const { return pBegin; }
+    const unsigned char* end() const { return pBegin + nSize; }
+
+    //! Decode every output in order and pass it to fn(const CTxOutView&)
+    template <typename Callback>
+    void ForEachOutput(Callback fn) const;
+};
+
+/**
+ * Read-only view of a serialized block (e.g. one read with
+ * ReadRawBlockFromDisk) for callers that only need txids, sizes and outputs.
+ *
+ * Parsing checks the whole encoding and fills one CTransactionView per
+ * transaction, so the only allocation is the transaction vector. The view
+ * does not own the buffer, which must outlive it.
+ */
+class CBlockView
+{
+    CBlockHeader header;
+    std::vector<CTransactionView> vtx;
+    size_t nSize{0};
+    size_t nStrippedSize{0};
+
+    static void ParseTransaction(CSpanReader& r, CTransactionView& tx);
+
+public:
+    //! Parse size bytes at data; returns false if they are not exactly one well-formed block
+    bool Parse(const unsigned char* data, size_t size);
+
+    const CBlockHeader& GetHeader() const { return header; }
+    const std::vector<CTransactionView>& GetTransactions() const { return vtx; }
+
+    size_t GetTotalSize() const { return nSize; }
+    size_t GetStrippedSize() const { return nStrippedSize; }
+    //! Same value as GetBlockWeight() on the deserialized block
+    int64_t GetWeight() const;
+};
+
+namespace blockview_detail {
+//! Decode a compact size at *pos, advancing it; the encoding was already validated by CBlockView::Parse
+uint64_t ReadCompactSize(const unsigned char*& pos);
+}
+
+template <typename Callback>
+void CTransactionView::ForEachOutput(Callback fn) const
+{
+    const unsigned char* pos = pBegin + nVoutOffset;
+    uint64_t nCount = blockview_detail::ReadCompactSize(pos);
+    for (uint64_t i = 0; i < nCount; i++) {
+        CTxOutView out;
+        out.nValue = (CAmount)ReadLE64(pos);
+        pos += 8;
+        out.nScriptSize = blockview_detail::ReadCompactSize(pos);
+        out.pScript = pos;
+        pos += out.nScriptSize;
+        fn(out);
+    }
+}
+
+#endif // MYNTA_PRIMITIVES_BLOCKVIEW_H
@@ -71,11 +71,49 @@ uint256 CMutableTransaction::GetHash() const
     return SerializeHash(*this, SER_GETHASH, SERIALIZE_TRANSACTION_NO_WITNESS);
 }
 
+bool CTransaction::ComputeHasWitness() const
+{
+    for (size_t i = 0; i < vin.size(); i++) {
+        if (!vin[i].scriptWitness.IsNull()) {
+            return true;
+        }
+    }
+    return false;
+}
+
 uint256 CTransaction::ComputeHash() const
 {
     return SerializeHash(*this, SER_GETHASH, SERIALIZE_TRANSACTION_NO_WITNESS);
 }
 
+unsigned int CTransaction::ComputeLegacySigOps() const
+{
+    unsigned int nSigOps = 0;
+    for (const auto& txin : vin)
+        nSigOps += txin.scriptSig.GetSigOpCount(false);
+    for (const auto& txout : vout)
+        nSigOps += txout.scriptPubKey.GetSigOpCount(false);
+    return nSigOps;
+}
+
+bool CTransaction::ComputeHasAssetOutputs() const
+{
+    for (const auto& txout : vout) {
+        if (txout.scriptPubKey.IsAssetScript())
+            return true;
+    }
+    return false;
+}
+
+bool CTransaction::ComputeHasNullAssetOutputs() const
+{
+    for (const auto& txout : vout) {
+        if (txout.scriptPubKey.IsNullAsset())
+            return true;
+    }
+    return false;
+}
+
 uint256 CTransaction::GetWitnessHash() const
 {
     if (!HasWitness()) {
@@ -85,9 +123,19 @@ uint256 CTransaction::GetWitnessHash() const
 }
 
 /* For backward compatibility, the hash is initialized to 0. TODO: remove the need for this default constructor entirely. */
-CTransaction::CTransaction() : vin(), vout(), nVersion(CTransaction::CURRENT_VERSION), nType(0), nLockTime(0), vExtraPayload(), hash() {}
-CTransaction::CTransaction(const CMutableTransaction &tx) : vin(tx.vin), vout(tx.vout), nVersion(tx.nVersion), nType(tx.nType), nLockTime(tx.nLockTime), vExtraPayload(tx.vExtraPayload), hash(ComputeHash()) {}
-CTransaction::CTransaction(CMutableTransaction &&tx) : vin(std::move(tx.vin)), vout(std::move(tx.vout)), nVersion(tx.nVersion), nType(tx.nType), nLockTime(tx.nLockTime), vExtraPayload(std::move(tx.vExtraPayload)), hash(ComputeHash()) {}
+CTransaction::CTransaction() : vin(), vout(), nVersion(CTransaction::CURRENT_VERSION), nType(0), nLockTime(0), vExtraPayload(), fHasWitness(false), hash(),
+    nBaseSize(::GetSerializeSize(*this, SER_NETWORK, PROTOCOL_VERSION | SERIALIZE_TRANSACTION_NO_WITNESS)), nTotalSize(nBaseSize),
+    nLegacySigOps(0), fHasAssetOutputs(false), fHasNullAssetOutputs(false) {}
+CTransaction::CTransaction(const CMutableTransaction &tx) : vin(tx.vin), vout(tx.vout), nVersion(tx.nVersion), nType(tx.nType), nLockTime(tx.nLockTime), vExtraPayload(tx.vExtraPayload),
+    fHasWitness(ComputeHasWitness()), hash(ComputeHash()),
+    nBaseSize(::GetSerializeSize(*this, SER_NETWORK, PROTOCOL_VERSION | SERIALIZE_TRANSACTION_NO_WITNESS)),
+    nTotalSize(fHasWitness ? ::GetSerializeSize(*this, SER_NETWORK, PROTOCOL_VERSION) : nBaseSize),
+    nLegacySigOps(ComputeLegacySigOps()), fHasAssetOutputs(ComputeHasAssetOutputs()), fHasNullAssetOutputs(ComputeHasNullAssetOutputs()) {}
+CTransaction::CTransaction(CMutableTransaction &&tx) : vin(std::move(tx.vin)), vout(std::move(tx.vout)), nVersion(tx.nVersion), nType(tx.nType), nLockTime(tx.nLockTime), vExtraPayload(std::move(tx.vExtraPayload)),
+    fHasWitness(ComputeHasWitness()), hash(ComputeHash()),
+    nBaseSize(::GetSerializeSize(*this, SER_NETWORK, PROTOCOL_VERSION | SERIALIZE_TRANSACTION_NO_WITNESS)),
+    nTotalSize(fHasWitness ? ::GetSerializeSize(*this, SER_NETWORK, PROTOCOL_VERSION) : nBaseSize),
+    nLegacySigOps(ComputeLegacySigOps()), fHasAssetOutputs(ComputeHasAssetOutputs()), fHasNullAssetOutputs(ComputeHasNullAssetOutputs()) {}
 
 CAmount CTransaction::GetValueOut(const bool fAreEnforcedValues) const
 {
@@ -110,11 +158,6 @@ CAmount CTransaction::GetValueOut(const bool fAreEnforcedValues) const
     return nValueOut;
 }
 
-unsigned int CTransaction::GetTotalSize() const
-{
-    return ::GetSerializeSize(*this, SER_NETWORK, PROTOCOL_VERSION);
-}
-
 std::string CTransaction::ToString() const
 {
     std::string str;
@@ -132,3 +175,12 @@ std::string CTransaction::ToString() const
         str += "    " + tx_out.ToString() + "\n";
     return str;
 }
+
+void* CTxChunk::Allocate(size_t nSize, size_t nAlign)
+{
+    const size_t nStart = (nUsed + nAlign - 1) & ~(nAlign - 1);
+    if (nStart + nSize > CHUNK_SIZE)
+        return nullptr;
+    nUsed = nStart + nSize;
+    return vBuffer + nStart;
+}
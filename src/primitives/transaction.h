@@ -7,6 +7,8 @@
 #ifndef MYNTA_PRIMITIVES_TRANSACTION_H
 #define MYNTA_PRIMITIVES_TRANSACTION_H
 
+#include <cstddef>
+#include <memory>
 #include <stdint.h>
 #include "amount.h"
 #include "script/script.h"
@@ -300,10 +302,20 @@ public:
     const std::vector<unsigned char> vExtraPayload;  // Extra payload for special transactions
 
 private:
-    /** Memory only. */
+    /** Memory only. Worked out once when the transaction is made, in this order. */
+    const bool fHasWitness;
     const uint256 hash;
+    const unsigned int nBaseSize;  //!< serialized size without witness data
+    const unsigned int nTotalSize; //!< serialized size with witness data
+    const unsigned int nLegacySigOps;
+    const bool fHasAssetOutputs;
+    const bool fHasNullAssetOutputs;
 
+    bool ComputeHasWitness() const;
     uint256 ComputeHash() const;
+    unsigned int ComputeLegacySigOps() const;
+    bool ComputeHasAssetOutputs() const;
+    bool ComputeHasNullAssetOutputs() const;
 
 public:
     /** Construct a CTransaction that qualifies as IsNull() */
@@ -365,7 +377,19 @@ public:
      * "Total Size" defined in BIP141 and BIP144.
      * @return Total transaction size in bytes
      */
-    unsigned int GetTotalSize() const;
+    unsigned int GetTotalSize() const { return nTotalSize; }
+
+    /** Serialized size without witness data, as in the txid */
+    unsigned int GetBaseSize() const { return nBaseSize; }
+
+    /** Signature operations in the scripts of the inputs and outputs, see GetLegacySigOpCount */
+    unsigned int GetLegacySigOpCount() const { return nLegacySigOps; }
+
+    /** Whether any output is an asset script */
+    bool HasAssetOutputs() const { return fHasAssetOutputs; }
+
+    /** Whether any output is a null asset data script */
+    bool HasNullAssetOutputs() const { return fHasNullAssetOutputs; }
 
     bool IsCoinBase() const
     {
@@ -386,12 +410,7 @@ public:
 
     bool HasWitness() const
     {
-        for (size_t i = 0; i < vin.size(); i++) {
-            if (!vin[i].scriptWitness.IsNull()) {
-                return true;
-            }
-        }
-        return false;
+        return fHasWitness;
     }
 };
 
@@ -449,4 +468,90 @@ typedef std::shared_ptr<const CTransaction> CTransactionRef;
 static inline CTransactionRef MakeTransactionRef() { return std::make_shared<const CTransaction>(); }
 template <typename Tx> static inline CTransactionRef MakeTransactionRef(Tx&& txIn) { return std::make_shared<const CTransaction>(std::forward<Tx>(txIn)); }
 
+/**
+ * Memory for the transactions of a block being deserialized. Each
+ * transaction and its shared_ptr control block are carved out of a chunk,
+ * so a block costs one allocation per few dozen transactions instead of one
+ * each. Every transaction keeps its chunk alive and the chunk is freed with
+ * the last of them, so transactions that outlive their block, in the mempool
+ * or a wallet, stay valid and hold on to one small chunk at most.
+ */
+class CTxChunk
+{
+public:
+    static const size_t CHUNK_SIZE = 4096;
+    //! room taken by a transaction and its control block, with some to spare
+    static const size_t TX_SLOT_SIZE = sizeof(CTransaction) + 64;
+
+    /** Memory from the chunk, or nullptr when it has no room left */
+    void* Allocate(size_t nSize, size_t nAlign);
+    bool Contains(const void* p) const { return p >= vBuffer && p < vBuffer + CHUNK_SIZE; }
+    bool HasRoomForTransaction() const { return nUsed + TX_SLOT_SIZE <= CHUNK_SIZE; }
+
+private:
+    alignas(std::max_align_t) unsigned char vBuffer[CHUNK_SIZE];
+    size_t nUsed{0};
+};
+
+/** Allocator for std::allocate_shared from a CTxChunk, falling back to the heap when it is full */
+template <typename T>
+class CTxChunkAllocator
+{
+public:
+    typedef T value_type;
+
+    std::shared_ptr<CTxChunk> chunk;
+
+    explicit CTxChunkAllocator(std::shared_ptr<CTxChunk> chunkIn) : chunk(std::move(chunkIn)) {}
+    template <typename U>
+    CTxChunkAllocator(const CTxChunkAllocator<U>& other) : chunk(other.chunk) {}
+
+    T* allocate(size_t n)
+    {
+        void* p = chunk->Allocate(n * sizeof(T), alignof(T));
+        return static_cast<T*>(p ? p : ::operator new(n * sizeof(T)));
+    }
+
+    void deallocate(T* p, size_t)
+    {
+        // Chunk memory goes back all at once, with the chunk
+        if (!chunk->Contains(p))
+            ::operator delete(p);
+    }
+
+    template <typename U>
+    bool operator==(const CTxChunkAllocator<U>& other) const { return chunk == other.chunk; }
+    template <typename U>
+    bool operator!=(const CTxChunkAllocator<U>& other) const { return chunk != other.chunk; }
+};
+
+/** Deserialize a block's transactions, allocating them from shared chunks */
+template <typename Stream>
+void UnserializeBlockTransactions(Stream& s, std::vector<CTransactionRef>& vtx)
+{
+    vtx.clear();
+    const uint64_t nSize = ReadCompactSize(s);
+    // Like vector deserialization, don't trust the count for more than 5MB up front
+    vtx.reserve(std::min<uint64_t>(nSize, 5000000 / sizeof(CTransactionRef)));
+    std::shared_ptr<CTxChunk> chunk;
+    for (uint64_t i = 0; i < nSize; i++) {
+        if (!chunk || !chunk->HasRoomForTransaction())
+            chunk = std::make_shared<CTxChunk>();
+        vtx.push_back(std::allocate_shared<CTransaction>(CTxChunkAllocator<CTransaction>(chunk), deserialize, s));
+    }
+}
+
+/** A block's transactions, written as any vector and read with UnserializeBlockTransactions */
+template <typename Stream>
+inline void SerializeBlockTransactions(Stream& s, std::vector<CTransactionRef>& vtx, CSerActionSerialize)
+{
+    ::Serialize(s, vtx);
+}
+
+template <typename Stream>
+inline void SerializeBlockTransactions(Stream& s, std::vector<CTransactionRef>& vtx, CSerActionUnserialize)
+{
+    UnserializeBlockTransactions(s, vtx);
+}
+
 #endif // MYNTA_PRIMITIVES_TRANSACTION_H
@@ -262,6 +262,58 @@ extern const char *ASSETDATA;
  * @since protocol version 70018.
  */
     extern const char *ASSETNOTFOUND;
+
+/**
+ * Contains batches of LLMQ signature shares (CBatchedSigShares), pushed
+ * unannounced to every peer.
+ */
+extern const char *QSIGSHARES;
+
+/**
+ * Contains a CInstantSendLock, sent in response to a "getdata" for an
+ * MSG_ISLOCK inv.
+ */
+extern const char *ISLOCK;
+
+/**
+ * Contains a CChainLockSig, sent in response to a "getdata" for an
+ * MSG_CLSIG inv.
+ */
+extern const char *CLSIG;
+
+/**
+ * getcfilters requests the compact filters of a range of blocks, as BIP157
+ * defines it. Only sent to peers advertising NODE_COMPACT_FILTERS.
+ */
+extern const char *GETCFILTERS;
+
+/**
+ * cfilter holds the compact filter of one block, sent in response to
+ * getcfilters.
+ */
+extern const char *CFILTER;
+
+/**
+ * getcfheaders requests the compact filter headers of a range of blocks.
+ */
+extern const char *GETCFHEADERS;
+
+/**
+ * cfheaders holds the filter hashes of a range of blocks and the filter
+ * header before them, sent in response to getcfheaders.
+ */
+extern const char *CFHEADERS;
+
+/**
+ * getcfcheckpt requests the filter headers at every 1000th block up to a
+ * stop block.
+ */
+extern const char *GETCFCHECKPT;
+
+/**
+ * cfcheckpt holds the filter headers requested by getcfcheckpt.
+ */
+extern const char *CFCHECKPT;
 };
 
 /* Get a vector of all valid message types (see above) */
@@ -289,6 +341,9 @@ enum ServiceFlags : uint64_t {
     // NODE_XTHIN means the node supports Xtreme Thinblocks
     // If this is turned off then the node will not service nor make xthin requests
     NODE_XTHIN = (1 << 4),
+    // NODE_COMPACT_FILTERS means the node will serve basic block filters
+    // (BIP157 and BIP158) with getcfilters, getcfheaders and getcfcheckpt.
+    NODE_COMPACT_FILTERS = (1 << 6),
 
     // Bits 24-31 are reserved for temporary experiments. Just pick a bit that
     // isn't getting used, or one not being used much, and notify the
@@ -391,6 +446,9 @@ enum GetDataMsg
     MSG_WITNESS_BLOCK = MSG_BLOCK | MSG_WITNESS_FLAG, //!< Defined in BIP144
     MSG_WITNESS_TX = MSG_TX | MSG_WITNESS_FLAG,       //!< Defined in BIP144
     MSG_FILTERED_WITNESS_BLOCK = MSG_FILTERED_BLOCK | MSG_WITNESS_FLAG,
+    // LLMQ messages, announced in invs as well
+    MSG_CLSIG = 29,
+    MSG_ISLOCK = 30,
 };
 
 /** inv message data */
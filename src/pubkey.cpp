@@ -5,13 +5,68 @@
 
 #include "pubkey.h"
 
+#include "crypto/common.h"
+
 #include <secp256k1.h>
 #include <secp256k1_recovery.h>
 
+#include <array>
+#include <memory>
+#include <string.h>
+
 namespace
 {
 /* Global secp256k1_context object used for verification. */
 secp256k1_context* secp256k1_context_verify = nullptr;
+
+/**
+ * Public keys this thread parsed recently. Parsing a compressed key takes a
+ * square root, and blocks paying out to the same addresses over and over
+ * spend outputs locked to the same keys many times, so every script check
+ * thread keeps the parsed form of the keys it saw last. Slots are picked by
+ * the first bytes of the X coordinate and hold the whole serialized key, so
+ * a collision only costs a parse.
+ */
+class CParsedPubKeyCache
+{
+private:
+    static const size_t CACHE_SLOTS = 1024;
+
+    struct Slot {
+        unsigned int nSize{0};
+        //! Serialized key, 65 bytes when uncompressed
+        unsigned char vch[65];
+        secp256k1_pubkey pubkey;
+    };
+    std::array<Slot, CACHE_SLOTS> slots;
+
+public:
+    bool Parse(const CPubKey& key, secp256k1_pubkey& pubkey)
+    {
+        const unsigned char* vch = key.begin();
+        unsigned int nSize = key.size();
+        Slot& slot = slots[ReadLE32(vch + 1) % CACHE_SLOTS];
+        if (slot.nSize == nSize && memcmp(slot.vch, vch, nSize) == 0) {
+            pubkey = slot.pubkey;
+            return true;
+        }
+        if (!secp256k1_ec_pubkey_parse(secp256k1_context_verify, &pubkey, vch, nSize))
+            return false;
+        slot.nSize = nSize;
+        memcpy(slot.vch, vch, nSize);
+        slot.pubkey = pubkey;
+        return true;
+    }
+};
+
+bool ParsePubKeyCached(const CPubKey& key, secp256k1_pubkey& pubkey)
+{
+    // Allocated on first use, so threads that never verify don't pay for it
+    static thread_local std::unique_ptr<CParsedPubKeyCache> cache;
+    if (!cache)
+        cache.reset(new CParsedPubKeyCache());
+    return cache->Parse(key, pubkey);
+}
 } // namespace
 
 /** This function is taken from the libsecp256k1 distribution and implements
@@ -169,7 +224,7 @@ bool CPubKey::Verify(const uint256 &hash, const std::vector<unsigned char>& vchS
         return false;
     secp256k1_pubkey pubkey;
     secp256k1_ecdsa_signature sig;
-    if (!secp256k1_ec_pubkey_parse(secp256k1_context_verify, &pubkey, &(*this)[0], size())) {
+    if (!ParsePubKeyCached(*this, pubkey)) {
         return false;
     }
     if (!ecdsa_signature_parse_der_lax(secp256k1_context_verify, &sig, vchSig.data(), vchSig.size())) {
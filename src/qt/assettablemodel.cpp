@@ -21,12 +21,23 @@
 #include <QDebug>
 #include <QStringList>
 
+#include <boost/bind/bind.hpp>
 
+using namespace boost::placeholders;
+
+
+//! What a row shows of an asset besides its balance
+struct AssetTableMeta
+{
+    uint8_t units;
+    std::string ipfsHash;
+};
 
 class AssetTablePriv {
 public:
     AssetTablePriv(AssetTableModel *_parent) :
-            parent(_parent)
+            parent(_parent),
+            fRefreshAll(true)
     {
     }
 
@@ -34,63 +45,111 @@ public:
 
     QList<AssetRecord> cachedBalances;
 
-    // loads all current balances into cache
+    //! Metadata of the assets seen so far, so a refresh only looks up new or reissued ones
+    std::map<std::string, AssetTableMeta> mapMeta;
+    //! Assets a wallet transaction touched since the last refresh
+    std::set<std::string> setDirty;
+    //! Whether the next refresh must happen whatever is dirty (first load, transaction deleted)
+    bool fRefreshAll;
+
 #ifdef ENABLE_WALLET
-    void refreshWallet() {
-        qDebug() << "AssetTablePriv::refreshWallet";
-        cachedBalances.clear();
+    // the rows the table should show now, sorted by name; false if they can't be read
+    bool readBalances(QList<AssetRecord>& records) {
         auto currentActiveAssetCache = GetCurrentAssetCache();
-        if (currentActiveAssetCache) {
-            {
-                LOCK(cs_main);
-                std::map<std::string, CAmount> balances;
-                std::map<std::string, std::vector<COutput> > outputs;
-                if (!GetAllMyAssetBalances(outputs, balances)) {
-                    qWarning("AssetTablePriv::refreshWallet: Error retrieving asset balances");
-                    return;
-                }
-                std::set<std::string> setAssetsToSkip;
-                auto bal = balances.begin();
-                for (; bal != balances.end(); bal++) {
-                    // retrieve units for asset
-                    uint8_t units = OWNER_UNITS;
-                    bool fIsAdministrator = true;
-                    std::string ipfsHash = "";
-
-                    if (setAssetsToSkip.count(bal->first))
-                        continue;
-
-                    if (!IsAssetNameAnOwner(bal->first)) {
-                        // Asset is not an administrator asset
-                        CNewAsset assetData;
-                        if (!currentActiveAssetCache->GetAssetMetaDataIfExists(bal->first, assetData)) {
-                            qWarning("AssetTablePriv::refreshWallet: Error retrieving asset data");
-                            return;
-                        }
-                        units = assetData.units;
-                        ipfsHash = assetData.strIPFSHash;
-                        // If we have the administrator asset, add it to the skip listå
-                        if (balances.count(bal->first + OWNER_TAG)) {
-                            setAssetsToSkip.insert(bal->first + OWNER_TAG);
-                        } else {
-                            fIsAdministrator = false;
-                        }
-                    } else {
-                        // Asset is an administrator asset, if we own assets that is administrators, skip this balance
-                        std::string name = bal->first;
-                        name.pop_back();
-                        if (balances.count(name)) {
-                            setAssetsToSkip.insert(bal->first);
-                            continue;
-                        }
+        if (!currentActiveAssetCache)
+            return false;
+
+        LOCK(cs_main);
+        std::map<std::string, CAmount> balances;
+        std::map<std::string, std::vector<COutput> > outputs;
+        if (!GetAllMyAssetBalances(outputs, balances)) {
+            qWarning("AssetTablePriv::readBalances: Error retrieving asset balances");
+            return false;
+        }
+        std::set<std::string> setAssetsToSkip;
+        auto bal = balances.begin();
+        for (; bal != balances.end(); bal++) {
+            // retrieve units for asset
+            uint8_t units = OWNER_UNITS;
+            bool fIsAdministrator = true;
+            std::string ipfsHash = "";
+
+            if (setAssetsToSkip.count(bal->first))
+                continue;
+
+            if (!IsAssetNameAnOwner(bal->first)) {
+                // Asset is not an administrator asset
+                auto itMeta = mapMeta.find(bal->first);
+                if (itMeta == mapMeta.end()) {
+                    CNewAsset assetData;
+                    if (!currentActiveAssetCache->GetAssetMetaDataIfExists(bal->first, assetData)) {
+                        qWarning("AssetTablePriv::readBalances: Error retrieving asset data");
+                        return false;
                     }
-                    cachedBalances.append(AssetRecord(bal->first, bal->second, units, fIsAdministrator, EncodeAssetData(ipfsHash)));
+                    itMeta = mapMeta.emplace(bal->first, AssetTableMeta{(uint8_t)assetData.units, assetData.strIPFSHash}).first;
+                }
+                units = itMeta->second.units;
+                ipfsHash = itMeta->second.ipfsHash;
+                // If we have the administrator asset, add it to the skip list
+                if (balances.count(bal->first + OWNER_TAG)) {
+                    setAssetsToSkip.insert(bal->first + OWNER_TAG);
+                } else {
+                    fIsAdministrator = false;
+                }
+            } else {
+                // Asset is an administrator asset, if we own assets that is administrators, skip this balance
+                std::string name = bal->first;
+                name.pop_back();
+                if (balances.count(name)) {
+                    setAssetsToSkip.insert(bal->first);
+                    continue;
                 }
             }
+            records.append(AssetRecord(bal->first, bal->second, units, fIsAdministrator, EncodeAssetData(ipfsHash)));
         }
+        return true;
     }
-#endif
 
+    // brings the cache up to date if a transaction touched an asset, signalling only the rows that changed
+    void refreshWallet() {
+        if (!fRefreshAll && setDirty.empty())
+            return;
+        qDebug() << "AssetTablePriv::refreshWallet";
+
+        QList<AssetRecord> records;
+        if (!readBalances(records))
+            return;
+        fRefreshAll = false;
+        setDirty.clear();
+
+        // Both lists are sorted by name, so walk them together
+        int row = 0;
+        int i = 0;
+        while (row < cachedBalances.size() || i < records.size()) {
+            if (i == records.size() || (row < cachedBalances.size() && cachedBalances[row].name < records[i].name)) {
+                parent->beginRemoveRows(QModelIndex(), row, row);
+                cachedBalances.removeAt(row);
+                parent->endRemoveRows();
+            } else if (row == cachedBalances.size() || records[i].name < cachedBalances[row].name) {
+                parent->beginInsertRows(QModelIndex(), row, row);
+                cachedBalances.insert(row, records[i]);
+                parent->endInsertRows();
+                row++;
+                i++;
+            } else {
+                const AssetRecord& rec = records[i];
+                AssetRecord& cached = cachedBalances[row];
+                if (cached.quantity != rec.quantity || cached.units != rec.units ||
+                    cached.fIsAdministrator != rec.fIsAdministrator || cached.ipfshash != rec.ipfshash) {
+                    cached = rec;
+                    Q_EMIT parent->dataChanged(parent->index(row, 0), parent->index(row, parent->columns.length() - 1));
+                }
+                row++;
+                i++;
+            }
+        }
+    }
+#endif
 
     int size() {
         return cachedBalances.size();
@@ -114,22 +173,77 @@ AssetTableModel::AssetTableModel(WalletModel *parent) :
 #ifdef ENABLE_WALLET
     priv->refreshWallet();
 #endif
+    subscribeToCoreSignals();
 };
 
 AssetTableModel::~AssetTableModel()
 {
+    unsubscribeFromCoreSignals();
     delete priv;
 };
 
 void AssetTableModel::checkBalanceChanged() {
-    qDebug() << "AssetTableModel::CheckBalanceChanged";
-    // TODO: optimize by 1) updating cache incrementally; and 2) emitting more specific dataChanged signals
-    Q_EMIT layoutAboutToBeChanged();
 #ifdef ENABLE_WALLET
     priv->refreshWallet();
 #endif
-    Q_EMIT dataChanged(index(0, 0, QModelIndex()), index(priv->size(), columns.length()-1, QModelIndex()));
-    Q_EMIT layoutChanged();
+}
+
+void AssetTableModel::updateAsset(const QString &name)
+{
+    if (name.isEmpty()) {
+        priv->fRefreshAll = true;
+        return;
+    }
+
+    std::string strName = name.toStdString();
+    priv->setDirty.insert(strName);
+    // Moving the owner token is how an asset is reissued, so its metadata may be stale
+    if (IsAssetNameAnOwner(strName))
+        strName.pop_back();
+    priv->mapMeta.erase(strName);
+}
+
+static void NotifyAssetsChanged(AssetTableModel *assettablemodel, CWallet *wallet, const uint256 &hash, ChangeType status)
+{
+    // Called with cs_wallet held, from whichever thread changed the wallet
+    auto mi = wallet->mapWallet.find(hash);
+    if (mi == wallet->mapWallet.end()) {
+        // Gone from the wallet, with nothing left to say what it held
+        QMetaObject::invokeMethod(assettablemodel, "updateAsset", Qt::QueuedConnection, Q_ARG(QString, QString()));
+        return;
+    }
+
+    // The assets it pays, and those of the wallet's outputs it spends
+    std::set<std::string> setNames;
+    std::string strName;
+    CAmount nAmount;
+    const CTransaction& tx = *mi->second.tx;
+    for (const CTxOut& txout : tx.vout) {
+        if (GetAssetInfoFromScript(txout.scriptPubKey, strName, nAmount))
+            setNames.insert(strName);
+    }
+    for (const CTxIn& txin : tx.vin) {
+        auto prev = wallet->mapWallet.find(txin.prevout.hash);
+        if (prev == wallet->mapWallet.end() || txin.prevout.n >= prev->second.tx->vout.size())
+            continue;
+        if (GetAssetInfoFromScript(prev->second.tx->vout[txin.prevout.n].scriptPubKey, strName, nAmount))
+            setNames.insert(strName);
+    }
+
+    for (const std::string& name : setNames)
+        QMetaObject::invokeMethod(assettablemodel, "updateAsset", Qt::QueuedConnection, Q_ARG(QString, QString::fromStdString(name)));
+}
+
+void AssetTableModel::subscribeToCoreSignals()
+{
+    // Connect signals to wallet
+    walletModel->getWallet()->NotifyTransactionChanged.connect(boost::bind(NotifyAssetsChanged, this, _1, _2, _3));
+}
+
+void AssetTableModel::unsubscribeFromCoreSignals()
+{
+    // Disconnect signals from wallet
+    walletModel->getWallet()->NotifyTransactionChanged.disconnect(boost::bind(NotifyAssetsChanged, this, _1, _2, _3));
 }
 
 int AssetTableModel::rowCount(const QModelIndex &parent) const
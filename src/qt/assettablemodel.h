@@ -60,6 +60,7 @@ public:
     QString formatAssetName(const AssetRecord *wtx) const;
     QString formatAssetQuantity(const AssetRecord *wtx) const;
 
+    /** Bring the rows up to date with the wallet, if a transaction touched an asset since the last call */
     void checkBalanceChanged();
 
 private:
@@ -67,6 +68,13 @@ private:
     QStringList columns;
     AssetTablePriv *priv;
 
+    void subscribeToCoreSignals();
+    void unsubscribeFromCoreSignals();
+
+private Q_SLOTS:
+    /* A wallet transaction touched asset name; an empty name means any asset */
+    void updateAsset(const QString &name);
+
     friend class AssetTablePriv;
 };
 
@@ -105,6 +105,9 @@ static const bool DEFAULT_SPLASHSCREEN = true;
  */
 static const int TOOLTIP_WRAP_THRESHOLD = 80;
 
+/* Wallet transactions the transaction table loads at a time, newest first, as it is scrolled */
+static const int TRANSACTION_TABLE_FETCH_SIZE = 1000;
+
 /* Maximum allowed URI length */
 static const int MAX_URI_LENGTH = 255;
 
@@ -27,6 +27,8 @@
 #include <QIcon>
 #include <QList>
 
+#include <limits>
+
 // Fixing Boost 1.73 compile errors
 #include <boost/bind/bind.hpp>
 using namespace boost::placeholders;
@@ -42,55 +44,86 @@ static int column_alignments[] = {
         Qt::AlignLeft|Qt::AlignVCenter /* assetName */
     };
 
-// Comparison operator for sort/binary search of model tx list
-struct TxLessThan
-{
-    bool operator()(const TransactionRecord &a, const TransactionRecord &b) const
-    {
-        return a.hash < b.hash;
-    }
-    bool operator()(const TransactionRecord &a, const uint256 &b) const
-    {
-        return a.hash < b;
-    }
-    bool operator()(const uint256 &a, const TransactionRecord &b) const
-    {
-        return a < b.hash;
-    }
-};
-
 // Private implementation
 class TransactionTablePriv
 {
 public:
     TransactionTablePriv(CWallet *_wallet, TransactionTableModel *_parent) :
         wallet(_wallet),
-        parent(_parent)
+        parent(_parent),
+        nFetchedFrom(std::numeric_limits<int64_t>::max()),
+        fFetchedAll(false)
     {
     }
 
     CWallet *wallet;
     TransactionTableModel *parent;
 
-    /* Local cache of wallet.
-     * As it is in the same order as the CWallet, by definition
-     * this is sorted by sha256.
+    /* Local cache of wallet, in the order it was loaded: pages of the
+     * wallet's ordered transaction list, newest first, followed by the
+     * transactions that came in since. The rows of a transaction are
+     * contiguous, and mapRows holds where they start and end.
      */
     QList<TransactionRecord> cachedWallet;
+    std::map<uint256, std::pair<int, int> > mapRows;
+    /* Order position (see CWalletTx::nOrderPos) of the oldest transaction
+     * loaded; the ones before it are only loaded once the view scrolls to them.
+     */
+    int64_t nFetchedFrom;
+    bool fFetchedAll;
 
-    /* Query entire wallet anew from core.
+    void append(const QList<TransactionRecord> &records)
+    {
+        for (const TransactionRecord &rec : records)
+        {
+            auto it = mapRows.emplace(rec.hash, std::make_pair(cachedWallet.size(), cachedWallet.size())).first;
+            it->second.second++;
+            cachedWallet.append(rec);
+        }
+    }
+
+    /* Load the first page of the wallet from core.
      */
     void refreshWallet()
     {
         qDebug() << "TransactionTablePriv::refreshWallet";
-        cachedWallet.clear();
+        fetch(TRANSACTION_TABLE_FETCH_SIZE);
+    }
+
+    /* Load up to nMaxTransactions of the transactions older than those
+       loaded so far, and add their rows at the end.
+     */
+    void fetch(int nMaxTransactions)
+    {
+        QList<TransactionRecord> fetched;
         {
             LOCK2(cs_main, wallet->cs_wallet);
-            for(std::map<uint256, CWalletTx>::iterator it = wallet->mapWallet.begin(); it != wallet->mapWallet.end(); ++it)
+            int nTransactions = 0;
+            CWallet::TxItems::const_iterator it = wallet->wtxOrdered.lower_bound(nFetchedFrom);
+            while (it != wallet->wtxOrdered.begin())
             {
-                if(TransactionRecord::showTransaction(it->second))
-                    cachedWallet.append(TransactionRecord::decomposeTransaction(wallet, it->second));
+                --it;
+                // Only stop between order positions, so that none is loaded in part
+                if (nTransactions >= nMaxTransactions && it->first != nFetchedFrom)
+                {
+                    ++it;
+                    break;
+                }
+                nFetchedFrom = it->first;
+                const CWalletTx *wtx = it->second.first;
+                if (!wtx || mapRows.count(wtx->GetHash()) || !TransactionRecord::showTransaction(*wtx))
+                    continue;
+                fetched.append(TransactionRecord::decomposeTransaction(wallet, *wtx));
+                nTransactions++;
             }
+            fFetchedAll = (it == wallet->wtxOrdered.begin());
+        }
+
+        if (!fetched.isEmpty())
+        {
+            parent->beginInsertRows(QModelIndex(), cachedWallet.size(), cachedWallet.size() + fetched.size() - 1);
+            append(fetched);
+            parent->endInsertRows();
         }
     }
 
@@ -104,13 +137,10 @@ public:
         qDebug() << "TransactionTablePriv::updateWallet: " + QString::fromStdString(hash.ToString()) + " " + QString::number(status);
 
         // Find bounds of this transaction in model
-        QList<TransactionRecord>::iterator lower = std::lower_bound(
-            cachedWallet.begin(), cachedWallet.end(), hash, TxLessThan());
-        QList<TransactionRecord>::iterator upper = std::upper_bound(
-            cachedWallet.begin(), cachedWallet.end(), hash, TxLessThan());
-        int lowerIndex = (lower - cachedWallet.begin());
-        int upperIndex = (upper - cachedWallet.begin());
-        bool inModel = (lower != upper);
+        auto itRows = mapRows.find(hash);
+        bool inModel = (itRows != mapRows.end());
+        int lowerIndex = inModel ? itRows->second.first : cachedWallet.size();
+        int upperIndex = inModel ? itRows->second.second : cachedWallet.size();
 
         if(status == CT_UPDATED)
         {
@@ -142,18 +172,16 @@ public:
                     qWarning() << "TransactionTablePriv::updateWallet: Warning: Got CT_NEW, but transaction is not in wallet";
                     break;
                 }
-                // Added -- insert at the right position
+                // Not loaded yet -- it comes with its page
+                if(!fFetchedAll && mi->second.nOrderPos < nFetchedFrom)
+                    break;
+                // Added -- insert at the end
                 QList<TransactionRecord> toInsert =
                         TransactionRecord::decomposeTransaction(wallet, mi->second);
                 if(!toInsert.isEmpty()) /* only if something to insert */
                 {
                     parent->beginInsertRows(QModelIndex(), lowerIndex, lowerIndex+toInsert.size()-1);
-                    int insert_idx = lowerIndex;
-                    for (const TransactionRecord &rec : toInsert)
-                    {
-                        cachedWallet.insert(insert_idx, rec);
-                        insert_idx += 1;
-                    }
+                    append(toInsert);
                     parent->endInsertRows();
                 }
             }
@@ -166,16 +194,26 @@ public:
             }
             // Removed -- remove entire transaction from table
             parent->beginRemoveRows(QModelIndex(), lowerIndex, upperIndex-1);
-            cachedWallet.erase(lower, upper);
+            cachedWallet.erase(cachedWallet.begin() + lowerIndex, cachedWallet.begin() + upperIndex);
+            mapRows.erase(itRows);
+            for (auto &rows : mapRows)
+            {
+                if (rows.second.first >= upperIndex)
+                {
+                    rows.second.first -= upperIndex - lowerIndex;
+                    rows.second.second -= upperIndex - lowerIndex;
+                }
+            }
             parent->endRemoveRows();
             break;
         case CT_UPDATED:
-            // Miscellaneous updates -- nothing to do, status update will take care of this, and is only computed for
-            // visible transactions.
+            // Miscellaneous updates -- the status is recomputed when the rows are next shown
             for (int i = lowerIndex; i < upperIndex; i++) {
                 TransactionRecord *rec = &cachedWallet[i];
                 rec->status.needsUpdate = true;
             }
+            if(inModel)
+                Q_EMIT parent->dataChanged(parent->index(lowerIndex, 0), parent->index(upperIndex-1, parent->columns.length()-1));
             break;
         }
     }
@@ -285,10 +323,36 @@ void TransactionTableModel::updateConfirmations()
 {
     // Blocks came in since last poll.
     // Invalidate status (number of confirmations) and (possibly) description
-    //  for all rows. Qt is smart enough to only actually request the data for the
-    //  visible rows.
-    Q_EMIT dataChanged(index(0, Status), index(priv->size()-1, Status));
-    Q_EMIT dataChanged(index(0, ToAddress), index(priv->size()-1, ToAddress));
+    //  for the rows whose status still changes with every block. A confirmed
+    //  row looks the same whatever its depth, and its status is brought up to
+    //  date when it is next shown (see TransactionTablePriv::index); a reorg
+    //  reaches it through updateTransaction.
+    int firstChanging = -1;
+    for (int i = 0; i <= priv->size(); i++)
+    {
+        bool fChanging = i < priv->size() && priv->cachedWallet[i].status.status != TransactionStatus::Confirmed;
+        if (fChanging && firstChanging < 0)
+        {
+            firstChanging = i;
+        }
+        else if (!fChanging && firstChanging >= 0)
+        {
+            Q_EMIT dataChanged(index(firstChanging, Status), index(i-1, Status));
+            Q_EMIT dataChanged(index(firstChanging, ToAddress), index(i-1, ToAddress));
+            firstChanging = -1;
+        }
+    }
+}
+
+bool TransactionTableModel::canFetchMore(const QModelIndex &parent) const
+{
+    return !parent.isValid() && !priv->fFetchedAll;
+}
+
+void TransactionTableModel::fetchMore(const QModelIndex &parent)
+{
+    if (!parent.isValid())
+        priv->fetch(TRANSACTION_TABLE_FETCH_SIZE);
 }
 
 int TransactionTableModel::rowCount(const QModelIndex &parent) const
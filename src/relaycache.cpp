@@ -0,0 +1,68 @@
+// Copyright (c) 2026 The Mynta Core Developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include "relaycache.h"
+
+#include "memusage.h"
+
+size_t CRelayMessageCache::MessageUsage(const CSharedNetMsg& msg)
+{
+    size_t nUsage = sizeof(List::value_type) + 4 * sizeof(void*) + msg.command.capacity();
+    if (msg.header)
+        nUsage += memusage::DynamicUsage(*msg.header);
+    if (msg.data)
+        nUsage += memusage::DynamicUsage(*msg.data);
+    return nUsage;
+}
+
+bool CRelayMessageCache::Get(const uint256& hash, bool fWitness, CSharedNetMsg& msg)
+{
+    std::lock_guard<std::mutex> lock(cs);
+    auto it = index.find(Key(hash, fWitness));
+    if (it == index.end())
+        return false;
+    lru.splice(lru.begin(), lru, it->second);
+    msg = it->second->second;
+    return true;
+}
+
+void CRelayMessageCache::Put(const uint256& hash, bool fWitness, const CSharedNetMsg& msg)
+{
+    size_t nMsgUsage = MessageUsage(msg);
+    if (nMsgUsage > nMaxUsage)
+        return;
+
+    std::lock_guard<std::mutex> lock(cs);
+    Key key(hash, fWitness);
+    if (index.count(key))
+        return;
+    while (!lru.empty() && nUsage + nMsgUsage > nMaxUsage) {
+        nUsage -= MessageUsage(lru.back().second);
+        index.erase(lru.back().first);
+        lru.pop_back();
+    }
+    lru.emplace_front(key, msg);
+    index.emplace(key, lru.begin());
+    nUsage += nMsgUsage;
+}
+
+void CRelayMessageCache::Clear()
+{
+    std::lock_guard<std::mutex> lock(cs);
+    lru.clear();
+    index.clear();
+    nUsage = 0;
+}
+
+size_t CRelayMessageCache::size() const
+{
+    std::lock_guard<std::mutex> lock(cs);
+    return lru.size();
+}
+
+size_t CRelayMessageCache::GetUsage() const
+{
+    std::lock_guard<std::mutex> lock(cs);
+    return nUsage;
+}
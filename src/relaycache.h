@@ -0,0 +1,55 @@
+// Copyright (c) 2026 The Mynta Core Developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#ifndef MYNTA_RELAYCACHE_H
+#define MYNTA_RELAYCACHE_H
+
+#include "net.h"
+#include "uint256.h"
+
+#include <list>
+#include <map>
+#include <mutex>
+#include <utility>
+
+/** Bytes of serialized BLOCK messages kept for peers asking for recent blocks */
+static const size_t DEFAULT_BLOCK_RELAY_CACHE_SIZE = 32 << 20;
+/** Bytes of serialized TX messages kept for peers asking for relayed transactions */
+static const size_t DEFAULT_TX_RELAY_CACHE_SIZE = 8 << 20;
+/** Only blocks this close to the tip are put in the block relay cache */
+static const int RELAY_CACHE_BLOCK_DEPTH = 6;
+
+/**
+ * Size bounded LRU cache of serialized BLOCK or TX messages, keyed by hash and
+ * whether witnesses are included. A block or transaction that many peers ask
+ * for is serialized once; everyone after the first gets the same buffers (see
+ * CSharedNetMsg). Callers key transactions by wtxid so a cached message never
+ * holds a different witness than the transaction being answered for.
+ */
+class CRelayMessageCache
+{
+    typedef std::pair<uint256, bool> Key;
+    typedef std::list<std::pair<Key, CSharedNetMsg>> List;
+
+    mutable std::mutex cs;
+    List lru; // most recently used first
+    std::map<Key, List::iterator> index;
+    size_t nUsage{0};
+    size_t nMaxUsage;
+
+    static size_t MessageUsage(const CSharedNetMsg& msg);
+
+public:
+    explicit CRelayMessageCache(size_t nMaxUsageIn) : nMaxUsage(nMaxUsageIn) {}
+
+    bool Get(const uint256& hash, bool fWitness, CSharedNetMsg& msg);
+    //! Add msg, evicting the least recently used entries to make room; messages bigger than the whole cache are skipped
+    void Put(const uint256& hash, bool fWitness, const CSharedNetMsg& msg);
+    void Clear();
+
+    size_t size() const;
+    size_t GetUsage() const;
+};
+
+#endif // MYNTA_RELAYCACHE_H
@@ -4,10 +4,15 @@
 // Distributed under the MIT software license, see the accompanying
 // file COPYING or http://www.opensource.org/licenses/mit-license.php.
 
+#include "assets/assetdb.h"
+#include "assets/assets.h"
+#include "base58.h"
+#include "blockfilterindex.h"
 #include "chain.h"
 #include "chainparams.h"
 #include "core_io.h"
 #include "primitives/block.h"
+#include "primitives/blockview.h"
 #include "primitives/transaction.h"
 #include "validation.h"
 #include "httpserver.h"
@@ -24,6 +29,8 @@
 #include <univalue.h>
 
 static const size_t MAX_GETUTXOS_OUTPOINTS = 15; //allow a max of 15 outpoints to be queried at once
+static const size_t MAX_REST_TXS = 100; //most transactions returned by one /rest/tx/ request
+static const size_t MAX_REST_ASSET_ADDRESSES = 50000; //most holders returned by one /rest/asset/addresses/ request
 
 enum RetFormat {
     RF_UNDEF,
@@ -208,6 +215,10 @@ static bool rest_block(HTTPRequest* req,
 
     CBlock block;
     CBlockIndex* pblockindex = nullptr;
+    // Everything except the detailed JSON can be served from the bytes on disk
+    const bool fRaw = rf == RF_JSON ? !showTxDetails : RPCSerializationFlags() == 0;
+    std::vector<unsigned char> vBlockData;
+    CBlockView view;
     {
         LOCK(cs_main);
         if (mapBlockIndex.count(hash) == 0)
@@ -217,10 +228,46 @@ static bool rest_block(HTTPRequest* req,
         if (fHavePruned && !(pblockindex->nStatus & BLOCK_HAVE_DATA) && pblockindex->nTx > 0)
             return RESTERR(req, HTTP_NOT_FOUND, hashStr + " not available (pruned data)");
 
-        if (!ReadBlockFromDisk(block, pblockindex, GetParams().GetConsensus()))
+        if (fRaw) {
+            if (!ReadBlockViewFromDisk(view, vBlockData, pblockindex, GetParams().MessageStart()))
+                return RESTERR(req, HTTP_NOT_FOUND, hashStr + " not found");
+        } else if (!ReadBlockFromDisk(block, pblockindex, GetParams().GetConsensus()))
             return RESTERR(req, HTTP_NOT_FOUND, hashStr + " not found");
     }
 
+    if (fRaw) {
+        switch (rf) {
+        case RF_BINARY: {
+            req->WriteHeader("Content-Type", "application/octet-stream");
+            req->WriteReply(HTTP_OK, std::string(vBlockData.begin(), vBlockData.end()));
+            return true;
+        }
+
+        case RF_HEX: {
+            std::string strHex = HexStr(vBlockData.begin(), vBlockData.end()) + "\n";
+            req->WriteHeader("Content-Type", "text/plain");
+            req->WriteReply(HTTP_OK, strHex);
+            return true;
+        }
+
+        case RF_JSON: {
+            std::string strJSON;
+            {
+                // blockViewToJSON looks at chainActive
+                LOCK(cs_main);
+                strJSON = blockViewToJSON(view, pblockindex).write() + "\n";
+            }
+            req->WriteHeader("Content-Type", "application/json");
+            req->WriteReply(HTTP_OK, strJSON);
+            return true;
+        }
+
+        default: {
+            return RESTERR(req, HTTP_NOT_FOUND, "output format not found (available: " + AvailableDataFormatsString() + ")");
+        }
+        }
+    }
+
     CDataStream ssBlock(SER_NETWORK, PROTOCOL_VERSION | RPCSerializationFlags());
     ssBlock << block;
 
@@ -337,23 +384,33 @@ static bool rest_tx(HTTPRequest* req, const std::string& strURIPart)
 {
     if (!CheckWarmup(req))
         return false;
-    std::string hashStr;
-    const RetFormat rf = ParseDataFormat(hashStr, strURIPart);
-
-    uint256 hash;
-    if (!ParseHashStr(hashStr, hash))
-        return RESTERR(req, HTTP_BAD_REQUEST, "Invalid hash: " + hashStr);
+    std::string param;
+    const RetFormat rf = ParseDataFormat(param, strURIPart);
 
-    CTransactionRef tx;
-    uint256 hashBlock = uint256();
-    if (!GetTransaction(hash, tx, GetParams().GetConsensus(), hashBlock, true))
-        return RESTERR(req, HTTP_NOT_FOUND, hashStr + " not found");
+    // One hash, or several separated by '/', looked up together
+    std::vector<std::string> vHashStr;
+    boost::split(vHashStr, param, boost::is_any_of("/"));
+    if (vHashStr.size() > MAX_REST_TXS)
+        return RESTERR(req, HTTP_BAD_REQUEST, strprintf("Error: max transactions exceeded (max: %d, tried: %d)", MAX_REST_TXS, vHashStr.size()));
+    std::vector<uint256> vHash(vHashStr.size());
+    for (size_t i = 0; i < vHashStr.size(); i++) {
+        if (!ParseHashStr(vHashStr[i], vHash[i]))
+            return RESTERR(req, HTTP_BAD_REQUEST, "Invalid hash: " + vHashStr[i]);
+    }
 
-    CDataStream ssTx(SER_NETWORK, PROTOCOL_VERSION | RPCSerializationFlags());
-    ssTx << tx;
+    std::vector<CTransactionRef> vtx;
+    std::vector<uint256> vHashBlock;
+    GetTransactions(vHash, vtx, vHashBlock, GetParams().GetConsensus(), true);
+    for (size_t i = 0; i < vtx.size(); i++) {
+        if (!vtx[i])
+            return RESTERR(req, HTTP_NOT_FOUND, vHashStr[i] + " not found");
+    }
 
     switch (rf) {
     case RF_BINARY: {
+        CDataStream ssTx(SER_NETWORK, PROTOCOL_VERSION | RPCSerializationFlags());
+        for (const CTransactionRef& tx : vtx)
+            ssTx << tx;
         std::string binaryTx = ssTx.str();
         req->WriteHeader("Content-Type", "application/octet-stream");
         req->WriteReply(HTTP_OK, binaryTx);
@@ -361,16 +418,26 @@ static bool rest_tx(HTTPRequest* req, const std::string& strURIPart)
     }
 
     case RF_HEX: {
-        std::string strHex = HexStr(ssTx.begin(), ssTx.end()) + "\n";
+        std::string strHex;
+        for (const CTransactionRef& tx : vtx) {
+            CDataStream ssTx(SER_NETWORK, PROTOCOL_VERSION | RPCSerializationFlags());
+            ssTx << tx;
+            strHex += HexStr(ssTx.begin(), ssTx.end()) + "\n";
+        }
         req->WriteHeader("Content-Type", "text/plain");
         req->WriteReply(HTTP_OK, strHex);
         return true;
     }
 
     case RF_JSON: {
-        UniValue objTx(UniValue::VOBJ);
-        TxToUniv(*tx, hashBlock, objTx);
-        std::string strJSON = objTx.write() + "\n";
+        UniValue txs(UniValue::VARR);
+        for (size_t i = 0; i < vtx.size(); i++) {
+            UniValue objTx(UniValue::VOBJ);
+            TxToUniv(*vtx[i], vHashBlock[i], objTx);
+            txs.push_back(objTx);
+        }
+        // A single transaction is returned as is, not in an array
+        std::string strJSON = (vtx.size() == 1 ? txs[0].write() : txs.write()) + "\n";
         req->WriteHeader("Content-Type", "application/json");
         req->WriteReply(HTTP_OK, strJSON);
         return true;
@@ -564,6 +631,370 @@ static bool rest_getutxos(HTTPRequest* req, const std::string& strURIPart)
     }
 }
 
+/** Reply with serialized data as binary or hex, or with the JSON built by toJSON */
+static bool RESTReplyData(HTTPRequest* req, enum RetFormat rf, const CDataStream& ssData, const std::function<UniValue()>& toJSON)
+{
+    switch (rf) {
+    case RF_BINARY: {
+        req->WriteHeader("Content-Type", "application/octet-stream");
+        req->WriteReply(HTTP_OK, ssData.str());
+        return true;
+    }
+
+    case RF_HEX: {
+        std::string strHex = HexStr(ssData.begin(), ssData.end()) + "\n";
+        req->WriteHeader("Content-Type", "text/plain");
+        req->WriteReply(HTTP_OK, strHex);
+        return true;
+    }
+
+    case RF_JSON: {
+        std::string strJSON = toJSON().write() + "\n";
+        req->WriteHeader("Content-Type", "application/json");
+        req->WriteReply(HTTP_OK, strJSON);
+        return true;
+    }
+
+    default: {
+        return RESTERR(req, HTTP_NOT_FOUND, "output format not found (available: " + AvailableDataFormatsString() + ")");
+    }
+    }
+}
+
+static bool ParseIndexAddress(const std::string& strAddress, uint160& hashBytes, int& type)
+{
+    CMyntaAddress address(strAddress);
+    return address.GetIndexKey(hashBytes, type);
+}
+
+static std::string IndexAddressString(int type, const uint160& hashBytes)
+{
+    if (type == 2)
+        return CMyntaAddress(CScriptID(hashBytes)).ToString();
+    return CMyntaAddress(CKeyID(hashBytes)).ToString();
+}
+
+/** /rest/address/utxos/<address>[/<asset>]: unspent outputs of an address from the
+ * address index, of RVN unless an asset ('*' for all) is given */
+static bool rest_address_utxos(HTTPRequest* req, const std::string& strURIPart)
+{
+    if (!CheckWarmup(req))
+        return false;
+    if (!fAddressIndex)
+        return RESTERR(req, HTTP_NOT_FOUND, "Address index not enabled, start with -addressindex");
+    std::string param;
+    const RetFormat rf = ParseDataFormat(param, strURIPart);
+
+    const std::string::size_type pos = param.find('/');
+    const std::string strAddress = param.substr(0, pos);
+    const std::string strAsset = pos == std::string::npos ? RVN : urlDecode(param.substr(pos + 1));
+    uint160 hashBytes;
+    int type = 0;
+    if (!ParseIndexAddress(strAddress, hashBytes, type))
+        return RESTERR(req, HTTP_BAD_REQUEST, "Invalid address: " + strAddress);
+
+    std::vector<std::pair<CAddressUnspentKey, CAddressUnspentValue> > unspentOutputs;
+    bool fRead = strAsset == "*" ? GetAddressUnspent(hashBytes, type, unspentOutputs) : GetAddressUnspent(hashBytes, type, strAsset, unspentOutputs);
+    if (!fRead)
+        return RESTERR(req, HTTP_INTERNAL_SERVER_ERROR, "Unable to read the address index");
+    std::sort(unspentOutputs.begin(), unspentOutputs.end(), [](const std::pair<CAddressUnspentKey, CAddressUnspentValue>& a, const std::pair<CAddressUnspentKey, CAddressUnspentValue>& b) {
+        return a.second.blockHeight < b.second.blockHeight;
+    });
+
+    int nHeight;
+    uint256 hashTip;
+    {
+        LOCK(cs_main);
+        nHeight = chainActive.Height();
+        hashTip = chainActive.Tip()->GetBlockHash();
+    }
+
+    CDataStream ssUnspent(SER_NETWORK, PROTOCOL_VERSION);
+    ssUnspent << nHeight << hashTip << unspentOutputs;
+    return RESTReplyData(req, rf, ssUnspent, [&]() {
+        UniValue objUnspent(UniValue::VOBJ);
+        objUnspent.push_back(Pair("chainHeight", nHeight));
+        objUnspent.push_back(Pair("chaintipHash", hashTip.GetHex()));
+        UniValue utxos(UniValue::VARR);
+        for (const auto& unspent : unspentOutputs) {
+            UniValue utxo(UniValue::VOBJ);
+            utxo.push_back(Pair("address", strAddress));
+            utxo.push_back(Pair("assetName", unspent.first.asset));
+            utxo.push_back(Pair("txid", unspent.first.txhash.GetHex()));
+            utxo.push_back(Pair("outputIndex", (int)unspent.first.index));
+            utxo.push_back(Pair("script", HexStr(unspent.second.script.begin(), unspent.second.script.end())));
+            utxo.push_back(Pair("satoshis", unspent.second.satoshis));
+            utxo.push_back(Pair("height", unspent.second.blockHeight));
+            utxos.push_back(utxo);
+        }
+        objUnspent.push_back(Pair("utxos", utxos));
+        return objUnspent;
+    });
+}
+
+/** /rest/address/deltas/<start>/<end>/<address>[/<asset>]: balance changes of an
+ * address between two heights (0/0 for all), of every asset unless one is given */
+static bool rest_address_deltas(HTTPRequest* req, const std::string& strURIPart)
+{
+    if (!CheckWarmup(req))
+        return false;
+    if (!fAddressIndex)
+        return RESTERR(req, HTTP_NOT_FOUND, "Address index not enabled, start with -addressindex");
+    std::string param;
+    const RetFormat rf = ParseDataFormat(param, strURIPart);
+    std::vector<std::string> path;
+    boost::split(path, param, boost::is_any_of("/"));
+
+    if (path.size() < 3)
+        return RESTERR(req, HTTP_BAD_REQUEST, "No height range specified. Use /rest/address/deltas/<start>/<end>/<address>.<ext>.");
+
+    int32_t nStart, nEnd;
+    if (!ParseInt32(path[0], &nStart) || !ParseInt32(path[1], &nEnd) || nStart < 0 || nEnd < 0 || (nEnd > 0 && nEnd < nStart))
+        return RESTERR(req, HTTP_BAD_REQUEST, "Invalid height range: " + path[0] + "/" + path[1]);
+
+    const std::string& strAddress = path[2];
+    uint160 hashBytes;
+    int type = 0;
+    if (!ParseIndexAddress(strAddress, hashBytes, type))
+        return RESTERR(req, HTTP_BAD_REQUEST, "Invalid address: " + strAddress);
+    std::string strAsset;
+    if (path.size() > 3) {
+        // Sub asset names contain '/' themselves
+        std::vector<std::string> assetPath(path.begin() + 3, path.end());
+        strAsset = urlDecode(boost::algorithm::join(assetPath, "/"));
+    }
+
+    std::vector<std::pair<CAddressIndexKey, CAmount> > addressIndex;
+    bool fRead = strAsset.empty() ? GetAddressIndex(hashBytes, type, addressIndex) : GetAddressIndex(hashBytes, type, strAsset, addressIndex, nStart, nEnd);
+    if (!fRead)
+        return RESTERR(req, HTTP_INTERNAL_SERVER_ERROR, "Unable to read the address index");
+    // The index is ordered by asset first, so the range is only applied here across assets
+    if (nStart > 0 || nEnd > 0) {
+        addressIndex.erase(std::remove_if(addressIndex.begin(), addressIndex.end(), [&](const std::pair<CAddressIndexKey, CAmount>& entry) {
+            return entry.first.blockHeight < nStart || (nEnd > 0 && entry.first.blockHeight > nEnd);
+        }), addressIndex.end());
+    }
+
+    CDataStream ssDeltas(SER_NETWORK, PROTOCOL_VERSION);
+    ssDeltas << addressIndex;
+    return RESTReplyData(req, rf, ssDeltas, [&]() {
+        UniValue deltas(UniValue::VARR);
+        for (const auto& entry : addressIndex) {
+            UniValue delta(UniValue::VOBJ);
+            delta.push_back(Pair("assetName", entry.first.asset));
+            delta.push_back(Pair("satoshis", entry.second));
+            delta.push_back(Pair("txid", entry.first.txhash.GetHex()));
+            delta.push_back(Pair("index", (int)entry.first.index));
+            delta.push_back(Pair("blockindex", (int)entry.first.txindex));
+            delta.push_back(Pair("height", entry.first.blockHeight));
+            delta.push_back(Pair("address", IndexAddressString(entry.first.type, entry.first.hashBytes)));
+            deltas.push_back(delta);
+        }
+        return deltas;
+    });
+}
+
+/** /rest/asset/data/<name>: an asset's metadata with the block it was last changed in */
+static bool rest_asset_data(HTTPRequest* req, const std::string& strURIPart)
+{
+    if (!CheckWarmup(req))
+        return false;
+    std::string param;
+    const RetFormat rf = ParseDataFormat(param, strURIPart);
+    const std::string strName = urlDecode(param);
+
+    if (!AreAssetsDeployed() || !passetsdb)
+        return RESTERR(req, HTTP_NOT_FOUND, "Assets aren't active");
+
+    // Served from the asset db's read snapshot, without cs_main
+    auto view = passetsdb->GetReadView();
+    CDatabasedAssetData data;
+    if (!passetsdb->ReadAssetData(*view, strName, data))
+        return RESTERR(req, HTTP_NOT_FOUND, strName + " not found");
+    std::string verifier;
+    bool fVerifier = passetsdb->ReadVerifier(*view, strName, verifier);
+
+    CDataStream ssAsset(SER_NETWORK, PROTOCOL_VERSION);
+    ssAsset << data;
+    return RESTReplyData(req, rf, ssAsset, [&]() {
+        const CNewAsset& asset = data.asset;
+        UniValue objAsset(UniValue::VOBJ);
+        objAsset.push_back(Pair("name", asset.strName));
+        objAsset.push_back(Pair("amount", ValueFromAmount(asset.nAmount, asset.units)));
+        objAsset.push_back(Pair("units", asset.units));
+        objAsset.push_back(Pair("reissuable", asset.nReissuable));
+        objAsset.push_back(Pair("has_ipfs", asset.nHasIPFS));
+        if (asset.nHasIPFS) {
+            if (asset.strIPFSHash.size() == 32)
+                objAsset.push_back(Pair("txid", EncodeAssetData(asset.strIPFSHash)));
+            else
+                objAsset.push_back(Pair("ipfs_hash", EncodeAssetData(asset.strIPFSHash)));
+        }
+        if (fVerifier)
+            objAsset.push_back(Pair("verifier_string", verifier));
+        objAsset.push_back(Pair("height", data.nHeight));
+        objAsset.push_back(Pair("blockhash", data.blockHash.GetHex()));
+        return objAsset;
+    });
+}
+
+/** /rest/asset/addresses/<count>/<start>/<name>: a page of the addresses holding an
+ * asset with their balances, like listaddressesbyasset */
+static bool rest_asset_addresses(HTTPRequest* req, const std::string& strURIPart)
+{
+    if (!CheckWarmup(req))
+        return false;
+    if (!fAssetIndex)
+        return RESTERR(req, HTTP_NOT_FOUND, "Asset index not enabled, start with -assetindex");
+    std::string param;
+    const RetFormat rf = ParseDataFormat(param, strURIPart);
+
+    // The name comes last as sub asset names contain '/'
+    const std::string::size_type posCount = param.find('/');
+    const std::string::size_type posStart = posCount == std::string::npos ? posCount : param.find('/', posCount + 1);
+    if (posStart == std::string::npos)
+        return RESTERR(req, HTTP_BAD_REQUEST, "No range specified. Use /rest/asset/addresses/<count>/<start>/<name>.<ext>.");
+    int32_t nCount;
+    int64_t nStart;
+    if (!ParseInt32(param.substr(0, posCount), &nCount) || nCount < 1 || (size_t)nCount > MAX_REST_ASSET_ADDRESSES)
+        return RESTERR(req, HTTP_BAD_REQUEST, "Address count out of range: " + param.substr(0, posCount));
+    if (!ParseInt64(param.substr(posCount + 1, posStart - posCount - 1), &nStart))
+        return RESTERR(req, HTTP_BAD_REQUEST, "Invalid start: " + param.substr(posCount + 1, posStart - posCount - 1));
+    const std::string strName = urlDecode(param.substr(posStart + 1));
+    if (!IsAssetNameValid(strName))
+        return RESTERR(req, HTTP_BAD_REQUEST, "Invalid asset name: " + strName);
+    if (!passetsdb)
+        return RESTERR(req, HTTP_NOT_FOUND, "Assets aren't active");
+
+    // Served from the asset db's read snapshot, without cs_main
+    auto view = passetsdb->GetReadView();
+    std::vector<std::pair<std::string, CAmount> > vecAddressAmounts;
+    int nTotalEntries = 0;
+    if (!passetsdb->AssetAddressDir(*view, vecAddressAmounts, nTotalEntries, false, strName, nCount, nStart))
+        return RESTERR(req, HTTP_INTERNAL_SERVER_ERROR, "Unable to read the asset index");
+
+    CDataStream ssAddresses(SER_NETWORK, PROTOCOL_VERSION);
+    ssAddresses << vecAddressAmounts;
+    return RESTReplyData(req, rf, ssAddresses, [&]() {
+        uint8_t units = OWNER_UNITS;
+        CDatabasedAssetData data;
+        if (!IsAssetNameAnOwner(strName))
+            units = passetsdb->ReadAssetData(*view, strName, data) ? data.asset.units : MAX_UNIT;
+        UniValue objAddresses(UniValue::VOBJ);
+        for (const auto& pair : vecAddressAmounts)
+            objAddresses.push_back(Pair(pair.first, ValueFromAmount(pair.second, units)));
+        return objAddresses;
+    });
+}
+
+/** The block filter index serving filterType, or nullptr with an error reply sent */
+static CBlockFilterIndex* GetRESTBlockFilterIndex(HTTPRequest* req, const std::string& strType)
+{
+    BlockFilterType filterType;
+    if (!BlockFilterTypeByName(strType, filterType)) {
+        RESTERR(req, HTTP_BAD_REQUEST, "Unknown filter type: " + strType);
+        return nullptr;
+    }
+    if (!pblockfilterindex || pblockfilterindex->GetFilterType() != filterType) {
+        RESTERR(req, HTTP_NOT_FOUND, "Index is not enabled for filter type " + strType);
+        return nullptr;
+    }
+    return pblockfilterindex;
+}
+
+/** /rest/blockfilter/<type>/<hash>.<ext>: the compact filter of a block */
+static bool rest_block_filter(HTTPRequest* req, const std::string& strURIPart)
+{
+    if (!CheckWarmup(req))
+        return false;
+    std::string param;
+    const RetFormat rf = ParseDataFormat(param, strURIPart);
+    std::vector<std::string> path;
+    boost::split(path, param, boost::is_any_of("/"));
+    if (path.size() != 2)
+        return RESTERR(req, HTTP_BAD_REQUEST, "Invalid URI format. Expected /rest/blockfilter/<filtertype>/<blockhash>.<ext>");
+
+    uint256 hash;
+    if (!ParseHashStr(path[1], hash))
+        return RESTERR(req, HTTP_BAD_REQUEST, "Invalid hash: " + path[1]);
+    CBlockFilterIndex* pindexFilters = GetRESTBlockFilterIndex(req, path[0]);
+    if (!pindexFilters)
+        return false;
+
+    {
+        LOCK(cs_main);
+        if (!mapBlockIndex.count(hash))
+            return RESTERR(req, HTTP_NOT_FOUND, hash.GetHex() + " not found");
+    }
+    BlockFilter filter;
+    if (!pindexFilters->LookupFilter(hash, filter))
+        return RESTERR(req, HTTP_NOT_FOUND, "Filter not found. Block filters are still being indexed or the block is not in the active chain.");
+
+    CDataStream ssFilter(SER_NETWORK, PROTOCOL_VERSION);
+    ssFilter << filter.GetEncodedFilter();
+    return RESTReplyData(req, rf, ssFilter, [&]() {
+        UniValue objFilter(UniValue::VOBJ);
+        objFilter.push_back(Pair("filter", HexStr(filter.GetEncodedFilter())));
+        return objFilter;
+    });
+}
+
+/** /rest/blockfilterheaders/<type>/<count>/<hash>.<ext>: filter headers from a block onwards */
+static bool rest_filter_header(HTTPRequest* req, const std::string& strURIPart)
+{
+    if (!CheckWarmup(req))
+        return false;
+    std::string param;
+    const RetFormat rf = ParseDataFormat(param, strURIPart);
+    std::vector<std::string> path;
+    boost::split(path, param, boost::is_any_of("/"));
+    if (path.size() != 3)
+        return RESTERR(req, HTTP_BAD_REQUEST, "Invalid URI format. Expected /rest/blockfilterheaders/<filtertype>/<count>/<blockhash>.<ext>");
+
+    long count = strtol(path[1].c_str(), nullptr, 10);
+    if (count < 1 || count > 2000)
+        return RESTERR(req, HTTP_BAD_REQUEST, "Header count out of range: " + path[1]);
+    uint256 hash;
+    if (!ParseHashStr(path[2], hash))
+        return RESTERR(req, HTTP_BAD_REQUEST, "Invalid hash: " + path[2]);
+    CBlockFilterIndex* pindexFilters = GetRESTBlockFilterIndex(req, path[0]);
+    if (!pindexFilters)
+        return false;
+
+    std::vector<uint256> vBlockHashes;
+    vBlockHashes.reserve(count);
+    {
+        LOCK(cs_main);
+        BlockMap::const_iterator it = mapBlockIndex.find(hash);
+        const CBlockIndex* pindex = (it != mapBlockIndex.end()) ? it->second : nullptr;
+        while (pindex != nullptr && chainActive.Contains(pindex)) {
+            vBlockHashes.push_back(pindex->GetBlockHash());
+            if (vBlockHashes.size() == (unsigned long)count)
+                break;
+            pindex = chainActive.Next(pindex);
+        }
+    }
+
+    std::vector<uint256> vHeaders;
+    vHeaders.reserve(vBlockHashes.size());
+    for (const uint256& hashBlock : vBlockHashes) {
+        uint256 hashHeader;
+        if (!pindexFilters->LookupFilterHeader(hashBlock, hashHeader))
+            break;
+        vHeaders.push_back(hashHeader);
+    }
+
+    CDataStream ssHeaders(SER_NETWORK, PROTOCOL_VERSION);
+    for (const uint256& hashHeader : vHeaders)
+        ssHeaders << hashHeader;
+    return RESTReplyData(req, rf, ssHeaders, [&]() {
+        UniValue arrHeaders(UniValue::VARR);
+        for (const uint256& hashHeader : vHeaders)
+            arrHeaders.push_back(hashHeader.GetHex());
+        return arrHeaders;
+    });
+}
+
 static const struct {
     const char* prefix;
     bool (*handler)(HTTPRequest* req, const std::string& strReq);
@@ -575,7 +1006,13 @@ static const struct {
       {"/rest/mempool/info", rest_mempool_info},
       {"/rest/mempool/contents", rest_mempool_contents},
       {"/rest/headers/", rest_headers},
+      {"/rest/blockfilter/", rest_block_filter},
+      {"/rest/blockfilterheaders/", rest_filter_header},
       {"/rest/getutxos", rest_getutxos},
+      {"/rest/address/utxos/", rest_address_utxos},
+      {"/rest/address/deltas/", rest_address_deltas},
+      {"/rest/asset/data/", rest_asset_data},
+      {"/rest/asset/addresses/", rest_asset_addresses},
 };
 
 bool StartREST()
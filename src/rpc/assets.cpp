@@ -24,6 +24,8 @@
 #include "policy/fees.h"
 #include "policy/policy.h"
 #include "policy/rbf.h"
+#include "rpc/blockchain.h"
+#include "rpc/jsonstream.h"
 #include "rpc/mining.h"
 #include "rpc/safemode.h"
 #include "rpc/server.h"
@@ -113,6 +115,21 @@ UniValue UnitValueFromAmount(const CAmount& amount, const std::string asset_name
     return ValueFromAmount(amount, units);
 }
 
+/** Same, taking the units from a read view of the assets db instead of passets, so without cs_main */
+static UniValue UnitValueFromAmount(const CAssetsReadView& view, const CAmount& amount, const std::string& asset_name)
+{
+    uint8_t units = OWNER_UNITS;
+    if (!IsAssetNameAnOwner(asset_name)) {
+        CDatabasedAssetData data;
+        if (!passetsdb->ReadAssetData(view, asset_name, data))
+            units = MAX_UNIT;
+        else
+            units = data.asset.units;
+    }
+
+    return ValueFromAmount(amount, units);
+}
+
 #ifdef ENABLE_WALLET
 UniValue UpdateAddressTag(const JSONRPCRequest &request, const int8_t &flag)
 {
@@ -344,11 +361,11 @@ UniValue UpdateGlobalRestrictedAsset(const JSONRPCRequest &request, const int8_t
         throw JSONRPCError(RPC_INVALID_PARAMETER, std::string("Unsupported asset type: ") + AssetTypeToString(assetType));
     }
 
-    if (flag == 1 && mempool.mapGlobalFreezingAssetTransactions.count(restricted_name)){
+    if (flag == 1 && mempool.HasGlobalRestrictionChange(restricted_name, true)){
         throw JSONRPCError(RPC_TRANSACTION_REJECTED, std::string("Freezing transaction already in mempool"));
     }
 
-    if (flag == 0 && mempool.mapGlobalUnFreezingAssetTransactions.count(restricted_name)){
+    if (flag == 0 && mempool.HasGlobalRestrictionChange(restricted_name, false)){
         throw JSONRPCError(RPC_TRANSACTION_REJECTED, std::string("Unfreezing transaction already in mempool"));
     }
 
@@ -745,7 +762,7 @@ UniValue listassetbalancesbyaddress(const JSONRPCRequest& request)
 
     if (request.fHelp || !AreAssetsDeployed() || request.params.size() < 1)
         throw std::runtime_error(
-            "listassetbalancesbyaddress \"address\" (onlytotal) (count) (start)\n"
+            "listassetbalancesbyaddress \"address\" (onlytotal) (count) (start) (\"start_after\")\n"
             + AssetActivationWarning() +
             "\nReturns a list of all asset balances for an address.\n"
 
@@ -754,6 +771,7 @@ UniValue listassetbalancesbyaddress(const JSONRPCRequest& request)
             "2. \"onlytotal\"                (boolean, optional, default=false) when false result is just a list of assets balances -- when true the result is just a single number representing the number of assets\n"
             "3. \"count\"                    (integer, optional, default=50000, MAX=50000) truncates results to include only the first _count_ assets found\n"
             "4. \"start\"                    (integer, optional, default=0) results skip over the first _start_ assets found (if negative it skips back from the end)\n"
+            "5. \"start_after\"              (string, optional, default=\"\") continue after this asset name, the last one of the previous page, instead of skipping from the first\n"
 
             "\nResult:\n"
             "{\n"
@@ -766,6 +784,7 @@ UniValue listassetbalancesbyaddress(const JSONRPCRequest& request)
             + HelpExampleCli("listassetbalancesbyaddress", "\"myaddress\" false 2 0")
             + HelpExampleCli("listassetbalancesbyaddress", "\"myaddress\" true")
             + HelpExampleCli("listassetbalancesbyaddress", "\"myaddress\"")
+            + HelpExampleCli("listassetbalancesbyaddress", "\"myaddress\" false 100 0 \"LAST_ASSET_NAME\"")
         );
 
     ObserveSafeMode();
@@ -792,13 +811,21 @@ UniValue listassetbalancesbyaddress(const JSONRPCRequest& request)
         start = request.params[3].get_int();
     }
 
+    std::string strStartAfter;
+    if (request.params.size() > 4) {
+        strStartAfter = request.params[4].get_str();
+        if (!strStartAfter.empty() && start < 0)
+            throw JSONRPCError(RPC_INVALID_PARAMETER, "start can't be negative when start_after is given.");
+    }
+
     if (!passetsdb)
         throw JSONRPCError(RPC_INTERNAL_ERROR, "asset db unavailable.");
 
-    LOCK(cs_main);
+    // Served from the last flushed db state plus the blocks connected since, without cs_main
+    auto view = passetsdb->GetReadView();
     std::vector<std::pair<std::string, CAmount> > vecAssetAmounts;
     int nTotalEntries = 0;
-    if (!passetsdb->AddressDir(vecAssetAmounts, nTotalEntries, fOnlyTotal, address, count, start))
+    if (!passetsdb->AddressDir(*view, vecAssetAmounts, nTotalEntries, fOnlyTotal, address, count, start, strStartAfter))
         throw JSONRPCError(RPC_INTERNAL_ERROR, "couldn't retrieve address asset directory.");
 
     // If only the number of addresses is wanted return it
@@ -808,7 +835,7 @@ UniValue listassetbalancesbyaddress(const JSONRPCRequest& request)
 
     UniValue result(UniValue::VOBJ);
     for (auto& pair : vecAssetAmounts) {
-        result.push_back(Pair(pair.first, UnitValueFromAmount(pair.second, pair.first)));
+        result.push_back(Pair(pair.first, UnitValueFromAmount(*view, pair.second, pair.first)));
     }
 
     return result;
@@ -835,6 +862,9 @@ UniValue getassetdata(const JSONRPCRequest& request)
                 "  ipfs_hash: (hash), (only if has_ipfs = 1 and that data is a ipfs hash)\n"
                 "  txid_hash: (hash), (only if has_ipfs = 1 and that data is a txid hash)\n"
                 "  verifier_string: (string)\n"
+                "  circulating: (number), the amount in unspent outputs, less what was sent to burn addresses\n"
+                "  utxos: (number), the unspent outputs holding the asset\n"
+                "  holders: (number), the addresses holding the asset (only with -assetindex)\n"
                 "}\n"
 
                 "\nExamples:\n"
@@ -845,17 +875,18 @@ UniValue getassetdata(const JSONRPCRequest& request)
 
     std::string asset_name = request.params[0].get_str();
 
-    LOCK(cs_main);
     UniValue result (UniValue::VOBJ);
 
-    auto currentActiveAssetCache = GetCurrentAssetCache();
-    if (currentActiveAssetCache) {
-        CNewAsset asset;
-        if (!currentActiveAssetCache->GetAssetMetaDataIfExists(asset_name, asset))
+    if (passetsdb) {
+        // Served from the last flushed db state plus the blocks connected since, without cs_main
+        auto view = passetsdb->GetReadView();
+        CDatabasedAssetData data;
+        if (!passetsdb->ReadAssetData(*view, asset_name, data))
             return NullUniValue;
+        const CNewAsset& asset = data.asset;
 
         result.push_back(Pair("name", asset.strName));
-        result.push_back(Pair("amount", UnitValueFromAmount(asset.nAmount, asset.strName)));
+        result.push_back(Pair("amount", ValueFromAmount(asset.nAmount, asset.units)));
         result.push_back(Pair("units", asset.units));
         result.push_back(Pair("reissuable", asset.nReissuable));
         result.push_back(Pair("has_ipfs", asset.nHasIPFS));
@@ -868,11 +899,18 @@ UniValue getassetdata(const JSONRPCRequest& request)
             }
         }
 
-        CNullAssetTxVerifierString verifier;
-        if (currentActiveAssetCache->GetAssetVerifierStringIfExists(asset.strName, verifier)) {
-            result.push_back(Pair("verifier_string", verifier.verifier_string));
+        std::string verifier;
+        if (passetsdb->ReadVerifier(*view, asset.strName, verifier)) {
+            result.push_back(Pair("verifier_string", verifier));
         }
 
+        // Kept up to date block by block, so no need to walk the holders
+        const CAssetSupply supply = passetsdb->ReadAssetSupply(*view, asset.strName);
+        result.push_back(Pair("circulating", ValueFromAmount(supply.nHeld, asset.units)));
+        result.push_back(Pair("utxos", supply.nOutputs));
+        if (fAssetIndex)
+            result.push_back(Pair("holders", (int64_t)passetsdb->AssetHolderCount(*view, asset.strName)));
+
         return result;
     }
 
@@ -1075,9 +1113,9 @@ UniValue listaddressesbyasset(const JSONRPCRequest &request)
         return "_This rpc call is not functional unless -assetindex is enabled. To enable, please run the wallet with -assetindex, this will require a reindex to occur";
     }
 
-    if (request.fHelp || !AreAssetsDeployed() || request.params.size() > 4 || request.params.size() < 1)
+    if (request.fHelp || !AreAssetsDeployed() || request.params.size() > 5 || request.params.size() < 1)
         throw std::runtime_error(
-                "listaddressesbyasset \"asset_name\" (onlytotal) (count) (start)\n"
+                "listaddressesbyasset \"asset_name\" (onlytotal) (count) (start) (\"start_after\")\n"
                 + AssetActivationWarning() +
                 "\nReturns a list of all address that own the given asset (with balances)"
                 "\nOr returns the total size of how many address own the given asset"
@@ -1087,6 +1125,7 @@ UniValue listaddressesbyasset(const JSONRPCRequest &request)
                 "2. \"onlytotal\"                (boolean, optional, default=false) when false result is just a list of addresses with balances -- when true the result is just a single number representing the number of addresses\n"
                 "3. \"count\"                    (integer, optional, default=50000, MAX=50000) truncates results to include only the first _count_ assets found\n"
                 "4. \"start\"                    (integer, optional, default=0) results skip over the first _start_ assets found (if negative it skips back from the end)\n"
+                "5. \"start_after\"              (string, optional, default=\"\") continue after this address, the last one of the previous page, instead of skipping from the first\n"
 
                 "\nResult:\n"
                 "[ "
@@ -1098,10 +1137,9 @@ UniValue listaddressesbyasset(const JSONRPCRequest &request)
                 + HelpExampleCli("listaddressesbyasset", "\"ASSET_NAME\" false 2 0")
                 + HelpExampleCli("listaddressesbyasset", "\"ASSET_NAME\" true")
                 + HelpExampleCli("listaddressesbyasset", "\"ASSET_NAME\"")
+                + HelpExampleCli("listaddressesbyasset", "\"ASSET_NAME\" false 100 0 \"LAST_ADDRESS\"")
         );
 
-    LOCK(cs_main);
-
     std::string asset_name = request.params[0].get_str();
     bool fOnlyTotal = false;
     if (request.params.size() > 1)
@@ -1119,13 +1157,26 @@ UniValue listaddressesbyasset(const JSONRPCRequest &request)
         start = request.params[3].get_int();
     }
 
+    std::string strStartAfter;
+    if (request.params.size() > 4) {
+        strStartAfter = request.params[4].get_str();
+        if (!strStartAfter.empty() && start < 0)
+            throw JSONRPCError(RPC_INVALID_PARAMETER, "start can't be negative when start_after is given.");
+        if (!strStartAfter.empty() && !IsValidDestinationString(strStartAfter))
+            throw JSONRPCError(RPC_INVALID_ADDRESS_OR_KEY, std::string("Invalid start_after address: ") + strStartAfter);
+    }
+
     if (!IsAssetNameValid(asset_name))
         return "_Not a valid asset name";
 
-    LOCK(cs_main);
+    if (!passetsdb)
+        throw JSONRPCError(RPC_INTERNAL_ERROR, "asset db unavailable.");
+
+    // Served from the last flushed db state plus the blocks connected since, without cs_main
+    auto view = passetsdb->GetReadView();
     std::vector<std::pair<std::string, CAmount> > vecAddressAmounts;
     int nTotalEntries = 0;
-    if (!passetsdb->AssetAddressDir(vecAddressAmounts, nTotalEntries, fOnlyTotal, asset_name, count, start))
+    if (!passetsdb->AssetAddressDir(*view, vecAddressAmounts, nTotalEntries, fOnlyTotal, asset_name, count, start, strStartAfter))
         throw JSONRPCError(RPC_INTERNAL_ERROR, "couldn't retrieve address asset directory.");
 
     // If only the number of addresses is wanted return it
@@ -1133,14 +1184,234 @@ UniValue listaddressesbyasset(const JSONRPCRequest &request)
         return nTotalEntries;
     }
 
+    if (request.stream) {
+        request.stream->BeginObject();
+        for (auto& pair : vecAddressAmounts)
+            request.stream->KeyValue(pair.first, UnitValueFromAmount(*view, pair.second, asset_name));
+        request.stream->EndObject();
+        return NullUniValue;
+    }
+
     UniValue result(UniValue::VOBJ);
     for (auto& pair : vecAddressAmounts) {
-        result.push_back(Pair(pair.first, UnitValueFromAmount(pair.second, asset_name)));
+        result.push_back(Pair(pair.first, UnitValueFromAmount(*view, pair.second, asset_name)));
+    }
+
+
+    return result;
+}
+
+UniValue listuniqueassets(const JSONRPCRequest& request)
+{
+    if (request.fHelp || !AreAssetsDeployed() || request.params.size() > 5 || request.params.size() < 1)
+        throw std::runtime_error(
+                "listuniqueassets \"root_name\" (onlytotal) (count) (start) (\"start_after\")\n"
+                + AssetActivationWarning() +
+                "\nReturns the unique assets issued under a root asset (a collection), with their holders if -assetindex is enabled"
+                "\nOr returns the number of unique assets in the collection"
+
+                "\nArguments:\n"
+                "1. \"root_name\"                (string, required) the collection, the asset the unique assets were issued from\n"
+                "2. \"onlytotal\"                (boolean, optional, default=false) when true the result is just the number of unique assets in the collection\n"
+                "3. \"count\"                    (integer, optional, default=50000, MAX=50000) truncates results to include only the first _count_ unique assets found\n"
+                "4. \"start\"                    (integer, optional, default=0) results skip over the first _start_ unique assets found (if negative it skips back from the end)\n"
+                "5. \"start_after\"              (string, optional, default=\"\") continue after this tag, the last one of the previous page, instead of skipping from the first\n"
+
+                "\nResult:\n"
+                "[\n"
+                "  {\n"
+                "    \"name\": \"ROOT#TAG\",      (string) the unique asset\n"
+                "    \"tag\": \"TAG\",            (string) its tag, for start_after\n"
+                "    \"holder\": \"address\",     (string, only with -assetindex) the address holding it, absent if it was burned\n"
+                "  },\n"
+                "  ...\n"
+                "]\n"
+
+                "\nExamples:\n"
+                + HelpExampleCli("listuniqueassets", "\"ROOT\"")
+                + HelpExampleCli("listuniqueassets", "\"ROOT\" true")
+                + HelpExampleCli("listuniqueassets", "\"ROOT\" false 100 0 \"LAST_TAG\"")
+                + HelpExampleRpc("listuniqueassets", "\"ROOT\", false, 100")
+        );
+
+    std::string root_name = request.params[0].get_str();
+    bool fOnlyTotal = false;
+    if (request.params.size() > 1)
+        fOnlyTotal = request.params[1].get_bool();
+
+    size_t count = INT_MAX;
+    if (request.params.size() > 2) {
+        if (request.params[2].get_int() < 1)
+            throw JSONRPCError(RPC_INVALID_PARAMETER, "count must be greater than 1.");
+        count = request.params[2].get_int();
+    }
+
+    long start = 0;
+    if (request.params.size() > 3) {
+        start = request.params[3].get_int();
+    }
+
+    std::string strStartAfter;
+    if (request.params.size() > 4) {
+        strStartAfter = request.params[4].get_str();
+        if (!strStartAfter.empty() && start < 0)
+            throw JSONRPCError(RPC_INVALID_PARAMETER, "start can't be negative when start_after is given.");
+    }
+
+    AssetType type;
+    if (!IsAssetNameValid(root_name, type) || (type != AssetType::ROOT && type != AssetType::SUB))
+        throw JSONRPCError(RPC_INVALID_PARAMETER, std::string("Not a root or sub asset name: ") + root_name);
+
+    if (!passetsdb)
+        throw JSONRPCError(RPC_INTERNAL_ERROR, "asset db unavailable.");
+
+    // Served from the last flushed db state plus the blocks connected since, without cs_main
+    auto view = passetsdb->GetReadView();
+    std::vector<std::pair<std::string, CAmount> > vecTagAmounts;
+    int nTotalEntries = 0;
+    if (!passetsdb->UniqueCollectionDir(*view, vecTagAmounts, nTotalEntries, fOnlyTotal, root_name, count, start, strStartAfter))
+        throw JSONRPCError(RPC_INTERNAL_ERROR, "couldn't retrieve unique asset collection.");
+
+    if (fOnlyTotal) {
+        return nTotalEntries;
+    }
+
+    UniValue result(UniValue::VARR);
+    for (const auto& item : vecTagAmounts) {
+        const std::string name = root_name + "#" + item.first;
+        UniValue entry(UniValue::VOBJ);
+        entry.push_back(Pair("name", name));
+        entry.push_back(Pair("tag", item.first));
+        if (fAssetIndex) {
+            // A unique asset is a single coin, so it has one holder at most
+            std::vector<std::pair<std::string, CAmount> > vecHolders;
+            int nHolders = 0;
+            if (!passetsdb->AssetAddressDir(*view, vecHolders, nHolders, false, name, 1, 0))
+                throw JSONRPCError(RPC_INTERNAL_ERROR, "couldn't retrieve the holder of " + name);
+            if (!vecHolders.empty())
+                entry.push_back(Pair("holder", vecHolders.front().first));
+        }
+        result.push_back(entry);
+    }
+
+    return result;
+}
+
+static std::string AssetTreeTypeName(const std::string& name)
+{
+    AssetType type;
+    if (!IsAssetNameValid(name, type))
+        return "unknown";
+    switch (type) {
+        case AssetType::ROOT: return "root";
+        case AssetType::SUB: return "sub";
+        case AssetType::UNIQUE: return "unique";
+        case AssetType::MSGCHANNEL: return "msgchannel";
+        case AssetType::QUALIFIER: return "qualifier";
+        case AssetType::SUB_QUALIFIER: return "sub_qualifier";
+        case AssetType::RESTRICTED: return "restricted";
+        case AssetType::VOTE: return "vote";
+        case AssetType::OWNER: return "owner";
+        default: return "unknown";
+    }
+}
+
+UniValue listassetchildren(const JSONRPCRequest& request)
+{
+    if (request.fHelp || !AreAssetsDeployed() || request.params.size() > 5 || request.params.size() < 1)
+        throw std::runtime_error(
+                "listassetchildren \"asset_name\" (onlytotal) (count) (start) (\"start_after\")\n"
+                + AssetActivationWarning() +
+                "\nReturns the assets directly below an asset in the asset namespace: its sub assets, unique assets,"
+                "\nmessage channels and votes, the $NAME restricted asset and #NAME qualifier, and the sub qualifiers of a qualifier."
+                "\nOwner assets are implied by their asset and not listed."
+
+                "\nArguments:\n"
+                "1. \"asset_name\"               (string, required) the parent asset\n"
+                "2. \"onlytotal\"                (boolean, optional, default=false) when true the result is just the number of children and of all descendants\n"
+                "3. \"count\"                    (integer, optional, default=50000, MAX=50000) truncates results to include only the first _count_ children found\n"
+                "4. \"start\"                    (integer, optional, default=0) results skip over the first _start_ children found (if negative it skips back from the end)\n"
+                "5. \"start_after\"              (string, optional, default=\"\") continue after this child, the last one of the previous page, instead of skipping from the first\n"
+
+                "\nResult (onlytotal=false):\n"
+                "[\n"
+                "  {\n"
+                "    \"name\": \"asset_name\",    (string) the child asset\n"
+                "    \"type\": \"sub\",           (string) root, sub, unique, msgchannel, qualifier, sub_qualifier, restricted or vote\n"
+                "    \"descendants\": n,         (numeric) number of assets anywhere below it\n"
+                "  },\n"
+                "  ...\n"
+                "]\n"
+
+                "\nResult (onlytotal=true):\n"
+                "{\n"
+                "  \"children\": n,             (numeric) number of assets directly below asset_name\n"
+                "  \"descendants\": n,          (numeric) number of assets anywhere below asset_name\n"
+                "}\n"
+
+                "\nExamples:\n"
+                + HelpExampleCli("listassetchildren", "\"COMPANY\"")
+                + HelpExampleCli("listassetchildren", "\"COMPANY\" true")
+                + HelpExampleCli("listassetchildren", "\"COMPANY\" false 100 0 \"COMPANY/LAST\"")
+                + HelpExampleRpc("listassetchildren", "\"COMPANY\", false, 100")
+        );
+
+    std::string asset_name = request.params[0].get_str();
+    bool fOnlyTotal = false;
+    if (request.params.size() > 1)
+        fOnlyTotal = request.params[1].get_bool();
+
+    size_t count = INT_MAX;
+    if (request.params.size() > 2) {
+        if (request.params[2].get_int() < 1)
+            throw JSONRPCError(RPC_INVALID_PARAMETER, "count must be greater than 1.");
+        count = request.params[2].get_int();
+    }
+
+    long start = 0;
+    if (request.params.size() > 3) {
+        start = request.params[3].get_int();
+    }
+
+    std::string strStartAfter;
+    if (request.params.size() > 4) {
+        strStartAfter = request.params[4].get_str();
+        if (!strStartAfter.empty() && start < 0)
+            throw JSONRPCError(RPC_INVALID_PARAMETER, "start can't be negative when start_after is given.");
+    }
+
+    if (!IsAssetNameValid(asset_name))
+        throw JSONRPCError(RPC_INVALID_PARAMETER, std::string("Invalid asset name: ") + asset_name);
+
+    if (!passetsdb)
+        throw JSONRPCError(RPC_INTERNAL_ERROR, "asset db unavailable.");
+
+    // Served from the last flushed db state plus the blocks connected since, without cs_main
+    auto view = passetsdb->GetReadView();
+    std::vector<std::pair<std::string, CAmount> > vecChildren;
+    int nTotalEntries = 0;
+    if (!passetsdb->AssetChildrenDir(*view, vecChildren, nTotalEntries, fOnlyTotal, asset_name, count, start, strStartAfter))
+        throw JSONRPCError(RPC_INTERNAL_ERROR, "couldn't retrieve asset children.");
+
+    if (fOnlyTotal) {
+        UniValue result(UniValue::VOBJ);
+        result.push_back(Pair("children", nTotalEntries));
+        result.push_back(Pair("descendants", (int64_t)passetsdb->AssetDescendantCount(*view, asset_name)));
+        return result;
     }
 
+    UniValue result(UniValue::VARR);
+    for (const auto& item : vecChildren) {
+        UniValue entry(UniValue::VOBJ);
+        entry.push_back(Pair("name", item.first));
+        entry.push_back(Pair("type", AssetTreeTypeName(item.first)));
+        entry.push_back(Pair("descendants", (int64_t)passetsdb->AssetDescendantCount(*view, item.first)));
+        result.push_back(entry);
+    }
 
     return result;
 }
+
 #ifdef ENABLE_WALLET
 
 UniValue transfer(const JSONRPCRequest& request)
@@ -1737,8 +2008,10 @@ UniValue listassets(const JSONRPCRequest& request)
         start = request.params[3].get_int();
     }
 
+    // Served from the last flushed db state plus the blocks connected since, without cs_main
+    auto view = passetsdb->GetReadView();
     std::vector<CDatabasedAssetData> assets;
-    if (!passetsdb->AssetDir(assets, filter, count, start))
+    if (!passetsdb->AssetDir(*view, assets, filter, count, start))
         throw JSONRPCError(RPC_INTERNAL_ERROR, "couldn't retrieve asset directory.");
 
     UniValue result;
@@ -1749,7 +2022,7 @@ UniValue listassets(const JSONRPCRequest& request)
         if (verbose) {
             UniValue detail(UniValue::VOBJ);
             detail.push_back(Pair("name", asset.strName));
-            detail.push_back(Pair("amount", UnitValueFromAmount(asset.nAmount, asset.strName)));
+            detail.push_back(Pair("amount", ValueFromAmount(asset.nAmount, asset.units)));
             detail.push_back(Pair("units", asset.units));
             detail.push_back(Pair("reissuable", asset.nReissuable));
             detail.push_back(Pair("has_ipfs", asset.nHasIPFS));
@@ -1771,6 +2044,19 @@ UniValue listassets(const JSONRPCRequest& request)
     return result;
 }
 
+static UniValue LRUCacheStatsToJSON(const CLRUCacheStats& stats)
+{
+    UniValue obj(UniValue::VOBJ);
+    obj.push_back(Pair("entries", (uint64_t)stats.nEntries));
+    obj.push_back(Pair("max entries", (uint64_t)stats.nMaxEntries));
+    obj.push_back(Pair("bytes", (uint64_t)stats.nUsage));
+    obj.push_back(Pair("max bytes", (uint64_t)stats.nMaxUsage));
+    obj.push_back(Pair("hits", stats.nHits));
+    obj.push_back(Pair("misses", stats.nMisses));
+    obj.push_back(Pair("evictions", stats.nEvictions));
+    return obj;
+}
+
 UniValue getcacheinfo(const JSONRPCRequest& request)
 {
     if (request.fHelp || !AreAssetsDeployed() || request.params.size())
@@ -1789,8 +2075,8 @@ UniValue getcacheinfo(const JSONRPCRequest& request)
                 "  asset metadata map:\n"
                 "  asset metadata list (est):\n"
                 "  dirty cache (est):\n"
-
-
+                "  lru caches: { name: { entries, max entries, bytes, max bytes, hits, misses, evictions } }\n"
+                "  memory budget: { budget, usage, pressure_events, caches: { name: { bytes, evictable, evictions, evicted_bytes } } }\n"
                 "]\n"
 
                 "\nExamples:\n"
@@ -1821,11 +2107,24 @@ UniValue getcacheinfo(const JSONRPCRequest& request)
 
     info.push_back(Pair("reissue tracking (memory only)", (int)memusage::DynamicUsage(mapReissuedAssets) + (int)memusage::DynamicUsage(mapReissuedTx)));
     info.push_back(Pair("asset data", descendants));
-    info.push_back(Pair("asset metadata map",  (int)memusage::DynamicUsage(passetsCache->GetItemsMap())));
-    info.push_back(Pair("asset metadata list (est)",  (int)passetsCache->GetItemsList().size() * (32 + 80))); // Max 32 bytes for asset name, 80 bytes max for asset data
+    info.push_back(Pair("asset metadata map",  (int)passetsCache->DynamicMemoryUsage()));
+    info.push_back(Pair("asset metadata list (est)",  (int)passetsCache->Size() * (32 + 80))); // Max 32 bytes for asset name, 80 bytes max for asset data
     info.push_back(Pair("dirty cache (est)",  (int)currentActiveAssetCache->GetCacheSize()));
     info.push_back(Pair("dirty cache V2 (est)",  (int)currentActiveAssetCache->GetCacheSizeV2()));
 
+    UniValue lruCaches(UniValue::VOBJ);
+    lruCaches.push_back(Pair("asset metadata", LRUCacheStatsToJSON(passetsCache->GetStats())));
+    if (passetsVerifierCache)
+        lruCaches.push_back(Pair("verifier", LRUCacheStatsToJSON(passetsVerifierCache->GetStats())));
+    if (passetsQualifierCache)
+        lruCaches.push_back(Pair("qualifier", LRUCacheStatsToJSON(passetsQualifierCache->GetStats())));
+    if (passetsRestrictionCache)
+        lruCaches.push_back(Pair("restriction", LRUCacheStatsToJSON(passetsRestrictionCache->GetStats())));
+    if (passetsGlobalRestrictionCache)
+        lruCaches.push_back(Pair("global restriction", LRUCacheStatsToJSON(passetsGlobalRestrictionCache->GetStats())));
+    info.push_back(Pair("lru caches", lruCaches));
+    info.push_back(Pair("memory budget", memoryBudgetToJSON()));
+
     result.push_back(info);
     return result;
 }
@@ -2960,18 +3259,19 @@ UniValue getsnapshot(const JSONRPCRequest& request)
     LOCK(cs_main);
     UniValue result (UniValue::VOBJ);
 
-    CAssetSnapshotDBEntry snapshotDbEntry;
+    CAssetSnapshotReader snapshotReader(*pAssetSnapshotDb, asset_name, block_height);
 
-    if (pAssetSnapshotDb->RetrieveOwnershipSnapshot(asset_name, block_height, snapshotDbEntry)) {
-        result.push_back(Pair("name", snapshotDbEntry.assetName));
-        result.push_back(Pair("height", snapshotDbEntry.height));
+    if (snapshotReader.Found()) {
+        result.push_back(Pair("name", snapshotReader.AssetName()));
+        result.push_back(Pair("height", snapshotReader.Height()));
 
         UniValue entries(UniValue::VARR);
-        for (auto const & ownerAndAmt : snapshotDbEntry.ownersAndAmounts) {
+        std::pair<std::string, CAmount> ownerAndAmt;
+        while (snapshotReader.Next(ownerAndAmt)) {
             UniValue entry(UniValue::VOBJ);
 
             entry.push_back(Pair("address", ownerAndAmt.first));
-            entry.push_back(Pair("amount_owned", UnitValueFromAmount(ownerAndAmt.second, snapshotDbEntry.assetName)));
+            entry.push_back(Pair("amount_owned", UnitValueFromAmount(ownerAndAmt.second, snapshotReader.AssetName())));
 
             entries.push_back(entry);
         }
@@ -3040,9 +3340,11 @@ static const CRPCCommand commands[] =
     { "assets",   "issueunique",                &issueunique,                {"root_name", "asset_tags", "ipfs_hashes", "to_address", "change_address"}},
     { "assets",   "listmyassets",               &listmyassets,               {"asset", "verbose", "count", "start", "confs"}},
 #endif
-    { "assets",   "listassetbalancesbyaddress", &listassetbalancesbyaddress, {"address", "onlytotal", "count", "start"} },
+    { "assets",   "listassetbalancesbyaddress", &listassetbalancesbyaddress, {"address", "onlytotal", "count", "start", "start_after"} },
     { "assets",   "getassetdata",               &getassetdata,               {"asset_name"}},
-    { "assets",   "listaddressesbyasset",       &listaddressesbyasset,       {"asset_name", "onlytotal", "count", "start"}},
+    { "assets",   "listaddressesbyasset",       &listaddressesbyasset,       {"asset_name", "onlytotal", "count", "start", "start_after"}},
+    { "assets",   "listuniqueassets",           &listuniqueassets,           {"root_name", "onlytotal", "count", "start", "start_after"}},
+    { "assets",   "listassetchildren",          &listassetchildren,          {"asset_name", "onlytotal", "count", "start", "start_after"}},
 #ifdef ENABLE_WALLET
     { "assets",   "transferfromaddress",        &transferfromaddress,        {"asset_name", "from_address", "qty", "to_address", "message", "expire_time", "rvn_change_address", "asset_change_address"}},
     { "assets",   "transferfromaddresses",      &transferfromaddresses,      {"asset_name", "from_addresses", "qty", "to_address", "message", "expire_time", "rvn_change_address", "asset_change_address"}},
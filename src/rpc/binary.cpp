@@ -0,0 +1,187 @@
+// Copyright (c) 2026 The Mynta Core Developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include "rpc/binary.h"
+
+#include "assets/assetdb.h"
+#include "assets/assets.h"
+#include "base58.h"
+#include "chain.h"
+#include "chainparams.h"
+#include "kawpowshares.h"
+#include "primitives/transaction.h"
+#include "rpc/mining.h"
+#include "rpc/protocol.h"
+#include "rpc/server.h"
+#include "sync.h"
+#include "validation.h"
+#include "version.h"
+
+#include <algorithm>
+
+#include <univalue.h>
+
+/** getblockheader <uint256 hash>: CBlockHeader, int32 height and int32
+ * confirmations, both -1 for a block off the active chain */
+static void binary_getblockheader(CDataStream& params, CDataStream& result)
+{
+    uint256 hash;
+    params >> hash;
+
+    LOCK(cs_main);
+    BlockMap::const_iterator it = mapBlockIndex.find(hash);
+    if (it == mapBlockIndex.end())
+        throw JSONRPCError(RPC_INVALID_ADDRESS_OR_KEY, "Block not found");
+    const CBlockIndex* pindex = it->second;
+    const bool fActive = chainActive.Contains(pindex);
+    result << pindex->GetBlockHeader();
+    result << (int32_t)(fActive ? pindex->nHeight : -1);
+    result << (int32_t)(fActive ? chainActive.Height() - pindex->nHeight + 1 : -1);
+}
+
+/** getrawtransaction <uint256 txid>: the transaction and the hash of the
+ * block it is in, null for a mempool transaction */
+static void binary_getrawtransaction(CDataStream& params, CDataStream& result)
+{
+    uint256 hash;
+    params >> hash;
+
+    CTransactionRef tx;
+    uint256 hashBlock;
+    if (!GetTransaction(hash, tx, GetParams().GetConsensus(), hashBlock, true))
+        throw JSONRPCError(RPC_INVALID_ADDRESS_OR_KEY, std::string(fTxIndex ? "No such mempool or blockchain transaction"
+            : "No such mempool transaction. Use -txindex to enable blockchain transaction queries"));
+    result << tx << hashBlock;
+}
+
+/** getassetdata <string name>: the asset's CDatabasedAssetData */
+static void binary_getassetdata(CDataStream& params, CDataStream& result)
+{
+    std::string strName;
+    params >> strName;
+
+    if (!AreAssetsDeployed() || !passetsdb)
+        throw JSONRPCError(RPC_MISC_ERROR, "Assets aren't active");
+
+    // Served from the asset db's read snapshot, without cs_main
+    auto view = passetsdb->GetReadView();
+    CDatabasedAssetData data;
+    if (!passetsdb->ReadAssetData(*view, strName, data))
+        throw JSONRPCError(RPC_INVALID_PARAMETER, "Asset not found: " + strName);
+    result << data;
+}
+
+/** getaddressutxos <string address> <string asset>: the chain height and tip
+ * hash, then the address index entries of the address's unspent outputs of
+ * the asset, RVN if it is empty and every asset if it is "*" */
+static void binary_getaddressutxos(CDataStream& params, CDataStream& result)
+{
+    std::string strAddress, strAsset;
+    params >> strAddress >> strAsset;
+
+    if (!fAddressIndex)
+        throw JSONRPCError(RPC_MISC_ERROR, "Address index not enabled, start with -addressindex");
+    uint160 hashBytes;
+    int type = 0;
+    if (!CMyntaAddress(strAddress).GetIndexKey(hashBytes, type))
+        throw JSONRPCError(RPC_INVALID_ADDRESS_OR_KEY, "Invalid address");
+
+    std::vector<std::pair<CAddressUnspentKey, CAddressUnspentValue> > unspentOutputs;
+    bool fRead = strAsset == "*" ? GetAddressUnspent(hashBytes, type, unspentOutputs)
+        : GetAddressUnspent(hashBytes, type, strAsset.empty() ? RVN : strAsset, unspentOutputs);
+    if (!fRead)
+        throw JSONRPCError(RPC_INVALID_ADDRESS_OR_KEY, "No information available for address");
+    std::sort(unspentOutputs.begin(), unspentOutputs.end(), [](const std::pair<CAddressUnspentKey, CAddressUnspentValue>& a, const std::pair<CAddressUnspentKey, CAddressUnspentValue>& b) {
+        return a.second.blockHeight < b.second.blockHeight;
+    });
+
+    int32_t nHeight;
+    uint256 hashTip;
+    {
+        LOCK(cs_main);
+        nHeight = chainActive.Height();
+        hashTip = chainActive.Tip()->GetBlockHash();
+    }
+    result << nHeight << hashTip << unspentOutputs;
+}
+
+/** verifykawpowshares <vector<CKawpowShare> shares>: a CKawpowShareResult
+ * per share, in order */
+static void binary_verifykawpowshares(CDataStream& params, CDataStream& result)
+{
+    std::vector<CKawpowShare> vShares;
+    params >> vShares;
+    result << VerifyKawpowSharesRPC(vShares);
+}
+
+static const struct {
+    const char* name;
+    binaryrpcfn_type actor;
+} vBinaryRPCMethods[] = {
+    {"getblockheader", binary_getblockheader},
+    {"getrawtransaction", binary_getrawtransaction},
+    {"getassetdata", binary_getassetdata},
+    {"getaddressutxos", binary_getaddressutxos},
+    {"verifykawpowshares", binary_verifykawpowshares},
+};
+
+binaryrpcfn_type GetBinaryRPCMethod(const std::string& strMethod)
+{
+    // Only methods the JSON-RPC table serves have a binary form
+    if (!tableRPC[strMethod])
+        return nullptr;
+    for (unsigned int i = 0; i < ARRAYLEN(vBinaryRPCMethods); i++) {
+        if (strMethod == vBinaryRPCMethods[i].name)
+            return vBinaryRPCMethods[i].actor;
+    }
+    return nullptr;
+}
+
+static void ExecuteBinaryRPCCall(const CBinaryRPCCall& call, CBinaryRPCReply& reply)
+{
+    std::string strWarmupStatus;
+    if (RPCIsInWarmup(&strWarmupStatus))
+        throw JSONRPCError(RPC_IN_WARMUP, strWarmupStatus);
+    binaryrpcfn_type actor = GetBinaryRPCMethod(call.strMethod);
+    if (!actor)
+        throw JSONRPCError(RPC_METHOD_NOT_FOUND, "Method not found");
+
+    CDataStream params(call.vParams, SER_NETWORK, PROTOCOL_VERSION);
+    CDataStream result(SER_NETWORK, PROTOCOL_VERSION | RPCSerializationFlags());
+    try {
+        actor(params, result);
+    } catch (const std::ios_base::failure&) {
+        throw JSONRPCError(RPC_INVALID_PARAMS, "Invalid parameters");
+    }
+    reply.vResult.assign(result.begin(), result.end());
+}
+
+std::string ExecuteBinaryRPC(const std::string& strBody)
+{
+    CDataStream ssRequest(strBody.data(), strBody.data() + strBody.size(), SER_NETWORK, PROTOCOL_VERSION);
+    uint64_t nCalls = ReadCompactSize(ssRequest);
+    if (nCalls > MAX_BINARY_RPC_CALLS)
+        throw std::ios_base::failure(strprintf("Too many calls in one request (max: %u)", MAX_BINARY_RPC_CALLS));
+
+    CDataStream ssReply(SER_NETWORK, PROTOCOL_VERSION);
+    WriteCompactSize(ssReply, nCalls);
+    for (uint64_t i = 0; i < nCalls; i++) {
+        CBinaryRPCCall call;
+        ssRequest >> call;
+
+        CBinaryRPCReply reply;
+        reply.nId = call.nId;
+        try {
+            ExecuteBinaryRPCCall(call, reply);
+        } catch (const UniValue& objError) {
+            reply.nCode = find_value(objError, "code").get_int();
+            reply.strError = find_value(objError, "message").get_str();
+        } catch (const std::exception& e) {
+            reply.nCode = RPC_MISC_ERROR;
+            reply.strError = e.what();
+        }
+        ssReply << reply;
+    }
+    return ssReply.str();
+}
@@ -0,0 +1,82 @@
+// Copyright (c) 2026 The Mynta Core Developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#ifndef MYNTA_RPC_BINARY_H
+#define MYNTA_RPC_BINARY_H
+
+#include "serialize.h"
+#include "streams.h"
+
+#include <stdint.h>
+#include <string>
+#include <vector>
+
+/** Most calls carried by one binary RPC request */
+static const size_t MAX_BINARY_RPC_CALLS = 1000;
+
+/**
+ * One call in a binary RPC request. The parameters and the result are the
+ * network serialization of the method's native types, so neither side goes
+ * through JSON or hex. Calls are answered in order and tagged with the id the
+ * client gave them, so one request body can carry many lookups.
+ */
+class CBinaryRPCCall
+{
+public:
+    uint32_t nId;
+    std::string strMethod;
+    std::vector<unsigned char> vParams;
+
+    CBinaryRPCCall() : nId(0) {}
+
+    ADD_SERIALIZE_METHODS;
+
+    template <typename Stream, typename Operation>
+    inline void SerializationOp(Stream& s, Operation ser_action)
+    {
+        READWRITE(nId);
+        READWRITE(strMethod);
+        READWRITE(vParams);
+    }
+};
+
+/** The answer to a CBinaryRPCCall: a result, or the JSON-RPC error code and message */
+class CBinaryRPCReply
+{
+public:
+    uint32_t nId;
+    //! 0 on success, otherwise an RPCErrorCode
+    int32_t nCode;
+    std::vector<unsigned char> vResult;
+    std::string strError;
+
+    CBinaryRPCReply() : nId(0), nCode(0) {}
+
+    ADD_SERIALIZE_METHODS;
+
+    template <typename Stream, typename Operation>
+    inline void SerializationOp(Stream& s, Operation ser_action)
+    {
+        READWRITE(nId);
+        READWRITE(nCode);
+        READWRITE(vResult);
+        READWRITE(strError);
+    }
+};
+
+/** Reads a method's parameters from the first stream and writes its result to
+ * the second. Errors are thrown with JSONRPCError, as for JSON-RPC methods. */
+typedef void (*binaryrpcfn_type)(CDataStream& params, CDataStream& result);
+
+/** The binary form of a JSON-RPC method, or nullptr if it has none */
+binaryrpcfn_type GetBinaryRPCMethod(const std::string& strMethod);
+
+/**
+ * Run every call of a serialized std::vector<CBinaryRPCCall> and return the
+ * serialized std::vector<CBinaryRPCReply>. A call failing only fails its own
+ * reply; a body that can't be parsed throws std::ios_base::failure.
+ */
+std::string ExecuteBinaryRPC(const std::string& strBody);
+
+#endif // MYNTA_RPC_BINARY_H
@@ -11,13 +11,17 @@
 #include "chain.h"
 #include "chainparams.h"
 #include "checkpoints.h"
+#include "clientversion.h"
+#include "coinstats.h"
 #include "coins.h"
 #include "consensus/validation.h"
 #include "validation.h"
 #include "core_io.h"
 #include "policy/feerate.h"
 #include "policy/policy.h"
+#include "primitives/blockview.h"
 #include "primitives/transaction.h"
+#include "rpc/jsonstream.h"
 #include "rpc/server.h"
 #include "script/script.h"
 #include "script/script_error.h"
@@ -27,9 +31,12 @@
 #include "sync.h"
 #include "txdb.h"
 #include "txmempool.h"
+#include "txoutsnapshot.h"
 #include "util.h"
 #include "utilstrencodings.h"
+#include "validationstats.h"
 #include "hash.h"
+#include "memorybudget.h"
 #include "warnings.h"
 
 #include <stdint.h>
@@ -94,10 +101,11 @@ UniValue blockheaderToJSON(const CBlockIndex* blockindex)
     result.push_back(Pair("height", blockindex->nHeight));
     result.push_back(Pair("version", blockindex->nVersion));
     result.push_back(Pair("versionHex", strprintf("%08x", blockindex->nVersion)));
-    result.push_back(Pair("merkleroot", blockindex->hashMerkleRoot.GetHex()));
+    const CBlockIndexColdData cold = blockindex->GetColdData();
+    result.push_back(Pair("merkleroot", cold.hashMerkleRoot.GetHex()));
     result.push_back(Pair("time", (int64_t)blockindex->nTime));
     result.push_back(Pair("mediantime", (int64_t)blockindex->GetMedianTimePast()));
-    result.push_back(Pair("nonce", (uint64_t)blockindex->nNonce));
+    result.push_back(Pair("nonce", (uint64_t)cold.nNonce));
     result.push_back(Pair("bits", strprintf("%08x", blockindex->nBits)));
     result.push_back(Pair("difficulty", GetDifficulty(blockindex)));
     result.push_back(Pair("chainwork", blockindex->nChainWork.GetHex()));
@@ -216,7 +224,8 @@ UniValue blockToDeltasJSON(const CBlock& block, const CBlockIndex* blockindex)
     return result;
 }
 
-UniValue blockToJSON(const CBlock& block, const CBlockIndex* blockindex, bool txDetails)
+/** Everything blockToJSON reports but the transactions, with an empty "tx" array in their place */
+static UniValue blockFieldsToJSON(const CBlock& block, const CBlockIndex* blockindex)
 {
     UniValue result(UniValue::VOBJ);
     result.push_back(Pair("hash", blockindex->GetBlockHash().GetHex()));
@@ -232,19 +241,7 @@ UniValue blockToJSON(const CBlock& block, const CBlockIndex* blockindex, bool tx
     result.push_back(Pair("version", block.nVersion));
     result.push_back(Pair("versionHex", strprintf("%08x", block.nVersion)));
     result.push_back(Pair("merkleroot", block.hashMerkleRoot.GetHex()));
-    UniValue txs(UniValue::VARR);
-    for(const auto& tx : block.vtx)
-    {
-        if(txDetails)
-        {
-            UniValue objTx(UniValue::VOBJ);
-            TxToUniv(*tx, uint256(), objTx, true, RPCSerializationFlags());
-            txs.push_back(objTx);
-        }
-        else
-            txs.push_back(tx->GetHash().GetHex());
-    }
-    result.push_back(Pair("tx", txs));
+    result.push_back(Pair("tx", UniValue(UniValue::VARR)));
     result.push_back(Pair("time", block.GetBlockTime()));
     result.push_back(Pair("mediantime", (int64_t)blockindex->GetMedianTimePast()));
     result.push_back(Pair("nonce", (uint64_t)block.nNonce));
@@ -263,6 +260,84 @@ UniValue blockToJSON(const CBlock& block, const CBlockIndex* blockindex, bool tx
     return result;
 }
 
+static UniValue blockTxToJSON(const CTransaction& tx, bool txDetails)
+{
+    if (!txDetails)
+        return tx.GetHash().GetHex();
+    UniValue objTx(UniValue::VOBJ);
+    TxToUniv(tx, uint256(), objTx, true, RPCSerializationFlags());
+    return objTx;
+}
+
+UniValue blockToJSON(const CBlock& block, const CBlockIndex* blockindex, bool txDetails)
+{
+    UniValue result = blockFieldsToJSON(block, blockindex);
+    UniValue txs(UniValue::VARR);
+    for(const auto& tx : block.vtx)
+        txs.push_back(blockTxToJSON(*tx, txDetails));
+    result.pushKV("tx", txs);
+    return result;
+}
+
+void blockToJSON(CJSONStreamWriter& stream, const CBlock& block, const CBlockIndex* blockindex, bool txDetails)
+{
+    UniValue fields = blockFieldsToJSON(block, blockindex);
+    const std::vector<std::string>& keys = fields.getKeys();
+    const std::vector<UniValue>& values = fields.getValues();
+    stream.BeginObject();
+    for (size_t i = 0; i < keys.size(); i++) {
+        if (keys[i] != "tx") {
+            stream.KeyValue(keys[i], values[i]);
+            continue;
+        }
+        stream.Key("tx");
+        stream.BeginArray();
+        for (const auto& tx : block.vtx)
+            stream.Value(blockTxToJSON(*tx, txDetails));
+        stream.EndArray();
+    }
+    stream.EndObject();
+}
+
+UniValue blockViewToJSON(const CBlockView& view, const CBlockIndex* blockindex)
+{
+    const CBlockHeader& header = view.GetHeader();
+    UniValue result(UniValue::VOBJ);
+    result.push_back(Pair("hash", blockindex->GetBlockHash().GetHex()));
+    int confirmations = -1;
+    // Only report confirmations if the block is on the main chain
+    if (chainActive.Contains(blockindex))
+        confirmations = chainActive.Height() - blockindex->nHeight + 1;
+    result.push_back(Pair("confirmations", confirmations));
+    result.push_back(Pair("strippedsize", (int)view.GetStrippedSize()));
+    result.push_back(Pair("size", (int)view.GetTotalSize()));
+    result.push_back(Pair("weight", (int)view.GetWeight()));
+    result.push_back(Pair("height", blockindex->nHeight));
+    result.push_back(Pair("version", header.nVersion));
+    result.push_back(Pair("versionHex", strprintf("%08x", header.nVersion)));
+    result.push_back(Pair("merkleroot", header.hashMerkleRoot.GetHex()));
+    UniValue txs(UniValue::VARR);
+    for (const auto& tx : view.GetTransactions())
+        txs.push_back(tx.GetHash().GetHex());
+    result.push_back(Pair("tx", txs));
+    result.push_back(Pair("time", header.GetBlockTime()));
+    result.push_back(Pair("mediantime", (int64_t)blockindex->GetMedianTimePast()));
+    result.push_back(Pair("nonce", (uint64_t)header.nNonce));
+    result.push_back(Pair("bits", strprintf("%08x", header.nBits)));
+    result.push_back(Pair("difficulty", GetDifficulty(blockindex)));
+    result.push_back(Pair("chainwork", blockindex->nChainWork.GetHex()));
+    result.push_back(Pair("headerhash", header.GetKAWPOWHeaderHash().GetHex()));
+    result.push_back(Pair("mixhash", header.mix_hash.GetHex()));
+    result.push_back(Pair("nonce64", (uint64_t)header.nNonce64));
+
+    if (blockindex->pprev)
+        result.push_back(Pair("previousblockhash", blockindex->pprev->GetBlockHash().GetHex()));
+    CBlockIndex *pnext = chainActive.Next(blockindex);
+    if (pnext)
+        result.push_back(Pair("nextblockhash", pnext->GetBlockHash().GetHex()));
+    return result;
+}
+
 UniValue decodeblockToJSON(const CBlock& block)
 {
     UniValue result(UniValue::VOBJ);
@@ -556,20 +631,53 @@ UniValue mempoolToJSON(bool fVerbose)
     }
 }
 
+void mempoolToJSON(CJSONStreamWriter& stream, bool fVerbose)
+{
+    if (fVerbose)
+    {
+        LOCK(mempool.cs);
+        stream.BeginObject();
+        for (const CTxMemPoolEntry& e : mempool.mapTx)
+        {
+            UniValue info(UniValue::VOBJ);
+            entryToJSON(info, e);
+            stream.KeyValue(e.GetTx().GetHash().ToString(), info);
+        }
+        stream.EndObject();
+    }
+    else
+    {
+        std::vector<uint256> vtxid;
+        mempool.queryHashes(vtxid);
+
+        stream.BeginArray();
+        for (const uint256& hash : vtxid)
+            stream.Value(hash.ToString());
+        stream.EndArray();
+    }
+}
+
 UniValue getrawmempool(const JSONRPCRequest& request)
 {
-    if (request.fHelp || request.params.size() > 1)
+    if (request.fHelp || request.params.size() > 2)
         throw std::runtime_error(
-            "getrawmempool ( verbose )\n"
+            "getrawmempool ( verbose mempool_sequence )\n"
             "\nReturns all transaction ids in memory pool as a json array of string transaction ids.\n"
             "\nHint: use getmempoolentry to fetch a specific transaction from the mempool.\n"
             "\nArguments:\n"
             "1. verbose (boolean, optional, default=false) True for a json object, false for array of transaction ids\n"
+            "2. mempool_sequence (boolean, optional, default=false) With verbose = false, also return the mempool event sequence\n"
+            "   the ids were taken at, to follow with getmempoolevents\n"
             "\nResult: (for verbose = false):\n"
             "[                     (json array of string)\n"
             "  \"transactionid\"     (string) The transaction id\n"
             "  ,...\n"
             "]\n"
+            "\nResult: (for verbose = false and mempool_sequence = true):\n"
+            "{\n"
+            "  \"txids\": [ \"transactionid\", ... ],  (json array of string) The transaction ids\n"
+            "  \"mempool_sequence\": n             (numeric) Sequence of the last mempool event they include\n"
+            "}\n"
             "\nResult: (for verbose = true):\n"
             "{                           (json object)\n"
             "  \"transactionid\" : {       (json object)\n"
@@ -585,6 +693,20 @@ UniValue getrawmempool(const JSONRPCRequest& request)
     if (!request.params[0].isNull())
         fVerbose = request.params[0].get_bool();
 
+    if (!request.params[1].isNull() && request.params[1].get_bool()) {
+        if (fVerbose)
+            throw JSONRPCError(RPC_INVALID_PARAMETER, "Verbose results cannot contain mempool sequence values");
+        LOCK(mempool.cs);
+        UniValue o(UniValue::VOBJ);
+        o.push_back(Pair("txids", mempoolToJSON(false)));
+        o.push_back(Pair("mempool_sequence", mempool.GetEventSequence()));
+        return o;
+    }
+
+    if (request.stream) {
+        mempoolToJSON(*request.stream, fVerbose);
+        return NullUniValue;
+    }
     return mempoolToJSON(fVerbose);
 }
 
@@ -716,6 +838,114 @@ UniValue getmempooldescendants(const JSONRPCRequest& request)
     }
 }
 
+static void PushStrings(UniValue& o, const std::string& strKey, const std::vector<std::string>& vStrings)
+{
+    if (vStrings.empty())
+        return;
+    UniValue a(UniValue::VARR);
+    for (const std::string& str : vStrings)
+        a.push_back(str);
+    o.push_back(Pair(strKey, a));
+}
+
+static void PushAddressAssets(UniValue& o, const std::string& strKey, const std::vector<std::pair<std::string, std::string>>& vPairs)
+{
+    if (vPairs.empty())
+        return;
+    UniValue a(UniValue::VARR);
+    for (const auto& pair : vPairs) {
+        UniValue entry(UniValue::VOBJ);
+        entry.push_back(Pair("address", pair.first));
+        entry.push_back(Pair("asset", pair.second));
+        a.push_back(entry);
+    }
+    o.push_back(Pair(strKey, a));
+}
+
+static UniValue MempoolEventToJSON(const CMempoolEvent& event)
+{
+    UniValue o(UniValue::VOBJ);
+    o.push_back(Pair("sequence", event.nSequence));
+    o.push_back(Pair("type", event.nType == CMempoolEvent::ADDED ? "added" : "removed"));
+    o.push_back(Pair("txid", event.txid.GetHex()));
+    if (event.nType == CMempoolEvent::REMOVED)
+        o.push_back(Pair("reason", RemovalReasonToString((MemPoolRemovalReason)event.nReason)));
+    if (event.assetRecord) {
+        const CMempoolAssetRecord& record = *event.assetRecord;
+        UniValue assets(UniValue::VOBJ);
+        if (!record.strNewAsset.empty())
+            assets.push_back(Pair("issued", record.strNewAsset));
+        PushStrings(assets, "qualifier_addresses", record.vQualifierAddresses);
+        PushStrings(assets, "verifier_assets", record.vVerifierAssets);
+        PushStrings(assets, "global_frozen_assets", record.vGlobalFrozenAssets);
+        PushAddressAssets(assets, "frozen_addresses", record.vFrozenAddresses);
+        PushStrings(assets, "global_freezes", record.vGlobalFreezes);
+        PushStrings(assets, "global_unfreezes", record.vGlobalUnfreezes);
+        PushAddressAssets(assets, "added_tags", record.vAddedTags);
+        PushAddressAssets(assets, "removed_tags", record.vRemovedTags);
+        PushStrings(assets, "verifier_changes", record.vVerifierChanges);
+        PushAddressAssets(assets, "address_freezes", record.vAddressFreezes);
+        o.push_back(Pair("assets", assets));
+    }
+    return o;
+}
+
+UniValue getmempoolevents(const JSONRPCRequest& request)
+{
+    if (request.fHelp || request.params.size() < 1 || request.params.size() > 2) {
+        throw std::runtime_error(
+            "getmempoolevents since ( count )\n"
+            "\nReturns the transactions that entered and left the mempool after the event numbered since, in order.\n"
+            "Start from the mempool_sequence of getrawmempool false true, then pass the sequence of the last event\n"
+            "returned, to keep a copy of the mempool exact without listing it again. The same events are published\n"
+            "with -zmqpubmempoolevent.\n"
+            "\nArguments:\n"
+            "1. since     (numeric, required) Sequence of the last event already applied\n"
+            "2. count     (numeric, optional, default=1000) Most events to return\n"
+            "\nResult:\n"
+            "{\n"
+            "  \"sequence\": n,          (numeric) Sequence of the last event so far\n"
+            "  \"events\": [\n"
+            "    {\n"
+            "      \"sequence\": n,      (numeric) Sequence of the event, one more than the one before\n"
+            "      \"type\": \"xxxx\",     (string) \"added\" or \"removed\"\n"
+            "      \"txid\": \"hash\",     (string) The transaction id\n"
+            "      \"reason\": \"xxxx\",   (string) For removals: expiry, sizelimit, reorg, block, conflict, replaced or unknown\n"
+            "      \"assets\": {...}     (json object, optional) The asset names and addresses the mempool's asset\n"
+            "                          indexes hold the transaction under, such as \"issued\", \"added_tags\" or \"global_freezes\"\n"
+            "    }, ...\n"
+            "  ]\n"
+            "}\n"
+            "\nExamples:\n"
+            + HelpExampleCli("getmempoolevents", "1200")
+            + HelpExampleRpc("getmempoolevents", "1200, 100")
+        );
+    }
+
+    int64_t nSince = request.params[0].get_int64();
+    if (nSince < 0)
+        throw JSONRPCError(RPC_INVALID_PARAMETER, "since must not be negative");
+    int nCount = 1000;
+    if (!request.params[1].isNull())
+        nCount = request.params[1].get_int();
+    if (nCount <= 0)
+        throw JSONRPCError(RPC_INVALID_PARAMETER, "count must be positive");
+
+    std::vector<CMempoolEvent> vEvents;
+    uint64_t nSequence = mempool.GetEventSequence();
+    if (!mempool.GetEventsSince(nSince, nCount, vEvents))
+        throw JSONRPCError(RPC_INVALID_PARAMETER, strprintf("Events after %d are no longer kept, start over from getrawmempool false true", nSince));
+
+    UniValue events(UniValue::VARR);
+    for (const CMempoolEvent& event : vEvents)
+        events.push_back(MempoolEventToJSON(event));
+
+    UniValue result(UniValue::VOBJ);
+    result.push_back(Pair("sequence", std::max(nSequence, vEvents.empty() ? 0 : vEvents.back().nSequence)));
+    result.push_back(Pair("events", events));
+    return result;
+}
+
 UniValue getmempoolentry(const JSONRPCRequest& request)
 {
     if (request.fHelp || request.params.size() != 1) {
@@ -785,6 +1015,8 @@ UniValue getblockhashes(const JSONRPCRequest& request)
             "    {\n"
             "      \"noOrphans\":true   (boolean) will only include blocks on the main chain\n"
             "      \"logicalTimes\":true   (boolean) will include logical timestamps with hashes\n"
+            "      \"count\":n   (numeric) return no more than n hashes\n"
+            "      \"start_after\":\"hash\"   (string) continue after this block, the last of the previous page\n"
             "    }\n"
             "\nResult:\n"
             "[\n"
@@ -800,32 +1032,50 @@ UniValue getblockhashes(const JSONRPCRequest& request)
             + HelpExampleCli("getblockhashes", "1231614698 1231024505")
             + HelpExampleRpc("getblockhashes", "1231614698, 1231024505")
             + HelpExampleCli("getblockhashes", "1231614698 1231024505 '{\"noOrphans\":false, \"logicalTimes\":true}'")
+            + HelpExampleCli("getblockhashes", "1231614698 1231024505 '{\"count\":1000, \"start_after\":\"hash\"}'")
             );
 
     unsigned int high = request.params[0].get_int();
     unsigned int low = request.params[1].get_int();
     bool fActiveOnly = false;
     bool fLogicalTS = false;
+    size_t nCount = std::numeric_limits<size_t>::max();
+    uint256 hashStartAfter;
 
     if (request.params.size() > 2) {
         if (request.params[2].isObject()) {
             UniValue noOrphans = find_value(request.params[2].get_obj(), "noOrphans");
             UniValue returnLogical = find_value(request.params[2].get_obj(), "logicalTimes");
+            UniValue count = find_value(request.params[2].get_obj(), "count");
+            UniValue startAfter = find_value(request.params[2].get_obj(), "start_after");
 
             if (noOrphans.isBool())
                 fActiveOnly = noOrphans.get_bool();
 
             if (returnLogical.isBool())
                 fLogicalTS = returnLogical.get_bool();
+
+            if (!count.isNull()) {
+                if (count.get_int() < 1)
+                    throw JSONRPCError(RPC_INVALID_PARAMETER, "count must be positive");
+                nCount = count.get_int();
+            }
+
+            if (!startAfter.isNull())
+                hashStartAfter = ParseHashV(startAfter, "start_after");
         }
     }
 
     std::vector<std::pair<uint256, unsigned int> > blockHashes;
 
-    if (fActiveOnly)
+    bool fFound;
+    if (fActiveOnly) {
         LOCK(cs_main);
-
-    if (!GetTimestampIndex(high, low, fActiveOnly, blockHashes)) {
+        fFound = GetTimestampIndex(high, low, fActiveOnly, blockHashes, nCount, hashStartAfter);
+    } else {
+        fFound = GetTimestampIndex(high, low, fActiveOnly, blockHashes, nCount, hashStartAfter);
+    }
+    if (!fFound) {
         throw JSONRPCError(RPC_INVALID_ADDRESS_OR_KEY, "No information available for block hashes");
     }
 
@@ -1001,6 +1251,18 @@ UniValue getblock(const JSONRPCRequest& request)
     if (fHavePruned && !(pblockindex->nStatus & BLOCK_HAVE_DATA) && pblockindex->nTx > 0)
         throw JSONRPCError(RPC_MISC_ERROR, "Block not available (pruned data)");
 
+    // The raw hex and the txid-only object don't need the transactions
+    // deserialized; work straight from the bytes on disk
+    if (verbosity == 1 || (verbosity <= 0 && RPCSerializationFlags() == 0)) {
+        std::vector<unsigned char> vBlockData;
+        CBlockView view;
+        if (!ReadBlockViewFromDisk(view, vBlockData, pblockindex, GetParams().MessageStart()))
+            throw JSONRPCError(RPC_MISC_ERROR, "Block not found on disk");
+        if (verbosity <= 0)
+            return HexStr(vBlockData.begin(), vBlockData.end());
+        return blockViewToJSON(view, pblockindex);
+    }
+
     if (!ReadBlockFromDisk(block, pblockindex, GetParams().GetConsensus()))
         // Block not found on disk. This could be because we have the block
         // header in our index but don't have the block (for example if a
@@ -1017,6 +1279,10 @@ UniValue getblock(const JSONRPCRequest& request)
         return strHex;
     }
 
+    if (request.stream) {
+        blockToJSON(*request.stream, block, pblockindex, verbosity >= 2);
+        return NullUniValue;
+    }
     return blockToJSON(block, pblockindex, verbosity >= 2);
 }
 
@@ -1059,77 +1325,6 @@ UniValue decodeblock(const JSONRPCRequest& request)
 
 
 
-struct CCoinsStats
-{
-    int nHeight;
-    uint256 hashBlock;
-    uint64_t nTransactions;
-    uint64_t nTransactionOutputs;
-    uint64_t nBogoSize;
-    uint256 hashSerialized;
-    uint64_t nDiskSize;
-    CAmount nTotalAmount;
-
-    CCoinsStats() : nHeight(0), nTransactions(0), nTransactionOutputs(0), nBogoSize(0), nDiskSize(0), nTotalAmount(0) {}
-};
-
-static void ApplyStats(CCoinsStats &stats, CHashWriter& ss, const uint256& hash, const std::map<uint32_t, Coin>& outputs)
-{
-    assert(!outputs.empty());
-    ss << hash;
-    ss << VARINT(outputs.begin()->second.nHeight * 2 + outputs.begin()->second.fCoinBase);
-    stats.nTransactions++;
-    for (const auto output : outputs) {
-        ss << VARINT(output.first + 1);
-        ss << output.second.out.scriptPubKey;
-        ss << VARINT(output.second.out.nValue);
-        stats.nTransactionOutputs++;
-        stats.nTotalAmount += output.second.out.nValue;
-        stats.nBogoSize += 32 /* txid */ + 4 /* vout index */ + 4 /* height + coinbase */ + 8 /* amount */ +
-                           2 /* scriptPubKey len */ + output.second.out.scriptPubKey.size() /* scriptPubKey */;
-    }
-    ss << VARINT(0);
-}
-
-//! Calculate statistics about the unspent transaction output set
-static bool GetUTXOStats(CCoinsView *view, CCoinsStats &stats)
-{
-    std::unique_ptr<CCoinsViewCursor> pcursor(view->Cursor());
-    assert(pcursor);
-
-    CHashWriter ss(SER_GETHASH, PROTOCOL_VERSION);
-    stats.hashBlock = pcursor->GetBestBlock();
-    {
-        LOCK(cs_main);
-        stats.nHeight = mapBlockIndex.find(stats.hashBlock)->second->nHeight;
-    }
-    ss << stats.hashBlock;
-    uint256 prevkey;
-    std::map<uint32_t, Coin> outputs;
-    while (pcursor->Valid()) {
-        boost::this_thread::interruption_point();
-        COutPoint key;
-        Coin coin;
-        if (pcursor->GetKey(key) && pcursor->GetValue(coin)) {
-            if (!outputs.empty() && key.hash != prevkey) {
-                ApplyStats(stats, ss, prevkey, outputs);
-                outputs.clear();
-            }
-            prevkey = key.hash;
-            outputs[key.n] = std::move(coin);
-        } else {
-            return error("%s: unable to read value", __func__);
-        }
-        pcursor->Next();
-    }
-    if (!outputs.empty()) {
-        ApplyStats(stats, ss, prevkey, outputs);
-    }
-    stats.hashSerialized = ss.GetHash();
-    stats.nDiskSize = view->EstimateSize();
-    return true;
-}
-
 UniValue pruneblockchain(const JSONRPCRequest& request)
 {
     if (request.fHelp || request.params.size() != 1)
@@ -1181,11 +1376,16 @@ UniValue pruneblockchain(const JSONRPCRequest& request)
 
 UniValue gettxoutsetinfo(const JSONRPCRequest& request)
 {
-    if (request.fHelp || request.params.size() != 0)
+    if (request.fHelp || request.params.size() > 2)
         throw std::runtime_error(
-            "gettxoutsetinfo\n"
+            "gettxoutsetinfo ( \"hash_type\" assets )\n"
             "\nReturns statistics about the unspent transaction output set.\n"
-            "Note this call may take some time.\n"
+            "Note this call may take some time. Unless hash_type is hash_serialized_2, the set is read\n"
+            "by several threads at once.\n"
+            "\nArguments:\n"
+            "1. \"hash_type\"  (string, optional, default=hash_serialized_2) Which hash of the set to compute:\n"
+            "                 hash_serialized_2, muhash (which doesn't depend on the order of the coins) or none\n"
+            "2. assets         (boolean, optional, default=false) Also break the set down by asset\n"
             "\nResult:\n"
             "{\n"
             "  \"height\":n,     (numeric) The current block height (index)\n"
@@ -1193,34 +1393,139 @@ UniValue gettxoutsetinfo(const JSONRPCRequest& request)
             "  \"transactions\": n,      (numeric) The number of transactions\n"
             "  \"txouts\": n,            (numeric) The number of output transactions\n"
             "  \"bogosize\": n,          (numeric) A meaningless metric for UTXO set size\n"
-            "  \"hash_serialized_2\": \"hash\", (string) The serialized hash\n"
+            "  \"hash_serialized_2\": \"hash\", (string) The serialized hash (only with hash_type hash_serialized_2)\n"
+            "  \"muhash\": \"hash\",     (string) The MuHash3072 of the set (only with hash_type muhash)\n"
             "  \"disk_size\": n,         (numeric) The estimated size of the chainstate on disk\n"
-            "  \"total_amount\": x.xxx          (numeric) The total amount\n"
+            "  \"total_amount\": x.xxx,  (numeric) The total amount\n"
+            "  \"assets\": [             (array, only with assets) Unspent outputs of each asset\n"
+            "    {\n"
+            "      \"name\": \"name\",     (string) The asset name\n"
+            "      \"amount\": x.xxx,    (numeric) The amount of the asset in unspent outputs\n"
+            "      \"txouts\": n,        (numeric) The number of unspent outputs holding the asset\n"
+            "      \"holders\": n        (numeric) The number of distinct addresses holding the asset\n"
+            "    }, ...\n"
+            "  ]\n"
             "}\n"
             "\nExamples:\n"
             + HelpExampleCli("gettxoutsetinfo", "")
-            + HelpExampleRpc("gettxoutsetinfo", "")
+            + HelpExampleCli("gettxoutsetinfo", "\"muhash\" true")
+            + HelpExampleRpc("gettxoutsetinfo", "\"none\", true")
         );
 
-    UniValue ret(UniValue::VOBJ);
+    CoinStatsHashType hashType = CoinStatsHashType::HASH_SERIALIZED;
+    if (!request.params[0].isNull() && !CoinStatsHashTypeByName(request.params[0].get_str(), hashType))
+        throw JSONRPCError(RPC_INVALID_PARAMETER, strprintf("Unknown hash_type %s", request.params[0].get_str()));
+    const bool fAssets = !request.params[1].isNull() && request.params[1].get_bool();
+
+    // The snapshot is taken right after a flush, before another can start
+    std::shared_ptr<const CDBSnapshot> snapshot;
+    {
+        LOCK(cs_main);
+        FlushStateToDisk();
+        snapshot = pcoinsdbview->GetSnapshot();
+    }
 
     CCoinsStats stats;
-    FlushStateToDisk();
-    if (GetUTXOStats(pcoinsdbview, stats)) {
-        ret.push_back(Pair("height", (int64_t)stats.nHeight));
-        ret.push_back(Pair("bestblock", stats.hashBlock.GetHex()));
-        ret.push_back(Pair("transactions", (int64_t)stats.nTransactions));
-        ret.push_back(Pair("txouts", (int64_t)stats.nTransactionOutputs));
-        ret.push_back(Pair("bogosize", (int64_t)stats.nBogoSize));
-        ret.push_back(Pair("hash_serialized_2", stats.hashSerialized.GetHex()));
-        ret.push_back(Pair("disk_size", stats.nDiskSize));
-        ret.push_back(Pair("total_amount", ValueFromAmount(stats.nTotalAmount)));
-    } else {
+    if (!GetUTXOStats(pcoinsdbview, snapshot, stats, hashType, fAssets, GetNumCores()))
         throw JSONRPCError(RPC_INTERNAL_ERROR, "Unable to read UTXO set");
+    {
+        LOCK(cs_main);
+        BlockMap::const_iterator it = mapBlockIndex.find(stats.hashBlock);
+        if (it != mapBlockIndex.end())
+            stats.nHeight = it->second->nHeight;
+    }
+
+    UniValue ret(UniValue::VOBJ);
+    ret.push_back(Pair("height", (int64_t)stats.nHeight));
+    ret.push_back(Pair("bestblock", stats.hashBlock.GetHex()));
+    ret.push_back(Pair("transactions", (int64_t)stats.nTransactions));
+    ret.push_back(Pair("txouts", (int64_t)stats.nTransactionOutputs));
+    ret.push_back(Pair("bogosize", (int64_t)stats.nBogoSize));
+    if (hashType == CoinStatsHashType::HASH_SERIALIZED)
+        ret.push_back(Pair("hash_serialized_2", stats.hashSerialized.GetHex()));
+    else if (hashType == CoinStatsHashType::MUHASH)
+        ret.push_back(Pair("muhash", stats.hashSerialized.GetHex()));
+    ret.push_back(Pair("disk_size", stats.nDiskSize));
+    ret.push_back(Pair("total_amount", ValueFromAmount(stats.nTotalAmount)));
+    if (fAssets) {
+        UniValue assets(UniValue::VARR);
+        for (const auto& asset : stats.mapAssets) {
+            UniValue entry(UniValue::VOBJ);
+            entry.push_back(Pair("name", asset.first));
+            entry.push_back(Pair("amount", ValueFromAmount(asset.second.nAmount)));
+            entry.push_back(Pair("txouts", (int64_t)asset.second.nOutputs));
+            entry.push_back(Pair("holders", (int64_t)asset.second.nHolders));
+            assets.push_back(entry);
+        }
+        ret.push_back(Pair("assets", assets));
     }
     return ret;
 }
 
+UniValue dumptxoutset(const JSONRPCRequest& request)
+{
+    if (request.fHelp || request.params.size() != 1)
+        throw std::runtime_error(
+            "dumptxoutset \"path\"\n"
+            "\nWrites a snapshot of the unspent transaction output set and the asset, restricted asset\n"
+            "and evo databases at the current tip. The file ends with a hash of its contents.\n"
+            "Note this call may take some time.\n"
+            "\nArguments:\n"
+            "1. \"path\"    (string, required) The file to write, relative to the working directory if not absolute\n"
+            "\nResult:\n"
+            "{\n"
+            "  \"base_hash\": \"hex\",       (string) the block the snapshot was taken at\n"
+            "  \"base_height\": n,          (numeric) the height of that block\n"
+            "  \"coins_written\": n,        (numeric) the number of coins written\n"
+            "  \"asset_entries\": n,        (numeric) the number of asset database entries written\n"
+            "  \"restricted_entries\": n,   (numeric) the number of restricted asset database entries written\n"
+            "  \"evo_entries\": n,          (numeric) the number of evo database entries written\n"
+            "  \"snapshot_hash\": \"hex\",   (string) the hash the file ends with\n"
+            "  \"path\": \"path\"            (string) the absolute path of the file\n"
+            "}\n"
+            "\nExamples:\n"
+            + HelpExampleCli("dumptxoutset", "\"utxo.dat\"")
+            + HelpExampleRpc("dumptxoutset", "\"utxo.dat\"")
+        );
+
+    const fs::path path = fs::absolute(request.params[0].get_str());
+    const fs::path pathTemp = path.string() + ".incomplete";
+    if (fs::exists(path))
+        throw JSONRPCError(RPC_INVALID_PARAMETER, path.string() + " already exists. If you are sure this is what you want, move it out of the way first");
+
+    CAutoFile file(fsbridge::fopen(pathTemp, "wb"), SER_DISK, CLIENT_VERSION);
+    if (file.IsNull())
+        throw JSONRPCError(RPC_INVALID_PARAMETER, "Unable to open " + pathTemp.string() + " for writing");
+
+    CTxOutSnapshotStats stats;
+    std::string strError;
+    bool fWritten = DumpTxOutSnapshot(file, stats, strError);
+    if (fWritten) {
+        if (fflush(file.Get()) != 0) {
+            fWritten = false;
+            strError = "failed to flush " + pathTemp.string();
+        } else {
+            FileCommit(file.Get());
+        }
+    }
+    file.fclose();
+    if (!fWritten || !RenameOver(pathTemp, path)) {
+        fs::remove(pathTemp);
+        throw JSONRPCError(RPC_MISC_ERROR, strError.empty() ? "Unable to rename " + pathTemp.string() : strError);
+    }
+
+    UniValue ret(UniValue::VOBJ);
+    ret.push_back(Pair("base_hash", stats.metadata.hashBaseBlock.GetHex()));
+    ret.push_back(Pair("base_height", stats.metadata.nBaseHeight));
+    ret.push_back(Pair("coins_written", (int64_t)stats.nCoins));
+    ret.push_back(Pair("asset_entries", (int64_t)stats.mapEntries[TxOutSnapshotSection::ASSETS]));
+    ret.push_back(Pair("restricted_entries", (int64_t)stats.mapEntries[TxOutSnapshotSection::RESTRICTED]));
+    ret.push_back(Pair("evo_entries", (int64_t)stats.mapEntries[TxOutSnapshotSection::EVO]));
+    ret.push_back(Pair("snapshot_hash", stats.hashSnapshot.GetHex()));
+    ret.push_back(Pair("path", path.string()));
+    return ret;
+}
+
 UniValue gettxout(const JSONRPCRequest& request)
 {
     if (request.fHelp || request.params.size() < 2 || request.params.size() > 3)
@@ -1629,6 +1934,27 @@ UniValue getchaintips(const JSONRPCRequest& request)
     return res;
 }
 
+UniValue memoryBudgetToJSON()
+{
+    UniValue ret(UniValue::VOBJ);
+    UniValue consumers(UniValue::VOBJ);
+    uint64_t nTotal = 0;
+    for (const CMemoryConsumerStats& stats : g_memoryBudget.GetStats()) {
+        UniValue consumer(UniValue::VOBJ);
+        consumer.push_back(Pair("bytes", (uint64_t)stats.nUsage));
+        consumer.push_back(Pair("evictable", stats.fEvictable));
+        consumer.push_back(Pair("evictions", stats.nEvictions));
+        consumer.push_back(Pair("evicted_bytes", stats.nEvictedBytes));
+        consumers.push_back(Pair(stats.strName, consumer));
+        nTotal += stats.nUsage;
+    }
+    ret.push_back(Pair("budget", (uint64_t)g_memoryBudget.GetBudget()));
+    ret.push_back(Pair("usage", nTotal));
+    ret.push_back(Pair("pressure_events", g_memoryBudget.GetPressureEvents()));
+    ret.push_back(Pair("caches", consumers));
+    return ret;
+}
+
 UniValue mempoolInfoToJSON()
 {
     UniValue ret(UniValue::VOBJ);
@@ -1639,6 +1965,16 @@ UniValue mempoolInfoToJSON()
     ret.push_back(Pair("maxmempool", (int64_t) maxmempool));
     ret.push_back(Pair("mempoolminfee", ValueFromAmount(mempool.GetMinFee(maxmempool).GetFeePerK())));
 
+    ScriptCacheStats stats = GetScriptCacheStats();
+    uint64_t nLookups = stats.nHits + stats.nFlagHits + stats.nMisses;
+    UniValue scriptcache(UniValue::VOBJ);
+    scriptcache.push_back(Pair("hits", stats.nHits));
+    scriptcache.push_back(Pair("flaghits", stats.nFlagHits));
+    scriptcache.push_back(Pair("misses", stats.nMisses));
+    scriptcache.push_back(Pair("hitrate", nLookups ? (double)(stats.nHits + stats.nFlagHits) / nLookups : 0.0));
+    scriptcache.push_back(Pair("validatedtxs", (uint64_t)stats.nValidatedTxs));
+    ret.push_back(Pair("scriptcache", scriptcache));
+
     return ret;
 }
 
@@ -1654,7 +1990,14 @@ UniValue getmempoolinfo(const JSONRPCRequest& request)
             "  \"bytes\": xxxxx,              (numeric) Sum of all virtual transaction sizes as defined in BIP 141. Differs from actual serialized size because witness data is discounted\n"
             "  \"usage\": xxxxx,              (numeric) Total memory usage for the mempool\n"
             "  \"maxmempool\": xxxxx,         (numeric) Maximum memory usage for the mempool\n"
-            "  \"mempoolminfee\": xxxxx       (numeric) Minimum fee rate in " + CURRENCY_UNIT + "/kB for tx to be accepted\n"
+            "  \"mempoolminfee\": xxxxx,      (numeric) Minimum fee rate in " + CURRENCY_UNIT + "/kB for tx to be accepted\n"
+            "  \"scriptcache\": {             (json object) Transaction scripts met again while connecting blocks\n"
+            "    \"hits\": xxxxx,               (numeric) Skipped, already executed with the block's script flags\n"
+            "    \"flaghits\": xxxxx,           (numeric) Skipped, accepted to the mempool under stricter flags\n"
+            "    \"misses\": xxxxx,             (numeric) Executed\n"
+            "    \"hitrate\": x.xxx,            (numeric) Share of transactions skipped\n"
+            "    \"validatedtxs\": xxxxx        (numeric) Accepted transactions whose script flags are remembered\n"
+            "  }\n"
             "}\n"
             "\nExamples:\n"
             + HelpExampleCli("getmempoolinfo", "")
@@ -1856,6 +2199,71 @@ UniValue getchaintxstats(const JSONRPCRequest& request)
     return ret;
 }
 
+UniValue getvalidationstats(const JSONRPCRequest& request)
+{
+    if (request.fHelp || request.params.size() > 2)
+        throw std::runtime_error(
+            "getvalidationstats ( \"format\" reset )\n"
+            "\nReturns how long blocks spent in each phase of validation since startup or the last reset.\n"
+            "Percentiles are rounded up to the end of a bucket, so are within about 19% of the exact value.\n"
+            "The phases inside connect_block run within it, and asset_checks within connect_txs.\n"
+            "\nArguments:\n"
+            "1. \"format\"   (string, optional, default=\"json\") \"json\", or \"prometheus\" for the Prometheus text format\n"
+            "2. reset      (boolean, optional, default=false) Forget the samples after returning them\n"
+            "\nResult (json format):\n"
+            "{\n"
+            "  \"phase\": {             (json object) one for each phase, such as check_block or script_verify\n"
+            "    \"count\": n,          (numeric) the number of blocks timed\n"
+            "    \"total_ms\": x.xxx,   (numeric) the time spent in total\n"
+            "    \"mean_ms\": x.xxx,    (numeric) the mean time per block\n"
+            "    \"p50_ms\": x.xxx,     (numeric) the median time\n"
+            "    \"p90_ms\": x.xxx,     (numeric) the 90th percentile\n"
+            "    \"p99_ms\": x.xxx,     (numeric) the 99th percentile\n"
+            "    \"max_ms\": x.xxx      (numeric) the longest time\n"
+            "  },\n"
+            "  ...\n"
+            "}\n"
+            "\nResult (prometheus format):\n"
+            "\"text\"                  (string) a summary metric named mynta_validation_phase_seconds\n"
+            "\nExamples:\n"
+            + HelpExampleCli("getvalidationstats", "")
+            + HelpExampleCli("getvalidationstats", "\"prometheus\"")
+            + HelpExampleRpc("getvalidationstats", "\"json\", true")
+        );
+
+    std::string strFormat = "json";
+    if (!request.params[0].isNull())
+        strFormat = request.params[0].get_str();
+    if (strFormat != "json" && strFormat != "prometheus")
+        throw JSONRPCError(RPC_INVALID_PARAMETER, "Unknown format " + strFormat);
+    bool fReset = false;
+    if (!request.params[1].isNull())
+        fReset = request.params[1].get_bool();
+
+    UniValue ret;
+    if (strFormat == "prometheus") {
+        ret = ValidationStatsToPrometheus();
+    } else {
+        ret = UniValue(UniValue::VOBJ);
+        for (size_t i = 0; i < VALIDATION_PHASE_COUNT; i++) {
+            const ValidationPhase phase = static_cast<ValidationPhase>(i);
+            const CValidationPhaseStats stats = GetValidationPhaseStats(phase);
+            UniValue obj(UniValue::VOBJ);
+            obj.push_back(Pair("count", stats.nCount));
+            obj.push_back(Pair("total_ms", stats.nTotalMicros * 0.001));
+            obj.push_back(Pair("mean_ms", stats.nCount ? stats.nTotalMicros * 0.001 / stats.nCount : 0.0));
+            obj.push_back(Pair("p50_ms", stats.nP50Micros * 0.001));
+            obj.push_back(Pair("p90_ms", stats.nP90Micros * 0.001));
+            obj.push_back(Pair("p99_ms", stats.nP99Micros * 0.001));
+            obj.push_back(Pair("max_ms", stats.nMaxMicros * 0.001));
+            ret.push_back(Pair(ValidationPhaseName(phase), obj));
+        }
+    }
+    if (fReset)
+        ResetValidationStats();
+    return ret;
+}
+
 UniValue savemempool(const JSONRPCRequest& request)
 {
     if (request.fHelp || request.params.size() != 0) {
@@ -1898,6 +2306,7 @@ static const CRPCCommand commands[] =
 { //  category              name                      actor (function)         argNames
   //  --------------------- ------------------------  -----------------------  ----------
     { "blockchain",         "clearmempool",           &clearmempool,           {} },
+    { "blockchain",         "dumptxoutset",           &dumptxoutset,           {"path"} },
     { "blockchain",         "getblockchaininfo",      &getblockchaininfo,      {} },
     { "blockchain",         "getchaintxstats",        &getchaintxstats,        {"nblocks", "blockhash"} },
     { "blockchain",         "getbestblockhash",       &getbestblockhash,       {} },
@@ -1914,9 +2323,11 @@ static const CRPCCommand commands[] =
     { "blockchain",         "getmempooldescendants",  &getmempooldescendants,  {"txid","verbose"} },
     { "blockchain",         "getmempoolentry",        &getmempoolentry,        {"txid"} },
     { "blockchain",         "getmempoolinfo",         &getmempoolinfo,         {} },
-    { "blockchain",         "getrawmempool",          &getrawmempool,          {"verbose"} },
+    { "blockchain",         "getrawmempool",          &getrawmempool,          {"verbose","mempool_sequence"} },
+    { "blockchain",         "getmempoolevents",       &getmempoolevents,       {"since","count"} },
     { "blockchain",         "gettxout",               &gettxout,               {"txid","n","include_mempool"} },
-    { "blockchain",         "gettxoutsetinfo",        &gettxoutsetinfo,        {} },
+    { "blockchain",         "gettxoutsetinfo",        &gettxoutsetinfo,        {"hash_type","assets"} },
+    { "blockchain",         "getvalidationstats",     &getvalidationstats,     {"format","reset"} },
     { "blockchain",         "pruneblockchain",        &pruneblockchain,        {"height"} },
     { "blockchain",         "savemempool",            &savemempool,            {} },
     { "blockchain",         "verifychain",            &verifychain,            {"checklevel","nblocks"} },
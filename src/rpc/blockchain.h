@@ -10,6 +10,8 @@
 
 class CBlock;
 class CBlockIndex;
+class CBlockView;
+class CJSONStreamWriter;
 class UniValue;
 
 
@@ -30,13 +32,22 @@ void RPCNotifyBlockChange(bool ibd, const CBlockIndex *);
 
 /** Block description to JSON */
 UniValue blockToJSON(const CBlock& block, const CBlockIndex* blockindex, bool txDetails = false);
+/** Same as blockToJSON, written to stream one transaction at a time */
+void blockToJSON(CJSONStreamWriter& stream, const CBlock& block, const CBlockIndex* blockindex, bool txDetails = false);
 UniValue decodeblockToJSON(const CBlock& block);
 
+/** Same as blockToJSON without transaction details, built from a block parsed in place */
+UniValue blockViewToJSON(const CBlockView& view, const CBlockIndex* blockindex);
+
 /** Mempool information to JSON */
 UniValue mempoolInfoToJSON();
 
+/** Memory budget and the usage of every cache counted against it to JSON */
+UniValue memoryBudgetToJSON();
+
 /** Mempool to JSON */
 UniValue mempoolToJSON(bool fVerbose = false);
+void mempoolToJSON(CJSONStreamWriter& stream, bool fVerbose = false);
 
 /** Block header to JSON */
 UniValue blockheaderToJSON(const CBlockIndex* blockindex);
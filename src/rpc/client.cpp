@@ -128,6 +128,10 @@ static const CRPCConvertParam vRPCConvertParams[] =
     { "getblock", 1, "verbose" },
     { "getblockheader", 1, "verbose" },
     { "getchaintxstats", 0, "nblocks" },
+    { "getvalidationstats", 1, "reset" },
+    { "getlockstats", 0, "count" },
+    { "getlockstats", 1, "reset" },
+    { "getschedulerstats", 0, "reset" },
     { "gettransaction", 1, "include_watchonly" },
     { "getrawtransaction", 1, "verbose" },
     { "createrawtransaction", 0, "inputs" },
@@ -143,6 +147,7 @@ static const CRPCConvertParam vRPCConvertParams[] =
     { "fundrawtransaction", 1, "options" },
     { "gettxout", 1, "n" },
     { "gettxout", 2, "include_mempool" },
+    { "gettxoutsetinfo", 1, "assets" },
     { "gettxoutproof", 0, "txids" },
     { "lockunspent", 0, "unlock" },
     { "lockunspent", 1, "transactions" },
@@ -157,6 +162,9 @@ static const CRPCConvertParam vRPCConvertParams[] =
     { "pruneblockchain", 0, "height" },
     { "keypoolrefill", 0, "newsize" },
     { "getrawmempool", 0, "verbose" },
+    { "getrawmempool", 1, "mempool_sequence" },
+    { "getmempoolevents", 0, "since" },
+    { "getmempoolevents", 1, "count" },
     { "estimatefee", 0, "nblocks" },
     { "estimatesmartfee", 0, "conf_target" },
     { "estimaterawfee", 0, "conf_target" },
@@ -203,7 +211,16 @@ static const CRPCConvertParam vRPCConvertParams[] =
     { "listassetbalancesbyaddress", 1, "totalonly"},
     { "listassetbalancesbyaddress", 2, "count"},
     { "listassetbalancesbyaddress", 3, "start"},
+    { "listuniqueassets", 1, "onlytotal"},
+    { "listuniqueassets", 2, "count"},
+    { "listuniqueassets", 3, "start"},
+    { "listassetchildren", 1, "onlytotal"},
+    { "listassetchildren", 2, "count"},
+    { "listassetchildren", 3, "start"},
     { "sendmessage", 2, "expire_time"},
+    { "viewallmessages", 1, "start_height"},
+    { "viewallmessages", 2, "count"},
+    { "clearmessages", 1, "before_height"},
     { "requestsnapshot", 1, "block_height"},
     { "getsnapshotrequest", 1, "block_height"},
     { "listsnapshotrequests", 1, "block_height"},
@@ -216,6 +233,7 @@ static const CRPCConvertParam vRPCConvertParams[] =
     { "purgesnapshot", 1, "block_height"},
     { "stop", 0, "wait"},
     { "getkawpowhash", 3, "height"},
+    { "verifykawpowshares", 0, "shares"},
 };
 
 class CRPCConvertTable
@@ -2,11 +2,13 @@
 // Distributed under the MIT software license, see the accompanying
 // file COPYING or http://www.opensource.org/licenses/mit-license.php.
 
+#include "arith_uint256.h"
 #include "assets/atomicswap.h"
 #include "assets/assets.h"
 #include "base58.h"
 #include "chain.h"
 #include "core_io.h"
+#include "dextradeindex.h"
 #include "hash.h"
 #include "init.h"
 #include "rpc/server.h"
@@ -26,22 +28,33 @@
 
 UniValue dex_orderbook(const JSONRPCRequest& request)
 {
-    if (request.fHelp || request.params.size() < 1 || request.params.size() > 2)
+    if (request.fHelp || request.params.size() < 1 || request.params.size() > 3)
         throw std::runtime_error(
-            "dex orderbook \"base_asset\" ( \"quote_asset\" )\n"
+            "dex orderbook \"base_asset\" ( \"quote_asset\" depth )\n"
             "\nGet the order book for a trading pair.\n"
             "\nArguments:\n"
             "1. \"base_asset\"     (string, required) The base asset (or \"MYNTA\")\n"
             "2. \"quote_asset\"    (string, optional, default=\"MYNTA\") The quote asset\n"
+            "3. depth            (numeric, optional, default=0) Price levels to return per side, 0 for all\n"
             "\nResult:\n"
             "{\n"
             "  \"pair\": \"BASE/QUOTE\",\n"
-            "  \"bids\": [...],\n"
-            "  \"asks\": [...]\n"
+            "  \"bids\": [...],          (array) Offers buying the base asset, best first\n"
+            "  \"asks\": [...],          (array) Offers selling the base asset, best first\n"
+            "  \"bidLevels\": [          (array) Bids aggregated by price\n"
+            "    {\n"
+            "      \"rate\": n,           (numeric) takerAmount / makerAmount of every offer in the level\n"
+            "      \"makerAmount\": n,    (numeric) Total offered\n"
+            "      \"takerAmount\": n,    (numeric) Total asked for\n"
+            "      \"offers\": n          (numeric) Number of offers\n"
+            "    }, ...\n"
+            "  ],\n"
+            "  \"askLevels\": [...]      (array) Asks aggregated by price\n"
             "}\n"
             "\nExamples:\n"
             + HelpExampleCli("dex", "orderbook \"MYTOKEN\"")
             + HelpExampleCli("dex", "orderbook \"MYTOKEN\" \"MYNTA\"")
+            + HelpExampleCli("dex", "orderbook \"MYTOKEN\" \"MYNTA\" 10")
         );
 
     std::string baseAsset = request.params[0].get_str();
@@ -51,6 +64,14 @@ UniValue dex_orderbook(const JSONRPCRequest& request)
         quoteAsset = request.params[1].get_str();
     }
     
+    int nDepth = 0;
+    if (request.params.size() >= 3) {
+        nDepth = request.params[2].get_int();
+        if (nDepth < 0) {
+            throw JSONRPCError(RPC_INVALID_PARAMETER, "depth must not be negative");
+        }
+    }
+    
     // Normalize "MYNTA" to empty string for internal use
     if (baseAsset == "MYNTA") baseAsset = "";
     if (quoteAsset == "MYNTA") quoteAsset = "";
@@ -59,7 +80,7 @@ UniValue dex_orderbook(const JSONRPCRequest& request)
         throw JSONRPCError(RPC_INTERNAL_ERROR, "Order book not initialized");
     }
     
-    return atomicSwapOrderBook->GetOrderBookJson(baseAsset, quoteAsset);
+    return atomicSwapOrderBook->GetOrderBookJson(baseAsset, quoteAsset, nDepth);
 }
 
 UniValue dex_createoffer(const JSONRPCRequest& request)
@@ -263,23 +284,218 @@ UniValue dex_canceloffer(const JSONRPCRequest& request)
     return result;
 }
 
+namespace {
+std::string NormalizeDexAsset(const std::string& strAsset)
+{
+    return strAsset.empty() ? "MYNTA" : strAsset;
+}
+
+void EnsureDexIndex()
+{
+    if (!pdextradeindex)
+        throw JSONRPCError(RPC_MISC_ERROR, "DEX trade index not enabled, start with -dexindex");
+}
+
+uint32_t DexTimeFromValue(const UniValue& value)
+{
+    int64_t nTime = value.get_int64();
+    if (nTime < 0 || nTime > std::numeric_limits<uint32_t>::max())
+        throw JSONRPCError(RPC_INVALID_PARAMETER, "Time out of range");
+    return nTime;
+}
+
+//! The price of the pair the other way round, quote per whole unit of base
+CAmount InvertDexPrice(CAmount nPrice)
+{
+    if (nPrice <= 0)
+        return 0;
+    return (arith_uint256((uint64_t)COIN) * (uint64_t)COIN / (uint64_t)nPrice).GetLow64();
+}
+
+UniValue DexTradeToJSON(CDexTrade trade, bool fInvert)
+{
+    if (fInvert) {
+        std::swap(trade.strBase, trade.strQuote);
+        std::swap(trade.nBaseAmount, trade.nQuoteAmount);
+    }
+    UniValue obj(UniValue::VOBJ);
+    obj.pushKV("pair", trade.strBase + "/" + trade.strQuote);
+    obj.pushKV("price", ValueFromAmount(trade.GetPrice()));
+    obj.pushKV("baseAmount", ValueFromAmount(trade.nBaseAmount));
+    obj.pushKV("quoteAmount", ValueFromAmount(trade.nQuoteAmount));
+    obj.pushKV("height", trade.nHeight);
+    obj.pushKV("time", (int64_t)trade.nTime);
+    obj.pushKV("hashLock", trade.hashLock.ToString());
+    obj.pushKV("txid", trade.txid.ToString());
+    return obj;
+}
+
+UniValue DexCandleToJSON(const CDexCandle& candle, bool fInvert)
+{
+    UniValue obj(UniValue::VOBJ);
+    obj.pushKV("time", (int64_t)candle.nStart);
+    obj.pushKV("open", ValueFromAmount(fInvert ? InvertDexPrice(candle.nOpen) : candle.nOpen));
+    obj.pushKV("high", ValueFromAmount(fInvert ? InvertDexPrice(candle.nLow) : candle.nHigh));
+    obj.pushKV("low", ValueFromAmount(fInvert ? InvertDexPrice(candle.nHigh) : candle.nLow));
+    obj.pushKV("close", ValueFromAmount(fInvert ? InvertDexPrice(candle.nClose) : candle.nClose));
+    obj.pushKV("baseVolume", ValueFromAmount(fInvert ? candle.nQuoteVolume : candle.nBaseVolume));
+    obj.pushKV("quoteVolume", ValueFromAmount(fInvert ? candle.nBaseVolume : candle.nQuoteVolume));
+    obj.pushKV("trades", (int64_t)candle.nTrades);
+    return obj;
+}
+} // namespace
+
 UniValue dex_listtrades(const JSONRPCRequest& request)
 {
-    if (request.fHelp || request.params.size() > 2)
+    if (request.fHelp || request.params.size() > 5)
         throw std::runtime_error(
-            "dex listtrades ( \"asset\" count )\n"
-            "\nList recent trades.\n"
+            "dex listtrades ( \"base_asset\" \"quote_asset\" count start_time end_time )\n"
+            "\nList filled swaps, newest first. Requires -dexindex.\n"
+            "A swap is filled once both of its HTLCs are claimed.\n"
             "\nArguments:\n"
-            "1. \"asset\"     (string, optional) Filter by asset\n"
-            "2. count         (numeric, optional, default=50) Number of trades to return\n"
+            "1. \"base_asset\"     (string, optional) The base asset (or \"MYNTA\"), all pairs if not given\n"
+            "2. \"quote_asset\"    (string, optional, default=\"MYNTA\") The quote asset\n"
+            "3. count            (numeric, optional, default=50) Number of trades to return\n"
+            "4. start_time       (numeric, optional, default=0) Oldest block time to include, for a pair only\n"
+            "5. end_time         (numeric, optional) Newest block time to include, for a pair only\n"
             "\nResult:\n"
-            "[...]\n"
+            "[\n"
+            "  {\n"
+            "    \"pair\": \"BASE/QUOTE\",\n"
+            "    \"price\": n,          (numeric) Quote amount per unit of base\n"
+            "    \"baseAmount\": n,     (numeric) Base amount swapped\n"
+            "    \"quoteAmount\": n,    (numeric) Quote amount swapped\n"
+            "    \"height\": n,         (numeric) Height of the block completing the swap\n"
+            "    \"time\": n,           (numeric) Time of that block\n"
+            "    \"hashLock\": \"hash\",  (string) Hash lock of the swap's HTLCs\n"
+            "    \"txid\": \"hash\"       (string) The claim completing the swap\n"
+            "  }, ...\n"
+            "]\n"
             "\nExamples:\n"
             + HelpExampleCli("dex", "listtrades")
+            + HelpExampleCli("dex", "listtrades \"MYTOKEN\" \"MYNTA\" 10")
+            + HelpExampleCli("dex", "listtrades \"MYTOKEN\" \"MYNTA\" 100 1767225600 1767312000")
+        );
+
+    EnsureDexIndex();
+
+    size_t nCount = 50;
+    if (request.params.size() >= 3) {
+        int nCountIn = request.params[2].get_int();
+        if (nCountIn <= 0) {
+            throw JSONRPCError(RPC_INVALID_PARAMETER, "count must be positive");
+        }
+        nCount = nCountIn;
+    }
+
+    std::vector<CDexTrade> vTrades;
+    UniValue result(UniValue::VARR);
+    if (request.params.size() < 1) {
+        if (!pdextradeindex->GetRecentTrades(nCount, vTrades)) {
+            throw JSONRPCError(RPC_DATABASE_ERROR, "Failed to read the DEX trade index");
+        }
+        for (const CDexTrade& trade : vTrades) {
+            result.push_back(DexTradeToJSON(trade, false));
+        }
+        return result;
+    }
+
+    std::string baseAsset = NormalizeDexAsset(request.params[0].get_str());
+    std::string quoteAsset = request.params.size() >= 2 ? NormalizeDexAsset(request.params[1].get_str()) : "MYNTA";
+    if (baseAsset == quoteAsset) {
+        throw JSONRPCError(RPC_INVALID_PARAMETER, "Base and quote asset must differ");
+    }
+    uint32_t nStartTime = request.params.size() >= 4 ? DexTimeFromValue(request.params[3]) : 0;
+    uint32_t nEndTime = request.params.size() >= 5 ? DexTimeFromValue(request.params[4]) : std::numeric_limits<uint32_t>::max();
+
+    // The index keeps each pair one way round, like the order book's pair keys
+    const bool fInvert = quoteAsset < baseAsset;
+    if (fInvert) {
+        std::swap(baseAsset, quoteAsset);
+    }
+    if (!pdextradeindex->GetTrades(baseAsset, quoteAsset, nStartTime, nEndTime, nCount, vTrades)) {
+        throw JSONRPCError(RPC_DATABASE_ERROR, "Failed to read the DEX trade index");
+    }
+    for (const CDexTrade& trade : vTrades) {
+        result.push_back(DexTradeToJSON(trade, fInvert));
+    }
+    return result;
+}
+
+UniValue dex_ohlcv(const JSONRPCRequest& request)
+{
+    if (request.fHelp || request.params.size() < 1 || request.params.size() > 6)
+        throw std::runtime_error(
+            "dex ohlcv \"base_asset\" ( \"quote_asset\" \"interval\" start_time end_time count )\n"
+            "\nOpen, high, low and close price and volume of a pair's trades by time bucket, oldest first.\n"
+            "Only buckets with trades are returned. Requires -dexindex.\n"
+            "\nArguments:\n"
+            "1. \"base_asset\"     (string, required) The base asset (or \"MYNTA\")\n"
+            "2. \"quote_asset\"    (string, optional, default=\"MYNTA\") The quote asset\n"
+            "3. \"interval\"       (string, optional, default=\"1h\") Bucket length: \"1m\", \"1h\" or \"1d\"\n"
+            "4. start_time       (numeric, optional, default=0) Time in the first bucket to return\n"
+            "5. end_time         (numeric, optional) Time in the last bucket to return\n"
+            "6. count            (numeric, optional, default=1000) Most buckets to return\n"
+            "\nResult:\n"
+            "[\n"
+            "  {\n"
+            "    \"time\": n,           (numeric) Start of the bucket\n"
+            "    \"open\": n,           (numeric) Price of the first trade\n"
+            "    \"high\": n,           (numeric) Highest price\n"
+            "    \"low\": n,            (numeric) Lowest price\n"
+            "    \"close\": n,          (numeric) Price of the last trade\n"
+            "    \"baseVolume\": n,     (numeric) Base amount traded\n"
+            "    \"quoteVolume\": n,    (numeric) Quote amount traded\n"
+            "    \"trades\": n          (numeric) Number of trades\n"
+            "  }, ...\n"
+            "]\n"
+            "\nExamples:\n"
+            + HelpExampleCli("dex", "ohlcv \"MYTOKEN\"")
+            + HelpExampleCli("dex", "ohlcv \"MYTOKEN\" \"MYNTA\" \"1d\" 1767225600")
         );
 
-    // TODO: Implement trade history
+    EnsureDexIndex();
+
+    std::string baseAsset = NormalizeDexAsset(request.params[0].get_str());
+    std::string quoteAsset = request.params.size() >= 2 ? NormalizeDexAsset(request.params[1].get_str()) : "MYNTA";
+    if (baseAsset == quoteAsset) {
+        throw JSONRPCError(RPC_INVALID_PARAMETER, "Base and quote asset must differ");
+    }
+
+    uint32_t nInterval = 60 * 60;
+    if (request.params.size() >= 3) {
+        const std::string strInterval = request.params[2].get_str();
+        if (strInterval == "1m") {
+            nInterval = 60;
+        } else if (strInterval == "1d") {
+            nInterval = 24 * 60 * 60;
+        } else if (strInterval != "1h") {
+            throw JSONRPCError(RPC_INVALID_PARAMETER, "Unknown interval: " + strInterval);
+        }
+    }
+    uint32_t nStartTime = request.params.size() >= 4 ? DexTimeFromValue(request.params[3]) : 0;
+    uint32_t nEndTime = request.params.size() >= 5 ? DexTimeFromValue(request.params[4]) : std::numeric_limits<uint32_t>::max();
+    size_t nCount = 1000;
+    if (request.params.size() >= 6) {
+        int nCountIn = request.params[5].get_int();
+        if (nCountIn <= 0) {
+            throw JSONRPCError(RPC_INVALID_PARAMETER, "count must be positive");
+        }
+        nCount = nCountIn;
+    }
+
+    const bool fInvert = quoteAsset < baseAsset;
+    if (fInvert) {
+        std::swap(baseAsset, quoteAsset);
+    }
+    std::vector<CDexCandle> vCandles;
+    if (!pdextradeindex->GetCandles(baseAsset, quoteAsset, nInterval, nStartTime, nEndTime, nCount, vCandles)) {
+        throw JSONRPCError(RPC_DATABASE_ERROR, "Failed to read the DEX trade index");
+    }
     UniValue result(UniValue::VARR);
+    for (const CDexCandle& candle : vCandles) {
+        result.push_back(DexCandleToJSON(candle, fInvert));
+    }
     return result;
 }
 
@@ -419,6 +635,7 @@ UniValue dex(const JSONRPCRequest& request)
             "  takeoffer     - Accept an existing offer\n"
             "  canceloffer   - Cancel your offer\n"
             "  listtrades    - List recent trades\n"
+            "  ohlcv         - Price and volume of a pair by time bucket\n"
         );
     }
 
@@ -438,6 +655,8 @@ UniValue dex(const JSONRPCRequest& request)
         return dex_canceloffer(newRequest);
     } else if (strCommand == "listtrades") {
         return dex_listtrades(newRequest);
+    } else if (strCommand == "ohlcv") {
+        return dex_ohlcv(newRequest);
     }
 
     throw JSONRPCError(RPC_INVALID_PARAMETER, "Unknown dex command: " + strCommand);
@@ -0,0 +1,96 @@
+// Copyright (c) 2026 The Mynta Core Developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include "rpc/jsonstream.h"
+
+#include <assert.h>
+
+CJSONStreamWriter::CJSONStreamWriter(Sink sinkIn, size_t nFlushSizeIn) : sink(std::move(sinkIn)), nFlushSize(nFlushSizeIn)
+{
+}
+
+void CJSONStreamWriter::Append(const std::string& str)
+{
+    strBuffer += str;
+    if (strBuffer.size() >= nFlushSize)
+        Flush();
+}
+
+void CJSONStreamWriter::BeginValue()
+{
+    if (vOpen.empty()) {
+        // Only a single top level value
+        assert(!fStarted);
+        fStarted = true;
+        return;
+    }
+    if (vOpen.back().first) {
+        assert(fKeyPending);
+        fKeyPending = false;
+        return;
+    }
+    if (vOpen.back().second)
+        strBuffer += ',';
+    vOpen.back().second = true;
+}
+
+void CJSONStreamWriter::BeginObject()
+{
+    BeginValue();
+    vOpen.emplace_back(true, false);
+    Append("{");
+}
+
+void CJSONStreamWriter::EndObject()
+{
+    assert(!vOpen.empty() && vOpen.back().first && !fKeyPending);
+    vOpen.pop_back();
+    Append("}");
+}
+
+void CJSONStreamWriter::BeginArray()
+{
+    BeginValue();
+    vOpen.emplace_back(false, false);
+    Append("[");
+}
+
+void CJSONStreamWriter::EndArray()
+{
+    assert(!vOpen.empty() && !vOpen.back().first);
+    vOpen.pop_back();
+    Append("]");
+}
+
+void CJSONStreamWriter::Key(const std::string& key)
+{
+    assert(!vOpen.empty() && vOpen.back().first && !fKeyPending);
+    if (vOpen.back().second)
+        strBuffer += ',';
+    vOpen.back().second = true;
+    fKeyPending = true;
+    // A string value serializes to the escaped, quoted form a key needs
+    strBuffer += UniValue(key).write();
+    strBuffer += ':';
+}
+
+void CJSONStreamWriter::Value(const UniValue& val)
+{
+    BeginValue();
+    Append(val.write());
+}
+
+void CJSONStreamWriter::RawValue(const std::string& strJSON)
+{
+    BeginValue();
+    Append(strJSON);
+}
+
+void CJSONStreamWriter::Flush()
+{
+    if (strBuffer.empty())
+        return;
+    sink(strBuffer);
+    strBuffer.clear();
+}
@@ -0,0 +1,71 @@
+// Copyright (c) 2026 The Mynta Core Developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#ifndef MYNTA_RPC_JSONSTREAM_H
+#define MYNTA_RPC_JSONSTREAM_H
+
+#include <functional>
+#include <string>
+#include <vector>
+
+#include <univalue.h>
+
+/** Output gathered by CJSONStreamWriter before it is handed to the sink */
+static const size_t DEFAULT_JSON_STREAM_FLUSH_SIZE = 64 * 1024;
+
+/**
+ * Writes one JSON value a piece at a time, so large RPC results never have to
+ * exist as a whole UniValue tree or string. Containers are opened and closed
+ * explicitly and everything inside them is written as UniValue records, each
+ * serialized as soon as it is pushed. Output is passed to the sink in pieces
+ * of about nFlushSize bytes, and whatever is left on Flush().
+ *
+ * When JSONRPCRequest::stream is set, methods that support it write their
+ * result here and return NullUniValue instead of building it.
+ */
+class CJSONStreamWriter
+{
+public:
+    typedef std::function<void(const std::string&)> Sink;
+
+private:
+    Sink sink;
+    size_t nFlushSize;
+    std::string strBuffer;
+    //! One entry per open container: whether it is an object, and whether it has members yet
+    std::vector<std::pair<bool, bool> > vOpen;
+    bool fKeyPending{false};
+    bool fStarted{false};
+
+    void BeginValue();
+    void Append(const std::string& str);
+
+public:
+    explicit CJSONStreamWriter(Sink sinkIn, size_t nFlushSizeIn = DEFAULT_JSON_STREAM_FLUSH_SIZE);
+
+    void BeginObject();
+    void EndObject();
+    void BeginArray();
+    void EndArray();
+    //! Name the next value written into the current object
+    void Key(const std::string& key);
+    void Value(const UniValue& val);
+    //! Write a value that is already serialized to compact JSON
+    void RawValue(const std::string& strJSON);
+    void KeyValue(const std::string& key, const UniValue& val)
+    {
+        Key(key);
+        Value(val);
+    }
+
+    //! Pass everything written so far to the sink
+    void Flush();
+
+    //! Whether anything has been written (the method streamed its result)
+    bool IsStarted() const { return fStarted; }
+    //! Whether the top level value is complete
+    bool IsComplete() const { return fStarted && vOpen.empty(); }
+};
+
+#endif // MYNTA_RPC_JSONSTREAM_H
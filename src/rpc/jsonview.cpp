@@ -0,0 +1,306 @@
+// Copyright (c) 2026 The Mynta Core Developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include "rpc/jsonview.h"
+
+#include <stdexcept>
+
+bool CJSONDocument::read(const char* raw, size_t size)
+{
+    strData.assign(raw, size);
+    vNodes.clear();
+    // Offsets into strData are 32 bit
+    if (size >= UINT32_MAX / 2)
+        return false;
+
+    enum {
+        EXPECT_VALUE,
+        EXPECT_ARR_VALUE, // a value or the end of an empty array
+        EXPECT_FIRST_KEY, // a member name or the end of an empty object
+        EXPECT_KEY,
+        EXPECT_COLON,
+        EXPECT_SEP,       // a comma or the end of the open array or object
+        EXPECT_END,
+    } state = EXPECT_VALUE;
+
+    std::vector<uint32_t> vOpen;
+    Node key{};
+    std::string tokenVal;
+    unsigned int consumed;
+    const char* pos = raw;
+    const char* end = raw + size;
+
+    // Store a string token in strData: a slice of the text when it has no escapes
+    auto storeString = [&](uint32_t nText, uint32_t nTextLen, uint32_t& nVal, uint32_t& nValLen) {
+        nValLen = tokenVal.size();
+        if (tokenVal.size() + 2 == nTextLen && tokenVal.compare(0, std::string::npos, raw + nText + 1, nTextLen - 2) == 0) {
+            nVal = nText + 1;
+        } else {
+            nVal = strData.size();
+            strData += tokenVal;
+        }
+    };
+
+    while (true) {
+        enum jtokentype tok = getJsonToken(tokenVal, consumed, pos, end);
+        if (tok == JTOK_ERR)
+            break;
+        const char* pTok = pos;
+        while (pTok < pos + consumed && json_isspace(*pTok))
+            pTok++;
+        pos += consumed;
+        if (tok == JTOK_NONE) {
+            if (state != EXPECT_END)
+                break;
+            return true;
+        }
+        uint32_t nText = pTok - raw;
+        uint32_t nTextLen = pos - pTok;
+
+        if (tok == JTOK_OBJ_CLOSE || tok == JTOK_ARR_CLOSE) {
+            bool fObj = tok == JTOK_OBJ_CLOSE;
+            if (!(state == EXPECT_SEP || (fObj && state == EXPECT_FIRST_KEY) || (!fObj && state == EXPECT_ARR_VALUE)))
+                break;
+            Node& open = vNodes[vOpen.back()];
+            if (open.type != (fObj ? UniValue::VOBJ : UniValue::VARR))
+                break;
+            open.nNext = vNodes.size();
+            open.nTextLen = pos - (raw + open.nText);
+            vOpen.pop_back();
+            state = vOpen.empty() ? EXPECT_END : EXPECT_SEP;
+            continue;
+        }
+
+        switch (state) {
+        case EXPECT_END:
+            break;
+        case EXPECT_COLON:
+            if (tok != JTOK_COLON)
+                break;
+            state = EXPECT_VALUE;
+            continue;
+        case EXPECT_SEP:
+            if (tok != JTOK_COMMA)
+                break;
+            state = vNodes[vOpen.back()].type == UniValue::VOBJ ? EXPECT_KEY : EXPECT_VALUE;
+            continue;
+        case EXPECT_FIRST_KEY:
+        case EXPECT_KEY:
+            if (tok != JTOK_STRING)
+                break;
+            key.nKeyText = nText;
+            key.nKeyTextLen = nTextLen;
+            storeString(nText, nTextLen, key.nKey, key.nKeyLen);
+            state = EXPECT_COLON;
+            continue;
+        case EXPECT_VALUE:
+        case EXPECT_ARR_VALUE: {
+            if (!jsonTokenIsValue(tok) && tok != JTOK_OBJ_OPEN && tok != JTOK_ARR_OPEN)
+                break;
+            Node node{};
+            node.nText = nText;
+            node.nTextLen = nTextLen;
+            node.nNext = vNodes.size() + 1;
+            if (!vOpen.empty()) {
+                Node& parent = vNodes[vOpen.back()];
+                parent.nSize++;
+                if (parent.type == UniValue::VOBJ) {
+                    node.nKey = key.nKey;
+                    node.nKeyLen = key.nKeyLen;
+                    node.nKeyText = key.nKeyText;
+                    node.nKeyTextLen = key.nKeyTextLen;
+                }
+            }
+            switch (tok) {
+            case JTOK_OBJ_OPEN:
+                node.type = UniValue::VOBJ;
+                break;
+            case JTOK_ARR_OPEN:
+                node.type = UniValue::VARR;
+                break;
+            case JTOK_KW_NULL:
+                node.type = UniValue::VNULL;
+                break;
+            case JTOK_KW_TRUE:
+            case JTOK_KW_FALSE:
+                node.type = UniValue::VBOOL;
+                node.nVal = tok == JTOK_KW_TRUE;
+                break;
+            case JTOK_NUMBER:
+                node.type = UniValue::VNUM;
+                node.nVal = nText;
+                node.nValLen = nTextLen;
+                break;
+            default:
+                node.type = UniValue::VSTR;
+                storeString(nText, nTextLen, node.nVal, node.nValLen);
+                break;
+            }
+            vNodes.push_back(node);
+            if (node.type == UniValue::VOBJ || node.type == UniValue::VARR) {
+                vOpen.push_back(vNodes.size() - 1);
+                state = node.type == UniValue::VOBJ ? EXPECT_FIRST_KEY : EXPECT_ARR_VALUE;
+            } else {
+                state = vOpen.empty() ? EXPECT_END : EXPECT_SEP;
+            }
+            continue;
+        }
+        }
+        break;
+    }
+
+    vNodes.clear();
+    return false;
+}
+
+UniValueView::const_iterator& UniValueView::const_iterator::operator++()
+{
+    nIndex = doc->vNodes[nIndex].nNext;
+    return *this;
+}
+
+UniValue::VType UniValueView::getType() const
+{
+    if (!doc || nIndex >= doc->vNodes.size())
+        return UniValue::VNULL;
+    return doc->vNodes[nIndex].type;
+}
+
+bool UniValueView::isTrue() const
+{
+    return isBool() && doc->vNodes[nIndex].nVal != 0;
+}
+
+size_t UniValueView::size() const
+{
+    if (!isArray() && !isObject())
+        return 0;
+    return doc->vNodes[nIndex].nSize;
+}
+
+UniValueView::const_iterator UniValueView::begin() const
+{
+    if (!isArray() && !isObject())
+        return const_iterator(doc, 0);
+    return const_iterator(doc, nIndex + 1);
+}
+
+UniValueView::const_iterator UniValueView::end() const
+{
+    if (!isArray() && !isObject())
+        return const_iterator(doc, 0);
+    return const_iterator(doc, doc->vNodes[nIndex].nNext);
+}
+
+UniValueView UniValueView::operator[](size_t index) const
+{
+    if (index >= size())
+        return UniValueView();
+    const_iterator it = begin();
+    while (index--)
+        ++it;
+    return *it;
+}
+
+UniValueView UniValueView::operator[](const std::string& key) const
+{
+    if (!isObject())
+        return UniValueView();
+    for (const_iterator it = begin(); it != end(); ++it) {
+        const CJSONDocument::Node& node = doc->vNodes[(*it).nIndex];
+        if (node.nKeyLen == key.size() && key.compare(0, std::string::npos, doc->strData.data() + node.nKey, node.nKeyLen) == 0)
+            return *it;
+    }
+    return UniValueView();
+}
+
+std::string UniValueView::getKey() const
+{
+    if (!doc || nIndex >= doc->vNodes.size())
+        return "";
+    const CJSONDocument::Node& node = doc->vNodes[nIndex];
+    return doc->strData.substr(node.nKey, node.nKeyLen);
+}
+
+std::string UniValueView::getValStr() const
+{
+    if (!isStr() && !isNum())
+        return "";
+    const CJSONDocument::Node& node = doc->vNodes[nIndex];
+    return doc->strData.substr(node.nVal, node.nValLen);
+}
+
+const std::string UniValueView::get_str() const
+{
+    if (!isStr())
+        throw std::runtime_error("JSON value is not a string as expected");
+    return getValStr();
+}
+
+bool UniValueView::get_bool() const
+{
+    if (!isBool())
+        throw std::runtime_error("JSON value is not a boolean as expected");
+    return isTrue();
+}
+
+UniValue UniValueView::ToUniValue() const
+{
+    switch (getType()) {
+    case UniValue::VNULL:
+        return NullUniValue;
+    case UniValue::VBOOL:
+        return UniValue(isTrue());
+    case UniValue::VSTR:
+    case UniValue::VNUM:
+        return UniValue(getType(), getValStr());
+    case UniValue::VARR: {
+        UniValue arr(UniValue::VARR);
+        for (const UniValueView& elem : *this)
+            arr.push_back(elem.ToUniValue());
+        return arr;
+    }
+    case UniValue::VOBJ: {
+        UniValue obj(UniValue::VOBJ);
+        for (const UniValueView& member : *this)
+            obj.__pushKV(member.getKey(), member.ToUniValue());
+        return obj;
+    }
+    }
+    return NullUniValue;
+}
+
+void UniValueView::write(std::string& str) const
+{
+    UniValue::VType type = getType();
+    if (type == UniValue::VNULL) {
+        str += "null";
+        return;
+    }
+    if (type == UniValue::VBOOL) {
+        str += isTrue() ? "true" : "false";
+        return;
+    }
+    const CJSONDocument::Node& node = doc->vNodes[nIndex];
+    if (type == UniValue::VSTR || type == UniValue::VNUM) {
+        str.append(doc->strData, node.nText, node.nTextLen);
+        return;
+    }
+
+    bool fObj = type == UniValue::VOBJ;
+    str += fObj ? '{' : '[';
+    bool fFirst = true;
+    for (const UniValueView& elem : *this) {
+        if (!fFirst)
+            str += ',';
+        fFirst = false;
+        if (fObj) {
+            const CJSONDocument::Node& member = doc->vNodes[elem.nIndex];
+            str.append(doc->strData, member.nKeyText, member.nKeyTextLen);
+            str += ':';
+        }
+        elem.write(str);
+    }
+    str += fObj ? '}' : ']';
+}
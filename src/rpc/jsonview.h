@@ -0,0 +1,121 @@
+// Copyright (c) 2026 The Mynta Core Developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#ifndef MYNTA_RPC_JSONVIEW_H
+#define MYNTA_RPC_JSONVIEW_H
+
+#include <stdint.h>
+#include <string>
+#include <vector>
+
+#include <univalue.h>
+
+class CJSONDocument;
+
+/**
+ * Read-only handle to one value of a CJSONDocument, valid while the document
+ * is. Missing members and out of range elements are null views, like
+ * find_value returns NullUniValue.
+ */
+class UniValueView
+{
+    const CJSONDocument* doc;
+    uint32_t nIndex;
+
+    friend class CJSONDocument;
+    UniValueView(const CJSONDocument* docIn, uint32_t nIndexIn) : doc(docIn), nIndex(nIndexIn) {}
+
+public:
+    UniValueView() : doc(nullptr), nIndex(0) {}
+
+    class const_iterator
+    {
+        const CJSONDocument* doc;
+        uint32_t nIndex;
+
+    public:
+        const_iterator(const CJSONDocument* docIn, uint32_t nIndexIn) : doc(docIn), nIndex(nIndexIn) {}
+        UniValueView operator*() const { return UniValueView(doc, nIndex); }
+        const_iterator& operator++();
+        bool operator!=(const const_iterator& other) const { return nIndex != other.nIndex; }
+    };
+
+    UniValue::VType getType() const;
+    bool isNull() const { return getType() == UniValue::VNULL; }
+    bool isTrue() const;
+    bool isFalse() const { return isBool() && !isTrue(); }
+    bool isBool() const { return getType() == UniValue::VBOOL; }
+    bool isStr() const { return getType() == UniValue::VSTR; }
+    bool isNum() const { return getType() == UniValue::VNUM; }
+    bool isArray() const { return getType() == UniValue::VARR; }
+    bool isObject() const { return getType() == UniValue::VOBJ; }
+
+    //! Number of elements or members, 0 for anything but arrays and objects
+    size_t size() const;
+    bool empty() const { return size() == 0; }
+
+    //! Elements of an array or members of an object, in order
+    const_iterator begin() const;
+    const_iterator end() const;
+    UniValueView operator[](size_t index) const;
+    //! First member called key (the one find_value would return)
+    UniValueView operator[](const std::string& key) const;
+    //! Member name, when this is a member of an object
+    std::string getKey() const;
+
+    //! Text of a string or number
+    std::string getValStr() const;
+    const std::string get_str() const;
+    bool get_bool() const;
+
+    //! Build the UniValue for this value (and everything in it)
+    UniValue ToUniValue() const;
+    //! Append compact JSON for this value. Strings keep the escaping they were read with.
+    void write(std::string& str) const;
+};
+
+/**
+ * JSON text parsed into one flat array of nodes and one character buffer that
+ * every string, number and member name refers into. Parsing a document costs
+ * a handful of allocations however many values it has, where UniValue::read
+ * makes a node with its own string and vectors for each value and member.
+ *
+ * It accepts exactly what UniValue::read accepts, using the same tokenizer.
+ * Large requests can be looked at in place and only the parts that are needed
+ * turned into UniValues with UniValueView::ToUniValue.
+ */
+class CJSONDocument
+{
+public:
+    struct Node {
+        UniValue::VType type;
+        //! Elements or members of an array or object
+        uint32_t nSize;
+        //! Index of the node after this one and everything in it
+        uint32_t nNext;
+        //! The value as it appears in the text (strings with their quotes)
+        uint32_t nText, nTextLen;
+        //! Unescaped string, number text, or 1 for true
+        uint32_t nVal, nValLen;
+        //! Member name, unescaped and as it appears in the text, inside an object
+        uint32_t nKey, nKeyLen, nKeyText, nKeyTextLen;
+    };
+
+private:
+    //! The text read, followed by any strings that had to be unescaped
+    std::string strData;
+    std::vector<Node> vNodes;
+
+    friend class UniValueView;
+
+public:
+    bool read(const char* raw, size_t size);
+    bool read(const std::string& str) { return read(str.data(), str.size()); }
+
+    //! The top level value, a null view if nothing has been read
+    UniValueView Root() const { return UniValueView(this, 0); }
+    size_t NodeCount() const { return vNodes.size(); }
+};
+
+#endif // MYNTA_RPC_JSONVIEW_H
@@ -12,6 +12,7 @@
 #include "init.h"
 #include "net.h"
 #include "netbase.h"
+#include "rpc/jsonstream.h"
 #include "rpc/server.h"
 #include "script/sign.h"
 #include "script/standard.h"
@@ -25,6 +26,23 @@
 
 #include <univalue.h>
 
+#include <algorithm>
+#include <map>
+#include <mutex>
+#include <string.h>
+
+static std::string MNStatus(const CDeterministicMNCPtr& mn)
+{
+    if (mn->state.nRevocationReason != 0) {
+        return "REVOKED";
+    } else if (mn->state.IsBanned()) {
+        return "POSE_BANNED";
+    } else if (!mn->IsValid()) {
+        return "INVALID";
+    }
+    return "ENABLED";
+}
+
 static UniValue MNToJson(const CDeterministicMNCPtr& mn)
 {
     UniValue obj(UniValue::VOBJ);
@@ -52,21 +70,194 @@ static UniValue MNToJson(const CDeterministicMNCPtr& mn)
     }
     
     obj.pushKV("state", stateObj);
+    obj.pushKV("status", MNStatus(mn));
     
-    // Status
-    std::string status;
-    if (mn->state.nRevocationReason != 0) {
-        status = "REVOKED";
-    } else if (mn->state.IsBanned()) {
-        status = "POSE_BANNED";
-    } else if (!mn->IsValid()) {
-        status = "INVALID";
+    return obj;
+}
+
+/** How the list RPCs show each masternode */
+enum class MNListFormat {
+    JSON,   // MNToJson in an array
+    FULL,   // MNToJson in an object, by the start of the proTxHash
+    ADDR,   // service in an array
+    HASH,   // proTxHash in an array
+};
+
+/**
+ * The JSON of every masternode of one list, built once for the list of a
+ * block and shared by the list RPCs until the tip moves, as monitoring polls
+ * them every few seconds. Status, payout address and service are indexed for
+ * the exact filters, and the complete unfiltered results are kept by format,
+ * both as UniValue and as serialized text for streamed replies.
+ */
+class CMNListRPCCache
+{
+public:
+    struct Entry {
+        CDeterministicMNCPtr mn;
+        UniValue json;
+        std::string strJson;
+        std::string strPayout;
+        std::string strService;
+    };
+
+    const uint256 blockHash;
+    //! In the list's order
+    std::vector<Entry> vEntries;
+    std::multimap<std::string, size_t> mapByStatus;
+    std::multimap<std::string, size_t> mapByPayout;
+    std::multimap<std::string, size_t> mapByService;
+
+    explicit CMNListRPCCache(const CDeterministicMNList& mnList) : blockHash(mnList.GetBlockHash())
+    {
+        mnList.ForEachMN(false, [&](const CDeterministicMNCPtr& mn) {
+            Entry entry;
+            entry.mn = mn;
+            entry.json = MNToJson(mn);
+            entry.strJson = entry.json.write();
+            entry.strPayout = find_value(entry.json["state"], "payoutAddress").getValStr();
+            entry.strService = mn->state.addr.ToString();
+            mapByStatus.emplace(MNStatus(mn), vEntries.size());
+            mapByPayout.emplace(entry.strPayout, vEntries.size());
+            mapByService.emplace(entry.strService, vEntries.size());
+            vEntries.push_back(std::move(entry));
+        });
+    }
+
+    //! The complete result for format over every, or only the valid, masternodes
+    const std::pair<UniValue, std::string>& GetResult(MNListFormat format, bool fOnlyValid) const
+    {
+        std::lock_guard<std::mutex> lock(csResults);
+        auto it = mapResults.find(std::make_pair(format, fOnlyValid));
+        if (it == mapResults.end()) {
+            std::vector<size_t> vSelected;
+            for (size_t i = 0; i < vEntries.size(); i++) {
+                if (!fOnlyValid || vEntries[i].mn->IsValid()) {
+                    vSelected.push_back(i);
+                }
+            }
+            UniValue result = Build(format, vSelected);
+            std::string strResult = result.write();
+            it = mapResults.emplace(std::make_pair(format, fOnlyValid), std::make_pair(std::move(result), std::move(strResult))).first;
+        }
+        return it->second;
+    }
+
+    //! The result for format over the entries vSelected
+    UniValue Build(MNListFormat format, const std::vector<size_t>& vSelected) const
+    {
+        UniValue result(format == MNListFormat::FULL ? UniValue::VOBJ : UniValue::VARR);
+        for (size_t i : vSelected) {
+            const Entry& entry = vEntries[i];
+            switch (format) {
+            case MNListFormat::JSON: result.push_back(entry.json); break;
+            case MNListFormat::FULL: result.pushKV(entry.mn->proTxHash.ToString().substr(0, 16), entry.json); break;
+            case MNListFormat::ADDR: result.push_back(entry.strService); break;
+            case MNListFormat::HASH: result.push_back(entry.mn->proTxHash.ToString()); break;
+            }
+        }
+        return result;
+    }
+
+    //! Write the result for format over the entries vSelected, reusing their serialized JSON
+    void Stream(CJSONStreamWriter& stream, MNListFormat format, const std::vector<size_t>& vSelected) const
+    {
+        if (format == MNListFormat::FULL) {
+            stream.BeginObject();
+        } else {
+            stream.BeginArray();
+        }
+        for (size_t i : vSelected) {
+            const Entry& entry = vEntries[i];
+            switch (format) {
+            case MNListFormat::JSON: stream.RawValue(entry.strJson); break;
+            case MNListFormat::FULL:
+                stream.Key(entry.mn->proTxHash.ToString().substr(0, 16));
+                stream.RawValue(entry.strJson);
+                break;
+            case MNListFormat::ADDR: stream.Value(entry.strService); break;
+            case MNListFormat::HASH: stream.Value(entry.mn->proTxHash.ToString()); break;
+            }
+        }
+        if (format == MNListFormat::FULL) {
+            stream.EndObject();
+        } else {
+            stream.EndArray();
+        }
+    }
+
+private:
+    mutable std::mutex csResults;
+    mutable std::map<std::pair<MNListFormat, bool>, std::pair<UniValue, std::string>> mapResults;
+};
+
+static std::mutex csMNListRPCCache;
+static std::shared_ptr<const CMNListRPCCache> mnListRPCCache;
+
+//! The cache for the list at the chain tip, built if the tip moved since the last call
+static std::shared_ptr<const CMNListRPCCache> GetMNListRPCCache()
+{
+    auto mnList = deterministicMNManager->GetListAtChainTip();
+    std::lock_guard<std::mutex> lock(csMNListRPCCache);
+    if (!mnListRPCCache || mnListRPCCache->blockHash != mnList->GetBlockHash()) {
+        mnListRPCCache = std::make_shared<const CMNListRPCCache>(*mnList);
+    }
+    return mnListRPCCache;
+}
+
+/**
+ * Return a list RPC's result over the masternodes of cache that fOnlyValid and
+ * strFilter select. "status=", "payout=" and "service=" filters are exact
+ * lookups in the indexes; any other filter is a substring of the masternode's
+ * JSON, or of its service in the ADDR format.
+ */
+static UniValue MNListResult(const JSONRPCRequest& request, const CMNListRPCCache& cache, MNListFormat format, bool fOnlyValid, const std::string& strFilter)
+{
+    if (strFilter.empty()) {
+        const std::pair<UniValue, std::string>& result = cache.GetResult(format, fOnlyValid);
+        if (request.stream) {
+            request.stream->RawValue(result.second);
+            return NullUniValue;
+        }
+        return result.first;
+    }
+
+    std::vector<size_t> vSelected;
+    const std::multimap<std::string, size_t>* pindex = nullptr;
+    std::string strKey;
+    for (const auto& prefix : {std::make_pair("status=", &cache.mapByStatus), std::make_pair("payout=", &cache.mapByPayout),
+                               std::make_pair("service=", &cache.mapByService)}) {
+        if (strFilter.compare(0, strlen(prefix.first), prefix.first) == 0) {
+            pindex = prefix.second;
+            strKey = strFilter.substr(strlen(prefix.first));
+        }
+    }
+    if (pindex) {
+        auto range = pindex->equal_range(strKey);
+        for (auto it = range.first; it != range.second; ++it) {
+            vSelected.push_back(it->second);
+        }
+        std::sort(vSelected.begin(), vSelected.end());
     } else {
-        status = "ENABLED";
+        for (size_t i = 0; i < cache.vEntries.size(); i++) {
+            const CMNListRPCCache::Entry& entry = cache.vEntries[i];
+            const std::string& strSearch = format == MNListFormat::ADDR ? entry.strService : entry.strJson;
+            if (strSearch.find(strFilter) != std::string::npos) {
+                vSelected.push_back(i);
+            }
+        }
     }
-    obj.pushKV("status", status);
-    
-    return obj;
+    if (fOnlyValid) {
+        vSelected.erase(std::remove_if(vSelected.begin(), vSelected.end(), [&](size_t i) {
+            return !cache.vEntries[i].mn->IsValid();
+        }), vSelected.end());
+    }
+
+    if (request.stream) {
+        cache.Stream(*request.stream, format, vSelected);
+        return NullUniValue;
+    }
+    return cache.Build(format, vSelected);
 }
 
 UniValue masternode_list(const JSONRPCRequest& request)
@@ -81,12 +272,14 @@ UniValue masternode_list(const JSONRPCRequest& request)
             "                   json   - Returns a JSON object with all masternode details\n"
             "                   addr   - Returns list of masternode addresses\n"
             "                   full   - Returns detailed info\n"
-            "2. \"filter\"    (string, optional) Filter output by substring\n"
+            "2. \"filter\"    (string, optional) Filter output by substring, or exactly by\n"
+            "                 \"status=<status>\", \"payout=<address>\" or \"service=<ip:port>\"\n"
             "\nResult:\n"
             "Depends on mode\n"
             "\nExamples:\n"
             + HelpExampleCli("masternode", "list")
             + HelpExampleCli("masternode", "list json")
+            + HelpExampleCli("masternode", "list json status=ENABLED")
             + HelpExampleRpc("masternode", "list, \"json\"")
         );
 
@@ -104,40 +297,14 @@ UniValue masternode_list(const JSONRPCRequest& request)
         throw JSONRPCError(RPC_INTERNAL_ERROR, "Masternode manager not initialized");
     }
 
-    auto mnList = deterministicMNManager->GetListAtChainTip();
+    auto cache = GetMNListRPCCache();
 
     if (strMode == "json") {
-        UniValue result(UniValue::VARR);
-        mnList->ForEachMN(false, [&](const CDeterministicMNCPtr& mn) {
-            UniValue obj = MNToJson(mn);
-            
-            // Apply filter if specified
-            if (!strFilter.empty()) {
-                std::string jsonStr = obj.write();
-                if (jsonStr.find(strFilter) == std::string::npos) {
-                    return;
-                }
-            }
-            
-            result.push_back(obj);
-        });
-        return result;
+        return MNListResult(request, *cache, MNListFormat::JSON, false, strFilter);
     } else if (strMode == "addr") {
-        UniValue result(UniValue::VARR);
-        mnList->ForEachMN(true, [&](const CDeterministicMNCPtr& mn) {
-            std::string addr = mn->state.addr.ToString();
-            if (strFilter.empty() || addr.find(strFilter) != std::string::npos) {
-                result.push_back(addr);
-            }
-        });
-        return result;
+        return MNListResult(request, *cache, MNListFormat::ADDR, true, strFilter);
     } else if (strMode == "full") {
-        UniValue result(UniValue::VOBJ);
-        mnList->ForEachMN(false, [&](const CDeterministicMNCPtr& mn) {
-            std::string key = mn->proTxHash.ToString().substr(0, 16);
-            result.pushKV(key, MNToJson(mn));
-        });
-        return result;
+        return MNListResult(request, *cache, MNListFormat::FULL, false, strFilter);
     }
 
     throw JSONRPCError(RPC_INVALID_PARAMETER, "Invalid mode: " + strMode);
@@ -172,6 +339,43 @@ UniValue masternode_count(const JSONRPCRequest& request)
     return obj;
 }
 
+UniValue masternode_cachestats(const JSONRPCRequest& request)
+{
+    if (request.fHelp || request.params.size() > 0)
+        throw std::runtime_error(
+            "masternode cachestats\n"
+            "\nGet statistics of the deterministic masternode list cache.\n"
+            "\nResult:\n"
+            "{\n"
+            "  \"entries\": n,      (numeric) Number of cached lists\n"
+            "  \"usage\": n,        (numeric) Estimated memory used by cached lists, in bytes\n"
+            "  \"maxusage\": n,     (numeric) Memory budget (-mnlistcachemb), in bytes\n"
+            "  \"hits\": n,         (numeric) List lookups served from the cache\n"
+            "  \"misses\": n,       (numeric) List lookups rebuilt from the database\n"
+            "  \"indexhits\": n,    (numeric) Lookups of recent active chain blocks served from the height index\n"
+            "}\n"
+            "\nExamples:\n"
+            + HelpExampleCli("masternode", "cachestats")
+            + HelpExampleRpc("masternode", "cachestats")
+        );
+
+    if (!deterministicMNManager) {
+        throw JSONRPCError(RPC_INTERNAL_ERROR, "Masternode manager not initialized");
+    }
+
+    auto stats = deterministicMNManager->GetCacheStats();
+
+    UniValue obj(UniValue::VOBJ);
+    obj.pushKV("entries", (uint64_t)stats.nEntries);
+    obj.pushKV("usage", (uint64_t)stats.nUsage);
+    obj.pushKV("maxusage", (uint64_t)stats.nMaxUsage);
+    obj.pushKV("hits", stats.nHits);
+    obj.pushKV("misses", stats.nMisses);
+    obj.pushKV("indexhits", stats.nIndexHits);
+
+    return obj;
+}
+
 UniValue masternode_winner(const JSONRPCRequest& request)
 {
     if (request.fHelp || request.params.size() > 1)
@@ -220,28 +424,19 @@ UniValue masternode_winner(const JSONRPCRequest& request)
     }
 
     // Predict winners for next blocks
-    for (int i = 1; i <= nCount; i++) {
-        int futureHeight = pindex->nHeight + i;
+    auto payees = mnList->GetProjectedMNPayees(nCount);
+    for (size_t i = 0; i < payees.size(); i++) {
+        const auto& winner = payees[i];
+        UniValue obj(UniValue::VOBJ);
+        obj.pushKV("height", pindex->nHeight + 1 + (int)i);
+        obj.pushKV("proTxHash", winner->proTxHash.ToString());
         
-        // Use a predictable hash for future blocks
-        CHashWriter hw(SER_GETHASH, PROTOCOL_VERSION);
-        hw << pindex->GetBlockHash();
-        hw << futureHeight;
-        uint256 futureHash = hw.GetHash();
-        
-        auto winner = mnList->GetMNPayee(futureHash);
-        if (winner) {
-            UniValue obj(UniValue::VOBJ);
-            obj.pushKV("height", futureHeight);
-            obj.pushKV("proTxHash", winner->proTxHash.ToString());
-            
-            CTxDestination dest;
-            if (ExtractDestination(winner->state.scriptPayout, dest)) {
-                obj.pushKV("payoutAddress", EncodeDestination(dest));
-            }
-            
-            result.push_back(obj);
+        CTxDestination dest;
+        if (ExtractDestination(winner->state.scriptPayout, dest)) {
+            obj.pushKV("payoutAddress", EncodeDestination(dest));
         }
+        
+        result.push_back(obj);
     }
 
     return result;
@@ -457,19 +652,9 @@ UniValue protx_list(const JSONRPCRequest& request)
         throw JSONRPCError(RPC_INTERNAL_ERROR, "Masternode manager not initialized");
     }
 
-    auto mnList = deterministicMNManager->GetListAtChainTip();
     bool onlyValid = (type == "valid");
 
-    UniValue result(UniValue::VARR);
-    mnList->ForEachMN(onlyValid, [&](const CDeterministicMNCPtr& mn) {
-        if (detailed) {
-            result.push_back(MNToJson(mn));
-        } else {
-            result.push_back(mn->proTxHash.ToString());
-        }
-    });
-
-    return result;
+    return MNListResult(request, *GetMNListRPCCache(), detailed ? MNListFormat::JSON : MNListFormat::HASH, onlyValid, "");
 }
 
 UniValue protx_info(const JSONRPCRequest& request)
@@ -515,6 +700,7 @@ UniValue masternode(const JSONRPCRequest& request)
             "\nArguments:\n"
             "1. \"command\"        (string, required) The command to execute\n"
             "\nAvailable commands:\n"
+            "  cachestats   - Get masternode list cache statistics\n"
             "  count        - Get masternode count\n"
             "  list         - Get list of masternodes\n"
             "  winner       - Get next masternode winner(s)\n"
@@ -530,6 +716,8 @@ UniValue masternode(const JSONRPCRequest& request)
 
     if (strCommand == "count") {
         return masternode_count(newRequest);
+    } else if (strCommand == "cachestats") {
+        return masternode_cachestats(newRequest);
     } else if (strCommand == "list") {
         return masternode_list(newRequest);
     } else if (strCommand == "winner") {
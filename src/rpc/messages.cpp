@@ -6,6 +6,8 @@
 #include "assets/assetdb.h"
 #include "assets/messages.h"
 #include "assets/myassetsdb.h"
+#include <algorithm>
+#include <limits>
 #include <map>
 #include "tinyformat.h"
 
@@ -38,12 +40,55 @@ std::string MessageActivationWarning()
     return AreMessagesDeployed() ? "" : "\nTHIS COMMAND IS NOT YET ACTIVE!\nhttps://github.com/RavenProject/rips/blob/master/rip-0005.mediawiki\n";
 }
 
+/** A channel's messages from the database with the unflushed changes applied, in block height order */
+static void GetChannelMessages(const std::string& channel, int nStartHeight, size_t nMaxCount, std::vector<CMessage>& vMessages)
+{
+    // Read enough extra rows that pending removals can't shorten the page
+    size_t nLoad = nMaxCount ? nMaxCount + setDirtyMessagesRemove.size() : 0;
+    std::vector<CMessage> vLoaded;
+    pmessagedb->LoadChannelMessages(channel, vLoaded, nStartHeight, nLoad);
+
+    std::map<COutPoint, CMessage> mapMessages;
+    for (const auto& message : vLoaded)
+        mapMessages[message.out] = message;
+
+    for (const auto& pair : mapDirtyMessagesOrphaned) {
+        if (pair.second.strName != channel || pair.second.nBlockHeight < nStartHeight)
+            continue;
+        CMessage message = pair.second;
+        message.status = MessageStatus::ORPHAN;
+        mapMessages[message.out] = message;
+    }
+
+    for (const auto& out : setDirtyMessagesRemove)
+        mapMessages.erase(out);
+
+    for (const auto& pair : mapDirtyMessagesAdd) {
+        if (pair.second.strName == channel && pair.second.nBlockHeight >= nStartHeight)
+            mapMessages[pair.first] = pair.second;
+    }
+
+    for (const auto& pair : mapMessages)
+        vMessages.push_back(pair.second);
+
+    std::sort(vMessages.begin(), vMessages.end(), [](const CMessage& a, const CMessage& b) {
+        return a.nBlockHeight < b.nBlockHeight || (a.nBlockHeight == b.nBlockHeight && a.out < b.out);
+    });
+    if (nMaxCount && vMessages.size() > nMaxCount)
+        vMessages.resize(nMaxCount);
+}
+
 UniValue viewallmessages(const JSONRPCRequest& request) {
-    if (request.fHelp || !AreMessagesDeployed() || request.params.size() != 0)
+    if (request.fHelp || !AreMessagesDeployed() || request.params.size() > 3)
         throw std::runtime_error(
-                "viewallmessages \n"
+                "viewallmessages ( \"channel_name\" start_height count )\n"
                 + MessageActivationWarning() +
-                "\nView all messages that the wallet contains\n"
+                "\nView all messages that the wallet contains, by channel and block height\n"
+
+                "\nArguments:\n"
+                "1. \"channel_name\"               (string, optional) Only show messages sent on this channel, otherwise every subscribed channel is shown\n"
+                "2. start_height                 (numeric, optional, default=0) Only show messages included at or after this block height\n"
+                "3. count                        (numeric, optional, default=0) The most messages to show per channel, 0 for all\n"
 
                 "\nResult:\n"
                 "\"Asset Name:\"                     (string) The name of the asset the message was sent on\n"
@@ -57,6 +102,7 @@ UniValue viewallmessages(const JSONRPCRequest& request) {
 
                 "\nExamples:\n"
                 + HelpExampleCli("viewallmessages", "")
+                + HelpExampleCli("viewallmessages", "\"ASSET_NAME!\" 100000 50")
                 + HelpExampleRpc("viewallmessages", "")
         );
 
@@ -66,38 +112,44 @@ UniValue viewallmessages(const JSONRPCRequest& request) {
         return ret;
     }
 
-    if (!pMessagesCache || !pmessagedb) {
+    if (!pMessagesCache || !pmessagedb || !pmessagechanneldb) {
         UniValue ret(UniValue::VSTR);
         ret.push_back("Messaging database and cache are having problems (a wallet restart might fix this issue)");
         return ret;
     }
 
-    std::set<CMessage> setMessages;
-
-    pmessagedb->LoadMessages(setMessages);
+    int nStartHeight = 0;
+    if (request.params.size() > 1)
+        nStartHeight = request.params[1].get_int();
 
-    for (auto pair : mapDirtyMessagesOrphaned) {
-        CMessage message = pair.second;
-        message.status = MessageStatus::ORPHAN;
-        if (setMessages.count(message))
-            setMessages.erase(message);
-        setMessages.insert(message);
+    size_t nMaxCount = 0;
+    if (request.params.size() > 2) {
+        int nCount = request.params[2].get_int();
+        if (nCount < 0)
+            throw JSONRPCError(RPC_INVALID_PARAMETER, "count must not be negative");
+        nMaxCount = nCount;
     }
 
-    for (auto out : setDirtyMessagesRemove) {
-        CMessage message;
-        message.out = out;
-        setMessages.erase(message);
-    }
+    LOCK(cs_messaging);
 
-    for (auto pair : mapDirtyMessagesAdd) {
-        setMessages.erase(pair.second);
-        setMessages.insert(pair.second);
+    std::set<std::string> setChannels;
+    if (request.params.size() > 0 && !request.params[0].get_str().empty()) {
+        setChannels.insert(request.params[0].get_str());
+    } else {
+        pmessagechanneldb->LoadMyMessageChannels(setChannels);
+        for (auto name : setDirtyChannelsRemove)
+            setChannels.erase(name);
+        for (auto name : setDirtyChannelsAdd)
+            setChannels.insert(name);
     }
 
+    std::vector<CMessage> vMessages;
+    for (const auto& channel : setChannels)
+        GetChannelMessages(channel, nStartHeight, nMaxCount, vMessages);
+
     UniValue messages(UniValue::VARR);
 
-    for (auto message : setMessages) {
+    for (auto message : vMessages) {
         UniValue obj(UniValue::VOBJ);
 
         obj.push_back(Pair("Asset Name", message.strName));
@@ -271,16 +323,21 @@ UniValue unsubscribefromchannel(const JSONRPCRequest& request) {
 }
 
 UniValue clearmessages(const JSONRPCRequest& request) {
-    if (request.fHelp || !AreMessagesDeployed() || request.params.size() != 0)
+    if (request.fHelp || !AreMessagesDeployed() || request.params.size() > 2)
         throw std::runtime_error(
-                "clearmessages \n"
+                "clearmessages ( \"channel_name\" before_height )\n"
                 + MessageActivationWarning() +
-                "\nDelete current database of messages\n"
+                "\nDelete current database of messages, or only the messages of one channel\n"
+
+                "\nArguments:\n"
+                "1. \"channel_name\"               (string, optional) Only delete messages sent on this channel\n"
+                "2. before_height                (numeric, optional) Only delete this channel's messages included below this block height\n"
 
                 "\nResult:[\n"
                 "\n]\n"
                 "\nExamples:\n"
                 + HelpExampleCli("clearmessages", "")
+                + HelpExampleCli("clearmessages", "\"ASSET_NAME!\" 100000")
                 + HelpExampleRpc("clearmessages", "")
         );
 
@@ -293,6 +350,35 @@ UniValue clearmessages(const JSONRPCRequest& request) {
     }
 
     int count = 0;
+
+    if (request.params.size() > 0) {
+        std::string channel = request.params[0].get_str();
+        int nBeforeHeight = std::numeric_limits<int>::max();
+        if (request.params.size() > 1)
+            nBeforeHeight = request.params[1].get_int();
+
+        LOCK(cs_messaging);
+        for (auto it = mapDirtyMessagesAdd.begin(); it != mapDirtyMessagesAdd.end();) {
+            if (it->second.strName == channel && it->second.nBlockHeight < nBeforeHeight) {
+                it = mapDirtyMessagesAdd.erase(it);
+                count++;
+            } else {
+                ++it;
+            }
+        }
+        for (auto it = mapDirtyMessagesOrphaned.begin(); it != mapDirtyMessagesOrphaned.end();) {
+            if (it->second.strName == channel && it->second.nBlockHeight < nBeforeHeight)
+                it = mapDirtyMessagesOrphaned.erase(it);
+            else
+                ++it;
+        }
+
+        pMessagesCache->Clear();
+        pmessagedb->EraseChannelMessages(channel, nBeforeHeight, count);
+
+        return "Erased " + std::to_string(count) + " Messages of " + channel + " from the database and cache";
+    }
+
     count += mapDirtyMessagesAdd.size();
 
     pMessagesCache->Clear();
@@ -488,7 +574,7 @@ UniValue viewmyrestrictedaddresses(const JSONRPCRequest& request) {
 static const CRPCCommand commands[] =
     {           //  category    name                          actor (function)             argNames
                 //  ----------- ------------------------      -----------------------      ----------
-            { "messages",       "viewallmessages",            &viewallmessages,            {}},
+            { "messages",       "viewallmessages",            &viewallmessages,            {"channel_name", "start_height", "count"}},
             { "messages",       "viewallmessagechannels",     &viewallmessagechannels,     {}},
             { "messages",       "subscribetochannel",         &subscribetochannel,         {"channel_name"}},
             { "messages",       "unsubscribefromchannel",     &unsubscribefromchannel,     {"channel_name"}},
@@ -497,7 +583,7 @@ static const CRPCCommand commands[] =
             {"restricted",        "viewmytaggedaddresses",      &viewmytaggedaddresses,       {}},
             {"restricted",        "viewmyrestrictedaddresses",  &viewmyrestrictedaddresses,   {}},
 #endif
-            { "messages",       "clearmessages",              &clearmessages,              {}},
+            { "messages",       "clearmessages",              &clearmessages,              {"channel_name", "before_height"}},
     };
 
 void RegisterMessageRPCCommands(CRPCTable &t)
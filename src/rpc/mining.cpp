@@ -12,7 +12,9 @@
 #include "consensus/params.h"
 #include "consensus/validation.h"
 #include "core_io.h"
+#include "epochcontext.h"
 #include "init.h"
+#include "kawpowshares.h"
 #include "validation.h"
 #include "miner.h"
 #include "net.h"
@@ -21,12 +23,14 @@
 #include "rpc/blockchain.h"
 #include "rpc/mining.h"
 #include "rpc/server.h"
+#include "scheduler.h"
 #include "txmempool.h"
 #include "util.h"
 #include "utilstrencodings.h"
 #include "validationinterface.h"
 #include "warnings.h"
 
+#include <atomic>
 #include <memory>
 #include <stdint.h>
 
@@ -35,8 +39,6 @@
 #include <consensus/merkle.h>
 #include <crypto/ethash/include/ethash/progpow.hpp>
 
-extern uint64_t nHashesPerSec;
-
 std::map<std::string, CBlock> mapRVNKAWBlockTemplates;
 
 unsigned int ParseConfirmTarget(const UniValue& value)
@@ -237,7 +239,7 @@ UniValue getmininginfo(const JSONRPCRequest& request)
     obj.push_back(Pair("currentblocktx",   (uint64_t)nLastBlockTx));
     obj.push_back(Pair("difficulty",       (double)GetDifficulty()));
     obj.push_back(Pair("networkhashps",    getnetworkhashps(request)));
-    obj.push_back(Pair("hashespersec",     (uint64_t)nHashesPerSec));
+    obj.push_back(Pair("hashespersec",     GetMinerHashRate().nHashesPerSec));
     obj.push_back(Pair("pooledtx",         (uint64_t)mempool.size()));
     obj.push_back(Pair("chain", GetParams().NetworkIDString()));
     if (IsDeprecatedRPCEnabled("getmininginfo")) {
@@ -312,6 +314,196 @@ std::string gbt_vb_name(const Consensus::DeploymentPos pos) {
     return s;
 }
 
+/** A template whose mempool has changed is rebuilt once it is this old */
+static const int64_t BLOCK_TEMPLATE_REFRESH_SECONDS = 5;
+/** Templates are kept fresh in the background for this long after one was asked for */
+static const int64_t BLOCK_TEMPLATE_IDLE_SECONDS = 120;
+
+/**
+ * The template getblocktemplate serves, shared by every caller. It is rebuilt
+ * when the tip changes. When only the mempool has changed, the assembler that
+ * built it patches in the new transactions, and it is rebuilt only when that
+ * can't be done and it is BLOCK_TEMPLATE_REFRESH_SECONDS old; a scheduler
+ * task does that in the background while templates are being asked for, so
+ * callers (and longpoll waiters woken by a new tip) usually find it ready
+ * instead of each running block assembly. Guarded by cs_main.
+ */
+struct CCachedBlockTemplate
+{
+    const CBlockIndex* pindexPrev{nullptr};
+    unsigned int nTransactionsUpdated{0};
+    //! Kept to avoid returning a segwit-block to a non-segwit caller
+    bool fSupportsSegwit{true};
+    int64_t nTimeBuilt{0};
+    std::unique_ptr<BlockAssembler> assembler;
+    std::unique_ptr<CBlockTemplate> pblocktemplate;
+    //! The "transactions" of the result, encoded once per template
+    UniValue transactions;
+};
+static CCachedBlockTemplate cachedBlockTemplate;
+static std::atomic<int64_t> nLastBlockTemplateRequest{0};
+
+static bool BlockTemplateIsStale(bool fSupportsSegwit)
+{
+    AssertLockHeld(cs_main);
+    const CCachedBlockTemplate& cached = cachedBlockTemplate;
+    return cached.pindexPrev != chainActive.Tip() ||
+        mempool.GetTransactionsUpdated() != cached.nTransactionsUpdated ||
+        cached.fSupportsSegwit != fSupportsSegwit;
+}
+
+/** The "transactions" of a getblocktemplate result */
+static UniValue BlockTemplateTransactions(const CBlockTemplate& blocktemplate)
+{
+    // NOTE: If at some point we support pre-segwit miners post-segwit-activation, this needs to take segwit support into consideration
+    const bool fPreSegWit = false; //(THRESHOLD_ACTIVE != VersionBitsState(pindexPrev, consensusParams, Consensus::DEPLOYMENT_SEGWIT, versionbitscache));
+
+    UniValue transactions(UniValue::VARR);
+    std::map<uint256, int64_t> setTxIndex;
+    int i = 0;
+    for (const auto& it : blocktemplate.block.vtx) {
+        const CTransaction& tx = *it;
+        uint256 txHash = tx.GetHash();
+        setTxIndex[txHash] = i++;
+
+        if (tx.IsCoinBase())
+            continue;
+
+        UniValue entry(UniValue::VOBJ);
+
+        entry.push_back(Pair("data", EncodeHexTx(tx)));
+        entry.push_back(Pair("txid", txHash.GetHex()));
+        entry.push_back(Pair("hash", tx.GetWitnessHash().GetHex()));
+
+        UniValue deps(UniValue::VARR);
+        for (const CTxIn &in : tx.vin)
+        {
+            if (setTxIndex.count(in.prevout.hash))
+                deps.push_back(setTxIndex[in.prevout.hash]);
+        }
+        entry.push_back(Pair("depends", deps));
+
+        int index_in_template = i - 1;
+        entry.push_back(Pair("fee", blocktemplate.vTxFees[index_in_template]));
+        int64_t nTxSigOps = blocktemplate.vTxSigOpsCost[index_in_template];
+        if (fPreSegWit) {
+            assert(nTxSigOps % WITNESS_SCALE_FACTOR == 0);
+            nTxSigOps /= WITNESS_SCALE_FACTOR;
+        }
+        entry.push_back(Pair("sigops", nTxSigOps));
+        entry.push_back(Pair("weight", GetTransactionWeight(tx)));
+
+        transactions.push_back(entry);
+    }
+    return transactions;
+}
+
+/** The coinbase script of templates; throws like getblocktemplate */
+static CScript GetBlockTemplateScript()
+{
+    // Get mining address if it is set
+    std::string address = gArgs.GetArg("-miningaddress", "");
+    if (address.empty())
+        return CScript() << OP_TRUE;
+    CTxDestination dest = DecodeDestination(address);
+    if (!IsValidDestination(dest))
+        throw JSONRPCError(RPC_INVALID_PARAMETER, "-miningaddress is not a valid address. Please use a valid address");
+    return GetScriptForDestination(dest);
+}
+
+/** Update or rebuild the cached template if it is stale; throws like getblocktemplate */
+static void UpdateBlockTemplate(bool fSupportsSegwit)
+{
+    AssertLockHeld(cs_main);
+    if (!BlockTemplateIsStale(fSupportsSegwit))
+        return;
+
+    CCachedBlockTemplate& cached = cachedBlockTemplate;
+    const CScript script = GetBlockTemplateScript();
+    CBlockIndex* pindexPrevNew = chainActive.Tip();
+
+    // Only the mempool changed: patch the template in place if the assembler can
+    if (cached.pindexPrev == pindexPrevNew && cached.fSupportsSegwit == fSupportsSegwit && cached.assembler) {
+        const unsigned int nTransactionsUpdated = mempool.GetTransactionsUpdated();
+        if (cached.assembler->UpdateBlock(*cached.pblocktemplate, script)) {
+            // Blocks handed out for the earlier version stay in mapRVNKAWBlockTemplates, as they are still valid
+            cached.nTransactionsUpdated = nTransactionsUpdated;
+            cached.transactions = BlockTemplateTransactions(*cached.pblocktemplate);
+            return;
+        }
+        if (GetTime() - cached.nTimeBuilt <= BLOCK_TEMPLATE_REFRESH_SECONDS)
+            return;
+    }
+
+    // Clear pindexPrev so future calls make a new block, despite any failures from here on
+    cached.pindexPrev = nullptr;
+    mapRVNKAWBlockTemplates.clear();
+
+    // Store the pindexBest used before CreateNewBlock, to avoid races
+    cached.nTransactionsUpdated = mempool.GetTransactionsUpdated();
+    cached.nTimeBuilt = GetTime();
+    cached.fSupportsSegwit = fSupportsSegwit;
+
+    // Create new block
+    cached.assembler.reset(new BlockAssembler(GetParams()));
+    cached.pblocktemplate = cached.assembler->CreateNewBlock(script, fSupportsSegwit);
+    if (!cached.pblocktemplate)
+        throw JSONRPCError(RPC_OUT_OF_MEMORY, "Out of memory");
+    cached.transactions = BlockTemplateTransactions(*cached.pblocktemplate);
+
+    // Need to update only after we know CreateNewBlock succeeded
+    cached.pindexPrev = pindexPrevNew;
+}
+
+/** Scheduler task keeping the cached template fresh while it is in use */
+static void RefreshBlockTemplate()
+{
+    if (GetTime() - nLastBlockTemplateRequest > BLOCK_TEMPLATE_IDLE_SECONDS)
+        return;
+    if (IsInitialBlockDownload() || !IsRPCRunning())
+        return;
+
+    LOCK(cs_main);
+    if (!BlockTemplateIsStale(cachedBlockTemplate.fSupportsSegwit))
+        return;
+    try {
+        UpdateBlockTemplate(cachedBlockTemplate.fSupportsSegwit);
+    } catch (const UniValue& objError) {
+        LogPrintf("%s: %s\n", __func__, find_value(objError, "message").get_str());
+    } catch (const std::exception& e) {
+        LogPrintf("%s: %s\n", __func__, e.what());
+    }
+}
+
+void StartBlockTemplateRefresh(CScheduler& scheduler)
+{
+    scheduler.scheduleEvery(RefreshBlockTemplate, 1000, "block_template_refresh");
+}
+
+bool GetBlockTemplateForMining(CBlock& block, std::string& strError)
+{
+    LOCK(cs_main);
+    nLastBlockTemplateRequest = GetTime();
+    try {
+        UpdateBlockTemplate(GetParams().GetConsensus().nSegwitEnabled);
+    } catch (const UniValue& objError) {
+        strError = find_value(objError, "message").get_str();
+        return false;
+    } catch (const std::exception& e) {
+        strError = e.what();
+        return false;
+    }
+
+    const CCachedBlockTemplate& cached = cachedBlockTemplate;
+    block = cached.pblocktemplate->block;
+    UpdateTime(&block, GetParams().GetConsensus(), cached.pindexPrev);
+    block.nNonce = 0;
+    block.nNonce64 = 0;
+    block.mix_hash.SetNull();
+    block.hashMerkleRoot = BlockMerkleRoot(block);
+    return true;
+}
+
 UniValue getblocktemplate(const JSONRPCRequest& request)
 {
     if (request.fHelp || request.params.size() > 1)
@@ -468,7 +660,7 @@ UniValue getblocktemplate(const JSONRPCRequest& request)
     if (IsInitialBlockDownload() && !gArgs.GetBoolArg("-bypassdownload", false))
         throw JSONRPCError(RPC_CLIENT_IN_INITIAL_DOWNLOAD, "Mynta is downloading blocks...");
 
-    static unsigned int nTransactionsUpdatedLast;
+    nLastBlockTemplateRequest = GetTime();
 
     if (!lpval.isNull())
     {
@@ -489,7 +681,7 @@ UniValue getblocktemplate(const JSONRPCRequest& request)
         {
             // NOTE: Spec does not specify behaviour for non-string longpollid, but this makes testing easier
             hashWatchedChain = chainActive.Tip()->GetBlockHash();
-            nTransactionsUpdatedLastLP = nTransactionsUpdatedLast;
+            nTransactionsUpdatedLastLP = cachedBlockTemplate.nTransactionsUpdated;
         }
 
         // Release the wallet and main lock while waiting
@@ -523,49 +715,9 @@ UniValue getblocktemplate(const JSONRPCRequest& request)
     bool fSupportsSegwit = GetParams().GetConsensus().nSegwitEnabled;
 
     // Update block
-    static CBlockIndex* pindexPrev;
-    static int64_t nStart;
-    static std::unique_ptr<CBlockTemplate> pblocktemplate;
-    // Cache whether the last invocation was with segwit support, to avoid returning
-    // a segwit-block to a non-segwit caller.
-    static bool fLastTemplateSupportsSegwit = true;
-    if (pindexPrev != chainActive.Tip() ||
-        (mempool.GetTransactionsUpdated() != nTransactionsUpdatedLast && GetTime() - nStart > 5) ||
-        fLastTemplateSupportsSegwit != fSupportsSegwit)
-    {
-        // Clear pindexPrev so future calls make a new block, despite any failures from here on
-        pindexPrev = nullptr;
-        mapRVNKAWBlockTemplates.clear();
-
-        // Store the pindexBest used before CreateNewBlock, to avoid races
-        nTransactionsUpdatedLast = mempool.GetTransactionsUpdated();
-        CBlockIndex* pindexPrevNew = chainActive.Tip();
-        nStart = GetTime();
-        fLastTemplateSupportsSegwit = fSupportsSegwit;
-
-        // Create new block
-        // Get mining address if it is set
-        CScript script;
-        std::string address = gArgs.GetArg("-miningaddress", "");
-        if (!address.empty()) {
-            CTxDestination dest = DecodeDestination(address);
-
-            if (IsValidDestination(dest)) {
-                script = GetScriptForDestination(dest);
-            } else {
-                throw JSONRPCError(RPC_INVALID_PARAMETER, "-miningaddress is not a valid address. Please use a valid address");
-            }
-        } else {
-            script = CScript() << OP_TRUE;
-        }
-
-        pblocktemplate = BlockAssembler(GetParams()).CreateNewBlock(script, fSupportsSegwit);
-        if (!pblocktemplate)
-            throw JSONRPCError(RPC_OUT_OF_MEMORY, "Out of memory");
-
-        // Need to update only after we know CreateNewBlock succeeded
-        pindexPrev = pindexPrevNew;
-    }
+    UpdateBlockTemplate(fSupportsSegwit);
+    const CBlockIndex* pindexPrev = cachedBlockTemplate.pindexPrev;
+    std::unique_ptr<CBlockTemplate>& pblocktemplate = cachedBlockTemplate.pblocktemplate;
     CBlock* pblock = &pblocktemplate->block; // pointer for convenience
     const Consensus::Params& consensusParams = GetParams().GetConsensus();
 
@@ -578,44 +730,6 @@ UniValue getblocktemplate(const JSONRPCRequest& request)
 
     UniValue aCaps(UniValue::VARR); aCaps.push_back("proposal");
 
-    UniValue transactions(UniValue::VARR);
-    std::map<uint256, int64_t> setTxIndex;
-    int i = 0;
-    for (const auto& it : pblock->vtx) {
-        const CTransaction& tx = *it;
-        uint256 txHash = tx.GetHash();
-        setTxIndex[txHash] = i++;
-
-        if (tx.IsCoinBase())
-            continue;
-
-        UniValue entry(UniValue::VOBJ);
-
-        entry.push_back(Pair("data", EncodeHexTx(tx)));
-        entry.push_back(Pair("txid", txHash.GetHex()));
-        entry.push_back(Pair("hash", tx.GetWitnessHash().GetHex()));
-
-        UniValue deps(UniValue::VARR);
-        for (const CTxIn &in : tx.vin)
-        {
-            if (setTxIndex.count(in.prevout.hash))
-                deps.push_back(setTxIndex[in.prevout.hash]);
-        }
-        entry.push_back(Pair("depends", deps));
-
-        int index_in_template = i - 1;
-        entry.push_back(Pair("fee", pblocktemplate->vTxFees[index_in_template]));
-        int64_t nTxSigOps = pblocktemplate->vTxSigOpsCost[index_in_template];
-        if (fPreSegWit) {
-            assert(nTxSigOps % WITNESS_SCALE_FACTOR == 0);
-            nTxSigOps /= WITNESS_SCALE_FACTOR;
-        }
-        entry.push_back(Pair("sigops", nTxSigOps));
-        entry.push_back(Pair("weight", GetTransactionWeight(tx)));
-
-        transactions.push_back(entry);
-    }
-
     UniValue aux(UniValue::VOBJ);
     aux.push_back(Pair("flags", HexStr(COINBASE_FLAGS.begin(), COINBASE_FLAGS.end())));
 
@@ -685,10 +799,10 @@ UniValue getblocktemplate(const JSONRPCRequest& request)
     }
 
     result.push_back(Pair("previousblockhash", pblock->hashPrevBlock.GetHex()));
-    result.push_back(Pair("transactions", transactions));
+    result.push_back(Pair("transactions", cachedBlockTemplate.transactions));
     result.push_back(Pair("coinbaseaux", aux));
     result.push_back(Pair("coinbasevalue", (int64_t)pblock->vtx[0]->vout[0].nValue));
-    result.push_back(Pair("longpollid", chainActive.Tip()->GetBlockHash().GetHex() + i64tostr(nTransactionsUpdatedLast)));
+    result.push_back(Pair("longpollid", chainActive.Tip()->GetBlockHash().GetHex() + i64tostr(cachedBlockTemplate.nTransactionsUpdated)));
     result.push_back(Pair("target", hashTarget.GetHex()));
     result.push_back(Pair("mintime", (int64_t)pindexPrev->GetMedianTimePast()+1));
     result.push_back(Pair("mutable", aMutable));
@@ -755,6 +869,28 @@ protected:
     }
 };
 
+std::string SubmitMinedBlock(const std::shared_ptr<CBlock>& pblock)
+{
+    {
+        LOCK(cs_main);
+        BlockMap::iterator mi = mapBlockIndex.find(pblock->hashPrevBlock);
+        if (mi != mapBlockIndex.end()) {
+            UpdateUncommittedBlockStructures(*pblock, mi->second, GetParams().GetConsensus());
+        }
+    }
+
+    submitblock_StateCatcher sc(pblock->GetHash());
+    RegisterValidationInterface(&sc);
+    bool fAccepted = ProcessNewBlock(GetParams(), pblock, true, nullptr);
+    UnregisterValidationInterface(&sc);
+    if (!sc.found)
+        return fAccepted ? "inconclusive" : "rejected";
+    if (sc.state.IsValid())
+        return "";
+    const std::string strRejectReason = sc.state.GetRejectReason();
+    return strRejectReason.empty() ? "rejected" : strRejectReason;
+}
+
 static UniValue getkawpowhash(const JSONRPCRequest& request) {
     if (request.fHelp || request.params.size() < 4) {
         throw std::runtime_error(
@@ -795,18 +931,14 @@ static UniValue getkawpowhash(const JSONRPCRequest& request) {
         fCheckTarget = true;
     }
 
-    static ethash::epoch_context_ptr context{nullptr, nullptr};
-
-    // Get the context from the block height
-    const auto epoch_number = ethash::get_epoch_number(nHeight);
-    if (!context || context->epoch_number != epoch_number)
-        context = ethash::create_epoch_context(epoch_number);
+    // Get the context from the block height (shared with block validation)
+    const auto context = epochContextCache.GetForHeight(nHeight);
 
     // ProgPow hash
     const auto result = progpow::hash(*context, nHeight, header_hash, nNonce);
 
-    uint256 mined_mix_hash = uint256S(to_hex(result.mix_hash));
-    uint256 mined_final_hash = uint256S(to_hex(result.final_hash));
+    uint256 mined_mix_hash = FromEthashHash256(result.mix_hash);
+    uint256 mined_final_hash = FromEthashHash256(result.final_hash);
 
     bool mix_hash_match = false;
     bool final_hash_meets_target = false;
@@ -833,6 +965,87 @@ static UniValue getkawpowhash(const JSONRPCRequest& request) {
     return ret;
 }
 
+std::vector<CKawpowShareResult> VerifyKawpowSharesRPC(const std::vector<CKawpowShare>& vShares)
+{
+    if (vShares.size() > MAX_KAWPOW_SHARES_PER_CALL)
+        throw JSONRPCError(RPC_INVALID_PARAMETER, strprintf("At most %u shares per call", MAX_KAWPOW_SHARES_PER_CALL));
+
+    int nMaxHeight;
+    {
+        LOCK(cs_main);
+        nMaxHeight = chainActive.Height() + 10;
+    }
+    // Like getkawpowhash, so a caller can't have arbitrary epochs built
+    for (const CKawpowShare& share : vShares) {
+        if (share.nHeight > (uint32_t)nMaxHeight)
+            throw JSONRPCError(RPC_INVALID_PARAMETER, strprintf("Block height %u is too large", share.nHeight));
+    }
+    return VerifyKawpowShares(vShares, GetNumCores());
+}
+
+static UniValue verifykawpowshares(const JSONRPCRequest& request)
+{
+    if (request.fHelp || request.params.size() != 1) {
+        throw std::runtime_error(
+                "verifykawpowshares [{\"header_hash\":\"hash\",\"mix_hash\":\"hash\",\"nonce\":\"hex\",\"height\":n,\"target\":\"hex\"},...]\n"
+                "\nVerify a batch of KAWPOW shares in parallel, as a pool checks what its miners submit.\n"
+
+                "\nArguments\n"
+                "1. \"shares\"             (array, required) at most " + std::to_string(MAX_KAWPOW_SHARES_PER_CALL) + " shares\n"
+                "     [\n"
+                "       {\n"
+                "         \"header_hash\": \"hash\", (string, required) the prog_pow header hash the miner worked on\n"
+                "         \"mix_hash\": \"hash\",    (string, required) the mix hash the miner found\n"
+                "         \"nonce\": \"hex\",        (string, required) the hex nonce the miner found\n"
+                "         \"height\": n,           (numeric, required) the height of the block being mined\n"
+                "         \"target\": \"hex\"        (string, required) the target the share has to meet\n"
+                "       }\n"
+                "       ,...\n"
+                "     ]\n"
+                "\nResult: one entry per share, in order\n"
+                "[\n"
+                "  {\n"
+                "    \"valid\": true|false,     (boolean) the mix hash is right and the final hash meets the target\n"
+                "    \"final_hash\": \"hash\"     (string) the final hash of the share's mix hash\n"
+                "  }\n"
+                "  ,...\n"
+                "]\n"
+                "\nExamples:\n"
+                + HelpExampleCli("verifykawpowshares", "'[{\"header_hash\":\"header_hash\",\"mix_hash\":\"mix_hash\",\"nonce\":\"0x100000\",\"height\":2456,\"target\":\"target\"}]'")
+                + HelpExampleRpc("verifykawpowshares", "[{\"header_hash\":\"header_hash\",\"mix_hash\":\"mix_hash\",\"nonce\":\"0x100000\",\"height\":2456,\"target\":\"target\"}]")
+        );
+    }
+
+    const UniValue& shares = request.params[0].get_array();
+    std::vector<CKawpowShare> vShares(shares.size());
+    for (size_t i = 0; i < shares.size(); i++) {
+        const UniValue& obj = shares[i].get_obj();
+        RPCTypeCheckObj(obj, {
+                {"header_hash", UniValueType(UniValue::VSTR)},
+                {"mix_hash", UniValueType(UniValue::VSTR)},
+                {"nonce", UniValueType(UniValue::VSTR)},
+                {"height", UniValueType(UniValue::VNUM)},
+                {"target", UniValueType(UniValue::VSTR)},
+            });
+        CKawpowShare& share = vShares[i];
+        share.hashHeader = ParseHashO(obj, "header_hash");
+        share.hashMix = ParseHashO(obj, "mix_hash");
+        if (!ParseUInt64(find_value(obj, "nonce").get_str(), &share.nNonce, 16))
+            throw JSONRPCError(RPC_INVALID_PARAMS, "Invalid nonce hex string");
+        share.nHeight = find_value(obj, "height").get_int();
+        share.target = ParseHashO(obj, "target");
+    }
+
+    UniValue ret(UniValue::VARR);
+    for (const CKawpowShareResult& result : VerifyKawpowSharesRPC(vShares)) {
+        UniValue entry(UniValue::VOBJ);
+        entry.pushKV("valid", result.fValid);
+        entry.pushKV("final_hash", result.hashFinal.GetHex());
+        ret.push_back(entry);
+    }
+    return ret;
+}
+
 static UniValue pprpcsb(const JSONRPCRequest& request) {
     if (request.fHelp || request.params.size() != 3) {
         throw std::runtime_error(
@@ -1225,6 +1438,36 @@ UniValue getgenerate(const JSONRPCRequest& request)
     return gArgs.GetBoolArg("-gen", DEFAULT_GENERATE);
 }
 
+UniValue getminerhashrate(const JSONRPCRequest& request)
+{
+    if (request.fHelp || request.params.size() != 0)
+        throw std::runtime_error(
+            "getminerhashrate\n"
+            "\nReturns the throughput of the built-in miner since it was last started with -gen or setgenerate.\n"
+            "\nResult:\n"
+            "{\n"
+            "  \"threads\": n,              (numeric) The number of miner threads running, 0 when not generating\n"
+            "  \"fulldataset\": true|false, (boolean) Whether KAWPOW is searched against the full dataset (-minerfulldataset)\n"
+            "  \"hashes\": n,               (numeric) The number of hashes tried by all threads\n"
+            "  \"elapsed\": n,              (numeric) Seconds since the miner threads were started\n"
+            "  \"hashespersec\": n,         (numeric) The average hashes per second of all threads\n"
+            "}\n"
+            "\nExamples:\n"
+            + HelpExampleCli("getminerhashrate", "")
+            + HelpExampleRpc("getminerhashrate", "")
+        );
+
+    const CMinerHashRate stats = GetMinerHashRate();
+
+    UniValue obj(UniValue::VOBJ);
+    obj.push_back(Pair("threads",          stats.nThreads));
+    obj.push_back(Pair("fulldataset",      stats.fFullDataset));
+    obj.push_back(Pair("hashes",           stats.nHashesDone));
+    obj.push_back(Pair("elapsed",          stats.nElapsedMicros / 1000000));
+    obj.push_back(Pair("hashespersec",     stats.nHashesPerSec));
+    return obj;
+}
+
 UniValue setgenerate(const JSONRPCRequest& request)
 {
     if (request.fHelp || request.params.size() < 1 || request.params.size() > 2)
@@ -1285,10 +1528,12 @@ static const CRPCCommand commands[] =
     { "mining",             "submitblock",            &submitblock,            {"hexdata","dummy"} },
     { "mining",             "pprpcsb",                &pprpcsb,                {"header_hash","mix_hash", "nonce"} },
     { "mining",             "getkawpowhash",          &getkawpowhash,          {"header_hash", "mix_hash", "nonce", "height"} },
+    { "mining",             "verifykawpowshares",     &verifykawpowshares,     {"shares"} },
 
     /* Coin generation */
     { "generating",         "getgenerate",            &getgenerate,            {}  },
     { "generating",         "setgenerate",            &setgenerate,            {"generate", "genproclimit"}  },
+    { "generating",         "getminerhashrate",       &getminerhashrate,       {}  },
 
     { "generating",         "generatetoaddress",      &generatetoaddress,      {"nblocks","address","maxtries"} },
 
@@ -10,6 +10,15 @@
 
 #include <univalue.h>
 
+#include <memory>
+#include <string>
+#include <vector>
+
+class CBlock;
+class CScheduler;
+struct CKawpowShare;
+struct CKawpowShareResult;
+
 static const bool DEFAULT_GENERATE = false;
 static const int DEFAULT_GENERATE_THREADS = 1;
 
@@ -18,6 +27,25 @@ UniValue generateBlocks(std::shared_ptr<CReserveScript> coinbaseScript, int nGen
 
 UniValue getgenerate(const UniValue& params, bool fHelp);
 
+/** Keep the getblocktemplate template up to date in the background while it is being used */
+void StartBlockTemplateRefresh(CScheduler& scheduler);
+
+/**
+ * A block to mine from the getblocktemplate template, with its time and
+ * merkle root filled in, the way a KAWPOW miner gets it over RPC. Takes
+ * cs_main; false with the reason getblocktemplate would throw otherwise.
+ */
+bool GetBlockTemplateForMining(CBlock& block, std::string& strError);
+
+/** Process a mined block like pprpcsb; returns the BIP22 result, empty if it was accepted */
+std::string SubmitMinedBlock(const std::shared_ptr<CBlock>& pblock);
+
+/**
+ * verifykawpowshares for both the JSON and the binary interface: checks the
+ * batch size and heights, then verifies the shares on all cores.
+ */
+std::vector<CKawpowShareResult> VerifyKawpowSharesRPC(const std::vector<CKawpowShare>& vShares);
+
 /** Check bounds on a command line confirm target */
 unsigned int ParseConfirmTarget(const UniValue& value);
 
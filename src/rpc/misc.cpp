@@ -6,6 +6,7 @@
 
 #include "base58.h"
 #include "chain.h"
+#include "checkqueue.h"
 #include "clientversion.h"
 #include "core_io.h"
 #include "init.h"
@@ -14,11 +15,15 @@
 #include "net.h"
 #include "netbase.h"
 #include "rpc/blockchain.h"
+#include "rpc/jsonstream.h"
 #include "rpc/server.h"
+#include "scheduler.h"
 #include "timedata.h"
+#include "txdb.h"
 #include "txmempool.h"
 #include "util.h"
 #include "utilstrencodings.h"
+#include "validationinterface.h"
 #ifdef ENABLE_WALLET
 #include "wallet/rpcwallet.h"
 #include "wallet/wallet.h"
@@ -524,6 +529,310 @@ static std::string RPCMallocInfo()
 }
 #endif
 
+UniValue getcheckqueueinfo(const JSONRPCRequest& request)
+{
+    if (request.fHelp || request.params.size() != 0)
+        throw std::runtime_error(
+            "getcheckqueueinfo\n"
+            "Returns the work done by each script verification thread since startup.\n"
+            "\nResult:\n"
+            "{\n"
+            "  \"threads\": n,                (numeric) Script verification threads in use (-par), 0 when checking inline\n"
+            "  \"workers\": [                 (array) One entry per worker queue, the block connecting thread first\n"
+            "    {\n"
+            "      \"checks\": n,             (numeric) Script checks executed\n"
+            "      \"batches\": n,            (numeric) Batches taken\n"
+            "      \"steals\": n,             (numeric) Batches stolen from another worker's queue\n"
+            "      \"busy_ms\": n,            (numeric) Milliseconds spent executing checks\n"
+            "      \"checks_per_second\": x.x (numeric) Checks executed per second of busy time\n"
+            "    }, ...\n"
+            "  ]\n"
+            "}\n"
+            "\nExamples:\n"
+            + HelpExampleCli("getcheckqueueinfo", "")
+            + HelpExampleRpc("getcheckqueueinfo", "")
+        );
+
+    UniValue workers(UniValue::VARR);
+    for (const CCheckQueueWorkerStats& stats : GetScriptCheckStats()) {
+        UniValue worker(UniValue::VOBJ);
+        worker.push_back(Pair("checks", stats.nChecks));
+        worker.push_back(Pair("batches", stats.nBatches));
+        worker.push_back(Pair("steals", stats.nSteals));
+        worker.push_back(Pair("busy_ms", stats.nBusyMicros / 1000));
+        worker.push_back(Pair("checks_per_second", stats.nBusyMicros ? stats.nChecks * 1000000.0 / stats.nBusyMicros : 0.0));
+        workers.push_back(worker);
+    }
+    UniValue obj(UniValue::VOBJ);
+    obj.push_back(Pair("threads", nScriptCheckThreads));
+    obj.push_back(Pair("workers", workers));
+    return obj;
+}
+
+static std::string ValidationQueuePolicyName(ValidationQueuePolicy policy)
+{
+    switch (policy) {
+    case ValidationQueuePolicy::WAIT: return "wait";
+    case ValidationQueuePolicy::DROP_OLDEST: return "drop_oldest";
+    case ValidationQueuePolicy::DROP_NEWEST: return "drop_newest";
+    }
+    return "";
+}
+
+UniValue getvalidationqueueinfo(const JSONRPCRequest& request)
+{
+    if (request.fHelp || request.params.size() != 0)
+        throw std::runtime_error(
+            "getvalidationqueueinfo\n"
+            "Returns the queues of the validation subscribers that run on threads of their own (the block filter index, ZMQ).\n"
+            "The wallet and peer logic are notified synchronously and have none.\n"
+            "\nResult:\n"
+            "[\n"
+            "  {\n"
+            "    \"name\": \"name\",           (string) The subscriber\n"
+            "    \"policy\": \"wait\",         (string) What a full queue does: wait, drop_oldest or drop_newest\n"
+            "    \"depth\": n,               (numeric) Events waiting now\n"
+            "    \"max_depth\": n,           (numeric) Events the queue holds\n"
+            "    \"peak_depth\": n,          (numeric) Most events that have waited at once\n"
+            "    \"processed\": n,           (numeric) Events run\n"
+            "    \"dropped\": n,             (numeric) Events dropped because the queue was full\n"
+            "    \"overflows\": n,           (numeric) Events a wait queue took past max_depth after waiting its longest\n"
+            "    \"wait_ms\": n,             (numeric) Milliseconds validation spent waiting for room\n"
+            "    \"busy_ms\": n              (numeric) Milliseconds spent in the subscriber's callbacks\n"
+            "  }, ...\n"
+            "]\n"
+            "\nExamples:\n"
+            + HelpExampleCli("getvalidationqueueinfo", "")
+            + HelpExampleRpc("getvalidationqueueinfo", "")
+        );
+
+    UniValue result(UniValue::VARR);
+    for (const ValidationQueueStats& stats : GetValidationQueueStats()) {
+        UniValue queue(UniValue::VOBJ);
+        queue.push_back(Pair("name", stats.strName));
+        queue.push_back(Pair("policy", ValidationQueuePolicyName(stats.policy)));
+        queue.push_back(Pair("depth", (uint64_t)stats.nDepth));
+        queue.push_back(Pair("max_depth", (uint64_t)stats.nMaxDepth));
+        queue.push_back(Pair("peak_depth", (uint64_t)stats.nPeakDepth));
+        queue.push_back(Pair("processed", stats.nProcessed));
+        queue.push_back(Pair("dropped", stats.nDropped));
+        queue.push_back(Pair("overflows", stats.nOverflows));
+        queue.push_back(Pair("wait_ms", stats.nWaitMicros / 1000));
+        queue.push_back(Pair("busy_ms", stats.nBusyMicros / 1000));
+        result.push_back(queue);
+    }
+    return result;
+}
+
+UniValue getlockstats(const JSONRPCRequest& request)
+{
+    if (request.fHelp || request.params.size() > 2)
+        throw std::runtime_error(
+            "getlockstats ( count reset )\n"
+            "Returns how long threads waited for and held each lock since startup or the last reset.\n"
+            "Locks are told apart by the expression their LOCK names, such as cs_main or mempool.cs.\n"
+            "Hold times are those of the outermost LOCK of a mutex on a thread.\n"
+            "\nArguments:\n"
+            "1. count    (numeric, optional, default=10) How many call sites to list as top holders and waiters\n"
+            "2. reset    (boolean, optional, default=false) Zero the counts after returning them\n"
+            "\nResult:\n"
+            "{\n"
+            "  \"locks\": {                   (json object) Totals for each lock\n"
+            "    \"name\": {\n"
+            "      \"acquisitions\": n,        (numeric) Times the lock was taken\n"
+            "      \"contentions\": n,         (numeric) Times it had to be waited for\n"
+            "      \"wait_ms\": x.xxx,         (numeric) Time spent waiting for it\n"
+            "      \"max_wait_ms\": x.xxx,     (numeric) Longest single wait\n"
+            "      \"hold_ms\": x.xxx,         (numeric) Time it was held\n"
+            "      \"max_hold_ms\": x.xxx      (numeric) Longest single hold\n"
+            "    }, ...\n"
+            "  },\n"
+            "  \"top_holders\": [             (array) Call sites that held their lock longest in total\n"
+            "    {\n"
+            "      \"lock\": \"name\",          (string) The lock\n"
+            "      \"site\": \"file:line\",     (string) Where it was taken\n"
+            "      \"holds\": n,               (numeric) Outermost acquisitions there\n"
+            "      \"hold_ms\": x.xxx,         (numeric) Time it was held from there\n"
+            "      \"max_hold_ms\": x.xxx      (numeric) Longest single hold\n"
+            "    }, ...\n"
+            "  ],\n"
+            "  \"top_waiters\": [             (array) Call sites that waited for their lock longest in total\n"
+            "    {\n"
+            "      \"lock\": \"name\",          (string) The lock\n"
+            "      \"site\": \"file:line\",     (string) Where it was waited for\n"
+            "      \"contentions\": n,         (numeric) Times it had to be waited for there\n"
+            "      \"wait_ms\": x.xxx,         (numeric) Time spent waiting there\n"
+            "      \"max_wait_ms\": x.xxx      (numeric) Longest single wait\n"
+            "    }, ...\n"
+            "  ]\n"
+            "}\n"
+            "\nExamples:\n"
+            + HelpExampleCli("getlockstats", "")
+            + HelpExampleCli("getlockstats", "20 true")
+            + HelpExampleRpc("getlockstats", "20, true")
+        );
+
+    int nCount = 10;
+    if (!request.params[0].isNull())
+        nCount = request.params[0].get_int();
+    if (nCount < 0)
+        throw JSONRPCError(RPC_INVALID_PARAMETER, "count must not be negative");
+    bool fReset = false;
+    if (!request.params[1].isNull())
+        fReset = request.params[1].get_bool();
+
+    struct LockTotals {
+        uint64_t nAcquisitions = 0;
+        uint64_t nContentions = 0;
+        int64_t nWaitMicros = 0;
+        int64_t nMaxWaitMicros = 0;
+        int64_t nHoldMicros = 0;
+        int64_t nMaxHoldMicros = 0;
+    };
+    std::map<std::string, LockTotals> mapLocks;
+    std::vector<const CLockSite*> vSites;
+    for (CLockSite* psite = GetLockSites(); psite; psite = psite->pnext) {
+        if (psite->nAcquisitions == 0)
+            continue;
+        LockTotals& totals = mapLocks[psite->pszName];
+        totals.nAcquisitions += psite->nAcquisitions;
+        totals.nContentions += psite->nContentions;
+        totals.nWaitMicros += psite->nWaitMicros;
+        totals.nMaxWaitMicros = std::max<int64_t>(totals.nMaxWaitMicros, psite->nMaxWaitMicros);
+        totals.nHoldMicros += psite->nHoldMicros;
+        totals.nMaxHoldMicros = std::max<int64_t>(totals.nMaxHoldMicros, psite->nMaxHoldMicros);
+        vSites.push_back(psite);
+    }
+
+    UniValue locks(UniValue::VOBJ);
+    for (const auto& item : mapLocks) {
+        UniValue lock(UniValue::VOBJ);
+        lock.push_back(Pair("acquisitions", item.second.nAcquisitions));
+        lock.push_back(Pair("contentions", item.second.nContentions));
+        lock.push_back(Pair("wait_ms", item.second.nWaitMicros * 0.001));
+        lock.push_back(Pair("max_wait_ms", item.second.nMaxWaitMicros * 0.001));
+        lock.push_back(Pair("hold_ms", item.second.nHoldMicros * 0.001));
+        lock.push_back(Pair("max_hold_ms", item.second.nMaxHoldMicros * 0.001));
+        locks.push_back(Pair(item.first, lock));
+    }
+
+    const size_t nTop = std::min<size_t>(nCount, vSites.size());
+    std::partial_sort(vSites.begin(), vSites.begin() + nTop, vSites.end(), [](const CLockSite* a, const CLockSite* b) {
+        return a->nHoldMicros > b->nHoldMicros;
+    });
+    UniValue holders(UniValue::VARR);
+    for (size_t i = 0; i < nTop && vSites[i]->nHoldMicros > 0; i++) {
+        UniValue site(UniValue::VOBJ);
+        site.push_back(Pair("lock", vSites[i]->pszName));
+        site.push_back(Pair("site", strprintf("%s:%d", vSites[i]->pszFile, vSites[i]->nLine)));
+        site.push_back(Pair("holds", (uint64_t)vSites[i]->nHolds));
+        site.push_back(Pair("hold_ms", vSites[i]->nHoldMicros * 0.001));
+        site.push_back(Pair("max_hold_ms", vSites[i]->nMaxHoldMicros * 0.001));
+        holders.push_back(site);
+    }
+
+    std::partial_sort(vSites.begin(), vSites.begin() + nTop, vSites.end(), [](const CLockSite* a, const CLockSite* b) {
+        return a->nWaitMicros > b->nWaitMicros;
+    });
+    UniValue waiters(UniValue::VARR);
+    for (size_t i = 0; i < nTop && vSites[i]->nContentions > 0; i++) {
+        UniValue site(UniValue::VOBJ);
+        site.push_back(Pair("lock", vSites[i]->pszName));
+        site.push_back(Pair("site", strprintf("%s:%d", vSites[i]->pszFile, vSites[i]->nLine)));
+        site.push_back(Pair("contentions", (uint64_t)vSites[i]->nContentions));
+        site.push_back(Pair("wait_ms", vSites[i]->nWaitMicros * 0.001));
+        site.push_back(Pair("max_wait_ms", vSites[i]->nMaxWaitMicros * 0.001));
+        waiters.push_back(site);
+    }
+
+    if (fReset) {
+        for (CLockSite* psite = GetLockSites(); psite; psite = psite->pnext)
+            psite->Reset();
+    }
+
+    UniValue obj(UniValue::VOBJ);
+    obj.push_back(Pair("locks", locks));
+    obj.push_back(Pair("top_holders", holders));
+    obj.push_back(Pair("top_waiters", waiters));
+    return obj;
+}
+
+static UniValue TimingStatsToJSON(const CTimingStats& stats)
+{
+    UniValue obj(UniValue::VOBJ);
+    obj.push_back(Pair("count", stats.nCount));
+    obj.push_back(Pair("mean_ms", stats.nCount ? stats.nTotalMicros * 0.001 / stats.nCount : 0.0));
+    obj.push_back(Pair("p50_ms", stats.nP50Micros * 0.001));
+    obj.push_back(Pair("p90_ms", stats.nP90Micros * 0.001));
+    obj.push_back(Pair("p99_ms", stats.nP99Micros * 0.001));
+    obj.push_back(Pair("max_ms", stats.nMaxMicros * 0.001));
+    return obj;
+}
+
+UniValue getschedulerstats(const JSONRPCRequest& request)
+{
+    if (request.fHelp || request.params.size() > 1)
+        throw std::runtime_error(
+            "getschedulerstats ( reset )\n"
+            "Returns how late and how long the background tasks of the scheduler ran since startup or the last reset.\n"
+            "Tasks are told apart by their names, such as addresses_dump or sigshares_relay.\n"
+            "Percentiles are rounded up to the end of a bucket, so are within about 19% of the exact value.\n"
+            "\nArguments:\n"
+            "1. reset    (boolean, optional, default=false) Forget the samples after returning them\n"
+            "\nResult:\n"
+            "{\n"
+            "  \"threads\": n,               (numeric) Threads running the tasks\n"
+            "  \"queued\": n,                (numeric) Tasks waiting to run\n"
+            "  \"tasks\": {                  (json object) One for each task name\n"
+            "    \"name\": {\n"
+            "      \"queued\": n,            (numeric) Tasks of this name waiting to run\n"
+            "      \"lateness\": {           (json object) From the time a task was due until it started\n"
+            "        \"count\": n,           (numeric) The number of tasks run\n"
+            "        \"mean_ms\": x.xxx,     (numeric) The mean\n"
+            "        \"p50_ms\": x.xxx,      (numeric) The median\n"
+            "        \"p90_ms\": x.xxx,      (numeric) The 90th percentile\n"
+            "        \"p99_ms\": x.xxx,      (numeric) The 99th percentile\n"
+            "        \"max_ms\": x.xxx       (numeric) The longest\n"
+            "      },\n"
+            "      \"runtime\": {            (json object) How long the tasks ran, as for lateness\n"
+            "        ...\n"
+            "      }\n"
+            "    }, ...\n"
+            "  }\n"
+            "}\n"
+            "\nExamples:\n"
+            + HelpExampleCli("getschedulerstats", "")
+            + HelpExampleCli("getschedulerstats", "true")
+            + HelpExampleRpc("getschedulerstats", "true")
+        );
+
+    bool fReset = false;
+    if (!request.params[0].isNull())
+        fReset = request.params[0].get_bool();
+
+    if (!g_scheduler)
+        throw JSONRPCError(RPC_INTERNAL_ERROR, "The scheduler is not running");
+
+    boost::chrono::system_clock::time_point first, last;
+    const size_t nQueued = g_scheduler->getQueueInfo(first, last);
+    UniValue tasks(UniValue::VOBJ);
+    for (const auto& item : g_scheduler->GetTaskStats()) {
+        UniValue task(UniValue::VOBJ);
+        task.push_back(Pair("queued", (uint64_t)item.second.nQueued));
+        task.push_back(Pair("lateness", TimingStatsToJSON(item.second.lateness)));
+        task.push_back(Pair("runtime", TimingStatsToJSON(item.second.runtime)));
+        tasks.push_back(Pair(item.first, task));
+    }
+    if (fReset)
+        g_scheduler->ResetTaskStats();
+
+    UniValue obj(UniValue::VOBJ);
+    obj.push_back(Pair("threads", g_scheduler->GetThreadCount()));
+    obj.push_back(Pair("queued", (uint64_t)nQueued));
+    obj.push_back(Pair("tasks", tasks));
+    return obj;
+}
+
 UniValue getmemoryinfo(const JSONRPCRequest& request)
 {
     /* Please, avoid using the word "pool" here in the RPC interface or help,
@@ -546,6 +855,19 @@ UniValue getmemoryinfo(const JSONRPCRequest& request)
             "    \"locked\": xxxxxx,       (numeric) Amount of bytes that succeeded locking. If this number is smaller than total, locking pages failed at some point and key data could be swapped to disk.\n"
             "    \"chunks_used\": xxxxx,   (numeric) Number allocated chunks\n"
             "    \"chunks_free\": xxxxx,   (numeric) Number unused chunks\n"
+            "  },\n"
+            "  \"budget\": {               (json object) The caches counted against -memorybudget\n"
+            "    \"budget\": xxxxx,        (numeric) Bytes the caches may use together, 0 for no limit\n"
+            "    \"usage\": xxxxx,         (numeric) Bytes the caches use together\n"
+            "    \"pressure_events\": xxx, (numeric) Times the caches were found over the budget\n"
+            "    \"caches\": {             (json object) Each cache by name\n"
+            "      \"name\": {\n"
+            "        \"bytes\": xxxxx,     (numeric) Bytes it uses\n"
+            "        \"evictable\": xx,    (boolean) Whether the budget can make it drop entries\n"
+            "        \"evictions\": xx,    (numeric) Times it was asked to drop entries\n"
+            "        \"evicted_bytes\": xx (numeric) Bytes it dropped\n"
+            "      }, ...\n"
+            "    }\n"
             "  }\n"
             "}\n"
             "\nResult (mode \"mallocinfo\"):\n"
@@ -559,6 +881,7 @@ UniValue getmemoryinfo(const JSONRPCRequest& request)
     if (mode == "stats") {
         UniValue obj(UniValue::VOBJ);
         obj.push_back(Pair("locked", RPCLockedMemoryInfo()));
+        obj.push_back(Pair("budget", memoryBudgetToJSON()));
         return obj;
     } else if (mode == "mallocinfo") {
 #ifdef HAVE_MALLOC_INFO
@@ -709,6 +1032,49 @@ bool timestampSort(std::pair<CMempoolAddressDeltaKey, CMempoolAddressDelta> a,
     return a.second.time < b.second.time;
 }
 
+/** Cursor returned with a page of address index results, to continue after its last entry */
+static std::string AddressIndexCursorString(const CAddressIndexKey& key)
+{
+    CDataStream ssKey(SER_DISK, CLIENT_VERSION);
+    ssKey << key;
+    return HexStr(ssKey.begin(), ssKey.end());
+}
+
+static CAddressIndexKey ParseAddressIndexCursor(const UniValue& value)
+{
+    std::vector<unsigned char> vchKey = ParseHexV(value, "after");
+    CDataStream ssKey(vchKey, SER_DISK, CLIENT_VERSION);
+    CAddressIndexKey key;
+    try {
+        ssKey >> key;
+    } catch (const std::exception&) {
+        throw JSONRPCError(RPC_INVALID_PARAMETER, "Invalid after cursor");
+    }
+    if (!ssKey.empty())
+        throw JSONRPCError(RPC_INVALID_PARAMETER, "Invalid after cursor");
+    return key;
+}
+
+/** The limit and after cursor of a paged address index query, limit 0 for no paging */
+static void ParseAddressIndexPaging(const UniValue& params, size_t& nLimit, bool& fAfter, CAddressIndexKey& after)
+{
+    nLimit = 0;
+    fAfter = false;
+    if (!params[0].isObject())
+        return;
+    UniValue limitValue = find_value(params[0].get_obj(), "limit");
+    if (limitValue.isNum()) {
+        if (limitValue.get_int() < 1)
+            throw JSONRPCError(RPC_INVALID_PARAMETER, "Limit is expected to be greater than zero");
+        nLimit = limitValue.get_int();
+    }
+    UniValue afterValue = find_value(params[0].get_obj(), "after");
+    if (!afterValue.isNull()) {
+        after = ParseAddressIndexCursor(afterValue);
+        fAfter = true;
+    }
+}
+
 UniValue getaddressmempool(const JSONRPCRequest& request)
 {
     if (request.fHelp || request.params.size() > 2)
@@ -929,6 +1295,8 @@ UniValue getaddressdeltas(const JSONRPCRequest& request)
             "  \"end\" (number) The end block height\n"
             "  \"chainInfo\" (boolean) Include chain info in results, only applies if start and end specified\n"
             "  \"assetName\"   (string, optional) Get deltas for a particular asset instead of RVN.\n"
+            "  \"limit\" (number, optional) Return at most this many deltas, in an object with the cursor to continue from\n"
+            "  \"after\" (string, optional) Continue after the last delta of a previous page, the \"after\" it was returned with\n"
             "}\n"
             "\nResult:\n"
             "[\n"
@@ -941,6 +1309,8 @@ UniValue getaddressdeltas(const JSONRPCRequest& request)
             "    \"address\"  (string) The base58check encoded address\n"
             "  }\n"
             "]\n"
+            "Deltas of several addresses are merged in chain order. With limit or chainInfo the array is the \"deltas\" member\n"
+            "of an object, and with limit the object's \"after\" is the cursor for the next page (null after the last one).\n"
             "\nExamples:\n"
             + HelpExampleCli("getaddressdeltas", "'{\"addresses\": [\"12c6DSiU4Rq3P4ZxziKxzrL5LmMBrzjrJX\"]}'")
             + HelpExampleRpc("getaddressdeltas", "{\"addresses\": [\"12c6DSiU4Rq3P4ZxziKxzrL5LmMBrzjrJX\"]}")
@@ -986,42 +1356,32 @@ UniValue getaddressdeltas(const JSONRPCRequest& request)
         throw JSONRPCError(RPC_INVALID_ADDRESS_OR_KEY, "Invalid address");
     }
 
-    std::vector<std::pair<CAddressIndexKey, CAmount> > addressIndex;
+    size_t nLimit;
+    bool fAfter;
+    CAddressIndexKey after;
+    ParseAddressIndexPaging(request.params, nLimit, fAfter, after);
 
-    for (std::vector<std::pair<uint160, int> >::iterator it = addresses.begin(); it != addresses.end(); it++) {
-        if (start > 0 && end > 0) {
-            if (!GetAddressIndex((*it).first, (*it).second, assetName, addressIndex, start, end)) {
-                throw JSONRPCError(RPC_INVALID_ADDRESS_OR_KEY, "No information available for address");
-            }
-        } else {
-            if (!GetAddressIndex((*it).first, (*it).second, assetName, addressIndex)) {
-                throw JSONRPCError(RPC_INVALID_ADDRESS_OR_KEY, "No information available for address");
-            }
-        }
+    if (!fAddressIndex) {
+        throw JSONRPCError(RPC_INVALID_ADDRESS_OR_KEY, "No information available for address");
     }
 
-    UniValue deltas(UniValue::VARR);
-
-    for (std::vector<std::pair<CAddressIndexKey, CAmount> >::const_iterator it=addressIndex.begin(); it!=addressIndex.end(); it++) {
-        std::string address;
-        if (!getAddressFromIndex(it->first.type, it->first.hashBytes, address)) {
-            throw JSONRPCError(RPC_INVALID_ADDRESS_OR_KEY, "Unknown address type");
-        }
-
-        UniValue delta(UniValue::VOBJ);
-        delta.push_back(Pair("assetName", it->first.asset));
-        delta.push_back(Pair("satoshis", it->second));
-        delta.push_back(Pair("txid", it->first.txhash.GetHex()));
-        delta.push_back(Pair("index", (int)it->first.index));
-        delta.push_back(Pair("blockindex", (int)it->first.txindex));
-        delta.push_back(Pair("height", it->first.blockHeight));
-        delta.push_back(Pair("address", address));
-        deltas.push_back(delta);
+    // Merge the addresses' entries in chain order, reading only as many as the page needs
+    std::vector<std::pair<CAddressIndexKey, CAmount> > addressIndex;
+    CAddressIndexCursor cursor(*pblocktree, addresses, assetName, start, end, fAfter ? &after : nullptr);
+    for (; cursor.Valid() && (nLimit == 0 || addressIndex.size() < nLimit); cursor.Next())
+        addressIndex.emplace_back(cursor.GetKey(), cursor.GetValue());
+    if (cursor.Failed()) {
+        throw JSONRPCError(RPC_INVALID_ADDRESS_OR_KEY, "No information available for address");
     }
-
-    UniValue result(UniValue::VOBJ);
-
-    if (includeChainInfo && start > 0 && end > 0) {
+    UniValue nextCursor = NullUniValue;
+    if (cursor.Valid() && !addressIndex.empty())
+        nextCursor = AddressIndexCursorString(addressIndex.back().first);
+
+    // Chain info first, so nothing can fail once the deltas are streamed
+    bool fChainInfo = includeChainInfo && start > 0 && end > 0;
+    UniValue startInfo(UniValue::VOBJ);
+    UniValue endInfo(UniValue::VOBJ);
+    if (fChainInfo) {
         LOCK(cs_main);
 
         if (start > chainActive.Height() || end > chainActive.Height()) {
@@ -1031,19 +1391,65 @@ UniValue getaddressdeltas(const JSONRPCRequest& request)
         CBlockIndex* startIndex = chainActive[start];
         CBlockIndex* endIndex = chainActive[end];
 
-        UniValue startInfo(UniValue::VOBJ);
-        UniValue endInfo(UniValue::VOBJ);
-
         startInfo.push_back(Pair("hash", startIndex->GetBlockHash().GetHex()));
         startInfo.push_back(Pair("height", start));
 
         endInfo.push_back(Pair("hash", endIndex->GetBlockHash().GetHex()));
         endInfo.push_back(Pair("height", end));
+    }
 
-        result.push_back(Pair("deltas", deltas));
-        result.push_back(Pair("start", startInfo));
-        result.push_back(Pair("end", endInfo));
+    auto deltaToJSON = [](const std::pair<CAddressIndexKey, CAmount>& entry) {
+        std::string address;
+        if (!getAddressFromIndex(entry.first.type, entry.first.hashBytes, address)) {
+            throw JSONRPCError(RPC_INVALID_ADDRESS_OR_KEY, "Unknown address type");
+        }
+
+        UniValue delta(UniValue::VOBJ);
+        delta.push_back(Pair("assetName", entry.first.asset));
+        delta.push_back(Pair("satoshis", entry.second));
+        delta.push_back(Pair("txid", entry.first.txhash.GetHex()));
+        delta.push_back(Pair("index", (int)entry.first.index));
+        delta.push_back(Pair("blockindex", (int)entry.first.txindex));
+        delta.push_back(Pair("height", entry.first.blockHeight));
+        delta.push_back(Pair("address", address));
+        return delta;
+    };
+
+    bool fPaged = nLimit > 0;
+    if (request.stream) {
+        CJSONStreamWriter& stream = *request.stream;
+        if (fChainInfo || fPaged) {
+            stream.BeginObject();
+            stream.Key("deltas");
+        }
+        stream.BeginArray();
+        for (const auto& entry : addressIndex)
+            stream.Value(deltaToJSON(entry));
+        stream.EndArray();
+        if (fChainInfo) {
+            stream.KeyValue("start", startInfo);
+            stream.KeyValue("end", endInfo);
+        }
+        if (fPaged)
+            stream.KeyValue("after", nextCursor);
+        if (fChainInfo || fPaged)
+            stream.EndObject();
+        return NullUniValue;
+    }
+
+    UniValue deltas(UniValue::VARR);
+    for (const auto& entry : addressIndex)
+        deltas.push_back(deltaToJSON(entry));
 
+    if (fChainInfo || fPaged) {
+        UniValue result(UniValue::VOBJ);
+        result.push_back(Pair("deltas", deltas));
+        if (fChainInfo) {
+            result.push_back(Pair("start", startInfo));
+            result.push_back(Pair("end", endInfo));
+        }
+        if (fPaged)
+            result.push_back(Pair("after", nextCursor));
         return result;
     } else {
         return deltas;
@@ -1097,21 +1503,42 @@ UniValue getaddressbalance(const JSONRPCRequest& request)
         includeAssets = request.params[1].get_bool();
     }
 
-    if (includeAssets) {
-        if (!AreAssetsDeployed())
-            throw JSONRPCError(RPC_INVALID_PARAMETER, "Assets aren't active.  includeAssets can't be true.");
+    if (includeAssets && !AreAssetsDeployed())
+        throw JSONRPCError(RPC_INVALID_PARAMETER, "Assets aren't active.  includeAssets can't be true.");
+
+    //assetName -> (received, balance)
+    std::map<std::string, std::pair<CAmount, CAmount>> balances;
 
+    if (fAddressIndex && pblocktree->HaveAddressBalances()) {
+        // Each (address, asset) keeps a running total, so this is one read per address
+        for (const auto& address : addresses) {
+            if (includeAssets) {
+                std::vector<std::pair<std::string, CAddressBalanceValue> > vBalances;
+                if (!pblocktree->ReadAddressBalances(address.first, address.second, vBalances))
+                    throw JSONRPCError(RPC_INVALID_ADDRESS_OR_KEY, "No information available for address");
+                for (const auto& entry : vBalances) {
+                    balances[entry.first].first += entry.second.received;
+                    balances[entry.first].second += entry.second.balance;
+                }
+            } else {
+                CAddressBalanceValue value;
+                if (!pblocktree->ReadAddressBalance(address.first, address.second, RVN, value))
+                    throw JSONRPCError(RPC_INVALID_ADDRESS_OR_KEY, "No information available for address");
+                balances[RVN].first += value.received;
+                balances[RVN].second += value.balance;
+            }
+        }
+    } else {
         std::vector<std::pair<CAddressIndexKey, CAmount> > addressIndex;
 
         for (std::vector<std::pair<uint160, int> >::iterator it = addresses.begin(); it != addresses.end(); it++) {
-            if (!GetAddressIndex((*it).first, (*it).second, addressIndex)) {
+            bool fRead = includeAssets ? GetAddressIndex((*it).first, (*it).second, addressIndex)
+                                       : GetAddressIndex((*it).first, (*it).second, RVN, addressIndex);
+            if (!fRead) {
                 throw JSONRPCError(RPC_INVALID_ADDRESS_OR_KEY, "No information available for address");
             }
         }
 
-        //assetName -> (received, balance)
-        std::map<std::string, std::pair<CAmount, CAmount>> balances;
-
         for (std::vector<std::pair<CAddressIndexKey, CAmount> >::const_iterator it = addressIndex.begin();
              it != addressIndex.end(); it++) {
             std::string assetName = it->first.asset;
@@ -1123,7 +1550,9 @@ UniValue getaddressbalance(const JSONRPCRequest& request)
             }
             balances[assetName].second += it->second;
         }
+    }
 
+    if (includeAssets) {
         UniValue result(UniValue::VARR);
 
         for (std::map<std::string, std::pair<CAmount, CAmount>>::const_iterator it = balances.begin();
@@ -1135,35 +1564,14 @@ UniValue getaddressbalance(const JSONRPCRequest& request)
             result.push_back(balance);
         }
 
-        return result;
-
-    } else {
-        std::vector<std::pair<CAddressIndexKey, CAmount> > addressIndex;
-
-        for (std::vector<std::pair<uint160, int> >::iterator it = addresses.begin(); it != addresses.end(); it++) {
-            if (!GetAddressIndex((*it).first, (*it).second, RVN, addressIndex)) {
-                throw JSONRPCError(RPC_INVALID_ADDRESS_OR_KEY, "No information available for address");
-            }
-        }
-
-        CAmount balance = 0;
-        CAmount received = 0;
-
-        for (std::vector<std::pair<CAddressIndexKey, CAmount> >::const_iterator it = addressIndex.begin();
-             it != addressIndex.end(); it++) {
-            if (it->second > 0) {
-                received += it->second;
-            }
-            balance += it->second;
-        }
-
-        UniValue result(UniValue::VOBJ);
-        result.push_back(Pair("balance", balance));
-        result.push_back(Pair("received", received));
-
         return result;
     }
 
+    UniValue result(UniValue::VOBJ);
+    result.push_back(Pair("balance", balances[RVN].second));
+    result.push_back(Pair("received", balances[RVN].first));
+
+    return result;
 }
 
 UniValue getaddresstxids(const JSONRPCRequest& request)
@@ -1181,6 +1589,8 @@ UniValue getaddresstxids(const JSONRPCRequest& request)
             "    ]\n"
             "  \"start\" (number, optional) The start block height\n"
             "  \"end\" (number, optional) The end block height\n"
+            "  \"limit\" (number, optional) Return at most this many txids, in an object with the cursor to continue from\n"
+            "  \"after\" (string, optional) Continue after the last txid of a previous page, the \"after\" it was returned with\n"
             "},\n"
             "\"includeAssets\" (boolean, optional, default false)  If true this will return an expanded result which includes asset transactions\n"
             "\nResult:\n"
@@ -1188,6 +1598,8 @@ UniValue getaddresstxids(const JSONRPCRequest& request)
             "  \"transactionid\"  (string) The transaction id\n"
             "  ,...\n"
             "]\n"
+            "Txids are in chain order. With limit the array is the \"txids\" member of an object whose \"after\"\n"
+            "is the cursor for the next page (null after the last one).\n"
             "\nExamples:\n"
             + HelpExampleCli("getaddresstxids", "'{\"addresses\": [\"12c6DSiU4Rq3P4ZxziKxzrL5LmMBrzjrJX\"]}'")
             + HelpExampleRpc("getaddresstxids", "{\"addresses\": [\"12c6DSiU4Rq3P4ZxziKxzrL5LmMBrzjrJX\"]}")
@@ -1221,52 +1633,46 @@ UniValue getaddresstxids(const JSONRPCRequest& request)
         if (!AreAssetsDeployed())
             throw JSONRPCError(RPC_INVALID_PARAMETER, "Assets aren't active.  includeAssets can't be true.");
 
-    std::vector<std::pair<CAddressIndexKey, CAmount> > addressIndex;
+    size_t nLimit;
+    bool fAfter;
+    CAddressIndexKey after;
+    ParseAddressIndexPaging(request.params, nLimit, fAfter, after);
 
-    for (std::vector<std::pair<uint160, int> >::iterator it = addresses.begin(); it != addresses.end(); it++) {
-        if (includeAssets) {
-            if (start > 0 && end > 0) {
-                if (!GetAddressIndex((*it).first, (*it).second, addressIndex, start, end)) {
-                    throw JSONRPCError(RPC_INVALID_ADDRESS_OR_KEY, "No information available for address");
-                }
-            } else {
-                if (!GetAddressIndex((*it).first, (*it).second, addressIndex)) {
-                    throw JSONRPCError(RPC_INVALID_ADDRESS_OR_KEY, "No information available for address");
-                }
-            }
-        } else {
-            if (start > 0 && end > 0) {
-                if (!GetAddressIndex((*it).first, (*it).second, RVN, addressIndex, start, end)) {
-                    throw JSONRPCError(RPC_INVALID_ADDRESS_OR_KEY, "No information available for address");
-                }
-            } else {
-                if (!GetAddressIndex((*it).first, (*it).second, RVN, addressIndex)) {
-                    throw JSONRPCError(RPC_INVALID_ADDRESS_OR_KEY, "No information available for address");
-                }
-            }
-        }
+    if (!fAddressIndex) {
+        throw JSONRPCError(RPC_INVALID_ADDRESS_OR_KEY, "No information available for address");
+    }
+    if (start <= 0 || end <= 0) {
+        start = 0;
+        end = 0;
     }
 
-    std::set<std::pair<int, std::string> > txids;
+    // In chain order all entries of a transaction are next to each other, so
+    // repeats are dropped as they come; a page ends after a whole transaction
     UniValue result(UniValue::VARR);
-
-    for (std::vector<std::pair<CAddressIndexKey, CAmount> >::const_iterator it=addressIndex.begin(); it!=addressIndex.end(); it++) {
-        int height = it->first.blockHeight;
-        std::string txid = it->first.txhash.GetHex();
-
-        if (addresses.size() > 1) {
-            txids.insert(std::make_pair(height, txid));
-        } else {
-            if (txids.insert(std::make_pair(height, txid)).second) {
-                result.push_back(txid);
-            }
+    CAddressIndexCursor cursor(*pblocktree, addresses, includeAssets ? "" : RVN, start, end, fAfter ? &after : nullptr);
+    CAddressIndexKey last;
+    bool fLast = false;
+    for (; cursor.Valid(); cursor.Next()) {
+        const CAddressIndexKey& key = cursor.GetKey();
+        if (fLast && key.blockHeight == last.blockHeight && key.txindex == last.txindex && key.txhash == last.txhash) {
+            last = key;
+            continue;
         }
+        if (nLimit > 0 && result.size() >= nLimit)
+            break;
+        result.push_back(key.txhash.GetHex());
+        last = key;
+        fLast = true;
+    }
+    if (cursor.Failed()) {
+        throw JSONRPCError(RPC_INVALID_ADDRESS_OR_KEY, "No information available for address");
     }
 
-    if (addresses.size() > 1) {
-        for (std::set<std::pair<int, std::string> >::const_iterator it=txids.begin(); it!=txids.end(); it++) {
-            result.push_back(it->second);
-        }
+    if (nLimit > 0) {
+        UniValue page(UniValue::VOBJ);
+        page.push_back(Pair("txids", result));
+        page.push_back(Pair("after", cursor.Valid() && fLast ? UniValue(AddressIndexCursorString(last)) : NullUniValue));
+        return page;
     }
 
     return result;
@@ -1326,6 +1732,10 @@ static const CRPCCommand commands[] =
   //  --------------------- ------------------------  -----------------------  ----------
     { "control",            "getinfo",                &getinfo,                {} }, /* uses wallet if enabled */
     { "control",            "getmemoryinfo",          &getmemoryinfo,          {"mode"} },
+    { "control",            "getcheckqueueinfo",      &getcheckqueueinfo,      {} },
+    { "control",            "getvalidationqueueinfo", &getvalidationqueueinfo, {} },
+    { "control",            "getlockstats",           &getlockstats,           {"count","reset"} },
+    { "control",            "getschedulerstats",      &getschedulerstats,      {"reset"} },
     { "util",               "validateaddress",        &validateaddress,        {"address"} }, /* uses wallet if enabled */
     { "util",               "createmultisig",         &createmultisig,         {"nrequired","keys"} },
     { "util",               "verifymessage",          &verifymessage,          {"address","signature","message"} },
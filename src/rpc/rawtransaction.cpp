@@ -48,17 +48,29 @@ void TxToJSON(const CTransaction& tx, const uint256 hashBlock, UniValue& entry,
 
     if (expanded) {
         uint256 txid = tx.GetHash();
+
+        // Look up the spent information of every input and output at once
+        std::vector<CSpentIndexKey> vSpentKeys;
+        if (!tx.IsCoinBase()) {
+            for (const CTxIn& txin : tx.vin)
+                vSpentKeys.push_back(CSpentIndexKey(txin.prevout.hash, txin.prevout.n));
+        }
+        const size_t nVoutStart = vSpentKeys.size();
+        for (unsigned int i = 0; i < tx.vout.size(); i++)
+            vSpentKeys.push_back(CSpentIndexKey(txid, i));
+        std::vector<CSpentIndexValue> vSpentInfo;
+        std::vector<bool> vSpentFound;
+        GetSpentIndex(vSpentKeys, vSpentInfo, vSpentFound);
+
         if (!(tx.IsCoinBase())) {
             const UniValue& oldVin = entry["vin"];
             UniValue newVin(UniValue::VARR);
             for (unsigned int i = 0; i < tx.vin.size(); i++) {
-                const CTxIn& txin = tx.vin[i];
                 UniValue in = oldVin[i];
 
                 // Add address and value info if spentindex enabled
-                CSpentIndexValue spentInfo;
-                CSpentIndexKey spentKey(txin.prevout.hash, txin.prevout.n);
-                if (GetSpentIndex(spentKey, spentInfo)) {
+                if (vSpentFound[i]) {
+                    const CSpentIndexValue& spentInfo = vSpentInfo[i];
                     in.pushKV("value", ValueFromAmount(spentInfo.satoshis));
                     in.pushKV("valueSat", spentInfo.satoshis);
                     if (spentInfo.addressType == 1) {
@@ -79,9 +91,8 @@ void TxToJSON(const CTransaction& tx, const uint256 hashBlock, UniValue& entry,
             UniValue out = oldVout[i];
 
             // Add spent information if spentindex is enabled
-            CSpentIndexValue spentInfo;
-            CSpentIndexKey spentKey(txid, i);
-            if (GetSpentIndex(spentKey, spentInfo)) {
+            if (vSpentFound[nVoutStart + i]) {
+                const CSpentIndexValue& spentInfo = vSpentInfo[nVoutStart + i];
                 out.pushKV("spentTxId", spentInfo.txid.GetHex());
                 out.pushKV("spentIndex", (int)spentInfo.inputIndex);
                 out.pushKV("spentHeight", spentInfo.blockHeight);
@@ -183,8 +194,6 @@ UniValue getrawtransaction(const JSONRPCRequest& request)
             + HelpExampleRpc("getrawtransaction", "\"mytxid\", true")
         );
 
-    LOCK(cs_main);
-
     uint256 hash = ParseHashV(request.params[0], "parameter 1");
 
     // Accept either a bool (true) or a num (>=1) to indicate verbose output.
@@ -216,8 +225,13 @@ UniValue getrawtransaction(const JSONRPCRequest& request)
     if (!fVerbose)
         return EncodeHexTx(*tx, RPCSerializationFlags());
 
+    // Only the block context needs cs_main; GetTransaction takes it itself
+    // when it has to, so lookups through the tx index run concurrently
     UniValue result(UniValue::VOBJ);
-    TxToJSON(*tx, hashBlock, result, true);
+    {
+        LOCK(cs_main);
+        TxToJSON(*tx, hashBlock, result, true);
+    }
 
     return result;
 }
@@ -431,6 +431,19 @@ UniValue getdistributestatus(const JSONRPCRequest& request) {
                 "4. \"gross_distribution_amount\"  (number, required) The amount of the distribution asset that will be split amongst all owners\n"
                 "5. \"exception_addresses\"        (string, optional) Ownership addresses that should be excluded\n"
 
+                "\nResult:\n"
+                "{\n"
+                "  \"Asset Name\", \"Height\", \"Distribution Name\", \"Distribution Amount\", \"Status\",\n"
+                "  \"Progress\": {                   (object) Only once this node has started sending the distribution\n"
+                "    \"running\": true|false,         (boolean) Whether the transactions are being built right now\n"
+                "    \"owners\": n,                   (number) Owners in the snapshot that get a share\n"
+                "    \"owners_processed\": n,         (number) Owners whose payment has been computed\n"
+                "    \"batches_confirmed\": n,        (number) Payment transactions already in a block\n"
+                "    \"batches_sent\": n,             (number) Payment transactions sent by the last run\n"
+                "    \"batches_pending\": n,          (number) Payment transactions built and waiting to be signed\n"
+                "  }\n"
+                "}\n"
+
                 "\nExamples:\n"
                 + HelpExampleCli("getdistributestatus", "\"TRONCO\" 12345 \"RVN\" 1000")
                 + HelpExampleCli("getdistributestatus", "\"PHATSTACKS\" 12345 \"DIVIDENDS\" 1000 \"mwN7xC3yomYdvJuVXkVC7ymY9wNBjWNduD,n4Rf18edydDaRBh7t6gHUbuByLbWEoWUTg\"")
@@ -475,6 +488,18 @@ UniValue getdistributestatus(const JSONRPCRequest& request) {
     responseObj.push_back(std::make_pair("Distribution Amount", ValueFromAmount(temp.nDistributionAmount)));
     responseObj.push_back(std::make_pair("Status", temp.nStatus));
 
+    CDistributionProgress progress;
+    if (GetDistributionProgress(hash, progress)) {
+        UniValue progressObj(UniValue::VOBJ);
+        progressObj.push_back(std::make_pair("running", progress.fRunning));
+        progressObj.push_back(std::make_pair("owners", progress.nOwners));
+        progressObj.push_back(std::make_pair("owners_processed", progress.nOwnersProcessed));
+        progressObj.push_back(std::make_pair("batches_confirmed", progress.nBatchesConfirmed));
+        progressObj.push_back(std::make_pair("batches_sent", progress.nBatchesSent));
+        progressObj.push_back(std::make_pair("batches_pending", progress.nBatchesPending));
+        responseObj.push_back(std::make_pair("Progress", progressObj));
+    }
+
     return responseObj;
 }
 #endif
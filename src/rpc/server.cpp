@@ -8,6 +8,8 @@
 
 #include "base58.h"
 #include "fs.h"
+#include "httprpc.h"
+#include "httpserver.h"
 #include "init.h"
 #include "random.h"
 #include "sync.h"
@@ -15,8 +17,12 @@
 #include "util.h"
 #include "utilstrencodings.h"
 #include "mining.h"
+#include "rpc/jsonview.h"
 
+#include <atomic>
+#include <condition_variable>
 #include <mutex>
+#include <set>
 #include <univalue.h>
 
 // Fixing Boost 1.73 compile errors
@@ -319,6 +325,32 @@ UniValue getrpcinfo(const JSONRPCRequest& jsonRequest)
                 "    \"duration\"     (numeric)  The running time in microseconds\n"
                 "   },...\n"
                 "  ],\n"
+                " \"work_queues\" (array) The HTTP work queues requests wait in, the default one first\n"
+                "  [\n"
+                "   {               (object) Information about a work queue\n"
+                "    \"name\"         (string)  The name used with -rpcqueue and -rpcroute\n"
+                "    \"threads\"      (numeric) Worker threads serving it\n"
+                "    \"depth\"        (numeric) Requests waiting now\n"
+                "    \"max_depth\"    (numeric) Requests that can wait before new ones are rejected\n"
+                "    \"processed\"    (numeric) Requests handled\n"
+                "    \"rejected\"     (numeric) Requests rejected because the queue was full\n"
+                "    \"avg_wait\"     (numeric) Average time waiting for a worker, in microseconds\n"
+                "    \"max_wait\"     (numeric) Longest time waiting for a worker, in microseconds\n"
+                "    \"avg_run\"      (numeric) Average time handling a request, in microseconds\n"
+                "    \"max_run\"      (numeric) Longest time handling a request, in microseconds\n"
+                "   },...\n"
+                "  ],\n"
+                " \"users\" (array) Requests per user that has connected\n"
+                "  [\n"
+                "   {               (object) Information about a user\n"
+                "    \"name\"          (string)  The user name\n"
+                "    \"requests\"      (numeric) Requests handled\n"
+                "    \"last_minute\"   (numeric) Requests handled in the last whole minute\n"
+                "    \"auth_failures\" (numeric) Requests rejected for a wrong password\n"
+                "    \"avg_latency\"   (numeric) Average time handling a request, in microseconds\n"
+                "    \"max_latency\"   (numeric) Longest time handling a request, in microseconds\n"
+                "   },...\n"
+                "  ]\n"
                 "}\n"
                 + HelpExampleCli("getrpcinfo", "")
                 + HelpExampleRpc("getrpcinfo", "")
@@ -337,6 +369,36 @@ UniValue getrpcinfo(const JSONRPCRequest& jsonRequest)
     result.pushKV("active_commands", active_commands);
     g_rpc_server_info.mtx.unlock();
 
+    UniValue work_queues(UniValue::VARR);
+    for (const HTTPWorkQueueStats& stats : GetHTTPWorkQueueStats()) {
+        UniValue entry(UniValue::VOBJ);
+        entry.pushKV("name", stats.name);
+        entry.pushKV("threads", stats.nThreads);
+        entry.pushKV("depth", (uint64_t)stats.nDepth);
+        entry.pushKV("max_depth", (uint64_t)stats.nMaxDepth);
+        entry.pushKV("processed", stats.nProcessed);
+        entry.pushKV("rejected", stats.nRejected);
+        entry.pushKV("avg_wait", stats.nProcessed ? stats.nTotalWaitMicros / (int64_t)stats.nProcessed : 0);
+        entry.pushKV("max_wait", stats.nMaxWaitMicros);
+        entry.pushKV("avg_run", stats.nProcessed ? stats.nTotalRunMicros / (int64_t)stats.nProcessed : 0);
+        entry.pushKV("max_run", stats.nMaxRunMicros);
+        work_queues.push_back(entry);
+    }
+    result.pushKV("work_queues", work_queues);
+
+    UniValue users(UniValue::VARR);
+    for (const HTTPRPCUserStats& stats : GetHTTPRPCUserStats()) {
+        UniValue entry(UniValue::VOBJ);
+        entry.pushKV("name", stats.name);
+        entry.pushKV("requests", stats.nRequests);
+        entry.pushKV("last_minute", stats.nLastMinute);
+        entry.pushKV("auth_failures", stats.nAuthFailures);
+        entry.pushKV("avg_latency", stats.nRequests ? stats.nTotalMicros / (int64_t)stats.nRequests : 0);
+        entry.pushKV("max_latency", stats.nMaxMicros);
+        users.push_back(entry);
+    }
+    result.pushKV("users", users);
+
     return result;
 }
 
@@ -439,18 +501,17 @@ bool RPCIsInWarmup(std::string *outStatus)
     return fRPCInWarmup;
 }
 
-void JSONRPCRequest::parse(const UniValue& valRequest)
+void JSONRPCRequest::parse(const UniValueView& valRequest)
 {
     // Parse request
     if (!valRequest.isObject())
         throw JSONRPCError(RPC_INVALID_REQUEST, "Invalid Request object");
-    const UniValue& request = valRequest.get_obj();
 
     // Parse id now so errors from here on will have the id
-    id = find_value(request, "id");
+    id = valRequest["id"].ToUniValue();
 
     // Parse method
-    UniValue valMethod = find_value(request, "method");
+    UniValueView valMethod = valRequest["method"];
     if (valMethod.isNull())
         throw JSONRPCError(RPC_INVALID_REQUEST, "Missing method");
     if (!valMethod.isStr())
@@ -459,9 +520,9 @@ void JSONRPCRequest::parse(const UniValue& valRequest)
     LogPrint(BCLog::RPC, "ThreadRPCServer method=%s\n", SanitizeString(strMethod));
 
     // Parse params
-    UniValue valParams = find_value(request, "params");
+    UniValueView valParams = valRequest["params"];
     if (valParams.isArray() || valParams.isObject())
-        params = valParams;
+        params = valParams.ToUniValue();
     else if (valParams.isNull())
         params = UniValue(UniValue::VARR);
     else
@@ -475,7 +536,7 @@ bool IsDeprecatedRPCEnabled(const std::string& method)
     return find(enabled_methods.begin(), enabled_methods.end(), method) != enabled_methods.end();
 }
 
-static UniValue JSONRPCExecOne(JSONRPCRequest jreq, const UniValue& req)
+static UniValue JSONRPCExecOne(JSONRPCRequest jreq, const UniValueView& req)
 {
     UniValue rpc_result(UniValue::VOBJ);
 
@@ -498,11 +559,85 @@ static UniValue JSONRPCExecOne(JSONRPCRequest jreq, const UniValue& req)
     return rpc_result;
 }
 
-std::string JSONRPCExecBatch(const JSONRPCRequest& jreq, const UniValue& vReq)
+/** Methods that only read chain, mempool or index state. Consecutive calls
+ * to them in a batch don't depend on each other and may run concurrently. */
+static const std::set<std::string> setBatchParallelMethods = {
+    "decoderawtransaction", "decodescript", "getaddressbalance", "getaddressdeltas",
+    "getaddressmempool", "getaddresstxids", "getaddressutxos", "getassetdata",
+    "getbestblockhash", "getblock", "getblockcount", "getblockhash", "getblockhashes",
+    "getblockheader", "getmempoolentry", "getrawtransaction", "getspentinfo",
+    "gettxout", "gettxoutproof", "listassets", "validateaddress", "verifytxoutproof",
+};
+
+/** Calls of a batch shared between the worker running it and its helpers */
+struct JSONRPCBatchRun
 {
+    std::atomic<size_t> nNext{0};
+    size_t nEnd{0};
+    std::mutex cs;
+    std::condition_variable cond;
+    size_t nDone{0};
+};
+
+/** Run calls of the batch until there are none left to claim. Helpers can
+ * start after the batch is finished, so only touch the calls after claiming
+ * one; the worker running the batch waits for every claimed call. */
+static void JSONRPCExecBatchCalls(std::shared_ptr<JSONRPCBatchRun> run, const JSONRPCRequest* jreq, const UniValueView* vCalls, UniValue* vResults)
+{
+    size_t i;
+    while ((i = run->nNext++) < run->nEnd) {
+        vResults[i] = JSONRPCExecOne(*jreq, vCalls[i]);
+        std::lock_guard<std::mutex> lock(run->cs);
+        if (++run->nDone == run->nEnd)
+            run->cond.notify_all();
+    }
+}
+
+std::string JSONRPCExecBatch(const JSONRPCRequest& jreq, const UniValueView& vReq, const RPCBatchSpawn& spawn, int nMaxHelpers)
+{
+    std::vector<UniValueView> vCalls;
+    for (const UniValueView& req : vReq)
+        vCalls.push_back(req);
+    std::vector<UniValue> vResults(vCalls.size());
+    auto fParallel = [&](size_t i) {
+        const UniValueView method = vCalls[i]["method"];
+        return method.isStr() && setBatchParallelMethods.count(method.get_str());
+    };
+
+    size_t i = 0;
+    while (i < vCalls.size()) {
+        // Calls that may change state run alone, in order
+        size_t nEnd = i + 1;
+        if (fParallel(i)) {
+            while (nEnd < vCalls.size() && fParallel(nEnd))
+                nEnd++;
+        }
+        if (nEnd - i == 1 || !spawn || nMaxHelpers < 1) {
+            for (; i < nEnd; i++)
+                vResults[i] = JSONRPCExecOne(jreq, vCalls[i]);
+            continue;
+        }
+
+        std::shared_ptr<JSONRPCBatchRun> run = std::make_shared<JSONRPCBatchRun>();
+        run->nEnd = nEnd - i;
+        const UniValueView* pCalls = &vCalls[i];
+        UniValue* pResults = &vResults[i];
+        size_t nHelpers = std::min<size_t>(nMaxHelpers, run->nEnd - 1);
+        for (size_t n = 0; n < nHelpers; n++) {
+            if (!spawn(std::bind(JSONRPCExecBatchCalls, run, &jreq, pCalls, pResults)))
+                break;
+        }
+        JSONRPCExecBatchCalls(run, &jreq, pCalls, pResults);
+        {
+            std::unique_lock<std::mutex> lock(run->cs);
+            run->cond.wait(lock, [&] { return run->nDone == run->nEnd; });
+        }
+        i = nEnd;
+    }
+
     UniValue ret(UniValue::VARR);
-    for (unsigned int reqIdx = 0; reqIdx < vReq.size(); reqIdx++)
-        ret.push_back(JSONRPCExecOne(jreq, vReq[reqIdx]));
+    for (const UniValue& result : vResults)
+        ret.push_back(result);
 
     return ret.write() + "\n";
 }
@@ -11,6 +11,7 @@
 #include "rpc/protocol.h"
 #include "uint256.h"
 
+#include <functional>
 #include <list>
 #include <map>
 #include <stdint.h>
@@ -20,7 +21,9 @@
 
 static const unsigned int DEFAULT_RPC_SERIALIZE_VERSION = 1;
 
+class CJSONStreamWriter;
 class CRPCCommand;
+class UniValueView;
 
 namespace RPCServer
 {
@@ -46,9 +49,12 @@ public:
     bool fHelp;
     std::string URI;
     std::string authUser;
+    //! If set, methods that can stream their result write it here instead (see CJSONStreamWriter)
+    CJSONStreamWriter* stream;
 
-    JSONRPCRequest() : id(NullUniValue), params(NullUniValue), fHelp(false) {}
-    void parse(const UniValue& valRequest);
+    JSONRPCRequest() : id(NullUniValue), params(NullUniValue), fHelp(false), stream(nullptr) {}
+    //! Only the id and params are turned into UniValues
+    void parse(const UniValueView& valRequest);
 };
 
 /** Query whether RPC is running */
@@ -195,7 +201,11 @@ void CheckIPFSTxidMessage(const std::string &message, int64_t expireTime);
 bool StartRPC();
 void InterruptRPC();
 void StopRPC();
-std::string JSONRPCExecBatch(const JSONRPCRequest& jreq, const UniValue& vReq);
+/** Run a task on another thread if one can take it, returning false if not */
+typedef std::function<bool(const std::function<void()>&)> RPCBatchSpawn;
+/** Execute a batch of calls and return the reply. Runs of read-only calls are
+ * shared with up to nMaxHelpers tasks started with spawn. */
+std::string JSONRPCExecBatch(const JSONRPCRequest& jreq, const UniValueView& vReq, const RPCBatchSpawn& spawn = nullptr, int nMaxHelpers = 0);
 
 // Retrieves any serialization flags requested in command line argument
 int RPCSerializationFlags();
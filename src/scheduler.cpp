@@ -8,13 +8,56 @@
 #include "random.h"
 #include "reverselock.h"
 
+#include <algorithm>
 #include <assert.h>
+#include <limits>
 // Fixing Boost 1.73 compile errors
 #include <boost/bind/bind.hpp>
 using namespace boost::placeholders;
 #include <utility>
 
-CScheduler::CScheduler() : nThreadsServicingQueue(0), stopRequested(false), stopWhenEmpty(false)
+CScheduler* g_scheduler = nullptr;
+
+static int64_t NanosSinceEpoch(const boost::chrono::system_clock::time_point& t)
+{
+    return boost::chrono::duration_cast<boost::chrono::nanoseconds>(t.time_since_epoch()).count();
+}
+
+static const int64_t NANOS_PER_TICK = CScheduler::TICK_MILLIS * 1000000;
+
+//! The first tick at or after t, so a task isn't run before its time
+static int64_t TickAtOrAfter(const boost::chrono::system_clock::time_point& t)
+{
+    const int64_t nNanos = NanosSinceEpoch(t);
+    int64_t nTick = nNanos / NANOS_PER_TICK;
+    if (nTick * NANOS_PER_TICK < nNanos)
+        nTick++;
+    return nTick;
+}
+
+//! The last tick that has started by t
+static int64_t TickAtOrBefore(const boost::chrono::system_clock::time_point& t)
+{
+    const int64_t nNanos = NanosSinceEpoch(t);
+    int64_t nTick = nNanos / NANOS_PER_TICK;
+    if (nTick * NANOS_PER_TICK > nNanos)
+        nTick--;
+    return nTick;
+}
+
+static boost::chrono::system_clock::time_point TickTime(int64_t nTick)
+{
+    return boost::chrono::system_clock::time_point(boost::chrono::milliseconds(nTick * CScheduler::TICK_MILLIS));
+}
+
+static bool RunsBefore(const boost::chrono::system_clock::time_point& t, uint64_t nSequence,
+                       const boost::chrono::system_clock::time_point& tOther, uint64_t nSequenceOther)
+{
+    return t < tOther || (t == tOther && nSequence < nSequenceOther);
+}
+
+CScheduler::CScheduler() : vLevelTasks(), nCurrentTick(TickAtOrBefore(boost::chrono::system_clock::now())), nTasks(0), nNextSequence(0),
+                           nThreadsServicingQueue(0), stopRequested(false), stopWhenEmpty(false)
 {
 }
 
@@ -33,6 +76,140 @@ static boost::system_time toPosixTime(const boost::chrono::system_clock::time_po
 }
 #endif
 
+void CScheduler::AddTask(Task&& task)
+{
+    nTasks++;
+    task.timings->nQueued++;
+    PlaceTask(std::move(task));
+}
+
+void CScheduler::PlaceTask(Task&& task)
+{
+    if (task.nTick < nCurrentTick) {
+        // Due already; keep readyTasks in the order the tasks are due
+        auto it = readyTasks.end();
+        while (it != readyTasks.begin() && RunsBefore(task.time, task.nSequence, (it - 1)->time, (it - 1)->nSequence))
+            --it;
+        readyTasks.insert(it, std::move(task));
+        return;
+    }
+    const int64_t nDelta = task.nTick - nCurrentTick;
+    for (int nLevel = 0; nLevel < WHEEL_LEVELS; nLevel++) {
+        const int nShift = WHEEL_BITS * nLevel;
+        if (nDelta < (int64_t(1) << (nShift + WHEEL_BITS))) {
+            vWheel[nLevel][(task.nTick >> nShift) & (WHEEL_SLOTS - 1)].push_back(std::move(task));
+            vLevelTasks[nLevel]++;
+            return;
+        }
+    }
+    vFarTasks.push_back(std::move(task));
+}
+
+void CScheduler::AdvanceTo(int64_t nTick)
+{
+    while (nCurrentTick <= nTick) {
+        // Entering the range of a slot of a higher level: spread its tasks
+        // over the levels below, starting from the top so none is missed.
+        const int nTopShift = WHEEL_BITS * (WHEEL_LEVELS - 1);
+        if ((nCurrentTick & ((int64_t(1) << nTopShift) - 1)) == 0 && !vFarTasks.empty()) {
+            std::vector<Task> vFar;
+            vFar.swap(vFarTasks);
+            for (Task& task : vFar)
+                PlaceTask(std::move(task));
+        }
+        for (int nLevel = WHEEL_LEVELS - 1; nLevel > 0; nLevel--) {
+            const int nShift = WHEEL_BITS * nLevel;
+            if ((nCurrentTick & ((int64_t(1) << nShift) - 1)) != 0 || vLevelTasks[nLevel] == 0)
+                continue;
+            std::vector<Task> vSlot;
+            vSlot.swap(vWheel[nLevel][(nCurrentTick >> nShift) & (WHEEL_SLOTS - 1)]);
+            vLevelTasks[nLevel] -= vSlot.size();
+            for (Task& task : vSlot)
+                PlaceTask(std::move(task));
+        }
+
+        std::vector<Task>& vSlot = vWheel[0][nCurrentTick & (WHEEL_SLOTS - 1)];
+        if (!vSlot.empty()) {
+            vLevelTasks[0] -= vSlot.size();
+            std::sort(vSlot.begin(), vSlot.end(), [](const Task& a, const Task& b) {
+                return RunsBefore(a.time, a.nSequence, b.time, b.nSequence);
+            });
+            nCurrentTick++;
+            for (Task& task : vSlot)
+                PlaceTask(std::move(task));
+            vSlot.clear();
+        } else {
+            nCurrentTick++;
+        }
+
+        // Skip the ticks where nothing is due or moves down: up to the next
+        // turn of the lowest level holding tasks, or all the way if none does
+        if (vLevelTasks[0] == 0) {
+            int nLevel = 1;
+            while (nLevel < WHEEL_LEVELS && vLevelTasks[nLevel] == 0)
+                nLevel++;
+            int64_t nNext = nTick + 1;
+            if (nLevel < WHEEL_LEVELS || !vFarTasks.empty()) {
+                const int64_t nSpan = int64_t(1) << (WHEEL_BITS * std::min(nLevel, WHEEL_LEVELS - 1));
+                nNext = std::min(nNext, (nCurrentTick + nSpan - 1) & ~(nSpan - 1));
+            }
+            nCurrentTick = std::max(nCurrentTick, nNext);
+        }
+    }
+}
+
+int64_t CScheduler::NextEventTick() const
+{
+    if (!readyTasks.empty())
+        return nCurrentTick - 1;
+    int64_t nNext = std::numeric_limits<int64_t>::max();
+    if (vLevelTasks[0] > 0) {
+        for (int64_t nTick = nCurrentTick; nTick < nCurrentTick + WHEEL_SLOTS; nTick++) {
+            if (!vWheel[0][nTick & (WHEEL_SLOTS - 1)].empty()) {
+                nNext = nTick;
+                break;
+            }
+        }
+    }
+    for (int nLevel = 1; nLevel < WHEEL_LEVELS; nLevel++) {
+        if (vLevelTasks[nLevel] == 0)
+            continue;
+        // The slots are moved down at the start of their range
+        const int nShift = WHEEL_BITS * nLevel;
+        const int64_t nSpan = int64_t(1) << nShift;
+        const int64_t nStart = (nCurrentTick + nSpan - 1) & ~(nSpan - 1);
+        for (int i = 0; i < WHEEL_SLOTS; i++) {
+            const int64_t nTick = nStart + i * nSpan;
+            if (nTick >= nNext)
+                break;
+            if (!vWheel[nLevel][(nTick >> nShift) & (WHEEL_SLOTS - 1)].empty()) {
+                nNext = nTick;
+                break;
+            }
+        }
+    }
+    if (!vFarTasks.empty()) {
+        const int64_t nSpan = int64_t(1) << (WHEEL_BITS * (WHEEL_LEVELS - 1));
+        nNext = std::min(nNext, (nCurrentTick + nSpan - 1) & ~(nSpan - 1));
+    }
+    return nNext;
+}
+
+template <typename Callable>
+void CScheduler::ForEachTask(Callable fn) const
+{
+    for (const Task& task : readyTasks)
+        fn(task);
+    for (int nLevel = 0; nLevel < WHEEL_LEVELS; nLevel++) {
+        for (const std::vector<Task>& vSlot : vWheel[nLevel]) {
+            for (const Task& task : vSlot)
+                fn(task);
+        }
+    }
+    for (const Task& task : vFarTasks)
+        fn(task);
+}
+
 void CScheduler::serviceQueue()
 {
     boost::unique_lock<boost::mutex> lock(newTaskMutex);
@@ -43,47 +220,53 @@ void CScheduler::serviceQueue()
     // is called.
     while (!shouldStop()) {
         try {
-            if (!shouldStop() && taskQueue.empty()) {
+            if (!shouldStop() && nTasks == 0) {
                 reverse_lock<boost::unique_lock<boost::mutex> > rlock(lock);
                 // Use this chance to get a tiny bit more entropy
                 RandAddSeedSleep();
             }
-            while (!shouldStop() && taskQueue.empty()) {
+            while (!shouldStop() && nTasks == 0) {
                 // Wait until there is something to do.
                 newTaskScheduled.wait(lock);
             }
 
-            // Wait until either there is a new task, or until
-            // the time of the first item on the queue:
-
+            // Turn the wheel until a task is due, waiting for the next tick
+            // with anything to do or for a new task in between.
+            while (!shouldStop() && nTasks > 0) {
+                AdvanceTo(TickAtOrBefore(boost::chrono::system_clock::now()));
+                if (!readyTasks.empty())
+                    break;
+                boost::chrono::system_clock::time_point timeToWaitFor = TickTime(NextEventTick());
 // wait_until needs boost 1.50 or later; older versions have timed_wait:
 #if BOOST_VERSION < 105000
-            while (!shouldStop() && !taskQueue.empty() &&
-                   newTaskScheduled.timed_wait(lock, toPosixTime(taskQueue.begin()->first))) {
-                // Keep waiting until timeout
-            }
+                newTaskScheduled.timed_wait(lock, toPosixTime(timeToWaitFor));
 #else
-            // Some boost versions have a conflicting overload of wait_until that returns void.
-            // Explicitly use a template here to avoid hitting that overload.
-            while (!shouldStop() && !taskQueue.empty()) {
-                boost::chrono::system_clock::time_point timeToWaitFor = taskQueue.begin()->first;
-                if (newTaskScheduled.wait_until<>(lock, timeToWaitFor) == boost::cv_status::timeout)
-                    break; // Exit loop after timeout, it means we reached the time of the event
-            }
+                // Some boost versions have a conflicting overload of wait_until that returns void.
+                // Explicitly use a template here to avoid hitting that overload.
+                newTaskScheduled.wait_until<>(lock, timeToWaitFor);
 #endif
+            }
             // If there are multiple threads, the queue can empty while we're waiting (another
             // thread may service the task we were waiting on).
-            if (shouldStop() || taskQueue.empty())
+            if (shouldStop() || readyTasks.empty())
                 continue;
 
-            Function f = taskQueue.begin()->second;
-            taskQueue.erase(taskQueue.begin());
+            Task task = std::move(readyTasks.front());
+            readyTasks.pop_front();
+            nTasks--;
+            task.timings->nQueued--;
+            // Another thread can take the next due task while this one runs
+            if (!readyTasks.empty())
+                newTaskScheduled.notify_one();
 
             {
                 // Unlock before calling f, so it can reschedule itself or another task
                 // without deadlocking:
                 reverse_lock<boost::unique_lock<boost::mutex> > rlock(lock);
-                f();
+                const boost::chrono::system_clock::time_point start = boost::chrono::system_clock::now();
+                task.timings->lateness.Add(boost::chrono::duration_cast<boost::chrono::microseconds>(start - task.time).count());
+                task.f();
+                task.timings->runtime.Add(boost::chrono::duration_cast<boost::chrono::microseconds>(boost::chrono::system_clock::now() - start).count());
             }
         } catch (...) {
             --nThreadsServicingQueue;
@@ -106,41 +289,49 @@ void CScheduler::stop(bool drain)
     newTaskScheduled.notify_all();
 }
 
-void CScheduler::schedule(CScheduler::Function f, boost::chrono::system_clock::time_point t)
+void CScheduler::schedule(CScheduler::Function f, boost::chrono::system_clock::time_point t, const std::string& name)
 {
     {
         boost::unique_lock<boost::mutex> lock(newTaskMutex);
-        taskQueue.insert(std::make_pair(t, f));
+        // Place the task relative to now, however long the wheel stood still
+        AdvanceTo(TickAtOrBefore(boost::chrono::system_clock::now()));
+        std::unique_ptr<TaskTimings>& timings = mapTaskTimings[name];
+        if (!timings)
+            timings.reset(new TaskTimings());
+        AddTask(Task{t, TickAtOrAfter(t), nNextSequence++, std::move(f), timings.get()});
     }
     newTaskScheduled.notify_one();
 }
 
-void CScheduler::scheduleFromNow(CScheduler::Function f, int64_t deltaMilliSeconds)
+void CScheduler::scheduleFromNow(CScheduler::Function f, int64_t deltaMilliSeconds, const std::string& name)
 {
-    schedule(f, boost::chrono::system_clock::now() + boost::chrono::milliseconds(deltaMilliSeconds));
+    schedule(f, boost::chrono::system_clock::now() + boost::chrono::milliseconds(deltaMilliSeconds), name);
 }
 
-static void Repeat(CScheduler* s, CScheduler::Function f, int64_t deltaMilliSeconds)
+static void Repeat(CScheduler* s, CScheduler::Function f, int64_t deltaMilliSeconds, const std::string& name)
 {
     f();
-    s->scheduleFromNow(boost::bind(&Repeat, s, f, deltaMilliSeconds), deltaMilliSeconds);
+    s->scheduleFromNow(boost::bind(&Repeat, s, f, deltaMilliSeconds, name), deltaMilliSeconds, name);
 }
 
-void CScheduler::scheduleEvery(CScheduler::Function f, int64_t deltaMilliSeconds)
+void CScheduler::scheduleEvery(CScheduler::Function f, int64_t deltaMilliSeconds, const std::string& name)
 {
-    scheduleFromNow(boost::bind(&Repeat, this, f, deltaMilliSeconds), deltaMilliSeconds);
+    scheduleFromNow(boost::bind(&Repeat, this, f, deltaMilliSeconds, name), deltaMilliSeconds, name);
 }
 
 size_t CScheduler::getQueueInfo(boost::chrono::system_clock::time_point &first,
                              boost::chrono::system_clock::time_point &last) const
 {
     boost::unique_lock<boost::mutex> lock(newTaskMutex);
-    size_t result = taskQueue.size();
-    if (!taskQueue.empty()) {
-        first = taskQueue.begin()->first;
-        last = taskQueue.rbegin()->first;
-    }
-    return result;
+    bool fFirst = true;
+    ForEachTask([&](const Task& task) {
+        if (fFirst || task.time < first)
+            first = task.time;
+        if (fFirst || task.time > last)
+            last = task.time;
+        fFirst = false;
+    });
+    return nTasks;
 }
 
 bool CScheduler::AreThreadsServicingQueue() const {
@@ -148,6 +339,34 @@ bool CScheduler::AreThreadsServicingQueue() const {
     return nThreadsServicingQueue;
 }
 
+int CScheduler::GetThreadCount() const
+{
+    boost::unique_lock<boost::mutex> lock(newTaskMutex);
+    return nThreadsServicingQueue;
+}
+
+std::map<std::string, CSchedulerTaskStats> CScheduler::GetTaskStats() const
+{
+    boost::unique_lock<boost::mutex> lock(newTaskMutex);
+    std::map<std::string, CSchedulerTaskStats> mapStats;
+    for (const auto& entry : mapTaskTimings) {
+        CSchedulerTaskStats& stats = mapStats[entry.first];
+        stats.nQueued = entry.second->nQueued;
+        stats.lateness = entry.second->lateness.GetStats();
+        stats.runtime = entry.second->runtime.GetStats();
+    }
+    return mapStats;
+}
+
+void CScheduler::ResetTaskStats()
+{
+    boost::unique_lock<boost::mutex> lock(newTaskMutex);
+    for (const auto& entry : mapTaskTimings) {
+        entry.second->lateness.Reset();
+        entry.second->runtime.Reset();
+    }
+}
+
 
 void SingleThreadedSchedulerClient::MaybeScheduleProcessQueue() {
     {
@@ -158,7 +377,7 @@ void SingleThreadedSchedulerClient::MaybeScheduleProcessQueue() {
         if (m_are_callbacks_running) return;
         if (m_callbacks_pending.empty()) return;
     }
-    m_pscheduler->schedule(std::bind(&SingleThreadedSchedulerClient::ProcessQueue, this));
+    m_pscheduler->schedule(std::bind(&SingleThreadedSchedulerClient::ProcessQueue, this), boost::chrono::system_clock::now(), "background_callbacks");
 }
 
 void SingleThreadedSchedulerClient::ProcessQueue() {
@@ -13,9 +13,14 @@
 //
 #include <boost/chrono/chrono.hpp>
 #include <boost/thread.hpp>
+#include <deque>
 #include <map>
+#include <memory>
+#include <string>
+#include <vector>
 
 #include "sync.h"
+#include "timinghistogram.h"
 
 //
 // Simple class for background tasks that should be run
@@ -25,7 +30,7 @@
 //
 // CScheduler* s = new CScheduler();
 // s->scheduleFromNow(doSomething, 11); // Assuming a: void doSomething() { }
-// s->scheduleFromNow(std::bind(Class::func, this, argument), 3);
+// s->scheduleFromNow(std::bind(Class::func, this, argument), 3, "func");
 // boost::thread* t = new boost::thread(boost::bind(CScheduler::serviceQueue, s));
 //
 // ... then at program shutdown, clean up the thread running serviceQueue:
@@ -35,6 +40,19 @@
 // delete s; // Must be done after thread is interrupted/joined.
 //
 
+static const int DEFAULT_SCHEDULER_THREADS = 1;
+static const int MAX_SCHEDULER_THREADS = 16;
+
+/** How late and how long the tasks of one name ran */
+struct CSchedulerTaskStats
+{
+    //! tasks of this name waiting to run
+    size_t nQueued{0};
+    //! from the time a task was due until a thread started it
+    CTimingStats lateness;
+    CTimingStats runtime;
+};
+
 class CScheduler
 {
 public:
@@ -43,18 +61,19 @@ public:
 
     typedef std::function<void(void)> Function;
 
-    // Call func at/after time t
-    void schedule(Function f, boost::chrono::system_clock::time_point t=boost::chrono::system_clock::now());
+    // Call func at/after time t. Tasks are named for the stats
+    // getschedulerstats reports, the name should be a literal.
+    void schedule(Function f, boost::chrono::system_clock::time_point t=boost::chrono::system_clock::now(), const std::string& name="unnamed");
 
     // Convenience method: call f once deltaSeconds from now
-    void scheduleFromNow(Function f, int64_t deltaMilliSeconds);
+    void scheduleFromNow(Function f, int64_t deltaMilliSeconds, const std::string& name="unnamed");
 
     // Another convenience method: call f approximately
     // every deltaSeconds forever, starting deltaSeconds from now.
     // To be more precise: every time f is finished, it
     // is rescheduled to run deltaSeconds later. If you
     // need more accurate scheduling, don't use this method.
-    void scheduleEvery(Function f, int64_t deltaMilliSeconds);
+    void scheduleEvery(Function f, int64_t deltaMilliSeconds, const std::string& name="unnamed");
 
     // To keep things as simple as possible, there is no unschedule.
 
@@ -75,16 +94,79 @@ public:
     // Returns true if there are threads actively running in serviceQueue()
     bool AreThreadsServicingQueue() const;
 
+    // Returns the number of threads running serviceQueue()
+    int GetThreadCount() const;
+
+    // Lateness and run time of the tasks run so far, by name
+    std::map<std::string, CSchedulerTaskStats> GetTaskStats() const;
+
+    // Forget the lateness and run times recorded so far
+    void ResetTaskStats();
+
+    //! Width of a slot of the lowest level of the wheel, in milliseconds
+    static const int64_t TICK_MILLIS = 1;
+    static const int WHEEL_LEVELS = 4;
+    static const int WHEEL_BITS = 6;
+    static const int WHEEL_SLOTS = 1 << WHEEL_BITS;
+
 private:
-    std::multimap<boost::chrono::system_clock::time_point, Function> taskQueue;
+    struct TaskTimings
+    {
+        size_t nQueued{0};
+        CTimingHistogram lateness;
+        CTimingHistogram runtime;
+    };
+
+    struct Task
+    {
+        boost::chrono::system_clock::time_point time;
+        //! the tick time rounds up to, so a task is never run early
+        int64_t nTick;
+        //! order tasks were scheduled in, to keep it among tasks due together
+        uint64_t nSequence;
+        Function f;
+        TaskTimings* timings;
+    };
+
+    /**
+     * Tasks waiting for their time, in a hierarchical timer wheel: the
+     * lowest level has a slot per tick for the next WHEEL_SLOTS ticks, each
+     * level above a slot per WHEEL_SLOTS slots of the one below. A task goes
+     * into the lowest level whose span reaches its tick, and is moved down a
+     * level whenever the wheel turns into the range of its slot, so
+     * scheduling and running a task costs the same however many are waiting.
+     * Tasks beyond the top level wait in vFarTasks.
+     */
+    std::vector<Task> vWheel[WHEEL_LEVELS][WHEEL_SLOTS];
+    size_t vLevelTasks[WHEEL_LEVELS];
+    std::vector<Task> vFarTasks;
+    //! the next tick the wheel has not reached; the tasks of earlier ticks are in readyTasks
+    int64_t nCurrentTick;
+    //! due tasks in the order to run them
+    std::deque<Task> readyTasks;
+    size_t nTasks;
+    uint64_t nNextSequence;
+    std::map<std::string, std::unique_ptr<TaskTimings>> mapTaskTimings;
+
     boost::condition_variable newTaskScheduled;
     mutable boost::mutex newTaskMutex;
     int nThreadsServicingQueue;
     bool stopRequested;
     bool stopWhenEmpty;
-    bool shouldStop() const { return stopRequested || (stopWhenEmpty && taskQueue.empty()); }
+    bool shouldStop() const { return stopRequested || (stopWhenEmpty && nTasks == 0); }
+
+    void AddTask(Task&& task);
+    void PlaceTask(Task&& task);
+    //! Turn the wheel up to and including nTick, moving the tasks due by then to readyTasks
+    void AdvanceTo(int64_t nTick);
+    //! Tick at which the wheel next has tasks to run or move down, if any are waiting
+    int64_t NextEventTick() const;
+    template <typename Callable> void ForEachTask(Callable fn) const;
 };
 
+/** The node's scheduler, for reporting its stats; null until it is started */
+extern CScheduler* g_scheduler;
+
 /**
  * Class used by CScheduler clients which may schedule multiple jobs
  * which are required to be run serially. Does not require such jobs
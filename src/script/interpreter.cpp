@@ -12,6 +12,7 @@
 #include "crypto/sha256.h"
 #include "pubkey.h"
 #include "script/script.h"
+#include "streams.h"
 
 typedef std::vector<unsigned char> valtype;
 
@@ -56,13 +57,117 @@ bool CastToBool(const valtype &vch)
 #define stacktop(i)  (stack.at(stack.size()+(i)))
 #define altstacktop(i)  (altstack.at(altstack.size()+(i)))
 
+namespace
+{
+/**
+ * Memory for stack elements, kept per thread. Elements popped off a stack
+ * hand their buffers back here and later pushes copy into them, so a script
+ * check thread that has warmed up evaluates an input without allocating for
+ * each signature, key and hash it pushes. Stacks are recycled the same way
+ * and give all their elements back when the input is done.
+ */
+class CScriptElementArena
+{
+private:
+    //! a signature (73 bytes) or an uncompressed key fits without growing
+    static const size_t ELEMENT_CAPACITY = 80;
+    //! far deeper than the stacks of standard scripts
+    static const size_t MAX_FREE_ELEMENTS = 128;
+    static const size_t MAX_FREE_STACKS = 8;
+
+    std::vector<valtype> vFreeElements;
+    std::vector<std::vector<valtype>> vFreeStacks;
+
+public:
+    CScriptElementArena()
+    {
+        vFreeElements.reserve(MAX_FREE_ELEMENTS);
+        vFreeStacks.reserve(MAX_FREE_STACKS);
+    }
+
+    valtype TakeElement()
+    {
+        if (vFreeElements.empty()) {
+            valtype vch;
+            vch.reserve(ELEMENT_CAPACITY);
+            return vch;
+        }
+        valtype vch = std::move(vFreeElements.back());
+        vFreeElements.pop_back();
+        return vch;
+    }
+
+    void GiveElement(valtype& vch)
+    {
+        // Buffers that were moved from or grew past any push are not worth keeping
+        if (vFreeElements.size() < MAX_FREE_ELEMENTS && vch.capacity() != 0 && vch.capacity() <= MAX_SCRIPT_ELEMENT_SIZE) {
+            vch.clear();
+            vFreeElements.push_back(std::move(vch));
+        }
+    }
+
+    std::vector<valtype> TakeStack()
+    {
+        if (vFreeStacks.empty())
+            return std::vector<valtype>();
+        std::vector<valtype> stack = std::move(vFreeStacks.back());
+        vFreeStacks.pop_back();
+        return stack;
+    }
+
+    void GiveStack(std::vector<valtype>& stack)
+    {
+        for (valtype& vch : stack)
+            GiveElement(vch);
+        stack.clear();
+        if (vFreeStacks.size() < MAX_FREE_STACKS)
+            vFreeStacks.push_back(std::move(stack));
+    }
+};
+
+CScriptElementArena& ElementArena()
+{
+    static thread_local CScriptElementArena arena;
+    return arena;
+}
+
+/** A stack taken from this thread's arena for the length of a scope */
+class CArenaStack
+{
+public:
+    std::vector<valtype> stack;
+
+    CArenaStack() : stack(ElementArena().TakeStack()) {}
+    ~CArenaStack() { ElementArena().GiveStack(stack); }
+};
+
+/** An element buffer taken from this thread's arena for the length of a scope */
+class CArenaElement
+{
+public:
+    valtype vch;
+
+    CArenaElement() : vch(ElementArena().TakeElement()) {}
+    ~CArenaElement() { ElementArena().GiveElement(vch); }
+};
+} // namespace
+
 static inline void popstack(std::vector<valtype> &stack)
 {
     if (stack.empty())
         throw std::runtime_error("popstack(): stack empty");
+    ElementArena().GiveElement(stack.back());
     stack.pop_back();
 }
 
+/** Push a copy of vch, which may be an element of the same stack */
+static inline void pushstack(std::vector<valtype> &stack, const valtype &vch)
+{
+    valtype vchCopy = ElementArena().TakeElement();
+    vchCopy.assign(vch.begin(), vch.end());
+    stack.push_back(std::move(vchCopy));
+}
+
 bool static IsCompressedOrUncompressedPubKey(const valtype &vchPubKey)
 {
     if (vchPubKey.size() < 33)
@@ -299,9 +404,11 @@ bool EvalScript(std::vector<std::vector<unsigned char> > &stack, const CScript &
     CScript::const_iterator pend = script.end();
     CScript::const_iterator pbegincodehash = script.begin();
     opcodetype opcode;
-    valtype vchPushValue;
+    CArenaElement pushValue;
+    valtype& vchPushValue = pushValue.vch;
     std::vector<bool> vfExec;
-    std::vector<valtype> altstack;
+    CArenaStack arenaAltstack;
+    std::vector<valtype>& altstack = arenaAltstack.stack;
     set_error(serror, SCRIPT_ERR_UNKNOWN_ERROR);
     if (script.size() > MAX_SCRIPT_SIZE)
         return set_error(serror, SCRIPT_ERR_SCRIPT_SIZE);
@@ -349,7 +456,7 @@ bool EvalScript(std::vector<std::vector<unsigned char> > &stack, const CScript &
                 {
                     return set_error(serror, SCRIPT_ERR_MINIMALDATA);
                 }
-                stack.push_back(vchPushValue);
+                pushstack(stack, vchPushValue);
             }
             else if (fExec || (OP_IF <= opcode && opcode <= OP_ENDIF))
             {
@@ -549,7 +656,7 @@ bool EvalScript(std::vector<std::vector<unsigned char> > &stack, const CScript &
                     {
                         if (stack.size() < 1)
                             return set_error(serror, SCRIPT_ERR_INVALID_STACK_OPERATION);
-                        altstack.push_back(stacktop(-1));
+                        pushstack(altstack, stacktop(-1));
                         popstack(stack);
                     }
                         break;
@@ -557,7 +664,7 @@ bool EvalScript(std::vector<std::vector<unsigned char> > &stack, const CScript &
                     {
                         if (altstack.size() < 1)
                             return set_error(serror, SCRIPT_ERR_INVALID_ALTSTACK_OPERATION);
-                        stack.push_back(altstacktop(-1));
+                        pushstack(stack, altstacktop(-1));
                         popstack(altstack);
                     }
                         break;
@@ -575,10 +682,8 @@ bool EvalScript(std::vector<std::vector<unsigned char> > &stack, const CScript &
                         // (x1 x2 -- x1 x2 x1 x2)
                         if (stack.size() < 2)
                             return set_error(serror, SCRIPT_ERR_INVALID_STACK_OPERATION);
-                        valtype vch1 = stacktop(-2);
-                        valtype vch2 = stacktop(-1);
-                        stack.push_back(vch1);
-                        stack.push_back(vch2);
+                        pushstack(stack, stacktop(-2));
+                        pushstack(stack, stacktop(-2));
                     }
                         break;
                     case OP_3DUP:
@@ -586,12 +691,9 @@ bool EvalScript(std::vector<std::vector<unsigned char> > &stack, const CScript &
                         // (x1 x2 x3 -- x1 x2 x3 x1 x2 x3)
                         if (stack.size() < 3)
                             return set_error(serror, SCRIPT_ERR_INVALID_STACK_OPERATION);
-                        valtype vch1 = stacktop(-3);
-                        valtype vch2 = stacktop(-2);
-                        valtype vch3 = stacktop(-1);
-                        stack.push_back(vch1);
-                        stack.push_back(vch2);
-                        stack.push_back(vch3);
+                        pushstack(stack, stacktop(-3));
+                        pushstack(stack, stacktop(-3));
+                        pushstack(stack, stacktop(-3));
                     }
                         break;
 
@@ -600,10 +702,8 @@ bool EvalScript(std::vector<std::vector<unsigned char> > &stack, const CScript &
                         // (x1 x2 x3 x4 -- x1 x2 x3 x4 x1 x2)
                         if (stack.size() < 4)
                             return set_error(serror, SCRIPT_ERR_INVALID_STACK_OPERATION);
-                        valtype vch1 = stacktop(-4);
-                        valtype vch2 = stacktop(-3);
-                        stack.push_back(vch1);
-                        stack.push_back(vch2);
+                        pushstack(stack, stacktop(-4));
+                        pushstack(stack, stacktop(-4));
                     }
                         break;
 
@@ -635,9 +735,8 @@ bool EvalScript(std::vector<std::vector<unsigned char> > &stack, const CScript &
                         // (x - 0 | x x)
                         if (stack.size() < 1)
                             return set_error(serror, SCRIPT_ERR_INVALID_STACK_OPERATION);
-                        valtype vch = stacktop(-1);
-                        if (CastToBool(vch))
-                            stack.push_back(vch);
+                        if (CastToBool(stacktop(-1)))
+                            pushstack(stack, stacktop(-1));
                     }
                         break;
 
@@ -663,8 +762,7 @@ bool EvalScript(std::vector<std::vector<unsigned char> > &stack, const CScript &
                         // (x -- x x)
                         if (stack.size() < 1)
                             return set_error(serror, SCRIPT_ERR_INVALID_STACK_OPERATION);
-                        valtype vch = stacktop(-1);
-                        stack.push_back(vch);
+                        pushstack(stack, stacktop(-1));
                     }
                         break;
 
@@ -682,8 +780,7 @@ bool EvalScript(std::vector<std::vector<unsigned char> > &stack, const CScript &
                         // (x1 x2 -- x1 x2 x1)
                         if (stack.size() < 2)
                             return set_error(serror, SCRIPT_ERR_INVALID_STACK_OPERATION);
-                        valtype vch = stacktop(-2);
-                        stack.push_back(vch);
+                        pushstack(stack, stacktop(-2));
                     }
                         break;
 
@@ -768,7 +865,7 @@ bool EvalScript(std::vector<std::vector<unsigned char> > &stack, const CScript &
                         //    fEqual = !fEqual;
                         popstack(stack);
                         popstack(stack);
-                        stack.push_back(fEqual ? vchTrue : vchFalse);
+                        pushstack(stack, fEqual ? vchTrue : vchFalse);
                         if (opcode == OP_EQUALVERIFY)
                         {
                             if (fEqual)
@@ -916,7 +1013,7 @@ bool EvalScript(std::vector<std::vector<unsigned char> > &stack, const CScript &
                         popstack(stack);
                         popstack(stack);
                         popstack(stack);
-                        stack.push_back(fValue ? vchTrue : vchFalse);
+                        pushstack(stack, fValue ? vchTrue : vchFalse);
                     }
                         break;
 
@@ -934,8 +1031,8 @@ bool EvalScript(std::vector<std::vector<unsigned char> > &stack, const CScript &
                         if (stack.size() < 1)
                             return set_error(serror, SCRIPT_ERR_INVALID_STACK_OPERATION);
                         valtype &vch = stacktop(-1);
-                        valtype vchHash(
-                                (opcode == OP_RIPEMD160 || opcode == OP_SHA1 || opcode == OP_HASH160) ? 20 : 32);
+                        valtype vchHash = ElementArena().TakeElement();
+                        vchHash.resize((opcode == OP_RIPEMD160 || opcode == OP_SHA1 || opcode == OP_HASH160) ? 20 : 32);
                         if (opcode == OP_RIPEMD160)
                             CRIPEMD160().Write(vch.data(), vch.size()).Finalize(vchHash.data());
                         else if (opcode == OP_SHA1)
@@ -947,7 +1044,7 @@ bool EvalScript(std::vector<std::vector<unsigned char> > &stack, const CScript &
                         else if (opcode == OP_HASH256)
                             CHash256().Write(vch.data(), vch.size()).Finalize(vchHash.data());
                         popstack(stack);
-                        stack.push_back(vchHash);
+                        stack.push_back(std::move(vchHash));
                     }
                         break;
 
@@ -990,7 +1087,7 @@ bool EvalScript(std::vector<std::vector<unsigned char> > &stack, const CScript &
 
                         popstack(stack);
                         popstack(stack);
-                        stack.push_back(fSuccess ? vchTrue : vchFalse);
+                        pushstack(stack, fSuccess ? vchTrue : vchFalse);
                         if (opcode == OP_CHECKSIGVERIFY)
                         {
                             if (fSuccess)
@@ -1102,7 +1199,7 @@ bool EvalScript(std::vector<std::vector<unsigned char> > &stack, const CScript &
                             return set_error(serror, SCRIPT_ERR_SIG_NULLDUMMY);
                         popstack(stack);
 
-                        stack.push_back(fSuccess ? vchTrue : vchFalse);
+                        pushstack(stack, fSuccess ? vchTrue : vchFalse);
 
                         if (opcode == OP_CHECKMULTISIGVERIFY)
                         {
@@ -1276,9 +1373,42 @@ namespace
         return ss.GetHash();
     }
 
+    /** Serializes straight into a SHA256 state, so the state can be copied part way through */
+    class CSHA256Writer
+    {
+    private:
+        CSHA256 &sha;
+
+    public:
+        explicit CSHA256Writer(CSHA256 &shaIn) : sha(shaIn) {}
+
+        int GetType() const { return SER_GETHASH; }
+        int GetVersion() const { return 0; }
+
+        void write(const char *pch, size_t size)
+        {
+            sha.Write((const unsigned char *) pch, size);
+        }
+
+        template<typename T>
+        CSHA256Writer &operator<<(const T &obj)
+        {
+            ::Serialize(*this, obj);
+            return *this;
+        }
+    };
+
+    //! Serialized size of an input other than the one being signed, under SIGHASH_ALL
+    const size_t LEGACY_BLANK_INPUT_SIZE = 36 + 1 + 4;
+
 } // namespace
 
 PrecomputedTransactionData::PrecomputedTransactionData(const CTransaction &txTo)
+{
+    Init(txTo);
+}
+
+void PrecomputedTransactionData::Init(const CTransaction &txTo)
 {
     // Cache is calculated only for transactions with witness
     if (txTo.HasWitness())
@@ -1288,6 +1418,30 @@ PrecomputedTransactionData::PrecomputedTransactionData(const CTransaction &txTo)
         hashOutputs = GetOutputsHash(txTo);
         ready = true;
     }
+
+    // With a single input there is nothing to share between inputs
+    if (txTo.vin.size() > 1)
+    {
+        CSHA256 sha;
+        CSHA256Writer ss(sha);
+        ss << txTo.nVersion;
+        ::WriteCompactSize(ss, txTo.vin.size());
+        vLegacyPrefix.clear();
+        vLegacyPrefix.reserve(txTo.vin.size());
+        vchLegacySuffix.clear();
+        CVectorWriter suffix(SER_GETHASH, 0, vchLegacySuffix, 0);
+        for (const auto &txin : txTo.vin)
+        {
+            vLegacyPrefix.push_back(sha);
+            ss << txin.prevout << CScript() << txin.nSequence;
+            suffix << txin.prevout << CScript() << txin.nSequence;
+        }
+        ::WriteCompactSize(suffix, txTo.vout.size());
+        for (const auto &txout : txTo.vout)
+            suffix << txout;
+        suffix << txTo.nLockTime;
+        legacyReady = true;
+    }
 }
 
 uint256 SignatureHash(const CScript &scriptCode, const CTransaction &txTo, unsigned int nIn, int nHashType, const CAmount &amount, SigVersion sigversion, const PrecomputedTransactionData *cache)
@@ -1361,6 +1515,23 @@ uint256 SignatureHash(const CScript &scriptCode, const CTransaction &txTo, unsig
     // Wrapper to serialize only the necessary parts of the transaction being signed
     CTransactionSignatureSerializer txTmp(txTo, scriptCode, nIn, nHashType);
 
+    // SIGHASH_ALL serializes the same blanked inputs and outputs for every input,
+    // so only the input being signed has to be hashed on top of the cached state
+    if (cache && cache->legacyReady && !(nHashType & SIGHASH_ANYONECANPAY) &&
+        (nHashType & 0x1f) != SIGHASH_SINGLE && (nHashType & 0x1f) != SIGHASH_NONE)
+    {
+        CSHA256 sha = cache->vLegacyPrefix[nIn];
+        CSHA256Writer ss(sha);
+        txTmp.SerializeInput(ss, nIn);
+        const size_t nSkip = (nIn + 1) * LEGACY_BLANK_INPUT_SIZE;
+        sha.Write(cache->vchLegacySuffix.data() + nSkip, cache->vchLegacySuffix.size() - nSkip);
+        ss << nHashType;
+        uint256 hash;
+        sha.Finalize(hash.begin());
+        CSHA256().Write(hash.begin(), CSHA256::OUTPUT_SIZE).Finalize(hash.begin());
+        return hash;
+    }
+
     // Serialize and hash
     CHashWriter ss(SER_GETHASH, 0);
     ss << txTmp << nHashType;
@@ -1475,7 +1646,8 @@ bool TransactionSignatureChecker::CheckSequence(const CScriptNum &nSequence) con
 
 static bool VerifyWitnessProgram(const CScriptWitness &witness, int witversion, const std::vector<unsigned char> &program, unsigned int flags, const BaseSignatureChecker &checker, ScriptError *serror)
 {
-    std::vector<std::vector<unsigned char> > stack;
+    CArenaStack arenaStack;
+    std::vector<std::vector<unsigned char> >& stack = arenaStack.stack;
     CScript scriptPubKey;
 
     if (witversion == 0)
@@ -1488,7 +1660,8 @@ static bool VerifyWitnessProgram(const CScriptWitness &witness, int witversion,
                 return set_error(serror, SCRIPT_ERR_WITNESS_PROGRAM_WITNESS_EMPTY);
             }
             scriptPubKey = CScript(witness.stack.back().begin(), witness.stack.back().end());
-            stack = std::vector<std::vector<unsigned char> >(witness.stack.begin(), witness.stack.end() - 1);
+            for (auto it = witness.stack.begin(); it != witness.stack.end() - 1; ++it)
+                pushstack(stack, *it);
             uint256 hashScriptPubKey;
             CSHA256().Write(&scriptPubKey[0], scriptPubKey.size()).Finalize(hashScriptPubKey.begin());
             if (memcmp(hashScriptPubKey.begin(), program.data(), 32))
@@ -1504,7 +1677,8 @@ static bool VerifyWitnessProgram(const CScriptWitness &witness, int witversion,
                 return set_error(serror, SCRIPT_ERR_WITNESS_PROGRAM_MISMATCH); // 2 items in witness
             }
             scriptPubKey << OP_DUP << OP_HASH160 << program << OP_EQUALVERIFY << OP_CHECKSIG;
-            stack = witness.stack;
+            for (const valtype& vch : witness.stack)
+                pushstack(stack, vch);
         }
         else
         {
@@ -1542,7 +1716,7 @@ static bool VerifyWitnessProgram(const CScriptWitness &witness, int witversion,
 }
 
 
-bool VerifyScript(const CScript &scriptSig, const CScript &scriptPubKey, const CScriptWitness *witness, unsigned int flags, const BaseSignatureChecker &checker, ScriptError *serror)
+bool VerifyScriptInterpreted(const CScript &scriptSig, const CScript &scriptPubKey, const CScriptWitness *witness, unsigned int flags, const BaseSignatureChecker &checker, ScriptError *serror)
 {
     static const CScriptWitness emptyWitness;
     if (witness == nullptr)
@@ -1558,12 +1732,16 @@ bool VerifyScript(const CScript &scriptSig, const CScript &scriptPubKey, const C
         return set_error(serror, SCRIPT_ERR_SIG_PUSHONLY);
     }
 
-    std::vector<std::vector<unsigned char> > stack, stackCopy;
+    CArenaStack arenaStack, arenaStackCopy;
+    std::vector<std::vector<unsigned char> >& stack = arenaStack.stack;
+    std::vector<std::vector<unsigned char> >& stackCopy = arenaStackCopy.stack;
     if (!EvalScript(stack, scriptSig, flags, checker, SIGVERSION_BASE, serror))
         // serror is set
         return false;
-    if (flags & SCRIPT_VERIFY_P2SH)
-        stackCopy = stack;
+    if (flags & SCRIPT_VERIFY_P2SH) {
+        for (const valtype& vch : stack)
+            pushstack(stackCopy, vch);
+    }
     if (!EvalScript(stack, scriptPubKey, flags, checker, SIGVERSION_BASE, serror))
     {
         // mney - changed from if(serror). This code wasn't in Bitcoin. It caused a spewing of script error
@@ -1681,6 +1859,175 @@ bool VerifyScript(const CScript &scriptSig, const CScript &scriptPubKey, const C
     return set_success(serror);
 }
 
+namespace
+{
+
+/**
+ * The data pushes of a push-only script, as EvalScript leaves them on the
+ * stack. False if the script holds anything else, or more than nMaxPushes,
+ * or a push EvalScript would reject.
+ */
+bool GetScriptPushes(const CScript& script, unsigned int flags, size_t nMaxPushes, std::vector<valtype>& vPushes)
+{
+    if (script.size() > MAX_SCRIPT_SIZE)
+        return false;
+    CScript::const_iterator pc = script.begin();
+    opcodetype opcode;
+    CArenaElement element;
+    valtype& vch = element.vch;
+    while (pc < script.end()) {
+        if (vPushes.size() == nMaxPushes)
+            return false;
+        if (!script.GetOp(pc, opcode, vch) || opcode > OP_PUSHDATA4 || vch.size() > MAX_SCRIPT_ELEMENT_SIZE)
+            return false;
+        if ((flags & SCRIPT_VERIFY_MINIMALDATA) && !CheckMinimalPush(vch, opcode))
+            return false;
+        pushstack(vPushes, vch);
+    }
+    return true;
+}
+
+/** Whether script is P2PKH, on its own or followed by OP_RVN_ASSET and asset data */
+bool IsFastPayToPubKeyHash(const CScript& script)
+{
+    if (script.size() < 25 || script.size() > MAX_SCRIPT_SIZE)
+        return false;
+    if (script[0] != OP_DUP || script[1] != OP_HASH160 || script[2] != 20 || script[23] != OP_EQUALVERIFY || script[24] != OP_CHECKSIG)
+        return false;
+    if (script.size() == 25)
+        return true;
+
+    // GetOp reads everything after OP_RVN_ASSET as its data, which EvalScript
+    // skips once the signature has been checked
+    return script[25] == OP_RVN_ASSET && script.size() - 26 <= MAX_SCRIPT_ELEMENT_SIZE;
+}
+
+/** OP_CHECKSIG over scriptCode, when it pushes true */
+bool FastCheckSig(const valtype& vchSig, const valtype& vchPubKey, const CScript& scriptCode, unsigned int flags, const BaseSignatureChecker& checker)
+{
+    if (!CheckSignatureEncoding(vchSig, flags, nullptr) || !CheckPubKeyEncoding(vchPubKey, flags, SIGVERSION_BASE, nullptr))
+        return false;
+    CScript scriptCodeNoSig(scriptCode);
+    scriptCodeNoSig.FindAndDelete(CScript(vchSig));
+    return checker.CheckSig(vchSig, vchPubKey, scriptCodeNoSig, SIGVERSION_BASE);
+}
+
+/** <sig> <pubkey> against P2PKH */
+bool VerifyFastPayToPubKeyHash(const std::vector<valtype>& vPushes, const CScript& scriptPubKey, unsigned int flags, const BaseSignatureChecker& checker)
+{
+    if (vPushes.size() != 2)
+        return false;
+    const valtype& vchSig = vPushes[0];
+    const valtype& vchPubKey = vPushes[1];
+
+    // OP_DUP OP_HASH160 <hash> OP_EQUALVERIFY
+    unsigned char hash[20];
+    CHash160().Write(vchPubKey.data(), vchPubKey.size()).Finalize(hash);
+    if (memcmp(hash, &scriptPubKey[3], sizeof(hash)) != 0)
+        return false;
+
+    // OP_CHECKSIG; the script code has no OP_CODESEPARATOR to start after
+    return FastCheckSig(vchSig, vchPubKey, scriptPubKey, flags, checker);
+}
+
+/** OP_0 <sig>... <redeemScript> against P2SH, with an m-of-n OP_CHECKMULTISIG redeem script */
+bool VerifyFastScriptHashMultisig(const std::vector<valtype>& vPushes, const CScript& scriptPubKey, unsigned int flags, const BaseSignatureChecker& checker)
+{
+    if (!(flags & SCRIPT_VERIFY_P2SH) || vPushes.size() < 3 || !vPushes[0].empty())
+        return false;
+
+    // OP_HASH160 <hash> OP_EQUAL
+    const valtype& vchRedeemScript = vPushes.back();
+    unsigned char hash[20];
+    CHash160().Write(vchRedeemScript.data(), vchRedeemScript.size()).Finalize(hash);
+    if (memcmp(hash, &scriptPubKey[2], sizeof(hash)) != 0)
+        return false;
+
+    // OP_m <pubkey>... OP_n OP_CHECKMULTISIG
+    const CScript redeemScript(vchRedeemScript.begin(), vchRedeemScript.end());
+    CScript::const_iterator pc = redeemScript.begin();
+    opcodetype opcode;
+    CArenaElement element;
+    valtype& vch = element.vch;
+    if (!redeemScript.GetOp(pc, opcode) || opcode < OP_1 || opcode > OP_16)
+        return false;
+    const int nSigs = CScript::DecodeOP_N(opcode);
+    CArenaStack arenaPubKeys;
+    std::vector<valtype>& vPubKeys = arenaPubKeys.stack;
+    while (true) {
+        if (!redeemScript.GetOp(pc, opcode, vch))
+            return false;
+        if (opcode > OP_PUSHDATA4)
+            break;
+        if (vch.size() > MAX_SCRIPT_ELEMENT_SIZE || ((flags & SCRIPT_VERIFY_MINIMALDATA) && !CheckMinimalPush(vch, opcode)))
+            return false;
+        pushstack(vPubKeys, vch);
+    }
+    if (opcode < OP_1 || opcode > OP_16 || CScript::DecodeOP_N(opcode) != (int)vPubKeys.size() || nSigs > (int)vPubKeys.size())
+        return false;
+    if (!redeemScript.GetOp(pc, opcode) || opcode != OP_CHECKMULTISIG || pc != redeemScript.end())
+        return false;
+
+    // Exactly the dummy and one signature per required key, so the stack ends up clean
+    if ((int)vPushes.size() != nSigs + 2)
+        return false;
+    int witnessversion;
+    valtype witnessprogram;
+    if ((flags & SCRIPT_VERIFY_WITNESS) && redeemScript.IsWitnessProgram(witnessversion, witnessprogram))
+        return false;
+
+    CScript scriptCode(redeemScript);
+    for (int i = 1; i <= nSigs; i++)
+        scriptCode.FindAndDelete(CScript(vPushes[i]));
+
+    // Signatures and keys are matched from the last ones down, as OP_CHECKMULTISIG does
+    int iSig = nSigs;
+    int iKey = vPubKeys.size() - 1;
+    while (iSig > 0) {
+        if (iSig > iKey + 1)
+            return false;
+        const valtype& vchSig = vPushes[iSig];
+        const valtype& vchPubKey = vPubKeys[iKey];
+        if (!CheckSignatureEncoding(vchSig, flags, nullptr) || !CheckPubKeyEncoding(vchPubKey, flags, SIGVERSION_BASE, nullptr))
+            return false;
+        if (checker.CheckSig(vchSig, vchPubKey, scriptCode, SIGVERSION_BASE))
+            iSig--;
+        iKey--;
+    }
+    return true;
+}
+
+} // namespace
+
+bool VerifyStandardScript(const CScript& scriptSig, const CScript& scriptPubKey, const CScriptWitness* witness, unsigned int flags, const BaseSignatureChecker& checker)
+{
+    if (witness && !witness->IsNull())
+        return false;
+    if ((flags & SCRIPT_VERIFY_CLEANSTACK) != 0) {
+        assert((flags & SCRIPT_VERIFY_P2SH) != 0);
+        assert((flags & SCRIPT_VERIFY_WITNESS) != 0);
+    }
+
+    CArenaStack arenaPushes;
+    std::vector<valtype>& vPushes = arenaPushes.stack;
+    if (IsFastPayToPubKeyHash(scriptPubKey)) {
+        return GetScriptPushes(scriptSig, flags, 2, vPushes) && VerifyFastPayToPubKeyHash(vPushes, scriptPubKey, flags, checker);
+    }
+    if (scriptPubKey.IsPayToScriptHash()) {
+        return GetScriptPushes(scriptSig, flags, MAX_PUBKEYS_PER_MULTISIG + 2, vPushes) && VerifyFastScriptHashMultisig(vPushes, scriptPubKey, flags, checker);
+    }
+    return false;
+}
+
+bool VerifyScript(const CScript &scriptSig, const CScript &scriptPubKey, const CScriptWitness *witness, unsigned int flags, const BaseSignatureChecker &checker, ScriptError *serror)
+{
+    // Everything the fast path doesn't accept, failures included, is evaluated
+    // in full, so results and errors are the interpreter's
+    if (VerifyStandardScript(scriptSig, scriptPubKey, witness, flags, checker))
+        return set_success(serror);
+    return VerifyScriptInterpreted(scriptSig, scriptPubKey, witness, flags, checker, serror);
+}
+
 size_t static WitnessSigOps(int witversion, const std::vector<unsigned char> &witprogram, const CScriptWitness &witness, int flags)
 {
     if (witversion == 0)
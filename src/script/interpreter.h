@@ -9,6 +9,7 @@
 
 #include "script_error.h"
 #include "primitives/transaction.h"
+#include "crypto/sha256.h"
 
 #include <vector>
 #include <stdint.h>
@@ -119,7 +120,22 @@ struct PrecomputedTransactionData
     uint256 hashPrevouts, hashSequence, hashOutputs;
     bool ready = false;
 
+    /**
+     * Legacy SIGHASH_ALL hashing shared by every input of a transaction. Each
+     * input's hash starts from vLegacyPrefix[nIn], the SHA256 state after the
+     * version, the input count and the blanked inputs before it, and ends with
+     * the part of vchLegacySuffix after the blanked input nIn: the remaining
+     * blanked inputs, the outputs and nLockTime.
+     */
+    std::vector<CSHA256> vLegacyPrefix;
+    std::vector<unsigned char> vchLegacySuffix;
+    bool legacyReady = false;
+
+    PrecomputedTransactionData() {}
     explicit PrecomputedTransactionData(const CTransaction &tx);
+
+    //! Fill in the hashes for tx, so block validation can do it on any thread
+    void Init(const CTransaction &tx);
 };
 
 enum SigVersion
@@ -187,6 +203,18 @@ bool EvalScript(std::vector<std::vector<unsigned char> > &stack, const CScript &
 
 bool VerifyScript(const CScript &scriptSig, const CScript &scriptPubKey, const CScriptWitness *witness, unsigned int flags, const BaseSignatureChecker &checker, ScriptError *serror = nullptr);
 
+/**
+ * Check the script pairs that make up nearly all inputs, P2PKH (asset
+ * outputs included) and P2SH multisig, without running the interpreter.
+ * True only where VerifyScript succeeds; false when the pair is not one of
+ * them or might fail, and has to be evaluated in full. VerifyScript tries
+ * this first.
+ */
+bool VerifyStandardScript(const CScript &scriptSig, const CScript &scriptPubKey, const CScriptWitness *witness, unsigned int flags, const BaseSignatureChecker &checker);
+
+/** VerifyScript without the standard script fast path, for comparing the two */
+bool VerifyScriptInterpreted(const CScript &scriptSig, const CScript &scriptPubKey, const CScriptWitness *witness, unsigned int flags, const BaseSignatureChecker &checker, ScriptError *serror = nullptr);
+
 size_t CountWitnessSigOps(const CScript &scriptSig, const CScript &scriptPubKey, const CScriptWitness *witness, unsigned int flags);
 
 #endif // MYNTA_SCRIPT_INTERPRETER_H
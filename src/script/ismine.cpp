@@ -64,6 +64,7 @@ isminetype IsMine(const CKeyStore &keystore, const CScript& scriptPubKey, bool&
         case TX_NULL_DATA:
             break;
         case TX_RESTRICTED_ASSET_DATA:
+        case TX_HTLC:
             break;
         case TX_PUBKEY:
             keyID = CPubKey(vSolutions[0]).GetID();
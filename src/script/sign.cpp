@@ -353,6 +353,7 @@ static Stacks CombineSignatures(const CScript& scriptPubKey, const BaseSignature
             return sigs1;
         return sigs2;
     case TX_RESTRICTED_ASSET_DATA:
+    case TX_HTLC:
         // Don't know anything about this, assume bigger one is correct:
         if (sigs1.script.size() >= sigs2.script.size())
             return sigs1;
@@ -32,6 +32,7 @@ const char* GetTxnOutputType(txnouttype t)
     case TX_MULTISIG: return "multisig";
     case TX_NULL_DATA: return "nulldata";
     case TX_RESTRICTED_ASSET_DATA: return "nullassetdata";
+    case TX_HTLC: return "htlc";
     case TX_WITNESS_V0_KEYHASH: return "witness_v0_keyhash";
     case TX_WITNESS_V0_SCRIPTHASH: return "witness_v0_scripthash";
 
@@ -44,6 +45,47 @@ const char* GetTxnOutputType(txnouttype t)
     return nullptr;
 }
 
+/**
+ * Byte-for-byte match of the HTLC redeem script with P2PKH parties:
+ *
+ *   OP_IF OP_SHA256 <32 byte hash lock> OP_EQUALVERIFY
+ *       OP_DUP OP_HASH160 <receiver key hash> OP_EQUALVERIFY OP_CHECKSIG
+ *   OP_ELSE <lock height> OP_CHECKLOCKTIMEVERIFY OP_DROP
+ *       OP_DUP OP_HASH160 <sender key hash> OP_EQUALVERIFY OP_CHECKSIG
+ *   OP_ENDIF
+ *
+ * Every field but the height has a fixed size and position, so this is a
+ * handful of compares instead of an opcode walk. Solutions are the hash lock,
+ * the receiver key hash, the height as pushed (a CScriptNum) and the sender
+ * key hash.
+ */
+static bool MatchHTLC(const CScript& script, std::vector<valtype>& vSolutionsRet)
+{
+    static const unsigned char PREFIX_SIZE = 62;
+    static const unsigned char SUFFIX_SIZE = 28;
+    if (script.size() < PREFIX_SIZE + 1 + SUFFIX_SIZE || script.size() > PREFIX_SIZE + 6 + SUFFIX_SIZE)
+        return false;
+    if (script[0] != OP_IF || script[1] != OP_SHA256 || script[2] != 32 || script[35] != OP_EQUALVERIFY ||
+        script[36] != OP_DUP || script[37] != OP_HASH160 || script[38] != 20 || script[59] != OP_EQUALVERIFY ||
+        script[60] != OP_CHECKSIG || script[61] != OP_ELSE)
+        return false;
+
+    // The height is pushed as 0 to 5 bytes of CScriptNum
+    unsigned int nHeightSize = script[PREFIX_SIZE];
+    if (nHeightSize > 5 || script.size() != PREFIX_SIZE + 1 + nHeightSize + SUFFIX_SIZE)
+        return false;
+    const unsigned char* suffix = script.data() + PREFIX_SIZE + 1 + nHeightSize;
+    if (suffix[0] != OP_CHECKLOCKTIMEVERIFY || suffix[1] != OP_DROP || suffix[2] != OP_DUP || suffix[3] != OP_HASH160 ||
+        suffix[4] != 20 || suffix[25] != OP_EQUALVERIFY || suffix[26] != OP_CHECKSIG || suffix[27] != OP_ENDIF)
+        return false;
+
+    vSolutionsRet.emplace_back(script.begin() + 3, script.begin() + 35);
+    vSolutionsRet.emplace_back(script.begin() + 39, script.begin() + 59);
+    vSolutionsRet.emplace_back(script.begin() + PREFIX_SIZE + 1, script.begin() + PREFIX_SIZE + 1 + nHeightSize);
+    vSolutionsRet.emplace_back(suffix + 5, suffix + 25);
+    return true;
+}
+
 bool Solver(const CScript& scriptPubKey, txnouttype& typeRet, std::vector<std::vector<unsigned char> >& vSolutionsRet)
 {
     // Templates
@@ -122,6 +164,11 @@ bool Solver(const CScript& scriptPubKey, txnouttype& typeRet, std::vector<std::v
         return true;
     }
 
+    if (MatchHTLC(scriptPubKey, vSolutionsRet)) {
+        typeRet = TX_HTLC;
+        return true;
+    }
+
     // Scan templates
     const CScript& script1 = scriptPubKey;
     for (const std::pair<txnouttype, CScript>& tplate : mTemplates)
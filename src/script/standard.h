@@ -71,6 +71,7 @@ enum txnouttype
     TX_TRANSFER_ASSET = 10,
     TX_RESTRICTED_ASSET_DATA = 11, //!< unspendable OP_RAVEN_ASSET script that carries data
     /** RVN END */
+    TX_HTLC = 12, //!< atomic swap redeem script from HTLCScript::CreateHTLCScript, only standard behind P2SH
 };
 
 class CNoDestination {
@@ -0,0 +1,268 @@
+// Copyright (c) 2026 The Mynta Core Developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include "sockevents.h"
+
+#include "netbase.h"
+#include "util.h"
+#include "utiltime.h"
+
+#include <algorithm>
+#include <map>
+
+#if defined(__linux__)
+#include <sys/epoll.h>
+#include <unistd.h>
+#define USE_EPOLL 1
+#elif defined(__APPLE__) || defined(__FreeBSD__) || defined(__OpenBSD__) || defined(__DragonFly__)
+#include <sys/types.h>
+#include <sys/event.h>
+#include <sys/time.h>
+#include <unistd.h>
+#define USE_KQUEUE 1
+#endif
+
+namespace {
+/** Most events taken from the kernel per wait; the rest are returned by the next one */
+const int MAX_EVENTS_PER_WAIT = 256;
+
+/** Portable fallback that rebuilds fd_sets from the registrations on every wait */
+class CSocketEventsSelect : public CSocketEvents
+{
+    struct Entry {
+        SOCKET hSocket;
+        int nInterest;
+    };
+    std::map<uint64_t, Entry> mapSockets;
+
+public:
+    const char* GetName() const override { return "select"; }
+    bool IsFdSetLimited() const override { return true; }
+
+    bool Add(SOCKET hSocket, uint64_t nTag, int nFlags, bool fEdgeTriggered) override
+    {
+        if (!IsSelectableSocket(hSocket))
+            return false;
+        mapSockets[nTag] = Entry{hSocket, nFlags};
+        return true;
+    }
+
+    void Remove(uint64_t nTag) override
+    {
+        mapSockets.erase(nTag);
+    }
+
+    void SetInterest(uint64_t nTag, int nFlags) override
+    {
+        auto it = mapSockets.find(nTag);
+        if (it != mapSockets.end())
+            it->second.nInterest = nFlags;
+    }
+
+    bool Wait(int64_t nTimeoutMs, std::vector<Event>& vEvents) override
+    {
+        fd_set fdsetRecv;
+        fd_set fdsetSend;
+        fd_set fdsetError;
+        FD_ZERO(&fdsetRecv);
+        FD_ZERO(&fdsetSend);
+        FD_ZERO(&fdsetError);
+        SOCKET hSocketMax = 0;
+
+        for (const auto& item : mapSockets) {
+            const Entry& entry = item.second;
+            // Errors are always watched for, like the old select loop did
+            FD_SET(entry.hSocket, &fdsetError);
+            if (entry.nInterest & SOCKET_EVENT_RECV)
+                FD_SET(entry.hSocket, &fdsetRecv);
+            if (entry.nInterest & SOCKET_EVENT_SEND)
+                FD_SET(entry.hSocket, &fdsetSend);
+            hSocketMax = std::max(hSocketMax, entry.hSocket);
+        }
+
+        if (mapSockets.empty()) {
+            // Windows select() fails without any sockets to wait on
+            MilliSleep(nTimeoutMs);
+            return true;
+        }
+
+        struct timeval timeout;
+        timeout.tv_sec = nTimeoutMs / 1000;
+        timeout.tv_usec = (nTimeoutMs % 1000) * 1000;
+        int nSelect = select(hSocketMax + 1, &fdsetRecv, &fdsetSend, &fdsetError, &timeout);
+        if (nSelect == SOCKET_ERROR)
+            return false;
+
+        for (const auto& item : mapSockets) {
+            const Entry& entry = item.second;
+            int nFlags = 0;
+            if (FD_ISSET(entry.hSocket, &fdsetRecv))
+                nFlags |= SOCKET_EVENT_RECV;
+            if (FD_ISSET(entry.hSocket, &fdsetSend))
+                nFlags |= SOCKET_EVENT_SEND;
+            if (FD_ISSET(entry.hSocket, &fdsetError))
+                nFlags |= SOCKET_EVENT_ERROR;
+            if (nFlags)
+                vEvents.push_back(Event{item.first, nFlags});
+        }
+        return true;
+    }
+};
+
+#ifdef USE_EPOLL
+class CSocketEventsEpoll : public CSocketEvents
+{
+    int fdEpoll;
+
+public:
+    CSocketEventsEpoll() : fdEpoll(epoll_create1(EPOLL_CLOEXEC)) {}
+    ~CSocketEventsEpoll() override
+    {
+        if (fdEpoll >= 0)
+            close(fdEpoll);
+    }
+
+    bool IsValid() const { return fdEpoll >= 0; }
+
+    const char* GetName() const override { return "epoll"; }
+
+    bool Add(SOCKET hSocket, uint64_t nTag, int nFlags, bool fEdgeTriggered) override
+    {
+        struct epoll_event ev = {};
+        ev.events = EPOLLRDHUP;
+        if (nFlags & SOCKET_EVENT_RECV)
+            ev.events |= EPOLLIN;
+        if (nFlags & SOCKET_EVENT_SEND)
+            ev.events |= EPOLLOUT;
+        if (fEdgeTriggered)
+            ev.events |= EPOLLET;
+        ev.data.u64 = nTag;
+        if (epoll_ctl(fdEpoll, EPOLL_CTL_ADD, hSocket, &ev) != 0) {
+            LogPrintf("CSocketEventsEpoll::%s -- epoll_ctl failed: %s\n", __func__, NetworkErrorString(errno));
+            return false;
+        }
+        return true;
+    }
+
+    void Remove(uint64_t nTag) override {}
+
+    bool Wait(int64_t nTimeoutMs, std::vector<Event>& vEvents) override
+    {
+        struct epoll_event events[MAX_EVENTS_PER_WAIT];
+        int nEvents = epoll_wait(fdEpoll, events, MAX_EVENTS_PER_WAIT, nTimeoutMs);
+        if (nEvents < 0)
+            return errno == EINTR;
+
+        for (int i = 0; i < nEvents; i++) {
+            int nFlags = 0;
+            if (events[i].events & EPOLLIN)
+                nFlags |= SOCKET_EVENT_RECV;
+            if (events[i].events & EPOLLOUT)
+                nFlags |= SOCKET_EVENT_SEND;
+            if (events[i].events & (EPOLLERR | EPOLLHUP | EPOLLRDHUP))
+                nFlags |= SOCKET_EVENT_ERROR;
+            vEvents.push_back(Event{events[i].data.u64, nFlags});
+        }
+        return true;
+    }
+};
+#endif // USE_EPOLL
+
+#ifdef USE_KQUEUE
+class CSocketEventsKqueue : public CSocketEvents
+{
+    int fdKqueue;
+
+public:
+    CSocketEventsKqueue() : fdKqueue(kqueue()) {}
+    ~CSocketEventsKqueue() override
+    {
+        if (fdKqueue >= 0)
+            close(fdKqueue);
+    }
+
+    bool IsValid() const { return fdKqueue >= 0; }
+
+    const char* GetName() const override { return "kqueue"; }
+
+    bool Add(SOCKET hSocket, uint64_t nTag, int nFlags, bool fEdgeTriggered) override
+    {
+        struct kevent changes[2];
+        int nChanges = 0;
+        unsigned short nAction = EV_ADD | (fEdgeTriggered ? EV_CLEAR : 0);
+        void* udata = reinterpret_cast<void*>(static_cast<uintptr_t>(nTag));
+        if (nFlags & SOCKET_EVENT_RECV)
+            EV_SET(&changes[nChanges++], hSocket, EVFILT_READ, nAction, 0, 0, udata);
+        if (nFlags & SOCKET_EVENT_SEND)
+            EV_SET(&changes[nChanges++], hSocket, EVFILT_WRITE, nAction, 0, 0, udata);
+        if (kevent(fdKqueue, changes, nChanges, nullptr, 0, nullptr) != 0) {
+            LogPrintf("CSocketEventsKqueue::%s -- kevent failed: %s\n", __func__, NetworkErrorString(errno));
+            return false;
+        }
+        return true;
+    }
+
+    void Remove(uint64_t nTag) override {}
+
+    bool Wait(int64_t nTimeoutMs, std::vector<Event>& vEvents) override
+    {
+        struct kevent events[MAX_EVENTS_PER_WAIT];
+        struct timespec timeout;
+        timeout.tv_sec = nTimeoutMs / 1000;
+        timeout.tv_nsec = (nTimeoutMs % 1000) * 1000000;
+        int nEvents = kevent(fdKqueue, nullptr, 0, events, MAX_EVENTS_PER_WAIT, &timeout);
+        if (nEvents < 0)
+            return errno == EINTR;
+
+        // A socket's read and write filters come back as separate events
+        for (int i = 0; i < nEvents; i++) {
+            int nFlags = events[i].filter == EVFILT_WRITE ? SOCKET_EVENT_SEND : SOCKET_EVENT_RECV;
+            if (events[i].flags & (EV_EOF | EV_ERROR))
+                nFlags |= SOCKET_EVENT_ERROR;
+            vEvents.push_back(Event{static_cast<uint64_t>(reinterpret_cast<uintptr_t>(events[i].udata)), nFlags});
+        }
+        return true;
+    }
+};
+#endif // USE_KQUEUE
+} // namespace
+
+std::unique_ptr<CSocketEvents> CreateSocketEvents(const std::string& strName)
+{
+#ifdef USE_EPOLL
+    if (strName == "epoll") {
+        std::unique_ptr<CSocketEventsEpoll> events(new CSocketEventsEpoll());
+        if (!events->IsValid()) {
+            LogPrintf("%s: epoll_create1 failed: %s\n", __func__, NetworkErrorString(errno));
+            return nullptr;
+        }
+        return std::move(events);
+    }
+#endif
+#ifdef USE_KQUEUE
+    if (strName == "kqueue") {
+        std::unique_ptr<CSocketEventsKqueue> events(new CSocketEventsKqueue());
+        if (!events->IsValid()) {
+            LogPrintf("%s: kqueue failed: %s\n", __func__, NetworkErrorString(errno));
+            return nullptr;
+        }
+        return std::move(events);
+    }
+#endif
+    if (strName == "select")
+        return std::unique_ptr<CSocketEvents>(new CSocketEventsSelect());
+    return nullptr;
+}
+
+std::string GetSocketEventsBackends()
+{
+    std::string strBackends;
+#ifdef USE_EPOLL
+    strBackends += "epoll, ";
+#endif
+#ifdef USE_KQUEUE
+    strBackends += "kqueue, ";
+#endif
+    return strBackends + "select";
+}
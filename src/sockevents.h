@@ -0,0 +1,77 @@
+// Copyright (c) 2026 The Mynta Core Developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#ifndef MYNTA_SOCKEVENTS_H
+#define MYNTA_SOCKEVENTS_H
+
+#include "compat.h"
+
+#include <memory>
+#include <stdint.h>
+#include <string>
+#include <vector>
+
+/** Readiness reported by, and interest given to, a CSocketEvents backend */
+enum SocketEventFlags {
+    SOCKET_EVENT_RECV = 1,
+    SOCKET_EVENT_SEND = 2,
+    SOCKET_EVENT_ERROR = 4,
+};
+
+/** Default for -socketevents: the best backend this platform has */
+#if defined(__linux__)
+static const char* const DEFAULT_SOCKETEVENTS = "epoll";
+#elif defined(__APPLE__) || defined(__FreeBSD__) || defined(__OpenBSD__) || defined(__DragonFly__)
+static const char* const DEFAULT_SOCKETEVENTS = "kqueue";
+#else
+static const char* const DEFAULT_SOCKETEVENTS = "select";
+#endif
+
+/**
+ * Socket readiness notification for CConnman::ThreadSocketHandler.
+ *
+ * Sockets are registered once and stay registered until their tag is
+ * removed, so a wait costs nothing per idle socket on the kernel backends.
+ * An edge triggered registration reports a socket when it becomes readable
+ * or writable, not for as long as it is; the caller must remember the
+ * readiness until a recv or send comes back short. Level triggered
+ * registrations (used for listening sockets) report it on every wait.
+ *
+ * All methods are called from the socket handler thread only.
+ */
+class CSocketEvents
+{
+public:
+    struct Event {
+        uint64_t nTag;
+        int nFlags;
+    };
+
+    virtual ~CSocketEvents() {}
+
+    virtual const char* GetName() const = 0;
+
+    //! Whether sockets must be below FD_SETSIZE to be watched
+    virtual bool IsFdSetLimited() const { return false; }
+
+    //! Start watching hSocket for nFlags, reporting it as nTag; tags must fit in a pointer
+    virtual bool Add(SOCKET hSocket, uint64_t nTag, int nFlags, bool fEdgeTriggered) = 0;
+
+    //! Stop watching nTag. Closing a socket already unregisters it from the kernel backends.
+    virtual void Remove(uint64_t nTag) = 0;
+
+    //! Narrow what a backend that can't do edge triggering waits for; edge triggered backends ignore this
+    virtual void SetInterest(uint64_t nTag, int nFlags) {}
+
+    //! Wait up to nTimeoutMs for readiness and append it to vEvents; returns false on a wait error
+    virtual bool Wait(int64_t nTimeoutMs, std::vector<Event>& vEvents) = 0;
+};
+
+//! The backend named strName ("epoll", "kqueue" or "select"), or nullptr if it isn't available here
+std::unique_ptr<CSocketEvents> CreateSocketEvents(const std::string& strName);
+
+//! Comma separated names of the backends this build supports, for the -socketevents help
+std::string GetSocketEventsBackends();
+
+#endif // MYNTA_SOCKEVENTS_H
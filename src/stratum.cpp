@@ -0,0 +1,567 @@
+// Copyright (c) 2026 The Mynta Core Developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include "stratum.h"
+
+#include "chain.h"
+#include "chainparams.h"
+#include "hash.h"
+#include "netbase.h"
+#include "primitives/block.h"
+#include "rpc/mining.h"
+#include "txmempool.h"
+#include "util.h"
+#include "utilstrencodings.h"
+#include "utiltime.h"
+#include "validation.h"
+#include "validationinterface.h"
+
+#include <crypto/ethash/helpers.hpp>
+#include <univalue.h>
+
+#include <deque>
+#include <functional>
+#include <map>
+#include <memory>
+#include <set>
+#include <thread>
+
+#include <event2/buffer.h>
+#include <event2/bufferevent.h>
+#include <event2/event.h>
+#include <event2/listener.h>
+#include <event2/thread.h>
+#include <event2/util.h>
+
+/** Stratum error codes, as pools report them */
+enum StratumError {
+    STRATUM_OTHER = 20,
+    STRATUM_JOB_NOT_FOUND = 21,
+    STRATUM_DUPLICATE_SHARE = 22,
+    STRATUM_LOW_DIFFICULTY = 23,
+    STRATUM_UNAUTHORIZED = 24,
+    STRATUM_NOT_SUBSCRIBED = 25,
+};
+
+arith_uint256 GetStratumShareTarget(const arith_uint256& powLimit, uint64_t nDifficulty, const arith_uint256& blockTarget)
+{
+    arith_uint256 target = powLimit;
+    if (nDifficulty > 1)
+        target /= nDifficulty;
+    return target < blockTarget ? blockTarget : target;
+}
+
+static std::string StripHexPrefix(const std::string& str)
+{
+    if (str.size() >= 2 && str[0] == '0' && (str[1] == 'x' || str[1] == 'X'))
+        return str.substr(2);
+    return str;
+}
+
+bool ParseStratumNonce(const std::string& str, uint64_t& nNonce)
+{
+    const std::string strHex = StripHexPrefix(str);
+    if (strHex.empty() || strHex.size() > 16 || !IsHex(strHex))
+        return false;
+    return ParseUInt64(strHex, &nNonce, 16);
+}
+
+bool ParseStratumHash(const std::string& str, uint256& hash)
+{
+    const std::string strHex = StripHexPrefix(str);
+    if (strHex.size() != 64 || !IsHex(strHex))
+        return false;
+    hash = uint256S(strHex);
+    return true;
+}
+
+namespace {
+
+/** A template handed out to miners; the header hash is what they search on */
+struct CStratumJob
+{
+    std::string strId;
+    std::shared_ptr<const CBlock> pblock;
+    uint256 hashHeader;
+    arith_uint256 blockTarget;
+    arith_uint256 shareTarget;
+    //! Nonces already submitted, so a share counts once
+    std::set<uint64_t> setNonces;
+};
+
+struct CStratumClient
+{
+    struct bufferevent* bev{nullptr};
+    CService addr;
+    bool fSubscribed{false};
+    bool fAuthorized{false};
+    std::string strExtraNonce;
+    std::string strWorker;
+};
+
+/**
+ * Everything but Start, Interrupt and Stop runs on the server's own event
+ * loop thread, so clients and jobs need no lock. Jobs are rebuilt from the
+ * template cache when the tip changes, which UpdatedBlockTip signals right
+ * away, and for new mempool transactions at most every
+ * STRATUM_JOB_REFRESH_SECONDS, which a timer checks every second.
+ */
+class CStratumServer final : public CValidationInterface
+{
+private:
+    struct event_base* base{nullptr};
+    struct evconnlistener* listener{nullptr};
+    struct event* jobEvent{nullptr};
+    std::thread thread;
+
+    std::vector<CSubNet> vAllowed;
+    arith_uint256 powLimit;
+    uint64_t nDifficulty{DEFAULT_STRATUM_DIFFICULTY};
+
+    std::map<struct bufferevent*, std::unique_ptr<CStratumClient>> mapClients;
+    std::deque<std::shared_ptr<CStratumJob>> jobs;
+    uint64_t nJobCounter{0};
+    uint16_t nNextExtraNonce{0};
+    uint256 hashJobPrev;
+    unsigned int nJobTransactionsUpdated{0};
+    int64_t nJobTime{0};
+
+    static void AcceptCallback(struct evconnlistener* listener, evutil_socket_t fd, struct sockaddr* addr, int socklen, void* ctx);
+    static void ReadCallback(struct bufferevent* bev, void* ctx);
+    static void EventCallback(struct bufferevent* bev, short what, void* ctx);
+    static void JobCallback(evutil_socket_t fd, short what, void* ctx);
+
+    bool ClientAllowed(const CNetAddr& addr) const;
+    void Disconnect(struct bufferevent* bev);
+    void Send(CStratumClient& client, const UniValue& msg);
+    void Reply(CStratumClient& client, const UniValue& id, const UniValue& result, int nError = 0, const std::string& strError = "");
+    void Notify(CStratumClient& client, const CStratumJob& job, bool fClean);
+    void HandleRequest(CStratumClient& client, const std::string& strLine);
+    void HandleSubmit(CStratumClient& client, const UniValue& id, const UniValue& params);
+    void UpdateJob();
+
+protected:
+    void UpdatedBlockTip(const CBlockIndex* pindexNew, const CBlockIndex* pindexFork, bool fInitialDownload) override;
+
+public:
+    ~CStratumServer();
+
+    bool Start();
+    void Interrupt();
+    void Stop();
+};
+
+} // namespace
+
+static std::unique_ptr<CStratumServer> g_stratum;
+
+CStratumServer::~CStratumServer()
+{
+    Stop();
+}
+
+bool CStratumServer::ClientAllowed(const CNetAddr& addr) const
+{
+    if (!addr.IsValid())
+        return false;
+    for (const CSubNet& subnet : vAllowed) {
+        if (subnet.Match(addr))
+            return true;
+    }
+    return false;
+}
+
+bool CStratumServer::Start()
+{
+    CNetAddr localv4;
+    CNetAddr localv6;
+    LookupHost("127.0.0.1", localv4, false);
+    LookupHost("::1", localv6, false);
+    vAllowed.push_back(CSubNet(localv4, 8));
+    vAllowed.push_back(CSubNet(localv6));
+    for (const std::string& strAllow : gArgs.GetArgs("-stratumallowip")) {
+        CSubNet subnet;
+        LookupSubNet(strAllow.c_str(), subnet);
+        if (!subnet.IsValid()) {
+            LogPrintf("stratum: Invalid -stratumallowip subnet specification: %s\n", strAllow);
+            return false;
+        }
+        vAllowed.push_back(subnet);
+    }
+
+    powLimit = UintToArith256(GetParams().GetConsensus().kawpowLimit);
+    nDifficulty = std::max<int64_t>(1, gArgs.GetArg("-stratumdifficulty", DEFAULT_STRATUM_DIFFICULTY));
+
+    const int nPort = gArgs.GetArg("-stratumport", DEFAULT_STRATUM_PORT);
+    CService bind;
+    if (!Lookup(gArgs.GetArg("-stratumbind", "127.0.0.1").c_str(), bind, nPort, false)) {
+        LogPrintf("stratum: Invalid -stratumbind address\n");
+        return false;
+    }
+    struct sockaddr_storage sockaddr;
+    socklen_t len = sizeof(sockaddr);
+    if (!bind.GetSockAddr((struct sockaddr*)&sockaddr, &len)) {
+        LogPrintf("stratum: Can't bind to %s\n", bind.ToString());
+        return false;
+    }
+
+#ifdef WIN32
+    evthread_use_windows_threads();
+#else
+    evthread_use_pthreads();
+#endif
+    base = event_base_new();
+    if (!base) {
+        LogPrintf("stratum: Unable to create event_base\n");
+        return false;
+    }
+    listener = evconnlistener_new_bind(base, AcceptCallback, this, LEV_OPT_CLOSE_ON_FREE | LEV_OPT_REUSEABLE, -1, (struct sockaddr*)&sockaddr, len);
+    if (!listener) {
+        LogPrintf("stratum: Unable to listen on %s\n", bind.ToString());
+        return false;
+    }
+    jobEvent = event_new(base, -1, EV_PERSIST, JobCallback, this);
+    struct timeval tv = {1, 0};
+    event_add(jobEvent, &tv);
+
+    RegisterValidationInterface(this);
+    thread = std::thread(&TraceThread<std::function<void()> >, "stratum",
+                         std::function<void()>([this] { event_base_dispatch(base); }));
+    LogPrintf("stratum: Listening on %s, share difficulty %u\n", bind.ToString(), nDifficulty);
+    return true;
+}
+
+void CStratumServer::Interrupt()
+{
+    if (base)
+        event_base_loopbreak(base);
+}
+
+void CStratumServer::Stop()
+{
+    if (!base)
+        return;
+    UnregisterValidationInterface(this);
+    event_base_loopbreak(base);
+    if (thread.joinable())
+        thread.join();
+    for (auto& client : mapClients)
+        bufferevent_free(client.first);
+    mapClients.clear();
+    jobs.clear();
+    if (jobEvent)
+        event_free(jobEvent);
+    jobEvent = nullptr;
+    if (listener)
+        evconnlistener_free(listener);
+    listener = nullptr;
+    event_base_free(base);
+    base = nullptr;
+}
+
+void CStratumServer::UpdatedBlockTip(const CBlockIndex* pindexNew, const CBlockIndex* pindexFork, bool fInitialDownload)
+{
+    if (!fInitialDownload && jobEvent)
+        event_active(jobEvent, EV_TIMEOUT, 0);
+}
+
+void CStratumServer::AcceptCallback(struct evconnlistener* listener, evutil_socket_t fd, struct sockaddr* addr, int socklen, void* ctx)
+{
+    CStratumServer* self = (CStratumServer*)ctx;
+    CService service;
+    service.SetSockAddr(addr);
+    if (!self->ClientAllowed(service) || (int)self->mapClients.size() >= MAX_STRATUM_CLIENTS) {
+        LogPrint(BCLog::STRATUM, "stratum: Refused connection from %s\n", service.ToString());
+        evutil_closesocket(fd);
+        return;
+    }
+
+    struct bufferevent* bev = bufferevent_socket_new(self->base, fd, BEV_OPT_CLOSE_ON_FREE);
+    if (!bev) {
+        evutil_closesocket(fd);
+        return;
+    }
+    auto client = std::make_unique<CStratumClient>();
+    client->bev = bev;
+    client->addr = service;
+    client->strExtraNonce = strprintf("%04x", self->nNextExtraNonce++);
+    self->mapClients.emplace(bev, std::move(client));
+    bufferevent_setcb(bev, ReadCallback, nullptr, EventCallback, self);
+    bufferevent_enable(bev, EV_READ | EV_WRITE);
+    LogPrint(BCLog::STRATUM, "stratum: Connection from %s\n", service.ToString());
+}
+
+void CStratumServer::ReadCallback(struct bufferevent* bev, void* ctx)
+{
+    CStratumServer* self = (CStratumServer*)ctx;
+    auto it = self->mapClients.find(bev);
+    if (it == self->mapClients.end())
+        return;
+    CStratumClient& client = *it->second;
+
+    struct evbuffer* input = bufferevent_get_input(bev);
+    size_t nRead = 0;
+    char* line;
+    while ((line = evbuffer_readln(input, &nRead, EVBUFFER_EOL_ANY)) != nullptr) {
+        std::string strLine(line, nRead);
+        free(line);
+        if (!strLine.empty())
+            self->HandleRequest(client, strLine);
+    }
+    // What is left is an incomplete line
+    if (evbuffer_get_length(input) > MAX_STRATUM_LINE_LENGTH) {
+        LogPrint(BCLog::STRATUM, "stratum: Disconnecting %s, line too long\n", client.addr.ToString());
+        self->Disconnect(bev);
+    }
+}
+
+void CStratumServer::EventCallback(struct bufferevent* bev, short what, void* ctx)
+{
+    CStratumServer* self = (CStratumServer*)ctx;
+    if (what & (BEV_EVENT_EOF | BEV_EVENT_ERROR))
+        self->Disconnect(bev);
+}
+
+void CStratumServer::JobCallback(evutil_socket_t fd, short what, void* ctx)
+{
+    ((CStratumServer*)ctx)->UpdateJob();
+}
+
+void CStratumServer::Disconnect(struct bufferevent* bev)
+{
+    auto it = mapClients.find(bev);
+    if (it == mapClients.end())
+        return;
+    LogPrint(BCLog::STRATUM, "stratum: %s disconnected\n", it->second->addr.ToString());
+    mapClients.erase(it);
+    bufferevent_free(bev);
+}
+
+void CStratumServer::Send(CStratumClient& client, const UniValue& msg)
+{
+    const std::string str = msg.write() + "\n";
+    evbuffer_add(bufferevent_get_output(client.bev), str.data(), str.size());
+}
+
+void CStratumServer::Reply(CStratumClient& client, const UniValue& id, const UniValue& result, int nError, const std::string& strError)
+{
+    UniValue reply(UniValue::VOBJ);
+    reply.pushKV("id", id);
+    if (nError) {
+        UniValue error(UniValue::VARR);
+        error.push_back(nError);
+        error.push_back(strError);
+        error.push_back(NullUniValue);
+        reply.pushKV("result", NullUniValue);
+        reply.pushKV("error", error);
+    } else {
+        reply.pushKV("result", result);
+        reply.pushKV("error", NullUniValue);
+    }
+    Send(client, reply);
+}
+
+void CStratumServer::Notify(CStratumClient& client, const CStratumJob& job, bool fClean)
+{
+    const int nHeight = job.pblock->nHeight;
+    UniValue params(UniValue::VARR);
+    params.push_back(job.strId);
+    params.push_back(job.hashHeader.GetHex());
+    params.push_back(to_hex(ethash::calculate_epoch_seed(ethash::get_epoch_number(nHeight))));
+    params.push_back(job.shareTarget.GetHex());
+    params.push_back(fClean);
+    params.push_back(nHeight);
+    params.push_back(strprintf("%08x", job.pblock->nBits));
+
+    UniValue notify(UniValue::VOBJ);
+    notify.pushKV("id", NullUniValue);
+    notify.pushKV("method", "mining.notify");
+    notify.pushKV("params", params);
+    Send(client, notify);
+}
+
+void CStratumServer::HandleRequest(CStratumClient& client, const std::string& strLine)
+{
+    UniValue request;
+    if (!request.read(strLine) || !request.isObject()) {
+        LogPrint(BCLog::STRATUM, "stratum: Malformed request from %s\n", client.addr.ToString());
+        return;
+    }
+    const UniValue& id = find_value(request, "id");
+    const UniValue& method = find_value(request, "method");
+    const UniValue& params = find_value(request, "params");
+    if (!method.isStr()) {
+        Reply(client, id, NullUniValue, STRATUM_OTHER, "Missing method");
+        return;
+    }
+    const std::string& strMethod = method.get_str();
+
+    if (strMethod == "mining.subscribe") {
+        client.fSubscribed = true;
+        UniValue result(UniValue::VARR);
+        result.push_back(NullUniValue);
+        result.push_back(client.strExtraNonce);
+        Reply(client, id, result);
+        if (!jobs.empty()) {
+            UniValue target(UniValue::VARR);
+            target.push_back(jobs.back()->shareTarget.GetHex());
+            UniValue setTarget(UniValue::VOBJ);
+            setTarget.pushKV("id", NullUniValue);
+            setTarget.pushKV("method", "mining.set_target");
+            setTarget.pushKV("params", target);
+            Send(client, setTarget);
+            Notify(client, *jobs.back(), true);
+        }
+    } else if (strMethod == "mining.authorize") {
+        client.fAuthorized = true;
+        if (params.isArray() && params.size() > 0 && params[0].isStr())
+            client.strWorker = params[0].get_str();
+        Reply(client, id, true);
+    } else if (strMethod == "mining.extranonce.subscribe") {
+        Reply(client, id, false);
+    } else if (strMethod == "mining.submit") {
+        if (!client.fSubscribed) {
+            Reply(client, id, NullUniValue, STRATUM_NOT_SUBSCRIBED, "Not subscribed");
+        } else if (!client.fAuthorized) {
+            Reply(client, id, NullUniValue, STRATUM_UNAUTHORIZED, "Unauthorized worker");
+        } else if (!params.isArray()) {
+            Reply(client, id, NullUniValue, STRATUM_OTHER, "Invalid parameters");
+        } else {
+            HandleSubmit(client, id, params);
+        }
+    } else {
+        Reply(client, id, NullUniValue, STRATUM_OTHER, "Unsupported method");
+    }
+}
+
+void CStratumServer::HandleSubmit(CStratumClient& client, const UniValue& id, const UniValue& params)
+{
+    // [worker, job id, nonce, header hash, mix hash]
+    uint64_t nNonce;
+    uint256 hashHeader;
+    uint256 hashMix;
+    if (params.size() < 5 || !params[1].isStr() || !params[2].isStr() || !params[3].isStr() || !params[4].isStr() ||
+        !ParseStratumNonce(params[2].get_str(), nNonce) || !ParseStratumHash(params[3].get_str(), hashHeader) ||
+        !ParseStratumHash(params[4].get_str(), hashMix)) {
+        Reply(client, id, NullUniValue, STRATUM_OTHER, "Invalid parameters");
+        return;
+    }
+
+    std::shared_ptr<CStratumJob> job;
+    for (const std::shared_ptr<CStratumJob>& candidate : jobs) {
+        if (candidate->strId == params[1].get_str())
+            job = candidate;
+    }
+    if (!job || job->hashHeader != hashHeader) {
+        Reply(client, id, NullUniValue, STRATUM_JOB_NOT_FOUND, "Job not found");
+        return;
+    }
+    if (!job->setNonces.insert(nNonce).second) {
+        Reply(client, id, NullUniValue, STRATUM_DUPLICATE_SHARE, "Duplicate share");
+        return;
+    }
+
+    // The full hash with the resident epoch context; the miner's mix hash has to match it
+    CBlockHeader header = *job->pblock;
+    header.nNonce64 = nNonce;
+    uint256 hashMixResult;
+    const arith_uint256 hash = UintToArith256(KAWPOWHash(header, hashMixResult));
+    if (hashMixResult != hashMix) {
+        LogPrint(BCLog::STRATUM, "stratum: Share from %s has a wrong mix hash\n", client.addr.ToString());
+        Reply(client, id, NullUniValue, STRATUM_OTHER, "Invalid mix hash");
+        return;
+    }
+    if (hash > job->shareTarget) {
+        Reply(client, id, NullUniValue, STRATUM_LOW_DIFFICULTY, "Low difficulty share");
+        return;
+    }
+    LogPrint(BCLog::STRATUM, "stratum: Share from %s (%s) for job %s\n", client.strWorker, client.addr.ToString(), job->strId);
+
+    if (hash <= job->blockTarget) {
+        auto pblock = std::make_shared<CBlock>(*job->pblock);
+        pblock->nNonce64 = nNonce;
+        pblock->mix_hash = hashMix;
+        const std::string strResult = SubmitMinedBlock(pblock);
+        if (strResult.empty()) {
+            LogPrintf("stratum: Block %s found by %s at height %d\n", pblock->GetHash().ToString(), client.strWorker, pblock->nHeight);
+        } else {
+            LogPrintf("stratum: Block %s found by %s was not accepted: %s\n", pblock->GetHash().ToString(), client.strWorker, strResult);
+            Reply(client, id, NullUniValue, STRATUM_OTHER, strResult);
+            return;
+        }
+    }
+    Reply(client, id, true);
+}
+
+void CStratumServer::UpdateJob()
+{
+    if (IsInitialBlockDownload())
+        return;
+
+    uint256 hashTip;
+    {
+        LOCK(cs_main);
+        hashTip = chainActive.Tip()->GetBlockHash();
+    }
+    const unsigned int nTransactionsUpdated = mempool.GetTransactionsUpdated();
+    const bool fNewTip = hashTip != hashJobPrev;
+    if (!fNewTip && (nTransactionsUpdated == nJobTransactionsUpdated || GetTime() - nJobTime < STRATUM_JOB_REFRESH_SECONDS))
+        return;
+
+    auto pblock = std::make_shared<CBlock>();
+    std::string strError;
+    if (!GetBlockTemplateForMining(*pblock, strError)) {
+        LogPrint(BCLog::STRATUM, "stratum: No block template: %s\n", strError);
+        return;
+    }
+    if (pblock->nTime < nKAWPOWActivationTime)
+        return;
+
+    auto job = std::make_shared<CStratumJob>();
+    job->strId = strprintf("%x", ++nJobCounter);
+    job->pblock = pblock;
+    job->hashHeader = pblock->GetKAWPOWHeaderHash();
+    job->blockTarget.SetCompact(pblock->nBits);
+    job->shareTarget = GetStratumShareTarget(powLimit, nDifficulty, job->blockTarget);
+
+    // Shares for the previous tip can't make a block any more
+    const bool fClean = pblock->hashPrevBlock != hashJobPrev;
+    if (fClean)
+        jobs.clear();
+    jobs.push_back(job);
+    while (jobs.size() > MAX_STRATUM_JOBS)
+        jobs.pop_front();
+    hashJobPrev = pblock->hashPrevBlock;
+    nJobTransactionsUpdated = nTransactionsUpdated;
+    nJobTime = GetTime();
+
+    for (auto& client : mapClients) {
+        if (client.second->fSubscribed)
+            Notify(*client.second, *job, fClean);
+    }
+    LogPrint(BCLog::STRATUM, "stratum: Job %s at height %d for %u clients\n", job->strId, pblock->nHeight, mapClients.size());
+}
+
+bool StartStratumServer()
+{
+    if (!gArgs.GetBoolArg("-stratum", DEFAULT_STRATUM))
+        return true;
+    g_stratum = std::make_unique<CStratumServer>();
+    if (!g_stratum->Start()) {
+        g_stratum.reset();
+        return false;
+    }
+    return true;
+}
+
+void InterruptStratumServer()
+{
+    if (g_stratum)
+        g_stratum->Interrupt();
+}
+
+void StopStratumServer()
+{
+    g_stratum.reset();
+}
@@ -0,0 +1,45 @@
+// Copyright (c) 2026 The Mynta Core Developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+/**
+ * A stratum endpoint for KAWPOW miners and pool front ends, serving jobs
+ * from the getblocktemplate template and submitting found blocks directly.
+ */
+#ifndef MYNTA_STRATUM_H
+#define MYNTA_STRATUM_H
+
+#include "arith_uint256.h"
+#include "uint256.h"
+
+#include <stdint.h>
+#include <string>
+
+static const bool DEFAULT_STRATUM = false;
+static const unsigned short DEFAULT_STRATUM_PORT = 3333;
+/** Default for -stratumdifficulty, the share target being kawpowLimit divided by it */
+static const uint64_t DEFAULT_STRATUM_DIFFICULTY = 1;
+/** Replace the job for new mempool transactions at most this often */
+static const int64_t STRATUM_JOB_REFRESH_SECONDS = 30;
+/** Jobs of the current tip shares are accepted for */
+static const size_t MAX_STRATUM_JOBS = 16;
+static const int MAX_STRATUM_CLIENTS = 128;
+/** Longest request line; clients sending more are disconnected */
+static const size_t MAX_STRATUM_LINE_LENGTH = 16384;
+
+/**
+ * The target shares have to meet: kawpowLimit divided by the difficulty,
+ * but never below the block target, so every block found is submitted.
+ */
+arith_uint256 GetStratumShareTarget(const arith_uint256& powLimit, uint64_t nDifficulty, const arith_uint256& blockTarget);
+
+/** Parse a nonce or hash as miners send it, hex with or without a 0x prefix */
+bool ParseStratumNonce(const std::string& str, uint64_t& nNonce);
+bool ParseStratumHash(const std::string& str, uint256& hash);
+
+/** Listen for stratum clients if -stratum is set; false if that fails */
+bool StartStratumServer();
+void InterruptStratumServer();
+void StopStratumServer();
+
+#endif // MYNTA_STRATUM_H
@@ -139,6 +139,139 @@ private:
     size_t nPos;
 };
 
+/* Minimal stream for reading from an existing byte range without copying it
+ *
+ * The range is not owned and must outlive the reader. Reading past its end
+ * throws std::ios_base::failure, like the other streams do.
+ */
+class CSpanReader
+{
+ public:
+
+/*
+ * @param[in]  nTypeIn Serialization Type
+ * @param[in]  nVersionIn Serialization Version (including any flags)
+ * @param[in]  data  Start of the byte range to read
+ * @param[in]  size  Number of bytes in the range
+*/
+    CSpanReader(int nTypeIn, int nVersionIn, const unsigned char* data, size_t size) : nType(nTypeIn), nVersion(nVersionIn), pos(data), pEnd(data + size) {}
+
+    void read(char* pch, size_t nSize)
+    {
+        if (nSize > this->size()) {
+            throw std::ios_base::failure("CSpanReader::read(): end of data");
+        }
+        memcpy(pch, pos, nSize);
+        pos += nSize;
+    }
+    void ignore(size_t nSize)
+    {
+        if (nSize > this->size()) {
+            throw std::ios_base::failure("CSpanReader::ignore(): end of data");
+        }
+        pos += nSize;
+    }
+    //! Only here so SerializationOps that branch on ser_action.ForRead() at runtime compile
+    void write(const char* pch, size_t nSize)
+    {
+        throw std::ios_base::failure("CSpanReader::write(): read-only stream");
+    }
+    template<typename T>
+    CSpanReader& operator>>(T& obj)
+    {
+        // Unserialize from this stream
+        ::Unserialize(*this, obj);
+        return (*this);
+    }
+    int GetVersion() const
+    {
+        return nVersion;
+    }
+    int GetType() const
+    {
+        return nType;
+    }
+    //! Next byte to be read
+    const unsigned char* data() const { return pos; }
+    //! Number of bytes left to read
+    size_t size() const { return pEnd - pos; }
+    bool empty() const { return pos == pEnd; }
+private:
+    const int nType;
+    const int nVersion;
+    const unsigned char* pos;
+    const unsigned char* const pEnd;
+};
+
+/* CSpanReader over bytes stored XORed with a repeating key, as CDataStream::Xor
+ * leaves them, undoing the XOR on the bytes as they are read instead of on a copy
+ * of the whole range.
+ *
+ * Neither the range nor the key is owned; both must outlive the reader.
+ */
+class CXorSpanReader
+{
+ public:
+    CXorSpanReader(int nTypeIn, int nVersionIn, const unsigned char* data, size_t size, const std::vector<unsigned char>& keyIn)
+        : nType(nTypeIn), nVersion(nVersionIn), pos(data), pEnd(data + size), key(keyIn) {}
+
+    void read(char* pch, size_t nSize)
+    {
+        if (nSize > this->size()) {
+            throw std::ios_base::failure("CXorSpanReader::read(): end of data");
+        }
+        memcpy(pch, pos, nSize);
+        pos += nSize;
+        if (key.empty()) {
+            return;
+        }
+        for (size_t i = 0; i != nSize; i++) {
+            pch[i] ^= key[nKeyPos++];
+            if (nKeyPos == key.size())
+                nKeyPos = 0;
+        }
+    }
+    void ignore(size_t nSize)
+    {
+        if (nSize > this->size()) {
+            throw std::ios_base::failure("CXorSpanReader::ignore(): end of data");
+        }
+        pos += nSize;
+        if (!key.empty())
+            nKeyPos = (nKeyPos + nSize) % key.size();
+    }
+    void write(const char* pch, size_t nSize)
+    {
+        throw std::ios_base::failure("CXorSpanReader::write(): read-only stream");
+    }
+    template<typename T>
+    CXorSpanReader& operator>>(T& obj)
+    {
+        // Unserialize from this stream
+        ::Unserialize(*this, obj);
+        return (*this);
+    }
+    int GetVersion() const
+    {
+        return nVersion;
+    }
+    int GetType() const
+    {
+        return nType;
+    }
+    //! Number of bytes left to read
+    size_t size() const { return pEnd - pos; }
+    bool empty() const { return pos == pEnd; }
+private:
+    const int nType;
+    const int nVersion;
+    const unsigned char* pos;
+    const unsigned char* const pEnd;
+    const std::vector<unsigned char>& key;
+    //! Index in key of the byte the next one read was XORed with
+    size_t nKeyPos{0};
+};
+
 /** Double ended buffer combining vector and stream-like interfaces.
  *
  * >> and << read and write unformatted data using the above serialization templates.
@@ -414,6 +547,12 @@ public:
         clear();
     }
 
+    //! Exchange the underlying buffer with d and rewind, keeping both allocations
+    void SwapBuffer(CSerializeData &d) {
+        vch.swap(d);
+        nReadPos = 0;
+    }
+
     /**
      * XOR the contents of this stream with a certain key.
      *
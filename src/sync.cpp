@@ -12,6 +12,51 @@
 
 #include <boost/thread.hpp>
 
+static std::atomic<CLockSite*> plockSites{nullptr};
+
+CLockSite::CLockSite(const char* pszNameIn, const char* pszFileIn, int nLineIn)
+    : pszName(pszNameIn), pszFile(pszFileIn), nLine(nLineIn), pnext(plockSites.load())
+{
+    // Sites are only ever pushed onto the front, so readers never see one half linked
+    while (!plockSites.compare_exchange_weak(pnext, this)) {}
+}
+
+static void AtomicMax(std::atomic<int64_t>& nMax, int64_t n)
+{
+    int64_t nCurrent = nMax.load(std::memory_order_relaxed);
+    while (n > nCurrent && !nMax.compare_exchange_weak(nCurrent, n, std::memory_order_relaxed)) {}
+}
+
+void CLockSite::AddWait(int64_t nMicros)
+{
+    nContentions.fetch_add(1, std::memory_order_relaxed);
+    nWaitMicros.fetch_add(nMicros, std::memory_order_relaxed);
+    AtomicMax(nMaxWaitMicros, nMicros);
+}
+
+void CLockSite::AddHold(int64_t nMicros)
+{
+    nHolds.fetch_add(1, std::memory_order_relaxed);
+    nHoldMicros.fetch_add(nMicros, std::memory_order_relaxed);
+    AtomicMax(nMaxHoldMicros, nMicros);
+}
+
+void CLockSite::Reset()
+{
+    nAcquisitions = 0;
+    nContentions = 0;
+    nWaitMicros = 0;
+    nMaxWaitMicros = 0;
+    nHolds = 0;
+    nHoldMicros = 0;
+    nMaxHoldMicros = 0;
+}
+
+CLockSite* GetLockSites()
+{
+    return plockSites.load();
+}
+
 #ifdef DEBUG_LOCKCONTENTION
 void PrintLockContention(const char* pszName, const char* pszFile, int nLine)
 {
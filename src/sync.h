@@ -9,6 +9,10 @@
 
 #include "threadsafety.h"
 
+#include <atomic>
+#include <chrono>
+#include <stdint.h>
+
 #include <boost/thread/condition_variable.hpp>
 #include <boost/thread/mutex.hpp>
 #include <boost/thread/recursive_mutex.hpp>
@@ -85,16 +89,99 @@ void static inline DeleteLock(void* cs) {}
 #endif
 #define AssertLockHeld(cs) AssertLockHeldInternal(#cs, __FILE__, __LINE__, &cs)
 
+/**
+ * Contention accounting for one LOCK, TRY_LOCK or LOCK2 in the source: how
+ * often it took its lock, how long it waited for it when another thread had
+ * it, and how long it kept it when it was the outermost lock of that mutex.
+ * Each is made the first time its LOCK runs and linked into a list that
+ * getlockstats walks.
+ */
+struct CLockSite
+{
+    const char* const pszName;
+    const char* const pszFile;
+    const int nLine;
+    CLockSite* pnext;
+
+    std::atomic<uint64_t> nAcquisitions{0};
+    std::atomic<uint64_t> nContentions{0};
+    std::atomic<int64_t> nWaitMicros{0};
+    std::atomic<int64_t> nMaxWaitMicros{0};
+    std::atomic<uint64_t> nHolds{0};
+    std::atomic<int64_t> nHoldMicros{0};
+    std::atomic<int64_t> nMaxHoldMicros{0};
+
+    CLockSite(const char* pszNameIn, const char* pszFileIn, int nLineIn);
+    void AddWait(int64_t nMicros);
+    void AddHold(int64_t nMicros);
+    void Reset();
+};
+
+/** The most recently made lock site; the others follow through pnext */
+CLockSite* GetLockSites();
+
+/** Monotonic clock lock waits and holds are measured with */
+static inline int64_t LockStatsMicros()
+{
+    return std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
 /**
  * Wrapped boost mutex: supports recursive locking, but no waiting
  * TODO: We should move away from using the recursive lock by default.
  */
 class CCriticalSection : public AnnotatedMixin<boost::recursive_mutex>
 {
+private:
+    // Only touched by the thread holding the lock
+    int nLockDepth{0};
+    int64_t nHoldStart{0};
+    CLockSite* pHoldSite{nullptr};
+
+    void Acquired()
+    {
+        if (nLockDepth++ == 0) {
+            nHoldStart = LockStatsMicros();
+            pHoldSite = nullptr;
+        }
+    }
+
 public:
     ~CCriticalSection() {
         DeleteLock((void*)this);
     }
+
+    void lock() EXCLUSIVE_LOCK_FUNCTION()
+    {
+        AnnotatedMixin::lock();
+        Acquired();
+    }
+    void unlock() UNLOCK_FUNCTION()
+    {
+        CLockSite* psite = nullptr;
+        int64_t nHeld = 0;
+        if (--nLockDepth == 0 && pHoldSite) {
+            psite = pHoldSite;
+            nHeld = LockStatsMicros() - nHoldStart;
+        }
+        AnnotatedMixin::unlock();
+        if (psite)
+            psite->AddHold(nHeld);
+    }
+    bool try_lock() EXCLUSIVE_TRYLOCK_FUNCTION(true)
+    {
+        if (!AnnotatedMixin::try_lock())
+            return false;
+        Acquired();
+        return true;
+    }
+
+    /** Charge the time until the lock is released to psite, if this is its outermost acquisition */
+    void SetHoldSite(CLockSite* psite)
+    {
+        if (nLockDepth == 1 && !pHoldSite)
+            pHoldSite = psite;
+    }
 };
 
 /** Wrapped boost mutex: supports waiting but not recursive locking */
@@ -114,46 +201,58 @@ class SCOPED_LOCKABLE CMutexLock
 private:
     boost::unique_lock<Mutex> lock;
 
-    void Enter(const char* pszName, const char* pszFile, int nLine)
+    void Acquired(CLockSite* psite)
+    {
+        if (!psite)
+            return;
+        psite->nAcquisitions.fetch_add(1, std::memory_order_relaxed);
+        lock.mutex()->SetHoldSite(psite);
+    }
+
+    void Enter(const char* pszName, const char* pszFile, int nLine, CLockSite* psite)
     {
         EnterCritical(pszName, pszFile, nLine, (void*)(lock.mutex()));
-#ifdef DEBUG_LOCKCONTENTION
         if (!lock.try_lock()) {
+#ifdef DEBUG_LOCKCONTENTION
             PrintLockContention(pszName, pszFile, nLine);
 #endif
+            int64_t nWaitStart = LockStatsMicros();
             lock.lock();
-#ifdef DEBUG_LOCKCONTENTION
+            if (psite)
+                psite->AddWait(LockStatsMicros() - nWaitStart);
         }
-#endif
+        Acquired(psite);
     }
 
-    bool TryEnter(const char* pszName, const char* pszFile, int nLine)
+    bool TryEnter(const char* pszName, const char* pszFile, int nLine, CLockSite* psite)
     {
         EnterCritical(pszName, pszFile, nLine, (void*)(lock.mutex()), true);
         lock.try_lock();
         if (!lock.owns_lock())
             LeaveCritical();
+        else
+            Acquired(psite);
         return lock.owns_lock();
     }
 
 public:
-    CMutexLock(Mutex& mutexIn, const char* pszName, const char* pszFile, int nLine, bool fTry = false) EXCLUSIVE_LOCK_FUNCTION(mutexIn) : lock(mutexIn, boost::defer_lock)
+    CMutexLock(Mutex& mutexIn, const char* pszName, const char* pszFile, int nLine, bool fTry = false, CLockSite* psite = nullptr) EXCLUSIVE_LOCK_FUNCTION(mutexIn) : lock(mutexIn, boost::defer_lock)
     {
         if (fTry)
-            TryEnter(pszName, pszFile, nLine);
+            TryEnter(pszName, pszFile, nLine, psite);
         else
-            Enter(pszName, pszFile, nLine);
+            Enter(pszName, pszFile, nLine, psite);
     }
 
-    CMutexLock(Mutex* pmutexIn, const char* pszName, const char* pszFile, int nLine, bool fTry = false) EXCLUSIVE_LOCK_FUNCTION(pmutexIn)
+    CMutexLock(Mutex* pmutexIn, const char* pszName, const char* pszFile, int nLine, bool fTry = false, CLockSite* psite = nullptr) EXCLUSIVE_LOCK_FUNCTION(pmutexIn)
     {
         if (!pmutexIn) return;
 
         lock = boost::unique_lock<Mutex>(*pmutexIn, boost::defer_lock);
         if (fTry)
-            TryEnter(pszName, pszFile, nLine);
+            TryEnter(pszName, pszFile, nLine, psite);
         else
-            Enter(pszName, pszFile, nLine);
+            Enter(pszName, pszFile, nLine, psite);
     }
 
     ~CMutexLock() UNLOCK_FUNCTION()
@@ -173,9 +272,12 @@ typedef CMutexLock<CCriticalSection> CCriticalBlock;
 #define PASTE(x, y) x ## y
 #define PASTE2(x, y) PASTE(x, y)
 
-#define LOCK(cs) CCriticalBlock PASTE2(criticalblock, __COUNTER__)(cs, #cs, __FILE__, __LINE__)
-#define LOCK2(cs1, cs2) CCriticalBlock criticalblock1(cs1, #cs1, __FILE__, __LINE__), criticalblock2(cs2, #cs2, __FILE__, __LINE__)
-#define TRY_LOCK(cs, name) CCriticalBlock name(cs, #cs, __FILE__, __LINE__, true)
+// The lambda gives every expansion a static CLockSite of its own
+#define LOCK_SITE(cs) ([]() -> CLockSite* { static CLockSite site(#cs, __FILE__, __LINE__); return &site; }())
+
+#define LOCK(cs) CCriticalBlock PASTE2(criticalblock, __COUNTER__)(cs, #cs, __FILE__, __LINE__, false, LOCK_SITE(cs))
+#define LOCK2(cs1, cs2) CCriticalBlock criticalblock1(cs1, #cs1, __FILE__, __LINE__, false, LOCK_SITE(cs1)), criticalblock2(cs2, #cs2, __FILE__, __LINE__, false, LOCK_SITE(cs2))
+#define TRY_LOCK(cs, name) CCriticalBlock name(cs, #cs, __FILE__, __LINE__, true, LOCK_SITE(cs))
 
 #define ENTER_CRITICAL_SECTION(cs)                            \
     {                                                         \
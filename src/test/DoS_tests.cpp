@@ -26,13 +26,14 @@ extern bool AddOrphanTx(const CTransactionRef &tx, NodeId peer);
 
 extern void EraseOrphansFor(NodeId peer);
 
-extern unsigned int LimitOrphanTxSize(unsigned int nMaxOrphans);
+extern unsigned int LimitOrphanTxSize(unsigned int nMaxOrphans, size_t nMaxUsage);
 
 struct COrphanTx
 {
     CTransactionRef tx;
     NodeId fromPeer;
     int64_t nTimeExpire;
+    size_t nUsage;
 };
 extern std::map<uint256, COrphanTx> mapOrphanTransactions;
 
@@ -274,11 +275,51 @@ BOOST_FIXTURE_TEST_SUITE(DoS_tests, TestingSetup)
         }
 
         // Test LimitOrphanTxSize() function:
-        LimitOrphanTxSize(40);
+        LimitOrphanTxSize(40, std::numeric_limits<size_t>::max());
         BOOST_CHECK(mapOrphanTransactions.size() <= 40);
-        LimitOrphanTxSize(10);
+        LimitOrphanTxSize(10, std::numeric_limits<size_t>::max());
         BOOST_CHECK(mapOrphanTransactions.size() <= 10);
-        LimitOrphanTxSize(0);
+        LimitOrphanTxSize(0, std::numeric_limits<size_t>::max());
+        BOOST_CHECK(mapOrphanTransactions.empty());
+    }
+
+    BOOST_AUTO_TEST_CASE(DoS_maporphans_memory_test)
+    {
+        BOOST_TEST_MESSAGE("Running DoS MapOrphans Memory Test");
+
+        // Peer 0 floods the pool, peer 1 sends two orphans
+        size_t nUsage = 0;
+        for (int i = 0; i < 22; i++)
+        {
+            CMutableTransaction tx;
+            tx.vin.resize(1);
+            tx.vin[0].prevout.n = 0;
+            tx.vin[0].prevout.hash = InsecureRand256();
+            tx.vin[0].scriptSig << OP_1;
+            tx.vout.resize(1);
+            tx.vout[0].nValue = 1 * CENT;
+            tx.vout[0].scriptPubKey = CScript() << OP_TRUE;
+
+            CTransactionRef ptx = MakeTransactionRef(tx);
+            BOOST_CHECK(AddOrphanTx(ptx, i < 20 ? 0 : 1));
+            nUsage += RecursiveDynamicUsage(ptx);
+        }
+
+        // Going over the memory budget evicts the flooding peer's orphans only
+        LimitOrphanTxSize(std::numeric_limits<unsigned int>::max(), nUsage / 2);
+        size_t nUsageLeft = 0;
+        int nFromPeer1 = 0;
+        for (const auto& item : mapOrphanTransactions)
+        {
+            nUsageLeft += item.second.nUsage;
+            if (item.second.fromPeer == 1)
+                nFromPeer1++;
+        }
+        BOOST_CHECK(nUsageLeft <= nUsage / 2);
+        BOOST_CHECK_EQUAL(nFromPeer1, 2);
+
+        EraseOrphansFor(0);
+        EraseOrphansFor(1);
         BOOST_CHECK(mapOrphanTransactions.empty());
     }
 
@@ -25,6 +25,14 @@ public:
             //  Set addrman addr placement to be deterministic.
             MakeDeterministic();
         }
+
+        // Read the tables directly so Select follows the deterministic RandomInt
+        nSnapshotMaxAge = -1;
+    }
+
+    void SetSnapshotMaxAge(int64_t nMaxAge)
+    {
+        nSnapshotMaxAge = nMaxAge;
     }
 
     //! Ensure that bucket placement is always the same for testing purposes.
@@ -226,6 +234,86 @@ BOOST_FIXTURE_TEST_SUITE(addrman_tests, BasicTestingSetup)
         BOOST_CHECK_EQUAL(ports.size(), (uint64_t)3);
     }
 
+    BOOST_AUTO_TEST_CASE(addrman_snapshot_test)
+    {
+        BOOST_TEST_MESSAGE("Running Addrman Snapshot Test");
+
+        CAddrManTest addrman;
+        addrman.SetSnapshotMaxAge(ADDRMAN_SNAPSHOT_MAX_AGE);
+        int64_t nStart = GetTime();
+        SetMockTime(nStart);
+
+        CAddrInfo addr_null = addrman.Select();
+        BOOST_CHECK_EQUAL(addr_null.ToString(), "[::]:0");
+        BOOST_CHECK_EQUAL(addrman.GetAddr().size(), (uint64_t)0);
+
+        // Test: an empty snapshot is replaced as soon as there is something to select.
+        CService addr1 = ResolveService("250.1.1.1", 8767);
+        addrman.Add(CAddress(addr1, NODE_NONE), ResolveIP("252.2.2.2"));
+        BOOST_CHECK_EQUAL(addrman.Select(true).ToString(), "250.1.1.1:8767");
+
+        // Test: the snapshot lags behind the tables for at most ADDRMAN_SNAPSHOT_MAX_AGE.
+        addrman.Good(CAddress(addr1, NODE_NONE));
+        BOOST_CHECK_EQUAL(addrman.Select(true).ToString(), "250.1.1.1:8767");
+        SetMockTime(nStart + ADDRMAN_SNAPSHOT_MAX_AGE);
+        BOOST_CHECK_EQUAL(addrman.Select(true).ToString(), "[::]:0");
+        BOOST_CHECK_EQUAL(addrman.Select().ToString(), "250.1.1.1:8767");
+
+        // Test: GetAddr from the snapshot returns 23% of the addresses.
+        for (unsigned int i = 1; i < (8 * 256); i++) {
+            int octet1 = i % 256;
+            int octet2 = i >> 8 % 256;
+            std::string strAddr = boost::to_string(octet1) + "." + boost::to_string(octet2) + ".1.23";
+            CAddress addr = CAddress(ResolveService(strAddr), NODE_NONE);
+            addr.nTime = GetAdjustedTime();
+            addrman.Add(addr, ResolveIP(strAddr));
+        }
+        SetMockTime(nStart + 2 * ADDRMAN_SNAPSHOT_MAX_AGE);
+        BOOST_CHECK_EQUAL(addrman.GetAddr().size(), (addrman.size() * 23) / 100);
+
+        SetMockTime(0);
+    }
+
+    BOOST_AUTO_TEST_CASE(addrman_fixed_layout_test)
+    {
+        BOOST_TEST_MESSAGE("Running Addrman Fixed Layout Test");
+
+        CAddrManTest addrman;
+        CNetAddr source = ResolveIP("252.2.2.2");
+        for (unsigned int i = 1; i < 20; i++) {
+            CAddress addr = CAddress(ResolveService("250.1.1." + boost::to_string(i), 8767), NODE_NETWORK);
+            addrman.Add(addr, source);
+            if (i % 4 == 0)
+                addrman.Good(addr);
+        }
+        BOOST_CHECK(addrman.size() > 0);
+
+        std::vector<unsigned char> vch;
+        addrman.GetCurrentSnapshot()->SerializeFixed(vch);
+        BOOST_CHECK(CAddrMan::IsFixedFormat(vch.data(), vch.size()));
+
+        // Test: loading the encoding gives back the same entries.
+        CAddrManTest addrman2(false);
+        BOOST_CHECK(addrman2.UnserializeFixed(vch.data(), vch.size()));
+        BOOST_CHECK_EQUAL(addrman2.size(), addrman.size());
+        for (unsigned int i = 1; i < 20; i++) {
+            CNetAddr addr = ResolveIP("250.1.1." + boost::to_string(i));
+            CAddrInfo* info = addrman.Find(addr);
+            CAddrInfo* info2 = addrman2.Find(addr);
+            BOOST_CHECK_EQUAL(info == nullptr, info2 == nullptr);
+            if (info && info2) {
+                BOOST_CHECK_EQUAL(info2->ToString(), info->ToString());
+                BOOST_CHECK_EQUAL(info2->nServices, info->nServices);
+                BOOST_CHECK_EQUAL(info2->nTime, info->nTime);
+            }
+        }
+
+        // Test: a truncated encoding is rejected and leaves the tables empty.
+        vch.pop_back();
+        BOOST_CHECK(!addrman2.UnserializeFixed(vch.data(), vch.size()));
+        BOOST_CHECK_EQUAL(addrman2.size(), (uint64_t)0);
+    }
+
     BOOST_AUTO_TEST_CASE(addrman_new_collisions_test)
     {
         BOOST_TEST_MESSAGE("Running Addrman New Collisions Test");
@@ -33,18 +33,18 @@ BOOST_FIXTURE_TEST_SUITE(asset_reissue_tests, BasicTestingSetup)
 
         // Add an asset to a valid rvn address
         uint256 hash = uint256();
-        BOOST_CHECK_MESSAGE(cache.AddNewAsset(asset1, GetParams().GlobalBurnAddress(), 0, hash), "Failed to add new asset");
+        BOOST_CHECK_MESSAGE(cache.AddNewAsset(asset1, CAddressKey::FromString(GetParams().GlobalBurnAddress()), 0, hash), "Failed to add new asset");
 
         // Create a reissuance of the asset
         CReissueAsset reissue1("RVNASSET", CAmount(1 * COIN), 8, 1, DecodeAssetData("QmacSRmrkVmvJfbCpmU6pK72furJ8E8fbKHindrLxmYMQo"));
         COutPoint out(uint256S("BF50CB9A63BE0019171456252989A459A7D0A5F494735278290079D22AB704A4"), 1);
 
         // Add an reissuance of the asset to the cache
-        BOOST_CHECK_MESSAGE(cache.AddReissueAsset(reissue1, GetParams().GlobalBurnAddress(), out), "Failed to add reissue");
+        BOOST_CHECK_MESSAGE(cache.AddReissueAsset(reissue1, CAddressKey::FromString(GetParams().GlobalBurnAddress()), out), "Failed to add reissue");
 
         // Check to see if the reissue changed the cache data correctly
         BOOST_CHECK_MESSAGE(cache.mapReissuedAssetData.count("RVNASSET"), "Map Reissued Asset should contain the asset \"RVNASSET\"");
-        BOOST_CHECK_MESSAGE(cache.mapAssetsAddressAmount.at(make_pair("RVNASSET", GetParams().GlobalBurnAddress())) == CAmount(101 * COIN), "Reissued amount wasn't added to the previous total");
+        BOOST_CHECK_MESSAGE(cache.mapAssetsAddressAmount.at(std::make_pair(std::string("RVNASSET"), CAddressKey::FromString(GetParams().GlobalBurnAddress()))) == CAmount(101 * COIN), "Reissued amount wasn't added to the previous total");
 
         // Get the new asset data from the cache
         CNewAsset asset2;
@@ -60,7 +60,7 @@ BOOST_FIXTURE_TEST_SUITE(asset_reissue_tests, BasicTestingSetup)
         // Remove the reissue from the cache
         std::vector<std::pair<std::string, CBlockAssetUndo> > undoBlockData;
         undoBlockData.emplace_back(std::make_pair("RVNASSET", CBlockAssetUndo{true, false, "", 0, ASSET_UNDO_INCLUDES_VERIFIER_STRING, false, ""}));
-        BOOST_CHECK_MESSAGE(cache.RemoveReissueAsset(reissue1, GetParams().GlobalBurnAddress(), out, undoBlockData), "Failed to remove reissue");
+        BOOST_CHECK_MESSAGE(cache.RemoveReissueAsset(reissue1, CAddressKey::FromString(GetParams().GlobalBurnAddress()), out, undoBlockData), "Failed to remove reissue");
 
         // Get the asset data from the cache now that the reissuance was removed
         CNewAsset asset3;
@@ -75,7 +75,7 @@ BOOST_FIXTURE_TEST_SUITE(asset_reissue_tests, BasicTestingSetup)
 
         // Check to see if the reissue removal updated the cache correctly
         BOOST_CHECK_MESSAGE(cache.mapReissuedAssetData.count("RVNASSET"), "Map of reissued data was removed, even though changes were made and not databased yet");
-        BOOST_CHECK_MESSAGE(cache.mapAssetsAddressAmount.at(make_pair("RVNASSET", GetParams().GlobalBurnAddress())) == CAmount(100 * COIN), "Assets total wasn't undone when reissuance was");
+        BOOST_CHECK_MESSAGE(cache.mapAssetsAddressAmount.at(std::make_pair(std::string("RVNASSET"), CAddressKey::FromString(GetParams().GlobalBurnAddress()))) == CAmount(100 * COIN), "Assets total wasn't undone when reissuance was");
     }
 
     BOOST_AUTO_TEST_CASE(reissue_cache_test_txid)
@@ -93,18 +93,18 @@ BOOST_FIXTURE_TEST_SUITE(asset_reissue_tests, BasicTestingSetup)
 
         // Add an asset to a valid rvn address
         uint256 hash = uint256();
-        BOOST_CHECK_MESSAGE(cache.AddNewAsset(asset1, GetParams().GlobalBurnAddress(), 0, hash), "Failed to add new asset");
+        BOOST_CHECK_MESSAGE(cache.AddNewAsset(asset1, CAddressKey::FromString(GetParams().GlobalBurnAddress()), 0, hash), "Failed to add new asset");
 
         // Create a reissuance of the asset
         CReissueAsset reissue1("RVNASSET", CAmount(1 * COIN), 8, 1, DecodeAssetData("9c2c8e121a0139ba39bffd3ca97267bca9d4c0c1e84ac0c34a883c28e7a912ca"));
         COutPoint out(uint256S("BF50CB9A63BE0019171456252989A459A7D0A5F494735278290079D22AB704A4"), 1);
 
         // Add an reissuance of the asset to the cache
-        BOOST_CHECK_MESSAGE(cache.AddReissueAsset(reissue1, GetParams().GlobalBurnAddress(), out), "Failed to add reissue");
+        BOOST_CHECK_MESSAGE(cache.AddReissueAsset(reissue1, CAddressKey::FromString(GetParams().GlobalBurnAddress()), out), "Failed to add reissue");
 
         // Check to see if the reissue changed the cache data correctly
         BOOST_CHECK_MESSAGE(cache.mapReissuedAssetData.count("RVNASSET"), "Map Reissued Asset should contain the asset \"RVNASSET\"");
-        BOOST_CHECK_MESSAGE(cache.mapAssetsAddressAmount.at(make_pair("RVNASSET", GetParams().GlobalBurnAddress())) == CAmount(101 * COIN), "Reissued amount wasn't added to the previous total");
+        BOOST_CHECK_MESSAGE(cache.mapAssetsAddressAmount.at(std::make_pair(std::string("RVNASSET"), CAddressKey::FromString(GetParams().GlobalBurnAddress()))) == CAmount(101 * COIN), "Reissued amount wasn't added to the previous total");
 
         // Get the new asset data from the cache
         CNewAsset asset2;
@@ -120,7 +120,7 @@ BOOST_FIXTURE_TEST_SUITE(asset_reissue_tests, BasicTestingSetup)
         // Remove the reissue from the cache
         std::vector<std::pair<std::string, CBlockAssetUndo> > undoBlockData;
         undoBlockData.emplace_back(std::make_pair("RVNASSET", CBlockAssetUndo{true, false, "", 0, ASSET_UNDO_INCLUDES_VERIFIER_STRING, false, ""}));
-        BOOST_CHECK_MESSAGE(cache.RemoveReissueAsset(reissue1, GetParams().GlobalBurnAddress(), out, undoBlockData), "Failed to remove reissue");
+        BOOST_CHECK_MESSAGE(cache.RemoveReissueAsset(reissue1, CAddressKey::FromString(GetParams().GlobalBurnAddress()), out, undoBlockData), "Failed to remove reissue");
 
         // Get the asset data from the cache now that the reissuance was removed
         CNewAsset asset3;
@@ -135,7 +135,7 @@ BOOST_FIXTURE_TEST_SUITE(asset_reissue_tests, BasicTestingSetup)
 
         // Check to see if the reissue removal updated the cache correctly
         BOOST_CHECK_MESSAGE(cache.mapReissuedAssetData.count("RVNASSET"), "Map of reissued data was removed, even though changes were made and not databased yet");
-        BOOST_CHECK_MESSAGE(cache.mapAssetsAddressAmount.at(make_pair("RVNASSET", GetParams().GlobalBurnAddress())) == CAmount(100 * COIN), "Assets total wasn't undone when reissuance was");
+        BOOST_CHECK_MESSAGE(cache.mapAssetsAddressAmount.at(std::make_pair(std::string("RVNASSET"), CAddressKey::FromString(GetParams().GlobalBurnAddress()))) == CAmount(100 * COIN), "Assets total wasn't undone when reissuance was");
     }
 
 
@@ -151,7 +151,7 @@ BOOST_FIXTURE_TEST_SUITE(asset_reissue_tests, BasicTestingSetup)
         CNewAsset asset1("RVNASSET", CAmount(100 * COIN), 8, 1, 0, "");
 
         // Add an asset to a valid rvn address
-        BOOST_CHECK_MESSAGE(cache.AddNewAsset(asset1, GetParams().GlobalBurnAddress(), 0, uint256()), "Failed to add new asset");
+        BOOST_CHECK_MESSAGE(cache.AddNewAsset(asset1, CAddressKey::FromString(GetParams().GlobalBurnAddress()), 0, uint256()), "Failed to add new asset");
 
         // Create a reissuance of the asset that is valid
         CReissueAsset reissue1("RVNASSET", CAmount(1 * COIN), 8, 1, DecodeAssetData("QmacSRmrkVmvJfbCpmU6pK72furJ8E8fbKHindrLxmYMQo"));
@@ -178,7 +178,7 @@ BOOST_FIXTURE_TEST_SUITE(asset_reissue_tests, BasicTestingSetup)
         CNewAsset asset2("RVNASSET2", CAmount(100 * COIN), 0, 1, 0, "");
 
         // Add new asset2 to a valid rvn address
-        BOOST_CHECK_MESSAGE(cache.AddNewAsset(asset2, GetParams().GlobalBurnAddress(), 0, uint256()), "Failed to add new asset");
+        BOOST_CHECK_MESSAGE(cache.AddNewAsset(asset2, CAddressKey::FromString(GetParams().GlobalBurnAddress()), 0, uint256()), "Failed to add new asset");
 
         // Create a reissuance of the asset that is valid unit go from 0 -> 1 and change the ipfs hash
         CReissueAsset reissue5("RVNASSET2", CAmount(1 * COIN), 1, 1, DecodeAssetData("QmacSRmrkVmvJfbCpmU6pK72furJ8E8fbKHindrLxmYMQo"));
@@ -194,7 +194,7 @@ BOOST_FIXTURE_TEST_SUITE(asset_reissue_tests, BasicTestingSetup)
         CNewAsset asset3("DATAHASH", CAmount(100 * COIN), 8, 1, 0, "");
 
         // Add new asset3 to a valid rvn address
-        BOOST_CHECK_MESSAGE(cache.AddNewAsset(asset3, GetParams().GlobalBurnAddress(), 0, uint256()), "Failed to add new asset");
+        BOOST_CHECK_MESSAGE(cache.AddNewAsset(asset3, CAddressKey::FromString(GetParams().GlobalBurnAddress()), 0, uint256()), "Failed to add new asset");
 
         // Create a reissuance of the asset that is valid txid but messaging isn't active in unit tests
         CReissueAsset reissue7("DATAHASH", CAmount(1 * COIN), 8, 1, DecodeAssetData("9c2c8e121a0139ba39bffd3ca97267bca9d4c0c1e84ac0c34a883c28e7a912ca"));
@@ -15,6 +15,8 @@
 
 #include "LibBoolEE.h"
 
+#include <regex>
+
 BOOST_FIXTURE_TEST_SUITE(asset_tests, BasicTestingSetup)
 
     BOOST_AUTO_TEST_CASE(name_validation_tests)
@@ -220,6 +222,82 @@ BOOST_FIXTURE_TEST_SUITE(asset_tests, BasicTestingSetup)
         BOOST_CHECK(!IsAssetNameValid("$ABC#NO"));
     }
 
+    BOOST_AUTO_TEST_CASE(name_validation_matches_regex_test)
+    {
+        BOOST_TEST_MESSAGE("Running Name Validation Matches Regex Test");
+
+        // The std::regex formats the hand written validators replaced
+        const std::regex ROOT_NAME_CHARACTERS("^[A-Z0-9._]{3,}$");
+        const std::regex SUB_NAME_CHARACTERS("^[A-Z0-9._]+$");
+        const std::regex UNIQUE_TAG_CHARACTERS("^[-A-Za-z0-9@$%&*()[\\]{}_.?:]+$");
+        const std::regex MSG_CHANNEL_TAG_CHARACTERS("^[A-Za-z0-9_]+$");
+        const std::regex VOTE_TAG_CHARACTERS("^[A-Z0-9._]+$");
+        const std::regex QUALIFIER_NAME_CHARACTERS("#[A-Z0-9._]{3,}$");
+        const std::regex SUB_QUALIFIER_NAME_CHARACTERS("#[A-Z0-9._]+$");
+        const std::regex RESTRICTED_NAME_CHARACTERS("\\$[A-Z0-9._]{3,}$");
+        const std::regex DOUBLE_PUNCTUATION("^.*[._]{2,}.*$");
+        const std::regex LEADING_PUNCTUATION("^[._].*$");
+        const std::regex TRAILING_PUNCTUATION("^.*[._]$");
+        const std::regex QUALIFIER_LEADING_PUNCTUATION("^[#\\$][._].*$");
+        const std::regex UNIQUE_INDICATOR(R"(^[^^~#!]+#[^~#!\/]+$)");
+        const std::regex MSG_CHANNEL_INDICATOR(R"(^[^^~#!]+~[^~#!\/]+$)");
+        const std::regex OWNER_INDICATOR(R"(^[^^~#!]+!$)");
+        const std::regex VOTE_INDICATOR(R"(^[^^~#!]+\^[^~#!\/]+$)");
+        const std::regex QUALIFIER_INDICATOR("^[#][A-Z0-9._]{3,}$");
+        const std::regex SUB_QUALIFIER_INDICATOR("^#[A-Z0-9._]+\\/#[A-Z0-9._]+$");
+        const std::regex RESTRICTED_INDICATOR("^[\\$][A-Z0-9._]{3,}$");
+        const std::regex RAVEN_NAMES("^RVN$|^RAVEN$|^RAVENCOIN$|^#RVN$|^#RAVEN$|^#RAVENCOIN$");
+
+        auto punctuationValid = [&](const std::string& name) {
+            return !std::regex_match(name, DOUBLE_PUNCTUATION)
+                && !std::regex_match(name, LEADING_PUNCTUATION)
+                && !std::regex_match(name, TRAILING_PUNCTUATION);
+        };
+        auto indicator = [&](const std::string& name) {
+            if (std::regex_match(name, UNIQUE_INDICATOR)) return AssetType::UNIQUE;
+            if (std::regex_match(name, MSG_CHANNEL_INDICATOR)) return AssetType::MSGCHANNEL;
+            if (std::regex_match(name, OWNER_INDICATOR)) return AssetType::OWNER;
+            if (std::regex_match(name, VOTE_INDICATOR)) return AssetType::VOTE;
+            if (std::regex_match(name, QUALIFIER_INDICATOR)) return AssetType::QUALIFIER;
+            if (std::regex_match(name, SUB_QUALIFIER_INDICATOR)) return AssetType::SUB_QUALIFIER;
+            if (std::regex_match(name, RESTRICTED_INDICATOR)) return AssetType::RESTRICTED;
+            return AssetType::INVALID;
+        };
+
+        // Names made mostly of the characters the formats care about
+        static const std::string alphabet = "ABZ09._._#$~!^/a-@ ";
+        for (int i = 0; i < 20000; i++) {
+            std::string name;
+            for (int n = InsecureRandRange(12); n > 0; n--)
+                name += alphabet[InsecureRandRange(alphabet.size())];
+            if (InsecureRandBool())
+                name = (InsecureRandBool() ? "#" : "$") + name;
+
+            BOOST_CHECK_EQUAL(IsRootNameValid(name), std::regex_match(name, ROOT_NAME_CHARACTERS)
+                    && punctuationValid(name) && !std::regex_match(name, RAVEN_NAMES));
+            BOOST_CHECK_EQUAL(IsQualifierNameValid(name), std::regex_match(name, QUALIFIER_NAME_CHARACTERS)
+                    && !std::regex_match(name, DOUBLE_PUNCTUATION) && !std::regex_match(name, QUALIFIER_LEADING_PUNCTUATION)
+                    && !std::regex_match(name, TRAILING_PUNCTUATION) && !std::regex_match(name, RAVEN_NAMES));
+            BOOST_CHECK_EQUAL(IsRestrictedNameValid(name), std::regex_match(name, RESTRICTED_NAME_CHARACTERS)
+                    && punctuationValid(name) && !std::regex_match(name, RAVEN_NAMES));
+            BOOST_CHECK_EQUAL(IsSubQualifierNameValid(name), std::regex_match(name, SUB_QUALIFIER_NAME_CHARACTERS)
+                    && punctuationValid(name));
+            BOOST_CHECK_EQUAL(IsSubNameValid(name), std::regex_match(name, SUB_NAME_CHARACTERS) && punctuationValid(name));
+            BOOST_CHECK_EQUAL(IsUniqueTagValid(name), std::regex_match(name, UNIQUE_TAG_CHARACTERS));
+            BOOST_CHECK_EQUAL(IsVoteTagValid(name), std::regex_match(name, VOTE_TAG_CHARACTERS));
+            BOOST_CHECK_EQUAL(IsMsgChannelTagValid(name), std::regex_match(name, MSG_CHANNEL_TAG_CHARACTERS)
+                    && punctuationValid(name));
+            BOOST_CHECK(GetAssetNameIndicator(name) == indicator(name));
+
+            std::set<std::string> qualifiers, expected;
+            ExtractVerifierStringQualifiers(name, qualifiers);
+            const std::regex run("[A-Z0-9_.]+");
+            for (auto it = std::sregex_iterator(name.begin(), name.end(), run); it != std::sregex_iterator(); ++it)
+                expected.insert(it->str());
+            BOOST_CHECK(qualifiers == expected);
+        }
+    }
+
     BOOST_AUTO_TEST_CASE(transfer_asset_coin_test)
     {
         BOOST_TEST_MESSAGE("Running Transfer Asset Coin Test");
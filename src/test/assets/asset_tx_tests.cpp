@@ -607,4 +607,177 @@ BOOST_FIXTURE_TEST_SUITE(asset_tx_tests, BasicTestingSetup)
     }
 #endif
 
+    BOOST_AUTO_TEST_CASE(asset_output_record_test)
+    {
+        BOOST_TEST_MESSAGE("Running Asset Output Record Test");
+
+        SelectParams(CBaseChainParams::MAIN);
+
+        std::string address = GetParams().GlobalBurnAddress();
+        CScript plainScript = GetScriptForDestination(DecodeDestination(address));
+
+        // A plain output is not an asset and matches GetAssetData
+        CAssetOutputRecord record;
+        DecodeAssetOutput(plainScript, record);
+        CAssetOutputEntry entry;
+        BOOST_CHECK(!record.fIsAsset);
+        BOOST_CHECK(!record.fDecoded);
+        BOOST_CHECK(!GetAssetData(plainScript, entry));
+
+        // A transfer is decoded into the record
+        CAssetTransfer transfer("RAVENTEST", 1000);
+        CScript transferScript = plainScript;
+        transfer.ConstructTransaction(transferScript);
+        DecodeAssetOutput(transferScript, record);
+        BOOST_CHECK(record.fIsAsset);
+        BOOST_CHECK(record.fDecoded);
+        BOOST_CHECK_EQUAL(record.nType, TX_TRANSFER_ASSET);
+        BOOST_CHECK_EQUAL(record.transfer.strName, "RAVENTEST");
+        BOOST_CHECK_EQUAL(record.transfer.nAmount, 1000);
+        BOOST_CHECK_EQUAL(record.address.ToString(), address);
+        // The binary key maps back to the destination it was made from
+        BOOST_CHECK(record.address == CAddressKey::FromString(address));
+        BOOST_CHECK(record.address.GetDestination() == DecodeDestination(address));
+
+        CAssetScriptView view;
+        BOOST_CHECK(DecodeAssetScript(transferScript, view));
+        BOOST_CHECK(view.type == AssetScriptType::TRANSFER);
+        BOOST_CHECK(view.nullType == NullAssetScriptType::NONE);
+        BOOST_CHECK(view.pPayload == transferScript.data() + view.nStartingIndex);
+        BOOST_CHECK_EQUAL(view.nPayloadSize, transferScript.size() - view.nStartingIndex);
+        BOOST_CHECK(!DecodeAssetScript(plainScript, view));
+
+        // Decoding again resets whatever the record held
+        DecodeAssetOutput(plainScript, record);
+        BOOST_CHECK(!record.fIsAsset);
+        BOOST_CHECK(record.transfer.strName.empty());
+    }
+
+    BOOST_AUTO_TEST_CASE(asset_tx_coin_asset_data_test)
+    {
+        BOOST_TEST_MESSAGE("Running Asset TX Coin Asset Data Test");
+
+        SelectParams(CBaseChainParams::MAIN);
+
+        CAssetTransfer asset("RAVENTEST", 1000);
+        CTxDestination dest = DecodeDestination(GetParams().GlobalBurnAddress());
+        CScript scriptPubKey = GetScriptForDestination(dest);
+        asset.ConstructTransaction(scriptPubKey);
+
+        CCoinsView view;
+        CCoinsViewCache coins(&view);
+
+        COutPoint outpoint(uint256S("BF50CB9A63BE0019171456252989A459A7D0A5F494735278290079D22AB704A2"), 1);
+        COutPoint outpointPlain(outpoint.hash, 2);
+        coins.AddCoin(outpoint, Coin(CTxOut(0, scriptPubKey), 10, 0), true);
+        coins.AddCoin(outpointPlain, Coin(CTxOut(COIN, GetScriptForDestination(dest)), 10, 0), true);
+
+        // The asset coin is decoded once and the result handed out again
+        auto data = coins.AccessCoinAssetData(outpoint);
+        BOOST_REQUIRE(data);
+        BOOST_CHECK(data->fDecoded);
+        BOOST_CHECK_EQUAL(data->strName, "RAVENTEST");
+        BOOST_CHECK_EQUAL(data->nAmount, 1000);
+        BOOST_CHECK(data->address == CAddressKey::FromDestination(dest));
+        BOOST_CHECK(coins.AccessCoinAssetData(outpoint) == data);
+
+        // Plain and missing coins have none
+        BOOST_CHECK(!coins.AccessCoinAssetData(outpointPlain));
+        BOOST_CHECK(!coins.AccessCoinAssetData(COutPoint(outpoint.hash, 3)));
+
+        // Replacing or spending the coin drops it
+        CAssetTransfer asset2("RAVENTEST", 500);
+        CScript scriptPubKey2 = GetScriptForDestination(dest);
+        asset2.ConstructTransaction(scriptPubKey2);
+        coins.AddCoin(outpoint, Coin(CTxOut(0, scriptPubKey2), 11, 0), true);
+        auto data2 = coins.AccessCoinAssetData(outpoint);
+        BOOST_REQUIRE(data2);
+        BOOST_CHECK_EQUAL(data2->nAmount, 500);
+        BOOST_CHECK(coins.SpendCoin(outpoint));
+        BOOST_CHECK(!coins.AccessCoinAssetData(outpoint));
+    }
+
+    BOOST_AUTO_TEST_CASE(asset_tx_mismatch_many_assets_test)
+    {
+        BOOST_TEST_MESSAGE("Running Asset TX Mismatch Many Assets Test");
+
+        SelectParams(CBaseChainParams::MAIN);
+
+        CTxDestination dest = DecodeDestination(GetParams().GlobalBurnAddress());
+        auto TransferOut = [&dest](const std::string& strName, CAmount nAmount) {
+            CAssetTransfer transfer(strName, nAmount);
+            CScript scriptPubKey = GetScriptForDestination(dest);
+            transfer.ConstructTransaction(scriptPubKey);
+            return CTxOut(0, scriptPubKey);
+        };
+
+        // Twenty assets, more than a transaction's tally scans linearly
+        std::vector<std::string> vNames;
+        for (char c = 'A'; c < 'A' + 20; c++)
+            vNames.emplace_back(std::string("RAVENTEST") + c);
+
+        CCoinsView view;
+        CCoinsViewCache coins(&view);
+        uint256 hash = uint256S("BF50CB9A63BE0019171456252989A459A7D0A5F494735278290079D22AB704A2");
+        for (size_t i = 0; i < vNames.size(); i++)
+            coins.AddCoin(COutPoint(hash, i), Coin(TransferOut(vNames[i], 1000), 10, 0), true);
+
+        // Spend all of them, with the outputs in reverse name order
+        auto MakeTx = [&](const std::vector<CAmount>& vOutAmounts) {
+            CMutableTransaction mutTx;
+            for (size_t i = 0; i < vNames.size(); i++)
+                mutTx.vin.emplace_back(COutPoint(hash, i));
+            for (size_t i = vNames.size(); i-- > 0;) {
+                if (vOutAmounts[i] > 0)
+                    mutTx.vout.emplace_back(TransferOut(vNames[i], vOutAmounts[i]));
+            }
+            return CTransaction(mutTx);
+        };
+
+        std::vector<std::pair<std::string, uint256>> vReissueAssets;
+        std::vector<CAmount> vAmounts(vNames.size(), 1000);
+        CValidationState state;
+        BOOST_CHECK_MESSAGE(Consensus::CheckTxAssets(MakeTx(vAmounts), state, coins, nullptr, false, vReissueAssets, true), state.GetDebugMessage());
+
+        // Several assets burn or mint some: the first by name is reported, whatever the output order
+        vAmounts[17] = 900;
+        vAmounts[4] = 1100;
+        vAmounts[9] = 999;
+        state = CValidationState();
+        BOOST_CHECK(!Consensus::CheckTxAssets(MakeTx(vAmounts), state, coins, nullptr, false, vReissueAssets, true));
+        BOOST_CHECK_EQUAL(state.GetRejectReason(), "bad-tx-inputs-outputs-mismatch Bad Transaction - Assets would be burnt " + vNames[4]);
+
+        vAmounts[4] = 1000;
+        state = CValidationState();
+        BOOST_CHECK(!Consensus::CheckTxAssets(MakeTx(vAmounts), state, coins, nullptr, false, vReissueAssets, true));
+        BOOST_CHECK_EQUAL(state.GetRejectReason(), "bad-tx-inputs-outputs-mismatch Bad Transaction - Assets would be burnt " + vNames[9]);
+
+        // An asset in the outputs only is reported where it sorts among the mismatches
+        vAmounts[9] = 1000;
+        CMutableTransaction mutTx(MakeTx(vAmounts));
+        mutTx.vout.emplace_back(TransferOut("RAVENTESTB0", 1));
+        state = CValidationState();
+        BOOST_CHECK(!Consensus::CheckTxAssets(CTransaction(mutTx), state, coins, nullptr, false, vReissueAssets, true));
+        BOOST_CHECK_EQUAL(state.GetRejectReason(), "bad-tx-inputs-outputs-mismatch Bad Transaction - Trying to create outpoint for asset that you don't have: RAVENTESTB0");
+
+        // Outputs that all match but leave an input asset out burn the whole of it
+        vAmounts[17] = 1000;
+        vAmounts[12] = 0;
+        state = CValidationState();
+        BOOST_CHECK(!Consensus::CheckTxAssets(MakeTx(vAmounts), state, coins, nullptr, false, vReissueAssets, true));
+        BOOST_CHECK_EQUAL(state.GetRejectReason(), "bad-tx-asset-inputs-size-does-not-match-outputs-size");
+
+        // A small transaction after the large one sees none of its totals
+        CMutableTransaction smallTx;
+        smallTx.vin.emplace_back(COutPoint(hash, 0));
+        smallTx.vout.emplace_back(TransferOut(vNames[0], 600));
+        smallTx.vout.emplace_back(TransferOut(vNames[0], 400));
+        state = CValidationState();
+        BOOST_CHECK_MESSAGE(Consensus::CheckTxAssets(CTransaction(smallTx), state, coins, nullptr, false, vReissueAssets, true), state.GetDebugMessage());
+        smallTx.vout.emplace_back(TransferOut(vNames[1], 1000));
+        state = CValidationState();
+        BOOST_CHECK(!Consensus::CheckTxAssets(CTransaction(smallTx), state, coins, nullptr, false, vReissueAssets, true));
+        BOOST_CHECK_EQUAL(state.GetRejectReason(), "bad-tx-inputs-outputs-mismatch Bad Transaction - Trying to create outpoint for asset that you don't have: " + vNames[1]);
+    }
+
 BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,508 @@
+// Copyright (c) 2026 The Mynta Core Developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include <assets/assets.h>
+#include <assets/assetdb.h>
+#include <assets/assetsnapshotdb.h>
+#include <base58.h>
+#include <assets/restricteddb.h>
+#include <assets/snapshotrequestdb.h>
+#include <test/test_mynta.h>
+#include <txdb.h>
+#include <validation.h>
+
+#include <boost/test/unit_test.hpp>
+
+BOOST_FIXTURE_TEST_SUITE(assetdb_tests, TestingSetup)
+
+static CAddressKey TestAddress(int i)
+{
+    return CAddressKey::FromDestination(CKeyID(uint160(std::vector<unsigned char>(20, i + 1))));
+}
+
+BOOST_AUTO_TEST_CASE(asset_address_dir_test)
+{
+    BOOST_TEST_MESSAGE("Running Asset Address Dir Test");
+
+    CAssetsDB* pOldAssetsDb = passetsdb;
+    passetsdb = new CAssetsDB(1 << 20, true, true);
+
+    for (int i = 0; i < 10; i++) {
+        CAddressKey address = TestAddress(i);
+        BOOST_CHECK(passetsdb->WriteAssetAddressQuantity("DIRASSET", address, COIN * (i + 1)));
+        BOOST_CHECK(passetsdb->WriteAddressAssetQuantity(address, "DIRASSET", COIN * (i + 1)));
+    }
+    // Rewriting a balance or erasing a missing entry doesn't change the counts
+    BOOST_CHECK(passetsdb->WriteAssetAddressQuantity("DIRASSET", TestAddress(0), COIN * 5));
+    BOOST_CHECK(passetsdb->EraseAssetAddressQuantity("DIRASSET", TestAddress(20)));
+    BOOST_CHECK(passetsdb->EraseAssetAddressQuantity("DIRASSET", TestAddress(9)));
+
+    std::vector<std::pair<std::string, CAmount> > vecAddressAmounts;
+    int nTotal = 0;
+    BOOST_CHECK(passetsdb->AssetAddressDir(vecAddressAmounts, nTotal, true, "DIRASSET", INT_MAX, 0));
+    BOOST_CHECK_EQUAL(nTotal, 9);
+    BOOST_CHECK(passetsdb->AddressDir(vecAddressAmounts, nTotal, true, TestAddress(9).ToString(), INT_MAX, 0));
+    BOOST_CHECK_EQUAL(nTotal, 1);
+
+    // A cursor continues where the offset left off
+    BOOST_CHECK(passetsdb->AssetAddressDir(vecAddressAmounts, nTotal, false, "DIRASSET", 3, 3));
+    BOOST_CHECK_EQUAL(vecAddressAmounts.size(), 3);
+    std::string strLast = vecAddressAmounts.back().first;
+    std::vector<std::pair<std::string, CAmount> > vecNext;
+    BOOST_CHECK(passetsdb->AssetAddressDir(vecNext, nTotal, false, "DIRASSET", 3, 0, strLast));
+    std::vector<std::pair<std::string, CAmount> > vecOffset;
+    BOOST_CHECK(passetsdb->AssetAddressDir(vecOffset, nTotal, false, "DIRASSET", 3, 6));
+    BOOST_CHECK(vecNext == vecOffset);
+
+    // Negative starts count back from the end of this asset's entries only
+    vecAddressAmounts.clear();
+    BOOST_CHECK(passetsdb->AssetAddressDir(vecAddressAmounts, nTotal, false, "DIRASSET", INT_MAX, -2));
+    BOOST_CHECK_EQUAL(vecAddressAmounts.size(), 2);
+    BOOST_CHECK_EQUAL(vecAddressAmounts.back().first, TestAddress(8).ToString());
+
+    // Addresses that don't decode hold nothing, and can't be a cursor
+    BOOST_CHECK(passetsdb->AddressDir(vecAddressAmounts, nTotal, true, "notanaddress", INT_MAX, 0));
+    BOOST_CHECK_EQUAL(nTotal, 0);
+    BOOST_CHECK(!passetsdb->AssetAddressDir(vecNext, nTotal, false, "DIRASSET", 3, 0, "notanaddress"));
+
+    delete passetsdb;
+    passetsdb = pOldAssetsDb;
+}
+
+BOOST_AUTO_TEST_CASE(asset_read_view_test)
+{
+    BOOST_TEST_MESSAGE("Running Asset Read View Test");
+
+    CAssetsDB* pOldAssetsDb = passetsdb;
+    passetsdb = new CAssetsDB(1 << 20, true, true);
+
+    for (int i = 0; i < 3; i++)
+        BOOST_CHECK(passetsdb->WriteAssetAddressQuantity("VIEWASSET", TestAddress(i), COIN));
+    passetsdb->PublishReadSnapshot();
+
+    // Writes after the snapshot stay invisible until the next one
+    BOOST_CHECK(passetsdb->WriteAssetAddressQuantity("VIEWASSET", TestAddress(3), COIN));
+
+    std::shared_ptr<CAssetsReadDelta> delta = std::make_shared<CAssetsReadDelta>();
+    delta->mapAssetAddressAmount[std::make_pair(std::string("VIEWASSET"), TestAddress(1))] = 0;
+    delta->mapAssetAddressAmount[std::make_pair(std::string("VIEWASSET"), TestAddress(10))] = 2 * COIN;
+    delta->mapAssets["VIEWASSET"] = std::make_pair(true, CDatabasedAssetData(CNewAsset("VIEWASSET", 10 * COIN), 1, uint256()));
+    passetsdb->PublishReadDelta(delta);
+
+    auto view = passetsdb->GetReadView();
+    std::vector<std::pair<std::string, CAmount> > vecAddressAmounts;
+    int nTotal = 0;
+    BOOST_CHECK(passetsdb->AssetAddressDir(*view, vecAddressAmounts, nTotal, true, "VIEWASSET", INT_MAX, 0));
+    BOOST_CHECK_EQUAL(nTotal, 3);
+
+    BOOST_CHECK(passetsdb->AssetAddressDir(*view, vecAddressAmounts, nTotal, false, "VIEWASSET", INT_MAX, 0));
+    BOOST_CHECK_EQUAL(vecAddressAmounts.size(), 3);
+    BOOST_CHECK_EQUAL(vecAddressAmounts[0].first, TestAddress(0).ToString());
+    BOOST_CHECK_EQUAL(vecAddressAmounts[1].first, TestAddress(2).ToString());
+    BOOST_CHECK_EQUAL(vecAddressAmounts[2].first, TestAddress(10).ToString());
+    BOOST_CHECK_EQUAL(vecAddressAmounts[2].second, 2 * COIN);
+
+    CDatabasedAssetData data;
+    BOOST_CHECK(passetsdb->ReadAssetData(*view, "VIEWASSET", data));
+    BOOST_CHECK_EQUAL(data.asset.nAmount, 10 * COIN);
+    BOOST_CHECK(!passetsdb->ReadAssetData(*view, "VIEWMISSING", data));
+
+    // A new snapshot drops the deltas and sees the later writes
+    passetsdb->PublishReadSnapshot();
+    view = passetsdb->GetReadView();
+    BOOST_CHECK(view->vDeltas.empty());
+    BOOST_CHECK(passetsdb->AssetAddressDir(*view, vecAddressAmounts, nTotal, true, "VIEWASSET", INT_MAX, 0));
+    BOOST_CHECK_EQUAL(nTotal, 4);
+
+    view.reset();
+    delete passetsdb;
+    passetsdb = pOldAssetsDb;
+}
+
+BOOST_AUTO_TEST_CASE(unique_collection_dir_test)
+{
+    BOOST_TEST_MESSAGE("Running Unique Collection Dir Test");
+
+    CAssetsDB* pOldAssetsDb = passetsdb;
+    passetsdb = new CAssetsDB(1 << 20, true, true);
+
+    BOOST_CHECK(passetsdb->WriteAssetData(CNewAsset("COLL", 1000 * COIN), 1, uint256()));
+    for (int i = 0; i < 12; i++)
+        BOOST_CHECK(passetsdb->WriteAssetData(CNewAsset("COLL#T" + std::to_string(i), UNIQUE_ASSET_AMOUNT), 2, uint256()));
+    // Other collections, and a rewrite, don't change the count
+    BOOST_CHECK(passetsdb->WriteAssetData(CNewAsset("COLLX#T0", UNIQUE_ASSET_AMOUNT), 2, uint256()));
+    BOOST_CHECK(passetsdb->WriteAssetData(CNewAsset("COLL/SUB#T0", UNIQUE_ASSET_AMOUNT), 2, uint256()));
+    BOOST_CHECK(passetsdb->WriteAssetData(CNewAsset("COLL#T0", UNIQUE_ASSET_AMOUNT), 3, uint256()));
+    BOOST_CHECK(passetsdb->EraseAssetData("COLL#T11"));
+    passetsdb->PublishReadSnapshot();
+
+    auto view = passetsdb->GetReadView();
+    std::vector<std::pair<std::string, CAmount> > vecTagAmounts;
+    int nTotal = 0;
+    BOOST_CHECK(passetsdb->UniqueCollectionDir(*view, vecTagAmounts, nTotal, true, "COLL", INT_MAX, 0));
+    BOOST_CHECK_EQUAL(nTotal, 11);
+    BOOST_CHECK(passetsdb->UniqueCollectionDir(*view, vecTagAmounts, nTotal, true, "COLL/SUB", INT_MAX, 0));
+    BOOST_CHECK_EQUAL(nTotal, 1);
+
+    // Pages continue after the last tag as they do by offset
+    BOOST_CHECK(passetsdb->UniqueCollectionDir(*view, vecTagAmounts, nTotal, false, "COLL", 3, 3));
+    BOOST_CHECK_EQUAL(vecTagAmounts.size(), 3);
+    std::vector<std::pair<std::string, CAmount> > vecNext, vecOffset;
+    BOOST_CHECK(passetsdb->UniqueCollectionDir(*view, vecNext, nTotal, false, "COLL", 3, 0, vecTagAmounts.back().first));
+    BOOST_CHECK(passetsdb->UniqueCollectionDir(*view, vecOffset, nTotal, false, "COLL", 3, 6));
+    BOOST_CHECK(vecNext == vecOffset);
+
+    // listassets "COLL#*" is served from the index, in the same order as a prefix scan
+    std::vector<CDatabasedAssetData> vecIndexed, vecScanned;
+    BOOST_CHECK(passetsdb->AssetDir(*view, vecIndexed, "COLL#*", INT_MAX, 0));
+    BOOST_CHECK(passetsdb->AssetDir(*view, vecScanned, "COLL#T*", INT_MAX, 0));
+    BOOST_CHECK_EQUAL(vecIndexed.size(), 11);
+    BOOST_CHECK_EQUAL(vecIndexed.size(), vecScanned.size());
+    for (size_t i = 0; i < std::min(vecIndexed.size(), vecScanned.size()); i++)
+        BOOST_CHECK_EQUAL(vecIndexed[i].asset.strName, vecScanned[i].asset.strName);
+    vecIndexed.clear();
+    BOOST_CHECK(passetsdb->AssetDir(*view, vecIndexed, "COLL#*", 2, -2));
+    BOOST_CHECK_EQUAL(vecIndexed.size(), 2);
+    BOOST_CHECK_EQUAL(vecIndexed.back().asset.strName, vecScanned.back().asset.strName);
+
+    // Uniques issued and disconnected since the snapshot come from the deltas
+    std::shared_ptr<CAssetsReadDelta> delta = std::make_shared<CAssetsReadDelta>();
+    delta->mapAssets["COLL#NEW"] = std::make_pair(true, CDatabasedAssetData(CNewAsset("COLL#NEW", UNIQUE_ASSET_AMOUNT), 4, uint256()));
+    delta->mapUniqueCollection[std::make_pair(std::string("COLL"), std::string("NEW"))] = UNIQUE_ASSET_AMOUNT;
+    delta->mapAssets["COLL#T1"] = std::make_pair(false, CDatabasedAssetData());
+    delta->mapUniqueCollection[std::make_pair(std::string("COLL"), std::string("T1"))] = 0;
+    passetsdb->PublishReadDelta(delta);
+    view = passetsdb->GetReadView();
+    BOOST_CHECK(passetsdb->UniqueCollectionDir(*view, vecTagAmounts, nTotal, true, "COLL", INT_MAX, 0));
+    BOOST_CHECK_EQUAL(nTotal, 11);
+    vecIndexed.clear();
+    BOOST_CHECK(passetsdb->AssetDir(*view, vecIndexed, "COLL#*", INT_MAX, 0));
+    BOOST_CHECK_EQUAL(vecIndexed.size(), 11);
+    BOOST_CHECK(std::none_of(vecIndexed.begin(), vecIndexed.end(), [](const CDatabasedAssetData& data) { return data.asset.strName == "COLL#T1"; }));
+    BOOST_CHECK(std::any_of(vecIndexed.begin(), vecIndexed.end(), [](const CDatabasedAssetData& data) { return data.asset.strName == "COLL#NEW"; }));
+
+    std::string root, tag;
+    BOOST_CHECK(SplitUniqueAssetName("COLL/SUB#T0", root, tag));
+    BOOST_CHECK_EQUAL(root, "COLL/SUB");
+    BOOST_CHECK_EQUAL(tag, "T0");
+    BOOST_CHECK(!SplitUniqueAssetName("COLL", root, tag));
+    BOOST_CHECK(!SplitUniqueAssetName("#QUALIFIER", root, tag));
+
+    view.reset();
+    delete passetsdb;
+    passetsdb = pOldAssetsDb;
+}
+
+BOOST_AUTO_TEST_CASE(asset_tree_dir_test)
+{
+    BOOST_TEST_MESSAGE("Running Asset Tree Dir Test");
+
+    CAssetsDB* pOldAssetsDb = passetsdb;
+    passetsdb = new CAssetsDB(1 << 20, true, true);
+
+    std::vector<std::string> vNames = {"COMPANY", "COMPANY/DIV", "COMPANY/DIV/TEAM", "COMPANY/DIV#T0", "COMPANY#T0",
+                                       "COMPANY~CHANNEL", "$COMPANY", "#COMPANY", "#COMPANY/#SUB", "OTHER"};
+    for (const auto& name : vNames)
+        BOOST_CHECK(passetsdb->WriteAssetData(CNewAsset(name, COIN), 1, uint256()));
+    // A rewrite doesn't count twice
+    BOOST_CHECK(passetsdb->WriteAssetData(CNewAsset("COMPANY/DIV", COIN), 2, uint256()));
+    passetsdb->PublishReadSnapshot();
+
+    auto view = passetsdb->GetReadView();
+    std::vector<std::pair<std::string, CAmount> > vecChildren;
+    int nTotal = 0;
+    BOOST_CHECK(passetsdb->AssetChildrenDir(*view, vecChildren, nTotal, false, "COMPANY", INT_MAX, 0));
+    BOOST_CHECK_EQUAL(nTotal, 5);
+    BOOST_CHECK_EQUAL(vecChildren.size(), 5);
+    BOOST_CHECK(passetsdb->AssetChildrenDir(*view, vecChildren, nTotal, true, "COMPANY/DIV", INT_MAX, 0));
+    BOOST_CHECK_EQUAL(nTotal, 2);
+    BOOST_CHECK(passetsdb->AssetChildrenDir(*view, vecChildren, nTotal, true, "#COMPANY", INT_MAX, 0));
+    BOOST_CHECK_EQUAL(nTotal, 1);
+    BOOST_CHECK(passetsdb->AssetChildrenDir(*view, vecChildren, nTotal, true, "OTHER", INT_MAX, 0));
+    BOOST_CHECK_EQUAL(nTotal, 0);
+
+    BOOST_CHECK_EQUAL(passetsdb->AssetDescendantCount(*view, "COMPANY"), 8);
+    BOOST_CHECK_EQUAL(passetsdb->AssetDescendantCount(*view, "COMPANY/DIV"), 2);
+    BOOST_CHECK_EQUAL(passetsdb->AssetDescendantCount(*view, "COMPANY/DIV/TEAM"), 0);
+
+    // Pages continue after the last child as they do by offset
+    std::vector<std::pair<std::string, CAmount> > vecFirst, vecNext, vecOffset;
+    BOOST_CHECK(passetsdb->AssetChildrenDir(*view, vecFirst, nTotal, false, "COMPANY", 2, 0));
+    BOOST_CHECK(passetsdb->AssetChildrenDir(*view, vecNext, nTotal, false, "COMPANY", 2, 0, vecFirst.back().first));
+    BOOST_CHECK(passetsdb->AssetChildrenDir(*view, vecOffset, nTotal, false, "COMPANY", 2, 2));
+    BOOST_CHECK(vecNext == vecOffset);
+
+    // Erasing a leaf updates every ancestor
+    BOOST_CHECK(passetsdb->EraseAssetData("COMPANY/DIV/TEAM"));
+    passetsdb->PublishReadSnapshot();
+    view = passetsdb->GetReadView();
+    BOOST_CHECK_EQUAL(passetsdb->AssetDescendantCount(*view, "COMPANY"), 7);
+    BOOST_CHECK_EQUAL(passetsdb->AssetDescendantCount(*view, "COMPANY/DIV"), 1);
+
+    // Assets issued and disconnected since the snapshot come from the deltas
+    std::shared_ptr<CAssetsReadDelta> delta = std::make_shared<CAssetsReadDelta>();
+    delta->mapAssetTree[std::make_pair(std::string("COMPANY/DIV"), std::string("COMPANY/DIV/NEW"))] = ASSET_TREE_ENTRY;
+    delta->mapAssetTree[std::make_pair(std::string("COMPANY"), std::string("COMPANY~CHANNEL"))] = 0;
+    passetsdb->PublishReadDelta(delta);
+    view = passetsdb->GetReadView();
+    BOOST_CHECK(passetsdb->AssetChildrenDir(*view, vecChildren, nTotal, true, "COMPANY", INT_MAX, 0));
+    BOOST_CHECK_EQUAL(nTotal, 4);
+    BOOST_CHECK_EQUAL(passetsdb->AssetDescendantCount(*view, "COMPANY"), 7);
+    BOOST_CHECK_EQUAL(passetsdb->AssetDescendantCount(*view, "COMPANY/DIV"), 2);
+
+    std::string parent;
+    BOOST_CHECK(GetAssetTreeParent("COMPANY/DIV#T0", parent));
+    BOOST_CHECK_EQUAL(parent, "COMPANY/DIV");
+    BOOST_CHECK(GetAssetTreeParent("COMPANY~CHANNEL", parent));
+    BOOST_CHECK_EQUAL(parent, "COMPANY");
+    BOOST_CHECK(GetAssetTreeParent("$COMPANY", parent));
+    BOOST_CHECK_EQUAL(parent, "COMPANY");
+    BOOST_CHECK(GetAssetTreeParent("#COMPANY/#SUB", parent));
+    BOOST_CHECK_EQUAL(parent, "#COMPANY");
+    BOOST_CHECK(GetAssetTreeParent("COMPANY!", parent));
+    BOOST_CHECK_EQUAL(parent, "COMPANY");
+    BOOST_CHECK(GetAssetTreeParent("#COMPANY", parent));
+    BOOST_CHECK_EQUAL(parent, "COMPANY");
+    BOOST_CHECK(!GetAssetTreeParent("COMPANY", parent));
+
+    view.reset();
+    delete passetsdb;
+    passetsdb = pOldAssetsDb;
+}
+
+BOOST_AUTO_TEST_CASE(restricted_prefilter_test)
+{
+    BOOST_TEST_MESSAGE("Running Restricted Prefilter Test");
+
+    CRestrictedDB db(1 << 20, true, true);
+    BOOST_CHECK(db.WriteAddressQualifier("addr1", "#KYC/#US"));
+    BOOST_CHECK(db.WriteRestrictedAddress("addr1", "$TOKEN"));
+    BOOST_CHECK(db.WriteGlobalRestriction("$FROZEN"));
+
+    // Lookups pass through before the filters are loaded, and give the same answers after
+    for (int nPass = 0; nPass < 2; nPass++) {
+        BOOST_CHECK(db.ReadAddressQualifier("addr1", "#KYC/#US"));
+        BOOST_CHECK(db.CheckForAddressRootQualifier("addr1", "#KYC"));
+        BOOST_CHECK(!db.CheckForAddressRootQualifier("addr2", "#KYC"));
+        BOOST_CHECK(db.ReadRestrictedAddress("addr1", "$TOKEN"));
+        BOOST_CHECK(!db.ReadRestrictedAddress("addr2", "$TOKEN"));
+        BOOST_CHECK(db.ReadGlobalRestriction("$FROZEN"));
+        BOOST_CHECK(!db.ReadGlobalRestriction("$OTHER"));
+        db.LoadPrefilters();
+    }
+
+    // Writes after loading are seen straight away, erases still read as absent
+    BOOST_CHECK(db.WriteRestrictedAddress("addr2", "$TOKEN"));
+    BOOST_CHECK(db.ReadRestrictedAddress("addr2", "$TOKEN"));
+    BOOST_CHECK(db.EraseRestrictedAddress("addr1", "$TOKEN"));
+    BOOST_CHECK(!db.ReadRestrictedAddress("addr1", "$TOKEN"));
+
+    // Growing past the filter's capacity rebuilds it without losing keys
+    bool fWritten = true;
+    for (int i = 0; i < 70000; i++) {
+        fWritten &= db.WriteGlobalRestriction("$G" + std::to_string(i));
+    }
+    BOOST_CHECK(fWritten);
+    BOOST_CHECK(db.ReadGlobalRestriction("$G0"));
+    BOOST_CHECK(db.ReadGlobalRestriction("$G69999"));
+    BOOST_CHECK(db.ReadGlobalRestriction("$FROZEN"));
+}
+
+BOOST_AUTO_TEST_CASE(incremental_snapshot_test)
+{
+    BOOST_TEST_MESSAGE("Running Incremental Snapshot Test");
+
+    CAssetsDB* pOldAssetsDb = passetsdb;
+    passetsdb = new CAssetsDB(1 << 20, true, true);
+
+    std::vector<std::string> vAddresses;
+    for (int i = 0; i < 4; i++)
+        vAddresses.push_back(TestAddress(i).ToString());
+    for (int i = 0; i < 3; i++)
+        BOOST_CHECK(passetsdb->WriteAssetAddressQuantity("SNAPASSET", TestAddress(i), COIN * (i + 1)));
+
+    auto readAll = [](CAssetSnapshotDB& db, int nHeight) {
+        std::map<std::string, CAmount> owners;
+        CAssetSnapshotReader reader(db, "SNAPASSET", nHeight);
+        std::pair<std::string, CAmount> ownerAndAmount;
+        while (reader.Next(ownerAndAmount))
+            owners.insert(ownerAndAmount);
+        return owners;
+    };
+
+    {
+        CAssetSnapshotDB db(1 << 20, true, true);
+        BOOST_CHECK(db.AddAssetOwnershipSnapshot("SNAPASSET", 10));
+
+        // Blocks after the base only record the balances they changed
+        std::map<std::pair<std::string, CAddressKey>, CAmount> mapBlock11, mapBlock12;
+        mapBlock11[std::make_pair(std::string("SNAPASSET"), TestAddress(0))] = 0;
+        mapBlock11[std::make_pair(std::string("SNAPASSET"), TestAddress(3))] = 5 * COIN;
+        mapBlock11[std::make_pair(std::string("OTHERASSET"), TestAddress(0))] = COIN;
+        mapBlock12[std::make_pair(std::string("SNAPASSET"), TestAddress(1))] = 7 * COIN;
+        db.ConnectBlockHolderDeltas(11, mapBlock11);
+        db.ConnectBlockHolderDeltas(12, mapBlock12);
+        BOOST_CHECK(db.AddAssetOwnershipSnapshot("SNAPASSET", 12));
+
+        std::map<std::string, CAmount> owners = readAll(db, 10);
+        BOOST_CHECK_EQUAL(owners.size(), 3);
+        BOOST_CHECK_EQUAL(owners[vAddresses[1]], 2 * COIN);
+
+        owners = readAll(db, 12);
+        BOOST_CHECK_EQUAL(owners.size(), 3);
+        BOOST_CHECK(!owners.count(vAddresses[0]));
+        BOOST_CHECK_EQUAL(owners[vAddresses[1]], 7 * COIN);
+        BOOST_CHECK_EQUAL(owners[vAddresses[2]], 3 * COIN);
+        BOOST_CHECK_EQUAL(owners[vAddresses[3]], 5 * COIN);
+
+        CAssetSnapshotDBEntry entry;
+        BOOST_CHECK(db.RetrieveOwnershipSnapshot("SNAPASSET", 12, entry));
+        BOOST_CHECK_EQUAL(entry.ownersAndAmounts.size(), 3);
+
+        // Disconnecting a block drops its deltas
+        db.DisconnectBlockHolderDeltas(12);
+        owners = readAll(db, 12);
+        BOOST_CHECK_EQUAL(owners[vAddresses[1]], 2 * COIN);
+
+        // The base outlives the snapshot it was taken for while others use it
+        BOOST_CHECK(db.RemoveOwnershipSnapshot("SNAPASSET", 10));
+        BOOST_CHECK(!db.HasOwnershipSnapshot("SNAPASSET", 10));
+        BOOST_CHECK_EQUAL(readAll(db, 12).size(), 3);
+        BOOST_CHECK(db.RemoveOwnershipSnapshot("SNAPASSET", 12));
+        BOOST_CHECK(!db.HasOwnershipSnapshot("SNAPASSET", 12));
+        BOOST_CHECK(readAll(db, 12).empty());
+    }
+
+    delete passetsdb;
+    passetsdb = pOldAssetsDb;
+}
+
+BOOST_AUTO_TEST_CASE(snapshot_request_height_test)
+{
+    BOOST_TEST_MESSAGE("Running Snapshot Request Height Test");
+
+    CAssetsDB* pOldAssetsDb = passetsdb;
+    passetsdb = new CAssetsDB(1 << 20, true, true);
+    for (int i = 0; i < 2; i++) {
+        BOOST_CHECK(passetsdb->WriteAssetAddressQuantity("REQA", TestAddress(i), COIN));
+        BOOST_CHECK(passetsdb->WriteAssetAddressQuantity("REQB", TestAddress(i), 2 * COIN));
+    }
+
+    CSnapshotRequestDB requests(1 << 20, true, true);
+    BOOST_CHECK(requests.ScheduleSnapshot("REQA", 10));
+    BOOST_CHECK(requests.ScheduleSnapshot("REQB", 10));
+    BOOST_CHECK(requests.ScheduleSnapshot("REQA", 100));
+    BOOST_CHECK(requests.ScheduleSnapshot("REQC", 9));
+
+    // Only the requests of the height, though "100REQA" used to sort among them
+    std::set<CSnapshotRequestDBEntry> entries;
+    BOOST_CHECK(requests.RetrieveSnapshotRequestsForHeight("", 10, entries));
+    BOOST_CHECK_EQUAL(entries.size(), 2);
+    for (auto const & entry : entries)
+        BOOST_CHECK_EQUAL(entry.heightForSnapshot, 10);
+    BOOST_CHECK(requests.RetrieveSnapshotRequestsForHeight("REQA", 10, entries));
+    BOOST_CHECK_EQUAL(entries.size(), 1);
+    BOOST_CHECK(requests.RetrieveSnapshotRequestsForHeight("REQA", 0, entries));
+    BOOST_CHECK_EQUAL(entries.size(), 2);
+    BOOST_CHECK(requests.RetrieveSnapshotRequestsForHeight("", 0, entries));
+    BOOST_CHECK_EQUAL(entries.size(), 4);
+    BOOST_CHECK(requests.RetrieveSnapshotRequestsForHeight("", 11, entries));
+    BOOST_CHECK(entries.empty());
+
+    BOOST_CHECK(requests.ContainsSnapshotRequest("REQC", 9));
+    BOOST_CHECK(requests.RemoveSnapshotRequest("REQC", 9));
+    BOOST_CHECK(!requests.ContainsSnapshotRequest("REQC", 9));
+
+    // The snapshots due at a block are taken with its holder deltas
+    CAssetSnapshotDB db(1 << 20, true, true);
+    std::vector<std::string> vDue;
+    BOOST_CHECK(requests.RetrieveSnapshotRequestsForHeight("", 10, entries));
+    for (auto const & entry : entries)
+        vDue.push_back(entry.assetName);
+    db.ConnectBlockSnapshots(10, {}, vDue, *passetsdb->GetReadView());
+    BOOST_CHECK(db.HasOwnershipSnapshot("REQA", 10));
+    BOOST_CHECK(db.HasOwnershipSnapshot("REQB", 10));
+
+    std::map<std::pair<std::string, CAddressKey>, CAmount> mapBlock11;
+    mapBlock11[std::make_pair(std::string("REQA"), TestAddress(0))] = 3 * COIN;
+    db.ConnectBlockSnapshots(11, mapBlock11, {"REQA"}, *passetsdb->GetReadView());
+    CAssetSnapshotDBEntry entry;
+    BOOST_CHECK(db.RetrieveOwnershipSnapshot("REQA", 11, entry));
+    BOOST_CHECK(entry.ownersAndAmounts.count(std::make_pair(TestAddress(0).ToString(), 3 * COIN)));
+    BOOST_CHECK(db.RetrieveOwnershipSnapshot("REQB", 10, entry));
+    BOOST_CHECK_EQUAL(entry.ownersAndAmounts.size(), 2);
+
+    delete passetsdb;
+    passetsdb = pOldAssetsDb;
+}
+
+BOOST_AUTO_TEST_CASE(asset_supply_test)
+{
+    BOOST_TEST_MESSAGE("Running Asset Supply Test");
+
+    CAssetsDB* pOldAssetsDb = passetsdb;
+    passetsdb = new CAssetsDB(1 << 20, true, true);
+
+    auto transferOut = [](const std::string& name, CAmount nAmount, const CScript& script) {
+        CScript scriptPubKey = script;
+        CAssetTransfer(name, nAmount).ConstructTransaction(scriptPubKey);
+        return CTxOut(0, scriptPubKey);
+    };
+    const CScript holder = GetScriptForDestination(TestAddress(0).GetDestination());
+    const CScript burn = GetScriptForDestination(DecodeDestination(GetParams().IssueAssetBurnAddress()));
+
+    // The coins db already has outputs before the supply is kept
+    CCoinsViewDB coinsdb(1 << 20, true, true);
+    {
+        CCoinsViewCache coins(&coinsdb);
+        coins.AddCoin(COutPoint(uint256S("01"), 0), Coin(transferOut("SUPPLY", 5 * COIN, holder), 1, false), false);
+        coins.AddCoin(COutPoint(uint256S("01"), 1), Coin(transferOut("SUPPLY", 2 * COIN, burn), 1, false), false);
+        coins.AddCoin(COutPoint(uint256S("02"), 0), Coin(CTxOut(COIN, holder), 1, false), false);
+        coins.SetBestBlock(uint256S("01"));
+        BOOST_CHECK(coins.Flush());
+    }
+    BOOST_CHECK(passetsdb->IndexAssetSupply(&coinsdb));
+    passetsdb->PublishReadSnapshot();
+    CAssetSupply supply = passetsdb->ReadAssetSupply(*passetsdb->GetReadView(), "SUPPLY");
+    BOOST_CHECK_EQUAL(supply.nOutputs, 2);
+    BOOST_CHECK_EQUAL(supply.nHeld, 5 * COIN);
+
+    // A block spends the held output into two, and its changes reach the base cache on flush
+    CAssetsCache base;
+    {
+        CAssetsCache block(&base);
+        block.UpdateAssetSupply(transferOut("SUPPLY", 5 * COIN, holder), -1);
+        block.UpdateAssetSupply(transferOut("SUPPLY", 3 * COIN, holder), 1);
+        block.UpdateAssetSupply(transferOut("SUPPLY", 2 * COIN, GetScriptForDestination(TestAddress(1).GetDestination())), 1);
+        block.UpdateAssetSupply(CTxOut(COIN, holder), 1);
+        BOOST_CHECK(block.Flush());
+    }
+    BOOST_CHECK_EQUAL(base.mapAssetSupplyDelta.size(), 1);
+
+    // RPCs see the block before it is written, and the same totals after
+    std::shared_ptr<CAssetsReadDelta> delta = std::make_shared<CAssetsReadDelta>();
+    base.GetReadDelta(*delta);
+    passetsdb->PublishReadDelta(delta);
+    supply = passetsdb->ReadAssetSupply(*passetsdb->GetReadView(), "SUPPLY");
+    BOOST_CHECK_EQUAL(supply.nOutputs, 3);
+    BOOST_CHECK_EQUAL(supply.nHeld, 5 * COIN);
+
+    BOOST_CHECK(passetsdb->AddAssetSupply(base.mapAssetSupplyDelta));
+    passetsdb->PublishReadSnapshot();
+    supply = passetsdb->ReadAssetSupply(*passetsdb->GetReadView(), "SUPPLY");
+    BOOST_CHECK_EQUAL(supply.nOutputs, 3);
+    BOOST_CHECK_EQUAL(supply.nHeld, 5 * COIN);
+
+    // Counting again only happens for a wiped coins db, which starts over
+    BOOST_CHECK(passetsdb->IndexAssetSupply(&coinsdb));
+    CCoinsViewDB emptydb(1 << 20, true, true);
+    BOOST_CHECK(passetsdb->IndexAssetSupply(&emptydb));
+    passetsdb->PublishReadSnapshot();
+    BOOST_CHECK(passetsdb->ReadAssetSupply(*passetsdb->GetReadView(), "SUPPLY").IsNull());
+
+    delete passetsdb;
+    passetsdb = pOldAssetsDb;
+}
+
+BOOST_AUTO_TEST_SUITE_END()
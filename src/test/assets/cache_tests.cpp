@@ -2,6 +2,8 @@
 #include "assets/assets.h"
 #include <boost/test/unit_test.hpp>
 #include <test/test_mynta.h>
+#include <chainparams.h>
+#include <validation.h>
 
 BOOST_FIXTURE_TEST_SUITE(cache_tests, BasicTestingSetup)
 
@@ -37,5 +39,202 @@ BOOST_AUTO_TEST_CASE(cache_test)
 
 }
 
+BOOST_AUTO_TEST_CASE(cache_overlay_test)
+{
+    BOOST_TEST_MESSAGE("Running Cache Overlay Test");
+
+    SelectParams(CBaseChainParams::MAIN);
+
+    fAssetIndex = false;
+    CAssetsCache* pOldAssets = passets;
+    passets = new CAssetsCache();
+
+    CAddressKey address = CAddressKey::FromString(GetParams().GlobalBurnAddress());
+    CNewAsset asset1("OVERLAYBASE", CAmount(100 * COIN), 8, 1, 0, "");
+    CNewAsset asset2("OVERLAYNEW", CAmount(100 * COIN), 8, 1, 0, "");
+
+    CAssetsCache base;
+    BOOST_CHECK_MESSAGE(base.AddNewAsset(asset1, address, 0, uint256()), "Failed to add asset1 to the base");
+
+    // The overlay starts out empty but reads through to its base
+    CAssetsCache overlay(&base);
+    BOOST_CHECK_MESSAGE(overlay.setNewAssetsToAdd.empty(), "Overlay copied the base's dirty set");
+    BOOST_CHECK_MESSAGE(overlay.CheckIfAssetExists("OVERLAYBASE"), "Overlay didn't see asset1 in its base");
+
+    // Changes made in the overlay shadow the base, without touching it
+    BOOST_CHECK_MESSAGE(overlay.AddNewAsset(asset2, address, 0, uint256()), "Failed to add asset2 to the overlay");
+    BOOST_CHECK_MESSAGE(overlay.RemoveNewAsset(asset1, address), "Failed to remove asset1 in the overlay");
+    BOOST_CHECK_MESSAGE(!overlay.CheckIfAssetExists("OVERLAYBASE"), "Overlay still has asset1 after removing it");
+    BOOST_CHECK_MESSAGE(overlay.CheckIfAssetExists("OVERLAYNEW"), "Overlay doesn't have asset2");
+    BOOST_CHECK_MESSAGE(base.CheckIfAssetExists("OVERLAYBASE"), "Removing asset1 in the overlay changed the base");
+    BOOST_CHECK_MESSAGE(!base.CheckIfAssetExists("OVERLAYNEW"), "Adding asset2 in the overlay changed the base");
+
+    // Flushing moves the overlay's changes into the base, not passets
+    BOOST_CHECK_MESSAGE(overlay.Flush(), "Failed to flush the overlay");
+    BOOST_CHECK_MESSAGE(!base.CheckIfAssetExists("OVERLAYBASE"), "Base still has asset1 after the flush");
+    BOOST_CHECK_MESSAGE(base.CheckIfAssetExists("OVERLAYNEW"), "Base doesn't have asset2 after the flush");
+    BOOST_CHECK_MESSAGE(passets->setNewAssetsToAdd.empty() && passets->setNewAssetsToRemove.empty(), "Overlay flushed into passets");
+
+    delete passets;
+    passets = pOldAssets;
+}
+
+BOOST_AUTO_TEST_CASE(cache_interned_keys_test)
+{
+    BOOST_TEST_MESSAGE("Running Cache Interned Keys Test");
+
+    CAssetNameLRUCache<int8_t> nameCache(2);
+    CAssetAddressLRUCache<int8_t> addressCache(2);
+
+    // Looking up a name that was never put doesn't intern it
+    size_t nPoolSize = assetNamePool.Size();
+    BOOST_CHECK_MESSAGE(!nameCache.Exists("INTERNMISSING"), "Cache had a name that was never put");
+    BOOST_CHECK_MESSAGE(!addressCache.Exists("#INTERNMISSING", "address"), "Cache had a pair that was never put");
+    BOOST_CHECK_MESSAGE(assetNamePool.Size() == nPoolSize, "Lookup added a name to the pool");
+
+    nameCache.Put("INTERNED", 1);
+    uint32_t nId;
+    BOOST_CHECK_MESSAGE(assetNamePool.Find("INTERNED", nId), "Put didn't intern the name");
+    BOOST_CHECK_MESSAGE(assetNamePool.GetName(nId) == "INTERNED", "Pool returned the wrong name for the id");
+    BOOST_CHECK_MESSAGE(assetNamePool.Intern("INTERNED") == nId, "Interning a name twice gave two ids");
+    BOOST_CHECK_MESSAGE(nameCache.Exists("INTERNED") && nameCache.Get("INTERNED") == 1, "Cache lost the name");
+
+    // The same asset with another address is another entry
+    addressCache.Put("#INTERNED", "address1", 1);
+    BOOST_CHECK_MESSAGE(addressCache.Exists("#INTERNED", "address1"), "Cache lost the pair");
+    BOOST_CHECK_MESSAGE(!addressCache.Exists("#INTERNED", "address2"), "Cache matched the wrong address");
+    addressCache.Erase("#INTERNED", "address1");
+    BOOST_CHECK_MESSAGE(!addressCache.Exists("#INTERNED", "address1"), "Erase didn't remove the pair");
+
+    // Interned ids still follow the LRU size limit
+    nameCache.Put("INTERNED2", 1);
+    nameCache.Put("INTERNED3", 1);
+    BOOST_CHECK_MESSAGE(!nameCache.Exists("INTERNED"), "Cache didn't remove the least recently used");
+    BOOST_CHECK_MESSAGE(nameCache.Exists("INTERNED3"), "Cache didn't have INTERNED3");
+}
+
+BOOST_AUTO_TEST_CASE(cache_sharded_lru_test)
+{
+    BOOST_TEST_MESSAGE("Running Cache Sharded LRU Test");
+
+    // Large enough to be split into shards
+    CShardedLRUCache<uint32_t, int8_t> cache(4096);
+    for (uint32_t i = 0; i < 8192; i++)
+        cache.Put(i, 1);
+
+    CLRUCacheStats stats = cache.GetStats();
+    BOOST_CHECK_MESSAGE(cache.Size() <= cache.MaxSize(), "Cache grew past its entry limit");
+    BOOST_CHECK_MESSAGE(stats.nEntries == cache.Size(), "Stats disagree with the size");
+    BOOST_CHECK_MESSAGE(stats.nEvictions == 8192 - stats.nEntries, "Evictions weren't counted");
+    BOOST_CHECK_MESSAGE(cache.Exists(8191), "Cache lost the most recent entry");
+
+    int8_t value = 0;
+    BOOST_CHECK_MESSAGE(cache.Get(8191, value) && value == 1, "Get missed the most recent entry");
+    BOOST_CHECK_MESSAGE(!cache.Get(0, value), "Get found an evicted entry");
+    stats = cache.GetStats();
+    BOOST_CHECK_MESSAGE(stats.nHits == 2 && stats.nMisses == 1, "Hits and misses weren't counted");
+
+    // The byte budget evicts before the entry limit is reached
+    CAssetNameLRUCache<CNullAssetTxVerifierString> verifierCache(1000, 64 * 1024);
+    for (int i = 0; i < 1000; i++)
+        verifierCache.Put("SHARDED" + std::to_string(i), CNullAssetTxVerifierString(std::string(1000, 'A')));
+    BOOST_CHECK_MESSAGE(verifierCache.Size() < 1000, "Byte budget didn't evict anything");
+    BOOST_CHECK_MESSAGE(verifierCache.GetStats().nUsage <= 64 * 1024, "Cache grew past its byte budget");
+
+    // Shrinking frees at least what was asked for, oldest entries first
+    const size_t nBefore = verifierCache.GetStats().nUsage;
+    const size_t nFreed = verifierCache.Shrink(nBefore / 2);
+    BOOST_CHECK_MESSAGE(nFreed >= nBefore / 2, "Shrink freed too little");
+    BOOST_CHECK_MESSAGE(verifierCache.GetStats().nUsage == nBefore - nFreed, "Shrink miscounted what it freed");
+    BOOST_CHECK_MESSAGE(verifierCache.Exists("SHARDED999"), "Shrink dropped the most recent entry");
+    BOOST_CHECK_MESSAGE(verifierCache.Shrink(nBefore * 2) == nBefore - nFreed && verifierCache.Size() == 0, "Shrink didn't empty the cache");
+
+    cache.Clear();
+    BOOST_CHECK_MESSAGE(cache.Size() == 0 && cache.DynamicMemoryUsage() < 1024 * 1024, "Clear left entries behind");
+}
+
+BOOST_AUTO_TEST_CASE(cache_recent_keys_test)
+{
+    BOOST_TEST_MESSAGE("Running Cache Recent Keys Test");
+
+    CAssetNameLRUCache<int8_t> nameCache(10);
+    for (int i = 0; i < 5; i++)
+        nameCache.Put("RECENT" + std::to_string(i), 1);
+    // Using an asset makes it the most recent
+    nameCache.Get("RECENT0");
+
+    std::vector<std::string> vNames = nameCache.GetRecentNames(3);
+    BOOST_CHECK_MESSAGE(vNames.size() == 3, "Didn't get as many names as asked for");
+    BOOST_CHECK_MESSAGE(vNames[0] == "RECENT0", "Most recently used name wasn't first");
+    BOOST_CHECK_MESSAGE(nameCache.GetRecentNames(100).size() == 5, "Didn't get every name");
+
+    // Shards are taken in turn, so the most recent entries of each come first
+    CShardedLRUCache<uint32_t, int8_t> cache(4096);
+    for (uint32_t i = 0; i < 4096; i++)
+        cache.Put(i, 1);
+    std::vector<uint32_t> vKeys = cache.GetRecentKeys(64);
+    BOOST_CHECK_MESSAGE(vKeys.size() == 64, "Didn't get as many keys as asked for");
+    BOOST_CHECK_MESSAGE(std::set<uint32_t>(vKeys.begin(), vKeys.end()).size() == 64, "Keys were repeated");
+    for (uint32_t nKey : vKeys)
+        BOOST_CHECK_MESSAGE(nKey >= 4096 - 256, "Key wasn't among the most recent");
+}
+
+BOOST_AUTO_TEST_CASE(cache_notifications_test)
+{
+    BOOST_TEST_MESSAGE("Running Cache Notifications Test");
+
+    SelectParams(CBaseChainParams::MAIN);
+
+    fAssetIndex = false;
+    CAssetsCache* pOldAssets = passets;
+    passets = new CAssetsCache();
+
+    CAddressKey address = CAddressKey::FromString(GetParams().GlobalBurnAddress());
+    CNewAsset asset("NOTIFY", CAmount(100 * COIN), 8, 1, 0, "");
+    COutPoint out(uint256S("01"), 2);
+
+    CAssetsCache cache;
+    BOOST_CHECK_MESSAGE(cache.AddNewAsset(asset, address, 10, uint256()), "Failed to add the asset");
+    BOOST_CHECK_MESSAGE(cache.AddOwnerAsset("NOTIFY!", address), "Failed to add the owner token");
+    BOOST_CHECK_MESSAGE(cache.AddTransferAsset(CAssetTransfer("NOTIFY", 5 * COIN), address, out, CTxOut()), "Failed to add the transfer");
+
+    // Issues, then transfers; no balances without the asset index
+    std::vector<CAssetNotification> vNotifications;
+    cache.GetNotifications(10, true, vNotifications);
+    BOOST_CHECK_EQUAL(vNotifications.size(), 3U);
+    BOOST_CHECK(vNotifications[0].nType == CAssetNotification::ISSUE && vNotifications[0].assetName == "NOTIFY" && vNotifications[0].nAmount == 100 * COIN);
+    BOOST_CHECK(vNotifications[1].nType == CAssetNotification::ISSUE && vNotifications[1].assetName == "NOTIFY!" && vNotifications[1].nAmount == OWNER_ASSET_AMOUNT);
+    BOOST_CHECK(vNotifications[2].nType == CAssetNotification::TRANSFER && vNotifications[2].out == out && vNotifications[2].address == address.ToString());
+    for (const auto& notification : vNotifications)
+        BOOST_CHECK(notification.fConnected && notification.nHeight == 10);
+
+    // A disconnected block reports what it removed
+    CAssetsCache undo;
+    BOOST_CHECK_MESSAGE(undo.RemoveTransfer(CAssetTransfer("NOTIFY", 5 * COIN), address, out), "Failed to remove the transfer");
+    vNotifications.clear();
+    undo.GetNotifications(10, false, vNotifications);
+    BOOST_CHECK_EQUAL(vNotifications.size(), 1U);
+    BOOST_CHECK(vNotifications[0].nType == CAssetNotification::TRANSFER && !vNotifications[0].fConnected && vNotifications[0].nAmount == 5 * COIN);
+
+    // With the index, every balance the block touched
+    fAssetIndex = true;
+    cache.mapAssetsAddressAmount[std::make_pair(std::string("NOTIFY"), address)] = 105 * COIN;
+    vNotifications.clear();
+    cache.GetNotifications(10, true, vNotifications);
+    BOOST_CHECK_EQUAL(vNotifications.size(), 4U);
+    BOOST_CHECK(vNotifications.back().nType == CAssetNotification::BALANCE && vNotifications.back().nAmount == 105 * COIN);
+    fAssetIndex = false;
+
+    // Records survive a serialization round trip
+    CDataStream ss(SER_NETWORK, PROTOCOL_VERSION);
+    ss << vNotifications.back();
+    CAssetNotification read;
+    ss >> read;
+    BOOST_CHECK(read.assetName == "NOTIFY" && read.address == address.ToString() && read.nAmount == 105 * COIN && read.out.IsNull());
+
+    delete passets;
+    passets = pOldAssets;
+}
+
 BOOST_AUTO_TEST_SUITE_END()
 
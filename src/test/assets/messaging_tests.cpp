@@ -3,6 +3,9 @@
 // file COPYING or http://www.opensource.org/licenses/mit-license.php.
 
 #include <assets/assets.h>
+#include <validation.h>
+#include <assets/messages.h>
+#include <assets/myassetsdb.h>
 
 #include <test/test_mynta.h>
 
@@ -78,4 +81,79 @@ BOOST_FIXTURE_TEST_SUITE(messaging_tests, BasicTestingSetup)
     }
 
 
+    BOOST_AUTO_TEST_CASE(message_channel_index_check)
+    {
+        CMessageDB db(1 << 20, true, true);
+
+        // Written out of height order on two channels
+        int heights[] = {30, 10, 20, 10};
+        for (int i = 0; i < 4; i++) {
+            CMessage message(COutPoint(uint256S(std::to_string(i + 1)), i), i < 3 ? "CHANNEL!" : "OTHER!", "", 0, 0);
+            message.nBlockHeight = heights[i];
+            BOOST_CHECK(db.WriteMessage(message));
+        }
+
+        std::vector<CMessage> vMessages;
+        BOOST_CHECK(db.LoadChannelMessages("CHANNEL!", vMessages));
+        BOOST_CHECK_EQUAL(vMessages.size(), 3);
+        BOOST_CHECK_EQUAL(vMessages[0].nBlockHeight, 10);
+        BOOST_CHECK_EQUAL(vMessages[1].nBlockHeight, 20);
+        BOOST_CHECK_EQUAL(vMessages[2].nBlockHeight, 30);
+
+        // Paging starts at a height and stops after the count
+        vMessages.clear();
+        BOOST_CHECK(db.LoadChannelMessages("CHANNEL!", vMessages, 15, 1));
+        BOOST_CHECK_EQUAL(vMessages.size(), 1);
+        BOOST_CHECK_EQUAL(vMessages[0].nBlockHeight, 20);
+
+        // Erasing by outpoint drops the index entry too
+        BOOST_CHECK(db.EraseMessage(COutPoint(uint256S("3"), 2)));
+        vMessages.clear();
+        BOOST_CHECK(db.LoadChannelMessages("CHANNEL!", vMessages));
+        BOOST_CHECK_EQUAL(vMessages.size(), 2);
+
+        int count = 0;
+        BOOST_CHECK(db.EraseChannelMessages("CHANNEL!", 25, count));
+        BOOST_CHECK_EQUAL(count, 1);
+        CMessage message;
+        BOOST_CHECK(!db.ReadMessage(COutPoint(uint256S("2"), 1), message));
+        BOOST_CHECK(db.ReadMessage(COutPoint(uint256S("1"), 0), message));
+
+        vMessages.clear();
+        BOOST_CHECK(db.LoadChannelMessages("OTHER!", vMessages));
+        BOOST_CHECK_EQUAL(vMessages.size(), 1);
+    }
+
+    BOOST_AUTO_TEST_CASE(message_cache_flush_check)
+    {
+        CMessageDB db(1 << 20, true, true);
+        CMessageLRUCache* pOldCache = pMessagesCache;
+        pMessagesCache = new CMessageLRUCache(MAX_MESSAGE_CACHE_ENTRIES, 1 << 16);
+
+        CMessage kept(COutPoint(uint256S("1"), 0), "CHANNEL!", "", 0, 0);
+        CMessage removed(COutPoint(uint256S("2"), 0), "CHANNEL!", "", 0, 0);
+        BOOST_CHECK(db.WriteMessage(removed));
+        pMessagesCache->Put(removed.out.ToSerializedString(), removed);
+
+        size_t nEmptySize = GetMessageDirtyCacheSize();
+        AddMessage(kept);
+        RemoveMessage(removed);
+        BOOST_CHECK(GetMessageDirtyCacheSize() > nEmptySize);
+
+        BOOST_CHECK(db.Flush());
+        BOOST_CHECK(mapDirtyMessagesAdd.empty() && setDirtyMessagesRemove.empty());
+        BOOST_CHECK_EQUAL(GetMessageDirtyCacheSize(), nEmptySize);
+
+        // The flush wrote both changes and left the read cache consistent with them
+        CMessage message;
+        BOOST_CHECK(db.ReadMessage(kept.out, message));
+        BOOST_CHECK(!db.ReadMessage(removed.out, message));
+        BOOST_CHECK(pMessagesCache->Exists(kept.out.ToSerializedString()));
+        BOOST_CHECK(!pMessagesCache->Exists(removed.out.ToSerializedString()));
+        BOOST_CHECK(pMessagesCache->DynamicMemoryUsage() <= (1 << 16));
+
+        delete pMessagesCache;
+        pMessagesCache = pOldCache;
+    }
+
 BOOST_AUTO_TEST_SUITE_END()
\ No newline at end of file
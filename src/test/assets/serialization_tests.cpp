@@ -175,4 +175,35 @@ BOOST_FIXTURE_TEST_SUITE(serialization_tests, BasicTestingSetup)
         BOOST_CHECK_MESSAGE(IsScriptNewMsgChannelAsset(scriptPubKey), "Script wasn't a message channel");
     }
 
+    BOOST_AUTO_TEST_CASE(address_key_serialization)
+    {
+        SelectParams(CBaseChainParams::MAIN);
+
+        CAddressKey key = CAddressKey::FromString(GetParams().GlobalBurnAddress());
+        BOOST_CHECK_MESSAGE(!key.IsNull(), "Burn address didn't decode");
+        BOOST_CHECK_MESSAGE(key.ToString() == GetParams().GlobalBurnAddress(), "Address didn't round trip");
+
+        // The same key comes out of the asset script as out of the address
+        CNewAsset asset("KEYASSET", 1000);
+        CScript scriptPubKey = GetScriptForDestination(DecodeDestination(GetParams().GlobalBurnAddress()));
+        asset.ConstructTransaction(scriptPubKey);
+        CNewAsset decoded;
+        CAddressKey scriptKey;
+        BOOST_CHECK_MESSAGE(AssetFromScript(scriptPubKey, decoded, scriptKey), "Failed to decode the asset script");
+        BOOST_CHECK_MESSAGE(scriptKey == key, "Script key differs from the address key");
+
+        // A type byte and the hash, ordered by both
+        CDataStream ss(SER_DISK, PROTOCOL_VERSION);
+        ss << key;
+        BOOST_CHECK_EQUAL(ss.size(), 21U);
+        CAddressKey read;
+        ss >> read;
+        BOOST_CHECK_MESSAGE(read == key, "Key didn't survive serialization");
+
+        CAddressKey script = CAddressKey::FromDestination(CScriptID(uint160()));
+        BOOST_CHECK_MESSAGE(key < script, "Key ids don't sort before script ids");
+        BOOST_CHECK_MESSAGE(CAddressKey::FromString("notanaddress").IsNull(), "Invalid address decoded");
+        BOOST_CHECK_MESSAGE(CAddressKey().ToString().empty(), "Null key has an address");
+    }
+
 BOOST_AUTO_TEST_SUITE_END()
\ No newline at end of file
@@ -367,4 +367,42 @@ BOOST_FIXTURE_TEST_SUITE(verifier_string_tests, BasicTestingSetup)
     }
 
 
+    BOOST_AUTO_TEST_CASE(compiled_verifier_matches_resolve_test)
+    {
+        BOOST_TEST_MESSAGE("Running Compiled Verifier Matches Resolve Test");
+
+        const std::vector<std::string> vFormulas = {
+            "A", "!A", "A&B", "A|B", "A&!B|C", "(A|B)&C", "!(A&(B|!C))", "((A))", "A&B&C&D", "A|B|C|D&A",
+            "1", "0&A", "!!A", "(A|0)&1", "A B", "(A", "A)", "A&&B", "A|", "", "()", "A&MISSING", "A~B"
+        };
+        const std::vector<std::string> vVariables = {"A", "B", "C", "D"};
+
+        for (const std::string& formula : vFormulas) {
+            LibBoolEE::Program program;
+            bool fCompiled = LibBoolEE::compile(formula, vVariables, program);
+            for (uint64_t valuation = 0; valuation < 16; valuation++) {
+                LibBoolEE::Vals vals;
+                for (size_t i = 0; i < vVariables.size(); i++)
+                    vals.insert(std::make_pair(vVariables[i], ((valuation >> i) & 1) != 0));
+
+                bool fResolved = false;
+                bool fThrew = false;
+                try {
+                    fResolved = LibBoolEE::resolve(formula, vals);
+                } catch (const std::runtime_error&) {
+                    fThrew = true;
+                }
+
+                BOOST_CHECK_MESSAGE(fCompiled == !fThrew, formula);
+                if (fCompiled && !fThrew)
+                    BOOST_CHECK_MESSAGE(LibBoolEE::evaluate(program, valuation) == fResolved, formula);
+            }
+        }
+
+        // Compiled verifier strings keep the tagged qualifiers; "true" and invalid strings aren't compiled
+        BOOST_CHECK(CompileVerifierString("KYC&!ABC") != nullptr);
+        BOOST_CHECK(CompileVerifierString("true") == nullptr);
+        BOOST_CHECK(CompileVerifierString("KYC&&ABC") == nullptr);
+    }
+
 BOOST_AUTO_TEST_SUITE_END()
@@ -3,9 +3,11 @@
 // file COPYING or http://www.opensource.org/licenses/mit-license.php.
 
 #include "assets/atomicswap.h"
+#include "arith_uint256.h"
 #include "hash.h"
 #include "script/script.h"
 #include "script/standard.h"
+#include "streams.h"
 #include "test/test_mynta.h"
 #include "uint256.h"
 
@@ -280,5 +282,238 @@ BOOST_AUTO_TEST_CASE(htlc_script_generation)
     BOOST_CHECK(scriptStr.find("OP_CHECKLOCKTIMEVERIFY") != std::string::npos);
 }
 
+BOOST_AUTO_TEST_CASE(order_book_price_levels)
+{
+    CAtomicSwapOrderBook book;
+    auto makeOffer = [](int id, const std::string& maker, CAmount makerAmount, const std::string& taker, CAmount takerAmount, int height) {
+        CAtomicSwapOffer offer;
+        offer.offerHash = ArithToUint256(arith_uint256(id));
+        offer.makerAssetName = maker;
+        offer.makerAmount = makerAmount;
+        offer.takerAssetName = taker;
+        offer.takerAmount = takerAmount;
+        offer.timeoutBlocks = 100;
+        offer.createdHeight = height;
+        return offer;
+    };
+
+    // Asks selling TOKEN for MYNTA; 2 and 3 share the 0.5 level, 3 was created first
+    BOOST_CHECK(book.AddOffer(makeOffer(1, "TOKEN", 100 * COIN, "", 60 * COIN, 10)));
+    BOOST_CHECK(book.AddOffer(makeOffer(2, "TOKEN", 100 * COIN, "", 50 * COIN, 12)));
+    BOOST_CHECK(book.AddOffer(makeOffer(3, "TOKEN", 200 * COIN, "", 100 * COIN, 11)));
+    // Bids giving MYNTA for TOKEN
+    BOOST_CHECK(book.AddOffer(makeOffer(4, "", 40 * COIN, "TOKEN", 100 * COIN, 10)));
+    BOOST_CHECK(book.AddOffer(makeOffer(5, "", 45 * COIN, "TOKEN", 100 * COIN, 10)));
+    BOOST_CHECK(!book.AddOffer(makeOffer(5, "", 45 * COIN, "TOKEN", 100 * COIN, 10)));
+
+    // "MYNTA" and "" name the same asset
+    CAtomicSwapOffer* best = book.GetBestOffer("TOKEN", "MYNTA", true);
+    BOOST_REQUIRE(best);
+    BOOST_CHECK(best->offerHash == ArithToUint256(arith_uint256(3)));
+    best = book.GetBestOffer("TOKEN", "", false);
+    BOOST_REQUIRE(best);
+    BOOST_CHECK(best->offerHash == ArithToUint256(arith_uint256(5)));
+    BOOST_CHECK(!book.GetBestOffer("OTHER", "", true));
+
+    UniValue json = book.GetOrderBookJson("TOKEN", "");
+    BOOST_CHECK_EQUAL(json["pair"].get_str(), "TOKEN/MYNTA");
+    BOOST_REQUIRE_EQUAL(json["asks"].size(), 3U);
+    BOOST_CHECK_EQUAL(json["asks"][0]["hash"].get_str(), ArithToUint256(arith_uint256(3)).ToString());
+    BOOST_CHECK_EQUAL(json["asks"][1]["hash"].get_str(), ArithToUint256(arith_uint256(2)).ToString());
+    BOOST_REQUIRE_EQUAL(json["askLevels"].size(), 2U);
+    BOOST_CHECK_EQUAL(json["askLevels"][0]["makerAmount"].get_int64(), 300 * COIN);
+    BOOST_CHECK_EQUAL(json["askLevels"][0]["takerAmount"].get_int64(), 150 * COIN);
+    BOOST_CHECK_EQUAL(json["askLevels"][0]["offers"].get_int(), 2);
+    BOOST_REQUIRE_EQUAL(json["bidLevels"].size(), 2U);
+    BOOST_CHECK_EQUAL(json["bids"][0]["hash"].get_str(), ArithToUint256(arith_uint256(5)).ToString());
+
+    json = book.GetOrderBookJson("TOKEN", "", 1);
+    BOOST_CHECK_EQUAL(json["askLevels"].size(), 1U);
+    BOOST_CHECK_EQUAL(json["asks"].size(), 2U);
+    BOOST_CHECK_EQUAL(json["bids"].size(), 1U);
+
+    // Emptying a level drops it and the next one becomes the best
+    BOOST_CHECK(book.RemoveOffer(ArithToUint256(arith_uint256(2))));
+    BOOST_CHECK(book.RemoveOffer(ArithToUint256(arith_uint256(3))));
+    BOOST_CHECK(!book.RemoveOffer(ArithToUint256(arith_uint256(3))));
+    best = book.GetBestOffer("TOKEN", "", true);
+    BOOST_REQUIRE(best);
+    BOOST_CHECK(best->offerHash == ArithToUint256(arith_uint256(1)));
+    BOOST_CHECK_EQUAL(book.GetOffersForPair("", "TOKEN").size(), 3U);
+}
+
+BOOST_AUTO_TEST_CASE(order_book_price_exact_compare)
+{
+    CAtomicSwapOffer a, b;
+    // Rates that round to the same double but differ exactly
+    a.makerAmount = MAX_MONEY;
+    a.takerAmount = MAX_MONEY - 1;
+    b.makerAmount = MAX_MONEY - 1;
+    b.takerAmount = MAX_MONEY - 2;
+    BOOST_CHECK(COrderBookPrice(b) < COrderBookPrice(a));
+    BOOST_CHECK(!(COrderBookPrice(a) < COrderBookPrice(b)));
+
+    b.makerAmount = 2 * COIN;
+    b.takerAmount = 2 * COIN;
+    a.makerAmount = COIN;
+    a.takerAmount = COIN;
+    BOOST_CHECK(!(COrderBookPrice(a) < COrderBookPrice(b)));
+    BOOST_CHECK(!(COrderBookPrice(b) < COrderBookPrice(a)));
+}
+
+BOOST_AUTO_TEST_CASE(order_book_cleanup_expired)
+{
+    CAtomicSwapOrderBook book;
+    for (int i = 1; i <= 4; i++) {
+        CAtomicSwapOffer offer;
+        offer.offerHash = ArithToUint256(arith_uint256(i));
+        offer.makerAssetName = "TOKEN";
+        offer.makerAmount = COIN;
+        offer.takerAmount = i * COIN;
+        offer.createdHeight = 100;
+        offer.timeoutBlocks = i * 10;
+        BOOST_CHECK(book.AddOffer(offer));
+    }
+
+    // Offers expire once the height reaches createdHeight + timeoutBlocks
+    book.CleanupExpired(119);
+    BOOST_CHECK(!book.GetOffer(ArithToUint256(arith_uint256(1))));
+    BOOST_CHECK(book.GetOffer(ArithToUint256(arith_uint256(2))));
+    book.CleanupExpired(130);
+    BOOST_CHECK(!book.GetOffer(ArithToUint256(arith_uint256(2))));
+    BOOST_CHECK(!book.GetOffer(ArithToUint256(arith_uint256(3))));
+    BOOST_CHECK(book.GetOffer(ArithToUint256(arith_uint256(4))));
+
+    // A removed offer is no longer cleaned up
+    BOOST_CHECK(book.RemoveOffer(ArithToUint256(arith_uint256(4))));
+    book.CleanupExpired(1000);
+    BOOST_CHECK(book.GetOffersForPair("TOKEN", "").empty());
+}
+
+BOOST_AUTO_TEST_CASE(persistent_order_book_reload)
+{
+    const fs::path path = fs::temp_directory_path() / strprintf("test_orderbook_%lu_%i", (unsigned long)GetTime(), (int)InsecureRandRange(100000));
+    fs::create_directories(path);
+    {
+        CPersistentOrderBook book(path.string());
+        BOOST_CHECK(book.Initialize());
+        for (int i = 1; i <= 3; i++) {
+            CAtomicSwapOffer offer;
+            offer.offerHash = ArithToUint256(arith_uint256(i));
+            offer.makerAssetName = "TOKEN";
+            offer.makerAmount = COIN;
+            offer.makerAddress = CScript() << OP_TRUE;
+            offer.takerAmount = i * COIN;
+            offer.createdHeight = 100;
+            // The second offer's timeout is too short for CheckAtomicSwapOffer
+            offer.timeoutBlocks = i == 2 ? 5 : 100;
+            BOOST_CHECK(book.AddOffer(offer, COutPoint(uint256S("01"), i)));
+        }
+        BOOST_CHECK(book.Flush());
+    }
+    {
+        // Test: an offer that doesn't pass the checks isn't loaded again.
+        CPersistentOrderBook book(path.string());
+        BOOST_CHECK(book.Initialize());
+        BOOST_CHECK_EQUAL(book.GetOfferCount(), 2);
+        CAtomicSwapOffer offer;
+        BOOST_CHECK(book.GetOffer(ArithToUint256(arith_uint256(3)), offer));
+        BOOST_CHECK_EQUAL(offer.takerAmount, 3 * COIN);
+        BOOST_CHECK(!book.GetOffer(ArithToUint256(arith_uint256(2)), offer));
+        BOOST_CHECK_EQUAL(book.GetOffersForPair("TOKEN", "").size(), 2U);
+        // Test: the funding outpoints are loaded with their offers.
+        book.UTXOSpent(COutPoint(uint256S("01"), 3));
+        BOOST_CHECK(!book.GetOffer(ArithToUint256(arith_uint256(3)), offer));
+        BOOST_CHECK_EQUAL(book.GetOfferCount(), 1);
+    }
+    fs::remove_all(path);
+}
+
+BOOST_AUTO_TEST_CASE(order_book_update_sequence)
+{
+    CAtomicSwapOrderBook book;
+    CAtomicSwapOffer offer;
+    offer.offerHash = ArithToUint256(arith_uint256(7));
+    offer.makerAssetName = "TOKEN";
+    offer.makerAmount = COIN;
+    offer.takerAmount = 2 * COIN;
+    offer.timeoutBlocks = 10;
+    offer.createdHeight = 1;
+
+    uint64_t nStart = book.GetOrderBookJson("TOKEN", "")["sequence"].get_int64();
+    BOOST_CHECK(book.AddOffer(offer));
+    BOOST_CHECK_EQUAL(book.GetOrderBookJson("TOKEN", "")["sequence"].get_int64(), nStart + 1);
+    BOOST_CHECK(!book.AddOffer(offer));
+    BOOST_CHECK(book.RemoveOffer(offer.offerHash));
+    BOOST_CHECK_EQUAL(book.GetOrderBookJson("TOKEN", "")["sequence"].get_int64(), nStart + 2);
+
+    // Removals carry only the sequence, type and offer hash
+    CDataStream ss(SER_NETWORK, PROTOCOL_VERSION);
+    ss << COrderBookUpdate(COrderBookUpdate::OFFER_REMOVED, offer);
+    BOOST_CHECK_EQUAL(ss.size(), 8U + 1 + 32);
+
+    COrderBookUpdate added(COrderBookUpdate::OFFER_ADDED, offer), decoded;
+    added.nSequence = 42;
+    ss.clear();
+    ss << added;
+    ss >> decoded;
+    BOOST_CHECK_EQUAL(decoded.nSequence, 42U);
+    BOOST_CHECK(decoded.offerHash == offer.offerHash);
+    BOOST_CHECK_EQUAL(decoded.makerAssetName, "TOKEN");
+    BOOST_CHECK_EQUAL(decoded.takerAmount, 2 * COIN);
+    BOOST_CHECK_EQUAL(decoded.timeoutBlocks, 10U);
+}
+
+BOOST_AUTO_TEST_CASE(htlc_spend_matching)
+{
+    std::vector<unsigned char> preimage(32, 0x07);
+    uint256 hashLock = HashSecret(preimage);
+    CKey receiverKey, senderKey;
+    receiverKey.MakeNewKey(true);
+    senderKey.MakeNewKey(true);
+    CScript receiverScript = GetScriptForDestination(receiverKey.GetPubKey().GetID());
+    CScript senderScript = GetScriptForDestination(senderKey.GetPubKey().GetID());
+    CScript redeemScript = HTLCScript::CreateHTLCScript(
+        std::vector<unsigned char>(hashLock.begin(), hashLock.end()), receiverScript, senderScript, 123456);
+
+    CHTLC htlc;
+    BOOST_REQUIRE(HTLCScript::ParseHTLCRedeemScript(redeemScript, htlc));
+    BOOST_CHECK(htlc.hashLock == hashLock);
+    BOOST_CHECK(htlc.receiverAddress == receiverScript);
+    BOOST_CHECK(htlc.senderAddress == senderScript);
+    BOOST_CHECK_EQUAL(htlc.timeLock, 123456U);
+
+    std::vector<unsigned char> sig(71, 0x30), pubkey(33, 0x02);
+    CMutableTransaction mtx;
+    mtx.vin.resize(3);
+    mtx.vin[0].prevout = COutPoint(ArithToUint256(arith_uint256(1)), 0);
+    mtx.vin[0].scriptSig = CScript() << sig << pubkey;
+    mtx.vin[1].prevout = COutPoint(ArithToUint256(arith_uint256(2)), 1);
+    mtx.vin[1].scriptSig = HTLCScript::CreateClaimScript(preimage, sig, pubkey)
+                           << std::vector<unsigned char>(redeemScript.begin(), redeemScript.end());
+    mtx.vin[2].prevout = COutPoint(ArithToUint256(arith_uint256(3)), 2);
+    mtx.vin[2].scriptSig = HTLCScript::CreateRefundScript(sig, pubkey)
+                           << std::vector<unsigned char>(redeemScript.begin(), redeemScript.end());
+
+    HTLCScript::HTLCSpend spend;
+    BOOST_CHECK(!HTLCScript::MatchHTLCSpend(mtx.vin[0].scriptSig, spend));
+    BOOST_REQUIRE(HTLCScript::MatchHTLCSpend(mtx.vin[1].scriptSig, spend));
+    BOOST_CHECK(spend.fClaim);
+    BOOST_CHECK(spend.preimage == preimage);
+    BOOST_REQUIRE(HTLCScript::MatchHTLCSpend(mtx.vin[2].scriptSig, spend));
+    BOOST_CHECK(!spend.fClaim);
+    BOOST_CHECK(spend.htlc.hashLock == hashLock);
+
+    // The claim reveals the preimage by hash lock
+    CHTLCIndex index;
+    BOOST_CHECK_EQUAL(index.ConnectTransaction(CTransaction(mtx)), 1);
+    std::vector<unsigned char> found;
+    BOOST_CHECK(index.GetPreimage(hashLock, found));
+    BOOST_CHECK(found == preimage);
+    COutPoint outpoint;
+    BOOST_CHECK(index.GetHTLC(hashLock, outpoint));
+    BOOST_CHECK(!index.GetPreimage(uint256(), found));
+}
+
 BOOST_AUTO_TEST_SUITE_END()
 
@@ -80,6 +80,55 @@ BOOST_FIXTURE_TEST_SUITE(base58_tests, BasicTestingSetup)
         BOOST_CHECK_EQUAL_COLLECTIONS(result.begin(), result.end(), expected.begin(), expected.end());
     }
 
+    // Goal: the limb conversions agree with digit by digit base58 at every length
+    BOOST_AUTO_TEST_CASE(base58_limbs_test)
+    {
+        BOOST_TEST_MESSAGE("Running Base58 Limbs Test");
+
+        static const char* pszDigits = "123456789ABCDEFGHJKLMNPQRSTUVWXYZabcdefghijkmnopqrstuvwxyz";
+        auto encodeSlow = [](const std::vector<unsigned char>& vch) {
+            std::vector<unsigned char> b58;
+            size_t zeroes = 0;
+            while (zeroes < vch.size() && vch[zeroes] == 0)
+                zeroes++;
+            for (size_t i = zeroes; i < vch.size(); i++) {
+                int carry = vch[i];
+                for (auto it = b58.rbegin(); it != b58.rend(); ++it) {
+                    carry += 256 * (*it);
+                    *it = carry % 58;
+                    carry /= 58;
+                }
+                for (; carry != 0; carry /= 58)
+                    b58.insert(b58.begin(), carry % 58);
+            }
+            std::string str(zeroes, '1');
+            for (unsigned char digit : b58)
+                str += pszDigits[digit];
+            return str;
+        };
+
+        for (size_t nSize = 0; nSize <= 80; nSize++) {
+            for (int i = 0; i < 20; i++) {
+                std::vector<unsigned char> vch(nSize);
+                for (unsigned char& c : vch)
+                    c = InsecureRandBits(8);
+                // Leading zeroes, and all zeroes or all ones, are the edge cases
+                size_t nZeroes = std::min<size_t>(InsecureRandRange(4), nSize);
+                std::fill(vch.begin(), vch.begin() + nZeroes, 0);
+                if (i == 0)
+                    std::fill(vch.begin(), vch.end(), 0xff);
+                if (i == 1)
+                    std::fill(vch.begin(), vch.end(), 0);
+
+                std::string str = EncodeBase58(vch);
+                BOOST_CHECK_EQUAL(str, encodeSlow(vch));
+                std::vector<unsigned char> decoded;
+                BOOST_CHECK(DecodeBase58(str, decoded));
+                BOOST_CHECK(decoded == vch);
+            }
+        }
+    }
+
     // Visitor to check address type
     class TestAddrTypeVisitor : public boost::static_visitor<bool>
     {
@@ -0,0 +1,142 @@
+// Copyright (c) 2026 The Mynta Core Developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include "assets/assets.h"
+#include "blockfilter.h"
+#include "coins.h"
+#include "primitives/block.h"
+#include "random.h"
+#include "script/standard.h"
+#include "streams.h"
+#include "undo.h"
+#include "utilstrencodings.h"
+
+#include "test/test_mynta.h"
+
+#include <boost/test/unit_test.hpp>
+
+BOOST_FIXTURE_TEST_SUITE(blockfilter_tests, BasicTestingSetup)
+
+static GCSFilter::Element ScriptElement(const CScript& script)
+{
+    return GCSFilter::Element(script.begin(), script.end());
+}
+
+BOOST_AUTO_TEST_CASE(gcsfilter_test)
+{
+    FastRandomContext ctx(true);
+    GCSFilter::ElementSet included;
+    GCSFilter::ElementSet excluded;
+    for (int i = 0; i < 100; i++) {
+        GCSFilter::Element element1(32);
+        GCSFilter::Element element2(32);
+        for (int j = 0; j < 32; j++) {
+            element1[j] = ctx.randbits(8);
+            element2[j] = ctx.randbits(8);
+        }
+        included.push_back(element1);
+        excluded.push_back(element2);
+    }
+
+    const GCSFilter::Params params(0, 0, 10, 1 << 10);
+    GCSFilter filter(params, included);
+    BOOST_CHECK_EQUAL(filter.GetN(), 100U);
+    for (const GCSFilter::Element& element : included) {
+        BOOST_CHECK(filter.Match(element));
+        GCSFilter::ElementSet query = excluded;
+        query.push_back(element);
+        BOOST_CHECK(filter.MatchAny(query));
+    }
+
+    // Decoding gives back the same filter, and refuses a cut off one
+    GCSFilter decoded(params, filter.GetEncoded());
+    BOOST_CHECK_EQUAL(decoded.GetN(), filter.GetN());
+    for (const GCSFilter::Element& element : included)
+        BOOST_CHECK(decoded.Match(element));
+    std::vector<unsigned char> vTruncated(filter.GetEncoded().begin(), filter.GetEncoded().end() - 8);
+    BOOST_CHECK_THROW(GCSFilter(params, vTruncated), std::ios_base::failure);
+
+    GCSFilter empty(params);
+    BOOST_CHECK_EQUAL(empty.GetN(), 0U);
+    BOOST_CHECK(!empty.Match(included[0]));
+    BOOST_CHECK(GCSFilter(params, empty.GetEncoded()).GetEncoded() == empty.GetEncoded());
+}
+
+BOOST_AUTO_TEST_CASE(gcsfilter_bip158_vector)
+{
+    // The basic filter of the Bitcoin testnet genesis block, from the BIP158 test vectors
+    const uint256 hashBlock = uint256S("000000000933ea01ad0ee984209779baaec3ced90fa3f408719526f8d77f4943");
+    const std::vector<unsigned char> vScript = ParseHex("4104678afdb0fe5548271967f1a67130b7105cd6a828e03909a67962e0ea1f61deb649f6bc3f4cef38c4f35504e51ec112de5c384df7ba0b8d578a4c702b6bf11d5fac");
+    const GCSFilter::Params params(hashBlock.GetUint64(0), hashBlock.GetUint64(1), BASIC_FILTER_P, BASIC_FILTER_M);
+    GCSFilter filter(params, GCSFilter::ElementSet{vScript});
+    BOOST_CHECK_EQUAL(HexStr(filter.GetEncoded()), "019dfca8");
+
+    BlockFilter blockFilter(BlockFilterType::BASIC, hashBlock, filter.GetEncoded());
+    BOOST_CHECK_EQUAL(blockFilter.ComputeHeader(uint256()).GetHex(), "21584579b7eb08997773e5aeff3a7f932700042d0ed2a6129012b7d7ae81b750");
+}
+
+BOOST_AUTO_TEST_CASE(blockfilter_basic_test)
+{
+    CScript scriptIncluded = CScript() << OP_DUP << OP_HASH160 << std::vector<unsigned char>(20, 1) << OP_EQUALVERIFY << OP_CHECKSIG;
+    CScript scriptSpent = CScript() << OP_HASH160 << std::vector<unsigned char>(20, 2) << OP_EQUAL;
+    CScript scriptOpReturn = CScript() << OP_RETURN << std::vector<unsigned char>(4, 3);
+
+    // An asset transfer to an address that nothing else in the block pays
+    CScript scriptAddress = CScript() << OP_DUP << OP_HASH160 << std::vector<unsigned char>(20, 4) << OP_EQUALVERIFY << OP_CHECKSIG;
+    CScript scriptAsset = scriptAddress;
+    CAssetTransfer("FILTERASSET", 5 * COIN).ConstructTransaction(scriptAsset);
+    BOOST_CHECK(scriptAsset.IsAssetScript());
+
+    CMutableTransaction tx;
+    tx.vin.resize(1);
+    tx.vin[0].prevout = COutPoint(uint256S("0x01"), 0);
+    tx.vout.emplace_back(100, scriptIncluded);
+    tx.vout.emplace_back(0, scriptOpReturn);
+    tx.vout.emplace_back(0, CScript());
+    tx.vout.emplace_back(0, scriptAsset);
+
+    CBlock block;
+    block.vtx.push_back(MakeTransactionRef(tx));
+
+    CBlockUndo blockundo;
+    blockundo.vtxundo.emplace_back();
+    blockundo.vtxundo[0].vprevout.emplace_back(CTxOut(500, scriptSpent), 1000, false);
+
+    BlockFilter filter(BlockFilterType::BASIC, block, blockundo);
+    const GCSFilter& gcs = filter.GetFilter();
+    BOOST_CHECK_EQUAL(gcs.GetN(), 4U);
+    BOOST_CHECK(gcs.Match(ScriptElement(scriptIncluded)));
+    BOOST_CHECK(gcs.Match(ScriptElement(scriptSpent)));
+    BOOST_CHECK(gcs.Match(ScriptElement(scriptAsset)));
+    BOOST_CHECK(gcs.Match(ScriptElement(scriptAddress)));
+    BOOST_CHECK(!gcs.Match(ScriptElement(scriptOpReturn)));
+
+    // Serialized and read back, the filter is the same
+    CDataStream stream(SER_NETWORK, PROTOCOL_VERSION);
+    stream << filter;
+    BlockFilter filterRead;
+    stream >> filterRead;
+    BOOST_CHECK(filterRead.GetFilterType() == BlockFilterType::BASIC);
+    BOOST_CHECK(filterRead.GetBlockHash() == block.GetHash());
+    BOOST_CHECK(filterRead.GetEncodedFilter() == filter.GetEncodedFilter());
+
+    // Each header commits to the one before it
+    const uint256 hashHeader1 = filter.ComputeHeader(uint256());
+    const uint256 hashHeader2 = filter.ComputeHeader(hashHeader1);
+    BOOST_CHECK(hashHeader1 != hashHeader2);
+    const uint256 hashFilter = filter.GetHash();
+    BOOST_CHECK(hashHeader2 == Hash(hashFilter.begin(), hashFilter.end(), hashHeader1.begin(), hashHeader1.end()));
+}
+
+BOOST_AUTO_TEST_CASE(blockfilter_type_names)
+{
+    BlockFilterType filterType;
+    BOOST_CHECK(BlockFilterTypeByName("basic", filterType));
+    BOOST_CHECK(filterType == BlockFilterType::BASIC);
+    BOOST_CHECK_EQUAL(BlockFilterTypeName(BlockFilterType::BASIC), "basic");
+    BOOST_CHECK(!BlockFilterTypeByName("extended", filterType));
+    BOOST_CHECK_EQUAL(BlockFilterTypeName(BlockFilterType::INVALID), "");
+}
+
+BOOST_AUTO_TEST_SUITE_END()
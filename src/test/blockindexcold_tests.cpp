@@ -0,0 +1,109 @@
+// Copyright (c) 2026 The Mynta Core Developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include "blockindexcold.h"
+#include "chain.h"
+#include "clientversion.h"
+#include "streams.h"
+
+#include "test/test_mynta.h"
+
+#include <boost/test/unit_test.hpp>
+
+BOOST_FIXTURE_TEST_SUITE(blockindexcold_tests, TestingSetup)
+
+static CBlockIndexColdData RandomColdData()
+{
+    CBlockIndexColdData data;
+    data.hashMerkleRoot = InsecureRand256();
+    data.nNonce = InsecureRand32();
+    data.nNonce64 = InsecureRandBits(64);
+    data.mix_hash = InsecureRand256();
+    return data;
+}
+
+static bool SameColdData(const CBlockIndexColdData& a, const CBlockIndexColdData& b)
+{
+    return a.hashMerkleRoot == b.hashMerkleRoot && a.nNonce == b.nNonce && a.nNonce64 == b.nNonce64 && a.mix_hash == b.mix_hash;
+}
+
+static void CheckStore(CBlockIndexColdStore& store)
+{
+    // Test: records spanning several chunks read back as written, and can be overwritten.
+    std::vector<CBlockIndexColdData> vData;
+    const uint32_t nRecords = 2 * CBlockIndexColdStore::CHUNK_RECORDS + 100;
+    for (uint32_t i = 0; i < nRecords; i++) {
+        vData.push_back(RandomColdData());
+        BOOST_REQUIRE_EQUAL(store.Add(vData.back()), i);
+    }
+    BOOST_CHECK_EQUAL(store.Size(), nRecords);
+    for (uint32_t i = 0; i < nRecords; i += 997)
+        BOOST_CHECK(SameColdData(store.Get(i), vData[i]));
+    BOOST_CHECK(SameColdData(store.Get(nRecords - 1), vData.back()));
+
+    const uint32_t nPos = CBlockIndexColdStore::CHUNK_RECORDS + 5;
+    vData[nPos] = RandomColdData();
+    store.Set(nPos, vData[nPos]);
+    BOOST_CHECK(SameColdData(store.Get(nPos), vData[nPos]));
+    BOOST_CHECK(SameColdData(store.Get(nPos - 1), vData[nPos - 1]));
+
+    // Test: a cleared store starts again from the first position.
+    store.Clear();
+    BOOST_CHECK_EQUAL(store.Size(), 0U);
+    CBlockIndexColdData data = RandomColdData();
+    BOOST_CHECK_EQUAL(store.Add(data), 0U);
+    BOOST_CHECK(SameColdData(store.Get(0), data));
+}
+
+BOOST_AUTO_TEST_CASE(blockindexcold_heap)
+{
+    CBlockIndexColdStore store;
+    BOOST_CHECK(!store.IsMapped());
+    CheckStore(store);
+}
+
+#ifndef WIN32
+BOOST_AUTO_TEST_CASE(blockindexcold_mapped)
+{
+    CBlockIndexColdStore store;
+    const fs::path path = pathTemp / "indexcold.tmp";
+    BOOST_REQUIRE(store.Open(path));
+    BOOST_CHECK(store.IsMapped());
+    // Test: the scratch file is gone from the directory as soon as it is open.
+    BOOST_CHECK(!fs::exists(path));
+    CheckStore(store);
+}
+#endif
+
+BOOST_AUTO_TEST_CASE(blockindexcold_header)
+{
+    CBlockHeader header;
+    header.nVersion = 4;
+    header.nTime = 1700000000;
+    header.nBits = 0x1e00ffff;
+    header.nHeight = 12;
+    header.hashMerkleRoot = InsecureRand256();
+    header.nNonce64 = InsecureRandBits(64);
+    header.mix_hash = InsecureRand256();
+
+    // Test: an entry gives back the header it was made from once its cold fields are set.
+    CBlockIndex index(header);
+    BOOST_CHECK(index.GetColdData().hashMerkleRoot.IsNull());
+    index.SetColdData(CBlockIndexColdData(header));
+    const CBlockHeader rebuilt = index.GetBlockHeader();
+    BOOST_CHECK(rebuilt.hashMerkleRoot == header.hashMerkleRoot);
+    BOOST_CHECK_EQUAL(rebuilt.nNonce64, header.nNonce64);
+    BOOST_CHECK(rebuilt.mix_hash == header.mix_hash);
+    BOOST_CHECK_EQUAL(rebuilt.nTime, header.nTime);
+
+    // Test: the database form of the entry carries the cold fields.
+    CDataStream ss(SER_DISK, CLIENT_VERSION);
+    ss << CDiskBlockIndex(&index);
+    CDiskBlockIndex diskindex;
+    ss >> diskindex;
+    BOOST_CHECK(diskindex.cold.hashMerkleRoot == header.hashMerkleRoot);
+    BOOST_CHECK_EQUAL(diskindex.nTime, header.nTime);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,104 @@
+// Copyright (c) 2026 The Mynta Core Developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include "blockprefetch.h"
+#include "txdb.h"
+
+#include "test/test_mynta.h"
+
+#include <boost/test/unit_test.hpp>
+
+#include <chrono>
+#include <thread>
+
+BOOST_FIXTURE_TEST_SUITE(blockprefetch_tests, BasicTestingSetup)
+
+static void WaitForRead(const CBlockInputPrefetcher& prefetcher)
+{
+    for (int i = 0; i < 1000 && prefetcher.DynamicMemoryUsage() == 0; i++)
+        std::this_thread::sleep_for(std::chrono::milliseconds(5));
+}
+
+BOOST_AUTO_TEST_CASE(blockprefetch_apply)
+{
+    CCoinsViewDB db(1 << 20, true);
+    CCoinsViewCache tip(&db);
+
+    std::vector<COutPoint> vOutpoints;
+    for (int i = 0; i < 10; i++) {
+        vOutpoints.emplace_back(InsecureRand256(), i % 2);
+        tip.AddCoin(vOutpoints.back(), Coin(CTxOut(i + 1, CScript() << OP_TRUE), 1, false), false);
+    }
+    tip.SetBestBlock(InsecureRand256());
+    BOOST_CHECK(tip.Flush());
+
+    // A coinbase, a transaction spending six earlier coins and one spending
+    // an output of the block itself, which isn't read
+    CBlock block;
+    CMutableTransaction coinbase;
+    coinbase.vin.resize(1);
+    coinbase.vout.emplace_back(1, CScript() << OP_TRUE);
+    block.vtx.push_back(MakeTransactionRef(coinbase));
+    CMutableTransaction spend;
+    for (int i = 0; i < 6; i++)
+        spend.vin.emplace_back(vOutpoints[i]);
+    spend.vout.emplace_back(1, CScript() << OP_TRUE);
+    block.vtx.push_back(MakeTransactionRef(spend));
+    CMutableTransaction child;
+    child.vin.emplace_back(COutPoint(block.vtx[1]->GetHash(), 0));
+    child.vout.emplace_back(1, CScript() << OP_TRUE);
+    block.vtx.push_back(MakeTransactionRef(child));
+    BOOST_CHECK_EQUAL(GetBlockPrefetchOutpoints(block).size(), 6U);
+
+    CBlockInputPrefetcher prefetcher;
+    BOOST_CHECK(!prefetcher.IsRunning());
+    prefetcher.Prefetch(block);
+    BOOST_CHECK_EQUAL(prefetcher.Apply(block.GetHash()), 0U);
+
+    prefetcher.Start(&tip, 2);
+    BOOST_CHECK(prefetcher.IsRunning());
+    prefetcher.Prefetch(block);
+    WaitForRead(prefetcher);
+    BOOST_CHECK(prefetcher.DynamicMemoryUsage() > 0);
+    BOOST_CHECK_EQUAL(prefetcher.Apply(block.GetHash()), 6U);
+    BOOST_CHECK_EQUAL(prefetcher.DynamicMemoryUsage(), 0U);
+    BOOST_CHECK_EQUAL(tip.GetCacheSize(), 6U);
+    for (int i = 0; i < 10; i++)
+        BOOST_CHECK_EQUAL(tip.HaveCoinInCache(vOutpoints[i]), i < 6);
+    BOOST_CHECK_EQUAL(tip.AccessCoin(vOutpoints[5]).out.nValue, 6);
+    // Applied once only
+    BOOST_CHECK_EQUAL(prefetcher.Apply(block.GetHash()), 0U);
+
+    // The tip keeps its own entry over the one read ahead
+    BOOST_CHECK(tip.Flush());
+    prefetcher.Prefetch(block);
+    WaitForRead(prefetcher);
+    BOOST_CHECK(tip.SpendCoin(vOutpoints[0]));
+    BOOST_CHECK_EQUAL(prefetcher.Apply(block.GetHash()), 6U);
+    BOOST_CHECK(!tip.HaveCoin(vOutpoints[0]));
+    BOOST_CHECK(tip.HaveCoinInCache(vOutpoints[1]));
+
+    // A flush since the read leaves the coins read stale
+    BOOST_CHECK(tip.Flush());
+    prefetcher.Prefetch(block);
+    WaitForRead(prefetcher);
+    BOOST_CHECK(tip.SpendCoin(vOutpoints[1]));
+    BOOST_CHECK(tip.Flush());
+    BOOST_CHECK_EQUAL(prefetcher.Apply(block.GetHash()), 0U);
+    BOOST_CHECK_EQUAL(tip.GetCacheSize(), 0U);
+    BOOST_CHECK(!tip.HaveCoin(vOutpoints[1]));
+
+    // Discarded blocks are forgotten
+    prefetcher.Prefetch(block);
+    prefetcher.Discard(block.GetHash());
+    BOOST_CHECK_EQUAL(prefetcher.Apply(block.GetHash()), 0U);
+
+    prefetcher.Stop();
+    BOOST_CHECK(!prefetcher.IsRunning());
+    prefetcher.Prefetch(block);
+    BOOST_CHECK_EQUAL(prefetcher.Apply(block.GetHash()), 0U);
+    BOOST_CHECK_EQUAL(prefetcher.DynamicMemoryUsage(), 0U);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
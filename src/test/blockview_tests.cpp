@@ -0,0 +1,118 @@
+// Copyright (c) 2026 The Mynta Core Developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include "consensus/validation.h"
+#include "primitives/blockview.h"
+#include "random.h"
+#include "streams.h"
+#include "version.h"
+
+#include "test/test_mynta.h"
+
+#include <boost/test/unit_test.hpp>
+
+BOOST_FIXTURE_TEST_SUITE(blockview_tests, BasicTestingSetup)
+
+static CBlock BuildViewTestBlock()
+{
+    CBlock block;
+    block.nVersion = 4;
+    block.hashPrevBlock = InsecureRand256();
+    block.nTime = 1500000000;
+    block.nBits = 0x207fffff;
+    block.nNonce = 7;
+
+    CMutableTransaction coinbase;
+    coinbase.vin.resize(1);
+    coinbase.vin[0].prevout.SetNull();
+    coinbase.vin[0].scriptSig = CScript() << 1 << OP_0;
+    coinbase.vout.resize(1);
+    coinbase.vout[0].nValue = 5000;
+    coinbase.vout[0].scriptPubKey = CScript() << OP_TRUE;
+    block.vtx.push_back(MakeTransactionRef(coinbase));
+
+    // Witness transaction with several outputs
+    CMutableTransaction tx;
+    tx.vin.resize(2);
+    for (auto& in : tx.vin) {
+        in.prevout = COutPoint(InsecureRand256(), 1);
+        in.scriptWitness.stack.push_back(std::vector<unsigned char>(72, 0x30));
+        in.scriptWitness.stack.push_back(std::vector<unsigned char>(33, 0x02));
+    }
+    for (int i = 0; i < 3; i++) {
+        CTxOut out;
+        out.nValue = 1000 + i;
+        out.scriptPubKey = CScript() << OP_DUP << OP_HASH160 << std::vector<unsigned char>(20, i) << OP_EQUALVERIFY << OP_CHECKSIG;
+        tx.vout.push_back(out);
+    }
+    tx.nLockTime = 99;
+    block.vtx.push_back(MakeTransactionRef(tx));
+
+    // Legacy transaction with a long script to exercise larger compact sizes
+    CMutableTransaction tx2;
+    tx2.vin.resize(1);
+    tx2.vin[0].prevout = COutPoint(InsecureRand256(), 0);
+    std::vector<unsigned char> vNops(300, OP_NOP);
+    tx2.vin[0].scriptSig = CScript(vNops.begin(), vNops.end());
+    tx2.vout.resize(1);
+    tx2.vout[0].nValue = 1;
+    vNops.resize(70000, OP_NOP);
+    tx2.vout[0].scriptPubKey = CScript(vNops.begin(), vNops.end());
+    block.vtx.push_back(MakeTransactionRef(tx2));
+    return block;
+}
+
+BOOST_AUTO_TEST_CASE(blockview_matches_deserialized_block)
+{
+    CBlock block = BuildViewTestBlock();
+    CDataStream ss(SER_NETWORK, PROTOCOL_VERSION);
+    ss << block;
+    std::vector<unsigned char> data(ss.begin(), ss.end());
+
+    CBlockView view;
+    BOOST_REQUIRE(view.Parse(data.data(), data.size()));
+    BOOST_CHECK(view.GetHeader().GetHash() == block.GetHash());
+    BOOST_CHECK_EQUAL(view.GetTotalSize(), ::GetSerializeSize(block, SER_NETWORK, PROTOCOL_VERSION));
+    BOOST_CHECK_EQUAL(view.GetStrippedSize(), ::GetSerializeSize(block, SER_NETWORK, PROTOCOL_VERSION | SERIALIZE_TRANSACTION_NO_WITNESS));
+    BOOST_CHECK_EQUAL(view.GetWeight(), GetBlockWeight(block));
+
+    BOOST_REQUIRE_EQUAL(view.GetTransactions().size(), block.vtx.size());
+    for (size_t i = 0; i < block.vtx.size(); i++) {
+        const CTransaction& tx = *block.vtx[i];
+        const CTransactionView& txView = view.GetTransactions()[i];
+        BOOST_CHECK(txView.GetHash() == tx.GetHash());
+        BOOST_CHECK_EQUAL(txView.HasWitness(), tx.HasWitness());
+        BOOST_CHECK_EQUAL(txView.GetInputCount(), tx.vin.size());
+        BOOST_CHECK_EQUAL(txView.GetTotalSize(), tx.GetTotalSize());
+
+        size_t n = 0;
+        txView.ForEachOutput([&](const CTxOutView& out) {
+            BOOST_REQUIRE(n < tx.vout.size());
+            BOOST_CHECK_EQUAL(out.nValue, tx.vout[n].nValue);
+            BOOST_CHECK(out.GetScript() == tx.vout[n].scriptPubKey);
+            n++;
+        });
+        BOOST_CHECK_EQUAL(n, tx.vout.size());
+    }
+}
+
+BOOST_AUTO_TEST_CASE(blockview_rejects_malformed_data)
+{
+    CBlock block = BuildViewTestBlock();
+    CDataStream ss(SER_NETWORK, PROTOCOL_VERSION);
+    ss << block;
+    std::vector<unsigned char> data(ss.begin(), ss.end());
+
+    CBlockView view;
+    // Truncated anywhere
+    for (size_t len : {size_t(0), size_t(40), size_t(81), data.size() / 2, data.size() - 1}) {
+        BOOST_CHECK(!view.Parse(data.data(), len));
+    }
+    // Trailing garbage
+    data.push_back(0);
+    BOOST_CHECK(!view.Parse(data.data(), data.size()));
+    BOOST_CHECK(view.GetTransactions().empty());
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -428,6 +428,20 @@ BOOST_FIXTURE_TEST_SUITE(bloom_tests, BasicTestingSetup)
         BOOST_CHECK(vMatched.size() == merkleBlock.vMatchedTxn.size());
         for (unsigned int i = 0; i < vMatched.size(); i++)
             BOOST_CHECK(vMatched[i] == merkleBlock.vMatchedTxn[i].second);
+
+        // Matching with the elements of every transaction extracted up front gives the same
+        // block, and leaves the filter the same
+        std::vector<CBloomFilterElements> vElements;
+        for (const CTransactionRef& tx : block.vtx)
+            vElements.emplace_back(*tx);
+        CBloomFilter filterElements = filter;
+        CMerkleBlock merkleBlockElements(block, filterElements, vElements);
+        merkleBlock = CMerkleBlock(block, filter);
+        BOOST_CHECK(merkleBlockElements.vMatchedTxn == merkleBlock.vMatchedTxn);
+        CDataStream ssFilter(SER_NETWORK, PROTOCOL_VERSION), ssFilterElements(SER_NETWORK, PROTOCOL_VERSION);
+        ssFilter << filter;
+        ssFilterElements << filterElements;
+        BOOST_CHECK(ssFilter.str() == ssFilterElements.str());
     }
 
     BOOST_AUTO_TEST_CASE(merkle_block_4_test_p2pubkey_only_test)
@@ -5,11 +5,17 @@
 #include "test/test_mynta.h"
 
 #include "bls/bls.h"
+#include "bls/bls_worker.h"
 #include "hash.h"
+#include "streams.h"
 #include "uint256.h"
 
 #include <boost/test/unit_test.hpp>
 
+#include <atomic>
+#include <chrono>
+#include <thread>
+
 BOOST_FIXTURE_TEST_SUITE(bls_tests, BasicTestingSetup)
 
 BOOST_AUTO_TEST_CASE(bls_key_generation)
@@ -187,4 +193,216 @@ BOOST_AUTO_TEST_CASE(bls_deterministic_key_from_seed)
     BOOST_CHECK(pk1 == pk2);
 }
 
+BOOST_AUTO_TEST_CASE(bls_batch_verification)
+{
+    const size_t numSigs = 9;
+    std::vector<CBLSPublicKey> pks;
+    std::vector<CBLSSignature> sigs;
+    std::vector<uint256> hashes;
+    
+    for (size_t i = 0; i < numSigs; i++) {
+        CBLSSecretKey sk;
+        sk.MakeNewKey();
+        uint256 msgHash = Hash(BEGIN(i), END(i));
+        pks.push_back(sk.GetPublicKey());
+        sigs.push_back(sk.Sign(msgHash));
+        hashes.push_back(msgHash);
+    }
+    
+    // All signatures valid
+    std::vector<size_t> vecInvalid;
+    BOOST_CHECK(CBLSSignature::BatchVerify(sigs, pks, hashes));
+    BOOST_CHECK(CBLSSignature::BatchVerify(sigs, pks, hashes, vecInvalid));
+    BOOST_CHECK(vecInvalid.empty());
+    
+    // Swap in two bad signatures; bisection must find exactly those
+    std::swap(sigs[2], sigs[7]);
+    BOOST_CHECK(!CBLSSignature::BatchVerify(sigs, pks, hashes));
+    BOOST_CHECK(!CBLSSignature::BatchVerify(sigs, pks, hashes, vecInvalid));
+    BOOST_CHECK_EQUAL(vecInvalid.size(), 2U);
+    BOOST_CHECK_EQUAL(vecInvalid[0], 2U);
+    BOOST_CHECK_EQUAL(vecInvalid[1], 7U);
+    
+    // Malformed entries are reported without entering the batch
+    std::swap(sigs[2], sigs[7]);
+    sigs[4] = CBLSSignature();
+    BOOST_CHECK(!CBLSSignature::BatchVerify(sigs, pks, hashes, vecInvalid));
+    BOOST_CHECK_EQUAL(vecInvalid.size(), 1U);
+    BOOST_CHECK_EQUAL(vecInvalid[0], 4U);
+    
+    // Mismatched input sizes are rejected
+    hashes.pop_back();
+    BOOST_CHECK(!CBLSSignature::BatchVerify(sigs, pks, hashes));
+}
+
+BOOST_AUTO_TEST_CASE(bls_worker_async_verification)
+{
+    const size_t numSigs = 16;
+    std::vector<CBLSPublicKey> pks;
+    std::vector<CBLSSignature> sigs;
+    std::vector<uint256> hashes;
+    
+    for (size_t i = 0; i < numSigs; i++) {
+        CBLSSecretKey sk;
+        sk.MakeNewKey();
+        uint256 msgHash = Hash(BEGIN(i), END(i));
+        pks.push_back(sk.GetPublicKey());
+        sigs.push_back(sk.Sign(msgHash));
+        hashes.push_back(msgHash);
+    }
+    // Entry 5 signs the wrong message
+    hashes[5] = Hash(BEGIN(numSigs), END(numSigs));
+    
+    CBLSWorker worker;
+    worker.Start(2, 4);
+    BOOST_CHECK(worker.IsRunning());
+    
+    std::vector<int> results(numSigs, -1);
+    std::atomic<size_t> nDone{0};
+    for (size_t i = 0; i < numSigs; i++) {
+        worker.AsyncVerifySig(sigs[i], pks[i], hashes[i], [&results, &nDone, i](bool fValid) {
+            results[i] = fValid ? 1 : 0;
+            nDone++;
+        });
+    }
+    
+    for (int n = 0; n < 1000 && nDone < numSigs; n++) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+    BOOST_CHECK_EQUAL(nDone.load(), numSigs);
+    
+    worker.Stop();
+    BOOST_CHECK(!worker.IsRunning());
+    
+    for (size_t i = 0; i < numSigs; i++) {
+        BOOST_CHECK_EQUAL(results[i], i == 5 ? 0 : 1);
+    }
+    
+    // A stopped worker verifies synchronously
+    bool fCalled = false;
+    worker.AsyncVerifySig(sigs[0], pks[0], hashes[0], [&fCalled](bool fValid) {
+        BOOST_CHECK(fValid);
+        fCalled = true;
+    });
+    BOOST_CHECK(fCalled);
+}
+
+BOOST_AUTO_TEST_CASE(bls_threshold_recovery)
+{
+    const size_t threshold = 3;
+    const size_t numMembers = 5;
+    
+    // Master secret key polynomial, msk[0] is the group secret
+    std::vector<CBLSSecretKey> msk(threshold);
+    for (auto& sk : msk) {
+        sk.MakeNewKey();
+    }
+    CBLSPublicKey groupPk = msk[0].GetPublicKey();
+    
+    uint256 msgHash = Hash(std::string("threshold test").begin(), std::string("threshold test").end());
+    uint256 quorumHash = Hash(std::string("quorum").begin(), std::string("quorum").end());
+    
+    std::vector<CBLSId> ids;
+    std::vector<CBLSSignature> shares;
+    for (size_t i = 0; i < numMembers; i++) {
+        CBLSId id(Hash(BEGIN(i), END(i)));
+        CBLSSecretKey skShare;
+        BOOST_CHECK(skShare.SecretKeyShare(msk, id));
+        ids.push_back(id);
+        shares.push_back(skShare.Sign(msgHash));
+    }
+    
+    CBLSSignature expected = msk[0].Sign(msgHash);
+    
+    // Any threshold-sized subset recovers the group signature
+    CBLSSignature recovered = CBLSSignature::RecoverThresholdSignature(shares, ids, threshold);
+    BOOST_CHECK(recovered.IsValid());
+    BOOST_CHECK(recovered == expected);
+    BOOST_CHECK(recovered.VerifyInsecure(groupPk, msgHash));
+    
+    std::vector<CBLSSignature> subShares = {shares[4], shares[1], shares[3]};
+    std::vector<CBLSId> subIds = {ids[4], ids[1], ids[3]};
+    // Twice, the second call is served from the coefficient cache
+    for (int i = 0; i < 2; i++) {
+        recovered = CBLSSignature::RecoverThresholdSignature(subShares, subIds, threshold, quorumHash);
+        BOOST_CHECK(recovered == expected);
+    }
+    
+    // Fewer than threshold shares do not recover the group signature
+    subShares.pop_back();
+    subIds.pop_back();
+    BOOST_CHECK(!CBLSSignature::RecoverThresholdSignature(subShares, subIds, threshold).IsValid());
+    recovered = CBLSSignature::RecoverThresholdSignature(subShares, subIds, threshold - 1);
+    BOOST_CHECK(recovered.IsValid());
+    BOOST_CHECK(!(recovered == expected));
+    
+    // Duplicate ids are rejected
+    subShares = {shares[0], shares[0], shares[1]};
+    subIds = {ids[0], ids[0], ids[1]};
+    BOOST_CHECK(!CBLSSignature::RecoverThresholdSignature(subShares, subIds, threshold).IsValid());
+}
+
+BOOST_AUTO_TEST_CASE(bls_lazy_objects)
+{
+    CBLSSecretKey sk;
+    sk.MakeNewKey();
+    CBLSPublicKey pk = sk.GetPublicKey();
+    uint256 msgHash = Hash(std::string("lazy test").begin(), std::string("lazy test").end());
+    CBLSSignature sig = sk.Sign(msgHash);
+    
+    // Parsed on first access, cached decompressed points on later ones
+    for (int i = 0; i < 2; i++) {
+        CBLSLazyPublicKey lazyPk;
+        lazyPk.SetBytes(pk.ToBytes());
+        BOOST_CHECK(lazyPk.IsValid());
+        BOOST_CHECK(lazyPk.Get() == pk);
+        
+        CBLSLazySignature lazySig;
+        lazySig.SetBytes(sig.ToBytes());
+        BOOST_CHECK(lazySig.IsValid());
+        BOOST_CHECK(lazySig.Get().VerifyInsecure(lazyPk.Get(), msgHash));
+    }
+    
+    // Serialization round trip and copies
+    CBLSLazyPublicKey lazyPk;
+    lazyPk.SetBytes(pk.ToBytes());
+    CDataStream ss(SER_NETWORK, PROTOCOL_VERSION);
+    ss << lazyPk;
+    CBLSLazyPublicKey lazyPk2;
+    ss >> lazyPk2;
+    CBLSLazyPublicKey lazyPk3(lazyPk2);
+    BOOST_CHECK(lazyPk3.Get() == pk);
+    
+    // Corrupted bytes never parse, even after the valid encoding was cached
+    std::vector<uint8_t> badBytes = pk.ToBytes();
+    badBytes[BLS_PUBLIC_KEY_SIZE - 1] ^= 0x01;
+    CBLSLazyPublicKey badPk;
+    badPk.SetBytes(badBytes);
+    BOOST_CHECK(!(badPk.Get() == pk));
+}
+
+BOOST_AUTO_TEST_CASE(bls_pinned_public_keys)
+{
+    CBLSSecretKey sk;
+    sk.MakeNewKey();
+    CBLSPublicKey pk = sk.GetPublicKey();
+    uint256 msgHash = GetRandHash();
+    CBLSSignature sig = sk.Sign(msgHash);
+    
+    // Pinned as often as unpinned, and verifying as before while pinned
+    const size_t nPinned = BLSPinnedPublicKeyCount();
+    BOOST_CHECK(BLSPinPublicKey(pk));
+    BOOST_CHECK(BLSPinPublicKey(pk));
+    BOOST_CHECK_EQUAL(BLSPinnedPublicKeyCount(), nPinned + 1);
+    BOOST_CHECK(sig.VerifyInsecure(pk, msgHash));
+    BLSUnpinPublicKey(pk);
+    BOOST_CHECK_EQUAL(BLSPinnedPublicKeyCount(), nPinned + 1);
+    BLSUnpinPublicKey(pk);
+    BOOST_CHECK_EQUAL(BLSPinnedPublicKeyCount(), nPinned);
+    
+    // Invalid keys are never pinned
+    BOOST_CHECK(!BLSPinPublicKey(CBLSPublicKey()));
+    BOOST_CHECK_EQUAL(BLSPinnedPublicKeyCount(), nPinned);
+}
+
 BOOST_AUTO_TEST_SUITE_END()
@@ -478,6 +478,41 @@ BOOST_FIXTURE_TEST_SUITE(checkqueue_tests, TestingSetup)
     }
 
 
+    /** Test that CFunctionCheck runs every function once and reports failures */
+    BOOST_AUTO_TEST_CASE(checkqueue_function_check_test)
+    {
+        BOOST_TEST_MESSAGE("Running CheckQueue FunctionCheck Test");
+
+        auto queue = std::unique_ptr<CCheckQueue<CFunctionCheck>>(new CCheckQueue<CFunctionCheck>{QUEUE_BATCH_SIZE});
+        boost::thread_group tg;
+        for (auto x = 0; x < nScriptCheckThreads; ++x)
+        {
+            tg.create_thread([&]
+                             { queue->Thread(); });
+        }
+        for (bool fail : {false, true})
+        {
+            std::atomic<size_t> nCalls{0};
+            CCheckQueueControl<CFunctionCheck> control(queue.get());
+            std::vector<CFunctionCheck> vChecks;
+            for (size_t i = 0; i < 1000; ++i)
+                vChecks.emplace_back([&nCalls, fail, i]
+                                     { nCalls++; return !(fail && i == 500); });
+            control.Add(vChecks);
+            BOOST_REQUIRE(control.Wait() != fail);
+            if (!fail)
+                BOOST_REQUIRE_EQUAL(nCalls, 1000U);
+        }
+        // Every check was taken off a deque exactly once, skipped or not
+        uint64_t nChecks = 0;
+        for (const CCheckQueueWorkerStats& stats : queue->GetWorkerStats())
+            nChecks += stats.nChecks;
+        BOOST_REQUIRE_EQUAL(nChecks, 2000U);
+        tg.interrupt_all();
+        tg.join_all();
+    }
+
+
     /** Test that CCheckQueueControl is threadsafe */
     BOOST_AUTO_TEST_CASE(checkqueuecontrol_locks_test)
     {
@@ -5,6 +5,7 @@
 
 #include "coins.h"
 #include "script/standard.h"
+#include "txdb.h"
 #include "uint256.h"
 #include "undo.h"
 #include "utilstrencodings.h"
@@ -92,7 +93,7 @@ namespace
             size_t count = 0;
             for (CCoinsMap::iterator it = cacheCoins.begin(); it != cacheCoins.end(); it++)
             {
-                ret += it->second.coin.DynamicMemoryUsage();
+                ret += it->second.DynamicMemoryUsage();
                 ++count;
             }
             BOOST_CHECK_EQUAL(GetCacheSize(), count);
@@ -945,4 +946,156 @@ BOOST_FIXTURE_TEST_SUITE(coins_tests, BasicTestingSetup)
                         CheckWriteCoins(parent_value, child_value, parent_value, parent_flags, child_flags, parent_flags);
     }
 
+    BOOST_AUTO_TEST_CASE(ccoins_background_flush)
+    {
+        CCoinsViewDB db(1 << 20, true);
+        CCoinsViewFlushBuffer buffer(&db, &db);
+        CCoinsViewCache tip(&buffer);
+
+        std::vector<COutPoint> vOutpoints;
+        for (int i = 0; i < 1000; i++)
+        {
+            vOutpoints.emplace_back(InsecureRand256(), i % 4);
+            tip.AddCoin(vOutpoints.back(), Coin(CTxOut(i + 1, CScript() << OP_TRUE), 1, false), false);
+        }
+        uint256 hashFirst = InsecureRand256();
+        tip.SetBestBlock(hashFirst);
+        tip.Flush();
+
+        // The second flush is written in the background and read from the buffer meanwhile
+        for (int i = 0; i < 500; i++)
+            tip.SpendCoin(vOutpoints[i]);
+        uint256 hashSecond = InsecureRand256();
+        tip.SetBestBlock(hashSecond);
+        buffer.SetBackground(true);
+        BOOST_CHECK(tip.Flush());
+        BOOST_CHECK_EQUAL(tip.GetCacheSize(), 0U);
+        for (int i = 0; i < 1000; i++)
+        {
+            BOOST_CHECK_EQUAL(tip.HaveCoin(vOutpoints[i]), i >= 500);
+            if (i >= 500)
+                BOOST_CHECK_EQUAL(tip.AccessCoin(vOutpoints[i]).out.nValue, i + 1);
+        }
+
+        BOOST_CHECK(buffer.WaitForWrite());
+        BOOST_CHECK(!buffer.WriteFailed());
+        BOOST_CHECK_EQUAL(buffer.DynamicMemoryUsage(), 0U);
+        BOOST_CHECK(db.GetBestBlock() == hashSecond);
+        BOOST_CHECK(db.GetHeadBlocks().empty());
+        for (int i = 0; i < 1000; i++)
+            BOOST_CHECK_EQUAL(db.HaveCoin(vOutpoints[i]), i >= 500);
+    }
+
+    BOOST_AUTO_TEST_CASE(ccoins_prefetch)
+    {
+        CCoinsViewDB db(1 << 20, true);
+        CCoinsViewFlushBuffer buffer(&db, &db);
+        CCoinsViewCache tip(&buffer);
+
+        std::vector<COutPoint> vOutpoints;
+        for (int i = 0; i < 1000; i++)
+        {
+            vOutpoints.emplace_back(InsecureRand256(), i % 4);
+            tip.AddCoin(vOutpoints.back(), Coin(CTxOut(i + 1, CScript() << OP_TRUE), 1, false), false);
+        }
+        tip.SetBestBlock(InsecureRand256());
+        tip.Flush();
+        BOOST_CHECK_EQUAL(tip.GetCacheSize(), 0U);
+
+        // Enough outpoints for several read threads, some spent and some never created
+        std::vector<COutPoint> vWanted(vOutpoints.begin(), vOutpoints.begin() + 400);
+        for (int i = 0; i < 100; i++)
+            vWanted.emplace_back(InsecureRand256(), 0);
+        std::vector<std::pair<COutPoint, Coin>> vCoins;
+        db.GetCoins(vWanted, vCoins);
+        BOOST_CHECK_EQUAL(vCoins.size(), 400U);
+        for (const auto& found : vCoins) {
+            Coin coin;
+            BOOST_CHECK(db.GetCoin(found.first, coin) && coin.out == found.second.out);
+        }
+
+        // Prefetching fills the cache so the lookups after it don't read through
+        tip.PrefetchCoins(vWanted);
+        BOOST_CHECK_EQUAL(tip.GetCacheSize(), 400U);
+        for (int i = 0; i < 400; i++)
+        {
+            BOOST_CHECK(tip.HaveCoinInCache(vOutpoints[i]));
+            BOOST_CHECK_EQUAL(tip.AccessCoin(vOutpoints[i]).out.nValue, i + 1);
+        }
+        BOOST_CHECK(!tip.HaveCoinInCache(vOutpoints[400]));
+
+        // A child cache gets its coins through the tip without losing the ones it has
+        CCoinsViewCache view(&tip);
+        view.SpendCoin(vOutpoints[0]);
+        vCoins.clear();
+        view.GetCoins(std::vector<COutPoint>(vOutpoints.begin(), vOutpoints.begin() + 10), vCoins);
+        BOOST_CHECK_EQUAL(vCoins.size(), 9U);
+        BOOST_CHECK(!view.HaveCoin(vOutpoints[0]) && tip.HaveCoin(vOutpoints[0]));
+    }
+
+    //! A chainstate coin key, as CCoinsViewDB writes it
+    struct LegacyCoinKey {
+        COutPoint outpoint;
+
+        template<typename Stream>
+        void Serialize(Stream &s) const {
+            s << 'C' << outpoint.hash << VARINT(outpoint.n);
+        }
+    };
+
+    BOOST_FIXTURE_TEST_CASE(ccoins_db_legacy_format, TestingSetup)
+    {
+        // The fixture's chainstate is in memory, so the datadir one is free
+        const fs::path path = GetDataDir() / "chainstate";
+
+        CScript transferScript = GetScriptForDestination(CKeyID(uint160(ParseHex("0102030405060708090a0b0c0d0e0f1011121314"))));
+        CAssetTransfer("ASSET", 5 * COIN).ConstructTransaction(transferScript);
+        const Coin assetCoin(CTxOut(0, transferScript), 100, false);
+        const Coin rawCoin(CTxOut(7, CScript() << OP_1 << std::vector<unsigned char>(33, 0x02) << OP_1 << OP_CHECKMULTISIG), 101, true);
+        const COutPoint assetOutpoint(InsecureRand256(), 1), rawOutpoint(InsecureRand256(), 0);
+
+        // Coins written by a release before the asset script format, in Coin's own serialization
+        {
+            CDBWrapper legacy(path, 1 << 20, false, true, true);
+            BOOST_CHECK(legacy.Write(LegacyCoinKey{assetOutpoint}, assetCoin));
+            BOOST_CHECK(legacy.Write(LegacyCoinKey{rawOutpoint}, rawCoin));
+        }
+
+        {
+            // Read as they are until upgraded, and the same after
+            CCoinsViewDB db(1 << 20);
+            Coin coin;
+            BOOST_CHECK(db.GetCoin(assetOutpoint, coin));
+            BOOST_CHECK(coin.out == assetCoin.out && coin.nHeight == 100 && !coin.fCoinBase);
+            BOOST_CHECK(db.GetCoin(rawOutpoint, coin));
+            BOOST_CHECK(coin.out == rawCoin.out && coin.nHeight == 101 && coin.fCoinBase);
+
+            BOOST_CHECK(db.Upgrade());
+            BOOST_CHECK(db.GetCoin(assetOutpoint, coin));
+            BOOST_CHECK(coin.out == assetCoin.out && coin.nHeight == 100);
+            BOOST_CHECK(db.GetCoin(rawOutpoint, coin));
+            BOOST_CHECK(coin.out == rawCoin.out && coin.nHeight == 101);
+        }
+
+        {
+            // The upgrade leaves a per-tx coins record older releases can't parse
+            CDBWrapper upgraded(path, 1 << 20, false, false, true);
+            unsigned char guard = 1;
+            BOOST_CHECK(upgraded.Read(std::make_pair('c', uint256()), guard));
+            BOOST_CHECK_EQUAL(guard, 0);
+            // which would otherwise misread the asset coin
+            Coin coin;
+            BOOST_CHECK(!upgraded.Read(LegacyCoinKey{assetOutpoint}, coin) || coin.out != assetCoin.out);
+        }
+
+        {
+            // which this release skips, upgrading nothing again
+            CCoinsViewDB db(1 << 20);
+            BOOST_CHECK(db.Upgrade());
+            Coin coin;
+            BOOST_CHECK(db.GetCoin(assetOutpoint, coin));
+            BOOST_CHECK(coin.out == assetCoin.out);
+        }
+    }
+
 BOOST_AUTO_TEST_SUITE_END()
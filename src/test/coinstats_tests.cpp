@@ -0,0 +1,143 @@
+// Copyright (c) 2026 The Mynta Core Developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include "assets/assets.h"
+#include "coins.h"
+#include "coinstats.h"
+#include "hash.h"
+#include "pubkey.h"
+#include "script/standard.h"
+#include "txdb.h"
+#include "utilstrencodings.h"
+
+#include "test/test_mynta.h"
+
+#include <boost/test/unit_test.hpp>
+
+namespace
+{
+
+COutPoint OutPoint(unsigned int i, uint32_t n)
+{
+    // Hashed, so the txids spread over the whole key range and every thread gets some
+    return COutPoint(Hash(BEGIN(i), END(i)), n);
+}
+
+bool Stats(const CCoinsViewDB& db, CCoinsStats& stats, CoinStatsHashType hashType, bool fAssets, int nThreads)
+{
+    return GetUTXOStats(&db, db.GetSnapshot(), stats, hashType, fAssets, nThreads);
+}
+
+} // namespace
+
+BOOST_FIXTURE_TEST_SUITE(coinstats_tests, BasicTestingSetup)
+
+BOOST_AUTO_TEST_CASE(coinstats_threads_test)
+{
+    CCoinsViewDB db(1 << 20, true);
+    const CScript holderA = GetScriptForDestination(CKeyID(uint160(ParseHex("0102030405060708090a0b0c0d0e0f1011121314"))));
+    const CScript holderB = GetScriptForDestination(CScriptID(uint160(ParseHex("1413121110090807060504030201000f0e0d0c0b"))));
+    uint256 hashBest;
+    hashBest.SetHex("0b");
+    CAmount nTotal = 0;
+    {
+        CCoinsViewCache cache(&db);
+        for (unsigned int i = 0; i < 600; i++) {
+            for (uint32_t n = 0; n < 1 + i % 3; n++) {
+                CScript script = n == 2 ? holderB : holderA;
+                if (i % 5 == 0)
+                    CAssetTransfer(i % 2 ? "GOLD" : "SILVER", (n + 1) * COIN).ConstructTransaction(script);
+                Coin coin(CTxOut(i * 1000 + n, script), i, i == 0);
+                nTotal += coin.out.nValue;
+                cache.AddCoin(OutPoint(i, n), std::move(coin), false);
+            }
+        }
+        cache.SetBestBlock(hashBest);
+        BOOST_CHECK(cache.Flush());
+    }
+
+    CCoinsStats serial;
+    BOOST_CHECK(Stats(db, serial, CoinStatsHashType::HASH_SERIALIZED, true, 4));
+    BOOST_CHECK(serial.hashBlock == hashBest);
+    BOOST_CHECK_EQUAL(serial.nTransactions, 600U);
+    BOOST_CHECK_EQUAL(serial.nTransactionOutputs, 1200U);
+    BOOST_CHECK_EQUAL(serial.nTotalAmount, nTotal);
+
+    // Splitting the set over threads only changes how fast it is read
+    CCoinsStats muhash1;
+    BOOST_CHECK(Stats(db, muhash1, CoinStatsHashType::MUHASH, true, 1));
+    for (int nThreads : {2, 3, 7, MAX_COINSTATS_THREADS}) {
+        CCoinsStats stats;
+        BOOST_CHECK(Stats(db, stats, CoinStatsHashType::MUHASH, true, nThreads));
+        BOOST_CHECK(stats.hashBlock == hashBest);
+        BOOST_CHECK_EQUAL(stats.nTransactions, serial.nTransactions);
+        BOOST_CHECK_EQUAL(stats.nTransactionOutputs, serial.nTransactionOutputs);
+        BOOST_CHECK_EQUAL(stats.nBogoSize, serial.nBogoSize);
+        BOOST_CHECK_EQUAL(stats.nTotalAmount, serial.nTotalAmount);
+        BOOST_CHECK(stats.hashSerialized == muhash1.hashSerialized);
+        BOOST_CHECK(stats.mapAssets.size() == 2);
+    }
+    BOOST_CHECK(muhash1.hashSerialized != serial.hashSerialized);
+
+    // Asset amounts, outputs and distinct holders; i = 0, 10, ... hold SILVER,
+    // i = 5, 15, ... GOLD, with outputs n = 0 and 1 at holderA, n = 2 at holderB
+    const CCoinsAssetStats& silver = muhash1.mapAssets["SILVER"];
+    const CCoinsAssetStats& gold = muhash1.mapAssets["GOLD"];
+    CAmount nSilver = 0, nGold = 0;
+    uint64_t nSilverOutputs = 0, nGoldOutputs = 0;
+    for (unsigned int i = 0; i < 600; i += 5) {
+        for (uint32_t n = 0; n < 1 + i % 3; n++) {
+            (i % 2 ? nGold : nSilver) += (n + 1) * COIN;
+            (i % 2 ? nGoldOutputs : nSilverOutputs)++;
+        }
+    }
+    BOOST_CHECK_EQUAL(silver.nAmount, nSilver);
+    BOOST_CHECK_EQUAL(silver.nOutputs, nSilverOutputs);
+    BOOST_CHECK_EQUAL(silver.nHolders, 2U);
+    BOOST_CHECK_EQUAL(gold.nAmount, nGold);
+    BOOST_CHECK_EQUAL(gold.nOutputs, nGoldOutputs);
+    BOOST_CHECK_EQUAL(gold.nHolders, 2U);
+
+    // Without asking for assets there is no breakdown
+    CCoinsStats none;
+    BOOST_CHECK(Stats(db, none, CoinStatsHashType::NONE, false, 4));
+    BOOST_CHECK(none.mapAssets.empty());
+    BOOST_CHECK(none.hashSerialized.IsNull());
+    BOOST_CHECK_EQUAL(none.nTransactionOutputs, serial.nTransactionOutputs);
+}
+
+BOOST_AUTO_TEST_CASE(coinstats_snapshot_test)
+{
+    CCoinsViewDB db(1 << 20, true);
+    uint256 hashFirst, hashSecond;
+    hashFirst.SetHex("01");
+    hashSecond.SetHex("02");
+    {
+        CCoinsViewCache cache(&db);
+        cache.AddCoin(OutPoint(1, 0), Coin(CTxOut(COIN, CScript() << OP_TRUE), 1, false), false);
+        cache.SetBestBlock(hashFirst);
+        BOOST_CHECK(cache.Flush());
+    }
+    std::shared_ptr<const CDBSnapshot> snapshot = db.GetSnapshot();
+    {
+        CCoinsViewCache cache(&db);
+        cache.AddCoin(OutPoint(2, 0), Coin(CTxOut(COIN, CScript() << OP_TRUE), 2, false), false);
+        cache.SetBestBlock(hashSecond);
+        BOOST_CHECK(cache.Flush());
+    }
+
+    // The snapshot still has the first state, coins and best block alike
+    CCoinsStats stats;
+    BOOST_CHECK(GetUTXOStats(&db, snapshot, stats, CoinStatsHashType::MUHASH, false, 4));
+    BOOST_CHECK(stats.hashBlock == hashFirst);
+    BOOST_CHECK_EQUAL(stats.nTransactionOutputs, 1U);
+
+    CCoinsStats current;
+    BOOST_CHECK(Stats(db, current, CoinStatsHashType::MUHASH, false, 4));
+    BOOST_CHECK(current.hashBlock == hashSecond);
+    BOOST_CHECK_EQUAL(current.nTransactionOutputs, 2U);
+    BOOST_CHECK(current.hashSerialized != stats.hashSerialized);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -3,7 +3,11 @@
 // Distributed under the MIT software license, see the accompanying
 // file COPYING or http://www.opensource.org/licenses/mit-license.php.
 
+#include "blockcompression.h"
 #include "compressor.h"
+#include "assets/assets.h"
+#include "script/standard.h"
+#include "streams.h"
 #include "util.h"
 #include "test/test_mynta.h"
 
@@ -68,4 +72,89 @@ BOOST_FIXTURE_TEST_SUITE(compress_tests, BasicTestingSetup)
             BOOST_CHECK(TestDecode(i));
     }
 
+    static size_t CompressedSize(const CScript& script, bool fAssetScripts)
+    {
+        CTxOut out(COIN, script);
+        CDataStream ss(SER_DISK, 0);
+        ss << CTxOutCompressor(out, fAssetScripts);
+        const size_t nSize = ss.size();
+        CTxOut read;
+        ss >> REF(CTxOutCompressor(read, fAssetScripts));
+        BOOST_CHECK(read == out);
+        BOOST_CHECK(ss.empty());
+        return nSize;
+    }
+
+    BOOST_AUTO_TEST_CASE(compress_asset_scripts_test)
+    {
+        const CScript p2pkh = GetScriptForDestination(CKeyID(uint160(ParseHex("0102030405060708090a0b0c0d0e0f1011121314"))));
+        const CScript p2sh = GetScriptForDestination(CScriptID(uint160(ParseHex("1413121110090807060504030201000f0e0d0c0b"))));
+
+        std::vector<CScript> vScripts;
+        for (const CScript& dest : {p2pkh, p2sh}) {
+            CScript script;
+            script = dest;
+            CAssetTransfer("ASSET", 5 * COIN).ConstructTransaction(script);
+            vScripts.push_back(script);
+            script = dest;
+            CAssetTransfer("ASSET/SUB#TAG", 1 * COIN, "QmTqu3Lk3gmTsQVtjU7rYYM37EAW4xNmbuEAp2Mjr4AV7E", 1700000000).ConstructTransaction(script);
+            vScripts.push_back(script);
+            script = dest;
+            CNewAsset("ASSET", 21000000 * COIN, 8, 1, 0, "").ConstructTransaction(script);
+            vScripts.push_back(script);
+            script = dest;
+            CNewAsset("ASSET", 1000 * COIN).ConstructOwnerTransaction(script);
+            vScripts.push_back(script);
+            script = dest;
+            CAssetTransfer(std::string(200, 'A'), 3).ConstructTransaction(script);
+            vScripts.push_back(script);
+        }
+
+        for (const CScript& script : vScripts) {
+            // Both formats give the script back, the chainstate one in fewer bytes
+            size_t nLegacy = CompressedSize(script, false);
+            size_t nAsset = CompressedSize(script, true);
+            BOOST_CHECK(nAsset < nLegacy);
+        }
+
+        // Other scripts only move by the two extra cases
+        CScript multisig = CScript() << OP_1 << std::vector<unsigned char>(33, 0x02) << OP_1 << OP_CHECKMULTISIG;
+        BOOST_CHECK_EQUAL(CompressedSize(multisig, true), CompressedSize(multisig, false));
+        BOOST_CHECK_EQUAL(CompressedSize(p2pkh, true), CompressedSize(p2pkh, false));
+        BOOST_CHECK_EQUAL(CompressedSize(CScript(), true), CompressedSize(CScript(), false));
+
+        // Negative amounts and longer pushes are stored as they are
+        CScript negative = p2pkh;
+        CAssetTransfer("ASSET", -1).ConstructTransaction(negative);
+        BOOST_CHECK_EQUAL(CompressedSize(negative, true), CompressedSize(negative, false));
+    }
+
+    BOOST_AUTO_TEST_CASE(compress_disk_record)
+    {
+        // Repetitive data compresses, and decompresses to exactly what it was
+        std::vector<unsigned char> vData;
+        for (int i = 0; i < 1000; i++) {
+            const std::string strName = strprintf("ASSET%d", i % 10);
+            vData.insert(vData.end(), strName.begin(), strName.end());
+        }
+        std::vector<unsigned char> vStored;
+        if (!CanCompressDiskRecords()) {
+            BOOST_CHECK(!CompressDiskRecord(vData, vStored));
+            BOOST_CHECK_THROW(DecompressDiskRecord(vData.data(), vData.size(), vData.size(), vStored), std::ios_base::failure);
+            return;
+        }
+        BOOST_REQUIRE(CompressDiskRecord(vData, vStored));
+        BOOST_CHECK(vStored.size() < vData.size());
+        std::vector<unsigned char> vOut;
+        DecompressDiskRecord(vStored.data(), vStored.size(), vData.size(), vOut);
+        BOOST_CHECK(vOut == vData);
+
+        // Too large or corrupt data is refused
+        BOOST_CHECK_THROW(DecompressDiskRecord(vStored.data(), vStored.size(), vData.size() - 1, vOut), std::ios_base::failure);
+        BOOST_CHECK_THROW(DecompressDiskRecord(vStored.data(), vStored.size() / 2, vData.size(), vOut), std::ios_base::failure);
+
+        // Data that doesn't get smaller is left to be stored as it is
+        BOOST_CHECK(!CompressDiskRecord(std::vector<unsigned char>(1, 0x42), vStored));
+    }
+
 BOOST_AUTO_TEST_SUITE_END()
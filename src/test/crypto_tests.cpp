@@ -5,12 +5,14 @@
 
 #include "crypto/aes.h"
 #include "crypto/chacha20.h"
+#include "crypto/muhash.h"
 #include "crypto/ripemd160.h"
 #include "crypto/sha1.h"
 #include "crypto/sha256.h"
 #include "crypto/sha512.h"
 #include "crypto/hmac_sha256.h"
 #include "crypto/hmac_sha512.h"
+#include "hash.h"
 #include "random.h"
 #include "utilstrencodings.h"
 #include "test/test_mynta.h"
@@ -334,6 +336,20 @@ BOOST_FIXTURE_TEST_SUITE(crypto_tests, BasicTestingSetup)
         TestSHA256(test1, "a316d55510b49662420f49d145d42fb83f31ef8dc016aa4e32df049991a91e26");
     }
 
+    BOOST_AUTO_TEST_CASE(sha256d64_test)
+    {
+        // Every count up to past a full run of each multi-way kernel, against CHash256
+        for (size_t blocks = 0; blocks <= 34; blocks++) {
+            std::vector<unsigned char> in(64 * blocks), out(32 * blocks), expected(32 * blocks);
+            for (size_t i = 0; i < in.size(); i++)
+                in[i] = InsecureRandBits(8);
+            for (size_t i = 0; i < blocks; i++)
+                CHash256().Write(in.data() + 64 * i, 64).Finalize(expected.data() + 32 * i);
+            SHA256D64(out.data(), in.data(), blocks);
+            BOOST_CHECK(out == expected);
+        }
+    }
+
     BOOST_AUTO_TEST_CASE(sha512_testvectors_test)
     {
         BOOST_TEST_MESSAGE("Running sha512 TestVectors Test");
@@ -565,6 +581,60 @@ BOOST_FIXTURE_TEST_SUITE(crypto_tests, BasicTestingSetup)
                      "fab78c9");
     }
 
+    static MuHash3072 MuHashFromInt(unsigned char i)
+    {
+        unsigned char data[32] = {i, 0};
+        return MuHash3072(data, sizeof(data));
+    }
+
+    static uint256 MuHashFinal(MuHash3072 muhash)
+    {
+        std::vector<unsigned char> vchHash(MuHash3072::OUTPUT_SIZE);
+        muhash.Finalize(vchHash.data());
+        return uint256(vchHash);
+    }
+
+    BOOST_AUTO_TEST_CASE(muhash_test)
+    {
+        BOOST_TEST_MESSAGE("Running MuHash3072 Test");
+
+        // The vector other MuHash3072 implementations are checked against
+        MuHash3072 acc = MuHashFromInt(0);
+        acc *= MuHashFromInt(1);
+        acc /= MuHashFromInt(2);
+        BOOST_CHECK_EQUAL(MuHashFinal(acc).GetHex(), "10d312b100cbd32ada024a6646e40d3482fcff103668d2625f10002a607d5863");
+
+        // Order doesn't matter, and removing an element undoes inserting it
+        std::vector<std::vector<unsigned char>> vElements;
+        for (int i = 0; i < 8; i++)
+            vElements.push_back(insecure_rand_ctx.randbytes(1 + i * 17));
+        MuHash3072 forward, backward, split;
+        for (size_t i = 0; i < vElements.size(); i++) {
+            const std::vector<unsigned char>& last = vElements[vElements.size() - 1 - i];
+            forward.Insert(vElements[i].data(), vElements[i].size());
+            backward.Insert(last.data(), last.size());
+        }
+        BOOST_CHECK(MuHashFinal(forward) == MuHashFinal(backward));
+
+        MuHash3072 half;
+        for (size_t i = 0; i < vElements.size(); i++)
+            (i % 2 ? half : split).Insert(vElements[i].data(), vElements[i].size());
+        split *= half;
+        BOOST_CHECK(MuHashFinal(split) == MuHashFinal(forward));
+
+        MuHash3072 removed = forward;
+        removed.Remove(vElements[3].data(), vElements[3].size());
+        BOOST_CHECK(MuHashFinal(removed) != MuHashFinal(forward));
+        removed.Insert(vElements[3].data(), vElements[3].size());
+        BOOST_CHECK(MuHashFinal(removed) == MuHashFinal(forward));
+
+        MuHash3072 empty, emptied;
+        emptied.Insert(vElements[0].data(), vElements[0].size());
+        emptied.Remove(vElements[0].data(), vElements[0].size());
+        BOOST_CHECK(MuHashFinal(emptied) == MuHashFinal(empty));
+        BOOST_CHECK(MuHashFinal(forward) != MuHashFinal(empty));
+    }
+
     BOOST_AUTO_TEST_CASE(countbits_test)
     {
         BOOST_TEST_MESSAGE("Running CoutBits Test");
@@ -4,6 +4,7 @@
 // file COPYING or http://www.opensource.org/licenses/mit-license.php.
 
 #include "dbwrapper.h"
+#include "txdb.h"
 #include "uint256.h"
 #include "random.h"
 #include "test/test_mynta.h"
@@ -45,6 +46,35 @@ BOOST_FIXTURE_TEST_SUITE(dbwrapper_tests, BasicTestingSetup)
         }
     }
 
+    BOOST_AUTO_TEST_CASE(dbwrapper_shared_cache_test)
+    {
+        // Databases opened while a shared block cache is set read through it.
+        // Blocks of mapped tables aren't cached, so its usage isn't checked.
+        SetSharedDBBlockCache(1 << 20);
+        {
+            CDBWrapper dbw1(fs::temp_directory_path() / fs::unique_path(), (1 << 20), false, true, false);
+            CDBWrapper dbw2(fs::temp_directory_path() / fs::unique_path(), (1 << 20), false, true, true);
+            std::vector<uint256> vIn;
+            for (int i = 0; i < 100; i++) {
+                vIn.push_back(InsecureRand256());
+                BOOST_CHECK(dbw1.Write(i, vIn.back()));
+                BOOST_CHECK(dbw2.Write(i, vIn.back()));
+            }
+            // Move the values from the write buffer into tables
+            dbw1.CompactRange(0, 100);
+            dbw2.CompactRange(0, 100);
+
+            // Replacing the cache leaves the open databases with the old one
+            SetSharedDBBlockCache(0);
+            BOOST_CHECK_EQUAL(GetSharedDBBlockCacheUsage(), 0U);
+            uint256 res1, res2;
+            for (int i = 0; i < 100; i++) {
+                BOOST_CHECK(dbw1.Read(i, res1) && dbw2.Read(i, res2));
+                BOOST_CHECK(res1 == vIn[i] && res2 == vIn[i]);
+            }
+        }
+    }
+
 // Test batch operations
     BOOST_AUTO_TEST_CASE(dbwrapper_batch_test)
     {
@@ -85,6 +115,80 @@ BOOST_FIXTURE_TEST_SUITE(dbwrapper_tests, BasicTestingSetup)
         }
     }
 
+// Test writes queued for one atomic commit
+    BOOST_AUTO_TEST_CASE(dbwrapper_deferred_test)
+    {
+        for (bool obfuscate : {false, true})
+        {
+            fs::path ph = fs::temp_directory_path() / fs::unique_path();
+            CDBWrapper dbw(ph, (1 << 20), true, false, obfuscate);
+
+            uint256 in = InsecureRand256();
+            uint256 in2 = InsecureRand256();
+            uint256 res;
+            BOOST_CHECK(dbw.Write('a', in));
+            BOOST_CHECK(!dbw.ReadFlushMarker(res));
+
+            dbw.BeginDeferred();
+            BOOST_CHECK(dbw.Write('a', in2));
+            BOOST_CHECK(dbw.Write('b', in));
+            BOOST_CHECK(dbw.Erase('b'));
+            BOOST_CHECK(dbw.Write('c', in));
+            BOOST_CHECK(dbw.WriteFlushMarker(in2));
+
+            // Reads see the queued changes, a snapshot taken now does not
+            std::shared_ptr<const CDBSnapshot> snapshot = dbw.GetSnapshot();
+            BOOST_CHECK(dbw.Read('a', res));
+            BOOST_CHECK_EQUAL(res.ToString(), in2.ToString());
+            BOOST_CHECK(!dbw.Exists('b'));
+            BOOST_CHECK(dbw.Exists('c'));
+            BOOST_CHECK(dbw.Read('a', res, snapshot.get()));
+            BOOST_CHECK_EQUAL(res.ToString(), in.ToString());
+            BOOST_CHECK(!dbw.Exists('c', snapshot.get()));
+
+            BOOST_CHECK(dbw.CommitDeferred());
+            BOOST_CHECK(dbw.Read('a', res));
+            BOOST_CHECK_EQUAL(res.ToString(), in2.ToString());
+            BOOST_CHECK(!dbw.Exists('b'));
+            BOOST_CHECK(dbw.Exists('c'));
+            BOOST_CHECK(dbw.ReadFlushMarker(res));
+            BOOST_CHECK_EQUAL(res.ToString(), in2.ToString());
+
+            // Discarded changes never reach the database
+            dbw.BeginDeferred();
+            BOOST_CHECK(dbw.Erase('a'));
+            BOOST_CHECK(!dbw.Exists('a'));
+            dbw.DiscardDeferred();
+            BOOST_CHECK(dbw.Read('a', res));
+            BOOST_CHECK_EQUAL(res.ToString(), in2.ToString());
+        }
+    }
+
+// Test databases opened with the non-default profiles
+    BOOST_AUTO_TEST_CASE(dbwrapper_profile_test)
+    {
+        CDBProfile profile;
+        std::string strError;
+        BOOST_CHECK(GetDBProfile("chainstate", profile, strError));
+        BOOST_CHECK(!profile.fCompress);
+        BOOST_CHECK_EQUAL(profile.nBloomBits, 10);
+        BOOST_CHECK(GetDBProfile("index", profile, strError));
+        BOOST_CHECK(profile.fCompress);
+        BOOST_CHECK_EQUAL(profile.nBlockSize, 16U << 10);
+
+        for (const char* name : {"index", "assetsnapshot"})
+        {
+            fs::path ph = fs::temp_directory_path() / fs::unique_path() / name;
+            CDBWrapper dbw(ph, (1 << 20), true, false, true);
+            for (int i = 0; i < 1000; i++)
+                BOOST_CHECK(dbw.Write(i, uint256S("ab")));
+            uint256 res;
+            BOOST_CHECK(dbw.Read(999, res));
+            BOOST_CHECK(res == uint256S("ab"));
+            BOOST_CHECK(!dbw.Exists(1000));
+        }
+    }
+
     BOOST_AUTO_TEST_CASE(dbwrapper_iterator_test)
     {
         BOOST_TEST_MESSAGE("Running dbWrapper Iterator Test");
@@ -360,5 +464,165 @@ BOOST_FIXTURE_TEST_SUITE(dbwrapper_tests, BasicTestingSetup)
         }
     }
 
+    BOOST_AUTO_TEST_CASE(address_index_cursor_test)
+    {
+        BOOST_TEST_MESSAGE("Running Address Index Cursor Test");
+
+        CBlockTreeDB db(1 << 20, true, true);
+        uint160 addrA(std::vector<unsigned char>(20, 0xaa)), addrB(std::vector<unsigned char>(20, 0xbb)), addrC(std::vector<unsigned char>(20, 0xcc));
+        std::vector<std::pair<CAddressIndexKey, CAmount> > vEntries;
+        for (int nHeight = 1; nHeight <= 20; nHeight++) {
+            vEntries.emplace_back(CAddressIndexKey(1, addrA, nHeight, 1, InsecureRand256(), 0, false), nHeight);
+            if (nHeight % 2 == 0)
+                vEntries.emplace_back(CAddressIndexKey(1, addrB, nHeight, 2, InsecureRand256(), nHeight, true), -nHeight);
+            if (nHeight % 5 == 0)
+                vEntries.emplace_back(CAddressIndexKey(2, addrB, "ASSET", nHeight, 3, InsecureRand256(), 300, false), 5);
+        }
+        // Not asked for
+        vEntries.emplace_back(CAddressIndexKey(1, addrC, 7, 1, InsecureRand256(), 0, false), 1);
+        BOOST_CHECK(db.WriteAddressIndex(vEntries));
+        std::vector<std::pair<uint160, int> > vAddresses = {{addrB, 1}, {addrA, 1}, {addrB, 2}};
+
+        // Test: every asset's entries of the addresses come merged in chain order.
+        std::vector<CAddressIndexKey> vAll;
+        for (CAddressIndexCursor cursor(db, vAddresses, ""); cursor.Valid(); cursor.Next()) {
+            if (!vAll.empty())
+                BOOST_CHECK(CAddressIndexCursor::Less(vAll.back(), cursor.GetKey()));
+            vAll.push_back(cursor.GetKey());
+        }
+        BOOST_CHECK_EQUAL(vAll.size(), 20U + 10U + 4U);
+
+        // Test: one asset and a height range.
+        size_t nCount = 0;
+        for (CAddressIndexCursor cursor(db, vAddresses, RVN, 5, 10); cursor.Valid(); cursor.Next()) {
+            BOOST_CHECK(cursor.GetKey().asset == RVN);
+            BOOST_CHECK(cursor.GetKey().blockHeight >= 5 && cursor.GetKey().blockHeight <= 10);
+            nCount++;
+        }
+        BOOST_CHECK_EQUAL(nCount, 6U + 3U);
+
+        // Test: resuming after an entry gives the rest of the walk.
+        for (size_t nPage : {1, 7, 33}) {
+            CAddressIndexCursor cursor(db, vAddresses, "", 0, 0, &vAll[nPage - 1]);
+            for (size_t i = nPage; i < vAll.size(); i++) {
+                BOOST_CHECK(cursor.Valid());
+                if (!cursor.Valid())
+                    break;
+                BOOST_CHECK(cursor.GetKey().txhash == vAll[i].txhash);
+                cursor.Next();
+            }
+            BOOST_CHECK(!cursor.Valid());
+        }
+    }
+
+    BOOST_AUTO_TEST_CASE(address_balance_rollup_test)
+    {
+        BOOST_TEST_MESSAGE("Running Address Balance Rollup Test");
+
+        CBlockTreeDB db(1 << 20, true, true);
+        uint160 addrA(std::vector<unsigned char>(20, 0xaa)), addrB(std::vector<unsigned char>(20, 0xbb));
+        std::vector<std::pair<CAddressIndexKey, CAmount> > vBlock1, vBlock2;
+        vBlock1.emplace_back(CAddressIndexKey(1, addrA, 1, 1, InsecureRand256(), 0, false), 50);
+        vBlock1.emplace_back(CAddressIndexKey(1, addrB, 1, 1, InsecureRand256(), 1, false), 20);
+        vBlock1.emplace_back(CAddressIndexKey(1, addrA, "ASSET", 1, 2, InsecureRand256(), 0, false), 7);
+        vBlock2.emplace_back(CAddressIndexKey(1, addrA, 2, 1, InsecureRand256(), 0, true), -50);
+        vBlock2.emplace_back(CAddressIndexKey(1, addrA, 2, 1, InsecureRand256(), 1, false), 30);
+        BOOST_CHECK(db.WriteAddressIndex(vBlock1));
+        BOOST_CHECK(db.WriteAddressIndex(vBlock2));
+
+        // Test: the rollup is the sum of the entries, received counts only credits.
+        CAddressBalanceValue value;
+        BOOST_CHECK(db.ReadAddressBalance(addrA, 1, RVN, value));
+        BOOST_CHECK_EQUAL(value.balance, 30);
+        BOOST_CHECK_EQUAL(value.received, 80);
+        std::vector<std::pair<std::string, CAddressBalanceValue> > vBalances;
+        BOOST_CHECK(db.ReadAddressBalances(addrA, 1, vBalances));
+        BOOST_CHECK_EQUAL(vBalances.size(), 2U);
+
+        // Test: writing a block again (as on replay) does not count it twice.
+        BOOST_CHECK(db.WriteAddressIndex(vBlock2));
+        BOOST_CHECK(db.ReadAddressBalance(addrA, 1, RVN, value));
+        BOOST_CHECK_EQUAL(value.balance, 30);
+
+        // Test: erasing a block takes it back out, and an emptied rollup is gone.
+        BOOST_CHECK(db.EraseAddressIndex(vBlock2));
+        BOOST_CHECK(db.EraseAddressIndex(vBlock2));
+        BOOST_CHECK(db.ReadAddressBalance(addrA, 1, RVN, value));
+        BOOST_CHECK_EQUAL(value.balance, 50);
+        BOOST_CHECK_EQUAL(value.received, 50);
+        BOOST_CHECK(db.EraseAddressIndex(vBlock1));
+        BOOST_CHECK(db.ReadAddressBalance(addrB, 1, RVN, value));
+        BOOST_CHECK(value.IsNull());
+
+        // Test: building from the index gives the same rollups.
+        BOOST_CHECK(db.WriteAddressIndex(vBlock1));
+        BOOST_CHECK(db.WriteAddressIndex(vBlock2));
+        BOOST_CHECK(db.BuildAddressBalances());
+        BOOST_CHECK(db.HaveAddressBalances());
+        BOOST_CHECK(db.ReadAddressBalance(addrA, 1, RVN, value));
+        BOOST_CHECK_EQUAL(value.balance, 30);
+        BOOST_CHECK_EQUAL(value.received, 80);
+        BOOST_CHECK(db.ReadAddressBalance(addrA, 1, "ASSET", value));
+        BOOST_CHECK_EQUAL(value.balance, 7);
+        BOOST_CHECK(db.ReadAddressBalance(addrB, 1, RVN, value));
+        BOOST_CHECK_EQUAL(value.balance, 20);
+    }
+
+    BOOST_AUTO_TEST_CASE(index_build_batch_test)
+    {
+        BOOST_TEST_MESSAGE("Running Index Build Batch Test");
+
+        CBlockTreeDB db(1 << 20, true, true);
+        uint160 addr(std::vector<unsigned char>(20, 0xcc));
+        uint256 txA = InsecureRand256(), txB = InsecureRand256();
+
+        // An output created and spent within one batch ends up out of the unspent index
+        CIndexBuildBatch batch;
+        batch.vAddressIndex.emplace_back(CAddressIndexKey(1, addr, 1, 1, txA, 0, false), 40);
+        batch.vAddressIndex.emplace_back(CAddressIndexKey(1, addr, 1, 1, txA, 1, false), 2);
+        batch.vAddressUnspent.emplace_back(CAddressUnspentKey(1, addr, txA, 0), CAddressUnspentValue(40, CScript(), 1));
+        batch.vAddressUnspent.emplace_back(CAddressUnspentKey(1, addr, txA, 1), CAddressUnspentValue(2, CScript(), 1));
+        batch.vAddressIndex.emplace_back(CAddressIndexKey(1, addr, 2, 1, txB, 0, true), -40);
+        batch.vAddressUnspent.emplace_back(CAddressUnspentKey(1, addr, txA, 0), CAddressUnspentValue());
+        batch.vSpentIndex.emplace_back(CSpentIndexKey(txA, 0), CSpentIndexValue(txB, 0, 2, 40, 1, addr));
+        batch.vTimestamps.emplace_back(InsecureRand256(), 1000);
+
+        CIndexBuildState state;
+        state.nIndexes = INDEX_BUILD_ADDRESS | INDEX_BUILD_SPENT | INDEX_BUILD_TIMESTAMP;
+        state.hashBlock = InsecureRand256();
+        state.nLogicalTS = 1000;
+        BOOST_CHECK(db.WriteIndexBuildBatch(batch, state, false));
+
+        // Test: the state is written with the entries, and the indexes are not yet on.
+        CIndexBuildState stateRead;
+        BOOST_CHECK(db.ReadIndexBuild(stateRead));
+        BOOST_CHECK_EQUAL(stateRead.nIndexes, state.nIndexes);
+        BOOST_CHECK(stateRead.hashBlock == state.hashBlock);
+        BOOST_CHECK_EQUAL(stateRead.nLogicalTS, 1000U);
+        bool fValue = true;
+        BOOST_CHECK(!db.ReadFlag("addressindex", fValue) || !fValue);
+
+        std::vector<std::pair<CAddressUnspentKey, CAddressUnspentValue> > vUnspent;
+        BOOST_CHECK(db.ReadAddressUnspentIndex(addr, 1, RVN, vUnspent));
+        BOOST_REQUIRE_EQUAL(vUnspent.size(), 1U);
+        BOOST_CHECK_EQUAL(vUnspent[0].first.index, 1U);
+        CSpentIndexKey spentKey(txA, 0);
+        CSpentIndexValue spentValue;
+        BOOST_CHECK(db.ReadSpentIndex(spentKey, spentValue));
+        BOOST_CHECK(spentValue.txid == txB);
+        CAddressBalanceValue balance;
+        BOOST_CHECK(db.ReadAddressBalance(addr, 1, RVN, balance));
+        BOOST_CHECK_EQUAL(balance.balance, 2);
+
+        // Test: the last batch turns the indexes on and drops the state.
+        batch.Clear();
+        BOOST_CHECK_EQUAL(batch.Count(), 0U);
+        BOOST_CHECK(db.WriteIndexBuildBatch(batch, state, true));
+        BOOST_CHECK(!db.ReadIndexBuild(stateRead));
+        BOOST_CHECK(db.ReadFlag("addressindex", fValue) && fValue);
+        BOOST_CHECK(db.ReadFlag("spentindex", fValue) && fValue);
+        BOOST_CHECK(db.ReadFlag("timestampindex", fValue) && fValue);
+    }
+
 
 BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,89 @@
+// Copyright (c) 2026 The Mynta Core Developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include "dextradeindex.h"
+
+#include "test/test_mynta.h"
+
+#include <limits>
+
+#include <boost/test/unit_test.hpp>
+
+BOOST_FIXTURE_TEST_SUITE(dextradeindex_tests, BasicTestingSetup)
+
+static CDexSwapLeg MakeLeg(const std::string& strAsset, CAmount nAmount)
+{
+    CDexSwapLeg leg;
+    leg.strAsset = strAsset;
+    leg.nAmount = nAmount;
+    return leg;
+}
+
+static CDexTrade MakeTrade(CAmount nBaseAmount, CAmount nQuoteAmount, uint32_t nTime, int nHeight, uint32_t nOrder)
+{
+    CDexTrade trade;
+    BOOST_REQUIRE(CDexTrade::FromLegs(MakeLeg("MYNTA", nBaseAmount), MakeLeg("TOKEN", nQuoteAmount), trade));
+    trade.nTime = nTime;
+    trade.nHeight = nHeight;
+    trade.nOrder = nOrder;
+    return trade;
+}
+
+BOOST_AUTO_TEST_CASE(dextrade_from_legs)
+{
+    // Test: the pair is ordered by name whichever leg was claimed first.
+    CDexTrade trade;
+    BOOST_CHECK(CDexTrade::FromLegs(MakeLeg("TOKEN", 300 * COIN), MakeLeg("MYNTA", 100 * COIN), trade));
+    BOOST_CHECK_EQUAL(trade.strBase, "MYNTA");
+    BOOST_CHECK_EQUAL(trade.strQuote, "TOKEN");
+    BOOST_CHECK_EQUAL(trade.nBaseAmount, 100 * COIN);
+    BOOST_CHECK_EQUAL(trade.nQuoteAmount, 300 * COIN);
+    BOOST_CHECK_EQUAL(trade.GetPrice(), 3 * COIN);
+
+    // Test: two legs of one asset aren't a trade.
+    BOOST_CHECK(!CDexTrade::FromLegs(MakeLeg("TOKEN", COIN), MakeLeg("TOKEN", 2 * COIN), trade));
+
+    // Test: the price doesn't overflow for large amounts.
+    BOOST_CHECK(CDexTrade::FromLegs(MakeLeg("A", 1), MakeLeg("B", MAX_MONEY), trade));
+    BOOST_CHECK_EQUAL(trade.GetPrice(), std::numeric_limits<CAmount>::max());
+    BOOST_CHECK(CDexTrade::FromLegs(MakeLeg("A", 3 * COIN), MakeLeg("B", COIN), trade));
+    BOOST_CHECK_EQUAL(trade.GetPrice(), COIN / 3);
+}
+
+BOOST_AUTO_TEST_CASE(dexcandle_add_any_order)
+{
+    BOOST_CHECK_EQUAL(CDexCandle::BucketStart(3725, 60), 3720U);
+    BOOST_CHECK_EQUAL(CDexCandle::BucketStart(3725, 3600), 3600U);
+
+    std::vector<CDexTrade> vTrades;
+    vTrades.push_back(MakeTrade(COIN, 2 * COIN, 3600, 10, 0));
+    vTrades.push_back(MakeTrade(COIN, 5 * COIN, 3610, 11, 0));
+    vTrades.push_back(MakeTrade(2 * COIN, 2 * COIN, 3610, 11, 1));
+    vTrades.push_back(MakeTrade(COIN, 3 * COIN, 3650, 12, 0));
+
+    // Test: adding the trades newest first, as a reorg recomputes a candle, gives the same candle.
+    CDexCandle forward, backward;
+    for (const CDexTrade& trade : vTrades)
+        forward.Add(trade);
+    for (auto it = vTrades.rbegin(); it != vTrades.rend(); ++it)
+        backward.Add(*it);
+    for (const CDexCandle* candle : {&forward, &backward}) {
+        BOOST_CHECK_EQUAL(candle->nOpen, 2 * COIN);
+        BOOST_CHECK_EQUAL(candle->nHigh, 5 * COIN);
+        BOOST_CHECK_EQUAL(candle->nLow, COIN);
+        BOOST_CHECK_EQUAL(candle->nClose, 3 * COIN);
+        BOOST_CHECK_EQUAL(candle->nBaseVolume, 5 * COIN);
+        BOOST_CHECK_EQUAL(candle->nQuoteVolume, 12 * COIN);
+        BOOST_CHECK_EQUAL(candle->nTrades, 4U);
+    }
+
+    // Test: of two trades at the same time, the one connected later closes the bucket.
+    CDexCandle sameTime;
+    sameTime.Add(vTrades[2]);
+    sameTime.Add(vTrades[1]);
+    BOOST_CHECK_EQUAL(sameTime.nOpen, 5 * COIN);
+    BOOST_CHECK_EQUAL(sameTime.nClose, COIN);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
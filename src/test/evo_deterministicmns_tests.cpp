@@ -2,10 +2,17 @@
 // Distributed under the MIT software license, see the accompanying
 // file COPYING or http://www.opensource.org/licenses/mit-license.php.
 
+#include "arith_uint256.h"
+#include "chain.h"
+#include "consensus/validation.h"
 #include "evo/deterministicmns.h"
 #include "evo/providertx.h"
 #include "evo/evodb.h"
+#include "evo/specialtx.h"
 #include "hash.h"
+#include "key.h"
+#include "netbase.h"
+#include "primitives/block.h"
 #include "test/test_mynta.h"
 #include "uint256.h"
 
@@ -121,13 +128,13 @@ BOOST_AUTO_TEST_CASE(deterministicmnlist_operations)
     mn1->proTxHash = uint256S("1111111111111111111111111111111111111111111111111111111111111111");
     mn1->collateralOutpoint = COutPoint(uint256S("aaaa"), 0);
     mn1->state.nRegisteredHeight = 100;
-    mn1->state.addr = CService("192.168.1.1:8770");
+    mn1->state.addr = LookupNumeric("192.168.1.1", 8770);
     
     auto mn2 = std::make_shared<CDeterministicMN>();
     mn2->proTxHash = uint256S("2222222222222222222222222222222222222222222222222222222222222222");
     mn2->collateralOutpoint = COutPoint(uint256S("bbbb"), 0);
     mn2->state.nRegisteredHeight = 101;
-    mn2->state.addr = CService("192.168.1.2:8770");
+    mn2->state.addr = LookupNumeric("192.168.1.2", 8770);
     
     // Add MNs
     CDeterministicMNList list1 = list.AddMN(mn1);
@@ -193,8 +200,8 @@ BOOST_AUTO_TEST_CASE(deterministicmnlist_unique_properties)
     auto mn1 = std::make_shared<CDeterministicMN>();
     mn1->proTxHash = uint256S("1111111111111111111111111111111111111111111111111111111111111111");
     mn1->collateralOutpoint = COutPoint(uint256S("aaaa"), 0);
-    mn1->state.addr = CService("192.168.1.1:8770");
-    mn1->state.keyIDOwner = CKeyID(uint160S("0123456789abcdef0123456789abcdef01234567"));
+    mn1->state.addr = LookupNumeric("192.168.1.1", 8770);
+    mn1->state.keyIDOwner = CKeyID(uint160(ParseHex("0123456789abcdef0123456789abcdef01234567")));
     
     list = list.AddMN(mn1);
     
@@ -208,6 +215,59 @@ BOOST_AUTO_TEST_CASE(deterministicmnlist_unique_properties)
     BOOST_CHECK(!list.HasUniqueProperty(list.GetUniquePropertyHash(nonExistent)));
 }
 
+BOOST_AUTO_TEST_CASE(deterministicmnlist_collateral_index)
+{
+    CDeterministicMNList list(uint256(), 0);
+    BOOST_CHECK(!list.MayBeCollateral(COutPoint(uint256S("aaaa"), 0)));
+
+    std::vector<CDeterministicMNCPtr> mns;
+    for (int i = 0; i < 20; i++) {
+        auto mn = std::make_shared<CDeterministicMN>();
+        mn->proTxHash = ArithToUint256(arith_uint256(i + 1));
+        mn->collateralOutpoint = COutPoint(ArithToUint256(arith_uint256(1000 + i)), i % 2);
+        mn->state.addr = LookupNumeric(strprintf("10.0.0.%d", i + 1).c_str(), 8770);
+        list = list.AddMN(mn);
+        mns.push_back(mn);
+    }
+
+    // Every collateral and service is found, an unknown outpoint is not
+    for (const auto& mn : mns) {
+        BOOST_CHECK(list.MayBeCollateral(mn->collateralOutpoint));
+        BOOST_CHECK(list.GetMNByCollateral(mn->collateralOutpoint) == mn);
+        BOOST_CHECK(list.GetMNByService(mn->state.addr) == mn);
+    }
+    BOOST_CHECK(list.GetMNByCollateral(COutPoint(mns[0]->collateralOutpoint.hash, 7)) == nullptr);
+    BOOST_CHECK(list.GetMNByService(LookupNumeric("10.0.1.1", 8770)) == nullptr);
+
+    // Updates are seen through the index, the parent list keeps the old entry
+    CDeterministicMNState newState = mns[3]->state;
+    newState.nLastPaidHeight = 50;
+    newState.addr = LookupNumeric("10.0.2.1", 8770);
+    CDeterministicMNList list2 = list.UpdateMN(mns[3]->proTxHash, newState);
+    BOOST_CHECK_EQUAL(list2.GetMNByCollateral(mns[3]->collateralOutpoint)->state.nLastPaidHeight, 50);
+    BOOST_CHECK(list2.GetMNByService(newState.addr) != nullptr);
+    BOOST_CHECK(list2.GetMNByService(mns[3]->state.addr) == nullptr);
+    BOOST_CHECK(list.GetMNByCollateral(mns[3]->collateralOutpoint) == mns[3]);
+
+    // Removed collaterals are gone from the filter and the index
+    CDeterministicMNList list3 = list2.RemoveMN(mns[5]->proTxHash);
+    BOOST_CHECK(list3.GetMNByCollateral(mns[5]->collateralOutpoint) == nullptr);
+    BOOST_CHECK(list3.GetMNByCollateral(mns[6]->collateralOutpoint) == mns[6]);
+    BOOST_CHECK(list2.GetMNByCollateral(mns[5]->collateralOutpoint) == mns[5]);
+
+    // Both are rebuilt when a list is deserialized
+    CDataStream ss(SER_DISK, PROTOCOL_VERSION);
+    ss << list3;
+    CDeterministicMNList list4;
+    ss >> list4;
+    BOOST_CHECK(list4.GetMNByCollateral(mns[5]->collateralOutpoint) == nullptr);
+    for (size_t i = 0; i < mns.size(); i++) {
+        if (i == 5) continue;
+        auto mn = list4.GetMNByCollateral(mns[i]->collateralOutpoint);
+        BOOST_CHECK(mn && mn->proTxHash == mns[i]->proTxHash);
+    }
+}
+
 BOOST_AUTO_TEST_CASE(deterministicmnlist_payment_selection)
 {
     CDeterministicMNList list(uint256(), 100);
@@ -227,21 +287,251 @@ BOOST_AUTO_TEST_CASE(deterministicmnlist_payment_selection)
     
     BOOST_CHECK_EQUAL(list.GetValidMNsCount(), 5);
     
-    // Get payee for a block
-    uint256 blockHash = uint256S("abcd1234abcd1234abcd1234abcd1234abcd1234abcd1234abcd1234abcd1234");
-    auto payee = list.GetMNPayee(blockHash);
-    
+    // Nobody has been paid yet, so the queue is ordered by proTxHash
+    auto payee = list.GetMNPayee();
     BOOST_CHECK(payee != nullptr);
+    BOOST_CHECK(payee->proTxHash == mns[0]->proTxHash);
     
-    // Payee should be deterministic - same block hash should give same payee
-    auto payee2 = list.GetMNPayee(blockHash);
+    // Payee should be deterministic
+    auto payee2 = list.GetMNPayee();
     BOOST_CHECK(payee->proTxHash == payee2->proTxHash);
     
-    // Different block should give different payee (usually, depending on hash)
-    uint256 blockHash2 = uint256S("1234abcd1234abcd1234abcd1234abcd1234abcd1234abcd1234abcd1234abcd");
-    auto payee3 = list.GetMNPayee(blockHash2);
-    BOOST_CHECK(payee3 != nullptr);
-    // Note: They might be the same by chance, so we don't assert they're different
+    // Once paid, an MN moves to the back of the queue
+    CDeterministicMNState paidState = payee->state;
+    paidState.nLastPaidHeight = 101;
+    list = list.UpdateMN(payee->proTxHash, paidState);
+    BOOST_CHECK(list.GetMNPayee()->proTxHash == mns[1]->proTxHash);
+    
+    auto projected = list.GetProjectedMNPayees(7);
+    BOOST_CHECK_EQUAL(projected.size(), 7U);
+    BOOST_CHECK(projected[0]->proTxHash == mns[1]->proTxHash);
+    BOOST_CHECK(projected[3]->proTxHash == mns[4]->proTxHash);
+    BOOST_CHECK(projected[4]->proTxHash == mns[0]->proTxHash);
+    BOOST_CHECK(projected[5]->proTxHash == mns[1]->proTxHash);
+    
+    // Banned MNs leave the queue
+    CDeterministicMNState bannedState = mns[1]->state;
+    bannedState.nPoSeBanHeight = 102;
+    list = list.UpdateMN(mns[1]->proTxHash, bannedState);
+    BOOST_CHECK_EQUAL(list.GetValidMNsCount(), 4U);
+    BOOST_CHECK(list.GetMNPayee()->proTxHash == mns[2]->proTxHash);
+    
+    // The queue is rebuilt when a list is deserialized
+    CDataStream ss(SER_DISK, PROTOCOL_VERSION);
+    ss << list;
+    CDeterministicMNList list2;
+    ss >> list2;
+    BOOST_CHECK_EQUAL(list2.GetValidMNsCount(), 4U);
+    BOOST_CHECK(list2.GetMNPayee()->proTxHash == mns[2]->proTxHash);
+}
+
+BOOST_AUTO_TEST_CASE(deterministicmnlist_diff_roundtrip)
+{
+    CDeterministicMNList list(uint256S("01"), 100);
+    
+    std::vector<CDeterministicMNCPtr> mns;
+    for (int i = 1; i <= 4; i++) {
+        auto mn = std::make_shared<CDeterministicMN>();
+        mn->proTxHash = ArithToUint256(arith_uint256(i));
+        mn->collateralOutpoint = COutPoint(ArithToUint256(arith_uint256(i + 100)), 0);
+        mn->state.addr = LookupNumeric(strprintf("192.168.1.%d", i).c_str(), 8770);
+        mns.push_back(mn);
+        list = list.AddMN(mn);
+    }
+    
+    // Next block: one added, one updated, one removed
+    CDeterministicMNList next = list;
+    next.SetBlockHash(uint256S("02"));
+    next.SetHeight(101);
+    
+    auto mn5 = std::make_shared<CDeterministicMN>();
+    mn5->proTxHash = ArithToUint256(arith_uint256(5));
+    mn5->state.addr = LookupNumeric("192.168.1.5", 8770);
+    next = next.AddMN(mn5);
+    
+    CDeterministicMNState newState = mns[1]->state;
+    newState.nLastPaidHeight = 101;
+    newState.addr = LookupNumeric("10.0.0.2", 8770);
+    next = next.UpdateMN(mns[1]->proTxHash, newState);
+    next = next.RemoveMN(mns[2]->proTxHash);
+    
+    CDeterministicMNListDiff diff = list.BuildDiff(next);
+    BOOST_CHECK(diff.HasChanges());
+    BOOST_CHECK_EQUAL(diff.addedMNs.size(), 1U);
+    BOOST_CHECK_EQUAL(diff.updatedMNs.size(), 1U);
+    BOOST_CHECK_EQUAL(diff.removedMns.size(), 1U);
+    
+    // Round trip through serialization as stored in the evo db
+    CDataStream ss(SER_DISK, PROTOCOL_VERSION);
+    ss << diff;
+    CDeterministicMNListDiff diff2;
+    ss >> diff2;
+    
+    CDeterministicMNList rebuilt = list.ApplyDiff(diff2);
+    BOOST_CHECK(rebuilt.GetBlockHash() == next.GetBlockHash());
+    BOOST_CHECK_EQUAL(rebuilt.GetHeight(), next.GetHeight());
+    BOOST_CHECK_EQUAL(rebuilt.GetTotalRegisteredCount(), next.GetTotalRegisteredCount());
+    BOOST_CHECK_EQUAL(rebuilt.GetAllMNsCount(), next.GetAllMNsCount());
+    for (const auto& pair : next.GetMnMap()) {
+        auto mn = rebuilt.GetMN(pair.first);
+        BOOST_CHECK(mn != nullptr);
+        BOOST_CHECK(mn->state == pair.second->state);
+    }
+    
+    // Unique property index follows the diff
+    BOOST_CHECK(rebuilt.GetMNByService(LookupNumeric("10.0.0.2", 8770)) != nullptr);
+    BOOST_CHECK(!rebuilt.HasUniqueProperty(rebuilt.GetUniquePropertyHash(mns[1]->state.addr)));
+    BOOST_CHECK(!rebuilt.HasUniqueProperty(rebuilt.GetUniquePropertyHash(mns[2]->collateralOutpoint)));
+    
+    // Identical lists produce an empty diff
+    BOOST_CHECK(!next.BuildDiff(rebuilt).HasChanges());
+}
+
+BOOST_AUTO_TEST_CASE(deterministicmnlist_memory_usage)
+{
+    CDeterministicMNList list(uint256S("01"), 100);
+    for (int i = 1; i <= 200; i++) {
+        auto mn = std::make_shared<CDeterministicMN>();
+        mn->proTxHash = ArithToUint256(arith_uint256(i));
+        mn->collateralOutpoint = COutPoint(ArithToUint256(arith_uint256(i + 1000)), 0);
+        mn->state.addr = LookupNumeric(strprintf("10.0.%d.%d", i / 256, i % 256).c_str(), 8770);
+        list = list.AddMN(mn);
+    }
+
+    size_t nFullUsage = list.GetMemoryUsage();
+    BOOST_CHECK(nFullUsage > 200 * sizeof(CDeterministicMN));
+
+    // A list one change away from its parent only pays for the copied paths
+    BOOST_CHECK(list.GetIncrementalMemoryUsage(0) < list.GetIncrementalMemoryUsage(1));
+    BOOST_CHECK(list.GetIncrementalMemoryUsage(1) * 20 < nFullUsage);
+}
+
+BOOST_AUTO_TEST_CASE(protx_signature_checks_deferred)
+{
+    CKey ownerKey;
+    ownerKey.MakeNewKey(true);
+
+    CMutableTransaction tx;
+    tx.nVersion = 3;
+    tx.nType = static_cast<uint16_t>(TxType::TRANSACTION_PROVIDER_REGISTER);
+    tx.vin.emplace_back(COutPoint(uint256S("01"), 0));
+
+    CProRegTx proTx;
+    proTx.addr = LookupNumeric("1.2.3.4", 10226);
+    proTx.keyIDOwner = ownerKey.GetPubKey().GetID();
+    proTx.vchOperatorPubKey.assign(48, 1);
+    proTx.scriptPayout = GetScriptForDestination(proTx.keyIDOwner);
+    CHashWriter hw(SER_GETHASH, PROTOCOL_VERSION);
+    hw << tx.vin[0].prevout;
+    proTx.inputsHash = hw.GetHash();
+    BOOST_CHECK(ownerKey.SignCompact(proTx.GetSignatureHash(), proTx.vchSig));
+    SetTxPayload(tx, proTx);
+
+    CValidationState state;
+    BOOST_CHECK(CheckProRegTx(CTransaction(tx), nullptr, state));
+
+    // A bad signature fails inline, but is only queued when checks are deferred
+    proTx.vchSig[10] ^= 1;
+    SetTxPayload(tx, proTx);
+    BOOST_CHECK(!CheckProRegTx(CTransaction(tx), nullptr, state));
+    BOOST_CHECK_EQUAL(state.GetRejectReason(), "bad-protx-sig");
+
+    std::vector<CProviderSigCheck> vChecks;
+    CValidationState deferredState;
+    BOOST_CHECK(CheckSpecialTx(CTransaction(tx), nullptr, deferredState, &vChecks));
+    BOOST_CHECK_EQUAL(vChecks.size(), 1U);
+    BOOST_CHECK(!vChecks[0]());
+}
+
+BOOST_AUTO_TEST_CASE(evodb_object_cache)
+{
+    CEvoDB db(1 << 20, true, true, 4096);
+    const auto key1 = std::make_pair(std::string("k"), uint256S("01"));
+    const auto key2 = std::make_pair(std::string("k"), uint256S("02"));
+    int nValue = 0;
+
+    // Reads see the writes of the open transaction, and nothing of one rolled back
+    db.BeginTransaction();
+    db.Write(key1, 1);
+    BOOST_CHECK(db.Read(key1, nValue));
+    BOOST_CHECK_EQUAL(nValue, 1);
+    db.RollbackTransaction();
+    BOOST_CHECK(!db.Exists(key1));
+    BOOST_CHECK(!db.Read(key1, nValue));
+
+    db.BeginTransaction();
+    db.Write(key1, 2);
+    db.Write(key2, 3);
+    db.Erase(key2);
+    BOOST_CHECK(!db.Exists(key2));
+    db.CommitTransaction();
+    BOOST_CHECK(db.Read(key1, nValue));
+    BOOST_CHECK_EQUAL(nValue, 2);
+    BOOST_CHECK(!db.Read(key2, nValue));
+    BOOST_CHECK(db.GetRawDB().Read(key1, nValue));
+    BOOST_CHECK_EQUAL(nValue, 2);
+
+    // Read as another type, the object goes through its serialization
+    int64_t nValue64 = 0;
+    db.Write(key1, int64_t(5));
+    BOOST_CHECK(db.Read(key1, nValue64));
+    BOOST_CHECK_EQUAL(nValue64, 5);
+    auto pvalue = db.ReadShared<int64_t>(key1);
+    BOOST_CHECK(pvalue && *pvalue == 5);
+
+    // The cache stays in its bound, and what it drops is read back from the database
+    for (int i = 0; i < 200; i++) {
+        db.Write(std::make_pair(std::string("n"), i), std::string(100, 'a' + i % 26));
+    }
+    BOOST_CHECK(db.GetCacheSize() <= 4096);
+    BOOST_CHECK(db.GetCacheCount() < 200);
+    std::string str;
+    BOOST_CHECK(db.Read(std::make_pair(std::string("n"), 0), str));
+    BOOST_CHECK_EQUAL(str, std::string(100, 'a'));
+}
+
+BOOST_AUTO_TEST_CASE(deterministicmnmanager_height_index)
+{
+    CEvoDB db(1 << 20, true, true);
+    CDeterministicMNManager manager(db);
+    manager.Init();
+
+    // A chain of empty blocks, longer than the height index
+    const size_t nBlocks = MNLIST_HEIGHT_INDEX_SIZE + 10;
+    std::vector<uint256> vHashes(nBlocks);
+    std::vector<CBlockIndex> vIndex(nBlocks);
+    CBlock block;
+    CValidationState state;
+    for (size_t i = 0; i < nBlocks; i++) {
+        vHashes[i] = ArithToUint256(arith_uint256(i + 1));
+        vIndex[i].phashBlock = &vHashes[i];
+        vIndex[i].nHeight = i;
+        vIndex[i].pprev = i ? &vIndex[i - 1] : nullptr;
+        BOOST_CHECK(manager.ProcessBlock(block, &vIndex[i], state, false));
+    }
+
+    // Recent blocks are served from the index, older ones from the cache
+    uint64_t nIndexHits = manager.GetCacheStats().nIndexHits;
+    BOOST_CHECK(manager.GetListForBlock(&vIndex.back())->GetBlockHash() == vHashes.back());
+    BOOST_CHECK(manager.GetListForBlock(&vIndex[nBlocks - MNLIST_HEIGHT_INDEX_SIZE])->GetBlockHash() == vHashes[nBlocks - MNLIST_HEIGHT_INDEX_SIZE]);
+    BOOST_CHECK_EQUAL(manager.GetCacheStats().nIndexHits, nIndexHits + 2);
+    BOOST_CHECK(manager.GetListForBlock(&vIndex[0])->GetBlockHash() == vHashes[0]);
+    BOOST_CHECK_EQUAL(manager.GetCacheStats().nIndexHits, nIndexHits + 2);
+
+    // After a reorg the block replacing the tip gets its own list, and the
+    // disconnected one is no longer answered from the index
+    BOOST_CHECK(manager.UndoBlock(block, &vIndex.back()));
+    uint256 hashFork = ArithToUint256(arith_uint256(nBlocks + 100));
+    CBlockIndex indexFork;
+    indexFork.phashBlock = &hashFork;
+    indexFork.nHeight = vIndex.back().nHeight;
+    indexFork.pprev = &vIndex[nBlocks - 2];
+    BOOST_CHECK(manager.ProcessBlock(block, &indexFork, state, false));
+    nIndexHits = manager.GetCacheStats().nIndexHits;
+    BOOST_CHECK(manager.GetListForBlock(&indexFork)->GetBlockHash() == hashFork);
+    BOOST_CHECK_EQUAL(manager.GetCacheStats().nIndexHits, nIndexHits + 1);
+    manager.GetListForBlock(&vIndex.back());
+    BOOST_CHECK_EQUAL(manager.GetCacheStats().nIndexHits, nIndexHits + 1);
 }
 
 BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,121 @@
+// Copyright (c) 2026 The Mynta Core Developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include "flatmap.h"
+#include "memusage.h"
+#include "random.h"
+
+#include "test/test_mynta.h"
+
+#include <map>
+#include <string>
+
+#include <boost/test/unit_test.hpp>
+
+BOOST_FIXTURE_TEST_SUITE(flatmap_tests, BasicTestingSetup)
+
+template <typename K, typename V>
+static bool MapsEqual(const flatmap<K, V>& fm, const std::map<K, V>& m)
+{
+    if (fm.size() != m.size()) {
+        return false;
+    }
+    size_t n = 0;
+    for (const auto& kv : fm) {
+        auto it = m.find(kv.first);
+        if (it == m.end() || it->second != kv.second) {
+            return false;
+        }
+        n++;
+    }
+    return n == m.size();
+}
+
+BOOST_AUTO_TEST_CASE(flatmap_matches_std_map)
+{
+    FastRandomContext ctx(true);
+    flatmap<int, std::string> fm;
+    std::map<int, std::string> m;
+
+    for (int i = 0; i < 20000; i++) {
+        int k = ctx.randrange(2000);
+        switch (ctx.randrange(4)) {
+        case 0: {
+            std::string v(ctx.randrange(40), 'a' + ctx.randrange(26));
+            fm[k] = v;
+            m[k] = v;
+            break;
+        }
+        case 1: {
+            bool fInserted = fm.emplace(k, "x").second;
+            BOOST_CHECK_EQUAL(fInserted, m.emplace(k, "x").second);
+            break;
+        }
+        default:
+            BOOST_CHECK_EQUAL(fm.erase(k), m.erase(k));
+        }
+        BOOST_CHECK_EQUAL(fm.count(k), m.count(k));
+    }
+    BOOST_CHECK(MapsEqual(fm, m));
+    BOOST_CHECK(fm.find(5000) == fm.end());
+
+    fm.clear();
+    BOOST_CHECK(fm.empty());
+    BOOST_CHECK(fm.begin() == fm.end());
+    BOOST_CHECK_EQUAL(memusage::DynamicUsage(fm), 0U);
+}
+
+BOOST_AUTO_TEST_CASE(flatmap_entries_do_not_move)
+{
+    flatmap<int, int> fm;
+    std::vector<const int*> vRefs;
+    for (int i = 0; i < 10000; i++) {
+        vRefs.push_back(&fm.emplace(i, i * 2).first->second);
+    }
+    for (int i = 0; i < 10000; i++) {
+        BOOST_CHECK_EQUAL(*vRefs[i], i * 2);
+        BOOST_CHECK(&fm.find(i)->second == vRefs[i]);
+    }
+
+    // Erased entries are reused before new chunks are allocated
+    const size_t nChunks = fm.chunk_count();
+    for (int i = 0; i < 10000; i += 2) {
+        fm.erase(i);
+    }
+    for (int i = 0; i < 5000; i++) {
+        fm.emplace(20000 + i, i);
+    }
+    BOOST_CHECK_EQUAL(fm.chunk_count(), nChunks);
+    BOOST_CHECK_EQUAL(fm.size(), 10000U);
+}
+
+BOOST_AUTO_TEST_CASE(flatmap_erase_while_iterating)
+{
+    flatmap<int, int> fm;
+    for (int i = 0; i < 1000; i++) {
+        fm.emplace(i, i);
+    }
+
+    // Both ways the coins views erase while walking a map
+    for (auto it = fm.begin(); it != fm.end();) {
+        if (it->first % 3 == 0) {
+            it = fm.erase(it);
+        } else {
+            ++it;
+        }
+    }
+    BOOST_CHECK_EQUAL(fm.size(), 666U);
+    for (auto it = fm.begin(); it != fm.end();) {
+        auto itOld = it++;
+        if (itOld->first % 3 == 1) {
+            fm.erase(itOld);
+        }
+    }
+    BOOST_CHECK_EQUAL(fm.size(), 333U);
+    for (const auto& kv : fm) {
+        BOOST_CHECK_EQUAL(kv.first % 3, 2);
+    }
+}
+
+BOOST_AUTO_TEST_SUITE_END()
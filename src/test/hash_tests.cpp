@@ -49,6 +49,21 @@ BOOST_FIXTURE_TEST_SUITE(hash_tests, BasicTestingSetup)
 #undef T
     }
 
+    BOOST_AUTO_TEST_CASE(murmurhash3_multi)
+    {
+        // Every lane, including those of a partial last batch, matches MurmurHash3 under its seed
+        std::vector<unsigned char> vData;
+        for (unsigned int nLen = 0; nLen < 12; nLen++) {
+            for (unsigned int nHashes : {1u, MURMUR_HASH_LANES, MURMUR_HASH_LANES + 3}) {
+                std::vector<unsigned int> vHashes(nHashes);
+                MurmurHash3Multi(0x12345678, 0xFBA4C795, nHashes, vData.data(), vData.size(), vHashes.data());
+                for (unsigned int i = 0; i < nHashes; i++)
+                    BOOST_CHECK_EQUAL(vHashes[i], MurmurHash3(0x12345678 + i * 0xFBA4C795, vData));
+            }
+            vData.push_back(nLen * 37 + 11);
+        }
+    }
+
     /*
        SipHash-2-4 output with
        k = 00 01 02 ...
@@ -107,6 +122,41 @@ BOOST_FIXTURE_TEST_SUITE(hash_tests, BasicTestingSetup)
 
     };
 
+    BOOST_AUTO_TEST_CASE(x16r_stage_dispatch_test)
+    {
+        BOOST_TEST_MESSAGE("Running X16R Stage Dispatch Test");
+
+        // Whatever X16RAutoDetect picked must match the sph implementations
+        std::vector<unsigned char> in(400);
+        for (size_t i = 0; i < in.size(); i++)
+            in[i] = InsecureRandBits(8);
+
+        for (size_t len = 0; len <= in.size(); len++) {
+            unsigned char expected[64], actual[64];
+
+            sph_groestl512_context ctx_groestl;
+            sph_groestl512_init(&ctx_groestl);
+            sph_groestl512(&ctx_groestl, in.data(), len);
+            sph_groestl512_close(&ctx_groestl, expected);
+            x16rStages.groestl512(in.data(), len, actual);
+            BOOST_CHECK(memcmp(expected, actual, 64) == 0);
+
+            sph_shavite512_context ctx_shavite;
+            sph_shavite512_init(&ctx_shavite);
+            sph_shavite512(&ctx_shavite, in.data(), len);
+            sph_shavite512_close(&ctx_shavite, expected);
+            x16rStages.shavite512(in.data(), len, actual);
+            BOOST_CHECK(memcmp(expected, actual, 64) == 0);
+
+            sph_echo512_context ctx_echo;
+            sph_echo512_init(&ctx_echo);
+            sph_echo512(&ctx_echo, in.data(), len);
+            sph_echo512_close(&ctx_echo, expected);
+            x16rStages.echo512(in.data(), len, actual);
+            BOOST_CHECK(memcmp(expected, actual, 64) == 0);
+        }
+    }
+
     BOOST_AUTO_TEST_CASE(siphash_test)
     {
         BOOST_TEST_MESSAGE("Running SipHash Test");
@@ -3,6 +3,10 @@
 // file COPYING or http://www.opensource.org/licenses/mit-license.php.
 
 
+#include <arith_uint256.h>
+#include <epochcontext.h>
+#include <hash.h>
+#include <kawpowshares.h>
 #include <test/test_mynta.h>
 
 #include <boost/test/unit_test.hpp>
@@ -139,4 +143,75 @@ BOOST_AUTO_TEST_CASE(kawpow_search)
     BOOST_CHECK(sr.mix_hash == r.mix_hash);
 }
 
+BOOST_AUTO_TEST_CASE(kawpow_epoch_context_cache)
+{
+    CEpochContextCache cache;
+
+    // Contexts are built once per epoch and shared between callers
+    auto context = cache.GetForHeight(0);
+    BOOST_REQUIRE(context);
+    BOOST_CHECK_EQUAL(context->epoch_number, 0);
+    BOOST_CHECK(cache.GetForHeight(ethash::epoch_length - EPOCH_CONTEXT_PREBUILD_BLOCKS - 1) == context);
+
+    // Near the boundary the next epoch is prebuilt; Get() waits for that build
+    auto contextAtBoundary = cache.GetForHeight(ethash::epoch_length - 1);
+    BOOST_CHECK(contextAtBoundary == context);
+    auto contextNext = cache.Get(1);
+    BOOST_REQUIRE(contextNext);
+    BOOST_CHECK_EQUAL(contextNext->epoch_number, 1);
+    BOOST_CHECK(cache.GetForHeight(ethash::epoch_length) == contextNext);
+
+    // Results match a freshly created context
+    const auto header_hash = to_hash256("c6c1ab79d1a9a0ec4d5d8c1f9b1a1d5e5d1a9c3e7f1d8c9b1a1d5e5d1a9c3e7f");
+    auto fresh = ethash::create_epoch_context(1);
+    const auto r1 = progpow::hash(*contextNext, ethash::epoch_length, header_hash, 1);
+    const auto r2 = progpow::hash(*fresh, ethash::epoch_length, header_hash, 1);
+    BOOST_CHECK(to_hex(r1.final_hash) == to_hex(r2.final_hash));
+}
+
+BOOST_AUTO_TEST_CASE(kawpow_verify_shares)
+{
+    // The test vectors of the first epoch, each as a passing share, one
+    // whose final hash misses the target and one with a wrong mix hash
+    std::vector<CKawpowShare> vShares;
+    std::vector<uint256> vFinal;
+    for (auto& t : progpow_hash_test_cases) {
+        if (ethash::get_epoch_number(t.block_number) != 0)
+            continue;
+        CKawpowShare share;
+        share.hashHeader = FromEthashHash256(to_hash256(t.header_hash_hex));
+        share.hashMix = FromEthashHash256(to_hash256(t.mix_hash_hex));
+        share.nNonce = std::stoull(t.nonce_hex, nullptr, 16);
+        share.nHeight = t.block_number;
+        share.target = FromEthashHash256(to_hash256(t.final_hash_hex));
+        vShares.push_back(share);
+        vFinal.push_back(share.target);
+
+        CKawpowShare missed = share;
+        missed.target = ArithToUint256(UintToArith256(share.target) - 1);
+        vShares.push_back(missed);
+        vFinal.push_back(share.target);
+
+        CKawpowShare wrongMix = share;
+        *wrongMix.hashMix.begin() ^= 1;
+        vShares.push_back(wrongMix);
+        vFinal.push_back(uint256());
+    }
+    BOOST_REQUIRE(vShares.size() >= 3 * 3);
+
+    for (int nThreads : {1, 4}) {
+        const std::vector<CKawpowShareResult> vResults = VerifyKawpowShares(vShares, nThreads);
+        BOOST_REQUIRE_EQUAL(vResults.size(), vShares.size());
+        for (size_t i = 0; i < vShares.size(); i++) {
+            BOOST_CHECK_EQUAL(vResults[i].fValid, i % 3 == 0);
+            // The final hash is reported for failing shares too
+            if (i % 3 != 2)
+                BOOST_CHECK(vResults[i].hashFinal == vFinal[i]);
+            else
+                BOOST_CHECK(vResults[i].hashFinal != vFinal[i - 2]);
+        }
+    }
+    BOOST_CHECK(VerifyKawpowShares({}, 4).empty());
+}
+
 BOOST_AUTO_TEST_SUITE_END()
\ No newline at end of file
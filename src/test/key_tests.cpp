@@ -6,12 +6,15 @@
 #include "key.h"
 
 #include "base58.h"
+#include "crypto/common.h"
+#include "hash.h"
 #include "script/script.h"
 #include "uint256.h"
 #include "util.h"
 #include "utilstrencodings.h"
 #include "test/test_mynta.h"
 
+#include <map>
 #include <string>
 #include <vector>
 
@@ -165,4 +168,47 @@ BOOST_FIXTURE_TEST_SUITE(key_tests, BasicTestingSetup)
         BOOST_CHECK(detsigc == ParseHex("2052d8a32079c11e79db95af63bb9600c5b04f21a9ca33dc129c2bfa8ac9dc1cd561d8ae5e0f6c1a16bde3719c64c2fd70e404b6428ab9a69566962e8771b5944d"));
     }
 
+    BOOST_AUTO_TEST_CASE(key_verify_parse_cache_test)
+    {
+        // Verify keeps parsed keys per thread in slots picked by the start of
+        // the X coordinate. Keys that share a slot, or the same X in another
+        // encoding, must never be mistaken for each other.
+        CKey keyA, keyB;
+        keyA.MakeNewKey(true);
+        std::map<uint32_t, CKey> mapSlots;
+        for (int i = 0; i < 10000; i++) {
+            CKey key;
+            key.MakeNewKey(true);
+            uint32_t nSlot = ReadLE32(key.GetPubKey().begin() + 1) % 1024;
+            if (mapSlots.count(nSlot)) {
+                keyA = mapSlots[nSlot];
+                keyB = key;
+                break;
+            }
+            mapSlots[nSlot] = key;
+        }
+        BOOST_CHECK(keyB.IsValid());
+
+        uint256 hash = Hash(strSecret1.begin(), strSecret1.end());
+        std::vector<unsigned char> sigA, sigB;
+        BOOST_CHECK(keyA.Sign(hash, sigA));
+        BOOST_CHECK(keyB.Sign(hash, sigB));
+
+        CPubKey pubkeyA = keyA.GetPubKey();
+        CPubKey pubkeyB = keyB.GetPubKey();
+        for (int i = 0; i < 2; i++) {
+            BOOST_CHECK(pubkeyA.Verify(hash, sigA));
+            BOOST_CHECK(!pubkeyB.Verify(hash, sigA));
+            BOOST_CHECK(pubkeyB.Verify(hash, sigB));
+            BOOST_CHECK(!pubkeyA.Verify(hash, sigB));
+        }
+
+        // The uncompressed encoding of A lands in the same slot
+        CPubKey pubkeyAU = pubkeyA;
+        BOOST_CHECK(pubkeyAU.Decompress());
+        BOOST_CHECK(pubkeyAU.Verify(hash, sigA));
+        BOOST_CHECK(pubkeyA.Verify(hash, sigA));
+        BOOST_CHECK(!pubkeyAU.Verify(hash, sigB));
+    }
+
 BOOST_AUTO_TEST_SUITE_END()
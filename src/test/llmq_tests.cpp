@@ -7,8 +7,11 @@
 #include "llmq/quorums.h"
 #include "llmq/instantsend.h"
 #include "llmq/chainlocks.h"
+#include "arith_uint256.h"
 #include "bls/bls.h"
+#include "evo/evodb.h"
 #include "hash.h"
+#include "streams.h"
 #include "uint256.h"
 
 #include <boost/test/unit_test.hpp>
@@ -53,6 +56,61 @@ BOOST_AUTO_TEST_CASE(llmq_quorum_snapshot)
     BOOST_CHECK(snapshot.activeMembers[0]);
 }
 
+BOOST_AUTO_TEST_CASE(llmq_quorum_snapshot_db)
+{
+    llmq::CQuorum quorum;
+    quorum.llmqType = llmq::LLMQType::LLMQ_50_60;
+    quorum.quorumHash = uint256S("abcdef1234567890abcdef1234567890abcdef1234567890abcdef1234567890");
+    quorum.quorumHeight = 2400;
+    std::vector<CBLSPublicKey> pubKeys;
+    for (int i = 0; i < 45; i++) {
+        CBLSSecretKey sk;
+        sk.MakeNewKey();
+        llmq::CQuorumMember member;
+        member.proTxHash = ArithToUint256(arith_uint256(i + 1));
+        member.pubKeyOperator = sk.GetPublicKey();
+        member.valid = i % 9 != 0;
+        if (member.valid) {
+            pubKeys.push_back(member.pubKeyOperator);
+            quorum.validMemberCount++;
+        }
+        quorum.members.push_back(member);
+    }
+    quorum.quorumPublicKey = CBLSPublicKey::AggregatePublicKeys(pubKeys);
+    quorum.fValid = quorum.validMemberCount >= quorum.GetMinSize();
+    BOOST_CHECK_EQUAL(quorum.validMemberCount, 40);
+    
+    // Test: the snapshot survives serialization and restores the same quorum.
+    CDataStream ss(SER_DISK, CLIENT_VERSION);
+    ss << llmq::MakeQuorumSnapshot(quorum);
+    llmq::CQuorumSnapshot snapshot;
+    ss >> snapshot;
+    llmq::CQuorumCPtr restored = llmq::QuorumFromSnapshot(snapshot);
+    BOOST_REQUIRE(restored);
+    BOOST_CHECK(restored->llmqType == quorum.llmqType);
+    BOOST_CHECK_EQUAL(restored->quorumHeight, quorum.quorumHeight);
+    BOOST_CHECK(restored->fValid);
+    BOOST_CHECK_EQUAL(restored->validMemberCount, quorum.validMemberCount);
+    BOOST_CHECK(restored->quorumPublicKey == quorum.quorumPublicKey);
+    BOOST_REQUIRE_EQUAL(restored->members.size(), quorum.members.size());
+    for (size_t i = 0; i < quorum.members.size(); i++) {
+        BOOST_CHECK(restored->members[i].proTxHash == quorum.members[i].proTxHash);
+        BOOST_CHECK(restored->members[i].pubKeyOperator == quorum.members[i].pubKeyOperator);
+        BOOST_CHECK_EQUAL(restored->members[i].valid, quorum.members[i].valid);
+    }
+    
+    // Test: a manager that never built the quorum loads it from the evo database.
+    evoDb.reset(new CEvoDB(1 << 20, true, true));
+    llmq::CQuorumManager manager;
+    BOOST_CHECK(!manager.GetQuorum(quorum.llmqType, quorum.quorumHash));
+    llmq::WriteQuorumSnapshot(*evoDb, llmq::MakeQuorumSnapshot(quorum));
+    llmq::CQuorumCPtr loaded = manager.GetQuorum(quorum.llmqType, quorum.quorumHash);
+    BOOST_REQUIRE(loaded);
+    BOOST_CHECK(loaded->quorumPublicKey == quorum.quorumPublicKey);
+    BOOST_CHECK(!manager.GetQuorum(llmq::LLMQType::LLMQ_400_60, quorum.quorumHash));
+    evoDb.reset();
+}
+
 BOOST_AUTO_TEST_CASE(llmq_recovered_sig)
 {
     llmq::CRecoveredSig sig;
@@ -73,6 +131,36 @@ BOOST_AUTO_TEST_CASE(llmq_recovered_sig)
     BOOST_CHECK(!signHash.IsNull());
 }
 
+BOOST_AUTO_TEST_CASE(llmq_batched_sig_shares)
+{
+    llmq::CBatchedSigShares batch;
+    batch.llmqType = llmq::LLMQType::LLMQ_50_60;
+    batch.quorumHash = uint256S("1111111111111111111111111111111111111111111111111111111111111111");
+    batch.id = uint256S("2222222222222222222222222222222222222222222222222222222222222222");
+    batch.msgHash = uint256S("3333333333333333333333333333333333333333333333333333333333333333");
+    
+    for (uint16_t i = 0; i < 3; i++) {
+        CBLSSecretKey sk;
+        sk.MakeNewKey();
+        batch.shares.emplace_back(i * 7, sk.Sign(batch.msgHash));
+    }
+    
+    CDataStream ss(SER_NETWORK, PROTOCOL_VERSION);
+    ss << batch;
+    llmq::CBatchedSigShares batch2;
+    ss >> batch2;
+    
+    BOOST_CHECK(batch2.llmqType == batch.llmqType);
+    BOOST_CHECK(batch2.quorumHash == batch.quorumHash);
+    BOOST_CHECK(batch2.id == batch.id);
+    BOOST_CHECK(batch2.msgHash == batch.msgHash);
+    BOOST_REQUIRE_EQUAL(batch2.shares.size(), 3);
+    for (size_t i = 0; i < 3; i++) {
+        BOOST_CHECK_EQUAL(batch2.shares[i].first, batch.shares[i].first);
+        BOOST_CHECK(batch2.shares[i].second == batch.shares[i].second);
+    }
+}
+
 BOOST_AUTO_TEST_CASE(instantsend_lock)
 {
     llmq::CInstantSendLock islock;
@@ -94,6 +182,71 @@ BOOST_AUTO_TEST_CASE(instantsend_lock)
     BOOST_CHECK_EQUAL(islock.inputs.size(), 2);
 }
 
+BOOST_AUTO_TEST_CASE(instantsend_db)
+{
+    llmq::CInstantSendDb db(1 << 20, true, true);
+    
+    llmq::CInstantSendLock islock;
+    islock.txid = uint256S("4444444444444444444444444444444444444444444444444444444444444444");
+    islock.inputs.push_back(COutPoint(uint256S("6666666666666666666666666666666666666666666666666666666666666666"), 0));
+    islock.inputs.push_back(COutPoint(uint256S("7777777777777777777777777777777777777777777777777777777777777777"), 1));
+    BOOST_CHECK(db.WriteLock(islock));
+    
+    // Found by hash, txid and each input
+    const uint256 hash = islock.GetHash();
+    BOOST_CHECK(db.GetLock(hash) != nullptr);
+    BOOST_CHECK(db.IsTxLocked(islock.txid));
+    for (const auto& input : islock.inputs) {
+        auto lock = db.GetLockForInput(input);
+        BOOST_REQUIRE(lock != nullptr);
+        BOOST_CHECK(lock->txid == islock.txid);
+    }
+    BOOST_CHECK(!db.IsInputLocked(COutPoint(islock.inputs[0].hash, 1)));
+    BOOST_CHECK_EQUAL(db.GetAllLockedOutpoints().size(), 2);
+    
+    // Pruned only once its transaction is mined at or below the height
+    BOOST_CHECK_EQUAL(db.RemoveConfirmedLocks(1000), 0);
+    db.WriteLocksMined({hash}, 500);
+    BOOST_CHECK_EQUAL(db.RemoveConfirmedLocks(499), 0);
+    BOOST_CHECK(db.IsTxLocked(islock.txid));
+    db.RemoveLocksMined({hash}, 500);
+    db.WriteLocksMined({hash}, 501);
+    BOOST_CHECK_EQUAL(db.RemoveConfirmedLocks(500), 0);
+    BOOST_CHECK_EQUAL(db.RemoveConfirmedLocks(501), 1);
+    BOOST_CHECK(!db.IsTxLocked(islock.txid));
+    BOOST_CHECK(db.GetLock(hash) == nullptr);
+    BOOST_CHECK(!db.IsInputLocked(islock.inputs[0]));
+    BOOST_CHECK(db.GetAllLockedOutpoints().empty());
+}
+
+BOOST_AUTO_TEST_CASE(instantsend_db_prune_batches)
+{
+    llmq::CInstantSendDb db(1 << 20, true, true);
+    
+    // Enough locks that pruning them all takes several batches
+    const int nLocks = 3 * (llmq::INSTANTSEND_PRUNE_BATCH_SIZE / 64);
+    std::vector<uint256> hashes;
+    for (int i = 0; i < nLocks; i++) {
+        llmq::CInstantSendLock islock;
+        islock.txid = ArithToUint256(arith_uint256(i + 1));
+        islock.inputs.push_back(COutPoint(islock.txid, 0));
+        BOOST_REQUIRE(db.WriteLock(islock));
+        hashes.push_back(islock.GetHash());
+    }
+    db.WriteLocksMined(std::vector<uint256>(hashes.begin(), hashes.begin() + nLocks / 2), 100);
+    db.WriteLocksMined(std::vector<uint256>(hashes.begin() + nLocks / 2, hashes.end()), 200);
+    
+    BOOST_CHECK_EQUAL(db.RemoveConfirmedLocks(150), (size_t)(nLocks / 2));
+    BOOST_CHECK(db.GetLock(hashes.front()) == nullptr);
+    BOOST_CHECK(db.GetLock(hashes.back()) != nullptr);
+    BOOST_CHECK_EQUAL(db.GetAllLockedOutpoints().size(), (size_t)(nLocks - nLocks / 2));
+    
+    // The mined entries went with the locks
+    BOOST_CHECK_EQUAL(db.RemoveConfirmedLocks(150), 0);
+    BOOST_CHECK_EQUAL(db.RemoveConfirmedLocks(200), (size_t)(nLocks - nLocks / 2));
+    BOOST_CHECK(db.GetAllLockedOutpoints().empty());
+}
+
 BOOST_AUTO_TEST_CASE(chainlock_sig)
 {
     llmq::CChainLockSig clsig;
@@ -116,4 +269,67 @@ BOOST_AUTO_TEST_CASE(chainlock_sig)
     BOOST_CHECK(!reqId.IsNull());
 }
 
+BOOST_AUTO_TEST_CASE(chainlock_db_keeps_best)
+{
+    llmq::CChainLocksDb db;
+    BOOST_CHECK(db.WriteChainLock(llmq::CChainLockSig(1000, uint256S("01"))));
+    BOOST_CHECK(db.WriteChainLock(llmq::CChainLockSig(1005, uint256S("02"))));
+    
+    // The lock at 1000 is still in the window below the one at 1005
+    llmq::CChainLockSig clsig;
+    BOOST_CHECK(db.GetChainLock(1000, clsig));
+    BOOST_CHECK(db.HasChainLock(uint256S("01")));
+    BOOST_CHECK(db.HasChainLock(1000, uint256S("01")));
+    BOOST_CHECK(!db.HasChainLock(1000, uint256S("02")));
+    BOOST_CHECK(!db.HasChainLock(1001, uint256S("01")));
+    BOOST_CHECK(db.GetChainLock(1005, clsig));
+    BOOST_CHECK_EQUAL(db.GetBestChainLockHeight(), 1005);
+    
+    // And nothing goes back below it
+    BOOST_CHECK(!db.WriteChainLock(llmq::CChainLockSig(1001, uint256S("03"))));
+    
+    // Once the best moves a window past it, it is implied and dropped,
+    // also from the slot it shares with the new best
+    BOOST_CHECK(db.WriteChainLock(llmq::CChainLockSig(1000 + llmq::CHAINLOCK_WINDOW_SIZE, uint256S("04"))));
+    BOOST_CHECK(!db.GetChainLock(1000, clsig));
+    BOOST_CHECK(!db.HasChainLock(uint256S("01")));
+    BOOST_CHECK(!db.HasChainLock(1000, uint256S("01")));
+    BOOST_CHECK(db.HasChainLock(1005, uint256S("02")));
+    BOOST_CHECK(db.HasChainLock(1000 + llmq::CHAINLOCK_WINDOW_SIZE, uint256S("04")));
+}
+
+BOOST_AUTO_TEST_CASE(chainlock_db_persists_window)
+{
+    evoDb.reset(new CEvoDB(1 << 20, true, true));
+    {
+        llmq::CChainLocksDb db(evoDb.get());
+        BOOST_CHECK(db.WriteChainLock(llmq::CChainLockSig(2000, uint256S("01"))));
+        BOOST_CHECK(db.WriteChainLock(llmq::CChainLockSig(2010, uint256S("02"))));
+    }
+    
+    // A restart finds the best lock and the window below it
+    {
+        llmq::CChainLocksDb db(evoDb.get());
+        BOOST_CHECK_EQUAL(db.GetBestChainLockHeight(), 2010);
+        BOOST_CHECK(db.GetBestChainLockHash() == uint256S("02"));
+        BOOST_CHECK(db.HasChainLock(2000, uint256S("01")));
+        BOOST_CHECK(db.HasChainLock(2010, uint256S("02")));
+        BOOST_CHECK(db.WriteChainLock(llmq::CChainLockSig(2100, uint256S("03"))));
+        
+        db.RemoveAboveHeight(2050);
+        BOOST_CHECK_EQUAL(db.GetBestChainLockHeight(), 0);
+        BOOST_CHECK(!db.HasChainLock(2100, uint256S("03")));
+    }
+    
+    // Pruned and removed locks are gone from disk too
+    {
+        llmq::CChainLocksDb db(evoDb.get());
+        BOOST_CHECK_EQUAL(db.GetBestChainLockHeight(), 0);
+        llmq::CChainLockSig clsig;
+        BOOST_CHECK(!db.GetChainLock(2000, clsig));
+        BOOST_CHECK(!db.GetChainLock(2100, clsig));
+    }
+    evoDb.reset();
+}
+
 BOOST_AUTO_TEST_SUITE_END()
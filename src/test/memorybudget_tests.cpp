@@ -0,0 +1,88 @@
+// Copyright (c) 2026 The Mynta Core Developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include "memorybudget.h"
+
+#include "test/test_mynta.h"
+
+#include <boost/test/unit_test.hpp>
+
+BOOST_FIXTURE_TEST_SUITE(memorybudget_tests, BasicTestingSetup)
+
+/** A cache that is just a byte count, dropping what it is asked to in blocks of nBlock */
+struct FakeCache
+{
+    size_t nUsage;
+    size_t nBlock;
+    size_t nCalls{0};
+
+    FakeCache(size_t nUsageIn, size_t nBlockIn) : nUsage(nUsageIn), nBlock(nBlockIn) {}
+
+    size_t Evict(size_t nBytes)
+    {
+        nCalls++;
+        size_t nFreed = 0;
+        while (nFreed < nBytes && nUsage >= nBlock) {
+            nUsage -= nBlock;
+            nFreed += nBlock;
+        }
+        return nFreed;
+    }
+};
+
+BOOST_AUTO_TEST_CASE(accounting_only)
+{
+    CMemoryBudget budget;
+    FakeCache big(1000, 10);
+    budget.Register("big", [&] { return big.nUsage; }, [&](size_t n) { return big.Evict(n); });
+    budget.Register("fixed", [] { return (size_t)500; });
+
+    // Without a budget the caches are only counted
+    BOOST_CHECK_EQUAL(budget.Enforce(), 0U);
+    BOOST_CHECK_EQUAL(big.nCalls, 0U);
+
+    std::vector<CMemoryConsumerStats> vStats = budget.GetStats();
+    BOOST_REQUIRE_EQUAL(vStats.size(), 2U);
+    BOOST_CHECK(vStats[0].strName == "big" && vStats[0].nUsage == 1000 && vStats[0].fEvictable);
+    BOOST_CHECK(vStats[1].strName == "fixed" && vStats[1].nUsage == 500 && !vStats[1].fEvictable);
+
+    budget.Unregister("fixed");
+    BOOST_CHECK_EQUAL(budget.GetStats().size(), 1U);
+}
+
+BOOST_AUTO_TEST_CASE(largest_first)
+{
+    CMemoryBudget budget;
+    FakeCache big(1000, 10);
+    FakeCache small(300, 10);
+    budget.Register("big", [&] { return big.nUsage; }, [&](size_t n) { return big.Evict(n); });
+    budget.Register("small", [&] { return small.nUsage; }, [&](size_t n) { return small.Evict(n); });
+    budget.Register("fixed", [] { return (size_t)500; });
+
+    // 1800 bytes against 1500: the largest cache that can evict frees the difference
+    budget.SetBudget(1500);
+    BOOST_CHECK_EQUAL(budget.Enforce(), 300U);
+    BOOST_CHECK_EQUAL(big.nUsage, 700U);
+    BOOST_CHECK_EQUAL(small.nCalls, 0U);
+    BOOST_CHECK_EQUAL(budget.GetPressureEvents(), 1U);
+
+    // Within the budget nothing is asked to evict
+    BOOST_CHECK_EQUAL(budget.Enforce(), 0U);
+    BOOST_CHECK_EQUAL(big.nCalls, 1U);
+
+    // A cache that can't free enough leaves the rest to the next one
+    big.nBlock = 1000000;
+    budget.SetBudget(1000);
+    BOOST_CHECK_EQUAL(budget.Enforce(), 300U);
+    BOOST_CHECK_EQUAL(small.nUsage, 0U);
+
+    for (const CMemoryConsumerStats& stats : budget.GetStats()) {
+        if (stats.strName == "big")
+            BOOST_CHECK(stats.nEvictions == 2 && stats.nEvictedBytes == 300);
+        if (stats.strName == "small")
+            BOOST_CHECK(stats.nEvictions == 1 && stats.nEvictedBytes == 300);
+    }
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -442,6 +442,194 @@ BOOST_FIXTURE_TEST_SUITE(mempool_tests, TestingSetup)
     }
 
 
+    BOOST_AUTO_TEST_CASE(mempool_ancestor_chain_test)
+    {
+        BOOST_TEST_MESSAGE("Running Mempool Ancestor Chain Test");
+
+        // A chain of transactions each spending the previous one's change, with
+        // a merge at the end, as reward distributions build them
+        CTxMemPool pool;
+        TestMemPoolEntryHelper entry;
+        std::vector<CMutableTransaction> vChain;
+        uint256 hashPrev = uint256S("0x01");
+        for (int i = 0; i < 50; i++) {
+            CMutableTransaction tx;
+            tx.vin.resize(1);
+            tx.vin[0].scriptSig = CScript() << OP_11;
+            tx.vin[0].prevout = COutPoint(hashPrev, 0);
+            tx.vout.resize(2);
+            tx.vout[0].scriptPubKey = CScript() << OP_11 << OP_EQUAL;
+            tx.vout[0].nValue = (100 - i) * COIN;
+            tx.vout[1].scriptPubKey = CScript() << OP_12 << OP_EQUAL;
+            tx.vout[1].nValue = COIN;
+            pool.addUnchecked(tx.GetHash(), entry.Fee(1000 + i).FromTx(tx));
+            vChain.push_back(tx);
+            hashPrev = tx.GetHash();
+
+            CTxMemPool::txiter it = pool.mapTx.find(tx.GetHash());
+            BOOST_CHECK_EQUAL(it->GetCountWithAncestors(), (uint64_t)(i + 1));
+            BOOST_CHECK_EQUAL(it->GetModFeesWithAncestors(), (i + 1) * 1000 + i * (i + 1) / 2);
+            BOOST_CHECK_EQUAL(pool.mapTx.find(vChain[0].GetHash())->GetCountWithDescendants(), (uint64_t)(i + 1));
+        }
+
+        // Spending the tip and an output halfway down the chain finds each ancestor once
+        CMutableTransaction txMerge;
+        txMerge.vin.resize(2);
+        txMerge.vin[0].prevout = COutPoint(vChain[49].GetHash(), 0);
+        txMerge.vin[1].prevout = COutPoint(vChain[20].GetHash(), 1);
+        txMerge.vout.resize(1);
+        txMerge.vout[0].scriptPubKey = CScript() << OP_11 << OP_EQUAL;
+        txMerge.vout[0].nValue = COIN;
+        CTxMemPool::setEntries setAncestors;
+        std::string errString;
+        uint64_t nNoLimit = std::numeric_limits<uint64_t>::max();
+        BOOST_CHECK(pool.CalculateMemPoolAncestors(entry.FromTx(txMerge), setAncestors, nNoLimit, nNoLimit, nNoLimit, nNoLimit, errString));
+        BOOST_CHECK_EQUAL(setAncestors.size(), 50U);
+
+        // The limits are enforced over ancestors taken from the cache too
+        setAncestors.clear();
+        BOOST_CHECK(!pool.CalculateMemPoolAncestors(entry.FromTx(txMerge), setAncestors, 25, nNoLimit, nNoLimit, nNoLimit, errString));
+        setAncestors.clear();
+        BOOST_CHECK(!pool.CalculateMemPoolAncestors(entry.FromTx(txMerge), setAncestors, nNoLimit, nNoLimit, 25, nNoLimit, errString));
+
+        // Once the start of the chain is mined, it is no longer an ancestor
+        std::vector<CTransactionRef> vtx{MakeTransactionRef(vChain[0])};
+        pool.removeForBlock(vtx, 1);
+        setAncestors.clear();
+        BOOST_CHECK(pool.CalculateMemPoolAncestors(entry.FromTx(txMerge), setAncestors, nNoLimit, nNoLimit, nNoLimit, nNoLimit, errString));
+        BOOST_CHECK_EQUAL(setAncestors.size(), 49U);
+        pool.addUnchecked(txMerge.GetHash(), entry.FromTx(txMerge));
+        BOOST_CHECK_EQUAL(pool.mapTx.find(txMerge.GetHash())->GetCountWithAncestors(), 50U);
+        BOOST_CHECK_EQUAL(pool.mapTx.find(vChain[1].GetHash())->GetCountWithDescendants(), 50U);
+
+        // Announced parents first, whatever order they are asked for in, without the mined one
+        std::vector<uint256> vHashes{txMerge.GetHash()};
+        for (int i = 49; i >= 0; i--)
+            vHashes.push_back(vChain[i].GetHash());
+        std::vector<TxMempoolInfo> vInfo = pool.infoByDepthAndScore(vHashes);
+        BOOST_CHECK_EQUAL(vInfo.size(), 50U);
+        for (int i = 1; i < 50; i++)
+            BOOST_CHECK(vInfo[i - 1].tx->GetHash() == vChain[i].GetHash());
+        BOOST_CHECK(vInfo[49].tx->GetHash() == txMerge.GetHash());
+    }
+
+    BOOST_AUTO_TEST_CASE(mempool_event_log_test)
+    {
+        BOOST_TEST_MESSAGE("Running Mempool Event Log Test");
+
+        CTxMemPool pool;
+        TestMemPoolEntryHelper entry;
+        BOOST_CHECK_EQUAL(pool.GetEventSequence(), 0U);
+
+        CMutableTransaction txParent;
+        txParent.vin.resize(1);
+        txParent.vin[0].scriptSig = CScript() << OP_11;
+        txParent.vout.resize(1);
+        txParent.vout[0].scriptPubKey = CScript() << OP_11 << OP_EQUAL;
+        txParent.vout[0].nValue = 10 * COIN;
+        CMutableTransaction txChild;
+        txChild.vin.resize(1);
+        txChild.vin[0].prevout = COutPoint(txParent.GetHash(), 0);
+        txChild.vout.resize(1);
+        txChild.vout[0].scriptPubKey = CScript() << OP_11 << OP_EQUAL;
+        txChild.vout[0].nValue = 9 * COIN;
+
+        pool.addUnchecked(txParent.GetHash(), entry.FromTx(txParent));
+        pool.addUnchecked(txChild.GetHash(), entry.FromTx(txChild));
+        pool.removeRecursive(txParent, MemPoolRemovalReason::CONFLICT);
+        BOOST_CHECK_EQUAL(pool.GetEventSequence(), 4U);
+
+        std::vector<CMempoolEvent> vEvents;
+        BOOST_CHECK(pool.GetEventsSince(0, 10, vEvents));
+        BOOST_REQUIRE_EQUAL(vEvents.size(), 4U);
+        for (size_t i = 0; i < vEvents.size(); i++)
+            BOOST_CHECK_EQUAL(vEvents[i].nSequence, i + 1);
+        BOOST_CHECK(vEvents[0].nType == CMempoolEvent::ADDED && vEvents[0].txid == txParent.GetHash());
+        BOOST_CHECK(vEvents[1].nType == CMempoolEvent::ADDED && vEvents[1].txid == txChild.GetHash());
+        std::set<uint256> setRemoved{vEvents[2].txid, vEvents[3].txid};
+        BOOST_CHECK(setRemoved.count(txParent.GetHash()) && setRemoved.count(txChild.GetHash()));
+        BOOST_CHECK(vEvents[2].nType == CMempoolEvent::REMOVED && vEvents[2].nReason == (uint8_t)MemPoolRemovalReason::CONFLICT);
+
+        // Paged from a sequence, and nothing after the last one
+        BOOST_CHECK(pool.GetEventsSince(1, 2, vEvents));
+        BOOST_REQUIRE_EQUAL(vEvents.size(), 2U);
+        BOOST_CHECK_EQUAL(vEvents[0].nSequence, 2U);
+        BOOST_CHECK(pool.GetEventsSince(4, 10, vEvents));
+        BOOST_CHECK(vEvents.empty());
+
+        // Round trips through its serialization, as ZMQ publishes it
+        CDataStream ss(SER_NETWORK, PROTOCOL_VERSION);
+        CMempoolEvent event;
+        event.nSequence = 7;
+        event.txid = txChild.GetHash();
+        ss << event;
+        CMempoolEvent eventRead;
+        ss >> eventRead;
+        BOOST_CHECK_EQUAL(eventRead.nSequence, 7U);
+        BOOST_CHECK(eventRead.txid == txChild.GetHash());
+        BOOST_CHECK(!eventRead.assetRecord);
+    }
+
+    BOOST_AUTO_TEST_CASE(mempool_asset_record_test)
+    {
+        BOOST_TEST_MESSAGE("Running Mempool Asset Record Test");
+
+        CTxMemPool pool;
+        TestMemPoolEntryHelper entry;
+
+        CMutableTransaction txIssue;
+        txIssue.vin.resize(1);
+        txIssue.vin[0].prevout = COutPoint(uint256S("0x01"), 0);
+        txIssue.vout.resize(1);
+        txIssue.vout[0].scriptPubKey = CScript() << OP_11 << OP_EQUAL;
+        txIssue.vout[0].nValue = COIN;
+        CMempoolAssetRecord recordIssue;
+        recordIssue.strNewAsset = "RECORDASSET";
+        CTxMemPoolEntry entryIssue = entry.FromTx(txIssue);
+        entryIssue.SetAssetRecord(std::make_shared<const CMempoolAssetRecord>(recordIssue));
+        pool.addUnchecked(txIssue.GetHash(), entryIssue);
+        BOOST_CHECK(pool.HasAssetIssue("RECORDASSET"));
+        BOOST_CHECK(!pool.HasAssetIssue("OTHERASSET"));
+
+        // A freeze that names its asset twice is indexed once
+        CMutableTransaction txFreeze = txIssue;
+        txFreeze.vin[0].prevout = COutPoint(uint256S("0x02"), 0);
+        CMempoolAssetRecord recordFreeze;
+        recordFreeze.vGlobalFreezes = {"$RECORD"};
+        recordFreeze.vAddedTags = {std::make_pair("address", "#TAG"), std::make_pair("address", "#TAG")};
+        CTxMemPoolEntry entryFreeze = entry.FromTx(txFreeze);
+        entryFreeze.SetAssetRecord(std::make_shared<const CMempoolAssetRecord>(recordFreeze));
+        pool.addUnchecked(txFreeze.GetHash(), entryFreeze);
+        BOOST_CHECK(pool.HasGlobalRestrictionChange("$RECORD", true));
+        BOOST_CHECK(!pool.HasGlobalRestrictionChange("$RECORD", false));
+
+        // A second freeze conflicts, unless it replaces the first
+        std::string strReason;
+        CTxMemPool::setEntries setReplaced;
+        BOOST_CHECK(pool.HasAssetRecordConflict(recordFreeze, setReplaced, strReason));
+        BOOST_CHECK_EQUAL(strReason, "bad-txns-global-freeze-already-in-mempool");
+        CMempoolAssetRecord recordTag;
+        recordTag.vAddedTags = {std::make_pair("address", "#TAG")};
+        BOOST_CHECK(pool.HasAssetRecordConflict(recordTag, setReplaced, strReason));
+        BOOST_CHECK_EQUAL(strReason, "bad-txns-adding-tag-already-in-mempool");
+        recordTag.vAddedTags = {std::make_pair("address", "#OTHERTAG")};
+        BOOST_CHECK(!pool.HasAssetRecordConflict(recordTag, setReplaced, strReason));
+        setReplaced.insert(pool.mapTx.find(txFreeze.GetHash()));
+        BOOST_CHECK(!pool.HasAssetRecordConflict(recordFreeze, setReplaced, strReason));
+
+        // Removal drops the keys of each record
+        pool.removeRecursive(txFreeze);
+        setReplaced.clear();
+        BOOST_CHECK(!pool.HasGlobalRestrictionChange("$RECORD", true));
+        BOOST_CHECK(!pool.HasAssetRecordConflict(recordFreeze, setReplaced, strReason));
+        BOOST_CHECK(pool.HasAssetIssue("RECORDASSET"));
+        std::vector<CTransactionRef> vtx{MakeTransactionRef(txIssue)};
+        pool.removeForBlock(vtx, 1);
+        BOOST_CHECK(!pool.HasAssetIssue("RECORDASSET"));
+        BOOST_CHECK_EQUAL(pool.size(), 0U);
+    }
+
+
     BOOST_AUTO_TEST_CASE(mempool_size_limit_test)
     {
         BOOST_TEST_MESSAGE("Running Mempool Size Limit Test");
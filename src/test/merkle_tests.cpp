@@ -148,4 +148,41 @@ BOOST_FIXTURE_TEST_SUITE(merkle_tests, TestingSetup)
         }
     }
 
+    BOOST_AUTO_TEST_CASE(merkle_tree_test)
+    {
+        for (int ntx = 0; ntx <= 40; ntx++)
+        {
+            CBlock block;
+            block.vtx.resize(ntx);
+            for (int j = 0; j < ntx; j++)
+            {
+                CMutableTransaction mtx;
+                mtx.nLockTime = j;
+                block.vtx[j] = MakeTransactionRef(std::move(mtx));
+            }
+            std::vector<uint256> merkleTree;
+            const uint256 oldRoot = BlockBuildMerkleTree(block, nullptr, merkleTree);
+            const CMerkleTree tree = BlockMerkleTree(block);
+            BOOST_CHECK(tree.Root() == oldRoot);
+            BOOST_CHECK(!tree.Mutated());
+
+            // Every node, level by level, matches the old flattened tree
+            size_t nOffset = 0;
+            for (size_t height = 0; height < tree.Height(); height++)
+            {
+                for (size_t pos = 0; pos < tree.Width(height); pos++)
+                    BOOST_CHECK(tree.Node(height, pos) == merkleTree[nOffset + pos]);
+                nOffset += tree.Width(height);
+            }
+            BOOST_CHECK_EQUAL(nOffset, merkleTree.size());
+
+            // All branches come out of the one tree
+            for (int mtx = 0; mtx < ntx; mtx++)
+            {
+                BOOST_CHECK(tree.Branch(mtx) == BlockGetMerkleBranch(block, merkleTree, mtx));
+                BOOST_CHECK(ComputeMerkleRootFromBranch(block.vtx[mtx]->GetHash(), tree.Branch(mtx), mtx) == oldRoot);
+            }
+        }
+    }
+
 BOOST_AUTO_TEST_SUITE_END()
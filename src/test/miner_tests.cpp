@@ -287,6 +287,120 @@ BOOST_FIXTURE_TEST_SUITE(miner_tests, RegtestMinerTestingSetup)
         BOOST_CHECK(pblocktemplate->block.vtx[8]->GetHash() == hashLowFeeTx2);
     }
 
+    // Test that UpdateBlock patches new mempool transactions into the last
+    // template, and refuses once a transaction has left the mempool.
+    void TestIncrementalUpdate(const CChainParams &chainparams, CScript scriptPubKey, std::vector<CTransactionRef> &txFirst)
+    {
+        TestMemPoolEntryHelper entry;
+        mempool.clear();
+
+        CMutableTransaction tx;
+        tx.vin.resize(1);
+        tx.vin[0].scriptSig = CScript() << OP_1;
+        tx.vin[0].prevout.hash = txFirst[0]->GetHash();
+        tx.vin[0].prevout.n = 0;
+        tx.vout.resize(1);
+        tx.vout[0].nValue = 5000000000LL - 10000;
+        uint256 hashFirstTx = tx.GetHash();
+        mempool.addUnchecked(hashFirstTx, entry.Fee(10000).Time(GetTime()).SpendsCoinbase(true).FromTx(tx));
+
+        BlockAssembler assembler = AssemblerForTest(chainparams);
+        std::unique_ptr<CBlockTemplate> pblocktemplate = assembler.CreateNewBlock(scriptPubKey);
+        BOOST_REQUIRE_EQUAL(pblocktemplate->block.vtx.size(), 2U);
+        const CAmount nCoinbaseValue = pblocktemplate->block.vtx[0]->vout[0].nValue;
+
+        // Nothing new yet: the template stays as it is
+        BOOST_CHECK(assembler.UpdateBlock(*pblocktemplate, scriptPubKey));
+        BOOST_CHECK_EQUAL(pblocktemplate->block.vtx.size(), 2U);
+
+        // A child of the first transaction and an unrelated one are patched in
+        tx.vin[0].prevout.hash = hashFirstTx;
+        tx.vout[0].nValue = 5000000000LL - 10000 - 20000;
+        uint256 hashChildTx = tx.GetHash();
+        mempool.addUnchecked(hashChildTx, entry.Fee(20000).Time(GetTime()).SpendsCoinbase(false).FromTx(tx));
+        tx.vin[0].prevout.hash = txFirst[1]->GetHash();
+        tx.vout[0].nValue = 5000000000LL - 30000;
+        uint256 hashOtherTx = tx.GetHash();
+        mempool.addUnchecked(hashOtherTx, entry.Fee(30000).Time(GetTime()).SpendsCoinbase(true).FromTx(tx));
+
+        BOOST_CHECK(assembler.UpdateBlock(*pblocktemplate, scriptPubKey));
+        BOOST_REQUIRE_EQUAL(pblocktemplate->block.vtx.size(), 4U);
+        BOOST_CHECK(pblocktemplate->block.vtx[1]->GetHash() == hashFirstTx);
+        BOOST_CHECK(pblocktemplate->block.vtx[2]->GetHash() == hashOtherTx);
+        BOOST_CHECK(pblocktemplate->block.vtx[3]->GetHash() == hashChildTx);
+        BOOST_CHECK_EQUAL(pblocktemplate->block.vtx[0]->vout[0].nValue, nCoinbaseValue + 50000);
+        BOOST_CHECK_EQUAL(pblocktemplate->vTxFees[0], -60000);
+
+        // The patched template is what a full build gives
+        std::unique_ptr<CBlockTemplate> pblocktemplateFull = AssemblerForTest(chainparams).CreateNewBlock(scriptPubKey);
+        BOOST_CHECK_EQUAL(pblocktemplateFull->block.vtx.size(), 4U);
+        BOOST_CHECK_EQUAL(pblocktemplateFull->block.vtx[0]->vout[0].nValue, pblocktemplate->block.vtx[0]->vout[0].nValue);
+
+        // Once a transaction leaves the mempool the template must be built anew
+        mempool.removeRecursive(*pblocktemplate->block.vtx[2]);
+        BOOST_CHECK(!assembler.UpdateBlock(*pblocktemplate, scriptPubKey));
+        BOOST_CHECK_EQUAL(pblocktemplate->block.vtx.size(), 4U);
+
+        mempool.clear();
+    }
+
+    BOOST_AUTO_TEST_CASE(block_asset_claims_test)
+    {
+        CTxMemPool pool;
+        TestMemPoolEntryHelper entry;
+        auto fnAdd = [&](int n, const CMempoolAssetRecord& record) {
+            CMutableTransaction tx;
+            tx.vin.resize(1);
+            tx.vin[0].prevout = COutPoint(ArithToUint256(arith_uint256(n)), 0);
+            tx.vout.resize(1);
+            tx.vout[0].scriptPubKey = CScript() << OP_11 << OP_EQUAL;
+            tx.vout[0].nValue = COIN;
+            CTxMemPoolEntry entryTx = entry.FromTx(tx);
+            entryTx.SetAssetRecord(std::make_shared<const CMempoolAssetRecord>(record));
+            pool.addUnchecked(tx.GetHash(), entryTx);
+            return pool.mapTx.find(tx.GetHash());
+        };
+
+        CMempoolAssetRecord recordSend;
+        recordSend.vQualifierAddresses = {"address"};
+        recordSend.vVerifierAssets = {"$RESTRICTED"};
+        recordSend.vGlobalFrozenAssets = {"$RESTRICTED"};
+        CMempoolAssetRecord recordOtherSend = recordSend;
+        CMempoolAssetRecord recordUntag;
+        recordUntag.vRemovedTags = {std::make_pair("address", "#TAG")};
+        CMempoolAssetRecord recordFreeze;
+        recordFreeze.vGlobalFreezes = {"$RESTRICTED"};
+        CMempoolAssetRecord recordOtherFreeze;
+        recordOtherFreeze.vGlobalFreezes = {"$OTHER"};
+
+        CTxMemPool::txiter itSend = fnAdd(1, recordSend);
+        CTxMemPool::txiter itOtherSend = fnAdd(2, recordOtherSend);
+        CTxMemPool::txiter itUntag = fnAdd(3, recordUntag);
+        CTxMemPool::txiter itFreeze = fnAdd(4, recordFreeze);
+        CTxMemPool::txiter itOtherFreeze = fnAdd(5, recordOtherFreeze);
+
+        // Transactions depending on the same state go together, and a
+        // transaction may change what it depends on itself
+        CBlockAssetClaims claims;
+        BOOST_CHECK(!claims.Conflicts({itSend, itOtherSend}));
+        claims.Add(itSend);
+        BOOST_CHECK(!claims.Conflicts({itOtherSend}));
+        BOOST_CHECK(!claims.Conflicts({itOtherFreeze}));
+
+        // Changing the qualifiers of the address or freezing the asset sent clashes
+        BOOST_CHECK(claims.Conflicts({itUntag}));
+        BOOST_CHECK(claims.Conflicts({itFreeze}));
+        BOOST_CHECK(CBlockAssetClaims().Conflicts({itOtherSend, itFreeze}));
+
+        // Once the send is taken out again, so is its claim
+        claims.Remove(itSend);
+        BOOST_CHECK(!claims.Conflicts({itUntag, itFreeze}));
+        claims.Add(itFreeze);
+        BOOST_CHECK(claims.Conflicts({itSend}));
+        claims.Clear();
+        BOOST_CHECK(!claims.Conflicts({itSend}));
+    }
+
     // NOTE: These tests rely on CreateNewBlock doing its own self-validation!
     BOOST_AUTO_TEST_CASE(createnewblock_validity_test)
     {
@@ -676,6 +790,7 @@ BOOST_FIXTURE_TEST_SUITE(miner_tests, RegtestMinerTestingSetup)
         mempool.clear();
 
         TestPackageSelection(chainparams, scriptPubKey, txFirst);
+        TestIncrementalUpdate(chainparams, scriptPubKey, txFirst);
 
         fCheckpointsEnabled = true;
     }
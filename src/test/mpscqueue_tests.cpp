@@ -0,0 +1,98 @@
+// Copyright (c) 2026 The Mynta Core Developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include "mpscqueue.h"
+
+#include "test/test_mynta.h"
+
+#include <memory>
+#include <thread>
+#include <vector>
+
+#include <boost/test/unit_test.hpp>
+
+BOOST_FIXTURE_TEST_SUITE(mpscqueue_tests, BasicTestingSetup)
+
+BOOST_AUTO_TEST_CASE(mpscqueue_bounded_fifo)
+{
+    CMPSCQueue<int> queue(5);
+    BOOST_CHECK_EQUAL(queue.Capacity(), 8U);
+    BOOST_CHECK(queue.Empty());
+
+    // Test: values come out in order, and a full queue refuses more.
+    for (int i = 0; i < 8; i++)
+        BOOST_CHECK(queue.TryPush(int(i)));
+    BOOST_CHECK(!queue.TryPush(8));
+    int n;
+    for (int i = 0; i < 8; i++) {
+        BOOST_CHECK(queue.TryPop(n));
+        BOOST_CHECK_EQUAL(n, i);
+    }
+    BOOST_CHECK(!queue.TryPop(n));
+    BOOST_CHECK(queue.Empty());
+
+    // Test: cells are reused over many laps.
+    for (int i = 0; i < 100; i++) {
+        BOOST_CHECK(queue.TryPush(int(i)));
+        BOOST_CHECK(queue.TryPop(n));
+        BOOST_CHECK_EQUAL(n, i);
+    }
+
+    // Test: a refused value is left with the caller, a popped one isn't kept.
+    CMPSCQueue<std::shared_ptr<int>> ptrQueue(2);
+    auto value = std::make_shared<int>(1);
+    BOOST_CHECK(ptrQueue.TryPush(std::make_shared<int>(0)));
+    BOOST_CHECK(ptrQueue.TryPush(std::shared_ptr<int>(value)));
+    auto refused = std::make_shared<int>(2);
+    BOOST_CHECK(!ptrQueue.TryPush(std::move(refused)));
+    BOOST_CHECK(refused && *refused == 2);
+    std::shared_ptr<int> popped;
+    BOOST_CHECK(ptrQueue.TryPop(popped));
+    BOOST_CHECK(ptrQueue.TryPop(popped));
+    BOOST_CHECK(popped == value);
+    popped.reset();
+    BOOST_CHECK_EQUAL(value.use_count(), 1);
+}
+
+BOOST_AUTO_TEST_CASE(mpscqueue_many_producers)
+{
+    static const int PRODUCERS = 4;
+    static const int PER_PRODUCER = 20000;
+    CMPSCQueue<int> queue(64);
+
+    std::vector<std::thread> vProducers;
+    for (int p = 0; p < PRODUCERS; p++) {
+        vProducers.emplace_back([&queue, p]() {
+            for (int i = 0; i < PER_PRODUCER; i++) {
+                while (!queue.TryPush(p * PER_PRODUCER + i))
+                    std::this_thread::yield();
+            }
+        });
+    }
+
+    // Test: every value arrives exactly once, each producer's in its own order.
+    std::vector<int> vLast(PRODUCERS, -1);
+    std::vector<int> vCount(PRODUCERS, 0);
+    int nTotal = 0;
+    while (nTotal < PRODUCERS * PER_PRODUCER) {
+        int n;
+        if (!queue.TryPop(n)) {
+            std::this_thread::yield();
+            continue;
+        }
+        const int p = n / PER_PRODUCER;
+        BOOST_REQUIRE(p >= 0 && p < PRODUCERS);
+        BOOST_CHECK(n % PER_PRODUCER > vLast[p]);
+        vLast[p] = n % PER_PRODUCER;
+        vCount[p]++;
+        nTotal++;
+    }
+    for (std::thread& producer : vProducers)
+        producer.join();
+    for (int p = 0; p < PRODUCERS; p++)
+        BOOST_CHECK_EQUAL(vCount[p], PER_PRODUCER);
+    BOOST_CHECK(queue.Empty());
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -10,9 +10,17 @@
 #include "serialize.h"
 #include "streams.h"
 #include "net.h"
+#include "net_processing.h"
+#include "relaycache.h"
 #include "netbase.h"
 #include "chainparams.h"
 #include "util.h"
+#include "sockevents.h"
+
+#ifndef WIN32
+#include <sys/socket.h>
+#include <unistd.h>
+#endif
 
 class CAddrManSerializationMock : public CAddrMan
 {
@@ -198,4 +206,141 @@ BOOST_FIXTURE_TEST_SUITE(net_tests, BasicTestingSetup)
         BOOST_CHECK(pnode2->fFeeler == false);
     }
 
+#ifndef WIN32
+BOOST_AUTO_TEST_CASE(socket_events_backends)
+{
+    std::vector<std::string> vBackends = {DEFAULT_SOCKETEVENTS, "select"};
+    for (const std::string& strBackend : vBackends) {
+        std::unique_ptr<CSocketEvents> events = CreateSocketEvents(strBackend);
+        BOOST_REQUIRE(events);
+        BOOST_CHECK_EQUAL(events->GetName(), strBackend);
+
+        int fds[2];
+        BOOST_REQUIRE(socketpair(AF_UNIX, SOCK_STREAM, 0, fds) == 0);
+        BOOST_CHECK(events->Add(fds[0], 7, SOCKET_EVENT_RECV, true));
+
+        // Nothing to read yet
+        std::vector<CSocketEvents::Event> vEvents;
+        BOOST_CHECK(events->Wait(0, vEvents));
+        BOOST_CHECK(vEvents.empty());
+
+        BOOST_CHECK_EQUAL(write(fds[1], "x", 1), 1);
+        BOOST_CHECK(events->Wait(1000, vEvents));
+        BOOST_REQUIRE_EQUAL(vEvents.size(), 1);
+        BOOST_CHECK_EQUAL(vEvents[0].nTag, 7);
+        BOOST_CHECK(vEvents[0].nFlags & SOCKET_EVENT_RECV);
+
+        events->Remove(7);
+        close(fds[0]);
+        close(fds[1]);
+    }
+    BOOST_CHECK(!CreateSocketEvents("unknown"));
+}
+#endif
+
+BOOST_AUTO_TEST_CASE(shared_message_push)
+{
+    CConnman connman(0x1337, 0x1337);
+    CAddress addr(CService(), NODE_NONE);
+    CNode node1(0, NODE_NETWORK, 0, INVALID_SOCKET, addr, 0, 0, CAddress(), "", false);
+    CNode node2(1, NODE_NETWORK, 0, INVALID_SOCKET, addr, 1, 1, CAddress(), "", false);
+
+    CSerializedNetMsg msg;
+    msg.command = NetMsgType::PING;
+    msg.data.assign(8, 0x42);
+    CSharedNetMsg shared = connman.MakeSharedMessage(std::move(msg));
+    BOOST_CHECK_EQUAL(shared.header->size(), CMessageHeader::HEADER_SIZE);
+    BOOST_CHECK_EQUAL(shared.data->size(), 8U);
+
+    // Both peers queue the same header and payload instead of copies
+    connman.PushMessage(&node1, shared);
+    connman.PushMessage(&node2, shared);
+    BOOST_CHECK_EQUAL(node1.vSendMsg.size(), 2U);
+    BOOST_CHECK_EQUAL(node2.vSendMsg.size(), 2U);
+    BOOST_CHECK(node1.vSendMsg[0] == node2.vSendMsg[0]);
+    BOOST_CHECK(node1.vSendMsg[1] == node2.vSendMsg[1]);
+    BOOST_CHECK_EQUAL(node1.nSendSize, CMessageHeader::HEADER_SIZE + 8);
+
+    // An empty payload only queues the header
+    CSerializedNetMsg empty;
+    empty.command = NetMsgType::VERACK;
+    connman.PushMessage(&node1, std::move(empty));
+    BOOST_CHECK_EQUAL(node1.vSendMsg.size(), 3U);
+}
+
+BOOST_AUTO_TEST_CASE(recv_buffer_pool)
+{
+    size_t nPooled = netMessageBufferPool.size();
+
+    CDataStream small(SER_NETWORK, PROTOCOL_VERSION);
+    small.resize(1000);
+    netMessageBufferPool.Give(small);
+    BOOST_CHECK(small.empty());
+    BOOST_CHECK_EQUAL(netMessageBufferPool.size(), nPooled + 1);
+
+    // Buffers that grew too big aren't kept
+    CDataStream big(SER_NETWORK, PROTOCOL_VERSION);
+    big.resize(MAX_POOLED_RECV_BUFFER_SIZE + 1);
+    netMessageBufferPool.Give(big);
+    BOOST_CHECK_EQUAL(netMessageBufferPool.size(), nPooled + 1);
+
+    CDataStream taken(SER_NETWORK, PROTOCOL_VERSION);
+    netMessageBufferPool.Take(taken);
+    BOOST_CHECK(taken.empty());
+    BOOST_CHECK_EQUAL(netMessageBufferPool.size(), nPooled);
+}
+
+BOOST_AUTO_TEST_CASE(relay_message_cache)
+{
+    CConnman connman(0x1337, 0x1337);
+    auto make = [&connman](size_t nSize) {
+        CSerializedNetMsg msg;
+        msg.command = NetMsgType::TX;
+        msg.data.assign(nSize, 0x01);
+        return connman.MakeSharedMessage(std::move(msg));
+    };
+
+    CRelayMessageCache cache(3000);
+    uint256 hash1 = uint256S("01"), hash2 = uint256S("02"), hash3 = uint256S("03");
+    CSharedNetMsg msg1 = make(1000);
+    cache.Put(hash1, true, msg1);
+
+    // The same message comes back; the other witness flavour is a different entry
+    CSharedNetMsg got;
+    BOOST_CHECK(cache.Get(hash1, true, got));
+    BOOST_CHECK(got.data == msg1.data);
+    BOOST_CHECK(!cache.Get(hash1, false, got));
+
+    // Filling the cache evicts the least recently used entry
+    cache.Put(hash2, true, make(1000));
+    BOOST_CHECK(cache.Get(hash1, true, got));
+    cache.Put(hash3, true, make(1000));
+    BOOST_CHECK(cache.Get(hash1, true, got));
+    BOOST_CHECK(!cache.Get(hash2, true, got));
+    BOOST_CHECK(cache.Get(hash3, true, got));
+    BOOST_CHECK(cache.GetUsage() <= 3000);
+
+    // Messages bigger than the whole cache aren't kept
+    cache.Put(uint256S("04"), true, make(4000));
+    BOOST_CHECK(!cache.Get(uint256S("04"), true, got));
+    BOOST_CHECK_EQUAL(cache.size(), 2U);
+}
+
+BOOST_AUTO_TEST_CASE(peer_local_messages)
+{
+    // Handlers that only touch the sending peer may run on any handler thread
+    BOOST_CHECK(IsPeerLocalMessage(NetMsgType::PING));
+    BOOST_CHECK(IsPeerLocalMessage(NetMsgType::PONG));
+    BOOST_CHECK(IsPeerLocalMessage(NetMsgType::FEEFILTER));
+    BOOST_CHECK(IsPeerLocalMessage(NetMsgType::FILTERLOAD));
+
+    // Anything that relays to or asks other peers stays serialized
+    BOOST_CHECK(!IsPeerLocalMessage(NetMsgType::VERSION));
+    BOOST_CHECK(!IsPeerLocalMessage(NetMsgType::ADDR));
+    BOOST_CHECK(!IsPeerLocalMessage(NetMsgType::INV));
+    BOOST_CHECK(!IsPeerLocalMessage(NetMsgType::TX));
+    BOOST_CHECK(!IsPeerLocalMessage(NetMsgType::BLOCK));
+    BOOST_CHECK(!IsPeerLocalMessage(NetMsgType::HEADERS));
+}
+
 BOOST_AUTO_TEST_SUITE_END()
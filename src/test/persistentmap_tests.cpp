@@ -0,0 +1,117 @@
+// Copyright (c) 2026 The Mynta Core Developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include "persistentmap.h"
+#include "random.h"
+#include "streams.h"
+#include "version.h"
+
+#include "test/test_mynta.h"
+
+#include <map>
+
+#include <boost/test/unit_test.hpp>
+
+BOOST_FIXTURE_TEST_SUITE(persistentmap_tests, BasicTestingSetup)
+
+template <typename K, typename V>
+static bool MapsEqual(const persistentmap<K, V>& pm, const std::map<K, V>& m)
+{
+    if (pm.size() != m.size()) {
+        return false;
+    }
+    auto it = m.begin();
+    for (const auto& kv : pm) {
+        if (it == m.end() || kv.first != it->first || kv.second != it->second) {
+            return false;
+        }
+        ++it;
+    }
+    return it == m.end();
+}
+
+BOOST_AUTO_TEST_CASE(persistentmap_matches_std_map)
+{
+    FastRandomContext ctx(true);
+    persistentmap<int, int> pm;
+    std::map<int, int> m;
+
+    for (int i = 0; i < 5000; i++) {
+        int k = ctx.randrange(500);
+        if (ctx.randbool()) {
+            int v = ctx.rand32();
+            pm.set(k, v);
+            m[k] = v;
+        } else {
+            BOOST_CHECK_EQUAL(pm.erase(k), m.erase(k));
+        }
+        BOOST_CHECK_EQUAL(pm.count(k), m.count(k));
+    }
+    BOOST_CHECK(MapsEqual(pm, m));
+
+    for (const auto& kv : m) {
+        auto it = pm.find(kv.first);
+        BOOST_CHECK(it != pm.end());
+        BOOST_CHECK_EQUAL(it->second, kv.second);
+        BOOST_CHECK_EQUAL(*pm.find_value(kv.first), kv.second);
+
+        // Iterating from a found element continues in key order
+        auto itNext = std::next(m.find(kv.first));
+        ++it;
+        BOOST_CHECK((it == pm.end()) == (itNext == m.end()));
+        if (itNext != m.end()) {
+            BOOST_CHECK_EQUAL(it->first, itNext->first);
+        }
+    }
+    BOOST_CHECK(pm.find(1000) == pm.end());
+    BOOST_CHECK(pm.find_value(1000) == nullptr);
+}
+
+BOOST_AUTO_TEST_CASE(persistentmap_copies_are_independent)
+{
+    persistentmap<int, int> a;
+    for (int i = 0; i < 100; i++) {
+        a.set(i, i);
+    }
+
+    persistentmap<int, int> b = a;
+    BOOST_CHECK(b.shares_root_with(a));
+    b.set(50, -50);
+    b.set(200, 200);
+    b.erase(10);
+    BOOST_CHECK(!b.shares_root_with(a));
+
+    // The original is unaffected by changes to the copy
+    BOOST_CHECK_EQUAL(a.size(), 100U);
+    BOOST_CHECK_EQUAL(*a.find_value(50), 50);
+    BOOST_CHECK_EQUAL(a.count(10), 1U);
+    BOOST_CHECK_EQUAL(a.count(200), 0U);
+
+    BOOST_CHECK_EQUAL(b.size(), 100U);
+    BOOST_CHECK_EQUAL(*b.find_value(50), -50);
+    BOOST_CHECK_EQUAL(b.count(10), 0U);
+    BOOST_CHECK_EQUAL(b.count(200), 1U);
+}
+
+BOOST_AUTO_TEST_CASE(persistentmap_serialization_matches_std_map)
+{
+    std::map<uint32_t, uint32_t> m;
+    persistentmap<uint32_t, uint32_t> pm;
+    for (uint32_t i = 0; i < 300; i++) {
+        m[i * 7] = i;
+        pm.set(i * 7, i);
+    }
+
+    CDataStream ss1(SER_DISK, PROTOCOL_VERSION);
+    CDataStream ss2(SER_DISK, PROTOCOL_VERSION);
+    ss1 << m;
+    ss2 << pm;
+    BOOST_CHECK(ss1.str() == ss2.str());
+
+    persistentmap<uint32_t, uint32_t> pm2;
+    ss1 >> pm2;
+    BOOST_CHECK(MapsEqual(pm2, m));
+}
+
+BOOST_AUTO_TEST_SUITE_END()
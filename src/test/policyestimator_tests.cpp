@@ -205,4 +205,72 @@ BOOST_FIXTURE_TEST_SUITE(policyestimator_tests, BasicTestingSetup)
         }
     }
 
+    BOOST_AUTO_TEST_CASE(block_policy_estimates_table_test)
+    {
+        // An estimator whose table is refreshed now and then answers just like
+        // one that works out every estimate when asked
+        CBlockPolicyEstimator feeEst, feeEstRef;
+        CTxMemPool mpool(&feeEst), mpoolRef(&feeEstRef);
+        TestMemPoolEntryHelper entry;
+
+        CMutableTransaction tx;
+        tx.vin.resize(1);
+        tx.vin[0].scriptSig = CScript() << OP_11;
+        tx.vout.resize(1);
+        tx.vout[0].nValue = 0LL;
+
+        auto fnCompare = [&]() {
+            for (int target = 1; target <= 50; target++) {
+                for (bool conservative : {false, true}) {
+                    FeeCalculation feeCalc, feeCalcRef;
+                    BOOST_CHECK(feeEst.estimateSmartFee(target, &feeCalc, conservative) == feeEstRef.estimateSmartFee(target, &feeCalcRef, conservative));
+                    BOOST_CHECK_EQUAL(feeCalc.returnedTarget, feeCalcRef.returnedTarget);
+                    BOOST_CHECK(feeCalc.reason == feeCalcRef.reason);
+                    BOOST_CHECK_EQUAL(feeCalc.est.pass.withinTarget, feeCalcRef.est.pass.withinTarget);
+                }
+            }
+        };
+
+        std::vector<uint256> vHashes;
+        std::vector<CTransactionRef> block, blockRef;
+        for (int blocknum = 0; blocknum < 120; blocknum++) {
+            for (int j = 0; j < 10; j++) {
+                tx.vin[0].prevout.n = 100 * blocknum + j;
+                mpool.addUnchecked(tx.GetHash(), entry.Fee(2000 * (j + 1)).Time(GetTime()).Height(blocknum).FromTx(tx));
+                mpoolRef.addUnchecked(tx.GetHash(), entry.Fee(2000 * (j + 1)).Time(GetTime()).Height(blocknum).FromTx(tx));
+                vHashes.push_back(tx.GetHash());
+            }
+            // Leave the cheapest txs waiting a while, and let some of them go
+            // between blocks, which moves the estimates without a block
+            std::vector<uint256> vWaiting;
+            for (const uint256& hash : vHashes) {
+                CTransactionRef ptx = mpool.get(hash);
+                if (ptx->vin[0].prevout.n % 10 >= 3 || ptx->vin[0].prevout.n / 100 + 5 < (unsigned int)blocknum) {
+                    block.push_back(ptx);
+                    blockRef.push_back(mpoolRef.get(hash));
+                } else {
+                    vWaiting.push_back(hash);
+                }
+            }
+            vHashes = vWaiting;
+            if (blocknum % 7 == 3 && !vHashes.empty()) {
+                feeEst.RefreshEstimates();
+                fnCompare();
+                mpool.removeRecursive(*mpool.get(vHashes.back()));
+                mpoolRef.removeRecursive(*mpoolRef.get(vHashes.back()));
+                vHashes.pop_back();
+                fnCompare();
+            }
+
+            mpool.removeForBlock(block, blocknum + 1);
+            mpoolRef.removeForBlock(blockRef, blocknum + 1);
+            block.clear();
+            blockRef.clear();
+            if (blocknum % 5 == 0)
+                feeEst.RefreshEstimates();
+            fnCompare();
+        }
+        BOOST_CHECK(feeEst.estimateSmartFee(6, nullptr, false) != CFeeRate(0));
+    }
+
 BOOST_AUTO_TEST_SUITE_END()
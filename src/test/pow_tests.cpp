@@ -6,6 +6,7 @@
 #include "chain.h"
 #include "chainparams.h"
 #include "pow.h"
+#include "primitives/block.h"
 #include "random.h"
 #include "util.h"
 #include "test/test_mynta.h"
@@ -96,4 +97,43 @@ BOOST_FIXTURE_TEST_SUITE(pow_tests, BasicTestingSetup)
         }
     }
 
+    BOOST_AUTO_TEST_CASE(block_header_hash_cache_test)
+    {
+        BOOST_TEST_MESSAGE("Running Block Header Hash Cache Test");
+
+        CBlockHeader header;
+        header.nVersion = 4;
+        header.hashPrevBlock = uint256S("0x01");
+        header.hashMerkleRoot = uint256S("0x02");
+        header.nTime = 1569945600 - 1;
+        header.nBits = 0x1e00ffff;
+        header.nNonce = 1;
+
+        // A cached hash must match a freshly computed one
+        uint256 hash = header.GetHash();
+        BOOST_CHECK(hash == header.GetX16RHash());
+        BOOST_CHECK(header.GetHash() == hash);
+
+        // Modifying any field in place invalidates the cache
+        header.nNonce++;
+        BOOST_CHECK(header.GetHash() != hash);
+        BOOST_CHECK(header.GetHash() == header.GetX16RHash());
+        header.nNonce--;
+        BOOST_CHECK(header.GetHash() == hash);
+
+        header.hashMerkleRoot = uint256S("0x03");
+        BOOST_CHECK(header.GetHash() == header.GetX16RHash());
+        header.hashMerkleRoot = uint256S("0x02");
+
+        // Copies carry the cache, CBlock::GetBlockHeader() included
+        CBlock block(header);
+        BOOST_CHECK(block.GetHash() == hash);
+        BOOST_CHECK(block.GetBlockHeader().GetHash() == hash);
+        block.nNonce++;
+        BOOST_CHECK(block.GetBlockHeader().GetHash() == block.GetX16RHash());
+
+        header.SetNull();
+        BOOST_CHECK(header.GetHash() == header.GetX16RHash());
+    }
+
 BOOST_AUTO_TEST_SUITE_END()
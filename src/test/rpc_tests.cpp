@@ -4,7 +4,10 @@
 // file COPYING or http://www.opensource.org/licenses/mit-license.php.
 
 #include "rpc/server.h"
+#include "rpc/binary.h"
 #include "rpc/client.h"
+#include "rpc/jsonstream.h"
+#include "rpc/jsonview.h"
 
 #include "base58.h"
 #include "core_io.h"
@@ -19,6 +22,8 @@
 #include <validation.h>
 #include <consensus/consensus.h>
 
+#include <thread>
+
 UniValue CallRPC(std::string args)
 {
     std::vector<std::string> vArgs;
@@ -390,4 +395,162 @@ BOOST_FIXTURE_TEST_SUITE(rpc_tests, TestingSetup)
         BOOST_CHECK_EQUAL(result[2].get_int(), 9);
     }
 
+    BOOST_AUTO_TEST_CASE(rpc_json_stream_test)
+    {
+        UniValue inner(UniValue::VOBJ);
+        inner.push_back(Pair("a\"b", 1));
+        inner.push_back(Pair("c", UniValue(UniValue::VARR)));
+        UniValue expected(UniValue::VOBJ);
+        expected.push_back(Pair("x", "y"));
+        UniValue arr(UniValue::VARR);
+        arr.push_back(inner);
+        arr.push_back(NullUniValue);
+        arr.push_back(UniValue(UniValue::VOBJ));
+        arr.push_back(inner);
+        expected.push_back(Pair("list", arr));
+        expected.push_back(Pair("z", 2.5));
+
+        // A tiny flush size hands every piece to the sink on its own
+        std::string strOut;
+        int nFlushes = 0;
+        CJSONStreamWriter stream([&](const std::string& strChunk) { strOut += strChunk; nFlushes++; }, 1);
+        BOOST_CHECK(!stream.IsStarted());
+        stream.BeginObject();
+        stream.KeyValue("x", "y");
+        stream.Key("list");
+        stream.BeginArray();
+        stream.Value(inner);
+        stream.Value(NullUniValue);
+        stream.BeginObject();
+        stream.EndObject();
+        stream.RawValue(inner.write());
+        stream.EndArray();
+        BOOST_CHECK(!stream.IsComplete());
+        stream.KeyValue("z", 2.5);
+        stream.EndObject();
+        BOOST_CHECK(stream.IsComplete());
+        stream.Flush();
+
+        BOOST_CHECK_EQUAL(strOut, expected.write());
+        BOOST_CHECK(nFlushes > 1);
+    }
+
+    BOOST_AUTO_TEST_CASE(rpc_json_view_test)
+    {
+        const std::string strJSON = "{\"method\":\"sendmany\",\"params\":[\"\",{\"a\\\"b\":1.5,\"c\":2}],"
+                                    "\"id\":7,\"flag\":true,\"id\":8}";
+        UniValue val;
+        BOOST_CHECK(val.read(strJSON));
+        CJSONDocument doc;
+        BOOST_CHECK(doc.read(strJSON));
+
+        // Test: the view finds the same members find_value does and builds the same UniValues.
+        UniValueView root = doc.Root();
+        BOOST_CHECK(root.isObject());
+        BOOST_CHECK_EQUAL(root.size(), 5U);
+        BOOST_CHECK_EQUAL(root["method"].get_str(), "sendmany");
+        BOOST_CHECK_EQUAL(root["id"].getValStr(), "7");
+        BOOST_CHECK(root["flag"].isTrue());
+        BOOST_CHECK(root["missing"].isNull());
+        BOOST_CHECK_EQUAL(root["params"][1]["a\"b"].getValStr(), "1.5");
+        BOOST_CHECK(root["params"][2].isNull());
+        BOOST_CHECK_EQUAL(root.ToUniValue().write(), val.write());
+
+        // Test: the compact form reads back as the same value.
+        std::string strWritten;
+        root.write(strWritten);
+        UniValue valWritten;
+        BOOST_CHECK(valWritten.read(strWritten));
+        BOOST_CHECK_EQUAL(valWritten.write(), val.write());
+
+        // Test: malformed text is rejected like UniValue::read rejects it.
+        BOOST_CHECK(!doc.read("[1,]"));
+        BOOST_CHECK(doc.Root().isNull());
+        BOOST_CHECK(!doc.read("{\"a\":1}}"));
+        BOOST_CHECK(!doc.read(""));
+    }
+
+    BOOST_AUTO_TEST_CASE(rpc_batch_parallel_test)
+    {
+        std::string strBatch = "[";
+        for (int i = 0; i < 20; i++)
+            strBatch += strprintf("{\"method\":\"getblockcount\",\"id\":%d},", i);
+        strBatch += "{\"method\":\"nosuchmethod\",\"id\":20},{\"method\":\"getbestblockhash\",\"id\":21}]";
+        CJSONDocument doc;
+        BOOST_CHECK(doc.read(strBatch));
+
+        // Test: helpers on other threads take calls, and the replies stay in order.
+        std::vector<std::thread> vHelpers;
+        RPCBatchSpawn spawn = [&](const std::function<void()>& task) {
+            vHelpers.emplace_back(task);
+            return true;
+        };
+        JSONRPCRequest jreq;
+        UniValue reply;
+        BOOST_CHECK(reply.read(JSONRPCExecBatch(jreq, doc.Root(), spawn, 3)));
+        for (std::thread& helper : vHelpers)
+            helper.join();
+        BOOST_CHECK_EQUAL(vHelpers.size(), 3U);
+        BOOST_CHECK_EQUAL(reply.size(), 22U);
+        for (int i = 0; i < 22; i++)
+            BOOST_CHECK_EQUAL(find_value(reply[i], "id").get_int(), i);
+        BOOST_CHECK_EQUAL(find_value(reply[5], "result").get_int(), chainActive.Height());
+        BOOST_CHECK_EQUAL(find_value(find_value(reply[20], "error"), "code").get_int(), RPC_METHOD_NOT_FOUND);
+        BOOST_CHECK_EQUAL(find_value(reply[21], "result").get_str(), chainActive.Tip()->GetBlockHash().GetHex());
+
+        // Test: without a way to spawn helpers the same batch runs on the calling thread.
+        UniValue replySerial;
+        BOOST_CHECK(replySerial.read(JSONRPCExecBatch(jreq, doc.Root())));
+        BOOST_CHECK_EQUAL(replySerial.write(), reply.write());
+    }
+
+BOOST_AUTO_TEST_CASE(rpc_binary_calls)
+{
+    std::string strStatus;
+    if (RPCIsInWarmup(&strStatus))
+        SetRPCWarmupFinished();
+
+    std::vector<CBinaryRPCCall> vCalls(3);
+    vCalls[0].nId = 7;
+    vCalls[0].strMethod = "getblockheader";
+    CDataStream ssParams(SER_NETWORK, PROTOCOL_VERSION);
+    ssParams << chainActive.Genesis()->GetBlockHash();
+    vCalls[0].vParams.assign(ssParams.begin(), ssParams.end());
+    vCalls[1].nId = 3;
+    vCalls[1].strMethod = "nosuchmethod";
+    // Parameters that end too soon
+    vCalls[2].nId = 5;
+    vCalls[2].strMethod = "getblockheader";
+    vCalls[2].vParams.resize(4);
+
+    CDataStream ssRequest(SER_NETWORK, PROTOCOL_VERSION);
+    ssRequest << vCalls;
+    const std::string strReply = ExecuteBinaryRPC(ssRequest.str());
+    CDataStream ssReply(strReply.data(), strReply.data() + strReply.size(), SER_NETWORK, PROTOCOL_VERSION);
+    std::vector<CBinaryRPCReply> vReplies;
+    ssReply >> vReplies;
+
+    // Test: every call is answered in order, a failing one only failing its own reply.
+    BOOST_CHECK_EQUAL(vReplies.size(), 3U);
+    BOOST_CHECK_EQUAL(vReplies[0].nId, 7U);
+    BOOST_CHECK_EQUAL(vReplies[0].nCode, 0);
+    CDataStream ssResult(vReplies[0].vResult, SER_NETWORK, PROTOCOL_VERSION);
+    CBlockHeader header;
+    int32_t nHeight, nConfirmations;
+    ssResult >> header >> nHeight >> nConfirmations;
+    BOOST_CHECK(header.GetHash() == chainActive.Genesis()->GetBlockHash());
+    BOOST_CHECK_EQUAL(nHeight, 0);
+    BOOST_CHECK_EQUAL(nConfirmations, chainActive.Height() + 1);
+    BOOST_CHECK_EQUAL(vReplies[1].nId, 3U);
+    BOOST_CHECK_EQUAL(vReplies[1].nCode, RPC_METHOD_NOT_FOUND);
+    BOOST_CHECK_EQUAL(vReplies[2].nId, 5U);
+    BOOST_CHECK_EQUAL(vReplies[2].nCode, RPC_INVALID_PARAMS);
+
+    // Test: a truncated body, or too many calls, fails the whole request.
+    BOOST_CHECK_THROW(ExecuteBinaryRPC(ssRequest.str().substr(0, 10)), std::ios_base::failure);
+    CDataStream ssTooMany(SER_NETWORK, PROTOCOL_VERSION);
+    WriteCompactSize(ssTooMany, MAX_BINARY_RPC_CALLS + 1);
+    BOOST_CHECK_THROW(ExecuteBinaryRPC(ssTooMany.str()), std::ios_base::failure);
+}
+
 BOOST_AUTO_TEST_SUITE_END()
@@ -14,6 +14,9 @@ using namespace boost::placeholders;
 #include <boost/thread.hpp>
 #include <boost/test/unit_test.hpp>
 
+#include <algorithm>
+#include <vector>
+
 BOOST_AUTO_TEST_SUITE(scheduler_tests)
 
     static void microTask(CScheduler &s, boost::mutex &mutex, int &counter, int delta, boost::chrono::system_clock::time_point rescheduleTime)
@@ -124,4 +127,63 @@ BOOST_AUTO_TEST_SUITE(scheduler_tests)
         BOOST_CHECK_EQUAL(counterSum, 200);
     }
 
+    static void orderedTask(boost::mutex &mutex, std::vector<int> &order, int n)
+    {
+        boost::unique_lock<boost::mutex> lock(mutex);
+        order.push_back(n);
+    }
+
+    BOOST_AUTO_TEST_CASE(wheel_order_and_stats)
+    {
+        CScheduler scheduler;
+        boost::mutex orderMutex;
+        std::vector<int> order;
+
+        // Tasks spread over the two lowest levels of the wheel and one due
+        // already, scheduled out of order; the task ten hours out is beyond
+        // the top level.
+        const int offsets[] = {150, 3, 70, -5, 64, 0, 200, 1, 130, 63};
+        boost::chrono::system_clock::time_point now = boost::chrono::system_clock::now();
+        for (int offset : offsets)
+            scheduler.schedule(boost::bind(&orderedTask, boost::ref(orderMutex), boost::ref(order), offset),
+                               now + boost::chrono::milliseconds(offset), offset % 2 ? "odd" : "even");
+        boost::chrono::system_clock::time_point farTime = now + boost::chrono::hours(10);
+        scheduler.schedule(boost::bind(&orderedTask, boost::ref(orderMutex), boost::ref(order), -1), farTime, "far");
+
+        boost::chrono::system_clock::time_point first, last;
+        BOOST_CHECK_EQUAL(scheduler.getQueueInfo(first, last), 11U);
+        BOOST_CHECK(first == now - boost::chrono::milliseconds(5));
+        BOOST_CHECK(last == farTime);
+        std::map<std::string, CSchedulerTaskStats> stats = scheduler.GetTaskStats();
+        BOOST_CHECK_EQUAL(stats.size(), 3U);
+        BOOST_CHECK_EQUAL(stats["even"].nQueued, 6U);
+        BOOST_CHECK_EQUAL(stats["odd"].nQueued, 4U);
+        BOOST_CHECK_EQUAL(stats["far"].nQueued, 1U);
+
+        boost::thread serviceThread(boost::bind(&CScheduler::serviceQueue, &scheduler));
+        scheduler.scheduleFromNow(boost::bind(&CScheduler::stop, &scheduler, false), 400, "stop");
+        serviceThread.join();
+
+        // Test: each task ran once, no earlier than it was due, in the order it was due.
+        std::vector<int> sorted(std::begin(offsets), std::end(offsets));
+        std::sort(sorted.begin(), sorted.end());
+        BOOST_CHECK(order == sorted);
+        BOOST_CHECK_EQUAL(scheduler.getQueueInfo(first, last), 1U);
+
+        stats = scheduler.GetTaskStats();
+        BOOST_CHECK_EQUAL(stats["even"].lateness.nCount, 6U);
+        BOOST_CHECK_EQUAL(stats["odd"].runtime.nCount, 4U);
+        BOOST_CHECK_EQUAL(stats["odd"].nQueued, 0U);
+        BOOST_CHECK_EQUAL(stats["far"].lateness.nCount, 0U);
+        BOOST_CHECK_EQUAL(stats["far"].nQueued, 1U);
+        BOOST_CHECK_EQUAL(stats["stop"].lateness.nCount, 1U);
+        // The task due 5ms before it was scheduled was at least that late
+        BOOST_CHECK(stats["odd"].lateness.nMaxMicros >= 5000);
+
+        scheduler.ResetTaskStats();
+        stats = scheduler.GetTaskStats();
+        BOOST_CHECK_EQUAL(stats["even"].lateness.nCount, 0U);
+        BOOST_CHECK_EQUAL(stats["far"].nQueued, 1U);
+    }
+
 BOOST_AUTO_TEST_SUITE_END()
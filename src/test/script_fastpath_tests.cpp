@@ -0,0 +1,177 @@
+// Copyright (c) 2026 The Mynta Core Developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include "key.h"
+#include "policy/policy.h"
+#include "script/interpreter.h"
+#include "script/script.h"
+#include "script/script_error.h"
+#include "script/standard.h"
+#include "test/test_mynta.h"
+
+#include <boost/test/unit_test.hpp>
+
+BOOST_FIXTURE_TEST_SUITE(script_fastpath_tests, BasicTestingSetup)
+
+static const unsigned int FLAG_SETS[] = {
+    SCRIPT_VERIFY_NONE,
+    SCRIPT_VERIFY_P2SH,
+    MANDATORY_SCRIPT_VERIFY_FLAGS,
+    STANDARD_SCRIPT_VERIFY_FLAGS,
+};
+
+/** A spend of one output, signed for its script */
+struct FastPathSpend
+{
+    CScript scriptPubKey;
+    CScript scriptSig;
+    CMutableTransaction txSpend;
+};
+
+static CMutableTransaction SpendingTransaction(const CScript& scriptPubKey)
+{
+    CMutableTransaction txCredit;
+    txCredit.nVersion = 1;
+    txCredit.vin.resize(1);
+    txCredit.vin[0].prevout.SetNull();
+    txCredit.vin[0].scriptSig = CScript() << CScriptNum(0) << CScriptNum(0);
+    txCredit.vout.resize(1);
+    txCredit.vout[0].scriptPubKey = scriptPubKey;
+
+    CMutableTransaction txSpend;
+    txSpend.nVersion = 1;
+    txSpend.vin.resize(1);
+    txSpend.vin[0].prevout = COutPoint(txCredit.GetHash(), 0);
+    txSpend.vout.resize(1);
+    return txSpend;
+}
+
+static std::vector<unsigned char> Sign(const CKey& key, const CScript& scriptCode, const CMutableTransaction& txSpend)
+{
+    uint256 hash = SignatureHash(scriptCode, txSpend, 0, SIGHASH_ALL, 0, SIGVERSION_BASE);
+    std::vector<unsigned char> vchSig;
+    BOOST_CHECK(key.Sign(hash, vchSig));
+    vchSig.push_back(SIGHASH_ALL);
+    return vchSig;
+}
+
+/** Check the fast path and the interpreter agree on a pair, under every set of flags */
+static void CheckSameResult(const FastPathSpend& spend, const CScript& scriptSig, const CScript& scriptPubKey)
+{
+    MutableTransactionSignatureChecker checker(&spend.txSpend, 0, 0);
+    for (unsigned int flags : FLAG_SETS) {
+        ScriptError errFast, errFull;
+        bool fFast = VerifyScript(scriptSig, scriptPubKey, nullptr, flags, checker, &errFast);
+        bool fFull = VerifyScriptInterpreted(scriptSig, scriptPubKey, nullptr, flags, checker, &errFull);
+        BOOST_CHECK_MESSAGE(fFast == fFull && errFast == errFull,
+                            "fast path disagrees on " << HexStr(scriptSig) << " / " << HexStr(scriptPubKey) << " with flags " << flags
+                            << ": " << ScriptErrorString(errFast) << " vs " << ScriptErrorString(errFull));
+    }
+}
+
+static CScript Mutate(const CScript& script)
+{
+    std::vector<unsigned char> vch(script.begin(), script.end());
+    switch (InsecureRandRange(4)) {
+        case 0: // flip a bit
+            if (!vch.empty())
+                vch[InsecureRandRange(vch.size())] ^= 1 << InsecureRandRange(8);
+            break;
+        case 1: // cut the end off
+            if (!vch.empty())
+                vch.resize(InsecureRandRange(vch.size()));
+            break;
+        case 2: // append an opcode
+            vch.push_back(InsecureRandBits(8));
+            break;
+        case 3: // change a byte
+            if (!vch.empty())
+                vch[InsecureRandRange(vch.size())] = InsecureRandBits(8);
+            break;
+    }
+    return CScript(vch.begin(), vch.end());
+}
+
+BOOST_AUTO_TEST_CASE(fastpath_matches_interpreter)
+{
+    SeedInsecureRand(true);
+
+    std::vector<CKey> keys(3);
+    for (size_t i = 0; i < keys.size(); i++)
+        keys[i].MakeNewKey(i != 2);
+
+    std::vector<FastPathSpend> spends;
+
+    // P2PKH, with compressed and uncompressed keys
+    for (const CKey& key : {keys[0], keys[2]}) {
+        FastPathSpend spend;
+        spend.scriptPubKey = GetScriptForDestination(key.GetPubKey().GetID());
+        spend.txSpend = SpendingTransaction(spend.scriptPubKey);
+        spend.scriptSig = CScript() << Sign(key, spend.scriptPubKey, spend.txSpend) << ToByteVector(key.GetPubKey());
+        spends.push_back(spend);
+    }
+
+    // P2PKH holding an asset transfer
+    {
+        FastPathSpend spend;
+        std::vector<unsigned char> vchAsset = {'r', 'v', 'n', 't'};
+        vchAsset.resize(40, 0x42);
+        spend.scriptPubKey = GetScriptForDestination(keys[1].GetPubKey().GetID()) << OP_RVN_ASSET << vchAsset << OP_DROP;
+        spend.txSpend = SpendingTransaction(spend.scriptPubKey);
+        spend.scriptSig = CScript() << Sign(keys[1], spend.scriptPubKey, spend.txSpend) << ToByteVector(keys[1].GetPubKey());
+        spends.push_back(spend);
+    }
+
+    // P2SH 2-of-3 multisig
+    {
+        FastPathSpend spend;
+        CScript redeemScript = GetScriptForMultisig(2, {keys[0].GetPubKey(), keys[1].GetPubKey(), keys[2].GetPubKey()});
+        spend.scriptPubKey = GetScriptForDestination(CScriptID(redeemScript));
+        spend.txSpend = SpendingTransaction(spend.scriptPubKey);
+        spend.scriptSig = CScript() << OP_0 << Sign(keys[0], redeemScript, spend.txSpend) << Sign(keys[2], redeemScript, spend.txSpend)
+                                    << std::vector<unsigned char>(redeemScript.begin(), redeemScript.end());
+        spends.push_back(spend);
+    }
+
+    for (const FastPathSpend& spend : spends) {
+        // The valid spends take the fast path
+        MutableTransactionSignatureChecker checker(&spend.txSpend, 0, 0);
+        for (unsigned int flags : FLAG_SETS) {
+            if (spend.scriptPubKey.IsPayToScriptHash() && !(flags & SCRIPT_VERIFY_P2SH))
+                continue;
+            BOOST_CHECK(VerifyStandardScript(spend.scriptSig, spend.scriptPubKey, nullptr, flags, checker));
+        }
+        CheckSameResult(spend, spend.scriptSig, spend.scriptPubKey);
+
+        // And whatever they are mutated into, both paths give the same answer
+        for (int i = 0; i < 300; i++) {
+            CScript scriptSig = spend.scriptSig;
+            CScript scriptPubKey = spend.scriptPubKey;
+            if (InsecureRandBool())
+                scriptSig = Mutate(scriptSig);
+            else
+                scriptPubKey = Mutate(scriptPubKey);
+            CheckSameResult(spend, scriptSig, scriptPubKey);
+        }
+    }
+
+    // Non-minimal pushes, a signature for another key, signatures out of order
+    const FastPathSpend& p2pkh = spends[0];
+    std::vector<unsigned char> vchSig = Sign(keys[0], p2pkh.scriptPubKey, p2pkh.txSpend);
+    CScript nonMinimal = CScript() << OP_PUSHDATA1 << std::vector<unsigned char>(1, vchSig.size());
+    nonMinimal.insert(nonMinimal.end(), vchSig.begin(), vchSig.end());
+    nonMinimal << ToByteVector(keys[0].GetPubKey());
+    CheckSameResult(p2pkh, nonMinimal, p2pkh.scriptPubKey);
+    CheckSameResult(p2pkh, CScript() << Sign(keys[1], p2pkh.scriptPubKey, p2pkh.txSpend) << ToByteVector(keys[0].GetPubKey()), p2pkh.scriptPubKey);
+    CheckSameResult(p2pkh, CScript() << std::vector<unsigned char>() << ToByteVector(keys[0].GetPubKey()), p2pkh.scriptPubKey);
+
+    const FastPathSpend& multisig = spends.back();
+    CScript redeemScript = GetScriptForMultisig(2, {keys[0].GetPubKey(), keys[1].GetPubKey(), keys[2].GetPubKey()});
+    std::vector<unsigned char> vchRedeem(redeemScript.begin(), redeemScript.end());
+    CheckSameResult(multisig, CScript() << OP_0 << Sign(keys[2], redeemScript, multisig.txSpend) << Sign(keys[0], redeemScript, multisig.txSpend) << vchRedeem, multisig.scriptPubKey);
+    CheckSameResult(multisig, CScript() << OP_1 << Sign(keys[0], redeemScript, multisig.txSpend) << Sign(keys[2], redeemScript, multisig.txSpend) << vchRedeem, multisig.scriptPubKey);
+    CheckSameResult(multisig, CScript() << OP_0 << Sign(keys[0], redeemScript, multisig.txSpend) << vchRedeem, multisig.scriptPubKey);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -126,6 +126,24 @@ BOOST_FIXTURE_TEST_SUITE(script_standard_tests, BasicTestingSetup)
         BOOST_CHECK_EQUAL(solutions.size(), (uint64_t)1);
         BOOST_CHECK(solutions[0] == ToByteVector(scriptHash));
 
+        // TX_HTLC
+        std::vector<unsigned char> hashLock(32, 0x42);
+        for (int64_t nTimeLock : {(int64_t)0, (int64_t)100, (int64_t)0xffffffff}) {
+            s.clear();
+            s << OP_IF << OP_SHA256 << hashLock << OP_EQUALVERIFY
+              << OP_DUP << OP_HASH160 << ToByteVector(pubkeys[0].GetID()) << OP_EQUALVERIFY << OP_CHECKSIG
+              << OP_ELSE << CScriptNum(nTimeLock) << OP_CHECKLOCKTIMEVERIFY << OP_DROP
+              << OP_DUP << OP_HASH160 << ToByteVector(pubkeys[1].GetID()) << OP_EQUALVERIFY << OP_CHECKSIG
+              << OP_ENDIF;
+            BOOST_CHECK(Solver(s, whichType, solutions));
+            BOOST_CHECK_EQUAL(whichType, TX_HTLC);
+            BOOST_CHECK_EQUAL(solutions.size(), (uint64_t)4);
+            BOOST_CHECK(solutions[0] == hashLock);
+            BOOST_CHECK(solutions[1] == ToByteVector(pubkeys[0].GetID()));
+            BOOST_CHECK(solutions[2] == CScriptNum(nTimeLock).getvch());
+            BOOST_CHECK(solutions[3] == ToByteVector(pubkeys[1].GetID()));
+        }
+
         // TX_NONSTANDARD
         s.clear();
         s << OP_9 << OP_ADD << OP_11 << OP_EQUAL;
@@ -200,6 +218,24 @@ BOOST_FIXTURE_TEST_SUITE(script_standard_tests, BasicTestingSetup)
         s.clear();
         s << OP_0 << std::vector<unsigned char>(19, 0x01);
         BOOST_CHECK(!Solver(s, whichType, solutions));
+
+        // TX_HTLC with a 6 byte lock height
+        s.clear();
+        s << OP_IF << OP_SHA256 << std::vector<unsigned char>(32, 0x42) << OP_EQUALVERIFY
+          << OP_DUP << OP_HASH160 << ToByteVector(pubkey.GetID()) << OP_EQUALVERIFY << OP_CHECKSIG
+          << OP_ELSE << std::vector<unsigned char>(6, 0x01) << OP_CHECKLOCKTIMEVERIFY << OP_DROP
+          << OP_DUP << OP_HASH160 << ToByteVector(pubkey.GetID()) << OP_EQUALVERIFY << OP_CHECKSIG
+          << OP_ENDIF;
+        BOOST_CHECK(!Solver(s, whichType, solutions));
+
+        // TX_HTLC with OP_CHECKSEQUENCEVERIFY instead of OP_CHECKLOCKTIMEVERIFY
+        s.clear();
+        s << OP_IF << OP_SHA256 << std::vector<unsigned char>(32, 0x42) << OP_EQUALVERIFY
+          << OP_DUP << OP_HASH160 << ToByteVector(pubkey.GetID()) << OP_EQUALVERIFY << OP_CHECKSIG
+          << OP_ELSE << CScriptNum(100) << OP_CHECKSEQUENCEVERIFY << OP_DROP
+          << OP_DUP << OP_HASH160 << ToByteVector(pubkey.GetID()) << OP_EQUALVERIFY << OP_CHECKSIG
+          << OP_ENDIF;
+        BOOST_CHECK(!Solver(s, whichType, solutions));
     }
 
     BOOST_AUTO_TEST_CASE(script_standard_extractdestination_test)
@@ -1143,6 +1143,28 @@ BOOST_FIXTURE_TEST_SUITE(script_tests, BasicTestingSetup)
         BOOST_CHECK_MESSAGE(err == SCRIPT_ERR_OK, ScriptErrorString(err));
     }
 
+    BOOST_AUTO_TEST_CASE(script_stack_buffer_reuse_test)
+    {
+        // Popped elements hand their buffers to later pushes; nothing of the
+        // old contents may show through in what is pushed into them.
+        std::vector<unsigned char> vchLong(72, 0xab);
+        CScript script = CScript() << vchLong << OP_DUP << OP_2DROP << std::vector<unsigned char>(3, 0x01) << OP_SIZE
+                                   << OP_TOALTSTACK << OP_HASH160 << OP_FROMALTSTACK << OP_0 << OP_OVER;
+
+        std::vector<unsigned char> vchHash(20);
+        std::vector<unsigned char> vchShort(3, 0x01);
+        CHash160().Write(vchShort.data(), vchShort.size()).Finalize(vchHash.data());
+        const std::vector<std::vector<unsigned char> > expected = {vchHash, {3}, {}, {3}};
+
+        for (int i = 0; i < 3; i++) {
+            ScriptError err;
+            std::vector<std::vector<unsigned char> > stack;
+            BOOST_CHECK(EvalScript(stack, script, SCRIPT_VERIFY_MINIMALDATA, BaseSignatureChecker(), SIGVERSION_BASE, &err));
+            BOOST_CHECK_MESSAGE(err == SCRIPT_ERR_OK, ScriptErrorString(err));
+            BOOST_CHECK(stack == expected);
+        }
+    }
+
     CScript
     sign_multisig(CScript scriptPubKey, std::vector<CKey> keys, CTransaction transaction)
     {
@@ -168,6 +168,31 @@ BOOST_FIXTURE_TEST_SUITE(sighash_tests, BasicTestingSetup)
     #endif
     }
 
+    // Goal: check that hashing from the precomputed legacy state gives the same hash for every input
+    BOOST_AUTO_TEST_CASE(sighash_precomputed_test)
+    {
+        SeedInsecureRand(false);
+
+        for (int i = 0; i < 5000; i++)
+        {
+            int nHashType = InsecureRand32();
+            CMutableTransaction txTo;
+            RandomTransaction(txTo, (nHashType & 0x1f) == SIGHASH_SINGLE);
+            const CTransaction tx(txTo);
+            PrecomputedTransactionData txdata(tx);
+            BOOST_CHECK_EQUAL(txdata.legacyReady, tx.vin.size() > 1);
+            CScript scriptCode;
+            RandomScript(scriptCode);
+
+            for (unsigned int nIn = 0; nIn < tx.vin.size(); nIn++)
+            {
+                uint256 sho = SignatureHashOld(scriptCode, tx, nIn, nHashType);
+                BOOST_CHECK(SignatureHash(scriptCode, tx, nIn, nHashType, 0, SIGVERSION_BASE, &txdata) == sho);
+                BOOST_CHECK(SignatureHash(scriptCode, tx, nIn, nHashType & ~0x9f, 0, SIGVERSION_BASE, &txdata) == SignatureHashOld(scriptCode, tx, nIn, nHashType & ~0x9f));
+            }
+        }
+    }
+
     // Goal: check that signature_hash generates correct hash
     BOOST_AUTO_TEST_CASE(sighash_from_data_test)
     {
@@ -0,0 +1,47 @@
+// Copyright (c) 2026 The Mynta Core Developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include "stratum.h"
+
+#include "test/test_mynta.h"
+
+#include <boost/test/unit_test.hpp>
+
+BOOST_FIXTURE_TEST_SUITE(stratum_tests, BasicTestingSetup)
+
+BOOST_AUTO_TEST_CASE(stratum_share_target)
+{
+    const arith_uint256 powLimit = UintToArith256(uint256S("00000000ffffffffffffffffffffffffffffffffffffffffffffffffffffffff"));
+    arith_uint256 blockTarget;
+    blockTarget.SetCompact(0x1c00ffff);
+
+    BOOST_CHECK(GetStratumShareTarget(powLimit, 0, blockTarget) == powLimit);
+    BOOST_CHECK(GetStratumShareTarget(powLimit, 1, blockTarget) == powLimit);
+    BOOST_CHECK(GetStratumShareTarget(powLimit, 256, blockTarget) == (powLimit >> 8));
+    // Shares are never harder than a block, so every block found gets submitted
+    BOOST_CHECK(GetStratumShareTarget(powLimit, 1ULL << 40, blockTarget) == blockTarget);
+}
+
+BOOST_AUTO_TEST_CASE(stratum_parse)
+{
+    uint64_t nNonce;
+    BOOST_CHECK(ParseStratumNonce("0x00ff00ff00ff00ff", nNonce));
+    BOOST_CHECK_EQUAL(nNonce, 0x00ff00ff00ff00ffULL);
+    BOOST_CHECK(ParseStratumNonce("deadbeef", nNonce));
+    BOOST_CHECK_EQUAL(nNonce, 0xdeadbeefULL);
+    BOOST_CHECK(!ParseStratumNonce("0x", nNonce));
+    BOOST_CHECK(!ParseStratumNonce("0x00ff00ff00ff00ff00", nNonce));
+    BOOST_CHECK(!ParseStratumNonce("0xnothex", nNonce));
+
+    const std::string strHash = "0f1e2d3c4b5a69788796a5b4c3d2e1f00f1e2d3c4b5a69788796a5b4c3d2e1f0";
+    uint256 hash;
+    BOOST_CHECK(ParseStratumHash("0x" + strHash, hash));
+    BOOST_CHECK_EQUAL(hash.GetHex(), strHash);
+    BOOST_CHECK(ParseStratumHash(strHash, hash));
+    BOOST_CHECK_EQUAL(hash.GetHex(), strHash);
+    BOOST_CHECK(!ParseStratumHash(strHash.substr(2), hash));
+    BOOST_CHECK(!ParseStratumHash("0x" + strHash.substr(2) + "zz", hash));
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -125,4 +125,38 @@ BOOST_FIXTURE_TEST_SUITE(streams_tests, BasicTestingSetup)
                 std::string(ds.begin(), ds.end()));
     }
 
+    BOOST_AUTO_TEST_CASE(streams_xor_span_reader_test)
+    {
+        BOOST_TEST_MESSAGE("Running Streams Xor Span Reader Test");
+
+        // Whatever the reads are split into, the key follows the position in the range
+        std::vector<unsigned char> key{0x12, 0x34, 0x56};
+        CDataStream ds(SER_DISK, 0);
+        ds << uint8_t(0xab) << uint32_t(0xdeadbeef) << std::string("obfuscated") << uint16_t(0x0102);
+        ds.Xor(key);
+        std::vector<unsigned char> stored(ds.begin(), ds.end());
+
+        CXorSpanReader reader(SER_DISK, 0, stored.data(), stored.size(), key);
+        uint8_t a;
+        uint32_t b;
+        uint16_t d;
+        reader >> a >> b;
+        reader.ignore(1);
+        char c[10];
+        reader.read(c, sizeof(c));
+        reader >> d;
+        BOOST_CHECK_EQUAL(a, 0xab);
+        BOOST_CHECK_EQUAL(b, 0xdeadbeef);
+        BOOST_CHECK_EQUAL(std::string(c, sizeof(c)), "obfuscated");
+        BOOST_CHECK_EQUAL(d, 0x0102);
+        BOOST_CHECK(reader.empty());
+        BOOST_CHECK_THROW(reader >> a, std::ios_base::failure);
+
+        // An empty key reads the bytes as they are
+        std::vector<unsigned char> noKey;
+        CXorSpanReader plain(SER_DISK, 0, stored.data(), 1, noKey);
+        plain >> a;
+        BOOST_CHECK_EQUAL(a, 0xab ^ 0x12);
+    }
+
 BOOST_AUTO_TEST_SUITE_END()
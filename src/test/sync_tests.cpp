@@ -0,0 +1,78 @@
+// Copyright (c) 2026 The Mynta Core Developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include "sync.h"
+#include "utiltime.h"
+
+#include "test/test_mynta.h"
+
+#include <string.h>
+#include <vector>
+
+#include <boost/test/unit_test.hpp>
+#include <boost/thread.hpp>
+
+BOOST_FIXTURE_TEST_SUITE(sync_tests, BasicTestingSetup)
+
+/** Sites of LOCKs naming pszName, in the order they were first run */
+static std::vector<CLockSite*> FindLockSites(const char* pszName)
+{
+    std::vector<CLockSite*> vSites;
+    for (CLockSite* psite = GetLockSites(); psite; psite = psite->pnext) {
+        if (strcmp(psite->pszName, pszName) == 0)
+            vSites.insert(vSites.begin(), psite);
+    }
+    return vSites;
+}
+
+BOOST_AUTO_TEST_CASE(lock_site_holds_test)
+{
+    CCriticalSection csSyncTest;
+    for (int i = 0; i < 3; i++) {
+        LOCK(csSyncTest);
+        // Taking the lock again is counted, but the hold is the outer LOCK's
+        LOCK(csSyncTest);
+    }
+
+    std::vector<CLockSite*> vSites = FindLockSites("csSyncTest");
+    BOOST_REQUIRE_EQUAL(vSites.size(), 2U);
+    BOOST_CHECK(strstr(vSites[0]->pszFile, "sync_tests.cpp"));
+    BOOST_CHECK_EQUAL(vSites[1]->nLine, vSites[0]->nLine + 2);
+    for (const CLockSite* psite : vSites) {
+        BOOST_CHECK_EQUAL(psite->nAcquisitions, 3U);
+        BOOST_CHECK_EQUAL(psite->nContentions, 0U);
+    }
+    BOOST_CHECK_EQUAL(vSites[0]->nHolds, 3U);
+    BOOST_CHECK_EQUAL(vSites[1]->nHolds, 0U);
+
+    vSites[0]->Reset();
+    BOOST_CHECK_EQUAL(vSites[0]->nAcquisitions, 0U);
+    BOOST_CHECK_EQUAL(vSites[0]->nHolds, 0U);
+    BOOST_CHECK_EQUAL(vSites[0]->nHoldMicros, 0);
+}
+
+BOOST_AUTO_TEST_CASE(lock_site_contention_test)
+{
+    CCriticalSection csContended;
+    boost::thread thread;
+    {
+        LOCK(csContended);
+        thread = boost::thread([&csContended] {
+            LOCK(csContended);
+        });
+        MilliSleep(50);
+    }
+    thread.join();
+
+    std::vector<CLockSite*> vSites = FindLockSites("csContended");
+    BOOST_REQUIRE_EQUAL(vSites.size(), 2U);
+    // The thread had to wait until the lock had been held for 50ms
+    BOOST_CHECK_EQUAL(vSites[0]->nContentions, 0U);
+    BOOST_CHECK(vSites[0]->nHoldMicros >= 50000);
+    BOOST_CHECK_EQUAL(vSites[1]->nContentions, 1U);
+    BOOST_CHECK(vSites[1]->nWaitMicros > 0);
+    BOOST_CHECK_EQUAL(vSites[1]->nHolds, 1U);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
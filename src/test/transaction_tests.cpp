@@ -295,6 +295,15 @@ BOOST_FIXTURE_TEST_SUITE(transaction_tests, BasicTestingSetup)
         // Check that duplicate txins fail
         tx.vin.push_back(tx.vin[0]);
         BOOST_CHECK_MESSAGE(!CheckTransaction(tx, state) || !state.IsValid(), "Transaction with duplicate txins should be invalid.");
+
+        // Same for a transaction with too many inputs to compare pairwise
+        tx.vin.resize(1);
+        for (uint32_t i = 0; i < 1000; i++)
+            tx.vin.push_back(CTxIn(COutPoint(tx.vin[0].prevout.hash, i + 1)));
+        CValidationState stateLarge;
+        BOOST_CHECK_MESSAGE(CheckTransaction(tx, stateLarge) && stateLarge.IsValid(), "Transaction with distinct txins should be valid.");
+        tx.vin.push_back(tx.vin[500]);
+        BOOST_CHECK_MESSAGE(!CheckTransaction(tx, stateLarge) && stateLarge.GetRejectReason() == "bad-txns-inputs-duplicate", "Transaction with duplicate txins should be invalid.");
     }
 
     //
@@ -437,6 +446,86 @@ BOOST_FIXTURE_TEST_SUITE(transaction_tests, BasicTestingSetup)
         script = PushAll(stack);
     }
 
+    BOOST_AUTO_TEST_CASE(cached_properties_test)
+    {
+        CMutableTransaction mtx;
+        mtx.vin.resize(2);
+        mtx.vin[0].prevout = COutPoint(InsecureRand256(), 0);
+        mtx.vin[0].scriptSig << OP_1 << OP_CHECKSIG;
+        mtx.vin[1].prevout = COutPoint(InsecureRand256(), 1);
+        mtx.vout.resize(1);
+        mtx.vout[0].nValue = CENT;
+        mtx.vout[0].scriptPubKey << OP_2 << OP_CHECKMULTISIG;
+
+        const CTransaction tx(mtx);
+        BOOST_CHECK(!tx.HasWitness());
+        BOOST_CHECK_EQUAL(tx.GetBaseSize(), ::GetSerializeSize(tx, SER_NETWORK, PROTOCOL_VERSION | SERIALIZE_TRANSACTION_NO_WITNESS));
+        BOOST_CHECK_EQUAL(tx.GetTotalSize(), tx.GetBaseSize());
+        BOOST_CHECK_EQUAL(GetTransactionWeight(tx), tx.GetBaseSize() * WITNESS_SCALE_FACTOR);
+        BOOST_CHECK_EQUAL(tx.GetLegacySigOpCount(), 1U + MAX_PUBKEYS_PER_MULTISIG);
+        BOOST_CHECK(!tx.HasAssetOutputs());
+        BOOST_CHECK(!tx.HasNullAssetOutputs());
+
+        // A witness only counts towards the total size
+        mtx.vin[1].scriptWitness.stack.push_back(std::vector<unsigned char>(100, 1));
+        const CTransaction txWitness(mtx);
+        BOOST_CHECK(txWitness.HasWitness());
+        BOOST_CHECK_EQUAL(txWitness.GetBaseSize(), tx.GetBaseSize());
+        BOOST_CHECK_EQUAL(txWitness.GetTotalSize(), ::GetSerializeSize(txWitness, SER_NETWORK, PROTOCOL_VERSION));
+        BOOST_CHECK(txWitness.GetTotalSize() > txWitness.GetBaseSize());
+
+        // The deserializing constructor caches the same values
+        CDataStream ss(SER_NETWORK, PROTOCOL_VERSION);
+        ss << txWitness;
+        const CTransaction txRead(deserialize, ss);
+        BOOST_CHECK_EQUAL(txRead.GetTotalSize(), txWitness.GetTotalSize());
+        BOOST_CHECK_EQUAL(txRead.GetBaseSize(), txWitness.GetBaseSize());
+        BOOST_CHECK_EQUAL(txRead.GetLegacySigOpCount(), txWitness.GetLegacySigOpCount());
+    }
+
+    BOOST_AUTO_TEST_CASE(block_transactions_from_chunks_test)
+    {
+        // Enough transactions to fill several chunks
+        CBlock block;
+        for (int i = 0; i < 100; i++) {
+            CMutableTransaction mtx;
+            mtx.vin.resize(1);
+            mtx.vin[0].prevout = COutPoint(InsecureRand256(), i);
+            mtx.vin[0].scriptSig = CScript() << std::vector<unsigned char>(InsecureRandRange(100), i);
+            mtx.vout.resize(1);
+            mtx.vout[0].nValue = i;
+            block.vtx.push_back(MakeTransactionRef(std::move(mtx)));
+        }
+        CDataStream ss(SER_NETWORK, PROTOCOL_VERSION);
+        ss << block;
+
+        CTransactionRef txKept;
+        {
+            CBlock blockRead;
+            ss >> blockRead;
+            BOOST_CHECK_EQUAL(blockRead.vtx.size(), block.vtx.size());
+            for (size_t i = 0; i < block.vtx.size(); i++)
+                BOOST_CHECK(blockRead.vtx[i]->GetHash() == block.vtx[i]->GetHash());
+            txKept = blockRead.vtx[42];
+        }
+
+        // A transaction that outlives its block keeps its chunk
+        CDataStream ssKept(SER_NETWORK, PROTOCOL_VERSION);
+        ssKept << *txKept;
+        CDataStream ssOriginal(SER_NETWORK, PROTOCOL_VERSION);
+        ssOriginal << *block.vtx[42];
+        BOOST_CHECK(ssKept.str() == ssOriginal.str());
+        BOOST_CHECK(txKept->GetHash() == block.vtx[42]->GetHash());
+
+        // Chunks hand out aligned memory until they are full
+        CTxChunk chunk;
+        void* p = chunk.Allocate(1, 1);
+        void* q = chunk.Allocate(sizeof(uint64_t), alignof(uint64_t));
+        BOOST_CHECK(chunk.Contains(p) && chunk.Contains(q));
+        BOOST_CHECK_EQUAL(reinterpret_cast<uintptr_t>(q) % alignof(uint64_t), 0U);
+        BOOST_CHECK(chunk.Allocate(CTxChunk::CHUNK_SIZE, 1) == nullptr);
+    }
+
     BOOST_AUTO_TEST_CASE(big_witness_transaction_test)
     {
         BOOST_TEST_MESSAGE("Running Big Witness Transaction Test");
@@ -0,0 +1,139 @@
+// Copyright (c) 2026 The Mynta Core Developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include "clientversion.h"
+#include "coins.h"
+#include "script/script.h"
+#include "streams.h"
+#include "txoutsnapshot.h"
+
+#include "test/test_mynta.h"
+
+#include <stdio.h>
+
+#include <boost/test/unit_test.hpp>
+
+BOOST_FIXTURE_TEST_SUITE(txoutsnapshot_tests, BasicTestingSetup)
+
+typedef std::pair<std::vector<unsigned char>, std::vector<unsigned char>> DatabaseEntry;
+
+static std::vector<unsigned char> FileBytes(CAutoFile& file)
+{
+    std::vector<unsigned char> vData;
+    rewind(file.Get());
+    int ch;
+    while ((ch = fgetc(file.Get())) != EOF)
+        vData.push_back(static_cast<unsigned char>(ch));
+    rewind(file.Get());
+    return vData;
+}
+
+static bool ReadAll(CAutoFile& file, std::vector<std::pair<COutPoint, Coin>>& vCoins, std::vector<std::pair<TxOutSnapshotSection, DatabaseEntry>>& vEntries,
+                    CTxOutSnapshotStats& stats, std::string& strError)
+{
+    return ReadTxOutSnapshot(file,
+        [&vCoins](const COutPoint& outpoint, const Coin& coin) {
+            vCoins.emplace_back(outpoint, coin);
+            return true;
+        },
+        [&vEntries](TxOutSnapshotSection section, const std::vector<unsigned char>& vKey, const std::vector<unsigned char>& vValue) {
+            vEntries.emplace_back(section, DatabaseEntry(vKey, vValue));
+            return true;
+        },
+        stats, strError);
+}
+
+BOOST_AUTO_TEST_CASE(txoutsnapshot_roundtrip)
+{
+    CTxOutSnapshotMetadata metadata;
+    metadata.hashBaseBlock = uint256S("0x1234");
+    metadata.nBaseHeight = 500;
+
+    const CScript script = CScript() << OP_DUP << OP_HASH160 << std::vector<unsigned char>(20, 7) << OP_EQUALVERIFY << OP_CHECKSIG;
+    const std::vector<std::pair<COutPoint, Coin>> vCoinsIn = {
+        {COutPoint(uint256S("0x01"), 0), Coin(CTxOut(5000, script), 10, true)},
+        {COutPoint(uint256S("0x02"), 3), Coin(CTxOut(1, CScript() << OP_TRUE), 499, false)},
+    };
+    const DatabaseEntry entryAsset({'a', 'X'}, {1, 2, 3});
+    const DatabaseEntry entryEvo({'e'}, {});
+
+    CAutoFile file(tmpfile(), SER_DISK, CLIENT_VERSION);
+    BOOST_REQUIRE(!file.IsNull());
+    CTxOutSnapshotWriter writer(file, metadata);
+    writer.BeginSection(TxOutSnapshotSection::COINS);
+    for (const auto& entry : vCoinsIn)
+        writer.AddCoin(entry.first, entry.second);
+    writer.EndSection();
+    writer.BeginSection(TxOutSnapshotSection::ASSETS);
+    writer.AddEntry(entryAsset.first, entryAsset.second);
+    writer.EndSection();
+    writer.BeginSection(TxOutSnapshotSection::EVO);
+    writer.AddEntry(entryEvo.first, entryEvo.second);
+    writer.EndSection();
+    const CTxOutSnapshotStats statsWritten = writer.Finish();
+    BOOST_CHECK_EQUAL(statsWritten.nCoins, 2U);
+
+    std::vector<std::pair<COutPoint, Coin>> vCoins;
+    std::vector<std::pair<TxOutSnapshotSection, DatabaseEntry>> vEntries;
+    CTxOutSnapshotStats stats;
+    std::string strError;
+    const std::vector<unsigned char> vData = FileBytes(file);
+    BOOST_REQUIRE_MESSAGE(ReadAll(file, vCoins, vEntries, stats, strError), strError);
+
+    BOOST_CHECK(stats.metadata.hashBaseBlock == metadata.hashBaseBlock);
+    BOOST_CHECK_EQUAL(stats.metadata.nBaseHeight, 500);
+    BOOST_CHECK(stats.hashSnapshot == statsWritten.hashSnapshot);
+    BOOST_CHECK(stats.mapEntries == statsWritten.mapEntries);
+    BOOST_REQUIRE_EQUAL(vCoins.size(), 2U);
+    for (size_t i = 0; i < vCoins.size(); i++) {
+        BOOST_CHECK(vCoins[i].first == vCoinsIn[i].first);
+        BOOST_CHECK(vCoins[i].second.out == vCoinsIn[i].second.out);
+        BOOST_CHECK_EQUAL(vCoins[i].second.nHeight, vCoinsIn[i].second.nHeight);
+        BOOST_CHECK_EQUAL(vCoins[i].second.fCoinBase, vCoinsIn[i].second.fCoinBase);
+    }
+    BOOST_REQUIRE_EQUAL(vEntries.size(), 2U);
+    BOOST_CHECK(vEntries[0].first == TxOutSnapshotSection::ASSETS && vEntries[0].second == entryAsset);
+    BOOST_CHECK(vEntries[1].first == TxOutSnapshotSection::EVO && vEntries[1].second == entryEvo);
+
+    // Changing any byte of the contents breaks the closing hash
+    std::vector<unsigned char> vTampered = vData;
+    vTampered[vTampered.size() - 40] ^= 1;
+    CAutoFile fileTampered(tmpfile(), SER_DISK, CLIENT_VERSION);
+    fileTampered.write(reinterpret_cast<const char*>(vTampered.data()), vTampered.size());
+    rewind(fileTampered.Get());
+    vCoins.clear();
+    vEntries.clear();
+    BOOST_CHECK(!ReadAll(fileTampered, vCoins, vEntries, stats, strError));
+
+    // So does cutting the file short
+    CAutoFile fileTruncated(tmpfile(), SER_DISK, CLIENT_VERSION);
+    fileTruncated.write(reinterpret_cast<const char*>(vData.data()), vData.size() - 1);
+    rewind(fileTruncated.Get());
+    BOOST_CHECK(!ReadAll(fileTruncated, vCoins, vEntries, stats, strError));
+}
+
+BOOST_AUTO_TEST_CASE(txoutsnapshot_bad_header)
+{
+    CAutoFile file(tmpfile(), SER_DISK, CLIENT_VERSION);
+    file << uint32_t(0x12345678) << TXOUT_SNAPSHOT_VERSION;
+    rewind(file.Get());
+
+    std::vector<std::pair<COutPoint, Coin>> vCoins;
+    std::vector<std::pair<TxOutSnapshotSection, DatabaseEntry>> vEntries;
+    CTxOutSnapshotStats stats;
+    std::string strError;
+    BOOST_CHECK(!ReadAll(file, vCoins, vEntries, stats, strError));
+    BOOST_CHECK_EQUAL(strError, "not a txout snapshot");
+
+    // A snapshot must hold the coins section before any other
+    CAutoFile fileNoCoins(tmpfile(), SER_DISK, CLIENT_VERSION);
+    CTxOutSnapshotWriter writer(fileNoCoins, CTxOutSnapshotMetadata());
+    writer.BeginSection(TxOutSnapshotSection::ASSETS);
+    writer.EndSection();
+    writer.Finish();
+    rewind(fileNoCoins.Get());
+    BOOST_CHECK(!ReadAll(fileNoCoins, vCoins, vEntries, stats, strError));
+}
+
+BOOST_AUTO_TEST_SUITE_END()
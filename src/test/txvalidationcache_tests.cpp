@@ -98,6 +98,55 @@ BOOST_AUTO_TEST_SUITE(tx_validationcache_tests)
         BOOST_CHECK_EQUAL(mempool.size(), (uint64_t)0);
     }
 
+    BOOST_FIXTURE_TEST_CASE(tx_mempool_flags_cache_test, TestChain100Setup)
+    {
+
+        BOOST_TEST_MESSAGE("Running TX MemPool Flags Cache Test");
+
+        // A transaction accepted to the mempool under the standard flags
+        // shouldn't be executed again by a block that checks fewer flags.
+        CScript scriptPubKey = CScript() << ToByteVector(coinbaseKey.GetPubKey()) << OP_CHECKSIG;
+        CMutableTransaction spend;
+        spend.nVersion = 1;
+        spend.vin.resize(1);
+        spend.vin[0].prevout.hash = coinbaseTxns[0].GetHash();
+        spend.vin[0].prevout.n = 0;
+        spend.vout.resize(1);
+        spend.vout[0].nValue = 11 * CENT;
+        spend.vout[0].scriptPubKey = scriptPubKey;
+        {
+            std::vector<unsigned char> vchSig;
+            uint256 hash = SignatureHash(scriptPubKey, spend, 0, SIGHASH_ALL, 0, SIGVERSION_BASE);
+            BOOST_CHECK(coinbaseKey.Sign(hash, vchSig));
+            vchSig.push_back((unsigned char) SIGHASH_ALL);
+            spend.vin[0].scriptSig << vchSig;
+        }
+        BOOST_CHECK(ToMemPool(spend));
+
+        LOCK(cs_main);
+        const CTransaction tx(spend);
+        PrecomputedTransactionData txdata(tx);
+        CValidationState state;
+        ScriptCacheStats before = GetScriptCacheStats();
+
+        // Flags that discourage upgradable NOPs never match a subset
+        std::vector<CScriptCheck> scriptchecks;
+        BOOST_CHECK(CheckInputs(tx, state, pcoinsTip, true, SCRIPT_VERIFY_P2SH | SCRIPT_VERIFY_LOW_S | SCRIPT_VERIFY_DISCOURAGE_UPGRADABLE_NOPS, false, false, txdata, &scriptchecks));
+        BOOST_CHECK_EQUAL(scriptchecks.size(), tx.vin.size());
+
+        // Connecting a block skips the scripts once, then the entry is gone
+        scriptchecks.clear();
+        BOOST_CHECK(CheckInputs(tx, state, pcoinsTip, true, SCRIPT_VERIFY_P2SH | SCRIPT_VERIFY_LOW_S, false, false, txdata, &scriptchecks));
+        BOOST_CHECK(scriptchecks.empty());
+        BOOST_CHECK(CheckInputs(tx, state, pcoinsTip, true, SCRIPT_VERIFY_P2SH | SCRIPT_VERIFY_LOW_S, false, false, txdata, &scriptchecks));
+        BOOST_CHECK_EQUAL(scriptchecks.size(), tx.vin.size());
+
+        ScriptCacheStats after = GetScriptCacheStats();
+        BOOST_CHECK_EQUAL(after.nFlagHits, before.nFlagHits + 1);
+        BOOST_CHECK_EQUAL(after.nMisses, before.nMisses + 2);
+        BOOST_CHECK_EQUAL(after.nValidatedTxs + 1, before.nValidatedTxs);
+    }
+
     // Run CheckInputs (using pcoinsTip) on the given transaction, for all script
     // flags.  Test that CheckInputs passes for all flags that don't overlap with
     // the failing_flags argument, but otherwise fails.
@@ -394,4 +443,45 @@ BOOST_AUTO_TEST_SUITE(tx_validationcache_tests)
         }
     }
 
+    BOOST_FIXTURE_TEST_CASE(tx_mempool_batch_test, TestChain100Setup)
+    {
+
+        BOOST_TEST_MESSAGE("Running TX MemPool Batch Test");
+
+        // A batch holding a child before its parent accepts both, and turns
+        // down a double-spend of the parent's input without taking it for an
+        // orphan.
+        CScript scriptPubKey = CScript() << ToByteVector(coinbaseKey.GetPubKey()) << OP_CHECKSIG;
+        std::vector<CMutableTransaction> txs(3);
+        for (int i = 0; i < 3; i++)
+        {
+            txs[i].nVersion = 1;
+            txs[i].vin.resize(1);
+            txs[i].vin[0].prevout.hash = i == 1 ? txs[0].GetHash() : coinbaseTxns[0].GetHash();
+            txs[i].vin[0].prevout.n = 0;
+            txs[i].vout.resize(1);
+            txs[i].vout[0].nValue = (i == 1 ? 10 : 11 + i) * CENT;
+            txs[i].vout[0].scriptPubKey = scriptPubKey;
+
+            std::vector<unsigned char> vchSig;
+            uint256 hash = SignatureHash(scriptPubKey, txs[i], 0, SIGHASH_ALL, 0, SIGVERSION_BASE);
+            BOOST_CHECK(coinbaseKey.Sign(hash, vchSig));
+            vchSig.push_back((unsigned char) SIGHASH_ALL);
+            txs[i].vin[0].scriptSig << vchSig;
+        }
+
+        std::vector<CTxMemPoolBatchEntry> vEntries;
+        vEntries.emplace_back(MakeTransactionRef(txs[1]), GetTime());
+        vEntries.emplace_back(MakeTransactionRef(txs[0]), GetTime());
+        vEntries.emplace_back(MakeTransactionRef(txs[2]), GetTime());
+        AcceptToMemoryPoolBatch(mempool, vEntries, nullptr /* plTxnReplaced */, true /* bypass_limits */, 0 /* nAbsurdFee */);
+
+        BOOST_CHECK(vEntries[0].fAccepted);
+        BOOST_CHECK(vEntries[1].fAccepted);
+        BOOST_CHECK(!vEntries[2].fAccepted);
+        BOOST_CHECK(!vEntries[2].fMissingInputs);
+        BOOST_CHECK_EQUAL(mempool.size(), (uint64_t)2);
+        mempool.clear();
+    }
+
 BOOST_AUTO_TEST_SUITE_END()
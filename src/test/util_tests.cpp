@@ -97,6 +97,51 @@ BOOST_FIXTURE_TEST_SUITE(util_tests, BasicTestingSetup)
                 "04 67 8a fd b0");
     }
 
+    BOOST_AUTO_TEST_CASE(util_hex_long_runs)
+    {
+        // Lengths around the vector block sizes, checked against one character at a time
+        static const char* const digits = "0123456789abcdefABCDEF";
+        static const char* const others = " \t\nxg-\x80";
+        for (int i = 0; i < 2000; i++) {
+            std::vector<unsigned char> data(InsecureRandRange(300));
+            for (unsigned char& b : data)
+                b = InsecureRandBits(8);
+            std::string expected;
+            for (unsigned char b : data) {
+                expected += "0123456789abcdef"[b >> 4];
+                expected += "0123456789abcdef"[b & 15];
+            }
+            BOOST_CHECK_EQUAL(HexStr(data), expected);
+            BOOST_CHECK(ParseHex(expected) == data);
+            BOOST_CHECK_EQUAL(IsHex(expected), !data.empty());
+
+            std::string str(InsecureRandRange(600), '0');
+            for (char& c : str)
+                c = digits[InsecureRandRange(22)];
+            for (int j = InsecureRandRange(3); j > 0 && !str.empty(); j--)
+                str[InsecureRandRange(str.size())] = others[InsecureRandRange(7)];
+
+            std::vector<unsigned char> parsed;
+            const char* psz = str.c_str();
+            while (true) {
+                while (isspace(*psz))
+                    psz++;
+                signed char hi = HexDigit(*psz++);
+                if (hi < 0)
+                    break;
+                signed char lo = HexDigit(*psz++);
+                if (lo < 0)
+                    break;
+                parsed.push_back((hi << 4) | lo);
+            }
+            BOOST_CHECK(ParseHex(str) == parsed);
+            bool fHex = !str.empty() && str.size() % 2 == 0;
+            for (char c : str)
+                fHex = fHex && HexDigit(c) >= 0;
+            BOOST_CHECK_EQUAL(IsHex(str), fHex);
+        }
+    }
+
 
     BOOST_AUTO_TEST_CASE(util_DateTimeStrFormat_test)
     {
@@ -0,0 +1,147 @@
+// Copyright (c) 2026 The Mynta Core Developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include "arith_uint256.h"
+#include "utiltime.h"
+#include "validationinterface.h"
+
+#include "test/test_mynta.h"
+
+#include <atomic>
+#include <mutex>
+
+#include <boost/test/unit_test.hpp>
+
+BOOST_FIXTURE_TEST_SUITE(validationinterface_tests, TestingSetup)
+
+namespace {
+
+class CQueuedSubscriber final : public CValidationInterface
+{
+public:
+    std::mutex cs;
+    std::vector<uint256> vFound;
+    //! Callbacks wait while it is set
+    std::atomic<bool> fHold{false};
+    std::atomic<int> nEntered{0};
+
+    std::vector<uint256> Found()
+    {
+        std::lock_guard<std::mutex> lock(cs);
+        return vFound;
+    }
+
+protected:
+    void BlockFound(const uint256& hash) override
+    {
+        nEntered++;
+        while (fHold)
+            MilliSleep(1);
+        std::lock_guard<std::mutex> lock(cs);
+        vFound.push_back(hash);
+    }
+};
+
+uint256 Hash(int n)
+{
+    return ArithToUint256(arith_uint256(n));
+}
+
+ValidationQueueStats Stats(const std::string& strName)
+{
+    for (const ValidationQueueStats& stats : GetValidationQueueStats())
+        if (stats.strName == strName)
+            return stats;
+    BOOST_ERROR("no queue named " + strName);
+    return ValidationQueueStats();
+}
+
+//! Fire the first event and wait until the subscriber is stuck in it, so the rest stay queued
+void HoldFirst(CQueuedSubscriber& subscriber)
+{
+    subscriber.fHold = true;
+    GetMainSignals().BlockFound(Hash(0));
+    while (subscriber.nEntered == 0)
+        MilliSleep(1);
+}
+
+}
+
+BOOST_AUTO_TEST_CASE(queue_keeps_order)
+{
+    CQueuedSubscriber subscriber;
+    ValidationQueueOptions options;
+    options.strName = "order";
+    RegisterValidationInterface(&subscriber, options);
+
+    std::vector<uint256> vExpected;
+    for (int i = 0; i < 100; i++) {
+        vExpected.push_back(Hash(i));
+        GetMainSignals().BlockFound(Hash(i));
+    }
+    SyncWithValidationInterfaceQueues();
+    BOOST_CHECK(subscriber.Found() == vExpected);
+    ValidationQueueStats stats = Stats("order");
+    BOOST_CHECK_EQUAL(stats.nProcessed, 100);
+    BOOST_CHECK_EQUAL(stats.nDepth, 0);
+    BOOST_CHECK_EQUAL(stats.nDropped, 0);
+
+    UnregisterValidationInterface(&subscriber);
+    GetMainSignals().BlockFound(Hash(100));
+    BOOST_CHECK_EQUAL(subscriber.Found().size(), 100);
+    BOOST_CHECK(GetValidationQueueStats().empty());
+}
+
+BOOST_AUTO_TEST_CASE(queue_drop_policies)
+{
+    for (ValidationQueuePolicy policy : {ValidationQueuePolicy::DROP_NEWEST, ValidationQueuePolicy::DROP_OLDEST}) {
+        CQueuedSubscriber subscriber;
+        ValidationQueueOptions options;
+        options.strName = "drop";
+        options.nMaxDepth = 4;
+        options.policy = policy;
+        RegisterValidationInterface(&subscriber, options);
+
+        HoldFirst(subscriber);
+        for (int i = 1; i <= 7; i++)
+            GetMainSignals().BlockFound(Hash(i));
+        ValidationQueueStats stats = Stats("drop");
+        BOOST_CHECK_EQUAL(stats.nDepth, 4);
+        BOOST_CHECK_EQUAL(stats.nPeakDepth, 4);
+        BOOST_CHECK_EQUAL(stats.nDropped, 3);
+        subscriber.fHold = false;
+        SyncWithValidationInterfaceQueues();
+
+        std::vector<uint256> vExpected{Hash(0)};
+        for (int i = 1; i <= 4; i++)
+            vExpected.push_back(Hash(policy == ValidationQueuePolicy::DROP_NEWEST ? i : i + 3));
+        BOOST_CHECK(subscriber.Found() == vExpected);
+        UnregisterValidationInterface(&subscriber);
+    }
+}
+
+BOOST_AUTO_TEST_CASE(queue_wait_policy)
+{
+    CQueuedSubscriber subscriber;
+    ValidationQueueOptions options;
+    options.strName = "wait";
+    options.nMaxDepth = 2;
+    RegisterValidationInterface(&subscriber, options);
+
+    // A full queue holds the caller up for a while, then takes the event anyway
+    HoldFirst(subscriber);
+    for (int i = 1; i <= 3; i++)
+        GetMainSignals().BlockFound(Hash(i));
+    ValidationQueueStats stats = Stats("wait");
+    BOOST_CHECK_EQUAL(stats.nDepth, 3);
+    BOOST_CHECK_EQUAL(stats.nOverflows, 1);
+    BOOST_CHECK(stats.nWaitMicros >= VALIDATION_QUEUE_MAX_WAIT_MS * 1000);
+
+    // Unregistering runs what is left
+    subscriber.fHold = false;
+    UnregisterValidationInterface(&subscriber);
+    BOOST_CHECK_EQUAL(subscriber.Found().size(), 4);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
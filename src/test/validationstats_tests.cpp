@@ -0,0 +1,71 @@
+// Copyright (c) 2026 The Mynta Core Developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include "validationstats.h"
+
+#include "test/test_mynta.h"
+
+#include <boost/test/unit_test.hpp>
+
+BOOST_FIXTURE_TEST_SUITE(validationstats_tests, BasicTestingSetup)
+
+BOOST_AUTO_TEST_CASE(timing_histogram_buckets)
+{
+    // Every duration falls in the bucket whose bounds hold it, and the
+    // buckets follow each other without gaps
+    int nLastIndex = 0;
+    for (int64_t nMicros = 0; nMicros < 100000; nMicros++) {
+        const int nIndex = CTimingHistogram::BucketIndex(nMicros);
+        BOOST_CHECK(nIndex == nLastIndex || nIndex == nLastIndex + 1);
+        BOOST_CHECK(nMicros <= CTimingHistogram::BucketUpperBound(nIndex));
+        BOOST_CHECK(nIndex == 0 || nMicros > CTimingHistogram::BucketUpperBound(nIndex - 1));
+        nLastIndex = nIndex;
+    }
+    BOOST_CHECK_EQUAL(CTimingHistogram::BucketIndex(-5), 0);
+    BOOST_CHECK_EQUAL(CTimingHistogram::BucketIndex(int64_t(1) << 50), CTimingHistogram::NUM_BUCKETS - 1);
+}
+
+BOOST_AUTO_TEST_CASE(timing_histogram_percentiles)
+{
+    CTimingHistogram histogram;
+    BOOST_CHECK_EQUAL(histogram.Percentile(0.5), 0);
+
+    for (int64_t nMicros = 1; nMicros <= 1000; nMicros++)
+        histogram.Add(nMicros * 100);
+    const CValidationPhaseStats stats = histogram.GetStats();
+    BOOST_CHECK_EQUAL(stats.nCount, 1000U);
+    BOOST_CHECK_EQUAL(stats.nTotalMicros, 100 * 1000 * 1001 / 2);
+    BOOST_CHECK_EQUAL(stats.nMaxMicros, 100000);
+
+    // Percentiles are never below the exact value, nor more than a bucket above it
+    const std::pair<int64_t, int64_t> expected[] = {
+        {stats.nP50Micros, 50000}, {stats.nP90Micros, 90000}, {stats.nP99Micros, 99000}};
+    for (const auto& percentile : expected) {
+        BOOST_CHECK(percentile.first >= percentile.second);
+        BOOST_CHECK(percentile.first <= percentile.second * 1.25);
+    }
+    BOOST_CHECK_EQUAL(histogram.Percentile(1.0), 100000);
+
+    histogram.Reset();
+    BOOST_CHECK_EQUAL(histogram.GetStats().nCount, 0U);
+    BOOST_CHECK_EQUAL(histogram.Percentile(0.99), 0);
+}
+
+BOOST_AUTO_TEST_CASE(validation_stats_prometheus)
+{
+    ResetValidationStats();
+    RecordValidationTime(ValidationPhase::SCRIPT_VERIFY, 2500);
+    RecordValidationTime(ValidationPhase::SCRIPT_VERIFY, 1500);
+    BOOST_CHECK_EQUAL(GetValidationPhaseStats(ValidationPhase::SCRIPT_VERIFY).nCount, 2U);
+    BOOST_CHECK_EQUAL(GetValidationPhaseStats(ValidationPhase::CHECK_BLOCK).nCount, 0U);
+
+    const std::string strText = ValidationStatsToPrometheus();
+    BOOST_CHECK(strText.find("# TYPE mynta_validation_phase_seconds summary\n") != std::string::npos);
+    BOOST_CHECK(strText.find("mynta_validation_phase_seconds_count{phase=\"script_verify\"} 2\n") != std::string::npos);
+    BOOST_CHECK(strText.find("mynta_validation_phase_seconds_sum{phase=\"script_verify\"} 0.004000\n") != std::string::npos);
+    BOOST_CHECK(strText.find("mynta_validation_phase_seconds_count{phase=\"disconnect_tip\"} 0\n") != std::string::npos);
+    ResetValidationStats();
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,86 @@
+// Copyright (c) 2026 The Mynta Core Developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include "timinghistogram.h"
+
+#include <algorithm>
+#include <cmath>
+
+static int HighestBit(uint64_t n)
+{
+    int nBit = -1;
+    while (n) {
+        n >>= 1;
+        nBit++;
+    }
+    return nBit;
+}
+
+int CTimingHistogram::BucketIndex(int64_t nMicros)
+{
+    if (nMicros < 8)
+        return std::max<int64_t>(nMicros, 0);
+    // Four buckets per power of two, told apart by the two bits after the highest
+    const int nBit = HighestBit(nMicros);
+    const int nIndex = (nBit - 1) * 4 + ((nMicros >> (nBit - 2)) & 3);
+    return std::min(nIndex, NUM_BUCKETS - 1);
+}
+
+int64_t CTimingHistogram::BucketUpperBound(int nIndex)
+{
+    if (nIndex < 7)
+        return nIndex;
+    // The last microsecond before the next bucket starts
+    const int nNext = nIndex + 1;
+    return (int64_t(4 + nNext % 4) << (nNext / 4 - 1)) - 1;
+}
+
+void CTimingHistogram::Add(int64_t nMicros)
+{
+    nMicros = std::max<int64_t>(nMicros, 0);
+    vBuckets[BucketIndex(nMicros)].fetch_add(1, std::memory_order_relaxed);
+    nTotalMicros.fetch_add(nMicros, std::memory_order_relaxed);
+    int64_t nMax = nMaxMicros.load(std::memory_order_relaxed);
+    while (nMicros > nMax && !nMaxMicros.compare_exchange_weak(nMax, nMicros, std::memory_order_relaxed)) {}
+    nCount.fetch_add(1, std::memory_order_relaxed);
+}
+
+int64_t CTimingHistogram::Percentile(double fraction) const
+{
+    uint64_t nTotal = 0;
+    for (const std::atomic<uint64_t>& nBucket : vBuckets)
+        nTotal += nBucket.load(std::memory_order_relaxed);
+    if (nTotal == 0)
+        return 0;
+
+    const uint64_t nRank = std::max<uint64_t>(1, std::ceil(fraction * nTotal));
+    uint64_t nSeen = 0;
+    for (int i = 0; i < NUM_BUCKETS; i++) {
+        nSeen += vBuckets[i].load(std::memory_order_relaxed);
+        if (nSeen >= nRank)
+            return std::min(BucketUpperBound(i), nMaxMicros.load(std::memory_order_relaxed));
+    }
+    return nMaxMicros.load(std::memory_order_relaxed);
+}
+
+CTimingStats CTimingHistogram::GetStats() const
+{
+    CTimingStats stats;
+    stats.nCount = nCount.load(std::memory_order_relaxed);
+    stats.nTotalMicros = nTotalMicros.load(std::memory_order_relaxed);
+    stats.nMaxMicros = nMaxMicros.load(std::memory_order_relaxed);
+    stats.nP50Micros = Percentile(0.5);
+    stats.nP90Micros = Percentile(0.9);
+    stats.nP99Micros = Percentile(0.99);
+    return stats;
+}
+
+void CTimingHistogram::Reset()
+{
+    for (std::atomic<uint64_t>& nBucket : vBuckets)
+        nBucket.store(0, std::memory_order_relaxed);
+    nCount = 0;
+    nTotalMicros = 0;
+    nMaxMicros = 0;
+}
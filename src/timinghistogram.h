@@ -0,0 +1,49 @@
+// Copyright (c) 2026 The Mynta Core Developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#ifndef MYNTA_TIMINGHISTOGRAM_H
+#define MYNTA_TIMINGHISTOGRAM_H
+
+#include <array>
+#include <atomic>
+#include <stdint.h>
+
+struct CTimingStats
+{
+    uint64_t nCount{0};
+    int64_t nTotalMicros{0};
+    int64_t nMaxMicros{0};
+    int64_t nP50Micros{0};
+    int64_t nP90Micros{0};
+    int64_t nP99Micros{0};
+};
+
+/**
+ * Durations in buckets a quarter of a power of two wide, so a percentile is
+ * known to within about 19%. Adding is lock free, so stats can be read while
+ * samples are being added; a read racing an add may miss it.
+ */
+class CTimingHistogram
+{
+public:
+    //! durations below 8us get a bucket each; 2^40us and above share the last
+    static const int NUM_BUCKETS = 160;
+
+    static int BucketIndex(int64_t nMicros);
+    static int64_t BucketUpperBound(int nIndex);
+
+    void Add(int64_t nMicros);
+    /** Duration by which a fraction of the samples ended, rounded up to the end of its bucket */
+    int64_t Percentile(double fraction) const;
+    CTimingStats GetStats() const;
+    void Reset();
+
+private:
+    std::array<std::atomic<uint64_t>, NUM_BUCKETS> vBuckets{};
+    std::atomic<uint64_t> nCount{0};
+    std::atomic<int64_t> nTotalMicros{0};
+    std::atomic<int64_t> nMaxMicros{0};
+};
+
+#endif // MYNTA_TIMINGHISTOGRAM_H
@@ -7,6 +7,7 @@
 #include "txdb.h"
 
 #include "chainparams.h"
+#include "crypto/common.h"
 #include "hash.h"
 #include "random.h"
 #include "pow.h"
@@ -18,6 +19,11 @@
 
 #include <stdint.h>
 
+#include <algorithm>
+#include <exception>
+#include <iterator>
+#include <thread>
+
 #include <boost/thread.hpp>
 
 static const char DB_COIN = 'C';
@@ -29,6 +35,7 @@ static const char DB_ADDRESSUNSPENTINDEX = 'u';
 static const char DB_TIMESTAMPINDEX = 's';
 static const char DB_BLOCKHASHINDEX = 'z';
 static const char DB_SPENTINDEX = 'p';
+static const char DB_ADDRESSBALANCE = 'A';
 static const char DB_BLOCK_INDEX = 'b';
 
 static const char DB_BEST_BLOCK = 'B';
@@ -36,6 +43,23 @@ static const char DB_HEAD_BLOCKS = 'H';
 static const char DB_FLAG = 'F';
 static const char DB_REINDEX_FLAG = 'R';
 static const char DB_LAST_BLOCK = 'l';
+static const char DB_INDEX_BUILD = 'I';
+static const char DB_COIN_FORMAT = 'V';
+static const char DB_COIN_FORMAT_UPGRADE = 'U';
+
+//! Coins are stored with the asset script cases of CScriptCompressor
+static const int COIN_FORMAT_ASSET_SCRIPTS = 1;
+
+/**
+ * Releases from before DB_COIN_FORMAT don't read it, and would take coins in
+ * the asset script format for Coin's own. All of them do run the per-tx
+ * coins upgrade at startup, though, which fails on a DB_COINS record it
+ * can't parse. This one, under the null txid and holding a single zero byte,
+ * makes them refuse to load the chainstate. It is written before the first
+ * coin changes format and never removed: downgrading needs -reindex-chainstate.
+ */
+static const std::pair<char, uint256> DB_COIN_FORMAT_GUARD{DB_COINS, uint256()};
+static const unsigned char COIN_FORMAT_GUARD_VALUE = 0;
 
 namespace {
 
@@ -59,20 +83,100 @@ struct CoinEntry {
     }
 };
 
+/** A coin as serialized in the chainstate, which is Coin's own format unless fAssetScripts */
+struct CoinValue {
+    Coin* coin;
+    bool fAssetScripts;
+    CoinValue(const Coin* ptr, bool fAssetScriptsIn) : coin(const_cast<Coin*>(ptr)), fAssetScripts(fAssetScriptsIn) {}
+
+    template<typename Stream>
+    void Serialize(Stream &s) const {
+        assert(!coin->IsSpent());
+        uint32_t code = coin->nHeight * 2 + coin->fCoinBase;
+        s << VARINT(code);
+        s << CTxOutCompressor(REF(coin->out), fAssetScripts);
+    }
+
+    template<typename Stream>
+    void Unserialize(Stream& s) {
+        uint32_t code = 0;
+        s >> VARINT(code);
+        coin->nHeight = code >> 1;
+        coin->fCoinBase = code & 1;
+        s >> REF(CTxOutCompressor(coin->out, fAssetScripts));
+    }
+};
+
 }
 
 CCoinsViewDB::CCoinsViewDB(size_t nCacheSize, bool fMemory, bool fWipe) : db(GetDataDir() / "chainstate", nCacheSize, fMemory, fWipe, true, 2 << 20)
 {
+    // A chainstate without coins starts out in the current format, one with coins waits for Upgrade()
+    int nFormat = 0;
+    if (!db.Read(DB_COIN_FORMAT, nFormat)) {
+        std::unique_ptr<CDBIterator> pcursor(db.NewIterator());
+        COutPoint outpoint;
+        CoinEntry entry(&outpoint);
+        pcursor->Seek(DB_COIN);
+        if (!pcursor->Valid() || !pcursor->GetKey(entry) || entry.key != DB_COIN) {
+            nFormat = COIN_FORMAT_ASSET_SCRIPTS;
+            CDBBatch batch(db);
+            batch.Write(DB_COIN_FORMAT_GUARD, COIN_FORMAT_GUARD_VALUE);
+            batch.Write(DB_COIN_FORMAT, nFormat);
+            db.WriteBatch(batch);
+        }
+    }
+    fAssetScripts = nFormat >= COIN_FORMAT_ASSET_SCRIPTS;
+    // Chainstates upgraded before the guard existed get it now
+    if (fAssetScripts && !db.Exists(DB_COIN_FORMAT_GUARD))
+        db.Write(DB_COIN_FORMAT_GUARD, COIN_FORMAT_GUARD_VALUE, true);
 }
 
 bool CCoinsViewDB::GetCoin(const COutPoint &outpoint, Coin &coin) const {
-    return db.Read(CoinEntry(&outpoint), coin);
+    CoinValue value(&coin, fAssetScripts);
+    return db.Read(CoinEntry(&outpoint), value);
 }
 
 bool CCoinsViewDB::HaveCoin(const COutPoint &outpoint) const {
     return db.Exists(CoinEntry(&outpoint));
 }
 
+void CCoinsViewDB::GetCoins(const std::vector<COutPoint> &vOutpoints, std::vector<std::pair<COutPoint, Coin>> &vCoins) const {
+    // COutPoint sorts like its key, so each thread reads a run of neighbouring
+    // keys, mostly from the same tables and blocks
+    std::vector<COutPoint> vSorted(vOutpoints);
+    std::sort(vSorted.begin(), vSorted.end());
+    const size_t nThreads = std::max<size_t>(1, std::min(MAX_COINS_READ_THREADS, vSorted.size() / COINS_READ_BATCH));
+
+    std::vector<std::vector<std::pair<COutPoint, Coin>>> vFound(nThreads);
+    std::vector<std::exception_ptr> vErrors(nThreads);
+    auto readRun = [&](size_t nRun) {
+        try {
+            Coin coin;
+            for (size_t i = vSorted.size() * nRun / nThreads; i < vSorted.size() * (nRun + 1) / nThreads; i++) {
+                if (GetCoin(vSorted[i], coin))
+                    vFound[nRun].emplace_back(vSorted[i], std::move(coin));
+            }
+        } catch (...) {
+            vErrors[nRun] = std::current_exception();
+        }
+    };
+    std::vector<std::thread> vThreads;
+    for (size_t nRun = 1; nRun < nThreads; nRun++)
+        vThreads.emplace_back(readRun, nRun);
+    readRun(0);
+    for (std::thread& thread : vThreads)
+        thread.join();
+
+    // Read errors reach the caller as they would from GetCoin
+    for (const std::exception_ptr& error : vErrors) {
+        if (error)
+            std::rethrow_exception(error);
+    }
+    for (std::vector<std::pair<COutPoint, Coin>>& vRun : vFound)
+        std::move(vRun.begin(), vRun.end(), std::back_inserter(vCoins));
+}
+
 uint256 CCoinsViewDB::GetBestBlock() const {
     uint256 hashBestChain;
     if (!db.Read(DB_BEST_BLOCK, hashBestChain))
@@ -89,11 +193,14 @@ std::vector<uint256> CCoinsViewDB::GetHeadBlocks() const {
 }
 
 bool CCoinsViewDB::BatchWrite(CCoinsMap &mapCoins, const uint256 &hashBlock) {
-    CDBBatch batch(db);
-    size_t count = 0;
-    size_t changed = 0;
-    size_t batch_size = (size_t)gArgs.GetArg("-dbbatchsize", nDefaultDbBatchSize);
-    int crash_simulate = gArgs.GetArg("-dbcrashratio", 0);
+    if (!BeginBatchWrite(hashBlock))
+        return false;
+    bool ret = WriteCoins(mapCoins, hashBlock);
+    mapCoins.clear();
+    return ret;
+}
+
+bool CCoinsViewDB::BeginBatchWrite(const uint256 &hashBlock) {
     assert(!hashBlock.IsNull());
 
     uint256 old_tip = GetBestBlock();
@@ -106,28 +213,38 @@ bool CCoinsViewDB::BatchWrite(CCoinsMap &mapCoins, const uint256 &hashBlock) {
         }
     }
 
-    // In the first batch, mark the database as being in the middle of a
-    // transition from old_tip to hashBlock.
+    // Mark the database as being in the middle of a transition from old_tip
+    // to hashBlock before any coin is written.
     // A vector is used for future extensibility, as we may want to support
     // interrupting after partial writes from multiple independent reorgs.
+    CDBBatch batch(db);
     batch.Erase(DB_BEST_BLOCK);
     batch.Write(DB_HEAD_BLOCKS, std::vector<uint256>{hashBlock, old_tip});
+    return db.WriteBatch(batch);
+}
+
+bool CCoinsViewDB::WriteCoins(const CCoinsMap &mapCoins, const uint256 &hashBlock) {
+    CDBBatch batch(db);
+    size_t count = 0;
+    size_t changed = 0;
+    size_t batch_size = (size_t)gArgs.GetArg("-dbbatchsize", nDefaultDbBatchSize);
+    int crash_simulate = gArgs.GetArg("-dbcrashratio", 0);
+    assert(!hashBlock.IsNull());
 
-    for (CCoinsMap::iterator it = mapCoins.begin(); it != mapCoins.end();) {
+    for (CCoinsMap::const_iterator it = mapCoins.begin(); it != mapCoins.end(); ++it) {
         if (it->second.flags & CCoinsCacheEntry::DIRTY) {
             CoinEntry entry(&it->first);
             if (it->second.coin.IsSpent())
                 batch.Erase(entry);
             else
-                batch.Write(entry, it->second.coin);
+                batch.Write(entry, CoinValue(&it->second.coin, fAssetScripts));
             changed++;
         }
         count++;
-        CCoinsMap::iterator itOld = it++;
-        mapCoins.erase(itOld);
         if (batch.SizeEstimate() > batch_size) {
             LogPrint(BCLog::COINDB, "Writing partial batch of %.2f MiB\n", batch.SizeEstimate() * (1.0 / 1048576.0));
-            db.WriteBatch(batch);
+            if (!db.WriteBatch(batch))
+                return false;
             batch.Clear();
             if (crash_simulate) {
                 static FastRandomContext rng;
@@ -149,6 +266,122 @@ bool CCoinsViewDB::BatchWrite(CCoinsMap &mapCoins, const uint256 &hashBlock) {
     return ret;
 }
 
+CCoinsViewFlushBuffer::CCoinsViewFlushBuffer(CCoinsView *viewIn, CCoinsViewDB *pdbIn) : CCoinsViewBacked(viewIn), pdb(pdbIn) {}
+
+CCoinsViewFlushBuffer::~CCoinsViewFlushBuffer() {
+    WaitForWrite();
+}
+
+bool CCoinsViewFlushBuffer::GetCoin(const COutPoint &outpoint, Coin &coin) const {
+    {
+        LOCK(cs);
+        CCoinsMap::const_iterator it = mapFrozen.find(outpoint);
+        if (it != mapFrozen.end()) {
+            if (it->second.coin.IsSpent())
+                return false;
+            coin = it->second.coin;
+            return true;
+        }
+    }
+    return base->GetCoin(outpoint, coin);
+}
+
+void CCoinsViewFlushBuffer::GetCoins(const std::vector<COutPoint> &vOutpoints, std::vector<std::pair<COutPoint, Coin>> &vCoins) const {
+    std::vector<COutPoint> vMissing;
+    {
+        LOCK(cs);
+        for (const COutPoint& outpoint : vOutpoints) {
+            CCoinsMap::const_iterator it = mapFrozen.find(outpoint);
+            if (it == mapFrozen.end())
+                vMissing.push_back(outpoint);
+            else if (!it->second.coin.IsSpent())
+                vCoins.emplace_back(outpoint, it->second.coin);
+        }
+    }
+    if (!vMissing.empty())
+        base->GetCoins(vMissing, vCoins);
+}
+
+bool CCoinsViewFlushBuffer::HaveCoin(const COutPoint &outpoint) const {
+    {
+        LOCK(cs);
+        CCoinsMap::const_iterator it = mapFrozen.find(outpoint);
+        if (it != mapFrozen.end())
+            return !it->second.coin.IsSpent();
+    }
+    return base->HaveCoin(outpoint);
+}
+
+uint256 CCoinsViewFlushBuffer::GetBestBlock() const {
+    {
+        LOCK(cs);
+        if (!hashFrozen.IsNull())
+            return hashFrozen;
+    }
+    return base->GetBestBlock();
+}
+
+bool CCoinsViewFlushBuffer::WaitForWrite() const {
+    LOCK(cs_writer);
+    if (writer.joinable())
+        writer.join();
+    return !fFailed;
+}
+
+bool CCoinsViewFlushBuffer::BatchWrite(CCoinsMap &mapCoins, const uint256 &hashBlock) {
+    LOCK(cs_writer);
+    if (!WaitForWrite())
+        return false;
+    if (!fBackground)
+        return base->BatchWrite(mapCoins, hashBlock);
+
+    if (!pdb->BeginBatchWrite(hashBlock))
+        return false;
+    size_t nUsage = memusage::DynamicUsage(mapCoins);
+    for (const auto& entry : mapCoins)
+        nUsage += entry.second.coin.DynamicMemoryUsage();
+    {
+        LOCK(cs);
+        assert(mapFrozen.empty());
+        mapFrozen.swap(mapCoins);
+        hashFrozen = hashBlock;
+        nFrozenUsage = nUsage;
+    }
+    writer = std::thread([this, hashBlock] {
+        RenameThread("mynta-coinsflush");
+        bool fOk = false;
+        try {
+            fOk = pdb->WriteCoins(mapFrozen, hashBlock);
+        } catch (const std::exception& e) {
+            LogPrintf("%s: %s\n", __func__, e.what());
+        }
+        if (!fOk) {
+            // Keep the entries: they are the only copy
+            LogPrintf("Failed to write flushed coins to the coin database\n");
+            fFailed = true;
+            return;
+        }
+        CCoinsMap mapWritten;
+        {
+            LOCK(cs);
+            mapWritten.swap(mapFrozen);
+            hashFrozen.SetNull();
+            nFrozenUsage = 0;
+        }
+    });
+    return true;
+}
+
+CCoinsViewCursor *CCoinsViewFlushBuffer::Cursor() const {
+    WaitForWrite();
+    return base->Cursor();
+}
+
+size_t CCoinsViewFlushBuffer::DynamicMemoryUsage() const {
+    LOCK(cs);
+    return nFrozenUsage;
+}
+
 size_t CCoinsViewDB::EstimateSize() const
 {
     return db.EstimateSize(DB_COIN, (char)(DB_COIN+1));
@@ -179,7 +412,7 @@ bool CBlockTreeDB::ReadLastBlockFile(int &nFile) {
 
 CCoinsViewCursor *CCoinsViewDB::Cursor() const
 {
-    CCoinsViewDBCursor *i = new CCoinsViewDBCursor(const_cast<CDBWrapper&>(db).NewIterator(), GetBestBlock());
+    CCoinsViewDBCursor *i = new CCoinsViewDBCursor(const_cast<CDBWrapper&>(db).NewIterator(), GetBestBlock(), fAssetScripts);
     /* It seems that there are no "const iterators" for LevelDB.  Since we
        only need read operations on it, use a const-cast to get around
        that restriction.  */
@@ -195,6 +428,23 @@ CCoinsViewCursor *CCoinsViewDB::Cursor() const
     return i;
 }
 
+CCoinsViewCursor *CCoinsViewDB::Cursor(const std::shared_ptr<const CDBSnapshot>& snapshot, const uint256 &hashFrom) const
+{
+    uint256 hashBestChain;
+    db.Read(DB_BEST_BLOCK, hashBestChain, snapshot.get());
+    CCoinsViewDBCursor *i = new CCoinsViewDBCursor(const_cast<CDBWrapper&>(db).NewIterator(snapshot.get()), hashBestChain, fAssetScripts, snapshot);
+    COutPoint outpointFrom(hashFrom, 0);
+    i->pcursor->Seek(CoinEntry(&outpointFrom));
+    if (i->pcursor->Valid()) {
+        CoinEntry entry(&i->keyTmp.second);
+        i->pcursor->GetKey(entry);
+        i->keyTmp.first = entry.key;
+    } else {
+        i->keyTmp.first = 0;
+    }
+    return i;
+}
+
 bool CCoinsViewDBCursor::GetKey(COutPoint &key) const
 {
     // Return cached key
@@ -207,7 +457,8 @@ bool CCoinsViewDBCursor::GetKey(COutPoint &key) const
 
 bool CCoinsViewDBCursor::GetValue(Coin &coin) const
 {
-    return pcursor->GetValue(coin);
+    CoinValue value(&coin, fAssetScripts);
+    return pcursor->GetValue(value);
 }
 
 unsigned int CCoinsViewDBCursor::GetValueSize() const
@@ -258,6 +509,30 @@ bool CBlockTreeDB::ReadSpentIndex(CSpentIndexKey &key, CSpentIndexValue &value)
     return Read(std::make_pair(DB_SPENTINDEX, key), value);
 }
 
+void CBlockTreeDB::ReadSpentIndex(const std::vector<CSpentIndexKey> &vKeys, std::vector<CSpentIndexValue> &vValues, std::vector<bool> &vFound) {
+    vValues.assign(vKeys.size(), CSpentIndexValue());
+    vFound.assign(vKeys.size(), false);
+
+    // Seeking forward through one iterator keeps reading the same blocks
+    // for the outputs of a transaction, rather than looking each one up anew
+    std::vector<size_t> vOrder(vKeys.size());
+    for (size_t i = 0; i < vOrder.size(); i++)
+        vOrder[i] = i;
+    std::sort(vOrder.begin(), vOrder.end(), [&vKeys](size_t a, size_t b) {
+        return vKeys[a].txid < vKeys[b].txid || (vKeys[a].txid == vKeys[b].txid && vKeys[a].outputIndex < vKeys[b].outputIndex);
+    });
+
+    std::unique_ptr<CDBIterator> pcursor(NewIterator());
+    for (size_t i : vOrder) {
+        pcursor->Seek(std::make_pair(DB_SPENTINDEX, vKeys[i]));
+        std::pair<char, CSpentIndexKey> key;
+        if (pcursor->Valid() && pcursor->GetKey(key) && key.first == DB_SPENTINDEX &&
+            key.second.txid == vKeys[i].txid && key.second.outputIndex == vKeys[i].outputIndex) {
+            vFound[i] = pcursor->GetValue(vValues[i]);
+        }
+    }
+}
+
 bool CBlockTreeDB::UpdateSpentIndex(const std::vector<std::pair<CSpentIndexKey, CSpentIndexValue> >&vect) {
     CDBBatch batch(*this);
     for (std::vector<std::pair<CSpentIndexKey,CSpentIndexValue> >::const_iterator it=vect.begin(); it!=vect.end(); it++) {
@@ -339,6 +614,8 @@ bool CBlockTreeDB::ReadAddressUnspentIndex(uint160 addressHash, int type,
 
 bool CBlockTreeDB::WriteAddressIndex(const std::vector<std::pair<CAddressIndexKey, CAmount > >&vect) {
     CDBBatch batch(*this);
+    if (!UpdateAddressBalances(batch, vect, false))
+        return false;
     for (std::vector<std::pair<CAddressIndexKey, CAmount> >::const_iterator it=vect.begin(); it!=vect.end(); it++)
         batch.Write(std::make_pair(DB_ADDRESSINDEX, it->first), it->second);
     return WriteBatch(batch);
@@ -346,11 +623,135 @@ bool CBlockTreeDB::WriteAddressIndex(const std::vector<std::pair<CAddressIndexKe
 
 bool CBlockTreeDB::EraseAddressIndex(const std::vector<std::pair<CAddressIndexKey, CAmount > >&vect) {
     CDBBatch batch(*this);
+    if (!UpdateAddressBalances(batch, vect, true))
+        return false;
     for (std::vector<std::pair<CAddressIndexKey, CAmount> >::const_iterator it=vect.begin(); it!=vect.end(); it++)
         batch.Erase(std::make_pair(DB_ADDRESSINDEX, it->first));
     return WriteBatch(batch);
 }
 
+bool CBlockTreeDB::UpdateAddressBalances(CDBBatch& batch, const std::vector<std::pair<CAddressIndexKey, CAmount> >& vect, bool fErase) {
+    std::map<CAddressBalanceKey, CAddressBalanceValue> mapChanges;
+    for (const auto& entry : vect) {
+        // Erased entries count with the amount they were written with
+        CAmount nValue;
+        bool fHave = Read(std::make_pair(DB_ADDRESSINDEX, entry.first), nValue);
+        if (fHave != fErase)
+            continue;
+        if (!fErase)
+            nValue = entry.second;
+        CAddressBalanceValue& change = mapChanges[CAddressBalanceKey(entry.first.type, entry.first.hashBytes, entry.first.asset)];
+        change.balance += fErase ? -nValue : nValue;
+        if (nValue > 0)
+            change.received += fErase ? -nValue : nValue;
+    }
+
+    for (const auto& change : mapChanges) {
+        CAddressBalanceValue value;
+        if (Exists(std::make_pair(DB_ADDRESSBALANCE, change.first)) && !Read(std::make_pair(DB_ADDRESSBALANCE, change.first), value))
+            return error("%s: failed to read address balance", __func__);
+        value.balance += change.second.balance;
+        value.received += change.second.received;
+        if (value.IsNull())
+            batch.Erase(std::make_pair(DB_ADDRESSBALANCE, change.first));
+        else
+            batch.Write(std::make_pair(DB_ADDRESSBALANCE, change.first), value);
+    }
+    return true;
+}
+
+bool CBlockTreeDB::ReadAddressBalance(uint160 addressHash, int type, const std::string& assetName, CAddressBalanceValue& value) {
+    value.SetNull();
+    if (!Exists(std::make_pair(DB_ADDRESSBALANCE, CAddressBalanceKey(type, addressHash, assetName))))
+        return true;
+    return Read(std::make_pair(DB_ADDRESSBALANCE, CAddressBalanceKey(type, addressHash, assetName)), value);
+}
+
+bool CBlockTreeDB::ReadAddressBalances(uint160 addressHash, int type, std::vector<std::pair<std::string, CAddressBalanceValue> >& vBalances) {
+    std::unique_ptr<CDBIterator> pcursor(NewIterator());
+    pcursor->Seek(std::make_pair(DB_ADDRESSBALANCE, CAddressIndexIteratorKey(type, addressHash)));
+
+    while (pcursor->Valid()) {
+        std::pair<char, CAddressBalanceKey> key;
+        if (!pcursor->GetKey(key) || key.first != DB_ADDRESSBALANCE || key.second.type != (unsigned int)type || key.second.hashBytes != addressHash)
+            break;
+        CAddressBalanceValue value;
+        if (!pcursor->GetValue(value))
+            return error("failed to get address balance value");
+        vBalances.emplace_back(key.second.asset, value);
+        pcursor->Next();
+    }
+    return true;
+}
+
+bool CBlockTreeDB::HaveAddressBalances() {
+    bool fHave = false;
+    return ReadFlag("addressbalances", fHave) && fHave;
+}
+
+bool CBlockTreeDB::BuildAddressBalances() {
+    LogPrintf("Building address balances from the address index...\n");
+
+    // Drop any partial rollups first; keys are ordered by address and asset,
+    // so each one is summed in a single pass over its entries
+    std::unique_ptr<CDBIterator> pcursor(NewIterator());
+    CDBBatch batch(*this);
+    pcursor->Seek(DB_ADDRESSBALANCE);
+    while (pcursor->Valid()) {
+        std::pair<char, CAddressBalanceKey> key;
+        if (!pcursor->GetKey(key) || key.first != DB_ADDRESSBALANCE)
+            break;
+        batch.Erase(key);
+        pcursor->Next();
+    }
+    if (!WriteBatch(batch))
+        return error("%s: failed to erase address balances", __func__);
+    batch.Clear();
+
+    CAddressBalanceKey current;
+    CAddressBalanceValue value;
+    bool fCurrent = false;
+    size_t nRecords = 0;
+    pcursor->Seek(DB_ADDRESSINDEX);
+    while (true) {
+        boost::this_thread::interruption_point();
+        std::pair<char, CAddressIndexKey> key;
+        bool fValid = pcursor->Valid() && pcursor->GetKey(key) && key.first == DB_ADDRESSINDEX;
+        CAddressBalanceKey next;
+        if (fValid)
+            next = CAddressBalanceKey(key.second.type, key.second.hashBytes, key.second.asset);
+        if (fCurrent && (!fValid || current.type != next.type || current.hashBytes != next.hashBytes || current.asset != next.asset)) {
+            if (!value.IsNull())
+                batch.Write(std::make_pair(DB_ADDRESSBALANCE, current), value);
+            value.SetNull();
+            fCurrent = false;
+            if (batch.SizeEstimate() > (size_t)nDefaultDbBatchSize) {
+                if (!WriteBatch(batch))
+                    return error("%s: failed to write address balances", __func__);
+                batch.Clear();
+            }
+            nRecords++;
+        }
+        if (!fValid)
+            break;
+        CAmount nValue;
+        if (!pcursor->GetValue(nValue))
+            return error("%s: failed to get address index value", __func__);
+        current = next;
+        fCurrent = true;
+        value.balance += nValue;
+        if (nValue > 0)
+            value.received += nValue;
+        pcursor->Next();
+    }
+
+    batch.Write(std::make_pair(DB_FLAG, std::string("addressbalances")), '1');
+    if (!WriteBatch(batch))
+        return error("%s: failed to write address balances", __func__);
+    LogPrintf("Built %u address balances\n", nRecords);
+    return true;
+}
+
 bool CBlockTreeDB::ReadAddressIndex(uint160 addressHash, int type, std::string assetName,
                                     std::vector<std::pair<CAddressIndexKey, CAmount> > &addressIndex,
                                     int start, int end) {
@@ -396,19 +797,146 @@ bool CBlockTreeDB::ReadAddressIndex(uint160 addressHash, int type,
     return CBlockTreeDB::ReadAddressIndex(addressHash, type, "", addressIndex, start, end);
 }
 
+/** Output index as it sorts in the database, where it is stored little endian */
+static uint32_t AddressIndexSortIndex(size_t index)
+{
+    unsigned char buf[4];
+    WriteLE32(buf, index);
+    return ReadBE32(buf);
+}
+
+bool CAddressIndexCursor::Less(const CAddressIndexKey& a, const CAddressIndexKey& b)
+{
+    // Within one address and asset this is the order of the database keys
+    if (a.blockHeight != b.blockHeight)
+        return a.blockHeight < b.blockHeight;
+    if (a.txindex != b.txindex)
+        return a.txindex < b.txindex;
+    if (a.txhash != b.txhash)
+        return a.txhash < b.txhash;
+    if (a.index != b.index)
+        return AddressIndexSortIndex(a.index) < AddressIndexSortIndex(b.index);
+    if (a.spending != b.spending)
+        return a.spending < b.spending;
+    // Entries of a transaction for different addresses
+    if (a.type != b.type)
+        return a.type < b.type;
+    if (a.hashBytes != b.hashBytes)
+        return a.hashBytes < b.hashBytes;
+    return a.asset < b.asset;
+}
+
+CAddressIndexCursor::CAddressIndexCursor(CBlockTreeDB& db, const std::vector<std::pair<uint160, int> >& addresses, const std::string& assetName, int start, int end, const CAddressIndexKey* pAfter) :
+    snapshot(db.GetSnapshot()), nEnd(end), fFailed(false)
+{
+    for (const auto& address : addresses) {
+        if (!assetName.empty()) {
+            AddSource(db, address.second, address.first, assetName, start, pAfter);
+            continue;
+        }
+
+        // One source per asset the address has entries for: find the first
+        // entry of each, then skip past the asset's highest possible height
+        std::unique_ptr<CDBIterator> pcursor(db.NewIterator(snapshot.get()));
+        pcursor->Seek(std::make_pair(DB_ADDRESSINDEX, CAddressIndexIteratorKey(address.second, address.first)));
+        std::pair<char, CAddressIndexKey> key;
+        while (pcursor->Valid() && pcursor->GetKey(key) && key.first == DB_ADDRESSINDEX &&
+               key.second.type == (unsigned int)address.second && key.second.hashBytes == address.first) {
+            AddSource(db, address.second, address.first, key.second.asset, start, pAfter);
+            pcursor->Seek(std::make_pair(DB_ADDRESSINDEX, CAddressIndexIteratorHeightKey(address.second, address.first, key.second.asset, -1)));
+        }
+    }
+}
+
+void CAddressIndexCursor::AddSource(CBlockTreeDB& db, unsigned int type, const uint160& hashBytes, const std::string& asset, int start, const CAddressIndexKey* pAfter)
+{
+    vSources.emplace_back();
+    Source& source = vSources.back();
+    source.pcursor.reset(db.NewIterator(snapshot.get()));
+    source.type = type;
+    source.hashBytes = hashBytes;
+    source.asset = asset;
+
+    int nHeight = start;
+    if (pAfter)
+        nHeight = std::max(nHeight, pAfter->blockHeight);
+    source.pcursor->Seek(std::make_pair(DB_ADDRESSINDEX, CAddressIndexIteratorHeightKey(type, hashBytes, asset, nHeight)));
+    bool fValid = ReadSource(source);
+    while (fValid && pAfter && !Less(*pAfter, source.key)) {
+        source.pcursor->Next();
+        fValid = ReadSource(source);
+    }
+    if (!fValid) {
+        vSources.pop_back();
+        return;
+    }
+    vHeap.push_back(vSources.size() - 1);
+    std::push_heap(vHeap.begin(), vHeap.end(), [this](size_t a, size_t b) { return HeapGreater(a, b); });
+}
+
+bool CAddressIndexCursor::ReadSource(Source& source)
+{
+    std::pair<char, CAddressIndexKey> key;
+    if (!source.pcursor->Valid() || !source.pcursor->GetKey(key) || key.first != DB_ADDRESSINDEX ||
+        key.second.type != source.type || key.second.hashBytes != source.hashBytes || key.second.asset != source.asset)
+        return false;
+    if (nEnd > 0 && key.second.blockHeight > nEnd)
+        return false;
+    if (!source.pcursor->GetValue(source.nValue)) {
+        fFailed = true;
+        return false;
+    }
+    source.key = std::move(key.second);
+    return true;
+}
+
+bool CAddressIndexCursor::HeapGreater(size_t a, size_t b) const
+{
+    return Less(vSources[b].key, vSources[a].key);
+}
+
+void CAddressIndexCursor::Next()
+{
+    auto cmp = [this](size_t a, size_t b) { return HeapGreater(a, b); };
+    std::pop_heap(vHeap.begin(), vHeap.end(), cmp);
+    Source& source = vSources[vHeap.back()];
+    source.pcursor->Next();
+    if (ReadSource(source))
+        std::push_heap(vHeap.begin(), vHeap.end(), cmp);
+    else
+        vHeap.pop_back();
+}
+
 bool CBlockTreeDB::WriteTimestampIndex(const CTimestampIndexKey &timestampIndex) {
     CDBBatch batch(*this);
     batch.Write(std::make_pair(DB_TIMESTAMPINDEX, timestampIndex), 0);
     return WriteBatch(batch);
 }
 
-bool CBlockTreeDB::ReadTimestampIndex(const unsigned int &high, const unsigned int &low, const bool fActiveOnly, std::vector<std::pair<uint256, unsigned int> > &hashes) {
+bool CBlockTreeDB::ReadTimestampIndex(const unsigned int &high, const unsigned int &low, const bool fActiveOnly, std::vector<std::pair<uint256, unsigned int> > &hashes,
+                                      size_t nLimit, const uint256 &hashStartAfter) {
 
     boost::scoped_ptr<CDBIterator> pcursor(NewIterator());
 
-    pcursor->Seek(std::make_pair(DB_TIMESTAMPINDEX, CTimestampIndexIteratorKey(low)));
+    if (hashStartAfter.IsNull()) {
+        pcursor->Seek(std::make_pair(DB_TIMESTAMPINDEX, CTimestampIndexIteratorKey(low)));
+    } else {
+        // Its entry is keyed by its logical timestamp, then its hash
+        unsigned int ltimestamp;
+        if (!ReadTimestampBlockIndex(hashStartAfter, ltimestamp))
+            return error("%s: no timestamp index entry for %s", __func__, hashStartAfter.GetHex());
+        CTimestampIndexKey keyStartAfter(ltimestamp, hashStartAfter);
+        pcursor->Seek(std::make_pair(DB_TIMESTAMPINDEX, keyStartAfter));
+        std::pair<char, CTimestampIndexKey> key;
+        if (pcursor->Valid() && pcursor->GetKey(key) && key.first == DB_TIMESTAMPINDEX &&
+            key.second.timestamp == ltimestamp && key.second.blockHash == hashStartAfter) {
+            pcursor->Next();
+        }
+        if (ltimestamp < low)
+            pcursor->Seek(std::make_pair(DB_TIMESTAMPINDEX, CTimestampIndexIteratorKey(low)));
+    }
 
-    while (pcursor->Valid()) {
+    while (pcursor->Valid() && hashes.size() < nLimit) {
         boost::this_thread::interruption_point();
         std::pair<char, CTimestampIndexKey> key;
         if (pcursor->GetKey(key) && key.first == DB_TIMESTAMPINDEX && key.second.timestamp < high) {
@@ -457,6 +985,49 @@ bool CBlockTreeDB::ReadFlag(const std::string &name, bool &fValue) {
     return true;
 }
 
+bool CBlockTreeDB::ReadIndexBuild(CIndexBuildState& state) {
+    return Read(DB_INDEX_BUILD, state);
+}
+
+bool CBlockTreeDB::WriteIndexBuild(const CIndexBuildState& state) {
+    return Write(DB_INDEX_BUILD, state, true);
+}
+
+bool CBlockTreeDB::WriteIndexBuildBatch(const CIndexBuildBatch& entries, const CIndexBuildState& state, bool fFinished) {
+    CDBBatch batch(*this);
+    if (!UpdateAddressBalances(batch, entries.vAddressIndex, false))
+        return false;
+    for (const auto& entry : entries.vAddressIndex)
+        batch.Write(std::make_pair(DB_ADDRESSINDEX, entry.first), entry.second);
+    for (const auto& entry : entries.vAddressUnspent) {
+        if (entry.second.IsNull())
+            batch.Erase(std::make_pair(DB_ADDRESSUNSPENTINDEX, entry.first));
+        else
+            batch.Write(std::make_pair(DB_ADDRESSUNSPENTINDEX, entry.first), entry.second);
+    }
+    for (const auto& entry : entries.vSpentIndex)
+        batch.Write(std::make_pair(DB_SPENTINDEX, entry.first), entry.second);
+    for (const auto& entry : entries.vTimestamps) {
+        batch.Write(std::make_pair(DB_TIMESTAMPINDEX, CTimestampIndexKey(entry.second, entry.first)), 0);
+        batch.Write(std::make_pair(DB_BLOCKHASHINDEX, CTimestampBlockIndexKey(entry.first)), CTimestampBlockIndexValue(entry.second));
+    }
+
+    if (!fFinished) {
+        batch.Write(DB_INDEX_BUILD, state);
+        return WriteBatch(batch);
+    }
+    if (state.nIndexes & INDEX_BUILD_ADDRESS) {
+        batch.Write(std::make_pair(DB_FLAG, std::string("addressindex")), '1');
+        batch.Write(std::make_pair(DB_FLAG, std::string("addressbalances")), '1');
+    }
+    if (state.nIndexes & INDEX_BUILD_SPENT)
+        batch.Write(std::make_pair(DB_FLAG, std::string("spentindex")), '1');
+    if (state.nIndexes & INDEX_BUILD_TIMESTAMP)
+        batch.Write(std::make_pair(DB_FLAG, std::string("timestampindex")), '1');
+    batch.Erase(DB_INDEX_BUILD);
+    return WriteBatch(batch, true);
+}
+
 bool CBlockTreeDB::LoadBlockIndexGuts(const Consensus::Params& consensusParams, std::function<CBlockIndex*(const uint256&)> insertBlockIndex)
 {
     std::unique_ptr<CDBIterator> pcursor(NewIterator());
@@ -470,23 +1041,21 @@ bool CBlockTreeDB::LoadBlockIndexGuts(const Consensus::Params& consensusParams,
         if (pcursor->GetKey(key) && key.first == DB_BLOCK_INDEX) {
             CDiskBlockIndex diskindex;
             if (pcursor->GetValue(diskindex)) {
-                // Construct block index object
-                CBlockIndex* pindexNew = insertBlockIndex(diskindex.GetBlockHash());
+                // Construct block index object. The key is the block hash, which saves
+                // hashing every header again; VerifyBlockIndexHashes checks it.
+                CBlockIndex* pindexNew = insertBlockIndex(key.second);
                 pindexNew->pprev          = insertBlockIndex(diskindex.hashPrev);
                 pindexNew->nHeight        = diskindex.nHeight;
                 pindexNew->nFile          = diskindex.nFile;
                 pindexNew->nDataPos       = diskindex.nDataPos;
                 pindexNew->nUndoPos       = diskindex.nUndoPos;
                 pindexNew->nVersion       = diskindex.nVersion;
-                pindexNew->hashMerkleRoot = diskindex.hashMerkleRoot;
                 pindexNew->nTime          = diskindex.nTime;
                 pindexNew->nBits          = diskindex.nBits;
-                pindexNew->nNonce         = diskindex.nNonce;
                 pindexNew->nStatus        = diskindex.nStatus;
                 pindexNew->nTx            = diskindex.nTx;
-                pindexNew->nNonce64       = diskindex.nNonce64;
-                pindexNew->mix_hash       = diskindex.mix_hash;
                 pindexNew->nHeight        = diskindex.nHeight;
+                pindexNew->SetColdData(diskindex.cold);
 
                 if (!CheckProofOfWork(pindexNew->GetBlockHash(), pindexNew->nBits, consensusParams))
                     return error("%s: CheckProofOfWork failed: %s", __func__, pindexNew->ToString());
@@ -503,6 +1072,31 @@ bool CBlockTreeDB::LoadBlockIndexGuts(const Consensus::Params& consensusParams,
     return true;
 }
 
+bool CBlockTreeDB::VerifyBlockIndexHashes(const Consensus::Params& consensusParams)
+{
+    std::unique_ptr<CDBIterator> pcursor(NewIterator());
+
+    pcursor->Seek(std::make_pair(DB_BLOCK_INDEX, uint256()));
+
+    while (pcursor->Valid()) {
+        boost::this_thread::interruption_point();
+        std::pair<char, uint256> key;
+        if (!pcursor->GetKey(key) || key.first != DB_BLOCK_INDEX)
+            break;
+        CDiskBlockIndex diskindex;
+        if (!pcursor->GetValue(diskindex))
+            return error("%s: failed to read value", __func__);
+        const uint256 hash = diskindex.GetBlockHash();
+        if (hash != key.second)
+            return error("%s: block index entry %s holds the header of block %s", __func__, key.second.ToString(), hash.ToString());
+        if (!CheckProofOfWork(hash, diskindex.nBits, consensusParams))
+            return error("%s: CheckProofOfWork failed: %s", __func__, diskindex.ToString());
+        pcursor->Next();
+    }
+
+    return true;
+}
+
 namespace {
 
 //! Legacy class to deserialize pre-pertxout database entries without reindex.
@@ -560,11 +1154,20 @@ public:
 
 /** Upgrade the database from older formats.
  *
- * Currently implemented: from the per-tx utxo model (0.8..0.14.x) to per-txout.
+ * Currently implemented: from the per-tx utxo model (0.8..0.14.x) to per-txout,
+ * and from Coin's own serialization to the one with compressed asset scripts.
  */
 bool CCoinsViewDB::Upgrade() {
+    return UpgradePerTxCoins() && UpgradeAssetScripts();
+}
+
+bool CCoinsViewDB::UpgradePerTxCoins() {
     std::unique_ptr<CDBIterator> pcursor(db.NewIterator());
     pcursor->Seek(std::make_pair(DB_COINS, uint256()));
+    // The format guard sorts first and is not a coin
+    std::pair<unsigned char, uint256> key;
+    if (pcursor->Valid() && pcursor->GetKey(key) && key.first == DB_COINS && key.second.IsNull())
+        pcursor->Next();
     if (!pcursor->Valid()) {
         return true;
     }
@@ -576,7 +1179,6 @@ bool CCoinsViewDB::Upgrade() {
     size_t batch_size = 1 << 24;
     CDBBatch batch(db);
     int reportDone = 0;
-    std::pair<unsigned char, uint256> key;
     std::pair<unsigned char, uint256> prev_key = {DB_COINS, uint256()};
     while (pcursor->Valid()) {
         boost::this_thread::interruption_point();
@@ -604,7 +1206,7 @@ bool CCoinsViewDB::Upgrade() {
                     Coin newcoin(std::move(old_coins.vout[i]), old_coins.nHeight, old_coins.fCoinBase);
                     outpoint.n = i;
                     CoinEntry entry(&outpoint);
-                    batch.Write(entry, newcoin);
+                    batch.Write(entry, CoinValue(&newcoin, fAssetScripts));
                 }
             }
             batch.Erase(key);
@@ -625,3 +1227,86 @@ bool CCoinsViewDB::Upgrade() {
     LogPrintf("[%s].\n", ShutdownRequested() ? "CANCELLED" : "DONE");
     return !ShutdownRequested();
 }
+
+bool CCoinsViewDB::UpgradeAssetScripts() {
+    if (fAssetScripts)
+        return true;
+
+    // Coins up to the one in DB_COIN_FORMAT_UPGRADE are already rewritten: carry on after it
+    std::unique_ptr<CDBIterator> pcursor(db.NewIterator());
+    COutPoint outpoint;
+    CoinEntry entry(&outpoint);
+    if (db.Read(DB_COIN_FORMAT_UPGRADE, outpoint)) {
+        const COutPoint last = outpoint;
+        pcursor->Seek(entry);
+        if (pcursor->Valid() && pcursor->GetKey(entry) && entry.key == DB_COIN && outpoint == last)
+            pcursor->Next();
+    } else {
+        pcursor->Seek(DB_COIN);
+    }
+
+    // Older releases must not load the chainstate once any coin changed format
+    if (!db.Exists(DB_COIN_FORMAT_GUARD) && !db.Write(DB_COIN_FORMAT_GUARD, COIN_FORMAT_GUARD_VALUE, true))
+        return false;
+
+    int64_t count = 0;
+    LogPrintf("Upgrading utxo-set database to compressed asset scripts...\n");
+    LogPrintf("[0%%]...");
+    uiInterface.ShowProgress(_("Upgrading UTXO database"), 0, true);
+    size_t batch_size = 1 << 24;
+    CDBBatch batch(db);
+    int reportDone = 0;
+    size_t nRewritten = 0;
+    bool fDone = true;
+    while (pcursor->Valid()) {
+        boost::this_thread::interruption_point();
+        if (ShutdownRequested()) {
+            fDone = false;
+            break;
+        }
+        if (!pcursor->GetKey(entry) || entry.key != DB_COIN)
+            break;
+        if (count++ % 256 == 0) {
+            uint32_t high = 0x100 * *outpoint.hash.begin() + *(outpoint.hash.begin() + 1);
+            int percentageDone = (int)(high * 100.0 / 65536.0 + 0.5);
+            uiInterface.ShowProgress(_("Upgrading UTXO database"), percentageDone, true);
+            if (reportDone < percentageDone/10) {
+                // report max. every 10% step
+                LogPrintf("[%d%%]...", percentageDone);
+                reportDone = percentageDone/10;
+            }
+        }
+        Coin coin;
+        CoinValue value(&coin, false);
+        if (!pcursor->GetValue(value)) {
+            return error("%s: cannot parse coin record", __func__);
+        }
+        // Every raw script moves, but the common pubkey and script hash cases don't
+        CDataStream ssOld(SER_DISK, CLIENT_VERSION), ssNew(SER_DISK, CLIENT_VERSION);
+        ssOld << value;
+        ssNew << CoinValue(&coin, true);
+        if (ssOld.str() != ssNew.str()) {
+            batch.Write(entry, CoinValue(&coin, true));
+            nRewritten++;
+        }
+        if (batch.SizeEstimate() > batch_size) {
+            batch.Write(DB_COIN_FORMAT_UPGRADE, outpoint);
+            if (!db.WriteBatch(batch))
+                return false;
+            batch.Clear();
+        }
+        pcursor->Next();
+    }
+    if (fDone) {
+        batch.Erase(DB_COIN_FORMAT_UPGRADE);
+        batch.Write(DB_COIN_FORMAT, COIN_FORMAT_ASSET_SCRIPTS);
+    } else if (count > 0) {
+        batch.Write(DB_COIN_FORMAT_UPGRADE, outpoint);
+    }
+    if (!db.WriteBatch(batch, true))
+        return false;
+    uiInterface.ShowProgress("", 100, false);
+    LogPrintf("[%s], %u coins rewritten.\n", fDone ? "DONE" : "CANCELLED", nRewritten);
+    fAssetScripts = fDone;
+    return fDone;
+}
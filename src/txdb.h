@@ -9,13 +9,19 @@
 
 #include "coins.h"
 #include "dbwrapper.h"
+#include "sync.h"
 #include "chain.h"
 #include "addressindex.h"
+#include "indexbuilder.h"
 #include "spentindex.h"
 #include "timestampindex.h"
 
+#include <atomic>
+#include <limits>
 #include <map>
+#include <memory>
 #include <string>
+#include <thread>
 #include <utility>
 #include <vector>
 
@@ -41,6 +47,14 @@ static const int64_t nMaxBlockDBCache = 2;
 static const int64_t nMaxBlockDBAndTxIndexCache = 1024;
 //! Max memory allocated to coin DB specific cache (MiB)
 static const int64_t nMaxCoinsDBCache = 8;
+//! -verifyblockindex default
+static const bool DEFAULT_VERIFYBLOCKINDEX = false;
+//! -dbsharedcache default
+static const bool DEFAULT_DB_SHARED_CACHE = true;
+//! Most threads CCoinsViewDB::GetCoins reads with
+static const size_t MAX_COINS_READ_THREADS = 8;
+//! Fewest outpoints worth a read thread of their own
+static const size_t COINS_READ_BATCH = 16;
 
 struct CDiskTxPos : public CDiskBlockPos
 {
@@ -72,21 +86,86 @@ class CCoinsViewDB final : public CCoinsView
 {
 protected:
     CDBWrapper db;
+    //! Whether coins are stored with compressed asset scripts (see CScriptCompressor)
+    bool fAssetScripts;
+
+    bool UpgradePerTxCoins();
+    bool UpgradeAssetScripts();
 public:
     explicit CCoinsViewDB(size_t nCacheSize, bool fMemory = false, bool fWipe = false);
 
     bool GetCoin(const COutPoint &outpoint, Coin &coin) const override;
     bool HaveCoin(const COutPoint &outpoint) const override;
+    //! Reads the outpoints in key order, split into runs read on up to MAX_COINS_READ_THREADS threads
+    void GetCoins(const std::vector<COutPoint> &vOutpoints, std::vector<std::pair<COutPoint, Coin>> &vCoins) const override;
     uint256 GetBestBlock() const override;
     std::vector<uint256> GetHeadBlocks() const override;
     bool BatchWrite(CCoinsMap &mapCoins, const uint256 &hashBlock) override;
     CCoinsViewCursor *Cursor() const override;
 
+    //! A consistent state of the database that several cursors can read in parts
+    std::shared_ptr<const CDBSnapshot> GetSnapshot() const { return db.GetSnapshot(); }
+    //! Cursor over the coins of snapshot, from the first one whose txid is not below hashFrom
+    CCoinsViewCursor *Cursor(const std::shared_ptr<const CDBSnapshot>& snapshot, const uint256 &hashFrom) const;
+
+    //! Mark the database as in transition to hashBlock, the first half of BatchWrite
+    bool BeginBatchWrite(const uint256 &hashBlock);
+    //! Write the dirty entries of mapCoins and mark the database consistent with hashBlock again. Leaves mapCoins alone.
+    bool WriteCoins(const CCoinsMap &mapCoins, const uint256 &hashBlock);
+
     //! Attempt to update from an older database format. Returns whether an error occurred.
     bool Upgrade();
     size_t EstimateSize() const override;
 };
 
+/**
+ * CCoinsView between the tip cache and the coins database that can write a
+ * flush on a background thread. BatchWrite then only marks the database as
+ * in transition (so ReplayBlocks finishes the job after a crash) and takes
+ * over the flushed entries; validation goes on into the now empty tip cache,
+ * reading the taken entries from here until they are on disk.
+ *
+ * Only one write is in flight: the next BatchWrite, Cursor or WaitForWrite
+ * waits for it.
+ */
+class CCoinsViewFlushBuffer final : public CCoinsViewBacked
+{
+private:
+    CCoinsViewDB *pdb;
+
+    //! Guards replacing and dropping mapFrozen. The writer only reads it.
+    mutable CCriticalSection cs;
+    CCoinsMap mapFrozen;
+    uint256 hashFrozen;
+    size_t nFrozenUsage{0};
+
+    //! Guards starting and joining the writer
+    mutable CCriticalSection cs_writer;
+    mutable std::thread writer;
+    std::atomic<bool> fFailed{false};
+    bool fBackground{false};
+
+public:
+    CCoinsViewFlushBuffer(CCoinsView *viewIn, CCoinsViewDB *pdbIn);
+    ~CCoinsViewFlushBuffer();
+
+    bool GetCoin(const COutPoint &outpoint, Coin &coin) const override;
+    bool HaveCoin(const COutPoint &outpoint) const override;
+    void GetCoins(const std::vector<COutPoint> &vOutpoints, std::vector<std::pair<COutPoint, Coin>> &vCoins) const override;
+    uint256 GetBestBlock() const override;
+    bool BatchWrite(CCoinsMap &mapCoins, const uint256 &hashBlock) override;
+    CCoinsViewCursor *Cursor() const override;
+
+    //! Whether the next BatchWrite returns before its entries are on disk
+    void SetBackground(bool fBackgroundIn) { fBackground = fBackgroundIn; }
+    //! Wait for the write in flight, if any. False if a background write failed.
+    bool WaitForWrite() const;
+    //! Whether a background write failed
+    bool WriteFailed() const { return fFailed; }
+    //! Memory held by entries not written yet
+    size_t DynamicMemoryUsage() const;
+};
+
 /** Specialization of CCoinsViewCursor to iterate over a CCoinsViewDB */
 class CCoinsViewDBCursor: public CCoinsViewCursor
 {
@@ -101,10 +180,13 @@ public:
     void Next() override;
 
 private:
-    CCoinsViewDBCursor(CDBIterator* pcursorIn, const uint256 &hashBlockIn):
-        CCoinsViewCursor(hashBlockIn), pcursor(pcursorIn) {}
+    CCoinsViewDBCursor(CDBIterator* pcursorIn, const uint256 &hashBlockIn, bool fAssetScriptsIn, std::shared_ptr<const CDBSnapshot> snapshotIn = nullptr):
+        CCoinsViewCursor(hashBlockIn), snapshot(std::move(snapshotIn)), pcursor(pcursorIn), fAssetScripts(fAssetScriptsIn) {}
+    //! Snapshot the cursor reads, if any; declared first so it outlives pcursor
+    std::shared_ptr<const CDBSnapshot> snapshot;
     std::unique_ptr<CDBIterator> pcursor;
     std::pair<char, COutPoint> keyTmp;
+    bool fAssetScripts;
 
     friend class CCoinsViewDB;
 };
@@ -112,6 +194,11 @@ private:
 /** Access to the block database (blocks/index/) */
 class CBlockTreeDB : public CDBWrapper
 {
+private:
+    //! Add the entries to, or take them from, the balance rollups in batch.
+    //! Only entries the index doesn't have yet (or still has) count, so replaying a block is harmless.
+    bool UpdateAddressBalances(CDBBatch& batch, const std::vector<std::pair<CAddressIndexKey, CAmount> >& vect, bool fErase);
+
 public:
     explicit CBlockTreeDB(size_t nCacheSize, bool fMemory = false, bool fWipe = false, size_t maxFileSize = 2 << 20);
 
@@ -126,6 +213,8 @@ public:
     bool ReadTxIndex(const uint256 &txid, CDiskTxPos &pos);
     bool WriteTxIndex(const std::vector<std::pair<uint256, CDiskTxPos> > &vect);
     bool ReadSpentIndex(CSpentIndexKey &key, CSpentIndexValue &value);
+    //! Read the entries of many outpoints through one iterator, in key order; vFound[i] tells whether vValues[i] was read
+    void ReadSpentIndex(const std::vector<CSpentIndexKey> &vKeys, std::vector<CSpentIndexValue> &vValues, std::vector<bool> &vFound);
     bool UpdateSpentIndex(const std::vector<std::pair<CSpentIndexKey, CSpentIndexValue> >&vect);
     bool UpdateAddressUnspentIndex(const std::vector<std::pair<CAddressUnspentKey, CAddressUnspentValue > >&vect);
     bool ReadAddressUnspentIndex(uint160 addressHash, int type, std::string assetName,
@@ -140,13 +229,90 @@ public:
     bool ReadAddressIndex(uint160 addressHash, int type,
                           std::vector<std::pair<CAddressIndexKey, CAmount> > &addressIndex,
                           int start = 0, int end = 0);
+    //! Balance and received total of one asset of an address, from its rollup record
+    bool ReadAddressBalance(uint160 addressHash, int type, const std::string& assetName, CAddressBalanceValue& value);
+    //! Rollups of every asset an address has entries for
+    bool ReadAddressBalances(uint160 addressHash, int type, std::vector<std::pair<std::string, CAddressBalanceValue> >& vBalances);
+    //! Whether the rollups cover the whole address index, see BuildAddressBalances
+    bool HaveAddressBalances();
+    //! Compute the rollups of an address index written before they were kept
+    bool BuildAddressBalances();
     bool WriteTimestampIndex(const CTimestampIndexKey &timestampIndex);
-    bool ReadTimestampIndex(const unsigned int &high, const unsigned int &low, const bool fActiveOnly, std::vector<std::pair<uint256, unsigned int> > &vect);
+    //! Hashes of the blocks with low <= timestamp < high, in timestamp order, going no further than nLimit
+    //! of them, and starting after the block hashStartAfter (the last of a previous page) if it isn't null
+    bool ReadTimestampIndex(const unsigned int &high, const unsigned int &low, const bool fActiveOnly, std::vector<std::pair<uint256, unsigned int> > &vect,
+                            size_t nLimit = std::numeric_limits<size_t>::max(), const uint256 &hashStartAfter = uint256());
     bool WriteTimestampBlockIndex(const CTimestampBlockIndexKey &blockhashIndex, const CTimestampBlockIndexValue &logicalts);
     bool ReadTimestampBlockIndex(const uint256 &hash, unsigned int &logicalTS);
     bool WriteFlag(const std::string &name, bool fValue);
     bool ReadFlag(const std::string &name, bool &fValue);
+    //! State of the background index build in progress, if there is one
+    bool ReadIndexBuild(CIndexBuildState& state);
+    bool WriteIndexBuild(const CIndexBuildState& state);
+    /**
+     * Write index entries from the background build along with how far it has
+     * got. fFinished marks its indexes as complete and ends the build instead.
+     */
+    bool WriteIndexBuildBatch(const CIndexBuildBatch& entries, const CIndexBuildState& state, bool fFinished);
     bool LoadBlockIndexGuts(const Consensus::Params& consensusParams, std::function<CBlockIndex*(const uint256&)> insertBlockIndex);
+    /**
+     * Hash the header of every block index entry and check it against the key
+     * LoadBlockIndexGuts trusted, and its proof of work. Slow with X16R and
+     * KAWPOW headers, so it runs in the background if -verifyblockindex is set.
+     */
+    bool VerifyBlockIndexHashes(const Consensus::Params& consensusParams);
+};
+
+/**
+ * Walks the address index entries of several addresses together, in chain
+ * order: by height, position of the transaction in its block, then the rest of
+ * the key. It keeps one database cursor per address and asset and merges them
+ * with a heap, instead of reading every address into memory and sorting.
+ * All cursors read the same snapshot of the database.
+ */
+class CAddressIndexCursor
+{
+private:
+    struct Source {
+        std::unique_ptr<CDBIterator> pcursor;
+        unsigned int type;
+        uint160 hashBytes;
+        std::string asset;
+        CAddressIndexKey key;
+        CAmount nValue;
+    };
+
+    std::shared_ptr<const CDBSnapshot> snapshot;
+    std::vector<Source> vSources;
+    //! Heap of indexes into vSources, the next entry in chain order at the front
+    std::vector<size_t> vHeap;
+    int nEnd;
+    bool fFailed;
+
+    void AddSource(CBlockTreeDB& db, unsigned int type, const uint160& hashBytes, const std::string& asset, int start, const CAddressIndexKey* pAfter);
+    bool ReadSource(Source& source);
+    bool HeapGreater(size_t a, size_t b) const;
+
+public:
+    /**
+     * Entries of the addresses for assetName, or every asset if it is empty,
+     * from height start up to end (0 for no limit). With pAfter the walk
+     * resumes after that entry, the last one of an earlier walk.
+     */
+    CAddressIndexCursor(CBlockTreeDB& db, const std::vector<std::pair<uint160, int> >& addresses, const std::string& assetName, int start = 0, int end = 0, const CAddressIndexKey* pAfter = nullptr);
+
+    CAddressIndexCursor(const CAddressIndexCursor&) = delete;
+    CAddressIndexCursor& operator=(const CAddressIndexCursor&) = delete;
+
+    bool Valid() const { return !vHeap.empty(); }
+    const CAddressIndexKey& GetKey() const { return vSources[vHeap.front()].key; }
+    CAmount GetValue() const { return vSources[vHeap.front()].nValue; }
+    void Next();
+    //! Whether an entry could not be read, which ends the walk early
+    bool Failed() const { return fFailed; }
+
+    //! Strict chain order of entries, the order of the walk
+    static bool Less(const CAddressIndexKey& a, const CAddressIndexKey& b);
 };
 
 #endif // MYNTA_TXDB_H
@@ -10,6 +10,7 @@
 #include "consensus/tx_verify.h"
 #include "consensus/validation.h"
 #include "validation.h"
+#include "validationinterface.h"
 #include "policy/policy.h"
 #include "policy/fees.h"
 #include "reverse_iterator.h"
@@ -111,6 +112,9 @@ void CTxMemPool::UpdateForDescendants(txiter updateIt, cacheMap &cachedDescendan
 void CTxMemPool::UpdateTransactionsFromBlock(const std::vector<uint256> &vHashesToUpdate)
 {
     LOCK(cs);
+    // Entries already in the mempool gain the re-added transactions as ancestors
+    ClearAncestorCache();
+    ++nPackagesChanged;
     // For each entry in vHashesToUpdate, store the set of in-mempool, but not
     // in-vHashesToUpdate transactions, so that we don't have to recalculate
     // descendants when we come across a previously seen entry.
@@ -181,11 +185,9 @@ bool CTxMemPool::CalculateMemPoolAncestors(const CTxMemPoolEntry &entry, setEntr
 
     size_t totalSizeWithAncestors = entry.GetTxSize();
 
-    while (!parentHashes.empty()) {
-        txiter stageit = *parentHashes.begin();
-
+    // Add an ancestor, checking that the entry fits within its descendant limits
+    auto fnAddAncestor = [&](txiter stageit) {
         setAncestors.insert(stageit);
-        parentHashes.erase(stageit);
         totalSizeWithAncestors += stageit->GetTxSize();
 
         if (stageit->GetSizeWithDescendants() + entry.GetTxSize() > limitDescendantSize) {
@@ -198,6 +200,37 @@ bool CTxMemPool::CalculateMemPoolAncestors(const CTxMemPoolEntry &entry, setEntr
             errString = strprintf("exceeds ancestor size limit [limit: %u]", limitAncestorSize);
             return false;
         }
+        return true;
+    };
+
+    // A parent added recently has its ancestor set cached, so a long chain of
+    // dependent transactions is not walked again for every child
+    for (setEntries::iterator pit = parentHashes.begin(); fSearchForParents && pit != parentHashes.end();) {
+        cacheMap::const_iterator itCache = mapAncestorCache.find(*pit);
+        if (itCache == mapAncestorCache.end()) {
+            ++pit;
+            continue;
+        }
+        if (!setAncestors.count(*pit) && !fnAddAncestor(*pit))
+            return false;
+        for (txiter ancestorIt : itCache->second) {
+            if (!setAncestors.count(ancestorIt) && !fnAddAncestor(ancestorIt))
+                return false;
+        }
+        pit = parentHashes.erase(pit);
+        if (parentHashes.size() + setAncestors.size() + 1 > limitAncestorCount) {
+            errString = strprintf("too many unconfirmed ancestors [limit: %u]", limitAncestorCount);
+            return false;
+        }
+    }
+
+    while (!parentHashes.empty()) {
+        txiter stageit = *parentHashes.begin();
+        parentHashes.erase(stageit);
+        if (setAncestors.count(stageit))
+            continue;
+        if (!fnAddAncestor(stageit))
+            return false;
 
         const setEntries & setMemPoolParents = GetMemPoolParents(stageit);
         for (const txiter &phash : setMemPoolParents) {
@@ -215,6 +248,22 @@ bool CTxMemPool::CalculateMemPoolAncestors(const CTxMemPoolEntry &entry, setEntr
     return true;
 }
 
+void CTxMemPool::CacheAncestors(txiter it, const setEntries &setAncestors)
+{
+    if (nAncestorCacheEntries + setAncestors.size() + 1 > ANCESTOR_CACHE_MAX_ENTRIES)
+        ClearAncestorCache();
+    if (setAncestors.size() + 1 > ANCESTOR_CACHE_MAX_ENTRIES)
+        return;
+    mapAncestorCache.emplace(it, setAncestors);
+    nAncestorCacheEntries += setAncestors.size() + 1;
+}
+
+void CTxMemPool::ClearAncestorCache()
+{
+    mapAncestorCache.clear();
+    nAncestorCacheEntries = 0;
+}
+
 void CTxMemPool::UpdateAncestorsOf(bool add, txiter it, setEntries &setAncestors)
 {
     setEntries parentIters = GetMemPoolParents(it);
@@ -236,6 +285,14 @@ void CTxMemPool::UpdateEntryForAncestors(txiter it, const setEntries &setAncesto
     int64_t updateSize = 0;
     CAmount updateFee = 0;
     int64_t updateSigOpsCost = 0;
+    // With one parent, the ancestors are the parent and its own ancestors,
+    // which the parent's ancestor state already sums up
+    const setEntries &setParents = GetMemPoolParents(it);
+    if (setParents.size() == 1 && (*setParents.begin())->GetCountWithAncestors() == updateCount) {
+        const txiter parentIt = *setParents.begin();
+        mapTx.modify(it, update_ancestor_state(parentIt->GetSizeWithAncestors(), parentIt->GetModFeesWithAncestors(), updateCount, parentIt->GetSigOpCostWithAncestors()));
+        return;
+    }
     for (txiter ancestorIt : setAncestors) {
         updateSize += ancestorIt->GetTxSize();
         updateFee += ancestorIt->GetModifiedFee();
@@ -331,7 +388,7 @@ void CTxMemPoolEntry::UpdateAncestorState(int64_t modifySize, CAmount modifyFee,
 }
 
 CTxMemPool::CTxMemPool(CBlockPolicyEstimator* estimator) :
-    nTransactionsUpdated(0), minerPolicyEstimator(estimator)
+    nTransactionsUpdated(0), nPackagesChanged(0), minerPolicyEstimator(estimator), nEventSequence(0)
 {
     _clear(); //lock free clear
 
@@ -359,6 +416,12 @@ void CTxMemPool::AddTransactionsUpdated(unsigned int n)
     nTransactionsUpdated += n;
 }
 
+unsigned int CTxMemPool::GetPackagesChanged() const
+{
+    LOCK(cs);
+    return nPackagesChanged;
+}
+
 bool CTxMemPool::addUnchecked(const uint256& hash, const CTxMemPoolEntry &entry, setEntries &setAncestors, bool validFeeEstimate)
 {
     NotifyEntryAdded(entry.GetSharedTx());
@@ -407,6 +470,11 @@ bool CTxMemPool::addUnchecked(const uint256& hash, const CTxMemPoolEntry &entry,
     }
     UpdateAncestorsOf(true, newit, setAncestors);
     UpdateEntryForAncestors(newit, setAncestors);
+    CacheAncestors(newit, setAncestors);
+
+    if (entry.GetAssetRecord())
+        addAssetIndex(hash, *entry.GetAssetRecord());
+    AddEvent(CMempoolEvent::ADDED, MemPoolRemovalReason::UNKNOWN, hash, entry.GetSharedAssetRecord());
 
     nTransactionsUpdated++;
     totalTxSize += entry.GetTxSize();
@@ -548,6 +616,129 @@ bool CTxMemPool::removeAddressIndex(const uint256 txhash)
     return true;
 }
 
+/** RVN START */
+template <typename Index>
+static void IndexAssetKey(Index& index, const typename Index::key_type& key, const uint256& hash)
+{
+    std::vector<uint256>& vHashes = index[key];
+    // A record can name a key twice, e.g. for two outputs to one address
+    if (vHashes.empty() || vHashes.back() != hash)
+        vHashes.push_back(hash);
+}
+
+template <typename Index>
+static void UnindexAssetKey(Index& index, const typename Index::key_type& key, const uint256& hash)
+{
+    auto it = index.find(key);
+    if (it == index.end())
+        return;
+    std::vector<uint256>& vHashes = it->second;
+    vHashes.erase(std::remove(vHashes.begin(), vHashes.end(), hash), vHashes.end());
+    if (vHashes.empty())
+        index.erase(it);
+}
+
+void CTxMemPool::addAssetIndex(const uint256& hash, const CMempoolAssetRecord& record)
+{
+    AssertLockHeld(cs);
+    if (!record.strNewAsset.empty())
+        mapAssetToHash[record.strNewAsset] = hash;
+    for (const auto& key : record.vQualifierAddresses)
+        IndexAssetKey(mapAddressesQualifiersChanged, key, hash);
+    for (const auto& key : record.vVerifierAssets)
+        IndexAssetKey(mapAssetVerifierChanged, key, hash);
+    for (const auto& key : record.vGlobalFrozenAssets)
+        IndexAssetKey(mapAssetMarkedGlobalFrozen, key, hash);
+    for (const auto& key : record.vFrozenAddresses)
+        IndexAssetKey(mapAddressesMarkedFrozen, key, hash);
+    for (const auto& key : record.vGlobalFreezes)
+        IndexAssetKey(mapGlobalFreezingAssetTransactions, key, hash);
+    for (const auto& key : record.vGlobalUnfreezes)
+        IndexAssetKey(mapGlobalUnFreezingAssetTransactions, key, hash);
+    for (const auto& key : record.vAddedTags)
+        IndexAssetKey(mapAddressAddedTag, key, hash);
+    for (const auto& key : record.vRemovedTags)
+        IndexAssetKey(mapAddressRemoveTag, key, hash);
+}
+
+void CTxMemPool::removeAssetIndex(const uint256& hash, const CMempoolAssetRecord& record)
+{
+    AssertLockHeld(cs);
+    if (!record.strNewAsset.empty()) {
+        auto it = mapAssetToHash.find(record.strNewAsset);
+        if (it != mapAssetToHash.end() && it->second == hash)
+            mapAssetToHash.erase(it);
+    }
+    for (const auto& key : record.vQualifierAddresses)
+        UnindexAssetKey(mapAddressesQualifiersChanged, key, hash);
+    for (const auto& key : record.vVerifierAssets)
+        UnindexAssetKey(mapAssetVerifierChanged, key, hash);
+    for (const auto& key : record.vGlobalFrozenAssets)
+        UnindexAssetKey(mapAssetMarkedGlobalFrozen, key, hash);
+    for (const auto& key : record.vFrozenAddresses)
+        UnindexAssetKey(mapAddressesMarkedFrozen, key, hash);
+    for (const auto& key : record.vGlobalFreezes)
+        UnindexAssetKey(mapGlobalFreezingAssetTransactions, key, hash);
+    for (const auto& key : record.vGlobalUnfreezes)
+        UnindexAssetKey(mapGlobalUnFreezingAssetTransactions, key, hash);
+    for (const auto& key : record.vAddedTags)
+        UnindexAssetKey(mapAddressAddedTag, key, hash);
+    for (const auto& key : record.vRemovedTags)
+        UnindexAssetKey(mapAddressRemoveTag, key, hash);
+}
+
+bool CTxMemPool::HasAssetIssue(const std::string& strName) const
+{
+    LOCK(cs);
+    return mapAssetToHash.count(strName) != 0;
+}
+
+bool CTxMemPool::HasGlobalRestrictionChange(const std::string& strName, bool fFreeze) const
+{
+    LOCK(cs);
+    return fFreeze ? mapGlobalFreezingAssetTransactions.count(strName) != 0 : mapGlobalUnFreezingAssetTransactions.count(strName) != 0;
+}
+
+bool CTxMemPool::HasAssetRecordConflict(const CMempoolAssetRecord& record, const setEntries& setReplaced, std::string& strReason) const
+{
+    LOCK(cs);
+    auto fnConflicts = [&](const std::vector<uint256>* pvHashes, const char* pszReason) {
+        if (!pvHashes)
+            return false;
+        for (const uint256& hash : *pvHashes) {
+            txiter it = mapTx.find(hash);
+            if (it == mapTx.end() || !setReplaced.count(it)) {
+                strReason = pszReason;
+                return true;
+            }
+        }
+        return false;
+    };
+    auto fnFind = [](const auto& index, const auto& key) -> const std::vector<uint256>* {
+        auto it = index.find(key);
+        return it != index.end() ? &it->second : nullptr;
+    };
+
+    for (const auto& key : record.vGlobalFreezes) {
+        if (fnConflicts(fnFind(mapGlobalFreezingAssetTransactions, key), "bad-txns-global-freeze-already-in-mempool"))
+            return true;
+    }
+    for (const auto& key : record.vGlobalUnfreezes) {
+        if (fnConflicts(fnFind(mapGlobalUnFreezingAssetTransactions, key), "bad-txns-global-unfreeze-already-in-mempool"))
+            return true;
+    }
+    for (const auto& key : record.vAddedTags) {
+        if (fnConflicts(fnFind(mapAddressAddedTag, key), "bad-txns-adding-tag-already-in-mempool"))
+            return true;
+    }
+    for (const auto& key : record.vRemovedTags) {
+        if (fnConflicts(fnFind(mapAddressRemoveTag, key), "bad-txns-remove-tag-already-in-mempool"))
+            return true;
+    }
+    return false;
+}
+/** RVN END */
+
 void CTxMemPool::addSpentIndex(const CTxMemPoolEntry &entry, const CCoinsViewCache &view)
 {
     LOCK(cs);
@@ -618,8 +809,13 @@ bool CTxMemPool::removeSpentIndex(const uint256 txhash)
 
 void CTxMemPool::removeUnchecked(txiter it, MemPoolRemovalReason reason)
 {
+    // Cached ancestor sets may hold it
+    ClearAncestorCache();
     NotifyEntryRemoved(it->GetSharedTx(), reason);
     const uint256 hash = it->GetTx().GetHash();
+    // Outlives the entry, for the asset indexes below
+    const std::shared_ptr<const CMempoolAssetRecord> assetRecord = it->GetSharedAssetRecord();
+    AddEvent(CMempoolEvent::REMOVED, reason, hash, assetRecord);
     for (const CTxIn& txin : it->GetTx().vin)
         mapNextTx.erase(txin.prevout);
 
@@ -638,6 +834,7 @@ void CTxMemPool::removeUnchecked(txiter it, MemPoolRemovalReason reason)
     mapLinks.erase(it);
     mapTx.erase(it);
     nTransactionsUpdated++;
+    nPackagesChanged++;
     if (minerPolicyEstimator) {minerPolicyEstimator->removeTx(hash, false);}
     removeAddressIndex(hash);
     removeSpentIndex(hash);
@@ -651,78 +848,9 @@ void CTxMemPool::removeUnchecked(txiter it, MemPoolRemovalReason reason)
         }
     }
 
-    // Erase from the asset mempool maps if they match txid
-    if (mapHashToAsset.count(hash)) {
-        mapAssetToHash.erase(mapHashToAsset.at(hash));
-        mapHashToAsset.erase(hash);
-    }
-
-    // Erase from the restricted asset mempool maps if they match txids
-    if (mapHashToAddressMarkedFrozen.count(hash)) {
-        for (auto item : mapHashToAddressMarkedFrozen.at(hash))
-            mapAddressesMarkedFrozen.at(item).erase(hash);
-        mapHashToAddressMarkedFrozen.erase(hash);
-    }
-
-    if (mapHashMarkedGlobalFrozen.count(hash)) {
-        for (auto item : mapHashMarkedGlobalFrozen.at(hash))
-            mapAssetMarkedGlobalFrozen.at(item).erase(hash);
-        mapHashMarkedGlobalFrozen.erase(hash);
-    }
-
-    if (mapHashQualifiersChanged.count(hash)) {
-        for (auto item : mapHashQualifiersChanged.at(hash))
-            mapAddressesQualifiersChanged.at(item).erase(hash);
-        mapHashQualifiersChanged.erase(hash);
-    }
-
-    if (mapHashVerifierChanged.count(hash)) {
-        for (auto item : mapHashVerifierChanged.at(hash))
-            mapAssetVerifierChanged.at(item).erase(hash);
-        mapHashVerifierChanged.erase(hash);
-    }
-
-    if (mapHashGlobalFreezingAssetTransactions.count(hash)) {
-        for (auto item : mapHashGlobalFreezingAssetTransactions.at(hash)) {
-            if (mapGlobalFreezingAssetTransactions.count(item)) {
-                mapGlobalFreezingAssetTransactions.at(item).erase(hash);
-                if (mapGlobalFreezingAssetTransactions.at(item).size() == 0)
-                    mapGlobalFreezingAssetTransactions.erase(item);
-            }
-        }
-        mapHashGlobalFreezingAssetTransactions.erase(hash);
-    }
-
-    if (mapHashGlobalUnFreezingAssetTransactions.count(hash)) {
-        for (auto item : mapHashGlobalUnFreezingAssetTransactions.at(hash)) {
-            if (mapGlobalUnFreezingAssetTransactions.count(item)) {
-                mapGlobalUnFreezingAssetTransactions.at(item).erase(hash);
-                if (mapGlobalUnFreezingAssetTransactions.at(item).size() == 0)
-                    mapGlobalUnFreezingAssetTransactions.erase(item);
-            }
-        }
-        mapHashGlobalUnFreezingAssetTransactions.erase(hash);
-    }
-
-    if (mapHashToAddressAddedTag.count(hash)) {
-        for (auto item : mapHashToAddressAddedTag.at(hash)) {
-            if (mapAddressAddedTag.count(item)) {
-                mapAddressAddedTag.at(item).erase(hash);
-                if (mapAddressAddedTag.at(item).size() == 0)
-                    mapAddressAddedTag.erase(item);
-            }
-        }
-    }
-
-    if (mapHashToAddressRemoveTag.count(hash)) {
-        for (auto item : mapHashToAddressRemoveTag.at(hash)) {
-            if (mapAddressRemoveTag.count(item)) {
-                mapAddressRemoveTag.at(item).erase(hash);
-                if (mapAddressRemoveTag.at(item).size() == 0)
-                    mapAddressRemoveTag.erase(item);
-            }
-        }
-    }
+    // Erase from the asset indexes the keys of the transaction's record
+    if (assetRecord)
+        removeAssetIndex(hash, *assetRecord);
     /** RVN END */
 }
 
@@ -873,19 +1001,21 @@ void CTxMemPool::removeForBlock(const std::vector<CTransactionRef>& vtx, unsigne
     // Get the newly added assets, and make sure they are in the entries
     std::vector<CTransaction> trans;
     for (auto it : connectedBlockData.newAssetsToAdd) {
-        if (mapAssetToHash.count(it.asset.strName)) {
-            indexed_transaction_set::iterator i = mapTx.find(mapAssetToHash.at(it.asset.strName));
+        auto itAsset = mapAssetToHash.find(it.asset.strName);
+        if (itAsset != mapAssetToHash.end()) {
+            indexed_transaction_set::iterator i = mapTx.find(itAsset->second);
             if (i != mapTx.end()) {
                 entries.push_back(&*i);
                 trans.emplace_back(i->GetTx());
-                setAlreadyRemoving.insert(mapAssetToHash.at(it.asset.strName));
+                setAlreadyRemoving.insert(itAsset->second);
             }
         }
     }
 
     for (auto it : connectedBlockData.newVerifiersToAdd) {
-        if (mapAssetVerifierChanged.count(it.assetName)) {
-            for (auto hash : mapAssetVerifierChanged.at(it.assetName)) {
+        auto itIndex = mapAssetVerifierChanged.find(it.assetName);
+        if (itIndex != mapAssetVerifierChanged.end()) {
+            for (auto hash : itIndex->second) {
                 indexed_transaction_set::iterator i = mapTx.find(hash);
                 if (i != mapTx.end()) {
                     CValidationState state;
@@ -900,8 +1030,9 @@ void CTxMemPool::removeForBlock(const std::vector<CTransactionRef>& vtx, unsigne
     }
 
     for (auto it : connectedBlockData.newQualifiersToAdd) {
-        if (mapAddressesQualifiersChanged.count(it.address)) {
-            for (auto hash : mapAddressesQualifiersChanged.at(it.address)) {
+        auto itIndex = mapAddressesQualifiersChanged.find(it.address);
+        if (itIndex != mapAddressesQualifiersChanged.end()) {
+            for (auto hash : itIndex->second) {
                 indexed_transaction_set::iterator i = mapTx.find(hash);
                 if (i != mapTx.end()) {
                     CValidationState state;
@@ -917,8 +1048,9 @@ void CTxMemPool::removeForBlock(const std::vector<CTransactionRef>& vtx, unsigne
 
     for (auto it : connectedBlockData.newGlobalRestrictionsToAdd) {
         if (it.type == RestrictedType::GLOBAL_FREEZE) {
-            if (mapAssetMarkedGlobalFrozen.count(it.assetName)) {
-                for (auto hash : mapAssetMarkedGlobalFrozen.at(it.assetName)) {
+            auto itFrozen = mapAssetMarkedGlobalFrozen.find(it.assetName);
+            if (itFrozen != mapAssetMarkedGlobalFrozen.end()) {
+                for (auto hash : itFrozen->second) {
                     indexed_transaction_set::iterator i = mapTx.find(hash);
                     if (i != mapTx.end()) {
                         CValidationState state;
@@ -931,8 +1063,9 @@ void CTxMemPool::removeForBlock(const std::vector<CTransactionRef>& vtx, unsigne
                 }
             }
 
-            if (mapGlobalFreezingAssetTransactions.count(it.assetName)) {
-                for (auto hash : mapGlobalFreezingAssetTransactions.at(it.assetName)) {
+            auto itFreezing = mapGlobalFreezingAssetTransactions.find(it.assetName);
+            if (itFreezing != mapGlobalFreezingAssetTransactions.end()) {
+                for (auto hash : itFreezing->second) {
                     indexed_transaction_set::iterator i = mapTx.find(hash);
                     if (i != mapTx.end()) {
                         CValidationState state;
@@ -945,8 +1078,9 @@ void CTxMemPool::removeForBlock(const std::vector<CTransactionRef>& vtx, unsigne
                 }
             }
         } else if (it.type == RestrictedType::GLOBAL_UNFREEZE) {
-            if (mapGlobalUnFreezingAssetTransactions.count(it.assetName)) {
-                for (auto hash : mapGlobalUnFreezingAssetTransactions.at(it.assetName)) {
+            auto itIndex = mapGlobalUnFreezingAssetTransactions.find(it.assetName);
+            if (itIndex != mapGlobalUnFreezingAssetTransactions.end()) {
+                for (auto hash : itIndex->second) {
                     indexed_transaction_set::iterator i = mapTx.find(hash);
                     if (i != mapTx.end()) {
                         CValidationState state;
@@ -964,8 +1098,9 @@ void CTxMemPool::removeForBlock(const std::vector<CTransactionRef>& vtx, unsigne
     for (auto it : connectedBlockData.newAddressRestrictionsToAdd) {
         if (it.type == RestrictedType::FREEZE_ADDRESS) {
             auto pair = std::make_pair(it.address, it.assetName);
-            if (mapAddressesMarkedFrozen.count(pair)) {
-                for (auto hash : mapAddressesMarkedFrozen.at(pair)) {
+            auto itIndex = mapAddressesMarkedFrozen.find(pair);
+            if (itIndex != mapAddressesMarkedFrozen.end()) {
+                for (auto hash : itIndex->second) {
                     indexed_transaction_set::iterator i = mapTx.find(hash);
                     if (i != mapTx.end()) {
                         CValidationState state;
@@ -1017,6 +1152,7 @@ void CTxMemPool::removeForBlock(const std::vector<CTransactionRef>& vtx, unsigne
 
 void CTxMemPool::_clear()
 {
+    ClearAncestorCache();
     mapLinks.clear();
     mapTx.clear();
     mapNextTx.clear();
@@ -1026,28 +1162,16 @@ void CTxMemPool::_clear()
     blockSinceLastRollingFeeBump = false;
     rollingMinimumFeeRate = 0;
     ++nTransactionsUpdated;
+    ++nPackagesChanged;
     mapAssetToHash.clear();
-    mapHashToAsset.clear();
-
-    mapAddressesMarkedFrozen.clear();
-    mapHashToAddressMarkedFrozen.clear();
-    mapAssetMarkedGlobalFrozen.clear();
-    mapHashMarkedGlobalFrozen.clear();
     mapAddressesQualifiersChanged.clear();
-    mapHashQualifiersChanged.clear();
     mapAssetVerifierChanged.clear();
-    mapHashVerifierChanged.clear();
-
-    mapHashToAddressAddedTag.clear();
-    mapAddressAddedTag.clear();
-    mapHashToAddressRemoveTag.clear();
-    mapAddressRemoveTag.clear();
-
+    mapAssetMarkedGlobalFrozen.clear();
+    mapAddressesMarkedFrozen.clear();
     mapGlobalFreezingAssetTransactions.clear();
-    mapHashGlobalFreezingAssetTransactions.clear();
-
     mapGlobalUnFreezingAssetTransactions.clear();
-    mapHashGlobalUnFreezingAssetTransactions.clear();
+    mapAddressAddedTag.clear();
+    mapAddressRemoveTag.clear();
 }
 
 void CTxMemPool::clear()
@@ -1269,6 +1393,78 @@ std::vector<TxMempoolInfo> CTxMemPool::infoAll() const
     return ret;
 }
 
+std::vector<TxMempoolInfo> CTxMemPool::infoByDepthAndScore(const std::vector<uint256>& vHashes) const
+{
+    LOCK(cs);
+    std::vector<indexed_transaction_set::const_iterator> iters;
+    iters.reserve(vHashes.size());
+    for (const uint256& hash : vHashes) {
+        indexed_transaction_set::const_iterator i = mapTx.find(hash);
+        if (i != mapTx.end())
+            iters.push_back(i);
+    }
+    std::sort(iters.begin(), iters.end(), DepthAndScoreComparator());
+
+    std::vector<TxMempoolInfo> ret;
+    ret.reserve(iters.size());
+    for (auto it : iters) {
+        ret.push_back(GetInfo(it));
+    }
+
+    return ret;
+}
+
+std::string RemovalReasonToString(MemPoolRemovalReason reason)
+{
+    switch (reason) {
+        case MemPoolRemovalReason::EXPIRY: return "expiry";
+        case MemPoolRemovalReason::SIZELIMIT: return "sizelimit";
+        case MemPoolRemovalReason::REORG: return "reorg";
+        case MemPoolRemovalReason::BLOCK: return "block";
+        case MemPoolRemovalReason::CONFLICT: return "conflict";
+        case MemPoolRemovalReason::REPLACED: return "replaced";
+        case MemPoolRemovalReason::UNKNOWN: break;
+    }
+    return "unknown";
+}
+
+void CTxMemPool::AddEvent(CMempoolEvent::Type type, MemPoolRemovalReason reason, const uint256& txid, std::shared_ptr<const CMempoolAssetRecord> assetRecord)
+{
+    AssertLockHeld(cs);
+    CMempoolEvent event;
+    event.nSequence = ++nEventSequence;
+    event.nType = type;
+    event.nReason = (uint8_t)reason;
+    event.txid = txid;
+    event.assetRecord = std::move(assetRecord);
+    vEvents.push_back(event);
+    if (vEvents.size() > MEMPOOL_EVENT_LOG_SIZE)
+        vEvents.pop_front();
+    // Signalled under cs, so subscribers see the events in sequence
+    GetMainSignals().MempoolUpdated(event);
+}
+
+uint64_t CTxMemPool::GetEventSequence() const
+{
+    LOCK(cs);
+    return nEventSequence;
+}
+
+bool CTxMemPool::GetEventsSince(uint64_t nSequence, size_t nMax, std::vector<CMempoolEvent>& vEventsOut) const
+{
+    LOCK(cs);
+    vEventsOut.clear();
+    if (nSequence >= nEventSequence)
+        return true;
+    // The log holds the events after nEventSequence - vEvents.size()
+    if (nSequence < nEventSequence - vEvents.size())
+        return false;
+    size_t nStart = vEvents.size() - (nEventSequence - nSequence);
+    size_t nEnd = std::min(vEvents.size(), nStart + nMax);
+    vEventsOut.assign(vEvents.begin() + nStart, vEvents.begin() + nEnd);
+    return true;
+}
+
 CTransactionRef CTxMemPool::get(const uint256& hash) const
 {
     LOCK(cs);
@@ -1312,6 +1508,7 @@ void CTxMemPool::PrioritiseTransaction(const uint256& hash, const CAmount& nFeeD
                 mapTx.modify(descendantIt, update_ancestor_state(0, nFeeDelta, 0, 0));
             }
             ++nTransactionsUpdated;
+            ++nPackagesChanged;
         }
     }
     LogPrintf("PrioritiseTransaction: %s feerate += %s\n", hash.ToString(), FormatMoney(nFeeDelta));
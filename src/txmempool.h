@@ -7,9 +7,11 @@
 #ifndef MYNTA_TXMEMPOOL_H
 #define MYNTA_TXMEMPOOL_H
 
+#include <deque>
 #include <memory>
 #include <set>
 #include <map>
+#include <unordered_map>
 #include <vector>
 #include <utility>
 #include <string>
@@ -17,6 +19,7 @@
 #include "addressindex.h"
 #include "spentindex.h"
 #include "amount.h"
+#include "assets/assettypes.h"
 #include "coins.h"
 #include "indirectmap.h"
 #include "policy/feerate.h"
@@ -36,6 +39,9 @@ struct ConnectedBlockAssetData;
 /** Fake height value used in Coin to signify they are only in the memory pool (since 0.8) */
 static const uint32_t MEMPOOL_HEIGHT = 0x7FFFFFFF;
 
+/** Most mempool iterators the cache of recent ancestor sets holds */
+static const size_t ANCESTOR_CACHE_MAX_ENTRIES = 1 << 16;
+
 struct LockPoints
 {
     // Will be set to the blockchain height and median time past
@@ -53,6 +59,54 @@ struct LockPoints
 
 class CTxMemPool;
 
+/**
+ * The asset names and addresses a mempool transaction touches, which are the
+ * keys CTxMemPool indexes it under so that the transactions a connected block
+ * invalidates can be found, and that BlockAssembler keeps clashing asset
+ * changes out of the same block by. Transactions without asset outputs,
+ * restricted asset inputs or asset null data have no record.
+ */
+struct CMempoolAssetRecord
+{
+    std::string strNewAsset;                                           //!< asset the tx issues, if any
+    std::vector<std::string> vQualifierAddresses;                      //!< addresses receiving restricted assets
+    std::vector<std::string> vVerifierAssets;                          //!< restricted assets the tx sends
+    std::vector<std::string> vGlobalFrozenAssets;                      //!< restricted assets the tx spends
+    std::vector<std::pair<std::string, std::string>> vFrozenAddresses; //!< (address, restricted asset) the tx spends
+    std::vector<std::string> vGlobalFreezes;                           //!< restricted assets the tx freezes
+    std::vector<std::string> vGlobalUnfreezes;                         //!< restricted assets the tx unfreezes
+    std::vector<std::pair<std::string, std::string>> vAddedTags;       //!< (address, qualifier) the tx tags
+    std::vector<std::pair<std::string, std::string>> vRemovedTags;     //!< (address, qualifier) the tx untags
+    std::vector<std::string> vVerifierChanges;                         //!< restricted assets the tx sets the verifier of
+    std::vector<std::pair<std::string, std::string>> vAddressFreezes;  //!< (address, restricted asset) the tx freezes or unfreezes
+
+    bool IsNull() const
+    {
+        return strNewAsset.empty() && vQualifierAddresses.empty() && vVerifierAssets.empty() &&
+               vGlobalFrozenAssets.empty() && vFrozenAddresses.empty() && vGlobalFreezes.empty() &&
+               vGlobalUnfreezes.empty() && vAddedTags.empty() && vRemovedTags.empty() &&
+               vVerifierChanges.empty() && vAddressFreezes.empty();
+    }
+
+    ADD_SERIALIZE_METHODS;
+
+    template <typename Stream, typename Operation>
+    inline void SerializationOp(Stream& s, Operation ser_action)
+    {
+        READWRITE(strNewAsset);
+        READWRITE(vQualifierAddresses);
+        READWRITE(vVerifierAssets);
+        READWRITE(vGlobalFrozenAssets);
+        READWRITE(vFrozenAddresses);
+        READWRITE(vGlobalFreezes);
+        READWRITE(vGlobalUnfreezes);
+        READWRITE(vAddedTags);
+        READWRITE(vRemovedTags);
+        READWRITE(vVerifierChanges);
+        READWRITE(vAddressFreezes);
+    }
+};
+
 /** \class CTxMemPoolEntry
  *
  * CTxMemPoolEntry stores data about the corresponding transaction, as well
@@ -78,6 +132,7 @@ private:
     int64_t sigOpCost;         //!< Total sigop cost
     int64_t feeDelta;          //!< Used for determining the priority of the transaction for mining in a block
     LockPoints lockPoints;     //!< Track the height and time at which tx was final
+    std::shared_ptr<const CMempoolAssetRecord> assetRecord; //!< Asset keys the mempool indexes the tx under, if any
 
     // Information about descendants of this transaction that are in the
     // mempool; if we remove this transaction we must remove all of these
@@ -109,6 +164,11 @@ public:
     int64_t GetModifiedFee() const { return nFee + feeDelta; }
     size_t DynamicMemoryUsage() const { return nUsageSize; }
     const LockPoints& GetLockPoints() const { return lockPoints; }
+    const CMempoolAssetRecord* GetAssetRecord() const { return assetRecord.get(); }
+    std::shared_ptr<const CMempoolAssetRecord> GetSharedAssetRecord() const { return assetRecord; }
+
+    // Set before the entry is added to the mempool, which indexes it by the record
+    void SetAssetRecord(std::shared_ptr<const CMempoolAssetRecord> record) { assetRecord = std::move(record); }
 
     // Adjusts the descendant state.
     void UpdateDescendantState(int64_t modifySize, CAmount modifyFee, int64_t modifyCount);
@@ -327,6 +387,50 @@ enum class MemPoolRemovalReason {
     REPLACED,    //!< Removed for replacement
 };
 
+std::string RemovalReasonToString(MemPoolRemovalReason reason);
+
+//! Events CTxMemPool keeps for GetEventsSince
+static const size_t MEMPOOL_EVENT_LOG_SIZE = 100000;
+
+/**
+ * A transaction entering or leaving the mempool, numbered in the order they
+ * happened, with the asset keys it took or gave up in the mempool's asset
+ * indexes. Applying them in sequence to a copy of the mempool keeps it exact;
+ * getrawmempool reports the sequence its transaction list was taken at.
+ */
+class CMempoolEvent
+{
+public:
+    enum Type : uint8_t {
+        ADDED = 0,
+        REMOVED = 1,
+    };
+
+    uint64_t nSequence{0};
+    uint8_t nType{ADDED};
+    uint8_t nReason{0}; //!< MemPoolRemovalReason, for REMOVED
+    uint256 txid;
+    std::shared_ptr<const CMempoolAssetRecord> assetRecord; //!< null if it touches no assets
+
+    template <typename Stream>
+    void Serialize(Stream& s) const
+    {
+        s << nSequence << nType << nReason << txid;
+        s << (assetRecord ? *assetRecord : CMempoolAssetRecord());
+    }
+
+    template <typename Stream>
+    void Unserialize(Stream& s)
+    {
+        CMempoolAssetRecord record;
+        s >> nSequence >> nType >> nReason >> txid >> record;
+        if (record.IsNull())
+            assetRecord.reset();
+        else
+            assetRecord = std::make_shared<const CMempoolAssetRecord>(std::move(record));
+    }
+};
+
 class SaltedTxidHasher
 {
 private:
@@ -418,6 +522,7 @@ class CTxMemPool
 private:
     uint32_t nCheckFrequency; //!< Value n means that n times in 2^32 we check.
     unsigned int nTransactionsUpdated; //!< Used by getblocktemplate to trigger CreateNewBlock() invocation
+    unsigned int nPackagesChanged; //!< Bumped when entries leave or change their fee or ancestors, which a block template can't be patched for
     CBlockPolicyEstimator* minerPolicyEstimator;
 
     uint64_t totalTxSize;      //!< sum of all mempool tx's virtual sizes. Differs from serialized tx size since witness data is discounted. Defined in BIP 141.
@@ -468,41 +573,6 @@ public:
     mutable CCriticalSection cs;
     indexed_transaction_set mapTx;
 
-    std::map<std::string, uint256> mapAssetToHash;
-    std::map<uint256, std::string> mapHashToAsset;
-
-    /** Restricted assets maps */
-    // Helper maps for when addresses are marked as frozen
-    std::map<std::pair<std::string, std::string>, std::set<uint256> > mapAddressesMarkedFrozen;
-    std::map<uint256, std::set<std::pair<std::string, std::string>>> mapHashToAddressMarkedFrozen;
-
-    // Helper maps for when restricted assets are globally frozen
-    std::map<std::string, std::set<uint256>> mapAssetMarkedGlobalFrozen;
-    std::map<uint256, std::set<std::string>> mapHashMarkedGlobalFrozen;
-
-    // Helper maps for when qualifiers are added or removed from addresses
-    std::map<std::string, std::set<uint256>> mapAddressesQualifiersChanged;
-    std::map<uint256, std::set<std::string>> mapHashQualifiersChanged;
-
-    // Helper maps for when verifier string are changed
-    std::map<std::string, std::set<uint256>> mapAssetVerifierChanged;
-    std::map<uint256, std::set<std::string>> mapHashVerifierChanged;
-
-    // Helper map for when an asset already in mempool that is globally freezing
-    std::map<std::string, std::set<uint256>> mapGlobalFreezingAssetTransactions;
-    std::map<uint256, std::set<std::string>> mapHashGlobalFreezingAssetTransactions;
-
-    // Helper map for when a qualfier is added to an address
-    std::map<std::pair<std::string, std::string>, std::set<uint256> > mapAddressAddedTag;
-    std::map<uint256, std::set<std::pair<std::string, std::string>>> mapHashToAddressAddedTag;
-
-    // Helper map for when a qualfier is added to an address
-    std::map<std::pair<std::string, std::string>, std::set<uint256> > mapAddressRemoveTag;
-    std::map<uint256, std::set<std::pair<std::string, std::string>>> mapHashToAddressRemoveTag;
-
-    std::map<std::string, std::set<uint256>> mapGlobalUnFreezingAssetTransactions;
-    std::map<uint256, std::set<std::string>> mapHashGlobalUnFreezingAssetTransactions;
-
     typedef indexed_transaction_set::nth_index<0>::type::iterator txiter;
     std::vector<std::pair<uint256, txiter> > vTxHashes; //!< All tx witness hashes/entries in mapTx, in random order
 
@@ -526,6 +596,12 @@ private:
     typedef std::map<txiter, TxLinks, CompareIteratorByHash> txlinksMap;
     txlinksMap mapLinks;
 
+    //! Ancestor sets of entries as addUnchecked found them, for their children
+    //! to reuse. Cleared whenever an entry is removed or gains ancestors.
+    cacheMap mapAncestorCache;
+    //! Iterators held by mapAncestorCache, entries included
+    size_t nAncestorCacheEntries;
+
     typedef std::map<CMempoolAddressDeltaKey, CMempoolAddressDelta, CMempoolAddressDeltaKeyCompare> addressDeltaMap;
     addressDeltaMap mapAddress;
 
@@ -538,9 +614,38 @@ private:
     typedef std::map<uint256, std::vector<CSpentIndexKey> > mapSpentIndexInserted;
     mapSpentIndexInserted mapSpentInserted;
 
+    /** RVN START */
+    // Transactions by the keys of their asset records. Each key usually has a
+    // single transaction; the records say which keys to drop on removal.
+    typedef std::unordered_map<std::string, std::vector<uint256>, CAssetCacheHasher> assetTxIndex;
+    typedef std::unordered_map<std::pair<std::string, std::string>, std::vector<uint256>, CAssetCacheHasher> assetPairTxIndex;
+
+    std::unordered_map<std::string, uint256, CAssetCacheHasher> mapAssetToHash;
+    assetTxIndex mapAddressesQualifiersChanged;
+    assetTxIndex mapAssetVerifierChanged;
+    assetTxIndex mapAssetMarkedGlobalFrozen;
+    assetPairTxIndex mapAddressesMarkedFrozen;
+    assetTxIndex mapGlobalFreezingAssetTransactions;
+    assetTxIndex mapGlobalUnFreezingAssetTransactions;
+    assetPairTxIndex mapAddressAddedTag;
+    assetPairTxIndex mapAddressRemoveTag;
+
+    void addAssetIndex(const uint256& hash, const CMempoolAssetRecord& record);
+    void removeAssetIndex(const uint256& hash, const CMempoolAssetRecord& record);
+    /** RVN END */
+
+    //! Sequence of the last event, and the last MEMPOOL_EVENT_LOG_SIZE events, oldest first
+    uint64_t nEventSequence;
+    std::deque<CMempoolEvent> vEvents;
+
+    void AddEvent(CMempoolEvent::Type type, MemPoolRemovalReason reason, const uint256& txid, std::shared_ptr<const CMempoolAssetRecord> assetRecord);
+
     void UpdateParent(txiter entry, txiter parent, bool add);
     void UpdateChild(txiter entry, txiter child, bool add);
 
+    void CacheAncestors(txiter it, const setEntries &setAncestors);
+    void ClearAncestorCache();
+
     std::vector<indexed_transaction_set::const_iterator> GetSortedDepthAndScore() const;
 
 public:
@@ -574,6 +679,17 @@ public:
                          std::vector<std::pair<CMempoolAddressDeltaKey, CMempoolAddressDelta> > &results);
     bool removeAddressIndex(const uint256 txhash);
 
+    /** Whether a mempool transaction issues the asset strName */
+    bool HasAssetIssue(const std::string& strName) const;
+    /** Whether a mempool transaction globally freezes (or, if !fFreeze, unfreezes) strName */
+    bool HasGlobalRestrictionChange(const std::string& strName, bool fFreeze) const;
+    /**
+     * Whether a mempool transaction other than those in setReplaced already
+     * makes one of the global restriction or tag changes of record, setting
+     * strReason if so.
+     */
+    bool HasAssetRecordConflict(const CMempoolAssetRecord& record, const setEntries& setReplaced, std::string& strReason) const;
+
     void addSpentIndex(const CTxMemPoolEntry &entry, const CCoinsViewCache &view);
     bool getSpentIndex(CSpentIndexKey &key, CSpentIndexValue &value);
     bool removeSpentIndex(const uint256 txhash);
@@ -591,6 +707,8 @@ public:
     bool isSpent(const COutPoint& outpoint);
     unsigned int GetTransactionsUpdated() const;
     void AddTransactionsUpdated(unsigned int n);
+    /** Unchanged as long as entries are only added, see BlockAssembler::UpdateBlock */
+    unsigned int GetPackagesChanged() const;
     /**
      * Check that none of this transactions inputs are in the mempool, and thus
      * the tx is not dependent on other mempool transactions to be included in a block.
@@ -681,6 +799,17 @@ public:
     CTransactionRef get(const uint256& hash) const;
     TxMempoolInfo info(const uint256& hash) const;
     std::vector<TxMempoolInfo> infoAll() const;
+    //! Those of vHashes still in the pool, in CompareDepthAndScore order, under a single lock
+    std::vector<TxMempoolInfo> infoByDepthAndScore(const std::vector<uint256>& vHashes) const;
+
+    //! Sequence of the last event, 0 before any
+    uint64_t GetEventSequence() const;
+    /**
+     * Up to nMax events after nSequence, oldest first. False if some of them
+     * were already dropped from the log, in which case the caller has to start
+     * over from getrawmempool.
+     */
+    bool GetEventsSince(uint64_t nSequence, size_t nMax, std::vector<CMempoolEvent>& vEventsOut) const;
 
     size_t DynamicMemoryUsage() const;
 
@@ -840,11 +969,11 @@ struct DisconnectedBlockTransactions {
 
 struct ConnectedBlockAssetData
 {
-    std::set<CAssetCacheNewAsset> newAssetsToAdd;
-    std::set<CAssetCacheRestrictedVerifiers> newVerifiersToAdd;
-    std::set<CAssetCacheRestrictedAddress> newAddressRestrictionsToAdd;
-    std::set<CAssetCacheRestrictedGlobal> newGlobalRestrictionsToAdd;
-    std::set<CAssetCacheQualifierAddress> newQualifiersToAdd;
+    CAssetCacheSet<CAssetCacheNewAsset> newAssetsToAdd;
+    CAssetCacheSet<CAssetCacheRestrictedVerifiers> newVerifiersToAdd;
+    CAssetCacheSet<CAssetCacheRestrictedAddress> newAddressRestrictionsToAdd;
+    CAssetCacheSet<CAssetCacheRestrictedGlobal> newGlobalRestrictionsToAdd;
+    CAssetCacheSet<CAssetCacheQualifierAddress> newQualifiersToAdd;
 };
 
 #endif // MYNTA_TXMEMPOOL_H
@@ -0,0 +1,236 @@
+// Copyright (c) 2026 The Mynta Core Developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include "txoutsnapshot.h"
+
+#include "assets/assetdb.h"
+#include "assets/restricteddb.h"
+#include "chain.h"
+#include "coins.h"
+#include "dbwrapper.h"
+#include "evo/evodb.h"
+#include "streams.h"
+#include "txdb.h"
+#include "util.h"
+#include "validation.h"
+
+#include <memory>
+
+#include <boost/thread.hpp>
+
+static const unsigned char TXOUT_SNAPSHOT_MAGIC[4] = {'m', 'u', 't', 'x'};
+
+//! Each record in a section starts with this; a zero byte ends the section
+static const uint8_t SNAPSHOT_RECORD = 1;
+static const uint8_t SNAPSHOT_SECTION_END = 0;
+
+CTxOutSnapshotWriter::CTxOutSnapshotWriter(CAutoFile& fileIn, const CTxOutSnapshotMetadata& metadata)
+    : file(fileIn), hasher(SER_GETHASH, 0)
+{
+    stats.metadata = metadata;
+    write(reinterpret_cast<const char*>(TXOUT_SNAPSHOT_MAGIC), sizeof(TXOUT_SNAPSHOT_MAGIC));
+    *this << TXOUT_SNAPSHOT_VERSION << metadata;
+}
+
+int CTxOutSnapshotWriter::GetType() const { return file.GetType(); }
+int CTxOutSnapshotWriter::GetVersion() const { return file.GetVersion(); }
+
+void CTxOutSnapshotWriter::write(const char* pch, size_t nSize)
+{
+    file.write(pch, nSize);
+    hasher.write(pch, nSize);
+}
+
+void CTxOutSnapshotWriter::BeginSection(TxOutSnapshotSection sectionIn)
+{
+    assert(section == TxOutSnapshotSection::END && sectionIn != TxOutSnapshotSection::END);
+    section = sectionIn;
+    *this << static_cast<uint8_t>(section);
+    if (section != TxOutSnapshotSection::COINS)
+        stats.mapEntries[section] = 0;
+}
+
+void CTxOutSnapshotWriter::AddCoin(const COutPoint& outpoint, const Coin& coin)
+{
+    assert(section == TxOutSnapshotSection::COINS);
+    *this << SNAPSHOT_RECORD << outpoint << coin;
+    stats.nCoins++;
+}
+
+void CTxOutSnapshotWriter::AddEntry(const std::vector<unsigned char>& vKey, const std::vector<unsigned char>& vValue)
+{
+    assert(section != TxOutSnapshotSection::COINS && section != TxOutSnapshotSection::END);
+    *this << SNAPSHOT_RECORD << vKey << vValue;
+    stats.mapEntries[section]++;
+}
+
+void CTxOutSnapshotWriter::EndSection()
+{
+    assert(section != TxOutSnapshotSection::END);
+    *this << SNAPSHOT_SECTION_END;
+    section = TxOutSnapshotSection::END;
+}
+
+const CTxOutSnapshotStats& CTxOutSnapshotWriter::Finish()
+{
+    assert(section == TxOutSnapshotSection::END);
+    *this << static_cast<uint8_t>(TxOutSnapshotSection::END);
+    stats.hashSnapshot = hasher.GetHash();
+    file << stats.hashSnapshot;
+    return stats;
+}
+
+bool ReadTxOutSnapshot(CAutoFile& file, const TxOutSnapshotCoinFn& fnCoin, const TxOutSnapshotEntryFn& fnEntry,
+                       CTxOutSnapshotStats& stats, std::string& strError)
+{
+    stats = CTxOutSnapshotStats();
+    try {
+        CHashVerifier<CAutoFile> verifier(&file);
+        unsigned char magic[sizeof(TXOUT_SNAPSHOT_MAGIC)];
+        verifier.read(reinterpret_cast<char*>(magic), sizeof(magic));
+        if (memcmp(magic, TXOUT_SNAPSHOT_MAGIC, sizeof(magic)) != 0) {
+            strError = "not a txout snapshot";
+            return false;
+        }
+        uint32_t nVersion;
+        verifier >> nVersion;
+        if (nVersion != TXOUT_SNAPSHOT_VERSION) {
+            strError = strprintf("unsupported snapshot version %u", nVersion);
+            return false;
+        }
+        verifier >> stats.metadata;
+
+        // Sections come in increasing order, each at most once, starting with the coins
+        int nLastSection = -1;
+        while (true) {
+            uint8_t nSection;
+            verifier >> nSection;
+            if (nSection == static_cast<uint8_t>(TxOutSnapshotSection::END))
+                break;
+            if (nSection > static_cast<uint8_t>(TxOutSnapshotSection::EVO) || nSection <= nLastSection) {
+                strError = strprintf("unexpected section %u", nSection);
+                return false;
+            }
+            if (nLastSection == -1 && nSection != static_cast<uint8_t>(TxOutSnapshotSection::COINS)) {
+                strError = "snapshot has no coins section";
+                return false;
+            }
+            nLastSection = nSection;
+            const TxOutSnapshotSection section = static_cast<TxOutSnapshotSection>(nSection);
+            if (section != TxOutSnapshotSection::COINS)
+                stats.mapEntries[section] = 0;
+
+            while (true) {
+                boost::this_thread::interruption_point();
+                uint8_t nRecord;
+                verifier >> nRecord;
+                if (nRecord == SNAPSHOT_SECTION_END)
+                    break;
+                if (nRecord != SNAPSHOT_RECORD) {
+                    strError = strprintf("unexpected record type %u", nRecord);
+                    return false;
+                }
+                if (section == TxOutSnapshotSection::COINS) {
+                    COutPoint outpoint;
+                    Coin coin;
+                    verifier >> outpoint >> coin;
+                    if (!fnCoin(outpoint, coin)) {
+                        strError = strprintf("coin %s was refused", outpoint.ToString());
+                        return false;
+                    }
+                    stats.nCoins++;
+                } else {
+                    std::vector<unsigned char> vKey, vValue;
+                    verifier >> vKey >> vValue;
+                    if (!fnEntry(section, vKey, vValue)) {
+                        strError = "database entry was refused";
+                        return false;
+                    }
+                    stats.mapEntries[section]++;
+                }
+            }
+        }
+        if (nLastSection == -1) {
+            strError = "snapshot has no coins section";
+            return false;
+        }
+
+        stats.hashSnapshot = verifier.GetHash();
+        uint256 hashStored;
+        file >> hashStored;
+        if (hashStored != stats.hashSnapshot) {
+            strError = strprintf("snapshot hash mismatch: file says %s, contents hash to %s", hashStored.ToString(), stats.hashSnapshot.ToString());
+            return false;
+        }
+    } catch (const std::exception& e) {
+        strError = strprintf("failed to read snapshot: %s", e.what());
+        return false;
+    }
+    return true;
+}
+
+static void WriteDatabaseSection(CTxOutSnapshotWriter& writer, TxOutSnapshotSection section, CDBIterator* piter)
+{
+    writer.BeginSection(section);
+    for (piter->SeekToFirst(); piter->Valid(); piter->Next()) {
+        boost::this_thread::interruption_point();
+        writer.AddEntry(piter->GetKeyBytes(), piter->GetValueBytes());
+    }
+    writer.EndSection();
+}
+
+bool DumpTxOutSnapshot(CAutoFile& file, CTxOutSnapshotStats& stats, std::string& strError)
+{
+    // Iterators see their database as of when they are created, so taking them
+    // all under cs_main right after a flush gives one consistent state
+    std::unique_ptr<CCoinsViewCursor> pcursor;
+    std::unique_ptr<CDBIterator> pitAssets, pitRestricted, pitEvo;
+    CTxOutSnapshotMetadata metadata;
+    {
+        LOCK(cs_main);
+        FlushStateToDisk();
+        pcursor.reset(pcoinsdbview->Cursor());
+        metadata.hashBaseBlock = pcursor->GetBestBlock();
+        BlockMap::const_iterator it = mapBlockIndex.find(metadata.hashBaseBlock);
+        if (it == mapBlockIndex.end()) {
+            strError = "best block of the coins database is unknown";
+            return false;
+        }
+        metadata.nBaseHeight = it->second->nHeight;
+        if (passetsdb)
+            pitAssets.reset(passetsdb->NewIterator());
+        if (prestricteddb)
+            pitRestricted.reset(prestricteddb->NewIterator());
+        if (evoDb)
+            pitEvo.reset(evoDb->GetRawDB().NewIterator());
+    }
+
+    try {
+        CTxOutSnapshotWriter writer(file, metadata);
+        writer.BeginSection(TxOutSnapshotSection::COINS);
+        for (; pcursor->Valid(); pcursor->Next()) {
+            boost::this_thread::interruption_point();
+            COutPoint outpoint;
+            Coin coin;
+            if (!pcursor->GetKey(outpoint) || !pcursor->GetValue(coin)) {
+                strError = "unable to read the coins database";
+                return false;
+            }
+            writer.AddCoin(outpoint, coin);
+        }
+        writer.EndSection();
+
+        if (pitAssets)
+            WriteDatabaseSection(writer, TxOutSnapshotSection::ASSETS, pitAssets.get());
+        if (pitRestricted)
+            WriteDatabaseSection(writer, TxOutSnapshotSection::RESTRICTED, pitRestricted.get());
+        if (pitEvo)
+            WriteDatabaseSection(writer, TxOutSnapshotSection::EVO, pitEvo.get());
+        stats = writer.Finish();
+    } catch (const std::ios_base::failure& e) {
+        strError = strprintf("failed to write snapshot: %s", e.what());
+        return false;
+    }
+    return true;
+}
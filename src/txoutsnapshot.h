@@ -0,0 +1,115 @@
+// Copyright (c) 2026 The Mynta Core Developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#ifndef MYNTA_TXOUTSNAPSHOT_H
+#define MYNTA_TXOUTSNAPSHOT_H
+
+#include "hash.h"
+#include "serialize.h"
+#include "uint256.h"
+
+#include <functional>
+#include <map>
+#include <string>
+#include <vector>
+
+class CAutoFile;
+class COutPoint;
+class Coin;
+
+static const uint32_t TXOUT_SNAPSHOT_VERSION = 1;
+
+/** Parts of the chain state a snapshot holds, in the order they are written */
+enum class TxOutSnapshotSection : uint8_t
+{
+    COINS = 0,
+    ASSETS = 1,
+    RESTRICTED = 2,
+    EVO = 3,
+    END = 255,
+};
+
+/** The block a snapshot was taken at */
+struct CTxOutSnapshotMetadata
+{
+    uint256 hashBaseBlock;
+    int nBaseHeight{-1};
+
+    ADD_SERIALIZE_METHODS;
+
+    template <typename Stream, typename Operation>
+    inline void SerializationOp(Stream& s, Operation ser_action)
+    {
+        READWRITE(hashBaseBlock);
+        READWRITE(nBaseHeight);
+    }
+};
+
+struct CTxOutSnapshotStats
+{
+    CTxOutSnapshotMetadata metadata;
+    uint64_t nCoins{0};
+    //! database entries in each section after the coins
+    std::map<TxOutSnapshotSection, uint64_t> mapEntries;
+    //! double SHA256 of everything before it in the file, which the file ends with
+    uint256 hashSnapshot;
+};
+
+/**
+ * Writes a snapshot of the chain state: a header with the base block, then
+ * the coins, then the raw entries of each database in order of section, and
+ * finally the hash of all of that. Write errors throw std::ios_base::failure.
+ */
+class CTxOutSnapshotWriter
+{
+private:
+    CAutoFile& file;
+    CHashWriter hasher;
+    CTxOutSnapshotStats stats;
+    TxOutSnapshotSection section{TxOutSnapshotSection::END};
+
+public:
+    CTxOutSnapshotWriter(CAutoFile& fileIn, const CTxOutSnapshotMetadata& metadata);
+
+    // Records are serialized through these, so the hash sees every byte written
+    int GetType() const;
+    int GetVersion() const;
+    void write(const char* pch, size_t nSize);
+
+    template <typename T>
+    CTxOutSnapshotWriter& operator<<(const T& obj)
+    {
+        ::Serialize(*this, obj);
+        return *this;
+    }
+
+    void BeginSection(TxOutSnapshotSection sectionIn);
+    void AddCoin(const COutPoint& outpoint, const Coin& coin);
+    void AddEntry(const std::vector<unsigned char>& vKey, const std::vector<unsigned char>& vValue);
+    void EndSection();
+
+    /** Write the closing hash; the writer must not be used after this */
+    const CTxOutSnapshotStats& Finish();
+};
+
+typedef std::function<bool(const COutPoint&, const Coin&)> TxOutSnapshotCoinFn;
+typedef std::function<bool(TxOutSnapshotSection, const std::vector<unsigned char>&, const std::vector<unsigned char>&)> TxOutSnapshotEntryFn;
+
+/**
+ * Read a snapshot, passing each coin and database entry to the callbacks,
+ * which stop the read by returning false. Records reach the callbacks before
+ * the closing hash is checked, so nothing they receive may be used unless
+ * this returns true.
+ */
+bool ReadTxOutSnapshot(CAutoFile& file, const TxOutSnapshotCoinFn& fnCoin, const TxOutSnapshotEntryFn& fnEntry,
+                       CTxOutSnapshotStats& stats, std::string& strError);
+
+/**
+ * Write a snapshot of the coins database and the asset, restricted asset and
+ * evo databases as of the active tip. The state is flushed and the databases
+ * are opened for iteration under cs_main, which is released while writing.
+ */
+bool DumpTxOutSnapshot(CAutoFile& file, CTxOutSnapshotStats& stats, std::string& strError);
+
+#endif // MYNTA_TXOUTSNAPSHOT_H
@@ -37,6 +37,7 @@
 #endif // __linux__
 
 #include <algorithm>
+#include <fstream>
 #include <fcntl.h>
 #include <sys/resource.h>
 #include <sys/stat.h>
@@ -73,6 +74,11 @@
 #include <sys/prctl.h>
 #endif
 
+#ifdef __linux__
+#include <pthread.h>
+#include <sched.h>
+#endif
+
 #ifdef HAVE_MALLOPT_ARENA_MAX
 #include <malloc.h>
 #endif
@@ -250,6 +256,8 @@ const CLogCategoryDesc LogCategories[] =
                 {BCLog::QT,          "qt"},
                 {BCLog::LEVELDB,     "leveldb"},
                 {BCLog::REWARDS,     "rewards"},
+                {BCLog::LLMQ,        "llmq"},
+                {BCLog::STRATUM,     "stratum"},
                 {BCLog::ALL,         "1"},
                 {BCLog::ALL,         "all"},
         };
@@ -1040,6 +1048,46 @@ int GetNumCores()
 #endif
 }
 
+std::vector<int> GetCPUsByCacheDomain()
+{
+    std::vector<int> vCPUs;
+#ifdef __linux__
+    // Each CPU is keyed by the CPUs it shares its last level cache with
+    std::map<std::string, std::vector<int>> mapDomains;
+    for (int nCPU = 0; nCPU < (int)boost::thread::hardware_concurrency(); nCPU++) {
+        std::string strShared;
+        for (int nIndex = 3; nIndex >= 0 && strShared.empty(); nIndex--) {
+            std::ifstream file(strprintf("/sys/devices/system/cpu/cpu%d/cache/index%d/shared_cpu_list", nCPU, nIndex));
+            std::getline(file, strShared);
+        }
+        if (strShared.empty())
+            return std::vector<int>();
+        mapDomains[strShared].push_back(nCPU);
+    }
+    // Domains in order of their first CPU
+    std::vector<std::vector<int>> vDomains;
+    for (auto& domain : mapDomains)
+        vDomains.push_back(std::move(domain.second));
+    std::sort(vDomains.begin(), vDomains.end());
+    for (const auto& domain : vDomains)
+        vCPUs.insert(vCPUs.end(), domain.begin(), domain.end());
+#endif
+    return vCPUs;
+}
+
+bool PinThreadToCPU(int nCPU)
+{
+#ifdef __linux__
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    CPU_SET(nCPU, &set);
+    return pthread_setaffinity_np(pthread_self(), sizeof(set), &set) == 0;
+#else
+    (void) nCPU;
+    return false;
+#endif
+}
+
 std::string CopyrightHolders(const std::string &strPrefix)
 {
     std::string strCopyrightHolders = strPrefix + strprintf(_(COPYRIGHT_HOLDERS), _(COPYRIGHT_HOLDERS_SUBSTITUTION));
@@ -106,6 +106,8 @@ namespace BCLog
         QT = (1 << 19),
         LEVELDB = (1 << 20),
         REWARDS = (1 << 21),
+        LLMQ = (1 << 22),
+        STRATUM = (1 << 23),
         ALL = ~(uint32_t) 0,
     };
 }
@@ -331,6 +333,15 @@ std::string HelpMessageOpt(const std::string &option, const std::string &message
  */
 int GetNumCores();
 
+/**
+ * Return the logical CPUs ordered so that the ones sharing a last level cache
+ * come one after another, or nothing when the topology can't be read.
+ */
+std::vector<int> GetCPUsByCacheDomain();
+
+/** Restrict the calling thread to one logical CPU. Returns false where that isn't supported. */
+bool PinThreadToCPU(int nCPU);
+
 void RenameThread(const char *name);
 
 /**
@@ -8,11 +8,19 @@
 
 #include "tinyformat.h"
 
+#include <algorithm>
 #include <cstdlib>
 #include <cstring>
 #include <errno.h>
 #include <limits>
 
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__amd64__))
+#define HAVE_HEX_SIMD 1
+#include <immintrin.h>
+#define HEX_SSSE3_TARGET __attribute__((target("ssse3")))
+#define HEX_AVX2_TARGET __attribute__((target("avx2")))
+#endif
+
 static const std::string CHARS_ALPHA_NUM = "abcdefghijklmnopqrstuvwxyzABCDEFGHIJKLMNOPQRSTUVWXYZ0123456789";
 
 static const std::string SAFE_CHARS[] =
@@ -56,39 +64,198 @@ signed char HexDigit(char c)
     return p_util_hexdigit[(unsigned char)c];
 }
 
-bool IsHex(const std::string& str)
+namespace
 {
-    for(std::string::const_iterator it(str.begin()); it != str.end(); ++it)
-    {
-        if (HexDigit(*it) < 0)
-            return false;
+const char HEX_DIGITS[] = "0123456789abcdef";
+
+/**
+ * Vector kernels for long runs of hex. Each works on whole blocks and
+ * returns how many bytes (or characters, for CountHex) it got through; the
+ * callers finish the rest one character at a time. Decoding and counting
+ * stop at the first block holding anything but hex digits.
+ */
+struct HexKernels
+{
+    size_t (*Encode)(const unsigned char* data, size_t len, char* out);
+    size_t (*Decode)(const char* in, size_t nBytes, unsigned char* out);
+    size_t (*CountHex)(const char* in, size_t len);
+};
+
+#if defined(HAVE_HEX_SIMD)
+HEX_SSSE3_TARGET inline void Encode16(const unsigned char* data, char* out)
+{
+    const __m128i table = _mm_setr_epi8('0', '1', '2', '3', '4', '5', '6', '7', '8', '9', 'a', 'b', 'c', 'd', 'e', 'f');
+    const __m128i mask = _mm_set1_epi8(0x0f);
+    const __m128i x = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data));
+    const __m128i hi = _mm_shuffle_epi8(table, _mm_and_si128(_mm_srli_epi16(x, 4), mask));
+    const __m128i lo = _mm_shuffle_epi8(table, _mm_and_si128(x, mask));
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(out), _mm_unpacklo_epi8(hi, lo));
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(out + 16), _mm_unpackhi_epi8(hi, lo));
+}
+
+/** The values of 16 characters, with valid set to all ones where they are hex digits */
+HEX_SSSE3_TARGET inline __m128i HexValues16(__m128i c, __m128i& valid)
+{
+    const __m128i digit = _mm_sub_epi8(c, _mm_set1_epi8('0'));
+    const __m128i isDigit = _mm_cmpeq_epi8(_mm_min_epu8(digit, _mm_set1_epi8(9)), digit);
+    // Folding to lower case only sends 'A'-'F' to 'a'-'f'
+    const __m128i letter = _mm_sub_epi8(_mm_or_si128(c, _mm_set1_epi8(0x20)), _mm_set1_epi8('a'));
+    const __m128i isLetter = _mm_cmpeq_epi8(_mm_min_epu8(letter, _mm_set1_epi8(5)), letter);
+    valid = _mm_or_si128(isDigit, isLetter);
+    return _mm_or_si128(_mm_and_si128(isDigit, digit), _mm_and_si128(isLetter, _mm_add_epi8(letter, _mm_set1_epi8(10))));
+}
+
+/** 32 characters to 16 bytes, false without writing if any is not a hex digit */
+HEX_SSSE3_TARGET inline bool Decode16(const char* in, unsigned char* out)
+{
+    __m128i valid0, valid1;
+    const __m128i v0 = HexValues16(_mm_loadu_si128(reinterpret_cast<const __m128i*>(in)), valid0);
+    const __m128i v1 = HexValues16(_mm_loadu_si128(reinterpret_cast<const __m128i*>(in + 16)), valid1);
+    if (_mm_movemask_epi8(_mm_and_si128(valid0, valid1)) != 0xffff)
+        return false;
+    // 16 * high + low for each pair of digits
+    const __m128i weights = _mm_set1_epi16(0x0110);
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(out), _mm_packus_epi16(_mm_maddubs_epi16(v0, weights), _mm_maddubs_epi16(v1, weights)));
+    return true;
+}
+
+HEX_SSSE3_TARGET size_t EncodeSSSE3(const unsigned char* data, size_t len, char* out)
+{
+    size_t i = 0;
+    for (; i + 16 <= len; i += 16)
+        Encode16(data + i, out + 2 * i);
+    return i;
+}
+
+HEX_SSSE3_TARGET size_t DecodeSSSE3(const char* in, size_t nBytes, unsigned char* out)
+{
+    size_t i = 0;
+    for (; i + 16 <= nBytes && Decode16(in + 2 * i, out + i); i += 16) {}
+    return i;
+}
+
+HEX_SSSE3_TARGET size_t CountHexSSSE3(const char* in, size_t len)
+{
+    size_t i = 0;
+    for (; i + 16 <= len; i += 16) {
+        __m128i valid;
+        HexValues16(_mm_loadu_si128(reinterpret_cast<const __m128i*>(in + i)), valid);
+        if (_mm_movemask_epi8(valid) != 0xffff)
+            break;
     }
-    return (str.size() > 0) && (str.size()%2 == 0);
+    return i;
 }
 
-bool IsHexNumber(const std::string& str)
+HEX_AVX2_TARGET inline __m256i HexValues32(__m256i c, __m256i& valid)
 {
-    size_t starting_location = 0;
-    if (str.size() > 2 && *str.begin() == '0' && *(str.begin()+1) == 'x') {
-        starting_location = 2;
+    const __m256i digit = _mm256_sub_epi8(c, _mm256_set1_epi8('0'));
+    const __m256i isDigit = _mm256_cmpeq_epi8(_mm256_min_epu8(digit, _mm256_set1_epi8(9)), digit);
+    const __m256i letter = _mm256_sub_epi8(_mm256_or_si256(c, _mm256_set1_epi8(0x20)), _mm256_set1_epi8('a'));
+    const __m256i isLetter = _mm256_cmpeq_epi8(_mm256_min_epu8(letter, _mm256_set1_epi8(5)), letter);
+    valid = _mm256_or_si256(isDigit, isLetter);
+    return _mm256_or_si256(_mm256_and_si256(isDigit, digit), _mm256_and_si256(isLetter, _mm256_add_epi8(letter, _mm256_set1_epi8(10))));
+}
+
+HEX_AVX2_TARGET size_t EncodeAVX2(const unsigned char* data, size_t len, char* out)
+{
+    const __m256i table = _mm256_setr_epi8('0', '1', '2', '3', '4', '5', '6', '7', '8', '9', 'a', 'b', 'c', 'd', 'e', 'f',
+                                           '0', '1', '2', '3', '4', '5', '6', '7', '8', '9', 'a', 'b', 'c', 'd', 'e', 'f');
+    const __m256i mask = _mm256_set1_epi8(0x0f);
+    size_t i = 0;
+    for (; i + 32 <= len; i += 32) {
+        const __m256i x = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + i));
+        const __m256i hi = _mm256_shuffle_epi8(table, _mm256_and_si256(_mm256_srli_epi16(x, 4), mask));
+        const __m256i lo = _mm256_shuffle_epi8(table, _mm256_and_si256(x, mask));
+        // Unpacking works within 128-bit lanes: a holds bytes 0-7 and 16-23, b bytes 8-15 and 24-31
+        const __m256i a = _mm256_unpacklo_epi8(hi, lo);
+        const __m256i b = _mm256_unpackhi_epi8(hi, lo);
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(out + 2 * i), _mm256_permute2x128_si256(a, b, 0x20));
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(out + 2 * i + 32), _mm256_permute2x128_si256(a, b, 0x31));
     }
-    for (auto c : str.substr(starting_location)) {
-        if (HexDigit(c) < 0) return false;
+    if (i + 16 <= len) {
+        Encode16(data + i, out + 2 * i);
+        i += 16;
     }
-    // Return false for empty string or "0x".
-    return (str.size() > starting_location);
+    return i;
 }
 
-std::vector<unsigned char> ParseHex(const char* psz)
+HEX_AVX2_TARGET size_t DecodeAVX2(const char* in, size_t nBytes, unsigned char* out)
+{
+    const __m256i weights = _mm256_set1_epi16(0x0110);
+    size_t i = 0;
+    for (; i + 32 <= nBytes; i += 32) {
+        __m256i valid0, valid1;
+        const __m256i v0 = HexValues32(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(in + 2 * i)), valid0);
+        const __m256i v1 = HexValues32(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(in + 2 * i + 32)), valid1);
+        if (_mm256_movemask_epi8(_mm256_and_si256(valid0, valid1)) != -1)
+            break;
+        // Packing works within lanes too, leaving the quarters in the order 0, 2, 1, 3
+        const __m256i packed = _mm256_packus_epi16(_mm256_maddubs_epi16(v0, weights), _mm256_maddubs_epi16(v1, weights));
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(out + i), _mm256_permute4x64_epi64(packed, 0xd8));
+    }
+    if (i + 16 <= nBytes && Decode16(in + 2 * i, out + i))
+        i += 16;
+    return i;
+}
+
+HEX_AVX2_TARGET size_t CountHexAVX2(const char* in, size_t len)
+{
+    size_t i = 0;
+    for (; i + 32 <= len; i += 32) {
+        __m256i valid;
+        HexValues32(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(in + i)), valid);
+        if (_mm256_movemask_epi8(valid) != -1)
+            break;
+    }
+    return i + CountHexSSSE3(in + i, std::min<size_t>(len - i, 16));
+}
+#endif
+
+HexKernels DetectHexKernels()
+{
+#if defined(HAVE_HEX_SIMD)
+    if (__builtin_cpu_supports("avx2"))
+        return {EncodeAVX2, DecodeAVX2, CountHexAVX2};
+    if (__builtin_cpu_supports("ssse3"))
+        return {EncodeSSSE3, DecodeSSSE3, CountHexSSSE3};
+#endif
+    return {nullptr, nullptr, nullptr};
+}
+
+const HexKernels& GetHexKernels()
+{
+    static const HexKernels kernels = DetectHexKernels();
+    return kernels;
+}
+
+std::vector<unsigned char> ParseHex(const char* psz, size_t len)
 {
     // convert hex dump to vector
+    const char* const pend = psz + len;
+    const HexKernels& kernels = GetHexKernels();
     std::vector<unsigned char> vch;
+    vch.reserve(len / 2);
+    int nScalarPairs = 0;
     while (true)
     {
-        while (isspace(*psz))
+        // Runs of digits go through the vector kernel, a few hundred bytes at a time
+        if (kernels.Decode && nScalarPairs == 0) {
+            unsigned char buf[256];
+            size_t nDecoded;
+            do {
+                nDecoded = kernels.Decode(psz, std::min<size_t>((pend - psz) / 2, sizeof(buf)), buf);
+                vch.insert(vch.end(), buf, buf + nDecoded);
+                psz += 2 * nDecoded;
+            } while (nDecoded == sizeof(buf));
+            // Whatever stopped it, such as spaces between bytes, is read one pair at a time for a while
+            nScalarPairs = 16;
+        }
+        while (psz < pend && isspace(*psz))
             psz++;
+        if (psz == pend)
+            break;
         signed char c = HexDigit(*psz++);
-        if (c == (signed char)-1)
+        if (c == (signed char)-1 || psz == pend)
             break;
         unsigned char n = (c << 4);
         c = HexDigit(*psz++);
@@ -96,13 +263,62 @@ std::vector<unsigned char> ParseHex(const char* psz)
             break;
         n |= c;
         vch.push_back(n);
+        if (nScalarPairs > 0)
+            nScalarPairs--;
     }
     return vch;
 }
+} // namespace
+
+void HexEncode(const unsigned char* data, size_t len, char* out)
+{
+    const HexKernels& kernels = GetHexKernels();
+    if (kernels.Encode) {
+        const size_t nDone = kernels.Encode(data, len, out);
+        data += nDone;
+        out += 2 * nDone;
+        len -= nDone;
+    }
+    for (size_t i = 0; i < len; i++) {
+        out[2 * i] = HEX_DIGITS[data[i] >> 4];
+        out[2 * i + 1] = HEX_DIGITS[data[i] & 15];
+    }
+}
+
+bool IsHex(const std::string& str)
+{
+    if (str.empty() || str.size() % 2 != 0)
+        return false;
+    const HexKernels& kernels = GetHexKernels();
+    for (size_t i = kernels.CountHex ? kernels.CountHex(str.data(), str.size()) : 0; i < str.size(); i++)
+    {
+        if (HexDigit(str[i]) < 0)
+            return false;
+    }
+    return true;
+}
+
+bool IsHexNumber(const std::string& str)
+{
+    size_t starting_location = 0;
+    if (str.size() > 2 && *str.begin() == '0' && *(str.begin()+1) == 'x') {
+        starting_location = 2;
+    }
+    for (auto c : str.substr(starting_location)) {
+        if (HexDigit(c) < 0) return false;
+    }
+    // Return false for empty string or "0x".
+    return (str.size() > starting_location);
+}
+
+std::vector<unsigned char> ParseHex(const char* psz)
+{
+    return ParseHex(psz, strlen(psz));
+}
 
 std::vector<unsigned char> ParseHex(const std::string& str)
 {
-    return ParseHex(str.c_str());
+    return ParseHex(str.data(), str.size());
 }
 
 void SplitHostPort(std::string in, int &portOut, std::string &hostOut) {
@@ -10,8 +10,10 @@
 #ifndef MYNTA_UTILSTRENCODINGS_H
 #define MYNTA_UTILSTRENCODINGS_H
 
+#include <iterator>
 #include <stdint.h>
 #include <string>
+#include <type_traits>
 #include <vector>
 
 #define BEGIN(a)            ((char*)&(a))
@@ -104,9 +106,38 @@ bool ParseUInt64(const std::string& str, uint64_t *out, int base = 10);
  */
 bool ParseDouble(const std::string& str, double *out);
 
+/** Write the hex of len bytes at data to out, which has room for 2 * len characters */
+void HexEncode(const unsigned char* data, size_t len, char* out);
+
+/** Iterators over bytes that are laid out one after the other in memory */
+template<typename T>
+struct IsContiguousByteIterator : std::integral_constant<bool,
+    (std::is_pointer<T>::value && sizeof(typename std::iterator_traits<T>::value_type) == 1) ||
+    std::is_same<T, std::vector<unsigned char>::iterator>::value ||
+    std::is_same<T, std::vector<unsigned char>::const_iterator>::value ||
+    std::is_same<T, std::string::iterator>::value ||
+    std::is_same<T, std::string::const_iterator>::value> {};
+
+/** Containers with data() and size() over bytes, such as vectors, strings and scripts */
+template<typename T, typename = void>
+struct HasContiguousBytes : std::false_type {};
+template<typename T>
+struct HasContiguousBytes<T, std::void_t<decltype(std::declval<const T&>().data()), decltype(std::declval<const T&>().size())>>
+    : std::integral_constant<bool, std::is_pointer<decltype(std::declval<const T&>().data())>::value &&
+                                   sizeof(*std::declval<const T&>().data()) == 1> {};
+
 template<typename T>
 std::string HexStr(const T itbegin, const T itend, bool fSpaces=false)
 {
+    if constexpr (IsContiguousByteIterator<T>::value) {
+        if (!fSpaces) {
+            std::string rv((itend - itbegin) * 2, '\0');
+            if (itbegin != itend)
+                HexEncode(reinterpret_cast<const unsigned char*>(&*itbegin), itend - itbegin, &rv[0]);
+            return rv;
+        }
+    }
+
     std::string rv;
     static const char hexmap[16] = { '0', '1', '2', '3', '4', '5', '6', '7',
                                      '8', '9', 'a', 'b', 'c', 'd', 'e', 'f' };
@@ -126,7 +157,12 @@ std::string HexStr(const T itbegin, const T itend, bool fSpaces=false)
 template<typename T>
 inline std::string HexStr(const T& vch, bool fSpaces=false)
 {
-    return HexStr(vch.begin(), vch.end(), fSpaces);
+    if constexpr (HasContiguousBytes<T>::value) {
+        const auto* p = vch.data();
+        return HexStr(p, p + vch.size(), fSpaces);
+    } else {
+        return HexStr(vch.begin(), vch.end(), fSpaces);
+    }
 }
 
 /**
@@ -7,6 +7,9 @@
 #include "validation.h"
 
 #include "arith_uint256.h"
+#include "blockcompression.h"
+#include "blockprefetch.h"
+#include "blockfilemap.h"
 #include "chain.h"
 #include "chainparams.h"
 #include "checkpoints.h"
@@ -18,12 +21,14 @@
 #include "cuckoocache.h"
 #include "fs.h"
 #include "hash.h"
+#include "indexbuilder.h"
 #include "init.h"
 #include "policy/fees.h"
 #include "policy/policy.h"
 #include "policy/rbf.h"
 #include "pow.h"
 #include "primitives/block.h"
+#include "primitives/blockview.h"
 #include "primitives/transaction.h"
 #include "random.h"
 #include "reverse_iterator.h"
@@ -40,12 +45,16 @@
 #include "utilmoneystr.h"
 #include "utilstrencodings.h"
 #include "validationinterface.h"
+#include "validationstats.h"
 #include "versionbits.h"
 #include "warnings.h"
 #include "net.h"
 
 #include <atomic>
+#include <deque>
 #include <sstream>
+#include <thread>
+#include <unordered_map>
 
 #include <boost/algorithm/string/replace.hpp>
 #include <boost/algorithm/string/join.hpp>
@@ -56,9 +65,11 @@
 #include "assets/assets.h"
 #include "assets/assetdb.h"
 #include "base58.h"
+#include "evo/deterministicmns.h"
 
 #include "assets/snapshotrequestdb.h"
 #include "assets/assetsnapshotdb.h"
+#include "assets/atomicswap.h"
 
 // Fixing Boost 1.73 compile errors
 #include <boost/bind/bind.hpp>
@@ -87,6 +98,36 @@ CCriticalSection cs_main;
 
 BlockMap mapBlockIndex;
 CChain chainActive;
+
+namespace {
+/**
+ * Owns the CBlockIndex objects of mapBlockIndex. They are allocated in chunks
+ * of adjacent objects, which loading an index of millions of blocks does far
+ * faster than one allocation each, and freed together by UnloadBlockIndex.
+ */
+class CBlockIndexArena
+{
+private:
+    static const size_t CHUNK_SIZE = 4096;
+    std::vector<std::vector<CBlockIndex>> vChunks;
+
+public:
+    template <typename... Args>
+    CBlockIndex* New(Args&&... args)
+    {
+        // A chunk never grows past its reserved size, so its objects never move
+        if (vChunks.empty() || vChunks.back().size() == vChunks.back().capacity()) {
+            vChunks.emplace_back();
+            vChunks.back().reserve(CHUNK_SIZE);
+        }
+        vChunks.back().emplace_back(std::forward<Args>(args)...);
+        return &vChunks.back().back();
+    }
+
+    void Clear() { vChunks.clear(); }
+};
+CBlockIndexArena blockIndexArena;
+} // namespace
 CBlockIndex *pindexBestHeader = nullptr;
 CWaitableCriticalSection csBestBlock;
 CConditionVariable cvBlockChange;
@@ -101,6 +142,8 @@ bool fTimestampIndex = false;
 bool fSpentIndex = false;
 bool fHavePruned = false;
 bool fPruneMode = false;
+bool fBlockFileMmap = DEFAULT_BLOCKFILE_MMAP;
+bool fBlockCompression = DEFAULT_BLOCK_COMPRESSION;
 bool fIsBareMultisigStd = DEFAULT_PERMIT_BAREMULTISIG;
 bool fRequireStandard = true;
 bool fCheckBlockIndex = false;
@@ -232,15 +275,16 @@ CBlockIndex* FindForkInGlobalIndex(const CChain& chain, const CBlockLocator& loc
 }
 
 CCoinsViewDB *pcoinsdbview = nullptr;
+CCoinsViewFlushBuffer *pcoinsbuffer = nullptr;
 CCoinsViewCache *pcoinsTip = nullptr;
 CBlockTreeDB *pblocktree = nullptr;
 
 CAssetsDB *passetsdb = nullptr;
 CAssetsCache *passets = nullptr;
-CLRUCache<std::string, CDatabasedAssetData> *passetsCache = nullptr;
-CLRUCache<std::string, CMessage> *pMessagesCache = nullptr;
+CAssetNameLRUCache<CDatabasedAssetData> *passetsCache = nullptr;
+CMessageLRUCache *pMessagesCache = nullptr;
 CLRUCache<std::string, int> *pMessageSubscribedChannelsCache = nullptr;
-CLRUCache<std::string, int> *pMessagesSeenAddressCache = nullptr;
+CSeenAddressLRUCache *pMessagesSeenAddressCache = nullptr;
 CMessageDB *pmessagedb = nullptr;
 CMessageChannelDB *pmessagechanneldb = nullptr;
 CMyRestrictedDB *pmyrestricteddb = nullptr;
@@ -248,10 +292,10 @@ CSnapshotRequestDB *pSnapshotRequestDb = nullptr;
 CAssetSnapshotDB *pAssetSnapshotDb = nullptr;
 CDistributeSnapshotRequestDB *pDistributeSnapshotDb = nullptr;
 
-CLRUCache<std::string, CNullAssetTxVerifierString> *passetsVerifierCache = nullptr;
-CLRUCache<std::string, int8_t> *passetsQualifierCache = nullptr;
-CLRUCache<std::string, int8_t> *passetsRestrictionCache = nullptr;
-CLRUCache<std::string, int8_t> *passetsGlobalRestrictionCache = nullptr;
+CAssetNameLRUCache<CNullAssetTxVerifierString> *passetsVerifierCache = nullptr;
+CAssetAddressLRUCache<int8_t> *passetsQualifierCache = nullptr;
+CAssetAddressLRUCache<int8_t> *passetsRestrictionCache = nullptr;
+CAssetNameLRUCache<int8_t> *passetsGlobalRestrictionCache = nullptr;
 CRestrictedDB *prestricteddb = nullptr;
 
 enum FlushStateMode {
@@ -266,6 +310,7 @@ static bool FlushStateToDisk(const CChainParams& chainParams, CValidationState &
 static void FindFilesToPruneManual(std::set<int>& setFilesToPrune, int nManualPruneHeight);
 static void FindFilesToPrune(std::set<int>& setFilesToPrune, uint64_t nPruneAfterHeight);
 bool CheckInputs(const CTransaction& tx, CValidationState &state, const CCoinsViewCache &inputs, bool fScriptChecks, unsigned int flags, bool cacheSigStore, bool cacheFullScriptStore, PrecomputedTransactionData& txdata, std::vector<CScriptCheck> *pvChecks = nullptr);
+static void AddValidatedTxFlags(const CTransaction& tx, unsigned int flags);
 static FILE* OpenUndoFile(const CDiskBlockPos &pos, bool fReadOnly = false);
 
 bool CheckFinalTx(const CTransaction &tx, int flags)
@@ -514,6 +559,99 @@ static bool CheckInputsFromMempoolAndCache(const CTransaction& tx, CValidationSt
     return CheckInputs(tx, state, view, true, flags, cacheSigStore, true, txdata);
 }
 
+/**
+ * Collect the keys CTxMemPool indexes an asset transaction under. Fails, with
+ * the reason in strReason, if the tx changes the same global restriction or
+ * tag twice.
+ */
+static bool GetMempoolAssetRecord(const CTransaction& tx, CMempoolAssetRecord& record, std::string& strReason)
+{
+    auto fnAddOnce = [&strReason](std::vector<std::string>& vKeys, const std::string& key, const char* pszReason) {
+        if (std::find(vKeys.begin(), vKeys.end(), key) != vKeys.end()) {
+            strReason = pszReason;
+            return false;
+        }
+        vKeys.push_back(key);
+        return true;
+    };
+    auto fnAddPairOnce = [&strReason](std::vector<std::pair<std::string, std::string>>& vKeys, const std::pair<std::string, std::string>& key, const char* pszReason) {
+        if (std::find(vKeys.begin(), vKeys.end(), key) != vKeys.end()) {
+            strReason = pszReason;
+            return false;
+        }
+        vKeys.push_back(key);
+        return true;
+    };
+
+    if (AreAssetsDeployed()) {
+        std::vector<std::string> vRestrictedChanged;
+        bool fSetsVerifier = false;
+        for (const CTxOut& out : tx.vout) {
+            if (out.scriptPubKey.IsAssetScript()) {
+                CAssetOutputEntry data;
+                if (!GetAssetData(out.scriptPubKey, data))
+                    continue;
+                if (data.type == TX_NEW_ASSET && !IsAssetNameAnOwner(data.assetName))
+                    record.strNewAsset = data.assetName;
+                if ((data.type == TX_NEW_ASSET || data.type == TX_REISSUE_ASSET) && IsAssetNameAnRestricted(data.assetName))
+                    vRestrictedChanged.push_back(data.assetName);
+
+                // Keep track of all restricted assets tx that can become invalid if qualifier or verifiers are changed
+                if (AreRestrictedAssetsDeployed() && IsAssetNameAnRestricted(data.assetName)) {
+                    record.vQualifierAddresses.push_back(EncodeDestination(data.destination));
+                    record.vVerifierAssets.push_back(data.assetName);
+                }
+            } else if (out.scriptPubKey.IsNullGlobalRestrictionAssetTxDataScript()) {
+                CNullAssetTxData globalNullData;
+                if (GlobalAssetNullDataFromScript(out.scriptPubKey, globalNullData)) {
+                    if (globalNullData.flag == 1) {
+                        if (!fnAddOnce(record.vGlobalFreezes, globalNullData.asset_name, "bad-txns-global-freeze-already-in-mempool"))
+                            return false;
+                    } else if (globalNullData.flag == 0) {
+                        if (!fnAddOnce(record.vGlobalUnfreezes, globalNullData.asset_name, "bad-txns-global-unfreeze-already-in-mempool"))
+                            return false;
+                    }
+                }
+            } else if (out.scriptPubKey.IsNullAssetTxDataScript()) {
+                // We need to track all tags that are being adding to address, that live in the mempool
+                // This will allow us to keep the mempool clean, and only allow one tag per address at a time into the mempool
+                CNullAssetTxData addressNullData;
+                std::string address;
+                if (!AssetNullDataFromScript(out.scriptPubKey, addressNullData, address))
+                    continue;
+                if (IsAssetNameAQualifier(addressNullData.asset_name)) {
+                    auto key = std::make_pair(address, addressNullData.asset_name);
+                    if (addressNullData.flag == (int) QualifierType::ADD_QUALIFIER) {
+                        if (!fnAddPairOnce(record.vAddedTags, key, "bad-txns-adding-tag-already-in-mempool"))
+                            return false;
+                    } else {
+                        if (!fnAddPairOnce(record.vRemovedTags, key, "bad-txns-remove-tag-already-in-mempool"))
+                            return false;
+                    }
+                } else if (IsAssetNameAnRestricted(addressNullData.asset_name)) {
+                    record.vAddressFreezes.emplace_back(address, addressNullData.asset_name);
+                }
+            } else if (out.scriptPubKey.IsNullAssetVerifierTxDataScript()) {
+                fSetsVerifier = true;
+            }
+        }
+        if (fSetsVerifier)
+            record.vVerifierChanges = vRestrictedChanged;
+    }
+
+    // Keep track of all restricted assets tx that can become invalid if address or assets are marked as frozen
+    if (AreRestrictedAssetsDeployed()) {
+        for (const CTxIn& in : tx.vin) {
+            auto pData = pcoinsTip->AccessCoinAssetData(in.prevout);
+            if (pData && pData->fDecoded && IsAssetNameAnRestricted(pData->strName)) {
+                record.vGlobalFrozenAssets.push_back(pData->strName);
+                record.vFrozenAddresses.emplace_back(pData->address.ToString(), pData->strName);
+            }
+        }
+    }
+    return true;
+}
+
 static bool AcceptToMemoryPoolWorker(const CChainParams& chainparams, CTxMemPool& pool, CValidationState& state, const CTransactionRef& ptx,
                               bool* pfMissingInputs, int64_t nAcceptTime, std::list<CTransactionRef>* plTxnReplaced,
                               bool bypass_limits, const CAmount& nAbsurdFee, std::vector<COutPoint>& coins_to_uncache, bool test_accept)
@@ -657,12 +795,8 @@ static bool AcceptToMemoryPoolWorker(const CChainParams& chainparams, CTxMemPool
         }
 
         /** RVN START */
-        if (!AreAssetsDeployed()) {
-            for (auto out : tx.vout) {
-                if (out.scriptPubKey.IsAssetScript())
-                    return state.DoS(100, false, REJECT_INVALID, "bad-txns-contained-asset-when-not-active");
-            }
-        }
+        if (!AreAssetsDeployed() && tx.HasAssetOutputs())
+            return state.DoS(100, false, REJECT_INVALID, "bad-txns-contained-asset-when-not-active");
 
         if (AreAssetsDeployed()) {
             if (!Consensus::CheckTxAssets(tx, state, view, GetCurrentAssetCache(), true, vReissueAssets))
@@ -934,8 +1068,21 @@ static bool AcceptToMemoryPoolWorker(const CChainParams& chainparams, CTxMemPool
                     LogPrintf("Warning: -promiscuousmempool flags set to not include currently enforced soft forks, this may break mining or otherwise cause instability!\n");
                 }
             }
+        } else {
+            // It passed with both, so blocks whose flags differ from the
+            // tip's can still skip it as long as they are no stricter.
+            AddValidatedTxFlags(tx, scriptVerifyFlags);
         }
 
+        // The asset names and addresses the mempool indexes the tx under. Only one
+        // global freeze, unfreeze or tag change of each key can wait in it at a time.
+        CMempoolAssetRecord assetRecord;
+        std::string strAssetReason;
+        if (!GetMempoolAssetRecord(tx, assetRecord, strAssetReason) || pool.HasAssetRecordConflict(assetRecord, allConflicting, strAssetReason))
+            return state.DoS(0, false, REJECT_INVALID, strAssetReason);
+        if (!assetRecord.IsNull())
+            entry.SetAssetRecord(std::make_shared<const CMempoolAssetRecord>(std::move(assetRecord)));
+
         if (test_accept) {
             // Tx was accepted, but not added
             return true;
@@ -985,100 +1132,6 @@ static bool AcceptToMemoryPoolWorker(const CChainParams& chainparams, CTxMemPool
             mapReissuedAssets.insert(out);
             mapReissuedTx.insert(std::make_pair(out.second, out.first));
         }
-
-        if (AreAssetsDeployed()) {
-            for (auto out : tx.vout) {
-                if (out.scriptPubKey.IsAssetScript()) {
-                    CAssetOutputEntry data;
-                    if (!GetAssetData(out.scriptPubKey, data))
-                        continue;
-                    if (data.type == TX_NEW_ASSET && !IsAssetNameAnOwner(data.assetName)) {
-                        pool.mapAssetToHash[data.assetName] = hash;
-                        pool.mapHashToAsset[hash] = data.assetName;
-                    }
-
-                    // Keep track of all restricted assets tx that can become invalid if qualifier or verifiers are changed
-                    if (AreRestrictedAssetsDeployed()) {
-                        if (IsAssetNameAnRestricted(data.assetName)) {
-                            std::string address = EncodeDestination(data.destination);
-                            pool.mapAddressesQualifiersChanged[address].insert(hash);
-                            pool.mapHashQualifiersChanged[hash].insert(address);
-
-                            pool.mapAssetVerifierChanged[data.assetName].insert(hash);
-                            pool.mapHashVerifierChanged[hash].insert(data.assetName);
-                        }
-                    }
-                } else if (out.scriptPubKey.IsNullGlobalRestrictionAssetTxDataScript()) {
-                    CNullAssetTxData globalNullData;
-                    if (GlobalAssetNullDataFromScript(out.scriptPubKey, globalNullData)) {
-                        if (globalNullData.flag == 1) {
-                            if (pool.mapGlobalFreezingAssetTransactions.count(globalNullData.asset_name)) {
-                                return state.DoS(0, false, REJECT_INVALID, "bad-txns-global-freeze-already-in-mempool");
-                            } else {
-                                pool.mapGlobalFreezingAssetTransactions[globalNullData.asset_name].insert(tx.GetHash());
-                                pool.mapHashGlobalFreezingAssetTransactions[tx.GetHash()].insert(globalNullData.asset_name);
-                            }
-                        } else if (globalNullData.flag == 0) {
-                            if (pool.mapGlobalUnFreezingAssetTransactions.count(globalNullData.asset_name)) {
-                                return state.DoS(0, false, REJECT_INVALID, "bad-txns-global-unfreeze-already-in-mempool");
-                            } else {
-                                pool.mapGlobalUnFreezingAssetTransactions[globalNullData.asset_name].insert(tx.GetHash());
-                                pool.mapHashGlobalUnFreezingAssetTransactions[tx.GetHash()].insert(globalNullData.asset_name);
-                            }
-                        }
-                    }
-                } else if (out.scriptPubKey.IsNullAssetTxDataScript()) {
-                    // We need to track all tags that are being adding to address, that live in the mempool
-                    // This will allow us to keep the mempool clean, and only allow one tag per address at a time into the mempool
-                    CNullAssetTxData addressNullData;
-                    std::string address;
-                    if (AssetNullDataFromScript(out.scriptPubKey, addressNullData, address)) {
-                        if (IsAssetNameAQualifier(addressNullData.asset_name)) {
-                            if (addressNullData.flag == (int) QualifierType::ADD_QUALIFIER) {
-                                if (pool.mapAddressAddedTag.count(std::make_pair(address, addressNullData.asset_name))) {
-                                    return state.DoS(0, false, REJECT_INVALID,
-                                                     "bad-txns-adding-tag-already-in-mempool");
-                                }
-                                // Adding a qualifier to an address
-                                pool.mapAddressAddedTag[std::make_pair(address, addressNullData.asset_name)].insert(tx.GetHash());
-                                pool.mapHashToAddressAddedTag[tx.GetHash()].insert(std::make_pair(address, addressNullData.asset_name));
-                            } else {
-                                    if (pool.mapAddressRemoveTag.count(std::make_pair(address, addressNullData.asset_name))) {
-                                        return state.DoS(0, false, REJECT_INVALID,
-                                                         "bad-txns-remove-tag-already-in-mempool");
-                                    }
-
-                                pool.mapAddressRemoveTag[std::make_pair(address, addressNullData.asset_name)].insert(tx.GetHash());
-                                pool.mapHashToAddressRemoveTag[tx.GetHash()].insert(std::make_pair(address, addressNullData.asset_name));
-                            }
-                        }
-                    }
-                }
-            }
-        }
-
-        // Keep track of all restricted assets tx that can become invalid if address or assets are marked as frozen
-        if (AreRestrictedAssetsDeployed()) {
-            for (auto in : tx.vin) {
-                const Coin coin = pcoinsTip->AccessCoin(in.prevout);
-
-                if (!coin.IsAsset())
-                    continue;
-
-                CAssetOutputEntry data;
-                if (GetAssetData(coin.out.scriptPubKey, data)) {
-
-                    if (IsAssetNameAnRestricted(data.assetName)) {
-                        pool.mapAssetMarkedGlobalFrozen[data.assetName].insert(hash);
-                        pool.mapHashMarkedGlobalFrozen[hash].insert(data.assetName);
-
-                        auto pair = std::make_pair(EncodeDestination(data.destination), data.assetName);
-                        pool.mapAddressesMarkedFrozen[pair].insert(hash);
-                        pool.mapHashToAddressMarkedFrozen[hash].insert(pair);
-                    }
-                }
-            }
-        }
     }
 
     GetMainSignals().TransactionAddedToMempool(ptx);
@@ -1111,12 +1164,13 @@ bool AcceptToMemoryPool(CTxMemPool& pool, CValidationState &state, const CTransa
     return AcceptToMemoryPoolWithTime(chainparams, pool, state, tx, pfMissingInputs, GetTime(), plTxnReplaced, bypass_limits, nAbsurdFee, test_accept);
 }
 
-bool GetTimestampIndex(const unsigned int &high, const unsigned int &low, const bool fActiveOnly, std::vector<std::pair<uint256, unsigned int> > &hashes)
+bool GetTimestampIndex(const unsigned int &high, const unsigned int &low, const bool fActiveOnly, std::vector<std::pair<uint256, unsigned int> > &hashes,
+                       size_t nLimit, const uint256 &hashStartAfter)
 {
     if (!fTimestampIndex)
         return error("Timestamp index not enabled");
 
-    if (!pblocktree->ReadTimestampIndex(high, low, fActiveOnly, hashes))
+    if (!pblocktree->ReadTimestampIndex(high, low, fActiveOnly, hashes, nLimit, hashStartAfter))
         return error("Unable to get hashes for timestamps");
 
     return true;
@@ -1136,6 +1190,39 @@ bool GetSpentIndex(CSpentIndexKey &key, CSpentIndexValue &value)
     return true;
 }
 
+void GetSpentIndex(const std::vector<CSpentIndexKey> &vKeys, std::vector<CSpentIndexValue> &vValues, std::vector<bool> &vFound)
+{
+    vValues.assign(vKeys.size(), CSpentIndexValue());
+    vFound.assign(vKeys.size(), false);
+    if (!fSpentIndex)
+        return;
+
+    // The mempool's first, then the rest from the index in one pass
+    std::vector<CSpentIndexKey> vDbKeys;
+    std::vector<size_t> vDbPos;
+    for (size_t i = 0; i < vKeys.size(); i++) {
+        CSpentIndexKey key = vKeys[i];
+        if (mempool.getSpentIndex(key, vValues[i])) {
+            vFound[i] = true;
+        } else {
+            vDbKeys.push_back(key);
+            vDbPos.push_back(i);
+        }
+    }
+    if (vDbKeys.empty())
+        return;
+
+    std::vector<CSpentIndexValue> vDbValues;
+    std::vector<bool> vDbFound;
+    pblocktree->ReadSpentIndex(vDbKeys, vDbValues, vDbFound);
+    for (size_t j = 0; j < vDbPos.size(); j++) {
+        if (vDbFound[j]) {
+            vValues[vDbPos[j]] = vDbValues[j];
+            vFound[vDbPos[j]] = true;
+        }
+    }
+}
+
 bool HashOnchainActive(const uint256 &hash)
 {
     CBlockIndex* pblockindex = mapBlockIndex[hash];
@@ -1196,12 +1283,66 @@ bool GetAddressUnspent(uint160 addressHash, int type,
 }
 
 /** Return transaction in txOut, and if it was found inside a block, its hash is placed in hashBlock */
+static CBlockFileMapCache::MapPtr MapDiskRecord(const CDiskBlockPos& pos, const char* prefix, size_t nTrailer, uint32_t& nSize, bool& fCompressed, bool fWillNeed = true);
+static bool ReadCompressedDiskRecord(CAutoFile& filein, std::vector<unsigned char>& vData);
+
+//! Read the transaction at postx from its block file, and the hash of that block
+static bool ReadTxFromDisk(const CDiskTxPos& postx, CTransactionRef& txOut, uint256& hashBlock)
+{
+    CBlockHeader header;
+    uint32_t nSize;
+    bool fCompressed;
+    std::vector<unsigned char> vData;
+    // Only the header and the transaction are read, not the whole block
+    if (CBlockFileMapCache::MapPtr map = MapDiskRecord(postx, "blk", 0, nSize, fCompressed, false)) {
+        try {
+            const unsigned char* pData = map->data() + postx.nPos;
+            if (fCompressed) {
+                DecompressDiskRecord(pData, nSize, MAX_SIZE, vData);
+                pData = vData.data();
+                nSize = vData.size();
+            }
+            CSpanReader filein(SER_DISK, CLIENT_VERSION, pData, nSize);
+            filein >> header;
+            filein.ignore(postx.nTxOffset);
+            filein >> txOut;
+        } catch (const std::exception& e) {
+            return error("%s: Deserialize or I/O error - %s", __func__, e.what());
+        }
+    } else {
+        if (postx.nPos < 8)
+            return error("%s: invalid block position %s", __func__, postx.ToString());
+        // Open the file at the size field in front of the block
+        CDiskBlockPos hpos = postx;
+        hpos.nPos -= 4;
+        CAutoFile file(OpenBlockFile(hpos, true), SER_DISK, CLIENT_VERSION);
+        if (file.IsNull())
+            return error("%s: OpenBlockFile failed", __func__);
+        try {
+            if (ReadCompressedDiskRecord(file, vData)) {
+                CSpanReader filein(SER_DISK, CLIENT_VERSION, vData.data(), vData.size());
+                filein >> header;
+                filein.ignore(postx.nTxOffset);
+                filein >> txOut;
+            } else {
+                file >> header;
+                fseek(file.Get(), postx.nTxOffset, SEEK_CUR);
+                file >> txOut;
+            }
+        } catch (const std::exception& e) {
+            return error("%s: Deserialize or I/O error - %s", __func__, e.what());
+        }
+    }
+    hashBlock = header.GetHash();
+    return true;
+}
+
 bool GetTransaction(const uint256 &hash, CTransactionRef &txOut, const Consensus::Params& consensusParams, uint256 &hashBlock, bool fAllowSlow)
 {
     CBlockIndex *pindexSlow = nullptr;
 
-    LOCK(cs_main);
-
+    // The mempool, the tx index and block files have locks of their own;
+    // only the slow path below needs cs_main
     CTransactionRef ptx = mempool.get(hash);
     if (ptx)
     {
@@ -1212,18 +1353,8 @@ bool GetTransaction(const uint256 &hash, CTransactionRef &txOut, const Consensus
     if (fTxIndex) {
         CDiskTxPos postx;
         if (pblocktree->ReadTxIndex(hash, postx)) {
-            CAutoFile file(OpenBlockFile(postx, true), SER_DISK, CLIENT_VERSION);
-            if (file.IsNull())
-                return error("%s: OpenBlockFile failed", __func__);
-            CBlockHeader header;
-            try {
-                file >> header;
-                fseek(file.Get(), postx.nTxOffset, SEEK_CUR);
-                file >> txOut;
-            } catch (const std::exception& e) {
-                return error("%s: Deserialize or I/O error - %s", __func__, e.what());
-            }
-            hashBlock = header.GetHash();
+            if (!ReadTxFromDisk(postx, txOut, hashBlock))
+                return false;
             if (txOut->GetHash() != hash)
                 return error("%s: txid mismatch", __func__);
             return true;
@@ -1233,6 +1364,8 @@ bool GetTransaction(const uint256 &hash, CTransactionRef &txOut, const Consensus
         return false;
     }
 
+    LOCK(cs_main);
+
     if (fAllowSlow) { // use coin database to locate block that contains transaction, and scan it
         const Coin& coin = AccessByTxid(*pcoinsTip, hash);
         if (!coin.IsSpent()) pindexSlow = chainActive[coin.nHeight];
@@ -1254,6 +1387,67 @@ bool GetTransaction(const uint256 &hash, CTransactionRef &txOut, const Consensus
     return false;
 }
 
+void GetTransactions(const std::vector<uint256>& vHash, std::vector<CTransactionRef>& vtxOut, std::vector<uint256>& vHashBlock,
+                     const Consensus::Params& consensusParams, bool fAllowSlow)
+{
+    vtxOut.assign(vHash.size(), nullptr);
+    vHashBlock.assign(vHash.size(), uint256());
+
+    // Positions of the ones that have to be read, and where their results go
+    std::vector<std::pair<CDiskTxPos, size_t> > vPos;
+    for (size_t i = 0; i < vHash.size(); i++) {
+        vtxOut[i] = mempool.get(vHash[i]);
+        if (vtxOut[i])
+            continue;
+        if (!fTxIndex) {
+            // Nothing to sort by; the slow path scans a whole block each
+            if (!GetTransaction(vHash[i], vtxOut[i], consensusParams, vHashBlock[i], fAllowSlow))
+                vtxOut[i] = nullptr;
+            continue;
+        }
+        CDiskTxPos postx;
+        if (pblocktree->ReadTxIndex(vHash[i], postx))
+            vPos.emplace_back(postx, i);
+    }
+    if (vPos.empty())
+        return;
+
+    // Read them in file order, each thread a run of neighbouring ones
+    std::sort(vPos.begin(), vPos.end(), [](const std::pair<CDiskTxPos, size_t>& a, const std::pair<CDiskTxPos, size_t>& b) {
+        return std::make_tuple(a.first.nFile, a.first.nPos, a.first.nTxOffset) < std::make_tuple(b.first.nFile, b.first.nPos, b.first.nTxOffset);
+    });
+    auto readRange = [&](size_t begin, size_t end) {
+        for (size_t j = begin; j < end; j++) {
+            const size_t i = vPos[j].second;
+            CTransactionRef tx;
+            uint256 hashBlock;
+            if (!ReadTxFromDisk(vPos[j].first, tx, hashBlock))
+                continue;
+            if (tx->GetHash() != vHash[i]) {
+                error("%s: txid mismatch", __func__);
+                continue;
+            }
+            vtxOut[i] = tx;
+            vHashBlock[i] = hashBlock;
+        }
+    };
+    size_t nThreads = std::min<size_t>(std::min(std::max(1, GetNumCores()), MAX_TX_READ_THREADS), vPos.size() / MIN_TX_READS_PER_THREAD);
+    if (nThreads <= 1) {
+        readRange(0, vPos.size());
+    } else {
+        size_t nChunk = (vPos.size() + nThreads - 1) / nThreads;
+        std::vector<std::thread> threads;
+        threads.reserve(nThreads - 1);
+        for (size_t t = 1; t < nThreads; t++) {
+            threads.emplace_back(readRange, t * nChunk, std::min(vPos.size(), (t + 1) * nChunk));
+        }
+        readRange(0, nChunk);
+        for (auto& thread : threads) {
+            thread.join();
+        }
+    }
+}
+
 
 
 
@@ -1264,7 +1458,89 @@ bool GetTransaction(const uint256 &hash, CTransactionRef &txOut, const Consensus
 // CBlock and CBlockIndex
 //
 
-static bool WriteBlockToDisk(const CBlock& block, CDiskBlockPos& pos, const CMessageHeader::MessageStartChars& messageStart)
+/**
+ * Map the size-prefixed record (block or undo data) that starts at pos in a
+ * blk/rev file, plus nTrailer bytes after it. Sets nSize to the size the
+ * record takes in the file and fCompressed to whether its data is compressed,
+ * and returns nullptr when -blockfilemmap is off or the file can't be mapped,
+ * in which case the caller falls back to reading through a FILE*. Readahead
+ * (fWillNeed) is for callers that read the whole record and what follows it.
+ */
+static CBlockFileMapCache::MapPtr MapDiskRecord(const CDiskBlockPos& pos, const char* prefix, size_t nTrailer, uint32_t& nSize, bool& fCompressed, bool fWillNeed)
+{
+    if (!fBlockFileMmap || pos.IsNull() || pos.nPos < 8)
+        return nullptr;
+
+    const fs::path path = GetBlockPosFilename(pos, prefix);
+    CBlockFileMapCache::MapPtr map = blockFileMaps.Get(path, pos.nPos);
+    if (!map)
+        return nullptr;
+
+    // The record's size is written just in front of it
+    nSize = ReadLE32(map->data() + pos.nPos - 4);
+    fCompressed = (nSize & DISK_RECORD_COMPRESSED) != 0;
+    nSize &= ~DISK_RECORD_COMPRESSED;
+    const size_t nEnd = (size_t)pos.nPos + nSize + nTrailer;
+    if (map->size() < nEnd && !(map = blockFileMaps.Get(path, nEnd)))
+        return nullptr;
+
+    // Pull in the record and the start of whatever follows it, so replays
+    // that walk a file in order don't stall on one page fault at a time
+    if (fWillNeed)
+        map->WillNeed(pos.nPos, nSize + nTrailer + BLOCKFILE_READAHEAD_SIZE);
+    return map;
+}
+
+/**
+ * Read the size field of a record through filein, which is positioned just
+ * after the magic in front of it. A compressed record's data is read and
+ * decompressed into vData, and true returned; otherwise filein is left at the
+ * start of the record's data. Throws on read errors and corrupt data.
+ */
+static bool ReadCompressedDiskRecord(CAutoFile& filein, std::vector<unsigned char>& vData)
+{
+    uint32_t nSize;
+    filein >> nSize;
+    if (!(nSize & DISK_RECORD_COMPRESSED))
+        return false;
+    nSize &= ~DISK_RECORD_COMPRESSED;
+    if (nSize > MAX_SIZE)
+        throw std::ios_base::failure("ReadCompressedDiskRecord(): compressed record too large");
+    std::vector<unsigned char> vStored(nSize);
+    filein.read((char*)vStored.data(), nSize);
+    DecompressDiskRecord(vStored.data(), nSize, MAX_SIZE, vData);
+    return true;
+}
+
+/**
+ * A block or undo record as it is written to a blk/rev file: serialized, and
+ * compressed if -blockcompression is on and that makes it smaller. Each record
+ * is compressed on its own, so a read never decompresses more than one block.
+ */
+class CDiskRecordData
+{
+public:
+    std::vector<unsigned char> vData;
+    bool fCompressed{false};
+
+    template <typename T>
+    explicit CDiskRecordData(const T& obj)
+    {
+        CVectorWriter(SER_DISK, CLIENT_VERSION, vData, 0, obj);
+        std::vector<unsigned char> vStored;
+        if (fBlockCompression && CompressDiskRecord(vData, vStored)) {
+            vData.swap(vStored);
+            fCompressed = true;
+        }
+    }
+
+    //! Bytes the record takes in the file, after the magic and size field in front of it
+    unsigned int size() const { return vData.size(); }
+    //! The size field written in front of it
+    uint32_t GetSizeField() const { return vData.size() | (fCompressed ? DISK_RECORD_COMPRESSED : 0); }
+};
+
+static bool WriteBlockToDisk(const CDiskRecordData& record, CDiskBlockPos& pos, const CMessageHeader::MessageStartChars& messageStart)
 {
     // Open history file to append
     CAutoFile fileout(OpenBlockFile(pos), SER_DISK, CLIENT_VERSION);
@@ -1272,15 +1548,14 @@ static bool WriteBlockToDisk(const CBlock& block, CDiskBlockPos& pos, const CMes
         return error("WriteBlockToDisk: OpenBlockFile failed");
 
     // Write index header
-    unsigned int nSize = GetSerializeSize(fileout, block);
-    fileout << FLATDATA(messageStart) << nSize;
+    fileout << FLATDATA(messageStart) << record.GetSizeField();
 
     // Write block
     long fileOutPos = ftell(fileout.Get());
     if (fileOutPos < 0)
         return error("WriteBlockToDisk: ftell failed");
     pos.nPos = (unsigned int)fileOutPos;
-    fileout << block;
+    fileout.write((const char*)record.vData.data(), record.vData.size());
 
     return true;
 }
@@ -1289,17 +1564,46 @@ bool ReadBlockFromDisk(CBlock& block, const CDiskBlockPos& pos, const Consensus:
 {
     block.SetNull();
 
-    // Open history file to read
-    CAutoFile filein(OpenBlockFile(pos, true), SER_DISK, CLIENT_VERSION);
-    if (filein.IsNull())
-        return error("ReadBlockFromDisk: OpenBlockFile failed for %s", pos.ToString());
-
-    // Read block
-    try {
-        filein >> block;
-    }
-    catch (const std::exception& e) {
-        return error("%s: Deserialize or I/O error - %s at %s", __func__, e.what(), pos.ToString());
+    uint32_t nSize;
+    bool fCompressed;
+    std::vector<unsigned char> vData;
+    if (CBlockFileMapCache::MapPtr map = MapDiskRecord(pos, "blk", 0, nSize, fCompressed)) {
+        try {
+            const unsigned char* pData = map->data() + pos.nPos;
+            if (fCompressed) {
+                DecompressDiskRecord(pData, nSize, MAX_SIZE, vData);
+                pData = vData.data();
+                nSize = vData.size();
+            }
+            CSpanReader filein(SER_DISK, CLIENT_VERSION, pData, nSize);
+            filein >> block;
+        }
+        catch (const std::exception& e) {
+            return error("%s: Deserialize or I/O error - %s at %s", __func__, e.what(), pos.ToString());
+        }
+    } else {
+        if (pos.nPos < 8)
+            return error("%s: invalid block position %s", __func__, pos.ToString());
+
+        // Open history file to read, at the size field in front of the block
+        CDiskBlockPos hpos = pos;
+        hpos.nPos -= 4;
+        CAutoFile filein(OpenBlockFile(hpos, true), SER_DISK, CLIENT_VERSION);
+        if (filein.IsNull())
+            return error("ReadBlockFromDisk: OpenBlockFile failed for %s", pos.ToString());
+
+        // Read block
+        try {
+            if (ReadCompressedDiskRecord(filein, vData)) {
+                CSpanReader blockin(SER_DISK, CLIENT_VERSION, vData.data(), vData.size());
+                blockin >> block;
+            } else {
+                filein >> block;
+            }
+        }
+        catch (const std::exception& e) {
+            return error("%s: Deserialize or I/O error - %s at %s", __func__, e.what(), pos.ToString());
+        }
     }
 
     // Check the header
@@ -1319,6 +1623,88 @@ bool ReadBlockFromDisk(CBlock& block, const CBlockIndex* pindex, const Consensus
     return true;
 }
 
+bool ReadRawBlockFromDisk(std::vector<unsigned char>& block, const CDiskBlockPos& pos, const CMessageHeader::MessageStartChars& message_start)
+{
+    block.clear();
+    if (pos.nPos < 8)
+        return error("%s: invalid block position %s", __func__, pos.ToString());
+
+    uint32_t nSize;
+    bool fCompressed;
+    if (CBlockFileMapCache::MapPtr map = MapDiskRecord(pos, "blk", 0, nSize, fCompressed)) {
+        if (memcmp(map->data() + pos.nPos - 8, message_start, CMessageHeader::MESSAGE_START_SIZE))
+            return error("%s: Block magic mismatch for %s", __func__, pos.ToString());
+        if (nSize > MAX_SIZE)
+            return error("%s: Block data is larger than maximum deserialization size for %s: %u versus %u", __func__, pos.ToString(),
+                    nSize, MAX_SIZE);
+        if (!fCompressed) {
+            block.assign(map->data() + pos.nPos, map->data() + pos.nPos + nSize);
+            return true;
+        }
+        try {
+            DecompressDiskRecord(map->data() + pos.nPos, nSize, MAX_SIZE, block);
+        } catch (const std::exception& e) {
+            block.clear();
+            return error("%s: %s for %s", __func__, e.what(), pos.ToString());
+        }
+        return true;
+    }
+
+    // Seek back to the index header written in front of the block
+    CDiskBlockPos hpos = pos;
+    hpos.nPos -= 8;
+    CAutoFile filein(OpenBlockFile(hpos, true), SER_DISK, CLIENT_VERSION);
+    if (filein.IsNull())
+        return error("%s: OpenBlockFile failed for %s", __func__, pos.ToString());
+
+    try {
+        CMessageHeader::MessageStartChars blk_start;
+        unsigned int blk_size;
+        filein >> FLATDATA(blk_start) >> blk_size;
+
+        if (memcmp(blk_start, message_start, CMessageHeader::MESSAGE_START_SIZE))
+            return error("%s: Block magic mismatch for %s: %s versus expected %s", __func__, pos.ToString(),
+                    HexStr(blk_start, blk_start + CMessageHeader::MESSAGE_START_SIZE),
+                    HexStr(message_start, message_start + CMessageHeader::MESSAGE_START_SIZE));
+
+        const bool fCompressed = (blk_size & DISK_RECORD_COMPRESSED) != 0;
+        blk_size &= ~DISK_RECORD_COMPRESSED;
+        if (blk_size > MAX_SIZE)
+            return error("%s: Block data is larger than maximum deserialization size for %s: %u versus %u", __func__, pos.ToString(),
+                    blk_size, MAX_SIZE);
+
+        block.resize(blk_size);
+        filein.read((char*)block.data(), blk_size);
+        if (fCompressed) {
+            std::vector<unsigned char> vStored;
+            vStored.swap(block);
+            DecompressDiskRecord(vStored.data(), vStored.size(), MAX_SIZE, block);
+        }
+    } catch (const std::exception& e) {
+        block.clear();
+        return error("%s: Read from block file failed: %s for %s", __func__, e.what(), pos.ToString());
+    }
+
+    return true;
+}
+
+bool ReadRawBlockFromDisk(std::vector<unsigned char>& block, const CBlockIndex* pindex, const CMessageHeader::MessageStartChars& message_start)
+{
+    return ReadRawBlockFromDisk(block, pindex->GetBlockPos(), message_start);
+}
+
+bool ReadBlockViewFromDisk(CBlockView& view, std::vector<unsigned char>& buffer, const CBlockIndex* pindex, const CMessageHeader::MessageStartChars& message_start)
+{
+    if (!ReadRawBlockFromDisk(buffer, pindex, message_start))
+        return false;
+    if (!view.Parse(buffer.data(), buffer.size()))
+        return error("%s: Deserialize error at %s", __func__, pindex->GetBlockPos().ToString());
+    if (view.GetHeader().GetHash() != pindex->GetBlockHash())
+        return error("%s: GetHash() doesn't match index for %s at %s", __func__,
+                pindex->ToString(), pindex->GetBlockPos().ToString());
+    return true;
+}
+
 CAmount GetBlockSubsidy(int nHeight, const Consensus::Params& consensusParams)
 {
     int halvings = nHeight / consensusParams.nSubsidyHalvingInterval;
@@ -1528,7 +1914,7 @@ void static InvalidBlockFound(CBlockIndex *pindex, const CValidationState &state
     }
 }
 
-void UpdateCoins(const CTransaction& tx, CCoinsViewCache& inputs, CTxUndo &txundo, int nHeight, uint256 blockHash, CAssetsCache* assetCache, std::pair<std::string, CBlockAssetUndo>* undoAssetData)
+void UpdateCoins(const CTransaction& tx, CCoinsViewCache& inputs, CTxUndo &txundo, int nHeight, uint256 blockHash, CAssetsCache* assetCache, std::pair<std::string, CBlockAssetUndo>* undoAssetData, const std::vector<CAssetOutputRecord>* pAssetOutputs)
 {
     // mark inputs spent
     if (!tx.IsCoinBase()) {
@@ -1540,7 +1926,7 @@ void UpdateCoins(const CTransaction& tx, CCoinsViewCache& inputs, CTxUndo &txund
         }
     }
     // add outputs
-    AddCoins(inputs, tx, nHeight, blockHash, false, assetCache, undoAssetData); /** RVN START */ /* Pass assetCache into function */ /** RVN END */
+    AddCoins(inputs, tx, nHeight, blockHash, false, assetCache, undoAssetData, pAssetOutputs); /** RVN START */ /* Pass assetCache into function */ /** RVN END */
 }
 
 void UpdateCoins(const CTransaction& tx, CCoinsViewCache& inputs, int nHeight)
@@ -1566,6 +1952,93 @@ int GetSpendHeight(const CCoinsViewCache& inputs)
 static CuckooCache::cache<uint256, SignatureCacheHasher> scriptExecutionCache;
 static uint256 scriptExecutionCacheNonce(GetRandHash());
 
+/**
+ * Strictest script flags each transaction passed mempool acceptance with, by
+ * witness hash. scriptExecutionCache only matches the exact flags it was
+ * filled under, so without this a block whose flags differ from the tip's at
+ * acceptance time (a soft fork activating, a reorg) runs every script again.
+ *
+ * Script flags only add rules, so passing with flags F means passing with
+ * any subset of F. The DISCOURAGE_UPGRADABLE_* policy flags are the exception
+ * (dropping CHECKLOCKTIMEVERIFY from F turns the opcode back into a
+ * discouraged NOP), so lookups that include them never match a subset.
+ * Protected by cs_main.
+ */
+class CValidatedTxFlagsCache
+{
+private:
+    std::unordered_map<uint256, unsigned int, SaltedTxidHasher> mapFlags;
+    //! Insertion order, oldest first, for eviction. May name entries already erased.
+    std::deque<uint256> queueInserted;
+    size_t nMaxEntries{0};
+
+public:
+    void SetMaxEntries(size_t nMaxEntriesIn)
+    {
+        nMaxEntries = nMaxEntriesIn;
+    }
+
+    void Insert(const uint256& hash, unsigned int flags)
+    {
+        if (nMaxEntries == 0)
+            return;
+        auto it = mapFlags.find(hash);
+        if (it != mapFlags.end()) {
+            // Keep whichever set of flags covers the other
+            if ((flags & it->second) == flags)
+                return;
+            it->second = flags;
+            return;
+        }
+        mapFlags.emplace(hash, flags);
+        queueInserted.push_back(hash);
+        while (queueInserted.size() > nMaxEntries) {
+            mapFlags.erase(queueInserted.front());
+            queueInserted.pop_front();
+        }
+    }
+
+    //! Whether hash passed with a superset of flags. A match is erased when fErase is set.
+    bool Contains(const uint256& hash, unsigned int flags, bool fErase)
+    {
+        if (flags & (SCRIPT_VERIFY_DISCOURAGE_UPGRADABLE_NOPS | SCRIPT_VERIFY_DISCOURAGE_UPGRADABLE_WITNESS_PROGRAM))
+            return false;
+        auto it = mapFlags.find(hash);
+        if (it == mapFlags.end() || (flags & ~it->second) != 0)
+            return false;
+        if (fErase)
+            mapFlags.erase(it);
+        return true;
+    }
+
+    size_t Size() const
+    {
+        return mapFlags.size();
+    }
+};
+
+static CValidatedTxFlagsCache validatedTxFlags;
+static std::atomic<uint64_t> nScriptCacheHits{0};
+static std::atomic<uint64_t> nScriptCacheFlagHits{0};
+static std::atomic<uint64_t> nScriptCacheMisses{0};
+
+static void AddValidatedTxFlags(const CTransaction& tx, unsigned int flags)
+{
+    AssertLockHeld(cs_main);
+    validatedTxFlags.Insert(tx.GetWitnessHash(), flags);
+}
+
+ScriptCacheStats GetScriptCacheStats()
+{
+    LOCK(cs_main);
+    ScriptCacheStats stats;
+    stats.nHits = nScriptCacheHits;
+    stats.nFlagHits = nScriptCacheFlagHits;
+    stats.nMisses = nScriptCacheMisses;
+    stats.nValidatedTxs = validatedTxFlags.Size();
+    return stats;
+}
+
 void InitScriptExecutionCache() {
     // nMaxCacheSize is unsigned. If -maxsigcachesize is set to zero,
     // setup_bytes creates the minimum possible cache (2 elements).
@@ -1573,6 +2046,12 @@ void InitScriptExecutionCache() {
     size_t nElems = scriptExecutionCache.setup_bytes(nMaxCacheSize);
     LogPrintf("Using %zu MiB out of %zu/2 requested for script execution cache, able to store %zu elements\n",
             (nElems*sizeof(uint256)) >>20, (nMaxCacheSize*2)>>20, nElems);
+    // Half as much again for the flags of accepted transactions, at about
+    // 100 bytes an entry with the map and queue overhead
+    size_t nFlagsEntries = nMaxCacheSize / 2 / 100;
+    LOCK(cs_main);
+    validatedTxFlags.SetMaxEntries(nFlagsEntries);
+    LogPrintf("Remembering the script flags of up to %zu accepted transactions\n", nFlagsEntries);
 }
 
 /**
@@ -1617,9 +2096,20 @@ bool CheckInputs(const CTransaction& tx, CValidationState &state, const CCoinsVi
             static_assert(55 - sizeof(flags) - 32 >= 128/8, "Want at least 128 bits of nonce for script execution cache");
             CSHA256().Write(scriptExecutionCacheNonce.begin(), 55 - sizeof(flags) - 32).Write(tx.GetWitnessHash().begin(), 32).Write((unsigned char*)&flags, sizeof(flags)).Finalize(hashCacheEntry.begin());
             AssertLockHeld(cs_main); //TODO: Remove this requirement by making CuckooCache not require external locks
+            // Connecting a block (not just checking one) is where a hit saves work worth counting
+            bool fConnecting = !cacheSigStore && !cacheFullScriptStore;
             if (scriptExecutionCache.contains(hashCacheEntry, !cacheFullScriptStore)) {
+                if (fConnecting)
+                    nScriptCacheHits++;
                 return true;
             }
+            if (fConnecting) {
+                if (validatedTxFlags.Contains(tx.GetWitnessHash(), flags, true)) {
+                    nScriptCacheFlagHits++;
+                    return true;
+                }
+                nScriptCacheMisses++;
+            }
 
             for (unsigned int i = 0; i < tx.vin.size(); i++) {
                 const COutPoint &prevout = tx.vin[i].prevout;
@@ -1675,7 +2165,7 @@ bool CheckInputs(const CTransaction& tx, CValidationState &state, const CCoinsVi
 
 namespace {
 
-bool UndoWriteToDisk(const CBlockUndo& blockundo, CDiskBlockPos& pos, const uint256& hashBlock, const CMessageHeader::MessageStartChars& messageStart)
+bool UndoWriteToDisk(const CBlockUndo& blockundo, const CDiskRecordData& record, CDiskBlockPos& pos, const uint256& hashBlock, const CMessageHeader::MessageStartChars& messageStart)
 {
     // Open history file to append
     CAutoFile fileout(OpenUndoFile(pos), SER_DISK, CLIENT_VERSION);
@@ -1683,17 +2173,16 @@ bool UndoWriteToDisk(const CBlockUndo& blockundo, CDiskBlockPos& pos, const uint
         return error("%s: OpenUndoFile failed", __func__);
 
     // Write index header
-    unsigned int nSize = GetSerializeSize(fileout, blockundo);
-    fileout << FLATDATA(messageStart) << nSize;
+    fileout << FLATDATA(messageStart) << record.GetSizeField();
 
     // Write undo data
     long fileOutPos = ftell(fileout.Get());
     if (fileOutPos < 0)
         return error("%s: ftell failed", __func__);
     pos.nPos = (unsigned int)fileOutPos;
-    fileout << blockundo;
+    fileout.write((const char*)record.vData.data(), record.vData.size());
 
-    // calculate & write checksum
+    // calculate & write checksum, of the data as it is before compression
     CHashWriter hasher(SER_GETHASH, PROTOCOL_VERSION);
     hasher << hashBlock;
     hasher << blockundo;
@@ -1702,19 +2191,62 @@ bool UndoWriteToDisk(const CBlockUndo& blockundo, CDiskBlockPos& pos, const uint
     return true;
 }
 
+} // namespace
+
 bool UndoReadFromDisk(CBlockUndo& blockundo, const CDiskBlockPos& pos, const uint256& hashBlock)
 {
-    // Open history file to read
-    CAutoFile filein(OpenUndoFile(pos, true), SER_DISK, CLIENT_VERSION);
+    uint32_t nSize;
+    bool fCompressed;
+    if (CBlockFileMapCache::MapPtr map = MapDiskRecord(pos, "rev", sizeof(uint256), nSize, fCompressed)) {
+        uint256 hashChecksum;
+        try {
+            std::vector<unsigned char> vData;
+            const unsigned char* pData = map->data() + pos.nPos;
+            if (fCompressed) {
+                DecompressDiskRecord(pData, nSize, MAX_SIZE, vData);
+                pData = vData.data();
+            }
+            CSpanReader filein(SER_DISK, CLIENT_VERSION, pData, fCompressed ? vData.size() : nSize);
+            CHashVerifier<CSpanReader> verifier(&filein);
+            verifier << hashBlock;
+            verifier >> blockundo;
+            CSpanReader(SER_DISK, CLIENT_VERSION, map->data() + pos.nPos + nSize, sizeof(uint256)) >> hashChecksum;
+            if (hashChecksum != verifier.GetHash())
+                return error("%s: Checksum mismatch", __func__);
+        }
+        catch (const std::exception& e) {
+            return error("%s: Deserialize or I/O error - %s", __func__, e.what());
+        }
+        return true;
+    }
+
+    if (pos.nPos < 8)
+        return error("%s: invalid undo position %s", __func__, pos.ToString());
+
+    // Open history file to read, at the size field in front of the undo data
+    CDiskBlockPos hpos = pos;
+    hpos.nPos -= 4;
+    CAutoFile filein(OpenUndoFile(hpos, true), SER_DISK, CLIENT_VERSION);
     if (filein.IsNull())
         return error("%s: OpenUndoFile failed", __func__);
 
     // Read block
     uint256 hashChecksum;
-    CHashVerifier<CAutoFile> verifier(&filein); // We need a CHashVerifier as reserializing may lose data
+    uint256 hashData;
     try {
-        verifier << hashBlock;
-        verifier >> blockundo;
+        std::vector<unsigned char> vData;
+        if (ReadCompressedDiskRecord(filein, vData)) {
+            CSpanReader undoin(SER_DISK, CLIENT_VERSION, vData.data(), vData.size());
+            CHashVerifier<CSpanReader> verifier(&undoin);
+            verifier << hashBlock;
+            verifier >> blockundo;
+            hashData = verifier.GetHash();
+        } else {
+            CHashVerifier<CAutoFile> verifier(&filein); // We need a CHashVerifier as reserializing may lose data
+            verifier << hashBlock;
+            verifier >> blockundo;
+            hashData = verifier.GetHash();
+        }
         filein >> hashChecksum;
     }
     catch (const std::exception& e) {
@@ -1722,12 +2254,14 @@ bool UndoReadFromDisk(CBlockUndo& blockundo, const CDiskBlockPos& pos, const uin
     }
 
     // Verify checksum
-    if (hashChecksum != verifier.GetHash())
+    if (hashChecksum != hashData)
         return error("%s: Checksum mismatch", __func__);
 
     return true;
 }
 
+namespace {
+
 /** Abort with a message */
 bool AbortNode(const std::string& strMessage, const std::string& userMessage="")
 {
@@ -1832,7 +2366,7 @@ static DisconnectResult DisconnectBlock(const CBlock& block, const CBlockIndex*
     }
 
     std::vector<std::pair<std::string, CBlockAssetUndo> > vUndoData;
-    if (!passetsdb->ReadBlockUndoAssetData(block.GetHash(), vUndoData)) {
+    if (!passetsdb->ReadBlockUndoAssetData(pindex->GetBlockHash(), vUndoData)) {
         error("DisconnectBlock(): block asset undo data inconsistent");
         return DISCONNECT_FAILED;
     }
@@ -1842,7 +2376,7 @@ static DisconnectResult DisconnectBlock(const CBlock& block, const CBlockIndex*
     std::vector<std::pair<CSpentIndexKey, CSpentIndexValue> > spentIndex;
 
     // undo transactions in reverse order
-    CAssetsCache tempCache(*assetsCache);
+    CAssetsCache tempCache(assetsCache);
     for (int i = block.vtx.size() - 1; i >= 0; i--) {
         const CTransaction &tx = *(block.vtx[i]);
         uint256 hash = tx.GetHash();
@@ -1920,6 +2454,9 @@ static DisconnectResult DisconnectBlock(const CBlock& block, const CBlockIndex*
                 /** RVN START */
                 if (AreAssetsDeployed()) {
                     if (assetsCache) {
+                        // SpendCoin only changed tempCache, which is dropped, so count the supply here
+                        if (is_spent)
+                            assetsCache->UpdateAssetSupply(coin.out, -1);
                         if (IsScriptTransferAsset(tx.vout[o].scriptPubKey))
                             vAssetTxIndex.emplace_back(o);
                     }
@@ -1952,7 +2489,7 @@ static DisconnectResult DisconnectBlock(const CBlock& block, const CBlockIndex*
                         return DISCONNECT_FAILED;
                     }
                     if (assetsCache->ContainsAsset(asset)) {
-                        if (!assetsCache->RemoveNewAsset(asset, strAddress)) {
+                        if (!assetsCache->RemoveNewAsset(asset, CAddressKey::FromString(strAddress))) {
                             error("%s : Failed to Remove Asset. Asset Name : %s", __func__, asset.strName);
                             return DISCONNECT_FAILED;
                         }
@@ -1966,7 +2503,7 @@ static DisconnectResult DisconnectBlock(const CBlock& block, const CBlockIndex*
                         return DISCONNECT_FAILED;
                     }
 
-                    if (!assetsCache->RemoveOwnerAsset(ownerName, ownerAddress)) {
+                    if (!assetsCache->RemoveOwnerAsset(ownerName, CAddressKey::FromString(ownerAddress))) {
                         error("%s : Failed to Remove Owner from transaction. TXID : %s", __func__, tx.GetHash().GetHex());
                         return DISCONNECT_FAILED;
                     }
@@ -1981,7 +2518,7 @@ static DisconnectResult DisconnectBlock(const CBlock& block, const CBlockIndex*
                     }
 
                     if (assetsCache->ContainsAsset(reissue.strName)) {
-                        if (!assetsCache->RemoveReissueAsset(reissue, strAddress,
+                        if (!assetsCache->RemoveReissueAsset(reissue, CAddressKey::FromString(strAddress),
                                                              COutPoint(tx.GetHash(), tx.vout.size() - 1),
                                                              vUndoData)) {
                             error("%s : Failed to Undo Reissue Asset. Asset Name : %s", __func__, reissue.strName);
@@ -1992,17 +2529,17 @@ static DisconnectResult DisconnectBlock(const CBlock& block, const CBlockIndex*
                     for (int n = 0; n < (int)tx.vout.size(); n++) {
                         auto out = tx.vout[n];
                         CNewAsset asset;
-                        std::string strAddress;
+                        CAddressKey address;
 
                         if (IsScriptNewUniqueAsset(out.scriptPubKey)) {
-                            if (!AssetFromScript(out.scriptPubKey, asset, strAddress)) {
+                            if (!AssetFromScript(out.scriptPubKey, asset, address)) {
                                 error("%s : Failed to get unique asset from transaction. TXID : %s, vout: %s", __func__,
                                       tx.GetHash().GetHex(), n);
                                 return DISCONNECT_FAILED;
                             }
 
                             if (assetsCache->ContainsAsset(asset.strName)) {
-                                if (!assetsCache->RemoveNewAsset(asset, strAddress)) {
+                                if (!assetsCache->RemoveNewAsset(asset, address)) {
                                     error("%s : Failed to Undo Unique Asset. Asset Name : %s", __func__, asset.strName);
                                     return DISCONNECT_FAILED;
                                 }
@@ -2020,7 +2557,7 @@ static DisconnectResult DisconnectBlock(const CBlock& block, const CBlockIndex*
                     }
 
                     if (assetsCache->ContainsAsset(asset.strName)) {
-                        if (!assetsCache->RemoveNewAsset(asset, strAddress)) {
+                        if (!assetsCache->RemoveNewAsset(asset, CAddressKey::FromString(strAddress))) {
                             error("%s : Failed to Undo Msg Channel Asset. Asset Name : %s", __func__, asset.strName);
                             return DISCONNECT_FAILED;
                         }
@@ -2036,7 +2573,7 @@ static DisconnectResult DisconnectBlock(const CBlock& block, const CBlockIndex*
                     }
 
                     if (assetsCache->ContainsAsset(asset.strName)) {
-                        if (!assetsCache->RemoveNewAsset(asset, strAddress)) {
+                        if (!assetsCache->RemoveNewAsset(asset, CAddressKey::FromString(strAddress))) {
                             error("%s : Failed to Undo Qualifier Asset. Asset Name : %s", __func__, asset.strName);
                             return DISCONNECT_FAILED;
                         }
@@ -2052,7 +2589,7 @@ static DisconnectResult DisconnectBlock(const CBlock& block, const CBlockIndex*
                     }
 
                     if (assetsCache->ContainsAsset(asset.strName)) {
-                        if (!assetsCache->RemoveNewAsset(asset, strAddress)) {
+                        if (!assetsCache->RemoveNewAsset(asset, CAddressKey::FromString(strAddress))) {
                             error("%s : Failed to Undo Restricted Asset. Asset Name : %s", __func__, asset.strName);
                             return DISCONNECT_FAILED;
                         }
@@ -2077,15 +2614,15 @@ static DisconnectResult DisconnectBlock(const CBlock& block, const CBlockIndex*
 
                 for (auto index : vAssetTxIndex) {
                     CAssetTransfer transfer;
-                    std::string strAddress;
-                    if (!TransferAssetFromScript(tx.vout[index].scriptPubKey, transfer, strAddress)) {
+                    CAddressKey address;
+                    if (!TransferAssetFromScript(tx.vout[index].scriptPubKey, transfer, address)) {
                         error("%s : Failed to get transfer asset from transaction. CTxOut : %s", __func__,
                               tx.vout[index].ToString());
                         return DISCONNECT_FAILED;
                     }
 
                     COutPoint out(hash, index);
-                    if (!assetsCache->RemoveTransfer(transfer, strAddress, out)) {
+                    if (!assetsCache->RemoveTransfer(transfer, address, out)) {
                         error("%s : Failed to Remove the transfer of an asset. Asset Name : %s, COutPoint : %s",
                               __func__,
                               transfer.strName, out.ToString());
@@ -2262,6 +2799,12 @@ void static FlushBlockFile(bool fFinalize = false)
 
     CDiskBlockPos posOld(nLastBlockFile, 0);
 
+    if (fFinalize) {
+        // Mappings may extend past the size the files are truncated to
+        blockFileMaps.Invalidate(GetBlockPosFilename(posOld, "blk"));
+        blockFileMaps.Invalidate(GetBlockPosFilename(posOld, "rev"));
+    }
+
     FILE *fileOld = OpenBlockFile(posOld);
     if (fileOld) {
         if (fFinalize)
@@ -2283,11 +2826,74 @@ static bool FindUndoPos(CValidationState &state, int nFile, CDiskBlockPos &pos,
 
 static CCheckQueue<CScriptCheck> scriptcheckqueue(128);
 
-void ThreadScriptCheck() {
+void ThreadScriptCheck(int nWorker) {
     RenameThread("raven-scriptch");
+    if (gArgs.GetBoolArg("-parpin", DEFAULT_SCRIPTCHECK_PIN)) {
+        static const std::vector<int> vCPUs = GetCPUsByCacheDomain();
+        if (vCPUs.empty()) {
+            LogPrintf("Not pinning script verification thread %d, CPU topology unknown\n", nWorker);
+        } else {
+            // Workers fill one cache domain before moving to the next. The
+            // first CPU is left to the thread connecting blocks.
+            int nCPU = vCPUs[(nWorker + 1) % vCPUs.size()];
+            if (!PinThreadToCPU(nCPU))
+                LogPrintf("Could not pin script verification thread %d to CPU %d\n", nWorker, nCPU);
+        }
+    }
     scriptcheckqueue.Thread();
 }
 
+std::vector<CCheckQueueWorkerStats> GetScriptCheckStats() {
+    return scriptcheckqueue.GetWorkerStats();
+}
+
+/**
+ * Prepare one transaction ahead of ConnectBlock's serial loop: compute its
+ * signature hash data, and classify and deserialize every output so
+ * CheckTxAssets and AddCoins read the records instead of each parsing the
+ * asset scripts again.
+ */
+class CTxPrepareCheck
+{
+private:
+    const CTransaction* ptx;
+    PrecomputedTransactionData* ptxdata;
+    std::vector<CAssetOutputRecord>* pvRecords;
+
+public:
+    CTxPrepareCheck() : ptx(nullptr), ptxdata(nullptr), pvRecords(nullptr) {}
+    CTxPrepareCheck(const CTransaction& txIn, PrecomputedTransactionData* ptxdataIn, std::vector<CAssetOutputRecord>* pvRecordsIn) :
+        ptx(&txIn), ptxdata(ptxdataIn), pvRecords(pvRecordsIn) {}
+
+    bool operator()()
+    {
+        if (ptxdata) {
+            ptxdata->Init(*ptx);
+        }
+        if (pvRecords) {
+            pvRecords->resize(ptx->vout.size());
+            for (size_t i = 0; i < ptx->vout.size(); i++) {
+                DecodeAssetOutput(ptx->vout[i].scriptPubKey, (*pvRecords)[i]);
+            }
+        }
+        return true;
+    }
+
+    void swap(CTxPrepareCheck& check)
+    {
+        std::swap(ptx, check.ptx);
+        std::swap(ptxdata, check.ptxdata);
+        std::swap(pvRecords, check.pvRecords);
+    }
+};
+
+static CCheckQueue<CTxPrepareCheck> txpreparequeue(1);
+
+void ThreadTxPrepare() {
+    RenameThread("mynta-txprep");
+    txpreparequeue.Thread();
+}
+
 // Protected by cs_main
 VersionBitsCache versionbitscache;
 
@@ -2440,6 +3046,7 @@ static bool ConnectBlock(const CBlock& block, CValidationState& state, CBlockInd
     }
 
     int64_t nTime1 = GetTimeMicros(); nTimeCheck += nTime1 - nTimeStart;
+    RecordValidationTime(ValidationPhase::CHECK_BLOCK, nTime1 - nTimeStart);
     LogPrint(BCLog::BENCH, "    - Sanity checks: %.2fms [%.2fs (%.2fms/blk)]\n", MILLI * (nTime1 - nTimeStart), nTimeCheck * MICRO, nTimeCheck * MILLI / nBlocksTotal);
 
     // Do not allow blocks that contain transactions which 'overwrite' older transactions,
@@ -2490,6 +3097,7 @@ static bool ConnectBlock(const CBlock& block, CValidationState& state, CBlockInd
     unsigned int flags = GetBlockScriptFlags(pindex, chainparams.GetConsensus());
 
     int64_t nTime2 = GetTimeMicros(); nTimeForks += nTime2 - nTime1;
+    RecordValidationTime(ValidationPhase::FORK_CHECKS, nTime2 - nTime1);
     LogPrint(BCLog::BENCH, "    - Fork checks: %.2fms [%.2fs (%.2fms/blk)]\n", MILLI * (nTime2 - nTime1), nTimeForks * MICRO, nTimeForks * MILLI / nBlocksTotal);
 
     CBlockUndo blockundo;
@@ -2505,19 +3113,46 @@ static bool ConnectBlock(const CBlock& block, CValidationState& state, CBlockInd
     std::vector<std::pair<uint256, CDiskTxPos> > vPos;
     vPos.reserve(block.vtx.size());
     blockundo.vtxundo.reserve(block.vtx.size() - 1);
-    std::vector<PrecomputedTransactionData> txdata;
-    txdata.reserve(block.vtx.size()); // Required so that pointers to individual PrecomputedTransactionData don't get invalidated
+    // Filled in up front and never resized again, so pointers to individual PrecomputedTransactionData stay valid
+    std::vector<PrecomputedTransactionData> txdata(block.vtx.size());
 
-    std::vector<std::pair<CAddressIndexKey, CAmount> > addressIndex;
-    std::vector<std::pair<CAddressUnspentKey, CAddressUnspentValue> > addressUnspentIndex;
-    std::vector<std::pair<CSpentIndexKey, CSpentIndexValue> > spentIndex;
 
     std::set<CMessage> setMessages;
     std::vector<std::pair<std::string, CNullAssetTxData>> myNullAssetData;
+    int64_t nTimeAssetChecks = 0;
+
+    // Compute the signature hash data and decode the asset outputs of every
+    // transaction up front, on the transaction prepare threads when there are any.
+    // Meanwhile the inputs spending coins from earlier blocks are read into the
+    // view in one batch, so the input checks below don't go to disk one by one.
+    std::vector<std::vector<CAssetOutputRecord>> vAssetOutputs;
+    const bool fAssets = AreAssetsDeployed();
+    if (fAssets)
+        vAssetOutputs.resize(block.vtx.size());
+    {
+        std::vector<CTxPrepareCheck> vChecks;
+        vChecks.reserve(block.vtx.size());
+        for (unsigned int i = 0; i < block.vtx.size(); i++) {
+            const CTransaction& tx = *block.vtx[i];
+            vChecks.emplace_back(tx, tx.IsCoinBase() ? nullptr : &txdata[i], fAssets ? &vAssetOutputs[i] : nullptr);
+        }
+        const std::vector<COutPoint> vPrefetch = GetBlockPrefetchOutpoints(block);
+        if (nScriptCheckThreads && vChecks.size() > 1) {
+            CCheckQueueControl<CTxPrepareCheck> prepareControl(&txpreparequeue);
+            prepareControl.Add(vChecks);
+            view.PrefetchCoins(vPrefetch);
+            prepareControl.Wait();
+        } else {
+            view.PrefetchCoins(vPrefetch);
+            for (CTxPrepareCheck& check : vChecks) {
+                check();
+            }
+        }
+    }
+
     for (unsigned int i = 0; i < block.vtx.size(); i++)
     {
         const CTransaction &tx = *(block.vtx[i]);
-        const uint256 txhash = tx.GetHash();
 
         nInputs += tx.vin.size();
 
@@ -2535,21 +3170,24 @@ static bool ConnectBlock(const CBlock& block, CValidationState& state, CBlockInd
             }
 
             /** RVN START */
-            if (!AreAssetsDeployed()) {
-                for (auto out : tx.vout)
+            if (!AreAssetsDeployed() && (tx.HasAssetOutputs() || tx.HasNullAssetOutputs())) {
+                for (const CTxOut& out : tx.vout) {
                     if (out.scriptPubKey.IsAssetScript())
                         return state.DoS(100, error("%s : Received Block with tx that contained an asset when assets wasn't active", __func__), REJECT_INVALID, "bad-txns-assets-not-active");
                     else if (out.scriptPubKey.IsNullAsset())
                         return state.DoS(100, error("%s : Received Block with tx that contained an null asset data tx when assets wasn't active", __func__), REJECT_INVALID, "bad-txns-null-data-assets-not-active");
+                }
             }
 
             if (AreAssetsDeployed()) {
+                int64_t nTimeAssetCheckStart = GetTimeMicros();
                 std::vector<std::pair<std::string, uint256>> vReissueAssets;
-                if (!Consensus::CheckTxAssets(tx, state, view, assetsCache, false, vReissueAssets, false, &setMessages, block.nTime, &myNullAssetData)) {
+                if (!Consensus::CheckTxAssets(tx, state, view, assetsCache, false, vReissueAssets, false, &setMessages, block.nTime, &myNullAssetData, &vAssetOutputs[i])) {
                     state.SetFailedTransaction(tx.GetHash());
                     return error("%s: Consensus::CheckTxAssets: %s, %s", __func__, tx.GetHash().ToString(),
                                  FormatStateMessage(state));
                 }
+                nTimeAssetChecks += GetTimeMicros() - nTimeAssetCheckStart;
             }
 
             /** RVN END */
@@ -2566,72 +3204,6 @@ static bool ConnectBlock(const CBlock& block, CValidationState& state, CBlockInd
                 return state.DoS(100, error("%s: contains a non-BIP68-final transaction", __func__),
                                  REJECT_INVALID, "bad-txns-nonfinal");
             }
-
-            if (fAddressIndex || fSpentIndex)
-            {
-                for (size_t j = 0; j < tx.vin.size(); j++) {
-
-                    const CTxIn input = tx.vin[j];
-                    const CTxOut &prevout = view.AccessCoin(tx.vin[j].prevout).out;
-                    uint160 hashBytes;
-                    int addressType = 0;
-                    bool isAsset = false;
-                    std::string assetName;
-                    CAmount assetAmount;
-
-                    if (prevout.scriptPubKey.IsPayToScriptHash()) {
-                        hashBytes = uint160(std::vector <unsigned char>(prevout.scriptPubKey.begin()+2, prevout.scriptPubKey.begin()+22));
-                        addressType = 2;
-                    } else if (prevout.scriptPubKey.IsPayToPublicKeyHash()) {
-                        hashBytes = uint160(std::vector <unsigned char>(prevout.scriptPubKey.begin()+3, prevout.scriptPubKey.begin()+23));
-                        addressType = 1;
-                    } else if (prevout.scriptPubKey.IsPayToPublicKey()) {
-                        hashBytes = Hash160(prevout.scriptPubKey.begin() + 1, prevout.scriptPubKey.end() - 1);
-                        addressType = 1;
-                    } else {
-                        /** RVN START */
-                        if (AreAssetsDeployed()) {
-                            hashBytes.SetNull();
-                            addressType = 0;
-
-                            if (ParseAssetScript(prevout.scriptPubKey, hashBytes, assetName, assetAmount)) {
-                                addressType = 1;
-                                isAsset = true;
-                            }
-                        }
-                        /** RVN END */
-                    }
-
-                    if (fAddressIndex && addressType > 0) {
-                        /** RVN START */
-                        if (isAsset) {
-//                            std::cout << "ConnectBlock(): pushing assets onto addressIndex: " << "1" << ", " << hashBytes.GetHex() << ", " << assetName << ", " << pindex->nHeight
-//                                      << ", " << i << ", " << txhash.GetHex() << ", " << j << ", " << "true" << ", " << assetAmount * -1 << std::endl;
-
-                            // record spending activity
-                            addressIndex.push_back(std::make_pair(CAddressIndexKey(addressType, hashBytes, assetName, pindex->nHeight, i, txhash, j, true), assetAmount * -1));
-
-                            // remove address from unspent index
-                            addressUnspentIndex.push_back(std::make_pair(CAddressUnspentKey(addressType, hashBytes, assetName, input.prevout.hash, input.prevout.n), CAddressUnspentValue()));
-                        /** RVN END */
-                        } else {
-                            // record spending activity
-                            addressIndex.push_back(std::make_pair(CAddressIndexKey(addressType, hashBytes, pindex->nHeight, i, txhash, j, true), prevout.nValue * -1));
-
-                            // remove address from unspent index
-                            addressUnspentIndex.push_back(std::make_pair(CAddressUnspentKey(addressType, hashBytes, input.prevout.hash, input.prevout.n), CAddressUnspentValue()));
-                        }
-                    }
-                    /** RVN END */
-
-                    if (fSpentIndex) {
-                        // add the spent index to determine the txid and input that spent an output
-                        // and to find the amount and address from an input
-                        spentIndex.push_back(std::make_pair(CSpentIndexKey(input.prevout.hash, input.prevout.n), CSpentIndexValue(txhash, j, pindex->nHeight, prevout.nValue, addressType, hashBytes)));
-                    }
-                }
-
-            }
         }
 
         // GetTransactionSigOpCost counts 3 types of sigops:
@@ -2643,7 +3215,6 @@ static bool ConnectBlock(const CBlock& block, CValidationState& state, CBlockInd
             return state.DoS(100, error("ConnectBlock(): too many sigops"),
                              REJECT_INVALID, "bad-blk-sigops");
 
-        txdata.emplace_back(tx);
         if (!tx.IsCoinBase())
         {
             std::vector<CScriptCheck> vChecks;
@@ -2654,65 +3225,6 @@ static bool ConnectBlock(const CBlock& block, CValidationState& state, CBlockInd
             control.Add(vChecks);
         }
 
-        if (fAddressIndex) {
-            for (unsigned int k = 0; k < tx.vout.size(); k++) {
-                const CTxOut &out = tx.vout[k];
-
-                if (out.scriptPubKey.IsPayToScriptHash()) {
-                    std::vector<unsigned char> hashBytes(out.scriptPubKey.begin()+2, out.scriptPubKey.begin()+22);
-
-                    // record receiving activity
-                    addressIndex.push_back(std::make_pair(CAddressIndexKey(2, uint160(hashBytes), pindex->nHeight, i, txhash, k, false), out.nValue));
-
-                    // record unspent output
-                    addressUnspentIndex.push_back(std::make_pair(CAddressUnspentKey(2, uint160(hashBytes), txhash, k), CAddressUnspentValue(out.nValue, out.scriptPubKey, pindex->nHeight)));
-
-                } else if (out.scriptPubKey.IsPayToPublicKeyHash()) {
-                    std::vector<unsigned char> hashBytes(out.scriptPubKey.begin()+3, out.scriptPubKey.begin()+23);
-
-                    // record receiving activity
-                    addressIndex.push_back(std::make_pair(CAddressIndexKey(1, uint160(hashBytes), pindex->nHeight, i, txhash, k, false), out.nValue));
-
-                    // record unspent output
-                    addressUnspentIndex.push_back(std::make_pair(CAddressUnspentKey(1, uint160(hashBytes), txhash, k), CAddressUnspentValue(out.nValue, out.scriptPubKey, pindex->nHeight)));
-
-                } else if (out.scriptPubKey.IsPayToPublicKey()) {
-                    uint160 hashBytes(Hash160(out.scriptPubKey.begin() + 1, out.scriptPubKey.end() - 1));
-                    addressIndex.push_back(
-                            std::make_pair(CAddressIndexKey(1, hashBytes, pindex->nHeight, i, txhash, k, false),
-                                           out.nValue));
-                    addressUnspentIndex.push_back(std::make_pair(CAddressUnspentKey(1, hashBytes, txhash, k),
-                                                                 CAddressUnspentValue(out.nValue, out.scriptPubKey,
-                                                                                      pindex->nHeight)));
-                } else {
-                    /** RVN START */
-                    if (AreAssetsDeployed()) {
-                        std::string assetName;
-                        CAmount assetAmount;
-                        uint160 hashBytes;
-
-                        if (ParseAssetScript(out.scriptPubKey, hashBytes, assetName, assetAmount)) {
-//                            std::cout << "ConnectBlock(): pushing assets onto addressIndex: " << "1" << ", " << hashBytes.GetHex() << ", " << assetName << ", " << pindex->nHeight
-//                                      << ", " << i << ", " << txhash.GetHex() << ", " << k << ", " << "true" << ", " << assetAmount << std::endl;
-
-                            // record receiving activity
-                            addressIndex.push_back(std::make_pair(
-                                    CAddressIndexKey(1, hashBytes, assetName, pindex->nHeight, i, txhash, k, false),
-                                    assetAmount));
-
-                            // record unspent output
-                            addressUnspentIndex.push_back(
-                                    std::make_pair(CAddressUnspentKey(1, hashBytes, assetName, txhash, k),
-                                                   CAddressUnspentValue(assetAmount, out.scriptPubKey,
-                                                                        pindex->nHeight)));
-                        }
-                    } else {
-                        continue;
-                    }
-                    /** RVN END */
-                }
-            }
-        }
 
         CTxUndo undoDummy;
         if (i > 0) {
@@ -2724,7 +3236,7 @@ static bool ConnectBlock(const CBlock& block, CValidationState& state, CBlockInd
         std::pair<std::string, CBlockAssetUndo>* undoAssetData = &undoPair;
         /** RVN END */
 
-        UpdateCoins(tx, view, i == 0 ? undoDummy : blockundo.vtxundo.back(), pindex->nHeight, block.GetHash(), assetsCache, undoAssetData);
+        UpdateCoins(tx, view, i == 0 ? undoDummy : blockundo.vtxundo.back(), pindex->nHeight, block.GetHash(), assetsCache, undoAssetData, vAssetOutputs.empty() ? nullptr : &vAssetOutputs[i]);
 
         /** RVN START */
         if (!undoAssetData->first.empty()) {
@@ -2733,9 +3245,12 @@ static bool ConnectBlock(const CBlock& block, CValidationState& state, CBlockInd
         /** RVN END */
 
         vPos.push_back(std::make_pair(tx.GetHash(), pos));
-        pos.nTxOffset += ::GetSerializeSize(tx, SER_DISK, CLIENT_VERSION);
+        pos.nTxOffset += tx.GetTotalSize();
     }
     int64_t nTime3 = GetTimeMicros(); nTimeConnect += nTime3 - nTime2;
+    RecordValidationTime(ValidationPhase::CONNECT_TXS, nTime3 - nTime2);
+    if (AreAssetsDeployed())
+        RecordValidationTime(ValidationPhase::ASSET_CHECKS, nTimeAssetChecks);
     LogPrint(BCLog::BENCH, "      - Connect %u transactions: %.2fms (%.3fms/tx, %.3fms/txin) [%.2fs (%.2fms/blk)]\n", (unsigned)block.vtx.size(), MILLI * (nTime3 - nTime2), MILLI * (nTime3 - nTime2) / block.vtx.size(), nInputs <= 1 ? 0 : MILLI * (nTime3 - nTime2) / (nInputs-1), nTimeConnect * MICRO, nTimeConnect * MILLI / nBlocksTotal);
 
     CAmount blockReward = nFees + GetBlockSubsidy(pindex->nHeight, chainparams.GetConsensus());
@@ -2748,6 +3263,7 @@ static bool ConnectBlock(const CBlock& block, CValidationState& state, CBlockInd
     if (!control.Wait())
         return state.DoS(100, error("%s: CheckQueue failed", __func__), REJECT_INVALID, "block-validation-failed");
     int64_t nTime4 = GetTimeMicros(); nTimeVerify += nTime4 - nTime2;
+    RecordValidationTime(ValidationPhase::SCRIPT_VERIFY, nTime4 - nTime2);
     LogPrint(BCLog::BENCH, "    - Verify %u txins: %.2fms (%.3fms/txin) [%.2fs (%.2fms/blk)]\n", nInputs - 1, MILLI * (nTime4 - nTime2), nInputs <= 1 ? 0 : MILLI * (nTime4 - nTime2) / (nInputs-1), nTimeVerify * MICRO, nTimeVerify * MILLI / nBlocksTotal);
 
     if (fJustCheck)
@@ -2758,9 +3274,10 @@ static bool ConnectBlock(const CBlock& block, CValidationState& state, CBlockInd
     {
         if (pindex->GetUndoPos().IsNull()) {
             CDiskBlockPos _pos;
-            if (!FindUndoPos(state, pindex->nFile, _pos, ::GetSerializeSize(blockundo, SER_DISK, CLIENT_VERSION) + 40))
+            const CDiskRecordData record(blockundo);
+            if (!FindUndoPos(state, pindex->nFile, _pos, record.size() + 40))
                 return error("ConnectBlock(): FindUndoPos failed");
-            if (!UndoWriteToDisk(blockundo, _pos, pindex->pprev->GetBlockHash(), chainparams.MessageStart()))
+            if (!UndoWriteToDisk(blockundo, record, _pos, pindex->pprev->GetBlockHash(), chainparams.MessageStart()))
                 return AbortNode(state, "Failed to write undo data");
 
             // update nUndoPos in block index
@@ -2781,19 +3298,25 @@ static bool ConnectBlock(const CBlock& block, CValidationState& state, CBlockInd
         if (!pblocktree->WriteTxIndex(vPos))
             return AbortNode(state, "Failed to write transaction index");
 
-    if (!ignoreAddressIndex && fAddressIndex) {
-        if (!pblocktree->WriteAddressIndex(addressIndex)) {
-            return AbortNode(state, "Failed to write address index");
-        }
+    if (!ignoreAddressIndex && (fAddressIndex || fSpentIndex)) {
+        // The same entries a background index build makes (see indexbuilder.h)
+        CIndexBuildBatch indexEntries;
+        AppendBlockIndexEntries(block, blockundo, pindex->nHeight, AreAssetsDeployed(), fAddressIndex, fSpentIndex, indexEntries);
 
-        if (!pblocktree->UpdateAddressUnspentIndex(addressUnspentIndex)) {
-            return AbortNode(state, "Failed to write address unspent index");
+        if (fAddressIndex) {
+            if (!pblocktree->WriteAddressIndex(indexEntries.vAddressIndex)) {
+                return AbortNode(state, "Failed to write address index");
+            }
+
+            if (!pblocktree->UpdateAddressUnspentIndex(indexEntries.vAddressUnspent)) {
+                return AbortNode(state, "Failed to write address unspent index");
+            }
         }
-    }
 
-    if (!ignoreAddressIndex && fSpentIndex)
-        if (!pblocktree->UpdateSpentIndex(spentIndex))
-            return AbortNode(state, "Failed to write transaction index");
+        if (fSpentIndex)
+            if (!pblocktree->UpdateSpentIndex(indexEntries.vSpentIndex))
+                return AbortNode(state, "Failed to write transaction index");
+    }
 
     if (!ignoreAddressIndex && fTimestampIndex) {
         unsigned int logicalTS = pindex->nTime;
@@ -2855,6 +3378,7 @@ static bool ConnectBlock(const CBlock& block, CValidationState& state, CBlockInd
     view.SetBestBlock(pindex->GetBlockHash());
 
     int64_t nTime5 = GetTimeMicros(); nTimeIndex += nTime5 - nTime4;
+    RecordValidationTime(ValidationPhase::INDEX_WRITES, nTime5 - nTime4);
     LogPrint(BCLog::BENCH, "    - Index writing: %.2fms [%.2fs (%.2fms/blk)]\n", MILLI * (nTime5 - nTime4), nTimeIndex * MICRO, nTimeIndex * MILLI / nBlocksTotal);
 
     int64_t nTime6 = GetTimeMicros(); nTimeCallbacks += nTime6 - nTime5;
@@ -2863,12 +3387,80 @@ static bool ConnectBlock(const CBlock& block, CValidationState& state, CBlockInd
     return true;
 }
 
+/** The databases that FlushStateToDisk brings to the coins database's best block, with their names for errors */
+static std::vector<std::pair<CDBWrapper*, std::string> > GetChainstateSideDatabases()
+{
+    std::vector<std::pair<CDBWrapper*, std::string> > vDatabases;
+    if (passetsdb)
+        vDatabases.emplace_back(passetsdb, "asset");
+    if (prestricteddb)
+        vDatabases.emplace_back(prestricteddb, "restricted asset");
+    return vDatabases;
+}
+
+/**
+ * Queues everything written to the chainstate side databases while in scope,
+ * so that each database takes a flush in one write that also records the
+ * block it was flushed at. Whatever was not committed is dropped.
+ */
+class CChainstateSideFlush
+{
+    std::vector<std::pair<CDBWrapper*, std::string> > vDatabases;
+
+public:
+    CChainstateSideFlush() : vDatabases(GetChainstateSideDatabases())
+    {
+        for (const auto& db : vDatabases)
+            db.first->BeginDeferred();
+    }
+
+    ~CChainstateSideFlush()
+    {
+        for (const auto& db : vDatabases)
+            db.first->DiscardDeferred();
+    }
+
+    bool Commit(const uint256& hashBlock)
+    {
+        for (const auto& db : vDatabases) {
+            db.first->WriteFlushMarker(hashBlock);
+            if (!db.first->CommitDeferred())
+                return false;
+        }
+        return true;
+    }
+};
+
+bool CheckChainstateSideDatabases()
+{
+    LOCK(cs_main);
+    const uint256 hashCoins = pcoinsTip->GetBestBlock();
+    for (const auto& db : GetChainstateSideDatabases()) {
+        // Databases last written before the markers existed have none
+        uint256 hashFlushed;
+        if (db.first->ReadFlushMarker(hashFlushed) && hashFlushed != hashCoins)
+            return error("%s: %s database was flushed at block %s, the coins database is at %s", __func__, db.second, hashFlushed.ToString(), hashCoins.ToString());
+    }
+    return true;
+}
+
 /**
  * Update the on-disk chain state.
  * The caches and indexes are flushed depending on the mode we're called with
  * if they're too large, if it's been a while since the last write,
  * or always and in all cases if we're in prune mode and are deleting files.
  */
+/** Let asset RPCs see the changes of a block flushed into passets before they reach the assets db */
+static std::shared_ptr<const CAssetsReadDelta> PublishAssetsReadDelta(const CAssetsCache& assetCache)
+{
+    if (!passetsdb)
+        return nullptr;
+    std::shared_ptr<CAssetsReadDelta> delta = std::make_shared<CAssetsReadDelta>();
+    assetCache.GetReadDelta(*delta);
+    passetsdb->PublishReadDelta(delta);
+    return delta;
+}
+
 bool static FlushStateToDisk(const CChainParams& chainparams, CValidationState &state, FlushStateMode mode, int nManualPruneHeight) {
     int64_t nMempoolUsage = mempool.DynamicMemoryUsage();
     LOCK(cs_main);
@@ -2881,6 +3473,8 @@ bool static FlushStateToDisk(const CChainParams& chainparams, CValidationState &
     int64_t nNow = 0;
 
     try {
+    if (pcoinsbuffer && pcoinsbuffer->WriteFailed())
+        return AbortNode(state, "Failed to write to coin database");
     {
         LOCK(cs_LastBlockFile);
         if (fPruneMode && (fCheckForPruning || nManualPruneHeight > 0) && !fReindex) {
@@ -2930,7 +3524,10 @@ bool static FlushStateToDisk(const CChainParams& chainparams, CValidationState &
         }
 
         int64_t nMempoolSizeMax = gArgs.GetArg("-maxmempool", DEFAULT_MAX_MEMPOOL_SIZE) * 1000000;
+        // Coins still being written in the background count until they are on disk
         int64_t cacheSize = pcoinsTip->DynamicMemoryUsage() + assetDynamicSize + assetDirtyCacheSize + messageCacheSize;
+        if (pcoinsbuffer)
+            cacheSize += pcoinsbuffer->DynamicMemoryUsage();
         int64_t nTotalSpace = nCoinCacheUsage + std::max<int64_t>(nMempoolSizeMax - nMempoolUsage, 0);
         // The cache is large and we're within 10% and 10 MiB of the limit, but we have time now (not in the middle of a block processing).
         bool fCacheLarge = mode == FLUSH_STATE_PERIODIC && cacheSize > std::max((9 * nTotalSpace) / 10, nTotalSpace - MAX_BLOCK_COINSDB_USAGE * 1024 * 1024);
@@ -2991,24 +3588,57 @@ bool static FlushStateToDisk(const CChainParams& chainparams, CValidationState &
             if (!CheckDiskSpace((48 * 2 * 2 * pcoinsTip->GetCacheSize()) + assetDirtyCacheSize * 2)) /** RVN START */ /** RVN END */
                 return state.Error("out of disk space");
 
+            // Write the coins on a background thread unless everything has to be on disk
+            // when we return. The other databases are written right after the coins
+            // database is marked as in transition, so this is only done when ReplayBlocks
+            // can complete an interrupted write by rolling forward: rolling back across a
+            // reorg would undo those databases' changes a second time.
+            if (pcoinsbuffer) {
+                if (!pcoinsbuffer->WaitForWrite())
+                    return AbortNode(state, "Failed to write to coin database");
+                bool fBackground = mode != FLUSH_STATE_ALWAYS && gArgs.GetBoolArg("-backgroundflush", DEFAULT_BACKGROUND_FLUSH);
+                if (fBackground) {
+                    const uint256 hashOnDisk = pcoinsdbview->GetBestBlock();
+                    BlockMap::const_iterator it = mapBlockIndex.find(hashOnDisk);
+                    fBackground = hashOnDisk.IsNull() || (it != mapBlockIndex.end() && chainActive.Contains(it->second));
+                }
+                pcoinsbuffer->SetBackground(fBackground);
+            }
+
             // Flush the chainstate (which may refer to block index entries).
             if (!pcoinsTip->Flush())
                 return AbortNode(state, "Failed to write to coin database");
 
             /** RVN START */
-            // Flush the assetstate
-            if (AreAssetsDeployed()) {
-                // Flush the assetstate
-                auto currentActiveAssetCache = GetCurrentAssetCache();
-                if (currentActiveAssetCache) {
-                    if (!currentActiveAssetCache->DumpCacheToDatabase())
-                        return AbortNode(state, "Failed to write to asset database");
+            // Each of the asset databases takes the flush in one write, marked with the
+            // block it brings the database to, so that startup can tell whether a crash
+            // left any of them behind the coins database
+            {
+                CChainstateSideFlush sideFlush;
+                bool fDumpedAssets = false;
+                if (AreAssetsDeployed()) {
+                    // Flush the assetstate
+                    auto currentActiveAssetCache = GetCurrentAssetCache();
+                    if (currentActiveAssetCache) {
+                        if (!currentActiveAssetCache->DumpCacheToDatabase())
+                            return AbortNode(state, "Failed to write to asset database");
+                        fDumpedAssets = true;
+                    }
                 }
+
+                // Write the reissue mempool data to database
+                if (passetsdb)
+                    passetsdb->WriteReissuedMempoolState();
+
+                if (!sideFlush.Commit(pcoinsTip->GetBestBlock()))
+                    return AbortNode(state, "Failed to write to asset database");
+                if (fDumpedAssets && passetsdb)
+                    passetsdb->PublishReadSnapshot();
             }
 
-            // Write the reissue mempool data to database
-            if (passetsdb)
-                passetsdb->WriteReissuedMempoolState();
+            // Commit the order book changes made since the last flush in one batch
+            if (persistentOrderBook && !persistentOrderBook->Flush())
+                return AbortNode(state, "Failed to write to order book database");
 
             if (fMessaging) {
                 if (pmessagedb) {
@@ -3052,6 +3682,48 @@ void PruneAndFlush() {
     FlushStateToDisk(chainparams, state, FLUSH_STATE_NONE);
 }
 
+void PruneBlockStateData()
+{
+    // While reindexing or importing, the block index doesn't know every block yet
+    if (!fPruneMode || !fHavePruned || fReindex || fImporting)
+        return;
+
+    size_t nAssetUndoErased = 0;
+    size_t nListsErased = 0;
+    int nKeepHeight;
+    {
+        LOCK(cs_main);
+        if (chainActive.Tip() == nullptr)
+            return;
+
+        // A block without undo data can't be disconnected, and neither can
+        // anything below it, so the asset undo data of such blocks and the
+        // masternode lists below the lowest block that still has it are dead
+        const CBlockIndex* pindexKeep = chainActive.Tip();
+        while (pindexKeep->pprev && (pindexKeep->pprev->nStatus & BLOCK_HAVE_UNDO))
+            pindexKeep = pindexKeep->pprev;
+        nKeepHeight = pindexKeep->nHeight;
+
+        if (passetsdb) {
+            nAssetUndoErased = passetsdb->EraseBlockUndoAssetData([](const uint256& hash) {
+                BlockMap::const_iterator mi = mapBlockIndex.find(hash);
+                return mi == mapBlockIndex.end() || !(mi->second->nStatus & BLOCK_HAVE_UNDO);
+            }, MAX_BLOCK_STATE_PRUNE_BATCH);
+        }
+        if (deterministicMNManager)
+            nListsErased = deterministicMNManager->EraseListsBelow(nKeepHeight, MAX_BLOCK_STATE_PRUNE_BATCH);
+    }
+
+    // Compacting drops the erased records from the files, which doesn't need cs_main
+    if (nAssetUndoErased)
+        passetsdb->CompactBlockUndoAssetData();
+    if (nListsErased)
+        deterministicMNManager->CompactLists();
+    if (nAssetUndoErased || nListsErased)
+        LogPrint(BCLog::PRUNE, "Prune: erased the asset undo data of %u blocks and %u masternode lists below height %d\n",
+                 nAssetUndoErased, nListsErased, nKeepHeight);
+}
+
 static void DoWarning(const std::string& strWarning)
 {
     static bool fWarned = false;
@@ -3139,6 +3811,7 @@ bool static DisconnectTip(CValidationState& state, const CChainParams& chainpara
         return error("DisconnectTip() : Failed to read block");
     // Apply the block atomically to the chain state.
     int64_t nStart = GetTimeMicros();
+    std::vector<CAssetNotification> vAssetNotifications;
     {
         CCoinsViewCache view(pcoinsTip);
         CAssetsCache assetCache;
@@ -3151,7 +3824,12 @@ bool static DisconnectTip(CValidationState& state, const CChainParams& chainpara
 
         bool assetsFlushed = assetCache.Flush();
         assert(assetsFlushed);
+        PublishAssetsReadDelta(assetCache);
+        assetCache.GetNotifications(pindexDelete->nHeight, false, vAssetNotifications);
+        if (pAssetSnapshotDb)
+            pAssetSnapshotDb->DisconnectBlockHolderDeltas(pindexDelete->nHeight);
     }
+    RecordValidationTime(ValidationPhase::DISCONNECT_TIP, GetTimeMicros() - nStart);
     LogPrint(BCLog::BENCH, "- Disconnect block: %.2fms\n", (GetTimeMicros() - nStart) * MILLI);
     // Write the chain state to disk, if necessary.
     if (!FlushStateToDisk(chainparams, state, FLUSH_STATE_IF_NEEDED))
@@ -3175,6 +3853,8 @@ bool static DisconnectTip(CValidationState& state, const CChainParams& chainpara
     // Let wallets know transactions went from 1-confirmed to
     // 0-confirmed or conflicted:
     GetMainSignals().BlockDisconnected(pblock);
+    if (!vAssetNotifications.empty())
+        GetMainSignals().AssetsUpdated(vAssetNotifications);
     return true;
 }
 
@@ -3274,6 +3954,8 @@ bool static ConnectTip(CValidationState& state, const CChainParams& chainparams,
     const CBlock& blockConnecting = *pthisBlock;
     // Apply the block atomically to the chain state.
     int64_t nTime2 = GetTimeMicros(); nTimeReadFromDisk += nTime2 - nTime1;
+    if (!pblock)
+        RecordValidationTime(ValidationPhase::LOAD_BLOCK, nTime2 - nTime1);
     int64_t nTime3;
     int64_t nTime4;
     int64_t nTimeAssetsFlush;
@@ -3282,8 +3964,12 @@ bool static ConnectTip(CValidationState& state, const CChainParams& chainparams,
     /** RVN START */
     // Initialize sets used from removing asset entries from the mempool
     ConnectedBlockAssetData assetDataFromBlock;
+    std::vector<CAssetNotification> vAssetNotifications;
     /** RVN END */
 
+    // Hand the inputs read ahead since the block arrived to the tip
+    g_blockPrefetcher.Apply(blockConnecting.GetHash());
+
     {
         CCoinsViewCache view(pcoinsTip);
         /** RVN START */
@@ -3304,6 +3990,7 @@ bool static ConnectTip(CValidationState& state, const CChainParams& chainparams,
             return error("ConnectTip(): ConnectBlock %s failed", pindexNew->GetBlockHash().ToString());
         }
         int64_t nTimeConnectDone = GetTimeMicros();
+        RecordValidationTime(ValidationPhase::CONNECT_BLOCK, nTimeConnectDone - nTimeConnectStart);
         LogPrint(BCLog::BENCH, "  - Connect Block only time: %.2fms [%.2fs (%.2fms/blk)]\n", (nTimeConnectDone - nTimeConnectStart) * MILLI, nTimeConnectTotal * MICRO, nTimeConnectTotal * MILLI / nBlocksTotal);
 
         int64_t nTimeAssetsStart = GetTimeMicros();
@@ -3321,6 +4008,7 @@ bool static ConnectTip(CValidationState& state, const CChainParams& chainparams,
             }
         }
         int64_t nTimeAssetsEnd = GetTimeMicros(); nTimeAssetTasks += nTimeAssetsEnd - nTimeAssetsStart;
+        RecordValidationTime(ValidationPhase::ASSET_TASKS, nTimeAssetsEnd - nTimeAssetsStart);
         LogPrint(BCLog::BENCH, "  - Compute Asset Tasks total: %.2fms [%.2fs (%.2fms/blk)]\n", (nTimeAssetsEnd - nTimeAssetsStart) * MILLI, nTimeAssetsEnd * MICRO, nTimeAssetsEnd * MILLI / nBlocksTotal);
         /** RVN END */
 
@@ -3329,13 +4017,32 @@ bool static ConnectTip(CValidationState& state, const CChainParams& chainparams,
         bool flushed = view.Flush();
         assert(flushed);
         nTime4 = GetTimeMicros(); nTimeFlush += nTime4 - nTime3;
+        RecordValidationTime(ValidationPhase::COINS_FLUSH, nTime4 - nTime3);
         LogPrint(BCLog::BENCH, "  - Flush RVN: %.2fms [%.2fs (%.2fms/blk)]\n", (nTime4 - nTime3) * MILLI, nTimeFlush * MICRO, nTimeFlush * MILLI / nBlocksTotal);
 
         /** RVN START */
         nTimeAssetsFlush = GetTimeMicros();
         bool assetFlushed = assetCache.Flush();
         assert(assetFlushed);
+        std::shared_ptr<const CAssetsReadDelta> assetsDelta = PublishAssetsReadDelta(assetCache);
+        assetCache.GetNotifications(pindexNew->nHeight, true, vAssetNotifications);
+        // Ownership snapshots are built from the holder balances each block changed,
+        // and the ones requested at this height are taken in the same write
+        if (pAssetSnapshotDb && passetsdb) {
+            std::vector<std::string> vSnapshotAssets;
+            std::set<CSnapshotRequestDBEntry> assetsToSnapshot;
+            if (pSnapshotRequestDb && pSnapshotRequestDb->RetrieveSnapshotRequestsForHeight("", pindexNew->nHeight, assetsToSnapshot)) {
+                for (auto const & assetEntry : assetsToSnapshot)
+                    vSnapshotAssets.push_back(assetEntry.assetName);
+            } else if (pSnapshotRequestDb) {
+                LogPrint(BCLog::REWARDS, "ConnectTip: Failed to load payable Snapshot Requests at height %d!\n", pindexNew->nHeight);
+            }
+            static const std::map<std::pair<std::string, CAddressKey>, CAmount> mapNoDeltas;
+            pAssetSnapshotDb->ConnectBlockSnapshots(pindexNew->nHeight, assetsDelta ? assetsDelta->mapAssetAddressAmount : mapNoDeltas,
+                                                    vSnapshotAssets, *passetsdb->GetReadView());
+        }
         int64_t nTimeAssetFlushFinished = GetTimeMicros(); nTimeAssetFlush += nTimeAssetFlushFinished - nTimeAssetsFlush;
+        RecordValidationTime(ValidationPhase::ASSET_FLUSH, nTimeAssetFlushFinished - nTimeAssetsFlush);
         LogPrint(BCLog::BENCH, "  - Flush Assets: %.2fms [%.2fs (%.2fms/blk)]\n", (nTimeAssetFlushFinished - nTimeAssetsFlush) * MILLI, nTimeAssetFlush * MICRO, nTimeAssetFlush * MILLI / nBlocksTotal);
         /** RVN END */
     }
@@ -3344,6 +4051,7 @@ bool static ConnectTip(CValidationState& state, const CChainParams& chainparams,
     if (!FlushStateToDisk(chainparams, state, FLUSH_STATE_IF_NEEDED))
         return false;
     int64_t nTime5 = GetTimeMicros(); nTimeChainState += nTime5 - nTime4;
+    RecordValidationTime(ValidationPhase::CHAINSTATE_WRITE, nTime5 - nTime4);
     LogPrint(BCLog::BENCH, "  - Writing chainstate: %.2fms [%.2fs (%.2fms/blk)]\n", (nTime5 - nTime4) * MILLI, nTimeChainState * MICRO, nTimeChainState * MILLI / nBlocksTotal);
     // Remove conflicting transactions from the mempool.;
     mempool.removeForBlock(blockConnecting.vtx, pindexNew->nHeight, assetDataFromBlock);
@@ -3352,33 +4060,16 @@ bool static ConnectTip(CValidationState& state, const CChainParams& chainparams,
     UpdateTip(pindexNew, chainparams);
 
     int64_t nTime6 = GetTimeMicros(); nTimePostConnect += nTime6 - nTime5; nTimeTotal += nTime6 - nTime1;
+    RecordValidationTime(ValidationPhase::POST_CONNECT, nTime6 - nTime5);
+    RecordValidationTime(ValidationPhase::CONNECT_TIP, nTime6 - nTime1);
     LogPrint(BCLog::BENCH, "  - Connect postprocess: %.2fms [%.2fs (%.2fms/blk)]\n", (nTime6 - nTime5) * MILLI, nTimePostConnect * MICRO, nTimePostConnect * MILLI / nBlocksTotal);
     LogPrint(BCLog::BENCH, "- Connect block: %.2fms [%.2fs (%.2fms/blk)]\n", (nTime6 - nTime1) * MILLI, nTimeTotal * MICRO, nTimeTotal * MILLI / nBlocksTotal);
 
     connectTrace.BlockConnected(pindexNew, std::move(pthisBlock));
+    if (!vAssetNotifications.empty())
+        GetMainSignals().AssetsUpdated(vAssetNotifications);
 
     /** RVN START */
-
-    //  Determine if the new block height has any pending snapshot requests,
-    //      and if so, capture a snapshot of the relevant target assets.
-    if (pSnapshotRequestDb != nullptr) {
-        //  Retrieve the scheduled snapshot requests
-        std::set<CSnapshotRequestDBEntry> assetsToSnapshot;
-        if (pSnapshotRequestDb->RetrieveSnapshotRequestsForHeight("", pindexNew->nHeight, assetsToSnapshot)) {
-            //  Loop through them
-            for (auto const & assetEntry : assetsToSnapshot) {
-                //  Add a snapshot entry for the target asset ownership
-                if (!pAssetSnapshotDb->AddAssetOwnershipSnapshot(assetEntry.assetName, pindexNew->nHeight)) {
-                   LogPrint(BCLog::REWARDS, "ConnectTip: Failed to snapshot owners for '%s' at height %d!\n",
-                       assetEntry.assetName.c_str(), pindexNew->nHeight);
-                }
-            }
-        }
-        else {
-            LogPrint(BCLog::REWARDS, "ConnectTip: Failed to load payable Snapshot Requests at height %d!\n", pindexNew->nHeight);
-        }
-    }
-
 #ifdef ENABLE_WALLET
     if (vpwallets.size()) {
         CheckRewardDistributions(vpwallets[0]);
@@ -3772,16 +4463,17 @@ bool ResetBlockFailureFlags(CBlockIndex *pindex) {
     return true;
 }
 
-static CBlockIndex* AddToBlockIndex(const CBlockHeader& block)
+static CBlockIndex* AddToBlockIndex(const CBlockHeader& block, const uint256* phash = nullptr)
 {
     // Check for duplicate
-    uint256 hash = block.GetHash();
+    uint256 hash = phash ? *phash : block.GetHash();
     BlockMap::iterator it = mapBlockIndex.find(hash);
     if (it != mapBlockIndex.end())
         return it->second;
 
     // Construct new block index object
-    CBlockIndex* pindexNew = new CBlockIndex(block);
+    CBlockIndex* pindexNew = blockIndexArena.New(block);
+    pindexNew->SetColdData(CBlockIndexColdData(block));
     // We assign the sequence id to blocks only when the full data is available,
     // to avoid miners withholding blocks but broadcasting headers, to get a
     // competitive advantage.
@@ -3943,27 +4635,28 @@ static bool FindUndoPos(CValidationState &state, int nFile, CDiskBlockPos &pos,
     return true;
 }
 
-static bool CheckBlockHeader(const CBlockHeader& block, CValidationState& state, const Consensus::Params& consensusParams, bool fCheckPOW = true)
+/**
+ * Proof-of-work part of CheckBlockHeader. Takes the last checkpoint height
+ * (-1 if none) instead of looking it up, so it is safe to run without cs_main.
+ */
+static bool CheckBlockHeaderPoW(const CBlockHeader& block, CValidationState& state, const Consensus::Params& consensusParams, int nCheckpointHeight)
 {
     // If we are checking a KAWPOW block below a know checkpoint height. We can validate the proof of work using the mix_hash
-    if (fCheckPOW && block.nTime >= nKAWPOWActivationTime) {
-        CBlockIndex* pcheckpoint = Checkpoints::GetLastCheckpoint(GetParams().Checkpoints());
-        if (fCheckPOW && pcheckpoint && block.nHeight <= (uint32_t)pcheckpoint->nHeight) {
-           if (!CheckProofOfWork(block.GetHash(), block.nBits, consensusParams)) {
-               return state.DoS(50, false, REJECT_INVALID, "high-hash", false, "proof of work failed with mix_hash only check");
-           }
-
-           return true;
+    if (block.nTime >= nKAWPOWActivationTime && nCheckpointHeight >= 0 && block.nHeight <= (uint32_t)nCheckpointHeight) {
+        if (!CheckProofOfWork(block.GetHash(), block.nBits, consensusParams)) {
+            return state.DoS(50, false, REJECT_INVALID, "high-hash", false, "proof of work failed with mix_hash only check");
         }
+
+        return true;
     }
 
     uint256 mix_hash;
     // Check proof of work matches claimed amount
-    if (fCheckPOW && !CheckProofOfWork(block.GetHashFull(mix_hash), block.nBits, consensusParams)) {
+    if (!CheckProofOfWork(block.GetHashFull(mix_hash), block.nBits, consensusParams)) {
         return state.DoS(50, false, REJECT_INVALID, "high-hash", false, "proof of work failed");
     }
 
-    if (fCheckPOW && block.nTime >= nKAWPOWActivationTime) {
+    if (block.nTime >= nKAWPOWActivationTime) {
         if (mix_hash != block.mix_hash) {
             return state.DoS(50, false, REJECT_INVALID, "invalid-mix-hash", false, "mix_hash validity failed");
         }
@@ -3972,6 +4665,118 @@ static bool CheckBlockHeader(const CBlockHeader& block, CValidationState& state,
     return true;
 }
 
+static int GetLastCheckpointHeight()
+{
+    CBlockIndex* pcheckpoint = Checkpoints::GetLastCheckpoint(GetParams().Checkpoints());
+    return pcheckpoint ? pcheckpoint->nHeight : -1;
+}
+
+static bool CheckBlockHeader(const CBlockHeader& block, CValidationState& state, const Consensus::Params& consensusParams, bool fCheckPOW = true)
+{
+    if (!fCheckPOW)
+        return true;
+
+    int nCheckpointHeight = block.nTime >= nKAWPOWActivationTime ? GetLastCheckpointHeight() : -1;
+    return CheckBlockHeaderPoW(block, state, consensusParams, nCheckpointHeight);
+}
+
+/**
+ * Closure representing one header to be hashed, or proof-of-work checked, on
+ * the header check queue. The result is written to the referenced
+ * CHeaderPreCheck, so the check itself always succeeds.
+ */
+class CHeaderPoWCheck
+{
+private:
+    const CBlockHeader* pheader;
+    CHeaderPreCheck* presult;
+    const Consensus::Params* pconsensusParams;
+    int nCheckpointHeight;
+    bool fCheckPOW;
+
+public:
+    CHeaderPoWCheck() : pheader(nullptr), presult(nullptr), pconsensusParams(nullptr), nCheckpointHeight(-1), fCheckPOW(false) {}
+    CHeaderPoWCheck(const CBlockHeader& headerIn, CHeaderPreCheck& resultIn, const Consensus::Params& consensusParamsIn, int nCheckpointHeightIn, bool fCheckPOWIn) :
+        pheader(&headerIn), presult(&resultIn), pconsensusParams(&consensusParamsIn), nCheckpointHeight(nCheckpointHeightIn), fCheckPOW(fCheckPOWIn) {}
+
+    bool operator()()
+    {
+        if (fCheckPOW) {
+            CValidationState state;
+            presult->fPoWValid = CheckBlockHeaderPoW(*pheader, state, *pconsensusParams, nCheckpointHeight);
+        } else {
+            presult->hash = pheader->GetHash();
+        }
+        return true;
+    }
+
+    void swap(CHeaderPoWCheck& check)
+    {
+        std::swap(pheader, check.pheader);
+        std::swap(presult, check.presult);
+        std::swap(pconsensusParams, check.pconsensusParams);
+        std::swap(nCheckpointHeight, check.nCheckpointHeight);
+        std::swap(fCheckPOW, check.fCheckPOW);
+    }
+};
+
+static CCheckQueue<CHeaderPoWCheck> headercheckqueue(16);
+
+void ThreadHeaderCheck() {
+    RenameThread("mynta-headerch");
+    headercheckqueue.Thread();
+}
+
+static void RunHeaderChecks(std::vector<CHeaderPoWCheck>& vChecks)
+{
+    if (nScriptCheckThreads && vChecks.size() > 1) {
+        CCheckQueueControl<CHeaderPoWCheck> control(&headercheckqueue);
+        control.Add(vChecks);
+        control.Wait();
+    } else {
+        for (CHeaderPoWCheck& check : vChecks) {
+            check();
+        }
+    }
+}
+
+std::vector<CHeaderPreCheck> HashBlockHeaders(const std::vector<CBlockHeader>& headers)
+{
+    std::vector<CHeaderPreCheck> vResults(headers.size());
+    std::vector<CHeaderPoWCheck> vChecks;
+    vChecks.reserve(headers.size());
+    for (size_t i = 0; i < headers.size(); i++) {
+        vChecks.emplace_back(headers[i], vResults[i], GetParams().GetConsensus(), -1, false);
+    }
+    RunHeaderChecks(vChecks);
+    return vResults;
+}
+
+void PreCheckBlockHeaders(const std::vector<CBlockHeader>& headers, std::vector<CHeaderPreCheck>& vPreChecks, const Consensus::Params& consensusParams)
+{
+    assert(vPreChecks.size() == headers.size());
+
+    // Headers we already have are not checked again by AcceptBlockHeader,
+    // so only spend proof-of-work time on the new ones
+    int nCheckpointHeight;
+    std::vector<size_t> vNew;
+    {
+        LOCK(cs_main);
+        nCheckpointHeight = GetLastCheckpointHeight();
+        for (size_t i = 0; i < headers.size(); i++) {
+            if (!mapBlockIndex.count(vPreChecks[i].hash))
+                vNew.push_back(i);
+        }
+    }
+
+    std::vector<CHeaderPoWCheck> vChecks;
+    vChecks.reserve(vNew.size());
+    for (size_t i : vNew) {
+        vChecks.emplace_back(headers[i], vPreChecks[i], consensusParams, nCheckpointHeight, true);
+    }
+    RunHeaderChecks(vChecks);
+}
+
 bool CheckBlock(const CBlock& block, CValidationState& state, const Consensus::Params& consensusParams, bool fCheckPOW, bool fCheckMerkleRoot, bool fDBCheck)
 {
     // These are checks that are independent of context.
@@ -4264,11 +5069,11 @@ static bool ContextualCheckBlock(const CBlock& block, CValidationState& state, c
     return true;
 }
 
-static bool AcceptBlockHeader(const CBlockHeader& block, CValidationState& state, const CChainParams& chainparams, CBlockIndex** ppindex)
+static bool AcceptBlockHeader(const CBlockHeader& block, CValidationState& state, const CChainParams& chainparams, CBlockIndex** ppindex, const CHeaderPreCheck* pPreCheck = nullptr)
 {
     AssertLockHeld(cs_main);
     // Check for duplicate
-    uint256 hash = block.GetHash();
+    uint256 hash = pPreCheck ? pPreCheck->hash : block.GetHash();
     BlockMap::iterator miSelf = mapBlockIndex.find(hash);
     CBlockIndex *pindex = nullptr;
     if (hash != chainparams.GetConsensus().hashGenesisBlock) {
@@ -4283,7 +5088,9 @@ static bool AcceptBlockHeader(const CBlockHeader& block, CValidationState& state
             return true;
         }
 
-        if (!CheckBlockHeader(block, state, chainparams.GetConsensus()))
+        // A header that failed the pre-check is checked again here, so the
+        // rejection is reported through state exactly as before
+        if ((!pPreCheck || !pPreCheck->fPoWValid) && !CheckBlockHeader(block, state, chainparams.GetConsensus()))
             return error("%s: Consensus::CheckBlockHeader: %s, %s", __func__, hash.ToString(), FormatStateMessage(state));
 
         // Get prev block index
@@ -4313,7 +5120,7 @@ static bool AcceptBlockHeader(const CBlockHeader& block, CValidationState& state
         }
     }
     if (pindex == nullptr)
-        pindex = AddToBlockIndex(block);
+        pindex = AddToBlockIndex(block, &hash);
 
     if (ppindex)
         *ppindex = pindex;
@@ -4324,14 +5131,16 @@ static bool AcceptBlockHeader(const CBlockHeader& block, CValidationState& state
 }
 
 // Exposed wrapper for AcceptBlockHeader
-bool ProcessNewBlockHeaders(const std::vector<CBlockHeader>& headers, CValidationState& state, const CChainParams& chainparams, const CBlockIndex** ppindex, CBlockHeader *first_invalid)
+bool ProcessNewBlockHeaders(const std::vector<CBlockHeader>& headers, CValidationState& state, const CChainParams& chainparams, const CBlockIndex** ppindex, CBlockHeader *first_invalid, const std::vector<CHeaderPreCheck>* pPreChecks)
 {
     if (first_invalid != nullptr) first_invalid->SetNull();
+    if (pPreChecks && pPreChecks->size() != headers.size()) pPreChecks = nullptr;
     {
         LOCK(cs_main);
-        for (const CBlockHeader& header : headers) {
+        for (size_t i = 0; i < headers.size(); i++) {
+            const CBlockHeader& header = headers[i];
             CBlockIndex *pindex = nullptr; // Use a temp pindex instead of ppindex to avoid a const_cast
-            if (!AcceptBlockHeader(header, state, chainparams, &pindex)) {
+            if (!AcceptBlockHeader(header, state, chainparams, &pindex, pPreChecks ? &(*pPreChecks)[i] : nullptr)) {
                 if (first_invalid) *first_invalid = header;
                 return false;
             }
@@ -4417,15 +5226,20 @@ static bool AcceptBlock(const std::shared_ptr<const CBlock>& pblock, CValidation
 
     // Write block to history file
     try {
-        unsigned int nBlockSize = ::GetSerializeSize(block, SER_DISK, CLIENT_VERSION);
         CDiskBlockPos blockPos;
-        if (dbp != nullptr)
+        if (dbp != nullptr) {
+            // Already in a block file; its serialized size is at least what it takes there
             blockPos = *dbp;
-        if (!FindBlockPos(state, blockPos, nBlockSize+8, nHeight, block.GetBlockTime(), dbp != nullptr))
-            return error("AcceptBlock(): FindBlockPos failed");
-        if (dbp == nullptr)
-            if (!WriteBlockToDisk(block, blockPos, chainparams.MessageStart()))
+            unsigned int nBlockSize = ::GetSerializeSize(block, SER_DISK, CLIENT_VERSION);
+            if (!FindBlockPos(state, blockPos, nBlockSize+8, nHeight, block.GetBlockTime(), true))
+                return error("AcceptBlock(): FindBlockPos failed");
+        } else {
+            const CDiskRecordData record(block);
+            if (!FindBlockPos(state, blockPos, record.size()+8, nHeight, block.GetBlockTime()))
+                return error("AcceptBlock(): FindBlockPos failed");
+            if (!WriteBlockToDisk(record, blockPos, chainparams.MessageStart()))
                 AbortNode(state, "Failed to write block");
+        }
         if (!ReceivedBlockTransactions(block, state, pindex, blockPos, chainparams.GetConsensus()))
             return error("AcceptBlock(): ReceivedBlockTransactions failed");
     } catch (const std::runtime_error& e) {
@@ -4449,11 +5263,19 @@ bool ProcessNewBlock(const CChainParams& chainparams, const std::shared_ptr<cons
         // belt-and-suspenders.
         bool ret = CheckBlock(*pblock, state, chainparams.GetConsensus(), true, true);
 
+        // Start reading the block's inputs while it waits for cs_main
+        if (ret)
+            g_blockPrefetcher.Prefetch(*pblock);
+
         LOCK(cs_main);
 
         if (ret) {
             // Store to disk
-            ret = AcceptBlock(pblock, state, chainparams, &pindex, fForceProcessing, nullptr, fNewBlock);
+            bool fNew = false;
+            ret = AcceptBlock(pblock, state, chainparams, &pindex, fForceProcessing, nullptr, &fNew);
+            if (fNewBlock) *fNewBlock = fNew;
+            if (!ret || !fNew)
+                g_blockPrefetcher.Discard(pblock->GetHash());
         }
 
         CheckBlockIndex(chainparams.GetConsensus());
@@ -4481,7 +5303,7 @@ bool TestBlockValidity(CValidationState& state, const CChainParams& chainparams,
     indexDummy.nHeight = pindexPrev->nHeight + 1;
 
     /** RVN START */
-    CAssetsCache assetCache = *GetCurrentAssetCache();
+    CAssetsCache assetCache(GetCurrentAssetCache());
     /** RVN END */
 
     // NOTE: CheckBlockHeader is called by CheckBlock
@@ -4553,6 +5375,8 @@ void UnlinkPrunedFiles(const std::set<int>& setFilesToPrune)
 {
     for (std::set<int>::iterator it = setFilesToPrune.begin(); it != setFilesToPrune.end(); ++it) {
         CDiskBlockPos pos(*it, 0);
+        blockFileMaps.Invalidate(GetBlockPosFilename(pos, "blk"));
+        blockFileMaps.Invalidate(GetBlockPosFilename(pos, "rev"));
         fs::remove(GetBlockPosFilename(pos, "blk"));
         fs::remove(GetBlockPosFilename(pos, "rev"));
         LogPrintf("Prune: %s deleted blk/rev (%05u)\n", __func__, *it);
@@ -4710,13 +5534,16 @@ CBlockIndex * InsertBlockIndex(uint256 hash)
         return (*mi).second;
 
     // Create new
-    CBlockIndex* pindexNew = new CBlockIndex();
+    CBlockIndex* pindexNew = blockIndexArena.New();
     mi = mapBlockIndex.insert(std::make_pair(hash, pindexNew)).first;
     pindexNew->phashBlock = &((*mi).first);
 
     return pindexNew;
 }
 
+/** Fewest blocks worth a thread of their own when computing block proofs at startup */
+static const size_t MIN_BLOCK_PROOFS_PER_THREAD = 10000;
+
 bool static LoadBlockIndexDB(const CChainParams& chainparams)
 {
     if (!pblocktree->LoadBlockIndexGuts(chainparams.GetConsensus(), InsertBlockIndex))
@@ -4733,10 +5560,34 @@ bool static LoadBlockIndexDB(const CChainParams& chainparams)
         vSortedByHeight.push_back(std::make_pair(pindex->nHeight, pindex));
     }
     sort(vSortedByHeight.begin(), vSortedByHeight.end());
-    for (const std::pair<int, CBlockIndex*>& item : vSortedByHeight)
+
+    // GetBlockProof divides 256 bit numbers, which adds up over millions of
+    // blocks, and depends on the block alone: spread it over all cores.
+    std::vector<arith_uint256> vBlockProof(vSortedByHeight.size());
+    auto proofRange = [&vSortedByHeight, &vBlockProof](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; i++)
+            vBlockProof[i] = GetBlockProof(*vSortedByHeight[i].second);
+    };
+    size_t nThreads = std::min<size_t>(std::max(1, GetNumCores()), vSortedByHeight.size() / MIN_BLOCK_PROOFS_PER_THREAD);
+    if (nThreads <= 1) {
+        proofRange(0, vSortedByHeight.size());
+    } else {
+        size_t nChunk = (vSortedByHeight.size() + nThreads - 1) / nThreads;
+        std::vector<std::thread> threads;
+        threads.reserve(nThreads - 1);
+        for (size_t t = 1; t < nThreads; t++) {
+            threads.emplace_back(proofRange, t * nChunk, std::min(vSortedByHeight.size(), (t + 1) * nChunk));
+        }
+        proofRange(0, nChunk);
+        for (auto& thread : threads) {
+            thread.join();
+        }
+    }
+
+    for (size_t i = 0; i < vSortedByHeight.size(); i++)
     {
-        CBlockIndex* pindex = item.second;
-        pindex->nChainWork = (pindex->pprev ? pindex->pprev->nChainWork : 0) + GetBlockProof(*pindex);
+        CBlockIndex* pindex = vSortedByHeight[i].second;
+        pindex->nChainWork = (pindex->pprev ? pindex->pprev->nChainWork : 0) + vBlockProof[i];
         pindex->nTimeMax = (pindex->pprev ? std::max(pindex->pprev->nTimeMax, pindex->nTime) : pindex->nTime);
         // We can link the chain of blocks for which we've received transactions at some point.
         // Pruned nodes may have deleted the block.
@@ -4822,6 +5673,12 @@ bool static LoadBlockIndexDB(const CChainParams& chainparams)
     pblocktree->ReadFlag("addressindex", fAddressIndex);
     LogPrintf("%s: address index %s\n", __func__, fAddressIndex ? "enabled" : "disabled");
 
+    // Address indexes from before balance rollups were kept get them built once
+    if (fAddressIndex && !pblocktree->HaveAddressBalances()) {
+        if (!pblocktree->BuildAddressBalances())
+            return error("%s: failed to build address balances", __func__);
+    }
+
     // Check whether we have a timestamp index
     pblocktree->ReadFlag("timestampindex", fTimestampIndex);
     LogPrintf("%s: timestamp index %s\n", __func__, fTimestampIndex ? "enabled" : "disabled");
@@ -4890,7 +5747,7 @@ bool CVerifyDB::VerifyDB(const CChainParams& chainparams, CCoinsView *coinsview,
     int reportDone = 0;
 
     auto currentActiveAssetCache = GetCurrentAssetCache();
-    CAssetsCache assetCache(*currentActiveAssetCache);
+    CAssetsCache assetCache(currentActiveAssetCache);
     LogPrintf("[0%%]...");
     for (CBlockIndex* pindex = chainActive.Tip(); pindex && pindex->pprev; pindex = pindex->pprev)
     {
@@ -4998,7 +5855,7 @@ bool ReplayBlocks(const CChainParams& params, CCoinsView* view)
 
     CCoinsViewCache cache(view);
     auto currentActiveAssetCache = GetCurrentAssetCache();
-    CAssetsCache assetsCache(*currentActiveAssetCache);
+    CAssetsCache assetsCache(currentActiveAssetCache);
 
     std::vector<uint256> hashHeads = view->GetHeadBlocks();
     if (hashHeads.empty()) return true; // We're already in a consistent state.
@@ -5056,6 +5913,7 @@ bool ReplayBlocks(const CChainParams& params, CCoinsView* view)
     cache.SetBestBlock(pindexNew->GetBlockHash());
     cache.Flush();
     assetsCache.Flush();
+    PublishAssetsReadDelta(assetsCache);
     uiInterface.ShowProgress("", 100, false);
     return true;
 }
@@ -5176,10 +6034,9 @@ void UnloadBlockIndex()
         warningcache[b].clear();
     }
 
-    for (BlockMap::value_type& entry : mapBlockIndex) {
-        delete entry.second;
-    }
     mapBlockIndex.clear();
+    blockIndexArena.Clear();
+    blockIndexColdStore.Clear();
     fHavePruned = false;
 }
 
@@ -5215,6 +6072,7 @@ bool LoadBlockIndex(const CChainParams& chainparams)
         // Use the provided setting for -addressindex in the new database
         fAddressIndex = gArgs.GetBoolArg("-addressindex", DEFAULT_ADDRESSINDEX);
         pblocktree->WriteFlag("addressindex", fAddressIndex);
+        pblocktree->WriteFlag("addressbalances", fAddressIndex);
         LogPrintf("%s: address index %s\n", __func__, fAddressIndex ? "enabled" : "disabled");
 
         // Use the provided setting for -timestampindex in the new database
@@ -5245,12 +6103,12 @@ bool LoadGenesisBlock(const CChainParams& chainparams)
     try {
         CBlock &block = const_cast<CBlock&>(chainparams.GenesisBlock());
         // Start new block file
-        unsigned int nBlockSize = ::GetSerializeSize(block, SER_DISK, CLIENT_VERSION);
+        const CDiskRecordData record(block);
         CDiskBlockPos blockPos;
         CValidationState state;
-        if (!FindBlockPos(state, blockPos, nBlockSize+8, 0, block.GetBlockTime()))
+        if (!FindBlockPos(state, blockPos, record.size()+8, 0, block.GetBlockTime()))
             return error("%s: FindBlockPos failed", __func__);
-        if (!WriteBlockToDisk(block, blockPos, chainparams.MessageStart()))
+        if (!WriteBlockToDisk(record, blockPos, chainparams.MessageStart()))
             return error("%s: writing genesis block to disk failed", __func__);
         CBlockIndex *pindex = AddToBlockIndex(block);
         if (!ReceivedBlockTransactions(block, state, pindex, blockPos, chainparams.GetConsensus()))
@@ -5262,6 +6120,291 @@ bool LoadGenesisBlock(const CChainParams& chainparams)
     return true;
 }
 
+/**
+ * Hand one block read by LoadExternalBlockFile to validation, along with any
+ * earlier out of order children that were waiting for it. Returns false if
+ * the import should stop.
+ */
+static bool LoadExternalBlock(const CChainParams& chainparams, const std::shared_ptr<CBlock>& pblock, CDiskBlockPos* dbp,
+                              std::multimap<uint256, CDiskBlockPos>& mapBlocksUnknownParent, int& nLoaded)
+{
+    const CBlock& block = *pblock;
+
+    // detect out of order blocks, and store them for later
+    uint256 hash = block.GetHash();
+    if (hash != chainparams.GetConsensus().hashGenesisBlock && mapBlockIndex.find(block.hashPrevBlock) == mapBlockIndex.end()) {
+        LogPrint(BCLog::REINDEX, "%s: Out of order block %s, parent %s not known\n", __func__, hash.ToString(),
+                block.hashPrevBlock.ToString());
+        if (dbp)
+            mapBlocksUnknownParent.insert(std::make_pair(block.hashPrevBlock, *dbp));
+        return true;
+    }
+
+    // process in case the block isn't known yet
+    if (mapBlockIndex.count(hash) == 0 || (mapBlockIndex[hash]->nStatus & BLOCK_HAVE_DATA) == 0) {
+        LOCK(cs_main);
+        CValidationState state;
+        if (AcceptBlock(pblock, state, chainparams, nullptr, true, dbp, nullptr, true)) {
+            nLoaded++;
+        }
+        if (state.IsError()) {
+            return false;
+        }
+    } else if (hash != chainparams.GetConsensus().hashGenesisBlock && mapBlockIndex[hash]->nHeight % 1000 == 0) {
+        LogPrint(BCLog::REINDEX, "Block Import: already had block %s at height %d\n", hash.ToString(), mapBlockIndex[hash]->nHeight);
+    }
+
+    // Activate the genesis block so normal node progress can continue
+    if (hash == chainparams.GetConsensus().hashGenesisBlock) {
+        CValidationState state;
+        if (!ActivateBestChain(state, chainparams)) {
+            return false;
+        }
+    }
+
+    NotifyHeaderTip();
+
+    // Recursively process earlier encountered successors of this block
+    std::deque<uint256> queue;
+    queue.push_back(hash);
+    while (!queue.empty()) {
+        uint256 head = queue.front();
+        queue.pop_front();
+        std::pair<std::multimap<uint256, CDiskBlockPos>::iterator, std::multimap<uint256, CDiskBlockPos>::iterator> range = mapBlocksUnknownParent.equal_range(head);
+        while (range.first != range.second) {
+            std::multimap<uint256, CDiskBlockPos>::iterator it = range.first;
+            std::shared_ptr<CBlock> pblockrecursive = std::make_shared<CBlock>();
+            if (ReadBlockFromDisk(*pblockrecursive, it->second, chainparams.GetConsensus()))
+            {
+                LogPrint(BCLog::REINDEX, "%s: Processing out of order child %s of %s\n", __func__, pblockrecursive->GetHash().ToString(),
+                        head.ToString());
+                LOCK(cs_main);
+                CValidationState dummy;
+                if (AcceptBlock(pblockrecursive, dummy, chainparams, nullptr, true, &it->second, nullptr, true))
+                {
+                    nLoaded++;
+                    queue.push_back(pblockrecursive->GetHash());
+                }
+            }
+            range.first++;
+            mapBlocksUnknownParent.erase(it);
+            NotifyHeaderTip();
+        }
+    }
+    return true;
+}
+
+/** Most blocks deserialized and checked ahead of the sequential import */
+static const size_t MAX_BLOCK_LOAD_BATCH = 128;
+/** Most bytes of block data in one such batch (at least one block is always taken) */
+static const size_t MAX_BLOCK_LOAD_BATCH_SIZE = 32 << 20;
+
+/** One block record found in a mapped blk file, and what the worker made of it */
+struct CBlockLoadRecord
+{
+    size_t nBlockPos;
+    //! Bytes the record takes in the file, and whether they are compressed
+    unsigned int nSize;
+    bool fCompressed{false};
+    std::shared_ptr<CBlock> pblock;
+    //! Bytes of the record the block deserialized from
+    size_t nConsumed{0};
+    std::string strError;
+};
+
+/**
+ * Closure representing one block of a reindex or -loadblock file to be
+ * deserialized and run through the context-free CheckBlock on the block load
+ * queue. A block that passes has fChecked set, so AcceptBlock only does the
+ * contextual checks on it; a block that fails is still handed to AcceptBlock
+ * so its failure is recorded the usual way. The check itself always succeeds.
+ */
+class CBlockLoadCheck
+{
+private:
+    const unsigned char* pData;
+    CBlockLoadRecord* precord;
+    const Consensus::Params* pconsensusParams;
+    int nCheckpointHeight;
+
+public:
+    CBlockLoadCheck() : pData(nullptr), precord(nullptr), pconsensusParams(nullptr), nCheckpointHeight(-1) {}
+    CBlockLoadCheck(const unsigned char* pDataIn, CBlockLoadRecord& recordIn, const Consensus::Params& consensusParamsIn, int nCheckpointHeightIn) :
+        pData(pDataIn), precord(&recordIn), pconsensusParams(&consensusParamsIn), nCheckpointHeight(nCheckpointHeightIn) {}
+
+    bool operator()()
+    {
+        try {
+            std::shared_ptr<CBlock> pblock = std::make_shared<CBlock>();
+            if (precord->fCompressed) {
+                // The record's size field is all that delimits a compressed block
+                std::vector<unsigned char> vData;
+                DecompressDiskRecord(pData + precord->nBlockPos, precord->nSize, GetMaxBlockSerializedSize(), vData);
+                CSpanReader blkdat(SER_DISK, CLIENT_VERSION, vData.data(), vData.size());
+                blkdat >> *pblock;
+                precord->nConsumed = precord->nSize;
+            } else {
+                CSpanReader blkdat(SER_DISK, CLIENT_VERSION, pData + precord->nBlockPos, precord->nSize);
+                blkdat >> *pblock;
+                precord->nConsumed = precord->nSize - blkdat.size();
+            }
+            precord->pblock = pblock;
+        } catch (const std::exception& e) {
+            precord->strError = e.what();
+            return true;
+        }
+        // CheckBlockHeader would look up the last checkpoint in mapBlockIndex,
+        // which needs cs_main, so check the proof of work against the height
+        // read up front and leave the rest to CheckBlock
+        const CBlock& block = *precord->pblock;
+        CValidationState state;
+        if (CheckBlockHeaderPoW(block, state, *pconsensusParams, block.nTime >= nKAWPOWActivationTime ? nCheckpointHeight : -1) &&
+            CheckBlock(block, state, *pconsensusParams, false, true)) {
+            block.fChecked = true;
+        }
+        return true;
+    }
+
+    void swap(CBlockLoadCheck& check)
+    {
+        std::swap(pData, check.pData);
+        std::swap(precord, check.precord);
+        std::swap(pconsensusParams, check.pconsensusParams);
+        std::swap(nCheckpointHeight, check.nCheckpointHeight);
+    }
+};
+
+static CCheckQueue<CBlockLoadCheck> blockloadqueue(1);
+
+void ThreadBlockLoadCheck() {
+    RenameThread("mynta-loadblk");
+    blockloadqueue.Thread();
+}
+
+/**
+ * LoadExternalBlockFile over a memory mapping of the whole file.
+ *
+ * Batches of records are located up front, deserialized and checked in
+ * parallel on the block load queue, and then handed to LoadExternalBlock in
+ * file order. The scan assumes every record deserializes to exactly its
+ * stated size; when one doesn't, the rest of the batch is dropped and the
+ * scan resumes where the sequential loader would have.
+ */
+static void LoadExternalBlockFileMapped(const CChainParams& chainparams, const CMappedBlockFile& map, CDiskBlockPos* dbp,
+                                        std::multimap<uint256, CDiskBlockPos>& mapBlocksUnknownParent, int& nLoaded)
+{
+    map.AdviseSequential();
+    const unsigned char* pData = map.data();
+    const size_t nFileSize = map.size();
+    size_t nReadahead = 0;
+    size_t nPos = 0;
+    std::vector<CBlockLoadRecord> vRecords;
+    std::vector<CBlockLoadCheck> vChecks;
+    bool fEnd = false;
+    while (!fEnd) {
+        boost::this_thread::interruption_point();
+
+        // locate the next batch of records
+        vRecords.clear();
+        size_t nBatchSize = 0;
+        size_t nScan = nPos;
+        while (vRecords.size() < MAX_BLOCK_LOAD_BATCH && nBatchSize < MAX_BLOCK_LOAD_BATCH_SIZE) {
+            if (nScan + 8 > nFileSize) {
+                fEnd = true;
+                break;
+            }
+
+            // Keep the kernel reading ahead of the parser
+            if (nScan + BLOCKFILE_READAHEAD_SIZE / 2 >= nReadahead) {
+                map.WillNeed(nScan, 2 * BLOCKFILE_READAHEAD_SIZE);
+                nReadahead = nScan + 2 * BLOCKFILE_READAHEAD_SIZE;
+            }
+
+            // locate a header
+            const unsigned char* pHeader = static_cast<const unsigned char*>(memchr(pData + nScan, chainparams.MessageStart()[0], nFileSize - nScan));
+            if (!pHeader || pHeader + 8 > pData + nFileSize) {
+                fEnd = true;
+                break;
+            }
+            nScan = pHeader - pData;
+            if (memcmp(pHeader, chainparams.MessageStart(), CMessageHeader::MESSAGE_START_SIZE)) {
+                nScan++;
+                continue;
+            }
+            // read size
+            unsigned int nSize = ReadLE32(pHeader + CMessageHeader::MESSAGE_START_SIZE);
+            const bool fCompressed = (nSize & DISK_RECORD_COMPRESSED) != 0;
+            nSize &= ~DISK_RECORD_COMPRESSED;
+            if (nSize < (fCompressed ? 1 : 80) || nSize > GetMaxBlockSerializedSize()) {
+                nScan++;
+                continue;
+            }
+            const size_t nBlockPos = nScan + 8;
+            if (nSize > nFileSize - nBlockPos) {
+                // no complete block left; don't complain
+                fEnd = true;
+                break;
+            }
+            CBlockLoadRecord record;
+            record.nBlockPos = nBlockPos;
+            record.nSize = nSize;
+            record.fCompressed = fCompressed;
+            vRecords.push_back(std::move(record));
+            nBatchSize += nSize;
+            nScan = nBlockPos + nSize;
+        }
+        if (vRecords.empty())
+            break;
+
+        // deserialize and check them, with the checkpoint height read under
+        // cs_main once for the batch so the workers never read mapBlockIndex
+        int nCheckpointHeight;
+        {
+            LOCK(cs_main);
+            nCheckpointHeight = GetLastCheckpointHeight();
+        }
+        vChecks.clear();
+        for (CBlockLoadRecord& record : vRecords) {
+            vChecks.emplace_back(pData, record, chainparams.GetConsensus(), nCheckpointHeight);
+        }
+        if (nScriptCheckThreads && vChecks.size() > 1) {
+            CCheckQueueControl<CBlockLoadCheck> control(&blockloadqueue);
+            control.Add(vChecks);
+            control.Wait();
+        } else {
+            for (CBlockLoadCheck& check : vChecks) {
+                check();
+            }
+        }
+
+        // and import them in file order
+        for (const CBlockLoadRecord& record : vRecords) {
+            boost::this_thread::interruption_point();
+
+            if (!record.pblock) {
+                LogPrintf("%s: Deserialize or I/O error - %s\n", __func__, record.strError);
+                // start one byte after the failed header, as the scan won't have
+                nPos = record.nBlockPos - 7;
+                fEnd = false;
+                break;
+            }
+            nPos = record.nBlockPos + record.nConsumed;
+            if (dbp)
+                dbp->nPos = record.nBlockPos;
+            try {
+                if (!LoadExternalBlock(chainparams, record.pblock, dbp, mapBlocksUnknownParent, nLoaded))
+                    return;
+            } catch (const std::exception& e) {
+                LogPrintf("%s: Deserialize or I/O error - %s\n", __func__, e.what());
+            }
+            if (record.nConsumed != record.nSize) {
+                fEnd = false;
+                break;
+            }
+        }
+    }
+}
+
 bool LoadExternalBlockFile(const CChainParams& chainparams, FILE* fileIn, CDiskBlockPos *dbp)
 {
     // Map of disk positions for blocks with unknown parent (only used for reindex)
@@ -5270,107 +6413,65 @@ bool LoadExternalBlockFile(const CChainParams& chainparams, FILE* fileIn, CDiskB
 
     int nLoaded = 0;
     try {
-        // This takes over fileIn and calls fclose() on it in the CBufferedFile destructor
-        CBufferedFile blkdat(fileIn, 2*GetMaxBlockSerializedSize(), GetMaxBlockSerializedSize()+8, SER_DISK, CLIENT_VERSION);
-        uint64_t nRewind = blkdat.GetPos();
-        while (!blkdat.eof()) {
-            boost::this_thread::interruption_point();
-
-            blkdat.SetPos(nRewind);
-            nRewind++; // start one byte further next time, in case of failure
-            blkdat.SetLimit(); // remove former limit
-            unsigned int nSize = 0;
-            try {
-                // locate a header
-                unsigned char buf[CMessageHeader::MESSAGE_START_SIZE];
-                blkdat.FindByte(chainparams.MessageStart()[0]);
-                nRewind = blkdat.GetPos()+1;
-                blkdat >> FLATDATA(buf);
-                if (memcmp(buf, chainparams.MessageStart(), CMessageHeader::MESSAGE_START_SIZE))
-                    continue;
-                // read size
-                blkdat >> nSize;
-                if (nSize < 80 || nSize > GetMaxBlockSerializedSize())
-                    continue;
-            } catch (const std::exception&) {
-                // no valid block header found; don't complain
-                break;
-            }
-            try {
-                // read block
-                uint64_t nBlockPos = blkdat.GetPos();
-                if (dbp)
-                    dbp->nPos = nBlockPos;
-                blkdat.SetLimit(nBlockPos + nSize);
-                blkdat.SetPos(nBlockPos);
-                std::shared_ptr<CBlock> pblock = std::make_shared<CBlock>();
-                CBlock& block = *pblock;
-                blkdat >> block;
-                nRewind = blkdat.GetPos();
-
-                // detect out of order blocks, and store them for later
-                uint256 hash = block.GetHash();
-                if (hash != chainparams.GetConsensus().hashGenesisBlock && mapBlockIndex.find(block.hashPrevBlock) == mapBlockIndex.end()) {
-                    LogPrint(BCLog::REINDEX, "%s: Out of order block %s, parent %s not known\n", __func__, hash.ToString(),
-                            block.hashPrevBlock.ToString());
-                    if (dbp)
-                        mapBlocksUnknownParent.insert(std::make_pair(block.hashPrevBlock, *dbp));
-                    continue;
+        CBlockFileMapCache::MapPtr map = fBlockFileMmap ? CMappedBlockFile::Map(fileIn) : nullptr;
+        if (map) {
+            // The mapping stays valid after the file is closed
+            fclose(fileIn);
+            LoadExternalBlockFileMapped(chainparams, *map, dbp, mapBlocksUnknownParent, nLoaded);
+        } else {
+            // This takes over fileIn and calls fclose() on it in the CBufferedFile destructor
+            CBufferedFile blkdat(fileIn, 2*GetMaxBlockSerializedSize(), GetMaxBlockSerializedSize()+8, SER_DISK, CLIENT_VERSION);
+            uint64_t nRewind = blkdat.GetPos();
+            while (!blkdat.eof()) {
+                boost::this_thread::interruption_point();
+
+                blkdat.SetPos(nRewind);
+                nRewind++; // start one byte further next time, in case of failure
+                blkdat.SetLimit(); // remove former limit
+                unsigned int nSize = 0;
+                bool fCompressed = false;
+                try {
+                    // locate a header
+                    unsigned char buf[CMessageHeader::MESSAGE_START_SIZE];
+                    blkdat.FindByte(chainparams.MessageStart()[0]);
+                    nRewind = blkdat.GetPos()+1;
+                    blkdat >> FLATDATA(buf);
+                    if (memcmp(buf, chainparams.MessageStart(), CMessageHeader::MESSAGE_START_SIZE))
+                        continue;
+                    // read size
+                    blkdat >> nSize;
+                    fCompressed = (nSize & DISK_RECORD_COMPRESSED) != 0;
+                    nSize &= ~DISK_RECORD_COMPRESSED;
+                    if (nSize < (fCompressed ? 1 : 80) || nSize > GetMaxBlockSerializedSize())
+                        continue;
+                } catch (const std::exception&) {
+                    // no valid block header found; don't complain
+                    break;
                 }
-
-                // process in case the block isn't known yet
-                if (mapBlockIndex.count(hash) == 0 || (mapBlockIndex[hash]->nStatus & BLOCK_HAVE_DATA) == 0) {
-                    LOCK(cs_main);
-                    CValidationState state;
-                    if (AcceptBlock(pblock, state, chainparams, nullptr, true, dbp, nullptr, true)) {
-                        nLoaded++;
-                    }
-                    if (state.IsError()) {
-                        break;
+                try {
+                    // read block
+                    uint64_t nBlockPos = blkdat.GetPos();
+                    if (dbp)
+                        dbp->nPos = nBlockPos;
+                    blkdat.SetLimit(nBlockPos + nSize);
+                    blkdat.SetPos(nBlockPos);
+                    std::shared_ptr<CBlock> pblock = std::make_shared<CBlock>();
+                    if (fCompressed) {
+                        std::vector<unsigned char> vStored(nSize), vData;
+                        blkdat.read((char*)vStored.data(), nSize);
+                        DecompressDiskRecord(vStored.data(), nSize, GetMaxBlockSerializedSize(), vData);
+                        CSpanReader blockin(SER_DISK, CLIENT_VERSION, vData.data(), vData.size());
+                        blockin >> *pblock;
+                    } else {
+                        blkdat >> *pblock;
                     }
-                } else if (hash != chainparams.GetConsensus().hashGenesisBlock && mapBlockIndex[hash]->nHeight % 1000 == 0) {
-                    LogPrint(BCLog::REINDEX, "Block Import: already had block %s at height %d\n", hash.ToString(), mapBlockIndex[hash]->nHeight);
-                }
+                    nRewind = blkdat.GetPos();
 
-                // Activate the genesis block so normal node progress can continue
-                if (hash == chainparams.GetConsensus().hashGenesisBlock) {
-                    CValidationState state;
-                    if (!ActivateBestChain(state, chainparams)) {
+                    if (!LoadExternalBlock(chainparams, pblock, dbp, mapBlocksUnknownParent, nLoaded))
                         break;
-                    }
-                }
-
-                NotifyHeaderTip();
-
-                // Recursively process earlier encountered successors of this block
-                std::deque<uint256> queue;
-                queue.push_back(hash);
-                while (!queue.empty()) {
-                    uint256 head = queue.front();
-                    queue.pop_front();
-                    std::pair<std::multimap<uint256, CDiskBlockPos>::iterator, std::multimap<uint256, CDiskBlockPos>::iterator> range = mapBlocksUnknownParent.equal_range(head);
-                    while (range.first != range.second) {
-                        std::multimap<uint256, CDiskBlockPos>::iterator it = range.first;
-                        std::shared_ptr<CBlock> pblockrecursive = std::make_shared<CBlock>();
-                        if (ReadBlockFromDisk(*pblockrecursive, it->second, chainparams.GetConsensus()))
-                        {
-                            LogPrint(BCLog::REINDEX, "%s: Processing out of order child %s of %s\n", __func__, pblockrecursive->GetHash().ToString(),
-                                    head.ToString());
-                            LOCK(cs_main);
-                            CValidationState dummy;
-                            if (AcceptBlock(pblockrecursive, dummy, chainparams, nullptr, true, &it->second, nullptr, true))
-                            {
-                                nLoaded++;
-                                queue.push_back(pblockrecursive->GetHash());
-                            }
-                        }
-                        range.first++;
-                        mapBlocksUnknownParent.erase(it);
-                        NotifyHeaderTip();
-                    }
+                } catch (const std::exception& e) {
+                    LogPrintf("%s: Deserialize or I/O error - %s\n", __func__, e.what());
                 }
-            } catch (const std::exception& e) {
-                LogPrintf("%s: Deserialize or I/O error - %s\n", __func__, e.what());
             }
         }
     } catch (const std::runtime_error& e) {
@@ -5595,11 +6696,103 @@ int VersionBitsTipStateSinceHeight(const Consensus::Params& params, Consensus::D
     return VersionBitsStateSinceHeight(chainActive.Tip(), params, pos, versionbitscache);
 }
 
+/**
+ * Check the input scripts of a batch of transactions on the script check
+ * threads. The results are thrown away; what is kept is the signature cache,
+ * so that AcceptToMemoryPool finds each signature there instead of verifying
+ * it again on one thread under cs_main. Inputs spending a transaction that is
+ * neither in the UTXO set, the pool nor the batch are left to it.
+ */
+static void PreCheckTxScripts(CTxMemPool& pool, const std::vector<CTxMemPoolBatchEntry>& vEntries, unsigned int nFlags)
+{
+    std::map<uint256, const CTransaction*> mapBatch;
+    for (const CTxMemPoolBatchEntry& entry : vEntries) {
+        mapBatch.emplace(entry.tx->GetHash(), entry.tx.get());
+    }
+
+    std::vector<PrecomputedTransactionData> vTxData;
+    vTxData.reserve(vEntries.size());
+    std::vector<CScriptCheck> vChecks;
+    {
+        LOCK2(cs_main, pool.cs);
+        CCoinsViewMemPool viewMemPool(pcoinsTip, pool);
+        for (const CTxMemPoolBatchEntry& entry : vEntries) {
+            const CTransaction& tx = *entry.tx;
+            if (tx.IsCoinBase())
+                continue;
+            vTxData.emplace_back(tx);
+            for (unsigned int i = 0; i < tx.vin.size(); i++) {
+                const COutPoint& prevout = tx.vin[i].prevout;
+                Coin coin;
+                auto it = mapBatch.find(prevout.hash);
+                if (it != mapBatch.end()) {
+                    if (prevout.n < it->second->vout.size())
+                        vChecks.emplace_back(it->second->vout[prevout.n], tx, i, nFlags, true, &vTxData.back());
+                } else if (viewMemPool.GetCoin(prevout, coin) && !coin.IsSpent()) {
+                    vChecks.emplace_back(coin.out, tx, i, nFlags, true, &vTxData.back());
+                }
+            }
+        }
+    }
+
+    CCheckQueueControl<CScriptCheck> control(&scriptcheckqueue);
+    control.Add(vChecks);
+    control.Wait();
+}
+
+void AcceptToMemoryPoolBatch(CTxMemPool& pool, std::vector<CTxMemPoolBatchEntry>& vEntries, std::list<CTransactionRef>* plTxnReplaced,
+                             bool bypass_limits, const CAmount nAbsurdFee)
+{
+    const CChainParams& chainparams = GetParams();
+    unsigned int scriptVerifyFlags = STANDARD_SCRIPT_VERIFY_FLAGS;
+    if (!chainparams.RequireStandard()) {
+        scriptVerifyFlags = gArgs.GetArg("-promiscuousmempoolflags", scriptVerifyFlags);
+    }
+    if (nScriptCheckThreads && vEntries.size() > 1) {
+        PreCheckTxScripts(pool, vEntries, scriptVerifyFlags);
+    }
+
+    LOCK2(cs_main, pool.cs);
+    // Accept what can be in order, then go over the ones missing inputs again
+    // for as long as that accepts more: they may spend a later entry
+    std::vector<size_t> vPending(vEntries.size());
+    for (size_t i = 0; i < vEntries.size(); i++) {
+        vPending[i] = i;
+    }
+    bool fProgress = true;
+    while (fProgress && !vPending.empty()) {
+        fProgress = false;
+        std::vector<size_t> vMissingInputs;
+        for (size_t i : vPending) {
+            CTxMemPoolBatchEntry& entry = vEntries[i];
+            entry.state = CValidationState();
+            std::vector<COutPoint> coins_to_uncache;
+            entry.fAccepted = AcceptToMemoryPoolWorker(chainparams, pool, entry.state, entry.tx, &entry.fMissingInputs, entry.nAcceptTime,
+                                                       plTxnReplaced, bypass_limits, nAbsurdFee, coins_to_uncache, false /* test_accept */);
+            if (!entry.fAccepted) {
+                for (const COutPoint& hashTx : coins_to_uncache)
+                    pcoinsTip->Uncache(hashTx);
+            }
+            if (entry.fAccepted) {
+                fProgress = true;
+            } else if (entry.fMissingInputs) {
+                vMissingInputs.push_back(i);
+            }
+        }
+        vPending.swap(vMissingInputs);
+    }
+
+    // Once for the batch, rather than after every transaction
+    CValidationState stateDummy;
+    FlushStateToDisk(chainparams, stateDummy, FLUSH_STATE_PERIODIC);
+}
+
 static const uint64_t MEMPOOL_DUMP_VERSION = 1;
+//! Transactions LoadMempool reads and accepts at once
+static const size_t MEMPOOL_LOAD_BATCH_SIZE = 1000;
 
 bool LoadMempool(void)
 {
-    const CChainParams& chainparams = GetParams();
     int64_t nExpiryTimeout = gArgs.GetArg("-mempoolexpiry", DEFAULT_MEMPOOL_EXPIRY) * 60 * 60;
     FILE* filestr = fsbridge::fopen(GetDataDir() / "mempool.dat", "rb");
     CAutoFile file(filestr, SER_DISK, CLIENT_VERSION);
@@ -5622,39 +6815,45 @@ bool LoadMempool(void)
         }
         uint64_t num;
         file >> num;
-        while (num--) {
-            CTransactionRef tx;
-            int64_t nTime;
-            int64_t nFeeDelta;
-            file >> tx;
-            file >> nTime;
-            file >> nFeeDelta;
-
-            CAmount amountdelta = nFeeDelta;
-            if (amountdelta) {
-                mempool.PrioritiseTransaction(tx->GetHash(), amountdelta);
+        std::vector<CTxMemPoolBatchEntry> vEntries;
+        while (num) {
+            // Read a batch of the unexpired transactions, in file order (parents first)
+            vEntries.clear();
+            while (num && vEntries.size() < MEMPOOL_LOAD_BATCH_SIZE) {
+                num--;
+                CTransactionRef tx;
+                int64_t nTime;
+                int64_t nFeeDelta;
+                file >> tx;
+                file >> nTime;
+                file >> nFeeDelta;
+
+                CAmount amountdelta = nFeeDelta;
+                if (amountdelta) {
+                    mempool.PrioritiseTransaction(tx->GetHash(), amountdelta);
+                }
+                if (nTime + nExpiryTimeout > nNow) {
+                    vEntries.emplace_back(tx, nTime);
+                } else {
+                    ++expired;
+                }
             }
-            CValidationState state;
-            if (nTime + nExpiryTimeout > nNow) {
-                LOCK(cs_main);
-                AcceptToMemoryPoolWithTime(chainparams, mempool, state, tx, nullptr /* pfMissingInputs */, nTime,
-                                           nullptr /* plTxnReplaced */, false /* bypass_limits */, 0 /* nAbsurdFee */,
-                                           false /* test_accept */);
-                if (state.IsValid()) {
+
+            AcceptToMemoryPoolBatch(mempool, vEntries, nullptr /* plTxnReplaced */, false /* bypass_limits */, 0 /* nAbsurdFee */);
+            for (const CTxMemPoolBatchEntry& entry : vEntries) {
+                if (entry.fAccepted) {
                     ++count;
                 } else {
                     // mempool may contain the transaction already, e.g. from
                     // wallet(s) having loaded it while we were processing
                     // mempool transactions; consider these as valid, instead of
                     // failed, but mark them as 'already there'
-                    if (mempool.exists(tx->GetHash())) {
+                    if (mempool.exists(entry.tx->GetHash())) {
                         ++already_there;
                     } else {
                         ++failed;
                     }
                 }
-            } else {
-                ++expired;
             }
             if (ShutdownRequested())
                 return false;
@@ -5857,9 +7056,7 @@ public:
     CMainCleanup() {}
     ~CMainCleanup() {
         // block headers
-        BlockMap::iterator it1 = mapBlockIndex.begin();
-        for (; it1 != mapBlockIndex.end(); it1++)
-            delete (*it1).second;
         mapBlockIndex.clear();
+        blockIndexArena.Clear();
     }
 } instance_of_cmaincleanup;
@@ -13,6 +13,7 @@
 
 #include "amount.h"
 #include "coins.h"
+#include "consensus/validation.h"
 #include "fs.h"
 #include "protocol.h" // For CMessageHeader::MessageStartChars
 #include "policy/feerate.h"
@@ -25,6 +26,7 @@
 
 #include <algorithm>
 #include <exception>
+#include <limits>
 #include <map>
 #include <set>
 #include <stdint.h>
@@ -42,9 +44,12 @@
 #include <assets/snapshotrequestdb.h>
 
 class CBlockIndex;
+class CBlockUndo;
+class CBlockView;
 class CBlockTreeDB;
 class CChainParams;
 class CCoinsViewDB;
+class CCoinsViewFlushBuffer;
 class CInv;
 class CConnman;
 class CScriptCheck;
@@ -53,6 +58,7 @@ class CTxMemPool;
 class CValidationState;
 class CTxUndo;
 struct ChainTxData;
+struct CCheckQueueWorkerStats;
 
 class CAssetsDB;
 class CAssets;
@@ -93,11 +99,24 @@ static const unsigned int BLOCKFILE_CHUNK_SIZE = 0x1000000; // 16 MiB
 static const unsigned int UNDOFILE_CHUNK_SIZE = 0x100000; // 1 MiB
 
 /** Maximum number of script-checking threads allowed */
-static const int MAX_SCRIPTCHECK_THREADS = 16;
+static const int MAX_SCRIPTCHECK_THREADS = 64;
+/** Maximum number of threads GetTransactions reads block files on */
+static const int MAX_TX_READ_THREADS = 8;
+/** Fewest transactions GetTransactions gives each of its threads to read */
+static const size_t MIN_TX_READS_PER_THREAD = 16;
 /** -par default (number of script-checking threads, 0 = auto) */
 static const int DEFAULT_SCRIPTCHECK_THREADS = 0;
+/** Default for -parpin, pinning script-checking threads to CPUs grouped by cache */
+static const bool DEFAULT_SCRIPTCHECK_PIN = false;
+/** Default for -backgroundflush, writing the coins database on a background thread while validation continues */
+static const bool DEFAULT_BACKGROUND_FLUSH = true;
 /** Number of blocks that can be requested at any given time from a single peer. */
 static const int MAX_BLOCKS_IN_TRANSIT_PER_PEER = 16;
+/** Bounds of a peer's block download window once its latency and delivery rate have been measured. */
+static const int MIN_ADAPTIVE_BLOCKS_IN_TRANSIT_PER_PEER = 2;
+static const int MAX_ADAPTIVE_BLOCKS_IN_TRANSIT_PER_PEER = 128;
+/** Time in microseconds a block holding back the download window must be outstanding before a faster peer is asked for it. */
+static const int64_t BLOCK_REASSIGN_MIN_DELAY = 500000;
 /** Timeout in seconds during which a peer must stall block download progress before being disconnected. */
 static const unsigned int BLOCK_STALLING_TIMEOUT = 2;
 /** Number of headers sent in one getheaders result. We rely on the assumption that if a peer sends
@@ -234,10 +253,18 @@ static const uint64_t nMinDiskSpace = 52428800;
 extern bool fHavePruned;
 /** True if we're running in -prune mode. */
 extern bool fPruneMode;
+/** Read blk/rev files through memory mappings (-blockfilemmap) */
+extern bool fBlockFileMmap;
+/** Compress the blocks and undo data written to blk/rev files (-blockcompression) */
+extern bool fBlockCompression;
 /** Number of MiB of block files that we're trying to stay below. */
 extern uint64_t nPruneTarget;
 /** Block files containing a block-height within MIN_BLOCKS_TO_KEEP of chainActive.Tip() will not be pruned. */
 static const unsigned int MIN_BLOCKS_TO_KEEP = 288;
+/** Seconds between the passes that erase the asset undo data and masternode lists of pruned blocks */
+static const int64_t BLOCK_STATE_PRUNE_INTERVAL = 60;
+/** Most records of each kind one of those passes erases, as it holds cs_main */
+static const size_t MAX_BLOCK_STATE_PRUNE_BATCH = 10000;
 
 static const signed int DEFAULT_CHECKBLOCKS = 6;
 static const unsigned int DEFAULT_CHECKLEVEL = 3;
@@ -273,6 +300,13 @@ static const uint64_t MIN_DISK_SPACE_FOR_BLOCK_FILES = 550 * 1024 * 1024;
  */
 bool ProcessNewBlock(const CChainParams& chainparams, const std::shared_ptr<const CBlock> pblock, bool fForceProcessing, bool* fNewBlock);
 
+/** Context-free results for a header, computed ahead of ProcessNewBlockHeaders */
+struct CHeaderPreCheck
+{
+    uint256 hash;
+    bool fPoWValid{false};
+};
+
 /**
  * Process incoming block headers.
  *
@@ -283,8 +317,22 @@ bool ProcessNewBlock(const CChainParams& chainparams, const std::shared_ptr<cons
  * @param[in]  chainparams The params for the chain we want to connect to
  * @param[out] ppindex If set, the pointer will be set to point to the last new block index object for the given headers
  * @param[out] first_invalid First header that fails validation, if one exists
+ * @param[in]  pPreChecks If set, the PreCheckBlockHeaders results for the same headers
+ */
+bool ProcessNewBlockHeaders(const std::vector<CBlockHeader>& block, CValidationState& state, const CChainParams& chainparams, const CBlockIndex** ppindex=nullptr, CBlockHeader *first_invalid=nullptr, const std::vector<CHeaderPreCheck>* pPreChecks=nullptr);
+
+/** Compute the hash of every header in a batch on the header check threads */
+std::vector<CHeaderPreCheck> HashBlockHeaders(const std::vector<CBlockHeader>& headers);
+
+/**
+ * Check the proof of work of the headers in a batch that are not known yet,
+ * given their HashBlockHeaders results. The work is spread over the header
+ * check threads and runs without cs_main held (it is only taken briefly to
+ * look up the last checkpoint), so it can be done right before
+ * ProcessNewBlockHeaders runs the sequential checks. As this is the
+ * expensive part, do the cheap checks on the batch first.
  */
-bool ProcessNewBlockHeaders(const std::vector<CBlockHeader>& block, CValidationState& state, const CChainParams& chainparams, const CBlockIndex** ppindex=nullptr, CBlockHeader *first_invalid=nullptr);
+void PreCheckBlockHeaders(const std::vector<CBlockHeader>& headers, std::vector<CHeaderPreCheck>& vPreChecks, const Consensus::Params& consensusParams);
 
 /** Check whether enough disk space is available for an incoming block */
 bool CheckDiskSpace(uint64_t nAdditionalBytes = 0);
@@ -303,13 +351,27 @@ bool LoadBlockIndex(const CChainParams& chainparams);
 bool LoadChainTip(const CChainParams& chainparams);
 /** Unload database information */
 void UnloadBlockIndex();
-/** Run an instance of the script checking thread */
-void ThreadScriptCheck();
+/** Run instance nWorker of the script checking thread */
+void ThreadScriptCheck(int nWorker);
+/** Work done by each thread of the script check queue, the block connecting thread first */
+std::vector<CCheckQueueWorkerStats> GetScriptCheckStats();
+/** Run an instance of the header proof-of-work checking thread */
+void ThreadHeaderCheck();
+/** Run an instance of the reindex block deserialize and check thread */
+void ThreadBlockLoadCheck();
+/** Run an instance of the block transaction prepare (sighash data and asset output decoding) thread */
+void ThreadTxPrepare();
 /** Check whether we are doing an initial block download (synchronizing from disk or network) */
 bool IsInitialBlockDownload();
 bool IsInitialSyncSpeedUp();
 /** Retrieve a transaction (from memory pool, or from disk, if possible) */
 bool GetTransaction(const uint256 &hash, CTransactionRef &tx, const Consensus::Params& params, uint256 &hashBlock, bool fAllowSlow = false);
+/** Retrieve many transactions at once, as GetTransaction does each. The ones
+ * not in the memory pool are read from the block files in file order, on up
+ * to MAX_TX_READ_THREADS threads. vtxOut and vHashBlock get an entry per hash,
+ * a null transaction for one that isn't found. */
+void GetTransactions(const std::vector<uint256>& vHash, std::vector<CTransactionRef>& vtxOut, std::vector<uint256>& vHashBlock,
+                     const Consensus::Params& params, bool fAllowSlow = false);
 /** Find the best known block, and make it the tip of the block chain */
 bool ActivateBestChain(CValidationState& state, const CChainParams& chainparams, std::shared_ptr<const CBlock> pblock = std::shared_ptr<const CBlock>());
 CAmount GetBlockSubsidy(int nHeight, const Consensus::Params& consensusParams);
@@ -338,6 +400,8 @@ void FlushStateToDisk();
 void PruneAndFlush();
 /** Prune block files up to a given height */
 void PruneBlockFilesManual(int nManualPruneHeight);
+/** Erase a batch of the asset undo data and masternode lists of blocks that pruning took the undo data of */
+void PruneBlockStateData();
 
 /** (try to) add transaction to memory pool
  * plTxnReplaced will be appended to with all transactions replaced from mempool **/
@@ -345,6 +409,27 @@ bool AcceptToMemoryPool(CTxMemPool& pool, CValidationState &state, const CTransa
                         bool* pfMissingInputs, std::list<CTransactionRef>* plTxnReplaced,
                         bool bypass_limits, const CAmount nAbsurdFee, bool test_accept=false);
 
+/** A transaction handed to AcceptToMemoryPoolBatch, and what came of it */
+struct CTxMemPoolBatchEntry
+{
+    CTransactionRef tx;
+    int64_t nAcceptTime;
+    CValidationState state;
+    bool fMissingInputs;
+    bool fAccepted;
+
+    CTxMemPoolBatchEntry(const CTransactionRef& txIn, int64_t nAcceptTimeIn) :
+        tx(txIn), nAcceptTime(nAcceptTimeIn), fMissingInputs(false), fAccepted(false) {}
+};
+
+/** (try to) add many transactions to memory pool at once.
+ * Their scripts are checked on the script check threads first, then they are
+ * accepted under one cs_main and pool.cs acquisition, an entry spending another
+ * of the batch after it. What came of each is left in its entry; the ones
+ * missing inputs that no other entry provides are left with fMissingInputs. **/
+void AcceptToMemoryPoolBatch(CTxMemPool& pool, std::vector<CTxMemPoolBatchEntry>& vEntries, std::list<CTransactionRef>* plTxnReplaced,
+                             bool bypass_limits, const CAmount nAbsurdFee);
+
 /** Convert CValidationState to a human-readable message for logging */
 std::string FormatStateMessage(const CValidationState &state);
 
@@ -361,7 +446,7 @@ int VersionBitsTipStateSinceHeight(const Consensus::Params& params, Consensus::D
 /** Apply the effects of this transaction on the UTXO set represented by view */
 void UpdateCoins(const CTransaction& tx, CCoinsViewCache& inputs, int nHeight);
 
-void UpdateCoins(const CTransaction& tx, CCoinsViewCache& inputs, CTxUndo& txundo, int nHeight, uint256 blockHash, CAssetsCache* assetCache = nullptr, std::pair<std::string, CBlockAssetUndo>* undoAssetData = nullptr);
+void UpdateCoins(const CTransaction& tx, CCoinsViewCache& inputs, CTxUndo& txundo, int nHeight, uint256 blockHash, CAssetsCache* assetCache = nullptr, std::pair<std::string, CBlockAssetUndo>* undoAssetData = nullptr, const std::vector<CAssetOutputRecord>* pAssetOutputs = nullptr);
 
 /** Transaction validation functions */
 
@@ -430,8 +515,23 @@ public:
 /** Initializes the script-execution cache */
 void InitScriptExecutionCache();
 
-bool GetTimestampIndex(const unsigned int &high, const unsigned int &low, const bool fActiveOnly, std::vector<std::pair<uint256, unsigned int> > &hashes);
+/** Script executions skipped or run while connecting blocks */
+struct ScriptCacheStats {
+    //! Cached under the block's own script flags
+    uint64_t nHits;
+    //! Accepted to the mempool under stricter flags than the block's
+    uint64_t nFlagHits;
+    uint64_t nMisses;
+    //! Transactions whose accepted flags are remembered
+    size_t nValidatedTxs;
+};
+ScriptCacheStats GetScriptCacheStats();
+
+bool GetTimestampIndex(const unsigned int &high, const unsigned int &low, const bool fActiveOnly, std::vector<std::pair<uint256, unsigned int> > &hashes,
+                       size_t nLimit = std::numeric_limits<size_t>::max(), const uint256 &hashStartAfter = uint256());
 bool GetSpentIndex(CSpentIndexKey &key, CSpentIndexValue &value);
+/** GetSpentIndex of many outpoints at once; vFound[i] tells whether vValues[i] was found */
+void GetSpentIndex(const std::vector<CSpentIndexKey> &vKeys, std::vector<CSpentIndexValue> &vValues, std::vector<bool> &vFound);
 bool HashOnchainActive(const uint256 &hash);
 bool GetAddressIndex(uint160 addressHash, int type, std::string assetName,
                      std::vector<std::pair<CAddressIndexKey, CAmount> > &addressIndex,
@@ -447,6 +547,13 @@ bool GetAddressUnspent(uint160 addressHash, int type,
 /** Functions for disk access for blocks */
 bool ReadBlockFromDisk(CBlock& block, const CDiskBlockPos& pos, const Consensus::Params& consensusParams);
 bool ReadBlockFromDisk(CBlock& block, const CBlockIndex* pindex, const Consensus::Params& consensusParams);
+/** Read the serialized block at pos without deserializing it, e.g. to parse with CBlockView */
+bool ReadRawBlockFromDisk(std::vector<unsigned char>& block, const CDiskBlockPos& pos, const CMessageHeader::MessageStartChars& message_start);
+bool ReadRawBlockFromDisk(std::vector<unsigned char>& block, const CBlockIndex* pindex, const CMessageHeader::MessageStartChars& message_start);
+/** Read a block's undo data, checked against the hash of its parent hashBlock */
+bool UndoReadFromDisk(CBlockUndo& blockundo, const CDiskBlockPos& pos, const uint256& hashBlock);
+/** Read pindex's block into buffer and parse it in place; view points into buffer */
+bool ReadBlockViewFromDisk(CBlockView& view, std::vector<unsigned char>& buffer, const CBlockIndex* pindex, const CMessageHeader::MessageStartChars& message_start);
 
 /** Functions for validating blocks and updating the block tree */
 
@@ -479,6 +586,9 @@ public:
 /** Replay blocks that aren't fully applied to the database. */
 bool ReplayBlocks(const CChainParams& params, CCoinsView* view);
 
+/** Check that the asset databases were last flushed at the coins database's best block. */
+bool CheckChainstateSideDatabases();
+
 /** Find the last common block between the parameter chain and a locator. */
 CBlockIndex* FindForkInGlobalIndex(const CChain& chain, const CBlockLocator& locator);
 
@@ -497,6 +607,9 @@ extern CChain chainActive;
 /** Global variable that points to the coins database (protected by cs_main) */
 extern CCoinsViewDB *pcoinsdbview;
 
+/** Global variable that points to the view writing flushes of pcoinsTip to pcoinsdbview (protected by cs_main) */
+extern CCoinsViewFlushBuffer *pcoinsbuffer;
+
 /** Global variable that points to the active CCoinsView (protected by cs_main) */
 extern CCoinsViewCache *pcoinsTip;
 
@@ -511,17 +624,17 @@ extern CAssetsDB *passetsdb;
 /** Global variable that point to the active assets (protected by cs_main) */
 extern CAssetsCache *passets;
 
-/** Global variable that point to the assets metadata LRU Cache (protected by cs_main) */
-extern CLRUCache<std::string, CDatabasedAssetData> *passetsCache;
+/** Global variable that point to the assets metadata LRU Cache (internally locked) */
+extern CAssetNameLRUCache<CDatabasedAssetData> *passetsCache;
 
 /** Global variable that points to the subscribed channel LRU Cache (protected by cs_main) */
-extern CLRUCache<std::string, CMessage> *pMessagesCache;
+extern CMessageLRUCache *pMessagesCache;
 
 /** Global variable that points to the subscribed channel LRU Cache (protected by cs_main) */
 extern CLRUCache<std::string, int> *pMessageSubscribedChannelsCache;
 
 /** Global variable that points to the address seen LRU Cache (protected by cs_main) */
-extern CLRUCache<std::string, int> *pMessagesSeenAddressCache;
+extern CSeenAddressLRUCache *pMessagesSeenAddressCache;
 
 /** Global variable that points to the messages database (protected by cs_main) */
 extern CMessageDB *pmessagedb;
@@ -535,17 +648,17 @@ extern CMyRestrictedDB *pmyrestricteddb;
 /** Global variable that points to the active restricted asset database (protected by cs_main) */
 extern CRestrictedDB *prestricteddb;
 
-/** Global variable that points to the asset verifier LRU Cache (protected by cs_main) */
-extern CLRUCache<std::string, CNullAssetTxVerifierString> *passetsVerifierCache;
+/** Global variable that points to the asset verifier LRU Cache (internally locked) */
+extern CAssetNameLRUCache<CNullAssetTxVerifierString> *passetsVerifierCache;
 
-/** Global variable that points to the asset address qualifier LRU Cache (protected by cs_main) */
-extern CLRUCache<std::string, int8_t> *passetsQualifierCache; // hash(address,qualifier_name) ->int8_t
+/** Global variable that points to the asset address qualifier LRU Cache (internally locked) */
+extern CAssetAddressLRUCache<int8_t> *passetsQualifierCache; // (qualifier_name, address) -> int8_t
 
-/** Global variable that points to the asset address restriction LRU Cache (protected by cs_main) */
-extern CLRUCache<std::string, int8_t> *passetsRestrictionCache; // hash(address,qualifier_name) ->int8_t
+/** Global variable that points to the asset address restriction LRU Cache (internally locked) */
+extern CAssetAddressLRUCache<int8_t> *passetsRestrictionCache; // (restricted_name, address) -> int8_t
 
-/** Global variable that points to the global asset restriction LRU Cache (protected by cs_main) */
-extern CLRUCache<std::string, int8_t> *passetsGlobalRestrictionCache;
+/** Global variable that points to the global asset restriction LRU Cache (internally locked) */
+extern CAssetNameLRUCache<int8_t> *passetsGlobalRestrictionCache;
 
 /** Global variable that point to the active Snapshot Request database (protected by cs_main) */
 extern CSnapshotRequestDB *pSnapshotRequestDb;
@@ -6,14 +6,24 @@
 
 #include "validationinterface.h"
 
+#include "assets/assettypes.h"
+#include "assets/atomicswap.h"
+#include "assets/messages.h"
 #include "init.h"
 #include "primitives/block.h"
 #include "scheduler.h"
 #include "sync.h"
+#include "txmempool.h"
 #include "util.h"
 
 #include <list>
 #include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <map>
+#include <mutex>
+#include <thread>
 
 #include <boost/signals2/signal.hpp>
 
@@ -21,6 +31,137 @@
 #include <boost/bind/bind.hpp>
 using namespace boost::placeholders;
 
+/** Runs the callbacks of one subscriber in order, on a thread of its own */
+class CValidationQueue
+{
+private:
+    const ValidationQueueOptions options;
+
+    mutable std::mutex cs;
+    //! Signalled when an event is queued or the queue is stopping
+    std::condition_variable condWork;
+    //! Signalled when an event is taken or has run
+    std::condition_variable condDone;
+    std::deque<std::function<void ()>> queue;
+    bool fRunning;
+    bool fBusy;
+    ValidationQueueStats stats;
+    //! Connections to the signals, feeding the queue
+    std::vector<boost::signals2::connection> vConnections;
+    std::thread thread;
+
+    void Run();
+
+public:
+    explicit CValidationQueue(const ValidationQueueOptions& optionsIn) : options(optionsIn), fRunning(true), fBusy(false), stats()
+    {
+        stats.strName = options.strName;
+        stats.policy = options.policy;
+        stats.nMaxDepth = options.nMaxDepth;
+        thread = std::thread(&CValidationQueue::Run, this);
+    }
+
+    //! Runs the events still queued, then stops the thread
+    ~CValidationQueue()
+    {
+        Disconnect();
+        {
+            std::lock_guard<std::mutex> lock(cs);
+            fRunning = false;
+            condWork.notify_all();
+        }
+        thread.join();
+    }
+
+    void Connect(const boost::signals2::connection& connection)
+    {
+        vConnections.push_back(connection);
+    }
+
+    void Disconnect()
+    {
+        for (boost::signals2::connection& connection : vConnections)
+            connection.disconnect();
+        vConnections.clear();
+    }
+
+    void Push(std::function<void ()> func)
+    {
+        std::unique_lock<std::mutex> lock(cs);
+        if (queue.size() >= options.nMaxDepth) {
+            switch (options.policy) {
+            case ValidationQueuePolicy::WAIT: {
+                const int64_t nStart = GetTimeMicros();
+                if (!condDone.wait_for(lock, std::chrono::milliseconds(VALIDATION_QUEUE_MAX_WAIT_MS), [this] { return queue.size() < options.nMaxDepth; }))
+                    stats.nOverflows++;
+                stats.nWaitMicros += GetTimeMicros() - nStart;
+                break;
+            }
+            case ValidationQueuePolicy::DROP_OLDEST:
+                queue.pop_front();
+                stats.nDropped++;
+                break;
+            case ValidationQueuePolicy::DROP_NEWEST:
+                stats.nDropped++;
+                return;
+            }
+        }
+        queue.push_back(std::move(func));
+        stats.nPeakDepth = std::max(stats.nPeakDepth, queue.size());
+        condWork.notify_one();
+    }
+
+    //! Wait until the events queued so far have run
+    void Sync()
+    {
+        std::unique_lock<std::mutex> lock(cs);
+        condDone.wait(lock, [this] { return queue.empty() && !fBusy; });
+    }
+
+    ValidationQueueStats GetStats() const
+    {
+        std::lock_guard<std::mutex> lock(cs);
+        ValidationQueueStats ret = stats;
+        ret.nDepth = queue.size();
+        return ret;
+    }
+};
+
+void CValidationQueue::Run()
+{
+    RenameThread(("mynta-vq-" + options.strName).c_str());
+
+    std::unique_lock<std::mutex> lock(cs);
+    while (true) {
+        condWork.wait(lock, [this] { return !fRunning || !queue.empty(); });
+        if (queue.empty())
+            break;
+        std::function<void ()> func = std::move(queue.front());
+        queue.pop_front();
+        fBusy = true;
+        condDone.notify_all();
+        lock.unlock();
+
+        const int64_t nStart = GetTimeMicros();
+        try {
+            func();
+        } catch (const std::exception& e) {
+            PrintExceptionContinue(&e, ("validation queue " + options.strName).c_str());
+        } catch (...) {
+            PrintExceptionContinue(nullptr, ("validation queue " + options.strName).c_str());
+        }
+        // The event's arguments go before the queue counts it as done
+        func = nullptr;
+        const int64_t nBusy = GetTimeMicros() - nStart;
+
+        lock.lock();
+        fBusy = false;
+        stats.nProcessed++;
+        stats.nBusyMicros += nBusy;
+        condDone.notify_all();
+    }
+}
+
 struct MainSignalsInstance {
     boost::signals2::signal<void (const CBlockIndex *, const CBlockIndex *, bool fInitialDownload)> UpdatedBlockTip;
     boost::signals2::signal<void (const CTransactionRef &)> TransactionAddedToMempool;
@@ -32,6 +173,9 @@ struct MainSignalsInstance {
     boost::signals2::signal<void (const CBlockIndex *, const std::shared_ptr<const CBlock>&)> NewPoWValidBlock;
     boost::signals2::signal<void (const uint256 &)> BlockFound;
     boost::signals2::signal<void (const CMessage &)> NewAssetMessage;
+    boost::signals2::signal<void (const COrderBookUpdate &)> OrderBookUpdated;
+    boost::signals2::signal<void (const std::vector<CAssetNotification> &)> AssetsUpdated;
+    boost::signals2::signal<void (const CMempoolEvent &)> MempoolUpdated;
     boost::signals2::signal<void (const std::string &)> AssetInventory;
 //    boost::signals2::signal<void (std::shared_ptr<CReserveScript>&)> ScriptForMining;
     
@@ -40,6 +184,10 @@ struct MainSignalsInstance {
     // our own queue here :(
     SingleThreadedSchedulerClient m_schedulerClient;
 
+    //! Queues of the subscribers registered with one, see RegisterValidationInterface
+    std::mutex m_cs_queues;
+    std::map<CValidationInterface*, std::unique_ptr<CValidationQueue>> m_queues;
+
     explicit MainSignalsInstance(CScheduler *pscheduler) : m_schedulerClient(pscheduler) {}
 };
 
@@ -56,6 +204,7 @@ void CMainSignals::UnregisterBackgroundSignalScheduler() {
 
 void CMainSignals::FlushBackgroundCallbacks() {
     m_internals->m_schedulerClient.EmptyQueue();
+    SyncWithValidationInterfaceQueues();
 }
 
 CMainSignals& GetMainSignals()
@@ -74,9 +223,57 @@ void RegisterValidationInterface(CValidationInterface* pwalletIn) {
     g_signals.m_internals->NewPoWValidBlock.connect(boost::bind(&CValidationInterface::NewPoWValidBlock, pwalletIn, _1, _2));
     g_signals.m_internals->BlockFound.connect(boost::bind(&CValidationInterface::BlockFound, pwalletIn, _1));
     g_signals.m_internals->NewAssetMessage.connect(boost::bind(&CValidationInterface::NewAssetMessage, pwalletIn, _1));
+    g_signals.m_internals->OrderBookUpdated.connect(boost::bind(&CValidationInterface::OrderBookUpdated, pwalletIn, _1));
+    g_signals.m_internals->AssetsUpdated.connect(boost::bind(&CValidationInterface::AssetsUpdated, pwalletIn, _1));
+    g_signals.m_internals->MempoolUpdated.connect(boost::bind(&CValidationInterface::MempoolUpdated, pwalletIn, _1));
 //    g_signals.m_internals->ScriptForMining.connect(boost::bind(&CValidationInterface::GetScriptForMining, pwalletIn, _1));
 }
 
+void RegisterValidationInterface(CValidationInterface* pwalletIn, const ValidationQueueOptions& options) {
+    MainSignalsInstance& internals = *g_signals.m_internals;
+    std::unique_ptr<CValidationQueue> queue(new CValidationQueue(options));
+    CValidationQueue* pqueue = queue.get();
+    pqueue->Connect(internals.UpdatedBlockTip.connect([pqueue, pwalletIn](const CBlockIndex *pindexNew, const CBlockIndex *pindexFork, bool fInitialDownload) {
+        pqueue->Push([=] { pwalletIn->UpdatedBlockTip(pindexNew, pindexFork, fInitialDownload); });
+    }));
+    pqueue->Connect(internals.TransactionAddedToMempool.connect([pqueue, pwalletIn](const CTransactionRef &ptx) {
+        pqueue->Push([=] { pwalletIn->TransactionAddedToMempool(ptx); });
+    }));
+    pqueue->Connect(internals.BlockConnected.connect([pqueue, pwalletIn](const std::shared_ptr<const CBlock> &pblock, const CBlockIndex *pindex, const std::vector<CTransactionRef>& vtxConflicted) {
+        pqueue->Push([=] { pwalletIn->BlockConnected(pblock, pindex, vtxConflicted); });
+    }));
+    pqueue->Connect(internals.BlockDisconnected.connect([pqueue, pwalletIn](const std::shared_ptr<const CBlock> &pblock) {
+        pqueue->Push([=] { pwalletIn->BlockDisconnected(pblock); });
+    }));
+    pqueue->Connect(internals.SetBestChain.connect([pqueue, pwalletIn](const CBlockLocator &locator) {
+        pqueue->Push([=] { pwalletIn->SetBestChain(locator); });
+    }));
+    pqueue->Connect(internals.Broadcast.connect([pqueue, pwalletIn](int64_t nBestBlockTime, CConnman* connman) {
+        pqueue->Push([=] { pwalletIn->ResendWalletTransactions(nBestBlockTime, connman); });
+    }));
+    pqueue->Connect(internals.BlockFound.connect([pqueue, pwalletIn](const uint256 &hash) {
+        pqueue->Push([=] { pwalletIn->BlockFound(hash); });
+    }));
+    pqueue->Connect(internals.NewAssetMessage.connect([pqueue, pwalletIn](const CMessage &message) {
+        pqueue->Push([=] { pwalletIn->NewAssetMessage(message); });
+    }));
+    pqueue->Connect(internals.OrderBookUpdated.connect([pqueue, pwalletIn](const COrderBookUpdate &update) {
+        pqueue->Push([=] { pwalletIn->OrderBookUpdated(update); });
+    }));
+    pqueue->Connect(internals.AssetsUpdated.connect([pqueue, pwalletIn](const std::vector<CAssetNotification> &vNotifications) {
+        pqueue->Push([=] { pwalletIn->AssetsUpdated(vNotifications); });
+    }));
+    pqueue->Connect(internals.MempoolUpdated.connect([pqueue, pwalletIn](const CMempoolEvent &event) {
+        pqueue->Push([=] { pwalletIn->MempoolUpdated(event); });
+    }));
+    // Their callers act on what the subscribers do straight away
+    internals.BlockChecked.connect(boost::bind(&CValidationInterface::BlockChecked, pwalletIn, _1, _2));
+    internals.NewPoWValidBlock.connect(boost::bind(&CValidationInterface::NewPoWValidBlock, pwalletIn, _1, _2));
+
+    std::lock_guard<std::mutex> lock(internals.m_cs_queues);
+    internals.m_queues[pwalletIn] = std::move(queue);
+}
+
 void UnregisterValidationInterface(CValidationInterface* pwalletIn) {
     g_signals.m_internals->BlockChecked.disconnect(boost::bind(&CValidationInterface::BlockChecked, pwalletIn, _1, _2));
     g_signals.m_internals->Broadcast.disconnect(boost::bind(&CValidationInterface::ResendWalletTransactions, pwalletIn, _1, _2));
@@ -88,7 +285,22 @@ void UnregisterValidationInterface(CValidationInterface* pwalletIn) {
     g_signals.m_internals->NewPoWValidBlock.disconnect(boost::bind(&CValidationInterface::NewPoWValidBlock, pwalletIn, _1, _2));
     g_signals.m_internals->BlockFound.disconnect(boost::bind(&CValidationInterface::BlockFound, pwalletIn, _1));
     g_signals.m_internals->NewAssetMessage.disconnect(boost::bind(&CValidationInterface::NewAssetMessage, pwalletIn, _1));
+    g_signals.m_internals->OrderBookUpdated.disconnect(boost::bind(&CValidationInterface::OrderBookUpdated, pwalletIn, _1));
+    g_signals.m_internals->AssetsUpdated.disconnect(boost::bind(&CValidationInterface::AssetsUpdated, pwalletIn, _1));
+    g_signals.m_internals->MempoolUpdated.disconnect(boost::bind(&CValidationInterface::MempoolUpdated, pwalletIn, _1));
 //    g_signals.m_internals->ScriptForMining.disconnect(boost::bind(&CValidationInterface::GetScriptForMining, pwalletIn, _1));
+
+    std::unique_ptr<CValidationQueue> queue;
+    {
+        std::lock_guard<std::mutex> lock(g_signals.m_internals->m_cs_queues);
+        auto it = g_signals.m_internals->m_queues.find(pwalletIn);
+        if (it != g_signals.m_internals->m_queues.end()) {
+            queue = std::move(it->second);
+            g_signals.m_internals->m_queues.erase(it);
+        }
+    }
+    // Runs what was queued for it before returning
+    queue.reset();
 }
 
 void UnregisterAllValidationInterfaces() {
@@ -102,7 +314,32 @@ void UnregisterAllValidationInterfaces() {
     g_signals.m_internals->NewPoWValidBlock.disconnect_all_slots();
     g_signals.m_internals->BlockFound.disconnect_all_slots();
     g_signals.m_internals->NewAssetMessage.disconnect_all_slots();
+    g_signals.m_internals->OrderBookUpdated.disconnect_all_slots();
+    g_signals.m_internals->AssetsUpdated.disconnect_all_slots();
+    g_signals.m_internals->MempoolUpdated.disconnect_all_slots();
 //    g_signals.m_internals->ScriptForMining.disconnect_all_slots();
+
+    std::map<CValidationInterface*, std::unique_ptr<CValidationQueue>> queues;
+    {
+        std::lock_guard<std::mutex> lock(g_signals.m_internals->m_cs_queues);
+        queues.swap(g_signals.m_internals->m_queues);
+    }
+}
+
+void SyncWithValidationInterfaceQueues() {
+    std::lock_guard<std::mutex> lock(g_signals.m_internals->m_cs_queues);
+    for (const auto& entry : g_signals.m_internals->m_queues)
+        entry.second->Sync();
+}
+
+std::vector<ValidationQueueStats> GetValidationQueueStats() {
+    std::vector<ValidationQueueStats> vStats;
+    if (!g_signals.m_internals)
+        return vStats;
+    std::lock_guard<std::mutex> lock(g_signals.m_internals->m_cs_queues);
+    for (const auto& entry : g_signals.m_internals->m_queues)
+        vStats.push_back(entry.second->GetStats());
+    return vStats;
 }
 
 void CMainSignals::UpdatedBlockTip(const CBlockIndex *pindexNew, const CBlockIndex *pindexFork, bool fInitialDownload) {
@@ -144,3 +381,19 @@ void CMainSignals::BlockFound(const uint256 &hash) {
 void CMainSignals::NewAssetMessage(const CMessage& message) {
     m_internals->NewAssetMessage(message);
 }
+
+void CMainSignals::AssetsUpdated(const std::vector<CAssetNotification>& vNotifications) {
+    m_internals->AssetsUpdated(vNotifications);
+}
+
+void CMainSignals::MempoolUpdated(const CMempoolEvent& event) {
+    // Mempools are also used without a running node (unit tests)
+    if (m_internals)
+        m_internals->MempoolUpdated(event);
+}
+
+void CMainSignals::OrderBookUpdated(const COrderBookUpdate& update) {
+    // The order books are also used without a running node (unit tests)
+    if (m_internals)
+        m_internals->OrderBookUpdated(update);
+}
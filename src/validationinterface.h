@@ -8,6 +8,8 @@
 #define MYNTA_VALIDATIONINTERFACE_H
 
 #include <memory>
+#include <string>
+#include <vector>
 
 #include "primitives/transaction.h" // CTransaction(Ref)
 
@@ -22,15 +24,63 @@ class CValidationState;
 class uint256;
 class CScheduler;
 class CMessage;
+class COrderBookUpdate;
+class CAssetNotification;
+class CMempoolEvent;
+
+/** What a subscriber queue does with an event that finds it full */
+enum class ValidationQueuePolicy {
+    WAIT,           //!< Hold up the caller until there is room, for at most VALIDATION_QUEUE_MAX_WAIT_MS, then queue it anyway
+    DROP_OLDEST,    //!< Drop the event that has waited longest
+    DROP_NEWEST,    //!< Drop the new event
+};
+
+//! Longest a WAIT queue holds up the caller. Callers may hold cs_main, which the subscriber could be waiting for.
+static const int64_t VALIDATION_QUEUE_MAX_WAIT_MS = 1000;
+//! Default number of events a subscriber queue holds
+static const size_t DEFAULT_VALIDATION_QUEUE_DEPTH = 1000;
+
+/** How a subscriber registered with a queue of its own is fed */
+struct ValidationQueueOptions {
+    std::string strName;
+    size_t nMaxDepth = DEFAULT_VALIDATION_QUEUE_DEPTH;
+    ValidationQueuePolicy policy = ValidationQueuePolicy::WAIT;
+};
+
+/** Depth and throughput of a subscriber queue since it was registered */
+struct ValidationQueueStats {
+    std::string strName;
+    ValidationQueuePolicy policy;
+    size_t nDepth;          //!< Events waiting now
+    size_t nMaxDepth;
+    size_t nPeakDepth;      //!< Most events that have waited at once
+    uint64_t nProcessed;
+    uint64_t nDropped;
+    uint64_t nOverflows;    //!< Events a WAIT queue took past nMaxDepth after waiting its longest
+    int64_t nWaitMicros;    //!< Time callers spent waiting for room
+    int64_t nBusyMicros;    //!< Time spent in the subscriber's callbacks
+};
 
 // These functions dispatch to one or all registered wallets
 
 /** Register a wallet to receive updates from core */
 void RegisterValidationInterface(CValidationInterface* pwalletIn);
-/** Unregister a wallet from core */
+/**
+ * Register a subscriber whose callbacks run in order on a thread of its own,
+ * fed from a bounded queue, so a slow subscriber doesn't hold up validation or
+ * the others. Arguments are kept alive until the callback has run. BlockChecked
+ * and NewPoWValidBlock are still called synchronously, as callers go on based
+ * on what they do.
+ */
+void RegisterValidationInterface(CValidationInterface* pwalletIn, const ValidationQueueOptions& options);
+/** Unregister a wallet from core. A queued subscriber gets its remaining events first. */
 void UnregisterValidationInterface(CValidationInterface* pwalletIn);
 /** Unregister all wallets from core */
 void UnregisterAllValidationInterfaces();
+/** Wait until every subscriber queue has run the events queued so far. Must not be called holding cs_main. */
+void SyncWithValidationInterfaceQueues();
+/** Stats of each subscriber queue, see getvalidationqueueinfo */
+std::vector<ValidationQueueStats> GetValidationQueueStats();
 
 class CValidationInterface {
 protected:
@@ -69,10 +119,17 @@ protected:
 
     virtual void BlockFound(const uint256 &hash) {};
     virtual void NewAssetMessage(const CMessage &message) {};
+    /** Notifies listeners of an offer entering or leaving an order book (see COrderBookUpdate) */
+    virtual void OrderBookUpdated(const COrderBookUpdate &update) {};
+    /** Notifies listeners of the asset changes of a block that was connected or disconnected (see CAssetNotification) */
+    virtual void AssetsUpdated(const std::vector<CAssetNotification> &vNotifications) {};
+    /** Notifies listeners of a transaction entering or leaving the mempool, in sequence (see CMempoolEvent) */
+    virtual void MempoolUpdated(const CMempoolEvent &event) {};
 
 //    virtual void GetScriptForMining(std::shared_ptr<CReserveScript>&) {};
 
     friend void ::RegisterValidationInterface(CValidationInterface*);
+    friend void ::RegisterValidationInterface(CValidationInterface*, const ValidationQueueOptions&);
     friend void ::UnregisterValidationInterface(CValidationInterface*);
     friend void ::UnregisterAllValidationInterfaces();
 };
@@ -84,15 +141,18 @@ private:
     std::unique_ptr<MainSignalsInstance> m_internals;
 
     friend void ::RegisterValidationInterface(CValidationInterface*);
+    friend void ::RegisterValidationInterface(CValidationInterface*, const ValidationQueueOptions&);
     friend void ::UnregisterValidationInterface(CValidationInterface*);
     friend void ::UnregisterAllValidationInterfaces();
+    friend void ::SyncWithValidationInterfaceQueues();
+    friend std::vector<ValidationQueueStats> (::GetValidationQueueStats)();
 
 public:
     /** Register a CScheduler to give callbacks which should run in the background (may only be called once) */
     void RegisterBackgroundSignalScheduler(CScheduler& scheduler);
     /** Unregister a CScheduler to give callbacks which should run in the background - these callbacks will now be dropped! */
     void UnregisterBackgroundSignalScheduler();
-    /** Call any remaining callbacks on the calling thread */
+    /** Call any remaining callbacks on the calling thread, and wait for the subscriber queues to run theirs */
     void FlushBackgroundCallbacks();
 
     void UpdatedBlockTip(const CBlockIndex *, const CBlockIndex *, bool fInitialDownload);
@@ -105,6 +165,9 @@ public:
     void NewPoWValidBlock(const CBlockIndex *, const std::shared_ptr<const CBlock>&);
     void BlockFound(const uint256 &);
     void NewAssetMessage(const CMessage&);
+    void OrderBookUpdated(const COrderBookUpdate&);
+    void AssetsUpdated(const std::vector<CAssetNotification>&);
+    void MempoolUpdated(const CMempoolEvent&);
 //    void ScriptForMining(std::shared_ptr<CReserveScript>&);
 
 };
@@ -0,0 +1,66 @@
+// Copyright (c) 2026 The Mynta Core Developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include "validationstats.h"
+
+#include "tinyformat.h"
+
+static const char* const VALIDATION_PHASE_NAMES[VALIDATION_PHASE_COUNT] = {
+    "load_block",
+    "check_block",
+    "fork_checks",
+    "connect_txs",
+    "asset_checks",
+    "script_verify",
+    "index_writes",
+    "connect_block",
+    "asset_tasks",
+    "coins_flush",
+    "asset_flush",
+    "chainstate_write",
+    "post_connect",
+    "connect_tip",
+    "disconnect_tip",
+};
+
+static CTimingHistogram validationHistograms[VALIDATION_PHASE_COUNT];
+
+const char* ValidationPhaseName(ValidationPhase phase)
+{
+    return VALIDATION_PHASE_NAMES[static_cast<size_t>(phase)];
+}
+
+void RecordValidationTime(ValidationPhase phase, int64_t nMicros)
+{
+    validationHistograms[static_cast<size_t>(phase)].Add(nMicros);
+}
+
+CValidationPhaseStats GetValidationPhaseStats(ValidationPhase phase)
+{
+    return validationHistograms[static_cast<size_t>(phase)].GetStats();
+}
+
+void ResetValidationStats()
+{
+    for (CTimingHistogram& histogram : validationHistograms)
+        histogram.Reset();
+}
+
+std::string ValidationStatsToPrometheus()
+{
+    std::string strOut;
+    strOut += "# HELP mynta_validation_phase_seconds Time blocks spent in each phase of validation\n";
+    strOut += "# TYPE mynta_validation_phase_seconds summary\n";
+    for (size_t i = 0; i < VALIDATION_PHASE_COUNT; i++) {
+        const char* strPhase = VALIDATION_PHASE_NAMES[i];
+        const CValidationPhaseStats stats = validationHistograms[i].GetStats();
+        const std::pair<const char*, int64_t> quantiles[] = {
+            {"0.5", stats.nP50Micros}, {"0.9", stats.nP90Micros}, {"0.99", stats.nP99Micros}};
+        for (const auto& quantile : quantiles)
+            strOut += strprintf("mynta_validation_phase_seconds{phase=\"%s\",quantile=\"%s\"} %.6f\n", strPhase, quantile.first, quantile.second * 1e-6);
+        strOut += strprintf("mynta_validation_phase_seconds_sum{phase=\"%s\"} %.6f\n", strPhase, stats.nTotalMicros * 1e-6);
+        strOut += strprintf("mynta_validation_phase_seconds_count{phase=\"%s\"} %u\n", strPhase, stats.nCount);
+    }
+    return strOut;
+}
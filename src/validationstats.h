@@ -0,0 +1,58 @@
+// Copyright (c) 2026 The Mynta Core Developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#ifndef MYNTA_VALIDATIONSTATS_H
+#define MYNTA_VALIDATIONSTATS_H
+
+#include "timinghistogram.h"
+
+#include <stdint.h>
+#include <string>
+
+/**
+ * Parts of connecting and disconnecting a block that are timed. The phases
+ * inside ConnectBlock (CHECK_BLOCK up to INDEX_WRITES) run within
+ * CONNECT_BLOCK, and ASSET_CHECKS within CONNECT_TXS, so the phases do not
+ * add up to the total. The ConnectBlock phases also count blocks that are
+ * only checked, such as new block templates.
+ */
+enum class ValidationPhase : uint8_t
+{
+    LOAD_BLOCK,       //!< reading the block from disk when it is not in memory
+    CHECK_BLOCK,      //!< CheckBlock again before connecting
+    FORK_CHECKS,      //!< BIP30 and the other checks depending on the deployments
+    CONNECT_TXS,      //!< inputs, asset checks and coin updates of every transaction
+    ASSET_CHECKS,     //!< Consensus::CheckTxAssets for every transaction
+    SCRIPT_VERIFY,    //!< from the first transaction until the script check queue is done
+    INDEX_WRITES,     //!< undo data and the tx, address, spent and timestamp indexes
+    CONNECT_BLOCK,    //!< all of ConnectBlock
+    ASSET_TASKS,      //!< clearing the reissue maps after a block
+    COINS_FLUSH,      //!< flushing the block's coins into the tip cache
+    ASSET_FLUSH,      //!< flushing the block's asset cache and publishing its changes
+    CHAINSTATE_WRITE, //!< FlushStateToDisk after a block, when it writes
+    POST_CONNECT,     //!< mempool update and moving the tip
+    CONNECT_TIP,      //!< all of connecting a block to the tip
+    DISCONNECT_TIP,   //!< disconnecting a block from the tip, up to its flush
+    COUNT
+};
+
+static const size_t VALIDATION_PHASE_COUNT = static_cast<size_t>(ValidationPhase::COUNT);
+
+/** Name of a phase as getvalidationstats reports it */
+const char* ValidationPhaseName(ValidationPhase phase);
+
+typedef CTimingStats CValidationPhaseStats;
+
+/** Add the time one block spent in a phase */
+void RecordValidationTime(ValidationPhase phase, int64_t nMicros);
+
+CValidationPhaseStats GetValidationPhaseStats(ValidationPhase phase);
+
+/** Forget all samples */
+void ResetValidationStats();
+
+/** All phases in the Prometheus text exposition format, as summaries in seconds */
+std::string ValidationStatsToPrometheus();
+
+#endif // MYNTA_VALIDATIONSTATS_H
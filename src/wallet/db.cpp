@@ -15,6 +15,8 @@
 
 #include <stdint.h>
 
+#include <leveldb/iterator.h>
+
 #ifndef WIN32
 #include <sys/stat.h>
 #endif
@@ -204,6 +206,10 @@ bool CDB::Recover(const std::string& filename, void *callbackDataIn, bool (*reco
     // Rewrite salvaged data to fresh wallet file
     // Set -rescan so any missing transactions will be
     // found.
+    if (IsLDBWallet(filename, GetDataDir())) {
+        LogPrintf("Salvage: %s is a LevelDB wallet, which can't be salvaged\n", filename);
+        return false;
+    }
     int64_t now = GetTime();
     newFilename = strprintf("%s.%d.bak", filename, now);
 
@@ -297,6 +303,9 @@ bool CDB::VerifyEnvironment(const std::string& walletFile, const fs::path& dataD
 
 bool CDB::VerifyDatabaseFile(const std::string& walletFile, const fs::path& dataDir, std::string& warningStr, std::string& errorStr, CDBEnv::recoverFunc_type recoverFunc)
 {
+    // LevelDB checks its own files as it opens them
+    if (IsLDBWallet(walletFile, dataDir))
+        return true;
     if (fs::exists(dataDir / walletFile))
     {
         std::string backup_filename;
@@ -394,6 +403,16 @@ void CDBEnv::CheckpointLSN(const std::string& strFile)
 }
 
 
+CDBCursor::CDBCursor(Dbc* pcursorIn) : pcursor(pcursorIn), fStarted(false) {}
+
+CDBCursor::CDBCursor(leveldb::Iterator* piterIn) : pcursor(nullptr), piter(piterIn), fStarted(false) {}
+
+CDBCursor::~CDBCursor()
+{
+    if (pcursor)
+        pcursor->close();
+}
+
 CDB::CDB(CWalletDBWrapper& dbw, const char* pszMode, bool fFlushOnCloseIn) : pdb(nullptr), activeTxn(nullptr)
 {
     fReadOnly = (!strchr(pszMode, '+') && !strchr(pszMode, 'w'));
@@ -405,6 +424,17 @@ CDB::CDB(CWalletDBWrapper& dbw, const char* pszMode, bool fFlushOnCloseIn) : pdb
     const std::string &strFilename = dbw.strFile;
 
     bool fCreate = strchr(pszMode, 'c') != nullptr;
+    if (dbw.ldb) {
+        pldb = dbw.ldb;
+        strFile = strFilename;
+        if (fCreate && !Exists(std::string("version"))) {
+            bool fTmp = fReadOnly;
+            fReadOnly = false;
+            WriteVersion(CLIENT_VERSION);
+            fReadOnly = fTmp;
+        }
+        return;
+    }
     unsigned int nFlags = DB_THREAD;
     if (fCreate)
         nFlags |= DB_CREATE;
@@ -455,8 +485,150 @@ CDB::CDB(CWalletDBWrapper& dbw, const char* pszMode, bool fFlushOnCloseIn) : pdb
     }
 }
 
+bool CDB::LDBRead(const CDataStream& ssKey, std::string& strValue)
+{
+    const std::string strKey(ssKey.begin(), ssKey.end());
+    if (pldbTxn) {
+        int nTxn = pldbTxn->Read(strKey, strValue);
+        if (nTxn >= 0)
+            return nTxn == 1;
+    }
+    return pldb->Read(strKey, strValue);
+}
+
+bool CDB::LDBWrite(const CDataStream& ssKey, const CDataStream* pssValue)
+{
+    CLDBStoreBatch batch;
+    CLDBStoreBatch& writes = pldbTxn ? *pldbTxn : batch;
+    const std::string strKey(ssKey.begin(), ssKey.end());
+    if (pssValue)
+        writes.Write(strKey, std::string(pssValue->begin(), pssValue->end()));
+    else
+        writes.Erase(strKey);
+    return pldbTxn || pldb->Write(batch);
+}
+
+CDBCursor* CDB::GetCursor()
+{
+    if (pldb)
+        return new CDBCursor(pldb->NewIterator());
+    if (!pdb)
+        return nullptr;
+    Dbc* pcursor = nullptr;
+    int ret = pdb->cursor(nullptr, &pcursor, 0);
+    if (ret != 0)
+        return nullptr;
+    return new CDBCursor(pcursor);
+}
+
+int CDB::ReadAtCursor(CDBCursor* pcursor, CDataStream& ssKey, CDataStream& ssValue, bool setRange)
+{
+    if (pcursor->piter) {
+        leveldb::Iterator* piter = pcursor->piter.get();
+        if (setRange)
+            piter->Seek(leveldb::Slice(ssKey.data(), ssKey.size()));
+        else if (!pcursor->fStarted)
+            piter->SeekToFirst();
+        else
+            piter->Next();
+        pcursor->fStarted = true;
+        if (!piter->Valid())
+            return piter->status().ok() ? DB_NOTFOUND : 99999;
+
+        ssKey.SetType(SER_DISK);
+        ssKey.clear();
+        ssKey.write(piter->key().data(), piter->key().size());
+        ssValue.SetType(SER_DISK);
+        ssValue.clear();
+        ssValue.write(piter->value().data(), piter->value().size());
+        return 0;
+    }
+
+    // Read at cursor
+    Dbt datKey;
+    unsigned int fFlags = DB_NEXT;
+    if (setRange) {
+        datKey.set_data(ssKey.data());
+        datKey.set_size(ssKey.size());
+        fFlags = DB_SET_RANGE;
+    }
+    Dbt datValue;
+    datKey.set_flags(DB_DBT_MALLOC);
+    datValue.set_flags(DB_DBT_MALLOC);
+    int ret = pcursor->pcursor->get(&datKey, &datValue, fFlags);
+    if (ret != 0)
+        return ret;
+    else if (datKey.get_data() == nullptr || datValue.get_data() == nullptr)
+        return 99999;
+
+    // Convert to streams
+    ssKey.SetType(SER_DISK);
+    ssKey.clear();
+    ssKey.write((char*)datKey.get_data(), datKey.get_size());
+    ssValue.SetType(SER_DISK);
+    ssValue.clear();
+    ssValue.write((char*)datValue.get_data(), datValue.get_size());
+
+    // Clear and free memory
+    memory_cleanse(datKey.get_data(), datKey.get_size());
+    memory_cleanse(datValue.get_data(), datValue.get_size());
+    free(datKey.get_data());
+    free(datValue.get_data());
+    return 0;
+}
+
+bool CDB::TxnBegin()
+{
+    if (pldb) {
+        if (pldbTxn)
+            return false;
+        pldbTxn.reset(new CLDBStoreBatch());
+        return true;
+    }
+    if (!pdb || activeTxn)
+        return false;
+    DbTxn* ptxn = bitdb.TxnBegin();
+    if (!ptxn)
+        return false;
+    activeTxn = ptxn;
+    return true;
+}
+
+bool CDB::TxnCommit()
+{
+    if (pldb) {
+        if (!pldbTxn)
+            return false;
+        std::unique_ptr<CLDBStoreBatch> batch = std::move(pldbTxn);
+        return pldb->Write(*batch);
+    }
+    if (!pdb || !activeTxn)
+        return false;
+    int ret = activeTxn->commit(0);
+    activeTxn = nullptr;
+    return (ret == 0);
+}
+
+bool CDB::TxnAbort()
+{
+    if (pldb) {
+        if (!pldbTxn)
+            return false;
+        pldbTxn.reset();
+        return true;
+    }
+    if (!pdb || !activeTxn)
+        return false;
+    int ret = activeTxn->abort();
+    activeTxn = nullptr;
+    return (ret == 0);
+}
+
 void CDB::Flush()
 {
+    // LevelDB writes reach its log as they are made, CWalletDBWrapper::Flush syncs it
+    if (pldb)
+        return;
     if (activeTxn)
         return;
 
@@ -475,6 +647,11 @@ void CWalletDBWrapper::IncrementUpdateCounter()
 
 void CDB::Close()
 {
+    if (pldb) {
+        pldbTxn.reset();
+        pldb.reset();
+        return;
+    }
     if (!pdb)
         return;
     if (activeTxn)
@@ -510,6 +687,29 @@ bool CDB::Rewrite(CWalletDBWrapper& dbw, const char* pszSkip)
     if (dbw.IsDummy()) {
         return true;
     }
+    if (dbw.ldb) {
+        // No copy needed: erase the skipped records, and compaction drops them from the files
+        LogPrintf("CDB::Rewrite: Rewriting %s...\n", dbw.strFile);
+        CDB db(dbw, "r+");
+        bool fSuccess = db.TxnBegin();
+        if (pszSkip) {
+            std::unique_ptr<CDBCursor> pcursor(db.GetCursor());
+            CDataStream ssKey(SER_DISK, CLIENT_VERSION);
+            CDataStream ssValue(SER_DISK, CLIENT_VERSION);
+            int ret = 0;
+            while (fSuccess && (ret = db.ReadAtCursor(pcursor.get(), ssKey, ssValue)) == 0) {
+                if (strncmp(ssKey.data(), pszSkip, std::min(ssKey.size(), strlen(pszSkip))) == 0)
+                    fSuccess = db.LDBWrite(ssKey, nullptr);
+            }
+            fSuccess = fSuccess && ret == DB_NOTFOUND;
+        }
+        fSuccess = fSuccess && db.WriteVersion(CLIENT_VERSION) && db.TxnCommit();
+        if (fSuccess)
+            dbw.ldb->Compact();
+        else
+            LogPrintf("CDB::Rewrite: Failed to rewrite database %s\n", dbw.strFile);
+        return fSuccess;
+    }
     CDBEnv *env = dbw.env;
     const std::string& strFile = dbw.strFile;
     while (true) {
@@ -539,17 +739,15 @@ bool CDB::Rewrite(CWalletDBWrapper& dbw, const char* pszSkip)
                         fSuccess = false;
                     }
 
-                    Dbc* pcursor = db.GetCursor();
+                    std::unique_ptr<CDBCursor> pcursor(db.GetCursor());
                     if (pcursor)
                         while (fSuccess) {
                             CDataStream ssKey(SER_DISK, CLIENT_VERSION);
                             CDataStream ssValue(SER_DISK, CLIENT_VERSION);
-                            int ret1 = db.ReadAtCursor(pcursor, ssKey, ssValue);
+                            int ret1 = db.ReadAtCursor(pcursor.get(), ssKey, ssValue);
                             if (ret1 == DB_NOTFOUND) {
-                                pcursor->close();
                                 break;
                             } else if (ret1 != 0) {
-                                pcursor->close();
                                 fSuccess = false;
                                 break;
                             }
@@ -567,6 +765,7 @@ bool CDB::Rewrite(CWalletDBWrapper& dbw, const char* pszSkip)
                             if (ret2 > 0)
                                 fSuccess = false;
                         }
+                    pcursor.reset();
                     if (fSuccess) {
                         db.Close();
                         env->CloseDb(strFile);
@@ -640,6 +839,9 @@ bool CDB::PeriodicFlush(CWalletDBWrapper& dbw)
     if (dbw.IsDummy()) {
         return true;
     }
+    if (dbw.ldb) {
+        return dbw.ldb->Flush();
+    }
     bool ret = false;
     CDBEnv *env = dbw.env;
     const std::string& strFile = dbw.strFile;
@@ -688,6 +890,19 @@ bool CWalletDBWrapper::Backup(const std::string& strDest)
     if (IsDummy()) {
         return false;
     }
+    if (ldb) {
+        fs::path pathDest(strDest);
+        if (fs::is_directory(pathDest) && !fs::exists(pathDest / "CURRENT"))
+            pathDest /= strFile;
+        try {
+            if (fs::exists(pathDest))
+                fs::remove_all(pathDest);
+        } catch (const fs::filesystem_error& e) {
+            LogPrintf("error replacing %s - %s\n", pathDest.string(), e.what());
+            return false;
+        }
+        return ldb->Backup(pathDest);
+    }
     while (true)
     {
         {
@@ -721,7 +936,27 @@ bool CWalletDBWrapper::Backup(const std::string& strDest)
 
 void CWalletDBWrapper::Flush(bool shutdown)
 {
-    if (!IsDummy()) {
+    if (ldb) {
+        ldb->Flush();
+    } else if (!IsDummy()) {
         env->Flush(shutdown);
     }
 }
+
+void CWalletDBWrapper::BeginBatch()
+{
+    if (ldb)
+        ldb->BeginBatch();
+}
+
+bool CWalletDBWrapper::CommitBatch()
+{
+    return !ldb || ldb->CommitBatch();
+}
+
+std::unique_ptr<CWalletDBWrapper> CWalletDBWrapper::Open(const std::string& walletFile)
+{
+    if (IsLDBWallet(walletFile, GetDataDir()))
+        return std::unique_ptr<CWalletDBWrapper>(new CWalletDBWrapper(std::make_shared<CLDBStore>(GetDataDir() / walletFile), walletFile));
+    return std::unique_ptr<CWalletDBWrapper>(new CWalletDBWrapper(&bitdb, walletFile));
+}
@@ -11,16 +11,20 @@
 #include "fs.h"
 #include "serialize.h"
 #include "streams.h"
+#include "support/cleanse.h"
 #include "sync.h"
 #include "version.h"
+#include "wallet/ldbstore.h"
 
 #include <atomic>
 #include <map>
+#include <memory>
 #include <string>
 #include <vector>
 
 #include <db_cxx.h>
 
+
 static const unsigned int DEFAULT_WALLET_DBLOGSIZE = 100;
 static const bool DEFAULT_WALLET_PRIVDB = true;
 
@@ -89,7 +93,8 @@ public:
 extern CDBEnv bitdb;
 
 /** An instance of this class represents one database.
- * For BerkeleyDB this is just a (env, strFile) tuple.
+ * For BerkeleyDB this is just a (env, strFile) tuple, for LevelDB the
+ * CLDBStore every CDB on the wallet shares.
  **/
 class CWalletDBWrapper
 {
@@ -106,6 +111,15 @@ public:
     {
     }
 
+    /** Create DB handle to a LevelDB wallet */
+    CWalletDBWrapper(std::shared_ptr<CLDBStore> ldb_in, const std::string &strFile_in) :
+        nUpdateCounter(0), nLastSeen(0), nLastFlushed(0), nLastWalletUpdate(0), env(nullptr), ldb(std::move(ldb_in)), strFile(strFile_in)
+    {
+    }
+
+    /** Create DB handle to walletFile in the data directory, in whichever backend it is in (see IsLDBWallet) */
+    static std::unique_ptr<CWalletDBWrapper> Open(const std::string& walletFile);
+
     /** Rewrite the entire database on disk, with the exception of key pszSkip if non-zero
      */
     bool Rewrite(const char* pszSkip=nullptr);
@@ -122,6 +136,13 @@ public:
      */
     void Flush(bool shutdown);
 
+    /** Hold back the writes through any CDB on this database until the
+     * matching CommitBatch, and write them together. Only the LevelDB
+     * backend batches; Berkeley DB writes them as they come.
+     */
+    void BeginBatch();
+    bool CommitBatch();
+
     void IncrementUpdateCounter();
 
     std::atomic<unsigned int> nUpdateCounter;
@@ -132,17 +153,49 @@ public:
 private:
     /** BerkeleyDB specific */
     CDBEnv *env;
+    /** LevelDB specific */
+    std::shared_ptr<CLDBStore> ldb;
     std::string strFile;
 
     /** Return whether this database handle is a dummy for testing.
      * Only to be used at a low level, application should ideally not care
      * about this.
      */
-    bool IsDummy() { return env == nullptr; }
+    bool IsDummy() { return env == nullptr && !ldb; }
+};
+
+/** Writes through a CWalletDBWrapper are batched while one of these is in scope */
+class CWalletDBBatchScope
+{
+private:
+    CWalletDBWrapper& dbw;
+
+public:
+    explicit CWalletDBBatchScope(CWalletDBWrapper& dbw_in) : dbw(dbw_in) { dbw.BeginBatch(); }
+    ~CWalletDBBatchScope() { dbw.CommitBatch(); }
+
+    CWalletDBBatchScope(const CWalletDBBatchScope&) = delete;
+    CWalletDBBatchScope& operator=(const CWalletDBBatchScope&) = delete;
 };
 
+/** A cursor over the records of a database of either backend, see CDB::GetCursor */
+class CDBCursor
+{
+public:
+    Dbc* pcursor;
+    std::unique_ptr<leveldb::Iterator> piter;
+    bool fStarted;
 
-/** RAII class that provides access to a Berkeley database */
+    explicit CDBCursor(Dbc* pcursorIn);
+    explicit CDBCursor(leveldb::Iterator* piterIn);
+    ~CDBCursor();
+
+    CDBCursor(const CDBCursor&) = delete;
+    CDBCursor& operator=(const CDBCursor&) = delete;
+};
+
+
+/** RAII class that provides access to a Berkeley or LevelDB database */
 class CDB
 {
 protected:
@@ -152,6 +205,12 @@ protected:
     bool fReadOnly;
     bool fFlushOnClose;
     CDBEnv *env;
+    //! The LevelDB store, used instead of pdb, and the writes of an open transaction on it
+    std::shared_ptr<CLDBStore> pldb;
+    std::unique_ptr<CLDBStoreBatch> pldbTxn;
+
+    bool LDBRead(const CDataStream& ssKey, std::string& strValue);
+    bool LDBWrite(const CDataStream& ssKey, const CDataStream* pssValue);
 
 public:
     explicit CDB(CWalletDBWrapper& dbw, const char* pszMode = "r+", bool fFlushOnCloseIn=true);
@@ -176,13 +235,31 @@ public:
     template <typename K, typename T>
     bool Read(const K& key, T& value)
     {
-        if (!pdb)
+        if (!pdb && !pldb)
             return false;
 
         // Key
         CDataStream ssKey(SER_DISK, CLIENT_VERSION);
         ssKey.reserve(1000);
         ssKey << key;
+
+        if (pldb) {
+            std::string strValue;
+            bool fFound = LDBRead(ssKey, strValue);
+            memory_cleanse(ssKey.data(), ssKey.size());
+            bool success = false;
+            if (fFound) {
+                try {
+                    CDataStream ssValue(strValue.data(), strValue.data() + strValue.size(), SER_DISK, CLIENT_VERSION);
+                    ssValue >> value;
+                    success = true;
+                } catch (const std::exception&) {
+                    // In this case success remains 'false'
+                }
+                memory_cleanse(&strValue[0], strValue.size());
+            }
+            return success;
+        }
         Dbt datKey(ssKey.data(), ssKey.size());
 
         // Read
@@ -211,7 +288,7 @@ public:
     template <typename K, typename T>
     bool Write(const K& key, const T& value, bool fOverwrite = true)
     {
-        if (!pdb)
+        if (!pdb && !pldb)
             return true;
         if (fReadOnly)
             assert(!"Write called on database in read-only mode");
@@ -220,12 +297,21 @@ public:
         CDataStream ssKey(SER_DISK, CLIENT_VERSION);
         ssKey.reserve(1000);
         ssKey << key;
-        Dbt datKey(ssKey.data(), ssKey.size());
 
         // Value
         CDataStream ssValue(SER_DISK, CLIENT_VERSION);
         ssValue.reserve(10000);
         ssValue << value;
+
+        if (pldb) {
+            std::string strExisting;
+            bool ret = (fOverwrite || !LDBRead(ssKey, strExisting)) && LDBWrite(ssKey, &ssValue);
+            memory_cleanse(&strExisting[0], strExisting.size());
+            memory_cleanse(ssKey.data(), ssKey.size());
+            memory_cleanse(ssValue.data(), ssValue.size());
+            return ret;
+        }
+        Dbt datKey(ssKey.data(), ssKey.size());
         Dbt datValue(ssValue.data(), ssValue.size());
 
         // Write
@@ -240,7 +326,7 @@ public:
     template <typename K>
     bool Erase(const K& key)
     {
-        if (!pdb)
+        if (!pdb && !pldb)
             return false;
         if (fReadOnly)
             assert(!"Erase called on database in read-only mode");
@@ -249,6 +335,12 @@ public:
         CDataStream ssKey(SER_DISK, CLIENT_VERSION);
         ssKey.reserve(1000);
         ssKey << key;
+
+        if (pldb) {
+            bool ret = LDBWrite(ssKey, nullptr);
+            memory_cleanse(ssKey.data(), ssKey.size());
+            return ret;
+        }
         Dbt datKey(ssKey.data(), ssKey.size());
 
         // Erase
@@ -262,13 +354,21 @@ public:
     template <typename K>
     bool Exists(const K& key)
     {
-        if (!pdb)
+        if (!pdb && !pldb)
             return false;
 
         // Key
         CDataStream ssKey(SER_DISK, CLIENT_VERSION);
         ssKey.reserve(1000);
         ssKey << key;
+
+        if (pldb) {
+            std::string strValue;
+            bool ret = LDBRead(ssKey, strValue);
+            memory_cleanse(&strValue[0], strValue.size());
+            memory_cleanse(ssKey.data(), ssKey.size());
+            return ret;
+        }
         Dbt datKey(ssKey.data(), ssKey.size());
 
         // Exists
@@ -279,81 +379,17 @@ public:
         return (ret == 0);
     }
 
-    Dbc* GetCursor()
-    {
-        if (!pdb)
-            return nullptr;
-        Dbc* pcursor = nullptr;
-        int ret = pdb->cursor(nullptr, &pcursor, 0);
-        if (ret != 0)
-            return nullptr;
-        return pcursor;
-    }
+    //! A cursor over every record, for ReadAtCursor; nullptr if there is none. The caller owns it.
+    CDBCursor* GetCursor();
 
-    int ReadAtCursor(Dbc* pcursor, CDataStream& ssKey, CDataStream& ssValue, bool setRange = false)
-    {
-        // Read at cursor
-        Dbt datKey;
-        unsigned int fFlags = DB_NEXT;
-        if (setRange) {
-            datKey.set_data(ssKey.data());
-            datKey.set_size(ssKey.size());
-            fFlags = DB_SET_RANGE;
-        }
-        Dbt datValue;
-        datKey.set_flags(DB_DBT_MALLOC);
-        datValue.set_flags(DB_DBT_MALLOC);
-        int ret = pcursor->get(&datKey, &datValue, fFlags);
-        if (ret != 0)
-            return ret;
-        else if (datKey.get_data() == nullptr || datValue.get_data() == nullptr)
-            return 99999;
-
-        // Convert to streams
-        ssKey.SetType(SER_DISK);
-        ssKey.clear();
-        ssKey.write((char*)datKey.get_data(), datKey.get_size());
-        ssValue.SetType(SER_DISK);
-        ssValue.clear();
-        ssValue.write((char*)datValue.get_data(), datValue.get_size());
-
-        // Clear and free memory
-        memory_cleanse(datKey.get_data(), datKey.get_size());
-        memory_cleanse(datValue.get_data(), datValue.get_size());
-        free(datKey.get_data());
-        free(datValue.get_data());
-        return 0;
-    }
+    //! Read the record at the cursor and move it on, or to the first record at or after ssKey with setRange.
+    //! Returns 0, DB_NOTFOUND past the last record, or another error.
+    int ReadAtCursor(CDBCursor* pcursor, CDataStream& ssKey, CDataStream& ssValue, bool setRange = false);
 
 public:
-    bool TxnBegin()
-    {
-        if (!pdb || activeTxn)
-            return false;
-        DbTxn* ptxn = bitdb.TxnBegin();
-        if (!ptxn)
-            return false;
-        activeTxn = ptxn;
-        return true;
-    }
-
-    bool TxnCommit()
-    {
-        if (!pdb || !activeTxn)
-            return false;
-        int ret = activeTxn->commit(0);
-        activeTxn = nullptr;
-        return (ret == 0);
-    }
-
-    bool TxnAbort()
-    {
-        if (!pdb || !activeTxn)
-            return false;
-        int ret = activeTxn->abort();
-        activeTxn = nullptr;
-        return (ret == 0);
-    }
+    bool TxnBegin();
+    bool TxnCommit();
+    bool TxnAbort();
 
     bool ReadVersion(int& nVersion)
     {
@@ -0,0 +1,73 @@
+// Copyright (c) 2026 The Mynta Core Developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#ifndef MYNTA_WALLET_HTLCTIMEOUTS_H
+#define MYNTA_WALLET_HTLCTIMEOUTS_H
+
+#include "primitives/transaction.h"
+#include "script/script.h"
+
+#include <functional>
+#include <map>
+#include <queue>
+#include <utility>
+#include <vector>
+
+/**
+ * The HTLCs a wallet can refund, in a min-heap by the height their refund
+ * path opens at, so a new tip only looks at the HTLCs that just became
+ * refundable however many swaps are open.
+ *
+ * Unwatching an HTLC leaves its heap entry behind; PopDue skips entries
+ * whose outpoint isn't watched any more, or is watched for another height.
+ */
+class CHTLCTimeoutQueue
+{
+private:
+    typedef std::pair<uint32_t, COutPoint> Entry;
+
+    std::priority_queue<Entry, std::vector<Entry>, std::greater<Entry>> heap;
+    //! Redeem script and due height of each watched HTLC output
+    std::map<COutPoint, std::pair<CScript, uint32_t>> watched;
+
+public:
+    /** Watch an HTLC output until nDueHeight, replacing an earlier due height */
+    void Watch(const COutPoint& outpoint, const CScript& redeemScript, uint32_t nDueHeight)
+    {
+        watched[outpoint] = std::make_pair(redeemScript, nDueHeight);
+        heap.emplace(nDueHeight, outpoint);
+    }
+
+    bool Unwatch(const COutPoint& outpoint) { return watched.erase(outpoint) > 0; }
+
+    bool IsWatched(const COutPoint& outpoint) const { return watched.count(outpoint) > 0; }
+
+    /** Stop watching the HTLCs due at nHeight or before and return them with their redeem scripts */
+    std::vector<std::pair<COutPoint, CScript>> PopDue(uint32_t nHeight)
+    {
+        std::vector<std::pair<COutPoint, CScript>> vDue;
+        while (!heap.empty() && heap.top().first <= nHeight) {
+            const Entry entry = heap.top();
+            heap.pop();
+            auto it = watched.find(entry.second);
+            if (it == watched.end() || it->second.second != entry.first)
+                continue;
+            vDue.emplace_back(entry.second, std::move(it->second.first));
+            watched.erase(it);
+        }
+        // Don't let entries left by Unwatch pile up while nothing falls due
+        if (heap.size() > 2 * watched.size() + 64) {
+            std::vector<Entry> vLive;
+            vLive.reserve(watched.size());
+            for (const auto& entry : watched)
+                vLive.emplace_back(entry.second.second, entry.first);
+            heap = std::priority_queue<Entry, std::vector<Entry>, std::greater<Entry>>(std::greater<Entry>(), std::move(vLive));
+        }
+        return vDue;
+    }
+
+    size_t Size() const { return watched.size(); }
+};
+
+#endif // MYNTA_WALLET_HTLCTIMEOUTS_H
@@ -10,6 +10,7 @@
 #include "util.h"
 #include "utilmoneystr.h"
 #include "validation.h"
+#include "wallet/ldbstore.h"
 #include "wallet/wallet.h"
 #include "wallet/rpcwallet.h"
 
@@ -26,6 +27,7 @@ std::string GetWalletHelpString(bool showDebug)
                                                                             CURRENCY_UNIT, FormatMoney(DEFAULT_DISCARD_FEE)));
     strUsage += HelpMessageOpt("-disablewallet", _("Do not load the wallet and disable wallet RPC calls"));
     strUsage += HelpMessageOpt("-fallbackfee=<amt>", strprintf(_("A fee rate (in %s/kB) that will be used when fee estimation has insufficient data (default: %s)"), CURRENCY_UNIT, FormatMoney(DEFAULT_FALLBACK_FEE)));
+    strUsage += HelpMessageOpt("-htlcautorefund", strprintf(_("Refund the wallet's HTLCs automatically once their timeout is reached and they weren't claimed (default: %u)"), DEFAULT_HTLC_AUTOREFUND));
     strUsage += HelpMessageOpt("-keypool=<n>", strprintf(_("Set key pool size to <n> (default: %u)"), DEFAULT_KEYPOOL_SIZE));
     strUsage += HelpMessageOpt("-mintxfee=<amt>", strprintf(_("Fees (in %s/kB) smaller than this are considered zero fee for transaction creation (default: %s)"), CURRENCY_UNIT, FormatMoney(DEFAULT_TRANSACTION_MINFEE)));
     strUsage += HelpMessageOpt("-mnemonic=<word-list>", strprintf(_("A space separated list of 12-words used to import a bip44 wallet")));
@@ -37,6 +39,7 @@ std::string GetWalletHelpString(bool showDebug)
     strUsage += HelpMessageOpt("-txconfirmtarget=<n>", strprintf(_("If paytxfee is not set, include enough fee so transactions begin confirmation on average within n blocks (default: %u)"), DEFAULT_TX_CONFIRM_TARGET));
     strUsage += HelpMessageOpt("-upgradewallet", _("Upgrade wallet to latest format on startup"));
     strUsage += HelpMessageOpt("-walletrbf", strprintf(_("Send transactions with full-RBF opt-in enabled (default: %u)"), DEFAULT_WALLET_RBF));
+    strUsage += HelpMessageOpt("-walletbackend=<backend>", strprintf(_("Database new wallets are created in, bdb or leveldb; existing wallets keep theirs (default: %s)"), DEFAULT_WALLET_BACKEND));
     strUsage += HelpMessageOpt("-wallet=<file>", _("Specify wallet file (within data directory)") + " " + strprintf(_("(default: %s)"), DEFAULT_WALLET_DAT));
     strUsage += HelpMessageOpt("-walletbroadcast", _("Make the wallet broadcast transactions") + " " + strprintf(_("(default: %u)"), DEFAULT_WALLETBROADCAST));
     strUsage += HelpMessageOpt("-walletnotify=<cmd>", _("Execute command when a wallet transaction changes (%s in cmd is replaced by TxID)"));
@@ -176,6 +179,7 @@ bool WalletParameterInteraction()
     nTxConfirmTarget = gArgs.GetArg("-txconfirmtarget", DEFAULT_TX_CONFIRM_TARGET);
     bSpendZeroConfChange = gArgs.GetBoolArg("-spendzeroconfchange", DEFAULT_SPEND_ZEROCONF_CHANGE);
     fWalletRbf = gArgs.GetBoolArg("-walletrbf", DEFAULT_WALLET_RBF);
+    fHTLCAutoRefund = gArgs.GetBoolArg("-htlcautorefund", DEFAULT_HTLC_AUTOREFUND);
 
     return true;
 }
@@ -194,6 +198,11 @@ bool VerifyWallets()
 
     uiInterface.InitMessage(_("Verifying wallet(s)..."));
 
+    const std::string strBackend = gArgs.GetArg("-walletbackend", DEFAULT_WALLET_BACKEND);
+    if (strBackend != "bdb" && strBackend != "leveldb") {
+        return InitError(strprintf(_("Unknown -walletbackend: '%s'"), strBackend));
+    }
+
     // Keep track of each wallet absolute path to detect duplicates.
     std::set<fs::path> wallet_paths;
 
@@ -208,7 +217,9 @@ bool VerifyWallets()
 
         fs::path wallet_path = fs::absolute(walletFile, GetDataDir());
 
-        if (fs::exists(wallet_path) && (!fs::is_regular_file(wallet_path) || fs::is_symlink(wallet_path))) {
+        // A LevelDB wallet is a directory
+        const bool fLDBWallet = IsLDBWallet(walletFile, GetDataDir());
+        if (fs::exists(wallet_path) && (!(fLDBWallet || fs::is_regular_file(wallet_path)) || fs::is_symlink(wallet_path))) {
             return InitError(strprintf(_("Error loading wallet %s. -wallet filename must be a regular file."), walletFile));
         }
 
@@ -222,6 +233,9 @@ bool VerifyWallets()
         }
 
         if (gArgs.GetBoolArg("-salvagewallet", false)) {
+            if (fLDBWallet) {
+                return InitError(strprintf(_("Error loading wallet %s. -salvagewallet only salvages Berkeley DB wallets."), walletFile));
+            }
             // Recover readable keypairs:
             CWallet dummyWallet;
             std::string backup_filename;
@@ -0,0 +1,218 @@
+// Copyright (c) 2026 The Mynta Core Developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include "wallet/ldbstore.h"
+
+#include "support/cleanse.h"
+#include "util.h"
+
+#include <leveldb/cache.h>
+#include <leveldb/db.h>
+#include <leveldb/env.h>
+#include <leveldb/filter_policy.h>
+#include <leveldb/write_batch.h>
+#include <memenv.h>
+
+//! Block cache of a wallet store; its records are read once at load, then mostly written
+static const size_t WALLET_LDB_CACHE_SIZE = 8 << 20;
+//! Records copied per write by Backup
+static const size_t WALLET_LDB_BACKUP_BATCH_RECORDS = 10000;
+
+int CLDBStoreBatch::Read(const std::string& key, std::string& value) const
+{
+    auto it = mapWrites.find(key);
+    if (it == mapWrites.end())
+        return -1;
+    if (!it->second.first)
+        return 0;
+    value = it->second.second;
+    return 1;
+}
+
+void CLDBStoreBatch::Add(const CLDBStoreBatch& other)
+{
+    for (const auto& item : other.mapWrites)
+        mapWrites[item.first] = item.second;
+}
+
+void CLDBStoreBatch::Clear()
+{
+    for (auto& item : mapWrites)
+        memory_cleanse(&item.second.second[0], item.second.second.size());
+    mapWrites.clear();
+}
+
+CLDBStore::CLDBStore(const fs::path& pathIn, bool fMemory) : path(pathIn), penv(nullptr), pdb(nullptr), nBatchDepth(0)
+{
+    pcache = leveldb::NewLRUCache(WALLET_LDB_CACHE_SIZE);
+    pfilter = leveldb::NewBloomFilterPolicy(10);
+
+    leveldb::Options options;
+    options.create_if_missing = true;
+    options.paranoid_checks = true;
+    options.block_cache = pcache;
+    options.filter_policy = pfilter;
+    options.compression = leveldb::kSnappyCompression;
+    if (fMemory) {
+        penv = leveldb::NewMemEnv(leveldb::Env::Default());
+        options.env = penv;
+    } else {
+        TryCreateDirectories(path);
+    }
+
+    leveldb::Status status = leveldb::DB::Open(options, path.string(), &pdb);
+    if (!status.ok()) {
+        delete pfilter;
+        delete pcache;
+        delete penv;
+        throw std::runtime_error(strprintf("CLDBStore: can't open wallet database %s: %s", path.string(), status.ToString()));
+    }
+    LogPrintf("Opened LevelDB wallet database %s\n", path.string());
+}
+
+CLDBStore::~CLDBStore()
+{
+    if (nBatchDepth)
+        LogPrintf("%s: %s closed with a batch open, its writes are lost\n", __func__, path.string());
+    delete pdb;
+    pdb = nullptr;
+    delete pfilter;
+    delete pcache;
+    delete penv;
+}
+
+bool CLDBStore::WriteToDB(const CLDBStoreBatch& batch, bool fSync)
+{
+    AssertLockHeld(cs_store);
+    leveldb::WriteBatch writeBatch;
+    for (const auto& item : batch.mapWrites) {
+        if (item.second.first)
+            writeBatch.Put(item.first, item.second.second);
+        else
+            writeBatch.Delete(item.first);
+    }
+
+    leveldb::WriteOptions writeOptions;
+    writeOptions.sync = fSync;
+    leveldb::Status status = pdb->Write(writeOptions, &writeBatch);
+    writeBatch.Clear();
+    if (!status.ok())
+        return error("%s: %s: %s", __func__, path.string(), status.ToString());
+    return true;
+}
+
+bool CLDBStore::Read(const std::string& key, std::string& value) const
+{
+    LOCK(cs_store);
+    int nPending = batchPending.Read(key, value);
+    if (nPending >= 0)
+        return nPending == 1;
+
+    leveldb::Status status = pdb->Get(leveldb::ReadOptions(), key, &value);
+    if (!status.ok() && !status.IsNotFound())
+        LogPrintf("%s: %s: %s\n", __func__, path.string(), status.ToString());
+    return status.ok();
+}
+
+bool CLDBStore::Write(const CLDBStoreBatch& batch)
+{
+    LOCK(cs_store);
+    if (nBatchDepth) {
+        batchPending.Add(batch);
+        return true;
+    }
+    return WriteToDB(batch, false);
+}
+
+void CLDBStore::BeginBatch()
+{
+    LOCK(cs_store);
+    nBatchDepth++;
+}
+
+bool CLDBStore::CommitBatch()
+{
+    LOCK(cs_store);
+    assert(nBatchDepth > 0);
+    if (--nBatchDepth || batchPending.IsEmpty())
+        return true;
+    bool fOk = WriteToDB(batchPending, false);
+    batchPending.Clear();
+    return fOk;
+}
+
+leveldb::Iterator* CLDBStore::NewIterator()
+{
+    LOCK(cs_store);
+    if (!batchPending.IsEmpty()) {
+        if (WriteToDB(batchPending, false))
+            batchPending.Clear();
+    }
+    leveldb::ReadOptions readOptions;
+    readOptions.fill_cache = false;
+    return pdb->NewIterator(readOptions);
+}
+
+bool CLDBStore::Flush()
+{
+    LOCK(cs_store);
+    // An empty synced write syncs the log with everything before it
+    CLDBStoreBatch empty;
+    return WriteToDB(empty, true);
+}
+
+void CLDBStore::Compact()
+{
+    LOCK(cs_store);
+    pdb->CompactRange(nullptr, nullptr);
+}
+
+bool CLDBStore::Backup(const fs::path& pathDest)
+{
+    std::unique_ptr<leveldb::Iterator> pcursor(NewIterator());
+
+    leveldb::Options options;
+    options.create_if_missing = true;
+    options.error_if_exists = true;
+    options.compression = leveldb::kSnappyCompression;
+    leveldb::DB* pdbDest = nullptr;
+    leveldb::Status status = leveldb::DB::Open(options, pathDest.string(), &pdbDest);
+    if (!status.ok())
+        return error("%s: can't create %s: %s", __func__, pathDest.string(), status.ToString());
+    std::unique_ptr<leveldb::DB> dbDest(pdbDest);
+
+    leveldb::WriteBatch batch;
+    size_t nBatched = 0;
+    for (pcursor->SeekToFirst(); status.ok(); pcursor->Next()) {
+        const bool fEnd = !pcursor->Valid();
+        if (!fEnd) {
+            batch.Put(pcursor->key(), pcursor->value());
+            nBatched++;
+        }
+        if (fEnd || nBatched >= WALLET_LDB_BACKUP_BATCH_RECORDS) {
+            leveldb::WriteOptions writeOptions;
+            writeOptions.sync = fEnd;
+            status = dbDest->Write(writeOptions, &batch);
+            batch.Clear();
+            nBatched = 0;
+        }
+        if (fEnd)
+            break;
+    }
+    if (status.ok())
+        status = pcursor->status();
+    if (!status.ok())
+        return error("%s: copying %s to %s: %s", __func__, path.string(), pathDest.string(), status.ToString());
+
+    LogPrintf("copied %s to %s\n", path.string(), pathDest.string());
+    return true;
+}
+
+bool IsLDBWallet(const std::string& walletFile, const fs::path& dataDir)
+{
+    const fs::path pathWallet = dataDir / walletFile;
+    if (fs::exists(pathWallet))
+        return fs::is_directory(pathWallet);
+    return gArgs.GetArg("-walletbackend", DEFAULT_WALLET_BACKEND) == "leveldb";
+}
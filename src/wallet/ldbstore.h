@@ -0,0 +1,106 @@
+// Copyright (c) 2026 The Mynta Core Developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#ifndef MYNTA_WALLET_LDBSTORE_H
+#define MYNTA_WALLET_LDBSTORE_H
+
+#include "fs.h"
+#include "sync.h"
+
+#include <map>
+#include <memory>
+#include <string>
+
+namespace leveldb {
+class Cache;
+class DB;
+class Env;
+class FilterPolicy;
+class Iterator;
+} // namespace leveldb
+
+//! What -walletbackend creates new wallets with by default
+static const char* const DEFAULT_WALLET_BACKEND = "bdb";
+
+/** Writes to a CLDBStore that are applied together, and that reads can look through first */
+class CLDBStoreBatch
+{
+public:
+    //! Serialized key -> whether it is written, and the serialized value it is written with
+    std::map<std::string, std::pair<bool, std::string> > mapWrites;
+
+    CLDBStoreBatch() {}
+    CLDBStoreBatch(const CLDBStoreBatch&) = delete;
+    CLDBStoreBatch& operator=(const CLDBStoreBatch&) = delete;
+    //! The values may be private keys
+    ~CLDBStoreBatch() { Clear(); }
+
+    void Write(const std::string& key, const std::string& value) { mapWrites[key] = std::make_pair(true, value); }
+    void Erase(const std::string& key) { mapWrites[key] = std::make_pair(false, std::string()); }
+    //! 1 if the batch writes key, with value, 0 if it erases it, -1 if it doesn't touch it
+    int Read(const std::string& key, std::string& value) const;
+    void Add(const CLDBStoreBatch& other);
+    void Clear();
+    bool IsEmpty() const { return mapWrites.empty(); }
+};
+
+/**
+ * A wallet database in LevelDB, for wallets whose transaction count makes
+ * Berkeley DB's locking and checkpoints the bottleneck. It holds the same
+ * serialized key/value records as the Berkeley DB file, in the same order, so
+ * CDB and CWalletDB work on either.
+ *
+ * Writes go to LevelDB's log without a sync, as the Berkeley DB ones go to its
+ * log with DB_TXN_WRITE_NOSYNC, and Flush() syncs. Between BeginBatch() and
+ * CommitBatch() they are held back and written as one batch, which is how the
+ * wallet writes everything a block changed at once.
+ */
+class CLDBStore
+{
+private:
+    mutable CCriticalSection cs_store;
+    fs::path path;
+    leveldb::Env* penv;
+    leveldb::Cache* pcache;
+    const leveldb::FilterPolicy* pfilter;
+    leveldb::DB* pdb;
+
+    //! Open BeginBatch() calls, and the writes held back until the last is committed
+    int nBatchDepth;
+    CLDBStoreBatch batchPending;
+
+    bool WriteToDB(const CLDBStoreBatch& batch, bool fSync);
+
+public:
+    //! Open or create the store at path, or an empty one in memory; throws std::runtime_error if it can't
+    explicit CLDBStore(const fs::path& pathIn, bool fMemory = false);
+    ~CLDBStore();
+
+    CLDBStore(const CLDBStore&) = delete;
+    CLDBStore& operator=(const CLDBStore&) = delete;
+
+    const fs::path& GetPath() const { return path; }
+
+    bool Read(const std::string& key, std::string& value) const;
+    //! Apply batch, or add it to the held back writes inside BeginBatch()/CommitBatch()
+    bool Write(const CLDBStoreBatch& batch);
+
+    void BeginBatch();
+    bool CommitBatch();
+
+    //! Iterator over every record; writes out the held back ones first, so it misses none
+    leveldb::Iterator* NewIterator();
+
+    //! Sync everything written so far to disk
+    bool Flush();
+    //! Compact the files, so nothing overwritten or erased is left in them
+    void Compact();
+    //! Copy every record into a new store at pathDest
+    bool Backup(const fs::path& pathDest);
+};
+
+//! Whether walletFile in dataDir is a LevelDB wallet, or will be created as one (see -walletbackend)
+bool IsLDBWallet(const std::string& walletFile, const fs::path& dataDir);
+
+#endif // MYNTA_WALLET_LDBSTORE_H
@@ -0,0 +1,94 @@
+// Copyright (c) 2026 The Mynta Core Developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include "wallet/db.h"
+#include "wallet/ldbstore.h"
+
+#include "test/test_mynta.h"
+
+#include <boost/test/unit_test.hpp>
+
+BOOST_FIXTURE_TEST_SUITE(ldbstore_tests, BasicTestingSetup)
+
+BOOST_AUTO_TEST_CASE(ldbstore_readwrite_test)
+{
+    CWalletDBWrapper dbw(std::make_shared<CLDBStore>(GetDataDir() / "wallet.ldb", true), "wallet.ldb");
+    CDB db(dbw, "cr+");
+
+    int nVersion = 0;
+    BOOST_CHECK(db.ReadVersion(nVersion));
+    BOOST_CHECK_EQUAL(nVersion, CLIENT_VERSION);
+
+    const auto key = std::make_pair(std::string("name"), std::string("addr1"));
+    std::string strValue;
+    BOOST_CHECK(!db.Exists(key));
+    BOOST_CHECK(db.Write(key, std::string("first")));
+    BOOST_CHECK(!db.Write(key, std::string("second"), false));
+    BOOST_CHECK(db.Read(key, strValue));
+    BOOST_CHECK_EQUAL(strValue, "first");
+    BOOST_CHECK(db.Erase(key));
+    BOOST_CHECK(!db.Read(key, strValue));
+
+    // An aborted transaction leaves nothing behind, a committed one is read back
+    BOOST_CHECK(db.TxnBegin());
+    BOOST_CHECK(db.Write(key, std::string("aborted")));
+    BOOST_CHECK(db.Read(key, strValue));
+    BOOST_CHECK(db.TxnAbort());
+    BOOST_CHECK(!db.Exists(key));
+    BOOST_CHECK(db.TxnBegin());
+    BOOST_CHECK(db.Write(key, std::string("committed")));
+    BOOST_CHECK(db.TxnCommit());
+    BOOST_CHECK(db.Read(key, strValue));
+    BOOST_CHECK_EQUAL(strValue, "committed");
+}
+
+BOOST_AUTO_TEST_CASE(ldbstore_batch_cursor_test)
+{
+    std::shared_ptr<CLDBStore> store = std::make_shared<CLDBStore>(GetDataDir() / "wallet.ldb", true);
+    CWalletDBWrapper dbw(store, "wallet.ldb");
+    {
+        CDB db(dbw, "cr+");
+        CWalletDBBatchScope batchScope(dbw);
+        for (int i = 0; i < 10; i++)
+            BOOST_CHECK(db.Write(std::make_pair(std::string("pool"), int64_t(i)), i * 2));
+
+        // Held back from the store, but every CDB on it reads them
+        std::string strRaw;
+        CDataStream ssKey(SER_DISK, CLIENT_VERSION);
+        ssKey << std::make_pair(std::string("pool"), int64_t(3));
+        BOOST_CHECK(store->Read(std::string(ssKey.begin(), ssKey.end()), strRaw));
+        CDB dbOther(dbw, "r");
+        int nValue = 0;
+        BOOST_CHECK(dbOther.Read(std::make_pair(std::string("pool"), int64_t(3)), nValue));
+        BOOST_CHECK_EQUAL(nValue, 6);
+    }
+
+    // The cursor returns the records in key order, the version record last, then DB_NOTFOUND
+    CDB db(dbw, "r");
+    std::unique_ptr<CDBCursor> pcursor(db.GetCursor());
+    BOOST_REQUIRE(pcursor);
+    CDataStream ssKey(SER_DISK, CLIENT_VERSION);
+    CDataStream ssValue(SER_DISK, CLIENT_VERSION);
+    ssKey << std::make_pair(std::string("pool"), int64_t(0));
+    int ret = db.ReadAtCursor(pcursor.get(), ssKey, ssValue, true);
+    int nRecords = 0;
+    for (; ret == 0; ret = db.ReadAtCursor(pcursor.get(), ssKey, ssValue)) {
+        std::string strType;
+        ssKey >> strType;
+        if (strType == "version")
+            continue;
+        int64_t nIndex;
+        int nValue;
+        ssKey >> nIndex;
+        ssValue >> nValue;
+        BOOST_CHECK_EQUAL(strType, "pool");
+        BOOST_CHECK_EQUAL(nIndex, nRecords);
+        BOOST_CHECK_EQUAL(nValue, nRecords * 2);
+        nRecords++;
+    }
+    BOOST_CHECK_EQUAL(ret, DB_NOTFOUND);
+    BOOST_CHECK_EQUAL(nRecords, 10);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -4,6 +4,8 @@
 // file COPYING or http://www.opensource.org/licenses/mit-license.php.
 
 #include "wallet/wallet.h"
+#include "assets/assets.h"
+#include "assets/atomicswap.h"
 #include "chainparams.h"
 
 #include <set>
@@ -377,6 +379,57 @@ BOOST_FIXTURE_TEST_SUITE(wallet_tests, WalletTestingSetup)
         empty_wallet();
     }
 
+    static void add_asset_coin(const std::string& strName, const CAmount& nAmount)
+    {
+        static int nextLockTime = 0;
+        CMutableTransaction tx;
+        tx.nLockTime = nextLockTime++;
+        tx.vout.resize(1);
+        tx.vout[0].scriptPubKey = GetScriptForDestination(CKeyID());
+        CAssetTransfer(strName, nAmount).ConstructTransaction(tx.vout[0].scriptPubKey);
+        std::unique_ptr<CWalletTx> wtx(new CWalletTx(&testWallet, MakeTransactionRef(std::move(tx))));
+        vCoins.push_back(COutput(wtx.get(), 0, 6 * 24, true /* spendable */, true /* solvable */, true /* safe */));
+        wtxn.emplace_back(std::move(wtx));
+    }
+
+    BOOST_AUTO_TEST_CASE(asset_selection_exact_match)
+    {
+        CoinSet setCoinsRet;
+        CAmount nValueRet;
+
+        LOCK(testWallet.cs_wallet);
+
+        empty_wallet();
+
+        // Only 4 + 3 adds up to 7 exactly; any other choice needs change
+        add_asset_coin("MYASSET", 5 * COIN);
+        add_asset_coin("MYASSET", 4 * COIN);
+        add_asset_coin("MYASSET", 3 * COIN);
+        BOOST_CHECK(testWallet.SelectAssetsMinConf(7 * COIN, 1, 6, 0, "MYASSET", vCoins, setCoinsRet, nValueRet));
+        BOOST_CHECK_EQUAL(nValueRet, 7 * COIN);
+        BOOST_CHECK_EQUAL(setCoinsRet.size(), 2U);
+
+        // Among exact matches the one with the fewest inputs wins
+        empty_wallet();
+        for (int i = 0; i < 20; i++)
+            add_asset_coin("MYASSET", 1 * COIN);
+        add_asset_coin("MYASSET", 6 * COIN);
+        add_asset_coin("MYASSET", 30 * COIN);
+        BOOST_CHECK(testWallet.SelectAssetsMinConf(7 * COIN, 1, 6, 0, "MYASSET", vCoins, setCoinsRet, nValueRet));
+        BOOST_CHECK_EQUAL(nValueRet, 7 * COIN);
+        BOOST_CHECK_EQUAL(setCoinsRet.size(), 2U);
+
+        // With no exact match the subset search still covers the target
+        empty_wallet();
+        add_asset_coin("MYASSET", 5 * COIN);
+        add_asset_coin("MYASSET", 5 * COIN);
+        BOOST_CHECK(testWallet.SelectAssetsMinConf(7 * COIN, 1, 6, 0, "MYASSET", vCoins, setCoinsRet, nValueRet));
+        BOOST_CHECK_EQUAL(nValueRet, 10 * COIN);
+        BOOST_CHECK(!testWallet.SelectAssetsMinConf(11 * COIN, 1, 6, 0, "MYASSET", vCoins, setCoinsRet, nValueRet));
+
+        empty_wallet();
+    }
+
     static void AddKey(CWallet &wallet, const CKey &key)
     {
         LOCK(wallet.cs_wallet);
@@ -606,6 +659,100 @@ BOOST_FIXTURE_TEST_SUITE(wallet_tests, WalletTestingSetup)
         SetMockTime(0);
     }
 
+    BOOST_AUTO_TEST_CASE(hd_keypool_topup_test)
+    {
+        BOOST_TEST_MESSAGE("Running HD KeyPool TopUp Test");
+
+        // The keys derived on several threads are the ones m/0'/<change>'/<n>' gives, in order
+        CWallet wallet;
+        LOCK(wallet.cs_wallet);
+        wallet.SetMinVersion(FEATURE_HD_SPLIT);
+        BOOST_CHECK(wallet.SetHDSeed(wallet.GenerateNewSeed()));
+        BOOST_CHECK(wallet.TopUpKeyPool(300));
+        BOOST_CHECK_EQUAL(wallet.KeypoolCountExternalKeys(), 300U);
+        BOOST_CHECK_EQUAL(wallet.GetKeyPoolSize(), 600U);
+        BOOST_CHECK_EQUAL(wallet.GetHDChain().nExternalChainCounter, 300U);
+        BOOST_CHECK_EQUAL(wallet.GetHDChain().nInternalChainCounter, 300U);
+
+        const uint32_t BIP32_HARDENED_KEY_LIMIT = 0x80000000;
+        CKey seed;
+        BOOST_CHECK(wallet.GetKey(wallet.GetHDChain().seed_id, seed));
+        CExtKey masterKey, accountKey;
+        masterKey.SetSeed(seed.begin(), seed.size());
+        masterKey.Derive(accountKey, BIP32_HARDENED_KEY_LIMIT);
+        for (int internal = 0; internal < 2; internal++) {
+            CExtKey chainKey;
+            accountKey.Derive(chainKey, BIP32_HARDENED_KEY_LIMIT + internal);
+            for (uint32_t i = 0; i < 300; i++) {
+                CExtKey childKey;
+                chainKey.Derive(childKey, BIP32_HARDENED_KEY_LIMIT | i);
+                CKeyID keyID = childKey.key.GetPubKey().GetID();
+                BOOST_CHECK(wallet.HaveKey(keyID));
+                BOOST_CHECK_EQUAL(wallet.mapKeyMetadata[keyID].hdKeypath, strprintf("m/0'/%d'/%d'", internal, i));
+            }
+        }
+
+        // A key derived one at a time goes on from where the pool left off
+        CWalletDB walletdb(wallet.GetDBHandle());
+        CPubKey pubkey = wallet.GenerateNewKey(walletdb, false);
+        BOOST_CHECK_EQUAL(wallet.mapKeyMetadata[pubkey.GetID()].hdKeypath, "m/0'/0'/300'");
+    }
+
+    BOOST_AUTO_TEST_CASE(htlc_timeout_queue_test)
+    {
+        CHTLCTimeoutQueue queue;
+        const CScript script = CScript() << OP_TRUE;
+        for (uint32_t i = 0; i < 10; i++)
+            queue.Watch(COutPoint(uint256S("01"), i), script, 100 + (i % 5) * 10);
+        BOOST_CHECK_EQUAL(queue.Size(), 10U);
+
+        // Test: only the HTLCs due by the height come out, each once.
+        BOOST_CHECK(queue.PopDue(99).empty());
+        std::vector<std::pair<COutPoint, CScript>> vDue = queue.PopDue(110);
+        BOOST_CHECK_EQUAL(vDue.size(), 4U);
+        for (const auto& entry : vDue)
+            BOOST_CHECK(entry.first.n % 5 <= 1 && entry.second == script);
+        BOOST_CHECK(queue.PopDue(110).empty());
+        BOOST_CHECK_EQUAL(queue.Size(), 6U);
+
+        // Test: an unwatched HTLC is skipped, a watched one moved to a later height waits for it.
+        BOOST_CHECK(queue.Unwatch(COutPoint(uint256S("01"), 2)));
+        BOOST_CHECK(!queue.Unwatch(COutPoint(uint256S("01"), 2)));
+        queue.Watch(COutPoint(uint256S("01"), 7), script, 200);
+        vDue = queue.PopDue(120);
+        BOOST_CHECK_EQUAL(vDue.size(), 0U);
+        BOOST_CHECK(queue.IsWatched(COutPoint(uint256S("01"), 7)));
+        vDue = queue.PopDue(199);
+        BOOST_CHECK_EQUAL(vDue.size(), 4U);
+        vDue = queue.PopDue(200);
+        BOOST_CHECK_EQUAL(vDue.size(), 1U);
+        BOOST_CHECK(vDue[0].first == COutPoint(uint256S("01"), 7));
+        BOOST_CHECK_EQUAL(queue.Size(), 0U);
+    }
+
+    BOOST_AUTO_TEST_CASE(htlc_watch_test)
+    {
+        CWallet wallet;
+        LOCK(wallet.cs_wallet);
+        CKey key, otherKey;
+        key.MakeNewKey(true);
+        otherKey.MakeNewKey(true);
+        BOOST_CHECK(wallet.AddKey(key));
+        const uint256 hashLock = HashSecret(std::vector<unsigned char>(32, 7));
+        const std::vector<unsigned char> vchHashLock(hashLock.begin(), hashLock.end());
+
+        // Test: an HTLC the wallet can't refund isn't watched.
+        const CScript theirs = HTLCScript::CreateHTLCScript(vchHashLock, GetScriptForDestination(key.GetPubKey().GetID()),
+            GetScriptForDestination(otherKey.GetPubKey().GetID()), 150);
+        BOOST_CHECK(!wallet.WatchHTLC(COutPoint(uint256S("01"), 0), theirs));
+
+        // Test: one it can refund is watched, and its redeem script kept.
+        const CScript ours = HTLCScript::CreateHTLCScript(vchHashLock, GetScriptForDestination(otherKey.GetPubKey().GetID()),
+            GetScriptForDestination(key.GetPubKey().GetID()), 150);
+        BOOST_CHECK(wallet.WatchHTLC(COutPoint(uint256S("01"), 1), ours));
+        BOOST_CHECK(wallet.HaveCScript(CScriptID(ours)));
+    }
+
     BOOST_AUTO_TEST_CASE(LoadReceiveRequests_Test)
     {
         BOOST_TEST_MESSAGE("Running LoadReceiveRequests Test");
@@ -716,4 +863,40 @@ BOOST_FIXTURE_TEST_SUITE(wallet_tests, WalletTestingSetup)
         BOOST_CHECK_EQUAL(list.begin()->second.size(), (uint64_t)2L);
     }
 
+    BOOST_FIXTURE_TEST_CASE(WalletUTXO_test, ListCoinsTestingSetup)
+    {
+        TurnOffSegwit();
+
+        LOCK2(cs_main, wallet->cs_wallet);
+
+        // Spend the mature coinbase; the wallet drops it as the block comes in
+        const CWalletTx& wtx = AddTx(CRecipient{GetScriptForRawPubKey({}), 1 * COIN, false /* subtract fee */});
+        const COutPoint spent = wtx.tx->vin[0].prevout;
+
+        std::vector<COutput> available;
+        wallet->AvailableCoins(available);
+        std::set<COutPoint> setAvailable;
+        CAmount nAvailable = 0;
+        for (const COutput& out : available) {
+            BOOST_CHECK(!(COutPoint(out.tx->GetHash(), out.i) == spent));
+            setAvailable.insert(COutPoint(out.tx->GetHash(), out.i));
+            nAvailable += out.tx->tx->vout[out.i].nValue;
+        }
+        BOOST_CHECK_EQUAL(available.size(), 2U);
+        BOOST_CHECK_EQUAL(wallet->GetBalance(), nAvailable);
+        const CAmount nImmature = wallet->GetImmatureBalance();
+        BOOST_CHECK(nImmature > 0);
+
+        // Rebuilding from mapWallet gives the same coins and balances
+        wallet->MarkDirty();
+        wallet->AvailableCoins(available);
+        std::set<COutPoint> setRebuilt;
+        for (const COutput& out : available) {
+            setRebuilt.insert(COutPoint(out.tx->GetHash(), out.i));
+        }
+        BOOST_CHECK(setRebuilt == setAvailable);
+        BOOST_CHECK_EQUAL(wallet->GetBalance(), nAvailable);
+        BOOST_CHECK_EQUAL(wallet->GetImmatureBalance(), nImmature);
+    }
+
 BOOST_AUTO_TEST_SUITE_END()
@@ -38,10 +38,14 @@
 
 #include <boost/algorithm/string/replace.hpp>
 #include <boost/thread.hpp>
+#include <future>
 #include <random>
+#include <thread>
+#include <unordered_set>
 #include <tinyformat.h>
 
 #include "assets/assets.h"
+#include "assets/atomicswap.h"
 
 std::vector<CWalletRef> vpwallets;
 /** Transaction fee set by the user */
@@ -49,6 +53,7 @@ CFeeRate payTxFee(DEFAULT_TRANSACTION_FEE);
 unsigned int nTxConfirmTarget = DEFAULT_TX_CONFIRM_TARGET;
 bool bSpendZeroConfChange = DEFAULT_SPEND_ZEROCONF_CHANGE;
 bool fWalletRbf = DEFAULT_WALLET_RBF;
+bool fHTLCAutoRefund = DEFAULT_HTLC_AUTOREFUND;
 
 const char * DEFAULT_WALLET_DAT = "wallet.dat";
 const uint32_t BIP32_HARDENED_KEY_LIMIT = 0x80000000;
@@ -86,15 +91,6 @@ struct CompareValueOnly
     }
 };
 
-struct CompareAssetValueOnly
-{
-    bool operator()(const std::pair<CInputCoin, CAmount>& t1,
-                    const std::pair<CInputCoin, CAmount>& t2) const
-    {
-        return t1.second < t2.second;
-    }
-};
-
 std::string COutput::ToString() const
 {
     return strprintf("COutput(%s, %d, %d) [%s]", tx->GetHash().ToString(), i, nDepth, FormatMoney(tx->tx->vout[i].nValue));
@@ -176,8 +172,9 @@ CPubKey CWallet::GenerateNewKey(CWalletDB &walletdb, bool internal)
     return pubkey;
 }
 
-void CWallet::DeriveNewChildKey(CWalletDB &walletdb, CKeyMetadata& metadata, CKey& secret, bool internal)
+CExtKey CWallet::GetHDChainKey(bool internal) const
 {
+    AssertLockHeld(cs_wallet); // hdChain
     // for now we use a fixed keypath scheme of m/0'/0'/k
     CExtKey masterKey;             //hd master key
 
@@ -186,7 +183,6 @@ void CWallet::DeriveNewChildKey(CWalletDB &walletdb, CKeyMetadata& metadata, CKe
 
     CExtKey accountKey;            //key at m/0'
     CExtKey chainChildKey;         //key at m/0'/0' (external) or m/0'/1' (internal)
-    CExtKey childKey;              //key at m/0'/0'/<n>'
 
 
     uint32_t nAccountIndex = 0; // TODO add HDAccounts management
@@ -201,11 +197,6 @@ void CWallet::DeriveNewChildKey(CWalletDB &walletdb, CKeyMetadata& metadata, CKe
         masterKey.SetSeed(g_vchSeed.data(), g_vchSeed.size());
     }
 
-    // Select which chain we are using depending on if this is a change address or not
-    uint32_t& nChildIndex = internal ? hdChain.nInternalChainCounter : hdChain.nExternalChainCounter;
-
-    do {
-
 			if(hdChain.IsBip44())
 			{
 				// Use BIP44 keypath scheme i.e. m / purpose' / coin_type' / account' / change / address_index
@@ -218,8 +209,6 @@ void CWallet::DeriveNewChildKey(CWalletDB &walletdb, CKeyMetadata& metadata, CKe
 				coinTypeKey.Derive(accountKey, nAccountIndex | BIP32_HARDENED_KEY_LIMIT);
 				// derive m/purpose'/coin_type'/account'/change
 				accountKey.Derive(chainChildKey, internal ? 1 : 0);
-				// derive m/purpose'/coin_type'/account'/change/address_index
-				chainChildKey.Derive(childKey, nChildIndex);
 			}
 			else
 			{
@@ -229,21 +218,41 @@ void CWallet::DeriveNewChildKey(CWalletDB &walletdb, CKeyMetadata& metadata, CKe
 				masterKey.Derive(accountKey, nAccountIndex | BIP32_HARDENED_KEY_LIMIT);
 				// derive m/account'/change
 				accountKey.Derive(chainChildKey, BIP32_HARDENED_KEY_LIMIT + (internal ? 1 : 0));
-				// derive m/account'/change/address_index
-				chainChildKey.Derive(childKey, BIP32_HARDENED_KEY_LIMIT |  nChildIndex);
 			}
 
-        // increment childkey index
-        nChildIndex++;
-    } while (HaveKey(childKey.key.GetPubKey().GetID()));
+    return chainChildKey;
+}
 
+void CWallet::DeriveHDChildKey(const CExtKey& chainKey, uint32_t nChildIndex, CKey& secret) const
+{
+    // derive m/purpose'/coin_type'/account'/change/address_index or m/account'/change/address_index'
+    CExtKey childKey;
+    chainKey.Derive(childKey, hdChain.IsBip44() ? nChildIndex : BIP32_HARDENED_KEY_LIMIT | nChildIndex);
     secret = childKey.key;
+}
 
+std::string CWallet::GetHDKeypath(bool internal, uint32_t nChildIndex) const
+{
+    uint32_t nAccountIndex = 0;
     if(hdChain.IsBip44())
-        metadata.hdKeypath = strprintf("m/44'/%d'/%d'/%d/%d", GetParams().ExtCoinType(), nAccountIndex, internal, nChildIndex - 1);
-    else
-        metadata.hdKeypath = strprintf("m/%d'/%d'/%d'", nAccountIndex, internal, nChildIndex - 1);
+        return strprintf("m/44'/%d'/%d'/%d/%d", GetParams().ExtCoinType(), nAccountIndex, internal, nChildIndex);
+    return strprintf("m/%d'/%d'/%d'", nAccountIndex, internal, nChildIndex);
+}
+
+void CWallet::DeriveNewChildKey(CWalletDB &walletdb, CKeyMetadata& metadata, CKey& secret, bool internal)
+{
+    const CExtKey chainChildKey = GetHDChainKey(internal);
 
+    // Select which chain we are using depending on if this is a change address or not
+    uint32_t& nChildIndex = internal ? hdChain.nInternalChainCounter : hdChain.nExternalChainCounter;
+
+    do {
+        DeriveHDChildKey(chainChildKey, nChildIndex, secret);
+        // increment childkey index
+        nChildIndex++;
+    } while (HaveKey(secret.GetPubKey().GetID()));
+
+    metadata.hdKeypath = GetHDKeypath(internal, nChildIndex - 1);
     metadata.hd_seed_id = hdChain.seed_id;
 
     // update the chain model in the database
@@ -252,6 +261,67 @@ void CWallet::DeriveNewChildKey(CWalletDB &walletdb, CKeyMetadata& metadata, CKe
 
 }
 
+std::vector<CPubKey> CWallet::GenerateNewHDKeys(CWalletDB& walletdb, size_t nKeys, bool internal)
+{
+    AssertLockHeld(cs_wallet); // mapKeyMetadata
+    std::vector<CPubKey> vPubKeys;
+    if (nKeys == 0)
+        return vPubKeys;
+    assert(IsHDEnabled());
+    SetMinVersion(FEATURE_COMPRPUBKEY, &walletdb);
+
+    const CExtKey chainKey = GetHDChainKey(internal);
+    uint32_t& nChildIndex = internal ? hdChain.nInternalChainCounter : hdChain.nExternalChainCounter;
+    while (vPubKeys.size() < nKeys) {
+        // The keys are derived and checked on several threads, which is most
+        // of the work; adding them to the wallet is left to this one
+        const uint32_t nFirst = nChildIndex;
+        std::vector<CKey> vSecrets(nKeys - vPubKeys.size());
+        std::vector<CPubKey> vDerived(vSecrets.size());
+        std::atomic<size_t> nNext{0};
+        auto deriveKeys = [&]() {
+            for (size_t i = nNext++; i < vSecrets.size(); i = nNext++) {
+                DeriveHDChildKey(chainKey, nFirst + i, vSecrets[i]);
+                vDerived[i] = vSecrets[i].GetPubKey();
+                assert(vSecrets[i].VerifyPubKey(vDerived[i]));
+            }
+        };
+        size_t nThreads = std::min<size_t>(std::min(std::max(1, GetNumCores()), KEYPOOL_MAX_DERIVE_THREADS), vSecrets.size() / 100 + 1);
+        std::vector<std::thread> threads;
+        for (size_t t = 1; t < nThreads; t++) {
+            threads.emplace_back(deriveKeys);
+        }
+        deriveKeys();
+        for (auto& thread : threads) {
+            thread.join();
+        }
+
+        int64_t nCreationTime = GetTime();
+        for (size_t i = 0; i < vSecrets.size(); i++) {
+            nChildIndex = nFirst + i + 1;
+            // As in DeriveNewChildKey, keys the wallet already has are passed over
+            if (HaveKey(vDerived[i].GetID()))
+                continue;
+
+            CKeyMetadata metadata(nCreationTime);
+            metadata.hdKeypath = GetHDKeypath(internal, nFirst + i);
+            metadata.hd_seed_id = hdChain.seed_id;
+            mapKeyMetadata[vDerived[i].GetID()] = metadata;
+            UpdateTimeFirstKey(nCreationTime);
+
+            if (!AddKeyPubKeyWithDB(walletdb, vSecrets[i], vDerived[i])) {
+                throw std::runtime_error(std::string(__func__) + ": AddKey failed");
+            }
+            vPubKeys.push_back(vDerived[i]);
+        }
+    }
+
+    // update the chain model in the database, once for all the keys
+    if (!walletdb.WriteHDChain(hdChain))
+        throw std::runtime_error(std::string(__func__) + ": Writing HD chain model failed");
+    return vPubKeys;
+}
+
 bool CWallet::AddKeyPubKeyWithDB(CWalletDB &walletdb, const CKey& secret, const CPubKey &pubkey)
 {
     AssertLockHeld(cs_wallet); // mapKeyMetadata
@@ -399,6 +469,57 @@ bool CWallet::LoadCScript(const CScript& redeemScript)
     return CCryptoKeyStore::AddCScript(redeemScript);
 }
 
+/** The wallet key an HTLC's refund path pays to, if the wallet has it */
+static bool GetHTLCRefundKeyID(const CScript& redeemScript, const CKeyStore& keystore, CHTLC& htlc, CKeyID& keyID)
+{
+    CTxDestination dest;
+    if (!HTLCScript::ParseHTLCRedeemScript(redeemScript, htlc) || !ExtractDestination(htlc.senderAddress, dest))
+        return false;
+    const CKeyID* pkeyID = boost::get<CKeyID>(&dest);
+    if (!pkeyID || !keystore.HaveKey(*pkeyID))
+        return false;
+    keyID = *pkeyID;
+    return true;
+}
+
+bool CWallet::WatchHTLC(const COutPoint& outpoint, const CScript& redeemScript)
+{
+    LOCK(cs_wallet);
+    CHTLC htlc;
+    CKeyID keyID;
+    if (!GetHTLCRefundKeyID(redeemScript, *this, htlc, keyID))
+        return false;
+    // Kept with the wallet, so LoadHTLCTimeouts finds the output again
+    if (!HaveCScript(CScriptID(redeemScript)) && !AddCScript(redeemScript))
+        return false;
+    htlcTimeouts.Watch(outpoint, redeemScript, htlc.timeLock);
+    return true;
+}
+
+void CWallet::LoadHTLCTimeouts()
+{
+    LOCK(cs_wallet);
+    std::vector<std::vector<unsigned char>> vSolutions;
+    txnouttype type;
+    for (const auto& entry : mapWallet) {
+        const CWalletTx& wtx = entry.second;
+        for (unsigned int i = 0; i < wtx.tx->vout.size(); i++) {
+            const CScript& scriptPubKey = wtx.tx->vout[i].scriptPubKey;
+            if (!scriptPubKey.IsPayToScriptHash() || !Solver(scriptPubKey, type, vSolutions) || type != TX_SCRIPTHASH)
+                continue;
+            CScript redeemScript;
+            CHTLC htlc;
+            CKeyID keyID;
+            if (!GetCScript(CScriptID(uint160(vSolutions[0])), redeemScript) || !GetHTLCRefundKeyID(redeemScript, *this, htlc, keyID))
+                continue;
+            if (!IsSpent(entry.first, i))
+                htlcTimeouts.Watch(COutPoint(entry.first, i), redeemScript, htlc.timeLock);
+        }
+    }
+    if (htlcTimeouts.Size())
+        LogPrintf("Watching %u HTLCs for their refund timeout\n", htlcTimeouts.Size());
+}
+
 bool CWallet::AddWatchOnly(const CScript& dest)
 {
     if (!CCryptoKeyStore::AddWatchOnly(dest))
@@ -662,6 +783,85 @@ void CWallet::AddToSpends(const uint256& wtxid)
         AddToSpends(txin.prevout, wtxid);
 }
 
+void CWallet::AddWalletUTXO(const COutPoint& outpoint, const CTxOut& txout) const
+{
+    if (IsMine(txout) == ISMINE_NO)
+        return;
+
+    setWalletUTXO.insert(outpoint);
+    CAssetOutputEntry assetData;
+    if (GetAssetData(txout.scriptPubKey, assetData))
+        mapWalletAssetUTXO[assetData.assetName].insert(outpoint);
+}
+
+void CWallet::AddWalletUTXOs(const CWalletTx& wtx) const
+{
+    const uint256& hash = wtx.GetHash();
+    for (unsigned int i = 0; i < wtx.tx->vout.size(); i++)
+        AddWalletUTXO(COutPoint(hash, i), wtx.tx->vout[i]);
+}
+
+void CWallet::EraseWalletUTXO(const COutPoint& outpoint)
+{
+    if (!setWalletUTXO.erase(outpoint))
+        return;
+
+    auto it = mapWallet.find(outpoint.hash);
+    CAssetOutputEntry assetData;
+    if (it != mapWallet.end() && GetAssetData(it->second.tx->vout[outpoint.n].scriptPubKey, assetData)) {
+        auto itAsset = mapWalletAssetUTXO.find(assetData.assetName);
+        if (itAsset != mapWalletAssetUTXO.end()) {
+            itAsset->second.erase(outpoint);
+            if (itAsset->second.empty())
+                mapWalletAssetUTXO.erase(itAsset);
+        }
+    }
+}
+
+void CWallet::UpdateWalletUTXOs() const
+{
+    AssertLockHeld(cs_main);
+    AssertLockHeld(cs_wallet);
+
+    if (!fWalletUTXODirty)
+        return;
+
+    setWalletUTXO.clear();
+    mapWalletAssetUTXO.clear();
+    for (const auto& item : mapWallet) {
+        const CWalletTx& wtx = item.second;
+        for (unsigned int i = 0; i < wtx.tx->vout.size(); i++) {
+            const COutPoint outpoint(item.first, i);
+            // Leave out what the main chain has spent; IsSpent covers the rest
+            bool fSpentInChain = false;
+            auto range = mapTxSpends.equal_range(outpoint);
+            for (auto it = range.first; it != range.second && !fSpentInChain; ++it) {
+                auto mit = mapWallet.find(it->second);
+                fSpentInChain = mit != mapWallet.end() && mit->second.GetDepthInMainChain() > 0;
+            }
+            if (!fSpentInChain)
+                AddWalletUTXO(outpoint, wtx.tx->vout[i]);
+        }
+    }
+    fWalletUTXODirty = false;
+}
+
+std::vector<const CWalletTx*> CWallet::GetWalletUTXOTxs() const
+{
+    UpdateWalletUTXOs();
+
+    std::vector<const CWalletTx*> vTxs;
+    for (auto it = setWalletUTXO.begin(); it != setWalletUTXO.end(); ++it) {
+        // The set is ordered by txid, so each transaction's outputs are together
+        if (it != setWalletUTXO.begin() && std::prev(it)->hash == it->hash)
+            continue;
+        auto mit = mapWallet.find(it->hash);
+        if (mit != mapWallet.end())
+            vTxs.push_back(&mit->second);
+    }
+    return vTxs;
+}
+
 bool CWallet::EncryptWallet(const SecureString& strWalletPassphrase)
 {
     if (IsCrypted())
@@ -966,6 +1166,7 @@ void CWallet::MarkDirty()
         LOCK(cs_wallet);
         for (std::pair<const uint256, CWalletTx>& item : mapWallet)
             item.second.MarkDirty();
+        fWalletUTXODirty = true;
     }
 }
 
@@ -1066,6 +1267,7 @@ bool CWallet::AddToWallet(const CWalletTx& wtxIn, bool fFlushOnClose)
 
     // Break debit/credit balance caches:
     wtx.MarkDirty();
+    AddWalletUTXOs(wtx);
 
     // Notify UI of new or updated transaction
     NotifyTransactionChanged(this, hash, fInsertedNew ? CT_NEW : CT_UPDATED);
@@ -1091,6 +1293,8 @@ bool CWallet::LoadToWallet(const CWalletTx& wtxIn)
     wtx.BindWallet(this);
     wtxOrdered.insert(std::make_pair(wtx.nOrderPos, TxPair(&wtx, nullptr)));
     AddToSpends(hash);
+    // Keys may not all be loaded yet, so work out what is ours once they are
+    fWalletUTXODirty = true;
     for (const CTxIn& txin : wtx.tx->vin) {
         auto it = mapWallet.find(txin.prevout.hash);
         if (it != mapWallet.end()) {
@@ -1133,6 +1337,7 @@ bool CWallet::AddToWalletIfInvolvingMe(const CTransactionRef& ptx, const CBlockI
                     }
                     range.first++;
                 }
+                EraseWalletUTXO(txin.prevout);
             }
         }
 
@@ -1329,6 +1534,8 @@ void CWallet::TransactionAddedToMempool(const CTransactionRef& ptx) {
 
 void CWallet::BlockConnected(const std::shared_ptr<const CBlock>& pblock, const CBlockIndex *pindex, const std::vector<CTransactionRef>& vtxConflicted) {
     LOCK2(cs_main, cs_wallet);
+    // Write everything the block changes in the wallet at once
+    CWalletDBBatchScope batchScope(*dbw);
     // TODO: Temporarily ensure that mempool removals are notified before
     // connected transactions.  This shouldn't matter, but the abandoned
     // state of transactions in our wallet is currently cleared when we
@@ -1347,12 +1554,134 @@ void CWallet::BlockConnected(const std::shared_ptr<const CBlock>& pblock, const
 
 void CWallet::BlockDisconnected(const std::shared_ptr<const CBlock>& pblock) {
     LOCK2(cs_main, cs_wallet);
+    CWalletDBBatchScope batchScope(*dbw);
 
     for (const CTransactionRef& ptx : pblock->vtx) {
         SyncTransaction(ptx);
+        // The outputs it spent are unspent in the main chain again
+        if (ptx->IsCoinBase())
+            continue;
+        for (const CTxIn& txin : ptx->vin) {
+            auto it = mapWallet.find(txin.prevout.hash);
+            if (it != mapWallet.end() && txin.prevout.n < it->second.tx->vout.size())
+                AddWalletUTXO(txin.prevout, it->second.tx->vout[txin.prevout.n]);
+        }
     }
 }
 
+void CWallet::UpdatedBlockTip(const CBlockIndex* pindexNew, const CBlockIndex* pindexFork, bool fInitialDownload)
+{
+    // What falls due during the initial download is looked at once it is over
+    if (fInitialDownload)
+        return;
+
+    LOCK2(cs_main, cs_wallet);
+    // Queued notifications can lag behind the chain, a refund must be final at the next block
+    const int nHeight = std::min(pindexNew->nHeight, chainActive.Height());
+    std::vector<std::pair<COutPoint, CScript>> vDue = htlcTimeouts.PopDue(nHeight);
+    std::vector<std::pair<COutPoint, CScript>> vRefund;
+    for (auto& entry : vDue) {
+        const COutPoint& outpoint = entry.first;
+        const CWalletTx* wtx = GetWalletTx(outpoint.hash);
+        if (!wtx || IsSpent(outpoint.hash, outpoint.n))
+            continue;
+        if (!pcoinsTip->HaveCoin(outpoint)) {
+            // Claimed, unless the funding transaction isn't in the chain yet
+            if (wtx->GetDepthInMainChain() <= 0 && !wtx->isAbandoned())
+                htlcTimeouts.Watch(outpoint, entry.second, nHeight + HTLC_REFUND_RETRY_BLOCKS);
+            continue;
+        }
+        if (!fHTLCAutoRefund || wtx->tx->vout[outpoint.n].scriptPubKey.IsAssetScript()) {
+            LogPrintf("%s: HTLC %s can be refunded\n", __func__, outpoint.ToString());
+            continue;
+        }
+        vRefund.push_back(std::move(entry));
+    }
+
+    for (size_t i = 0; i < vRefund.size(); i += MAX_HTLC_REFUND_BATCH) {
+        const std::vector<std::pair<COutPoint, CScript>> vBatch(vRefund.begin() + i, vRefund.begin() + std::min(i + MAX_HTLC_REFUND_BATCH, vRefund.size()));
+        std::string strError;
+        if (RefundHTLCs(vBatch, strError))
+            continue;
+        LogPrintf("%s: failed to refund %u HTLCs, trying again in %d blocks: %s\n", __func__, vBatch.size(), HTLC_REFUND_RETRY_BLOCKS, strError);
+        for (const auto& entry : vBatch)
+            htlcTimeouts.Watch(entry.first, entry.second, nHeight + HTLC_REFUND_RETRY_BLOCKS);
+    }
+}
+
+bool CWallet::RefundHTLCs(const std::vector<std::pair<COutPoint, CScript>>& vHTLCs, std::string& strError)
+{
+    AssertLockHeld(cs_main);
+    AssertLockHeld(cs_wallet);
+    if (IsLocked()) {
+        strError = "Wallet is locked";
+        return false;
+    }
+
+    CMutableTransaction mtx;
+    mtx.nVersion = 2;
+    std::vector<CKey> vKeys;
+    std::vector<CAmount> vAmounts;
+    CAmount nValue = 0;
+    unsigned int nScriptSigBytes = 0;
+    for (const auto& entry : vHTLCs) {
+        CHTLC htlc;
+        CKeyID keyID;
+        CKey key;
+        if (!GetHTLCRefundKeyID(entry.second, *this, htlc, keyID) || !GetKey(keyID, key)) {
+            strError = "No refund key for HTLC " + entry.first.ToString();
+            return false;
+        }
+        const CAmount nAmount = GetWalletTx(entry.first.hash)->tx->vout[entry.first.n].nValue;
+        // The refund path is open from the lock height on, for inputs that aren't final
+        mtx.vin.emplace_back(entry.first, CScript(), CTxIn::SEQUENCE_FINAL - 1);
+        mtx.nLockTime = std::max(mtx.nLockTime, htlc.timeLock);
+        vKeys.push_back(key);
+        vAmounts.push_back(nAmount);
+        nValue += nAmount;
+        // <sig> <pubkey> OP_FALSE <redeemScript> and the script length
+        nScriptSigBytes += 1 + 72 + 1 + 33 + 1 + 2 + entry.second.size() + 2;
+    }
+
+    CReserveKey reservekey(this);
+    CPubKey pubKey;
+    if (!reservekey.GetReservedKey(pubKey, true)) {
+        strError = "Keypool ran out";
+        return false;
+    }
+    mtx.vout.emplace_back(nValue, GetScriptForDestination(pubKey.GetID()));
+    const unsigned int nBytes = ::GetSerializeSize(mtx, SER_NETWORK, PROTOCOL_VERSION) + nScriptSigBytes;
+    mtx.vout[0].nValue -= GetMinimumFee(nBytes, CCoinControl(), ::mempool, ::feeEstimator, nullptr);
+    if (mtx.vout[0].nValue <= 0 || IsDust(mtx.vout[0], ::dustRelayFee)) {
+        strError = "The HTLCs don't cover the fee";
+        return false;
+    }
+
+    // Each input signs the transaction without the others' scriptSigs
+    const CTransaction txUnsigned(mtx);
+    for (size_t i = 0; i < mtx.vin.size(); i++) {
+        const CScript& redeemScript = vHTLCs[i].second;
+        std::vector<unsigned char> vchSig;
+        if (!vKeys[i].Sign(SignatureHash(redeemScript, txUnsigned, i, SIGHASH_ALL, vAmounts[i], SIGVERSION_BASE), vchSig)) {
+            strError = "Failed to sign the refund of HTLC " + vHTLCs[i].first.ToString();
+            return false;
+        }
+        vchSig.push_back((unsigned char)SIGHASH_ALL);
+        mtx.vin[i].scriptSig = HTLCScript::CreateRefundScript(vchSig, ToByteVector(vKeys[i].GetPubKey())) << ToByteVector(redeemScript);
+    }
+
+    CWalletTx wtx(this, MakeTransactionRef(std::move(mtx)));
+    wtx.fTimeReceivedIsTxTime = true;
+    wtx.fFromMe = true;
+    CValidationState state;
+    // One the mempool turns down stays in the wallet and is sent again with the others
+    if (!CommitTransaction(wtx, reservekey, g_connman.get(), state))
+        LogPrintf("%s: refund %s isn't accepted yet: %s\n", __func__, wtx.GetHash().ToString(), state.GetRejectReason());
+    else
+        LogPrintf("Refunded %u HTLCs in %s\n", vHTLCs.size(), wtx.GetHash().ToString());
+    return true;
+}
+
 
 
 isminetype CWallet::IsMine(const CTxIn &txin) const
@@ -1748,6 +2077,127 @@ int64_t CWallet::RescanFromTime(int64_t startTime, bool update)
     return startTime;
 }
 
+/**
+ * Fingerprints of the data that scripts paying the wallet push: key hashes,
+ * public keys, script hashes and the pushes of watched scripts. A rescan
+ * looks a transaction's outputs up here before it asks IsMine, which is much
+ * slower, and passes over those that push nothing in it. SipHash fingerprints
+ * are kept rather than a CBloomFilter, which is capped at a size that large
+ * wallets would fill.
+ */
+class CWalletScanFilter
+{
+private:
+    const uint64_t k0;
+    const uint64_t k1;
+    std::unordered_set<uint64_t> setFingerprints;
+    //! Cleared when a watched script pushes nothing, so that any output may match it
+    bool fUsable{true};
+
+    uint64_t Fingerprint(const std::vector<unsigned char>& vData) const
+    {
+        return CSipHasher(k0, k1).Write(vData.data(), vData.size()).Finalize();
+    }
+
+public:
+    CWalletScanFilter() : k0(GetRand(std::numeric_limits<uint64_t>::max())), k1(GetRand(std::numeric_limits<uint64_t>::max())) {}
+
+    void Clear()
+    {
+        setFingerprints.clear();
+        fUsable = true;
+    }
+
+    void Insert(const std::vector<unsigned char>& vData)
+    {
+        setFingerprints.insert(Fingerprint(vData));
+    }
+
+    /** Insert every push of script, and turn the filter off if there are none */
+    void InsertPushes(const CScript& script)
+    {
+        bool fPushed = false;
+        CScript::const_iterator pc = script.begin();
+        opcodetype opcode;
+        std::vector<unsigned char> vData;
+        while (pc < script.end() && script.GetOp(pc, opcode, vData)) {
+            if (!vData.empty()) {
+                Insert(vData);
+                fPushed = true;
+            }
+        }
+        if (!fPushed)
+            fUsable = false;
+    }
+
+    /** Whether an output of tx may pay the wallet. False only when none can. */
+    bool MayPayWallet(const CTransaction& tx) const
+    {
+        if (!fUsable)
+            return true;
+        std::vector<unsigned char> vData;
+        opcodetype opcode;
+        for (const CTxOut& txout : tx.vout) {
+            CScript::const_iterator pc = txout.scriptPubKey.begin();
+            while (pc < txout.scriptPubKey.end() && txout.scriptPubKey.GetOp(pc, opcode, vData)) {
+                if (!vData.empty() && setFingerprints.count(Fingerprint(vData)))
+                    return true;
+            }
+        }
+        return false;
+    }
+};
+
+size_t CWallet::GetScanFilterSourceCount() const
+{
+    LOCK(cs_KeyStore);
+    return mapKeys.size() + mapCryptedKeys.size() + mapScripts.size() + setWatchOnly.size();
+}
+
+void CWallet::BuildScanFilter(CWalletScanFilter& filter) const
+{
+    LOCK(cs_KeyStore);
+    filter.Clear();
+    for (const CKeyID& keyid : GetKeys()) {
+        filter.Insert(ToByteVector(keyid));
+        CPubKey pubkey;
+        if (GetPubKey(keyid, pubkey))
+            filter.Insert(ToByteVector(pubkey));
+    }
+    for (const auto& item : mapScripts) {
+        // P2SH pays the script's hash160, P2WSH its SHA256
+        filter.Insert(ToByteVector(item.first));
+        uint256 hash;
+        CSHA256().Write(item.second.data(), item.second.size()).Finalize(hash.begin());
+        filter.Insert(ToByteVector(hash));
+    }
+    for (const CScript& script : setWatchOnly)
+        filter.InsertPushes(script);
+}
+
+/** Read the blocks of vIndex into vBlocks on up to RESCAN_MAX_READ_THREADS threads */
+static void ReadRescanBlocks(const std::vector<CBlockIndex*>& vIndex, std::vector<CBlock>& vBlocks, std::vector<char>& vRead)
+{
+    vBlocks.assign(vIndex.size(), CBlock());
+    vRead.assign(vIndex.size(), false);
+
+    std::atomic<size_t> nNext{0};
+    auto readBlocks = [&]() {
+        for (size_t i = nNext++; i < vIndex.size(); i = nNext++)
+            vRead[i] = ReadBlockFromDisk(vBlocks[i], vIndex[i], GetParams().GetConsensus());
+    };
+
+    size_t nThreads = std::min<size_t>(std::min(std::max(1, GetNumCores()), RESCAN_MAX_READ_THREADS), vIndex.size());
+    std::vector<std::thread> threads;
+    for (size_t t = 1; t < nThreads; t++) {
+        threads.emplace_back(readBlocks);
+    }
+    readBlocks();
+    for (auto& thread : threads) {
+        thread.join();
+    }
+}
+
 /**
  * Scan the block chain (starting in pindexStart) for transactions
  * from or to us. If fUpdate is true, found transactions that already
@@ -1759,6 +2209,11 @@ int64_t CWallet::RescanFromTime(int64_t startTime, bool update)
  *
  * If pindexStop is not a nullptr, the scan will stop at the block-index
  * defined by pindexStop
+ *
+ * Blocks are read and deserialized on other threads, RESCAN_PREFETCH_BLOCKS
+ * ahead of the ones being scanned, which are applied to the wallet in order.
+ * Transactions that neither spend from nor pay the wallet, going by mapWallet
+ * and the scan filter, are passed over without calling IsMine.
  */
 CBlockIndex* CWallet::ScanForWalletTransactions(CBlockIndex* pindexStart, CBlockIndex* pindexStop, bool fUpdate)
 {
@@ -1776,30 +2231,67 @@ CBlockIndex* CWallet::ScanForWalletTransactions(CBlockIndex* pindexStart, CBlock
         fAbortRescan = false;
         fScanningWallet = true;
 
+        CWalletScanFilter filter;
+        BuildScanFilter(filter);
+        size_t nFilterSources = GetScanFilterSourceCount();
+
+        // The blocks being scanned, and the ones being read ahead of them
+        std::vector<CBlockIndex*> vIndex, vIndexNext;
+        std::vector<CBlock> vBlocks, vBlocksNext;
+        std::vector<char> vRead, vReadNext;
+        auto nextIndexes = [&](CBlockIndex* pindexFrom, std::vector<CBlockIndex*>& vIndexOut) {
+            vIndexOut.clear();
+            for (CBlockIndex* pindexNext = pindexFrom; pindexNext && vIndexOut.size() < RESCAN_PREFETCH_BLOCKS; pindexNext = chainActive.Next(pindexNext)) {
+                vIndexOut.push_back(pindexNext);
+                if (pindexNext == pindexStop)
+                    break;
+            }
+        };
+        nextIndexes(pindex, vIndex);
+        ReadRescanBlocks(vIndex, vBlocks, vRead);
+
         ShowProgress(_("Rescanning..."), 0); // show rescan progress in GUI as dialog or on splashscreen, if -rescan on startup
         double dProgressStart = GuessVerificationProgress(chainParams.TxData(), pindex);
         double dProgressTip = GuessVerificationProgress(chainParams.TxData(), chainActive.Tip());
-        while (pindex && !fAbortRescan)
+        while (!vIndex.empty() && !fAbortRescan)
         {
-            if (pindex->nHeight % 100 == 0 && dProgressTip - dProgressStart > 0.0)
-                ShowProgress(_("Rescanning..."), std::max(1, std::min(99, (int)((GuessVerificationProgress(chainParams.TxData(), pindex) - dProgressStart) / (dProgressTip - dProgressStart) * 100))));
-            if (GetTime() >= nNow + 60) {
-                nNow = GetTime();
-                LogPrintf("Still rescanning. At block %d. Progress=%f\n", pindex->nHeight, GuessVerificationProgress(chainParams.TxData(), pindex));
-            }
+            nextIndexes(vIndex.back() == pindexStop ? nullptr : chainActive.Next(vIndex.back()), vIndexNext);
+            std::future<void> reading = std::async(std::launch::async, [&]() { ReadRescanBlocks(vIndexNext, vBlocksNext, vReadNext); });
+
+            for (size_t i = 0; i < vIndex.size() && !fAbortRescan; i++) {
+                pindex = vIndex[i];
+                if (pindex->nHeight % 100 == 0 && dProgressTip - dProgressStart > 0.0)
+                    ShowProgress(_("Rescanning..."), std::max(1, std::min(99, (int)((GuessVerificationProgress(chainParams.TxData(), pindex) - dProgressStart) / (dProgressTip - dProgressStart) * 100))));
+                if (GetTime() >= nNow + 60) {
+                    nNow = GetTime();
+                    LogPrintf("Still rescanning. At block %d. Progress=%f\n", pindex->nHeight, GuessVerificationProgress(chainParams.TxData(), pindex));
+                }
 
-            CBlock block;
-            if (ReadBlockFromDisk(block, pindex, GetParams().GetConsensus())) {
+                if (!vRead[i]) {
+                    ret = pindex;
+                    continue;
+                }
+                const CBlock& block = vBlocks[i];
                 for (size_t posInBlock = 0; posInBlock < block.vtx.size(); ++posInBlock) {
-                    AddToWalletIfInvolvingMe(block.vtx[posInBlock], pindex, posInBlock, fUpdate);
+                    const CTransaction& tx = *block.vtx[posInBlock];
+                    bool fRelevant = mapWallet.count(tx.GetHash()) || filter.MayPayWallet(tx);
+                    for (size_t n = 0; n < tx.vin.size() && !fRelevant; n++) {
+                        fRelevant = mapWallet.count(tx.vin[n].prevout.hash) || mapTxSpends.count(tx.vin[n].prevout);
+                    }
+                    if (!fRelevant)
+                        continue;
+                    if (AddToWalletIfInvolvingMe(block.vtx[posInBlock], pindex, posInBlock, fUpdate) && GetScanFilterSourceCount() != nFilterSources) {
+                        // Keys were topped up; later outputs may pay the new ones
+                        BuildScanFilter(filter);
+                        nFilterSources = GetScanFilterSourceCount();
+                    }
                 }
-            } else {
-                ret = pindex;
-            }
-            if (pindex == pindexStop) {
-                break;
             }
-            pindex = chainActive.Next(pindex);
+
+            reading.wait();
+            vIndex.swap(vIndexNext);
+            vBlocks.swap(vBlocksNext);
+            vRead.swap(vReadNext);
         }
         if (pindex && fAbortRescan) {
             LogPrintf("Rescan aborted at block %d. Progress=%f\n", pindex->nHeight, GuessVerificationProgress(chainParams.TxData(), pindex));
@@ -2148,9 +2640,8 @@ CAmount CWallet::GetBalance() const
     CAmount nTotal = 0;
     {
         LOCK2(cs_main, cs_wallet);
-        for (std::map<uint256, CWalletTx>::const_iterator it = mapWallet.begin(); it != mapWallet.end(); ++it)
+        for (const CWalletTx* pcoin : GetWalletUTXOTxs())
         {
-            const CWalletTx* pcoin = &(*it).second;
             if (pcoin->IsTrusted())
                 nTotal += pcoin->GetAvailableCredit();
         }
@@ -2164,9 +2655,8 @@ CAmount CWallet::GetUnconfirmedBalance() const
     CAmount nTotal = 0;
     {
         LOCK2(cs_main, cs_wallet);
-        for (std::map<uint256, CWalletTx>::const_iterator it = mapWallet.begin(); it != mapWallet.end(); ++it)
+        for (const CWalletTx* pcoin : GetWalletUTXOTxs())
         {
-            const CWalletTx* pcoin = &(*it).second;
             if (!pcoin->IsTrusted() && pcoin->GetDepthInMainChain() == 0 && pcoin->InMempool())
                 nTotal += pcoin->GetAvailableCredit();
         }
@@ -2179,9 +2669,8 @@ CAmount CWallet::GetImmatureBalance() const
     CAmount nTotal = 0;
     {
         LOCK2(cs_main, cs_wallet);
-        for (std::map<uint256, CWalletTx>::const_iterator it = mapWallet.begin(); it != mapWallet.end(); ++it)
+        for (const CWalletTx* pcoin : GetWalletUTXOTxs())
         {
-            const CWalletTx* pcoin = &(*it).second;
             nTotal += pcoin->GetImmatureCredit();
         }
     }
@@ -2193,9 +2682,8 @@ CAmount CWallet::GetWatchOnlyBalance() const
     CAmount nTotal = 0;
     {
         LOCK2(cs_main, cs_wallet);
-        for (std::map<uint256, CWalletTx>::const_iterator it = mapWallet.begin(); it != mapWallet.end(); ++it)
+        for (const CWalletTx* pcoin : GetWalletUTXOTxs())
         {
-            const CWalletTx* pcoin = &(*it).second;
             if (pcoin->IsTrusted())
                 nTotal += pcoin->GetAvailableWatchOnlyCredit();
         }
@@ -2209,9 +2697,8 @@ CAmount CWallet::GetUnconfirmedWatchOnlyBalance() const
     CAmount nTotal = 0;
     {
         LOCK2(cs_main, cs_wallet);
-        for (std::map<uint256, CWalletTx>::const_iterator it = mapWallet.begin(); it != mapWallet.end(); ++it)
+        for (const CWalletTx* pcoin : GetWalletUTXOTxs())
         {
-            const CWalletTx* pcoin = &(*it).second;
             if (!pcoin->IsTrusted() && pcoin->GetDepthInMainChain() == 0 && pcoin->InMempool())
                 nTotal += pcoin->GetAvailableWatchOnlyCredit();
         }
@@ -2224,9 +2711,8 @@ CAmount CWallet::GetImmatureWatchOnlyBalance() const
     CAmount nTotal = 0;
     {
         LOCK2(cs_main, cs_wallet);
-        for (std::map<uint256, CWalletTx>::const_iterator it = mapWallet.begin(); it != mapWallet.end(); ++it)
+        for (const CWalletTx* pcoin : GetWalletUTXOTxs())
         {
-            const CWalletTx* pcoin = &(*it).second;
             nTotal += pcoin->GetImmatureWatchOnlyCredit();
         }
     }
@@ -2324,38 +2810,43 @@ void CWallet::AvailableCoinsAll(std::vector<COutput>& vCoins, std::map<std::stri
 
     {
         LOCK2(cs_main, cs_wallet);
+        UpdateWalletUTXOs();
 
         CAmount nTotal = 0;
 
-        /** RVN START */
-        bool fRVNLimitHit = false;
-        // A set of the hashes that have already been used
-        std::set<uint256> usedMempoolHashes;
-
-        std::map<std::string, CAmount> mapAssetTotals;
-        std::map<uint256, COutPoint> mapOutPoints;
-        std::set<std::string> setAssetMaxFound;
-        // Turn the OutPoints into a map that is easily interatable.
-        for (std::map<uint256, CWalletTx>::const_iterator it = mapWallet.begin(); it != mapWallet.end(); ++it) {
-            const uint256 &wtxid = it->first;
-            const CWalletTx *pcoin = &(*it).second;
-
-            if (!CheckFinalTx(*pcoin))
-                continue;
+        // The transaction of the last output looked at. The UTXO sets are
+        // ordered by txid, so it is checked once for all of its outputs.
+        uint256 hashLast;
+        const CWalletTx* pcoin = nullptr;
+        int nDepth = 0;
+        bool safeTx = false;
+        auto fnSelectTx = [&](const uint256& wtxid) -> bool {
+            if (wtxid == hashLast)
+                return pcoin != nullptr;
+            hashLast = wtxid;
+            pcoin = nullptr;
+
+            auto it = mapWallet.find(wtxid);
+            if (it == mapWallet.end())
+                return false;
+            const CWalletTx* ptx = &it->second;
 
-            if (pcoin->IsCoinBase() && pcoin->GetBlocksToMaturity() > 0)
-                continue;
+            if (!CheckFinalTx(*ptx))
+                return false;
 
-            int nDepth = pcoin->GetDepthInMainChain();
+            if (ptx->IsCoinBase() && ptx->GetBlocksToMaturity() > 0)
+                return false;
+
+            nDepth = ptx->GetDepthInMainChain();
             if (nDepth < 0)
-                continue;
+                return false;
 
             // We should not consider coins which aren't at least in our mempool
             // It's possible for these to be conflicted via ancestors which we may never be able to detect
-            if (nDepth == 0 && !pcoin->InMempool())
-                continue;
+            if (nDepth == 0 && !ptx->InMempool())
+                return false;
 
-            bool safeTx = pcoin->IsTrusted();
+            safeTx = ptx->IsTrusted();
 
             // We should not consider coins from transactions that are replacing
             // other transactions.
@@ -2372,7 +2863,7 @@ void CWallet::AvailableCoinsAll(std::vector<COutput>& vCoins, std::map<std::stri
             // be a 1-block reorg away from the chain where transactions A and C
             // were accepted to another chain where B, B', and C were all
             // accepted.
-            if (nDepth == 0 && pcoin->mapValue.count("replaces_txid")) {
+            if (nDepth == 0 && ptx->mapValue.count("replaces_txid")) {
                 safeTx = false;
             }
 
@@ -2384,59 +2875,68 @@ void CWallet::AvailableCoinsAll(std::vector<COutput>& vCoins, std::map<std::stri
             // intending to replace A', but potentially resulting in a scenario
             // where A, A', and D could all be accepted (instead of just B and
             // D, or just A and A' like the user would want).
-            if (nDepth == 0 && pcoin->mapValue.count("replaced_by_txid")) {
+            if (nDepth == 0 && ptx->mapValue.count("replaced_by_txid")) {
                 safeTx = false;
             }
 
             if (fOnlySafe && !safeTx) {
-                continue;
+                return false;
             }
 
             if (nDepth < nMinDepth || nDepth > nMaxDepth)
-                continue;
+                return false;
 
-            for (unsigned int i = 0; i < pcoin->tx->vout.size(); i++) {
+            pcoin = ptx;
+            return true;
+        };
 
-                int nType;
-                bool fIsOwner;
-                bool isAssetScript = pcoin->tx->vout[i].scriptPubKey.IsAssetScript(nType, fIsOwner);
-                if (coinControl && !isAssetScript && coinControl->HasSelected() && !coinControl->fAllowOtherInputs && !coinControl->IsSelected(COutPoint((*it).first, i)))
-                    continue;
+        // Output checks, for an output of pcoin
+        bool fSpendableIn = false;
+        bool fSolvableIn = false;
+        auto fnSelectOutput = [&](const COutPoint& outpoint, bool isAssetScript) -> bool {
+            if (coinControl && !isAssetScript && coinControl->HasSelected() && !coinControl->fAllowOtherInputs && !coinControl->IsSelected(outpoint))
+                return false;
 
-                if (coinControl && isAssetScript && coinControl->HasAssetSelected() && !coinControl->fAllowOtherInputs && !coinControl->IsAssetSelected(COutPoint((*it).first, i)))
-                    continue;
+            if (coinControl && isAssetScript && coinControl->HasAssetSelected() && !coinControl->fAllowOtherInputs && !coinControl->IsAssetSelected(outpoint))
+                return false;
 
-                if (IsLockedCoin((*it).first, i))
-                    continue;
+            if (IsLockedCoin(outpoint.hash, outpoint.n))
+                return false;
 
-                if (IsSpent(wtxid, i))
-                    continue;
+            if (IsSpent(outpoint.hash, outpoint.n))
+                return false;
 
-                isminetype mine = IsMine(pcoin->tx->vout[i]);
+            isminetype mine = IsMine(pcoin->tx->vout[outpoint.n]);
 
-                if (mine == ISMINE_NO) {
-                    continue;
-                }
+            if (mine == ISMINE_NO) {
+                return false;
+            }
 
-                bool fSpendableIn = ((mine & ISMINE_SPENDABLE) != ISMINE_NO) ||
-                                    (coinControl && coinControl->fAllowWatchOnly &&
-                                     (mine & ISMINE_WATCH_SOLVABLE) != ISMINE_NO);
-                bool fSolvableIn = (mine & (ISMINE_SPENDABLE | ISMINE_WATCH_SOLVABLE)) != ISMINE_NO;
+            fSpendableIn = ((mine & ISMINE_SPENDABLE) != ISMINE_NO) ||
+                           (coinControl && coinControl->fAllowWatchOnly &&
+                            (mine & ISMINE_WATCH_SOLVABLE) != ISMINE_NO);
+            fSolvableIn = (mine & (ISMINE_SPENDABLE | ISMINE_WATCH_SOLVABLE)) != ISMINE_NO;
+            return true;
+        };
 
-                std::string address;
+        /** RVN START */
+        // Looking for Asset Tx OutPoints Only
+        if (fGetAssets && AreAssetsDeployed()) {
+            for (const auto& assetUTXOs : mapWalletAssetUTXO) {
+                CAmount nAssetTotal = 0;
+                size_t nAssetCount = 0;
+                for (const COutPoint& outpoint : assetUTXOs.second) {
+                    if (!fnSelectTx(outpoint.hash))
+                        continue;
 
-                // Looking for Asset Tx OutPoints Only
-                if (fGetAssets && AreAssetsDeployed() && isAssetScript) {
+                    if (!fnSelectOutput(outpoint, true))
+                        continue;
 
                     CAssetOutputEntry output_data;
-                    if (!GetAssetData(pcoin->tx->vout[i].scriptPubKey, output_data))
+                    if (!GetAssetData(pcoin->tx->vout[outpoint.n].scriptPubKey, output_data))
                         continue;
 
-                    address = EncodeDestination(output_data.destination);
-
-                    // If we already have the maximum amount or size for this asset, skip it
-                    if (setAssetMaxFound.count(output_data.assetName))
-                        continue;
+                    std::string address = EncodeDestination(output_data.destination);
 
                     if (IsAssetNameAnRestricted(output_data.assetName)) {
                         if (passets->CheckForAddressRestriction(output_data.assetName, address, true)) {
@@ -2444,59 +2944,49 @@ void CWallet::AvailableCoinsAll(std::vector<COutput>& vCoins, std::map<std::stri
                         }
                     }
 
-                    // Initialize the map vector is it doesn't exist yet
-                    if (!mapAssetCoins.count(output_data.assetName)) {
-                        std::vector<COutput> vOutput;
-                        mapAssetCoins.insert(std::make_pair(output_data.assetName, vOutput));
-                    }
-
                     // Add the COutput to the map of available Asset Coins
-                    mapAssetCoins.at(output_data.assetName).push_back(
-                            COutput(pcoin, i, nDepth, fSpendableIn, fSolvableIn, safeTx));
-
-                    // Initialize the map of current asset totals
-                    if (!mapAssetTotals.count(output_data.assetName))
-                        mapAssetTotals[output_data.assetName] = 0;
+                    mapAssetCoins[output_data.assetName].push_back(
+                            COutput(pcoin, outpoint.n, nDepth, fSpendableIn, fSolvableIn, safeTx));
+                    nAssetCount++;
 
-                    // Update the map of totals depending the which type of asset tx we are looking at
-                    mapAssetTotals[output_data.assetName] += output_data.nAmount;
-
-                    // Checks the sum amount of all UTXO's, and adds to the set of assets that we found the max for
-                    if (nMinimumSumAmount != MAX_MONEY) {
-                        if (mapAssetTotals[output_data.assetName] >= nMinimumSumAmount)
-                            setAssetMaxFound.insert(output_data.assetName);
-                    }
+                    // Stop at the sum amount of all UTXO's
+                    nAssetTotal += output_data.nAmount;
+                    if (nMinimumSumAmount != MAX_MONEY && nAssetTotal >= nMinimumSumAmount)
+                        break;
 
-                    // Checks the maximum number of UTXO's, and addes to set of of asset that we found the max for
-                    if (nMaximumCount > 0 && mapAssetCoins[output_data.assetName].size() >= nMaximumCount) {
-                        setAssetMaxFound.insert(output_data.assetName);
-                    }
+                    // Stop at the maximum number of UTXO's
+                    if (nMaximumCount > 0 && nAssetCount >= nMaximumCount)
+                        break;
                 }
+            }
+        }
 
-                if (fGetRVN) { // Looking for RVN Tx OutPoints Only
-                    if (fRVNLimitHit) // We hit our limit
-                        continue;
+        if (fGetRVN) { // Looking for RVN Tx OutPoints Only
+            for (const COutPoint& outpoint : setWalletUTXO) {
+                if (!fnSelectTx(outpoint.hash))
+                    continue;
 
-                    // We only want RVN OutPoints. Don't include Asset OutPoints
-                    if (isAssetScript)
-                        continue;
+                // We only want RVN OutPoints. Don't include Asset OutPoints
+                if (pcoin->tx->vout[outpoint.n].scriptPubKey.IsAssetScript())
+                    continue;
 
-                    vCoins.push_back(COutput(pcoin, i, nDepth, fSpendableIn, fSolvableIn, safeTx));
+                if (!fnSelectOutput(outpoint, false))
+                    continue;
 
-                    // Checks the sum amount of all UTXO's.
-                    if (nMinimumSumAmount != MAX_MONEY) {
-                        nTotal += pcoin->tx->vout[i].nValue;
+                vCoins.push_back(COutput(pcoin, outpoint.n, nDepth, fSpendableIn, fSolvableIn, safeTx));
 
-                        if (nTotal >= nMinimumSumAmount) {
-                            fRVNLimitHit = true;
-                        }
-                    }
+                // Checks the sum amount of all UTXO's.
+                if (nMinimumSumAmount != MAX_MONEY) {
+                    nTotal += pcoin->tx->vout[outpoint.n].nValue;
 
-                    // Checks the maximum number of UTXO's.
-                    if (nMaximumCount > 0 && vCoins.size() >= nMaximumCount) {
-                        fRVNLimitHit = true;
+                    if (nTotal >= nMinimumSumAmount) {
+                        break;
                     }
-                    continue;
+                }
+
+                // Checks the maximum number of UTXO's.
+                if (nMaximumCount > 0 && vCoins.size() >= nMaximumCount) {
+                    break;
                 }
             }
         }
@@ -2914,23 +3404,135 @@ bool CWallet::CreateNewChangeAddress(CReserveKey& reservekey, CKeyID& keyID, std
     return true;
 }
 
-bool CWallet::SelectAssetsMinConf(const CAmount& nTargetValue, const int nConfMine, const int nConfTheirs, const uint64_t nMaxAncestors, const std::string& strAssetName, std::vector<COutput> vCoins,
+/** The asset amount an output pays, as asset coin selection counts it */
+static bool GetAssetCoinAmount(const CScript& scriptPubKey, CAmount& nAmount)
+{
+    int nType = -1;
+    bool fIsOwner = false;
+    if (!scriptPubKey.IsAssetScript(nType, fIsOwner)) {
+        return false;
+    }
+
+    std::string address;
+    if (nType == TX_NEW_ASSET && !fIsOwner) { // Root/Sub Asset
+        CNewAsset assetTemp;
+        if (!AssetFromScript(scriptPubKey, assetTemp, address))
+            return false;
+        nAmount = assetTemp.nAmount;
+    } else if (nType == TX_TRANSFER_ASSET) { // Transfer Asset
+        CAssetTransfer transferTemp;
+        if (!TransferAssetFromScript(scriptPubKey, transferTemp, address))
+            return false;
+        nAmount = transferTemp.nAmount;
+    } else if (nType == TX_NEW_ASSET && fIsOwner) { // Owner Asset
+        std::string ownerName;
+        if (!OwnerAssetFromScript(scriptPubKey, ownerName, address))
+            return false;
+        nAmount = OWNER_ASSET_AMOUNT;
+    } else if (nType == TX_REISSUE_ASSET) { // Reissue Asset
+        CReissueAsset reissueTemp;
+        if (!ReissueAssetFromScript(scriptPubKey, reissueTemp, address))
+            return false;
+        nAmount = reissueTemp.nAmount;
+    } else {
+        return false;
+    }
+    return true;
+}
+
+/** Index the asset outputs in vCoins by amount, largest first. The index points into vCoins. */
+static void BuildAssetCoinIndex(const std::vector<COutput>& vCoins, std::vector<CAssetCoinValue>& vIndex)
+{
+    vIndex.clear();
+    vIndex.reserve(vCoins.size());
+    for (const COutput& output : vCoins) {
+        CAmount nAmount;
+        if (GetAssetCoinAmount(output.tx->tx->vout[output.i].scriptPubKey, nAmount))
+            vIndex.push_back(CAssetCoinValue{&output, nAmount});
+    }
+    std::stable_sort(vIndex.begin(), vIndex.end(), [](const CAssetCoinValue& a, const CAssetCoinValue& b) {
+        return a.nAmount > b.nAmount;
+    });
+}
+
+/**
+ * Branch and bound search for a subset of vValues, sorted largest first, that
+ * adds up to exactly nTargetValue, preferring fewer inputs. Gives up after
+ * ASSET_BNB_TOTAL_TRIES steps. vSelected gets positions in vValues.
+ */
+static bool SelectAssetsBnB(const std::vector<CAmount>& vValues, const CAmount& nTargetValue, std::vector<size_t>& vSelected)
+{
+    // vRemaining[i] is the sum of vValues[i] and all after it
+    std::vector<CAmount> vRemaining(vValues.size() + 1, 0);
+    for (size_t i = vValues.size(); i-- > 0;)
+        vRemaining[i] = vRemaining[i + 1] + vValues[i];
+    if (vRemaining[0] < nTargetValue)
+        return false;
+
+    std::vector<size_t> vCurrent;
+    std::vector<size_t> vBest;
+    CAmount nCurrent = 0;
+    size_t i = 0;
+    for (size_t nTries = 0; nTries < ASSET_BNB_TOTAL_TRIES; nTries++) {
+        bool fBacktrack = false;
+        if (nCurrent > nTargetValue || nCurrent + vRemaining[i] < nTargetValue) {
+            fBacktrack = true; // Overshot, or what is left cannot reach the target
+        } else if (!vBest.empty() && vCurrent.size() >= vBest.size()) {
+            fBacktrack = true; // Cannot do better than the best match
+        } else if (nCurrent == nTargetValue) {
+            vBest = vCurrent;
+            fBacktrack = true;
+        }
+
+        if (!fBacktrack) {
+            // Try the branch with vValues[i] first
+            vCurrent.push_back(i);
+            nCurrent += vValues[i];
+            i++;
+            continue;
+        }
+
+        // Move to the branch without the last value taken. Leaving out an
+        // equal value next would repeat that branch, so skip those too.
+        if (vCurrent.empty())
+            break;
+        const size_t nLast = vCurrent.back();
+        vCurrent.pop_back();
+        nCurrent -= vValues[nLast];
+        i = nLast + 1;
+        while (i < vValues.size() && vValues[i] == vValues[nLast])
+            i++;
+    }
+
+    if (vBest.empty())
+        return false;
+    vSelected = vBest;
+    return true;
+}
+
+bool CWallet::SelectAssetsMinConf(const CAmount& nTargetValue, const int nConfMine, const int nConfTheirs, const uint64_t nMaxAncestors, const std::string& strAssetName, const std::vector<COutput>& vCoins,
+                                 std::set<CInputCoin>& setCoinsRet, CAmount& nValueRet) const
+{
+    std::vector<CAssetCoinValue> vIndex;
+    BuildAssetCoinIndex(vCoins, vIndex);
+    return SelectAssetsMinConf(nTargetValue, nConfMine, nConfTheirs, nMaxAncestors, strAssetName, vIndex, setCoinsRet, nValueRet);
+}
+
+bool CWallet::SelectAssetsMinConf(const CAmount& nTargetValue, const int nConfMine, const int nConfTheirs, const uint64_t nMaxAncestors, const std::string& strAssetName, const std::vector<CAssetCoinValue>& vIndex,
                                  std::set<CInputCoin>& setCoinsRet, CAmount& nValueRet) const
 {
     setCoinsRet.clear();
     nValueRet = 0;
 
-    // List of values less than target
-    boost::optional<CInputCoin> coinLowestLarger;
-    boost::optional<CAmount> coinLowestLargerAmount;
-    std::vector<std::pair<CInputCoin, CAmount> > vValue;
-    std::map<COutPoint, CAmount> mapValueAmount;
+    // Outputs worth less than target plus change, largest first, and the
+    // smallest one worth more
+    std::vector<const CAssetCoinValue*> vLower;
+    const CAssetCoinValue* coinLowestLarger = nullptr;
     CAmount nTotalLower = 0;
 
-    Shuffle(vCoins.begin(), vCoins.end(), FastRandomContext());
-    #pragma GCC diagnostic ignored "-Wmaybe-uninitialized"
-    for (const COutput &output : vCoins)
+    for (const CAssetCoinValue& entry : vIndex)
     {
+        const COutput& output = *entry.pout;
         if (!output.fSpendable)
             continue;
 
@@ -2942,89 +3544,65 @@ bool CWallet::SelectAssetsMinConf(const CAmount& nTargetValue, const int nConfMi
         if (!mempool.TransactionWithinChainLimit(pcoin->GetHash(), nMaxAncestors))
             continue;
 
-        int i = output.i;
-
-        CInputCoin coin = CInputCoin(pcoin, i);
-
-        //-------------------------------
-
-        int nType = -1;
-        bool fIsOwner = false;
-        if (!coin.txout.scriptPubKey.IsAssetScript(nType, fIsOwner)) {
-            continue;
-        }
-
-        CAmount nTempAmount = 0;
-        if (nType == TX_NEW_ASSET && !fIsOwner) { // Root/Sub Asset
-            CNewAsset assetTemp;
-            std::string address;
-            if (!AssetFromScript(coin.txout.scriptPubKey, assetTemp, address))
-                continue;
-            nTempAmount = assetTemp.nAmount;
-        } else if (nType == TX_TRANSFER_ASSET) { // Transfer Asset
-            CAssetTransfer transferTemp;
-            std::string address;
-            if (!TransferAssetFromScript(coin.txout.scriptPubKey, transferTemp, address))
-                continue;
-            nTempAmount = transferTemp.nAmount;
-        } else if (nType == TX_NEW_ASSET && fIsOwner) { // Owner Asset
-            std::string ownerName;
-            std::string address;
-            if (!OwnerAssetFromScript(coin.txout.scriptPubKey, ownerName, address))
-                continue;
-            nTempAmount = OWNER_ASSET_AMOUNT;
-        } else if (nType == TX_REISSUE_ASSET) { // Reissue Asset
-            CReissueAsset reissueTemp;
-            std::string address;
-            if (!ReissueAssetFromScript(coin.txout.scriptPubKey, reissueTemp, address))
-                continue;
-            nTempAmount = reissueTemp.nAmount;
-        } else {
-            continue;
-        }
-
-        if (nTempAmount == nTargetValue)
+        if (entry.nAmount == nTargetValue)
         {
-            setCoinsRet.insert(coin);
-            nValueRet += nTempAmount;
+            setCoinsRet.insert(CInputCoin(pcoin, output.i));
+            nValueRet += entry.nAmount;
             return true;
         }
-        else if (nTempAmount < nTargetValue + MIN_CHANGE)
+        else if (entry.nAmount < nTargetValue + MIN_CHANGE)
         {
-            vValue.push_back(std::make_pair(coin, nTempAmount));
-            nTotalLower += nTempAmount;
+            vLower.push_back(&entry);
+            nTotalLower += entry.nAmount;
         }
-        else if (!coinLowestLarger || !coinLowestLargerAmount || nTempAmount < coinLowestLargerAmount)
+        else
         {
-            coinLowestLarger = coin;
-            coinLowestLargerAmount = nTempAmount;
+            // The index is sorted, so each one found is smaller than the last
+            coinLowestLarger = &entry;
         }
     }
 
     if (nTotalLower == nTargetValue)
     {
-        for (const auto& pair : vValue)
+        for (const CAssetCoinValue* entry : vLower)
         {
-            setCoinsRet.insert(pair.first);
-            nValueRet += pair.second;
+            setCoinsRet.insert(CInputCoin(entry->pout->tx, entry->pout->i));
+            nValueRet += entry->nAmount;
         }
         return true;
     }
 
     if (nTotalLower < nTargetValue)
     {
-        if (!coinLowestLarger || !coinLowestLargerAmount)
+        if (!coinLowestLarger)
             return false;
-        setCoinsRet.insert(coinLowestLarger.get());
+        setCoinsRet.insert(CInputCoin(coinLowestLarger->pout->tx, coinLowestLarger->pout->i));
+        nValueRet += coinLowestLarger->nAmount;
+        return true;
+    }
 
-        #pragma GCC diagnostic ignored "-Wmaybe-uninitialized"
-        nValueRet += coinLowestLargerAmount.get();
+    // Look for an exact match first, which needs no asset change output
+    std::vector<CAmount> vLowerValues;
+    vLowerValues.reserve(vLower.size());
+    for (const CAssetCoinValue* entry : vLower)
+        vLowerValues.push_back(entry->nAmount);
+    std::vector<size_t> vSelected;
+    if (SelectAssetsBnB(vLowerValues, nTargetValue, vSelected))
+    {
+        for (size_t i : vSelected)
+        {
+            setCoinsRet.insert(CInputCoin(vLower[i]->pout->tx, vLower[i]->pout->i));
+            nValueRet += vLower[i]->nAmount;
+        }
+        LogPrint(BCLog::SELECTCOINS, "SelectAssets() exact match of %u inputs for %s : %s\n", vSelected.size(), strAssetName, FormatMoney(nValueRet));
         return true;
     }
 
     // Solve subset sum by stochastic approximation
-    std::sort(vValue.begin(), vValue.end(), CompareAssetValueOnly());
-    std::reverse(vValue.begin(), vValue.end());
+    std::vector<std::pair<CInputCoin, CAmount> > vValue;
+    vValue.reserve(vLower.size());
+    for (const CAssetCoinValue* entry : vLower)
+        vValue.emplace_back(CInputCoin(entry->pout->tx, entry->pout->i), entry->nAmount);
     std::vector<char> vfBest;
     CAmount nBest;
 
@@ -3034,11 +3612,11 @@ bool CWallet::SelectAssetsMinConf(const CAmount& nTargetValue, const int nConfMi
 
     // If we have a bigger coin and (either the stochastic approximation didn't find a good solution,
     //                                   or the next bigger coin is closer), return the bigger coin
-    if (coinLowestLarger && coinLowestLargerAmount &&
-        ((nBest != nTargetValue && nBest < nTargetValue + MIN_CHANGE) || coinLowestLargerAmount <= nBest))
+    if (coinLowestLarger &&
+        ((nBest != nTargetValue && nBest < nTargetValue + MIN_CHANGE) || coinLowestLarger->nAmount <= nBest))
     {
-        setCoinsRet.insert(coinLowestLarger.get());
-        nValueRet += coinLowestLargerAmount.get();
+        setCoinsRet.insert(CInputCoin(coinLowestLarger->pout->tx, coinLowestLarger->pout->i));
+        nValueRet += coinLowestLarger->nAmount;
     }
     else {
         for (unsigned int i = 0; i < vValue.size(); i++)
@@ -3071,9 +3649,10 @@ bool CWallet::SelectAssets(const std::map<std::string, std::vector<COutput> >& m
     size_t nMaxChainLength = std::min(gArgs.GetArg("-limitancestorcount", DEFAULT_ANCESTOR_LIMIT), gArgs.GetArg("-limitdescendantcount", DEFAULT_DESCENDANT_LIMIT));
     bool fRejectLongChains = gArgs.GetBoolArg("-walletrejectlongchains", DEFAULT_WALLET_REJECT_LONG_CHAINS);
 
-    for (auto assetVector : mapAvailableAssets) {
-        // Setup temporay variables
-        std::vector<COutput> vAssets(assetVector.second);
+    for (const auto& assetVector : mapAvailableAssets) {
+        // Index the outputs by amount once for all the passes below
+        std::vector<CAssetCoinValue> vAssets;
+        BuildAssetCoinIndex(assetVector.second, vAssets);
 
         std::set<CInputCoin> tempCoinsRet;
         CAmount nTempAmountRet;
@@ -4110,18 +4689,13 @@ bool CWallet::TopUpKeyPool(unsigned int kpSize)
             // don't create extra internal keys
             missingInternal = 0;
         }
-        bool internal = false;
         CWalletDB walletdb(*dbw);
-        for (int64_t i = missingInternal + missingExternal; i--;)
-        {
-            if (i < missingInternal) {
-                internal = true;
-            }
-
+        // The keys, their metadata and pool entries are written together
+        CWalletDBBatchScope batchScope(*dbw);
+        auto addToPool = [&](const CPubKey& pubkey, bool internal) {
             assert(m_max_keypool_index < std::numeric_limits<int64_t>::max()); // How in the hell did you use so many keys?
             int64_t index = ++m_max_keypool_index;
 
-            CPubKey pubkey(GenerateNewKey(walletdb, internal));
             if (!walletdb.WritePool(index, CKeyPool(pubkey, internal))) {
                 throw std::runtime_error(std::string(__func__) + ": writing generated key failed");
             }
@@ -4132,6 +4706,16 @@ bool CWallet::TopUpKeyPool(unsigned int kpSize)
                 setExternalKeyPool.insert(index);
             }
             m_pool_key_to_index[pubkey.GetID()] = index;
+        };
+
+        if (IsHDEnabled()) {
+            for (const CPubKey& pubkey : GenerateNewHDKeys(walletdb, missingExternal, false))
+                addToPool(pubkey, false);
+            for (const CPubKey& pubkey : GenerateNewHDKeys(walletdb, missingInternal, true))
+                addToPool(pubkey, true);
+        } else {
+            for (int64_t i = missingExternal; i--;)
+                addToPool(GenerateNewKey(walletdb, false), false);
         }
         if (missingInternal + missingExternal > 0) {
             LogPrintf("keypool added %d keys (%d internal), size=%u (%u internal)\n", missingInternal + missingExternal, missingInternal, setInternalKeyPool.size() + setExternalKeyPool.size(), setInternalKeyPool.size());
@@ -4682,7 +5266,7 @@ CWallet* CWallet:: CreateWalletFromFile(const std::string walletFile)
     if (gArgs.GetBoolArg("-zapwallettxes", false)) {
         uiInterface.InitMessage(_("Zapping all transactions from wallet..."));
 
-        std::unique_ptr<CWalletDBWrapper> dbw(new CWalletDBWrapper(&bitdb, walletFile));
+        std::unique_ptr<CWalletDBWrapper> dbw = CWalletDBWrapper::Open(walletFile);
         std::unique_ptr<CWallet> tempWallet(new CWallet(std::move(dbw)));
         DBErrors nZapWalletRet = tempWallet->ZapWalletTx(vWtx);
         if (nZapWalletRet != DB_LOAD_OK) {
@@ -4695,7 +5279,7 @@ CWallet* CWallet:: CreateWalletFromFile(const std::string walletFile)
 
     int64_t nStart = GetTimeMillis();
     bool fFirstRun = true;
-    std::unique_ptr<CWalletDBWrapper> dbw(new CWalletDBWrapper(&bitdb, walletFile));
+    std::unique_ptr<CWalletDBWrapper> dbw = CWalletDBWrapper::Open(walletFile);
     CWallet *walletInstance = new CWallet(std::move(dbw));
     DBErrors nLoadWalletRet = walletInstance->LoadWallet(fFirstRun);
     if (nLoadWalletRet != DB_LOAD_OK)
@@ -4900,6 +5484,7 @@ CWallet* CWallet:: CreateWalletFromFile(const std::string walletFile)
         }
     }
     walletInstance->SetBroadcastTransactions(gArgs.GetBoolArg("-walletbroadcast", DEFAULT_WALLETBROADCAST));
+    walletInstance->LoadHTLCTimeouts();
 
     {
         LOCK(walletInstance->cs_wallet);
@@ -4921,7 +5506,7 @@ void CWallet::postInitProcess(CScheduler& scheduler)
 
     // Run a thread to flush wallet periodically
     if (!CWallet::fFlushScheduled.exchange(true)) {
-        scheduler.scheduleEvery(MaybeCompactWalletDB, 500);
+        scheduler.scheduleEvery(MaybeCompactWalletDB, 500, "wallet_compact");
     }
 }
 
@@ -17,6 +17,7 @@
 #include "script/ismine.h"
 #include "script/sign.h"
 #include "wallet/crypter.h"
+#include "wallet/htlctimeouts.h"
 #include "wallet/walletdb.h"
 #include "wallet/rpcwallet.h"
 #include "assets/assettypes.h"
@@ -42,6 +43,7 @@ extern CFeeRate payTxFee;
 extern unsigned int nTxConfirmTarget;
 extern bool bSpendZeroConfChange;
 extern bool fWalletRbf;
+extern bool fHTLCAutoRefund;
 
 extern std::string my_words;
 extern std::string my_passphrase;
@@ -61,14 +63,28 @@ static const CAmount WALLET_INCREMENTAL_RELAY_FEE = 5000;
 static const CAmount MIN_CHANGE = CENT;
 //! final minimum change amount after paying for fees
 static const CAmount MIN_FINAL_CHANGE = MIN_CHANGE/2;
+//! steps the branch and bound asset selection takes before it falls back to the subset search
+static const size_t ASSET_BNB_TOTAL_TRIES = 100000;
 //! Default for -spendzeroconfchange
 static const bool DEFAULT_SPEND_ZEROCONF_CHANGE = true;
 //! Default for -walletrejectlongchains
 static const bool DEFAULT_WALLET_REJECT_LONG_CHAINS = false;
+//! Blocks a rescan reads ahead, on other threads, of the ones it is scanning
+static const size_t RESCAN_PREFETCH_BLOCKS = 64;
+//! Maximum number of threads reading blocks ahead of a rescan
+static const int RESCAN_MAX_READ_THREADS = 4;
+//! Maximum number of threads TopUpKeyPool derives HD keys on
+static const int KEYPOOL_MAX_DERIVE_THREADS = 8;
 //! -txconfirmtarget default
 static const unsigned int DEFAULT_TX_CONFIRM_TARGET = 6;
 //! -walletrbf default
 static const bool DEFAULT_WALLET_RBF = false;
+//! -htlcautorefund default
+static const bool DEFAULT_HTLC_AUTOREFUND = false;
+//! Most HTLCs one automatic refund transaction spends
+static const size_t MAX_HTLC_REFUND_BATCH = 100;
+//! Blocks until an automatic refund that couldn't be made is tried again
+static const int HTLC_REFUND_RETRY_BLOCKS = 10;
 static const bool DEFAULT_WALLETBROADCAST = true;
 static const bool DEFAULT_DISABLE_WALLET = false;
 
@@ -84,6 +100,7 @@ class CScript;
 class CScheduler;
 class CTxMemPool;
 class CBlockPolicyEstimator;
+class CWalletScanFilter;
 class CWalletTx;
 struct FeeCalculation;
 enum class FeeEstimateMode;
@@ -555,6 +572,13 @@ public:
     std::string ToString() const;
 };
 
+/** An asset output and the asset amount it holds, as asset coin selection indexes them */
+struct CAssetCoinValue
+{
+    const COutput* pout;
+    CAmount nAmount;
+};
+
 
 
 
@@ -715,6 +739,37 @@ private:
 
     void SyncMetaData(std::pair<TxSpends::iterator, TxSpends::iterator>);
 
+    //! Number of keys, scripts and watched scripts; it grows when one is added
+    size_t GetScanFilterSourceCount() const;
+    //! Fill filter with what scripts paying this wallet push, for rescans
+    void BuildScanFilter(CWalletScanFilter& filter) const;
+
+    /**
+     * Outputs that are ours and not spent by a transaction in the main chain,
+     * so that balances and coin selection need not walk all of mapWallet.
+     * setWalletUTXO holds them all, mapWalletAssetUTXO the asset outputs by
+     * asset name. They may still hold outputs that are spent in the mempool,
+     * conflicted or immature; callers check those as before.
+     */
+    mutable std::set<COutPoint> setWalletUTXO;
+    mutable std::map<std::string, std::set<COutPoint> > mapWalletAssetUTXO;
+    //! Set when what is ours may have changed; the sets are rebuilt on next use
+    mutable bool fWalletUTXODirty;
+
+    void AddWalletUTXOs(const CWalletTx& wtx) const;
+    void AddWalletUTXO(const COutPoint& outpoint, const CTxOut& txout) const;
+    void EraseWalletUTXO(const COutPoint& outpoint);
+    //! Rebuild the sets from mapWallet if they are dirty. Needs cs_main and cs_wallet.
+    void UpdateWalletUTXOs() const;
+    //! Wallet transactions with at least one output in setWalletUTXO
+    std::vector<const CWalletTx*> GetWalletUTXOTxs() const;
+
+    //! HTLCs this wallet funded and can refund, by the height their refund path opens
+    CHTLCTimeoutQueue htlcTimeouts;
+
+    /** Spend HTLC outputs whose refund path is open back to a new key, in one transaction */
+    bool RefundHTLCs(const std::vector<std::pair<COutPoint, CScript>>& vHTLCs, std::string& strError);
+
     /* Used by TransactionAddedToMemorypool/BlockConnected/Disconnected.
      * Should be called with pindexBlock and posInBlock if this is for a transaction that is included in a block. */
     void SyncTransaction(const CTransactionRef& tx, const CBlockIndex *pindex = nullptr, int posInBlock = 0);
@@ -722,6 +777,12 @@ private:
     /* the HD chain data model (external chain counters) */
     CHDChain hdChain;
 
+    /* HD key of the internal or external chain, that the keys on it are derived from */
+    CExtKey GetHDChainKey(bool internal) const;
+    /* HD derive the child key at nChildIndex of a chain key; thread safe */
+    void DeriveHDChildKey(const CExtKey& chainKey, uint32_t nChildIndex, CKey& secret) const;
+    std::string GetHDKeypath(bool internal, uint32_t nChildIndex) const;
+
     /* HD derive new child key (on internal or external chain) */
     void DeriveNewChildKey(CWalletDB &walletdb, CKeyMetadata& metadata, CKey& secret, bool internal = false);
 
@@ -815,6 +876,7 @@ public:
         nRelockTime = 0;
         fAbortRescan = false;
         fScanningWallet = false;
+        fWalletUTXODirty = true;
     }
 
     std::map<uint256, CWalletTx> mapWallet;
@@ -892,7 +954,13 @@ public:
      * assembled
      */
     bool SelectCoinsMinConf(const CAmount& nTargetValue, int nConfMine, int nConfTheirs, uint64_t nMaxAncestors, std::vector<COutput> vCoins, std::set<CInputCoin>& setCoinsRet, CAmount& nValueRet) const;
-    bool SelectAssetsMinConf(const CAmount& nTargetValue, const int nConfMine, const int nConfTheirs, const uint64_t nMaxAncestors, const std::string& strAssetName, std::vector<COutput> vCoins, std::set<CInputCoin>& setCoinsRet, CAmount& nValueRet) const;
+    bool SelectAssetsMinConf(const CAmount& nTargetValue, const int nConfMine, const int nConfTheirs, const uint64_t nMaxAncestors, const std::string& strAssetName, const std::vector<COutput>& vCoins, std::set<CInputCoin>& setCoinsRet, CAmount& nValueRet) const;
+    /**
+     * Select from vIndex, asset outputs sorted by amount with the largest first.
+     * An exact match found by branch and bound is preferred, so that no asset
+     * change output is needed; otherwise the stochastic subset search is used.
+     */
+    bool SelectAssetsMinConf(const CAmount& nTargetValue, const int nConfMine, const int nConfTheirs, const uint64_t nMaxAncestors, const std::string& strAssetName, const std::vector<CAssetCoinValue>& vIndex, std::set<CInputCoin>& setCoinsRet, CAmount& nValueRet) const;
 
     bool IsSpent(const uint256& hash, unsigned int n) const;
 
@@ -914,6 +982,8 @@ public:
      * Generate a new key
      */
     CPubKey GenerateNewKey(CWalletDB& walletdb, bool internal = false);
+    //! Derive and add nKeys new HD keys on one chain, on several threads
+    std::vector<CPubKey> GenerateNewHDKeys(CWalletDB& walletdb, size_t nKeys, bool internal);
     //! Adds a key to the store, and saves it to disk.
     bool AddKeyPubKey(const CKey& key, const CPubKey &pubkey) override;
     bool AddKeyPubKeyWithDB(CWalletDB &walletdb,const CKey& key, const CPubKey &pubkey);
@@ -939,6 +1009,14 @@ public:
     bool AddCScript(const CScript& redeemScript) override;
     bool LoadCScript(const CScript& redeemScript);
 
+    /**
+     * Keep the redeem script of an HTLC this wallet funded, refundable with
+     * one of its keys, and watch the output until the refund path opens
+     */
+    bool WatchHTLC(const COutPoint& outpoint, const CScript& redeemScript);
+    //! Watch the unspent HTLC outputs of the wallet's transactions again after loading
+    void LoadHTLCTimeouts();
+
     //! Adds a destination data tuple to the store, and saves it to disk
     bool AddDestData(const CTxDestination &dest, const std::string &key, const std::string &value);
     //! Erases a destination data tuple in the store and on disk
@@ -981,6 +1059,7 @@ public:
     void TransactionAddedToMempool(const CTransactionRef& tx) override;
     void BlockConnected(const std::shared_ptr<const CBlock>& pblock, const CBlockIndex *pindex, const std::vector<CTransactionRef>& vtxConflicted) override;
     void BlockDisconnected(const std::shared_ptr<const CBlock>& pblock) override;
+    void UpdatedBlockTip(const CBlockIndex* pindexNew, const CBlockIndex* pindexFork, bool fInitialDownload) override;
     bool AddToWalletIfInvolvingMe(const CTransactionRef& tx, const CBlockIndex* pIndex, int posInBlock, bool fUpdate);
     int64_t RescanFromTime(int64_t startTime, bool update);
     CBlockIndex* ScanForWalletTransactions(CBlockIndex* pindexStart, CBlockIndex* pindexStop, bool fUpdate = false);
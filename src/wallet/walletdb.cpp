@@ -18,6 +18,7 @@
 #include "wallet/wallet.h"
 
 #include <atomic>
+#include <thread>
 
 #include <boost/thread.hpp>
 
@@ -183,7 +184,7 @@ void CWalletDB::ListAccountCreditDebit(const std::string& strAccount, std::list<
 {
     bool fAllAccounts = (strAccount == "*");
 
-    Dbc* pcursor = batch.GetCursor();
+    std::unique_ptr<CDBCursor> pcursor(batch.GetCursor());
     if (!pcursor)
         throw std::runtime_error(std::string(__func__) + ": cannot create DB cursor");
     bool setRange = true;
@@ -194,15 +195,12 @@ void CWalletDB::ListAccountCreditDebit(const std::string& strAccount, std::list<
         if (setRange)
             ssKey << std::make_pair(std::string("acentry"), std::make_pair((fAllAccounts ? std::string("") : strAccount), uint64_t(0)));
         CDataStream ssValue(SER_DISK, CLIENT_VERSION);
-        int ret = batch.ReadAtCursor(pcursor, ssKey, ssValue, setRange);
+        int ret = batch.ReadAtCursor(pcursor.get(), ssKey, ssValue, setRange);
         setRange = false;
         if (ret == DB_NOTFOUND)
             break;
         else if (ret != 0)
-        {
-            pcursor->close();
             throw std::runtime_error(std::string(__func__) + ": error scanning DB");
-        }
 
         // Unserialize
         std::string strType;
@@ -218,8 +216,6 @@ void CWalletDB::ListAccountCreditDebit(const std::string& strAccount, std::list<
         ssKey >> acentry.nEntryNo;
         entries.push_back(acentry);
     }
-
-    pcursor->close();
 }
 
 class CWalletScanState {
@@ -241,6 +237,112 @@ public:
     }
 };
 
+/**
+ * Deserialize the "tx" record with ssKey read past its type. It touches
+ * nothing but its arguments, so LoadWallet runs it on several threads.
+ */
+static bool DecodeWalletTx(CDataStream& ssKey, CDataStream& ssValue, uint256& hash, CWalletTx& wtx, bool& fUpgrade, std::string& strErr)
+{
+    try {
+        ssKey >> hash;
+        ssValue >> wtx;
+
+        // Undo serialize changes in 31600
+        fUpgrade = 31404 <= wtx.fTimeReceivedIsTxTime && wtx.fTimeReceivedIsTxTime <= 31703;
+        if (fUpgrade)
+        {
+            if (!ssValue.empty())
+            {
+                char fTmp;
+                char fUnused;
+                ssValue >> fTmp >> fUnused >> wtx.strFromAccount;
+                strErr = strprintf("LoadWallet() upgrading tx ver=%d %d '%s' %s",
+                                   wtx.fTimeReceivedIsTxTime, fTmp, wtx.strFromAccount, hash.ToString());
+                wtx.fTimeReceivedIsTxTime = fTmp;
+            }
+            else
+            {
+                strErr = strprintf("LoadWallet() repairing tx ver=%d %s", wtx.fTimeReceivedIsTxTime, hash.ToString());
+                wtx.fTimeReceivedIsTxTime = 0;
+            }
+        }
+    } catch (...) {
+        return false;
+    }
+    return true;
+}
+
+/** Check a decoded "tx" record and add it to the wallet */
+static bool LoadWalletTx(CWallet* pwallet, const uint256& hash, const CWalletTx& wtx, bool fUpgrade,
+             CWalletScanState &wss, std::string& strErr)
+{
+    CValidationState state;
+    if (!(CheckTransaction(wtx, state) && (wtx.GetHash() == hash) && state.IsValid())) {
+        // If a client has a wallet.dat that contains asset transactions, but we are syncing the chain.
+        // we want to make sure that we don't fail to load this wallet transaction just because it is an asset transaction
+        // before asset are active
+        if (state.GetRejectReason() != "bad-txns-is-asset-and-asset-not-active" && state.GetRejectReason() != "bad-txns-transfer-asset-bad-deserialize") {
+            strErr = state.GetRejectReason();
+            return false;
+        }
+    }
+
+    if (fUpgrade)
+        wss.vWalletUpgrade.push_back(hash);
+
+    if (wtx.nOrderPos == -1)
+        wss.fAnyUnordered = true;
+
+    pwallet->LoadToWallet(wtx);
+    return true;
+}
+
+/** A "tx" record LoadWallet read, and what DecodeWalletTxs made of it */
+struct CWalletTxRecord
+{
+    CDataStream ssKey;
+    CDataStream ssValue;
+    uint256 hash;
+    CWalletTx wtx;
+    bool fDecoded;
+    bool fUpgrade;
+    std::string strErr;
+
+    CWalletTxRecord(CDataStream&& ssKeyIn, CDataStream&& ssValueIn) :
+        ssKey(std::move(ssKeyIn)), ssValue(std::move(ssValueIn)), fDecoded(false), fUpgrade(false) {}
+};
+
+/** Decode vRecords on up to WALLET_LOAD_MAX_THREADS threads */
+static void DecodeWalletTxs(std::vector<CWalletTxRecord>& vRecords)
+{
+    std::atomic<size_t> nNext{0};
+    auto decodeRecords = [&]() {
+        for (size_t i = nNext++; i < vRecords.size(); i = nNext++) {
+            CWalletTxRecord& record = vRecords[i];
+            std::string strType;
+            try {
+                record.ssKey >> strType;
+            } catch (...) {
+                continue;
+            }
+            record.fDecoded = DecodeWalletTx(record.ssKey, record.ssValue, record.hash, record.wtx, record.fUpgrade, record.strErr);
+            // The decoded transaction is all that is kept
+            record.ssValue = CDataStream(SER_DISK, CLIENT_VERSION);
+        }
+    };
+
+    // Small wallets aren't worth starting threads for
+    size_t nThreads = std::min<size_t>(std::min(std::max(1, GetNumCores()), WALLET_LOAD_MAX_THREADS), vRecords.size() / 1000 + 1);
+    std::vector<std::thread> threads;
+    for (size_t t = 1; t < nThreads; t++) {
+        threads.emplace_back(decodeRecords);
+    }
+    decodeRecords();
+    for (auto& thread : threads) {
+        thread.join();
+    }
+}
+
 bool ReadKeyValue(CWallet* pwallet, CDataStream& ssKey, CDataStream& ssValue,
              CWalletScanState &wss, std::string& strType, std::string& strErr)
 {
@@ -264,44 +366,12 @@ bool ReadKeyValue(CWallet* pwallet, CDataStream& ssKey, CDataStream& ssValue,
         else if (strType == "tx")
         {
             uint256 hash;
-            ssKey >> hash;
             CWalletTx wtx;
-            ssValue >> wtx;
-            CValidationState state;
-            if (!(CheckTransaction(wtx, state) && (wtx.GetHash() == hash) && state.IsValid())) {
-                // If a client has a wallet.dat that contains asset transactions, but we are syncing the chain.
-                // we want to make sure that we don't fail to load this wallet transaction just because it is an asset transaction
-                // before asset are active
-                if (state.GetRejectReason() != "bad-txns-is-asset-and-asset-not-active" && state.GetRejectReason() != "bad-txns-transfer-asset-bad-deserialize") {
-                    strErr = state.GetRejectReason();
-                    return false;
-                }
-            }
-
-            // Undo serialize changes in 31600
-            if (31404 <= wtx.fTimeReceivedIsTxTime && wtx.fTimeReceivedIsTxTime <= 31703)
-            {
-                if (!ssValue.empty())
-                {
-                    char fTmp;
-                    char fUnused;
-                    ssValue >> fTmp >> fUnused >> wtx.strFromAccount;
-                    strErr = strprintf("LoadWallet() upgrading tx ver=%d %d '%s' %s",
-                                       wtx.fTimeReceivedIsTxTime, fTmp, wtx.strFromAccount, hash.ToString());
-                    wtx.fTimeReceivedIsTxTime = fTmp;
-                }
-                else
-                {
-                    strErr = strprintf("LoadWallet() repairing tx ver=%d %s", wtx.fTimeReceivedIsTxTime, hash.ToString());
-                    wtx.fTimeReceivedIsTxTime = 0;
-                }
-                wss.vWalletUpgrade.push_back(hash);
-            }
-
-            if (wtx.nOrderPos == -1)
-                wss.fAnyUnordered = true;
-
-            pwallet->LoadToWallet(wtx);
+            bool fUpgrade;
+            if (!DecodeWalletTx(ssKey, ssValue, hash, wtx, fUpgrade, strErr))
+                return false;
+            if (!LoadWalletTx(pwallet, hash, wtx, fUpgrade, wss, strErr))
+                return false;
         }
         else if (strType == "acentry")
         {
@@ -612,19 +682,23 @@ DBErrors CWalletDB::LoadWallet(CWallet* pwallet)
         }
 
         // Get cursor
-        Dbc* pcursor = batch.GetCursor();
+        std::unique_ptr<CDBCursor> pcursor(batch.GetCursor());
         if (!pcursor)
         {
             LogPrintf("Error getting wallet database cursor\n");
             return DB_CORRUPT;
         }
 
+        // Transactions are most of a big wallet, and decoding them most of
+        // its load time: they are set aside here, decoded on several threads,
+        // then checked and added to the wallet in the order they were read.
+        std::vector<CWalletTxRecord> vTxRecords;
         while (true)
         {
             // Read next record
             CDataStream ssKey(SER_DISK, CLIENT_VERSION);
             CDataStream ssValue(SER_DISK, CLIENT_VERSION);
-            int ret = batch.ReadAtCursor(pcursor, ssKey, ssValue);
+            int ret = batch.ReadAtCursor(pcursor.get(), ssKey, ssValue);
             if (ret == DB_NOTFOUND)
                 break;
             else if (ret != 0)
@@ -633,6 +707,11 @@ DBErrors CWalletDB::LoadWallet(CWallet* pwallet)
                 return DB_CORRUPT;
             }
 
+            if (ssKey.size() > 3 && memcmp(ssKey.data(), "\x02tx", 3) == 0) {
+                vTxRecords.emplace_back(std::move(ssKey), std::move(ssValue));
+                continue;
+            }
+
             // Try to be tolerant of single corrupt records:
             std::string strType, strErr;
             if (!ReadKeyValue(pwallet, ssKey, ssValue, wss, strType, strErr))
@@ -655,7 +734,22 @@ DBErrors CWalletDB::LoadWallet(CWallet* pwallet)
             if (!strErr.empty())
                 LogPrintf("%s\n", strErr);
         }
-        pcursor->close();
+        pcursor.reset();
+
+        int64_t nStart = GetTimeMillis();
+        DecodeWalletTxs(vTxRecords);
+        for (CWalletTxRecord& record : vTxRecords) {
+            std::string strErr = record.strErr;
+            if (!record.fDecoded || !LoadWalletTx(pwallet, record.hash, record.wtx, record.fUpgrade, wss, strErr)) {
+                LogPrintf("DB failed to Read Key Value. Type: %s, Error: %s\n", "tx", strErr);
+                fNoncriticalErrors = true;
+                // Rescan if there is a bad transaction record:
+                gArgs.SoftSetBoolArg("-rescan", true);
+            } else if (!strErr.empty()) {
+                LogPrintf("%s\n", strErr);
+            }
+        }
+        LogPrint(BCLog::DB, "%s: loaded %u transactions in %dms\n", __func__, vTxRecords.size(), GetTimeMillis() - nStart);
     }
     catch (const boost::thread_interrupted&) {
         throw;
@@ -717,7 +811,7 @@ DBErrors CWalletDB::FindWalletTx(std::vector<uint256>& vTxHash, std::vector<CWal
         }
 
         // Get cursor
-        Dbc* pcursor = batch.GetCursor();
+        std::unique_ptr<CDBCursor> pcursor(batch.GetCursor());
         if (!pcursor)
         {
             LogPrintf("Error getting wallet database cursor\n");
@@ -729,7 +823,7 @@ DBErrors CWalletDB::FindWalletTx(std::vector<uint256>& vTxHash, std::vector<CWal
             // Read next record
             CDataStream ssKey(SER_DISK, CLIENT_VERSION);
             CDataStream ssValue(SER_DISK, CLIENT_VERSION);
-            int ret = batch.ReadAtCursor(pcursor, ssKey, ssValue);
+            int ret = batch.ReadAtCursor(pcursor.get(), ssKey, ssValue);
             if (ret == DB_NOTFOUND)
                 break;
             else if (ret != 0)
@@ -751,7 +845,6 @@ DBErrors CWalletDB::FindWalletTx(std::vector<uint256>& vTxHash, std::vector<CWal
                 vWtx.push_back(wtx);
             }
         }
-        pcursor->close();
     }
     catch (const boost::thread_interrupted&) {
         throw;
@@ -35,6 +35,8 @@
  */
 
 static const bool DEFAULT_FLUSHWALLET = true;
+//! Most threads LoadWallet decodes transaction records on
+static const int WALLET_LOAD_MAX_THREADS = 8;
 
 class CAccount;
 class CAccountingEntry;
@@ -17,7 +17,7 @@ bool CZMQAbstractNotifier::NotifyBlock(const CBlockIndex * /*CBlockIndex*/)
     return true;
 }
 
-bool CZMQAbstractNotifier::NotifyTransaction(const CTransaction &/*transaction*/)
+bool CZMQAbstractNotifier::NotifyTransaction(const CTransactionRef &/*ptx*/)
 {
     return true;
 }
@@ -26,3 +26,18 @@ bool CZMQAbstractNotifier::NotifyMessage(const CMessage &/*message*/)
 {
     return true;
 }
+
+bool CZMQAbstractNotifier::NotifyOrderBookUpdate(const COrderBookUpdate &/*update*/)
+{
+    return true;
+}
+
+bool CZMQAbstractNotifier::NotifyAsset(const CAssetNotification &/*notification*/)
+{
+    return true;
+}
+
+bool CZMQAbstractNotifier::NotifyMempoolEvent(const CMempoolEvent &/*event*/)
+{
+    return true;
+}
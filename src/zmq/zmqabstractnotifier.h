@@ -11,6 +11,9 @@
 class CBlockIndex;
 class CZMQAbstractNotifier;
 class CMessage;
+class COrderBookUpdate;
+class CAssetNotification;
+class CMempoolEvent;
 
 typedef CZMQAbstractNotifier* (*CZMQNotifierFactory)();
 
@@ -35,8 +38,11 @@ public:
     virtual void Shutdown() = 0;
 
     virtual bool NotifyBlock(const CBlockIndex *pindex);
-    virtual bool NotifyTransaction(const CTransaction &transaction);
+    virtual bool NotifyTransaction(const CTransactionRef &ptx);
     virtual bool NotifyMessage(const CMessage& message);
+    virtual bool NotifyOrderBookUpdate(const COrderBookUpdate& update);
+    virtual bool NotifyAsset(const CAssetNotification& notification);
+    virtual bool NotifyMempoolEvent(const CMempoolEvent& event);
 
 protected:
     void *psocket;
@@ -11,6 +11,8 @@
 #include "streams.h"
 #include "util.h"
 
+CZMQNotificationInterface* pzmqNotificationInterface = nullptr;
+
 void zmqError(const char *str)
 {
     LogPrint(BCLog::ZMQ, "zmq: Error: %s, errno=%s\n", str, zmq_strerror(errno));
@@ -30,6 +32,15 @@ CZMQNotificationInterface::~CZMQNotificationInterface()
     }
 }
 
+std::list<const CZMQAbstractNotifier*> CZMQNotificationInterface::GetActiveNotifiers() const
+{
+    std::list<const CZMQAbstractNotifier*> result;
+    for (const auto* n : notifiers) {
+        result.push_back(n);
+    }
+    return result;
+}
+
 CZMQNotificationInterface* CZMQNotificationInterface::Create()
 {
     CZMQNotificationInterface* notificationInterface = nullptr;
@@ -41,6 +52,12 @@ CZMQNotificationInterface* CZMQNotificationInterface::Create()
     factories["pubrawblock"] = CZMQAbstractNotifier::Create<CZMQPublishRawBlockNotifier>;
     factories["pubrawtx"] = CZMQAbstractNotifier::Create<CZMQPublishRawTransactionNotifier>;
     factories["pubrawmessage"] = CZMQAbstractNotifier::Create<CZMQPublishNewAssetMessageNotifier>;
+    factories["pubdexoffer"] = CZMQAbstractNotifier::Create<CZMQPublishDexOfferNotifier>;
+    factories["pubdexfill"] = CZMQAbstractNotifier::Create<CZMQPublishDexFillNotifier>;
+    factories["pubassettransfer"] = CZMQAbstractNotifier::Create<CZMQPublishAssetTransferNotifier>;
+    factories["pubassetissue"] = CZMQAbstractNotifier::Create<CZMQPublishAssetIssueNotifier>;
+    factories["pubassetbalance"] = CZMQAbstractNotifier::Create<CZMQPublishAssetBalanceNotifier>;
+    factories["pubmempoolevent"] = CZMQAbstractNotifier::Create<CZMQPublishMempoolEventNotifier>;
 
     for (std::map<std::string, CZMQNotifierFactory>::const_iterator i=factories.begin(); i!=factories.end(); ++i)
     {
@@ -85,6 +102,11 @@ bool CZMQNotificationInterface::Initialize()
         return false;
     }
 
+    if (!StartZMQPublisher())
+    {
+        return false;
+    }
+
     std::list<CZMQAbstractNotifier*>::iterator i=notifiers.begin();
     for (; i!=notifiers.end(); ++i)
     {
@@ -114,6 +136,7 @@ void CZMQNotificationInterface::Shutdown()
     LogPrint(BCLog::ZMQ, "zmq: Shutdown notification interface\n");
     if (pcontext)
     {
+        StopZMQPublisher();
         for (std::list<CZMQAbstractNotifier*>::iterator i=notifiers.begin(); i!=notifiers.end(); ++i)
         {
             CZMQAbstractNotifier *notifier = *i;
@@ -163,16 +186,74 @@ void CZMQNotificationInterface::NewAssetMessage(const CMessage& message)
     }
 }
 
+void CZMQNotificationInterface::OrderBookUpdated(const COrderBookUpdate& update)
+{
+    for (std::list<CZMQAbstractNotifier*>::iterator i = notifiers.begin(); i!=notifiers.end(); )
+    {
+        CZMQAbstractNotifier *notifier = *i;
+        if (notifier->NotifyOrderBookUpdate(update))
+        {
+            i++;
+        }
+        else
+        {
+            notifier->Shutdown();
+            i = notifiers.erase(i);
+        }
+    }
+}
+
+void CZMQNotificationInterface::AssetsUpdated(const std::vector<CAssetNotification>& vNotifications)
+{
+    for (std::list<CZMQAbstractNotifier*>::iterator i = notifiers.begin(); i!=notifiers.end(); )
+    {
+        CZMQAbstractNotifier *notifier = *i;
+        bool fOk = true;
+        for (const CAssetNotification& notification : vNotifications)
+        {
+            if (!notifier->NotifyAsset(notification))
+            {
+                fOk = false;
+                break;
+            }
+        }
+        if (fOk)
+        {
+            i++;
+        }
+        else
+        {
+            notifier->Shutdown();
+            i = notifiers.erase(i);
+        }
+    }
+}
+
+void CZMQNotificationInterface::MempoolUpdated(const CMempoolEvent& event)
+{
+    for (std::list<CZMQAbstractNotifier*>::iterator i = notifiers.begin(); i!=notifiers.end(); )
+    {
+        CZMQAbstractNotifier *notifier = *i;
+        if (notifier->NotifyMempoolEvent(event))
+        {
+            i++;
+        }
+        else
+        {
+            notifier->Shutdown();
+            i = notifiers.erase(i);
+        }
+    }
+}
+
 void CZMQNotificationInterface::TransactionAddedToMempool(const CTransactionRef& ptx)
 {
     // Used by BlockConnected and BlockDisconnected as well, because they're
     // all the same external callback.
-    const CTransaction& tx = *ptx;
-
     for (std::list<CZMQAbstractNotifier*>::iterator i = notifiers.begin(); i!=notifiers.end(); )
     {
         CZMQAbstractNotifier *notifier = *i;
-        if (notifier->NotifyTransaction(tx))
+        if (notifier->NotifyTransaction(ptx))
         {
             i++;
         }
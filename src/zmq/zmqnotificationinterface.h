@@ -19,6 +19,8 @@ class CZMQNotificationInterface final : public CValidationInterface
 public:
     virtual ~CZMQNotificationInterface();
 
+    std::list<const CZMQAbstractNotifier*> GetActiveNotifiers() const;
+
     static CZMQNotificationInterface* Create();
 
 protected:
@@ -31,6 +33,9 @@ protected:
     void BlockDisconnected(const std::shared_ptr<const CBlock>& pblock) override;
     void UpdatedBlockTip(const CBlockIndex *pindexNew, const CBlockIndex *pindexFork, bool fInitialDownload) override;
     void NewAssetMessage(const CMessage& message) override;
+    void OrderBookUpdated(const COrderBookUpdate& update) override;
+    void AssetsUpdated(const std::vector<CAssetNotification>& vNotifications) override;
+    void MempoolUpdated(const CMempoolEvent& event) override;
 
 private:
     CZMQNotificationInterface();
@@ -39,4 +44,6 @@ private:
     std::list<CZMQAbstractNotifier*> notifiers;
 };
 
+extern CZMQNotificationInterface* pzmqNotificationInterface;
+
 #endif // MYNTA_ZMQ_ZMQNOTIFICATIONINTERFACE_H
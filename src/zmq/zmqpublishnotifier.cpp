@@ -3,14 +3,22 @@
 // Distributed under the MIT software license, see the accompanying
 // file COPYING or http://www.opensource.org/licenses/mit-license.php.
 
+#include "assets/assettypes.h"
+#include "assets/atomicswap.h"
 #include "chain.h"
 #include "chainparams.h"
 #include "streams.h"
+#include "txmempool.h"
 #include "zmqpublishnotifier.h"
 #include "validation.h"
 #include "util.h"
 #include "rpc/server.h"
 
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <thread>
+
 static std::multimap<std::string, CZMQAbstractPublishNotifier*> mapPublishNotifiers;
 
 static const char *MSG_HASHBLOCK   = "hashblock";
@@ -18,48 +26,184 @@ static const char *MSG_HASHTX      = "hashtx";
 static const char *MSG_RAWBLOCK    = "rawblock";
 static const char *MSG_RAWTX       = "rawtx";
 static const char *MSG_RAWASSETMSG = "rawmessage";
+static const char *MSG_DEXOFFER    = "dexoffer";
+static const char *MSG_DEXFILL     = "dexfill";
+static const char *MSG_ASSETTRANSFER = "assettransfer";
+static const char *MSG_ASSETISSUE    = "assetissue";
+static const char *MSG_ASSETBALANCE  = "assetbalance";
+static const char *MSG_MEMPOOLEVENT  = "mempoolevent";
+
+// Send one part copying the data
+static bool zmq_send_part(void *sock, const void* data, size_t size, bool fMore)
+{
+    zmq_msg_t msg;
+
+    int rc = zmq_msg_init_size(&msg, size);
+    if (rc != 0)
+    {
+        zmqError("Unable to initialize ZMQ msg");
+        return false;
+    }
+
+    memcpy(zmq_msg_data(&msg), data, size);
 
-// Internal function to send multipart message
-static int zmq_send_multipart(void *sock, const void* data, size_t size, ...)
+    rc = zmq_msg_send(&msg, sock, fMore ? ZMQ_SNDMORE : 0);
+    if (rc == -1)
+    {
+        zmqError("Unable to send ZMQ msg");
+        zmq_msg_close(&msg);
+        return false;
+    }
+    return true;
+}
+
+static void zmq_free_buffer(void * /*data*/, void *hint)
+{
+    delete static_cast<ZMQPublishBuffer*>(hint);
+}
+
+// Send one part without copying: ZMQ holds a reference to the buffer until it is sent
+static bool zmq_send_buffer(void *sock, const ZMQPublishBuffer& buffer, bool fMore)
 {
-    va_list args;
-    va_start(args, size);
+    if (buffer->empty())
+        return zmq_send_part(sock, nullptr, 0, fMore);
+
+    zmq_msg_t msg;
+    ZMQPublishBuffer* hint = new ZMQPublishBuffer(buffer);
 
-    while (1)
+    int rc = zmq_msg_init_data(&msg, const_cast<unsigned char*>(buffer->data()), buffer->size(), zmq_free_buffer, hint);
+    if (rc != 0)
     {
-        zmq_msg_t msg;
+        zmqError("Unable to initialize ZMQ msg");
+        delete hint;
+        return false;
+    }
 
-        int rc = zmq_msg_init_size(&msg, size);
-        if (rc != 0)
+    rc = zmq_msg_send(&msg, sock, fMore ? ZMQ_SNDMORE : 0);
+    if (rc == -1)
+    {
+        zmqError("Unable to send ZMQ msg");
+        zmq_msg_close(&msg);
+        return false;
+    }
+    return true;
+}
+
+class CZMQPublisher
+{
+private:
+    struct Item {
+        CZMQAbstractPublishNotifier* notifier;
+        const char* command;
+        uint32_t nSequence;
+        ZMQPublishPayload payload;
+    };
+
+    std::mutex cs;
+    std::condition_variable cond;
+    std::deque<Item> queue;
+    size_t nMaxQueue;
+    bool fRunning;
+    //! Notifier of the message being sent, see Forget
+    CZMQAbstractPublishNotifier* pSending;
+    std::thread thread;
+
+    void Run();
+
+public:
+    explicit CZMQPublisher(size_t nMaxQueueIn) : nMaxQueue(nMaxQueueIn), fRunning(true), pSending(nullptr)
+    {
+        thread = std::thread(&CZMQPublisher::Run, this);
+    }
+
+    ~CZMQPublisher()
+    {
         {
-            zmqError("Unable to initialize ZMQ msg");
-            va_end(args);
-            return -1;
+            std::lock_guard<std::mutex> lock(cs);
+            fRunning = false;
+            cond.notify_all();
         }
+        thread.join();
+    }
 
-        void *buf = zmq_msg_data(&msg);
-        memcpy(buf, data, size);
-
-        data = va_arg(args, const void*);
+    void Push(CZMQAbstractPublishNotifier* notifier, const char* command, ZMQPublishPayload payload)
+    {
+        std::lock_guard<std::mutex> lock(cs);
+        uint32_t nSequence = notifier->nSequence++;
+        if (queue.size() >= nMaxQueue) {
+            notifier->nDropped++;
+            return;
+        }
+        queue.push_back(Item{notifier, command, nSequence, std::move(payload)});
+        cond.notify_one();
+    }
 
-        rc = zmq_msg_send(&msg, sock, data ? ZMQ_SNDMORE : 0);
-        if (rc == -1)
-        {
-            zmqError("Unable to send ZMQ msg");
-            zmq_msg_close(&msg);
-            va_end(args);
-            return -1;
+    //! Discard the messages of a notifier that is shutting down, and wait until none is being sent
+    void Forget(CZMQAbstractPublishNotifier* notifier)
+    {
+        std::unique_lock<std::mutex> lock(cs);
+        for (auto it = queue.begin(); it != queue.end(); ) {
+            if (it->notifier == notifier)
+                it = queue.erase(it);
+            else
+                it++;
         }
+        cond.wait(lock, [&] { return pSending != notifier; });
+    }
+};
 
-        zmq_msg_close(&msg);
+void CZMQPublisher::Run()
+{
+    RenameThread("mynta-zmqpub");
 
-        if (!data)
+    std::unique_lock<std::mutex> lock(cs);
+    while (true) {
+        cond.wait(lock, [this] { return !fRunning || !queue.empty(); });
+        if (!fRunning)
             break;
+        Item item = std::move(queue.front());
+        queue.pop_front();
+        pSending = item.notifier;
+        lock.unlock();
+
+        /* send three parts, command & data & a LE 4byte sequence number */
+        ZMQPublishBuffer data = item.payload();
+        if (data) {
+            void *sock = item.notifier->psocket;
+            unsigned char msgseq[sizeof(uint32_t)];
+            WriteLE32(&msgseq[0], item.nSequence);
+            if (!zmq_send_part(sock, item.command, strlen(item.command), true) ||
+                !zmq_send_buffer(sock, data, true) ||
+                !zmq_send_part(sock, msgseq, sizeof(msgseq), false)) {
+                LogPrint(BCLog::ZMQ, "zmq: Failed to publish %s\n", item.command);
+            }
+        }
+        item.payload = nullptr;
+        data.reset();
 
-        size = va_arg(args, size_t);
+        lock.lock();
+        pSending = nullptr;
+        cond.notify_all();
     }
-    va_end(args);
-    return 0;
+}
+
+static std::unique_ptr<CZMQPublisher> publisher;
+
+bool StartZMQPublisher()
+{
+    assert(!publisher);
+    int64_t nMaxQueue = gArgs.GetArg("-zmqpubqueue", DEFAULT_ZMQ_PUB_QUEUE);
+    if (nMaxQueue < 1) {
+        LogPrintf("zmq: Invalid -zmqpubqueue %d\n", nMaxQueue);
+        return false;
+    }
+    publisher.reset(new CZMQPublisher(nMaxQueue));
+    return true;
+}
+
+void StopZMQPublisher()
+{
+    publisher.reset();
 }
 
 bool CZMQAbstractPublishNotifier::Initialize(void *pcontext)
@@ -105,6 +249,10 @@ void CZMQAbstractPublishNotifier::Shutdown()
 {
     assert(psocket);
 
+    // Nothing may be sent on the socket once it is closed
+    if (publisher)
+        publisher->Forget(this);
+
     int count = mapPublishNotifiers.count(address);
 
     // remove this notifier from the list of publishers using this address
@@ -133,18 +281,19 @@ void CZMQAbstractPublishNotifier::Shutdown()
 
 bool CZMQAbstractPublishNotifier::SendMessage(const char *command, const void* data, size_t size)
 {
-    assert(psocket);
-
-    /* send three parts, command & data & a LE 4byte sequence number */
-    unsigned char msgseq[sizeof(uint32_t)];
-    WriteLE32(&msgseq[0], nSequence);
-    int rc = zmq_send_multipart(psocket, command, strlen(command), data, size, msgseq, (size_t)sizeof(uint32_t), nullptr);
-    if (rc == -1)
-        return false;
+    ZMQPublishBuffer buffer = std::make_shared<std::vector<unsigned char>>((const unsigned char*)data, (const unsigned char*)data + size);
+    return SendMessage(command, [buffer] { return buffer; });
+}
 
-    /* increment memory only sequence number after sending */
-    nSequence++;
+bool CZMQAbstractPublishNotifier::SendMessage(const char *command, ZMQPublishPayload payload)
+{
+    assert(psocket);
 
+    if (!publisher) {
+        nDropped++;
+        return true;
+    }
+    publisher->Push(this, command, std::move(payload));
     return true;
 }
 
@@ -158,9 +307,9 @@ bool CZMQPublishHashBlockNotifier::NotifyBlock(const CBlockIndex *pindex)
     return SendMessage(MSG_HASHBLOCK, data, 32);
 }
 
-bool CZMQPublishHashTransactionNotifier::NotifyTransaction(const CTransaction &transaction)
+bool CZMQPublishHashTransactionNotifier::NotifyTransaction(const CTransactionRef &ptx)
 {
-    uint256 hash = transaction.GetHash();
+    uint256 hash = ptx->GetHash();
     LogPrint(BCLog::ZMQ, "zmq: Publish hashtx %s\n", hash.GetHex());
     char data[32];
     for (unsigned int i = 0; i < 32; i++)
@@ -172,30 +321,35 @@ bool CZMQPublishRawBlockNotifier::NotifyBlock(const CBlockIndex *pindex)
 {
     LogPrint(BCLog::ZMQ, "zmq: Publish rawblock %s\n", pindex->GetBlockHash().GetHex());
 
-    const Consensus::Params& consensusParams = GetParams().GetConsensus();
-    CDataStream ss(SER_NETWORK, PROTOCOL_VERSION | RPCSerializationFlags());
-    {
-        LOCK(cs_main);
+    // Read and serialized by the publisher thread
+    int nVersion = PROTOCOL_VERSION | RPCSerializationFlags();
+    return SendMessage(MSG_RAWBLOCK, [pindex, nVersion]() -> ZMQPublishBuffer {
+        const Consensus::Params& consensusParams = GetParams().GetConsensus();
         CBlock block;
-        if(!ReadBlockFromDisk(block, pindex, consensusParams))
         {
-            zmqError("Can't read block from disk");
-            return false;
+            LOCK(cs_main);
+            if(!ReadBlockFromDisk(block, pindex, consensusParams))
+            {
+                zmqError("Can't read block from disk");
+                return nullptr;
+            }
         }
 
-        ss << block;
-    }
-
-    return SendMessage(MSG_RAWBLOCK, &(*ss.begin()), ss.size());
+        std::shared_ptr<std::vector<unsigned char>> data = std::make_shared<std::vector<unsigned char>>();
+        CVectorWriter(SER_NETWORK, nVersion, *data, 0, block);
+        return data;
+    });
 }
 
-bool CZMQPublishRawTransactionNotifier::NotifyTransaction(const CTransaction &transaction)
+bool CZMQPublishRawTransactionNotifier::NotifyTransaction(const CTransactionRef &ptx)
 {
-    uint256 hash = transaction.GetHash();
-    LogPrint(BCLog::ZMQ, "zmq: Publish rawtx %s\n", hash.GetHex());
-    CDataStream ss(SER_NETWORK, PROTOCOL_VERSION | RPCSerializationFlags());
-    ss << transaction;
-    return SendMessage(MSG_RAWTX, &(*ss.begin()), ss.size());
+    LogPrint(BCLog::ZMQ, "zmq: Publish rawtx %s\n", ptx->GetHash().GetHex());
+    int nVersion = PROTOCOL_VERSION | RPCSerializationFlags();
+    return SendMessage(MSG_RAWTX, [ptx, nVersion]() -> ZMQPublishBuffer {
+        std::shared_ptr<std::vector<unsigned char>> data = std::make_shared<std::vector<unsigned char>>();
+        CVectorWriter(SER_NETWORK, nVersion, *data, 0, *ptx);
+        return data;
+    });
 }
 
 bool CZMQPublishNewAssetMessageNotifier::NotifyMessage(const CMessage &message)
@@ -206,3 +360,65 @@ bool CZMQPublishNewAssetMessageNotifier::NotifyMessage(const CMessage &message)
     std::string str = zmqmessage.createJsonString();
     return SendMessage(MSG_RAWASSETMSG, &(*str.begin()), str.size());
 }
+
+bool CZMQPublishDexOfferNotifier::NotifyOrderBookUpdate(const COrderBookUpdate &update)
+{
+    if (update.nType == COrderBookUpdate::OFFER_FILLED)
+        return true;
+
+    LogPrint(BCLog::ZMQ, "zmq: Publish dexoffer %s\n", update.offerHash.GetHex());
+    CDataStream ss(SER_NETWORK, PROTOCOL_VERSION);
+    ss << update;
+    return SendMessage(MSG_DEXOFFER, &(*ss.begin()), ss.size());
+}
+
+bool CZMQPublishDexFillNotifier::NotifyOrderBookUpdate(const COrderBookUpdate &update)
+{
+    if (update.nType != COrderBookUpdate::OFFER_FILLED)
+        return true;
+
+    LogPrint(BCLog::ZMQ, "zmq: Publish dexfill %s\n", update.offerHash.GetHex());
+    CDataStream ss(SER_NETWORK, PROTOCOL_VERSION);
+    ss << update;
+    return SendMessage(MSG_DEXFILL, &(*ss.begin()), ss.size());
+}
+
+/** Serialized notification as a message of the given topic */
+static bool SendAssetNotification(CZMQAbstractPublishNotifier* notifier, const char* command, const CAssetNotification& notification)
+{
+    LogPrint(BCLog::ZMQ, "zmq: Publish %s %s %s\n", command, notification.assetName, notification.address);
+    std::shared_ptr<std::vector<unsigned char>> data = std::make_shared<std::vector<unsigned char>>();
+    CVectorWriter(SER_NETWORK, PROTOCOL_VERSION, *data, 0, notification);
+    ZMQPublishBuffer buffer = data;
+    return notifier->SendMessage(command, [buffer] { return buffer; });
+}
+
+bool CZMQPublishAssetTransferNotifier::NotifyAsset(const CAssetNotification &notification)
+{
+    if (notification.nType != CAssetNotification::TRANSFER)
+        return true;
+    return SendAssetNotification(this, MSG_ASSETTRANSFER, notification);
+}
+
+bool CZMQPublishAssetIssueNotifier::NotifyAsset(const CAssetNotification &notification)
+{
+    if (notification.nType != CAssetNotification::ISSUE && notification.nType != CAssetNotification::REISSUE)
+        return true;
+    return SendAssetNotification(this, MSG_ASSETISSUE, notification);
+}
+
+bool CZMQPublishAssetBalanceNotifier::NotifyAsset(const CAssetNotification &notification)
+{
+    if (notification.nType != CAssetNotification::BALANCE)
+        return true;
+    return SendAssetNotification(this, MSG_ASSETBALANCE, notification);
+}
+
+bool CZMQPublishMempoolEventNotifier::NotifyMempoolEvent(const CMempoolEvent &event)
+{
+    LogPrint(BCLog::ZMQ, "zmq: Publish mempoolevent %d %s\n", event.nSequence, event.txid.GetHex());
+    std::shared_ptr<std::vector<unsigned char>> data = std::make_shared<std::vector<unsigned char>>();
+    CVectorWriter(SER_NETWORK, PROTOCOL_VERSION, *data, 0, event);
+    ZMQPublishBuffer buffer = data;
+    return SendMessage(MSG_MEMPOOLEVENT, [buffer] { return buffer; });
+}
@@ -8,13 +8,39 @@
 
 #include "zmqabstractnotifier.h"
 
+#include <atomic>
+#include <functional>
+#include <memory>
+#include <vector>
+
 class CBlockIndex;
 class CMessage;
 
+/** Default number of messages waiting for the publisher thread before new ones are dropped */
+static const int DEFAULT_ZMQ_PUB_QUEUE = 1000;
+
+/** Serialized message data, shared with ZMQ until it has been sent */
+typedef std::shared_ptr<const std::vector<unsigned char>> ZMQPublishBuffer;
+/** Builds the data of a message on the publisher thread; an empty buffer cancels it */
+typedef std::function<ZMQPublishBuffer()> ZMQPublishPayload;
+
+/**
+ * Messages of every publish notifier are sent from one thread, in the order
+ * they were queued, so serializing a block or transaction and handing it to a
+ * socket never holds up the validation callbacks. At most -zmqpubqueue
+ * messages wait; beyond that new ones are dropped and counted, and the gap
+ * shows in the sequence numbers subscribers see.
+ */
+bool StartZMQPublisher();
+void StopZMQPublisher();
+
 class CZMQAbstractPublishNotifier : public CZMQAbstractNotifier
 {
 private:
-    uint32_t nSequence; //!< upcounting per message sequence number
+    std::atomic<uint32_t> nSequence{0}; //!< upcounting per message sequence number
+    std::atomic<uint64_t> nDropped{0};
+
+    friend class CZMQPublisher;
 
 public:
 
@@ -25,6 +51,13 @@ public:
           * message sequence number
     */
     bool SendMessage(const char *command, const void* data, size_t size);
+    //! Queue a message whose data is built when it is sent
+    bool SendMessage(const char *command, ZMQPublishPayload payload);
+
+    //! Sequence number of the next message
+    uint32_t GetSequence() const { return nSequence; }
+    //! Messages dropped because the publisher queue was full
+    uint64_t GetDropped() const { return nDropped; }
 
     bool Initialize(void *pcontext) override;
     void Shutdown() override;
@@ -39,7 +72,7 @@ public:
 class CZMQPublishHashTransactionNotifier : public CZMQAbstractPublishNotifier
 {
 public:
-    bool NotifyTransaction(const CTransaction &transaction) override;
+    bool NotifyTransaction(const CTransactionRef &ptx) override;
 };
 
 class CZMQPublishRawBlockNotifier : public CZMQAbstractPublishNotifier
@@ -51,7 +84,7 @@ public:
 class CZMQPublishRawTransactionNotifier : public CZMQAbstractPublishNotifier
 {
 public:
-    bool NotifyTransaction(const CTransaction &transaction) override;
+    bool NotifyTransaction(const CTransactionRef &ptx) override;
 };
 
 class CZMQPublishNewAssetMessageNotifier : public CZMQAbstractPublishNotifier
@@ -60,4 +93,46 @@ public:
     bool NotifyMessage(const CMessage& message) override;
 };
 
+/** Publishes offers added to and removed from the order books as serialized COrderBookUpdates */
+class CZMQPublishDexOfferNotifier : public CZMQAbstractPublishNotifier
+{
+public:
+    bool NotifyOrderBookUpdate(const COrderBookUpdate& update) override;
+};
+
+/** Publishes offers filled on chain as serialized COrderBookUpdates */
+class CZMQPublishDexFillNotifier : public CZMQAbstractPublishNotifier
+{
+public:
+    bool NotifyOrderBookUpdate(const COrderBookUpdate& update) override;
+};
+
+/** Publishes asset outputs of connected and disconnected blocks as serialized CAssetNotifications */
+class CZMQPublishAssetTransferNotifier : public CZMQAbstractPublishNotifier
+{
+public:
+    bool NotifyAsset(const CAssetNotification& notification) override;
+};
+
+/** Publishes asset issues and reissues as serialized CAssetNotifications */
+class CZMQPublishAssetIssueNotifier : public CZMQAbstractPublishNotifier
+{
+public:
+    bool NotifyAsset(const CAssetNotification& notification) override;
+};
+
+/** Publishes the asset balances blocks changed as serialized CAssetNotifications (needs -assetindex) */
+class CZMQPublishAssetBalanceNotifier : public CZMQAbstractPublishNotifier
+{
+public:
+    bool NotifyAsset(const CAssetNotification& notification) override;
+};
+
+/** Publishes transactions entering and leaving the mempool, in sequence, as serialized CMempoolEvents */
+class CZMQPublishMempoolEventNotifier : public CZMQAbstractPublishNotifier
+{
+public:
+    bool NotifyMempoolEvent(const CMempoolEvent& event) override;
+};
+
 #endif // MYNTA_ZMQ_ZMQPUBLISHNOTIFIER_H
@@ -0,0 +1,68 @@
+// Copyright (c) 2026 The Mynta Core Developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include "zmq/zmqrpc.h"
+
+#include "rpc/server.h"
+#include "util.h"
+#include "utilstrencodings.h"
+#include "zmq/zmqabstractnotifier.h"
+#include "zmq/zmqnotificationinterface.h"
+#include "zmq/zmqpublishnotifier.h"
+
+#include <univalue.h>
+
+UniValue getzmqnotifications(const JSONRPCRequest& request)
+{
+    if (request.fHelp || request.params.size() != 0) {
+        throw std::runtime_error(
+            "getzmqnotifications\n"
+            "\nReturns information about the active ZeroMQ notifications.\n"
+            "\nResult:\n"
+            "[\n"
+            "  {\n"
+            "    \"type\": \"pubhashtx\",          (string) Type of notification\n"
+            "    \"address\": \"...\",             (string) Address of the publisher\n"
+            "    \"queue\": n,                   (numeric) Messages that may wait to be published before new ones are dropped\n"
+            "    \"sequence\": n,                (numeric) Sequence number of the next message\n"
+            "    \"dropped\": n                  (numeric) Messages dropped because the queue was full\n"
+            "  },\n"
+            "  ...\n"
+            "]\n"
+            "\nExamples:\n"
+            + HelpExampleCli("getzmqnotifications", "")
+            + HelpExampleRpc("getzmqnotifications", "")
+        );
+    }
+
+    UniValue result(UniValue::VARR);
+    if (pzmqNotificationInterface != nullptr) {
+        for (const auto* n : pzmqNotificationInterface->GetActiveNotifiers()) {
+            UniValue obj(UniValue::VOBJ);
+            obj.push_back(Pair("type", n->GetType()));
+            obj.push_back(Pair("address", n->GetAddress()));
+            obj.push_back(Pair("queue", gArgs.GetArg("-zmqpubqueue", DEFAULT_ZMQ_PUB_QUEUE)));
+            const CZMQAbstractPublishNotifier* publisher = dynamic_cast<const CZMQAbstractPublishNotifier*>(n);
+            if (publisher) {
+                obj.push_back(Pair("sequence", (uint64_t)publisher->GetSequence()));
+                obj.push_back(Pair("dropped", publisher->GetDropped()));
+            }
+            result.push_back(obj);
+        }
+    }
+
+    return result;
+}
+
+static const CRPCCommand commands[] =
+{ //  category              name                      actor (function)         argNames
+  //  --------------------- ------------------------  -----------------------  ----------
+    { "zmq",                "getzmqnotifications",    &getzmqnotifications,    {} },
+};
+
+void RegisterZMQRPCCommands(CRPCTable& t)
+{
+    for (unsigned int vcidx = 0; vcidx < ARRAYLEN(commands); vcidx++)
+        t.appendCommand(commands[vcidx].name, &commands[vcidx]);
+}
@@ -0,0 +1,13 @@
+// Copyright (c) 2026 The Mynta Core Developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#ifndef MYNTA_ZMQ_ZMQRPC_H
+#define MYNTA_ZMQ_ZMQRPC_H
+
+class CRPCTable;
+
+/** Register ZMQ notification RPC commands */
+void RegisterZMQRPCCommands(CRPCTable& tableRPC);
+
+#endif // MYNTA_ZMQ_ZMQRPC_H
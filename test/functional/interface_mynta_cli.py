@@ -4,6 +4,9 @@
 # Distributed under the MIT software license, see the accompanying
 # file COPYING or http://www.opensource.org/licenses/mit-license.php.
 """Test mynta-cli"""
+import json
+import subprocess
+
 from test_framework.test_framework import RavenTestFramework
 from test_framework.util import (assert_equal, assert_raises_process_error, get_auth_cookie)
 
@@ -32,6 +35,23 @@ class TestRavenCli(RavenTestFramework):
         assert_equal(["foo", "bar"], self.nodes[0].cli('-rpcuser=%s' % user, '-stdin', '-stdinrpcpass', input_data=password + "\nfoo\nbar").echo())
         assert_raises_process_error(1, "incorrect rpcuser or rpcpassword", self.nodes[0].cli('-rpcuser=%s' % user, '-stdin', '-stdinrpcpass', input_data="foo").echo)
 
+        self.log.info("Test -stdinbatch")
+        cli = self.nodes[0].cli
+        lines = ["getblockcount", '["echo", "a b", "c"]', "", "nosuchcommand"] + ["echo %d" % i for i in range(250)]
+        process = subprocess.Popen([cli.binary, "-datadir=" + cli.datadir, "-stdinbatch", "-rpcbatchsize=7", "-rpcconcurrency=3"],
+                                   stdin=subprocess.PIPE, stdout=subprocess.PIPE, stderr=subprocess.PIPE, universal_newlines=True)
+        cli_stdout, cli_stderr = process.communicate(input="\n".join(lines) + "\n")
+        assert_equal(process.returncode, 1)
+        output = cli_stdout.split("\n")[:-1]
+        assert_equal(len(output), len(lines))
+        assert_equal(output[0], "0")
+        assert_equal(json.loads(output[1]), ["a b", "c"])
+        assert_equal(output[2], "")
+        assert_equal(output[3], "")
+        assert "line 4: Method not found" in cli_stderr
+        for i in range(250):
+            assert_equal(json.loads(output[4 + i]), [str(i)])
+
         self.log.info("Compare responses from `mynta-cli -getinfo` and the RPCs data is retrieved from.")
         cli_get_info = self.nodes[0].cli('-getinfo').help()
         wallet_info = self.nodes[0].getwalletinfo()
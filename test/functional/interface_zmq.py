@@ -124,6 +124,13 @@ class ZMQTest(RavenTestFramework):
         hex_data = self.rawtx.receive()
         assert_equal(payment_txid, hash256(hex_data).hex())
 
+        self.log.info("Check the notifier counters")
+        notifications = {n["type"]: n for n in self.nodes[0].getzmqnotifications()}
+        assert_equal(sorted(notifications.keys()), ["pubhashblock", "pubhashtx", "pubrawblock", "pubrawtx"])
+        assert_equal(notifications["pubhashblock"]["sequence"], num_blocks)
+        assert_equal(notifications["pubhashtx"]["dropped"], 0)
+        assert_equal(self.nodes[1].getzmqnotifications(), [])
+
 
 if __name__ == '__main__':
     ZMQTest().main()
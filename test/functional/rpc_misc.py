@@ -45,6 +45,14 @@ class RpcMiscTest(RavenTestFramework):
 
         assert_raises_rpc_error(-8, "unknown mode foobar", node.getmemoryinfo, mode="foobar")
 
+        self.log.info("test getcheckqueueinfo")
+        checkqueue = node.getcheckqueueinfo()
+        assert_greater_than_or_equal(checkqueue['threads'], 0)
+        assert_greater_than_or_equal(len(checkqueue['workers']), 1)
+        for worker in checkqueue['workers']:
+            assert_greater_than_or_equal(worker['checks'], worker['batches'])
+            assert_greater_than_or_equal(worker['batches'], worker['steals'])
+
         self.log.info("test logging")
         assert_equal(node.logging()['qt'], True)
         node.logging(exclude=['qt'])